@@ -66,6 +66,9 @@ static float screenSpaceError( float epsilon, float distance, float screenSize,
   return phi;
 }
 
+//! Maximum number of jobs of an entity that are processed at the same time
+static constexpr int MAX_ACTIVE_JOBS = 4;
+
 static float screenSpaceError( QgsChunkNode *node, const QgsChunkedEntity::SceneState &state )
 {
   if ( node->error() <= 0 ) //it happens for meshes
@@ -306,6 +309,24 @@ void QgsChunkedEntity::pruneLoaderQueue( const SceneState &state )
   {
     QgsDebugMsgLevel( QStringLiteral( "Pruned %1 chunks in loading queue" ).arg( toRemoveFromLoaderQueue.count() ), 2 );
   }
+
+  // Step 3: cancel the loaders that are already running for chunks that would get
+  // frustum culled, so that their worker threads are freed for the chunks in view.
+  // Update jobs are left running, as their nodes are already loaded.
+  QList<QgsChunkQueueJob *> toCancel;
+  for ( QgsChunkQueueJob *job : std::as_const( mActiveJobs ) )
+  {
+    if ( qobject_cast<QgsChunkLoader *>( job ) && Qgs3DUtils::isCullable( job->chunk()->bbox(), state.viewProjectionMatrix ) )
+      toCancel.append( job );
+  }
+
+  for ( QgsChunkQueueJob *job : std::as_const( toCancel ) )
+    cancelActiveJob( job );
+
+  if ( !toCancel.isEmpty() )
+  {
+    QgsDebugMsgLevel( QStringLiteral( "Canceled %1 active chunk loaders" ).arg( toCancel.count() ), 2 );
+  }
 }
 
 
@@ -585,7 +606,7 @@ void QgsChunkedEntity::onActiveJobFinished()
 
 void QgsChunkedEntity::startJobs()
 {
-  while ( mActiveJobs.count() < 4 )
+  while ( mActiveJobs.count() < MAX_ACTIVE_JOBS )
   {
     if ( mChunkLoaderQueue->isEmpty() )
       return;
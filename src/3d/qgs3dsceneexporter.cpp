@@ -61,6 +61,8 @@ typedef Qt3DCore::QGeometry Qt3DQGeometry;
 #include <QByteArray>
 #include <QFile>
 #include <QTextStream>
+#include <QThread>
+#include <QtConcurrent>
 
 #include "qgsbillboardgeometry.h"
 #include "qgsterraintileentity_p.h"
@@ -691,15 +693,47 @@ void Qgs3DSceneExporter::save( const QString &sceneName, const QString &sceneFol
   out << "mtllib " << mtlLibName << "\n";
 
   QTextStream mtlOut( &mtlFile );
-  for ( Qgs3DExportObject *obj : mObjects )
+
+  struct SerializedObject
   {
-    if ( obj == nullptr ) continue;
-    // Set object name
-    const QString material = obj->saveMaterial( mtlOut, sceneFolderPath );
-    out << "o " << obj->name() << "\n";
-    if ( material != QString() )
-      out << "usemtl " << material << "\n";
-    obj->saveTo( out, scale / mScale, QVector3D( centerX, centerY, centerZ ) );
+    Qgs3DExportObject *object = nullptr;
+    QString materialName;
+    QString material;
+    QString geometry;
+  };
+
+  // objects are serialized concurrently, in batches written in order to bound the memory used
+  const int batchSize = std::max( 1, QThread::idealThreadCount() ) * 4;
+  for ( int batchStart = 0; batchStart < mObjects.size(); batchStart += batchSize )
+  {
+    QVector< SerializedObject > batch;
+    batch.reserve( batchSize );
+    for ( int i = batchStart; i < std::min( batchStart + batchSize, static_cast< int >( mObjects.size() ) ); ++i )
+    {
+      if ( mObjects.at( i ) )
+        batch.append( SerializedObject { mObjects.at( i ), QString(), QString(), QString() } );
+    }
+
+    QtConcurrent::blockingMap( batch, [this, &sceneFolderPath, scale, centerX, centerY, centerZ]( SerializedObject & serialized )
+    {
+      QTextStream materialOut( &serialized.material );
+      serialized.materialName = serialized.object->saveMaterial( materialOut, sceneFolderPath );
+      materialOut.flush();
+
+      QTextStream geometryOut( &serialized.geometry );
+      serialized.object->saveTo( geometryOut, scale / mScale, QVector3D( centerX, centerY, centerZ ) );
+      geometryOut.flush();
+    } );
+
+    for ( const SerializedObject &serialized : std::as_const( batch ) )
+    {
+      mtlOut << serialized.material;
+      // Set object name
+      out << "o " << serialized.object->name() << "\n";
+      if ( serialized.materialName != QString() )
+        out << "usemtl " << serialized.materialName << "\n";
+      out << serialized.geometry;
+    }
   }
 }
 
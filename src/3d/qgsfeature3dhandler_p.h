@@ -103,6 +103,14 @@ class QgsFeature3DHandler
      */
     virtual void processFeature( const QgsFeature &feature, const Qgs3DRenderContext &context ) = 0;
 
+    /**
+     * Called when feature iteration has finished, before finalize(). Unlike finalize(), this is
+     * called in the thread of the feature iteration, so derived handlers can do the heavy processing
+     * of the extracted data here rather than in the main thread.
+     * \since QGIS 3.30
+     */
+    virtual void finishProcessing( const Qgs3DRenderContext &context ) { Q_UNUSED( context ) }
+
     /**
      * When feature iteration has finished, finalize() is called to turn the extracted data
      * to a 3D entity object(s) attached to the given parent.
@@ -89,6 +89,11 @@ QgsRuleBasedChunkLoader::QgsRuleBasedChunkLoader( const QgsRuleBasedChunkLoaderF
       mContext.expressionContext().setFeature( f );
       mRootRule->registerFeature( f, mContext, mHandlers );
     }
+    if ( !mCanceled )
+    {
+      for ( QgsFeature3DHandler *handler : std::as_const( mHandlers ) )
+        handler->finishProcessing( mContext );
+    }
   } );
 
   // emit finished() as soon as the handler is populated with features
@@ -99,6 +99,8 @@ QgsVectorLayerChunkLoader::QgsVectorLayerChunkLoader( const QgsVectorLayerChunkL
       mContext.expressionContext().setFeature( f );
       mHandler->processFeature( f, mContext );
     }
+    if ( !mCanceled )
+      mHandler->finishProcessing( mContext );
   } );
 
   // emit finished() as soon as the handler is populated with features
@@ -43,8 +43,16 @@
 #include "qgslinevertexdata_p.h"
 #include "qgslinematerial_p.h"
 
+#include <QtConcurrent>
+
 /// @cond PRIVATE
 
+//! Minimal number of pending polygons to tessellate them in parallel
+static constexpr int MIN_POLYGONS_FOR_PARALLEL_TESSELLATION = 64;
+
+//! Number of pending polygons after which they get tessellated while processing the features
+static constexpr int MAX_PENDING_POLYGONS = 4096;
+
 
 class QgsPolygon3DSymbolHandler : public QgsFeature3DHandler
 {
@@ -55,21 +63,35 @@ class QgsPolygon3DSymbolHandler : public QgsFeature3DHandler
 
     bool prepare( const Qgs3DRenderContext &context, QSet<QString> &attributeNames ) override;
     void processFeature( const QgsFeature &f, const Qgs3DRenderContext &context ) override;
+    void finishProcessing( const Qgs3DRenderContext &context ) override;
     void finalize( Qt3DCore::QEntity *parent, const Qgs3DRenderContext &context ) override;
 
   private:
 
+    //! polygon waiting to be tessellated
+    struct PendingPolygon
+    {
+      std::unique_ptr<QgsPolygon> polygon;
+      QgsFeatureId fid;
+      float extrusionHeight;
+      QByteArray materialDataDefined;  //!< data defined vertex colors of a single vertex
+    };
+
     //! temporary data we will pass to the tessellator
     struct PolygonData
     {
-      std::unique_ptr<QgsTessellator> tessellator;
+      std::vector<PendingPolygon> pendingPolygons;
+      QVector<float> vertexData;
+      float zMin = std::numeric_limits<float>::max();
+      float zMax = std::numeric_limits<float>::lowest();
       QVector<QgsFeatureId> triangleIndexFids;
       QVector<uint> triangleIndexStartingIndices;
       QByteArray materialDataDefined;
     };
 
     void processPolygon( QgsPolygon *polyClone, QgsFeatureId fid, float height, float extrusionHeight, const Qgs3DRenderContext &context, PolygonData &out );
-    void processMaterialDatadefined( uint verticesCount, const QgsExpressionContext &context, PolygonData &out );
+    void tessellatePendingPolygons( const Qgs3DRenderContext &context, PolygonData &out );
+    QgsTessellator *createTessellator( const Qgs3DRenderContext &context ) const;
     void makeEntity( Qt3DCore::QEntity *parent, const Qgs3DRenderContext &context, PolygonData &out, bool selected );
     Qt3DRender::QMaterial *material( const QgsPolygon3DSymbol *symbol, bool isSelected, const Qgs3DRenderContext &context ) const;
 
@@ -77,6 +99,8 @@ class QgsPolygon3DSymbolHandler : public QgsFeature3DHandler
     std::unique_ptr< QgsPolygon3DSymbol > mSymbol;
     // inputs - generic
     QgsFeatureIds mSelectedIds;
+    //! size of one vertex entry in the tessellated data (in bytes)
+    int mStride = 0;
 
     // outputs
     PolygonData outNormal;  //!< Features that are not selected
@@ -91,17 +115,8 @@ bool QgsPolygon3DSymbolHandler::prepare( const Qgs3DRenderContext &context, QSet
   outEdges.withAdjacency = true;
   outEdges.init( mSymbol->altitudeClamping(), mSymbol->altitudeBinding(), 0, &context.map() );
 
-  const QgsPhongTexturedMaterialSettings *texturedMaterialSettings = dynamic_cast< const QgsPhongTexturedMaterialSettings * >( mSymbol->materialSettings() );
-
-  outNormal.tessellator.reset( new QgsTessellator( context.map().origin().x(), context.map().origin().y(), true, mSymbol->invertNormals(), mSymbol->addBackFaces(), false,
-                               texturedMaterialSettings && texturedMaterialSettings->requiresTextureCoordinates(),
-                               mSymbol->renderedFacade(),
-                               texturedMaterialSettings ? texturedMaterialSettings->textureRotation() : 0 ) );
-  outSelected.tessellator.reset( new QgsTessellator( context.map().origin().x(), context.map().origin().y(), true, mSymbol->invertNormals(),
-                                 mSymbol->addBackFaces(), false,
-                                 texturedMaterialSettings && texturedMaterialSettings->requiresTextureCoordinates(),
-                                 mSymbol->renderedFacade(),
-                                 texturedMaterialSettings ? texturedMaterialSettings->textureRotation() : 0 ) );
+  const std::unique_ptr< QgsTessellator > tessellator( createTessellator( context ) );
+  mStride = tessellator->stride();
 
   QSet<QString> attrs = mSymbol->dataDefinedProperties().referencedFields( context.expressionContext() );
   attributeNames.unite( attrs );
@@ -110,9 +125,18 @@ bool QgsPolygon3DSymbolHandler::prepare( const Qgs3DRenderContext &context, QSet
   return true;
 }
 
+QgsTessellator *QgsPolygon3DSymbolHandler::createTessellator( const Qgs3DRenderContext &context ) const
+{
+  const QgsPhongTexturedMaterialSettings *texturedMaterialSettings = dynamic_cast< const QgsPhongTexturedMaterialSettings * >( mSymbol->materialSettings() );
+
+  return new QgsTessellator( context.map().origin().x(), context.map().origin().y(), true, mSymbol->invertNormals(), mSymbol->addBackFaces(), false,
+                             texturedMaterialSettings && texturedMaterialSettings->requiresTextureCoordinates(),
+                             mSymbol->renderedFacade(),
+                             texturedMaterialSettings ? texturedMaterialSettings->textureRotation() : 0 );
+}
+
 void QgsPolygon3DSymbolHandler::processPolygon( QgsPolygon *polyClone, QgsFeatureId fid, float height, float extrusionHeight, const Qgs3DRenderContext &context, PolygonData &out )
 {
-  const uint oldVerticesCount = out.tessellator->dataVerticesCount();
   if ( mSymbol->edgesEnabled() )
   {
     // add edges before the polygon gets the Z values modified because addLineString() does its own altitude handling
@@ -137,21 +161,66 @@ void QgsPolygon3DSymbolHandler::processPolygon( QgsPolygon *polyClone, QgsFeatur
 
   Qgs3DUtils::clampAltitudes( polyClone, mSymbol->altitudeClamping(), mSymbol->altitudeBinding(), height, context.map() );
 
-  Q_ASSERT( out.tessellator->dataVerticesCount() % 3 == 0 );
-  const uint startingTriangleIndex = static_cast<uint>( out.tessellator->dataVerticesCount() / 3 );
-  out.triangleIndexStartingIndices.append( startingTriangleIndex );
-  out.triangleIndexFids.append( fid );
-  out.tessellator->addPolygon( *polyClone, extrusionHeight );
-  delete polyClone;
-
+  // the tessellation itself is deferred, so that the polygons can be tessellated in parallel
+  PendingPolygon pending;
+  pending.polygon.reset( polyClone );
+  pending.fid = fid;
+  pending.extrusionHeight = extrusionHeight;
   if ( mSymbol->materialSettings()->dataDefinedProperties().hasActiveProperties() )
-    processMaterialDatadefined( out.tessellator->dataVerticesCount() - oldVerticesCount, context.expressionContext(), out );
+    pending.materialDataDefined = mSymbol->materialSettings()->dataDefinedVertexColorsAsByte( context.expressionContext() );
+  out.pendingPolygons.push_back( std::move( pending ) );
 }
 
-void QgsPolygon3DSymbolHandler::processMaterialDatadefined( uint verticesCount, const QgsExpressionContext &context, QgsPolygon3DSymbolHandler::PolygonData &out )
+void QgsPolygon3DSymbolHandler::tessellatePendingPolygons( const Qgs3DRenderContext &context, PolygonData &out )
 {
-  const QByteArray bytes = mSymbol->materialSettings()->dataDefinedVertexColorsAsByte( context );
-  out.materialDataDefined.append( bytes.repeated( verticesCount ) );
+  if ( out.pendingPolygons.empty() )
+    return;
+
+  struct TessellatedPolygon
+  {
+    QVector<float> data;
+    float zMin;
+    float zMax;
+  };
+
+  const std::function< TessellatedPolygon( const PendingPolygon & ) > tessellate = [this, &context]( const PendingPolygon & pending )
+  {
+    const std::unique_ptr< QgsTessellator > tessellator( createTessellator( context ) );
+    tessellator->addPolygon( *pending.polygon, pending.extrusionHeight );
+    return TessellatedPolygon{ tessellator->data(), tessellator->zMinimum(), tessellator->zMaximum() };
+  };
+
+  QVector< TessellatedPolygon > tessellated;
+  if ( out.pendingPolygons.size() >= MIN_POLYGONS_FOR_PARALLEL_TESSELLATION )
+  {
+    tessellated = QtConcurrent::blockingMapped< QVector< TessellatedPolygon > >( out.pendingPolygons, tessellate );
+  }
+  else
+  {
+    tessellated.reserve( static_cast< int >( out.pendingPolygons.size() ) );
+    for ( const PendingPolygon &pending : out.pendingPolygons )
+      tessellated.append( tessellate( pending ) );
+  }
+
+  // merge the polygons into the vertex data in the order of the features
+  const int floatsPerVertex = mStride / sizeof( float );
+  for ( size_t i = 0; i < out.pendingPolygons.size(); ++i )
+  {
+    const PendingPolygon &pending = out.pendingPolygons[i];
+    const TessellatedPolygon &polygon = tessellated.at( static_cast< int >( i ) );
+
+    Q_ASSERT( ( out.vertexData.count() / floatsPerVertex ) % 3 == 0 );
+    const uint startingTriangleIndex = static_cast<uint>( out.vertexData.count() / floatsPerVertex / 3 );
+    out.triangleIndexStartingIndices.append( startingTriangleIndex );
+    out.triangleIndexFids.append( pending.fid );
+    out.vertexData.append( polygon.data );
+    out.zMin = std::min( out.zMin, polygon.zMin );
+    out.zMax = std::max( out.zMax, polygon.zMax );
+
+    if ( !pending.materialDataDefined.isEmpty() )
+      out.materialDataDefined.append( pending.materialDataDefined.repeated( polygon.data.count() / floatsPerVertex ) );
+  }
+  out.pendingPolygons.clear();
 }
 
 void QgsPolygon3DSymbolHandler::processFeature( const QgsFeature &f, const Qgs3DRenderContext &context )
@@ -210,17 +279,29 @@ void QgsPolygon3DSymbolHandler::processFeature( const QgsFeature &f, const Qgs3D
   else
     qWarning() << "not a polygon";
 
+  if ( static_cast< int >( out.pendingPolygons.size() ) >= MAX_PENDING_POLYGONS )
+    tessellatePendingPolygons( context, out );
+
   mFeatureCount++;
 }
 
+void QgsPolygon3DSymbolHandler::finishProcessing( const Qgs3DRenderContext &context )
+{
+  tessellatePendingPolygons( context, outNormal );
+  tessellatePendingPolygons( context, outSelected );
+}
+
 void QgsPolygon3DSymbolHandler::finalize( Qt3DCore::QEntity *parent, const Qgs3DRenderContext &context )
 {
+  // tessellate the remaining polygons, if finishProcessing() has not been called
+  finishProcessing( context );
+
   // create entity for selected and not selected
   makeEntity( parent, context, outNormal, false );
   makeEntity( parent, context, outSelected, true );
 
-  mZMin = std::min( outNormal.tessellator->zMinimum(), outSelected.tessellator->zMinimum() );
-  mZMax = std::max( outNormal.tessellator->zMaximum(), outSelected.tessellator->zMaximum() );
+  mZMin = std::min( outNormal.zMin, outSelected.zMin );
+  mZMax = std::max( outNormal.zMax, outSelected.zMax );
 
   // add entity for edges
   if ( mSymbol->edgesEnabled() && !outEdges.indexes.isEmpty() )
@@ -249,14 +330,14 @@ void QgsPolygon3DSymbolHandler::finalize( Qt3DCore::QEntity *parent, const Qgs3D
 
 void QgsPolygon3DSymbolHandler::makeEntity( Qt3DCore::QEntity *parent, const Qgs3DRenderContext &context, PolygonData &out, bool selected )
 {
-  if ( out.tessellator->dataVerticesCount() == 0 )
+  if ( out.vertexData.isEmpty() )
     return;  // nothing to show - no need to create the entity
 
   Qt3DRender::QMaterial *mat = material( mSymbol.get(), selected, context );
 
   // extract vertex buffer data from tessellator
-  const QByteArray data( ( const char * )out.tessellator->data().constData(), out.tessellator->data().count() * sizeof( float ) );
-  const int nVerts = data.count() / out.tessellator->stride();
+  const QByteArray data( ( const char * )out.vertexData.constData(), out.vertexData.count() * sizeof( float ) );
+  const int nVerts = data.count() / mStride;
 
   const QgsPhongTexturedMaterialSettings *texturedMaterialSettings = dynamic_cast< const QgsPhongTexturedMaterialSettings * >( mSymbol->materialSettings() );
 
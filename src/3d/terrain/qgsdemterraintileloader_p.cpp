@@ -151,6 +151,9 @@ void QgsDemTerrainTileLoader::onHeightMapReady( int jobId, const QByteArray &hei
 #include <QFutureWatcher>
 #include "qgsterraindownloader.h"
 
+//! Maximum size of the cached height maps of a generator (in kilobytes)
+static constexpr int MAX_CACHED_HEIGHT_MAPS_SIZE = 64 * 1024;
+
 QgsDemHeightMapGenerator::QgsDemHeightMapGenerator( QgsRasterLayer *dtm, const QgsTilingScheme &tilingScheme, int resolution, const QgsCoordinateTransformContext &transformContext )
   : mDtmExtent( dtm ? dtm->extent() : QgsRectangle() )
   , mClonedProvider( dtm ? qgis::down_cast<QgsRasterDataProvider *>( dtm->dataProvider()->clone() ) : nullptr )
@@ -160,6 +163,7 @@ QgsDemHeightMapGenerator::QgsDemHeightMapGenerator( QgsRasterLayer *dtm, const Q
   , mDownloader( dtm ? nullptr : new QgsTerrainDownloader( transformContext ) )
   , mTransformContext( transformContext )
 {
+  mHeightMapCache.setMaxCost( MAX_CACHED_HEIGHT_MAPS_SIZE );
 }
 
 QgsDemHeightMapGenerator::~QgsDemHeightMapGenerator()
@@ -247,7 +251,12 @@ int QgsDemHeightMapGenerator::render( const QgsChunkNodeId &nodeId )
   QFutureWatcher<QByteArray> *fw = new QFutureWatcher<QByteArray>( nullptr );
   connect( fw, &QFutureWatcher<QByteArray>::finished, this, &QgsDemHeightMapGenerator::onFutureFinished );
   connect( fw, &QFutureWatcher<QByteArray>::finished, fw, &QObject::deleteLater );
-  if ( mClonedProvider )
+  if ( const QByteArray *cachedHeightMap = mHeightMapCache.object( nodeId.text() ) )
+  {
+    // the height map has been read already: deliver it asynchronously like the ones read from the DEM
+    jd.future = QtConcurrent::run( []( const QByteArray & heightMap ) { return heightMap; }, *cachedHeightMap );
+  }
+  else if ( mClonedProvider )
   {
     // make a clone of the data provider so it is safe to use in worker thread
     std::unique_ptr< QgsRasterDataProvider > clonedProviderClone( mClonedProvider->clone() );
@@ -283,6 +292,7 @@ void QgsDemHeightMapGenerator::waitForFinished()
     toBeDeleted.push_back( fw );
 
     QByteArray data = jobData.future.result();
+    cacheHeightMap( jobData.tileId, data );
     emit heightMapReady( jobData.jobId, data );
   }
 
@@ -336,7 +346,17 @@ void QgsDemHeightMapGenerator::onFutureFinished()
   QgsEventTracing::addEvent( QgsEventTracing::AsyncEnd, QStringLiteral( "3D" ), QStringLiteral( "DEM" ), jobData.tileId.text() );
 
   QByteArray data = jobData.future.result();
+  cacheHeightMap( jobData.tileId, data );
   emit heightMapReady( jobData.jobId, data );
 }
 
+void QgsDemHeightMapGenerator::cacheHeightMap( const QgsChunkNodeId &tileId, const QByteArray &heightMap )
+{
+  // empty height maps come from failed reads or downloads - let them be read again
+  if ( heightMap.isEmpty() || mHeightMapCache.contains( tileId.text() ) )
+    return;
+
+  mHeightMapCache.insert( tileId.text(), new QByteArray( heightMap ), std::max( 1, static_cast< int >( heightMap.size() / 1024 ) ) );
+}
+
 /// @endcond
@@ -33,6 +33,7 @@
 #include <QFutureWatcher>
 #include <QElapsedTimer>
 #include <QMutex>
+#include <QCache>
 
 #include "qgschunknode_p.h"
 #include "qgscoordinatetransformcontext.h"
@@ -135,6 +136,12 @@ class QgsDemHeightMapGenerator : public QObject
 
     QHash<QFutureWatcher<QByteArray>*, JobData> mJobs;
 
+    //! cache of the height maps that have been read recently, keyed by tile ID (cost in kilobytes)
+    QCache<QString, QByteArray> mHeightMapCache;
+
+    //! Adds a height map that has been read to the cache
+    void cacheHeightMap( const QgsChunkNodeId &tileId, const QByteArray &heightMap );
+
     void lazyLoadDtmCoarseData( int res, const QgsRectangle &rect );
     mutable QMutex mLazyLoadDtmCoarseDataMutex;
     //! used for height queries
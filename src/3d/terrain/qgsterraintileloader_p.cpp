@@ -65,6 +65,15 @@ void QgsTerrainTileLoader::loadTexture()
   mTextureJobId = mTerrain->textureGenerator()->render( mExtentMapCrs, mNode->tileId(), mTileDebugText );
 }
 
+void QgsTerrainTileLoader::cancel()
+{
+  if ( mTextureJobId != -1 )
+  {
+    mTerrain->textureGenerator()->cancelJob( mTextureJobId );
+    mTextureJobId = -1;
+  }
+}
+
 void QgsTerrainTileLoader::createTextureComponent( QgsTerrainTileEntity *entity, bool isShadingEnabled, const QgsPhongMaterialSettings &shadingMaterial, bool useTexture )
 {
   Qt3DRender::QTexture2D *texture = useTexture || !isShadingEnabled ? createTexture( entity ) : nullptr;
@@ -80,6 +80,15 @@ int NormVecDecorator::addPoint( const QgsPoint &p )
   return -1;
 }
 
+bool NormVecDecorator::addPoints( const QVector< QgsPoint > &points, QgsFeedback *feedback )
+{
+  // once the normals are estimated, they are updated around each new point
+  if ( alreadyestimated )
+    return QgsTriangulation::addPoints( points, feedback );
+
+  return TriDecorator::addPoints( points, feedback );
+}
+
 bool NormVecDecorator::calcNormal( double x, double y, QgsPoint &result )
 {
   if ( !alreadyestimated )
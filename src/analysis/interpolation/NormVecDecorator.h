@@ -43,6 +43,7 @@ class ANALYSIS_EXPORT NormVecDecorator: public TriDecorator
     NormVecDecorator( QgsTriangulation *tin );
     ~NormVecDecorator() override;
     int addPoint( const QgsPoint &p ) override;
+    bool addPoints( const QVector< QgsPoint > &points, QgsFeedback *feedback = nullptr ) override;
     //! Calculates the normal at a point on the surface and assigns it to 'result'. Returns TRUE in case of success and FALSE in case of failure
     bool calcNormal( double x, double y, QgsPoint &result SIP_OUT ) override;
     //! Calculates the normal of a triangle-point for the point with coordinates x and y. This is needed, if a point is on a break line and there is no unique normal stored in 'mNormVec'. Returns FALSE, it something went wrong and TRUE otherwise
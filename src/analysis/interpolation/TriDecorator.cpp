@@ -43,6 +43,19 @@ int TriDecorator::addPoint( const QgsPoint &p )
   }
 }
 
+bool TriDecorator::addPoints( const QVector< QgsPoint > &points, QgsFeedback *feedback )
+{
+  if ( mTIN )
+  {
+    return mTIN->addPoints( points, feedback );
+  }
+  else
+  {
+    QgsDebugMsg( QStringLiteral( "warning, null pointer" ) );
+    return false;
+  }
+}
+
 void TriDecorator::performConsistencyTest()
 {
   if ( mTIN )
@@ -37,6 +37,7 @@ class ANALYSIS_EXPORT TriDecorator : public QgsTriangulation
     explicit TriDecorator( QgsTriangulation *t );
     void addLine( const QVector< QgsPoint> &points, QgsInterpolator::SourceType lineType ) override;
     int addPoint( const QgsPoint &p ) override;
+    bool addPoints( const QVector< QgsPoint > &points, QgsFeedback *feedback = nullptr ) override;
     //! Adds an association to a triangulation
     virtual void addTriangulation( QgsTriangulation *t );
     //! Performs a consistency check, remove this later
@@ -22,9 +22,44 @@
 #include "qgslogger.h"
 #include "qgsvectorfilewriter.h"
 #include "qgsinterpolator.h"
+#include "qgsfeedback.h"
+
+#include <algorithm>
+#include <random>
 
 double leftOfTresh = 0;
 
+//! Number of bits per axis of the Hilbert curve used to sort the points added in bulk
+static constexpr int HILBERT_CURVE_BITS = 16;
+
+//! Number of rounds of the randomized insertion order of the points added in bulk
+static constexpr int INSERTION_ROUNDS = 16;
+
+//! Returns the distance along the Hilbert curve of the cell at \a x, \a y
+static quint32 hilbertDistance( quint32 x, quint32 y )
+{
+  const quint32 size = 1u << HILBERT_CURVE_BITS;
+  quint32 distance = 0;
+  for ( quint32 s = size / 2; s > 0; s /= 2 )
+  {
+    const quint32 rx = ( x & s ) > 0 ? 1 : 0;
+    const quint32 ry = ( y & s ) > 0 ? 1 : 0;
+    distance += s * s * ( ( 3 * rx ) ^ ry );
+
+    // rotate the quadrant
+    if ( ry == 0 )
+    {
+      if ( rx == 1 )
+      {
+        x = size - 1 - x;
+        y = size - 1 - y;
+      }
+      std::swap( x, y );
+    }
+  }
+  return distance;
+}
+
 static bool inCircle( const QgsPoint &testedPoint, const QgsPoint &point1, const QgsPoint &point2, const QgsPoint &point3 )
 {
   const double x2 = point2.x() - point1.x();
@@ -509,6 +544,102 @@ int QgsDualEdgeTriangulation::addPoint( const QgsPoint &p )
   return ( mPointVector.count() - 1 );
 }
 
+bool QgsDualEdgeTriangulation::addPoints( const QVector<QgsPoint> &points, QgsFeedback *feedback )
+{
+  if ( points.isEmpty() )
+    return true;
+
+  // the points are inserted in a biased randomized insertion order: they are randomly assigned to rounds
+  // of doubling size, and the points of each round are sorted along a Hilbert curve. The triangle containing
+  // a new point is then found by a short walk from the previous point, and the rounds keep the triangulation
+  // well shaped while it grows
+  double xMin = std::numeric_limits<double>::max();
+  double yMin = std::numeric_limits<double>::max();
+  double xMax = std::numeric_limits<double>::lowest();
+  double yMax = std::numeric_limits<double>::lowest();
+  for ( const QgsPoint &p : points )
+  {
+    xMin = std::min( xMin, p.x() );
+    yMin = std::min( yMin, p.y() );
+    xMax = std::max( xMax, p.x() );
+    yMax = std::max( yMax, p.y() );
+  }
+  const double maxCell = static_cast< double >( ( 1u << HILBERT_CURVE_BITS ) - 1 );
+  const double xScale = xMax > xMin ? maxCell / ( xMax - xMin ) : 0;
+  const double yScale = yMax > yMin ? maxCell / ( yMax - yMin ) : 0;
+
+  // fixed seed, so that the same points always give the same triangulation
+  std::mt19937 generator( 0 );
+  QVector< QPair< quint64, int > > insertionOrder( points.size() );
+  for ( int i = 0; i < points.size(); ++i )
+  {
+    const quint32 random = generator();
+    int round = 0;
+    while ( round < INSERTION_ROUNDS - 1 && ( random & ( 1u << round ) ) )
+      round++;
+
+    // rounds are inserted from the smallest one, i.e. from the highest round number
+    const quint32 cellX = static_cast< quint32 >( ( points.at( i ).x() - xMin ) * xScale );
+    const quint32 cellY = static_cast< quint32 >( ( points.at( i ).y() - yMin ) * yScale );
+    const quint64 key = ( static_cast< quint64 >( INSERTION_ROUNDS - 1 - round ) << 32 ) | hilbertDistance( cellX, cellY );
+    insertionOrder[i] = qMakePair( key, i );
+  }
+  std::sort( insertionOrder.begin(), insertionOrder.end() );
+
+  const int initialPointCount = mPointVector.count();
+  mPointVector.reserve( initialPointCount + points.size() );
+  // a triangulation has about three edges per point
+  mHalfEdge.reserve( mHalfEdge.count() + 6 * points.size() + 10 );
+
+  bool ok = true;
+  QVector< int > pointNumbers( points.size(), -1 );
+  for ( const QPair< quint64, int > &entry : std::as_const( insertionOrder ) )
+  {
+    if ( feedback && feedback->isCanceled() )
+    {
+      ok = false;
+      break;
+    }
+
+    const int number = addPoint( points.at( entry.second ) );
+    if ( number == -100 )
+      ok = false;
+    else
+      pointNumbers[entry.second] = number;
+  }
+
+  // renumber the new points in the order of the added points
+  QVector< int > newNumbers( mPointVector.count(), -1 );
+  for ( int i = 0; i < initialPointCount; ++i )
+    newNumbers[i] = i;
+  int nextNumber = initialPointCount;
+  for ( const int number : std::as_const( pointNumbers ) )
+  {
+    if ( number >= initialPointCount && newNumbers.at( number ) == -1 )
+      newNumbers[number] = nextNumber++;
+  }
+  for ( int i = initialPointCount; i < newNumbers.count(); ++i )
+  {
+    if ( newNumbers.at( i ) == -1 )
+      newNumbers[i] = nextNumber++;
+  }
+
+  QVector<QgsPoint *> renumberedPoints( mPointVector.count() );
+  for ( int i = 0; i < mPointVector.count(); ++i )
+    renumberedPoints[newNumbers.at( i )] = mPointVector.at( i );
+  mPointVector = renumberedPoints;
+
+  for ( HalfEdge *edge : std::as_const( mHalfEdge ) )
+  {
+    if ( edge->getPoint() >= 0 )
+      edge->setPoint( newNumbers.at( edge->getPoint() ) );
+  }
+  if ( mTwiceInsPoint >= 0 && mTwiceInsPoint < newNumbers.count() )
+    mTwiceInsPoint = newNumbers.at( mTwiceInsPoint );
+
+  return ok;
+}
+
 int QgsDualEdgeTriangulation::baseEdgeOfPoint( int point )
 {
   unsigned int actedge = mEdgeInside;//starting edge
@@ -55,6 +55,17 @@ class ANALYSIS_EXPORT QgsDualEdgeTriangulation: public QgsTriangulation
     ~QgsDualEdgeTriangulation() override;
     void addLine( const QVector< QgsPoint > &points, QgsInterpolator::SourceType lineType ) override;
     int addPoint( const QgsPoint &p ) override;
+
+    /**
+     * Adds a set of \a points to the triangulation.
+     *
+     * The points are inserted in a biased randomized order along a Hilbert curve, which is much faster
+     * than adding them one after the other in their original order for large sets of points. The points
+     * are then renumbered, so that they keep their order in the triangulation.
+     *
+     * \since QGIS 3.30
+     */
+    bool addPoints( const QVector<QgsPoint> &points, QgsFeedback *feedback = nullptr ) override;
     //! Performs a consistency check, remove this later
     void performConsistencyTest() override;
     //! Calculates the normal at a point on the surface
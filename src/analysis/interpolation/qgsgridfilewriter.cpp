@@ -19,8 +19,18 @@
 #include "qgsinterpolator.h"
 #include "qgsvectorlayer.h"
 #include "qgsfeedback.h"
+#include "qgsgdalutils.h"
+#include "qgsogrutils.h"
+#include "cpl_string.h"
 #include <QFile>
 #include <QFileInfo>
+#include <QtConcurrentMap>
+
+//! Value of the cells that cannot be interpolated
+static constexpr double NODATA_VALUE = -9999;
+
+//! Number of rows interpolated in parallel before they are written to the file
+static constexpr int ROWS_PER_BLOCK = 64;
 
 QgsGridFileWriter::QgsGridFileWriter( QgsInterpolator *i, const QString &outputPath, const QgsRectangle &extent, int nCols, int nRows )
   : mInterpolator( i )
@@ -33,6 +43,15 @@ QgsGridFileWriter::QgsGridFileWriter( QgsInterpolator *i, const QString &outputP
 {}
 
 int QgsGridFileWriter::writeFile( QgsFeedback *feedback )
+{
+  const QString suffix = QFileInfo( mOutputFilePath ).suffix().toLower();
+  if ( suffix == QLatin1String( "tif" ) || suffix == QLatin1String( "tiff" ) )
+    return writeGeoTiff( feedback );
+
+  return writeAsciiGrid( feedback );
+}
+
+int QgsGridFileWriter::writeAsciiGrid( QgsFeedback *feedback )
 {
   QFile outputFile( mOutputFilePath );
 
@@ -54,38 +73,18 @@ int QgsGridFileWriter::writeFile( QgsFeedback *feedback )
   outStream.setRealNumberPrecision( 8 );
   writeHeader( outStream );
 
-  double currentYValue = mInterpolationExtent.yMaximum() - mCellSizeY / 2.0; //calculate value in the center of the cell
-  double currentXValue;
-  double interpolatedValue;
-
-  for ( int i = 0; i < mNumRows; ++i )
+  const int result = interpolateRows( [&outStream]( const QVector< double > &values ) -> bool
   {
-    currentXValue = mInterpolationExtent.xMinimum() + mCellSizeX / 2.0; //calculate value in the center of the cell
-    for ( int j = 0; j < mNumColumns; ++j )
-    {
-      if ( mInterpolator->interpolatePoint( currentXValue, currentYValue, interpolatedValue, feedback ) == 0 )
-      {
-        outStream << interpolatedValue << ' ';
-      }
-      else
-      {
-        outStream << "-9999 ";
-      }
-      currentXValue += mCellSizeX;
-    }
-
+    for ( const double value : values )
+      outStream << value << ' ';
     outStream << Qt::endl;
-    currentYValue -= mCellSizeY;
+    return true;
+  }, feedback );
 
-    if ( feedback )
-    {
-      if ( feedback->isCanceled() )
-      {
-        outputFile.remove();
-        return 3;
-      }
-      feedback->setProgress( 100.0 * i / static_cast< double >( mNumRows ) );
-    }
+  if ( result != 0 )
+  {
+    outputFile.remove();
+    return result;
   }
 
   // create prj file
@@ -108,6 +107,133 @@ int QgsGridFileWriter::writeFile( QgsFeedback *feedback )
   return 0;
 }
 
+int QgsGridFileWriter::writeGeoTiff( QgsFeedback *feedback )
+{
+  if ( !mInterpolator )
+  {
+    return 2;
+  }
+
+  GDALDriverH driver = GDALGetDriverByName( "GTiff" );
+  if ( !driver )
+  {
+    return 1;
+  }
+
+  char **options = nullptr;
+  options = CSLSetNameValue( options, "TILED", "YES" );
+  options = CSLSetNameValue( options, "COMPRESS", "DEFLATE" );
+  options = CSLSetNameValue( options, "BIGTIFF", "IF_SAFER" );
+  gdal::dataset_unique_ptr dataset( GDALCreate( driver, mOutputFilePath.toUtf8().constData(), mNumColumns, mNumRows, 1, GDT_Float32, options ) );
+  CSLDestroy( options );
+  if ( !dataset )
+  {
+    return 1;
+  }
+
+  double geoTransform[6];
+  geoTransform[0] = mInterpolationExtent.xMinimum();
+  geoTransform[1] = mCellSizeX;
+  geoTransform[2] = 0;
+  geoTransform[3] = mInterpolationExtent.yMaximum();
+  geoTransform[4] = 0;
+  geoTransform[5] = -mCellSizeY;
+  GDALSetGeoTransform( dataset.get(), geoTransform );
+
+  const QgsCoordinateReferenceSystem crs = mInterpolator->layerData().at( 0 ).source->sourceCrs();
+  GDALSetProjection( dataset.get(), crs.toWkt( QgsCoordinateReferenceSystem::WKT_PREFERRED_GDAL ).toLatin1().constData() );
+
+  GDALRasterBandH band = GDALGetRasterBand( dataset.get(), 1 );
+  GDALSetRasterNoDataValue( band, NODATA_VALUE );
+
+  int row = 0;
+  const int result = interpolateRows( [this, band, &row]( const QVector< double > &values ) -> bool
+  {
+    // values are converted to the band data type while writing
+    const bool written = GDALRasterIO( band, GF_Write, 0, row, mNumColumns, 1, const_cast< double * >( values.constData() ), mNumColumns, 1, GDT_Float64, 0, 0 ) == CE_None;
+    ++row;
+    return written;
+  }, feedback );
+
+  if ( result != 0 )
+  {
+    gdal::fast_delete_and_close( dataset, driver, mOutputFilePath );
+    return result;
+  }
+
+  return 0;
+}
+
+int QgsGridFileWriter::interpolateRows( const std::function< bool( const QVector< double > & ) > &writeRow, QgsFeedback *feedback )
+{
+  const bool parallel = mInterpolator->supportsParallelInterpolation();
+  const std::function< QVector< double >( int ) > interpolate = [this]( int row ) -> QVector< double >
+  {
+    return interpolateRow( row, nullptr );
+  };
+
+  int row = 0;
+  while ( row < mNumRows )
+  {
+    if ( !parallel || row == 0 )
+    {
+      // the first row is always interpolated in this thread, so that the interpolator caches its data before the parallel rows
+      if ( !writeRow( interpolateRow( row, feedback ) ) )
+        return 1;
+      ++row;
+    }
+    else
+    {
+      QVector< int > rows;
+      for ( int blockRow = row; blockRow < std::min( row + ROWS_PER_BLOCK, mNumRows ); ++blockRow )
+        rows.append( blockRow );
+
+      const QList< QVector< double > > blockValues = QtConcurrent::blockingMapped< QList< QVector< double > > >( rows, interpolate );
+      for ( const QVector< double > &values : blockValues )
+      {
+        if ( !writeRow( values ) )
+          return 1;
+      }
+      row += rows.size();
+    }
+
+    if ( feedback )
+    {
+      if ( feedback->isCanceled() )
+      {
+        return 3;
+      }
+      feedback->setProgress( 100.0 * row / static_cast< double >( mNumRows ) );
+    }
+  }
+
+  return 0;
+}
+
+QVector< double > QgsGridFileWriter::interpolateRow( int row, QgsFeedback *feedback ) const
+{
+  QVector< double > values( mNumColumns );
+
+  const double currentYValue = mInterpolationExtent.yMaximum() - mCellSizeY / 2.0 - row * mCellSizeY; //calculate value in the center of the cell
+  double currentXValue = mInterpolationExtent.xMinimum() + mCellSizeX / 2.0; //calculate value in the center of the cell
+  double interpolatedValue;
+
+  for ( int j = 0; j < mNumColumns; ++j )
+  {
+    if ( mInterpolator->interpolatePoint( currentXValue, currentYValue, interpolatedValue, feedback ) == 0 )
+    {
+      values[j] = interpolatedValue;
+    }
+    else
+    {
+      values[j] = NODATA_VALUE;
+    }
+    currentXValue += mCellSizeX;
+  }
+
+  return values;
+}
+
 int QgsGridFileWriter::writeHeader( QTextStream &outStream )
 {
   outStream << "NCOLS " << mNumColumns << Qt::endl;
@@ -21,16 +21,20 @@
 #include "qgsrectangle.h"
 #include <QString>
 #include <QTextStream>
+#include <QVector>
 #include "qgis_analysis.h"
 
+#include <functional>
+
 class QgsInterpolator;
 class QgsFeedback;
 
-//todo: extend such that writing to other file types is possible
-
 /**
  * \ingroup analysis
- * \brief A class that does interpolation to a grid and writes the results to an ascii grid.
+ * \brief A class that does interpolation to a grid and writes the results to an ascii grid,
+ * or to a tiled GeoTIFF file since QGIS 3.30 when the output file has a .tif or .tiff extension.
+ *
+ * The rows of the grid are interpolated in parallel when the interpolator supports it.
 */
 class ANALYSIS_EXPORT QgsGridFileWriter
 {
@@ -60,6 +64,27 @@ class ANALYSIS_EXPORT QgsGridFileWriter
 
     int writeHeader( QTextStream &outStream );
 
+#ifndef SIP_RUN
+
+    //! Writes the grid to an ascii grid file
+    int writeAsciiGrid( QgsFeedback *feedback );
+
+    //! Writes the grid to a tiled GeoTIFF file
+    int writeGeoTiff( QgsFeedback *feedback );
+
+    /**
+     * Interpolates the rows of the grid from top to bottom, passing the values of each row to \a writeRow,
+     * which returns FALSE if the row could not be written.
+     *
+     * \returns 0 in case of success, 1 if a row could not be written, or 3 if the \a feedback was canceled
+     */
+    int interpolateRows( const std::function< bool( const QVector< double > & ) > &writeRow, QgsFeedback *feedback );
+
+    //! Interpolates the values of the grid row at \a row, set to the no data value where they cannot be interpolated
+    QVector< double > interpolateRow( int row, QgsFeedback *feedback ) const;
+
+#endif
+
     QgsInterpolator *mInterpolator = nullptr;
     QString mOutputFilePath;
     QgsRectangle mInterpolationExtent;
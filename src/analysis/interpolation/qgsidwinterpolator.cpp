@@ -17,13 +17,63 @@
 
 #include "qgsidwinterpolator.h"
 #include "qgis.h"
+#include "qgsrectangle.h"
+#include "qgsspatialindexkdbushdata.h"
+#include "kdbush.hpp"
 #include <cmath>
 #include <limits>
 
+///@cond PRIVATE
+
+/**
+ * KDBush index of the cached vertices of an IDW interpolator, storing the index of
+ * each vertex in place of a feature ID.
+ */
+class QgsIDWVertexIndex : public kdbush::KDBush< std::pair<double, double>, QgsSpatialIndexKDBushData, std::size_t >
+{
+  public:
+
+    explicit QgsIDWVertexIndex( const QVector<QgsInterpolatorVertexData> &vertices )
+    {
+      double xMin = std::numeric_limits<double>::max();
+      double yMin = std::numeric_limits<double>::max();
+      double xMax = std::numeric_limits<double>::lowest();
+      double yMax = std::numeric_limits<double>::lowest();
+
+      points.reserve( vertices.size() );
+      for ( int i = 0; i < vertices.size(); ++i )
+      {
+        const QgsInterpolatorVertexData &vertex = vertices.at( i );
+        points.emplace_back( QgsSpatialIndexKDBushData( i, vertex.x, vertex.y ) );
+        xMin = std::min( xMin, vertex.x );
+        yMin = std::min( yMin, vertex.y );
+        xMax = std::max( xMax, vertex.x );
+        yMax = std::max( yMax, vertex.y );
+      }
+
+      if ( !points.empty() )
+      {
+        mExtent = QgsRectangle( xMin, yMin, xMax, yMax );
+        sortKD( 0, points.size() - 1, 0 );
+      }
+    }
+
+    //! Returns the extent of the indexed vertices
+    QgsRectangle extent() const { return mExtent; }
+
+  private:
+
+    QgsRectangle mExtent;
+};
+
+///@endcond
+
 QgsIDWInterpolator::QgsIDWInterpolator( const QList<LayerData> &layerData )
   : QgsInterpolator( layerData )
 {}
 
+QgsIDWInterpolator::~QgsIDWInterpolator() = default;
+
 int QgsIDWInterpolator::interpolatePoint( double x, double y, double &result, QgsFeedback *feedback )
 {
   if ( !mDataIsCached )
@@ -34,17 +84,44 @@ int QgsIDWInterpolator::interpolatePoint( double x, double y, double &result, Qg
   double sumCounter = 0;
   double sumDenominator = 0;
 
-  for ( const QgsInterpolatorVertexData &vertex : std::as_const( mCachedBaseData ) )
+  // returns TRUE if the vertex is at the interpolated location, setting the result to its value
+  const auto addVertex = [this, x, y, &result, &sumCounter, &sumDenominator]( const QgsInterpolatorVertexData & vertex ) -> bool
   {
     double distance = std::sqrt( ( vertex.x - x ) * ( vertex.x - x ) + ( vertex.y - y ) * ( vertex.y - y ) );
     if ( qgsDoubleNear( distance, 0.0 ) )
     {
       result = vertex.z;
-      return 0;
+      return true;
     }
     double currentWeight = 1 / ( std::pow( distance, mDistanceCoefficient ) );
     sumCounter += ( currentWeight * vertex.z );
     sumDenominator += currentWeight;
+    return false;
+  };
+
+  if ( mMaxPointCount <= 0 && mSearchRadius <= 0 )
+  {
+    for ( const QgsInterpolatorVertexData &vertex : std::as_const( mCachedBaseData ) )
+    {
+      if ( addVertex( vertex ) )
+        return 0;
+    }
+  }
+  else
+  {
+    if ( !mIndex )
+    {
+      mIndex = std::make_unique< QgsIDWVertexIndex >( mCachedBaseData );
+      const QgsRectangle extent = mIndex->extent();
+      mAreaPerVertex = !mCachedBaseData.isEmpty() ? extent.width() * extent.height() / mCachedBaseData.size() : 0;
+    }
+
+    const QVector<int> vertices = nearestVertices( x, y );
+    for ( const int vertexIdx : vertices )
+    {
+      if ( addVertex( mCachedBaseData.at( vertexIdx ) ) )
+        return 0;
+    }
   }
 
   if ( sumDenominator == 0.0 )
@@ -55,3 +132,60 @@ int QgsIDWInterpolator::interpolatePoint( double x, double y, double &result, Qg
   result = sumCounter / sumDenominator;
   return 0;
 }
+
+QVector<int> QgsIDWInterpolator::nearestVertices( double x, double y ) const
+{
+  // squared distances and indices of the vertices found within the search radius
+  QVector< QPair< double, int > > candidates;
+  const auto searchWithin = [this, x, y, &candidates]( double radius )
+  {
+    candidates.clear();
+    mIndex->within( x, y, radius, [x, y, &candidates]( const QgsSpatialIndexKDBushData & data )
+    {
+      const double dx = data.coords.first - x;
+      const double dy = data.coords.second - y;
+      candidates.append( qMakePair( dx * dx + dy * dy, static_cast< int >( data.id ) ) );
+    } );
+  };
+
+  if ( mMaxPointCount <= 0 )
+  {
+    searchWithin( mSearchRadius );
+  }
+  else
+  {
+    // radius containing all vertices, or the search radius if it is smaller
+    const QgsRectangle extent = mIndex->extent();
+    const double dx = std::max( std::fabs( x - extent.xMinimum() ), std::fabs( x - extent.xMaximum() ) );
+    const double dy = std::max( std::fabs( y - extent.yMinimum() ), std::fabs( y - extent.yMaximum() ) );
+    double maxRadius = std::sqrt( dx * dx + dy * dy );
+    if ( mSearchRadius > 0 )
+      maxRadius = std::min( maxRadius, mSearchRadius );
+
+    // start from the radius expected to contain the requested count of vertices if they are evenly
+    // distributed, and double it until enough vertices are found
+    double radius = std::sqrt( mMaxPointCount * mAreaPerVertex / M_PI );
+    if ( !( radius > 0 ) || radius > maxRadius )
+      radius = maxRadius;
+
+    while ( true )
+    {
+      searchWithin( radius );
+      if ( candidates.size() >= mMaxPointCount || radius >= maxRadius )
+        break;
+      radius = std::min( radius * 2, maxRadius );
+    }
+
+    if ( candidates.size() > mMaxPointCount )
+    {
+      std::nth_element( candidates.begin(), candidates.begin() + mMaxPointCount, candidates.end() );
+      candidates.resize( mMaxPointCount );
+    }
+  }
+
+  QVector<int> vertices;
+  vertices.reserve( candidates.size() );
+  for ( const QPair< double, int > &candidate : std::as_const( candidates ) )
+    vertices.append( candidate.second );
+  return vertices;
+}
@@ -21,6 +21,12 @@
 #include "qgsinterpolator.h"
 #include "qgis_analysis.h"
 
+#include <memory>
+
+#ifndef SIP_RUN
+class QgsIDWVertexIndex;
+#endif
+
 /**
  * \ingroup analysis
  * \class QgsIDWInterpolator
@@ -35,7 +41,10 @@ class ANALYSIS_EXPORT QgsIDWInterpolator: public QgsInterpolator
      */
     QgsIDWInterpolator( const QList<QgsInterpolator::LayerData> &layerData );
 
+    ~QgsIDWInterpolator() override;
+
     int interpolatePoint( double x, double y, double &result SIP_OUT, QgsFeedback *feedback = nullptr ) override;
+    bool supportsParallelInterpolation() const override { return true; }
 
     /**
      * Sets the distance \a coefficient, the parameter that sets how the values are
@@ -60,11 +69,68 @@ class ANALYSIS_EXPORT QgsIDWInterpolator: public QgsInterpolator
     */
     double distanceCoefficient() const { return mDistanceCoefficient; }
 
+    /**
+     * Sets the maximum number of points used to interpolate a value, which are then the
+     * nearest points to the interpolated location.
+     *
+     * Limiting the number of points uses a spatial index of the points, which makes the interpolation
+     * of large datasets much faster. A \a count of 0 means that all points are used.
+     *
+     * \see maxPointCount()
+     * \since QGIS 3.30
+     */
+    void setMaxPointCount( int count ) { mMaxPointCount = count; }
+
+    /**
+     * Returns the maximum number of points used to interpolate a value, which are then the
+     * nearest points to the interpolated location. The default is 0, meaning that all points are used.
+     *
+     * \see setMaxPointCount()
+     * \since QGIS 3.30
+     */
+    int maxPointCount() const { return mMaxPointCount; }
+
+    /**
+     * Sets the search \a radius, the maximum distance of the points used to interpolate a value.
+     *
+     * Locations with no points within the radius cannot be interpolated. Limiting the radius uses
+     * a spatial index of the points, which makes the interpolation of large datasets much faster.
+     * A \a radius of 0 means that the distance of the points is not limited.
+     *
+     * \see searchRadius()
+     * \since QGIS 3.30
+     */
+    void setSearchRadius( double radius ) { mSearchRadius = radius; }
+
+    /**
+     * Returns the search radius, the maximum distance of the points used to interpolate a value.
+     * The default is 0, meaning that the distance of the points is not limited.
+     *
+     * \see setSearchRadius()
+     * \since QGIS 3.30
+     */
+    double searchRadius() const { return mSearchRadius; }
+
   private:
 
     QgsIDWInterpolator() = delete;
 
+#ifdef SIP_RUN
+    QgsIDWInterpolator( const QgsIDWInterpolator &other );
+#endif
+
+    //! Returns the indices of the cached vertices used to interpolate the value at x, y
+    QVector<int> nearestVertices( double x, double y ) const;
+
     double mDistanceCoefficient = 2.0;
+    int mMaxPointCount = 0;
+    double mSearchRadius = 0;
+
+#ifndef SIP_RUN
+    std::unique_ptr< QgsIDWVertexIndex > mIndex;
+#endif
+    //! Approximate area covered by each cached vertex, estimated when the index is built
+    double mAreaPerVertex = 0;
 };
 
 #endif
@@ -112,6 +112,8 @@ QgsInterpolator::Result QgsInterpolator::cacheBaseData( QgsFeedback *feedback )
     layerCount++;
   }
 
+  // also flag sources without any vertex as cached, so that they are not read again for each interpolated point
+  mDataIsCached = true;
   return Success;
 }
 
@@ -134,6 +134,16 @@ class ANALYSIS_EXPORT QgsInterpolator
      */
     virtual int interpolatePoint( double x, double y, double &result SIP_OUT, QgsFeedback *feedback = nullptr ) = 0;
 
+    /**
+     * Returns TRUE if interpolatePoint() can be called from several threads at the same time,
+     * once a first point has been interpolated.
+     *
+     * The default implementation returns FALSE.
+     *
+     * \since QGIS 3.30
+     */
+    virtual bool supportsParallelInterpolation() const { return false; }
+
     //! \note not available in Python bindings
     QList<LayerData> layerData() const { return mLayerData; } SIP_SKIP
 
@@ -142,6 +142,7 @@ void QgsTinInterpolator::initialize()
       }
     }
   }
+  addPendingPoints();
 
   if ( mInterpolation == CloughTocher )
   {
@@ -311,6 +312,8 @@ int QgsTinInterpolator::insertData( const QgsFeature &f, QgsInterpolator::ValueS
                   break;
               }
             }
+            // points are inserted before the lines read after them
+            addPendingPoints();
             mTriangulation->addLine( linePoints, type );
           }
           break;
@@ -348,10 +351,17 @@ int QgsTinInterpolator::addPointsFromGeometry( const QgsGeometry &g, ValueSource
         z = p.m();
         break;
     }
-    if ( mTriangulation->addPoint( QgsPoint( p.x(), p.y(), z ) ) == -100 )
-    {
-      return -1;
-    }
+    // points are added in bulk to the triangulation, which is much faster for large sets of points
+    mPendingPoints.append( QgsPoint( p.x(), p.y(), z ) );
   }
   return 0;
 }
+
+void QgsTinInterpolator::addPendingPoints()
+{
+  if ( mPendingPoints.isEmpty() )
+    return;
+
+  mTriangulation->addPoints( mPendingPoints, mFeedback );
+  mPendingPoints.clear();
+}
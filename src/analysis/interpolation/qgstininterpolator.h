@@ -19,7 +19,9 @@
 #define QGSTININTERPOLATOR_H
 
 #include "qgsinterpolator.h"
+#include "qgspoint.h"
 #include <QString>
+#include <QVector>
 #include "qgis_analysis.h"
 
 class QgsFeatureSink;
@@ -100,6 +102,12 @@ class ANALYSIS_EXPORT QgsTinInterpolator: public QgsInterpolator
     int insertData( const QgsFeature &f, QgsInterpolator::ValueSource source, int attr, SourceType type );
 
     int addPointsFromGeometry( const QgsGeometry &g, ValueSource source, double attributeValue );
+
+    //! Adds the pending points to the triangulation at once
+    void addPendingPoints();
+
+    //! Points waiting to be added in bulk to the triangulation
+    QVector< QgsPoint > mPendingPoints;
 };
 
 #endif
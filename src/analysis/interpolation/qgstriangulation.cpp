@@ -14,6 +14,21 @@
  ***************************************************************************/
 #include "qgstriangulation.h"
 #include "qgsfields.h"
+#include "qgsfeedback.h"
+
+bool QgsTriangulation::addPoints( const QVector< QgsPoint > &points, QgsFeedback *feedback )
+{
+  bool ok = true;
+  for ( const QgsPoint &point : points )
+  {
+    if ( feedback && feedback->isCanceled() )
+      return false;
+
+    if ( addPoint( point ) == -100 )
+      ok = false;
+  }
+  return ok;
+}
 
 QgsFields QgsTriangulation::triangulationFields()
 {
@@ -63,6 +63,20 @@ class ANALYSIS_EXPORT QgsTriangulation
      */
     virtual int addPoint( const QgsPoint &point ) = 0;
 
+    /**
+     * Adds a set of \a points to the triangulation.
+     *
+     * The points should have z-values matching the value to interpolate. Triangulations may change
+     * the order in which the points are inserted to build the triangulation faster, but the points
+     * keep their order in the triangulation.
+     *
+     * The default implementation adds the points one after the other with addPoint().
+     *
+     * \returns FALSE if a point could not be inserted, or if the \a feedback was canceled
+     * \since QGIS 3.30
+     */
+    virtual bool addPoints( const QVector< QgsPoint > &points, QgsFeedback *feedback = nullptr );
+
     /**
      * Calculates the normal at a point on the surface and assigns it to 'result'.
      * \returns TRUE in case of success and FALSE in case of failure
@@ -42,6 +42,7 @@ bool QgsMeshTriangulation::addVertices( QgsFeatureIterator &vertexFeatureIterato
 
   QgsFeature feat;
   long i = 0;
+  QVector<QgsPoint> vertices;
   while ( vertexFeatureIterator.nextFeature( feat ) )
   {
     if ( feedback )
@@ -53,9 +54,12 @@ bool QgsMeshTriangulation::addVertices( QgsFeatureIterator &vertexFeatureIterato
       i++;
     }
 
-    addVerticesFromFeature( feat, valueAttribute, transform, feedback );
+    addVerticesFromFeature( feat, valueAttribute, transform, vertices, feedback );
   }
 
+  // adding all vertices at once is much faster than adding them one after the other
+  mTriangulation->addPoints( vertices, feedback );
+
   return true;
 }
 
@@ -81,8 +85,12 @@ bool QgsMeshTriangulation::addBreakLines( QgsFeatureIterator &lineFeatureIterato
     switch ( geomType )
     {
       case QgsWkbTypes::PointGeometry:
-        addVerticesFromFeature( feat, valueAttribute, transform, feedback );
+      {
+        QVector<QgsPoint> vertices;
+        addVerticesFromFeature( feat, valueAttribute, transform, vertices, feedback );
+        mTriangulation->addPoints( vertices, feedback );
         break;
+      }
       case QgsWkbTypes::LineGeometry:
       case QgsWkbTypes::PolygonGeometry:
         addBreakLinesFromFeature( feat, valueAttribute, transform, feedback );
@@ -110,7 +118,7 @@ void QgsMeshTriangulation::setCrs( const QgsCoordinateReferenceSystem &crs )
   mCrs = crs;
 }
 
-void QgsMeshTriangulation::addVerticesFromFeature( const QgsFeature &feature, int valueAttribute, const QgsCoordinateTransform &transform, QgsFeedback *feedback )
+void QgsMeshTriangulation::addVerticesFromFeature( const QgsFeature &feature, int valueAttribute, const QgsCoordinateTransform &transform, QVector<QgsPoint> &vertices, QgsFeedback *feedback )
 {
   QgsGeometry geom = feature.geometry();
   try
@@ -135,10 +143,10 @@ void QgsMeshTriangulation::addVerticesFromFeature( const QgsFeature &feature, in
     if ( feedback && feedback->isCanceled() )
       break;
     if ( valueAttribute < 0 )
-      mTriangulation->addPoint( *vit );
+      vertices.append( *vit );
     else
     {
-      mTriangulation->addPoint( QgsPoint( QgsWkbTypes::PointZ, ( *vit ).x(), ( *vit ).y(), value ) );
+      vertices.append( QgsPoint( QgsWkbTypes::PointZ, ( *vit ).x(), ( *vit ).y(), value ) );
     }
     ++vit;
   }
@@ -94,7 +94,8 @@ class ANALYSIS_EXPORT QgsMeshTriangulation : public QObject
     QgsCoordinateReferenceSystem mCrs;
     std::unique_ptr<QgsTriangulation> mTriangulation;
 
-    void addVerticesFromFeature( const QgsFeature &feature, int valueAttribute, const QgsCoordinateTransform &transform, QgsFeedback *feedback = nullptr );
+    //! Appends the vertices of a \a feature to \a vertices, to be added in bulk to the triangulation
+    void addVerticesFromFeature( const QgsFeature &feature, int valueAttribute, const QgsCoordinateTransform &transform, QVector<QgsPoint> &vertices, QgsFeedback *feedback = nullptr );
     void addBreakLinesFromFeature( const QgsFeature &feature, int valueAttribute, const QgsCoordinateTransform &transform, QgsFeedback *feedback = nullptr );
 };
 
@@ -0,0 +1,119 @@
+/***************************************************************************
+  qgscompactgraph.cpp
+  --------------------------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+****************************************************************************
+*                                                                          *
+*   This program is free software; you can redistribute it and/or modify   *
+*   it under the terms of the GNU General Public License as published by   *
+*   the Free Software Foundation; either version 2 of the License, or      *
+*   (at your option) any later version.                                    *
+*                                                                          *
+***************************************************************************/
+
+#include "qgscompactgraph.h"
+#include "qgsgraph.h"
+
+#include <algorithm>
+
+QgsCompactGraph::QgsCompactGraph( const QVector<QgsPointXY> &points, const QVector<int> &fromVertices, const QVector<int> &toVertices, const QVector< QVector<float> > &costs )
+  : mPoints( points )
+{
+  const int vertexCount = points.count();
+  const int inputEdgeCount = std::min( fromVertices.count(), toVertices.count() );
+
+  // count the edges of each vertex to find where their rows start
+  mOutgoingOffsets = QVector<int>( vertexCount + 1, 0 );
+  mIncomingOffsets = QVector<int>( vertexCount + 1, 0 );
+  int edgeCount = 0;
+  for ( int i = 0; i < inputEdgeCount; ++i )
+  {
+    const int from = fromVertices.at( i );
+    const int to = toVertices.at( i );
+    if ( from < 0 || from >= vertexCount || to < 0 || to >= vertexCount )
+      continue;
+    ++mOutgoingOffsets[ from + 1 ];
+    ++mIncomingOffsets[ to + 1 ];
+    ++edgeCount;
+  }
+  for ( int i = 0; i < vertexCount; ++i )
+  {
+    mOutgoingOffsets[ i + 1 ] += mOutgoingOffsets.at( i );
+    mIncomingOffsets[ i + 1 ] += mIncomingOffsets.at( i );
+  }
+
+  // place the edges in the rows of their start vertices, keeping their order within a row
+  mFromVertices = QVector<int>( edgeCount );
+  mToVertices = QVector<int>( edgeCount );
+  mCosts = QVector< QVector<float> >( costs.count(), QVector<float>( edgeCount, 0 ) );
+  mIncomingEdges = QVector<int>( edgeCount );
+  QVector<int> outgoingPositions = mOutgoingOffsets;
+  QVector<int> incomingPositions = mIncomingOffsets;
+  for ( int i = 0; i < inputEdgeCount; ++i )
+  {
+    const int from = fromVertices.at( i );
+    const int to = toVertices.at( i );
+    if ( from < 0 || from >= vertexCount || to < 0 || to >= vertexCount )
+      continue;
+
+    const int edge = outgoingPositions[ from ]++;
+    mFromVertices[ edge ] = from;
+    mToVertices[ edge ] = to;
+    for ( int strategy = 0; strategy < costs.count(); ++strategy )
+    {
+      if ( i < costs.at( strategy ).count() )
+        mCosts[ strategy ][ edge ] = costs.at( strategy ).at( i );
+    }
+  }
+
+  // the incoming edges are filled by increasing edge index
+  for ( int edge = 0; edge < edgeCount; ++edge )
+    mIncomingEdges[ incomingPositions[ mToVertices.at( edge ) ]++ ] = edge;
+}
+
+QgsCompactGraph QgsCompactGraph::fromGraph( const QgsGraph &graph )
+{
+  QVector<QgsPointXY> points( graph.vertexCount() );
+  for ( int i = 0; i < graph.vertexCount(); ++i )
+  {
+    if ( graph.hasVertex( i ) )
+      points[ i ] = graph.vertex( i ).point();
+  }
+
+  QVector<int> fromVertices;
+  QVector<int> toVertices;
+  QVector< QVector<float> > costs;
+  fromVertices.reserve( graph.edgeCount() );
+  toVertices.reserve( graph.edgeCount() );
+  for ( int i = 0; i < graph.edgeCount(); ++i )
+  {
+    if ( !graph.hasEdge( i ) )
+      continue;
+
+    const QgsGraphEdge &edge = graph.edge( i );
+    const QVector< QVariant > strategies = edge.strategies();
+    if ( costs.count() < strategies.count() )
+      costs.resize( strategies.count() );
+    for ( int strategy = 0; strategy < strategies.count(); ++strategy )
+    {
+      // costs of the edges added before without this strategy are zero
+      costs[ strategy ].resize( fromVertices.count() );
+      costs[ strategy ].append( strategies.at( strategy ).toFloat() );
+    }
+    fromVertices.append( edge.fromVertex() );
+    toVertices.append( edge.toVertex() );
+  }
+
+  return QgsCompactGraph( points, fromVertices, toVertices, costs );
+}
+
+int QgsCompactGraph::findVertex( const QgsPointXY &pt ) const
+{
+  return mPoints.indexOf( pt );
+}
+
+QVector<int> QgsCompactGraph::incomingEdges( int vertexIdx ) const
+{
+  return mIncomingEdges.mid( mIncomingOffsets.at( vertexIdx ), mIncomingOffsets.at( vertexIdx + 1 ) - mIncomingOffsets.at( vertexIdx ) );
+}
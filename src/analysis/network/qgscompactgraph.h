@@ -0,0 +1,134 @@
+/***************************************************************************
+  qgscompactgraph.h
+  --------------------------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+****************************************************************************
+*                                                                          *
+*   This program is free software; you can redistribute it and/or modify   *
+*   it under the terms of the GNU General Public License as published by   *
+*   the Free Software Foundation; either version 2 of the License, or      *
+*   (at your option) any later version.                                    *
+*                                                                          *
+***************************************************************************/
+
+#ifndef QGSCOMPACTGRAPH_H
+#define QGSCOMPACTGRAPH_H
+
+#include <QVector>
+
+#include "qgspointxy.h"
+#include "qgis_sip.h"
+#include "qgis_analysis.h"
+
+class QgsGraph;
+
+/**
+ * \ingroup analysis
+ * \class QgsCompactGraph
+ * \brief An immutable graph stored in compact arrays, for the analysis of large networks.
+ *
+ * Unlike QgsGraph, which stores each vertex and edge as an object with its own list of
+ * edges and strategy costs, QgsCompactGraph stores the edges sorted by their start vertex in
+ * a few flat arrays (in compressed sparse row form), with the cost of each strategy in an array of
+ * single precision floats. This uses a fraction of the memory of a QgsGraph and gives
+ * cache friendly access to the outgoing edges of a vertex.
+ *
+ * The edges are indexed in the order of their start vertices: the outgoing edges of a vertex are the
+ * consecutive edges from firstOutgoingEdge() to firstOutgoingEdge() + outgoingEdgeCount() - 1.
+ *
+ * A compact graph can be built by QgsCompactGraphBuilder, or converted from a QgsGraph with fromGraph().
+ *
+ * \see QgsCompactGraphBuilder
+ * \since QGIS 3.30
+ */
+class ANALYSIS_EXPORT QgsCompactGraph
+{
+  public:
+
+    //! Constructor for an empty QgsCompactGraph
+    QgsCompactGraph() = default;
+
+    /**
+     * Constructs a graph from its vertex \a points and its edges, given by their \a fromVertices and \a toVertices
+     * indices and by the \a costs of each strategy, with a cost per edge for each strategy.
+     *
+     * Edges with invalid vertex indices are skipped.
+     */
+    QgsCompactGraph( const QVector<QgsPointXY> &points, const QVector<int> &fromVertices, const QVector<int> &toVertices, const QVector< QVector<float> > &costs );
+
+    /**
+     * Converts a \a graph to a compact graph.
+     *
+     * The vertices keep their indices, but edges are reordered by their start vertex.
+     * Edge costs are converted to single precision floats.
+     */
+    static QgsCompactGraph fromGraph( const QgsGraph &graph );
+
+    //! Returns the number of vertices of the graph
+    int vertexCount() const { return mPoints.count(); }
+
+    //! Returns the number of edges of the graph
+    int edgeCount() const { return mToVertices.count(); }
+
+    //! Returns the number of optimization strategies of the edge costs
+    int strategyCount() const { return mCosts.count(); }
+
+    //! Returns the point of the vertex at \a vertexIdx
+    QgsPointXY vertexPoint( int vertexIdx ) const { return mPoints.at( vertexIdx ); }
+
+    /**
+     * Returns the index of the first vertex at the point \a pt, or -1 if there is no vertex at this point.
+     */
+    int findVertex( const QgsPointXY &pt ) const;
+
+    //! Returns the index of the first outgoing edge of the vertex at \a vertexIdx
+    int firstOutgoingEdge( int vertexIdx ) const { return mOutgoingOffsets.at( vertexIdx ); }
+
+    //! Returns the number of outgoing edges of the vertex at \a vertexIdx
+    int outgoingEdgeCount( int vertexIdx ) const { return mOutgoingOffsets.at( vertexIdx + 1 ) - mOutgoingOffsets.at( vertexIdx ); }
+
+    //! Returns the indices of the incoming edges of the vertex at \a vertexIdx
+    QVector<int> incomingEdges( int vertexIdx ) const;
+
+    //! Returns the index of the start vertex of the edge at \a edgeIdx
+    int edgeFromVertex( int edgeIdx ) const { return mFromVertices.at( edgeIdx ); }
+
+    //! Returns the index of the end vertex of the edge at \a edgeIdx
+    int edgeToVertex( int edgeIdx ) const { return mToVertices.at( edgeIdx ); }
+
+    //! Returns the cost of the edge at \a edgeIdx for the strategy at \a strategyIndex
+    double edgeCost( int edgeIdx, int strategyIndex ) const { return mCosts.at( strategyIndex ).at( edgeIdx ); }
+
+#ifndef SIP_RUN
+
+    /**
+     * Returns the costs of all edges for the strategy at \a strategyIndex, indexed by edge.
+     *
+     * \note not available in Python bindings
+     */
+    const QVector<float> &edgeCosts( int strategyIndex ) const { return mCosts.at( strategyIndex ); }
+
+    /**
+     * Returns the end vertices of all edges, indexed by edge.
+     *
+     * \note not available in Python bindings
+     */
+    const QVector<int> &edgeToVertices() const { return mToVertices; }
+
+#endif
+
+  private:
+
+    QVector<QgsPointXY> mPoints;
+    //! first edge of each vertex, with an extra entry for the edge count
+    QVector<int> mOutgoingOffsets;
+    QVector<int> mFromVertices;
+    QVector<int> mToVertices;
+    QVector< QVector<float> > mCosts;
+    //! incoming edges of each vertex (compressed rows)
+    QVector<int> mIncomingOffsets;
+    QVector<int> mIncomingEdges;
+};
+
+#endif // QGSCOMPACTGRAPH_H
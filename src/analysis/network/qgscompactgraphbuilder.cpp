@@ -0,0 +1,53 @@
+/***************************************************************************
+  qgscompactgraphbuilder.cpp
+  --------------------------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+****************************************************************************
+*                                                                          *
+*   This program is free software; you can redistribute it and/or modify   *
+*   it under the terms of the GNU General Public License as published by   *
+*   the Free Software Foundation; either version 2 of the License, or      *
+*   (at your option) any later version.                                    *
+*                                                                          *
+***************************************************************************/
+
+#include "qgscompactgraphbuilder.h"
+#include "qgscompactgraph.h"
+
+QgsCompactGraphBuilder::QgsCompactGraphBuilder( const QgsCoordinateReferenceSystem &crs, bool otfEnabled, double topologyTolerance, const QString &ellipsoidID )
+  : QgsGraphBuilderInterface( crs, otfEnabled, topologyTolerance, ellipsoidID )
+{
+}
+
+void QgsCompactGraphBuilder::addVertex( int, const QgsPointXY &pt )
+{
+  mPoints.append( pt );
+}
+
+void QgsCompactGraphBuilder::addEdge( int pt1id, const QgsPointXY &, int pt2id, const QgsPointXY &, const QVector< QVariant > &prop )
+{
+  if ( mCosts.count() < prop.count() )
+    mCosts.resize( prop.count() );
+  for ( int strategy = 0; strategy < prop.count(); ++strategy )
+  {
+    // costs of the edges added before without this strategy are zero
+    mCosts[ strategy ].resize( mFromVertices.count() );
+    mCosts[ strategy ].append( prop.at( strategy ).toFloat() );
+  }
+  mFromVertices.append( pt1id );
+  mToVertices.append( pt2id );
+}
+
+QgsCompactGraph *QgsCompactGraphBuilder::takeCompactGraph()
+{
+  QgsCompactGraph *res = new QgsCompactGraph( mPoints, mFromVertices, mToVertices, mCosts );
+
+  // reset the builder in case it is used for additional work
+  mPoints.clear();
+  mFromVertices.clear();
+  mToVertices.clear();
+  mCosts.clear();
+
+  return res;
+}
@@ -0,0 +1,65 @@
+/***************************************************************************
+  qgscompactgraphbuilder.h
+  --------------------------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+****************************************************************************
+*                                                                          *
+*   This program is free software; you can redistribute it and/or modify   *
+*   it under the terms of the GNU General Public License as published by   *
+*   the Free Software Foundation; either version 2 of the License, or      *
+*   (at your option) any later version.                                    *
+*                                                                          *
+***************************************************************************/
+
+#ifndef QGSCOMPACTGRAPHBUILDER_H
+#define QGSCOMPACTGRAPHBUILDER_H
+
+#include "qgsgraphbuilderinterface.h"
+#include "qgis_sip.h"
+#include "qgis_analysis.h"
+
+class QgsCompactGraph;
+
+/**
+ * \ingroup analysis
+ * \class QgsCompactGraphBuilder
+ * \brief Builds a QgsCompactGraph, as an alternative to QgsGraphBuilder for large networks.
+ *
+ * The builder can be used with any graph director, such as QgsVectorLayerDirector. The vertices
+ * and edges are collected in flat arrays with single precision costs, and turned into a compact graph
+ * by takeCompactGraph(), without building a QgsGraph.
+ *
+ * \since QGIS 3.30
+ */
+class ANALYSIS_EXPORT QgsCompactGraphBuilder : public QgsGraphBuilderInterface SIP_NODEFAULTCTORS
+{
+  public:
+
+    /**
+     * Constructor for QgsCompactGraphBuilder, with the same arguments as QgsGraphBuilder.
+     */
+    QgsCompactGraphBuilder( const QgsCoordinateReferenceSystem &crs, bool otfEnabled = true, double topologyTolerance = 0.0, const QString &ellipsoidID = "WGS84" );
+
+    void addVertex( int id, const QgsPointXY &pt ) override;
+
+    void addEdge( int pt1id, const QgsPointXY &pt1, int pt2id, const QgsPointXY &pt2, const QVector< QVariant > &prop ) override;
+
+    /**
+     * Takes the generated graph from the builder, resetting the builder back to its initial
+     * state ready for additional graph construction.
+     */
+    QgsCompactGraph *takeCompactGraph() SIP_FACTORY;
+
+  private:
+
+    QVector<QgsPointXY> mPoints;
+    QVector<int> mFromVertices;
+    QVector<int> mToVertices;
+    QVector< QVector<float> > mCosts;
+
+    QgsCompactGraphBuilder( const QgsCompactGraphBuilder & ) = delete;
+    QgsCompactGraphBuilder &operator=( const QgsCompactGraphBuilder & ) = delete;
+};
+
+#endif // QGSCOMPACTGRAPHBUILDER_H
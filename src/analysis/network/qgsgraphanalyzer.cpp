@@ -14,6 +14,7 @@
 ***************************************************************************/
 
 #include <limits>
+#include <queue>
 
 #include <QMap>
 #include <QVector>
@@ -21,6 +22,7 @@
 
 #include "qgsgraph.h"
 #include "qgsgraphanalyzer.h"
+#include "qgscompactgraph.h"
 
 void QgsGraphAnalyzer::dijkstra( const QgsGraph *source, int startPointIdx, int criterionNum, QVector<int> *resultTree, QVector<double> *resultCost )
 {
@@ -88,6 +90,62 @@ void QgsGraphAnalyzer::dijkstra( const QgsGraph *source, int startPointIdx, int
   }
 }
 
+void QgsGraphAnalyzer::dijkstra( const QgsCompactGraph *source, int startVertexIdx, int criterionNum, QVector<int> *resultTree, QVector<double> *resultCost )
+{
+  if ( startVertexIdx < 0 || startVertexIdx >= source->vertexCount() || criterionNum < 0 || criterionNum >= source->strategyCount() )
+  {
+    // invalid start point or strategy
+    return;
+  }
+
+  QVector< double > costs( source->vertexCount(), std::numeric_limits<double>::infinity() );
+  costs[ startVertexIdx ] = 0.0;
+
+  if ( resultTree )
+  {
+    resultTree->clear();
+    resultTree->insert( resultTree->begin(), source->vertexCount(), -1 );
+  }
+
+  const QVector<float> &edgeCosts = source->edgeCosts( criterionNum );
+  const QVector<int> &toVertices = source->edgeToVertices();
+
+  // binary heap of ( cost, vertex ), with outdated entries skipped when popped
+  typedef std::pair< double, int > QueueEntry;
+  std::priority_queue< QueueEntry, std::vector< QueueEntry >, std::greater< QueueEntry > > queue;
+  queue.push( QueueEntry( 0.0, startVertexIdx ) );
+
+  while ( !queue.empty() )
+  {
+    const QueueEntry entry = queue.top();
+    queue.pop();
+    const double curCost = entry.first;
+    const int curVertex = entry.second;
+    if ( curCost > costs.at( curVertex ) )
+      continue;
+
+    const int firstEdge = source->firstOutgoingEdge( curVertex );
+    const int lastEdge = firstEdge + source->outgoingEdgeCount( curVertex );
+    for ( int edgeId = firstEdge; edgeId < lastEdge; ++edgeId )
+    {
+      const int toVertex = toVertices.at( edgeId );
+      const double cost = curCost + edgeCosts.at( edgeId );
+      if ( cost < costs.at( toVertex ) )
+      {
+        costs[ toVertex ] = cost;
+        if ( resultTree )
+        {
+          ( *resultTree )[ toVertex ] = edgeId;
+        }
+        queue.push( QueueEntry( cost, toVertex ) );
+      }
+    }
+  }
+
+  if ( resultCost )
+    *resultCost = costs;
+}
+
 QgsGraph *QgsGraphAnalyzer::shortestTree( const QgsGraph *source, int startVertexIdx, int criterionNum )
 {
   QgsGraph *treeResult = new QgsGraph();
@@ -22,6 +22,7 @@
 #include "qgis_analysis.h"
 
 class QgsGraph;
+class QgsCompactGraph;
 
 /**
  * \ingroup analysis
@@ -75,6 +76,19 @@ class ANALYSIS_EXPORT QgsGraphAnalyzer
     % End
 #endif
 
+    /**
+     * Solve shortest path problem using Dijkstra algorithm over a compact graph.
+     * \param source source graph
+     * \param startVertexIdx index of the start vertex
+     * \param criterionNum index of the optimization strategy
+     * \param resultTree array that represents shortest path tree. resultTree[ vertexIndex ] == inboundingArcIndex if vertex reachable, otherwise resultTree[ vertexIndex ] == -1.
+     * Note that the startVertexIdx will also have a value of -1 and may need special handling by callers.
+     * \param resultCost array of the paths costs
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    static void dijkstra( const QgsCompactGraph *source, int startVertexIdx, int criterionNum, QVector<int> *resultTree = nullptr, QVector<double> *resultCost = nullptr ) SIP_SKIP;
+
     /**
      * Returns shortest path tree with root-node in startVertexIdx
      * \param source source graph
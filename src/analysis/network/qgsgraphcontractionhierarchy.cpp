@@ -0,0 +1,636 @@
+/***************************************************************************
+  qgsgraphcontractionhierarchy.cpp
+  --------------------------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+****************************************************************************
+*                                                                          *
+*   This program is free software; you can redistribute it and/or modify   *
+*   it under the terms of the GNU General Public License as published by   *
+*   the Free Software Foundation; either version 2 of the License, or      *
+*   (at your option) any later version.                                    *
+*                                                                          *
+***************************************************************************/
+
+#include "qgsgraphcontractionhierarchy.h"
+#include "qgsgraph.h"
+#include "qgsfeedback.h"
+
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <functional>
+
+#include <QDataStream>
+#include <QFile>
+#include <QObject>
+#include <QtConcurrent>
+
+//! Maximum number of vertices settled by a witness search during the contraction
+static constexpr int WITNESS_SEARCH_MAX_SETTLED_VERTICES = 500;
+
+//! Identifies the files written by QgsGraphContractionHierarchy
+static constexpr quint32 FILE_MAGIC = 0x51474348;
+
+//! Version of the format of the files written by QgsGraphContractionHierarchy
+static constexpr qint32 FILE_VERSION = 1;
+
+typedef std::pair< double, int > QueueEntry;
+typedef std::priority_queue< QueueEntry, std::vector< QueueEntry >, std::greater< QueueEntry > > MinCostQueue;
+
+///@cond PRIVATE
+
+/**
+ * Remaining graph during the contraction of the vertices, with the witness searches
+ * that decide which shortcuts are needed.
+ */
+template <typename EdgeType>
+class QgsContractionGraph
+{
+  public:
+
+    QgsContractionGraph( QVector<EdgeType> &edges, int vertexCount )
+      : mEdges( edges )
+      , mOutgoing( vertexCount )
+      , mIncoming( vertexCount )
+      , mContracted( vertexCount, false )
+      , mContractedNeighbours( vertexCount, 0 )
+      , mWitnessCosts( vertexCount, std::numeric_limits<double>::infinity() )
+    {
+      for ( int i = 0; i < mEdges.count(); ++i )
+      {
+        mOutgoing[ mEdges.at( i ).fromVertex ].append( i );
+        mIncoming[ mEdges.at( i ).toVertex ].append( i );
+      }
+    }
+
+    /**
+     * Contracts a \a vertex, adding the shortcuts needed to keep the shortest paths through it.
+     * If \a simulate is TRUE the shortcuts are only counted.
+     * Returns the number of shortcuts.
+     */
+    int contract( int vertex, bool simulate )
+    {
+      int shortcuts = 0;
+      for ( const int inEdge : std::as_const( mIncoming[ vertex ] ) )
+      {
+        const int fromVertex = mEdges.at( inEdge ).fromVertex;
+        if ( mContracted.at( fromVertex ) )
+          continue;
+        const double inCost = mEdges.at( inEdge ).cost;
+
+        double maxCost = -1;
+        for ( const int outEdge : std::as_const( mOutgoing[ vertex ] ) )
+        {
+          const int toVertex = mEdges.at( outEdge ).toVertex;
+          if ( !mContracted.at( toVertex ) && toVertex != fromVertex )
+            maxCost = std::max( maxCost, inCost + mEdges.at( outEdge ).cost );
+        }
+        if ( maxCost < 0 )
+          continue;
+
+        witnessSearch( fromVertex, vertex, maxCost );
+
+        for ( const int outEdge : std::as_const( mOutgoing[ vertex ] ) )
+        {
+          const int toVertex = mEdges.at( outEdge ).toVertex;
+          if ( mContracted.at( toVertex ) || toVertex == fromVertex )
+            continue;
+
+          const double viaCost = inCost + mEdges.at( outEdge ).cost;
+          if ( mWitnessCosts.at( toVertex ) <= viaCost )
+            continue;  // there is a path as short without the vertex
+
+          // avoid adding several shortcuts for parallel edges
+          if ( std::isinf( mWitnessCosts.at( toVertex ) ) )
+            mTouched.append( toVertex );
+          mWitnessCosts[ toVertex ] = viaCost;
+          ++shortcuts;
+          if ( simulate )
+            continue;
+
+          EdgeType shortcut;
+          shortcut.fromVertex = fromVertex;
+          shortcut.toVertex = toVertex;
+          shortcut.cost = viaCost;
+          shortcut.firstEdge = inEdge;
+          shortcut.secondEdge = outEdge;
+          mOutgoing[ fromVertex ].append( mEdges.count() );
+          mIncoming[ toVertex ].append( mEdges.count() );
+          mEdges.append( shortcut );
+        }
+        resetWitnessCosts();
+      }
+      return shortcuts;
+    }
+
+    //! Returns the contraction priority of a \a vertex: vertices with the lowest priorities are contracted first
+    int priority( int vertex )
+    {
+      const int shortcuts = contract( vertex, true );
+      int removedEdges = 0;
+      for ( const int edge : std::as_const( mIncoming[ vertex ] ) )
+      {
+        if ( !mContracted.at( mEdges.at( edge ).fromVertex ) )
+          ++removedEdges;
+      }
+      for ( const int edge : std::as_const( mOutgoing[ vertex ] ) )
+      {
+        if ( !mContracted.at( mEdges.at( edge ).toVertex ) )
+          ++removedEdges;
+      }
+      return shortcuts - removedEdges + mContractedNeighbours.at( vertex );
+    }
+
+    //! Marks a \a vertex as contracted, removing it from the remaining graph
+    void setContracted( int vertex )
+    {
+      mContracted[ vertex ] = true;
+      for ( const int edge : std::as_const( mIncoming[ vertex ] ) )
+        ++mContractedNeighbours[ mEdges.at( edge ).fromVertex ];
+      for ( const int edge : std::as_const( mOutgoing[ vertex ] ) )
+        ++mContractedNeighbours[ mEdges.at( edge ).toVertex ];
+    }
+
+  private:
+
+    //! Searches the shortest paths from a vertex not going through the contracted one, up to a cost
+    void witnessSearch( int fromVertex, int contractedVertex, double maxCost )
+    {
+      MinCostQueue queue;
+      mWitnessCosts[ fromVertex ] = 0;
+      mTouched.append( fromVertex );
+      queue.push( QueueEntry( 0, fromVertex ) );
+
+      int settled = 0;
+      while ( !queue.empty() && settled < WITNESS_SEARCH_MAX_SETTLED_VERTICES )
+      {
+        const QueueEntry entry = queue.top();
+        queue.pop();
+        if ( entry.first > maxCost )
+          break;
+        if ( entry.first > mWitnessCosts.at( entry.second ) )
+          continue;  // outdated entry
+        ++settled;
+
+        for ( const int edge : std::as_const( mOutgoing[ entry.second ] ) )
+        {
+          const int toVertex = mEdges.at( edge ).toVertex;
+          if ( toVertex == contractedVertex || mContracted.at( toVertex ) )
+            continue;
+
+          const double cost = entry.first + mEdges.at( edge ).cost;
+          if ( cost < mWitnessCosts.at( toVertex ) )
+          {
+            if ( std::isinf( mWitnessCosts.at( toVertex ) ) )
+              mTouched.append( toVertex );
+            mWitnessCosts[ toVertex ] = cost;
+            queue.push( QueueEntry( cost, toVertex ) );
+          }
+        }
+      }
+    }
+
+    void resetWitnessCosts()
+    {
+      for ( const int vertex : std::as_const( mTouched ) )
+        mWitnessCosts[ vertex ] = std::numeric_limits<double>::infinity();
+      mTouched.clear();
+    }
+
+    QVector<EdgeType> &mEdges;
+    QVector< QVector<int> > mOutgoing;
+    QVector< QVector<int> > mIncoming;
+    QVector<bool> mContracted;
+    QVector<int> mContractedNeighbours;
+
+    QVector<double> mWitnessCosts;
+    //! vertices with a witness cost to reset after a search
+    QVector<int> mTouched;
+};
+
+///@endcond
+
+bool QgsGraphContractionHierarchy::build( const QgsGraph *graph, int criterionNum, QgsFeedback *feedback )
+{
+  mValid = false;
+  mEdges.clear();
+  mCriterionNum = criterionNum;
+
+  const int vertexCount = graph->vertexCount();
+  for ( int i = 0; i < graph->edgeCount(); ++i )
+  {
+    if ( !graph->hasEdge( i ) )
+      continue;
+
+    const QgsGraphEdge &graphEdge = graph->edge( i );
+    // loops are never part of a shortest path
+    if ( graphEdge.fromVertex() == graphEdge.toVertex()
+         || graphEdge.fromVertex() < 0 || graphEdge.fromVertex() >= vertexCount
+         || graphEdge.toVertex() < 0 || graphEdge.toVertex() >= vertexCount )
+      continue;
+
+    Edge edge;
+    edge.fromVertex = graphEdge.fromVertex();
+    edge.toVertex = graphEdge.toVertex();
+    edge.cost = graphEdge.cost( criterionNum ).toDouble();
+    edge.graphEdge = i;
+    mEdges.append( edge );
+  }
+
+  QgsContractionGraph<Edge> contractionGraph( mEdges, vertexCount );
+
+  // contract the vertices by increasing priority, updating the priorities lazily
+  MinCostQueue queue;
+  for ( int i = 0; i < vertexCount; ++i )
+    queue.push( QueueEntry( contractionGraph.priority( i ), i ) );
+
+  mRanks = QVector<int>( vertexCount, -1 );
+  int rank = 0;
+  while ( !queue.empty() )
+  {
+    const int vertex = queue.top().second;
+    queue.pop();
+
+    const int priority = contractionGraph.priority( vertex );
+    if ( !queue.empty() && priority > queue.top().first )
+    {
+      queue.push( QueueEntry( priority, vertex ) );
+      continue;
+    }
+
+    contractionGraph.contract( vertex, false );
+    contractionGraph.setContracted( vertex );
+    mRanks[ vertex ] = rank++;
+
+    if ( feedback && rank % 1000 == 0 )
+    {
+      if ( feedback->isCanceled() )
+      {
+        mEdges.clear();
+        mRanks.clear();
+        return false;
+      }
+      feedback->setProgress( 100.0 * rank / vertexCount );
+    }
+  }
+
+  buildSearchGraphs();
+  mValid = true;
+  return true;
+}
+
+int QgsGraphContractionHierarchy::shortcutCount() const
+{
+  int count = 0;
+  for ( const Edge &edge : mEdges )
+  {
+    if ( edge.graphEdge < 0 )
+      ++count;
+  }
+  return count;
+}
+
+void QgsGraphContractionHierarchy::buildSearchGraphs()
+{
+  const int vertexCount = mRanks.count();
+
+  // the forward search follows the edges to vertices of higher rank, the backward search
+  // follows the edges from vertices of higher rank in reverse
+  mForwardOffsets = QVector<int>( vertexCount + 1, 0 );
+  mBackwardOffsets = QVector<int>( vertexCount + 1, 0 );
+  for ( const Edge &edge : std::as_const( mEdges ) )
+  {
+    if ( mRanks.at( edge.fromVertex ) < mRanks.at( edge.toVertex ) )
+      ++mForwardOffsets[ edge.fromVertex + 1 ];
+    else
+      ++mBackwardOffsets[ edge.toVertex + 1 ];
+  }
+  for ( int i = 0; i < vertexCount; ++i )
+  {
+    mForwardOffsets[ i + 1 ] += mForwardOffsets.at( i );
+    mBackwardOffsets[ i + 1 ] += mBackwardOffsets.at( i );
+  }
+
+  mForwardEdges = QVector<int>( mForwardOffsets.at( vertexCount ) );
+  mBackwardEdges = QVector<int>( mBackwardOffsets.at( vertexCount ) );
+  QVector<int> forwardPositions = mForwardOffsets;
+  QVector<int> backwardPositions = mBackwardOffsets;
+  for ( int i = 0; i < mEdges.count(); ++i )
+  {
+    const Edge &edge = mEdges.at( i );
+    if ( mRanks.at( edge.fromVertex ) < mRanks.at( edge.toVertex ) )
+      mForwardEdges[ forwardPositions[ edge.fromVertex ]++ ] = i;
+    else
+      mBackwardEdges[ backwardPositions[ edge.toVertex ]++ ] = i;
+  }
+}
+
+double QgsGraphContractionHierarchy::search( int startVertexIdx, int endVertexIdx, QHash<int, SearchLabel> &forwardLabels, QHash<int, SearchLabel> &backwardLabels, int &meetingVertex ) const
+{
+  meetingVertex = -1;
+  double bestCost = std::numeric_limits<double>::infinity();
+  if ( !mValid || startVertexIdx < 0 || startVertexIdx >= mRanks.count() || endVertexIdx < 0 || endVertexIdx >= mRanks.count() )
+    return bestCost;
+
+  MinCostQueue forwardQueue;
+  MinCostQueue backwardQueue;
+  forwardLabels.insert( startVertexIdx, SearchLabel() );
+  forwardQueue.push( QueueEntry( 0, startVertexIdx ) );
+  backwardLabels.insert( endVertexIdx, SearchLabel() );
+  backwardQueue.push( QueueEntry( 0, endVertexIdx ) );
+
+  while ( !forwardQueue.empty() || !backwardQueue.empty() )
+  {
+    const bool forward = !forwardQueue.empty() && ( backwardQueue.empty() || forwardQueue.top().first <= backwardQueue.top().first );
+    MinCostQueue &queue = forward ? forwardQueue : backwardQueue;
+    // neither search can improve the best path anymore
+    if ( queue.top().first >= bestCost )
+      break;
+
+    const QueueEntry entry = queue.top();
+    queue.pop();
+
+    QHash<int, SearchLabel> &labels = forward ? forwardLabels : backwardLabels;
+    const QHash<int, SearchLabel> &otherLabels = forward ? backwardLabels : forwardLabels;
+    if ( entry.first > labels.value( entry.second ).cost )
+      continue;  // outdated entry
+
+    const auto otherLabel = otherLabels.constFind( entry.second );
+    if ( otherLabel != otherLabels.constEnd() && entry.first + otherLabel->cost < bestCost )
+    {
+      bestCost = entry.first + otherLabel->cost;
+      meetingVertex = entry.second;
+    }
+
+    const QVector<int> &offsets = forward ? mForwardOffsets : mBackwardOffsets;
+    const QVector<int> &edges = forward ? mForwardEdges : mBackwardEdges;
+    for ( int i = offsets.at( entry.second ); i < offsets.at( entry.second + 1 ); ++i )
+    {
+      const Edge &edge = mEdges.at( edges.at( i ) );
+      const int vertex = forward ? edge.toVertex : edge.fromVertex;
+      const double cost = entry.first + edge.cost;
+
+      const auto label = labels.find( vertex );
+      if ( label == labels.end() || cost < label->cost )
+      {
+        SearchLabel newLabel;
+        newLabel.cost = cost;
+        newLabel.edge = edges.at( i );
+        labels.insert( vertex, newLabel );
+        queue.push( QueueEntry( cost, vertex ) );
+      }
+    }
+  }
+
+  return bestCost;
+}
+
+QHash<int, QgsGraphContractionHierarchy::SearchLabel> QgsGraphContractionHierarchy::searchAll( int vertex, bool forward ) const
+{
+  QHash<int, SearchLabel> labels;
+  if ( !mValid || vertex < 0 || vertex >= mRanks.count() )
+    return labels;
+
+  const QVector<int> &offsets = forward ? mForwardOffsets : mBackwardOffsets;
+  const QVector<int> &edges = forward ? mForwardEdges : mBackwardEdges;
+
+  MinCostQueue queue;
+  labels.insert( vertex, SearchLabel() );
+  queue.push( QueueEntry( 0, vertex ) );
+  while ( !queue.empty() )
+  {
+    const QueueEntry entry = queue.top();
+    queue.pop();
+    if ( entry.first > labels.value( entry.second ).cost )
+      continue;  // outdated entry
+
+    for ( int i = offsets.at( entry.second ); i < offsets.at( entry.second + 1 ); ++i )
+    {
+      const Edge &edge = mEdges.at( edges.at( i ) );
+      const int nextVertex = forward ? edge.toVertex : edge.fromVertex;
+      const double cost = entry.first + edge.cost;
+
+      const auto label = labels.find( nextVertex );
+      if ( label == labels.end() || cost < label->cost )
+      {
+        SearchLabel newLabel;
+        newLabel.cost = cost;
+        newLabel.edge = edges.at( i );
+        labels.insert( nextVertex, newLabel );
+        queue.push( QueueEntry( cost, nextVertex ) );
+      }
+    }
+  }
+  return labels;
+}
+
+double QgsGraphContractionHierarchy::shortestPathCost( int startVertexIdx, int endVertexIdx ) const
+{
+  QHash<int, SearchLabel> forwardLabels;
+  QHash<int, SearchLabel> backwardLabels;
+  int meetingVertex = -1;
+  return search( startVertexIdx, endVertexIdx, forwardLabels, backwardLabels, meetingVertex );
+}
+
+QVector<int> QgsGraphContractionHierarchy::shortestPath( int startVertexIdx, int endVertexIdx, double *cost ) const
+{
+  QHash<int, SearchLabel> forwardLabels;
+  QHash<int, SearchLabel> backwardLabels;
+  int meetingVertex = -1;
+  const double pathCost = search( startVertexIdx, endVertexIdx, forwardLabels, backwardLabels, meetingVertex );
+  if ( cost )
+    *cost = pathCost;
+
+  QVector<int> path;
+  if ( meetingVertex < 0 )
+    return path;
+
+  // hierarchy edges from the start vertex to the meeting vertex
+  QVector<int> hierarchyEdges;
+  int vertex = meetingVertex;
+  while ( forwardLabels.value( vertex ).edge >= 0 )
+  {
+    const int edge = forwardLabels.value( vertex ).edge;
+    hierarchyEdges.prepend( edge );
+    vertex = mEdges.at( edge ).fromVertex;
+  }
+  // ... and on to the end vertex
+  vertex = meetingVertex;
+  while ( backwardLabels.value( vertex ).edge >= 0 )
+  {
+    const int edge = backwardLabels.value( vertex ).edge;
+    hierarchyEdges.append( edge );
+    vertex = mEdges.at( edge ).toVertex;
+  }
+
+  for ( const int edge : std::as_const( hierarchyEdges ) )
+    unpackEdge( edge, path );
+  return path;
+}
+
+void QgsGraphContractionHierarchy::unpackEdge( int edge, QVector<int> &path ) const
+{
+  QVector<int> stack;
+  stack.append( edge );
+  while ( !stack.isEmpty() )
+  {
+    const Edge &current = mEdges.at( stack.takeLast() );
+    if ( current.graphEdge >= 0 )
+    {
+      path.append( current.graphEdge );
+    }
+    else
+    {
+      stack.append( current.secondEdge );
+      stack.append( current.firstEdge );
+    }
+  }
+}
+
+QVector< QVector<double> > QgsGraphContractionHierarchy::costMatrix( const QVector<int> &startVertices, const QVector<int> &endVertices, QgsFeedback *feedback ) const
+{
+  // the backward searches from the end vertices are stored in buckets at the vertices they reach,
+  // then each forward search collects the costs from the buckets of the vertices it reaches
+  const std::function< QHash<int, SearchLabel>( int ) > backwardSearch = [this]( int vertex )
+  {
+    return searchAll( vertex, false );
+  };
+  const QVector< QHash<int, SearchLabel> > backwardSearches = QtConcurrent::blockingMapped< QVector< QHash<int, SearchLabel> > >( endVertices, backwardSearch );
+
+  QHash< int, QVector< QPair< int, double > > > buckets;
+  for ( int i = 0; i < backwardSearches.count(); ++i )
+  {
+    const QHash<int, SearchLabel> &labels = backwardSearches.at( i );
+    for ( auto it = labels.constBegin(); it != labels.constEnd(); ++it )
+      buckets[ it.key() ].append( qMakePair( i, it.value().cost ) );
+  }
+
+  const int endCount = endVertices.count();
+  const std::function< QVector<double>( int ) > forwardSearch = [this, &buckets, endCount, feedback]( int vertex )
+  {
+    QVector<double> costs( endCount, std::numeric_limits<double>::infinity() );
+    if ( feedback && feedback->isCanceled() )
+      return costs;
+
+    const QHash<int, SearchLabel> labels = searchAll( vertex, true );
+    for ( auto it = labels.constBegin(); it != labels.constEnd(); ++it )
+    {
+      const auto bucket = buckets.constFind( it.key() );
+      if ( bucket == buckets.constEnd() )
+        continue;
+
+      for ( const QPair< int, double > &entry : *bucket )
+        costs[ entry.first ] = std::min( costs.at( entry.first ), it.value().cost + entry.second );
+    }
+    return costs;
+  };
+  return QtConcurrent::blockingMapped< QVector< QVector<double> > >( startVertices, forwardSearch );
+}
+
+bool QgsGraphContractionHierarchy::writeToFile( const QString &path, QString *errorMessage ) const
+{
+  if ( !mValid )
+  {
+    if ( errorMessage )
+      *errorMessage = QObject::tr( "The contraction hierarchy has not been built" );
+    return false;
+  }
+
+  QFile file( path );
+  if ( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+  {
+    if ( errorMessage )
+      *errorMessage = QObject::tr( "Could not open %1 for writing: %2" ).arg( path, file.errorString() );
+    return false;
+  }
+
+  QDataStream stream( &file );
+  stream.setVersion( QDataStream::Qt_5_9 );
+  stream << FILE_MAGIC << FILE_VERSION << static_cast< qint32 >( mCriterionNum ) << mRanks;
+  stream << static_cast< qint32 >( mEdges.count() );
+  for ( const Edge &edge : mEdges )
+  {
+    stream << static_cast< qint32 >( edge.fromVertex ) << static_cast< qint32 >( edge.toVertex ) << edge.cost
+           << static_cast< qint32 >( edge.graphEdge ) << static_cast< qint32 >( edge.firstEdge ) << static_cast< qint32 >( edge.secondEdge );
+  }
+
+  if ( stream.status() != QDataStream::Ok )
+  {
+    if ( errorMessage )
+      *errorMessage = QObject::tr( "Could not write to %1: %2" ).arg( path, file.errorString() );
+    return false;
+  }
+  return true;
+}
+
+bool QgsGraphContractionHierarchy::readFromFile( const QString &path, QString *errorMessage )
+{
+  mValid = false;
+  mEdges.clear();
+  mRanks.clear();
+
+  QFile file( path );
+  if ( !file.open( QIODevice::ReadOnly ) )
+  {
+    if ( errorMessage )
+      *errorMessage = QObject::tr( "Could not open %1 for reading: %2" ).arg( path, file.errorString() );
+    return false;
+  }
+
+  QDataStream stream( &file );
+  stream.setVersion( QDataStream::Qt_5_9 );
+
+  quint32 magic = 0;
+  qint32 version = 0;
+  stream >> magic >> version;
+  if ( magic != FILE_MAGIC || version != FILE_VERSION )
+  {
+    if ( errorMessage )
+      *errorMessage = QObject::tr( "%1 is not a contraction hierarchy file" ).arg( path );
+    return false;
+  }
+
+  qint32 criterionNum = -1;
+  QVector<int> ranks;
+  qint32 edgeCount = 0;
+  stream >> criterionNum >> ranks >> edgeCount;
+
+  QVector<Edge> edges;
+  bool ok = stream.status() == QDataStream::Ok && edgeCount >= 0;
+  if ( ok )
+    edges.reserve( edgeCount );
+  for ( int i = 0; ok && i < edgeCount; ++i )
+  {
+    qint32 fromVertex, toVertex, graphEdge, firstEdge, secondEdge;
+    double cost;
+    stream >> fromVertex >> toVertex >> cost >> graphEdge >> firstEdge >> secondEdge;
+
+    ok = stream.status() == QDataStream::Ok
+         && fromVertex >= 0 && fromVertex < ranks.count() && toVertex >= 0 && toVertex < ranks.count()
+         && ( graphEdge >= 0 || ( firstEdge >= 0 && firstEdge < i && secondEdge >= 0 && secondEdge < i ) );
+
+    Edge edge;
+    edge.fromVertex = fromVertex;
+    edge.toVertex = toVertex;
+    edge.cost = cost;
+    edge.graphEdge = graphEdge;
+    edge.firstEdge = firstEdge;
+    edge.secondEdge = secondEdge;
+    edges.append( edge );
+  }
+
+  if ( !ok )
+  {
+    if ( errorMessage )
+      *errorMessage = QObject::tr( "Could not read the contraction hierarchy from %1" ).arg( path );
+    return false;
+  }
+
+  mCriterionNum = criterionNum;
+  mRanks = ranks;
+  mEdges = edges;
+  buildSearchGraphs();
+  mValid = true;
+  return true;
+}
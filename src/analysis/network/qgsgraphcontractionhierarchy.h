@@ -0,0 +1,171 @@
+/***************************************************************************
+  qgsgraphcontractionhierarchy.h
+  --------------------------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+****************************************************************************
+*                                                                          *
+*   This program is free software; you can redistribute it and/or modify   *
+*   it under the terms of the GNU General Public License as published by   *
+*   the Free Software Foundation; either version 2 of the License, or      *
+*   (at your option) any later version.                                    *
+*                                                                          *
+***************************************************************************/
+
+#ifndef QGSGRAPHCONTRACTIONHIERARCHY_H
+#define QGSGRAPHCONTRACTIONHIERARCHY_H
+
+#include <QHash>
+#include <QVector>
+#include <QString>
+
+#include "qgis_sip.h"
+#include "qgis_analysis.h"
+
+class QgsGraph;
+class QgsFeedback;
+
+/**
+ * \ingroup analysis
+ * \class QgsGraphContractionHierarchy
+ * \brief A contraction hierarchy of a graph, answering shortest path queries between two vertices
+ * much faster than a Dijkstra search over the whole graph.
+ *
+ * The hierarchy is built once from a QgsGraph for one of its optimization strategies, by contracting
+ * the vertices one after the other and adding shortcut edges that preserve the shortest path costs.
+ * Queries then only search the edges leading to more important vertices from both ends of the path,
+ * which visits a small part of the graph.
+ *
+ * Building the hierarchy of a large graph is expensive, so it can be written to a file and read back later,
+ * as long as the graph it was built from does not change. The hierarchy refers to the vertices and edges
+ * of the graph by their indices, and expects them to range from 0 to the vertex and edge counts of the graph.
+ *
+ * Edge costs must not be negative.
+ *
+ * \since QGIS 3.30
+ */
+class ANALYSIS_EXPORT QgsGraphContractionHierarchy
+{
+  public:
+
+    /**
+     * Constructor for an empty QgsGraphContractionHierarchy.
+     *
+     * Call build() or readFromFile() to populate the hierarchy.
+     */
+    QgsGraphContractionHierarchy() = default;
+
+    /**
+     * Builds the hierarchy of a \a graph, using the costs of its optimization strategy at \a criterionNum.
+     *
+     * \returns TRUE if the hierarchy was built, or FALSE if the \a feedback was canceled
+     */
+    bool build( const QgsGraph *graph, int criterionNum, QgsFeedback *feedback = nullptr );
+
+    /**
+     * Returns TRUE if the hierarchy has been built or read from a file.
+     */
+    bool isValid() const { return mValid; }
+
+    /**
+     * Returns the number of vertices of the graph the hierarchy was built from.
+     */
+    int vertexCount() const { return mRanks.count(); }
+
+    /**
+     * Returns the number of shortcut edges added to the graph by the contraction.
+     */
+    int shortcutCount() const;
+
+    /**
+     * Returns the cost of the shortest path from \a startVertexIdx to \a endVertexIdx,
+     * or infinity if there is no path between the vertices.
+     */
+    double shortestPathCost( int startVertexIdx, int endVertexIdx ) const;
+
+    /**
+     * Returns the indices of the graph edges along the shortest path from \a startVertexIdx
+     * to \a endVertexIdx, in order.
+     *
+     * An empty list is returned if there is no path between the vertices, or if they are the same vertex.
+     * The cost of the path is stored in \a cost, or infinity if there is no path.
+     */
+    QVector<int> shortestPath( int startVertexIdx, int endVertexIdx, double *cost SIP_OUT = nullptr ) const;
+
+    /**
+     * Returns the costs of the shortest paths from each of the \a startVertices to each of the \a endVertices.
+     *
+     * The result has a row for each start vertex, with the costs to the end vertices in their order,
+     * set to infinity when there is no path. The searches from the start vertices are run in parallel.
+     */
+    QVector< QVector<double> > costMatrix( const QVector<int> &startVertices, const QVector<int> &endVertices, QgsFeedback *feedback = nullptr ) const;
+
+    /**
+     * Writes the hierarchy to the file at \a path.
+     *
+     * \returns TRUE if the hierarchy was written, or FALSE with the \a errorMessage set in case of error
+     */
+    bool writeToFile( const QString &path, QString *errorMessage SIP_OUT = nullptr ) const;
+
+    /**
+     * Reads a hierarchy previously written with writeToFile() from the file at \a path.
+     *
+     * \returns TRUE if the hierarchy was read, or FALSE with the \a errorMessage set in case of error
+     */
+    bool readFromFile( const QString &path, QString *errorMessage SIP_OUT = nullptr );
+
+  private:
+
+#ifndef SIP_RUN
+
+    //! Edge of the hierarchy: either an edge of the graph, or a shortcut of two edges of the hierarchy
+    struct Edge
+    {
+      int fromVertex = -1;
+      int toVertex = -1;
+      double cost = 0;
+      //! index of the graph edge, or -1 for shortcuts
+      int graphEdge = -1;
+      //! index of the first hierarchy edge of a shortcut
+      int firstEdge = -1;
+      //! index of the second hierarchy edge of a shortcut
+      int secondEdge = -1;
+    };
+
+    //! Settled vertex of a search through the hierarchy
+    struct SearchLabel
+    {
+      double cost = 0;
+      //! index of the hierarchy edge leading to the vertex, or -1 for the search origin
+      int edge = -1;
+    };
+
+    //! Builds the edges going upwards in the hierarchy from the edges and ranks of the vertices
+    void buildSearchGraphs();
+
+    //! Searches the upward edges of the hierarchy from all vertices, returning the settled vertices
+    QHash<int, SearchLabel> searchAll( int vertex, bool forward ) const;
+
+    //! Runs a bidirectional search for the shortest path between two vertices, returning the best cost
+    double search( int startVertexIdx, int endVertexIdx, QHash<int, SearchLabel> &forwardLabels, QHash<int, SearchLabel> &backwardLabels, int &meetingVertex ) const;
+
+    //! Appends the graph edges of an hierarchy edge to a path, unpacking the shortcuts
+    void unpackEdge( int edge, QVector<int> &path ) const;
+
+    bool mValid = false;
+    int mCriterionNum = -1;
+    QVector<Edge> mEdges;
+    //! contraction order of the vertices
+    QVector<int> mRanks;
+
+    //! upward edges from each vertex of the forward search (compressed rows)
+    QVector<int> mForwardOffsets;
+    QVector<int> mForwardEdges;
+    //! upward edges from each vertex of the backward search (compressed rows)
+    QVector<int> mBackwardOffsets;
+    QVector<int> mBackwardEdges;
+
+#endif
+};
+
+#endif // QGSGRAPHCONTRACTIONHIERARCHY_H
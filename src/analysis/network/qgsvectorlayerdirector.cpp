@@ -31,10 +31,9 @@
 
 #include <QString>
 #include <QtAlgorithms>
+#include <QHash>
 
-#include <spatialindex/SpatialIndex.h>
-
-using namespace SpatialIndex;
+#include <cmath>
 
 struct TiePointInfo
 {
@@ -113,59 +112,74 @@ QgsVectorLayerDirector::Direction QgsVectorLayerDirector::directionForFeature( c
 }
 
 ///@cond PRIVATE
-class QgsNetworkVisitor : public SpatialIndex::IVisitor
+
+//! Minimum size of the cells of the grid used to find the graph vertices within the topology tolerance
+static constexpr double MIN_VERTEX_GRID_CELL_SIZE = 1e-6;
+
+/**
+ * Grid hash of the graph vertices, to find the vertices within the topology tolerance of a point.
+ *
+ * The cells are at least as large as the tolerance, so that the matching vertices are always in the
+ * cell of the point or in one of its neighbors. The vertices of a cell are chained by their indices.
+ */
+class QgsNetworkVertexGrid
 {
   public:
-    explicit QgsNetworkVisitor( QVector< int > &pointIndexes )
-      : mPoints( pointIndexes ) {}
-
-    void visitNode( const INode &n ) override
-    { Q_UNUSED( n ) }
+    explicit QgsNetworkVertexGrid( double tolerance )
+      : mTolerance( tolerance )
+      , mCellSize( std::max( tolerance, MIN_VERTEX_GRID_CELL_SIZE ) )
+    {}
 
-    void visitData( const IData &d ) override
+    //! Returns the lowest index of the \a vertices within the tolerance of a \a point, or -1 if there is none
+    int findVertex( const QgsPointXY &point, const QVector< QgsPointXY > &vertices ) const
     {
-      mPoints.append( d.getIdentifier() );
+      const qint64 cellX = cell( point.x() );
+      const qint64 cellY = cell( point.y() );
+      int found = -1;
+      for ( qint64 x = cellX - 1; x <= cellX + 1; ++x )
+      {
+        for ( qint64 y = cellY - 1; y <= cellY + 1; ++y )
+        {
+          const auto it = mFirstVertex.constFind( qMakePair( x, y ) );
+          if ( it == mFirstVertex.constEnd() )
+            continue;
+
+          for ( int vertex = it.value(); vertex != -1; vertex = mNextVertex.at( vertex ) )
+          {
+            const QgsPointXY &vertexPoint = vertices.at( vertex );
+            if ( ( found == -1 || vertex < found )
+                 && std::fabs( vertexPoint.x() - point.x() ) <= mTolerance
+                 && std::fabs( vertexPoint.y() - point.y() ) <= mTolerance )
+              found = vertex;
+          }
+        }
+      }
+      return found;
     }
 
-    void visitData( std::vector<const IData *> &v ) override
-    { Q_UNUSED( v ) }
+    //! Adds the vertex at \a index, which must be the count of the vertices added so far
+    void addVertex( const QgsPointXY &point, int index )
+    {
+      Q_ASSERT( index == mNextVertex.count() );
+      const QPair< qint64, qint64 > key( cell( point.x() ), cell( point.y() ) );
+      mNextVertex.append( mFirstVertex.value( key, -1 ) );
+      mFirstVertex.insert( key, index );
+    }
 
   private:
-    QVector< int > &mPoints;
+    qint64 cell( double coordinate ) const
+    {
+      return static_cast< qint64 >( std::floor( coordinate / mCellSize ) );
+    }
+
+    double mTolerance = 0;
+    double mCellSize = 0;
+    QHash< QPair< qint64, qint64 >, int > mFirstVertex;
+    QVector< int > mNextVertex;
 };
 
 ///@endcond
 
-std::unique_ptr< SpatialIndex::ISpatialIndex > createVertexSpatialIndex( SpatialIndex::IStorageManager &storageManager )
-{
-  // R-Tree parameters
-  double fillFactor = 0.7;
-  unsigned long indexCapacity = 10;
-  unsigned long leafCapacity = 10;
-  unsigned long dimension = 2;
-  RTree::RTreeVariant variant = RTree::RV_RSTAR;
-
-  // create R-tree
-  SpatialIndex::id_type indexId;
-  std::unique_ptr< SpatialIndex::ISpatialIndex > iRTree( RTree::createNewRTree( storageManager, fillFactor, indexCapacity,
-      leafCapacity, dimension, variant, indexId ) );
-  return iRTree;
-}
-
-int findClosestVertex( const QgsPointXY &point, SpatialIndex::ISpatialIndex *index, double tolerance )
-{
-  QVector< int > matching;
-  QgsNetworkVisitor visitor( matching );
-
-  double pt1[2] = { point.x() - tolerance, point.y() - tolerance },
-                  pt2[2] = { point.x() + tolerance, point.y() + tolerance };
-  SpatialIndex::Region searchRegion( pt1, pt2, 2 );
-
-  index->intersectsWithQuery( searchRegion, visitor );
-
-  return matching.empty() ? -1 : matching.at( 0 );
-}
-
 void QgsVectorLayerDirector::makeGraph( QgsGraphBuilderInterface *builder, const QVector< QgsPointXY > &additionalPoints,
                                         QVector< QgsPointXY > &snappedPoints, QgsFeedback *feedback ) const
 {
@@ -187,19 +201,16 @@ void QgsVectorLayerDirector::makeGraph( QgsGraphBuilderInterface *builder, const
   // graph's vertices = all vertices in graph, with vertices within builder's tolerance collapsed together
   QVector< QgsPointXY > graphVertices;
 
-  // spatial index for graph vertices
-  std::unique_ptr< SpatialIndex::IStorageManager > iStorage( StorageManager::createNewMemoryStorageManager() );
-  std::unique_ptr< SpatialIndex::ISpatialIndex > iRTree = createVertexSpatialIndex( *iStorage );
-
+  // grid hash of the graph vertices
   double tolerance = std::max( builder->topologyTolerance(), 1e-10 );
-  auto findPointWithinTolerance = [&iRTree, tolerance]( const QgsPointXY & point )->int
+  QgsNetworkVertexGrid vertexGrid( tolerance );
+  auto findPointWithinTolerance = [&vertexGrid, &graphVertices]( const QgsPointXY & point )->int
   {
-    return findClosestVertex( point, iRTree.get(), tolerance );
+    return vertexGrid.findVertex( point, graphVertices );
   };
-  auto addPointToIndex = [&iRTree]( const QgsPointXY & point, int index )
+  auto addPointToIndex = [&vertexGrid]( const QgsPointXY & point, int index )
   {
-    double coords[] = {point.x(), point.y()};
-    iRTree->insertData( 0, nullptr, SpatialIndex::Point( coords, 2 ), index );
+    vertexGrid.addVertex( point, index );
   };
 
   // first iteration - get all nodes from network, and snap additional points to network
@@ -20,6 +20,8 @@
 #include "qgsrasterfilewriter.h"
 #include "qgsrasteranalysisutils.h"
 
+#include <limits>
+
 ///@cond PRIVATE
 
 
@@ -255,6 +257,89 @@ bool QgsCellStatisticsAlgorithm::prepareSpecificAlgorithmParameters( const QVari
   return true;
 }
 
+void QgsCellStatisticsAlgorithm::accumulateRow( const std::vector< std::vector< double > > &stack, int row, int cols, QgsRasterBlock *output ) const
+{
+  const bool needSum = mMethod == QgsRasterAnalysisUtils::Sum || mMethod == QgsRasterAnalysisUtils::Mean;
+  const bool needMinimum = mMethod == QgsRasterAnalysisUtils::Minimum || mMethod == QgsRasterAnalysisUtils::Range;
+  const bool needMaximum = mMethod == QgsRasterAnalysisUtils::Maximum || mMethod == QgsRasterAnalysisUtils::Range;
+
+  std::vector< double > sum( cols, 0.0 );
+  std::vector< double > minimum( cols, std::numeric_limits< double >::max() );
+  std::vector< double > maximum( cols, std::numeric_limits< double >::lowest() );
+  std::vector< int > count( cols, 0 );
+
+  // the layers are accumulated column-wise over the whole row, with branchless loops which can be vectorized
+  const qgssize offset = static_cast< qgssize >( row ) * cols;
+  for ( const std::vector< double > &values : stack )
+  {
+    if ( values.empty() )
+      continue; //all cells of invalid blocks are NoData
+
+    const double *rowValues = values.data() + offset;
+    for ( int col = 0; col < cols; ++col )
+      count[col] += !std::isnan( rowValues[col] );
+    if ( needSum )
+    {
+      for ( int col = 0; col < cols; ++col )
+        sum[col] += std::isnan( rowValues[col] ) ? 0.0 : rowValues[col];
+    }
+    if ( needMinimum )
+    {
+      for ( int col = 0; col < cols; ++col )
+        minimum[col] = std::isnan( rowValues[col] ) || rowValues[col] >= minimum[col] ? minimum[col] : rowValues[col];
+    }
+    if ( needMaximum )
+    {
+      for ( int col = 0; col < cols; ++col )
+        maximum[col] = std::isnan( rowValues[col] ) || rowValues[col] <= maximum[col] ? maximum[col] : rowValues[col];
+    }
+  }
+
+  const int stackSize = static_cast< int >( stack.size() );
+  for ( int col = 0; col < cols; ++col )
+  {
+    const bool noDataInStack = count[col] < stackSize;
+    if ( noDataInStack && !mIgnoreNoData )
+    {
+      //output cell will always be NoData if NoData occurs in cellValueStack and NoData is not ignored
+      output->setValue( row, col, mMethod == QgsRasterAnalysisUtils::Count ? count[col] : mNoDataValue );
+    }
+    else if ( count[col] > 0 )
+    {
+      double result = 0;
+      switch ( mMethod )
+      {
+        case QgsRasterAnalysisUtils::Sum:
+          result = sum[col];
+          break;
+        case QgsRasterAnalysisUtils::Count:
+          result = count[col];
+          break;
+        case QgsRasterAnalysisUtils::Mean:
+          result = sum[col] / static_cast< double >( count[col] );
+          break;
+        case QgsRasterAnalysisUtils::Minimum:
+          result = minimum[col];
+          break;
+        case QgsRasterAnalysisUtils::Maximum:
+          result = maximum[col];
+          break;
+        case QgsRasterAnalysisUtils::Range:
+          result = maximum[col] - minimum[col];
+          break;
+        default:
+          break;
+      }
+      output->setValue( row, col, result );
+    }
+    else
+    {
+      //result is NoData if cellValueStack contains no valid values, eg. all cellValues are NoData
+      output->setValue( row, col, mNoDataValue );
+    }
+  }
+}
+
 void QgsCellStatisticsAlgorithm::processRasterStack( QgsProcessingFeedback *feedback )
 {
   int maxWidth = QgsRasterIterator::DEFAULT_MAXIMUM_TILE_WIDTH;
@@ -289,78 +374,80 @@ void QgsCellStatisticsAlgorithm::processRasterStack( QgsProcessingFeedback *feed
     }
 
     feedback->setProgress( 100 * ( ( iterTop / maxHeight * nbBlocksWidth ) + iterLeft / maxWidth ) / nbBlocks );
-    for ( int row = 0; row < iterRows; row++ )
+
+    // the input blocks are converted once, then the rows of the output block are computed in parallel
+    const std::vector< std::vector< double > > stack = QgsRasterAnalysisUtils::blockStackValues( inputBlocks );
+    QgsRasterBlock *output = outputBlock.get();
+    switch ( mMethod )
     {
-      if ( feedback->isCanceled() )
+      case QgsRasterAnalysisUtils::Sum:
+      case QgsRasterAnalysisUtils::Count:
+      case QgsRasterAnalysisUtils::Mean:
+      case QgsRasterAnalysisUtils::Minimum:
+      case QgsRasterAnalysisUtils::Maximum:
+      case QgsRasterAnalysisUtils::Range:
+        QgsRasterAnalysisUtils::processRowsInParallel( iterRows, [this, &stack, output, iterCols, feedback]( int row )
+        {
+          if ( !feedback->isCanceled() )
+            accumulateRow( stack, row, iterCols, output );
+        } );
         break;
 
-      for ( int col = 0; col < iterCols; col++ )
-      {
-        double result = 0;
-        bool noDataInStack = false;
-        std::vector<double> cellValues = QgsRasterAnalysisUtils::getCellValuesFromBlockStack( inputBlocks, row, col, noDataInStack );
-        int cellValueStackSize = cellValues.size();
-
-        if ( noDataInStack && !mIgnoreNoData )
+      default:
+        QgsRasterAnalysisUtils::processRowsInParallel( iterRows, [this, &stack, output, iterCols, feedback]( int row )
         {
-          //output cell will always be NoData if NoData occurs in cellValueStack and NoData is not ignored
-          //this saves unnecessary iterations on the cellValueStack
-          if ( mMethod == QgsRasterAnalysisUtils::Count )
-            outputBlock->setValue( row, col,  cellValueStackSize );
-          else
+          if ( feedback->isCanceled() )
+            return;
+
+          std::vector<double> cellValues;
+          cellValues.reserve( stack.size() );
+          for ( int col = 0; col < iterCols; col++ )
           {
-            outputBlock->setValue( row, col, mNoDataValue );
+            double result = 0;
+            bool noDataInStack = false;
+            QgsRasterAnalysisUtils::cellValuesFromStack( stack, static_cast< qgssize >( row ) * iterCols + col, cellValues, noDataInStack );
+            const int cellValueStackSize = cellValues.size();
+
+            if ( noDataInStack && !mIgnoreNoData )
+            {
+              //output cell will always be NoData if NoData occurs in cellValueStack and NoData is not ignored
+              output->setValue( row, col, mNoDataValue );
+            }
+            else if ( !noDataInStack || ( mIgnoreNoData && cellValueStackSize > 0 ) )
+            {
+              switch ( mMethod )
+              {
+                case QgsRasterAnalysisUtils::Median:
+                  result = QgsRasterAnalysisUtils::medianFromCellValues( cellValues, cellValueStackSize );
+                  break;
+                case QgsRasterAnalysisUtils::StandardDeviation:
+                  result = QgsRasterAnalysisUtils::stddevFromCellValues( cellValues, cellValueStackSize );
+                  break;
+                case QgsRasterAnalysisUtils::Variance:
+                  result = QgsRasterAnalysisUtils::varianceFromCellValues( cellValues, cellValueStackSize );
+                  break;
+                case QgsRasterAnalysisUtils::Minority:
+                  result = QgsRasterAnalysisUtils::minorityFromCellValues( cellValues, mNoDataValue, cellValueStackSize );
+                  break;
+                case QgsRasterAnalysisUtils::Majority:
+                  result = QgsRasterAnalysisUtils::majorityFromCellValues( cellValues, mNoDataValue, cellValueStackSize );
+                  break;
+                case QgsRasterAnalysisUtils::Variety:
+                  result = QgsRasterAnalysisUtils::varietyFromCellValues( cellValues );
+                  break;
+                default:
+                  break;
+              }
+              output->setValue( row, col, result );
+            }
+            else
+            {
+              //result is NoData if cellValueStack contains no valid values, eg. all cellValues are NoData
+              output->setValue( row, col, mNoDataValue );
+            }
           }
-        }
-        else if ( !noDataInStack || ( mIgnoreNoData && cellValueStackSize > 0 ) )
-        {
-          switch ( mMethod )
-          {
-            case QgsRasterAnalysisUtils::Sum:
-              result = std::accumulate( cellValues.begin(), cellValues.end(), 0.0 );
-              break;
-            case QgsRasterAnalysisUtils::Count:
-              result = cellValueStackSize;
-              break;
-            case QgsRasterAnalysisUtils::Mean:
-              result = QgsRasterAnalysisUtils::meanFromCellValues( cellValues, cellValueStackSize );
-              break;
-            case QgsRasterAnalysisUtils::Median:
-              result = QgsRasterAnalysisUtils::medianFromCellValues( cellValues, cellValueStackSize );
-              break;
-            case QgsRasterAnalysisUtils::StandardDeviation:
-              result = QgsRasterAnalysisUtils::stddevFromCellValues( cellValues, cellValueStackSize );
-              break;
-            case QgsRasterAnalysisUtils::Variance:
-              result = QgsRasterAnalysisUtils::varianceFromCellValues( cellValues, cellValueStackSize );
-              break;
-            case QgsRasterAnalysisUtils::Minimum:
-              result = QgsRasterAnalysisUtils::minimumFromCellValues( cellValues );
-              break;
-            case QgsRasterAnalysisUtils::Maximum:
-              result = QgsRasterAnalysisUtils::maximumFromCellValues( cellValues );
-              break;
-            case QgsRasterAnalysisUtils::Minority:
-              result = QgsRasterAnalysisUtils::minorityFromCellValues( cellValues, mNoDataValue, cellValueStackSize );
-              break;
-            case QgsRasterAnalysisUtils::Majority:
-              result = QgsRasterAnalysisUtils::majorityFromCellValues( cellValues, mNoDataValue, cellValueStackSize );
-              break;
-            case QgsRasterAnalysisUtils::Range:
-              result = QgsRasterAnalysisUtils::rangeFromCellValues( cellValues );
-              break;
-            case QgsRasterAnalysisUtils::Variety:
-              result = QgsRasterAnalysisUtils::varietyFromCellValues( cellValues );
-              break;
-          }
-          outputBlock->setValue( row, col, result );
-        }
-        else
-        {
-          //result is NoData if cellValueStack contains no valid values, eg. all cellValues are NoData
-          outputBlock->setValue( row, col, mNoDataValue );
-        }
-      }
+        } );
+        break;
     }
     mOutputRasterDataProvider->writeBlock( outputBlock.get(), 1, iterLeft, iterTop );
   }
@@ -466,21 +553,25 @@ void QgsCellStatisticsPercentileAlgorithm::processRasterStack( QgsProcessingFeed
     }
 
     feedback->setProgress( 100 * ( ( iterTop / maxHeight * nbBlocksWidth ) + iterLeft / maxWidth ) / nbBlocks );
-    for ( int row = 0; row < iterRows; row++ )
+    const std::vector< std::vector< double > > stack = QgsRasterAnalysisUtils::blockStackValues( inputBlocks );
+    QgsRasterBlock *output = outputBlock.get();
+    QgsRasterAnalysisUtils::processRowsInParallel( iterRows, [&]( int row )
     {
       if ( feedback->isCanceled() )
-        break;
+        return;
 
+      std::vector<double> cellValues;
+      cellValues.reserve( stack.size() );
       for ( int col = 0; col < iterCols; col++ )
       {
         double result = 0;
         bool noDataInStack = false;
-        std::vector<double> cellValues = QgsRasterAnalysisUtils::getCellValuesFromBlockStack( inputBlocks, row, col, noDataInStack );
-        int cellValueStackSize = cellValues.size();
+        QgsRasterAnalysisUtils::cellValuesFromStack( stack, static_cast< qgssize >( row ) * iterCols + col, cellValues, noDataInStack );
+        const int cellValueStackSize = cellValues.size();
 
         if ( noDataInStack && !mIgnoreNoData )
         {
-          outputBlock->setValue( row, col, mNoDataValue );
+          output->setValue( row, col, mNoDataValue );
         }
         else if ( !noDataInStack || ( mIgnoreNoData && cellValueStackSize > 0 ) )
         {
@@ -496,15 +587,15 @@ void QgsCellStatisticsPercentileAlgorithm::processRasterStack( QgsProcessingFeed
               result = QgsRasterAnalysisUtils::interpolatedPercentileExc( cellValues, cellValueStackSize, mPercentile, mNoDataValue );
               break;
           }
-          outputBlock->setValue( row, col, result );
+          output->setValue( row, col, result );
         }
         else
         {
           //result is NoData if cellValueStack contains no valid values, eg. all cellValues are NoData
-          outputBlock->setValue( row, col, mNoDataValue );
+          output->setValue( row, col, mNoDataValue );
         }
       }
-    }
+    } );
     mOutputRasterDataProvider->writeBlock( outputBlock.get(), 1, iterLeft, iterTop );
   }
   mOutputRasterDataProvider->setEditable( false );
@@ -604,21 +695,25 @@ void QgsCellStatisticsPercentRankFromValueAlgorithm::processRasterStack( QgsProc
     }
 
     feedback->setProgress( 100 * ( ( iterTop / maxHeight * nbBlocksWidth ) + iterLeft / maxWidth ) / nbBlocks );
-    for ( int row = 0; row < iterRows; row++ )
+    const std::vector< std::vector< double > > stack = QgsRasterAnalysisUtils::blockStackValues( inputBlocks );
+    QgsRasterBlock *output = outputBlock.get();
+    QgsRasterAnalysisUtils::processRowsInParallel( iterRows, [&]( int row )
     {
       if ( feedback->isCanceled() )
-        break;
+        return;
 
+      std::vector<double> cellValues;
+      cellValues.reserve( stack.size() );
       for ( int col = 0; col < iterCols; col++ )
       {
         double result = 0;
         bool noDataInStack = false;
-        std::vector<double> cellValues = QgsRasterAnalysisUtils::getCellValuesFromBlockStack( inputBlocks, row, col, noDataInStack );
-        int cellValueStackSize = cellValues.size();
+        QgsRasterAnalysisUtils::cellValuesFromStack( stack, static_cast< qgssize >( row ) * iterCols + col, cellValues, noDataInStack );
+        const int cellValueStackSize = cellValues.size();
 
         if ( noDataInStack && !mIgnoreNoData )
         {
-          outputBlock->setValue( row, col, mNoDataValue );
+          output->setValue( row, col, mNoDataValue );
         }
         else if ( !noDataInStack || ( mIgnoreNoData && cellValueStackSize > 0 ) )
         {
@@ -631,15 +726,15 @@ void QgsCellStatisticsPercentRankFromValueAlgorithm::processRasterStack( QgsProc
               result = QgsRasterAnalysisUtils::interpolatedPercentRankExc( cellValues, cellValueStackSize, mValue, mNoDataValue );
               break;
           }
-          outputBlock->setValue( row, col, result );
+          output->setValue( row, col, result );
         }
         else
         {
           //result is NoData if cellValueStack contains no valid values, eg. all cellValues are NoData
-          outputBlock->setValue( row, col, mNoDataValue );
+          output->setValue( row, col, mNoDataValue );
         }
       }
-    }
+    } );
     mOutputRasterDataProvider->writeBlock( outputBlock.get(), 1, iterLeft, iterTop );
   }
   mOutputRasterDataProvider->setEditable( false );
@@ -749,11 +844,15 @@ void QgsCellStatisticsPercentRankFromRasterAlgorithm::processRasterStack( QgsPro
     }
 
     feedback->setProgress( 100 * ( ( iterTop / maxHeight * nbBlocksWidth ) + iterLeft / maxWidth ) / nbBlocks );
-    for ( int row = 0; row < iterRows; row++ )
+    const std::vector< std::vector< double > > stack = QgsRasterAnalysisUtils::blockStackValues( inputBlocks );
+    QgsRasterBlock *output = outputBlock.get();
+    QgsRasterAnalysisUtils::processRowsInParallel( iterRows, [&]( int row )
     {
       if ( feedback->isCanceled() )
-        break;
+        return;
 
+      std::vector<double> cellValues;
+      cellValues.reserve( stack.size() );
       for ( int col = 0; col < iterCols; col++ )
       {
         bool percentRankValueIsNoData = false;
@@ -761,12 +860,12 @@ void QgsCellStatisticsPercentRankFromRasterAlgorithm::processRasterStack( QgsPro
 
         double result = 0;
         bool noDataInStack = false;
-        std::vector<double> cellValues = QgsRasterAnalysisUtils::getCellValuesFromBlockStack( inputBlocks, row, col, noDataInStack );
-        int cellValueStackSize = cellValues.size();
+        QgsRasterAnalysisUtils::cellValuesFromStack( stack, static_cast< qgssize >( row ) * iterCols + col, cellValues, noDataInStack );
+        const int cellValueStackSize = cellValues.size();
 
         if ( noDataInStack && !mIgnoreNoData && !percentRankValueIsNoData )
         {
-          outputBlock->setValue( row, col, mNoDataValue );
+          output->setValue( row, col, mNoDataValue );
         }
         else if ( !noDataInStack || ( !percentRankValueIsNoData && mIgnoreNoData && cellValueStackSize > 0 ) )
         {
@@ -779,15 +878,15 @@ void QgsCellStatisticsPercentRankFromRasterAlgorithm::processRasterStack( QgsPro
               result = QgsRasterAnalysisUtils::interpolatedPercentRankExc( cellValues, cellValueStackSize, percentRankValue, mNoDataValue );
               break;
           }
-          outputBlock->setValue( row, col, result );
+          output->setValue( row, col, result );
         }
         else
         {
           //result is NoData if cellValueStack contains no valid values, eg. all cellValues are NoData or percentRankValue is NoData
-          outputBlock->setValue( row, col, mNoDataValue );
+          output->setValue( row, col, mNoDataValue );
         }
       }
-    }
+    } );
     mOutputRasterDataProvider->writeBlock( outputBlock.get(), 1, iterLeft, iterTop );
   }
   mOutputRasterDataProvider->setEditable( false );
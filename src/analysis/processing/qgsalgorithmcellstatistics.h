@@ -75,6 +75,9 @@ class QgsCellStatisticsAlgorithm : public QgsCellStatisticsAlgorithmBase
     void processRasterStack( QgsProcessingFeedback *feedback ) override;
 
   private:
+    //! Computes the statistics which can be accumulated layer by layer for a \a row of the output block
+    void accumulateRow( const std::vector< std::vector< double > > &stack, int row, int cols, QgsRasterBlock *output ) const;
+
     QgsRasterAnalysisUtils::CellValueStatisticMethods mMethod;
 
 };
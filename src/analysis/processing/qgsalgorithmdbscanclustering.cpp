@@ -17,7 +17,8 @@
 
 #include "qgsalgorithmdbscanclustering.h"
 #include "qgsspatialindexkdbush.h"
-#include <unordered_set>
+#include <numeric>
+#include <QtConcurrentMap>
 
 ///@cond PRIVATE
 
@@ -90,21 +91,8 @@ QgsDbscanClusteringAlgorithm *QgsDbscanClusteringAlgorithm::createInstance() con
   return new QgsDbscanClusteringAlgorithm();
 }
 
-struct KDBushDataEqualById
-{
-  bool operator()( const QgsSpatialIndexKDBushData &a, const QgsSpatialIndexKDBushData &b ) const
-  {
-    return  a.id == b.id;
-  }
-};
-
-struct KDBushDataHashById
-{
-  std::size_t operator()( const QgsSpatialIndexKDBushData &a ) const
-  {
-    return std::hash< QgsFeatureId > {}( a.id );
-  }
-};
+//! Minimum number of points of a cluster expansion step for their neighbors to be searched in parallel
+constexpr std::size_t DBSCAN_PARALLEL_FRONTIER_SIZE = 16;
 
 QVariantMap QgsDbscanClusteringAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
@@ -219,123 +207,194 @@ void QgsDbscanClusteringAlgorithm::stdbscan( const std::size_t minSize,
     std::unordered_map< QgsFeatureId, QDateTime> &idToDateTime,
     QgsProcessingFeedback *feedback )
 {
-  const double step = featureCount > 0 ? 90.0 / featureCount : 1;
-
-  std::unordered_set< QgsFeatureId > visited;
-  visited.reserve( index.size() );
+  // collect the points in the order of the features, which gives the order of the clusters
+  const double step = featureCount > 0 ? 10.0 / featureCount : 1;
+  std::vector< QgsFeatureId > ids;
+  std::vector< QgsPointXY > points;
+  std::vector< qint64 > times;
+  std::unordered_map< QgsFeatureId, std::size_t > idToIndex;
+  ids.reserve( index.size() );
+  points.reserve( index.size() );
+  idToIndex.reserve( index.size() );
+  if ( !idToDateTime.empty() )
+    times.reserve( index.size() );
 
   QgsFeature feat;
   int i = 0;
-  int clusterCount = 0;
-
   while ( features.nextFeature( feat ) )
   {
     if ( feedback->isCanceled() )
     {
-      break;
+      return;
     }
 
+    feedback->setProgress( ++i * step );
     if ( !feat.hasGeometry() )
-    {
-      feedback->setProgress( ++i * step );
-      continue;
-    }
-
-    if ( visited.find( feat.id() ) != visited.end() )
-    {
-      // already visited!
       continue;
-    }
 
-    QgsPointXY point;
-    if ( QgsWkbTypes::flatType( feat.geometry().wkbType() ) == QgsWkbTypes::Point )
-      point = QgsPointXY( *qgsgeometry_cast< const QgsPoint * >( feat.geometry().constGet() ) );
-    else
+    if ( QgsWkbTypes::flatType( feat.geometry().wkbType() ) != QgsWkbTypes::Point )
     {
       // not a point geometry
       feedback->reportError( QObject::tr( "Feature %1 is a %2 feature, not a point." ).arg( feat.id() ).arg( QgsWkbTypes::displayString( feat.geometry().wkbType() ) ) );
-      feedback->setProgress( ++i * step );
       continue;
     }
 
-    if ( !idToDateTime.empty() && !idToDateTime[ feat.id() ].isValid() )
+    if ( !idToDateTime.empty() )
     {
-      // missing datetime value
-      feedback->reportError( QObject::tr( "Feature %1 is missing a valid datetime value." ).arg( feat.id() ).arg( QgsWkbTypes::displayString( feat.geometry().wkbType() ) ) );
-      feedback->setProgress( ++i * step );
-      continue;
+      const QDateTime dateTime = idToDateTime[ feat.id() ];
+      if ( !dateTime.isValid() )
+      {
+        // missing datetime value
+        feedback->reportError( QObject::tr( "Feature %1 is missing a valid datetime value." ).arg( feat.id() ).arg( QgsWkbTypes::displayString( feat.geometry().wkbType() ) ) );
+        continue;
+      }
+      times.emplace_back( dateTime.toMSecsSinceEpoch() );
     }
 
-    std::unordered_set< QgsSpatialIndexKDBushData, KDBushDataHashById, KDBushDataEqualById> within;
+    idToIndex[ feat.id() ] = points.size();
+    ids.emplace_back( feat.id() );
+    points.emplace_back( *qgsgeometry_cast< const QgsPoint * >( feat.geometry().constGet() ) );
+  }
 
-    if ( minSize > 1 )
+  // visits the indices of the points within the distances of the point at index i
+  const auto visitNeighbors = [&index, &idToIndex, &points, &times, eps1, eps2]( std::size_t i, const std::function< void( std::size_t ) > &visitor )
+  {
+    index.within( points[i], eps1, [&idToIndex, &times, eps2, &visitor, i]( const QgsSpatialIndexKDBushData & data )
+    {
+      const auto it = idToIndex.find( data.id );
+      if ( it == idToIndex.end() )
+        return;
+
+      if ( times.empty() || std::abs( times[ it->second ] - times[i] ) <= eps2 )
+        visitor( it->second );
+    } );
+  };
+
+  // find the core points, which have at least minSize points within the distances, in parallel
+  const std::size_t pointCount = points.size();
+  std::vector< char > isCore( pointCount, minSize <= 1 );
+  if ( minSize > 1 )
+  {
+    std::vector< std::size_t > candidates;
+    candidates.reserve( pointCount );
+    if ( times.empty() && eps1 > 0 )
     {
-      index.within( point, eps1, [&within, pointId = feat.id(), &idToDateTime, &eps2]( const QgsSpatialIndexKDBushData & data )
+      // points sharing a grid cell with a diagonal of eps1 are all within eps1 of each other,
+      // so that the points of cells holding at least minSize points are core points without any search
+      const double cellSize = eps1 / M_SQRT2;
+      const auto cellKey = [cellSize]( const QgsPointXY & point )
       {
-        if ( idToDateTime.empty() || ( idToDateTime[ data.id ].isValid() && std::abs( idToDateTime[ pointId ].msecsTo( idToDateTime[ data.id ] ) ) <= eps2 ) )
-          within.insert( data );
-      } );
-      if ( within.size() < minSize )
-        continue;
-
-      visited.insert( feat.id() );
+        return qMakePair( static_cast< qint64 >( std::floor( point.x() / cellSize ) ), static_cast< qint64 >( std::floor( point.y() / cellSize ) ) );
+      };
+      QHash< QPair< qint64, qint64 >, std::size_t > cellCounts;
+      for ( const QgsPointXY &point : points )
+        cellCounts[ cellKey( point ) ]++;
+      for ( std::size_t j = 0; j < pointCount; ++j )
+      {
+        if ( cellCounts.value( cellKey( points[j] ) ) >= minSize )
+          isCore[j] = true;
+        else
+          candidates.emplace_back( j );
+      }
     }
     else
     {
-      // optimised case for minSize == 1, we can skip the initial check
-      within.insert( QgsSpatialIndexKDBushData( feat.id(), point.x(), point.y() ) );
+      candidates.resize( pointCount );
+      std::iota( candidates.begin(), candidates.end(), 0 );
     }
 
-    // start new cluster
-    clusterCount++;
-    idToCluster[ feat.id() ] = clusterCount;
-    feedback->setProgress( ++i * step );
-
-    while ( !within.empty() )
+    // search the remaining points by batches, to report the progress between them
+    const std::size_t batchSize = std::max< std::size_t >( 1, candidates.size() / 100 );
+    for ( std::size_t batchStart = 0; batchStart < candidates.size(); batchStart += batchSize )
     {
       if ( feedback->isCanceled() )
-      {
-        break;
-      }
-
-      const QgsSpatialIndexKDBushData j = *within.begin();
-      within.erase( within.begin() );
+        return;
 
-      if ( visited.find( j.id ) != visited.end() )
+      std::vector< std::size_t > batch( candidates.begin() + batchStart, candidates.begin() + std::min( candidates.size(), batchStart + batchSize ) );
+      QtConcurrent::blockingMap( batch, [&isCore, &visitNeighbors, minSize]( const std::size_t & j )
       {
-        // already visited!
-        continue;
-      }
+        std::size_t count = 0;
+        visitNeighbors( j, [&count]( std::size_t ) { count++; } );
+        isCore[j] = count >= minSize;
+      } );
+      feedback->setProgress( 10 + 40.0 * ( batchStart + batch.size() ) / candidates.size() );
+    }
+  }
 
-      visited.insert( j.id );
-      feedback->setProgress( ++i * step );
+  // grow the clusters from the core points. The neighbors of the core points of each step of a cluster
+  // are searched in parallel, and only core points continue the expansion
+  const double clusterStep = pointCount > 0 ? 40.0 / pointCount : 1;
+  std::vector< char > visited( pointCount, false );
+  std::vector< std::size_t > frontier;
+  std::vector< std::vector< std::size_t > > frontierNeighbors;
+  int clusterCount = 0;
+  std::size_t visitedCount = 0;
+  for ( std::size_t seed = 0; seed < pointCount; ++seed )
+  {
+    if ( feedback->isCanceled() )
+      break;
 
-      // check from this point
-      const QgsPointXY point2 = j.point();
+    if ( visited[seed] || !isCore[seed] )
+      continue;
 
-      std::unordered_set< QgsSpatialIndexKDBushData, KDBushDataHashById, KDBushDataEqualById > within2;
-      index.within( point2, eps1, [&within2, point2Id = j.id, &idToDateTime, &eps2]( const QgsSpatialIndexKDBushData & data )
-      {
-        if ( idToDateTime.empty() || ( idToDateTime[ data.id ].isValid() && std::abs( idToDateTime[ point2Id ].msecsTo( idToDateTime[ data.id ] ) ) <= eps2 ) )
-          within2.insert( data );
-      } );
+    // start new cluster
+    clusterCount++;
+    visited[seed] = true;
+    visitedCount++;
+    idToCluster[ ids[seed] ] = clusterCount;
+    frontier.assign( 1, seed );
 
-      if ( within2.size() >= minSize )
+    while ( !frontier.empty() )
+    {
+      if ( feedback->isCanceled() )
+        break;
+
+      frontierNeighbors.assign( frontier.size(), std::vector< std::size_t >() );
+      const auto searchNeighbors = [&frontier, &frontierNeighbors, &visited, &visitNeighbors]( std::size_t j )
       {
-        // expand neighbourhood
-        std::copy_if( within2.begin(),
-                      within2.end(),
-                      std::inserter( within, within.end() ),
-                      [&visited]( const QgsSpatialIndexKDBushData & needle )
+        std::vector< std::size_t > &neighbors = frontierNeighbors[j];
+        visitNeighbors( frontier[j], [&neighbors, &visited]( std::size_t neighbor )
         {
-          return visited.find( needle.id ) == visited.end();
+          if ( !visited[neighbor] )
+            neighbors.emplace_back( neighbor );
         } );
+      };
+      if ( frontier.size() < DBSCAN_PARALLEL_FRONTIER_SIZE )
+      {
+        for ( std::size_t j = 0; j < frontier.size(); ++j )
+          searchNeighbors( j );
       }
-      if ( !borderPointsAreNoise || within2.size() >= minSize )
+      else
       {
-        idToCluster[ j.id ] = clusterCount;
+        std::vector< std::size_t > frontierIndices( frontier.size() );
+        std::iota( frontierIndices.begin(), frontierIndices.end(), 0 );
+        QtConcurrent::blockingMap( frontierIndices, [&searchNeighbors]( const std::size_t & j ) { searchNeighbors( j ); } );
+      }
+
+      frontier.clear();
+      for ( const std::vector< std::size_t > &neighbors : frontierNeighbors )
+      {
+        for ( const std::size_t neighbor : neighbors )
+        {
+          if ( visited[neighbor] )
+            continue;
+
+          visited[neighbor] = true;
+          visitedCount++;
+          if ( isCore[neighbor] )
+          {
+            // expand neighbourhood
+            frontier.emplace_back( neighbor );
+            idToCluster[ ids[neighbor] ] = clusterCount;
+          }
+          else if ( !borderPointsAreNoise )
+          {
+            idToCluster[ ids[neighbor] ] = clusterCount;
+          }
+        }
       }
     }
+    feedback->setProgress( 50 + visitedCount * clusterStep );
   }
 }
 
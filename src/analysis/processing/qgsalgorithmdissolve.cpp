@@ -17,14 +17,120 @@
 
 #include "qgsalgorithmdissolve.h"
 
+#include <QtConcurrentMap>
+
 ///@cond PRIVATE
 
+//! Maximum number of geometries united together by a single thread when dissolving
+static constexpr int DISSOLVE_CHUNK_SIZE = 256;
+
+//! Number of geometries collected before they are dissolved when dissolving all features
+static constexpr int DISSOLVE_MAX_QUEUE_LENGTH = 100000;
+
+//! Result of the union of a chunk of geometries
+struct DissolveResult
+{
+  QgsGeometry geometry;
+  //! TRUE if the geometries had to be united one by one after a GEOS error
+  bool slowerRoute = false;
+};
+
+/**
+ * Unites the geometries of a chunk, merging the resulting lines.
+ *
+ * This is called from several threads, so the \a feedback is only used to check for cancellation.
+ */
+static DissolveResult dissolveGeometries( const QVector< QgsGeometry > &parts, QgsFeedback *feedback )
+{
+  DissolveResult result;
+  result.geometry = QgsGeometry::unaryUnion( parts );
+  if ( QgsWkbTypes::geometryType( result.geometry.wkbType() ) == QgsWkbTypes::LineGeometry )
+    result.geometry = result.geometry.mergeLines();
+  // Geos may fail in some cases, let's try a slower but safer approach
+  // See: https://github.com/qgis/QGIS/issues/28411 - Dissolve tool failing to produce outputs
+  if ( ! result.geometry.lastError().isEmpty() && parts.count() >  2 )
+  {
+    if ( feedback->isCanceled() )
+      return result;
+
+    result.slowerRoute = true;
+    result.geometry = QgsGeometry();
+    for ( const auto &p : parts )
+    {
+      result.geometry = QgsGeometry::unaryUnion( QVector< QgsGeometry >() << result.geometry << p );
+      if ( QgsWkbTypes::geometryType( result.geometry.wkbType() ) == QgsWkbTypes::LineGeometry )
+        result.geometry = result.geometry.mergeLines();
+      if ( feedback->isCanceled() )
+        return result;
+    }
+  }
+  return result;
+}
+
+/**
+ * Splits geometries into chunks of at most \a chunkSize geometries close to each other, by sorting
+ * them along a Z-order curve through the centers of their bounding boxes.
+ */
+static QVector< QVector< QgsGeometry > > spatialChunks( const QVector< QgsGeometry > &geometries, int chunkSize )
+{
+  if ( geometries.size() <= chunkSize )
+    return QVector< QVector< QgsGeometry > >() << geometries;
+
+  QVector< QgsPointXY > centers;
+  centers.reserve( geometries.size() );
+  double xMin = std::numeric_limits< double >::max();
+  double yMin = std::numeric_limits< double >::max();
+  double xMax = std::numeric_limits< double >::lowest();
+  double yMax = std::numeric_limits< double >::lowest();
+  for ( const QgsGeometry &geometry : geometries )
+  {
+    const QgsPointXY center = geometry.boundingBox().center();
+    xMin = std::min( xMin, center.x() );
+    yMin = std::min( yMin, center.y() );
+    xMax = std::max( xMax, center.x() );
+    yMax = std::max( yMax, center.y() );
+    centers << center;
+  }
+
+  // interleave the bits of the cells of the centers on a 65536 x 65536 grid
+  const double width = xMax > xMin ? xMax - xMin : 1;
+  const double height = yMax > yMin ? yMax - yMin : 1;
+  std::vector< std::pair< quint32, int > > keys;
+  keys.reserve( geometries.size() );
+  for ( int i = 0; i < centers.size(); ++i )
+  {
+    const quint32 column = static_cast< quint32 >( std::min( 65535.0, ( centers.at( i ).x() - xMin ) / width * 65535.0 ) );
+    const quint32 row = static_cast< quint32 >( std::min( 65535.0, ( centers.at( i ).y() - yMin ) / height * 65535.0 ) );
+    quint32 key = 0;
+    for ( int bit = 0; bit < 16; ++bit )
+    {
+      key |= ( ( column >> bit ) & 1 ) << ( 2 * bit );
+      key |= ( ( row >> bit ) & 1 ) << ( 2 * bit + 1 );
+    }
+    keys.emplace_back( key, i );
+  }
+  std::sort( keys.begin(), keys.end() );
+
+  QVector< QVector< QgsGeometry > > chunks;
+  chunks.reserve( static_cast< int >( keys.size() ) / chunkSize + 1 );
+  for ( std::size_t i = 0; i < keys.size(); ++i )
+  {
+    if ( i % chunkSize == 0 )
+    {
+      chunks << QVector< QgsGeometry >();
+      chunks.last().reserve( chunkSize );
+    }
+    chunks.last() << geometries.at( keys[i].second );
+  }
+  return chunks;
+}
+
 //
 // QgsCollectorAlgorithm
 //
 
 QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback,
-    const std::function<QgsGeometry( const QVector< QgsGeometry >& )> &collector, int maxQueueLength, QgsProcessingFeatureSource::Flags sourceFlags, bool separateDisjoint )
+    const std::function<QgsGeometry( const QVector< QgsGeometry >& )> &collector, int maxQueueLength, QgsProcessingFeatureSource::Flags sourceFlags, bool separateDisjoint, bool sortedInput )
 {
   std::unique_ptr< QgsProcessingFeatureSource > source( parameterAsSource( parameters, QStringLiteral( "INPUT" ), context ) );
   if ( !source )
@@ -113,50 +219,13 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
         fieldIndexes << index;
     }
 
-    QHash< QVariant, QgsAttributes > attributeHash;
-    QHash< QVariant, QVector< QgsGeometry > > geometryHash;
-
-    while ( it.nextFeature( f ) )
-    {
-      if ( feedback->isCanceled() )
-      {
-        break;
-      }
-
-      QVariantList indexAttributes;
-      indexAttributes.reserve( fieldIndexes.size() );
-      for ( const int index : std::as_const( fieldIndexes ) )
-      {
-        indexAttributes << f.attribute( index );
-      }
-
-      if ( !attributeHash.contains( indexAttributes ) )
-      {
-        // keep attributes of first feature
-        attributeHash.insert( indexAttributes, f.attributes() );
-      }
-
-      if ( f.hasGeometry() && !f.geometry().isNull() )
-      {
-        geometryHash[ indexAttributes ].append( f.geometry() );
-      }
-    }
-
-    const int numberFeatures = attributeHash.count();
-    QHash< QVariant, QgsAttributes >::const_iterator attrIt = attributeHash.constBegin();
-    for ( ; attrIt != attributeHash.constEnd(); ++attrIt )
+    auto writeGroup = [&]( const QgsAttributes & attributes, const QVector< QgsGeometry > *geometries )
     {
-      if ( feedback->isCanceled() )
-      {
-        break;
-      }
-
       QgsFeature outputFeature;
-      outputFeature.setAttributes( attrIt.value() );
-      auto geometryHashIt = geometryHash.find( attrIt.key() );
-      if ( geometryHashIt != geometryHash.end() )
+      outputFeature.setAttributes( attributes );
+      if ( geometries )
       {
-        QgsGeometry geom = collector( geometryHashIt.value() );
+        QgsGeometry geom = collector( *geometries );
         if ( !geom.isMultipart() )
         {
           geom.convertToMultiType();
@@ -184,9 +253,99 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
         if ( !sink->addFeature( outputFeature, QgsFeatureSink::FastInsert ) )
           throw QgsProcessingException( writeFeatureError( sink.get(), parameters, QStringLiteral( "OUTPUT" ) ) );
       }
+    };
 
-      feedback->setProgress( current * 100.0 / numberFeatures );
-      current++;
+    if ( sortedInput )
+    {
+      // the features of a group follow each other, so each group is written as soon as the next one starts
+      QVariantList groupAttributes;
+      QgsAttributes groupFirstAttributes;
+      QVector< QgsGeometry > groupGeometries;
+      bool hasGroup = false;
+      while ( it.nextFeature( f ) )
+      {
+        if ( feedback->isCanceled() )
+        {
+          break;
+        }
+
+        QVariantList indexAttributes;
+        indexAttributes.reserve( fieldIndexes.size() );
+        for ( const int index : std::as_const( fieldIndexes ) )
+        {
+          indexAttributes << f.attribute( index );
+        }
+
+        if ( !hasGroup || indexAttributes != groupAttributes )
+        {
+          if ( hasGroup )
+            writeGroup( groupFirstAttributes, groupGeometries.isEmpty() ? nullptr : &groupGeometries );
+
+          // keep attributes of first feature
+          hasGroup = true;
+          groupAttributes = indexAttributes;
+          groupFirstAttributes = f.attributes();
+          groupGeometries.clear();
+        }
+
+        if ( f.hasGeometry() && !f.geometry().isNull() )
+        {
+          groupGeometries.append( f.geometry() );
+        }
+
+        feedback->setProgress( current * step );
+        current++;
+      }
+
+      if ( hasGroup && !feedback->isCanceled() )
+        writeGroup( groupFirstAttributes, groupGeometries.isEmpty() ? nullptr : &groupGeometries );
+    }
+    else
+    {
+      QHash< QVariant, QgsAttributes > attributeHash;
+      QHash< QVariant, QVector< QgsGeometry > > geometryHash;
+
+      while ( it.nextFeature( f ) )
+      {
+        if ( feedback->isCanceled() )
+        {
+          break;
+        }
+
+        QVariantList indexAttributes;
+        indexAttributes.reserve( fieldIndexes.size() );
+        for ( const int index : std::as_const( fieldIndexes ) )
+        {
+          indexAttributes << f.attribute( index );
+        }
+
+        if ( !attributeHash.contains( indexAttributes ) )
+        {
+          // keep attributes of first feature
+          attributeHash.insert( indexAttributes, f.attributes() );
+        }
+
+        if ( f.hasGeometry() && !f.geometry().isNull() )
+        {
+          geometryHash[ indexAttributes ].append( f.geometry() );
+        }
+      }
+
+      const int numberFeatures = attributeHash.count();
+      QHash< QVariant, QgsAttributes >::const_iterator attrIt = attributeHash.constBegin();
+      for ( ; attrIt != attributeHash.constEnd(); ++attrIt )
+      {
+        if ( feedback->isCanceled() )
+        {
+          break;
+        }
+
+        auto geometryHashIt = geometryHash.constFind( attrIt.key() );
+        writeGroup( attrIt.value(), geometryHashIt != geometryHash.constEnd() ? &geometryHashIt.value() : nullptr );
+
+        feedback->setProgress( current * 100.0 / numberFeatures );
+        current++;
+      }
     }
   }
 
@@ -237,6 +396,11 @@ void QgsDissolveAlgorithm::initAlgorithm( const QVariantMap & )
   disjointParam->setFlags( disjointParam->flags() | QgsProcessingParameterDefinition::FlagAdvanced );
   addParameter( disjointParam.release() );
 
+  std::unique_ptr< QgsProcessingParameterBoolean > sortedParam = std::make_unique< QgsProcessingParameterBoolean >( QStringLiteral( "SORTED_INPUT" ),
+      QObject::tr( "Input features are sorted by the dissolve field(s)" ), false );
+  sortedParam->setFlags( sortedParam->flags() | QgsProcessingParameterDefinition::FlagAdvanced );
+  addParameter( sortedParam.release() );
+
   addParameter( new QgsProcessingParameterFeatureSink( QStringLiteral( "OUTPUT" ), QObject::tr( "Dissolved" ) ) );
 }
 
@@ -248,7 +412,10 @@ QString QgsDissolveAlgorithm::shortHelpString() const
                       "All output geometries will be converted to multi geometries. "
                       "In case the input is a polygon layer, common boundaries of adjacent polygons being dissolved will get erased.\n\n"
                       "If enabled, the optional \"Keep disjoint features separate\" setting will cause features and parts that do not overlap or touch to be exported "
-                      "as separate features (instead of parts of a single multipart feature)." );
+                      "as separate features (instead of parts of a single multipart feature).\n\n"
+                      "If the optional \"Input features are sorted by the dissolve field(s)\" setting is enabled, the features with the same "
+                      "dissolve field values are expected to follow each other in the input layer, and each group of features is dissolved as soon as it is read. "
+                      "This needs much less memory for large layers, but a group of features will be split if its features are not contiguous." );
 }
 
 QgsDissolveAlgorithm *QgsDissolveAlgorithm::createInstance() const
@@ -259,38 +426,52 @@ QgsDissolveAlgorithm *QgsDissolveAlgorithm::createInstance() const
 QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   const bool separateDisjoint = parameterAsBool( parameters, QStringLiteral( "SEPARATE_DISJOINT" ), context );
+  const bool sortedInput = parameterAsBool( parameters, QStringLiteral( "SORTED_INPUT" ), context );
 
   return processCollection( parameters, context, feedback, [ & ]( const QVector< QgsGeometry > &parts )->QgsGeometry
   {
-    QgsGeometry result( QgsGeometry::unaryUnion( parts ) );
-    if ( QgsWkbTypes::geometryType( result.wkbType() ) == QgsWkbTypes::LineGeometry )
-      result = result.mergeLines();
-    // Geos may fail in some cases, let's try a slower but safer approach
-    // See: https://github.com/qgis/QGIS/issues/28411 - Dissolve tool failing to produce outputs
-    if ( ! result.lastError().isEmpty() && parts.count() >  2 )
+    // the geometries are united hierarchically from several threads: the geometries close to each other are first
+    // united by chunks, and the unions of neighboring chunks are then united by pairs until a single geometry remains
+    QVector< QVector< QgsGeometry > > chunks = spatialChunks( parts, DISSOLVE_CHUNK_SIZE );
+    const std::function< DissolveResult( const QVector< QgsGeometry > & ) > dissolveChunk = [feedback]( const QVector< QgsGeometry > &chunk )
     {
-      if ( feedback->isCanceled() )
-        return result;
+      return dissolveGeometries( chunk, feedback );
+    };
+
+    int level = 0;
+    while ( true )
+    {
+      if ( chunks.size() > 1 )
+        feedback->setProgressText( QObject::tr( "Dissolving geometries (level %1, %2 chunks)" ).arg( ++level ).arg( chunks.size() ) );
 
-      feedback->pushDebugInfo( QObject::tr( "GEOS exception: taking the slower route ..." ) );
-      result = QgsGeometry();
-      for ( const auto &p : parts )
+      const QVector< DissolveResult > results = QtConcurrent::blockingMapped< QVector< DissolveResult > >( chunks, dissolveChunk );
+      chunks.clear();
+
+      for ( const DissolveResult &result : results )
       {
-        result = QgsGeometry::unaryUnion( QVector< QgsGeometry >() << result << p );
-        if ( QgsWkbTypes::geometryType( result.wkbType() ) == QgsWkbTypes::LineGeometry )
-          result = result.mergeLines();
-        if ( feedback->isCanceled() )
-          return result;
+        if ( result.slowerRoute )
+          feedback->pushDebugInfo( QObject::tr( "GEOS exception: taking the slower route ..." ) );
+        if ( !result.geometry.lastError().isEmpty() )
+        {
+          feedback->reportError( result.geometry.lastError(), true );
+          if ( result.geometry.isEmpty() )
+            throw QgsProcessingException( QObject::tr( "The algorithm returned no output." ) );
+        }
+      }
+
+      if ( results.size() == 1 || feedback->isCanceled() )
+        return results.isEmpty() ? QgsGeometry() : results.first().geometry;
+
+      for ( int i = 0; i < results.size(); i += 2 )
+      {
+        QVector< QgsGeometry > pair;
+        pair << results.at( i ).geometry;
+        if ( i + 1 < results.size() )
+          pair << results.at( i + 1 ).geometry;
+        chunks << pair;
       }
     }
-    if ( ! result.lastError().isEmpty() )
-    {
-      feedback->reportError( result.lastError(), true );
-      if ( result.isEmpty() )
-        throw QgsProcessingException( QObject::tr( "The algorithm returned no output." ) );
-    }
-    return result;
-  }, 10000, QgsProcessingFeatureSource::Flags(), separateDisjoint );
+  }, DISSOLVE_MAX_QUEUE_LENGTH, QgsProcessingFeatureSource::Flags(), separateDisjoint, sortedInput );
 }
 
 //
@@ -33,9 +33,16 @@ class QgsCollectorAlgorithm : public QgsProcessingAlgorithm
 {
   protected:
 
+    /**
+     * Combines the geometries of the features of the INPUT source with the \a collector, for each group
+     * of features with the same values of the FIELD fields.
+     *
+     * If \a sortedInput is TRUE, the features of a group are expected to follow each other, and each group is
+     * written as soon as the features of the next group start, instead of keeping all the groups in memory.
+     */
     QVariantMap processCollection( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback,
                                    const std::function<QgsGeometry( const QVector<QgsGeometry>& )> &collector, int maxQueueLength = 0, QgsProcessingFeatureSource::Flags sourceFlags = QgsProcessingFeatureSource::Flags(),
-                                   bool separateDisjoint = false );
+                                   bool separateDisjoint = false, bool sortedInput = false );
 };
 
 /**
@@ -146,27 +146,39 @@ QgsFeatureList QgsDrapeAlgorithmBase::processFeature( const QgsFeature &feature,
     // a pointless iteration over all vertices
     if ( !mRasterExtent.isNull() && geometry.boundingBoxIntersects( mRasterExtent ) )
     {
-      geometry.transformVertices( [ = ]( const QgsPoint & p )->QgsPoint
+      // transform all the vertices first, so that the raster is sampled at once for the whole geometry
+      QVector< QgsPointXY > rasterPoints;
+      QVector< int > failedVertices;
+      rasterPoints.reserve( geometry.constGet()->nCoordinates() );
+      for ( auto it = geometry.vertices_begin(); it != geometry.vertices_end(); ++it )
       {
-        QgsPointXY t;
-        double val = nodata;
         try
         {
-          t = mTransform.transform( p );
-          bool ok = false;
-          val = mRasterProvider->sample( t, mBand, &ok );
-          if ( !ok )
-            val = nodata;
-          else
-          {
-            val *= scale;
-            val += offset;
-          }
+          rasterPoints << mTransform.transform( *it );
         }
         catch ( QgsCsException & )
         {
+          failedVertices << rasterPoints.size();
+          rasterPoints << QgsPointXY();
           feedback->reportError( QObject::tr( "Transform error while reprojecting feature {}" ).arg( f.id() ) );
         }
+      }
+
+      QVector< double > values = mRasterProvider->samplePoints( rasterPoints, mBand );
+      for ( const int vertex : std::as_const( failedVertices ) )
+        values[ vertex ] = std::numeric_limits< double >::quiet_NaN();
+
+      int vertex = 0;
+      geometry.transformVertices( [this, &values, &vertex, nodata, scale, offset]( const QgsPoint & p )->QgsPoint
+      {
+        double val = values.at( vertex++ );
+        if ( std::isnan( val ) )
+          val = nodata;
+        else
+        {
+          val *= scale;
+          val += offset;
+        }
 
         return drapeVertex( p, val );
       } );
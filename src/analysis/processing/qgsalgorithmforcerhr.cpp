@@ -22,6 +22,11 @@
 
 ///@cond PRIVATE
 
+QgsProcessingAlgorithm::Flags QgsForceRHRAlgorithm::flags() const
+{
+  return QgsProcessingFeatureBasedAlgorithm::flags() | QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing;
+}
+
 QString QgsForceRHRAlgorithm::name() const
 {
   return QStringLiteral( "forcerhr" );
@@ -18,11 +18,20 @@
 #include "qgsalgorithmjoinbynearest.h"
 #include "qgsprocessingoutputs.h"
 #include "qgslinestring.h"
+#include "qgsnearestneighborindex.h"
 
 #include <algorithm>
+#include <functional>
+#include <QtConcurrentMap>
 
 ///@cond PRIVATE
 
+//! Number of input features whose nearest features are searched in parallel before being written
+constexpr int JOIN_BATCH_SIZE = 1000;
+
+//! Nearest features of an input feature, with the attributes of the shortest lines to them
+typedef QList< QPair< QgsFeatureId, QgsAttributes > > JoinMatches;
+
 QString QgsJoinByNearestAlgorithm::name() const
 {
   return QStringLiteral( "joinbynearest" );
@@ -192,20 +201,22 @@ QVariantMap QgsJoinByNearestAlgorithm::processAlgorithm( const QVariantMap &para
     throw QgsProcessingException( invalidSinkError( parameters, QStringLiteral( "NON_MATCHING" ) ) );
 
   // make spatial index
-  const QgsFeatureIterator f2 = input2->getFeatures( QgsFeatureRequest().setDestinationCrs( input->sourceCrs(), context.transformContext() ).setSubsetOfAttributes( fields2Fetch ) );
+  QgsFeatureIterator f2 = input2->getFeatures( QgsFeatureRequest().setDestinationCrs( input->sourceCrs(), context.transformContext() ).setSubsetOfAttributes( fields2Fetch ) );
   QHash< QgsFeatureId, QgsAttributes > input2AttributeCache;
   double step = input2->featureCount() > 0 ? 50.0 / input2->featureCount() : 1;
   int i = 0;
-  const QgsSpatialIndex index( f2, [&]( const QgsFeature & f )->bool
+  QgsNearestNeighborIndex index;
+  QgsFeature f;
+  while ( f2.nextFeature( f ) )
   {
     i++;
     if ( feedback->isCanceled() )
-      return false;
+      break;
 
     feedback->setProgress( i * step );
 
     if ( !f.hasGeometry() )
-      return true;
+      continue;
 
     // only keep selected attributes
     QgsAttributes attributes;
@@ -216,11 +227,9 @@ QVariantMap QgsJoinByNearestAlgorithm::processAlgorithm( const QVariantMap &para
       attributes << f.attribute( j );
     }
     input2AttributeCache.insert( f.id(), attributes );
-
-    return true;
-  }, QgsSpatialIndex::FlagStoreFeatureGeometries );
-
-  QgsFeature f;
+    index.addFeature( f.id(), f.geometry() );
+  }
+  index.build();
 
   // create extra null attributes for non-matched records (the +2 is for the "n" and "distance", and start/end x/y fields)
   QgsAttributes nullMatch;
@@ -231,101 +240,111 @@ QVariantMap QgsJoinByNearestAlgorithm::processAlgorithm( const QVariantMap &para
   long long joinedCount = 0;
   long long unjoinedCount = 0;
 
+  // if the user didn't specify a distance (isnan), then don't limit the search distance
+  // if the user specified 0 exactly, then use the smallest positive double value instead
+  const double searchDistance = std::isnan( maxDistance ) ? 0 : std::max( std::numeric_limits<double>::min(), maxDistance );
+
+  // the nearest features and the shortest lines to them are found in parallel, for batches of input features
+  const bool computeLines = static_cast< bool >( sink );
+  const std::function< JoinMatches( const QgsFeature & ) > findMatches = [&index, neighbors, searchDistance, sameSourceAndTarget, computeLines]( const QgsFeature & feature )
+  {
+    JoinMatches result;
+    if ( !feature.hasGeometry() )
+      return result;
+
+    // don't match to same feature if using a single input table
+    const QList< QgsNearestNeighborIndex::Neighbor > nearest = index.nearestNeighbors( feature.geometry(), neighbors, searchDistance, sameSourceAndTarget ? feature.id() : FID_NULL );
+    result.reserve( nearest.size() );
+    for ( const QgsNearestNeighborIndex::Neighbor &neighbor : nearest )
+    {
+      QgsAttributes lineAttributes;
+      if ( computeLines )
+      {
+        const QgsGeometry closestLine = feature.geometry().shortestLine( index.geometry( neighbor.index ) );
+        if ( const QgsLineString *line = qgsgeometry_cast< const QgsLineString *>( closestLine.constGet() ) )
+        {
+          lineAttributes << line->length();
+          lineAttributes << line->startPoint().x() << line->startPoint().y();
+          lineAttributes << line->endPoint().x() << line->endPoint().y();
+        }
+        else
+        {
+          //distance, start x, start y, end x, end y
+          lineAttributes << QVariant() << QVariant() << QVariant() << QVariant() << QVariant();
+        }
+      }
+      result.append( qMakePair( neighbor.id, lineAttributes ) );
+    }
+    return result;
+  };
+
   // Create output vector layer with additional attributes
   step = input->featureCount() > 0 ? 50.0 / input->featureCount() : 1;
   QgsFeatureIterator features = input->getFeatures();
+  QgsFeatureList batch;
+  batch.reserve( JOIN_BATCH_SIZE );
   i = 0;
-  while ( features.nextFeature( f ) )
+  bool finished = false;
+  while ( !finished && !feedback->isCanceled() )
   {
-    i++;
-    if ( feedback->isCanceled() )
-    {
-      break;
-    }
+    batch.clear();
+    while ( batch.size() < JOIN_BATCH_SIZE && features.nextFeature( f ) )
+      batch << f;
+    finished = batch.size() < JOIN_BATCH_SIZE;
 
-    feedback->setProgress( 50 + i * step );
+    const QList< JoinMatches > batchMatches = QtConcurrent::blockingMapped< QList< JoinMatches > >( batch, findMatches );
 
-    if ( !f.hasGeometry() )
+    for ( int batchIndex = 0; batchIndex < batch.size(); ++batchIndex )
     {
-      unjoinedCount++;
-      if ( sinkNonMatching1 )
-      {
-        if ( !sinkNonMatching1->addFeature( f, QgsFeatureSink::FastInsert ) )
-          throw QgsProcessingException( writeFeatureError( sinkNonMatching1.get(), parameters, QStringLiteral( "NON_MATCHING" ) ) );
-      }
-      if ( sink && !discardNonMatching )
+      i++;
+      if ( feedback->isCanceled() )
       {
-        QgsAttributes attr = f.attributes();
-        attr.append( nullMatch );
-        f.setAttributes( attr );
-        if ( !sink->addFeature( f, QgsFeatureSink::FastInsert ) )
-          throw QgsProcessingException( writeFeatureError( sink.get(), parameters, QStringLiteral( "OUTPUT" ) ) );
+        break;
       }
-    }
-    else
-    {
-      // note - if using same source as target, we have to get one extra neighbor, since the first match will be the input feature
 
-      // if the user didn't specify a distance (isnan), then use 0 for nearestNeighbor() parameter
-      // if the user specified 0 exactly, then use the smallest positive double value instead
-      const double searchDistance = std::isnan( maxDistance ) ? 0 : std::max( std::numeric_limits<double>::min(), maxDistance );
-      const QList< QgsFeatureId > nearest = index.nearestNeighbor( f.geometry(), neighbors + ( sameSourceAndTarget ? 1 : 0 ), searchDistance );
+      feedback->setProgress( 50 + i * step );
 
-      if ( nearest.count() > neighbors + ( sameSourceAndTarget ? 1 : 0 ) )
+      QgsFeature &inputFeature = batch[ batchIndex ];
+      const JoinMatches &matches = batchMatches.at( batchIndex );
+      if ( inputFeature.hasGeometry() && matches.count() > neighbors )
       {
-        feedback->pushInfo( QObject::tr( "Multiple matching features found at same distance from search feature, found %n feature(s) instead of %1", nullptr, nearest.count() - ( sameSourceAndTarget ? 1 : 0 ) ).arg( neighbors ) );
+        feedback->pushInfo( QObject::tr( "Multiple matching features found at same distance from search feature, found %n feature(s) instead of %1", nullptr, matches.count() ).arg( neighbors ) );
       }
-      QgsFeature out;
-      out.setGeometry( f.geometry() );
-      int j = 0;
-      for ( const QgsFeatureId id : nearest )
+
+      if ( !matches.isEmpty() )
       {
-        if ( sameSourceAndTarget && id == f.id() )
-          continue; // don't match to same feature if using a single input table
-        j++;
         if ( sink )
         {
-          QgsAttributes attr = f.attributes();
-          attr.append( input2AttributeCache.value( id ) );
-          attr.append( j );
-
-          const QgsGeometry closestLine = f.geometry().shortestLine( index.geometry( id ) );
-          if ( const QgsLineString *line = qgsgeometry_cast< const QgsLineString *>( closestLine.constGet() ) )
+          QgsFeature out;
+          out.setGeometry( inputFeature.geometry() );
+          int j = 0;
+          for ( const QPair< QgsFeatureId, QgsAttributes > &match : matches )
           {
-            attr.append( line->length() );
-            attr.append( line->startPoint().x() );
-            attr.append( line->startPoint().y() );
-            attr.append( line->endPoint().x() );
-            attr.append( line->endPoint().y() );
+            j++;
+            QgsAttributes attr = inputFeature.attributes();
+            attr.append( input2AttributeCache.value( match.first ) );
+            attr.append( j );
+            attr.append( match.second );
+            out.setAttributes( attr );
+            if ( !sink->addFeature( out, QgsFeatureSink::FastInsert ) )
+              throw QgsProcessingException( writeFeatureError( sink.get(), parameters, QStringLiteral( "OUTPUT" ) ) );
           }
-          else
-          {
-            attr.append( QVariant() ); //distance
-            attr.append( QVariant() ); //start x
-            attr.append( QVariant() ); //start y
-            attr.append( QVariant() ); //end x
-            attr.append( QVariant() ); //end y
-          }
-          out.setAttributes( attr );
-          if ( !sink->addFeature( out, QgsFeatureSink::FastInsert ) )
-            throw QgsProcessingException( writeFeatureError( sink.get(), parameters, QStringLiteral( "OUTPUT" ) ) );
         }
-      }
-      if ( j > 0 )
         joinedCount++;
+      }
       else
       {
         if ( sinkNonMatching1 )
         {
-          if ( !sinkNonMatching1->addFeature( f, QgsFeatureSink::FastInsert ) )
+          if ( !sinkNonMatching1->addFeature( inputFeature, QgsFeatureSink::FastInsert ) )
             throw QgsProcessingException( writeFeatureError( sinkNonMatching1.get(), parameters, QStringLiteral( "NON_MATCHING" ) ) );
         }
         if ( !discardNonMatching && sink )
         {
-          QgsAttributes attr = f.attributes();
+          QgsAttributes attr = inputFeature.attributes();
           attr.append( nullMatch );
-          f.setAttributes( attr );
-          if ( !sink->addFeature( f, QgsFeatureSink::FastInsert ) )
+          inputFeature.setAttributes( attr );
+          if ( !sink->addFeature( inputFeature, QgsFeatureSink::FastInsert ) )
             throw QgsProcessingException( writeFeatureError( sink.get(), parameters, QStringLiteral( "OUTPUT" ) ) );
         }
         unjoinedCount++;
@@ -17,11 +17,33 @@
 
 #include "qgsalgorithmkmeansclustering.h"
 #include <unordered_map>
+#include <numeric>
+#include <random>
+#include <QtConcurrentMap>
 
 ///@cond PRIVATE
 
 const int KMEANS_MAX_ITERATIONS = 1000;
 
+//! Number of points of the chunks assigned to the clusters in parallel
+constexpr std::size_t KMEANS_CHUNK_SIZE = 10000;
+
+//! Seed of the random sampling of k-means++ and mini-batches, fixed so that the clusters can be reproduced
+constexpr unsigned int KMEANS_RANDOM_SEED = 5489;
+
+//! Mini-batch clustering converges when no center moves by more than this fraction of the extent of the points
+constexpr double KMEANS_MINIBATCH_TOLERANCE = 1e-6;
+
+//! Returns the offsets of the chunks of \a n points processed in parallel
+static std::vector< std::size_t > chunkOffsets( std::size_t n )
+{
+  std::vector< std::size_t > offsets;
+  offsets.reserve( n / KMEANS_CHUNK_SIZE + 1 );
+  for ( std::size_t offset = 0; offset < n; offset += KMEANS_CHUNK_SIZE )
+    offsets.push_back( offset );
+  return offsets;
+}
+
 QString QgsKMeansClusteringAlgorithm::name() const
 {
   return QStringLiteral( "kmeansclustering" );
@@ -63,13 +85,25 @@ void QgsKMeansClusteringAlgorithm::initAlgorithm( const QVariantMap & )
   sizeFieldNameParam->setFlags( sizeFieldNameParam->flags() | QgsProcessingParameterDefinition::FlagAdvanced );
   addParameter( sizeFieldNameParam.release() );
 
+  auto initMethodParam = std::make_unique<QgsProcessingParameterEnum>( QStringLiteral( "INIT_METHOD" ), QObject::tr( "Initialization method" ),
+                         QStringList() << QObject::tr( "Farthest points" ) << QObject::tr( "K-means++" ), false, 0 );
+  initMethodParam->setFlags( initMethodParam->flags() | QgsProcessingParameterDefinition::FlagAdvanced );
+  addParameter( initMethodParam.release() );
+  auto batchSizeParam = std::make_unique<QgsProcessingParameterNumber>( QStringLiteral( "BATCH_SIZE" ), QObject::tr( "Mini-batch size (0 to use all points)" ),
+                        QgsProcessingParameterNumber::Integer, 0, false, 0 );
+  batchSizeParam->setFlags( batchSizeParam->flags() | QgsProcessingParameterDefinition::FlagAdvanced );
+  addParameter( batchSizeParam.release() );
+
   addParameter( new QgsProcessingParameterFeatureSink( QStringLiteral( "OUTPUT" ), QObject::tr( "Clusters" ), QgsProcessing::TypeVectorAnyGeometry ) );
 }
 
 QString QgsKMeansClusteringAlgorithm::shortHelpString() const
 {
   return QObject::tr( "Calculates the 2D distance based k-means cluster number for each input feature.\n\n"
-                      "If input geometries are lines or polygons, the clustering is based on the centroid of the feature." );
+                      "If input geometries are lines or polygons, the clustering is based on the centroid of the feature.\n\n"
+                      "The initial cluster centers are either the points farthest from each other, or points picked at random by the k-means++ method. "
+                      "If a mini-batch size is set, the cluster centers are computed from random samples of that many points instead of all the points at "
+                      "each iteration, which is much faster for large layers at the cost of slightly less accurate clusters." );
 }
 
 QgsKMeansClusteringAlgorithm *QgsKMeansClusteringAlgorithm::createInstance() const
@@ -84,6 +118,8 @@ QVariantMap QgsKMeansClusteringAlgorithm::processAlgorithm( const QVariantMap &p
     throw QgsProcessingException( invalidSourceError( parameters, QStringLiteral( "INPUT" ) ) );
 
   int k = parameterAsInt( parameters, QStringLiteral( "CLUSTERS" ), context );
+  const int initMethod = parameterAsEnum( parameters, QStringLiteral( "INIT_METHOD" ), context );
+  const int batchSize = parameterAsInt( parameters, QStringLiteral( "BATCH_SIZE" ), context );
 
   QgsFields outputFields = source->fields();
   QgsFields newFields;
@@ -153,8 +189,15 @@ QVariantMap QgsKMeansClusteringAlgorithm::processAlgorithm( const QVariantMap &p
     // cluster centers
     std::vector< QgsPointXY > centers( k );
 
-    initClusters( clusterFeatures, centers, k, feedback );
-    calculateKMeans( clusterFeatures, centers, k, feedback );
+    if ( initMethod == 1 )
+      initClustersPlusPlus( clusterFeatures, centers, k, feedback );
+    else
+      initClusters( clusterFeatures, centers, k, feedback );
+
+    if ( batchSize > 0 )
+      calculateMiniBatchKMeans( clusterFeatures, centers, k, static_cast< std::size_t >( batchSize ), feedback );
+    else
+      calculateKMeans( clusterFeatures, centers, k, feedback );
   }
 
   // cluster size
@@ -300,6 +343,57 @@ void QgsKMeansClusteringAlgorithm::initClusters( std::vector<Feature> &points, s
   }
 }
 
+void QgsKMeansClusteringAlgorithm::initClustersPlusPlus( std::vector<Feature> &points, std::vector<QgsPointXY> &centers, const int k, QgsProcessingFeedback *feedback )
+{
+  const std::size_t n = points.size();
+  if ( n == 0 )
+    return;
+
+  std::mt19937 generator( KMEANS_RANDOM_SEED );
+  centers[0] = points[ std::uniform_int_distribution< std::size_t >( 0, n - 1 )( generator ) ].point;
+
+  // array of minimum distance to a point from accepted cluster centers
+  std::vector< double > distances( n, std::numeric_limits< double >::max() );
+  std::vector< std::size_t > offsets = chunkOffsets( n );
+  bool duplicates = false;
+  for ( int i = 1; i < k; i++ )
+  {
+    // update minimal distance with previously accepted cluster, in parallel
+    const QgsPointXY &center = centers[i - 1];
+    QtConcurrent::blockingMap( offsets, [&points, &distances, &center, n]( const std::size_t & offset )
+    {
+      const std::size_t end = std::min( n, offset + KMEANS_CHUNK_SIZE );
+      for ( std::size_t j = offset; j < end; j++ )
+        distances[j] = std::min( points[j].point.sqrDist( center ), distances[j] );
+    } );
+
+    // pick a point with a probability proportional to its squared distance from the accepted clusters
+    const double totalDistance = std::accumulate( distances.begin(), distances.end(), 0.0 );
+    std::size_t candidateCenter = 0;
+    if ( totalDistance > 0 )
+    {
+      double target = std::uniform_real_distribution< double >( 0, totalDistance )( generator );
+      for ( ; candidateCenter < n - 1; candidateCenter++ )
+      {
+        target -= distances[candidateCenter];
+        if ( target < 0 )
+          break;
+      }
+    }
+    else
+    {
+      // all remaining points are duplicates of the accepted clusters
+      duplicates = true;
+    }
+    centers[i] = points[candidateCenter].point;
+  }
+
+  if ( feedback && duplicates )
+  {
+    feedback->pushInfo( QObject::tr( "There are duplicate inputs, the number of output clusters may be less than was requested" ) );
+  }
+}
+
 // ported from https://github.com/postgis/postgis/blob/svn-trunk/liblwgeom/lwkmeans.c
 
 void QgsKMeansClusteringAlgorithm::calculateKMeans( std::vector<QgsKMeansClusteringAlgorithm::Feature> &objs, std::vector<QgsPointXY> &centers, int k, QgsProcessingFeedback *feedback )
@@ -327,61 +421,157 @@ void QgsKMeansClusteringAlgorithm::calculateKMeans( std::vector<QgsKMeansCluster
     feedback->pushInfo( QObject::tr( "Clustering converged after %n iteration(s)", nullptr, i ) );
 }
 
+void QgsKMeansClusteringAlgorithm::calculateMiniBatchKMeans( std::vector<QgsKMeansClusteringAlgorithm::Feature> &objs, std::vector<QgsPointXY> &centers, int k, std::size_t batchSize, QgsProcessingFeedback *feedback )
+{
+  const std::size_t n = objs.size();
+  if ( batchSize >= n )
+  {
+    // the batches would contain all the points
+    calculateKMeans( objs, centers, k, feedback );
+    return;
+  }
+
+  double xMin = std::numeric_limits< double >::max();
+  double yMin = std::numeric_limits< double >::max();
+  double xMax = std::numeric_limits< double >::lowest();
+  double yMax = std::numeric_limits< double >::lowest();
+  for ( const Feature &obj : objs )
+  {
+    xMin = std::min( xMin, obj.point.x() );
+    yMin = std::min( yMin, obj.point.y() );
+    xMax = std::max( xMax, obj.point.x() );
+    yMax = std::max( yMax, obj.point.y() );
+  }
+  const double tolerance = KMEANS_MINIBATCH_TOLERANCE * std::sqrt( ( xMax - xMin ) * ( xMax - xMin ) + ( yMax - yMin ) * ( yMax - yMin ) );
+
+  std::mt19937 generator( KMEANS_RANDOM_SEED );
+  std::uniform_int_distribution< std::size_t > distribution( 0, n - 1 );
+
+  // number of points assigned to each cluster over all the batches
+  std::vector< uint > counts( k, 0 );
+  std::vector< Feature > batch;
+  batch.reserve( batchSize );
+  std::vector< QgsPointXY > previousCenters;
+
+  bool converged = false;
+  uint i = 0;
+  for ( i = 0; i < KMEANS_MAX_ITERATIONS && !converged; i++ )
+  {
+    if ( feedback && feedback->isCanceled() )
+      break;
+
+    batch.clear();
+    for ( std::size_t j = 0; j < batchSize; j++ )
+      batch.emplace_back( Feature( objs[ distribution( generator ) ].point ) );
+
+    bool changed = false;
+    findNearest( batch, centers, k, changed );
+
+    // move the centers towards their points, less and less as they get more points
+    previousCenters = centers;
+    for ( const Feature &obj : batch )
+    {
+      QgsPointXY &center = centers[obj.cluster];
+      const double rate = 1.0 / ++counts[obj.cluster];
+      center.set( center.x() + rate * ( obj.point.x() - center.x() ),
+                  center.y() + rate * ( obj.point.y() - center.y() ) );
+    }
+
+    double maxMove = 0;
+    for ( int cluster = 0; cluster < k; cluster++ )
+      maxMove = std::max( maxMove, centers[cluster].distance( previousCenters[cluster] ) );
+    converged = maxMove <= tolerance;
+  }
+
+  if ( !converged && feedback )
+    feedback->reportError( QObject::tr( "Clustering did not converge after %n iteration(s)", nullptr, i ) );
+  else if ( feedback )
+    feedback->pushInfo( QObject::tr( "Clustering converged after %n iteration(s)", nullptr, i ) );
+
+  // assign all the points to the final clusters
+  bool changed = false;
+  findNearest( objs, centers, k, changed );
+}
+
 // ported from https://github.com/postgis/postgis/blob/svn-trunk/liblwgeom/lwkmeans.c
 
 void QgsKMeansClusteringAlgorithm::findNearest( std::vector<QgsKMeansClusteringAlgorithm::Feature> &points, const std::vector<QgsPointXY> &centers, const int k, bool &changed )
 {
-  changed = false;
   const std::size_t n = points.size();
-  for ( std::size_t i = 0; i < n; i++ )
+  std::vector< std::size_t > offsets = chunkOffsets( n );
+
+  // the chunks of points are assigned in parallel, each one recording whether its assignments changed
+  std::vector< char > chunkChanged( offsets.size(), false );
+  QtConcurrent::blockingMap( offsets, [&points, &centers, &chunkChanged, k, n]( const std::size_t & offset )
   {
-    Feature &point = points[i];
+    const std::size_t end = std::min( n, offset + KMEANS_CHUNK_SIZE );
+    for ( std::size_t i = offset; i < end; i++ )
+    {
+      Feature &point = points[i];
 
-    // Initialize with distance to first cluster
-    double currentDistance = point.point.sqrDist( centers[0] );
-    int currentCluster = 0;
+      // Initialize with distance to first cluster
+      double currentDistance = point.point.sqrDist( centers[0] );
+      int currentCluster = 0;
 
-    // Check all other cluster centers and find the nearest
-    for ( int cluster = 1; cluster < k; cluster++ )
-    {
-      const double distance = point.point.sqrDist( centers[cluster] );
-      if ( distance < currentDistance )
+      // Check all other cluster centers and find the nearest
+      for ( int cluster = 1; cluster < k; cluster++ )
       {
-        currentDistance = distance;
-        currentCluster = cluster;
+        const double distance = point.point.sqrDist( centers[cluster] );
+        if ( distance < currentDistance )
+        {
+          currentDistance = distance;
+          currentCluster = cluster;
+        }
       }
-    }
 
-    // Store the nearest cluster this object is in
-    if ( point.cluster != currentCluster )
-    {
-      changed = true;
-      point.cluster = currentCluster;
+      // Store the nearest cluster this object is in
+      if ( point.cluster != currentCluster )
+      {
+        chunkChanged[ offset / KMEANS_CHUNK_SIZE ] = true;
+        point.cluster = currentCluster;
+      }
     }
-  }
+  } );
+
+  changed = std::find( chunkChanged.begin(), chunkChanged.end(), true ) != chunkChanged.end();
 }
 
 // ported from https://github.com/postgis/postgis/blob/svn-trunk/liblwgeom/lwkmeans.c
 
 void QgsKMeansClusteringAlgorithm::updateMeans( const std::vector<Feature> &points, std::vector<QgsPointXY> &centers, std::vector<uint> &weights, const int k )
 {
-  const uint n = points.size();
-  std::fill( weights.begin(), weights.end(), 0 );
-  for ( int i = 0; i < k; i++ )
-  {
-    centers[i].setX( 0.0 );
-    centers[i].setY( 0.0 );
-  }
-  for ( uint i = 0; i < n; i++ )
+  const std::size_t n = points.size();
+  std::vector< std::size_t > offsets = chunkOffsets( n );
+
+  // the chunks of points are summed in parallel, then the sums of the chunks are added in order
+  std::vector< double > chunkSumX( offsets.size() * k, 0.0 );
+  std::vector< double > chunkSumY( offsets.size() * k, 0.0 );
+  std::vector< uint > chunkWeights( offsets.size() * k, 0 );
+  QtConcurrent::blockingMap( offsets, [&points, &chunkSumX, &chunkSumY, &chunkWeights, k, n]( const std::size_t & offset )
   {
-    const int cluster = points[i].cluster;
-    centers[cluster] += QgsVector( points[i].point.x(),
-                                   points[i].point.y() );
-    weights[cluster] += 1;
-  }
+    const std::size_t base = offset / KMEANS_CHUNK_SIZE * k;
+    const std::size_t end = std::min( n, offset + KMEANS_CHUNK_SIZE );
+    for ( std::size_t i = offset; i < end; i++ )
+    {
+      const int cluster = points[i].cluster;
+      chunkSumX[ base + cluster ] += points[i].point.x();
+      chunkSumY[ base + cluster ] += points[i].point.y();
+      chunkWeights[ base + cluster ] += 1;
+    }
+  } );
+
+  std::fill( weights.begin(), weights.end(), 0 );
   for ( int i = 0; i < k; i++ )
   {
-    centers[i] /= weights[i];
+    double sumX = 0.0;
+    double sumY = 0.0;
+    for ( std::size_t chunk = 0; chunk < offsets.size(); chunk++ )
+    {
+      sumX += chunkSumX[ chunk * k + i ];
+      sumY += chunkSumY[ chunk * k + i ];
+      weights[i] += chunkWeights[ chunk * k + i ];
+    }
+    centers[i].set( sumX / weights[i], sumY / weights[i] );
   }
 }
 
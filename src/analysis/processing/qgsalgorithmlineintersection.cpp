@@ -17,6 +17,7 @@
 
 #include "qgsalgorithmlineintersection.h"
 #include "qgsgeometryengine.h"
+#include "qgsspatialindexpackedrtree.h"
 
 ///@cond PRIVATE
 
@@ -107,7 +108,8 @@ QVariantMap QgsLineIntersectionAlgorithm::processAlgorithm( const QVariantMap &p
   if ( !sink )
     throw QgsProcessingException( invalidSinkError( parameters, QStringLiteral( "OUTPUT" ) ) );
 
-  QgsSpatialIndex spatialIndex( sourceB->getFeatures( QgsFeatureRequest().setNoAttributes().setDestinationCrs( sourceA->sourceCrs(), context.transformContext() ) ), feedback );
+  QgsFeatureIterator linesIt = sourceB->getFeatures( QgsFeatureRequest().setNoAttributes().setDestinationCrs( sourceA->sourceCrs(), context.transformContext() ) );
+  const QgsSpatialIndexPackedRTree spatialIndex( linesIt, feedback );
   QgsFeature outFeature;
   QgsFeatureIterator features = sourceA->getFeatures( QgsFeatureRequest().setSubsetOfAttributes( fieldIndicesA ) );
   double step = sourceA->featureCount() > 0 ? 100.0 / sourceA->featureCount() : 1;
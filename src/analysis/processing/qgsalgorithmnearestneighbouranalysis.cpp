@@ -18,10 +18,17 @@
 #include "qgsalgorithmnearestneighbouranalysis.h"
 #include "qgsapplication.h"
 #include "qgsdistancearea.h"
+#include "qgsnearestneighborindex.h"
 #include <QTextStream>
+#include <QtConcurrentMap>
+
+#include <functional>
 
 ///@cond PRIVATE
 
+//! Number of features whose nearest neighbors are measured in parallel between progress reports
+constexpr int NEAREST_NEIGHBOUR_BATCH_SIZE = 1000;
+
 QString QgsNearestNeighbourAnalysisAlgorithm::name() const
 {
   return QStringLiteral( "nearestneighbouranalysis" );
@@ -89,32 +96,56 @@ QVariantMap QgsNearestNeighbourAnalysisAlgorithm::processAlgorithm( const QVaria
 
   const QString outputFile = parameterAsFileOutput( parameters, QStringLiteral( "OUTPUT_HTML_FILE" ), context );
 
-  const QgsSpatialIndex spatialIndex( *source, feedback, QgsSpatialIndex::FlagStoreFeatureGeometries );
+  QgsNearestNeighborIndex spatialIndex;
+  QgsFeatureIterator it = source->getFeatures( QgsFeatureRequest().setNoAttributes() );
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+  {
+    if ( feedback->isCanceled() )
+      return QVariantMap();
+    spatialIndex.addFeature( f.id(), f.geometry() );
+  }
+  spatialIndex.build();
+
   QgsDistanceArea da;
   da.setSourceCrs( source->sourceCrs(), context.transformContext() );
   da.setEllipsoid( context.ellipsoid() );
 
   const double step = source->featureCount() ? 100.0 / source->featureCount() : 1;
-  QgsFeatureIterator it = source->getFeatures( QgsFeatureRequest().setSubsetOfAttributes( QList< int >() ) );
+  it = source->getFeatures( QgsFeatureRequest().setSubsetOfAttributes( QList< int >() ) );
 
-  const QgsFeatureRequest request;
-  const QgsFeature neighbour;
   double sumDist = 0.0;
   const double area = source->sourceExtent().width() * source->sourceExtent().height();
 
+  // the distances to the nearest neighbors are measured in parallel, for batches of features
+  const std::function< double( const QgsFeature & ) > nearestDistance = [&spatialIndex, &da]( const QgsFeature & feature ) -> double
+  {
+    const QList< QgsNearestNeighborIndex::Neighbor > nearest = spatialIndex.nearestNeighbors( feature.geometry(), 1, 0, feature.id() );
+    if ( nearest.isEmpty() )
+      return 0;
+    return da.measureLine( spatialIndex.geometry( nearest.at( 0 ).index ).asPoint(), feature.geometry().asPoint() );
+  };
+
   int i = 0;
-  QgsFeature f;
-  while ( it.nextFeature( f ) )
+  QgsFeatureList batch;
+  bool finished = false;
+  while ( !finished )
   {
     if ( feedback->isCanceled() )
     {
       break;
     }
 
-    const QgsFeatureId neighbourId = spatialIndex.nearestNeighbor( f.geometry().asPoint(), 2 ).at( 1 );
-    sumDist += da.measureLine( spatialIndex.geometry( neighbourId ).asPoint(), f.geometry().asPoint() );
+    batch.clear();
+    while ( batch.size() < NEAREST_NEIGHBOUR_BATCH_SIZE && it.nextFeature( f ) )
+      batch << f;
+    finished = batch.size() < NEAREST_NEIGHBOUR_BATCH_SIZE;
+
+    const QList< double > distances = QtConcurrent::blockingMapped< QList< double > >( batch, nearestDistance );
+    for ( const double distance : distances )
+      sumDist += distance;
 
-    i++;
+    i += batch.size();
     feedback->setProgress( i * step );
   }
 
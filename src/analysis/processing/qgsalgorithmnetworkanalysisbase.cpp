@@ -135,7 +135,7 @@ void QgsNetworkAnalysisAlgorithmBase::loadCommonParams( const QVariantMap &param
   mBuilder = std::make_unique< QgsGraphBuilder >( mNetwork->sourceCrs(), true, tolerance );
 }
 
-void QgsNetworkAnalysisAlgorithmBase::loadPoints( QgsFeatureSource *source, QVector< QgsPointXY > &points, QHash< int, QgsAttributes > &attributes, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+void QgsNetworkAnalysisAlgorithmBase::loadPoints( QgsFeatureSource *source, QVector< QgsPointXY > &points, QHash< int, QgsAttributes > &attributes, QgsProcessingContext &context, QgsProcessingFeedback *feedback, QVector< int > *featureNumbers )
 {
   feedback->pushInfo( QObject::tr( "Loading points…" ) );
 
@@ -163,6 +163,8 @@ void QgsNetworkAnalysisAlgorithmBase::loadPoints( QgsFeatureSource *source, QVec
     {
       points.push_back( QgsPointXY( *it ) );
       attributes.insert( pointId, feat.attributes() );
+      if ( featureNumbers )
+        featureNumbers->push_back( i );
       it++;
       pointId++;
     }
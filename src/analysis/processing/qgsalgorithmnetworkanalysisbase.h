@@ -57,8 +57,11 @@ class QgsNetworkAnalysisAlgorithmBase : public QgsProcessingAlgorithm
 
     /**
      * Loads point from the feature source for further processing.
+     *
+     * Each vertex of the features is loaded as a point. If \a featureNumbers is set, it receives the
+     * number of the feature of each point in the source, starting from 1.
      */
-    void loadPoints( QgsFeatureSource *source, QVector< QgsPointXY > &points, QHash< int, QgsAttributes > &attributes, QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+    void loadPoints( QgsFeatureSource *source, QVector< QgsPointXY > &points, QHash< int, QgsAttributes > &attributes, QgsProcessingContext &context, QgsProcessingFeedback *feedback, QVector< int > *featureNumbers = nullptr );
 
     std::unique_ptr< QgsFeatureSource > mNetwork;
     QgsVectorLayerDirector *mDirector = nullptr;
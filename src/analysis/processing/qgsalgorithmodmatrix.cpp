@@ -0,0 +1,202 @@
+/***************************************************************************
+                         qgsalgorithmodmatrix.cpp
+                         ---------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsalgorithmodmatrix.h"
+
+#include "qgscompactgraph.h"
+#include "qgsgraphanalyzer.h"
+
+#include <QtConcurrentMap>
+
+#include <functional>
+
+///@cond PRIVATE
+
+//! Number of origins searched in parallel before their rows are written to the sink
+static constexpr int ORIGINS_PER_BATCH = 256;
+
+QString QgsOdMatrixAlgorithm::name() const
+{
+  return QStringLiteral( "odmatrix" );
+}
+
+QString QgsOdMatrixAlgorithm::displayName() const
+{
+  return QObject::tr( "Origin-destination cost matrix" );
+}
+
+QStringList QgsOdMatrixAlgorithm::tags() const
+{
+  return QObject::tr( "network,path,shortest,fastest,od,origin,destination,matrix,distance,cost" ).split( ',' );
+}
+
+QString QgsOdMatrixAlgorithm::shortHelpString() const
+{
+  return QObject::tr( "This algorithm computes the costs of the optimal (shortest or fastest) routes from each point of "
+                      "a layer of origins to each point of a layer of destinations.\n\n"
+                      "The network graph is built once, and the routes from the origins are searched in parallel. "
+                      "The output table contains a row for each pair of origin and destination, identified by the values of "
+                      "the chosen ID fields, with an empty cost when the destination cannot be reached from the origin.\n\n"
+                      "Each point of multipoint features is a separate origin or destination, identified by the ID of its feature. "
+                      "Without an ID field, the points are identified by the number of their feature in the layer, starting from 1." );
+}
+
+QgsOdMatrixAlgorithm *QgsOdMatrixAlgorithm::createInstance() const
+{
+  return new QgsOdMatrixAlgorithm();
+}
+
+void QgsOdMatrixAlgorithm::initAlgorithm( const QVariantMap & )
+{
+  addCommonParams();
+  addParameter( new QgsProcessingParameterFeatureSource( QStringLiteral( "START_POINTS" ), QObject::tr( "Vector layer with origin points" ), QList< int >() << QgsProcessing::TypeVectorPoint ) );
+  addParameter( new QgsProcessingParameterField( QStringLiteral( "START_ID_FIELD" ), QObject::tr( "Origin ID field" ), QVariant(), QStringLiteral( "START_POINTS" ), QgsProcessingParameterField::Any, false, true ) );
+  addParameter( new QgsProcessingParameterFeatureSource( QStringLiteral( "END_POINTS" ), QObject::tr( "Vector layer with destination points" ), QList< int >() << QgsProcessing::TypeVectorPoint ) );
+  addParameter( new QgsProcessingParameterField( QStringLiteral( "END_ID_FIELD" ), QObject::tr( "Destination ID field" ), QVariant(), QStringLiteral( "END_POINTS" ), QgsProcessingParameterField::Any, false, true ) );
+
+  addParameter( new QgsProcessingParameterFeatureSink( QStringLiteral( "OUTPUT" ), QObject::tr( "Cost matrix" ), QgsProcessing::TypeVector ) );
+}
+
+QVariantMap QgsOdMatrixAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  loadCommonParams( parameters, context, feedback );
+
+  std::unique_ptr< QgsFeatureSource > startPoints( parameterAsSource( parameters, QStringLiteral( "START_POINTS" ), context ) );
+  if ( !startPoints )
+    throw QgsProcessingException( invalidSourceError( parameters, QStringLiteral( "START_POINTS" ) ) );
+
+  std::unique_ptr< QgsFeatureSource > endPoints( parameterAsSource( parameters, QStringLiteral( "END_POINTS" ), context ) );
+  if ( !endPoints )
+    throw QgsProcessingException( invalidSourceError( parameters, QStringLiteral( "END_POINTS" ) ) );
+
+  const QString startIdFieldName = parameterAsString( parameters, QStringLiteral( "START_ID_FIELD" ), context );
+  const int startIdField = startPoints->fields().lookupField( startIdFieldName );
+  const QString endIdFieldName = parameterAsString( parameters, QStringLiteral( "END_ID_FIELD" ), context );
+  const int endIdField = endPoints->fields().lookupField( endIdFieldName );
+
+  // without an ID field, points are identified by the number of their feature in the layer, starting from 1
+  QgsFields fields;
+  fields.append( startIdField >= 0 ? QgsField( QStringLiteral( "origin_id" ), startPoints->fields().at( startIdField ).type() ) : QgsField( QStringLiteral( "origin_id" ), QVariant::Int ) );
+  fields.append( endIdField >= 0 ? QgsField( QStringLiteral( "destination_id" ), endPoints->fields().at( endIdField ).type() ) : QgsField( QStringLiteral( "destination_id" ), QVariant::Int ) );
+  fields.append( QgsField( QStringLiteral( "cost" ), QVariant::Double ) );
+
+  QString dest;
+  std::unique_ptr< QgsFeatureSink > sink( parameterAsSink( parameters, QStringLiteral( "OUTPUT" ), context, dest, fields, QgsWkbTypes::NoGeometry ) );
+  if ( !sink )
+    throw QgsProcessingException( invalidSinkError( parameters, QStringLiteral( "OUTPUT" ) ) );
+
+  // the points of multipoint features are loaded separately, with the number of their feature
+  QVector< QgsPointXY > startPointsList;
+  QHash< int, QgsAttributes > startAttributes;
+  QVector< int > startFeatureNumbers;
+  loadPoints( startPoints.get(), startPointsList, startAttributes, context, feedback, &startFeatureNumbers );
+
+  QVector< QgsPointXY > endPointsList;
+  QHash< int, QgsAttributes > endAttributes;
+  QVector< int > endFeatureNumbers;
+  loadPoints( endPoints.get(), endPointsList, endAttributes, context, feedback, &endFeatureNumbers );
+
+  const int startCount = startPointsList.size();
+  const int endCount = endPointsList.size();
+
+  // all points are snapped to the network while the graph is built, once for the whole matrix
+  feedback->pushInfo( QObject::tr( "Building graph…" ) );
+  QVector< QgsPointXY > points = startPointsList;
+  points << endPointsList;
+  QVector< QgsPointXY > snappedPoints;
+  mDirector->makeGraph( mBuilder.get(), points, snappedPoints, feedback );
+
+  if ( feedback->isCanceled() )
+    return QVariantMap();
+
+  // the compact graph is shared by the searches without locking, and is much cheaper to search than a QgsGraph
+  std::unique_ptr< QgsGraph > graph( mBuilder->takeGraph() );
+  const QgsCompactGraph compactGraph = QgsCompactGraph::fromGraph( *graph );
+  graph.reset();
+
+  QVector< int > startVertices( startCount );
+  for ( int i = 0; i < startCount; ++i )
+    startVertices[i] = compactGraph.findVertex( snappedPoints.at( i ) );
+  QVector< int > endVertices( endCount );
+  for ( int i = 0; i < endCount; ++i )
+    endVertices[i] = compactGraph.findVertex( snappedPoints.at( startCount + i ) );
+
+  QVector< QVariant > startIds( startCount );
+  for ( int i = 0; i < startCount; ++i )
+    startIds[i] = startIdField >= 0 ? startAttributes.value( i + 1 ).value( startIdField ) : QVariant( startFeatureNumbers.at( i ) );
+  QVector< QVariant > endIds( endCount );
+  for ( int i = 0; i < endCount; ++i )
+    endIds[i] = endIdField >= 0 ? endAttributes.value( i + 1 ).value( endIdField ) : QVariant( endFeatureNumbers.at( i ) );
+
+  feedback->pushInfo( QObject::tr( "Calculating costs…" ) );
+
+  const std::function< QVector< double >( int ) > searchCosts = [&compactGraph, &endVertices, feedback]( int startVertex ) -> QVector< double >
+  {
+    QVector< double > result( endVertices.size(), std::numeric_limits<double>::infinity() );
+    if ( startVertex < 0 || feedback->isCanceled() )
+      return result;
+
+    QVector< double > costs;
+    QgsGraphAnalyzer::dijkstra( &compactGraph, startVertex, 0, nullptr, &costs );
+    if ( costs.isEmpty() )
+      return result;
+
+    for ( int i = 0; i < endVertices.size(); ++i )
+    {
+      if ( endVertices.at( i ) >= 0 )
+        result[i] = costs.at( endVertices.at( i ) );
+    }
+    return result;
+  };
+
+  QgsFeature feat;
+  feat.setFields( fields );
+  const double step = startCount > 0 ? 100.0 / startCount : 1;
+  for ( int batchStart = 0; batchStart < startCount; batchStart += ORIGINS_PER_BATCH )
+  {
+    if ( feedback->isCanceled() )
+      break;
+
+    // rows are written in the order of the origins, one batch at a time to bound the memory use
+    const QVector< int > batchVertices = startVertices.mid( batchStart, ORIGINS_PER_BATCH );
+    const QList< QVector< double > > batchCosts = QtConcurrent::blockingMapped< QList< QVector< double > > >( batchVertices, searchCosts );
+
+    if ( feedback->isCanceled() )
+      break;
+
+    for ( int i = 0; i < batchCosts.size(); ++i )
+    {
+      const int startIdx = batchStart + i;
+      const QVector< double > &rowCosts = batchCosts.at( i );
+      for ( int j = 0; j < endCount; ++j )
+      {
+        const double cost = rowCosts.at( j );
+        feat.setAttributes( QgsAttributes() << startIds.at( startIdx ) << endIds.at( j )
+                            << ( std::isinf( cost ) ? QVariant() : QVariant( cost / mMultiplier ) ) );
+        if ( !sink->addFeature( feat, QgsFeatureSink::FastInsert ) )
+          throw QgsProcessingException( writeFeatureError( sink.get(), parameters, QStringLiteral( "OUTPUT" ) ) );
+      }
+    }
+
+    feedback->setProgress( ( batchStart + batchCosts.size() ) * step );
+  }
+
+  QVariantMap outputs;
+  outputs.insert( QStringLiteral( "OUTPUT" ), dest );
+  return outputs;
+}
+
+///@endcond
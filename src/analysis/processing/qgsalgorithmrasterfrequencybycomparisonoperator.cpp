@@ -20,6 +20,8 @@
 #include "qgsrasterfilewriter.h"
 #include "qgsrasteranalysisutils.h"
 
+#include <numeric>
+
 ///@cond PRIVATE
 
 //
@@ -166,11 +168,18 @@ QVariantMap QgsRasterFrequencyByComparisonOperatorBase::processAlgorithm( const
 
     std::unique_ptr< QgsRasterBlock > outputBlock = std::make_unique<QgsRasterBlock>( Qgis::DataType::Int32, iterCols, iterRows );
     feedback->setProgress( 100 * ( ( iterTop / maxHeight * nbBlocksWidth ) + iterLeft / maxWidth ) / nbBlocks );
-    for ( int row = 0; row < iterRows; row++ )
+    // the rows are processed in parallel, each one counting its own results
+    const std::vector< std::vector< double > > stack = QgsRasterAnalysisUtils::blockStackValues( inputBlocks );
+    std::vector< unsigned long long > rowOccurrenceCounts( iterRows );
+    std::vector< unsigned long long > rowNoDataLocationsCounts( iterRows );
+    QgsRasterBlock *output = outputBlock.get();
+    QgsRasterAnalysisUtils::processRowsInParallel( iterRows, [&]( int row )
     {
       if ( feedback->isCanceled() )
-        break;
+        return;
 
+      std::vector<double> cellValues;
+      cellValues.reserve( stack.size() );
       for ( int col = 0; col < iterCols; col++ )
       {
         bool valueRasterCellIsNoData = false;
@@ -180,28 +189,30 @@ QVariantMap QgsRasterFrequencyByComparisonOperatorBase::processAlgorithm( const
         {
           //output cell will always be NoData if NoData occurs in valueRaster or cellValueStack and NoData is not ignored
           //this saves unnecessary iterations on the cellValueStack
-          outputBlock->setValue( row, col, mNoDataValue );
-          noDataLocationsCount++;
+          output->setValue( row, col, mNoDataValue );
+          rowNoDataLocationsCounts[row]++;
         }
         else
         {
           bool noDataInStack = false;
-          const std::vector<double> cellValues = QgsRasterAnalysisUtils::getCellValuesFromBlockStack( inputBlocks, row, col, noDataInStack );
+          QgsRasterAnalysisUtils::cellValuesFromStack( stack, static_cast< qgssize >( row ) * iterCols + col, cellValues, noDataInStack );
 
           if ( noDataInStack && !mIgnoreNoData )
           {
-            outputBlock->setValue( row, col, mNoDataValue );
-            noDataLocationsCount++;
+            output->setValue( row, col, mNoDataValue );
+            rowNoDataLocationsCounts[row]++;
           }
           else
           {
             const int frequency = applyComparisonOperator( value, cellValues );
-            outputBlock->setValue( row, col, frequency );
-            occurrenceCount += frequency;
+            output->setValue( row, col, frequency );
+            rowOccurrenceCounts[row] += frequency;
           }
         }
       }
-    }
+    } );
+    occurrenceCount += std::accumulate( rowOccurrenceCounts.begin(), rowOccurrenceCounts.end(), 0ULL );
+    noDataLocationsCount += std::accumulate( rowNoDataLocationsCounts.begin(), rowNoDataLocationsCounts.end(), 0ULL );
     provider->writeBlock( outputBlock.get(), 1, iterLeft, iterTop );
   }
   provider->setEditable( false );
@@ -261,7 +272,7 @@ QgsRasterFrequencyByEqualOperatorAlgorithm *QgsRasterFrequencyByEqualOperatorAlg
   return new QgsRasterFrequencyByEqualOperatorAlgorithm();
 }
 
-int QgsRasterFrequencyByEqualOperatorAlgorithm::applyComparisonOperator( double searchValue, std::vector<double> cellValueStack )
+int QgsRasterFrequencyByEqualOperatorAlgorithm::applyComparisonOperator( double searchValue, const std::vector<double> &cellValueStack ) const
 {
   return static_cast<int>( std::count( cellValueStack.begin(), cellValueStack.end(), searchValue ) );
 }
@@ -304,7 +315,7 @@ QgsRasterFrequencyByGreaterThanOperatorAlgorithm *QgsRasterFrequencyByGreaterTha
   return new QgsRasterFrequencyByGreaterThanOperatorAlgorithm();
 }
 
-int QgsRasterFrequencyByGreaterThanOperatorAlgorithm::applyComparisonOperator( double searchValue, std::vector<double> cellValueStack )
+int QgsRasterFrequencyByGreaterThanOperatorAlgorithm::applyComparisonOperator( double searchValue, const std::vector<double> &cellValueStack ) const
 {
   return static_cast<int>( std::count_if( cellValueStack.begin(), cellValueStack.end(), [&]( double const & stackValue ) { return stackValue > searchValue; } ) );
 }
@@ -347,7 +358,7 @@ QgsRasterFrequencyByLessThanOperatorAlgorithm *QgsRasterFrequencyByLessThanOpera
   return new QgsRasterFrequencyByLessThanOperatorAlgorithm();
 }
 
-int QgsRasterFrequencyByLessThanOperatorAlgorithm::applyComparisonOperator( double searchValue, std::vector<double> cellValueStack )
+int QgsRasterFrequencyByLessThanOperatorAlgorithm::applyComparisonOperator( double searchValue, const std::vector<double> &cellValueStack ) const
 {
   return static_cast<int>( std::count_if( cellValueStack.begin(), cellValueStack.end(), [&]( double const & stackValue ) { return stackValue < searchValue; } ) );
 }
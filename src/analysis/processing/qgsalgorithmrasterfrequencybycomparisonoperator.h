@@ -39,7 +39,7 @@ class QgsRasterFrequencyByComparisonOperatorBase : public QgsProcessingAlgorithm
   protected:
     bool prepareAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
     QVariantMap processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
-    virtual int applyComparisonOperator( double value, std::vector<double>cellValueStack ) = 0;
+    virtual int applyComparisonOperator( double value, const std::vector<double> &cellValueStack ) const = 0;
 
   private:
     std::unique_ptr< QgsRasterInterface > mInputValueRasterInterface;
@@ -66,7 +66,7 @@ class QgsRasterFrequencyByEqualOperatorAlgorithm : public QgsRasterFrequencyByCo
     QgsRasterFrequencyByEqualOperatorAlgorithm *createInstance() const override SIP_FACTORY;
 
   protected:
-    int applyComparisonOperator( double searchValue, std::vector<double>cellValueStack ) override;
+    int applyComparisonOperator( double searchValue, const std::vector<double> &cellValueStack ) const override;
 };
 
 class QgsRasterFrequencyByGreaterThanOperatorAlgorithm : public QgsRasterFrequencyByComparisonOperatorBase
@@ -80,7 +80,7 @@ class QgsRasterFrequencyByGreaterThanOperatorAlgorithm : public QgsRasterFrequen
     QgsRasterFrequencyByGreaterThanOperatorAlgorithm *createInstance() const override SIP_FACTORY;
 
   protected:
-    int applyComparisonOperator( double value, std::vector<double>cellValueStack ) override;
+    int applyComparisonOperator( double value, const std::vector<double> &cellValueStack ) const override;
 };
 
 class QgsRasterFrequencyByLessThanOperatorAlgorithm : public QgsRasterFrequencyByComparisonOperatorBase
@@ -94,7 +94,7 @@ class QgsRasterFrequencyByLessThanOperatorAlgorithm : public QgsRasterFrequencyB
     QgsRasterFrequencyByLessThanOperatorAlgorithm *createInstance() const override SIP_FACTORY;
 
   protected:
-    int applyComparisonOperator( double value, std::vector<double>cellValueStack ) override;
+    int applyComparisonOperator( double value, const std::vector<double> &cellValueStack ) const override;
 };
 
 ///@endcond PRIVATE
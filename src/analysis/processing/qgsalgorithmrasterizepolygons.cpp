@@ -0,0 +1,295 @@
+/***************************************************************************
+                         qgsalgorithmrasterizepolygons.cpp
+                         ---------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsalgorithmrasterizepolygons.h"
+#include "qgsrasteranalysisutils.h"
+#include "qgsrasterfilewriter.h"
+#include "qgsprocessingutils.h"
+#include "qgsgdalutils.h"
+#include "gdal.h"
+#include "cpl_string.h"
+
+#include <QtConcurrentMap>
+
+///@cond PRIVATE
+
+//! Size in pixels of the square tiles burned in parallel, also used as the block size of GeoTIFF outputs
+static constexpr int RASTERIZE_TILE_SIZE = 512;
+
+//! Polygon to burn into the tiles of a row
+struct BurnPolygon
+{
+  QgsGeometry geometry;
+  QgsRectangle boundingBox;
+  double value = 0;
+};
+
+//! Tile of a row of the output raster
+struct BurnTile
+{
+  int left = 0;
+  int width = 0;
+  std::unique_ptr< QgsRasterBlock > block;
+};
+
+QString QgsRasterizePolygonsAlgorithm::name() const
+{
+  return QStringLiteral( "rasterizepolygons" );
+}
+
+QString QgsRasterizePolygonsAlgorithm::displayName() const
+{
+  return QObject::tr( "Rasterize polygons" );
+}
+
+QStringList QgsRasterizePolygonsAlgorithm::tags() const
+{
+  return QObject::tr( "rasterize,burn,polygons,vector,raster,convert,cog,cloud optimized" ).split( ',' );
+}
+
+QString QgsRasterizePolygonsAlgorithm::group() const
+{
+  return QObject::tr( "Vector conversion" );
+}
+
+QString QgsRasterizePolygonsAlgorithm::groupId() const
+{
+  return QStringLiteral( "vectorconversion" );
+}
+
+QString QgsRasterizePolygonsAlgorithm::shortDescription() const
+{
+  return QObject::tr( "Burns the values of polygon features into a raster." );
+}
+
+QString QgsRasterizePolygonsAlgorithm::shortHelpString() const
+{
+  return QObject::tr( "This algorithm burns the values of polygon features into a new single band raster layer, "
+                      "in the CRS of the polygon layer.\n\n"
+                      "A pixel is set to the value of a polygon if its center lies inside the polygon. The value is either "
+                      "read from a numeric field of the features, or fixed. Where polygons overlap, the pixels are set to the "
+                      "value of the last polygon. Pixels outside of all polygons are set to the no data value.\n\n"
+                      "The raster is computed by tiles of %1 by %1 pixels in parallel, without rendering the features. "
+                      "Optionally the output can be written as a Cloud Optimized GeoTIFF (requires GDAL 3.1 or later)." ).arg( RASTERIZE_TILE_SIZE );
+}
+
+QgsRasterizePolygonsAlgorithm *QgsRasterizePolygonsAlgorithm::createInstance() const
+{
+  return new QgsRasterizePolygonsAlgorithm();
+}
+
+void QgsRasterizePolygonsAlgorithm::initAlgorithm( const QVariantMap & )
+{
+  addParameter( new QgsProcessingParameterFeatureSource( QStringLiteral( "INPUT" ), QObject::tr( "Input layer" ), QList< int >() << QgsProcessing::TypeVectorPolygon ) );
+  addParameter( new QgsProcessingParameterField( QStringLiteral( "FIELD" ), QObject::tr( "Field to use for burn value" ),
+                QVariant(), QStringLiteral( "INPUT" ), QgsProcessingParameterField::Numeric, false, true ) );
+  addParameter( new QgsProcessingParameterNumber( QStringLiteral( "BURN" ), QObject::tr( "Fixed value to burn" ),
+                QgsProcessingParameterNumber::Double, 1 ) );
+  addParameter( new QgsProcessingParameterDistance( QStringLiteral( "PIXEL_SIZE" ), QObject::tr( "Pixel size" ),
+                1, QStringLiteral( "INPUT" ), false, 0.000001 ) );
+  addParameter( new QgsProcessingParameterExtent( QStringLiteral( "EXTENT" ), QObject::tr( "Output extent" ), QVariant(), true ) );
+  addParameter( new QgsProcessingParameterNumber( QStringLiteral( "NODATA" ), QObject::tr( "No data value" ),
+                QgsProcessingParameterNumber::Double, -9999 ) );
+
+  std::unique_ptr< QgsProcessingParameterDefinition > typeChoice = QgsRasterAnalysisUtils::createRasterTypeParameter( QStringLiteral( "DATA_TYPE" ), QObject::tr( "Output data type" ), Qgis::DataType::Float32 );
+  typeChoice->setFlags( typeChoice->flags() | QgsProcessingParameterDefinition::FlagAdvanced );
+  addParameter( typeChoice.release() );
+
+  std::unique_ptr< QgsProcessingParameterBoolean > cloudOptimizedParam = std::make_unique< QgsProcessingParameterBoolean >( QStringLiteral( "CLOUD_OPTIMIZED" ), QObject::tr( "Write a Cloud Optimized GeoTIFF" ), false );
+  cloudOptimizedParam->setFlags( cloudOptimizedParam->flags() | QgsProcessingParameterDefinition::FlagAdvanced );
+  addParameter( cloudOptimizedParam.release() );
+
+  addParameter( new QgsProcessingParameterRasterDestination( QStringLiteral( "OUTPUT" ), QObject::tr( "Rasterized" ) ) );
+}
+
+QVariantMap QgsRasterizePolygonsAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  std::unique_ptr< QgsProcessingFeatureSource > source( parameterAsSource( parameters, QStringLiteral( "INPUT" ), context ) );
+  if ( !source )
+    throw QgsProcessingException( invalidSourceError( parameters, QStringLiteral( "INPUT" ) ) );
+
+  const QString fieldName = parameterAsString( parameters, QStringLiteral( "FIELD" ), context );
+  const int fieldIndex = fieldName.isEmpty() ? -1 : source->fields().lookupField( fieldName );
+  if ( !fieldName.isEmpty() && fieldIndex < 0 )
+    throw QgsProcessingException( QObject::tr( "Field %1 does not exist" ).arg( fieldName ) );
+
+  const double burnValue = parameterAsDouble( parameters, QStringLiteral( "BURN" ), context );
+  const double pixelSize = parameterAsDouble( parameters, QStringLiteral( "PIXEL_SIZE" ), context );
+  const double noDataValue = parameterAsDouble( parameters, QStringLiteral( "NODATA" ), context );
+  const Qgis::DataType dataType = QgsRasterAnalysisUtils::rasterTypeChoiceToDataType( parameterAsEnum( parameters, QStringLiteral( "DATA_TYPE" ), context ) );
+  const bool cloudOptimized = parameterAsBool( parameters, QStringLiteral( "CLOUD_OPTIMIZED" ), context );
+
+  QgsRectangle extent = parameterAsExtent( parameters, QStringLiteral( "EXTENT" ), context, source->sourceCrs() );
+  if ( extent.isNull() )
+    extent = source->sourceExtent();
+  if ( extent.isEmpty() )
+    throw QgsProcessingException( QObject::tr( "The output extent is empty" ) );
+
+  const int rows = std::max( std::ceil( extent.height() / pixelSize ), 1.0 );
+  const int cols = std::max( std::ceil( extent.width() / pixelSize ), 1.0 );
+
+  //build new raster extent based on number of columns and cellsize
+  //this prevents output cellsize being calculated too small
+  const QgsRectangle rasterExtent = QgsRectangle( extent.xMinimum(), extent.yMaximum() - ( rows * pixelSize ), extent.xMinimum() + ( cols * pixelSize ), extent.yMaximum() );
+
+  const QString outputFile = parameterAsOutputLayer( parameters, QStringLiteral( "OUTPUT" ), context );
+  const QFileInfo fi( outputFile );
+  const QString outputFormat = QgsRasterFileWriter::driverForExtension( fi.suffix() );
+  if ( cloudOptimized && outputFormat != QLatin1String( "GTiff" ) )
+    throw QgsProcessingException( QObject::tr( "Cloud Optimized GeoTIFF outputs must be written to a .tif file" ) );
+
+  // the COG driver only creates copies of existing datasets, so the tiles are first written to a temporary GeoTIFF
+  const QString rasterFile = cloudOptimized ? QgsProcessingUtils::generateTempFilename( QStringLiteral( "rasterized.tif" ) ) : outputFile;
+
+  std::unique_ptr< QgsRasterFileWriter > writer = std::make_unique< QgsRasterFileWriter >( rasterFile );
+  writer->setOutputProviderKey( QStringLiteral( "gdal" ) );
+  writer->setOutputFormat( outputFormat );
+  if ( outputFormat == QLatin1String( "GTiff" ) )
+  {
+    writer->setCreateOptions( QStringList() << QStringLiteral( "TILED=YES" )
+                              << QStringLiteral( "BLOCKXSIZE=%1" ).arg( RASTERIZE_TILE_SIZE )
+                              << QStringLiteral( "BLOCKYSIZE=%1" ).arg( RASTERIZE_TILE_SIZE ) );
+  }
+  std::unique_ptr<QgsRasterDataProvider > provider( writer->createOneBandRaster( dataType, cols, rows, rasterExtent, source->sourceCrs() ) );
+  if ( !provider )
+    throw QgsProcessingException( QObject::tr( "Could not create raster output: %1" ).arg( rasterFile ) );
+  if ( !provider->isValid() )
+    throw QgsProcessingException( QObject::tr( "Could not create raster output %1: %2" ).arg( rasterFile, provider->error().message( QgsErrorMessage::Text ) ) );
+
+  provider->setNoDataValue( 1, noDataValue );
+  provider->setEditable( true );
+
+  const int tileRows = static_cast< int >( std::ceil( rows / static_cast< double >( RASTERIZE_TILE_SIZE ) ) );
+  const int tileColumns = static_cast< int >( std::ceil( cols / static_cast< double >( RASTERIZE_TILE_SIZE ) ) );
+
+  QgsAttributeList attributes;
+  if ( fieldIndex >= 0 )
+    attributes << fieldIndex;
+
+  for ( int tileRow = 0; tileRow < tileRows; ++tileRow )
+  {
+    if ( feedback->isCanceled() )
+      break;
+
+    const int top = tileRow * RASTERIZE_TILE_SIZE;
+    const int height = std::min( RASTERIZE_TILE_SIZE, rows - top );
+    const QgsRectangle rowExtent( rasterExtent.xMinimum(), rasterExtent.yMaximum() - ( top + height ) * pixelSize,
+                                  rasterExtent.xMaximum(), rasterExtent.yMaximum() - top * pixelSize );
+
+    // the polygons of a row of tiles are read once, then burned into its tiles in parallel
+    std::vector< BurnPolygon > polygons;
+    QgsFeatureIterator it = source->getFeatures( QgsFeatureRequest().setFilterRect( rowExtent ).setSubsetOfAttributes( attributes ), QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks );
+    QgsFeature feature;
+    while ( it.nextFeature( feature ) )
+    {
+      if ( feedback->isCanceled() )
+        break;
+      if ( !feature.hasGeometry() )
+        continue;
+
+      double value = burnValue;
+      if ( fieldIndex >= 0 )
+      {
+        const QVariant attribute = feature.attribute( fieldIndex );
+        bool ok = false;
+        value = attribute.toDouble( &ok );
+        if ( attribute.isNull() || !ok )
+          continue;
+      }
+
+      BurnPolygon polygon;
+      polygon.geometry = feature.geometry();
+      polygon.boundingBox = polygon.geometry.boundingBox();
+      polygon.value = value;
+      polygons.emplace_back( std::move( polygon ) );
+    }
+
+    std::vector< BurnTile > tiles( tileColumns );
+    for ( int tileColumn = 0; tileColumn < tileColumns; ++tileColumn )
+    {
+      BurnTile &tile = tiles[ tileColumn ];
+      tile.left = tileColumn * RASTERIZE_TILE_SIZE;
+      tile.width = std::min( RASTERIZE_TILE_SIZE, cols - tile.left );
+      tile.block = std::make_unique< QgsRasterBlock >( dataType, tile.width, height );
+    }
+
+    const std::function< void( BurnTile & ) > burnTile = [ &polygons, &rasterExtent, &rowExtent, pixelSize, height, noDataValue, feedback ]( BurnTile & tile )
+    {
+      tile.block->setNoDataValue( noDataValue );
+      tile.block->setIsNoData();
+
+      const QgsRectangle tileExtent( rasterExtent.xMinimum() + tile.left * pixelSize, rowExtent.yMinimum(),
+                                     rasterExtent.xMinimum() + ( tile.left + tile.width ) * pixelSize, rowExtent.yMaximum() );
+      for ( const BurnPolygon &polygon : polygons )
+      {
+        if ( feedback->isCanceled() )
+          return;
+        if ( !polygon.boundingBox.intersects( tileExtent ) )
+          continue;
+
+        const QVector< QVector< int > > spans = QgsRasterAnalysisUtils::pixelCenterSpans( polygon.geometry, tile.width, height, pixelSize, pixelSize, tileExtent );
+        for ( int row = 0; row < height; ++row )
+        {
+          const QVector< int > &rowSpans = spans.at( row );
+          for ( int i = 0; i + 1 < rowSpans.size(); i += 2 )
+          {
+            for ( int col = rowSpans.at( i ); col < rowSpans.at( i + 1 ); ++col )
+              tile.block->setValue( row, col, polygon.value );
+          }
+        }
+      }
+    };
+    QtConcurrent::blockingMap( tiles, burnTile );
+
+    if ( feedback->isCanceled() )
+      break;
+
+    for ( const BurnTile &tile : tiles )
+    {
+      if ( !provider->writeBlock( tile.block.get(), 1, tile.left, top ) )
+        throw QgsProcessingException( QObject::tr( "Could not write raster block: %1" ).arg( provider->error().summary() ) );
+    }
+    feedback->setProgress( 100.0 * ( tileRow + 1 ) / tileRows );
+  }
+  provider->setEditable( false );
+  provider.reset();
+
+  if ( cloudOptimized && !feedback->isCanceled() )
+  {
+    feedback->pushInfo( QObject::tr( "Writing Cloud Optimized GeoTIFF" ) );
+    GDALDriverH cogDriver = GDALGetDriverByName( "COG" );
+    if ( !cogDriver )
+      throw QgsProcessingException( QObject::tr( "The GDAL COG driver is not available" ) );
+
+    const gdal::dataset_unique_ptr tiledDataset( GDALOpen( rasterFile.toUtf8().constData(), GA_ReadOnly ) );
+    if ( !tiledDataset )
+      throw QgsProcessingException( QObject::tr( "Could not open the temporary raster %1" ).arg( rasterFile ) );
+
+    char **options = nullptr;
+    options = CSLSetNameValue( options, "BLOCKSIZE", QString::number( RASTERIZE_TILE_SIZE ).toUtf8().constData() );
+    options = CSLSetNameValue( options, "NUM_THREADS", "ALL_CPUS" );
+    const gdal::dataset_unique_ptr cogDataset( GDALCreateCopy( cogDriver, outputFile.toUtf8().constData(), tiledDataset.get(), FALSE, options, nullptr, nullptr ) );
+    CSLDestroy( options );
+    if ( !cogDataset )
+      throw QgsProcessingException( QObject::tr( "Could not create raster output %1: %2" ).arg( outputFile, QString::fromUtf8( CPLGetLastErrorMsg() ) ) );
+  }
+
+  QVariantMap outputs;
+  outputs.insert( QStringLiteral( "OUTPUT" ), outputFile );
+  return outputs;
+}
+
+///@endcond
@@ -0,0 +1,54 @@
+/***************************************************************************
+                         qgsalgorithmrasterizepolygons.h
+                         ---------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSALGORITHMRASTERIZEPOLYGONS_H
+#define QGSALGORITHMRASTERIZEPOLYGONS_H
+
+#define SIP_NO_FILE
+
+#include "qgis_sip.h"
+#include "qgsprocessingalgorithm.h"
+
+///@cond PRIVATE
+
+/**
+ * Native rasterize polygons algorithm, burning values of polygon features into a raster.
+ */
+class QgsRasterizePolygonsAlgorithm : public QgsProcessingAlgorithm
+{
+  public:
+
+    QgsRasterizePolygonsAlgorithm() = default;
+    void initAlgorithm( const QVariantMap &configuration = QVariantMap() ) override;
+    QString name() const override;
+    QString displayName() const override;
+    QStringList tags() const override;
+    QString group() const override;
+    QString groupId() const override;
+    QString shortHelpString() const override;
+    QString shortDescription() const override;
+    QgsRasterizePolygonsAlgorithm *createInstance() const override SIP_FACTORY;
+
+  protected:
+
+    QVariantMap processAlgorithm( const QVariantMap &parameters,
+                                  QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
+
+};
+
+///@endcond PRIVATE
+
+#endif // QGSALGORITHMRASTERIZEPOLYGONS_H
@@ -20,6 +20,9 @@
 
 ///@cond PRIVATE
 
+//! Number of features whose points are sampled together
+static constexpr int SAMPLE_BATCH_SIZE = 10000;
+
 QString QgsRasterSamplingAlgorithm::name() const
 {
   return QStringLiteral( "rastersampling" );
@@ -116,6 +119,39 @@ QVariantMap QgsRasterSamplingAlgorithm::processAlgorithm( const QVariantMap &par
   const QgsCoordinateTransform ct( source->sourceCrs(), mCrs, context.transformContext() );
   QgsFeatureIterator it = source->getFeatures( QgsFeatureRequest() );
   QgsFeature feature;
+
+  // the features are sampled in batches, so that the raster blocks are read once for all the points they contain
+  QgsFeatureList batchFeatures;
+  QVector< QgsPointXY > batchPoints;
+  QVector< int > batchPointFeatures;
+  auto flushBatch = [&]
+  {
+    QVector< QVector< double > > bandValues;
+    for ( int band = 1; band <= mBandCount; band ++ )
+    {
+      bandValues << mDataProvider->samplePoints( batchPoints, band );
+    }
+
+    for ( int i = 0; i < batchPoints.size(); ++i )
+    {
+      QgsFeature &outputFeature = batchFeatures[ batchPointFeatures.at( i ) ];
+      QgsAttributes attributes = outputFeature.attributes();
+      for ( int band = 1; band <= mBandCount; band ++ )
+      {
+        const double value = bandValues.at( band - 1 ).at( i );
+        attributes += std::isnan( value ) ? QVariant() : value;
+      }
+      outputFeature.setAttributes( attributes );
+    }
+
+    if ( !sink->addFeatures( batchFeatures, QgsFeatureSink::FastInsert ) )
+      throw QgsProcessingException( writeFeatureError( sink.get(), parameters, QStringLiteral( "OUTPUT" ) ) );
+
+    batchFeatures.clear();
+    batchPoints.clear();
+    batchPointFeatures.clear();
+  };
+
   while ( it.nextFeature( feature ) )
   {
     if ( feedback->isCanceled() )
@@ -131,7 +167,7 @@ QVariantMap QgsRasterSamplingAlgorithm::processAlgorithm( const QVariantMap &par
     {
       attributes += emptySampleAttributes;
       outputFeature.setAttributes( attributes );
-      sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
+      batchFeatures << outputFeature;
       feedback->reportError( QObject::tr( "No geometry attached to feature %1." ).arg( feature.id() ) );
       continue;
     }
@@ -141,8 +177,7 @@ QVariantMap QgsRasterSamplingAlgorithm::processAlgorithm( const QVariantMap &par
     {
       attributes += emptySampleAttributes;
       outputFeature.setAttributes( attributes );
-      if ( !sink->addFeature( outputFeature, QgsFeatureSink::FastInsert ) )
-        throw QgsProcessingException( writeFeatureError( sink.get(), parameters, QStringLiteral( "OUTPUT" ) ) );
+      batchFeatures << outputFeature;
       feedback->reportError( QObject::tr( "Impossible to sample data of multipart feature %1." ).arg( feature.id() ) );
       continue;
     }
@@ -156,22 +191,19 @@ QVariantMap QgsRasterSamplingAlgorithm::processAlgorithm( const QVariantMap &par
     {
       attributes += emptySampleAttributes;
       outputFeature.setAttributes( attributes );
-      if ( !sink->addFeature( outputFeature, QgsFeatureSink::FastInsert ) )
-        throw QgsProcessingException( writeFeatureError( sink.get(), parameters, QStringLiteral( "OUTPUT" ) ) );
+      batchFeatures << outputFeature;
       feedback->reportError( QObject::tr( "Could not reproject feature %1 to raster CRS." ).arg( feature.id() ) );
       continue;
     }
 
-    for ( int band = 1; band <= mBandCount; band ++ )
-    {
-      bool ok = false;
-      const double value = mDataProvider->sample( point, band, &ok );
-      attributes += ok ? value : QVariant();
-    }
-    outputFeature.setAttributes( attributes );
-    if ( !sink->addFeature( outputFeature, QgsFeatureSink::FastInsert ) )
-      throw QgsProcessingException( writeFeatureError( sink.get(), parameters, QStringLiteral( "OUTPUT" ) ) );
+    batchPointFeatures << batchFeatures.size();
+    batchPoints << point;
+    batchFeatures << outputFeature;
+    if ( batchFeatures.size() >= SAMPLE_BATCH_SIZE )
+      flushBatch();
   }
+  if ( !batchFeatures.isEmpty() && !feedback->isCanceled() )
+    flushBatch();
 
   QVariantMap outputs;
   outputs.insert( QStringLiteral( "OUTPUT" ), dest );
@@ -156,10 +156,11 @@ QVariantMap QgsRasterStackPositionAlgorithmBase::processAlgorithm( const QVarian
     }
 
     feedback->setProgress( 100 * ( ( iterTop / maxHeight * nbBlocksWidth ) + iterLeft / maxWidth ) / nbBlocks );
-    for ( int row = 0; row < iterRows; row++ )
+    QgsRasterBlock *output = outputBlock.get();
+    QgsRasterAnalysisUtils::processRowsInParallel( iterRows, [&]( int row )
     {
       if ( feedback->isCanceled() )
-        break;
+        return;
 
       for ( int col = 0; col < iterCols; col++ )
       {
@@ -174,19 +175,19 @@ QVariantMap QgsRasterStackPositionAlgorithmBase::processAlgorithm( const QVarian
             //output cell will always be NoData if NoData occurs the current raster cell
             //of the input blocks and NoData is not ignored
             //this saves unnecessary iterations on the cellValueStack
-            outputBlock->setValue( row, col, mNoDataValue );
+            output->setValue( row, col, mNoDataValue );
           }
           else
           {
-            outputBlock->setValue( row, col, position );
+            output->setValue( row, col, position );
           }
         }
         else
         {
-          outputBlock->setValue( row, col, mNoDataValue );
+          output->setValue( row, col, mNoDataValue );
         }
       }
-    }
+    } );
     provider->writeBlock( outputBlock.get(), 1, iterLeft, iterTop );
   }
   provider->setEditable( false );
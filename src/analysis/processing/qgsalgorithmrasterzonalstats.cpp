@@ -207,6 +207,8 @@ QVariantMap QgsRasterLayerZonalStatsAlgorithm::processAlgorithm( const QVariantM
 
   QgsRasterIterator iter = mRefLayer == Source ? QgsRasterIterator( mSourceInterface )
                            : QgsRasterIterator( mZonesInterface );
+  // read the next part while the current one is processed
+  iter.setPrefetchCount( 1 );
   iter.startRasterRead( mRefLayer == Source ? mBand : mZonesBand, mLayerWidth, mLayerHeight, mExtent );
 
   int iterLeft = 0;
@@ -149,6 +149,8 @@ QVariantMap QgsRoundRasterValuesAlgorithm::processAlgorithm( const QVariantMap &
   const int nbBlocks = nbBlocksWidth * nbBlocksHeight;
 
   QgsRasterIterator iter( mInterface.get() );
+  // read the next part while the current one is processed
+  iter.setPrefetchCount( 1 );
   iter.startRasterRead( mBand, mLayerWidth, mLayerHeight, mExtent );
   int iterLeft = 0;
   int iterTop = 0;
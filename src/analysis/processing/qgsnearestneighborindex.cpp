@@ -0,0 +1,184 @@
+/***************************************************************************
+  qgsnearestneighborindex.cpp
+  ---------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsnearestneighborindex.h"
+#include "qgsgeometryengine.h"
+#include "qgspoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <queue>
+
+///@cond PRIVATE
+
+//! Maximum number of children of the nodes of the tree
+constexpr std::size_t NEAREST_NEIGHBOR_NODE_CAPACITY = 16;
+
+void QgsNearestNeighborIndex::Box::combine( const Box &other )
+{
+  xMin = std::min( xMin, other.xMin );
+  yMin = std::min( yMin, other.yMin );
+  xMax = std::max( xMax, other.xMax );
+  yMax = std::max( yMax, other.yMax );
+}
+
+double QgsNearestNeighborIndex::Box::distance( const Box &other ) const
+{
+  const double dx = std::max( 0.0, std::max( xMin - other.xMax, other.xMin - xMax ) );
+  const double dy = std::max( 0.0, std::max( yMin - other.yMax, other.yMin - yMax ) );
+  return std::sqrt( dx * dx + dy * dy );
+}
+
+void QgsNearestNeighborIndex::addFeature( QgsFeatureId id, const QgsGeometry &geometry )
+{
+  if ( geometry.isNull() )
+    return;
+
+  const QgsRectangle bounds = geometry.boundingBox();
+  Entry entry;
+  entry.id = id;
+  entry.geometry = geometry;
+  entry.bounds = Box { bounds.xMinimum(), bounds.yMinimum(), bounds.xMaximum(), bounds.yMaximum() };
+  entry.point = QgsWkbTypes::flatType( geometry.wkbType() ) == QgsWkbTypes::Point;
+  mEntries.emplace_back( std::move( entry ) );
+}
+
+void QgsNearestNeighborIndex::build()
+{
+  mNodes.clear();
+  const std::size_t entryCount = mEntries.size();
+  if ( entryCount == 0 )
+    return;
+
+  // sort-tile-recursive packing: vertical slices of entries sorted by x, each one sorted by y
+  const std::size_t leafCount = ( entryCount + NEAREST_NEIGHBOR_NODE_CAPACITY - 1 ) / NEAREST_NEIGHBOR_NODE_CAPACITY;
+  const std::size_t sliceSize = static_cast< std::size_t >( std::ceil( std::sqrt( static_cast< double >( leafCount ) ) ) ) * NEAREST_NEIGHBOR_NODE_CAPACITY;
+  std::sort( mEntries.begin(), mEntries.end(), []( const Entry & a, const Entry & b )
+  {
+    return a.bounds.xMin + a.bounds.xMax < b.bounds.xMin + b.bounds.xMax;
+  } );
+  for ( std::size_t sliceStart = 0; sliceStart < entryCount; sliceStart += sliceSize )
+  {
+    std::sort( mEntries.begin() + sliceStart, mEntries.begin() + std::min( entryCount, sliceStart + sliceSize ), []( const Entry & a, const Entry & b )
+    {
+      return a.bounds.yMin + a.bounds.yMax < b.bounds.yMin + b.bounds.yMax;
+    } );
+  }
+
+  mNodes.reserve( leafCount * 2 );
+  for ( std::size_t start = 0; start < entryCount; start += NEAREST_NEIGHBOR_NODE_CAPACITY )
+  {
+    Node node;
+    node.first = static_cast< int >( start );
+    node.count = static_cast< int >( std::min( NEAREST_NEIGHBOR_NODE_CAPACITY, entryCount - start ) );
+    node.bounds = mEntries[start].bounds;
+    for ( int i = 1; i < node.count; ++i )
+      node.bounds.combine( mEntries[start + i].bounds );
+    mNodes.emplace_back( node );
+  }
+
+  // the upper levels group consecutive nodes of the level below, which are close to each other, up to a single root node
+  std::size_t levelStart = 0;
+  std::size_t levelEnd = mNodes.size();
+  while ( levelEnd - levelStart > 1 )
+  {
+    for ( std::size_t start = levelStart; start < levelEnd; start += NEAREST_NEIGHBOR_NODE_CAPACITY )
+    {
+      Node node;
+      node.first = static_cast< int >( start );
+      node.count = static_cast< int >( std::min( NEAREST_NEIGHBOR_NODE_CAPACITY, levelEnd - start ) );
+      node.leaf = false;
+      node.bounds = mNodes[start].bounds;
+      for ( int i = 1; i < node.count; ++i )
+        node.bounds.combine( mNodes[start + i].bounds );
+      mNodes.emplace_back( node );
+    }
+    levelStart = levelEnd;
+    levelEnd = mNodes.size();
+  }
+}
+
+QList< QgsNearestNeighborIndex::Neighbor > QgsNearestNeighborIndex::nearestNeighbors( const QgsGeometry &geometry, int neighbors, double maxDistance, QgsFeatureId excludeId ) const
+{
+  QList< Neighbor > result;
+  if ( mNodes.empty() || geometry.isNull() || neighbors < 1 )
+    return result;
+
+  const QgsRectangle queryRectangle = geometry.boundingBox();
+  const Box queryBounds { queryRectangle.xMinimum(), queryRectangle.yMinimum(), queryRectangle.xMaximum(), queryRectangle.yMaximum() };
+  const bool queryIsPoint = QgsWkbTypes::flatType( geometry.wkbType() ) == QgsWkbTypes::Point;
+
+  // the query geometry is only prepared when distances to other geometries than points are required
+  std::unique_ptr< QgsGeometryEngine > engine;
+  const auto exactDistance = [&]( const Entry & entry ) -> double
+  {
+    if ( queryIsPoint && entry.point )
+      return queryBounds.distance( entry.bounds );
+
+    if ( !engine )
+    {
+      engine.reset( QgsGeometry::createGeometryEngine( geometry.constGet() ) );
+      engine->prepareGeometry();
+    }
+    return engine->distance( entry.geometry.constGet() );
+  };
+
+  // items of the queue are nodes, or entries encoded as negative indices, ordered by their distance to the query
+  using QueueItem = std::pair< double, int >;
+  std::priority_queue< QueueItem, std::vector< QueueItem >, std::greater< QueueItem > > queue;
+  const int root = static_cast< int >( mNodes.size() ) - 1;
+  queue.push( QueueItem( mNodes[root].bounds.distance( queryBounds ), root ) );
+
+  while ( !queue.empty() )
+  {
+    const QueueItem item = queue.top();
+    if ( maxDistance > 0 && item.first > maxDistance )
+      break;
+    // keep features at the same distance as the last neighbor
+    if ( result.size() >= neighbors && item.first > result.constLast().distance )
+      break;
+    queue.pop();
+
+    if ( item.second < 0 )
+    {
+      const int index = -item.second - 1;
+      result.append( Neighbor { mEntries[index].id, item.first, index } );
+      continue;
+    }
+
+    const Node &node = mNodes[item.second];
+    for ( int child = node.first; child < node.first + node.count; ++child )
+    {
+      if ( node.leaf )
+      {
+        const Entry &entry = mEntries[child];
+        if ( entry.id == excludeId )
+          continue;
+
+        const double distance = exactDistance( entry );
+        if ( distance >= 0 )
+          queue.push( QueueItem( distance, -child - 1 ) );
+      }
+      else
+      {
+        queue.push( QueueItem( mNodes[child].bounds.distance( queryBounds ), child ) );
+      }
+    }
+  }
+  return result;
+}
+
+///@endcond PRIVATE
@@ -0,0 +1,131 @@
+/***************************************************************************
+  qgsnearestneighborindex.h
+  ---------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSNEARESTNEIGHBORINDEX_H
+#define QGSNEARESTNEIGHBORINDEX_H
+
+#include "qgis_analysis.h"
+#include "qgsfeatureid.h"
+#include "qgsgeometry.h"
+
+#include <QList>
+
+#include <vector>
+
+#define SIP_NO_FILE
+
+///@cond PRIVATE
+
+/**
+ * \ingroup analysis
+ * \brief A read-only index of geometries answering nearest neighbor queries on exact distances.
+ *
+ * The geometries are added with addFeature(), then build() packs their bounding boxes into
+ * a static R-tree. Queries search the tree best-first with a priority queue, ordered by the
+ * distances to the bounding boxes of the nodes and by the exact distances to the geometries, which
+ * are computed with a prepared geometry of the query.
+ *
+ * Unlike QgsSpatialIndex, a built index is not locked by queries, and can be searched from
+ * several threads at the same time.
+ *
+ * \since QGIS 3.30
+ */
+class ANALYSIS_EXPORT QgsNearestNeighborIndex
+{
+  public:
+
+    //! A neighbor found by a query
+    struct Neighbor
+    {
+      //! Feature ID of the neighbor
+      QgsFeatureId id = FID_NULL;
+      //! Distance from the query geometry to the neighbor
+      double distance = 0;
+      //! Index of the geometry of the neighbor, see geometry()
+      int index = -1;
+    };
+
+    /**
+     * Adds a feature with the specified \a id and \a geometry to the index.
+     *
+     * Features must be added before calling build(). Null geometries are ignored.
+     */
+    void addFeature( QgsFeatureId id, const QgsGeometry &geometry );
+
+    /**
+     * Packs the added features into the tree, which must be done before querying the index.
+     */
+    void build();
+
+    /**
+     * Returns the number of features in the index.
+     */
+    int size() const { return static_cast< int >( mEntries.size() ); }
+
+    /**
+     * Returns the geometry of the neighbor at \a index.
+     */
+    const QgsGeometry &geometry( int index ) const { return mEntries[index].geometry; }
+
+    /**
+     * Returns the nearest \a neighbors features to a \a geometry, ordered by their distance.
+     *
+     * Features at the same distance as the last neighbor are also returned, so that more than
+     * \a neighbors features can be returned. If \a maxDistance is greater than 0, only features
+     * within this distance are returned. The feature with the \a excludeId ID is never returned, to
+     * search the neighbors of a feature of the index itself.
+     */
+    QList< Neighbor > nearestNeighbors( const QgsGeometry &geometry, int neighbors, double maxDistance = 0, QgsFeatureId excludeId = FID_NULL ) const;
+
+  private:
+
+    //! Bounding box, which unlike QgsRectangle is never null for points at the origin
+    struct Box
+    {
+      double xMin = 0;
+      double yMin = 0;
+      double xMax = 0;
+      double yMax = 0;
+
+      //! Extends the box to contain \a other
+      void combine( const Box &other );
+
+      //! Returns the minimum distance between the box and \a other
+      double distance( const Box &other ) const;
+    };
+
+    struct Entry
+    {
+      QgsFeatureId id = FID_NULL;
+      QgsGeometry geometry;
+      Box bounds;
+      bool point = false;
+    };
+
+    //! Node of the tree, holding a range of entries for leaves or of nodes otherwise
+    struct Node
+    {
+      Box bounds;
+      int first = 0;
+      int count = 0;
+      bool leaf = true;
+    };
+
+    std::vector< Entry > mEntries;
+    std::vector< Node > mNodes;
+};
+
+///@endcond PRIVATE
+
+#endif // QGSNEARESTNEIGHBORINDEX_H
@@ -20,9 +20,16 @@
 #include "qgsfeaturerequest.h"
 #include "qgsfeaturesource.h"
 #include "qgsprocessingcontext.h"
+#include "qgsspatialindex.h"
+
+#include <QtConcurrentMap>
+#include <numeric>
 
 ///@cond PRIVATE
 
+//! Number of features of the first source whose overlays are computed together in parallel
+static constexpr int OVERLAY_BATCH_SIZE = 1000;
+
 bool QgsOverlayUtils::sanitizeIntersectionResult( QgsGeometry &geom, QgsWkbTypes::GeometryType geometryType, SanitizeFlags flags )
 {
   if ( geom.isNull() )
@@ -98,6 +105,122 @@ static QString writeFeatureError()
   return QObject::tr( "Could not write feature" );
 }
 
+//! Output features of the overlay of a feature of the first source
+struct OverlayResult
+{
+  QgsFeatureList features;
+  //! error message of a failed overlay
+  QString error;
+};
+
+/**
+ * Computes the overlay of the features of the first source read by \a fitA with the features of \a sourceB
+ * whose bounding box they intersect in \a indexB.
+ *
+ * The features of the first source are read in batches, along with all the features of \a sourceB they may
+ * overlap. The \a overlay of the features of a batch are then computed in parallel, and written to the \a sink
+ * in the order of the features of the first source.
+ */
+static void overlayInBatches( QgsFeatureIterator &fitA, const QgsFeatureSource &sourceB, const QgsFeatureRequest &requestB, const QgsSpatialIndex &indexB,
+                              QgsFeatureSink &sink, QgsProcessingFeedback *feedback, long &count, long totalCount,
+                              const std::function< OverlayResult( const QgsFeature &featA, const QVector< const QgsFeature * > &featuresB ) > &overlay )
+{
+  auto processBatch = [&]( const QgsFeatureList & batchA )
+  {
+    QVector< QList< QgsFeatureId > > candidates( batchA.size() );
+    QgsFeatureIds allCandidates;
+    for ( int i = 0; i < batchA.size(); ++i )
+    {
+      if ( !batchA.at( i ).hasGeometry() )
+        continue;
+
+      QList< QgsFeatureId > ids = indexB.intersects( batchA.at( i ).geometry().boundingBox() );
+      std::sort( ids.begin(), ids.end() );
+      for ( const QgsFeatureId id : std::as_const( ids ) )
+        allCandidates.insert( id );
+      candidates[i] = ids;
+    }
+
+    // the features of B are read once for all the features of the batch
+    QHash< QgsFeatureId, QgsFeature > featuresB;
+    if ( !allCandidates.isEmpty() )
+    {
+      QgsFeatureRequest request( requestB );
+      request.setFilterFids( allCandidates );
+      QgsFeatureIterator fitB = sourceB.getFeatures( request );
+      QgsFeature featB;
+      while ( fitB.nextFeature( featB ) )
+      {
+        if ( feedback->isCanceled() )
+          return;
+
+        featuresB.insert( featB.id(), featB );
+      }
+    }
+
+    QVector< int > indices( batchA.size() );
+    std::iota( indices.begin(), indices.end(), 0 );
+    const std::function< OverlayResult( const int & ) > overlayFeature = [&]( const int &i ) -> OverlayResult
+    {
+      if ( feedback->isCanceled() )
+        return OverlayResult();
+
+      QVector< const QgsFeature * > candidateFeatures;
+      candidateFeatures.reserve( candidates.at( i ).size() );
+      for ( const QgsFeatureId id : candidates.at( i ) )
+      {
+        const auto it = featuresB.constFind( id );
+        if ( it != featuresB.constEnd() )
+          candidateFeatures << &it.value();
+      }
+
+      try
+      {
+        return overlay( batchA.at( i ), candidateFeatures );
+      }
+      catch ( QgsProcessingException &e )
+      {
+        OverlayResult result;
+        result.error = e.what();
+        return result;
+      }
+    };
+    QVector< OverlayResult > results = QtConcurrent::blockingMapped< QVector< OverlayResult > >( indices, overlayFeature );
+
+    for ( OverlayResult &result : results )
+    {
+      if ( feedback->isCanceled() )
+        return;
+
+      if ( !result.error.isEmpty() )
+        throw QgsProcessingException( result.error );
+
+      if ( !sink.addFeatures( result.features, QgsFeatureSink::FastInsert ) )
+        throw QgsProcessingException( writeFeatureError() );
+
+      ++count;
+      feedback->setProgress( count / static_cast< double >( totalCount ) * 100. );
+    }
+  };
+
+  QgsFeatureList batchA;
+  QgsFeature featA;
+  while ( fitA.nextFeature( featA ) )
+  {
+    if ( feedback->isCanceled() )
+      return;
+
+    batchA << featA;
+    if ( batchA.size() >= OVERLAY_BATCH_SIZE )
+    {
+      processBatch( batchA );
+      batchA.clear();
+    }
+  }
+  if ( !batchA.isEmpty() && !feedback->isCanceled() )
+    processBatch( batchA );
+}
+
 void QgsOverlayUtils::difference( const QgsFeatureSource &sourceA, const QgsFeatureSource &sourceB, QgsFeatureSink &sink, QgsProcessingContext &context, QgsProcessingFeedback *feedback, long &count, long totalCount, QgsOverlayUtils::DifferenceOutput outputAttrs, const QgsGeometryParameters &parameters, SanitizeFlags flags )
 {
   const QgsWkbTypes::GeometryType geometryType = QgsWkbTypes::geometryType( QgsWkbTypes::multiType( sourceA.wkbType() ) );
@@ -127,106 +250,85 @@ void QgsOverlayUtils::difference( const QgsFeatureSource &sourceA, const QgsFeat
 
   const int fieldsCountA = sourceA.fields().count();
   const int fieldsCountB = sourceB.fields().count();
-  QgsAttributes attrs;
-  attrs.resize( outputAttrs == OutputA ? fieldsCountA : ( fieldsCountA + fieldsCountB ) );
+  const int attrCount = outputAttrs == OutputA ? fieldsCountA : ( fieldsCountA + fieldsCountB );
 
   if ( totalCount == 0 )
     totalCount = 1;  // avoid division by zero
 
   feedback->setProgressText( QObject::tr( "Calculating difference" ) );
 
-  QgsFeature featA;
   QgsFeatureRequest requestA;
   requestA.setInvalidGeometryCheck( context.invalidGeometryCheck() );
   if ( outputAttrs == OutputBA )
     requestA.setDestinationCrs( sourceB.sourceCrs(), context.transformContext() );
   QgsFeatureIterator fitA = sourceA.getFeatures( requestA );
-  while ( fitA.nextFeature( featA ) )
-  {
-    if ( feedback->isCanceled() )
-      break;
 
-    if ( featA.hasGeometry() )
+  overlayInBatches( fitA, sourceB, requestB, indexB, sink, feedback, count, totalCount, [&]( const QgsFeature & featA, const QVector< const QgsFeature * > &featuresB ) -> OverlayResult
+  {
+    OverlayResult result;
+    if ( !featA.hasGeometry() )
     {
-      QgsGeometry geom( featA.geometry() );
-      const QgsFeatureIds intersects = qgis::listToSet( indexB.intersects( geom.boundingBox() ) );
-
-      QgsFeatureRequest request;
-      request.setFilterFids( intersects );
-      request.setNoAttributes();
-      if ( outputAttrs != OutputBA )
-        request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
+      // TODO: should we write out features that do not have geometry?
+      result.features << featA;
+      return result;
+    }
 
-      std::unique_ptr< QgsGeometryEngine > engine;
-      if ( !intersects.isEmpty() )
-      {
-        // use prepared geometries for faster intersection tests
-        engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
-        engine->prepareGeometry();
-      }
+    QgsGeometry geom( featA.geometry() );
+    QVector<QgsGeometry> geometriesB;
+    if ( !featuresB.isEmpty() )
+    {
+      // use prepared geometries for faster intersection tests
+      std::unique_ptr< QgsGeometryEngine > engine( QgsGeometry::createGeometryEngine( geom.constGet() ) );
+      engine->prepareGeometry();
 
-      QVector<QgsGeometry> geometriesB;
-      QgsFeature featB;
-      QgsFeatureIterator fitB = sourceB.getFeatures( request );
-      while ( fitB.nextFeature( featB ) )
+      for ( const QgsFeature *featB : featuresB )
       {
-        if ( feedback->isCanceled() )
-          break;
-
-        if ( engine->intersects( featB.geometry().constGet() ) )
-          geometriesB << featB.geometry();
+        if ( engine->intersects( featB->geometry().constGet() ) )
+          geometriesB << featB->geometry();
       }
+    }
 
-      if ( !geometriesB.isEmpty() )
+    if ( !geometriesB.isEmpty() )
+    {
+      const QgsGeometry geomB = QgsGeometry::unaryUnion( geometriesB, parameters );
+      if ( !geomB.lastError().isEmpty() )
       {
-        const QgsGeometry geomB = QgsGeometry::unaryUnion( geometriesB, parameters );
-        if ( !geomB.lastError().isEmpty() )
-        {
-          // This may happen if input geometries from a layer do not line up well (for example polygons
-          // that are nearly touching each other, but there is a very tiny overlap or gap at one of the edges).
-          // It is possible to get rid of this issue in two steps:
-          // 1. snap geometries with a small tolerance (e.g. 1cm) using QgsGeometrySnapperSingleSource
-          // 2. fix geometries (removes polygons collapsed to lines etc.) using MakeValid
-          throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: unary union failed." ), geomB.lastError() ) );
-        }
-        geom = geom.difference( geomB, parameters );
+        // This may happen if input geometries from a layer do not line up well (for example polygons
+        // that are nearly touching each other, but there is a very tiny overlap or gap at one of the edges).
+        // It is possible to get rid of this issue in two steps:
+        // 1. snap geometries with a small tolerance (e.g. 1cm) using QgsGeometrySnapperSingleSource
+        // 2. fix geometries (removes polygons collapsed to lines etc.) using MakeValid
+        throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: unary union failed." ), geomB.lastError() ) );
       }
+      geom = geom.difference( geomB, parameters );
+    }
 
-      if ( !geom.isNull() && !sanitizeDifferenceResult( geom, geometryType, flags ) )
-        continue;
+    if ( !geom.isNull() && !sanitizeDifferenceResult( geom, geometryType, flags ) )
+      return result;
 
-      const QgsAttributes attrsA( featA.attributes() );
-      switch ( outputAttrs )
-      {
-        case OutputA:
-          attrs = attrsA;
-          break;
-        case OutputAB:
-          for ( int i = 0; i < fieldsCountA; ++i )
-            attrs[i] = attrsA[i];
-          break;
-        case OutputBA:
-          for ( int i = 0; i < fieldsCountA; ++i )
-            attrs[i + fieldsCountB] = attrsA[i];
-          break;
-      }
-
-      QgsFeature outFeat;
-      outFeat.setGeometry( geom );
-      outFeat.setAttributes( attrs );
-      if ( !sink.addFeature( outFeat, QgsFeatureSink::FastInsert ) )
-        throw QgsProcessingException( writeFeatureError() );
-    }
-    else
+    QgsAttributes attrs( attrCount );
+    const QgsAttributes attrsA( featA.attributes() );
+    switch ( outputAttrs )
     {
-      // TODO: should we write out features that do not have geometry?
-      if ( !sink.addFeature( featA, QgsFeatureSink::FastInsert ) )
-        throw QgsProcessingException( writeFeatureError() );
+      case OutputA:
+        attrs = attrsA;
+        break;
+      case OutputAB:
+        for ( int i = 0; i < fieldsCountA; ++i )
+          attrs[i] = attrsA[i];
+        break;
+      case OutputBA:
+        for ( int i = 0; i < fieldsCountA; ++i )
+          attrs[i + fieldsCountB] = attrsA[i];
+        break;
     }
 
-    ++count;
-    feedback->setProgress( count / static_cast< double >( totalCount ) * 100. );
-  }
+    QgsFeature outFeat;
+    outFeat.setGeometry( geom );
+    outFeat.setAttributes( attrs );
+    result.features << outFeat;
+    return result;
+  } );
 }
 
 
@@ -239,8 +341,6 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
   request.setNoAttributes();
   request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
 
-  QgsFeature outFeat;
-
   double step = sourceB.featureCount() > 0 ? 100.0 / static_cast< double >( sourceB.featureCount() ) : 1;
   long long i = 0;
   QgsFeatureIterator fi = sourceB.getFeatures( request );
@@ -264,45 +364,31 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
 
   feedback->setProgressText( QObject::tr( "Calculating intersection" ) );
 
-  QgsFeature featA;
+  QgsFeatureRequest requestB;
+  requestB.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
+  requestB.setSubsetOfAttributes( fieldIndicesB );
+
   QgsFeatureIterator fitA = sourceA.getFeatures( QgsFeatureRequest().setSubsetOfAttributes( fieldIndicesA ) );
-  while ( fitA.nextFeature( featA ) )
+  overlayInBatches( fitA, sourceB, requestB, indexB, sink, feedback, count, totalCount, [&]( const QgsFeature & featA, const QVector< const QgsFeature * > &featuresB ) -> OverlayResult
   {
-    if ( feedback->isCanceled() )
-      break;
-
-    if ( !featA.hasGeometry() )
-      continue;
+    OverlayResult result;
+    if ( !featA.hasGeometry() || featuresB.isEmpty() )
+      return result;
 
     const QgsGeometry geom( featA.geometry() );
-    const QgsFeatureIds intersects = qgis::listToSet( indexB.intersects( geom.boundingBox() ) );
 
-    QgsFeatureRequest request;
-    request.setFilterFids( intersects );
-    request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
-    request.setSubsetOfAttributes( fieldIndicesB );
-
-    std::unique_ptr< QgsGeometryEngine > engine;
-    if ( !intersects.isEmpty() )
-    {
-      // use prepared geometries for faster intersection tests
-      engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
-      engine->prepareGeometry();
-    }
+    // use prepared geometries for faster intersection tests
+    std::unique_ptr< QgsGeometryEngine > engine( QgsGeometry::createGeometryEngine( geom.constGet() ) );
+    engine->prepareGeometry();
 
     QgsAttributes outAttributes( attrCount );
     const QgsAttributes attrsA( featA.attributes() );
     for ( int i = 0; i < fieldIndicesA.count(); ++i )
       outAttributes[i] = attrsA[fieldIndicesA[i]];
 
-    QgsFeature featB;
-    QgsFeatureIterator fitB = sourceB.getFeatures( request );
-    while ( fitB.nextFeature( featB ) )
+    for ( const QgsFeature *featB : featuresB )
     {
-      if ( feedback->isCanceled() )
-        break;
-
-      const QgsGeometry tmpGeom( featB.geometry() );
+      const QgsGeometry tmpGeom( featB->geometry() );
       if ( !engine->intersects( tmpGeom.constGet() ) )
         continue;
 
@@ -310,19 +396,17 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
       if ( !sanitizeIntersectionResult( intGeom, geometryType ) )
         continue;
 
-      const QgsAttributes attrsB( featB.attributes() );
+      const QgsAttributes attrsB( featB->attributes() );
       for ( int i = 0; i < fieldIndicesB.count(); ++i )
         outAttributes[fieldIndicesA.count() + i] = attrsB[fieldIndicesB[i]];
 
+      QgsFeature outFeat;
       outFeat.setGeometry( intGeom );
       outFeat.setAttributes( outAttributes );
-      if ( !sink.addFeature( outFeat, QgsFeatureSink::FastInsert ) )
-        throw QgsProcessingException( writeFeatureError() );
+      result.features << outFeat;
     }
-
-    ++count;
-    feedback->setProgress( count / static_cast<double >( totalCount ) * 100. );
-  }
+    return result;
+  } );
 }
 
 void QgsOverlayUtils::resolveOverlaps( const QgsFeatureSource &source, QgsFeatureSink &sink, QgsProcessingFeedback *feedback, const QgsGeometryParameters &parameters, SanitizeFlags flags )
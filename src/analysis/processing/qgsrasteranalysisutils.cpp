@@ -19,11 +19,17 @@
 #include "qgsrasterblock.h"
 #include "qgsrasteriterator.h"
 #include "qgsgeos.h"
+#include "qgscurvepolygon.h"
+#include "qgslinestring.h"
 #include "qgsprocessingparameters.h"
+#include <algorithm>
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
 #include <cmath>
+#include <limits>
+#include <numeric>
+#include <QtConcurrentMap>
 ///@cond PRIVATE
 
 void QgsRasterAnalysisUtils::cellInfoForBBox( const QgsRectangle &rasterBBox, const QgsRectangle &featureBBox, double cellSizeX, double cellSizeY,
@@ -59,14 +65,109 @@ void QgsRasterAnalysisUtils::cellInfoForBBox( const QgsRectangle &rasterBBox, co
                                     rasterBBox.yMaximum() - ( nCellsY + offsetY ) * cellSizeY );
 }
 
-void QgsRasterAnalysisUtils::statisticsFromMiddlePointTest( QgsRasterInterface *rasterInterface, int rasterBand, const QgsGeometry &poly, int nCellsX, int nCellsY, double cellSizeX, double cellSizeY, const QgsRectangle &rasterBBox,  const std::function<void( double )> &addValue, bool skipNodata )
+//! Ring edge crossing a range of pixel rows
+struct ScanlineEdge
 {
-  std::unique_ptr< QgsGeometryEngine > polyEngine( QgsGeometry::createGeometryEngine( poly.constGet( ) ) );
-  if ( !polyEngine )
+  double x1 = 0;
+  double y1 = 0;
+  double dxdy = 0;
+  int firstRow = 0;
+  int lastRow = 0;
+};
+
+QVector< QVector< int > > QgsRasterAnalysisUtils::pixelCenterSpans( const QgsGeometry &poly, int nCellsX, int nCellsY, double cellSizeX, double cellSizeY, const QgsRectangle &rasterBBox )
+{
+  QVector< QVector< int > > spans( nCellsY );
+  if ( nCellsX <= 0 || nCellsY <= 0 )
+    return spans;
+
+  QgsGeometry segmentized = poly;
+  if ( QgsWkbTypes::isCurvedType( segmentized.wkbType() ) )
+    segmentized.convertToStraightSegment();
+
+  const double top = rasterBBox.yMaximum();
+  const double left = rasterBBox.xMinimum();
+
+  std::vector< ScanlineEdge > edges;
+  auto addRing = [ &edges, top, cellSizeY, nCellsY ]( const QgsCurve * curve )
   {
-    return;
+    const QgsLineString *ring = qgsgeometry_cast< const QgsLineString * >( curve );
+    if ( !ring )
+      return;
+
+    const double *x = ring->xData();
+    const double *y = ring->yData();
+    const int pointCount = ring->numPoints();
+    for ( int i = 0; i < pointCount - 1; ++i )
+    {
+      const double yLow = std::min( y[i], y[i + 1] );
+      const double yHigh = std::max( y[i], y[i + 1] );
+      if ( yLow == yHigh )
+        continue;
+
+      // rows whose center line is in [yLow, yHigh), so that a vertex shared by two edges is crossed once
+      ScanlineEdge edge;
+      edge.firstRow = std::max( 0, static_cast< int >( std::floor( ( top - yHigh ) / cellSizeY - 0.5 ) ) + 1 );
+      edge.lastRow = std::min( nCellsY - 1, static_cast< int >( std::floor( ( top - yLow ) / cellSizeY - 0.5 ) ) );
+      if ( edge.firstRow > edge.lastRow )
+        continue;
+
+      edge.x1 = x[i];
+      edge.y1 = y[i];
+      edge.dxdy = ( x[i + 1] - x[i] ) / ( y[i + 1] - y[i] );
+      edges.emplace_back( edge );
+    }
+  };
+
+  for ( auto it = segmentized.const_parts_begin(); it != segmentized.const_parts_end(); ++it )
+  {
+    const QgsCurvePolygon *polygon = qgsgeometry_cast< const QgsCurvePolygon * >( *it );
+    if ( !polygon )
+      continue;
+
+    addRing( polygon->exteriorRing() );
+    for ( int i = 0; i < polygon->numInteriorRings(); ++i )
+      addRing( polygon->interiorRing( i ) );
   }
-  polyEngine->prepareGeometry();
+
+  std::sort( edges.begin(), edges.end(), []( const ScanlineEdge & a, const ScanlineEdge & b ) { return a.firstRow < b.firstRow; } );
+
+  std::vector< const ScanlineEdge * > activeEdges;
+  std::vector< double > crossings;
+  auto nextEdge = edges.cbegin();
+  for ( int row = 0; row < nCellsY; ++row )
+  {
+    activeEdges.erase( std::remove_if( activeEdges.begin(), activeEdges.end(), [row]( const ScanlineEdge * edge ) { return edge->lastRow < row; } ), activeEdges.end() );
+    for ( ; nextEdge != edges.cend() && nextEdge->firstRow == row; ++nextEdge )
+      activeEdges.emplace_back( &( *nextEdge ) );
+
+    if ( activeEdges.empty() )
+      continue;
+
+    const double cellCenterY = top - ( row + 0.5 ) * cellSizeY;
+    crossings.clear();
+    for ( const ScanlineEdge *edge : activeEdges )
+      crossings.emplace_back( edge->x1 + ( cellCenterY - edge->y1 ) * edge->dxdy );
+    std::sort( crossings.begin(), crossings.end() );
+
+    QVector< int > &rowSpans = spans[ row ];
+    for ( std::size_t i = 0; i + 1 < crossings.size(); i += 2 )
+    {
+      const int firstColumn = std::max( 0, static_cast< int >( std::floor( ( crossings[i] - left ) / cellSizeX - 0.5 ) ) + 1 );
+      const int endColumn = std::min( nCellsX, static_cast< int >( std::ceil( ( crossings[i + 1] - left ) / cellSizeX - 0.5 ) ) );
+      if ( firstColumn < endColumn )
+      {
+        rowSpans << firstColumn << endColumn;
+      }
+    }
+  }
+  return spans;
+}
+
+void QgsRasterAnalysisUtils::statisticsFromMiddlePointTest( QgsRasterInterface *rasterInterface, int rasterBand, const QgsGeometry &poly, int nCellsX, int nCellsY, double cellSizeX, double cellSizeY, const QgsRectangle &rasterBBox,  const std::function<void( double )> &addValue, bool skipNodata )
+{
+  // the pixels are selected by scanning the polygon rows, instead of testing each pixel center against the polygon
+  const QVector< QVector< int > > spans = pixelCenterSpans( poly, nCellsX, nCellsY, cellSizeX, cellSizeY, rasterBBox );
 
   QgsRasterIterator iter( rasterInterface );
   iter.startRasterRead( rasterBand, nCellsX, nCellsY, rasterBBox );
@@ -76,29 +177,25 @@ void QgsRasterAnalysisUtils::statisticsFromMiddlePointTest( QgsRasterInterface *
   int iterTop = 0;
   int iterCols = 0;
   int iterRows = 0;
-  QgsRectangle blockExtent;
   bool isNoData = false;
-  while ( iter.readNextRasterPart( rasterBand, iterCols, iterRows, block, iterLeft, iterTop, &blockExtent ) )
+  while ( iter.readNextRasterPart( rasterBand, iterCols, iterRows, block, iterLeft, iterTop ) )
   {
-    double cellCenterY = blockExtent.yMaximum() - 0.5 * cellSizeY;
-
     for ( int row = 0; row < iterRows; ++row )
     {
-      double cellCenterX = blockExtent.xMinimum() + 0.5 * cellSizeX;
-      for ( int col = 0; col < iterCols; ++col )
+      const QVector< int > &rowSpans = spans.at( iterTop + row );
+      for ( int i = 0; i + 1 < rowSpans.size(); i += 2 )
       {
-        const double pixelValue = block->valueAndNoData( row, col, isNoData );
-        if ( validPixel( pixelValue ) && ( !skipNodata || !isNoData ) )
+        const int firstColumn = std::max( rowSpans.at( i ), iterLeft ) - iterLeft;
+        const int endColumn = std::min( rowSpans.at( i + 1 ), iterLeft + iterCols ) - iterLeft;
+        for ( int col = firstColumn; col < endColumn; ++col )
         {
-          QgsPoint cellCenter( cellCenterX, cellCenterY );
-          if ( polyEngine->contains( &cellCenter ) )
+          const double pixelValue = block->valueAndNoData( row, col, isNoData );
+          if ( validPixel( pixelValue ) && ( !skipNodata || !isNoData ) )
           {
             addValue( pixelValue );
           }
         }
-        cellCenterX += cellSizeX;
       }
-      cellCenterY -= cellSizeY;
     }
   }
 }
@@ -262,10 +359,16 @@ void QgsRasterAnalysisUtils::applyRasterLogicOperator( const std::vector< QgsRas
     }
 
     feedback->setProgress( 100 * ( ( iterTop / maxHeight * nbBlocksWidth ) + iterLeft / maxWidth ) / nbBlocks );
-    for ( int row = 0; row < iterRows; row++ )
+
+    // the rows are processed in parallel, each one counting its own results
+    std::vector< qgssize > rowNoDataCounts( iterRows );
+    std::vector< qgssize > rowTrueCounts( iterRows );
+    std::vector< qgssize > rowFalseCounts( iterRows );
+    QgsRasterBlock *output = outputBlock.get();
+    processRowsInParallel( iterRows, [ &, output, iterCols ]( int row )
     {
       if ( feedback->isCanceled() )
-        break;
+        return;
 
       for ( int column = 0; column < iterCols; column++ )
       {
@@ -273,15 +376,19 @@ void QgsRasterAnalysisUtils::applyRasterLogicOperator( const std::vector< QgsRas
         bool resIsNoData = false;
         applyLogicFunc( inputBlocks, res, resIsNoData, row, column, treatNoDataAsFalse );
         if ( resIsNoData )
-          noDataCount++;
+          rowNoDataCounts[row]++;
         else if ( res )
-          trueCount++;
+          rowTrueCounts[row]++;
         else
-          falseCount++;
+          rowFalseCounts[row]++;
 
-        outputBlock->setValue( row, column, resIsNoData ? outputNoDataValue : ( res ? 1 : 0 ) );
+        output->setValue( row, column, resIsNoData ? outputNoDataValue : ( res ? 1 : 0 ) );
       }
-    }
+    } );
+    noDataCount += std::accumulate( rowNoDataCounts.begin(), rowNoDataCounts.end(), static_cast< qgssize >( 0 ) );
+    trueCount += std::accumulate( rowTrueCounts.begin(), rowTrueCounts.end(), static_cast< qgssize >( 0 ) );
+    falseCount += std::accumulate( rowFalseCounts.begin(), rowFalseCounts.end(), static_cast< qgssize >( 0 ) );
+
     destinationRaster->writeBlock( outputBlock.get(), 1, iterLeft, iterTop );
   }
   destinationRaster->setEditable( false );
@@ -319,6 +426,100 @@ std::vector<double> QgsRasterAnalysisUtils::getCellValuesFromBlockStack( const s
   return cellValues;
 }
 
+//! Converts \a count values of type T starting at \a data to double \a values
+template <typename T>
+static void convertBlockValues( const char *data, qgssize count, double *values )
+{
+  const T *typedData = reinterpret_cast< const T * >( data );
+  for ( qgssize i = 0; i < count; ++i )
+    values[i] = static_cast< double >( typedData[i] );
+}
+
+std::vector< std::vector< double > > QgsRasterAnalysisUtils::blockStackValues( const std::vector< std::unique_ptr< QgsRasterBlock > > &inputBlocks )
+{
+  std::vector< std::vector< double > > stack( inputBlocks.size() );
+  for ( std::size_t i = 0; i < inputBlocks.size(); ++i )
+  {
+    const QgsRasterBlock *block = inputBlocks[i].get();
+    if ( !block || !block->isValid() )
+      continue;
+
+    const qgssize count = static_cast< qgssize >( block->width() ) * static_cast< qgssize >( block->height() );
+    std::vector< double > &values = stack[i];
+    values.resize( count );
+
+    // the raw data is shared with the block, converting it by type avoids a switch on the data type for each value
+    const QByteArray data = block->data();
+    switch ( block->dataType() )
+    {
+      case Qgis::DataType::Byte:
+        convertBlockValues< quint8 >( data.constData(), count, values.data() );
+        break;
+      case Qgis::DataType::Int8:
+        convertBlockValues< qint8 >( data.constData(), count, values.data() );
+        break;
+      case Qgis::DataType::UInt16:
+        convertBlockValues< quint16 >( data.constData(), count, values.data() );
+        break;
+      case Qgis::DataType::Int16:
+        convertBlockValues< qint16 >( data.constData(), count, values.data() );
+        break;
+      case Qgis::DataType::UInt32:
+        convertBlockValues< quint32 >( data.constData(), count, values.data() );
+        break;
+      case Qgis::DataType::Int32:
+        convertBlockValues< qint32 >( data.constData(), count, values.data() );
+        break;
+      case Qgis::DataType::Float32:
+        convertBlockValues< float >( data.constData(), count, values.data() );
+        break;
+      case Qgis::DataType::Float64:
+        convertBlockValues< double >( data.constData(), count, values.data() );
+        break;
+      default:
+        for ( qgssize j = 0; j < count; ++j )
+          values[j] = block->value( j );
+        break;
+    }
+
+    if ( block->hasNoData() )
+    {
+      for ( qgssize j = 0; j < count; ++j )
+      {
+        if ( block->isNoData( j ) )
+          values[j] = std::numeric_limits< double >::quiet_NaN();
+      }
+    }
+  }
+  return stack;
+}
+
+void QgsRasterAnalysisUtils::cellValuesFromStack( const std::vector< std::vector< double > > &stack, qgssize index, std::vector<double> &cellValues, bool &noDataInStack )
+{
+  cellValues.clear();
+  for ( const std::vector< double > &values : stack )
+  {
+    if ( values.empty() )
+    {
+      noDataInStack = true;
+      continue;
+    }
+
+    const double value = values[index];
+    if ( std::isnan( value ) )
+      noDataInStack = true; //NoData is not included in the cell value vector
+    else
+      cellValues.push_back( value );
+  }
+}
+
+void QgsRasterAnalysisUtils::processRowsInParallel( int rows, const std::function< void( int ) > &processRow )
+{
+  std::vector< int > rowIndices( rows );
+  std::iota( rowIndices.begin(), rowIndices.end(), 0 );
+  QtConcurrent::blockingMap( rowIndices, [&processRow]( const int &row ) { processRow( row ); } );
+}
+
 double QgsRasterAnalysisUtils::meanFromCellValues( std::vector<double> &cellValues, int stackSize )
 {
   const double sum = std::accumulate( cellValues.begin(), cellValues.end(), 0.0 );
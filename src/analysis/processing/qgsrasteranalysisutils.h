@@ -19,6 +19,8 @@
 #include "qgis_analysis.h"
 #include "qgis.h"
 
+#include <QVector>
+
 #include <functional>
 #include <memory>
 #include <vector>
@@ -46,6 +48,15 @@ namespace QgsRasterAnalysisUtils
                         int rasterWidth, int rasterHeight,
                         QgsRectangle &rasterBlockExtent );
 
+  /**
+   * Returns the spans of pixels whose center is inside a polygon, for each row of the raster extent.
+   *
+   * The spans of a row are stored as pairs of the first column and the column after the last one. The rows
+   * are scanned along the lines through the pixel centers, and the pixel centers lying between consecutive
+   * crossings of the polygon rings are inside the polygon. Pixel centers lying on the rings are not inside it.
+   */
+  QVector< QVector< int > > pixelCenterSpans( const QgsGeometry &poly, int nCellsX, int nCellsY, double cellSizeX, double cellSizeY, const QgsRectangle &rasterBBox );
+
   //! Returns statistics by considering the pixels where the center point is within the polygon (fast)
   void statisticsFromMiddlePointTest( QgsRasterInterface *rasterInterface, int rasterBand, const QgsGeometry &poly, int nCellsX, int nCellsY,
                                       double cellSizeX, double cellSizeY, const QgsRectangle &rasterBBox, const std::function<void( double )> &addValue, bool skipNodata = true );
@@ -96,6 +107,28 @@ namespace QgsRasterAnalysisUtils
    */
   std::vector<double> getCellValuesFromBlockStack( const std::vector< std::unique_ptr< QgsRasterBlock > > &inputBlocks, int &row, int &col, bool &noDataInStack );
 
+  /**
+   * Returns the values of a stack of input QgsRasterBlocks converted to double, with a vector of values for each block.
+   *
+   * NoData values (and NaN values) are stored as NaN. The vector of a missing or invalid block is empty, as all its cells are NoData.
+   * The stack is meant to be converted once and read by cellValuesFromStack() or by kernels processing whole rows, instead
+   * of converting each value from the block data type at each cell.
+   */
+  std::vector< std::vector< double > > blockStackValues( const std::vector< std::unique_ptr< QgsRasterBlock > > &inputBlocks );
+
+  /**
+   * Collects the values of the cell at \a index from a \a stack returned by blockStackValues() into \a cellValues,
+   * which is cleared first so that it can be reused for all the cells without allocating memory.
+   *
+   * NoData values are not included in the cell values, and \a noDataInStack is set to TRUE if the stack contains NoData at the cell.
+   */
+  void cellValuesFromStack( const std::vector< std::vector< double > > &stack, qgssize index, std::vector<double> &cellValues, bool &noDataInStack );
+
+  /**
+   * Processes the \a rows of a block in parallel, calling \a processRow with each row index.
+   */
+  void processRowsInParallel( int rows, const std::function< void( int ) > &processRow );
+
   /**
    * Enum of cell value statistic methods to be used with QgsProcessingParameterEnum
    */
@@ -18,10 +18,15 @@
 #include <gdalwarper.h>
 #include <ogr_srs_api.h>
 #include <cpl_conv.h>
+#include <cpl_string.h>
+#include <algorithm>
+#include <atomic>
 #include <limits>
 
 #include <QPair>
 #include <QString>
+#include <QThread>
+#include <QtConcurrentRun>
 
 #include "qgscoordinatereferencesystem.h"
 #include "qgsrectangle.h"
@@ -72,6 +77,30 @@ static int CPL_STDCALL _progress( double dfComplete, const char *pszMessage, voi
 }
 
 
+//! Maximum memory in bytes used by each warp operation for its chunks
+static constexpr double WARP_MEMORY_LIMIT = 256.0 * 1024 * 1024;
+
+//! State of the warp of a raster run in a background thread
+struct WarpTask
+{
+  //! progress of the warp, from 0 to 1
+  std::atomic<double> progress { 0 };
+  //! set by the thread running the alignment to cancel the warp
+  const std::atomic<bool> *canceled = nullptr;
+  bool result = false;
+  QString error;
+};
+
+static int CPL_STDCALL _taskProgress( double dfComplete, const char *pszMessage, void *pProgressArg )
+{
+  Q_UNUSED( pszMessage )
+
+  WarpTask *task = static_cast< WarpTask * >( pProgressArg );
+  task->progress.store( dfComplete );
+  return !task->canceled->load();
+}
+
+
 static CPLErr rescalePreWarpChunkProcessor( void *pKern, void *pArg )
 {
   GDALWarpKernel *kern = ( GDALWarpKernel * ) pKern;
@@ -363,11 +392,49 @@ bool QgsAlignRaster::run()
 
   //dump();
 
-  const auto constMRasters = mRasters;
-  for ( const Item &r : constMRasters )
+  const List rasters = mRasters;
+  if ( rasters.isEmpty() )
+    return true;
+
+  // the rasters are warped concurrently, sharing the threads between the warps. The progress handler
+  // may update the GUI, so it is only called from this thread
+  const int warpThreadCount = std::max( 1, QThread::idealThreadCount() / rasters.count() );
+  std::atomic<bool> canceled { false };
+  std::vector< WarpTask > tasks( rasters.count() );
+  QList< QFuture< void > > futures;
+  for ( int i = 0; i < rasters.count(); ++i )
+  {
+    WarpTask &task = tasks[i];
+    task.canceled = &canceled;
+    const Item &raster = rasters.at( i );
+    futures << QtConcurrent::run( [this, &task, &raster, warpThreadCount]
+    {
+      task.result = warp( raster, warpThreadCount, _taskProgress, &task, task.error );
+    } );
+  }
+
+  bool finished = false;
+  while ( !finished )
+  {
+    finished = std::all_of( futures.constBegin(), futures.constEnd(), []( const QFuture< void > &future ) { return future.isFinished(); } );
+
+    double progress = 0;
+    for ( const WarpTask &task : tasks )
+      progress += task.progress.load();
+    if ( mProgressHandler && !canceled.load() && !mProgressHandler->progress( progress / rasters.count() ) )
+      canceled.store( true );
+
+    if ( !finished )
+      QThread::msleep( 50 );
+  }
+
+  for ( const WarpTask &task : tasks )
   {
-    if ( !createAndWarp( r ) )
+    if ( !task.result )
+    {
+      mErrorMessage = task.error;
       return false;
+    }
   }
   return true;
 }
@@ -420,10 +487,21 @@ int QgsAlignRaster::suggestedReferenceLayer() const
 
 bool QgsAlignRaster::createAndWarp( const Item &raster )
 {
-  GDALDriverH hDriver = GDALGetDriverByName( "GTiff" );
+  return warp( raster, QThread::idealThreadCount(), _progress, this, mErrorMessage );
+}
+
+bool QgsAlignRaster::warp( const Item &raster, int threadCount, GDALProgressFunc progress, void *progressArg, QString &error ) const
+{
+  GDALDriverH hDriver = GDALGetDriverByName( mVirtualOutput ? "VRT" : "GTiff" );
   if ( !hDriver )
   {
-    mErrorMessage = QStringLiteral( "GDALGetDriverByName(GTiff) failed." );
+    error = mVirtualOutput ? QStringLiteral( "GDALGetDriverByName(VRT) failed." ) : QStringLiteral( "GDALGetDriverByName(GTiff) failed." );
+    return false;
+  }
+
+  if ( mVirtualOutput && raster.rescaleValues )
+  {
+    error = QObject::tr( "Values cannot be rescaled in virtual output: %1" ).arg( raster.outputFilename );
     return false;
   }
 
@@ -431,54 +509,95 @@ bool QgsAlignRaster::createAndWarp( const Item &raster )
   const gdal::dataset_unique_ptr hSrcDS( GDALOpen( raster.inputFilename.toUtf8().constData(), GA_ReadOnly ) );
   if ( !hSrcDS )
   {
-    mErrorMessage = QObject::tr( "Unable to open input file: %1" ).arg( raster.inputFilename );
+    error = QObject::tr( "Unable to open input file: %1" ).arg( raster.inputFilename );
     return false;
   }
 
+  // Setup warp options.
+  gdal::warp_options_unique_ptr psWarpOptions( GDALCreateWarpOptions() );
+  psWarpOptions->hSrcDS = hSrcDS.get();
+
+  psWarpOptions->nBandCount = GDALGetRasterCount( hSrcDS.get() );
+  psWarpOptions->panSrcBands = ( int * ) CPLMalloc( sizeof( int ) * psWarpOptions->nBandCount );
+  psWarpOptions->panDstBands = ( int * ) CPLMalloc( sizeof( int ) * psWarpOptions->nBandCount );
+  for ( int i = 0; i < psWarpOptions->nBandCount; ++i )
+  {
+    psWarpOptions->panSrcBands[i] = i + 1;
+    psWarpOptions->panDstBands[i] = i + 1;
+  }
+
+  psWarpOptions->eResampleAlg = static_cast< GDALResampleAlg >( raster.resampleMethod );
+  psWarpOptions->dfWarpMemoryLimit = WARP_MEMORY_LIMIT;
+  psWarpOptions->papszWarpOptions = CSLSetNameValue( psWarpOptions->papszWarpOptions, "NUM_THREADS", QString::number( threadCount ).toUtf8().constData() );
+
+  GDALColorTableH hCT = GDALGetRasterColorTable( GDALGetRasterBand( hSrcDS.get(), 1 ) );
+
+  if ( mVirtualOutput )
+  {
+    // Establish reprojection transformer, owned by the virtual dataset
+    double srcGeoTransform[6];
+    GDALGetGeoTransform( hSrcDS.get(), srcGeoTransform );
+    double dstGeoTransform[6];
+    std::copy( mGeoTransform, mGeoTransform + 6, dstGeoTransform );
+    psWarpOptions->pTransformerArg =
+      GDALCreateGenImgProjTransformer3( GDALGetProjectionRef( hSrcDS.get() ), srcGeoTransform,
+                                        mCrsWkt.toLatin1().constData(), dstGeoTransform );
+    psWarpOptions->pfnTransformer = GDALGenImgProjTransform;
+
+    const gdal::dataset_unique_ptr hVrtDS( GDALCreateWarpedVRT( hSrcDS.get(), mXSize, mYSize, dstGeoTransform, psWarpOptions.get() ) );
+    if ( !hVrtDS )
+    {
+      error = QObject::tr( "Unable to create output file: %1" ).arg( raster.outputFilename );
+      return false;
+    }
+    GDALSetProjection( hVrtDS.get(), mCrsWkt.toLatin1().constData() );
+    if ( hCT )
+      GDALSetRasterColorTable( GDALGetRasterBand( hVrtDS.get(), 1 ), hCT );
+
+    const gdal::dataset_unique_ptr hDstDS( GDALCreateCopy( hDriver, raster.outputFilename.toUtf8().constData(), hVrtDS.get(), FALSE, nullptr, nullptr, nullptr ) );
+    if ( !hDstDS )
+    {
+      error = QObject::tr( "Unable to create output file: %1" ).arg( raster.outputFilename );
+      return false;
+    }
+    progress( 1.0, nullptr, progressArg );
+    return true;
+  }
+
   // Create output with same datatype as first input band.
 
   const int bandCount = GDALGetRasterCount( hSrcDS.get() );
   const GDALDataType eDT = GDALGetRasterDataType( GDALGetRasterBand( hSrcDS.get(), 1 ) );
 
-  // Create the output file.
+  // Create the output file, tiled and compressed.
+  char **createOptions = nullptr;
+  createOptions = CSLSetNameValue( createOptions, "TILED", "YES" );
+  createOptions = CSLSetNameValue( createOptions, "COMPRESS", "DEFLATE" );
+  createOptions = CSLSetNameValue( createOptions, "BIGTIFF", "IF_SAFER" );
   const gdal::dataset_unique_ptr hDstDS( GDALCreate( hDriver, raster.outputFilename.toUtf8().constData(), mXSize, mYSize,
-                                         bandCount, eDT, nullptr ) );
+                                         bandCount, eDT, createOptions ) );
+  CSLDestroy( createOptions );
   if ( !hDstDS )
   {
-    mErrorMessage = QObject::tr( "Unable to create output file: %1" ).arg( raster.outputFilename );
+    error = QObject::tr( "Unable to create output file: %1" ).arg( raster.outputFilename );
     return false;
   }
 
   // Write out the projection definition.
   GDALSetProjection( hDstDS.get(), mCrsWkt.toLatin1().constData() );
-  GDALSetGeoTransform( hDstDS.get(), mGeoTransform );
+  GDALSetGeoTransform( hDstDS.get(), const_cast< double * >( mGeoTransform ) );
 
   // Copy the color table, if required.
-  GDALColorTableH hCT = GDALGetRasterColorTable( GDALGetRasterBand( hSrcDS.get(), 1 ) );
   if ( hCT )
     GDALSetRasterColorTable( GDALGetRasterBand( hDstDS.get(), 1 ), hCT );
 
   // -----------------------------------------------------------------------
 
-  // Setup warp options.
-  gdal::warp_options_unique_ptr psWarpOptions( GDALCreateWarpOptions() );
-  psWarpOptions->hSrcDS = hSrcDS.get();
   psWarpOptions->hDstDS = hDstDS.get();
 
-  psWarpOptions->nBandCount = GDALGetRasterCount( hSrcDS.get() );
-  psWarpOptions->panSrcBands = ( int * ) CPLMalloc( sizeof( int ) * psWarpOptions->nBandCount );
-  psWarpOptions->panDstBands = ( int * ) CPLMalloc( sizeof( int ) * psWarpOptions->nBandCount );
-  for ( int i = 0; i < psWarpOptions->nBandCount; ++i )
-  {
-    psWarpOptions->panSrcBands[i] = i + 1;
-    psWarpOptions->panDstBands[i] = i + 1;
-  }
-
-  psWarpOptions->eResampleAlg = static_cast< GDALResampleAlg >( raster.resampleMethod );
-
   // our progress function
-  psWarpOptions->pfnProgress = _progress;
-  psWarpOptions->pProgressArg = this;
+  psWarpOptions->pfnProgress = progress;
+  psWarpOptions->pProgressArg = progressArg;
 
   // Establish reprojection transformer.
   psWarpOptions->pTransformerArg =
@@ -500,12 +619,17 @@ bool QgsAlignRaster::createAndWarp( const Item &raster )
     psWarpOptions->eWorkingDataType = GDT_Float32;
   }
 
-  // Initialize and execute the warp operation.
+  // Initialize and execute the warp operation, overlapping reads and computations
   GDALWarpOperation oOperation;
   oOperation.Initialize( psWarpOptions.get() );
-  oOperation.ChunkAndWarpImage( 0, 0, mXSize, mYSize );
+  const CPLErr err = oOperation.ChunkAndWarpMulti( 0, 0, mXSize, mYSize );
 
   GDALDestroyGenImgProjTransformer( psWarpOptions->pTransformerArg );
+  if ( err != CE_None )
+  {
+    error = QObject::tr( "Unable to warp input file %1: %2" ).arg( raster.inputFilename, QString::fromUtf8( CPLGetLastErrorMsg() ) );
+    return false;
+  }
   return true;
 }
 
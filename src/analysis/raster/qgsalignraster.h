@@ -39,6 +39,10 @@ typedef void *GDALDatasetH SIP_SKIP;
  * - cell size and raster size
  * - offset of the raster grid
  *
+ * The rasters are warped concurrently, each warp using GDAL multithreading. The aligned rasters are
+ * written as tiled and compressed GeoTIFF files, or as virtual rasters (VRT) warping the inputs
+ * on the fly when virtualOutput() is set.
+ *
  * \since QGIS 2.12
  */
 class ANALYSIS_EXPORT QgsAlignRaster
@@ -193,6 +197,26 @@ class ANALYSIS_EXPORT QgsAlignRaster
     //! Gets the output CRS in WKT format
     QString destinationCrs() const { return mCrsWkt; }
 
+    /**
+     * Sets whether the aligned rasters are written as virtual rasters (VRT) warping the input rasters
+     * on the fly, instead of GeoTIFF files storing the warped pixels.
+     *
+     * Virtual outputs are much faster to create and take no disk space, which suits callers reading
+     * the aligned rasters once, like the raster calculator. Values cannot be rescaled in virtual outputs.
+     *
+     * \see virtualOutput()
+     * \since QGIS 3.30
+     */
+    void setVirtualOutput( bool virtualOutput ) { mVirtualOutput = virtualOutput; }
+
+    /**
+     * Returns TRUE if the aligned rasters are written as virtual rasters (VRT).
+     *
+     * \see setVirtualOutput()
+     * \since QGIS 3.30
+     */
+    bool virtualOutput() const { return mVirtualOutput; }
+
     /**
      * Configure clipping extent (region of interest).
      * No extra clipping is done if the rectangle is null
@@ -271,6 +295,16 @@ class ANALYSIS_EXPORT QgsAlignRaster
     //! Internal function for processing of one raster (1. create output, 2. do the alignment)
     bool createAndWarp( const Item &raster );
 
+#ifndef SIP_RUN
+
+    /**
+     * Creates the aligned output of one \a raster, warping it with \a threadCount threads and reporting
+     * the progress to the GDAL \a progress function.
+     * Can be called from any thread. Returns FALSE with the \a error set in case of error.
+     */
+    bool warp( const Item &raster, int threadCount, GDALProgressFunc progress, void *progressArg, QString &error ) const;
+#endif
+
     //! Determine suggested output of raster warp to a different CRS. Returns TRUE on success
     static bool suggestedWarpOutput( const RasterInfo &info, const QString &destWkt, QSizeF *cellSize = nullptr, QPointF *gridOffset = nullptr, QgsRectangle *rect = nullptr );
 
@@ -287,6 +321,9 @@ class ANALYSIS_EXPORT QgsAlignRaster
     //! List of rasters to be aligned (with their output files and other options)
     List mRasters;
 
+    //! Whether the aligned rasters are written as virtual rasters
+    bool mVirtualOutput = false;
+
     //! Destination CRS - stored in well-known text (WKT) format
     QString mCrsWkt;
     //! Destination cell size
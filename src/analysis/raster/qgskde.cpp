@@ -18,8 +18,18 @@
 #include "qgsfeatureiterator.h"
 #include "qgsgeometry.h"
 
+#include <QtConcurrentMap>
+
+#include <functional>
+
 #define NO_DATA -9999
 
+//! Number of raster rows in each band of the surface
+static constexpr int BAND_ROWS = 64;
+
+//! Number of points collected before their kernels are added to the surface
+static constexpr int MAX_PENDING_POINTS = 100000;
+
 QgsKernelDensityEstimation::QgsKernelDensityEstimation( const QgsKernelDensityEstimation::Parameters &parameters, const QString &outputFile, const QString &outputFormat )
   : mSource( parameters.source )
   , mOutputFile( outputFile )
@@ -101,6 +111,13 @@ QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::prepare()
   if ( mRadiusField < 0 )
     mBufferSize = radiusSizeInPixels( mRadius );
 
+  // the surface is accumulated in memory, by bands of rows which are allocated when a kernel first covers them
+  mRows = rows;
+  mColumns = cols;
+  mPendingPoints.clear();
+  mBands.clear();
+  mBands.resize( ( rows + BAND_ROWS - 1 ) / BAND_ROWS );
+
   return Success;
 }
 
@@ -157,59 +174,153 @@ QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::addFeature( const
     }
 
     // calculate the pixel position
-    const unsigned int xPosition = ( ( ( *pointIt ).x() - mBounds.xMinimum() ) / mPixelSize ) - buffer;
-    const unsigned int yPosition = ( ( ( *pointIt ).y() - mBounds.yMinimum() ) / mPixelSize ) - buffer;
-    const unsigned int yPositionIO = ( ( mBounds.yMaximum() - ( *pointIt ).y() ) / mPixelSize ) - buffer;
-
+    const double xPosition = ( ( ( *pointIt ).x() - mBounds.xMinimum() ) / mPixelSize ) - buffer;
+    const double yPosition = ( ( ( *pointIt ).y() - mBounds.yMinimum() ) / mPixelSize ) - buffer;
+    const double yPositionIO = ( ( mBounds.yMaximum() - ( *pointIt ).y() ) / mPixelSize ) - buffer;
 
-    // get the data
-    float *dataBuffer = ( float * ) CPLMalloc( sizeof( float ) * blockSize * blockSize );
-    if ( GDALRasterIO( mRasterBandH, GF_Read, xPosition, yPositionIO, blockSize, blockSize,
-                       dataBuffer, blockSize, blockSize, GDT_Float32, 0, 0 ) != CE_None )
+    // kernels which do not fit in the raster cannot be added
+    if ( xPosition <= -1 || yPositionIO <= -1
+         || static_cast< int >( xPosition ) + blockSize > mColumns || static_cast< int >( yPositionIO ) + blockSize > mRows )
     {
       result = RasterIoError;
+      continue;
     }
 
-    for ( int xp = 0; xp < blockSize; xp++ )
+    PendingPoint point;
+    point.x = ( *pointIt ).x();
+    point.y = ( *pointIt ).y();
+    point.radius = radius;
+    point.weight = weight;
+    point.buffer = buffer;
+    point.column = static_cast< int >( xPosition );
+    point.row = static_cast< int >( yPositionIO );
+    point.rowFromBottom = static_cast< int >( yPosition );
+    mPendingPoints.append( point );
+  }
+
+  if ( mPendingPoints.size() >= MAX_PENDING_POINTS )
+    addPendingPoints();
+
+  return result;
+}
+
+void QgsKernelDensityEstimation::addPendingPoints()
+{
+  if ( mPendingPoints.isEmpty() )
+    return;
+
+  // points whose kernels cover each band, in the order they were added so that the sums
+  // do not depend on the threads
+  QVector< QVector< int > > bandPoints( mBands.size() );
+  for ( int i = 0; i < mPendingPoints.size(); ++i )
+  {
+    const PendingPoint &point = mPendingPoints.at( i );
+    const int firstBand = point.row / BAND_ROWS;
+    const int lastBand = ( point.row + 2 * point.buffer ) / BAND_ROWS;
+    for ( int band = firstBand; band <= lastBand; ++band )
+      bandPoints[band].append( i );
+  }
+
+  QVector< int > bands;
+  QVector< float * > bandData( mBands.size(), nullptr );
+  for ( int band = 0; band < bandPoints.size(); ++band )
+  {
+    if ( bandPoints.at( band ).isEmpty() )
+      continue;
+
+    if ( mBands.at( band ).isEmpty() )
+    {
+      const int bandRows = std::min( BAND_ROWS, mRows - band * BAND_ROWS );
+      mBands[band] = QVector< float >( bandRows * mColumns, NO_DATA );
+    }
+    bandData[band] = mBands[band].data();
+    bands.append( band );
+  }
+
+  // each band is only written by one thread
+  const std::function< void( int ) > addToBand = [this, &bandPoints, &bandData]( int band )
+  {
+    addPendingPointsToBand( band, bandData.at( band ), bandPoints.at( band ) );
+  };
+  QtConcurrent::blockingMap( bands, addToBand );
+
+  mPendingPoints.clear();
+}
+
+void QgsKernelDensityEstimation::addPendingPointsToBand( int bandIndex, float *bandData, const QVector< int > &pointIndices ) const
+{
+  const int bandFirstRow = bandIndex * BAND_ROWS;
+  const int bandRows = std::min( BAND_ROWS, mRows - bandFirstRow );
+  const bool uniform = mShape == KernelUniform;
+
+  for ( const int pointIndex : pointIndices )
+  {
+    const PendingPoint &point = mPendingPoints.at( pointIndex );
+    const int blockSize = 2 * point.buffer + 1;
+
+    // the uniform kernel has the same value over the whole bandwidth
+    const double uniformValue = uniform ? point.weight * calculateKernelValue( 0, point.radius, mShape, mOutputValues ) : 0;
+
+    const int firstYp = std::max( 0, bandFirstRow - point.row );
+    const int lastYp = std::min( blockSize - 1, bandFirstRow + bandRows - 1 - point.row );
+    for ( int yp = firstYp; yp <= lastYp; yp++ )
     {
-      for ( int yp = 0; yp < blockSize; yp++ )
+      const double pixelCentroidY = ( point.rowFromBottom + yp + 0.5 ) * mPixelSize + mBounds.yMinimum();
+      const double dy = pixelCentroidY - point.y;
+      float *rowData = bandData + static_cast< qgssize >( point.row + yp - bandFirstRow ) * mColumns + point.column;
+
+      for ( int xp = 0; xp < blockSize; xp++ )
       {
-        const double pixelCentroidX = ( xPosition + xp + 0.5 ) * mPixelSize + mBounds.xMinimum();
-        const double pixelCentroidY = ( yPosition + yp + 0.5 ) * mPixelSize + mBounds.yMinimum();
+        const double pixelCentroidX = ( point.column + xp + 0.5 ) * mPixelSize + mBounds.xMinimum();
+        const double dx = pixelCentroidX - point.x;
 
-        const double distance = std::sqrt( std::pow( pixelCentroidX - ( *pointIt ).x(), 2.0 ) + std::pow( pixelCentroidY - ( *pointIt ).y(), 2.0 ) );
+        const double distance = std::sqrt( dx * dx + dy * dy );
 
         // is pixel outside search bandwidth of feature?
-        if ( distance > radius )
+        if ( distance > point.radius )
         {
           continue;
         }
 
-        const double pixelValue = weight * calculateKernelValue( distance, radius, mShape, mOutputValues );
-        const int pos = xp + blockSize * yp;
-        if ( dataBuffer[ pos ] == NO_DATA )
+        const double pixelValue = uniform ? uniformValue : point.weight * calculateKernelValue( distance, point.radius, mShape, mOutputValues );
+        if ( rowData[ xp ] == NO_DATA )
         {
-          dataBuffer[ pos ] = 0;
+          rowData[ xp ] = 0;
         }
-        dataBuffer[ pos ] += pixelValue;
+        rowData[ xp ] += pixelValue;
       }
     }
-    if ( GDALRasterIO( mRasterBandH, GF_Write, xPosition, yPositionIO, blockSize, blockSize,
-                       dataBuffer, blockSize, blockSize, GDT_Float32, 0, 0 ) != CE_None )
-    {
-      result = RasterIoError;
-    }
-    CPLFree( dataBuffer );
   }
-
-  return result;
 }
 
 QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::finalise()
 {
+  Result result = Success;
+  if ( mRasterBandH )
+  {
+    addPendingPoints();
+
+    // write the bands in order, with the rows not covered by any kernel set to the no data value
+    const QVector< float > emptyBand( BAND_ROWS * mColumns, NO_DATA );
+    for ( int band = 0; band < mBands.size(); ++band )
+    {
+      const int bandRows = std::min( BAND_ROWS, mRows - band * BAND_ROWS );
+      const float *data = mBands.at( band ).isEmpty() ? emptyBand.constData() : mBands.at( band ).constData();
+      if ( GDALRasterIO( mRasterBandH, GF_Write, 0, band * BAND_ROWS, mColumns, bandRows,
+                         const_cast< float * >( data ), mColumns, bandRows, GDT_Float32, 0, 0 ) != CE_None )
+      {
+        result = RasterIoError;
+        break;
+      }
+      // release the memory of the band once written
+      mBands[band] = QVector< float >();
+    }
+  }
+
+  mBands.clear();
   mDatasetH.reset();
   mRasterBandH = nullptr;
-  return Success;
+  return result;
 }
 
 int QgsKernelDensityEstimation::radiusSizeInPixels( double radius ) const
@@ -243,21 +354,7 @@ bool QgsKernelDensityEstimation::createEmptyLayer( GDALDriverH driver, const Qgs
   if ( GDALSetRasterNoDataValue( poBand, NO_DATA ) != CE_None )
     return false;
 
-  float *line = static_cast< float * >( CPLMalloc( sizeof( float ) * columns ) );
-  for ( int i = 0; i < columns; i++ )
-  {
-    line[i] = NO_DATA;
-  }
-  // Write the empty raster
-  for ( int i = 0; i < rows ; i++ )
-  {
-    if ( GDALRasterIO( poBand, GF_Write, 0, i, columns, 1, line, columns, 1, GDT_Float32, 0, 0 ) != CE_None )
-    {
-      return false;
-    }
-  }
-
-  CPLFree( line );
+  // all the rows of the raster are written when the surface is finalised
   return true;
 }
 
@@ -19,6 +19,7 @@
 #include "qgsrectangle.h"
 #include "qgsogrutils.h"
 #include <QString>
+#include <QVector>
 
 // GDAL includes
 #include <gdal.h>
@@ -171,10 +172,43 @@ class ANALYSIS_EXPORT QgsKernelDensityEstimation
     gdal::dataset_unique_ptr mDatasetH;
     GDALRasterBandH mRasterBandH;
 
-    //! Creates a new raster layer and initializes it to the no data value
+    //! Creates a new raster layer, which is filled when the surface is finalised
     bool createEmptyLayer( GDALDriverH driver, const QgsRectangle &bounds, int rows, int columns ) const;
     int radiusSizeInPixels( double radius ) const;
 
+#ifndef SIP_RUN
+
+    //! Point waiting to be added to the surface
+    struct PendingPoint
+    {
+      double x = 0;
+      double y = 0;
+      double radius = 0;
+      double weight = 1;
+      //! kernel size around the point, in pixels
+      int buffer = 0;
+      //! raster column of the left of the kernel
+      int column = 0;
+      //! raster row of the top of the kernel
+      int row = 0;
+      //! row of the bottom of the kernel, counted from the bottom of the raster
+      int rowFromBottom = 0;
+    };
+
+    //! Adds the kernels of the pending points to the surface, processing bands of rows in parallel
+    void addPendingPoints();
+
+    //! Adds the kernels of the pending points at \a pointIndices to the values \a bandData of the band at \a bandIndex
+    void addPendingPointsToBand( int bandIndex, float *bandData, const QVector< int > &pointIndices ) const;
+
+    int mRows = 0;
+    int mColumns = 0;
+    QVector< PendingPoint > mPendingPoints;
+    //! values of each band of rows of the raster, allocated when a kernel first covers the band
+    QVector< QVector< float > > mBands;
+
+#endif
+
 #ifdef SIP_RUN
     QgsKernelDensityEstimation( const QgsKernelDensityEstimation &other );
 #endif
@@ -31,8 +31,14 @@
 #include <QFile>
 #include <QDebug>
 #include <QFileInfo>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
 #include <iterator>
+#include <vector>
 
+//! Number of rows of the bands processed by each thread
+constexpr int NINE_CELL_BAND_ROWS = 16;
 
 
 QgsNineCellFilter::QgsNineCellFilter( const QString &inputFile, const QString &outputFile, const QString &outputFormat )
@@ -402,16 +408,18 @@ int QgsNineCellFilter::processRasterCPU( QgsFeedback *feedback )
     return 6;
   }
 
-  //keep only three scanlines in memory at a time, make room for initial and final nodata
-  const std::size_t bufferSize( sizeof( float ) * ( xSize + 2 ) );
-  float *scanLine1 = ( float * ) CPLMalloc( bufferSize );
-  float *scanLine2 = ( float * ) CPLMalloc( bufferSize );
-  float *scanLine3 = ( float * ) CPLMalloc( bufferSize );
+  // the rows are calculated by chunks of bands of rows, each band being processed by a thread
+  QThreadPool threadPool;
+  threadPool.setMaxThreadCount( std::max( 1, QThreadPool::globalInstance()->maxThreadCount() ) );
+  const int chunkRows = std::min( ySize, NINE_CELL_BAND_ROWS * threadPool.maxThreadCount() );
 
-  float *resultLine = ( float * ) CPLMalloc( sizeof( float ) * xSize );
+  //keep the scanlines of a chunk and the rows above and below it in memory, make room for initial and final nodata
+  const std::size_t lineSize = static_cast< std::size_t >( xSize ) + 2;
+  std::vector< float > scanLines( lineSize * ( chunkRows + 2 ) );
+  std::vector< float > resultLines( static_cast< std::size_t >( xSize ) * chunkRows );
 
   //values outside the layer extent (if the 3x3 window is on the border) are sent to the processing method as (input) nodata values
-  for ( int yIndex = 0; yIndex < ySize; ++yIndex )
+  for ( int chunkStart = 0; chunkStart < ySize; chunkStart += chunkRows )
   {
     if ( feedback && feedback->isCanceled() )
     {
@@ -420,74 +428,83 @@ int QgsNineCellFilter::processRasterCPU( QgsFeedback *feedback )
 
     if ( feedback )
     {
-      feedback->setProgress( 100.0 * static_cast< double >( yIndex ) / ySize );
+      feedback->setProgress( 100.0 * static_cast< double >( chunkStart ) / ySize );
     }
 
-    if ( yIndex == 0 )
+    const int rows = std::min( chunkRows, ySize - chunkStart );
+
+    // scanline i holds the row chunkStart - 1 + i, the rows above the first row and below the last row are filled with nodata
+    const int firstRow = std::max( chunkStart - 1, 0 );
+    const int lastRow = std::min( chunkStart + rows, ySize - 1 );
+    if ( chunkStart == 0 )
     {
-      //fill scanline 1 with (input) nodata for the values above the first row and feed scanline2 with the first row
-      for ( int a = 0; a < xSize + 2 ; ++a )
-      {
-        scanLine1[a] = mInputNodataValue;
-      }
-      // Read scanline2
-      if ( GDALRasterIO( rasterBand, GF_Read, 0, 0, xSize, 1, &scanLine2[1], xSize, 1, GDT_Float32, 0, 0 ) != CE_None )
-      {
-        QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
-      }
+      std::fill( scanLines.begin(), scanLines.begin() + lineSize, mInputNodataValue );
     }
-    else
+    if ( chunkStart + rows == ySize )
     {
-      //normally fetch only scanLine3 and release scanline 1 if we move forward one row
-      CPLFree( scanLine1 );
-      scanLine1 = scanLine2;
-      scanLine2 = scanLine3;
-      scanLine3 = ( float * ) CPLMalloc( bufferSize );
+      std::fill( scanLines.begin() + lineSize * ( rows + 1 ), scanLines.begin() + lineSize * ( rows + 2 ), mInputNodataValue );
     }
-
-    // Read scanline 3
-    if ( yIndex == ySize - 1 ) //fill the row below the bottom with nodata values
+    float *firstScanLine = &scanLines[ lineSize * ( firstRow - chunkStart + 1 ) ];
+    if ( GDALRasterIO( rasterBand, GF_Read, 0, firstRow, xSize, lastRow - firstRow + 1, &firstScanLine[1], xSize, lastRow - firstRow + 1,
+                       GDT_Float32, 0, static_cast< GSpacing >( lineSize * sizeof( float ) ) ) != CE_None )
     {
-      for ( int a = 0; a < xSize + 2; ++a )
-      {
-        scanLine3[a] = mInputNodataValue;
-      }
+      QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
     }
-    else
+    // Set first and last extra columns to nodata
+    for ( int i = 0; i < rows + 2; ++i )
     {
-      if ( GDALRasterIO( rasterBand, GF_Read, 0, yIndex + 1, xSize, 1, &scanLine3[1], xSize, 1, GDT_Float32, 0, 0 ) != CE_None )
-      {
-        QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
-      }
+      scanLines[ lineSize * i ] = scanLines[ lineSize * i + xSize + 1 ] = mInputNodataValue;
     }
-    // Set first and last extra columns to nodata
-    scanLine1[0] = scanLine1[xSize + 1] = mInputNodataValue;
-    scanLine2[0] = scanLine2[xSize + 1] = mInputNodataValue;
-    scanLine3[0] = scanLine3[xSize + 1] = mInputNodataValue;
 
+    auto processBand = [this, &scanLines, &resultLines, lineSize, xSize, rows, feedback]( int bandStart )
+    {
+      const int bandEnd = std::min( bandStart + NINE_CELL_BAND_ROWS, rows );
+      for ( int row = bandStart; row < bandEnd; ++row )
+      {
+        if ( feedback && feedback->isCanceled() )
+        {
+          return;
+        }
 
+        float *scanLine1 = &scanLines[ lineSize * row ];
+        float *scanLine2 = scanLine1 + lineSize;
+        float *scanLine3 = scanLine2 + lineSize;
+        float *resultLine = &resultLines[ static_cast< std::size_t >( xSize ) * row ];
 
-    // j is the x axis index, skip 0 and last cell that have been filled with nodata
-    for ( int xIndex = 0; xIndex < xSize ; ++xIndex )
+        // j is the x axis index, skip 0 and last cell that have been filled with nodata
+        for ( int xIndex = 0; xIndex < xSize ; ++xIndex )
+        {
+          // cells(x, y) x11, x21, x31, x12, x22, x32, x13, x23, x33
+          resultLine[ xIndex ] = processNineCellWindow( &scanLine1[ xIndex ], &scanLine1[ xIndex + 1 ], &scanLine1[ xIndex + 2 ],
+                                 &scanLine2[ xIndex ], &scanLine2[ xIndex + 1 ], &scanLine2[ xIndex + 2 ],
+                                 &scanLine3[ xIndex ], &scanLine3[ xIndex + 1 ], &scanLine3[ xIndex + 2 ] );
+        }
+      }
+    };
+
+    QList< QFuture< void > > futures;
+    for ( int bandStart = NINE_CELL_BAND_ROWS; bandStart < rows; bandStart += NINE_CELL_BAND_ROWS )
+    {
+      futures << QtConcurrent::run( &threadPool, processBand, bandStart );
+    }
+    // the first band is processed by this thread
+    processBand( 0 );
+    for ( QFuture< void > &future : futures )
     {
-      // cells(x, y) x11, x21, x31, x12, x22, x32, x13, x23, x33
-      resultLine[ xIndex ] = processNineCellWindow( &scanLine1[ xIndex ], &scanLine1[ xIndex + 1 ], &scanLine1[ xIndex + 2 ],
-                             &scanLine2[ xIndex ], &scanLine2[ xIndex + 1 ], &scanLine2[ xIndex + 2 ],
-                             &scanLine3[ xIndex ], &scanLine3[ xIndex + 1 ], &scanLine3[ xIndex + 2 ] );
+      future.waitForFinished();
+    }
 
+    if ( feedback && feedback->isCanceled() )
+    {
+      break;
     }
 
-    if ( GDALRasterIO( outputRasterBand, GF_Write, 0, yIndex, xSize, 1, resultLine, xSize, 1, GDT_Float32, 0, 0 ) != CE_None )
+    if ( GDALRasterIO( outputRasterBand, GF_Write, 0, chunkStart, xSize, rows, resultLines.data(), xSize, rows, GDT_Float32, 0, 0 ) != CE_None )
     {
       QgsDebugMsg( QStringLiteral( "Raster IO Error" ) );
     }
   }
 
-  CPLFree( resultLine );
-  CPLFree( scanLine1 );
-  CPLFree( scanLine2 );
-  CPLFree( scanLine3 );
-
   if ( feedback && feedback->isCanceled() )
   {
     //delete the dataset without closing (because it is faster)
@@ -68,6 +68,9 @@ class ANALYSIS_EXPORT QgsNineCellFilter
      *
      * First index of the input cell is the row, second index is the column
      *
+     * \note Since QGIS 3.30 this method is called concurrently by several threads, it must not
+     * modify the state of the filter.
+     *
      * \param x11 surrounding cell top left
      * \param x21 surrounding cell central left
      * \param x31 surrounding cell bottom left
@@ -15,6 +15,7 @@
 #include "qgsrastercalcnode.h"
 #include "qgsrasterblock.h"
 #include "qgsrastermatrix.h"
+#include <algorithm>
 
 QgsRasterCalcNode::QgsRasterCalcNode( double number )
   : mNumber( number )
@@ -197,10 +198,12 @@ bool QgsRasterCalcNode::calculate( QMap<QString, QgsRasterBlock * > &rasterData,
   }
   else if ( mType == tNumber )
   {
-    const size_t nEntries = static_cast<size_t>( result.nColumns() * result.nRows() );
+    // the result may cover several rows when a whole block is calculated at once
+    const int nRows = std::max( result.nRows(), 1 );
+    const size_t nEntries = static_cast<size_t>( result.nColumns() ) * static_cast<size_t>( nRows );
     double *data = new double[ nEntries ];
     std::fill( data, data + nEntries, mNumber );
-    result.setData( result.nColumns(), 1, data, result.nodataValue() );
+    result.setData( result.nColumns(), nRows, data, result.nodataValue() );
 
     return true;
   }
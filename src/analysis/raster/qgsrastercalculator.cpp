@@ -27,15 +27,40 @@
 #include "qgsproject.h"
 
 #include <QFile>
+#include <QMutex>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtConcurrent>
 
 #include <cpl_string.h>
 #include <gdalwarper.h>
 
+#include <atomic>
+#include <deque>
+
 #ifdef HAVE_OPENCL
 #include "qgsopenclutils.h"
 #include "qgsgdalutils.h"
 #endif
 
+///@cond PRIVATE
+
+//! Size of the blocks the output raster is calculated by, and of the tiles of GeoTIFF outputs
+constexpr int CALCULATION_TILE_SIZE = 512;
+
+//! Values of a block of the output raster, calculated by a worker thread
+struct CalculatedTile
+{
+  int xOffset = 0;
+  int yOffset = 0;
+  int width = 0;
+  int height = 0;
+  std::vector<float> data;
+  QgsRasterCalculator::Result result = QgsRasterCalculator::Success;
+  QString error;
+};
+
+///@endcond
 
 //
 // global callback function
@@ -194,98 +219,15 @@ QgsRasterCalculator::Result QgsRasterCalculator::processCalculation( QgsFeedback
   GDALSetRasterNoDataValue( outputRasterBand, outputNodataValue );
 
 
-  // Take the fast route (process one line at a time) if we can
+  // Take the fast route (process one block at a time) if we can
   if ( ! requiresMatrix )
   {
-    // Map of raster names -> blocks
-    std::map<QString, std::unique_ptr<QgsRasterBlock>> inputBlocks;
-    std::map<QString, QgsRasterCalculatorEntry> uniqueRasterEntries;
-    const QList<const QgsRasterCalcNode *> rasterRefNodes = calcNode->findNodes( QgsRasterCalcNode::Type::tRasterRef );
-    for ( const QgsRasterCalcNode *r : rasterRefNodes )
-    {
-      QString layerRef( r->toString().remove( 0, 1 ) );
-      layerRef.chop( 1 );
-      if ( ! inputBlocks.count( layerRef ) )
-      {
-        for ( const QgsRasterCalculatorEntry &ref : std::as_const( mRasterEntries ) )
-        {
-          if ( ref.ref == layerRef )
-          {
-            uniqueRasterEntries[layerRef] = ref;
-            inputBlocks[layerRef ] = std::make_unique<QgsRasterBlock>();
-          }
-        }
-      }
-    }
-
-    //read / write line by line
-    QMap<QString, QgsRasterBlock * > _rasterData;
-    // Cast to float
-    std::vector<float> castedResult( static_cast<size_t>( mNumOutputColumns ), 0 );
-    auto rowHeight = mOutputRectangle.height() / mNumOutputRows;
-    for ( size_t row = 0; row < static_cast<size_t>( mNumOutputRows ); ++row )
+    const Result result = processCalculationTiled( calcNode.get(), outputRasterBand, outputNodataValue, feedback );
+    if ( result != Success && result != Canceled )
     {
-      if ( feedback )
-      {
-        feedback->setProgress( 100.0 * static_cast< double >( row ) / mNumOutputRows );
-      }
-
-      if ( feedback && feedback->isCanceled() )
-      {
-        break;
-      }
-
-      // Calculates the rect for a single row read
-      QgsRectangle rect( mOutputRectangle );
-      rect.setYMaximum( rect.yMaximum() - rowHeight * row );
-      rect.setYMinimum( rect.yMaximum() - rowHeight );
-
-      // Read rows into input blocks
-      for ( auto &layerRef : inputBlocks )
-      {
-        QgsRasterCalculatorEntry ref = uniqueRasterEntries[layerRef.first];
-        if ( ref.raster->crs() != mOutputCrs )
-        {
-          QgsRasterProjector proj;
-          proj.setCrs( ref.raster->crs(), mOutputCrs, mTransformContext );
-          proj.setInput( ref.raster->dataProvider() );
-          proj.setPrecision( QgsRasterProjector::Exact );
-          layerRef.second.reset( proj.block( ref.bandNumber, rect, mNumOutputColumns, 1 ) );
-        }
-        else
-        {
-          layerRef.second.reset( ref.raster->dataProvider()->block( ref.bandNumber, rect, mNumOutputColumns, 1 ) );
-        }
-      }
-
-      // 1 row X mNumOutputColumns matrix
-      QgsRasterMatrix resultMatrix( mNumOutputColumns, 1, nullptr, outputNodataValue );
-
-      _rasterData.clear();
-      for ( const auto &layerRef : inputBlocks )
-      {
-        _rasterData.insert( layerRef.first, layerRef.second.get() );
-      }
-
-      if ( calcNode->calculate( _rasterData, resultMatrix, 0 ) )
-      {
-        std::copy( resultMatrix.data(), resultMatrix.data() + mNumOutputColumns, castedResult.begin() );
-        if ( GDALRasterIO( outputRasterBand, GF_Write, 0, row, mNumOutputColumns, 1, castedResult.data(), mNumOutputColumns, 1, GDT_Float32, 0, 0 ) != CE_None )
-        {
-          QgsDebugMsg( QStringLiteral( "RasterIO error!" ) );
-        }
-      }
-      else
-      {
-        //delete the dataset without closing (because it is faster)
-        gdal::fast_delete_and_close( outputDataset, outputDriver, mOutputFile );
-        return CalculationError;
-      }
-    }
-
-    if ( feedback )
-    {
-      feedback->setProgress( 100.0 );
+      //delete the dataset without closing (because it is faster)
+      gdal::fast_delete_and_close( outputDataset, outputDriver, mOutputFile );
+      return result;
     }
   }
   else  // Original code (memory inefficient route)
@@ -394,6 +336,179 @@ QgsRasterCalculator::Result QgsRasterCalculator::processCalculation( QgsFeedback
   return Success;
 }
 
+QgsRasterCalculator::Result QgsRasterCalculator::processCalculationTiled( const QgsRasterCalcNode *calcNode, GDALRasterBandH outputRasterBand, float outputNodataValue, QgsFeedback *feedback )
+{
+  std::map<QString, QgsRasterCalculatorEntry> uniqueRasterEntries;
+  const QList<const QgsRasterCalcNode *> rasterRefNodes = calcNode->findNodes( QgsRasterCalcNode::Type::tRasterRef );
+  for ( const QgsRasterCalcNode *r : rasterRefNodes )
+  {
+    QString layerRef( r->toString().remove( 0, 1 ) );
+    layerRef.chop( 1 );
+    if ( ! uniqueRasterEntries.count( layerRef ) )
+    {
+      for ( const QgsRasterCalculatorEntry &ref : std::as_const( mRasterEntries ) )
+      {
+        if ( ref.ref == layerRef )
+        {
+          uniqueRasterEntries[layerRef] = ref;
+        }
+      }
+    }
+  }
+
+  const int tileColumns = ( mNumOutputColumns + CALCULATION_TILE_SIZE - 1 ) / CALCULATION_TILE_SIZE;
+  const int tileRows = ( mNumOutputRows + CALCULATION_TILE_SIZE - 1 ) / CALCULATION_TILE_SIZE;
+  const int tileCount = tileColumns * tileRows;
+  const double columnWidth = mOutputRectangle.width() / mNumOutputColumns;
+  const double rowHeight = mOutputRectangle.height() / mNumOutputRows;
+
+  // a dedicated pool, so that the workers cannot be starved by the thread running the calculation
+  QThreadPool threadPool;
+  threadPool.setMaxThreadCount( std::max( 1, std::min( QThreadPool::globalInstance()->maxThreadCount(), tileCount ) ) );
+  const size_t maxCalculatedTiles = 2 * static_cast< size_t >( threadPool.maxThreadCount() );
+
+  std::atomic<int> nextTile( 0 );
+  std::atomic<bool> stopped( false );
+  QMutex mutex;
+  QWaitCondition tileCalculated;
+  QWaitCondition tileTaken;
+  std::deque<CalculatedTile> calculatedTiles;
+
+  auto calculateTiles = [&]()
+  {
+    // providers are not thread safe, each worker reads the input rasters through its own clones
+    std::map<QString, std::unique_ptr<QgsRasterDataProvider>> providers;
+    for ( const auto &entry : uniqueRasterEntries )
+    {
+      providers[entry.first].reset( entry.second.raster->dataProvider()->clone() );
+    }
+
+    std::map<QString, std::unique_ptr<QgsRasterBlock>> inputBlocks;
+    QMap<QString, QgsRasterBlock * > rasterData;
+    for ( int tileIndex = nextTile++; tileIndex < tileCount && !stopped; tileIndex = nextTile++ )
+    {
+      if ( feedback && feedback->isCanceled() )
+        break;
+
+      CalculatedTile tile;
+      tile.xOffset = ( tileIndex % tileColumns ) * CALCULATION_TILE_SIZE;
+      tile.yOffset = ( tileIndex / tileColumns ) * CALCULATION_TILE_SIZE;
+      tile.width = std::min( CALCULATION_TILE_SIZE, mNumOutputColumns - tile.xOffset );
+      tile.height = std::min( CALCULATION_TILE_SIZE, mNumOutputRows - tile.yOffset );
+
+      const QgsRectangle rect( mOutputRectangle.xMinimum() + columnWidth * tile.xOffset,
+                               mOutputRectangle.yMaximum() - rowHeight * ( tile.yOffset + tile.height ),
+                               mOutputRectangle.xMinimum() + columnWidth * ( tile.xOffset + tile.width ),
+                               mOutputRectangle.yMaximum() - rowHeight * tile.yOffset );
+
+      rasterData.clear();
+      for ( const auto &entry : uniqueRasterEntries )
+      {
+        QgsRasterDataProvider *provider = providers[entry.first].get();
+        std::unique_ptr<QgsRasterBlock> &block = inputBlocks[entry.first];
+        if ( entry.second.raster->crs() != mOutputCrs )
+        {
+          QgsRasterProjector proj;
+          proj.setCrs( entry.second.raster->crs(), mOutputCrs, mTransformContext );
+          proj.setInput( provider );
+          proj.setPrecision( QgsRasterProjector::Exact );
+          block.reset( proj.block( entry.second.bandNumber, rect, tile.width, tile.height ) );
+        }
+        else
+        {
+          block.reset( provider->block( entry.second.bandNumber, rect, tile.width, tile.height ) );
+        }
+        if ( !block || block->width() != tile.width || block->height() != tile.height )
+        {
+          tile.result = MemoryError;
+          tile.error = QObject::tr( "Could not allocate required memory for %1" ).arg( entry.first );
+          break;
+        }
+        rasterData.insert( entry.first, block.get() );
+      }
+
+      if ( tile.result == Success )
+      {
+        QgsRasterMatrix resultMatrix( tile.width, tile.height, nullptr, outputNodataValue );
+        if ( calcNode->calculate( rasterData, resultMatrix, -1 ) )
+        {
+          tile.data.resize( static_cast< size_t >( tile.width ) * tile.height );
+          if ( resultMatrix.isNumber() )
+            std::fill( tile.data.begin(), tile.data.end(), static_cast< float >( resultMatrix.number() ) );
+          else
+            std::copy( resultMatrix.data(), resultMatrix.data() + tile.data.size(), tile.data.begin() );
+        }
+        else
+        {
+          tile.result = CalculationError;
+        }
+      }
+
+      const bool failed = tile.result != Success;
+      QMutexLocker locker( &mutex );
+      while ( calculatedTiles.size() >= maxCalculatedTiles && !stopped )
+        tileTaken.wait( &mutex );
+      calculatedTiles.emplace_back( std::move( tile ) );
+      tileCalculated.wakeOne();
+      if ( failed )
+        break;
+    }
+  };
+
+  QList< QFuture< void > > futures;
+  for ( int i = 0; i < threadPool.maxThreadCount(); ++i )
+    futures << QtConcurrent::run( &threadPool, calculateTiles );
+
+  // the tiles are written by this thread, as GDAL datasets are not thread safe
+  Result result = Success;
+  for ( int writtenTiles = 0; writtenTiles < tileCount && result == Success; )
+  {
+    CalculatedTile tile;
+    {
+      QMutexLocker locker( &mutex );
+      while ( calculatedTiles.empty() && !( feedback && feedback->isCanceled() ) )
+        tileCalculated.wait( &mutex, 100 );
+      if ( calculatedTiles.empty() )
+      {
+        result = Canceled;
+        break;
+      }
+      tile = std::move( calculatedTiles.front() );
+      calculatedTiles.pop_front();
+      tileTaken.wakeOne();
+    }
+
+    if ( tile.result != Success )
+    {
+      result = tile.result;
+      if ( !tile.error.isEmpty() )
+        mLastError = tile.error;
+      break;
+    }
+
+    if ( GDALRasterIO( outputRasterBand, GF_Write, tile.xOffset, tile.yOffset, tile.width, tile.height, tile.data.data(), tile.width, tile.height, GDT_Float32, 0, 0 ) != CE_None )
+    {
+      QgsDebugMsg( QStringLiteral( "RasterIO error!" ) );
+    }
+
+    ++writtenTiles;
+    if ( feedback )
+    {
+      feedback->setProgress( 100.0 * static_cast< double >( writtenTiles ) / tileCount );
+    }
+  }
+
+  {
+    QMutexLocker locker( &mutex );
+    stopped = true;
+    tileTaken.wakeAll();
+  }
+  for ( QFuture< void > &future : futures )
+    future.waitForFinished();
+
+  return result;
+}
+
 #ifdef HAVE_OPENCL
 QgsRasterCalculator::Result QgsRasterCalculator::processCalculationGPU( std::unique_ptr< QgsRasterCalcNode > calcNode, QgsFeedback *feedback )
 {
@@ -708,7 +823,15 @@ gdal::dataset_unique_ptr QgsRasterCalculator::openOutputFile( GDALDriverH output
 {
   //open output file
   char **papszOptions = nullptr;
+  if ( mOutputFormat.compare( QLatin1String( "GTiff" ), Qt::CaseInsensitive ) == 0 && mNumOutputColumns > CALCULATION_TILE_SIZE && mNumOutputRows > CALCULATION_TILE_SIZE )
+  {
+    // tiles matching the blocks of the calculation, so that each block is written to whole tiles
+    papszOptions = CSLSetNameValue( papszOptions, "TILED", "YES" );
+    papszOptions = CSLSetNameValue( papszOptions, "BLOCKXSIZE", QByteArray::number( CALCULATION_TILE_SIZE ).constData() );
+    papszOptions = CSLSetNameValue( papszOptions, "BLOCKYSIZE", QByteArray::number( CALCULATION_TILE_SIZE ).constData() );
+  }
   gdal::dataset_unique_ptr outputDataset( GDALCreate( outputDriver, mOutputFile.toUtf8().constData(), mNumOutputColumns, mNumOutputRows, 1, GDT_Float32, papszOptions ) );
+  CSLDestroy( papszOptions );
   if ( !outputDataset )
   {
     return nullptr;
@@ -197,6 +197,14 @@ class ANALYSIS_EXPORT QgsRasterCalculator
     */
     void outputGeoTransform( double *transform ) const;
 
+    /**
+     * Executes the calculations on blocks of the output raster, calculated in parallel by
+     * a pool of threads, and writes them to the \a outputRasterBand.
+     *
+     * The \a calcNode must not contain any matrix node.
+     */
+    Result processCalculationTiled( const QgsRasterCalcNode *calcNode, GDALRasterBandH outputRasterBand, float outputNodataValue, QgsFeedback *feedback );
+
     //! Execute calculations on GPU
     Result processCalculationGPU( std::unique_ptr< QgsRasterCalcNode > calcNode, QgsFeedback *feedback = nullptr );
 
@@ -20,6 +20,73 @@
 #include <cmath>
 #include <algorithm>
 
+///@cond PRIVATE
+
+/**
+ * Calls \a apply with a function object computing the \a op operator, so that the loops over
+ * the matrix values are specialized for each operator, without any switch in their body,
+ * and can be vectorized by the compiler.
+ */
+template <typename Apply>
+static void applyTwoArgumentOperation( QgsRasterMatrix::TwoArgOperator op, double nodataValue, const Apply &apply )
+{
+  switch ( op )
+  {
+    case QgsRasterMatrix::opPLUS:
+      apply( []( double arg1, double arg2 ) { return arg1 + arg2; } );
+      break;
+    case QgsRasterMatrix::opMINUS:
+      apply( []( double arg1, double arg2 ) { return arg1 - arg2; } );
+      break;
+    case QgsRasterMatrix::opMUL:
+      apply( []( double arg1, double arg2 ) { return arg1 * arg2; } );
+      break;
+    case QgsRasterMatrix::opDIV:
+      apply( [nodataValue]( double arg1, double arg2 ) { return arg2 == 0 ? nodataValue : arg1 / arg2; } );
+      break;
+    case QgsRasterMatrix::opPOW:
+      apply( [nodataValue]( double arg1, double arg2 )
+      {
+        // same test as QgsRasterMatrix::testPowerValidity()
+        const bool valid = !( ( arg1 == 0 && arg2 < 0 ) || ( arg1 < 0 && ( arg2 - std::floor( arg2 ) ) > 0 ) );
+        return valid ? std::pow( arg1, arg2 ) : nodataValue;
+      } );
+      break;
+    case QgsRasterMatrix::opEQ:
+      apply( []( double arg1, double arg2 ) { return arg1 == arg2 ? 1.0 : 0.0; } );
+      break;
+    case QgsRasterMatrix::opNE:
+      apply( []( double arg1, double arg2 ) { return arg1 == arg2 ? 0.0 : 1.0; } );
+      break;
+    case QgsRasterMatrix::opGT:
+      apply( []( double arg1, double arg2 ) { return arg1 > arg2 ? 1.0 : 0.0; } );
+      break;
+    case QgsRasterMatrix::opLT:
+      apply( []( double arg1, double arg2 ) { return arg1 < arg2 ? 1.0 : 0.0; } );
+      break;
+    case QgsRasterMatrix::opGE:
+      apply( []( double arg1, double arg2 ) { return arg1 >= arg2 ? 1.0 : 0.0; } );
+      break;
+    case QgsRasterMatrix::opLE:
+      apply( []( double arg1, double arg2 ) { return arg1 <= arg2 ? 1.0 : 0.0; } );
+      break;
+    case QgsRasterMatrix::opAND:
+      apply( []( double arg1, double arg2 ) { return arg1 && arg2 ? 1.0 : 0.0; } );
+      break;
+    case QgsRasterMatrix::opOR:
+      apply( []( double arg1, double arg2 ) { return arg1 || arg2 ? 1.0 : 0.0; } );
+      break;
+    case QgsRasterMatrix::opMAX:
+      apply( []( double arg1, double arg2 ) { return std::max( arg1, arg2 ); } );
+      break;
+    case QgsRasterMatrix::opMIN:
+      apply( []( double arg1, double arg2 ) { return std::min( arg1, arg2 ); } );
+      break;
+  }
+}
+
+///@endcond
+
 QgsRasterMatrix::QgsRasterMatrix( int nCols, int nRows, double *data, double nodataValue )
   : mColumns( nCols )
   , mRows( nRows )
@@ -348,30 +415,28 @@ bool QgsRasterMatrix::twoArgumentOperation( TwoArgOperator op, const QgsRasterMa
   //two matrices
   if ( !isNumber() && !other.isNumber() )
   {
-    double *matrix = other.mData;
+    const double *matrix = other.mData;
     const int nEntries = mColumns * mRows;
-    double value1, value2;
+    const double nodata = mNodataValue;
+    const double otherNodata = other.mNodataValue;
+    double *data = mData;
 
-    for ( int i = 0; i < nEntries; ++i )
+    applyTwoArgumentOperation( op, nodata, [ = ]( auto operation )
     {
-      value1 = mData[i];
-      value2 = matrix[i];
-      if ( value1 == mNodataValue || value2 == other.mNodataValue )
-      {
-        mData[i] = mNodataValue;
-      }
-      else
+      for ( int i = 0; i < nEntries; ++i )
       {
-        mData[i] = calculateTwoArgumentOp( op, value1, value2 );
+        const double value1 = data[i];
+        const double value2 = matrix[i];
+        data[i] = ( value1 == nodata || value2 == otherNodata ) ? nodata : operation( value1, value2 );
       }
-    }
+    } );
     return true;
   }
 
   //this matrix is a single number and the other one a real matrix
   if ( isNumber() )
   {
-    double *matrix = other.mData;
+    const double *matrix = other.mData;
     const int nEntries = other.nColumns() * other.nRows();
     const double value = mData[0];
     delete[] mData;
@@ -382,23 +447,22 @@ bool QgsRasterMatrix::twoArgumentOperation( TwoArgOperator op, const QgsRasterMa
 
     if ( value == mNodataValue )
     {
-      for ( int i = 0; i < nEntries; ++i )
-      {
-        mData[i] = mNodataValue;
-      }
+      std::fill( mData, mData + nEntries, mNodataValue );
       return true;
     }
 
-    for ( int i = 0; i < nEntries; ++i )
+    const double nodata = mNodataValue;
+    const double otherNodata = other.mNodataValue;
+    double *data = mData;
+
+    applyTwoArgumentOperation( op, nodata, [ = ]( auto operation )
     {
-      if ( matrix[i] == other.mNodataValue )
+      for ( int i = 0; i < nEntries; ++i )
       {
-        mData[i] = mNodataValue;
-        continue;
+        const double value2 = matrix[i];
+        data[i] = value2 == otherNodata ? nodata : operation( value, value2 );
       }
-
-      mData[i] = calculateTwoArgumentOp( op, value, matrix[i] );
-    }
+    } );
     return true;
   }
   else //this matrix is a real matrix and the other a number
@@ -408,22 +472,21 @@ bool QgsRasterMatrix::twoArgumentOperation( TwoArgOperator op, const QgsRasterMa
 
     if ( other.number() == other.mNodataValue )
     {
-      for ( int i = 0; i < nEntries; ++i )
-      {
-        mData[i] = mNodataValue;
-      }
+      std::fill( mData, mData + nEntries, mNodataValue );
       return true;
     }
 
-    for ( int i = 0; i < nEntries; ++i )
+    const double nodata = mNodataValue;
+    double *data = mData;
+
+    applyTwoArgumentOperation( op, nodata, [ = ]( auto operation )
     {
-      if ( mData[i] == mNodataValue )
+      for ( int i = 0; i < nEntries; ++i )
       {
-        continue;
+        const double value1 = data[i];
+        data[i] = value1 == nodata ? nodata : operation( value1, value );
       }
-
-      mData[i] = calculateTwoArgumentOp( op, mData[i], value );
-    }
+    } );
     return true;
   }
 }
@@ -29,8 +29,7 @@
 
 
 QgsFeaturePool::QgsFeaturePool( QgsVectorLayer *layer )
-  : mFeatureCache( CACHE_SIZE )
-  , mLayer( layer )
+  : mLayer( layer )
   , mGeometryType( layer->geometryType() )
   , mFeatureSource( std::make_unique<QgsVectorLayerFeatureSource>( layer ) )
   , mLayerName( layer->name() )
@@ -38,35 +37,44 @@ QgsFeaturePool::QgsFeaturePool( QgsVectorLayer *layer )
 
 }
 
+QgsFeaturePool::CacheShard &QgsFeaturePool::cacheShard( QgsFeatureId id ) const
+{
+  return mCacheShards[ static_cast< quint64 >( id ) % CACHE_SHARD_COUNT ];
+}
+
 bool QgsFeaturePool::getFeature( QgsFeatureId id, QgsFeature &feature )
 {
-  // Why is there a write lock acquired here? Weird, we only want to read a feature from the cache, right?
-  // A method like `QCache::object(const Key &key) const` certainly would not modify its internals.
-  // Mmmh. What if reality was different?
-  // If one reads the docs very, very carefully one will find the term "reentrant" in the
-  // small print of the QCache docs. This is the hint that reality is different.
+  // QCache::object() is not const, it moves the object to the front of the cache, so even reading
+  // from the cache needs an exclusive lock. It only locks the part of the cache storing this
+  // feature, and the lock is released before reading the feature from the source.
   //
   // https://bugreports.qt.io/browse/QTBUG-19794
-
-  QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Write );
-  QgsFeature *cachedFeature = mFeatureCache.object( id );
-  if ( cachedFeature )
+  CacheShard &shard = cacheShard( id );
   {
-    //feature was cached
-    feature = *cachedFeature;
-  }
-  else
-  {
-    // Feature not in cache, retrieve from layer
-    // TODO: avoid always querying all attributes (attribute values are needed when merging by attribute)
-    if ( !mFeatureSource->getFeatures( QgsFeatureRequest( id ) ).nextFeature( feature ) )
+    const QMutexLocker shardLocker( &shard.mutex );
+    if ( const QgsFeature *cachedFeature = shard.features.object( id ) )
     {
-      return false;
+      //feature was cached
+      feature = *cachedFeature;
+      return true;
     }
-    locker.changeMode( QgsReadWriteLocker::Write );
-    mFeatureCache.insert( id, new QgsFeature( feature ) );
-    mIndex.addFeature( feature );
   }
+
+  // Feature not in cache, retrieve from layer
+  // TODO: avoid always querying all attributes (attribute values are needed when merging by attribute)
+  QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Read );
+  if ( !mFeatureSource->getFeatures( QgsFeatureRequest( id ) ).nextFeature( feature ) )
+  {
+    return false;
+  }
+  locker.changeMode( QgsReadWriteLocker::Write );
+  mIndex.addFeature( feature );
+  if ( feature.hasGeometry() )
+    mExtent.combineExtentWith( feature.geometry().boundingBox() );
+  locker.unlock();
+
+  const QMutexLocker shardLocker( &shard.mutex );
+  shard.features.insert( id, new QgsFeature( feature ) );
   return true;
 }
 
@@ -76,8 +84,13 @@ QgsFeatureIds QgsFeaturePool::getFeatures( const QgsFeatureRequest &request, Qgs
   Q_UNUSED( feedback )
   Q_ASSERT( QThread::currentThread() == qApp->thread() );
 
-  mFeatureCache.clear();
+  for ( CacheShard &shard : mCacheShards )
+  {
+    const QMutexLocker shardLocker( &shard.mutex );
+    shard.features.clear();
+  }
   mIndex = QgsSpatialIndex();
+  mExtent = QgsRectangle();
 
   QgsFeatureIds fids;
 
@@ -94,6 +107,50 @@ QgsFeatureIds QgsFeaturePool::getFeatures( const QgsFeatureRequest &request, Qgs
   return fids;
 }
 
+int QgsFeaturePool::prefetchFeatures( const QgsRectangle &rect, QgsFeedback *feedback )
+{
+  const QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Read );
+
+  // only cache features of the spatial index, which does not contain the features removed from the pool
+  const QgsFeatureIds poolIds = qgis::listToSet( mIndex.intersects( rect ) );
+  QgsFeatureIds missingIds;
+  for ( const QgsFeatureId id : poolIds )
+  {
+    if ( !isFeatureCached( id ) )
+      missingIds.insert( id );
+  }
+  if ( missingIds.isEmpty() )
+    return 0;
+
+  // cutting the request short of the cache size avoids evicting the first features prefetched
+  const int maxFeatures = CACHE_SIZE * CACHE_SHARD_COUNT;
+  QgsFeatureRequest request;
+  request.setFilterRect( rect );
+  request.setLimit( maxFeatures );
+  if ( missingIds.size() < poolIds.size() )
+    request.setFilterFids( missingIds );
+
+  int count = 0;
+  QgsFeatureIterator it = mFeatureSource->getFeatures( request );
+  QgsFeature feature;
+  while ( it.nextFeature( feature ) )
+  {
+    if ( feedback && feedback->isCanceled() )
+      break;
+    if ( !missingIds.contains( feature.id() ) )
+      continue;
+
+    CacheShard &shard = cacheShard( feature.id() );
+    const QMutexLocker shardLocker( &shard.mutex );
+    if ( !shard.features.contains( feature.id() ) )
+    {
+      shard.features.insert( feature.id(), new QgsFeature( feature ) );
+      ++count;
+    }
+  }
+  return count;
+}
+
 QgsFeatureIds QgsFeaturePool::allFeatureIds() const
 {
   return mFeatureIds;
@@ -106,6 +163,12 @@ QgsFeatureIds QgsFeaturePool::getIntersects( const QgsRectangle &rect ) const
   return ids;
 }
 
+QgsRectangle QgsFeaturePool::extent() const
+{
+  const QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Read );
+  return mExtent;
+}
+
 QgsVectorLayer *QgsFeaturePool::layer() const
 {
   Q_ASSERT( QThread::currentThread() == qApp->thread() );
@@ -123,15 +186,24 @@ void QgsFeaturePool::insertFeature( const QgsFeature &feature, bool skipLock )
   QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Unlocked );
   if ( !skipLock )
     locker.changeMode( QgsReadWriteLocker::Write );
-  mFeatureCache.insert( feature.id(), new QgsFeature( feature ) );
   QgsFeature indexFeature( feature );
   mIndex.addFeature( indexFeature );
+  if ( feature.hasGeometry() )
+    mExtent.combineExtentWith( feature.geometry().boundingBox() );
+
+  CacheShard &shard = cacheShard( feature.id() );
+  const QMutexLocker shardLocker( &shard.mutex );
+  shard.features.insert( feature.id(), new QgsFeature( feature ) );
 }
 
 void QgsFeaturePool::refreshCache( const QgsFeature &feature )
 {
   QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Write );
-  mFeatureCache.remove( feature.id() );
+  {
+    CacheShard &shard = cacheShard( feature.id() );
+    const QMutexLocker shardLocker( &shard.mutex );
+    shard.features.remove( feature.id() );
+  }
   mIndex.deleteFeature( feature );
   locker.unlock();
 
@@ -148,8 +220,9 @@ void QgsFeaturePool::removeFeature( const QgsFeatureId featureId )
     locker.changeMode( QgsReadWriteLocker::Write );
     mIndex.deleteFeature( origFeature );
   }
-  locker.changeMode( QgsReadWriteLocker::Write );
-  mFeatureCache.remove( origFeature.id() );
+  CacheShard &shard = cacheShard( origFeature.id() );
+  const QMutexLocker shardLocker( &shard.mutex );
+  shard.features.remove( origFeature.id() );
 }
 
 void QgsFeaturePool::setFeatureIds( const QgsFeatureIds &ids )
@@ -159,8 +232,9 @@ void QgsFeaturePool::setFeatureIds( const QgsFeatureIds &ids )
 
 bool QgsFeaturePool::isFeatureCached( QgsFeatureId fid )
 {
-  const QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Read );
-  return mFeatureCache.contains( fid );
+  CacheShard &shard = cacheShard( fid );
+  const QMutexLocker shardLocker( &shard.mutex );
+  return shard.features.contains( fid );
 }
 
 QString QgsFeaturePool::layerName() const
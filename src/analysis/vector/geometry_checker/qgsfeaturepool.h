@@ -31,6 +31,10 @@
  * \ingroup analysis
  * \brief A feature pool is based on a vector layer and caches features.
  *
+ * The feature pool can be read from several threads at once: the cache is split into parts with
+ * their own lock, and features missing from the cache are read from the source without blocking
+ * the other readers.
+ *
  * \note This class is a technology preview and unstable API.
  * \since QGIS 3.4
  */
@@ -64,6 +68,22 @@ class ANALYSIS_EXPORT QgsFeaturePool : public QgsFeatureSink SIP_ABSTRACT
      */
     QgsFeatureIds getFeatures( const QgsFeatureRequest &request, QgsFeedback *feedback = nullptr ) SIP_SKIP;
 
+    /**
+     * Reads all the features of the pool intersecting the bounding box \a rect into the cache
+     * with a single request to the feature source, instead of reading the missing features one by one
+     * in getFeature().
+     *
+     * Unlike getFeatures(), this can be called from any thread while other threads read the pool.
+     * Only as many features as the cache can hold are kept.
+     * If \a feedback is specified, the call may return if the feedback is canceled.
+     *
+     * \returns the number of features added to the cache
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    int prefetchFeatures( const QgsRectangle &rect, QgsFeedback *feedback = nullptr ) SIP_SKIP;
+
     /**
      * Updates a feature in this pool.
      * Implementations will update the feature on the layer or on the data provider.
@@ -92,6 +112,17 @@ class ANALYSIS_EXPORT QgsFeaturePool : public QgsFeatureSink SIP_ABSTRACT
      */
     QgsFeatureIds getIntersects( const QgsRectangle &rect ) const SIP_SKIP;
 
+    /**
+     * Returns the extent of the features added to the pool.
+     *
+     * The extent is not reduced when features are removed, so it may be larger than the extent of the
+     * features currently in the pool.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    QgsRectangle extent() const SIP_SKIP;
+
     /**
      * Gets a pointer to the underlying layer.
      * May return a ``NULLPTR`` if the layer has been deleted.
@@ -176,10 +207,32 @@ class ANALYSIS_EXPORT QgsFeaturePool : public QgsFeatureSink SIP_ABSTRACT
     {}
 #endif
 
+#ifndef SIP_RUN
+    //! Maximum number of features in each part of the cache
     static const int CACHE_SIZE = 1000;
-    QCache<QgsFeatureId, QgsFeature> mFeatureCache;
+    //! Number of parts of the cache
+    static const int CACHE_SHARD_COUNT = 16;
+
+    //! Part of the feature cache, locked independently of the other parts
+    struct CacheShard
+    {
+      CacheShard()
+        : features( CACHE_SIZE )
+      {}
+
+      QCache<QgsFeatureId, QgsFeature> features;
+      QMutex mutex;
+    };
+
+    //! Returns the part of the cache storing the feature \a id
+    CacheShard &cacheShard( QgsFeatureId id ) const;
+
+    mutable CacheShard mCacheShards[CACHE_SHARD_COUNT];
+#endif
     QPointer<QgsVectorLayer> mLayer;
+    //! protects the spatial index, the extent and the feature source
     mutable QReadWriteLock mCacheLock;
+    QgsRectangle mExtent;
     QgsFeatureIds mFeatureIds;
     QgsSpatialIndex mIndex;
     QgsWkbTypes::GeometryType mGeometryType;
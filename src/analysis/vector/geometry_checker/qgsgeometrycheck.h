@@ -163,7 +163,8 @@ class ANALYSIS_EXPORT QgsGeometryCheck
      */
     enum Flag
     {
-      AvailableInValidation = 1 << 1 //!< This geometry check should be available in layer validation on the vector layer peroperties
+      AvailableInValidation = 1 << 1, //!< This geometry check should be available in layer validation on the vector layer peroperties
+      PartitionableByFeatures = 1 << 2, //!< The errors of this geometry check can be collected independently for subsets of the features, e.g. from several threads (since QGIS 3.30)
     };
     Q_DECLARE_FLAGS( Flags, Flag )
     Q_FLAG( Flags )
@@ -20,6 +20,9 @@
 #include <QTimer>
 #include <QTextStream>
 
+#include <cmath>
+#include <limits>
+
 #include "qgsgeometrycheckcontext.h"
 #include "qgsgeometrychecker.h"
 #include "qgsgeometrycheck.h"
@@ -27,6 +30,7 @@
 #include "qgsproject.h"
 #include "qgsvectorlayer.h"
 #include "qgsgeometrycheckerror.h"
+#include "qgssinglegeometrycheck.h"
 
 
 
@@ -281,12 +285,127 @@ bool QgsGeometryChecker::fixError( QgsGeometryCheckError *error, int method, boo
   return true;
 }
 
+///@cond PRIVATE
+
+//! Number of features of the spatial tiles a check is split into
+static constexpr int FEATURES_PER_TILE = 1000;
+
+//! Spatial tile of the features to check
+struct FeatureTile
+{
+  //! extent of the tile, or a null rectangle for features outside of all tiles
+  QgsRectangle extent;
+  QMap<QString, QgsFeatureIds> ids;
+};
+
+//! Errors and messages collected by a check for a tile of the features
+struct TileErrors
+{
+  QList<QgsGeometryCheckError *> errors;
+  QStringList messages;
+};
+
+/**
+ * Splits the features of the pools into spatial tiles of about FEATURES_PER_TILE features,
+ * each feature being assigned to a single tile. Every returned map contains all the layers.
+ */
+static QList< FeatureTile > spatialTiles( const QMap<QString, QgsFeaturePool *> &featurePools )
+{
+  QgsRectangle extent;
+  int featureCount = 0;
+  for ( const QgsFeaturePool *pool : featurePools )
+  {
+    extent.combineExtentWith( pool->extent() );
+    featureCount += pool->allFeatureIds().count();
+  }
+
+  const int tileCount = std::max( 1, static_cast< int >( std::ceil( std::sqrt( featureCount / static_cast< double >( FEATURES_PER_TILE ) ) ) ) );
+  QList< FeatureTile > tiles;
+  if ( tileCount == 1 || extent.isEmpty() )
+    return tiles;
+
+  QMap<QString, QgsFeatureIds> remainingIds;
+  for ( const QgsFeaturePool *pool : featurePools )
+    remainingIds.insert( pool->layerId(), pool->allFeatureIds() );
+
+  const double tileWidth = extent.width() / tileCount;
+  const double tileHeight = extent.height() / tileCount;
+  for ( int row = 0; row < tileCount; ++row )
+  {
+    for ( int col = 0; col < tileCount; ++col )
+    {
+      // extend the last row and column, the extent of the pools may be slightly smaller than the union of their features
+      const QgsRectangle tile( extent.xMinimum() + col * tileWidth,
+                               extent.yMinimum() + row * tileHeight,
+                               col == tileCount - 1 ? std::numeric_limits<double>::max() : extent.xMinimum() + ( col + 1 ) * tileWidth,
+                               row == tileCount - 1 ? std::numeric_limits<double>::max() : extent.yMinimum() + ( row + 1 ) * tileHeight );
+      QMap<QString, QgsFeatureIds> tileIds;
+      bool tileEmpty = true;
+      for ( const QgsFeaturePool *pool : featurePools )
+      {
+        QgsFeatureIds &remaining = remainingIds[pool->layerId()];
+        QgsFeatureIds ids = pool->getIntersects( tile ).intersect( remaining );
+        remaining.subtract( ids );
+        tileEmpty &= ids.isEmpty();
+        tileIds.insert( pool->layerId(), ids );
+      }
+      if ( !tileEmpty )
+        tiles << FeatureTile{ tile, tileIds };
+    }
+  }
+
+  // features without geometry, or missing from the spatial index
+  bool remainingEmpty = true;
+  for ( const QgsFeatureIds &ids : std::as_const( remainingIds ) )
+    remainingEmpty &= ids.isEmpty();
+  if ( !remainingEmpty )
+    tiles << FeatureTile{ QgsRectangle(), remainingIds };
+
+  return tiles;
+}
+
+///@endcond PRIVATE
+
 void QgsGeometryChecker::runCheck( const QMap<QString, QgsFeaturePool *> &featurePools, const QgsGeometryCheck *check )
 {
   // Run checks
   QList<QgsGeometryCheckError *> errors;
   QStringList messages;
-  check->collectErrors( featurePools, errors, messages, &mFeedback );
+
+  // Checks considering each feature independently from the others are split into spatial tiles run in parallel
+  QList< FeatureTile > tiles;
+  if ( check->flags() & QgsGeometryCheck::PartitionableByFeatures || dynamic_cast< const QgsSingleGeometryCheck * >( check ) )
+    tiles = spatialTiles( featurePools );
+
+  if ( tiles.size() > 1 )
+  {
+    const std::function< TileErrors( const FeatureTile & ) > collectTileErrors = [this, &featurePools, check]( const FeatureTile &tile )
+    {
+      TileErrors result;
+      if ( mFeedback.isCanceled() )
+        return result;
+
+      // read the features of the tile at once, the check then mostly finds them in the cache
+      if ( !tile.extent.isNull() )
+      {
+        for ( QgsFeaturePool *pool : featurePools )
+          pool->prefetchFeatures( tile.extent, &mFeedback );
+      }
+      check->collectErrors( featurePools, result.errors, result.messages, &mFeedback, QgsGeometryCheck::LayerFeatureIds( tile.ids ) );
+      return result;
+    };
+    const QList< TileErrors > results = QtConcurrent::blockingMapped< QList< TileErrors > >( tiles, collectTileErrors );
+    for ( const TileErrors &result : results )
+    {
+      errors.append( result.errors );
+      messages.append( result.messages );
+    }
+  }
+  else
+  {
+    check->collectErrors( featurePools, errors, messages, &mFeedback );
+  }
+
   mErrorListMutex.lock();
   mCheckErrors.append( errors );
   mMessages.append( messages );
@@ -76,6 +76,7 @@ class ANALYSIS_EXPORT QgsGeometryDuplicateCheck : public QgsGeometryCheck
     QString description() const override { return factoryDescription(); }
     QString id() const override { return factoryId(); }
     QgsGeometryCheck::CheckType checkType() const override { return factoryCheckType(); }
+    QgsGeometryCheck::Flags flags() const override { return factoryFlags(); }
 
     static QList<QgsWkbTypes::GeometryType> factoryCompatibleGeometryTypes() {return {QgsWkbTypes::PointGeometry, QgsWkbTypes::LineGeometry, QgsWkbTypes::PolygonGeometry}; }
     static bool factoryIsCompatible( QgsVectorLayer *layer ) SIP_SKIP { return factoryCompatibleGeometryTypes().contains( layer->geometryType() ); }
@@ -83,6 +84,13 @@ class ANALYSIS_EXPORT QgsGeometryDuplicateCheck : public QgsGeometryCheck
     static QString factoryId();
     static QgsGeometryCheck::CheckType factoryCheckType();
 
+    /**
+     * Returns the flags of the duplicate check.
+     *
+     * \since QGIS 3.30
+     */
+    static QgsGeometryCheck::Flags factoryFlags() SIP_SKIP { return QgsGeometryCheck::PartitionableByFeatures; }
+
     enum ResolutionMethod { NoChange, RemoveDuplicates };
 };
 
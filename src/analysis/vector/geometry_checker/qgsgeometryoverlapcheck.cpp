@@ -250,7 +250,7 @@ QString QgsGeometryOverlapCheck::factoryId()
 
 QgsGeometryCheck::Flags QgsGeometryOverlapCheck::factoryFlags()
 {
-  return QgsGeometryCheck::AvailableInValidation;
+  return QgsGeometryCheck::AvailableInValidation | QgsGeometryCheck::PartitionableByFeatures;
 }
 
 QList<QgsWkbTypes::GeometryType> QgsGeometryOverlapCheck::factoryCompatibleGeometryTypes()
@@ -29,6 +29,12 @@
 #include "qgsproject.h"
 
 #include <QFile>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <numeric>
+
+//! Number of polygons whose statistics are computed together in parallel
+static constexpr int FEATURES_PER_BATCH = 1024;
 
 QgsZonalStatistics::QgsZonalStatistics( QgsVectorLayer *polygonLayer, QgsRasterLayer *rasterLayer, const QString &attributePrefix, int rasterBand, QgsZonalStatistics::Statistics stats )
   : QgsZonalStatistics( polygonLayer,
@@ -121,35 +127,91 @@ QgsZonalStatistics::Result QgsZonalStatistics::calculateStatistics( QgsFeedback
 
   int featureCounter = 0;
 
+  // the statistics of a batch of polygons are computed in parallel, each thread reading the
+  // raster through its own clone of the raster interface
+  std::vector< std::unique_ptr< QgsRasterInterface > > threadInterfaces;
+  const int threadCount = QThread::idealThreadCount();
+  for ( int i = 0; threadCount > 1 && i < threadCount; ++i )
+  {
+    std::unique_ptr< QgsRasterInterface > clone( mRasterInterface->clone() );
+    if ( !clone )
+      break;
+    threadInterfaces.emplace_back( std::move( clone ) );
+  }
+
   QgsChangedAttributesMap changeMap;
-  while ( fi.nextFeature( feature ) )
+  QVector< QgsFeature > batch;
+  batch.reserve( FEATURES_PER_BATCH );
+
+  auto processBatch = [&]
   {
-    ++featureCounter;
-    if ( feedback && feedback->isCanceled() )
+    QVector< QMap<QgsZonalStatistics::Statistic, QVariant> > batchResults( batch.size() );
+    if ( threadInterfaces.size() > 1 && batch.size() > 1 )
     {
-      break;
-    }
+      const int chunkCount = std::min( static_cast< int >( threadInterfaces.size() ), batch.size() );
+      QVector< int > chunks( chunkCount );
+      std::iota( chunks.begin(), chunks.end(), 0 );
 
-    if ( feedback )
+      const std::function< void( const int & ) > processChunk = [this, &batch, &batchResults, &threadInterfaces, chunkCount, feedback]( const int &chunk )
+      {
+        QgsRasterInterface *rasterInterface = threadInterfaces.at( chunk ).get();
+        const int first = static_cast< int >( static_cast< qint64 >( batch.size() ) * chunk / chunkCount );
+        const int end = static_cast< int >( static_cast< qint64 >( batch.size() ) * ( chunk + 1 ) / chunkCount );
+        for ( int i = first; i < end; ++i )
+        {
+          if ( feedback && feedback->isCanceled() )
+            return;
+          batchResults[i] = calculateStatistics( rasterInterface, batch.at( i ).geometry(), mCellSizeX, mCellSizeY, mRasterBand, mStatistics );
+        }
+      };
+      QtConcurrent::blockingMap( chunks, processChunk );
+    }
+    else
     {
-      feedback->setProgress( 100.0 * static_cast< double >( featureCounter ) / featureCount );
+      for ( int i = 0; i < batch.size(); ++i )
+      {
+        if ( feedback && feedback->isCanceled() )
+          break;
+        batchResults[i] = calculateStatistics( mRasterInterface, batch.at( i ).geometry(), mCellSizeX, mCellSizeY, mRasterBand, mStatistics );
+      }
     }
 
-    QgsGeometry featureGeometry = feature.geometry();
+    for ( int i = 0; i < batch.size(); ++i )
+    {
+      const QMap<QgsZonalStatistics::Statistic, QVariant> &results = batchResults.at( i );
+      if ( results.empty() )
+        continue;
+
+      QgsAttributeMap changeAttributeMap;
+      for ( auto it = results.constBegin(); it != results.constEnd(); ++it )
+      {
+        changeAttributeMap.insert( statFieldIndexes.value( it.key() ), it.value() );
+      }
 
-    QMap<QgsZonalStatistics::Statistic, QVariant> results = calculateStatistics( mRasterInterface, featureGeometry, mCellSizeX, mCellSizeY, mRasterBand, mStatistics );
+      changeMap.insert( batch.at( i ).id(), changeAttributeMap );
+    }
+    batch.clear();
 
-    if ( results.empty() )
-      continue;
+    if ( feedback )
+    {
+      feedback->setProgress( 100.0 * static_cast< double >( featureCounter ) / featureCount );
+    }
+  };
 
-    QgsAttributeMap changeAttributeMap;
-    for ( const auto &result : results.toStdMap() )
+  while ( fi.nextFeature( feature ) )
+  {
+    ++featureCounter;
+    if ( feedback && feedback->isCanceled() )
     {
-      changeAttributeMap.insert( statFieldIndexes.value( result.first ), result.second );
+      break;
     }
 
-    changeMap.insert( feature.id(), changeAttributeMap );
+    batch << feature;
+    if ( batch.size() >= FEATURES_PER_BATCH )
+      processBatch();
   }
+  if ( !batch.isEmpty() && !( feedback && feedback->isCanceled() ) )
+    processBatch();
 
   vectorProvider->changeAttributeValues( changeMap );
   mPolygonLayer->updateFields();
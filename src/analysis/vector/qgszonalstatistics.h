@@ -130,6 +130,9 @@ class ANALYSIS_EXPORT QgsZonalStatistics
 
     /**
      * Runs the calculation.
+     *
+     * Since QGIS 3.30 the statistics of the polygons are computed in parallel, reading the raster
+     * through clones of the raster interface.
      */
     QgsZonalStatistics::Result calculateStatistics( QgsFeedback *feedback );
 
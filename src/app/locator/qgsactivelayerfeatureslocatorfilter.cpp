@@ -102,21 +102,18 @@ QStringList QgsActiveLayerFeaturesLocatorFilter::prepare( const QString &string,
   QStringList expressionParts;
   QStringList completionList;
   const QgsFields fields = layer->fields();
-  QgsAttributeList subsetOfAttributes = qgis::setToList( mDispExpression.referencedAttributeIndexes( layer->fields() ) );
-  for ( const QgsField &field : fields )
+  QgsAttributeList subsetOfAttributes = qgis::setToList( mDispExpression.referencedAttributeIndexes( fields ) );
+  for ( int index = 0; index < fields.count(); ++index )
   {
+    const QgsField field = fields.at( index );
     if ( field.configurationFlags().testFlag( QgsField::ConfigurationFlag::NotSearchable ) )
       continue;
 
     if ( isRestricting && !field.name().startsWith( _fieldRestriction ) )
       continue;
 
-    if ( isRestricting )
-    {
-      int index = layer->fields().indexFromName( field.name() );
-      if ( !subsetOfAttributes.contains( index ) )
-        subsetOfAttributes << index;
-    }
+    if ( isRestricting && !subsetOfAttributes.contains( index ) )
+      subsetOfAttributes << index;
 
     // if we are trying to find a field (and not searching anything yet)
     // keep the list of matching fields to display them as results
@@ -137,6 +134,14 @@ QStringList QgsActiveLayerFeaturesLocatorFilter::prepare( const QString &string,
     {
       expressionParts << QStringLiteral( "%1 = %2" ).arg( QgsExpression::quotedColumnRef( field.name() ), QString::number( numericalValue, 'g', 17 ) );
     }
+    else
+    {
+      continue;
+    }
+
+    // only the searched fields are fetched, which matters on layers with many columns
+    if ( !subsetOfAttributes.contains( index ) )
+      subsetOfAttributes << index;
   }
 
   QString expression = QStringLiteral( "(%1)" ).arg( expressionParts.join( QLatin1String( " ) OR ( " ) ) );
@@ -145,8 +150,7 @@ QStringList QgsActiveLayerFeaturesLocatorFilter::prepare( const QString &string,
   if ( !mDispExpression.needsGeometry() )
     req.setFlags( QgsFeatureRequest::NoGeometry );
   req.setFilterExpression( expression );
-  if ( isRestricting )
-    req.setSubsetOfAttributes( subsetOfAttributes );
+  req.setSubsetOfAttributes( subsetOfAttributes );
 
   req.setLimit( mMaxTotalResults );
   mFieldIterator = layer->getFeatures( req );
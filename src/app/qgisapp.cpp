@@ -1002,6 +1002,7 @@ QgisApp::QgisApp( QSplashScreen *splash, bool restorePlugins, bool skipBadLayers
   startProfile( tr( "Create database query logger" ) );
   mQueryLogger = new QgsAppQueryLogger( this );
   QgsApplication::databaseQueryLog()->setEnabled( settings.value( QStringLiteral( "logDatabaseQueries" ), false, QgsSettings::App ).toBool() );
+  QgsApplication::databaseQueryLog()->setSlowQueryThreshold( settings.value( QStringLiteral( "slowDatabaseQueryThreshold" ), 0, QgsSettings::App ).toInt() );
   endProfile();
 
   startProfile( tr( "Building style sheet" ) );
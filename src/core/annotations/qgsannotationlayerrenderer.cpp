@@ -32,22 +32,29 @@ QgsAnnotationLayerRenderer::QgsAnnotationLayerRenderer( QgsAnnotationLayer *laye
   // first, we can use the layer's spatial index to very quickly retrieve items we know will fall within the visible
   // extent. This will ONLY apply to items which have a non-scale-dependent bounding box though.
 
-  const QStringList itemsList = layer->queryIndex( context.extent() );
-  QSet< QString > items( itemsList.begin(), itemsList.end() );
+  const QStringList indexedItems = layer->queryIndex( context.extent() );
 
   // we also have NO choice but to clone ALL non-indexed items (i.e. those with a scale-dependent bounding box)
   // since these won't be in the layer's spatial index, and it's too expensive to determine their actual bounding box
   // upfront (we are blocking the main thread right now!)
 
   // TODO -- come up with some brilliant way to avoid this and also index scale-dependent items ;)
-  items.unite( layer->mNonIndexedItems );
+  const QSet< QString > &nonIndexedItems = layer->mNonIndexedItems;
 
-  mItems.reserve( items.size() );
-  std::transform( items.begin(), items.end(), std::back_inserter( mItems ),
-                  [layer]( const QString & id ) ->std::pair< QString, std::unique_ptr< QgsAnnotationItem > >
+  // the indexed and non-indexed items are cloned directly, without building a set of all their ids first,
+  // as the index may return many items for large layers
+  mItems.reserve( indexedItems.size() + nonIndexedItems.size() );
+  auto cloneItem = [this, layer]( const QString & id )
   {
-    return std::make_pair( id, std::unique_ptr< QgsAnnotationItem >( layer->item( id )->clone() ) );
-  } );
+    mItems.emplace_back( id, std::unique_ptr< QgsAnnotationItem >( layer->item( id )->clone() ) );
+  };
+  for ( const QString &id : indexedItems )
+  {
+    if ( nonIndexedItems.isEmpty() || !nonIndexedItems.contains( id ) )
+      cloneItem( id );
+  }
+  for ( const QString &id : nonIndexedItems )
+    cloneItem( id );
 
   std::sort( mItems.begin(), mItems.end(), [](
                const std::pair< QString, std::unique_ptr< QgsAnnotationItem > > &a,
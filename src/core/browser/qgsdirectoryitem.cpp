@@ -31,6 +31,8 @@
 #include <QMenu>
 #include <QAction>
 
+#include <algorithm>
+
 //
 // QgsDirectoryItem
 //
@@ -256,8 +258,25 @@ QVector<QgsDataItem *> QgsDirectoryItem::createChildren()
 
   const QList<QgsDataItemProvider *> providers = QgsApplication::dataItemProviderRegistry()->providers();
 
-  const QStringList entries = dir.entryList( QDir::AllDirs | QDir::NoDotAndDotDot, QDir::Name | QDir::IgnoreCase );
-  for ( const QString &subdir : entries )
+  // the directory is listed once and the file infos of the listing are reused, as each access to the
+  // file system is slow on network shares
+  const QFileInfoList entries = dir.entryInfoList( QDir::AllDirs | QDir::NoDotAndDotDot | QDir::Files, QDir::NoSort );
+
+  QFileInfoList subdirEntries;
+  for ( const QFileInfo &entry : entries )
+  {
+    if ( entry.isDir() )
+      subdirEntries << entry;
+  }
+  std::sort( subdirEntries.begin(), subdirEntries.end(), []( const QFileInfo & a, const QFileInfo & b )
+  {
+    return a.fileName().compare( b.fileName(), Qt::CaseInsensitive ) < 0;
+  } );
+
+  const QgsSettings settings;
+  const QStringList hiddenItems = settings.value( QStringLiteral( "browser/hiddenPaths" ), QStringList() ).toStringList();
+
+  for ( const QFileInfo &subdirInfo : std::as_const( subdirEntries ) )
   {
     if ( mRefreshLater )
     {
@@ -265,12 +284,13 @@ QVector<QgsDataItem *> QgsDirectoryItem::createChildren()
       return children;
     }
 
+    const QString subdir = subdirInfo.fileName();
     const QString subdirPath = dir.absoluteFilePath( subdir );
 
     QgsDebugMsgLevel( QStringLiteral( "creating subdir: %1" ).arg( subdirPath ), 2 );
 
     const QString path = mPath + ( mPath.endsWith( '/' ) ? QString() : QStringLiteral( "/" ) ) + subdir; // may differ from subdirPath
-    if ( QgsDirectoryItem::hiddenPath( path ) )
+    if ( hiddenItems.contains( path ) )
       continue;
 
     bool handledByProvider = false;
@@ -292,8 +312,12 @@ QVector<QgsDataItem *> QgsDirectoryItem::createChildren()
     children.append( item );
   }
 
-  const QStringList fileEntries = dir.entryList( QDir::Dirs | QDir::NoDotAndDotDot | QDir::Files, QDir::Name );
-  for ( const QString &name : fileEntries )
+  QFileInfoList fileEntries = entries;
+  std::sort( fileEntries.begin(), fileEntries.end(), []( const QFileInfo & a, const QFileInfo & b )
+  {
+    return a.fileName() < b.fileName();
+  } );
+  for ( const QFileInfo &fileInfo : std::as_const( fileEntries ) )
   {
     if ( mRefreshLater )
     {
@@ -301,8 +325,8 @@ QVector<QgsDataItem *> QgsDirectoryItem::createChildren()
       return children;
     }
 
+    const QString name = fileInfo.fileName();
     const QString path = dir.absoluteFilePath( name );
-    const QFileInfo fileInfo( path );
 
     if ( fileInfo.suffix().compare( QLatin1String( "zip" ), Qt::CaseInsensitive ) == 0 ||
          fileInfo.suffix().compare( QLatin1String( "tar" ), Qt::CaseInsensitive ) == 0 )
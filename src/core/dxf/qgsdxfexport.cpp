@@ -140,18 +140,14 @@ void QgsDxfExport::writeGroup( int code, const QgsPoint &p )
 
 void QgsDxfExport::writeGroup( const QColor &color, int exactMatchCode, int rgbCode, int transparencyCode )
 {
-  int minDistAt = -1;
-  int minDist = std::numeric_limits<int>::max();
+  // exports use few distinct colors, which are each matched against the palette only once
+  const QRgb rgb = color.rgb();
+  auto colorIt = mClosestDxfColors.constFind( rgb );
+  if ( colorIt == mClosestDxfColors.constEnd() )
+    colorIt = mClosestDxfColors.insert( rgb, closestColorMatch( rgb ) );
 
-  for ( int i = 1; i < static_cast< int >( sizeof( sDxfColors ) / sizeof( *sDxfColors ) ) && minDist > 0; ++i )
-  {
-    int dist = color_distance( color.rgba(), i );
-    if ( dist >= minDist )
-      continue;
-
-    minDistAt = i;
-    minDist = dist;
-  }
+  const int minDistAt = colorIt.value();
+  const int minDist = color_distance( rgb, minDistAt );
 
   if ( minDist == 0 && minDistAt != 7 )
   {
@@ -169,12 +165,12 @@ void QgsDxfExport::writeGroup( const QColor &color, int exactMatchCode, int rgbC
 
 void QgsDxfExport::writeGroupCode( int code )
 {
-  mTextStream << QStringLiteral( "%1\n" ).arg( code, 3, 10, QChar( ' ' ) );
+  mTextStream << qSetFieldWidth( 3 ) << code << qSetFieldWidth( 0 ) << '\n';
 }
 
 void QgsDxfExport::writeInt( int i )
 {
-  mTextStream << QStringLiteral( "%1\n" ).arg( i, 6, 10, QChar( ' ' ) );
+  mTextStream << qSetFieldWidth( 6 ) << i << qSetFieldWidth( 0 ) << '\n';
 }
 
 void QgsDxfExport::writeDouble( double d )
@@ -634,6 +634,8 @@ class CORE_EXPORT QgsDxfExport : public QgsLabelSink
     QgsCoordinateReferenceSystem mCrs;
     QgsMapSettings mMapSettings;
     QHash<QString, int> mLayerNameAttribute;
+    //! Closest DXF palette index of the colors written by the export
+    QHash<QRgb, int> mClosestDxfColors;
     double mFactor = 1.0;
     bool mForce2d = false;
 
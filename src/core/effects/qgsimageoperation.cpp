@@ -24,6 +24,9 @@
 #include <QColor>
 #include <QPainter>
 
+#include <algorithm>
+#include <vector>
+
 //determined via trial-and-error. Could possibly be optimised, or varied
 //depending on the image size.
 #define BLOCK_THREADS 16
@@ -720,7 +723,13 @@ void QgsImageOperation::GaussianBlurOperation::operator()( QgsImageOperation::Im
   if ( mDirection == ByRow )
   {
     unsigned char *sourceFirstLine = block.image->scanLine( 0 );
-    unsigned char *sourceRef;
+
+    // the kernel is applied one source line at a time, so that the lines are read sequentially instead of
+    // reading a column of pixels for each output pixel. The values of each pixel are summed in the same order
+    std::vector< double > r( width );
+    std::vector< double > g( width );
+    std::vector< double > b( width );
+    std::vector< double > a( width );
 
     //blur along rows
     for ( unsigned int y = block.beginLine; y < block.endLine; ++y, outputLineRef += mDestImageBpl )
@@ -728,14 +737,30 @@ void QgsImageOperation::GaussianBlurOperation::operator()( QgsImageOperation::Im
       if ( mFeedback && mFeedback->isCanceled() )
         break;
 
-      sourceRef = sourceFirstLine;
-      destRef = reinterpret_cast< QRgb * >( outputLineRef );
-      for ( int x = 0; x < width; ++x, ++destRef, sourceRef += 4 )
+      std::fill( r.begin(), r.end(), 0 );
+      std::fill( g.begin(), g.end(), 0 );
+      std::fill( b.begin(), b.end(), 0 );
+      std::fill( a.begin(), a.end(), 0 );
+
+      for ( int i = 0; i <= mRadius * 2; ++i )
       {
-        if ( mFeedback && mFeedback->isCanceled() )
-          break;
+        const int sourceY = std::clamp( static_cast< int >( y ) + ( i - mRadius ), 0, height - 1 );
+        const QRgb *sourceLine = reinterpret_cast< const QRgb * >( sourceFirstLine + sourceBpl * sourceY );
+        const double kernelValue = mKernel[i];
+        for ( int x = 0; x < width; ++x )
+        {
+          const QRgb rgb = sourceLine[x];
+          r[x] += kernelValue * qRed( rgb );
+          g[x] += kernelValue * qGreen( rgb );
+          b[x] += kernelValue * qBlue( rgb );
+          a[x] += kernelValue * qAlpha( rgb );
+        }
+      }
 
-        *destRef = gaussianBlurVertical( y, sourceRef, sourceBpl, height );
+      destRef = reinterpret_cast< QRgb * >( outputLineRef );
+      for ( int x = 0; x < width; ++x, ++destRef )
+      {
+        *destRef = qRgba( r[x], g[x], b[x], a[x] );
       }
     }
   }
@@ -759,30 +784,6 @@ void QgsImageOperation::GaussianBlurOperation::operator()( QgsImageOperation::Im
   }
 }
 
-inline QRgb QgsImageOperation::GaussianBlurOperation::gaussianBlurVertical( const int posy, unsigned char *sourceFirstLine, const int sourceBpl, const int height ) const
-{
-  double r = 0;
-  double b = 0;
-  double g = 0;
-  double a = 0;
-  int y;
-  unsigned char *ref;
-
-  for ( int i = 0; i <= mRadius * 2; ++i )
-  {
-    y = std::clamp( posy + ( i - mRadius ), 0, height - 1 );
-    ref = sourceFirstLine + sourceBpl * y;
-
-    QRgb *refRgb = reinterpret_cast< QRgb * >( ref );
-    r += mKernel[i] * qRed( *refRgb );
-    g += mKernel[i] * qGreen( *refRgb );
-    b += mKernel[i] * qBlue( *refRgb );
-    a += mKernel[i] * qAlpha( *refRgb );
-  }
-
-  return qRgba( r, g, b, a );
-}
-
 inline QRgb QgsImageOperation::GaussianBlurOperation::gaussianBlurHorizontal( const int posx, unsigned char *sourceFirstLine, const int width ) const
 {
   double r = 0;
@@ -502,7 +502,6 @@ class CORE_EXPORT QgsImageOperation
         double *mKernel = nullptr;
         QgsFeedback *mFeedback = nullptr;
 
-        inline QRgb gaussianBlurVertical( int posy, unsigned char *sourceFirstLine, int sourceBpl, int height ) const;
         inline QRgb gaussianBlurHorizontal( int posx, unsigned char *sourceFirstLine, int width ) const;
     };
 
@@ -182,6 +182,19 @@ void QgsProfilePlotRenderer::setContext( const QgsProfileGenerationContext &cont
       continue;
 
     job->mutex.lock();
+    // complete results generated over a larger range with at least the same detail, e.g. when the plot is
+    // panned back within the previously generated distances, are kept as they are
+    const Qgis::ProfileGeneratorFlags flags = job->generator->flags();
+    const bool resultsCoverContext = job->results && job->complete
+                                     && ( !( flags & Qgis::ProfileGeneratorFlag::RespectsMaximumErrorMapUnit ) || std::isnan( job->context.maximumErrorMapUnits() ) || job->context.maximumErrorMapUnits() <= mContext.maximumErrorMapUnits() )
+                                     && ( !( flags & Qgis::ProfileGeneratorFlag::RespectsDistanceRange ) || job->context.distanceRange().contains( mContext.distanceRange() ) )
+                                     && ( !( flags & Qgis::ProfileGeneratorFlag::RespectsElevationRange ) || job->context.elevationRange().contains( mContext.elevationRange() ) );
+    if ( resultsCoverContext )
+    {
+      job->mutex.unlock();
+      continue;
+    }
+
     job->context = mContext;
     if ( job->results && job->complete )
       job->invalidatedResults = std::move( job->results );
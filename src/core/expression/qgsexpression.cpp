@@ -56,6 +56,7 @@ void QgsExpression::setExpression( const QString &expression )
   d->mEvalErrorString = QString();
   d->mExp = expression;
   d->mIsPrepared = false;
+  d->mBytecode.reset();
 }
 
 QString QgsExpression::expression() const
@@ -330,6 +331,7 @@ bool QgsExpression::prepare( const QgsExpressionContext *context )
 {
   detach();
   d->mEvalErrorString = QString();
+  d->mBytecode.reset();
   if ( !d->mRootNode )
   {
     //re-parse expression. Creation of QgsExpressionContexts may have added extra
@@ -346,7 +348,9 @@ bool QgsExpression::prepare( const QgsExpressionContext *context )
 
   initGeomCalculator( context );
   d->mIsPrepared = true;
-  return d->mRootNode->prepare( this, context );
+  const bool res = d->mRootNode->prepare( this, context );
+  d->mBytecode = QgsExpressionBytecode::compile( d->mRootNode, context );
+  return res;
 }
 
 QVariant QgsExpression::evaluate()
@@ -374,6 +378,12 @@ QVariant QgsExpression::evaluate( const QgsExpressionContext *context )
   {
     prepare( context );
   }
+
+  // the node tree is used for the values the program was not compiled for
+  QVariant result;
+  if ( d->mBytecode && d->mBytecode->isWorthwhile() && d->mBytecode->evaluate( this, context, result ) )
+    return result;
+
   return d->mRootNode->eval( this, context );
 }
 
@@ -24,6 +24,7 @@
 #include "qgsdistancearea.h"
 #include "qgsunittypes.h"
 #include "qgsexpressionnode.h"
+#include "qgsexpressionbytecode_p.h"
 
 ///@cond
 
@@ -84,6 +85,9 @@ class QgsExpressionPrivate
     //! Whether prepare() has been called before evaluate()
     bool mIsPrepared = false;
 
+    //! Program compiled from mRootNode by prepare(), not shared with copies as it points to the nodes
+    std::unique_ptr<QgsExpressionBytecode> mBytecode;
+
     QgsExpressionPrivate &operator= ( const QgsExpressionPrivate & ) = delete;
 };
 
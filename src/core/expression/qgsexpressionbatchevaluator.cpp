@@ -0,0 +1,774 @@
+/***************************************************************************
+                         qgsexpressionbatchevaluator.cpp
+                         -------------------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsexpressionbatchevaluator.h"
+#include "qgsexpression.h"
+#include "qgsexpressioncontext.h"
+#include "qgsexpressionfunction.h"
+#include "qgsexpressionnodeimpl.h"
+#include "qgsexpressionutils.h"
+#include "qgsfeature.h"
+#include "qgsvariantutils.h"
+#include "qgis.h"
+
+#include <algorithm>
+#include <cmath>
+
+typedef QgsFeatureBatch::Column Column;
+typedef QgsFeatureBatch::ColumnType ColumnType;
+
+///@cond PRIVATE
+namespace
+{
+  bool isNumeric( const Column &column )
+  {
+    return column.type() == ColumnType::Int64 || column.type() == ColumnType::Double;
+  }
+
+  //! Returns TRUE if all the values of \a column are NULL, as for a NULL literal
+  bool isAllNull( const Column &column )
+  {
+    if ( column.type() != ColumnType::Variant )
+      return false;
+    const QByteArray &validity = column.validity();
+    return std::all_of( validity.constBegin(), validity.constEnd(), []( char bits ) { return bits == 0; } );
+  }
+
+  Column nullColumn( ColumnType type, int rows )
+  {
+    Column column( type );
+    column.reserve( rows );
+    for ( int row = 0; row < rows; ++row )
+      column.appendNull();
+    return column;
+  }
+
+  double doubleValue( const Column &column, int row )
+  {
+    return column.type() == ColumnType::Int64 ? static_cast< double >( column.int64Values().at( row ) ) : column.doubleValues().at( row );
+  }
+
+  QByteArray utf8Value( const Column &column, int row )
+  {
+    const qint32 start = column.stringOffsets().at( row );
+    return QByteArray::fromRawData( column.stringData().constData() + start, column.stringOffsets().at( row + 1 ) - start );
+  }
+
+  //! Three valued logic state of a numeric column value
+  enum class Tvl
+  {
+    False,
+    True,
+    Unknown,
+  };
+
+  Tvl tvlValue( const Column &column, int row )
+  {
+    if ( column.isNull( row ) )
+      return Tvl::Unknown;
+    return !qgsDoubleNear( doubleValue( column, row ), 0.0 ) ? Tvl::True : Tvl::False;
+  }
+
+  void appendTvl( Column &column, Tvl value )
+  {
+    if ( value == Tvl::Unknown )
+      column.appendNull();
+    else
+      column.appendInt64( value == Tvl::True ? 1 : 0 );
+  }
+
+  Column constantColumn( const QVariant &value, int rows )
+  {
+    Column column( QgsVariantUtils::isNull( value ) ? ColumnType::Variant : QgsFeatureBatch::columnTypeForField( value.type() ) );
+    column.reserve( rows );
+    for ( int row = 0; row < rows; ++row )
+      column.appendValue( value );
+    return column;
+  }
+
+  //! Returns the type able to store the values of both \a a and \a b
+  ColumnType commonType( ColumnType a, ColumnType b )
+  {
+    if ( a == b )
+      return a;
+    if ( ( a == ColumnType::Int64 || a == ColumnType::Double ) && ( b == ColumnType::Int64 || b == ColumnType::Double ) )
+      return ColumnType::Double;
+    return ColumnType::Variant;
+  }
+
+  //! Appends the value of \a source at \a row to \a target, converting numbers if required
+  void appendFrom( Column &target, const Column &source, int row )
+  {
+    if ( source.isNull( row ) )
+    {
+      target.appendNull();
+      return;
+    }
+
+    switch ( target.type() )
+    {
+      case ColumnType::Int64:
+        target.appendInt64( source.int64Values().at( row ) );
+        return;
+
+      case ColumnType::Double:
+        target.appendDouble( doubleValue( source, row ) );
+        return;
+
+      case ColumnType::String:
+      {
+        const QByteArray utf8 = utf8Value( source, row );
+        target.appendUtf8( utf8.constData(), utf8.size() );
+        return;
+      }
+
+      case ColumnType::Variant:
+        target.appendValue( source.value( row ) );
+        return;
+    }
+  }
+
+  bool compareDiff( QgsExpressionNodeBinaryOperator::BinaryOperator op, double diff )
+  {
+    switch ( op )
+    {
+      case QgsExpressionNodeBinaryOperator::boEQ:
+        return qgsDoubleNear( diff, 0.0 );
+      case QgsExpressionNodeBinaryOperator::boNE:
+        return !qgsDoubleNear( diff, 0.0 );
+      case QgsExpressionNodeBinaryOperator::boLT:
+        return diff < 0;
+      case QgsExpressionNodeBinaryOperator::boGT:
+        return diff > 0;
+      case QgsExpressionNodeBinaryOperator::boLE:
+        return diff <= 0;
+      case QgsExpressionNodeBinaryOperator::boGE:
+        return diff >= 0;
+      default:
+        return false;
+    }
+  }
+}
+///@endcond
+
+QgsExpressionBatchEvaluator::QgsExpressionBatchEvaluator( QgsExpression *expression )
+  : mExpression( expression )
+{
+}
+
+QgsFeatureBatch::Column QgsExpressionBatchEvaluator::evaluate( const QgsFeatureBatch &batch, QgsExpressionContext *context )
+{
+  mUsedRowFallback = false;
+  mErrorRows = QVector< bool >( batch.size(), false );
+  mEvalErrorString.clear();
+
+  QgsExpressionContext localContext;
+  if ( !context )
+    context = &localContext;
+
+  if ( !mExpression->rootNode() )
+    return constantColumn( QVariant(), batch.size() );
+
+  // make sure field indexes and static values are resolved
+  mExpression->prepare( context );
+  if ( !mExpression->rootNode() )
+    return constantColumn( QVariant(), batch.size() );
+
+  const Column result = evaluateNode( mExpression->rootNode(), batch, context, QVector< bool >( batch.size(), true ) );
+  if ( mEvalErrorString.isEmpty() )
+    return result;
+
+  // as for QgsExpression::evaluate(), errors make the whole expression NULL
+  mExpression->setEvalErrorString( mEvalErrorString );
+  Column withErrors( result.type() );
+  withErrors.reserve( batch.size() );
+  for ( int row = 0; row < batch.size(); ++row )
+  {
+    if ( mErrorRows.at( row ) )
+      withErrors.appendNull();
+    else
+      appendFrom( withErrors, result, row );
+  }
+  return withErrors;
+}
+
+QgsFeatureBatch::Column QgsExpressionBatchEvaluator::evaluateNode( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected )
+{
+  node = node->effectiveNode();
+
+  if ( node->hasCachedStaticValue() )
+    return constantColumn( node->cachedStaticValue(), batch.size() );
+
+  Column result;
+  switch ( node->nodeType() )
+  {
+    case QgsExpressionNode::ntLiteral:
+      return constantColumn( static_cast< const QgsExpressionNodeLiteral * >( node )->value(), batch.size() );
+
+    case QgsExpressionNode::ntColumnRef:
+    {
+      const int column = batch.columnIndex( batch.fields().lookupField( static_cast< const QgsExpressionNodeColumnRef * >( node )->name() ) );
+      if ( column >= 0 )
+        return batch.column( column );
+      break;
+    }
+
+    case QgsExpressionNode::ntUnaryOperator:
+      if ( evaluateUnary( node, batch, context, selected, result ) )
+        return result;
+      break;
+
+    case QgsExpressionNode::ntBinaryOperator:
+      if ( evaluateBinary( node, batch, context, selected, result ) )
+        return result;
+      break;
+
+    case QgsExpressionNode::ntCondition:
+      if ( evaluateCondition( node, batch, context, selected, result ) )
+        return result;
+      break;
+
+    case QgsExpressionNode::ntFunction:
+      if ( evaluateFunction( node, batch, context, selected, result ) )
+        return result;
+      break;
+
+    case QgsExpressionNode::ntInOperator:
+    case QgsExpressionNode::ntIndexOperator:
+    case QgsExpressionNode::ntBetweenOperator:
+      break;
+  }
+
+  return evaluateRows( node, batch, context, selected );
+}
+
+bool QgsExpressionBatchEvaluator::evaluateUnary( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected, QgsFeatureBatch::Column &result )
+{
+  const QgsExpressionNodeUnaryOperator *unary = static_cast< const QgsExpressionNodeUnaryOperator * >( node );
+  const Column operand = evaluateNode( unary->operand(), batch, context, selected );
+  if ( !isNumeric( operand ) )
+    return false;
+
+  const int rows = batch.size();
+  switch ( unary->op() )
+  {
+    case QgsExpressionNodeUnaryOperator::uoNot:
+      result = Column( ColumnType::Int64 );
+      result.reserve( rows );
+      for ( int row = 0; row < rows; ++row )
+      {
+        const Tvl value = tvlValue( operand, row );
+        appendTvl( result, value == Tvl::Unknown ? Tvl::Unknown : ( value == Tvl::True ? Tvl::False : Tvl::True ) );
+      }
+      return true;
+
+    case QgsExpressionNodeUnaryOperator::uoMinus:
+      result = Column( operand.type() );
+      result.reserve( rows );
+      for ( int row = 0; row < rows; ++row )
+      {
+        if ( operand.isNull( row ) )
+          result.appendNull();
+        else if ( operand.type() == ColumnType::Int64 )
+          result.appendInt64( -operand.int64Values().at( row ) );
+        else
+          result.appendDouble( -operand.doubleValues().at( row ) );
+      }
+      return true;
+  }
+  return false;
+}
+
+bool QgsExpressionBatchEvaluator::evaluateBinary( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected, QgsFeatureBatch::Column &result )
+{
+  const QgsExpressionNodeBinaryOperator *binary = static_cast< const QgsExpressionNodeBinaryOperator * >( node );
+  const QgsExpressionNodeBinaryOperator::BinaryOperator op = binary->op();
+
+  switch ( op )
+  {
+    case QgsExpressionNodeBinaryOperator::boRegexp:
+    case QgsExpressionNodeBinaryOperator::boLike:
+    case QgsExpressionNodeBinaryOperator::boNotLike:
+    case QgsExpressionNodeBinaryOperator::boILike:
+    case QgsExpressionNodeBinaryOperator::boNotILike:
+      return false;
+    default:
+      break;
+  }
+
+  const int rows = batch.size();
+  if ( op == QgsExpressionNodeBinaryOperator::boAnd || op == QgsExpressionNodeBinaryOperator::boOr )
+  {
+    const Column left = tvlColumn( evaluateNode( binary->opLeft(), batch, context, selected ), selected );
+
+    // the right operand is skipped for the rows decided by the left one
+    const Tvl decided = op == QgsExpressionNodeBinaryOperator::boAnd ? Tvl::False : Tvl::True;
+    QVector< bool > rightSelected = selected;
+    for ( int row = 0; row < rows; ++row )
+    {
+      if ( rightSelected.at( row ) && tvlValue( left, row ) == decided )
+        rightSelected[ row ] = false;
+    }
+    const Column right = tvlColumn( evaluateNode( binary->opRight(), batch, context, rightSelected ), rightSelected );
+
+    result = Column( ColumnType::Int64 );
+    result.reserve( rows );
+    for ( int row = 0; row < rows; ++row )
+    {
+      const Tvl l = tvlValue( left, row );
+      const Tvl r = tvlValue( right, row );
+      if ( op == QgsExpressionNodeBinaryOperator::boAnd )
+        appendTvl( result, l == Tvl::False || r == Tvl::False ? Tvl::False : ( l == Tvl::True && r == Tvl::True ? Tvl::True : Tvl::Unknown ) );
+      else
+        appendTvl( result, l == Tvl::True || r == Tvl::True ? Tvl::True : ( l == Tvl::False && r == Tvl::False ? Tvl::False : Tvl::Unknown ) );
+    }
+    return true;
+  }
+
+  const Column left = evaluateNode( binary->opLeft(), batch, context, selected );
+  const Column right = evaluateNode( binary->opRight(), batch, context, selected );
+  const bool numeric = isNumeric( left ) && isNumeric( right );
+  const bool strings = left.type() == ColumnType::String && right.type() == ColumnType::String;
+  const bool leftNull = isAllNull( left );
+  const bool rightNull = isAllNull( right );
+
+  switch ( op )
+  {
+    case QgsExpressionNodeBinaryOperator::boEQ:
+    case QgsExpressionNodeBinaryOperator::boNE:
+    case QgsExpressionNodeBinaryOperator::boLT:
+    case QgsExpressionNodeBinaryOperator::boGT:
+    case QgsExpressionNodeBinaryOperator::boLE:
+    case QgsExpressionNodeBinaryOperator::boGE:
+    {
+      // comparisons with NULL are always NULL
+      if ( leftNull || rightNull )
+      {
+        result = nullColumn( ColumnType::Int64, rows );
+        return true;
+      }
+      if ( !numeric && !strings )
+        return false;
+
+      result = Column( ColumnType::Int64 );
+      result.reserve( rows );
+      const bool equality = op == QgsExpressionNodeBinaryOperator::boEQ || op == QgsExpressionNodeBinaryOperator::boNE;
+      for ( int row = 0; row < rows; ++row )
+      {
+        if ( left.isNull( row ) || right.isNull( row ) )
+        {
+          result.appendNull();
+        }
+        else if ( numeric )
+        {
+          result.appendInt64( compareDiff( op, doubleValue( left, row ) - doubleValue( right, row ) ) ? 1 : 0 );
+        }
+        else if ( equality )
+        {
+          // UTF-8 byte equality matches string equality
+          const bool equal = utf8Value( left, row ) == utf8Value( right, row );
+          result.appendInt64( equal == ( op == QgsExpressionNodeBinaryOperator::boEQ ) ? 1 : 0 );
+        }
+        else
+        {
+          result.appendInt64( compareDiff( op, QString::compare( left.stringValue( row ), right.stringValue( row ) ) ) ? 1 : 0 );
+        }
+      }
+      return true;
+    }
+
+    case QgsExpressionNodeBinaryOperator::boIs:
+    case QgsExpressionNodeBinaryOperator::boIsNot:
+    {
+      // a NULL operand only needs the other operand to be checked for NULL
+      if ( !numeric && !strings && !leftNull && !rightNull )
+        return false;
+
+      result = Column( ColumnType::Int64 );
+      result.reserve( rows );
+      for ( int row = 0; row < rows; ++row )
+      {
+        bool equal = false;
+        if ( left.isNull( row ) || right.isNull( row ) )
+          equal = left.isNull( row ) && right.isNull( row );
+        else if ( numeric )
+          equal = qgsDoubleNear( doubleValue( left, row ), doubleValue( right, row ) );
+        else
+          equal = utf8Value( left, row ) == utf8Value( right, row );
+        result.appendInt64( equal == ( op == QgsExpressionNodeBinaryOperator::boIs ) ? 1 : 0 );
+      }
+      return true;
+    }
+
+    case QgsExpressionNodeBinaryOperator::boPlus:
+    case QgsExpressionNodeBinaryOperator::boMinus:
+    case QgsExpressionNodeBinaryOperator::boMul:
+    case QgsExpressionNodeBinaryOperator::boDiv:
+    case QgsExpressionNodeBinaryOperator::boMod:
+    case QgsExpressionNodeBinaryOperator::boPow:
+    {
+      // boIntDiv is left to the per feature evaluation, as it converts NULL values to 0
+      if ( ( leftNull && isNumeric( right ) ) || ( rightNull && isNumeric( left ) ) )
+      {
+        result = nullColumn( ColumnType::Double, rows );
+        return true;
+      }
+      if ( !numeric )
+        return false;
+
+      // integer arithmetic is used when both sides are integers, as in QgsExpressionNodeBinaryOperator
+      const bool integers = left.type() == ColumnType::Int64 && right.type() == ColumnType::Int64
+                            && op != QgsExpressionNodeBinaryOperator::boDiv && op != QgsExpressionNodeBinaryOperator::boPow;
+      result = Column( integers ? ColumnType::Int64 : ColumnType::Double );
+      result.reserve( rows );
+
+      for ( int row = 0; row < rows; ++row )
+      {
+        if ( left.isNull( row ) || right.isNull( row ) )
+        {
+          result.appendNull();
+          continue;
+        }
+
+        if ( integers )
+        {
+          const qint64 l = left.int64Values().at( row );
+          const qint64 r = right.int64Values().at( row );
+          switch ( op )
+          {
+            case QgsExpressionNodeBinaryOperator::boPlus:
+              result.appendInt64( l + r );
+              break;
+            case QgsExpressionNodeBinaryOperator::boMinus:
+              result.appendInt64( l - r );
+              break;
+            case QgsExpressionNodeBinaryOperator::boMul:
+              result.appendInt64( l * r );
+              break;
+            case QgsExpressionNodeBinaryOperator::boMod:
+              if ( r == 0 )
+                result.appendNull();
+              else
+                result.appendInt64( l % r );
+              break;
+            default:
+              result.appendNull();
+              break;
+          }
+          continue;
+        }
+
+        const double l = doubleValue( left, row );
+        const double r = doubleValue( right, row );
+        switch ( op )
+        {
+          case QgsExpressionNodeBinaryOperator::boPlus:
+            result.appendDouble( l + r );
+            break;
+          case QgsExpressionNodeBinaryOperator::boMinus:
+            result.appendDouble( l - r );
+            break;
+          case QgsExpressionNodeBinaryOperator::boMul:
+            result.appendDouble( l * r );
+            break;
+          case QgsExpressionNodeBinaryOperator::boDiv:
+            if ( r == 0. )
+              result.appendNull();
+            else
+              result.appendDouble( l / r );
+            break;
+          case QgsExpressionNodeBinaryOperator::boMod:
+            if ( r == 0. )
+              result.appendNull();
+            else
+              result.appendDouble( std::fmod( l, r ) );
+            break;
+          case QgsExpressionNodeBinaryOperator::boPow:
+            result.appendDouble( std::pow( l, r ) );
+            break;
+          default:
+            result.appendNull();
+            break;
+        }
+      }
+      return true;
+    }
+
+    case QgsExpressionNodeBinaryOperator::boConcat:
+    {
+      if ( ( leftNull && right.type() == ColumnType::String ) || ( rightNull && left.type() == ColumnType::String ) )
+      {
+        result = nullColumn( ColumnType::String, rows );
+        return true;
+      }
+      if ( !strings )
+        return false;
+
+      result = Column( ColumnType::String );
+      result.reserve( rows );
+      QByteArray buffer;
+      for ( int row = 0; row < rows; ++row )
+      {
+        if ( left.isNull( row ) || right.isNull( row ) )
+        {
+          result.appendNull();
+          continue;
+        }
+        buffer = utf8Value( left, row );
+        buffer.append( utf8Value( right, row ) );
+        result.appendUtf8( buffer.constData(), buffer.size() );
+      }
+      return true;
+    }
+
+    default:
+      break;
+  }
+
+  return false;
+}
+
+bool QgsExpressionBatchEvaluator::evaluateCondition( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected, QgsFeatureBatch::Column &result )
+{
+  const QgsExpressionNodeCondition *condition = static_cast< const QgsExpressionNodeCondition * >( node );
+  const QgsExpressionNodeCondition::WhenThenList conditions = condition->conditions();
+  const int rows = batch.size();
+
+  // each WHEN is only evaluated for the rows not taking a previous branch, each THEN for the rows taking it
+  QVector< Column > thens;
+  thens.reserve( conditions.size() + 1 );
+  QVector< int > branches( rows, -1 );
+  QVector< bool > remaining = selected;
+  bool first = true;
+  ColumnType type = ColumnType::Variant;
+  for ( const QgsExpressionNodeCondition::WhenThen *whenThen : conditions )
+  {
+    const Column when = tvlColumn( evaluateNode( whenThen->whenExp(), batch, context, remaining ), remaining );
+
+    QVector< bool > taken( rows, false );
+    for ( int row = 0; row < rows; ++row )
+    {
+      if ( remaining.at( row ) && tvlValue( when, row ) == Tvl::True )
+      {
+        taken[ row ] = true;
+        remaining[ row ] = false;
+        branches[ row ] = thens.size();
+      }
+    }
+
+    thens << evaluateNode( whenThen->thenExp(), batch, context, taken );
+    type = first ? thens.constLast().type() : commonType( type, thens.constLast().type() );
+    first = false;
+  }
+
+  if ( condition->elseExp() )
+  {
+    for ( int row = 0; row < rows; ++row )
+    {
+      if ( remaining.at( row ) )
+        branches[ row ] = thens.size();
+    }
+    thens << evaluateNode( condition->elseExp(), batch, context, remaining );
+    type = first ? thens.constLast().type() : commonType( type, thens.constLast().type() );
+  }
+
+  result = Column( type );
+  result.reserve( rows );
+  for ( int row = 0; row < rows; ++row )
+  {
+    const int branch = branches.at( row );
+    if ( branch >= 0 )
+      appendFrom( result, thens.at( branch ), row );
+    else
+      result.appendNull();
+  }
+  return true;
+}
+
+bool QgsExpressionBatchEvaluator::evaluateFunction( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected, QgsFeatureBatch::Column &result )
+{
+  const QgsExpressionNodeFunction *functionNode = static_cast< const QgsExpressionNodeFunction * >( node );
+  const QString name = QgsExpression::Functions().at( functionNode->fnIndex() )->name();
+
+  // functions can be overridden by the context
+  if ( context->hasFunction( name ) || !functionNode->args() )
+    return false;
+
+  const QList< QgsExpressionNode * > argNodes = functionNode->args()->list();
+  const int rows = batch.size();
+
+  if ( name == QLatin1String( "coalesce" ) )
+  {
+    QVector< Column > args;
+    ColumnType type = ColumnType::Variant;
+    for ( const QgsExpressionNode *argNode : argNodes )
+    {
+      args << evaluateNode( argNode, batch, context, selected );
+      type = args.size() == 1 ? args.constLast().type() : commonType( type, args.constLast().type() );
+    }
+
+    result = Column( type );
+    result.reserve( rows );
+    for ( int row = 0; row < rows; ++row )
+    {
+      int arg = 0;
+      while ( arg < args.size() && args.at( arg ).isNull( row ) )
+        ++arg;
+      if ( arg < args.size() )
+        appendFrom( result, args.at( arg ), row );
+      else
+        result.appendNull();
+    }
+    return true;
+  }
+
+  const bool mathFunction = name == QLatin1String( "abs" ) || name == QLatin1String( "sqrt" ) || name == QLatin1String( "floor" ) || name == QLatin1String( "ceil" ) || name == QLatin1String( "round" );
+  const bool stringFunction = name == QLatin1String( "upper" ) || name == QLatin1String( "lower" ) || name == QLatin1String( "length" );
+  if ( !mathFunction && !stringFunction )
+    return false;
+
+  // round() always gets its "places" argument, only rounding to integers is handled here
+  if ( name == QLatin1String( "round" ) && argNodes.size() == 2 )
+  {
+    const QgsExpressionNode *places = argNodes.at( 1 );
+    const QVariant placesValue = places->hasCachedStaticValue() ? places->cachedStaticValue()
+                                 : places->nodeType() == QgsExpressionNode::ntLiteral ? static_cast< const QgsExpressionNodeLiteral * >( places )->value() : QVariant( 1 );
+    if ( QgsVariantUtils::isNull( placesValue ) || placesValue.toInt() != 0 )
+      return false;
+  }
+  else if ( argNodes.size() != 1 )
+  {
+    return false;
+  }
+
+  const Column arg = evaluateNode( argNodes.at( 0 ), batch, context, selected );
+
+  if ( mathFunction )
+  {
+    if ( !isNumeric( arg ) )
+      return false;
+
+    const bool round = name == QLatin1String( "round" );
+    result = Column( round ? ColumnType::Int64 : ColumnType::Double );
+    result.reserve( rows );
+    for ( int row = 0; row < rows; ++row )
+    {
+      if ( arg.isNull( row ) )
+      {
+        result.appendNull();
+        continue;
+      }
+
+      const double value = doubleValue( arg, row );
+      if ( round )
+        result.appendInt64( static_cast< qint64 >( std::round( value ) ) );
+      else if ( name == QLatin1String( "abs" ) )
+        result.appendDouble( std::fabs( value ) );
+      else if ( name == QLatin1String( "sqrt" ) )
+        result.appendDouble( std::sqrt( value ) );
+      else if ( name == QLatin1String( "floor" ) )
+        result.appendDouble( std::floor( value ) );
+      else
+        result.appendDouble( std::ceil( value ) );
+    }
+    return true;
+  }
+
+  if ( stringFunction )
+  {
+    if ( arg.type() != ColumnType::String )
+      return false;
+
+    const bool length = name == QLatin1String( "length" );
+    const bool upper = name == QLatin1String( "upper" );
+    result = Column( length ? ColumnType::Int64 : ColumnType::String );
+    result.reserve( rows );
+    for ( int row = 0; row < rows; ++row )
+    {
+      if ( arg.isNull( row ) )
+        result.appendNull();
+      else if ( length )
+        result.appendInt64( arg.stringValue( row ).length() );
+      else
+        result.appendString( upper ? arg.stringValue( row ).toUpper() : arg.stringValue( row ).toLower() );
+    }
+    return true;
+  }
+
+  return false;
+}
+
+QgsFeatureBatch::Column QgsExpressionBatchEvaluator::tvlColumn( const QgsFeatureBatch::Column &column, const QVector< bool > &selected )
+{
+  if ( isNumeric( column ) )
+    return column;
+
+  // other values are converted as the node tree does
+  const int rows = column.size();
+  Column result( ColumnType::Int64 );
+  result.reserve( rows );
+  for ( int row = 0; row < rows; ++row )
+  {
+    if ( !selected.at( row ) || mErrorRows.at( row ) || column.isNull( row ) )
+    {
+      result.appendNull();
+      continue;
+    }
+
+    const QgsExpressionUtils::TVL value = QgsExpressionUtils::getTVLValue( column.value( row ), mExpression );
+    if ( mExpression->hasEvalError() )
+    {
+      mErrorRows[ row ] = true;
+      mEvalErrorString = mExpression->evalErrorString();
+      mExpression->setEvalErrorString( QString() );
+      result.appendNull();
+      continue;
+    }
+    appendTvl( result, value == QgsExpressionUtils::Unknown ? Tvl::Unknown : ( value == QgsExpressionUtils::True ? Tvl::True : Tvl::False ) );
+  }
+  return result;
+}
+
+QgsFeatureBatch::Column QgsExpressionBatchEvaluator::evaluateRows( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected )
+{
+  mUsedRowFallback = true;
+
+  const int rows = batch.size();
+  Column result( ColumnType::Variant );
+  result.reserve( rows );
+
+  // nodes are evaluated in place, exactly as QgsExpression::evaluate() does
+  QgsExpressionNode *evaluatedNode = const_cast< QgsExpressionNode * >( node );
+  QgsFeature feature( batch.fields() );
+  for ( int row = 0; row < rows; ++row )
+  {
+    if ( !selected.at( row ) || mErrorRows.at( row ) )
+    {
+      result.appendNull();
+      continue;
+    }
+
+    feature.setId( batch.ids().at( row ) );
+    feature.setAttributes( batch.attributes( row ) );
+    context->setFeature( feature );
+    result.appendValue( evaluatedNode->eval( mExpression, context ) );
+    if ( mExpression->hasEvalError() )
+    {
+      mErrorRows[ row ] = true;
+      mEvalErrorString = mExpression->evalErrorString();
+      mExpression->setEvalErrorString( QString() );
+    }
+  }
+  return result;
+}
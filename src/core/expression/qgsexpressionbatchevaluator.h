@@ -0,0 +1,100 @@
+/***************************************************************************
+                         qgsexpressionbatchevaluator.h
+                         -----------------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSEXPRESSIONBATCHEVALUATOR_H
+#define QGSEXPRESSIONBATCHEVALUATOR_H
+
+#include "qgis_core.h"
+#include "qgsfeaturebatch.h"
+
+#define SIP_NO_FILE
+
+class QgsExpression;
+class QgsExpressionContext;
+class QgsExpressionNode;
+
+/**
+ * \ingroup core
+ * \class QgsExpressionBatchEvaluator
+ *
+ * \brief Evaluates an expression over all the features of a QgsFeatureBatch at once.
+ *
+ * The node tree of the expression is walked once per batch instead of once per feature.
+ * Literals, field references, arithmetic, comparisons, logical operators, CASE and a set of
+ * common math and string functions (abs, sqrt, floor, ceil, round, upper, lower, length
+ * and coalesce) are evaluated with tight loops over the typed batch columns. Any other
+ * node is evaluated feature by feature, so the result is always the same as the one of
+ * QgsExpression::evaluate().
+ *
+ * As in QgsExpression::evaluate(), nodes are only evaluated feature by feature for the features
+ * which reach them: the right operand of AND and OR is skipped for the features decided by the
+ * left operand and the branches of CASE only for the features taking them. Features for which the
+ * evaluation raised an error get a NULL value.
+ *
+ * Boolean results are stored as 0 and 1 in Int64 columns, matching the values returned by
+ * QgsExpression::evaluate().
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsExpressionBatchEvaluator
+{
+  public:
+
+    /**
+     * Constructor for QgsExpressionBatchEvaluator, evaluating \a expression.
+     * The expression must outlive the evaluator.
+     */
+    explicit QgsExpressionBatchEvaluator( QgsExpression *expression );
+
+    /**
+     * Evaluates the expression for all the features of \a batch and returns the results, one
+     * value per feature.
+     *
+     * The expression is prepared with \a context if required. Fields which are not part of the
+     * batch are considered NULL.
+     *
+     * If the evaluation raised an error for some features, the error of the last of them is
+     * set on the expression, see QgsExpression::evalErrorString().
+     */
+    QgsFeatureBatch::Column evaluate( const QgsFeatureBatch &batch, QgsExpressionContext *context );
+
+    /**
+     * Returns TRUE if some nodes were evaluated feature by feature during the last evaluate() call.
+     */
+    bool usedRowFallback() const { return mUsedRowFallback; }
+
+  private:
+
+    /**
+     * The values of the rows which are not \a selected are not used by the caller, they are only
+     * computed when this is cheaper than skipping them and never evaluated feature by feature.
+     */
+    QgsFeatureBatch::Column evaluateNode( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected );
+    bool evaluateUnary( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected, QgsFeatureBatch::Column &result );
+    bool evaluateBinary( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected, QgsFeatureBatch::Column &result );
+    bool evaluateCondition( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected, QgsFeatureBatch::Column &result );
+    bool evaluateFunction( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected, QgsFeatureBatch::Column &result );
+    QgsFeatureBatch::Column evaluateRows( const QgsExpressionNode *node, const QgsFeatureBatch &batch, QgsExpressionContext *context, const QVector< bool > &selected );
+    //! Converts the \a selected values of \a column to three valued logic values, returns numeric columns as they are
+    QgsFeatureBatch::Column tvlColumn( const QgsFeatureBatch::Column &column, const QVector< bool > &selected );
+
+    QgsExpression *mExpression = nullptr;
+    bool mUsedRowFallback = false;
+    //! Rows for which the evaluation raised an error, their evaluation stops there
+    QVector< bool > mErrorRows;
+    QString mEvalErrorString;
+};
+
+#endif // QGSEXPRESSIONBATCHEVALUATOR_H
@@ -0,0 +1,1032 @@
+/***************************************************************************
+                         qgsexpressionbytecode.cpp
+                         -------------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsexpressionbytecode_p.h"
+#include "qgsexpression.h"
+#include "qgsexpressioncontext.h"
+#include "qgsexpressionfunction.h"
+#include "qgsexpressionnodeimpl.h"
+#include "qgsexpressionutils.h"
+#include "qgsfeature.h"
+#include "qgsvariantutils.h"
+#include "qgis.h"
+
+#include <QVarLengthArray>
+#include <cmath>
+
+///@cond PRIVATE
+
+typedef QgsExpressionBytecode::Value Value;
+typedef QgsExpressionBytecode::Type Type;
+typedef QgsExpressionNodeBinaryOperator::BinaryOperator BinaryOperator;
+
+namespace
+{
+  Type typeForVariantType( QVariant::Type type )
+  {
+    switch ( type )
+    {
+      case QVariant::Int:
+      case QVariant::UInt:
+      case QVariant::LongLong:
+      case QVariant::ULongLong:
+        return Type::Int;
+
+      case QVariant::Double:
+        return Type::Double;
+
+      case QVariant::String:
+        return Type::String;
+
+      default:
+        return Type::Variant;
+    }
+  }
+
+  void setValue( Value &result, const QVariant &value )
+  {
+    result.variant = value;
+    result.nativeInt = false;
+    if ( QgsVariantUtils::isNull( value ) )
+    {
+      result.type = Type::Null;
+      return;
+    }
+
+    result.type = typeForVariantType( value.type() );
+    if ( result.type == Type::Int )
+      result.intValue = value.toLongLong();
+    else if ( result.type == Type::Double )
+      result.doubleValue = value.toDouble();
+  }
+
+  QVariant toVariant( const Value &value )
+  {
+    switch ( value.type )
+    {
+      case Type::Int:
+        if ( value.variant.isValid() )
+          return value.variant;
+        return value.nativeInt ? QVariant( static_cast< int >( value.intValue ) ) : QVariant( static_cast< qlonglong >( value.intValue ) );
+
+      case Type::Double:
+        if ( value.variant.isValid() )
+          return value.variant;
+        return QVariant( value.doubleValue );
+
+      case Type::Null:
+      case Type::String:
+      case Type::Variant:
+        break;
+    }
+    return value.variant;
+  }
+
+  void setNull( Value &result )
+  {
+    result.type = Type::Null;
+    result.variant = QVariant();
+  }
+
+  void setInt( Value &result, qint64 value, bool nativeInt = false )
+  {
+    result.type = Type::Int;
+    result.nativeInt = nativeInt;
+    result.intValue = value;
+    result.variant = QVariant();
+  }
+
+  void setDouble( Value &result, double value )
+  {
+    result.type = Type::Double;
+    result.doubleValue = value;
+    result.variant = QVariant();
+  }
+
+  void setString( Value &result, const QString &value )
+  {
+    result.type = Type::String;
+    result.variant = value;
+  }
+
+  void setTvl( Value &result, QgsExpressionUtils::TVL value )
+  {
+    if ( value == QgsExpressionUtils::Unknown )
+      setNull( result );
+    else
+      setInt( result, value == QgsExpressionUtils::True ? 1 : 0, true );
+  }
+
+  bool isNumeric( Type type )
+  {
+    return type == Type::Int || type == Type::Double;
+  }
+
+  //! Converts a non NULL numeric \a value, returns FALSE where QgsExpressionUtils::getDoubleValue() would raise an error
+  bool toDouble( const Value &value, double &result )
+  {
+    if ( value.type == Type::Int )
+    {
+      result = static_cast< double >( value.intValue );
+      return true;
+    }
+    if ( value.type == Type::Double && std::isfinite( value.doubleValue ) )
+    {
+      result = value.doubleValue;
+      return true;
+    }
+    return false;
+  }
+
+  //! Matches QgsExpressionUtils::getTVLValue(), returns FALSE for the values it would need to convert
+  bool toTvlFast( const Value &value, QgsExpressionUtils::TVL &result )
+  {
+    switch ( value.type )
+    {
+      case Type::Null:
+        result = QgsExpressionUtils::Unknown;
+        return true;
+
+      case Type::Int:
+        result = value.intValue != 0 ? QgsExpressionUtils::True : QgsExpressionUtils::False;
+        return true;
+
+      case Type::Double:
+        result = !qgsDoubleNear( value.doubleValue, 0.0 ) ? QgsExpressionUtils::True : QgsExpressionUtils::False;
+        return true;
+
+      case Type::String:
+        return false;
+
+      case Type::Variant:
+        if ( value.variant.type() != QVariant::Bool )
+          return false;
+        result = value.variant.toBool() ? QgsExpressionUtils::True : QgsExpressionUtils::False;
+        return true;
+    }
+    return false;
+  }
+
+  //! Converts \a value as QgsExpressionUtils::getTVLValue() does, returns FALSE if the conversion raised an evaluation error
+  bool toTvl( QgsExpression *parent, const Value &value, QgsExpressionUtils::TVL &result )
+  {
+    if ( toTvlFast( value, result ) )
+      return true;
+    result = QgsExpressionUtils::getTVLValue( toVariant( value ), parent );
+    return !parent->hasEvalError();
+  }
+
+  //! Matches QgsExpressionNodeBinaryOperator::compare()
+  bool compareDiff( int op, double diff )
+  {
+    switch ( op )
+    {
+      case QgsExpressionNodeBinaryOperator::boEQ:
+        return qgsDoubleNear( diff, 0.0 );
+      case QgsExpressionNodeBinaryOperator::boNE:
+        return !qgsDoubleNear( diff, 0.0 );
+      case QgsExpressionNodeBinaryOperator::boLT:
+        return diff < 0;
+      case QgsExpressionNodeBinaryOperator::boGT:
+        return diff > 0;
+      case QgsExpressionNodeBinaryOperator::boLE:
+        return diff <= 0;
+      case QgsExpressionNodeBinaryOperator::boGE:
+        return diff >= 0;
+      default:
+        return false;
+    }
+  }
+
+  qint64 computeInt( int op, qint64 x, qint64 y )
+  {
+    switch ( op )
+    {
+      case QgsExpressionNodeBinaryOperator::boPlus:
+        return x + y;
+      case QgsExpressionNodeBinaryOperator::boMinus:
+        return x - y;
+      case QgsExpressionNodeBinaryOperator::boMul:
+        return x * y;
+      case QgsExpressionNodeBinaryOperator::boMod:
+        return x % y;
+      default:
+        return 0;
+    }
+  }
+
+  //! Double arithmetic of QgsExpressionNodeBinaryOperator, returns FALSE when the result is NULL
+  bool computeDouble( int op, double x, double y, double &result )
+  {
+    switch ( op )
+    {
+      case QgsExpressionNodeBinaryOperator::boPlus:
+        result = x + y;
+        return true;
+      case QgsExpressionNodeBinaryOperator::boMinus:
+        result = x - y;
+        return true;
+      case QgsExpressionNodeBinaryOperator::boMul:
+        result = x * y;
+        return true;
+      case QgsExpressionNodeBinaryOperator::boDiv:
+        result = x / y;
+        return y != 0.;
+      case QgsExpressionNodeBinaryOperator::boMod:
+        result = std::fmod( x, y );
+        return y != 0.;
+      case QgsExpressionNodeBinaryOperator::boPow:
+        result = std::pow( x, y );
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  Type commonType( Type a, Type b )
+  {
+    if ( a == Type::Null )
+      return b;
+    if ( b == Type::Null || a == b )
+      return a;
+    return Type::Variant;
+  }
+}
+
+std::unique_ptr< QgsExpressionBytecode > QgsExpressionBytecode::compile( QgsExpressionNode *root, const QgsExpressionContext *context )
+{
+  if ( !root || root->hasCachedStaticValue() )
+    return nullptr;
+
+  std::unique_ptr< QgsExpressionBytecode > program( new QgsExpressionBytecode() );
+  program->mResultRegister = program->compileNode( root, context );
+
+  // nothing gained if the whole tree is evaluated by a single instruction
+  if ( program->mCompiledNodes == 0 )
+    return nullptr;
+
+  return program;
+}
+
+int QgsExpressionBytecode::compileNode( QgsExpressionNode *node, const QgsExpressionContext *context )
+{
+  // matches QgsExpressionNode::eval()
+  if ( node->hasCachedStaticValue() )
+    return constantRegister( node->cachedStaticValue() );
+  if ( node->effectiveNode() != node )
+    return compileNode( const_cast< QgsExpressionNode * >( node->effectiveNode() ), context );
+
+  const int firstInstruction = mInstructions.size();
+  const int firstRegister = mRegisterTypes.size();
+  const int firstFieldLoad = mFieldLoads.size();
+  const int compiledNodes = mCompiledNodes;
+  const bool usesFeature = mUsesFeature;
+
+  const int result = compileNodeInstructions( node, context );
+  if ( !canFallbackAfterEvalNode( firstInstruction ) )
+    return result;
+
+  // giving up after a node was evaluated through the tree would evaluate it once more, e.g. calling rand() or
+  // running an aggregate twice, so the whole node is evaluated through the tree instead
+  mInstructions.resize( firstInstruction );
+  mRegisterTypes.resize( firstRegister );
+  mRegisters.resize( firstRegister );
+  mFieldLoads.resize( firstFieldLoad );
+  mCompiledNodes = compiledNodes;
+  mUsesFeature = usesFeature;
+  return evalNodeRegister( node );
+}
+
+int QgsExpressionBytecode::compileNodeInstructions( QgsExpressionNode *node, const QgsExpressionContext *context )
+{
+  switch ( node->nodeType() )
+  {
+    case QgsExpressionNode::ntLiteral:
+      return constantRegister( static_cast< const QgsExpressionNodeLiteral * >( node )->value() );
+
+    case QgsExpressionNode::ntColumnRef:
+    {
+      // same lookup as QgsExpressionNodeColumnRef::prepareNode()
+      if ( !context || !context->hasVariable( QgsExpressionContext::EXPR_FIELDS ) )
+        break;
+
+      const QString name = static_cast< const QgsExpressionNodeColumnRef * >( node )->name();
+      const QgsFields fields = qvariant_cast<QgsFields>( context->variable( QgsExpressionContext::EXPR_FIELDS ) );
+      int index = fields.lookupField( name );
+      Type type = index >= 0 ? typeForVariantType( fields.at( index ).type() ) : Type::Variant;
+      if ( index == -1 && context->hasFeature() )
+        index = context->feature().fieldNameIndex( name );
+      if ( index == -1 )
+        break;
+
+      // fields are loaded before running the instructions, so that their types are checked before any node is evaluated through the tree
+      FieldLoad load;
+      load.result = addRegister( type );
+      load.index = index;
+      load.type = type;
+      mFieldLoads.append( load );
+      mUsesFeature = true;
+      mCompiledNodes++;
+      return load.result;
+    }
+
+    case QgsExpressionNode::ntUnaryOperator:
+    {
+      const QgsExpressionNodeUnaryOperator *unaryNode = static_cast< const QgsExpressionNodeUnaryOperator * >( node );
+      const int operand = compileNode( unaryNode->operand(), context );
+      const bool negate = unaryNode->op() == QgsExpressionNodeUnaryOperator::uoMinus;
+      const Type operandType = mRegisterTypes.at( operand );
+      const int result = addRegister( !negate ? Type::Int : isNumeric( operandType ) ? operandType : Type::Variant );
+      addInstruction( negate ? OpCode::Negate : OpCode::Not, result, operand );
+      mCompiledNodes++;
+      return result;
+    }
+
+    case QgsExpressionNode::ntBinaryOperator:
+      return compileBinary( node, context );
+
+    case QgsExpressionNode::ntCondition:
+      return compileCondition( node, context );
+
+    case QgsExpressionNode::ntFunction:
+      return compileFunction( node, context );
+
+    case QgsExpressionNode::ntInOperator:
+    case QgsExpressionNode::ntIndexOperator:
+    case QgsExpressionNode::ntBetweenOperator:
+      break;
+  }
+
+  return evalNodeRegister( node );
+}
+
+int QgsExpressionBytecode::compileBinary( QgsExpressionNode *node, const QgsExpressionContext *context )
+{
+  const QgsExpressionNodeBinaryOperator *binaryNode = static_cast< const QgsExpressionNodeBinaryOperator * >( node );
+  const BinaryOperator op = binaryNode->op();
+
+  switch ( op )
+  {
+    case QgsExpressionNodeBinaryOperator::boAnd:
+    case QgsExpressionNodeBinaryOperator::boOr:
+    {
+      // the right operand is skipped if the left one decides the result
+      const int left = compileNode( binaryNode->opLeft(), context );
+      const int result = addRegister( Type::Int );
+      const int shortCircuit = addInstruction( OpCode::ShortCircuit, result, left, 0, op );
+      const int right = compileNode( binaryNode->opRight(), context );
+      addInstruction( OpCode::Logical, result, left, right, op );
+      mInstructions[ shortCircuit ].target = mInstructions.size();
+      mCompiledNodes++;
+      return result;
+    }
+
+    case QgsExpressionNodeBinaryOperator::boPlus:
+    case QgsExpressionNodeBinaryOperator::boMinus:
+    case QgsExpressionNodeBinaryOperator::boMul:
+    case QgsExpressionNodeBinaryOperator::boDiv:
+    case QgsExpressionNodeBinaryOperator::boMod:
+    case QgsExpressionNodeBinaryOperator::boPow:
+    {
+      const int left = compileNode( binaryNode->opLeft(), context );
+      const int right = compileNode( binaryNode->opRight(), context );
+      const Type leftType = mRegisterTypes.at( left );
+      const Type rightType = mRegisterTypes.at( right );
+      int result = -1;
+      if ( leftType == Type::Int && rightType == Type::Int && op != QgsExpressionNodeBinaryOperator::boDiv && op != QgsExpressionNodeBinaryOperator::boPow )
+      {
+        result = addRegister( Type::Int );
+        addInstruction( OpCode::ArithmeticInt, result, left, right, op );
+      }
+      else if ( isNumeric( leftType ) && isNumeric( rightType ) )
+      {
+        result = addRegister( Type::Double );
+        addInstruction( OpCode::ArithmeticDouble, result, left, right, op );
+      }
+      else
+      {
+        result = addRegister( Type::Variant );
+        addInstruction( OpCode::Arithmetic, result, left, right, op );
+      }
+      mCompiledNodes++;
+      return result;
+    }
+
+    case QgsExpressionNodeBinaryOperator::boIntDiv:
+    case QgsExpressionNodeBinaryOperator::boEQ:
+    case QgsExpressionNodeBinaryOperator::boNE:
+    case QgsExpressionNodeBinaryOperator::boLT:
+    case QgsExpressionNodeBinaryOperator::boGT:
+    case QgsExpressionNodeBinaryOperator::boLE:
+    case QgsExpressionNodeBinaryOperator::boGE:
+    case QgsExpressionNodeBinaryOperator::boIs:
+    case QgsExpressionNodeBinaryOperator::boIsNot:
+    case QgsExpressionNodeBinaryOperator::boConcat:
+    {
+      const int left = compileNode( binaryNode->opLeft(), context );
+      const int right = compileNode( binaryNode->opRight(), context );
+      OpCode code = OpCode::Compare;
+      if ( op == QgsExpressionNodeBinaryOperator::boIntDiv )
+        code = OpCode::IntDivision;
+      else if ( op == QgsExpressionNodeBinaryOperator::boIs || op == QgsExpressionNodeBinaryOperator::boIsNot )
+        code = OpCode::Is;
+      else if ( op == QgsExpressionNodeBinaryOperator::boConcat )
+        code = OpCode::Concat;
+      else if ( isNumeric( mRegisterTypes.at( left ) ) && isNumeric( mRegisterTypes.at( right ) ) )
+        code = OpCode::CompareNumeric;
+
+      const int result = addRegister( code == OpCode::Concat ? Type::String : Type::Int );
+      addInstruction( code, result, left, right, op );
+      mCompiledNodes++;
+      return result;
+    }
+
+    case QgsExpressionNodeBinaryOperator::boRegexp:
+    case QgsExpressionNodeBinaryOperator::boLike:
+    case QgsExpressionNodeBinaryOperator::boNotLike:
+    case QgsExpressionNodeBinaryOperator::boILike:
+    case QgsExpressionNodeBinaryOperator::boNotILike:
+      break;
+  }
+
+  return evalNodeRegister( node );
+}
+
+int QgsExpressionBytecode::compileCondition( QgsExpressionNode *node, const QgsExpressionContext *context )
+{
+  const QgsExpressionNodeCondition *conditionNode = static_cast< const QgsExpressionNodeCondition * >( node );
+  const int result = addRegister( Type::Null );
+  QVector< int > endJumps;
+  Type type = Type::Null;
+
+  const QgsExpressionNodeCondition::WhenThenList conditions = conditionNode->conditions();
+  for ( const QgsExpressionNodeCondition::WhenThen *condition : conditions )
+  {
+    const int when = compileNode( condition->whenExp(), context );
+    const int jumpToNext = addInstruction( OpCode::JumpIfNotTrue, 0, when );
+    const int then = compileNode( condition->thenExp(), context );
+    addInstruction( OpCode::Move, result, then );
+    endJumps << addInstruction( OpCode::Jump, 0 );
+    mInstructions[ jumpToNext ].target = mInstructions.size();
+    type = commonType( type, mRegisterTypes.at( then ) );
+  }
+
+  if ( conditionNode->elseExp() )
+  {
+    const int elseResult = compileNode( conditionNode->elseExp(), context );
+    addInstruction( OpCode::Move, result, elseResult );
+    type = commonType( type, mRegisterTypes.at( elseResult ) );
+  }
+  else
+  {
+    addInstruction( OpCode::LoadNull, result );
+  }
+
+  for ( int jump : std::as_const( endJumps ) )
+    mInstructions[ jump ].target = mInstructions.size();
+
+  mRegisterTypes[ result ] = type;
+  mCompiledNodes++;
+  return result;
+}
+
+int QgsExpressionBytecode::compileFunction( QgsExpressionNode *node, const QgsExpressionContext *context )
+{
+  const QgsExpressionNodeFunction *functionNode = static_cast< const QgsExpressionNodeFunction * >( node );
+  const QString name = QgsExpression::Functions().at( functionNode->fnIndex() )->name();
+
+  // functions can be overridden by the context
+  if ( ( context && context->hasFunction( name ) ) || !functionNode->args() )
+    return evalNodeRegister( node );
+
+  const QList< QgsExpressionNode * > argNodes = functionNode->args()->list();
+
+  if ( name == QLatin1String( "coalesce" ) && !argNodes.isEmpty() )
+  {
+    // all the arguments are evaluated first, as QgsExpressionFunction::run() does
+    QVector< int > args;
+    Type type = Type::Null;
+    for ( QgsExpressionNode *argNode : argNodes )
+    {
+      args << compileNode( argNode, context );
+      type = commonType( type, mRegisterTypes.at( args.constLast() ) );
+    }
+
+    const int result = addRegister( type );
+    QVector< int > endJumps;
+    for ( int arg : std::as_const( args ) )
+      endJumps << addInstruction( OpCode::MoveIfNotNull, result, arg );
+    addInstruction( OpCode::LoadNull, result );
+    for ( int jump : std::as_const( endJumps ) )
+      mInstructions[ jump ].target = mInstructions.size();
+    mCompiledNodes++;
+    return result;
+  }
+
+  Function function = Function::Abs;
+  Type type = Type::Double;
+  if ( name == QLatin1String( "abs" ) )
+    function = Function::Abs;
+  else if ( name == QLatin1String( "sqrt" ) )
+    function = Function::Sqrt;
+  else if ( name == QLatin1String( "floor" ) )
+    function = Function::Floor;
+  else if ( name == QLatin1String( "ceil" ) )
+    function = Function::Ceil;
+  else if ( name == QLatin1String( "round" ) )
+  {
+    function = Function::Round;
+    type = Type::Int;
+  }
+  else if ( name == QLatin1String( "upper" ) )
+  {
+    function = Function::Upper;
+    type = Type::String;
+  }
+  else if ( name == QLatin1String( "lower" ) )
+  {
+    function = Function::Lower;
+    type = Type::String;
+  }
+  else if ( name == QLatin1String( "length" ) )
+  {
+    function = Function::Length;
+    type = Type::Int;
+  }
+  else
+  {
+    return evalNodeRegister( node );
+  }
+
+  // round() always gets its "places" argument, only rounding to integers is compiled
+  if ( function == Function::Round && argNodes.size() == 2 )
+  {
+    const QgsExpressionNode *places = argNodes.at( 1 );
+    const QVariant placesValue = places->hasCachedStaticValue() ? places->cachedStaticValue()
+                                 : places->nodeType() == QgsExpressionNode::ntLiteral ? static_cast< const QgsExpressionNodeLiteral * >( places )->value() : QVariant( 1 );
+    if ( QgsVariantUtils::isNull( placesValue ) || placesValue.toInt() != 0 )
+      return evalNodeRegister( node );
+  }
+  else if ( argNodes.size() != 1 )
+  {
+    return evalNodeRegister( node );
+  }
+
+  const int arg = compileNode( argNodes.at( 0 ), context );
+  const int result = addRegister( type );
+  addInstruction( OpCode::Function, result, arg, 0, static_cast< int >( function ) );
+  mCompiledNodes++;
+  return result;
+}
+
+int QgsExpressionBytecode::constantRegister( const QVariant &value )
+{
+  // constant registers are never written when running the program
+  Value constant;
+  setValue( constant, value );
+  const int result = addRegister( constant.type );
+  mRegisters[ result ] = constant;
+  return result;
+}
+
+int QgsExpressionBytecode::evalNodeRegister( QgsExpressionNode *node )
+{
+  const int result = addRegister( Type::Variant );
+  const int instruction = addInstruction( OpCode::EvalNode, result );
+  mInstructions[ instruction ].node = node;
+  return result;
+}
+
+bool QgsExpressionBytecode::canFallback( const Instruction &instruction ) const
+{
+  const Type left = mRegisterTypes.at( instruction.left );
+  const Type right = mRegisterTypes.at( instruction.right );
+  switch ( instruction.code )
+  {
+    case OpCode::EvalNode:
+    case OpCode::Move:
+    case OpCode::MoveIfNotNull:
+    case OpCode::LoadNull:
+    case OpCode::Jump:
+    case OpCode::JumpIfNotTrue:
+    case OpCode::Not:
+    case OpCode::ArithmeticInt:
+    case OpCode::Concat:
+    case OpCode::ShortCircuit:
+    case OpCode::Logical:
+      return false;
+
+    case OpCode::ArithmeticDouble:
+      // only non finite values are left to the tree
+      return ( left != Type::Int && left != Type::Null ) || ( right != Type::Int && right != Type::Null );
+
+    case OpCode::CompareNumeric:
+    case OpCode::Compare:
+    case OpCode::Is:
+      return left != Type::Null && right != Type::Null
+             && !( left == Type::Int && right == Type::Int )
+             && !( left == Type::String && right == Type::String );
+
+    case OpCode::Function:
+      switch ( static_cast< Function >( instruction.op ) )
+      {
+        case Function::Abs:
+        case Function::Sqrt:
+        case Function::Floor:
+        case Function::Ceil:
+        case Function::Round:
+          return left != Type::Int && left != Type::Null;
+
+        case Function::Upper:
+        case Function::Lower:
+        case Function::Length:
+          return left == Type::Variant;
+      }
+      return true;
+
+    case OpCode::Negate:
+    case OpCode::Arithmetic:
+    case OpCode::IntDivision:
+      // NULL values are left to the tree as well
+      return true;
+  }
+  return true;
+}
+
+bool QgsExpressionBytecode::canFallbackAfterEvalNode( int firstInstruction ) const
+{
+  // jumps only go forward, so a single pass finds the instructions which may run after an EvalNode
+  const int size = mInstructions.size();
+  QVector< bool > afterEvalNode( size - firstInstruction + 1, false );
+  for ( int i = firstInstruction; i < size; ++i )
+  {
+    const Instruction &instruction = mInstructions.at( i );
+    const bool reached = afterEvalNode.at( i - firstInstruction );
+    if ( reached && canFallback( instruction ) )
+      return true;
+
+    const bool next = reached || instruction.code == OpCode::EvalNode;
+    if ( !next )
+      continue;
+    if ( instruction.code != OpCode::Jump )
+      afterEvalNode[ i - firstInstruction + 1 ] = true;
+    if ( instruction.code == OpCode::Jump || instruction.code == OpCode::JumpIfNotTrue || instruction.code == OpCode::MoveIfNotNull || instruction.code == OpCode::ShortCircuit )
+      afterEvalNode[ instruction.target - firstInstruction ] = true;
+  }
+  return false;
+}
+
+int QgsExpressionBytecode::addRegister( Type type )
+{
+  mRegisterTypes.append( type );
+  mRegisters.append( Value() );
+  return mRegisterTypes.size() - 1;
+}
+
+int QgsExpressionBytecode::addInstruction( OpCode code, int result, int left, int right, int op )
+{
+  Instruction instruction;
+  instruction.code = code;
+  instruction.result = result;
+  instruction.left = left;
+  instruction.right = right;
+  instruction.op = op;
+  mInstructions.append( instruction );
+  return mInstructions.size() - 1;
+}
+
+bool QgsExpressionBytecode::fallback() const
+{
+  mFallbackCount.ref();
+  return false;
+}
+
+bool QgsExpressionBytecode::isWorthwhile() const
+{
+  const int evaluations = mEvaluationCount.loadRelaxed();
+  return evaluations < 64 || mFallbackCount.loadRelaxed() * 8 < evaluations;
+}
+
+bool QgsExpressionBytecode::evaluate( QgsExpression *parent, const QgsExpressionContext *context, QVariant &result ) const
+{
+  mEvaluationCount.ref();
+
+  QgsFeature feature;
+  if ( mUsesFeature )
+  {
+    // QgsExpressionNodeColumnRef::evalNode() reports an error for invalid features
+    if ( !context )
+      return fallback();
+    feature = context->feature();
+    if ( !feature.isValid() )
+      return fallback();
+  }
+
+  // the registers are copied so that implicitly shared expressions can be evaluated from several threads
+  QVarLengthArray< Value, 32 > registerValues;
+  registerValues.append( mRegisters.constData(), mRegisters.size() );
+  Value *registers = registerValues.data();
+
+  for ( const FieldLoad &load : mFieldLoads )
+  {
+    Value &out = registers[ load.result ];
+    setValue( out, feature.attribute( load.index ) );
+    if ( load.type != Type::Variant && out.type != Type::Null && out.type != load.type )
+      return fallback();
+  }
+
+  const Instruction *instructions = mInstructions.constData();
+  const int size = mInstructions.size();
+  int pc = 0;
+  while ( pc < size )
+  {
+    const Instruction &instruction = instructions[ pc++ ];
+    Value &out = registers[ instruction.result ];
+    const Value &left = registers[ instruction.left ];
+    const Value &right = registers[ instruction.right ];
+
+    switch ( instruction.code )
+    {
+      case OpCode::EvalNode:
+        setValue( out, instruction.node->eval( parent, context ) );
+        if ( parent->hasEvalError() )
+        {
+          // errors propagate to the root of the tree as NULL values
+          result = QVariant();
+          return true;
+        }
+        break;
+
+      case OpCode::Move:
+        out = left;
+        break;
+
+      case OpCode::MoveIfNotNull:
+        if ( left.type != Type::Null )
+        {
+          out = left;
+          pc = instruction.target;
+        }
+        break;
+
+      case OpCode::LoadNull:
+        setNull( out );
+        break;
+
+      case OpCode::Jump:
+        pc = instruction.target;
+        break;
+
+      case OpCode::JumpIfNotTrue:
+      {
+        QgsExpressionUtils::TVL tvl;
+        if ( !toTvl( parent, left, tvl ) )
+        {
+          result = QVariant();
+          return true;
+        }
+        if ( tvl != QgsExpressionUtils::True )
+          pc = instruction.target;
+        break;
+      }
+
+      case OpCode::Negate:
+        if ( left.type == Type::Int )
+          setInt( out, -left.intValue );
+        else if ( left.type == Type::Double && std::isfinite( left.doubleValue ) )
+          setDouble( out, -left.doubleValue );
+        else
+          return fallback();
+        break;
+
+      case OpCode::Not:
+      {
+        QgsExpressionUtils::TVL tvl;
+        if ( !toTvl( parent, left, tvl ) )
+        {
+          result = QVariant();
+          return true;
+        }
+        setTvl( out, QgsExpressionUtils::NOT[tvl] );
+        break;
+      }
+
+      case OpCode::ArithmeticInt:
+        if ( left.type == Type::Null || right.type == Type::Null || ( instruction.op == QgsExpressionNodeBinaryOperator::boMod && right.intValue == 0 ) )
+          setNull( out );
+        else
+          setInt( out, computeInt( instruction.op, left.intValue, right.intValue ) );
+        break;
+
+      case OpCode::ArithmeticDouble:
+      case OpCode::Arithmetic:
+      {
+        if ( instruction.code == OpCode::Arithmetic )
+        {
+          // strings are concatenated by "+", dates and intervals have their own arithmetic
+          if ( left.type == Type::String || left.type == Type::Variant || right.type == Type::String || right.type == Type::Variant )
+            return fallback();
+          if ( instruction.op == QgsExpressionNodeBinaryOperator::boPlus && ( left.variant.type() == QVariant::String || right.variant.type() == QVariant::String ) )
+            return fallback();
+        }
+
+        if ( left.type == Type::Null || right.type == Type::Null )
+        {
+          setNull( out );
+        }
+        else if ( left.type == Type::Int && right.type == Type::Int && instruction.op != QgsExpressionNodeBinaryOperator::boDiv && instruction.op != QgsExpressionNodeBinaryOperator::boPow )
+        {
+          if ( instruction.op == QgsExpressionNodeBinaryOperator::boMod && right.intValue == 0 )
+            setNull( out );
+          else
+            setInt( out, computeInt( instruction.op, left.intValue, right.intValue ) );
+        }
+        else
+        {
+          double x = 0;
+          double y = 0;
+          double value = 0;
+          if ( !toDouble( left, x ) || !toDouble( right, y ) )
+            return fallback();
+          if ( computeDouble( instruction.op, x, y, value ) )
+            setDouble( out, value );
+          else
+            setNull( out );
+        }
+        break;
+      }
+
+      case OpCode::IntDivision:
+      {
+        // NULL values are left to the tree, QgsExpressionUtils::getDoubleValue() converts typed ones to 0
+        double x = 0;
+        double y = 0;
+        if ( !toDouble( left, x ) || !toDouble( right, y ) )
+          return fallback();
+        if ( y == 0. )
+          setNull( out );
+        else
+          setInt( out, static_cast< qlonglong >( std::floor( x / y ) ) );
+        break;
+      }
+
+      case OpCode::CompareNumeric:
+      case OpCode::Compare:
+      {
+        if ( left.type == Type::Null || right.type == Type::Null )
+        {
+          setNull( out );
+          break;
+        }
+
+        double x = 0;
+        double y = 0;
+        if ( isNumeric( left.type ) && isNumeric( right.type ) )
+        {
+          if ( !toDouble( left, x ) || !toDouble( right, y ) )
+            return fallback();
+          setTvl( out, compareDiff( instruction.op, x - y ) ? QgsExpressionUtils::True : QgsExpressionUtils::False );
+        }
+        else if ( left.type == Type::String && right.type == Type::String )
+        {
+          const int diff = QString::compare( left.variant.toString(), right.variant.toString() );
+          setTvl( out, compareDiff( instruction.op, diff ) ? QgsExpressionUtils::True : QgsExpressionUtils::False );
+        }
+        else
+        {
+          return fallback();
+        }
+        break;
+      }
+
+      case OpCode::Is:
+      {
+        const bool is = instruction.op == QgsExpressionNodeBinaryOperator::boIs;
+        bool equal = false;
+        if ( left.type == Type::Null || right.type == Type::Null )
+        {
+          equal = left.type == right.type;
+        }
+        else if ( isNumeric( left.type ) && isNumeric( right.type ) )
+        {
+          double x = 0;
+          double y = 0;
+          if ( !toDouble( left, x ) || !toDouble( right, y ) )
+            return fallback();
+          equal = qgsDoubleNear( x, y );
+        }
+        else if ( left.type == Type::String && right.type == Type::String )
+        {
+          equal = QString::compare( left.variant.toString(), right.variant.toString() ) == 0;
+        }
+        else
+        {
+          return fallback();
+        }
+        setTvl( out, equal == is ? QgsExpressionUtils::True : QgsExpressionUtils::False );
+        break;
+      }
+
+      case OpCode::Concat:
+        if ( left.type == Type::Null || right.type == Type::Null )
+          setNull( out );
+        else
+          setString( out, toVariant( left ).toString() + toVariant( right ).toString() );
+        break;
+
+      case OpCode::ShortCircuit:
+      {
+        QgsExpressionUtils::TVL tvl;
+        if ( !toTvl( parent, left, tvl ) )
+        {
+          result = QVariant();
+          return true;
+        }
+        if ( instruction.op == QgsExpressionNodeBinaryOperator::boAnd && tvl == QgsExpressionUtils::False )
+        {
+          setTvl( out, QgsExpressionUtils::False );
+          pc = instruction.target;
+        }
+        else if ( instruction.op == QgsExpressionNodeBinaryOperator::boOr && tvl == QgsExpressionUtils::True )
+        {
+          setTvl( out, QgsExpressionUtils::True );
+          pc = instruction.target;
+        }
+        break;
+      }
+
+      case OpCode::Logical:
+      {
+        QgsExpressionUtils::TVL tvlLeft;
+        QgsExpressionUtils::TVL tvlRight;
+        if ( !toTvl( parent, left, tvlLeft ) || !toTvl( parent, right, tvlRight ) )
+        {
+          result = QVariant();
+          return true;
+        }
+        setTvl( out, instruction.op == QgsExpressionNodeBinaryOperator::boAnd ? QgsExpressionUtils::AND[tvlLeft][tvlRight] : QgsExpressionUtils::OR[tvlLeft][tvlRight] );
+        break;
+      }
+
+      case OpCode::Function:
+      {
+        if ( left.type == Type::Null )
+        {
+          setNull( out );
+          break;
+        }
+
+        const Function function = static_cast< Function >( instruction.op );
+        switch ( function )
+        {
+          case Function::Abs:
+          case Function::Sqrt:
+          case Function::Floor:
+          case Function::Ceil:
+          case Function::Round:
+          {
+            double x = 0;
+            if ( !toDouble( left, x ) )
+              return fallback();
+            if ( function == Function::Round )
+              setInt( out, static_cast< qlonglong >( std::round( x ) ) );
+            else
+              setDouble( out, function == Function::Abs ? std::fabs( x ) : function == Function::Sqrt ? std::sqrt( x ) : function == Function::Floor ? std::floor( x ) : std::ceil( x ) );
+            break;
+          }
+
+          case Function::Upper:
+          case Function::Lower:
+            if ( left.type == Type::Variant )
+              return fallback();
+            setString( out, function == Function::Upper ? toVariant( left ).toString().toUpper() : toVariant( left ).toString().toLower() );
+            break;
+
+          case Function::Length:
+            // geometries have their own length
+            if ( left.type == Type::Variant )
+              return fallback();
+            setInt( out, toVariant( left ).toString().length(), true );
+            break;
+        }
+        break;
+      }
+    }
+  }
+
+  result = toVariant( registers[ mResultRegister ] );
+  return true;
+}
+
+///@endcond
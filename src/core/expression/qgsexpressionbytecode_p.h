@@ -0,0 +1,200 @@
+/***************************************************************************
+                         qgsexpressionbytecode_p.h
+                         -------------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSEXPRESSIONBYTECODE_P_H
+#define QGSEXPRESSIONBYTECODE_P_H
+
+#include "qgis_core.h"
+
+#include <QAtomicInt>
+#include <QVariant>
+#include <QVector>
+#include <memory>
+
+class QgsExpression;
+class QgsExpressionContext;
+class QgsExpressionNode;
+
+///@cond PRIVATE
+#define SIP_NO_FILE
+
+/**
+ * \brief Register based program compiled from the node tree of a prepared QgsExpression.
+ *
+ * Literals, field references, arithmetic, comparisons, logical operators, CASE and a set of
+ * common functions (abs, sqrt, floor, ceil, round, upper, lower, length and coalesce) are lowered
+ * into a flat list of instructions executed by a single dispatch loop. Static subtrees are folded
+ * into constant registers and the types of the fields of the preparation context are used to pick
+ * integer or floating point instructions upfront. Any other node is evaluated through the tree
+ * from within the program.
+ *
+ * When a value does not have the type the program was compiled for, evaluate() gives up and the
+ * expression must be evaluated through the tree instead, so results are always identical. Nodes
+ * after which the program could give up once a node was evaluated through the tree are not compiled,
+ * so that no node is evaluated twice for a feature.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsExpressionBytecode
+{
+  public:
+
+    //! Type of a value, as known at compile time or met when running the program. Variant matches any type at compile time.
+    enum class Type : quint8
+    {
+      Null,
+      Int,
+      Double,
+      String,
+      Variant,
+    };
+
+    //! Value stored in a register
+    struct Value
+    {
+      Type type = Type::Null;
+      //! TRUE if integer values are returned as int instead of qlonglong QVariants
+      bool nativeInt = false;
+      qint64 intValue = 0;
+      double doubleValue = 0;
+      //! String values, or the original value of fields and constants
+      QVariant variant;
+    };
+
+    /**
+     * Compiles the prepared node tree starting at \a root, using the fields of \a context.
+     *
+     * Returns NULLPTR when the tree would not benefit from compilation, e.g. when it is static
+     * or when no part of it can be compiled.
+     */
+    static std::unique_ptr< QgsExpressionBytecode > compile( QgsExpressionNode *root, const QgsExpressionContext *context );
+
+    /**
+     * Runs the program for the feature of \a context and stores its value in \a result.
+     *
+     * Returns FALSE if the program met a value it does not handle, in which case the expression
+     * must be evaluated through its node tree.
+     */
+    bool evaluate( QgsExpression *parent, const QgsExpressionContext *context, QVariant &result ) const;
+
+    /**
+     * Returns FALSE if evaluate() gave up for too many features for the program to be worth
+     * running.
+     */
+    bool isWorthwhile() const;
+
+    /**
+     * Returns the number of times evaluate() gave up.
+     */
+    int fallbackCount() const { return mFallbackCount.loadRelaxed(); }
+
+    /**
+     * Returns the number of instructions of the program.
+     */
+    int instructionCount() const { return mInstructions.size(); }
+
+  private:
+
+    enum class OpCode : quint8
+    {
+      EvalNode,
+      Move,
+      MoveIfNotNull,
+      LoadNull,
+      Jump,
+      JumpIfNotTrue,
+      Negate,
+      Not,
+      ArithmeticInt,
+      ArithmeticDouble,
+      Arithmetic,
+      IntDivision,
+      CompareNumeric,
+      Compare,
+      Is,
+      Concat,
+      ShortCircuit,
+      Logical,
+      Function,
+    };
+
+    enum class Function : quint8
+    {
+      Abs,
+      Sqrt,
+      Floor,
+      Ceil,
+      Round,
+      Upper,
+      Lower,
+      Length,
+    };
+
+    struct Instruction
+    {
+      OpCode code;
+      //! Operator, function or expected field type
+      int op = 0;
+      int result = 0;
+      int left = 0;
+      int right = 0;
+      //! Jump target
+      int target = 0;
+      QgsExpressionNode *node = nullptr;
+    };
+
+    //! Field loaded into a register before running the instructions
+    struct FieldLoad
+    {
+      int result = 0;
+      int index = 0;
+      //! Expected field type
+      Type type = Type::Variant;
+    };
+
+    QgsExpressionBytecode() = default;
+
+    int compileNode( QgsExpressionNode *node, const QgsExpressionContext *context );
+    int compileNodeInstructions( QgsExpressionNode *node, const QgsExpressionContext *context );
+    int compileBinary( QgsExpressionNode *node, const QgsExpressionContext *context );
+    int compileCondition( QgsExpressionNode *node, const QgsExpressionContext *context );
+    int compileFunction( QgsExpressionNode *node, const QgsExpressionContext *context );
+    int constantRegister( const QVariant &value );
+    int evalNodeRegister( QgsExpressionNode *node );
+    int addRegister( Type type );
+    int addInstruction( OpCode code, int result, int left = 0, int right = 0, int op = 0 );
+    bool fallback() const;
+
+    //! Returns TRUE if evaluate() may give up when running \a instruction
+    bool canFallback( const Instruction &instruction ) const;
+
+    //! Returns TRUE if evaluate() may give up after running an EvalNode instruction, from \a firstInstruction on
+    bool canFallbackAfterEvalNode( int firstInstruction ) const;
+
+    QVector< Instruction > mInstructions;
+    QVector< FieldLoad > mFieldLoads;
+    QVector< Value > mRegisters;
+    QVector< Type > mRegisterTypes;
+    int mResultRegister = -1;
+    bool mUsesFeature = false;
+    int mCompiledNodes = 0;
+
+    mutable QAtomicInt mEvaluationCount;
+    mutable QAtomicInt mFallbackCount;
+};
+
+///@endcond
+
+#endif // QGSEXPRESSIONBYTECODE_P_H
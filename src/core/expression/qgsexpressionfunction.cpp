@@ -7516,6 +7516,9 @@ static QVariant executeGeomOverlay( const QVariantList &values, const QgsExpress
       subExpression = QgsExpression( subExpString );
       subContext = QgsExpressionContext( QgsExpressionContextUtils::globalProjectLayerScopes( targetLayer ) );
       subExpression.prepare( &subContext );
+      // the prepared expression only depends on the target layer, so it is reused for the next features
+      context->setCachedValue( expCacheKey, QVariant::fromValue( subExpression ) );
+      context->setCachedValue( ctxCacheKey, QVariant::fromValue( subContext ) );
     }
     else
     {
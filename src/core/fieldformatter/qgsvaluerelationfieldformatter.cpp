@@ -30,6 +30,7 @@
 using namespace nlohmann;
 
 #include <QSettings>
+#include <algorithm>
 
 bool orderByKeyLessThan( const QgsValueRelationFieldFormatter::ValueRelationItem &p1, const QgsValueRelationFieldFormatter::ValueRelationItem &p2 )
 {
@@ -80,9 +81,10 @@ QString QgsValueRelationFieldFormatter::representValue( QgsVectorLayer *layer, i
 
     QStringList valueList;
 
+    const QSet< QString > keys = qgis::listToSet( keyList );
     for ( const QgsValueRelationFieldFormatter::ValueRelationItem &item : std::as_const( vrCache ) )
     {
-      if ( keyList.contains( item.key.toString() ) )
+      if ( keys.contains( item.key.toString() ) )
       {
         valueList << item.value;
       }
@@ -97,6 +99,20 @@ QString QgsValueRelationFieldFormatter::representValue( QgsVectorLayer *layer, i
       return QgsApplication::nullRepresentation();
     }
 
+    // the cache is sorted by key unless ordered by value, so keys of the same type as the value
+    // are found by a binary search. Other keys are still compared one by one below.
+    if ( !config.value( QStringLiteral( "OrderByValue" ) ).toBool() && !vrCache.isEmpty() && vrCache.constFirst().key.userType() == value.userType() )
+    {
+      const auto it = std::lower_bound( vrCache.constBegin(), vrCache.constEnd(), value, []( const QgsValueRelationFieldFormatter::ValueRelationItem & item, const QVariant & key )
+      {
+        return qgsVariantLessThan( item.key, key );
+      } );
+      if ( it != vrCache.constEnd() && it->key == value )
+      {
+        return it->value;
+      }
+    }
+
     for ( const QgsValueRelationFieldFormatter::ValueRelationItem &item : std::as_const( vrCache ) )
     {
       if ( item.key == value )
@@ -2198,6 +2198,37 @@ GEOSCoordSequence *QgsGeos::createCoordinateSequence( const QgsCurve *curve, dou
     }
     return coordSeq;
   }
+  else if ( precision > 0. )
+  {
+    // round the coordinates into temporary arrays, which are copied at once into the sequence
+    const int numOutPoints = forceClose && ( line->pointN( 0 ) != line->pointN( numPoints - 1 ) ) ? numPoints + 1 : numPoints;
+    QVector< double > x( numOutPoints );
+    QVector< double > y( numOutPoints );
+    QVector< double > z( hasZ ? numOutPoints : 0 );
+    const double *xData = line->xData();
+    const double *yData = line->yData();
+    const double *zData = hasZ ? line->zData() : nullptr;
+    for ( int i = 0; i < numOutPoints; ++i )
+    {
+      // the point closing a ring is read back from the start of the line
+      const int index = i < numPoints ? i : 0;
+      x[i] = std::round( xData[index] / precision ) * precision;
+      y[i] = std::round( yData[index] / precision ) * precision;
+      if ( hasZ )
+        z[i] = std::round( zData[index] / precision ) * precision;
+    }
+    try
+    {
+      coordSeq = GEOSCoordSeq_copyFromArrays_r( ctxt, x.constData(), y.constData(), !hasZ ? nullptr : z.constData(), nullptr, numOutPoints );
+      if ( !coordSeq )
+      {
+        QgsDebugMsg( QStringLiteral( "GEOS Exception: Could not create coordinate sequence for %1 points" ).arg( numOutPoints ) );
+        return nullptr;
+      }
+    }
+    CATCH_GEOS( nullptr )
+    return coordSeq;
+  }
 #endif
 
   int coordDims = 2;
@@ -1677,23 +1677,71 @@ void QgsLineString::transform( const QTransform &t, double zTranslate, double zS
   double *y = mY.data();
   double *z = hasZ ? mZ.data() : nullptr;
   double *m = hasM ? mM.data() : nullptr;
-  for ( int i = 0; i < nPoints; ++i )
+
+  // each dimension is transformed in its own loop, and affine matrices are applied directly
+  // instead of through QTransform::map(), so that the loops can be vectorized
+  switch ( t.type() )
   {
-    double xOut, yOut;
-    t.map( *x, *y, &xOut, &yOut );
-    *x++ = xOut;
-    *y++ = yOut;
-    if ( hasZ )
+    case QTransform::TxNone:
+      break;
+
+    case QTransform::TxTranslate:
+    case QTransform::TxScale:
     {
-      *z = *z * zScale + zTranslate;
-      z++;
+      const double m11 = t.m11();
+      const double m22 = t.m22();
+      const double dx = t.dx();
+      const double dy = t.dy();
+      for ( int i = 0; i < nPoints; ++i )
+      {
+        x[i] = m11 * x[i] + dx;
+        y[i] = m22 * y[i] + dy;
+      }
+      break;
     }
-    if ( hasM )
+
+    case QTransform::TxRotate:
+    case QTransform::TxShear:
     {
-      *m = *m * mScale + mTranslate;
-      m++;
+      const double m11 = t.m11();
+      const double m12 = t.m12();
+      const double m21 = t.m21();
+      const double m22 = t.m22();
+      const double dx = t.dx();
+      const double dy = t.dy();
+      for ( int i = 0; i < nPoints; ++i )
+      {
+        const double xIn = x[i];
+        const double yIn = y[i];
+        x[i] = m11 * xIn + m21 * yIn + dx;
+        y[i] = m12 * xIn + m22 * yIn + dy;
+      }
+      break;
+    }
+
+    case QTransform::TxProject:
+    {
+      for ( int i = 0; i < nPoints; ++i )
+      {
+        double xOut, yOut;
+        t.map( x[i], y[i], &xOut, &yOut );
+        x[i] = xOut;
+        y[i] = yOut;
+      }
+      break;
     }
   }
+
+  if ( hasZ )
+  {
+    for ( int i = 0; i < nPoints; ++i )
+      z[i] = z[i] * zScale + zTranslate;
+  }
+  if ( hasM )
+  {
+    for ( int i = 0; i < nPoints; ++i )
+      m[i] = m[i] * mScale + mTranslate;
+  }
   clearCache();
 }
 
@@ -1975,23 +2023,8 @@ void QgsLineString::importVerticesFromWkb( const QgsConstWkbPtr &wkb )
   mY.resize( nVertices );
   hasZ ? mZ.resize( nVertices ) : mZ.clear();
   hasM ? mM.resize( nVertices ) : mM.clear();
-  double *x = mX.data();
-  double *y = mY.data();
-  double *m = hasM ? mM.data() : nullptr;
-  double *z = hasZ ? mZ.data() : nullptr;
-  for ( int i = 0; i < nVertices; ++i )
-  {
-    wkb >> *x++;
-    wkb >> *y++;
-    if ( hasZ )
-    {
-      wkb >> *z++;
-    }
-    if ( hasM )
-    {
-      wkb >> *m++;
-    }
-  }
+  // the bounds of all the vertices are checked once, instead of once per ordinate
+  wkb.readVertices( nVertices, mX.data(), mY.data(), hasZ ? mZ.data() : nullptr, hasM ? mM.data() : nullptr );
   clearCache(); //set bounding box invalid
 }
 
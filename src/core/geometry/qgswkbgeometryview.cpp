@@ -0,0 +1,262 @@
+/***************************************************************************
+                         qgswkbgeometryview.cpp
+                         ----------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgswkbgeometryview.h"
+#include "qgsabstractgeometry.h"
+#include "qgslogger.h"
+
+#include <cmath>
+#include <limits>
+
+QgsWkbGeometryView::QgsWkbGeometryView( const QByteArray &wkb )
+  : mWkb( wkb )
+{
+  if ( mWkb.isEmpty() )
+    return;
+
+  try
+  {
+    const QgsConstWkbPtr wkbPtr( mWkb );
+    mWkbType = wkbPtr.readHeader();
+    mDirectlyReadable = scan( QgsConstWkbPtr( mWkb ) );
+  }
+  catch ( const QgsWkbException &e )
+  {
+    Q_UNUSED( e )
+    QgsDebugMsg( "WKB exception while reading geometry: " + e.what() );
+    mDirectlyReadable = false;
+  }
+}
+
+bool QgsWkbGeometryView::isDirectlyReadableType( QgsWkbTypes::Type type )
+{
+  switch ( QgsWkbTypes::flatType( type ) )
+  {
+    case QgsWkbTypes::Point:
+    case QgsWkbTypes::LineString:
+    case QgsWkbTypes::Polygon:
+    case QgsWkbTypes::Triangle:
+    case QgsWkbTypes::MultiPoint:
+    case QgsWkbTypes::MultiLineString:
+    case QgsWkbTypes::MultiPolygon:
+    case QgsWkbTypes::GeometryCollection:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+bool QgsWkbGeometryView::scan( const QgsConstWkbPtr &wkbPtr )
+{
+  const QgsWkbTypes::Type type = wkbPtr.readHeader();
+  if ( !isDirectlyReadableType( type ) )
+    return false;
+
+  const int pointSize = QgsWkbTypes::coordDimensions( type ) * static_cast< int >( sizeof( double ) );
+  switch ( QgsWkbTypes::flatType( type ) )
+  {
+    case QgsWkbTypes::Point:
+      if ( wkbPtr.remaining() < pointSize )
+        return false;
+      wkbPtr += pointSize;
+      return true;
+
+    case QgsWkbTypes::LineString:
+    {
+      int count = 0;
+      wkbPtr >> count;
+      if ( count < 0 || count > wkbPtr.remaining() / pointSize )
+        return false;
+      wkbPtr += count * pointSize;
+      return true;
+    }
+
+    case QgsWkbTypes::Polygon:
+    case QgsWkbTypes::Triangle:
+    {
+      int ringCount = 0;
+      wkbPtr >> ringCount;
+      if ( ringCount < 0 )
+        return false;
+      for ( int ring = 0; ring < ringCount; ++ring )
+      {
+        int count = 0;
+        wkbPtr >> count;
+        if ( count < 0 || count > wkbPtr.remaining() / pointSize )
+          return false;
+        wkbPtr += count * pointSize;
+      }
+      return true;
+    }
+
+    default:
+    {
+      int partCount = 0;
+      wkbPtr >> partCount;
+      if ( partCount < 0 )
+        return false;
+      for ( int part = 0; part < partCount; ++part )
+      {
+        if ( !scan( wkbPtr ) )
+          return false;
+      }
+      return true;
+    }
+  }
+}
+
+void QgsWkbGeometryView::visitPointSequences( const QgsConstWkbPtr &wkbPtr, const std::function< void( const QgsConstWkbPtr &, int, int, bool ) > &visitor )
+{
+  const QgsWkbTypes::Type type = wkbPtr.readHeader();
+  const int dimensions = QgsWkbTypes::coordDimensions( type );
+  switch ( QgsWkbTypes::flatType( type ) )
+  {
+    case QgsWkbTypes::Point:
+      visitor( wkbPtr, 1, dimensions, false );
+      break;
+
+    case QgsWkbTypes::LineString:
+    {
+      int count = 0;
+      wkbPtr >> count;
+      visitor( wkbPtr, count, dimensions, false );
+      break;
+    }
+
+    case QgsWkbTypes::Polygon:
+    case QgsWkbTypes::Triangle:
+    {
+      int ringCount = 0;
+      wkbPtr >> ringCount;
+      for ( int ring = 0; ring < ringCount; ++ring )
+      {
+        int count = 0;
+        wkbPtr >> count;
+        visitor( wkbPtr, count, dimensions, ring > 0 );
+      }
+      break;
+    }
+
+    default:
+    {
+      int partCount = 0;
+      wkbPtr >> partCount;
+      for ( int part = 0; part < partCount; ++part )
+        visitPointSequences( wkbPtr, visitor );
+      break;
+    }
+  }
+}
+
+QgsRectangle QgsWkbGeometryView::boundingBox() const
+{
+  if ( !mDirectlyReadable )
+    return geometry().boundingBox();
+
+  double xMin = std::numeric_limits< double >::max();
+  double yMin = std::numeric_limits< double >::max();
+  double xMax = std::numeric_limits< double >::lowest();
+  double yMax = std::numeric_limits< double >::lowest();
+  visitPointSequences( QgsConstWkbPtr( mWkb ), [&xMin, &yMin, &xMax, &yMax]( const QgsConstWkbPtr & wkbPtr, int count, int dimensions, bool interiorRing )
+  {
+    const int skipZM = ( dimensions - 2 ) * static_cast< int >( sizeof( double ) );
+
+    // like QgsCurvePolygon::boundingBox(), only the exterior ring of polygons is considered
+    if ( interiorRing )
+    {
+      wkbPtr += count * ( 2 * static_cast< int >( sizeof( double ) ) + skipZM );
+      return;
+    }
+
+    double x = 0;
+    double y = 0;
+    for ( int i = 0; i < count; ++i )
+    {
+      wkbPtr >> x >> y;
+      wkbPtr += skipZM;
+
+      // empty points are stored with NaN coordinates
+      if ( std::isnan( x ) )
+        continue;
+
+      xMin = std::min( xMin, x );
+      yMin = std::min( yMin, y );
+      xMax = std::max( xMax, x );
+      yMax = std::max( yMax, y );
+    }
+  } );
+
+  if ( xMin > xMax )
+    return QgsRectangle();
+
+  return QgsRectangle( xMin, yMin, xMax, yMax, false );
+}
+
+int QgsWkbGeometryView::vertexCount() const
+{
+  if ( !mDirectlyReadable )
+  {
+    const QgsGeometry g = geometry();
+    return g.isNull() ? 0 : g.constGet()->nCoordinates();
+  }
+
+  int vertexCount = 0;
+  visitPointSequences( QgsConstWkbPtr( mWkb ), [&vertexCount]( const QgsConstWkbPtr & wkbPtr, int count, int dimensions, bool )
+  {
+    vertexCount += count;
+    wkbPtr += count * dimensions * static_cast< int >( sizeof( double ) );
+  } );
+  return vertexCount;
+}
+
+void QgsWkbGeometryView::visitVertices( const std::function< void( double, double ) > &visitor ) const
+{
+  if ( !mDirectlyReadable )
+  {
+    const QgsGeometry g = geometry();
+    if ( g.isNull() )
+      return;
+
+    for ( auto it = g.constGet()->vertices_begin(); it != g.constGet()->vertices_end(); ++it )
+    {
+      const QgsPoint point = *it;
+      visitor( point.x(), point.y() );
+    }
+    return;
+  }
+
+  visitPointSequences( QgsConstWkbPtr( mWkb ), [&visitor]( const QgsConstWkbPtr & wkbPtr, int count, int dimensions, bool )
+  {
+    const int skipZM = ( dimensions - 2 ) * static_cast< int >( sizeof( double ) );
+    double x = 0;
+    double y = 0;
+    for ( int i = 0; i < count; ++i )
+    {
+      wkbPtr >> x >> y;
+      wkbPtr += skipZM;
+      visitor( x, y );
+    }
+  } );
+}
+
+QgsGeometry QgsWkbGeometryView::geometry() const
+{
+  QgsGeometry g;
+  if ( !mWkb.isEmpty() )
+    g.fromWkb( mWkb );
+  return g;
+}
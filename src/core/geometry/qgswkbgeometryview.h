@@ -0,0 +1,121 @@
+/***************************************************************************
+                         qgswkbgeometryview.h
+                         --------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSWKBGEOMETRYVIEW_H
+#define QGSWKBGEOMETRYVIEW_H
+
+#include "qgis_core.h"
+#include "qgsgeometry.h"
+#include "qgsrectangle.h"
+#include "qgswkbptr.h"
+#include "qgswkbtypes.h"
+
+#include <QByteArray>
+#include <functional>
+
+#define SIP_NO_FILE
+
+/**
+ * \ingroup core
+ * \class QgsWkbGeometryView
+ * \brief A read only view of a geometry stored as WKB, which does not build the geometry objects.
+ *
+ * The view shares the WKB data it is constructed from, and reads the bounding box and the vertices
+ * of the geometry directly from it. This avoids creating the QgsAbstractGeometry objects of the
+ * geometry when only these are required, e.g. to skip or simplify a feature before rendering it.
+ * geometry() creates the QgsGeometry from the WKB when it is required, e.g. for editing or a GEOS
+ * operation.
+ *
+ * Points, linestrings, polygons, triangles, their multi types and geometry collections of these,
+ * in any dimension, are read directly. The vertices of other types, such as curved geometries,
+ * are read from the geometry created from the WKB.
+ *
+ * \see QgsMapToPixelSimplifier::simplify()
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsWkbGeometryView
+{
+  public:
+
+    /**
+     * Constructor for QgsWkbGeometryView, for the geometry stored in \a wkb.
+     */
+    explicit QgsWkbGeometryView( const QByteArray &wkb );
+
+    /**
+     * Returns the WKB of the geometry.
+     */
+    const QByteArray &wkb() const { return mWkb; }
+
+    /**
+     * Returns the WKB type of the geometry, or QgsWkbTypes::Unknown if the WKB is empty.
+     */
+    QgsWkbTypes::Type wkbType() const { return mWkbType; }
+
+    /**
+     * Returns TRUE if the geometry is read directly from the WKB.
+     *
+     * This is FALSE for malformed WKB, and for the geometry types which need to be created from the
+     * WKB to read their vertices.
+     */
+    bool isDirectlyReadable() const { return mDirectlyReadable; }
+
+    /**
+     * Returns the bounding box of the geometry.
+     */
+    QgsRectangle boundingBox() const;
+
+    /**
+     * Returns the number of vertices of the geometry.
+     *
+     * \see QgsAbstractGeometry::nCoordinates()
+     */
+    int vertexCount() const;
+
+    /**
+     * Calls \a visitor with the x and y coordinates of each vertex of the geometry, in the order of
+     * the WKB.
+     */
+    void visitVertices( const std::function< void( double x, double y ) > &visitor ) const;
+
+    /**
+     * Creates the geometry stored in the WKB.
+     */
+    QgsGeometry geometry() const;
+
+    /**
+     * Returns TRUE if the geometries of \a type can be read directly from their WKB.
+     */
+    static bool isDirectlyReadableType( QgsWkbTypes::Type type );
+
+  private:
+
+    //! Checks that the geometry at \a wkbPtr is well formed and of a directly readable type, moving past it
+    static bool scan( const QgsConstWkbPtr &wkbPtr );
+
+    /**
+     * Calls \a visitor for each point sequence of the geometry at \a wkbPtr, with the count and dimensions of its
+     * coordinates and whether it is an interior ring. The visitor must read or skip the coordinates.
+     */
+    static void visitPointSequences( const QgsConstWkbPtr &wkbPtr, const std::function< void( const QgsConstWkbPtr &wkbPtr, int count, int dimensions, bool interiorRing ) > &visitor );
+
+    QByteArray mWkb;
+    QgsWkbTypes::Type mWkbType = QgsWkbTypes::Unknown;
+    bool mDirectlyReadable = false;
+};
+
+#endif // QGSWKBGEOMETRYVIEW_H
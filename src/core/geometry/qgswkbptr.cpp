@@ -99,3 +99,31 @@ const QgsConstWkbPtr &QgsConstWkbPtr::operator>>( QPolygonF &points ) const
   }
   return *this;
 }
+
+void QgsConstWkbPtr::readVertices( int count, double *x, double *y, double *z, double *m ) const
+{
+  if ( count <= 0 )
+    return;
+
+  const qint64 size = static_cast< qint64 >( count ) * ( 2 + ( z ? 1 : 0 ) + ( m ? 1 : 0 ) ) * static_cast< qint64 >( sizeof( double ) );
+  if ( !mP || size > mEnd - mP )
+    throw QgsWkbException( QStringLiteral( "wkb access out of bounds" ) );
+
+  auto readOrdinate = [this]( double * ordinate )
+  {
+    memcpy( ordinate, mP, sizeof( double ) );
+    mP += sizeof( double );
+    if ( mEndianSwap )
+      endian_swap( *ordinate );
+  };
+
+  for ( int i = 0; i < count; ++i )
+  {
+    readOrdinate( x++ );
+    readOrdinate( y++ );
+    if ( z )
+      readOrdinate( z++ );
+    if ( m )
+      readOrdinate( m++ );
+  }
+}
@@ -183,6 +183,18 @@ class CORE_EXPORT QgsConstWkbPtr
     //! Read a point array
     const QgsConstWkbPtr &operator>>( QPolygonF &points ) const; SIP_SKIP
 
+    /**
+     * Reads the ordinates of \a count vertices into the separate \a x, \a y, \a z and \a m arrays.
+     *
+     * The \a z and \a m arrays may be nullptr if the vertices do not have these ordinates. The bounds
+     * of the whole block of vertices are verified at once, before any vertex is read.
+     *
+     * \throws QgsWkbException if the WKB does not contain \a count vertices
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    void readVertices( int count, double *x, double *y, double *z, double *m ) const SIP_SKIP;
+
     inline void operator+=( int n ) const { verifyBound( n ); mP += n; } SIP_SKIP
     inline void operator-=( int n ) const { mP -= n; } SIP_SKIP
 
@@ -31,6 +31,8 @@
 #include "qgslabelingresults.h"
 #include "qgsfillsymbol.h"
 
+#include <QTransform>
+
 // helper function for checking for job cancellation within PAL
 static bool _palIsCanceled( void *ctx )
 {
@@ -351,6 +353,49 @@ void QgsLabelingEngine::solve( QgsRenderContext &context )
 
   mPal->registerCancellationCallback( &_palIsCanceled, reinterpret_cast< void * >( &context ) );
 
+  if ( !mPreviousLabelPositions.isEmpty() )
+  {
+    QHash< QPair< QString, QString >, const QgsAbstractLabelProvider * > providers;
+    for ( const QgsAbstractLabelProvider *provider : std::as_const( mProviders ) )
+      providers.insert( qMakePair( provider->layerId(), provider->providerId() ), provider );
+    for ( const QgsAbstractLabelProvider *provider : std::as_const( mSubProviders ) )
+      providers.insert( qMakePair( provider->layerId(), provider->providerId() ), provider );
+
+    // label positions are stored in real world coordinates, convert them back to the pre-rotated coordinates of the candidates
+    QTransform transform;
+    if ( !qgsDoubleNear( mMapSettings.rotation(), 0.0 ) )
+    {
+      const QgsPointXY center = mMapSettings.visibleExtent().center();
+      transform = QTransform::fromTranslate( center.x(), center.y() );
+      transform.rotate( -mMapSettings.rotation() );
+      transform.translate( -center.x(), -center.y() );
+    }
+
+    QHash< const QgsAbstractLabelProvider *, QHash< QgsFeatureId, QVector< pal::Pal::PreviousPosition > > > previousPositions;
+    for ( const QgsLabelPosition &position : std::as_const( mPreviousLabelPositions ) )
+    {
+      // curved labels are made of several parts, which cannot be matched to a single candidate
+      if ( position.isUnplaced || position.isPinned || position.groupedLabelId != 0 || position.cornerPoints.size() < 2 )
+        continue;
+
+      const QgsAbstractLabelProvider *provider = providers.value( qMakePair( position.layerID, position.providerID ) );
+      if ( !provider )
+        continue;
+
+      const QPointF origin = transform.map( position.cornerPoints.at( 0 ).toQPointF() );
+      const QPointF next = transform.map( position.cornerPoints.at( 1 ).toQPointF() );
+
+      pal::Pal::PreviousPosition previous;
+      previous.x = origin.x();
+      previous.y = origin.y();
+      previous.alpha = std::atan2( next.y() - origin.y(), next.x() - origin.x() );
+      previous.width = position.width;
+      previous.height = position.height;
+      previousPositions[ provider ][ position.featureId ].append( previous );
+    }
+    mPal->setPreviousPositions( previousPositions );
+  }
+
   QElapsedTimer t;
   t.start();
 
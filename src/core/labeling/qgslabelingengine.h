@@ -24,6 +24,7 @@
 #include "qgslabeling.h"
 #include "qgsfeedback.h"
 #include "qgslabelobstaclesettings.h"
+#include "qgslabelposition.h"
 
 class QgsLabelingEngine;
 class QgsLabelingResults;
@@ -394,6 +395,25 @@ class CORE_EXPORT QgsLabelingEngine
     //! For internal use by the providers
     QgsLabelingResults *results() const { return mResults.get(); }
 
+    /**
+     * Sets the label \a positions placed by a previous render of the map, e.g. before the map was panned.
+     *
+     * Labels are kept at their previous position when it is still one of their best candidates, so that
+     * they stay stable while the map is navigated.
+     *
+     * \see previousLabelPositions()
+     * \since QGIS 3.30
+     */
+    void setPreviousLabelPositions( const QList< QgsLabelPosition > &positions ) { mPreviousLabelPositions = positions; }
+
+    /**
+     * Returns the label positions placed by a previous render of the map.
+     *
+     * \see setPreviousLabelPositions()
+     * \since QGIS 3.30
+     */
+    QList< QgsLabelPosition > previousLabelPositions() const { return mPreviousLabelPositions; }
+
   protected:
     void processProvider( QgsAbstractLabelProvider *provider, QgsRenderContext &context, pal::Pal &p );
 
@@ -454,6 +474,8 @@ class CORE_EXPORT QgsLabelingEngine
 
     QStringList mLayerRenderingOrderIds;
 
+    QList< QgsLabelPosition > mPreviousLabelPositions;
+
 };
 
 /**
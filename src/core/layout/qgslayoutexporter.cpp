@@ -27,6 +27,8 @@
 #include "qgslinestring.h"
 #include "qgsmessagelog.h"
 #include "qgslabelingresults.h"
+#include "qgsmaprendererparalleljob.h"
+#include "qgsmaprenderercache.h"
 
 #include <QImageWriter>
 #include <QSize>
@@ -34,6 +36,9 @@
 #include <QBuffer>
 #include <QTimeZone>
 #include <QTextStream>
+#include <QtConcurrentRun>
+
+#include <algorithm>
 
 #include "gdal.h"
 #include "cpl_conv.h"
@@ -53,6 +58,17 @@ class LayoutContextPreviewSettingRestorer
     ~LayoutContextPreviewSettingRestorer()
     {
       mLayout->renderContext().mIsPreviewRender = mPreviousSetting;
+      if ( mPreviousSetting )
+      {
+        // the layer images reused by the maps during the export are no longer needed
+        QList< QgsLayoutItemMap * > maps;
+        mLayout->layoutItems( maps );
+        for ( QgsLayoutItemMap *map : std::as_const( maps ) )
+        {
+          map->mExportLayerCache.reset();
+          map->mExportLayerCacheParameters.clear();
+        }
+      }
     }
 
     LayoutContextPreviewSettingRestorer( const LayoutContextPreviewSettingRestorer &other ) = delete;
@@ -63,6 +79,14 @@ class LayoutContextPreviewSettingRestorer
     bool mPreviousSetting = false;
 };
 
+//! Returns the logical resolution of the images rendered with the \a dpi resolution
+static int imageLogicalDpi( double dpi )
+{
+  QImage image( 1, 1, QImage::Format_ARGB32 );
+  image.setDotsPerMeterX( static_cast< int >( std::round( dpi / 25.4 * 1000 ) ) );
+  return image.logicalDpiX();
+}
+
 class LayoutGuideHider
 {
   public:
@@ -367,6 +391,11 @@ class LayoutContextSettingsRestorer
 ///@endcond PRIVATE
 
 QgsLayoutExporter::ExportResult QgsLayoutExporter::exportToImage( const QString &filePath, const QgsLayoutExporter::ImageExportSettings &s )
+{
+  return exportToImagePrivate( filePath, s, nullptr );
+}
+
+QgsLayoutExporter::ExportResult QgsLayoutExporter::exportToImagePrivate( const QString &filePath, const QgsLayoutExporter::ImageExportSettings &s, QList< RenderedImagePage > *renderedPages )
 {
   if ( !mLayout )
     return PrintError;
@@ -403,6 +432,10 @@ QgsLayoutExporter::ExportResult QgsLayoutExporter::exportToImage( const QString
   mLayout->renderContext().setFlags( settings.flags );
   mLayout->renderContext().setPredefinedScales( settings.predefinedMapScales );
 
+  // the page images are rendered at the export resolution, unless their size is set
+  if ( settings.cropToContents || !settings.imageSize.isValid() )
+    prerenderMapLayers( mLayout, imageLogicalDpi( settings.dpi ) );
+
   QList< int > pages;
   if ( settings.pages.empty() )
   {
@@ -441,16 +474,31 @@ QgsLayoutExporter::ExportResult QgsLayoutExporter::exportToImage( const QString
       return MemoryError;
     }
 
-    if ( !saveImage( image, outputFilePath, pageDetails.extension, settings.exportMetadata ? mLayout->project() : nullptr ) )
+    RenderedImagePage renderedPage;
+    renderedPage.image = image;
+    renderedPage.filePath = outputFilePath;
+    renderedPage.format = pageDetails.extension;
+    renderedPage.dpi = settings.dpi;
+    if ( settings.exportMetadata && mLayout->project() )
     {
-      mErrorFileName = outputFilePath;
-      return FileError;
+      renderedPage.includeMetadata = true;
+      renderedPage.metadata = mLayout->project()->metadata();
     }
 
     const bool shouldGeoreference = ( page == worldFilePageNo );
     if ( shouldGeoreference )
     {
-      georeferenceOutputPrivate( outputFilePath, nullptr, bounds, settings.dpi, shouldGeoreference );
+      // the georeferencing is computed now, as the layout may have changed when the page is written
+      if ( QgsLayoutItemMap *referenceMap = mLayout->referenceMap() )
+      {
+        const std::unique_ptr<double[]> t = computeGeoTransform( referenceMap, bounds, settings.dpi );
+        if ( t )
+        {
+          renderedPage.georeference = true;
+          std::copy( t.get(), t.get() + 6, renderedPage.geoTransform );
+          renderedPage.crsWkt = referenceMap->crs().toWkt( QgsCoordinateReferenceSystem::WKT_PREFERRED_GDAL );
+        }
+      }
 
       if ( settings.generateWorldFile )
       {
@@ -464,13 +512,22 @@ QgsLayoutExporter::ExportResult QgsLayoutExporter::exportToImage( const QString
         QFileInfo fi( outputFilePath );
         // build the world file name
         QString outputSuffix = fi.suffix();
-        QString worldFileName = fi.absolutePath() + '/' + fi.completeBaseName() + '.'
-                                + outputSuffix.at( 0 ) + outputSuffix.at( fi.suffix().size() - 1 ) + 'w';
-
-        writeWorldFile( worldFileName, a, b, c, d, e, f );
+        renderedPage.worldFilePath = fi.absolutePath() + '/' + fi.completeBaseName() + '.'
+                                     + outputSuffix.at( 0 ) + outputSuffix.at( fi.suffix().size() - 1 ) + 'w';
+        const double parameters[6] = { a, b, c, d, e, f };
+        std::copy( parameters, parameters + 6, renderedPage.worldFileParameters );
       }
     }
 
+    if ( renderedPages )
+    {
+      renderedPages->append( renderedPage );
+    }
+    else if ( !writeImagePage( renderedPage ) )
+    {
+      mErrorFileName = outputFilePath;
+      return FileError;
+    }
   }
   captureLabelingResults();
   return Success;
@@ -483,6 +540,28 @@ QgsLayoutExporter::ExportResult QgsLayoutExporter::exportToImage( QgsAbstractLay
   if ( !iterator->beginRender() )
     return IteratorError;
 
+  // keeps the layer images reused by the maps for all the features
+  LayoutContextPreviewSettingRestorer iteratorRestorer( iterator->layout() );
+  ( void )iteratorRestorer;
+
+  // the layout can only be rendered from its thread, but the pages of a feature are encoded and written
+  // on a worker thread while the pages of the next feature are rendered
+  QFuture< bool > pendingWrite;
+  QString pendingFilePath;
+  const auto waitForPendingWrite = [&pendingWrite, &pendingFilePath, &error]() -> bool
+  {
+    if ( pendingFilePath.isEmpty() )
+      return true;
+
+    const bool written = pendingWrite.result();
+    pendingFilePath.clear();
+    if ( written )
+      return true;
+
+    error = QObject::tr( "Cannot write to %1. This file may be open in another application or may be an invalid path." ).arg( QDir::toNativeSeparators( pendingFilePath ) );
+    return false;
+  };
+
   int total = iterator->count();
   double step = total > 0 ? 100.0 / total : 100.0;
   int i = 0;
@@ -498,23 +577,48 @@ QgsLayoutExporter::ExportResult QgsLayoutExporter::exportToImage( QgsAbstractLay
     }
     if ( feedback && feedback->isCanceled() )
     {
+      waitForPendingWrite();
       iterator->endRender();
       return Canceled;
     }
 
     QgsLayoutExporter exporter( iterator->layout() );
     QString filePath = iterator->filePath( baseFilePath, extension );
-    ExportResult result = exporter.exportToImage( filePath, settings );
+    QList< RenderedImagePage > renderedPages;
+    ExportResult result = exporter.exportToImagePrivate( filePath, settings, &renderedPages );
+
+    // at most the pages of one feature are waiting to be written, to bound the memory use
+    if ( !waitForPendingWrite() )
+    {
+      iterator->endRender();
+      return FileError;
+    }
+
     if ( result != Success )
     {
-      if ( result == FileError )
-        error = QObject::tr( "Cannot write to %1. This file may be open in another application or may be an invalid path." ).arg( QDir::toNativeSeparators( filePath ) );
       iterator->endRender();
       return result;
     }
+
+    pendingFilePath = filePath;
+    pendingWrite = QtConcurrent::run( [renderedPages]
+    {
+      for ( const RenderedImagePage &page : renderedPages )
+      {
+        if ( !writeImagePage( page ) )
+          return false;
+      }
+      return true;
+    } );
     i++;
   }
 
+  if ( !waitForPendingWrite() )
+  {
+    iterator->endRender();
+    return FileError;
+  }
+
   if ( feedback )
   {
     feedback->setProgress( 100 );
@@ -726,6 +830,10 @@ QgsLayoutExporter::ExportResult QgsLayoutExporter::exportToPdf( QgsAbstractLayou
   if ( !iterator->beginRender() )
     return IteratorError;
 
+  // keeps the layer images reused by the maps for all the features
+  LayoutContextPreviewSettingRestorer iteratorRestorer( iterator->layout() );
+  ( void )iteratorRestorer;
+
   PdfExportSettings settings = s;
 
   QPrinter printer;
@@ -824,6 +932,10 @@ QgsLayoutExporter::ExportResult QgsLayoutExporter::exportToPdfs( QgsAbstractLayo
   if ( !iterator->beginRender() )
     return IteratorError;
 
+  // keeps the layer images reused by the maps for all the features
+  LayoutContextPreviewSettingRestorer iteratorRestorer( iterator->layout() );
+  ( void )iteratorRestorer;
+
   int total = iterator->count();
   double step = total > 0 ? 100.0 / total : 100.0;
   int i = 0;
@@ -916,6 +1028,10 @@ QgsLayoutExporter::ExportResult QgsLayoutExporter::print( QgsAbstractLayoutItera
   if ( !iterator->beginRender() )
     return IteratorError;
 
+  // keeps the layer images reused by the maps for all the features
+  LayoutContextPreviewSettingRestorer iteratorRestorer( iterator->layout() );
+  ( void )iteratorRestorer;
+
   PrintExportSettings settings = s;
 
   QPainter p;
@@ -1172,6 +1288,10 @@ QgsLayoutExporter::ExportResult QgsLayoutExporter::exportToSvg( QgsAbstractLayou
   if ( !iterator->beginRender() )
     return IteratorError;
 
+  // keeps the layer images reused by the maps for all the features
+  LayoutContextPreviewSettingRestorer iteratorRestorer( iterator->layout() );
+  ( void )iteratorRestorer;
+
   int total = iterator->count();
   double step = total > 0 ? 100.0 / total : 100.0;
   int i = 0;
@@ -1293,6 +1413,7 @@ QgsLayoutExporter::ExportResult QgsLayoutExporter::printPrivate( QPrinter &print
   int toPage = ( printer.toPage() < 1 ) ? mLayout->pageCollection()->pageCount() - 1 : printer.toPage() - 1;
 
   bool pageExported = false;
+  prerenderMapLayers( mLayout, rasterize ? imageLogicalDpi( dpi > 0 ? dpi : mLayout->renderContext().dpi() ) : printer.logicalDpiX() );
   if ( rasterize )
   {
     for ( int i = fromPage; i <= toPage; ++i )
@@ -1343,6 +1464,82 @@ QgsLayoutExporter::ExportResult QgsLayoutExporter::printPrivate( QPrinter &print
   return Success;
 }
 
+void QgsLayoutExporter::prerenderMapLayers( QgsLayout *layout, double dpi )
+{
+  struct MapPrerender
+  {
+    QgsMapRendererCache *cache = nullptr;
+    QString parameters;
+    QgsMapSettings settings;
+    std::unique_ptr< QgsMapRendererParallelJob > job;
+    //! Caches of the maps rendering the same layers with identical settings
+    QList< QgsMapRendererCache * > identicalCaches;
+  };
+
+  QList< QgsLayoutItemMap * > maps;
+  layout->layoutItems( maps );
+
+  std::vector< MapPrerender > prerenders;
+  for ( QgsLayoutItemMap *map : std::as_const( maps ) )
+  {
+    QgsMapSettings settings;
+    QgsMapRendererCache *cache = map->exportLayerPrerenderCache( dpi, settings );
+    if ( !cache )
+      continue;
+
+    // e.g. maps of the same extent on several pages only render their layers once
+    auto identical = std::find_if( prerenders.begin(), prerenders.end(), [map, &settings]( const MapPrerender & prerender )
+    {
+      return prerender.parameters == map->mExportLayerCacheParameters && prerender.settings.layers() == settings.layers()
+             && prerender.settings.flags() == settings.flags() && prerender.settings.outputSize() == settings.outputSize()
+             && prerender.settings.visibleExtent() == settings.visibleExtent() && prerender.settings.mapToPixel() == settings.mapToPixel();
+    } );
+    if ( identical != prerenders.end() )
+    {
+      identical->identicalCaches << cache;
+      continue;
+    }
+
+    MapPrerender prerender;
+    prerender.cache = cache;
+    prerender.parameters = map->mExportLayerCacheParameters;
+    prerender.settings = settings;
+    prerender.job = std::make_unique< QgsMapRendererParallelJob >( settings );
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+    prerender.job->setFeatureFilterProvider( layout->renderContext().featureFilterProvider() );
+#endif
+    prerender.job->setCache( cache );
+    prerenders.emplace_back( std::move( prerender ) );
+  }
+
+  // the maps render their layers concurrently, each one on several threads
+  for ( MapPrerender &prerender : prerenders )
+    prerender.job->start();
+
+  for ( MapPrerender &prerender : prerenders )
+  {
+    prerender.job->waitForFinished();
+    QgsLayoutItemMap::releaseDynamicLayerImages( prerender.cache, prerender.settings );
+
+    const QgsRectangle extent = prerender.settings.visibleExtent();
+    const QgsMapToPixel mapToPixel = prerender.settings.mapToPixel();
+    const QList< QgsMapLayer * > layers = prerender.settings.layers();
+    for ( QgsMapRendererCache *cache : std::as_const( prerender.identicalCaches ) )
+    {
+      cache->updateParameters( extent, mapToPixel );
+      for ( QgsMapLayer *layer : layers )
+      {
+        const QString cacheKey = layer->id();
+        if ( !prerender.cache->hasCacheImage( cacheKey ) )
+          continue;
+
+        cache->setCacheImageWithParameters( cacheKey, prerender.cache->cacheImage( cacheKey ), extent, mapToPixel, QList< QgsMapLayer * >() << layer );
+        cache->setCacheImageWithParameters( cacheKey + QStringLiteral( "_preview" ), prerender.cache->cacheImage( cacheKey ), extent, mapToPixel, QList< QgsMapLayer * >() << layer );
+      }
+    }
+  }
+}
+
 void QgsLayoutExporter::updatePrinterPageSize( QgsLayout *layout, QPrinter &printer, int page )
 {
   QgsLayoutSize pageSize = layout->pageCollection()->page( page )->sizeWithUnits();
@@ -1588,7 +1785,7 @@ std::unique_ptr<double[]> QgsLayoutExporter::computeGeoTransform( const QgsLayou
   return t;
 }
 
-void QgsLayoutExporter::writeWorldFile( const QString &worldFileName, double a, double b, double c, double d, double e, double f ) const
+void QgsLayoutExporter::writeWorldFile( const QString &worldFileName, double a, double b, double c, double d, double e, double f )
 {
   QFile worldFile( worldFileName );
   if ( !worldFile.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
@@ -2082,24 +2279,53 @@ void QgsLayoutExporter::captureLabelingResults()
   }
 }
 
-bool QgsLayoutExporter::saveImage( const QImage &image, const QString &imageFilename, const QString &imageFormat, QgsProject *projectForMetadata )
+bool QgsLayoutExporter::writeImagePage( const RenderedImagePage &page )
+{
+  if ( !saveImage( page.image, page.filePath, page.format, page.includeMetadata ? &page.metadata : nullptr ) )
+    return false;
+
+  if ( page.georeference )
+  {
+    // important - we need to manually specify the DPI in advance, as GDAL will otherwise
+    // assume a DPI of 150. The option is set for the current thread only, as pages may be written concurrently
+    CPLSetThreadLocalConfigOption( "GDAL_PDF_DPI", QString::number( page.dpi ).toUtf8().constData() );
+    gdal::dataset_unique_ptr outputDS( GDALOpen( page.filePath.toUtf8().constData(), GA_Update ) );
+    if ( outputDS )
+    {
+      double geoTransform[6];
+      std::copy( page.geoTransform, page.geoTransform + 6, geoTransform );
+      GDALSetGeoTransform( outputDS.get(), geoTransform );
+      GDALSetProjection( outputDS.get(), page.crsWkt.toLocal8Bit().constData() );
+    }
+    CPLSetThreadLocalConfigOption( "GDAL_PDF_DPI", nullptr );
+  }
+
+  if ( !page.worldFilePath.isEmpty() )
+  {
+    const double *p = page.worldFileParameters;
+    writeWorldFile( page.worldFilePath, p[0], p[1], p[2], p[3], p[4], p[5] );
+  }
+  return true;
+}
+
+bool QgsLayoutExporter::saveImage( const QImage &image, const QString &imageFilename, const QString &imageFormat, const QgsProjectMetadata *metadata )
 {
   QImageWriter w( imageFilename, imageFormat.toLocal8Bit().constData() );
   if ( imageFormat.compare( QLatin1String( "tiff" ), Qt::CaseInsensitive ) == 0 || imageFormat.compare( QLatin1String( "tif" ), Qt::CaseInsensitive ) == 0 )
   {
     w.setCompression( 1 ); //use LZW compression
   }
-  if ( projectForMetadata )
+  if ( metadata )
   {
-    w.setText( QStringLiteral( "Author" ), projectForMetadata->metadata().author() );
+    w.setText( QStringLiteral( "Author" ), metadata->author() );
     const QString creator = QStringLiteral( "QGIS %1" ).arg( Qgis::version() );
     w.setText( QStringLiteral( "Creator" ), creator );
     w.setText( QStringLiteral( "Producer" ), creator );
-    w.setText( QStringLiteral( "Subject" ), projectForMetadata->metadata().abstract() );
-    w.setText( QStringLiteral( "Created" ), projectForMetadata->metadata().creationDateTime().toString( Qt::ISODate ) );
-    w.setText( QStringLiteral( "Title" ), projectForMetadata->metadata().title() );
+    w.setText( QStringLiteral( "Subject" ), metadata->abstract() );
+    w.setText( QStringLiteral( "Created" ), metadata->creationDateTime().toString( Qt::ISODate ) );
+    w.setText( QStringLiteral( "Title" ), metadata->title() );
 
-    const QgsAbstractMetadataBase::KeywordMap keywords = projectForMetadata->metadata().keywords();
+    const QgsAbstractMetadataBase::KeywordMap keywords = metadata->keywords();
     QStringList allKeywords;
     for ( auto it = keywords.constBegin(); it != keywords.constEnd(); ++it )
     {
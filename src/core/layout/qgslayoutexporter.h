@@ -21,6 +21,8 @@
 #include "qgslayoutrendercontext.h"
 #include "qgslayoutreportcontext.h"
 #include "qgslayoutitem.h"
+#include "qgsprojectmetadata.h"
+#include <QImage>
 #include <QPointer>
 #include <QSize>
 #include <QRectF>
@@ -241,6 +243,9 @@ class CORE_EXPORT QgsLayoutExporter
      * The \a baseFilePath argument gives a base file path, which is modified by the
      * iterator to obtain file paths for each iterator feature.
      *
+     * The images of each iterator feature are encoded and written on a worker thread, while
+     * the layout is rendered for the next feature.
+     *
      * Returns a result code indicating whether the export was successful or an
      * error was encountered. If an error was obtained then \a error will be set
      * to the error description.
@@ -692,6 +697,37 @@ class CORE_EXPORT QgsLayoutExporter
 
     QImage createImage( const ImageExportSettings &settings, int page, QRectF &bounds, bool &skipPage ) const;
 
+#ifndef SIP_RUN
+
+    //! Rendered page of an image export, with everything required to write it without accessing the layout
+    struct RenderedImagePage
+    {
+      QImage image;
+      QString filePath;
+      QString format;
+      double dpi = 0;
+      bool includeMetadata = false;
+      QgsProjectMetadata metadata;
+      bool georeference = false;
+      double geoTransform[6] = { 0, 0, 0, 0, 0, 0 };
+      QString crsWkt;
+      QString worldFilePath;
+      double worldFileParameters[6] = { 0, 0, 0, 0, 0, 0 };
+    };
+
+    /**
+     * Exports the layout to the \a filePath image. If \a renderedPages is not NULLPTR, the
+     * pages are only rendered and appended to it, to be written later with writeImagePage().
+     */
+    ExportResult exportToImagePrivate( const QString &filePath, const ImageExportSettings &settings, QList< RenderedImagePage > *renderedPages );
+
+    /**
+     * Writes a rendered page to its file, with its georeferencing and world file.
+     * This does not access the layout, and can be called from any thread.
+     */
+    static bool writeImagePage( const RenderedImagePage &page );
+#endif
+
     /**
      * Returns the page number of the first page to be exported from the layout, skipping any pages
      * which have been excluded from export.
@@ -701,7 +737,7 @@ class CORE_EXPORT QgsLayoutExporter
     /**
      * Saves an image to a file, possibly using format specific options (e.g. LZW compression for tiff)
     */
-    static bool saveImage( const QImage &image, const QString &imageFilename, const QString &imageFormat, QgsProject *projectForMetadata );
+    static bool saveImage( const QImage &image, const QString &imageFilename, const QString &imageFormat, const QgsProjectMetadata *metadata );
 
     /**
      * Computes a GDAL style geotransform for georeferencing a layout.
@@ -719,7 +755,7 @@ class CORE_EXPORT QgsLayoutExporter
     std::unique_ptr<double[]> computeGeoTransform( const QgsLayoutItemMap *referenceMap = nullptr, const QRectF &exportRegion = QRectF(), double dpi = -1 ) const;
 
     //! Write a world file
-    void writeWorldFile( const QString &fileName, double a, double b, double c, double d, double e, double f ) const;
+    static void writeWorldFile( const QString &fileName, double a, double b, double c, double d, double e, double f );
 
 #ifndef QT_NO_PRINTER
 
@@ -748,6 +784,12 @@ class CORE_EXPORT QgsLayoutExporter
     static void updatePrinterPageSize( QgsLayout *layout, QPrinter &printer, int page );
 #endif
 
+    /**
+     * Renders the static layers of the maps of the \a layout concurrently into their export caches, before
+     * the maps are drawn on a paint device with the \a dpi logical resolution.
+     */
+    static void prerenderMapLayers( QgsLayout *layout, double dpi );
+
     ExportResult renderToLayeredSvg( const SvgExportSettings &settings, double width, double height, int page, const QRectF &bounds,
                                      const QString &filename, unsigned int svgLayerId, const QString &layerName,
                                      QDomDocument &svg, QDomNode &svgDocRoot, bool includeMetadata ) const;
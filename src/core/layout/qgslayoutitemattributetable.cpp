@@ -37,6 +37,21 @@
 #include "qgsfontutils.h"
 #include "qgsvariantutils.h"
 
+#include <QHash>
+
+///@cond PRIVATE
+
+//! Returns a hash of the contents of a table \a row. Rows with equal contents have the same hash.
+static uint hashRow( const QgsLayoutTableRow &row )
+{
+  uint hash = 0;
+  for ( const QVariant &value : row )
+    hash = hash * 31 + qHash( value.toString() );
+  return hash;
+}
+
+///@endcond
+
 //
 // QgsLayoutItemAttributeTable
 //
@@ -505,8 +520,65 @@ bool QgsLayoutItemAttributeTable::getTableContents( QgsLayoutTableContents &cont
   mConditionalStyles.clear();
   mFeatures.clear();
 
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+  mColumns = filteredColumns();
+#endif
+
+  // resolve the columns once, instead of for every feature
+  struct ColumnSource
+  {
+    int fieldIndex = -1;
+    QgsFieldFormatter *formatter = nullptr;
+    QgsEditorWidgetSetup setup;
+    QVariant formatterCache;
+    QList< QgsConditionalStyle > fieldStyles;
+    std::unique_ptr< QgsExpression > expression;
+  };
+  std::vector< ColumnSource > columnSources( mColumns.count() );
+  bool hasExpressionColumns = false;
+  for ( int i = 0; i < mColumns.count(); ++i )
+  {
+    const QgsLayoutTableColumn &column = mColumns.at( i );
+    ColumnSource &source = columnSources[i];
+    source.fieldIndex = layer->fields().lookupField( column.attribute() );
+    if ( source.fieldIndex != -1 )
+    {
+      if ( mUseConditionalStyling )
+        source.fieldStyles = conditionalStyles->fieldStyles( layer->fields().at( source.fieldIndex ).name() );
+
+      source.setup = layer->fields().at( source.fieldIndex ).editorWidgetSetup();
+      if ( !source.setup.isNull() )
+      {
+        source.formatter = QgsApplication::fieldFormatterRegistry()->fieldFormatter( source.setup.type() );
+        auto it = mLayerCache.constFind( column.attribute() );
+        if ( it != mLayerCache.constEnd() )
+        {
+          source.formatterCache = it.value();
+        }
+        else
+        {
+          source.formatterCache = source.formatter->createCache( layer, source.fieldIndex, source.setup.config() );
+          mLayerCache.insert( column.attribute(), source.formatterCache );
+        }
+      }
+    }
+    else
+    {
+      // Lets assume it's an expression
+      if ( !hasExpressionColumns )
+      {
+        context.lastScope()->addVariable( QgsExpressionContextScope::StaticVariable( QStringLiteral( "row_number" ), 1, true ) );
+        hasExpressionColumns = true;
+      }
+      source.expression = std::make_unique< QgsExpression >( column.attribute() );
+      source.expression->prepare( &context );
+    }
+  }
+
   QVector< QVector< Cell > > tempContents;
   QgsLayoutTableContents existingContents;
+  // rows by hash of their contents, for a fast check of the row uniqueness
+  QMultiHash< uint, int > existingRowHashes;
 
   while ( fit.nextFeature( f ) && counter < mMaximumNumberOfFeatures )
   {
@@ -558,49 +630,29 @@ bool QgsLayoutItemAttributeTable::getTableContents( QgsLayoutTableContents &cont
     // We also need a list of just the cell contents, so that we can do a quick check for row uniqueness (when the
     // corresponding option is enabled)
     QVector< Cell > currentRow;
-#ifdef HAVE_SERVER_PYTHON_PLUGINS
-    mColumns = filteredColumns();
-#endif
     currentRow.reserve( mColumns.count() );
     QgsLayoutTableRow rowContents;
     rowContents.reserve( mColumns.count() );
 
-    for ( const QgsLayoutTableColumn &column : std::as_const( mColumns ) )
+    if ( hasExpressionColumns )
+      context.lastScope()->addVariable( QgsExpressionContextScope::StaticVariable( QStringLiteral( "row_number" ), counter + 1, true ) );
+
+    for ( ColumnSource &source : columnSources )
     {
-      QgsConditionalStyle style;
-      int idx = layer->fields().lookupField( column.attribute() );
-      if ( idx != -1 )
+      if ( source.fieldIndex != -1 )
       {
-        QVariant val = f.attributes().at( idx );
+        QgsConditionalStyle style;
+        QVariant val = f.attributes().at( source.fieldIndex );
 
         if ( mUseConditionalStyling )
         {
-          QList<QgsConditionalStyle> styles = conditionalStyles->fieldStyles( layer->fields().at( idx ).name() );
-          styles = QgsConditionalStyle::matchingConditionalStyles( styles, val, context );
+          QList<QgsConditionalStyle> styles = QgsConditionalStyle::matchingConditionalStyles( source.fieldStyles, val, context );
           styles.insert( 0, rowStyle );
           style = QgsConditionalStyle::compressStyles( styles );
         }
 
-        const QgsEditorWidgetSetup setup = layer->fields().at( idx ).editorWidgetSetup();
-
-        if ( ! setup.isNull() )
-        {
-          QgsFieldFormatter *fieldFormatter = QgsApplication::fieldFormatterRegistry()->fieldFormatter( setup.type() );
-          QVariant cache;
-
-          auto it = mLayerCache.constFind( column.attribute() );
-          if ( it != mLayerCache.constEnd() )
-          {
-            cache = it.value();
-          }
-          else
-          {
-            cache = fieldFormatter->createCache( layer, idx, setup.config() );
-            mLayerCache.insert( column.attribute(), cache );
-          }
-
-          val = fieldFormatter->representValue( layer, idx, setup.config(), cache, val );
-        }
+        if ( source.formatter )
+          val = source.formatter->representValue( layer, source.fieldIndex, source.setup.config(), source.formatterCache, val );
 
         QVariant v = QgsVariantUtils::isNull( val ) ? QString() : replaceWrapChar( val );
         currentRow << Cell( v, style, f );
@@ -608,11 +660,7 @@ bool QgsLayoutItemAttributeTable::getTableContents( QgsLayoutTableContents &cont
       }
       else
       {
-        // Lets assume it's an expression
-        std::unique_ptr< QgsExpression > expression = std::make_unique< QgsExpression >( column.attribute() );
-        context.lastScope()->addVariable( QgsExpressionContextScope::StaticVariable( QStringLiteral( "row_number" ), counter + 1, true ) );
-        expression->prepare( &context );
-        QVariant value = expression->evaluate( &context );
+        QVariant value = source.expression->evaluate( &context );
 
         currentRow << Cell( value, rowStyle, f );
         rowContents << value;
@@ -621,8 +669,20 @@ bool QgsLayoutItemAttributeTable::getTableContents( QgsLayoutTableContents &cont
 
     if ( mShowUniqueRowsOnly )
     {
-      if ( contentsContainsRow( existingContents, rowContents ) )
+      const uint rowHash = hashRow( rowContents );
+      bool exists = false;
+      for ( auto it = existingRowHashes.constFind( rowHash ); it != existingRowHashes.constEnd() && it.key() == rowHash; ++it )
+      {
+        if ( existingContents.at( it.value() ) == rowContents )
+        {
+          exists = true;
+          break;
+        }
+      }
+      if ( exists )
         continue;
+
+      existingRowHashes.insert( rowHash, existingContents.size() );
     }
 
     tempContents << currentRow;
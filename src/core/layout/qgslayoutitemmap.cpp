@@ -42,6 +42,7 @@
 #include <QPainter>
 #include <QStyleOptionGraphicsItem>
 #include <QTimer>
+#include <algorithm>
 
 QgsLayoutItemMap::QgsLayoutItemMap( QgsLayout *layout )
   : QgsLayoutItem( layout )
@@ -1356,16 +1357,115 @@ void QgsLayoutItemMap::drawMap( QPainter *painter, const QgsRectangle &extent, Q
   job.setFeatureFilterProvider( mLayout->renderContext().featureFilterProvider() );
 #endif
 
+  // static layers are reused during the export, e.g. if the map shows the same extent on each atlas page
+  QgsMapRendererCache *layerCache = nullptr;
+  if ( !mLayout->renderContext().isPreviewRender() )
+  {
+    layerCache = layerCacheForSettings( mExportLayerCache, mExportLayerCacheParameters, ms );
+    if ( layerCache )
+      job.setCache( layerCache );
+  }
+
   // Render the map in this thread. This is done because of problems
   // with printing to printer on Windows (printing to PDF is fine though).
   // Raster images were not displayed - see #10599
   job.renderSynchronously();
 
+  if ( layerCache )
+    releaseDynamicLayerImages( layerCache, ms );
+
   mExportLabelingResults.reset( job.takeLabelingResults() );
 
   mRenderingErrors = job.errors();
 }
 
+QgsMapRendererCache *QgsLayoutItemMap::layerCacheForSettings( std::unique_ptr< QgsMapRendererCache > &cache, QString &parameters, const QgsMapSettings &settings )
+{
+  // vector outputs can't use images, and clipped or shaded layers depend on other items than the layer itself
+  if ( settings.testFlag( Qgis::MapSettingsFlag::ForceVectorOutput ) || !settings.clippingRegions().isEmpty() || settings.elevationShadingRenderer().isActive() )
+    return nullptr;
+
+  const QList< QgsMapLayer * > layers = settings.layers();
+  const bool hasStaticLayers = std::any_of( layers.begin(), layers.end(), []( const QgsMapLayer * layer ) { return layer->type() == QgsMapLayerType::RasterLayer; } );
+  if ( !hasStaticLayers )
+    return nullptr;
+
+  // the extent and scale of the images are checked by the cache itself
+  QStringList currentParameters;
+  currentParameters << settings.destinationCrs().toWkt( QgsCoordinateReferenceSystem::WKT_PREFERRED );
+  if ( settings.isTemporal() )
+    currentParameters << settings.temporalRange().begin().toString( Qt::ISODateWithMs ) << settings.temporalRange().end().toString( Qt::ISODateWithMs );
+  const QMap< QString, QString > styleOverrides = settings.layerStyleOverrides();
+  for ( auto it = styleOverrides.constBegin(); it != styleOverrides.constEnd(); ++it )
+    currentParameters << it.key() << it.value();
+  currentParameters << QString::number( settings.devicePixelRatio() );
+  const QString currentParametersString = currentParameters.join( QChar( '\n' ) );
+
+  if ( !cache )
+    cache = std::make_unique< QgsMapRendererCache >();
+  else if ( parameters != currentParametersString )
+    cache->clear();
+  parameters = currentParametersString;
+  return cache.get();
+}
+
+void QgsLayoutItemMap::releaseDynamicLayerImages( QgsMapRendererCache *cache, const QgsMapSettings &settings )
+{
+  // only raster layers are kept, the rendering of other layers and of the labels may depend
+  // on the atlas feature or on other expression variables
+  cache->clearCacheImage( QgsMapRendererJob::LABEL_CACHE_ID );
+  cache->clearCacheImage( QgsMapRendererJob::LABEL_PREVIEW_CACHE_ID );
+  const QList< QgsMapLayer * > layers = settings.layers();
+  for ( const QgsMapLayer *layer : layers )
+  {
+    if ( layer->type() == QgsMapLayerType::RasterLayer )
+      continue;
+
+    cache->clearCacheImage( layer->id() );
+    cache->clearCacheImage( layer->id() + QStringLiteral( "_preview" ) );
+    cache->clearCacheImage( QgsMapRendererJob::ELEVATION_MAP_CACHE_PREFIX + layer->id() );
+    cache->clearCacheImage( QgsMapRendererJob::ELEVATION_MAP_CACHE_PREFIX + layer->id() + QStringLiteral( "_preview" ) );
+  }
+}
+
+QgsMapRendererCache *QgsLayoutItemMap::exportLayerPrerenderCache( double dpi, QgsMapSettings &settings )
+{
+  // mirrors the settings of drawMap() when the layers are drawn directly on the device by paint()
+  if ( !mLayout || mLayout->renderContext().isPreviewRender() || !isVisible() || !shouldDrawPart( Layer ) || mCurrentExportPart != NotLayered )
+    return nullptr;
+  if ( containsAdvancedEffects() && !( mLayout->renderContext().flags() & QgsLayoutRenderContext::FlagForceVectorOutput ) )
+    return nullptr;
+
+  const QgsRectangle cExtent = extent();
+  QSizeF size( cExtent.width() * mapUnitsToLayoutUnits(), cExtent.height() * mapUnitsToLayoutUnits() );
+  size *= dpi / 25.4;
+  if ( qgsDoubleNear( size.width(), 0.0 ) || qgsDoubleNear( size.height(), 0.0 ) )
+    return nullptr;
+
+  QgsMapSettings ms( mapSettings( cExtent, size, dpi, true ) );
+  if ( shouldDrawPart( OverviewMapExtent ) )
+  {
+    ms.setLayers( mOverviewStack->modifyMapLayerList( ms.layers() ) );
+  }
+
+  QgsMapRendererCache *cache = layerCacheForSettings( mExportLayerCache, mExportLayerCacheParameters, ms );
+  if ( !cache )
+    return nullptr;
+
+  cache->updateParameters( ms.visibleExtent(), ms.mapToPixel() );
+  QList< QgsMapLayer * > layers = ms.layers();
+  layers.erase( std::remove_if( layers.begin(), layers.end(), [cache]( const QgsMapLayer * layer )
+  {
+    return layer->type() != QgsMapLayerType::RasterLayer || cache->hasCacheImage( layer->id() );
+  } ), layers.end() );
+  if ( layers.isEmpty() )
+    return nullptr;
+
+  ms.setLayers( layers );
+  settings = ms;
+  return cache;
+}
+
 void QgsLayoutItemMap::recreateCachedImageInBackground()
 {
   if ( mPainterJob )
@@ -1455,6 +1555,13 @@ void QgsLayoutItemMap::recreateCachedImageInBackground()
   }
 
   mPainterJob.reset( new QgsMapRendererCustomPainterJob( settings, mPainter.get() ) );
+  // static layers are not rendered again when the preview is refreshed for other layers
+  if ( QgsMapRendererCache *layerCache = layerCacheForSettings( mPreviewLayerCache, mPreviewLayerCacheParameters, settings ) )
+  {
+    // canceled jobs may have stored the images of other layers since the last refresh
+    releaseDynamicLayerImages( layerCache, settings );
+    mPainterJob->setCache( layerCache );
+  }
   connect( mPainterJob.get(), &QgsMapRendererCustomPainterJob::finished, this, &QgsLayoutItemMap::painterJobFinished );
   mPainterJob->start();
 
@@ -1981,6 +2088,8 @@ void QgsLayoutItemMap::layersAboutToBeRemoved( const QList<QgsMapLayer *> &layer
 void QgsLayoutItemMap::painterJobFinished()
 {
   mPainter->end();
+  if ( mPreviewLayerCache )
+    releaseDynamicLayerImages( mPreviewLayerCache.get(), mPainterJob->mapSettings() );
   mPreviewLabelingResults.reset( mPainterJob->takeLabelingResults() );
   mPainterJob.reset( nullptr );
   mPainter.reset( nullptr );
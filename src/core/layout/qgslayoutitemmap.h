@@ -26,6 +26,7 @@
 #include "qgslayoutitemmapoverview.h"
 #include "qgsmaprendererstagedrenderjob.h"
 #include "qgstemporalrangeobject.h"
+#include "qgsmaprenderercache.h"
 
 class QgsAnnotation;
 class QgsRenderedFeatureHandlerInterface;
@@ -1118,6 +1119,34 @@ class CORE_EXPORT QgsLayoutItemMap : public QgsLayoutItem, public QgsTemporalRan
     std::unique_ptr< QgsLabelingResults > mPreviewLabelingResults;
     std::unique_ptr< QgsLabelingResults > mExportLabelingResults;
 
+    //! Images of the static layers reused between the exports of the map, e.g. for the pages of an atlas
+    std::unique_ptr< QgsMapRendererCache > mExportLayerCache;
+    QString mExportLayerCacheParameters;
+    //! Images of the static layers reused between the previews of the map
+    std::unique_ptr< QgsMapRendererCache > mPreviewLayerCache;
+    QString mPreviewLayerCacheParameters;
+
+    /**
+     * Returns the \a cache of layer images to use to render the map with the specified \a settings,
+     * created as required and cleared if the \a parameters of its images changed, or NULLPTR if
+     * no layer can be reused.
+     */
+    static QgsMapRendererCache *layerCacheForSettings( std::unique_ptr< QgsMapRendererCache > &cache, QString &parameters, const QgsMapSettings &settings );
+
+    /**
+     * Removes the images of the layers of \a settings which can't be reused from the \a cache, e.g.
+     * layers whose symbology can depend on the current atlas feature.
+     */
+    static void releaseDynamicLayerImages( QgsMapRendererCache *cache, const QgsMapSettings &settings );
+
+    /**
+     * Returns the export cache of the static layers of the map, as they will be drawn on a paint device with
+     * the \a dpi logical resolution, and sets \a settings to render the layers missing from the cache.
+     *
+     * Returns NULLPTR if the map is not drawn directly on the device, or if no layer needs to be rendered.
+     */
+    QgsMapRendererCache *exportLayerPrerenderCache( double dpi, QgsMapSettings &settings );
+
     void init();
 
     //! Resets the item tooltip to reflect current map id
@@ -1192,6 +1221,7 @@ class CORE_EXPORT QgsLayoutItemMap : public QgsLayoutItem, public QgsTemporalRan
     friend class QgsCompositionConverter;
     friend class QgsGeoPdfRenderedFeatureHandler;
     friend class QgsLayoutExporter;
+    friend class LayoutContextPreviewSettingRestorer;
 
 };
 
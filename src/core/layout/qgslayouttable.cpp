@@ -26,6 +26,8 @@
 #include "qgslayoutpagecollection.h"
 #include "qgstextrenderer.h"
 
+#include <QHash>
+
 //
 // QgsLayoutTableStyle
 //
@@ -1188,6 +1190,9 @@ bool QgsLayoutTable::calculateMaxRowHeights()
     i++;
   }
 
+  // most cells share a few fonts, so their descents are only calculated once per font
+  QHash< QString, double > contentDescentsMm;
+
   //next, go through all the table contents and calculate the sizes
   QgsLayoutTableContents::const_iterator rowIt = mTableContents.constBegin();
   int row = 1;
@@ -1200,7 +1205,13 @@ bool QgsLayoutTable::calculateMaxRowHeights()
       QgsTextFormat cellFormat = textFormatForCell( row - 1, i );
       QgsExpressionContextScopePopper popper( context.expressionContext(), scopeForCell( row - 1, i ) );
       cellFormat.updateDataDefinedProperties( context );
-      const double contentDescentMm = QgsTextRenderer::fontMetrics( context, cellFormat, QgsTextRenderer::FONT_WORKAROUND_SCALE ).descent() / QgsTextRenderer::FONT_WORKAROUND_SCALE  / context.convertToPainterUnits( 1, QgsUnitTypes::RenderMillimeters );
+      const QString fontKey = cellFormat.scaledFont( context, QgsTextRenderer::FONT_WORKAROUND_SCALE ).key();
+      auto descentIt = contentDescentsMm.constFind( fontKey );
+      if ( descentIt == contentDescentsMm.constEnd() )
+      {
+        descentIt = contentDescentsMm.insert( fontKey, QgsTextRenderer::fontMetrics( context, cellFormat, QgsTextRenderer::FONT_WORKAROUND_SCALE ).descent() / QgsTextRenderer::FONT_WORKAROUND_SCALE  / context.convertToPainterUnits( 1, QgsUnitTypes::RenderMillimeters ) );
+      }
+      const double contentDescentMm = descentIt.value();
       const QString localizedString { QgsExpressionUtils::toLocalizedString( *colIt ) };
 
       heights[ row * cols + i ] = QgsTextRenderer::textHeight( context,
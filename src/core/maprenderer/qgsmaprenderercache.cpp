@@ -19,10 +19,31 @@
 #include "qgsmaplayerlistutils_p.h"
 #include "qgsapplication.h"
 
+#include <QBuffer>
 #include <QImage>
 #include <QPainter>
 #include <algorithm>
 
+///@cond PRIVATE
+// PNG quality mapped by the Qt writer to the zlib level 1, cold images favor speed over size
+constexpr int COLD_IMAGE_PNG_QUALITY = 89;
+///@endcond
+
+qint64 QgsMapRendererCache::CacheParameters::size() const
+{
+  return compressedImage.isEmpty() ? cachedImage.sizeInBytes() : compressedImage.size();
+}
+
+QImage QgsMapRendererCache::CacheParameters::image() const
+{
+  if ( compressedImage.isEmpty() )
+    return cachedImage;
+
+  QImage res = QImage::fromData( compressedImage, "PNG" ).convertToFormat( compressedFormat );
+  res.setDevicePixelRatio( compressedDevicePixelRatio );
+  return res;
+}
+
 QgsMapRendererCache::QgsMapRendererCache()
 {
   clear();
@@ -169,7 +190,10 @@ void QgsMapRendererCache::setCacheImageWithParameters( const QString &cacheKey,
     }
   }
 
+  params.lastAccess = ++mAccessCounter;
   mCachedImages[cacheKey] = params;
+
+  enforceMaximumSize( cacheKey );
 }
 
 bool QgsMapRendererCache::hasCacheImage( const QString &cacheKey ) const
@@ -213,7 +237,12 @@ bool QgsMapRendererCache::hasAnyCacheImage( const QString &cacheKey, double mini
 QImage QgsMapRendererCache::cacheImage( const QString &cacheKey ) const
 {
   QMutexLocker lock( &mMutex );
-  return mCachedImages.value( cacheKey ).cachedImage;
+  auto it = mCachedImages.constFind( cacheKey );
+  if ( it == mCachedImages.constEnd() )
+    return QImage();
+
+  it->lastAccess = ++mAccessCounter;
+  return it->image();
 }
 
 static QPointF _transform( const QgsMapToPixel &mtp, const QgsPointXY &point, double scale )
@@ -226,12 +255,18 @@ static QPointF _transform( const QgsMapToPixel &mtp, const QgsPointXY &point, do
 QImage QgsMapRendererCache::transformedCacheImage( const QString &cacheKey, const QgsMapToPixel &mtp ) const
 {
   QMutexLocker lock( &mMutex );
-  const CacheParameters params = mCachedImages.value( cacheKey );
+  auto it = mCachedImages.constFind( cacheKey );
+  if ( it == mCachedImages.constEnd() )
+    return QImage();
+
+  it->lastAccess = ++mAccessCounter;
+  const CacheParameters &params = it.value();
+  const QImage cachedImage = params.image();
 
   if ( params.cachedExtent == mExtent &&
        mtp.transform() == mMtp.transform() )
   {
-    return params.cachedImage;
+    return cachedImage;
   }
   else
   {
@@ -250,19 +285,19 @@ QImage QgsMapRendererCache::transformedCacheImage( const QString &cacheKey, cons
     const QRectF targetRect( ulT.x(), ulT.y(), lrT.x() - ulT.x(), lrT.y() - ulT.y() );
 
     // Calculate source rect
-    const QPointF ulS = _transform( params.cachedMtp, QgsPointXY( intersection.xMinimum(), intersection.yMaximum() ),  params.cachedImage.devicePixelRatio() );
-    const QPointF lrS = _transform( params.cachedMtp, QgsPointXY( intersection.xMaximum(), intersection.yMinimum() ),  params.cachedImage.devicePixelRatio() );
+    const QPointF ulS = _transform( params.cachedMtp, QgsPointXY( intersection.xMinimum(), intersection.yMaximum() ),  cachedImage.devicePixelRatio() );
+    const QPointF lrS = _transform( params.cachedMtp, QgsPointXY( intersection.xMaximum(), intersection.yMinimum() ),  cachedImage.devicePixelRatio() );
     const QRectF sourceRect( ulS.x(), ulS.y(), lrS.x() - ulS.x(), lrS.y() - ulS.y() );
 
     // Draw image
-    QImage ret( params.cachedImage.size(), params.cachedImage.format() );
-    ret.setDevicePixelRatio( params.cachedImage.devicePixelRatio() );
-    ret.setDotsPerMeterX( params.cachedImage.dotsPerMeterX() );
-    ret.setDotsPerMeterY( params.cachedImage.dotsPerMeterY() );
+    QImage ret( cachedImage.size(), cachedImage.format() );
+    ret.setDevicePixelRatio( cachedImage.devicePixelRatio() );
+    ret.setDotsPerMeterX( cachedImage.dotsPerMeterX() );
+    ret.setDotsPerMeterY( cachedImage.dotsPerMeterY() );
     ret.fill( Qt::transparent );
     QPainter painter;
     painter.begin( &ret );
-    painter.drawImage( targetRect, params.cachedImage, sourceRect );
+    painter.drawImage( targetRect, cachedImage, sourceRect );
     painter.end();
     return ret;
   }
@@ -315,3 +350,96 @@ void QgsMapRendererCache::clearCacheImage( const QString &cacheKey )
   dropUnusedConnections();
 }
 
+
+void QgsMapRendererCache::setMaximumCacheSize( qint64 bytes )
+{
+  QMutexLocker lock( &mMutex );
+  mMaximumSize = std::max< qint64 >( 0, bytes );
+  enforceMaximumSize( QString() );
+}
+
+qint64 QgsMapRendererCache::maximumCacheSize() const
+{
+  QMutexLocker lock( &mMutex );
+  return mMaximumSize;
+}
+
+qint64 QgsMapRendererCache::cacheSize() const
+{
+  QMutexLocker lock( &mMutex );
+  qint64 size = 0;
+  for ( const CacheParameters &params : mCachedImages )
+    size += params.size();
+  return size;
+}
+
+void QgsMapRendererCache::setCompressColdImages( bool compress )
+{
+  QMutexLocker lock( &mMutex );
+  mCompressColdImages = compress;
+}
+
+bool QgsMapRendererCache::compressColdImages() const
+{
+  QMutexLocker lock( &mMutex );
+  return mCompressColdImages;
+}
+
+void QgsMapRendererCache::enforceMaximumSize( const QString &keepKey )
+{
+  if ( mMaximumSize <= 0 )
+    return;
+
+  qint64 size = 0;
+  QList< QPair< quint64, QString > > candidates;
+  for ( auto it = mCachedImages.constBegin(); it != mCachedImages.constEnd(); ++it )
+  {
+    size += it->size();
+    if ( it.key() != keepKey )
+      candidates << qMakePair( it->lastAccess, it.key() );
+  }
+  if ( size <= mMaximumSize )
+    return;
+
+  // least recently used first
+  std::sort( candidates.begin(), candidates.end() );
+
+  if ( mCompressColdImages )
+  {
+    for ( const auto &candidate : std::as_const( candidates ) )
+    {
+      if ( size <= mMaximumSize )
+        break;
+
+      CacheParameters &params = mCachedImages[ candidate.second ];
+      if ( !params.compressedImage.isEmpty() || params.cachedImage.isNull() )
+        continue;
+
+      QByteArray data;
+      QBuffer buffer( &data );
+      buffer.open( QIODevice::WriteOnly );
+      if ( !params.cachedImage.save( &buffer, "PNG", COLD_IMAGE_PNG_QUALITY ) )
+        continue;
+
+      size -= params.cachedImage.sizeInBytes() - data.size();
+      params.compressedFormat = params.cachedImage.format();
+      params.compressedDevicePixelRatio = params.cachedImage.devicePixelRatio();
+      params.compressedImage = data;
+      params.cachedImage = QImage();
+    }
+  }
+
+  bool removed = false;
+  for ( const auto &candidate : std::as_const( candidates ) )
+  {
+    if ( size <= mMaximumSize )
+      break;
+
+    size -= mCachedImages.value( candidate.second ).size();
+    mCachedImages.remove( candidate.second );
+    removed = true;
+  }
+
+  if ( removed )
+    dropUnusedConnections();
+}
@@ -174,6 +174,52 @@ class CORE_EXPORT QgsMapRendererCache : public QObject
      */
     void invalidateCacheForLayer( QgsMapLayer *layer );
 
+    /**
+     * Sets the maximum size of the cached images, in bytes. When the budget is
+     * exceeded, the least recently used images are compressed (if compressColdImages()
+     * is set) and then evicted. A value of 0 (the default) means the cache is unbounded.
+     *
+     * \see maximumCacheSize()
+     * \see cacheSize()
+     * \since QGIS 3.30
+     */
+    void setMaximumCacheSize( qint64 bytes );
+
+    /**
+     * Returns the maximum size of the cached images, in bytes. 0 means the cache is unbounded.
+     *
+     * \see setMaximumCacheSize()
+     * \since QGIS 3.30
+     */
+    qint64 maximumCacheSize() const;
+
+    /**
+     * Returns the current size of the cached images, in bytes.
+     *
+     * \see setMaximumCacheSize()
+     * \since QGIS 3.30
+     */
+    qint64 cacheSize() const;
+
+    /**
+     * Sets whether the least recently used images are stored losslessly compressed
+     * when the maximum cache size is exceeded, instead of being evicted right away.
+     * Compressed images are decompressed when they are requested.
+     *
+     * \see compressColdImages()
+     * \since QGIS 3.30
+     */
+    void setCompressColdImages( bool compress );
+
+    /**
+     * Returns TRUE if the least recently used images are compressed when the
+     * maximum cache size is exceeded.
+     *
+     * \see setCompressColdImages()
+     * \since QGIS 3.30
+     */
+    bool compressColdImages() const;
+
   private slots:
     //! Remove layer (that emitted the signal) from the cache
     void layerRequestedRepaint();
@@ -183,14 +229,28 @@ class CORE_EXPORT QgsMapRendererCache : public QObject
     struct CacheParameters
     {
       QImage cachedImage;
+      //! PNG encoded image, used instead of cachedImage for cold entries
+      QByteArray compressedImage;
+      QImage::Format compressedFormat = QImage::Format_Invalid;
+      qreal compressedDevicePixelRatio = 1.0;
       QgsWeakMapLayerPointerList dependentLayers;
       QgsRectangle cachedExtent;
       QgsMapToPixel cachedMtp;
+      //! Value of the cache access counter when the entry was last used
+      mutable quint64 lastAccess = 0;
+
+      //! Returns the size of the stored image in bytes
+      qint64 size() const;
+      //! Returns the cached image, decompressed if needed
+      QImage image() const;
     };
 
     //! Invalidate cache contents (without locking)
     void clearInternal();
 
+    //! Compresses or evicts the least recently used images until the cache fits the maximum size (without locking)
+    void enforceMaximumSize( const QString &keepKey );
+
     //! Disconnects from layers we no longer care about
     void dropUnusedConnections();
 
@@ -204,6 +264,9 @@ class CORE_EXPORT QgsMapRendererCache : public QObject
 
     //! Map of cache key to cache parameters
     QMap<QString, CacheParameters> mCachedImages;
+    qint64 mMaximumSize = 0;
+    bool mCompressColdImages = false;
+    mutable quint64 mAccessCounter = 0;
     //! List of all layers on which this cache is currently connected
     QSet< QgsWeakMapLayerPointer > mConnectedLayers;
 };
@@ -113,6 +113,7 @@ void QgsMapRendererCustomPainterJob::startPrivate()
   {
     mLabelingEngineV2.reset( new QgsDefaultLabelingEngine() );
     mLabelingEngineV2->setMapSettings( mSettings );
+    mLabelingEngineV2->setPreviousLabelPositions( mPreviousLabelPositions );
   }
 
   const bool canUseLabelCache = prepareLabelCache();
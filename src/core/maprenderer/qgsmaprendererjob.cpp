@@ -47,6 +47,7 @@
 #include "qgsmaskpaintdevice.h"
 #include "qgsrasterrenderer.h"
 #include "qgselevationmap.h"
+#include "qgsruntimeprofiler.h"
 
 const QgsSettingsEntryBool *QgsMapRendererJob::settingsLogCanvasRefreshEvent = new QgsSettingsEntryBool( QStringLiteral( "logCanvasRefreshEvent" ), QgsSettings::sTreeMap, false );
 
@@ -211,6 +212,16 @@ void QgsMapRendererJob::setLayerRenderingTimeHints( const QHash<QString, int> &h
   mLayerRenderingTimeHints = hints;
 }
 
+void QgsMapRendererJob::setPreviousLabelPositions( const QList<QgsLabelPosition> &positions )
+{
+  mPreviousLabelPositions = positions;
+}
+
+QList<QgsLabelPosition> QgsMapRendererJob::previousLabelPositions() const
+{
+  return mPreviousLabelPositions;
+}
+
 const QgsMapSettings &QgsMapRendererJob::mapSettings() const
 {
   return mSettings;
@@ -1258,6 +1269,10 @@ QgsElevationMap QgsMapRendererJob::layerElevationToBeComposed( const QgsMapSetti
 
 void QgsMapRendererJob::composeSecondPass( std::vector<LayerRenderJob> &secondPassJobs, LabelRenderJob &labelJob, bool forceVector )
 {
+  // the binarized masks are shared by all the layers masked by the same mask images, which is the
+  // common case of labels masking several layers, instead of being computed again for each layer
+  QHash< const QImage *, QImage > binarizedMasks;
+
   // compose the second pass with the mask
   for ( LayerRenderJob &job : secondPassJobs )
   {
@@ -1273,6 +1288,8 @@ void QgsMapRendererJob::composeSecondPass( std::vector<LayerRenderJob> &secondPa
         if ( !maskPainter )
         {
           maskPainter = p.first ? p.first->maskPainter.get() : labelJob.maskPainters[ p.second ].get();
+          // the first mask image is modified by the merge
+          binarizedMasks.remove( maskImage );
         }
         else
         {
@@ -1297,12 +1314,17 @@ void QgsMapRendererJob::composeSecondPass( std::vector<LayerRenderJob> &secondPa
         //Create an "alpha binarized" image of the maskImage to :
         //* Eliminate antialiasing artifact
         //* Avoid applying mask opacity to elements under the mask but not masked
-        QImage maskBinAlpha = maskImage->createMaskFromColor( 0 );
-        QVector<QRgb> mswTable;
-        mswTable.push_back( qRgba( 0, 0, 0, 255 ) );
-        mswTable.push_back( qRgba( 0, 0, 0, 0 ) );
-        maskBinAlpha.setColorTable( mswTable );
-        painter->drawImage( 0, 0, maskBinAlpha );
+        auto binarizedIt = binarizedMasks.constFind( maskImage );
+        if ( binarizedIt == binarizedMasks.constEnd() )
+        {
+          QImage maskBinAlpha = maskImage->createMaskFromColor( 0 );
+          QVector<QRgb> mswTable;
+          mswTable.push_back( qRgba( 0, 0, 0, 255 ) );
+          mswTable.push_back( qRgba( 0, 0, 0, 0 ) );
+          maskBinAlpha.setColorTable( mswTable );
+          binarizedIt = binarizedMasks.insert( maskImage, maskBinAlpha );
+        }
+        painter->drawImage( 0, 0, *binarizedIt );
 
         // Modify the first pass' image ...
         {
@@ -1370,6 +1392,10 @@ void QgsMapRendererJob::drawLabeling( QgsRenderContext &renderContext, QgsLabeli
 
   if ( labelingEngine2 )
   {
+    std::unique_ptr< QgsScopedRuntimeProfile > profile;
+    if ( renderContext.testFlag( Qgis::RenderContextFlag::RecordProfile ) )
+      profile = std::make_unique< QgsScopedRuntimeProfile >( QObject::tr( "Drawing labels" ), QStringLiteral( "render" ) );
+
     labelingEngine2->run( renderContext );
   }
 
@@ -30,6 +30,7 @@
 #include "qgslabelsink.h"
 #include "qgsmapsettings.h"
 #include "qgsmaskidprovider.h"
+#include "qgslabelposition.h"
 #include "qgssettingsentryimpl.h"
 
 class QPicture;
@@ -441,6 +442,26 @@ class CORE_EXPORT QgsMapRendererJob : public QObject SIP_ABSTRACT
      */
     void setLayerRenderingTimeHints( const QHash< QString, int > &hints ) SIP_SKIP;
 
+    /**
+     * Sets the label \a positions placed by a previous render of the map, e.g. the results of
+     * the previous render before the map was panned.
+     *
+     * The labeling engine keeps labels at their previous position when it is still one of their best
+     * candidates, so that labels stay stable while the map is navigated.
+     *
+     * \see previousLabelPositions()
+     * \since QGIS 3.30
+     */
+    void setPreviousLabelPositions( const QList< QgsLabelPosition > &positions );
+
+    /**
+     * Returns the label positions placed by a previous render of the map.
+     *
+     * \see setPreviousLabelPositions()
+     * \since QGIS 3.30
+     */
+    QList< QgsLabelPosition > previousLabelPositions() const;
+
     /**
      * Returns map settings with which this job was started.
      * \returns A QgsMapSettings instance with render settings
@@ -526,6 +547,13 @@ class CORE_EXPORT QgsMapRendererJob : public QObject SIP_ABSTRACT
      */
     QHash< QString, int > mLayerRenderingTimeHints;
 
+    /**
+     * Label positions placed by a previous render of the map
+     *
+     * \since QGIS 3.30
+     */
+    QList< QgsLabelPosition > mPreviousLabelPositions;
+
     /**
      * TRUE if layer rendering time should be recorded.
      */
@@ -60,6 +60,7 @@ void QgsMapRendererParallelJob::startPrivate()
   {
     mLabelingEngineV2.reset( new QgsDefaultLabelingEngine() );
     mLabelingEngineV2->setMapSettings( mSettings );
+    mLabelingEngineV2->setPreviousLabelPositions( mPreviousLabelPositions );
   }
 
   const bool canUseLabelCache = prepareLabelCache();
@@ -28,6 +28,9 @@
 #include "qgsmeshvirtualdatasetgroup.h"
 #include "qgis.h"
 
+#include <QThread>
+#include <QtConcurrent>
+
 QgsMeshCalculator::QgsMeshCalculator( const QString &formulaString,
                                       const QString &outputFile,
                                       const QgsRectangle &outputExtent,
@@ -219,40 +222,56 @@ QgsMeshCalculator::Result QgsMeshCalculator::processCalculation( QgsFeedback *fe
     return Success;
   }
 
-  //open output dataset
-  const QgsMeshCalcUtils dsu( mMeshLayer, calcNode->usedDatasetGroupNames(), mStartTime, mEndTime );
-  if ( !dsu.isValid() )
+  // without aggregate functions, the time steps are calculated one after the other, so that only
+  // the input datasets of the time steps being calculated are fetched in memory
+  std::unique_ptr<QgsMeshMemoryDatasetGroup> outputGroup;
+  const QList<int> timeStepIndexes = calcNode->aggregatedUsedDatasetGroupNames().isEmpty() ?
+                                     QgsMeshCalcUtils::timeStepDatasetIndexes( mMeshLayer, calcNode->usedDatasetGroupNames(), mStartTime, mEndTime ) :
+                                     QList<int>();
+  if ( !timeStepIndexes.isEmpty() )
   {
-    return InvalidDatasets;
+    const Result result = calculateByTimeStep( *calcNode, timeStepIndexes, outputGroup, feedback );
+    if ( result != Success )
+      return result;
   }
+  else
+  {
+    //open output dataset
+    const QgsMeshCalcUtils dsu( mMeshLayer, calcNode->usedDatasetGroupNames(), mStartTime, mEndTime );
+    if ( !dsu.isValid() )
+    {
+      return InvalidDatasets;
+    }
 
-  std::unique_ptr<QgsMeshMemoryDatasetGroup> outputGroup = std::make_unique<QgsMeshMemoryDatasetGroup> ( mOutputGroupName, dsu.outputType() );
+    outputGroup = std::make_unique<QgsMeshMemoryDatasetGroup> ( mOutputGroupName, dsu.outputType() );
 
-  // calculate
-  const bool ok = calcNode->calculate( dsu, *outputGroup );
-  if ( !ok )
-  {
-    return EvaluateError;
-  }
+    // calculate
+    const bool ok = calcNode->calculate( dsu, *outputGroup );
+    if ( !ok )
+    {
+      return EvaluateError;
+    }
 
-  if ( feedback && feedback->isCanceled() )
-  {
-    return Canceled;
-  }
-  if ( feedback )
-  {
-    feedback->setProgress( 60.0 );
-  }
+    if ( feedback && feedback->isCanceled() )
+    {
+      return Canceled;
+    }
+    if ( feedback )
+    {
+      feedback->setProgress( 60.0 );
+    }
 
-  // Finalize dataset
-  if ( mUseMask )
-  {
-    dsu.filter( *outputGroup, mOutputMask );
-  }
-  else
-  {
-    dsu.filter( *outputGroup, mOutputExtent );
+    // Finalize dataset
+    if ( mUseMask )
+    {
+      dsu.filter( *outputGroup, mOutputMask );
+    }
+    else
+    {
+      dsu.filter( *outputGroup, mOutputExtent );
+    }
   }
+
   outputGroup->setIsScalar( true );
 
   // before storing the file, find out if the process is not already canceled
@@ -328,3 +347,90 @@ QgsMeshCalculator::Result QgsMeshCalculator::processCalculation( QgsFeedback *fe
   }
   return Success;
 }
+
+QgsMeshCalculator::Result QgsMeshCalculator::calculateByTimeStep( const QgsMeshCalcNode &calcNode, const QList<int> &datasetIndexes, std::unique_ptr<QgsMeshMemoryDatasetGroup> &outputGroup, QgsFeedback *feedback ) const
+{
+  const QStringList usedGroupNames = calcNode.usedDatasetGroupNames();
+
+  std::unique_ptr<QgsMeshCalcUtils> firstDsu = std::make_unique<QgsMeshCalcUtils>( mMeshLayer, usedGroupNames, datasetIndexes.first() );
+  if ( !firstDsu->isValid() )
+  {
+    return InvalidDatasets;
+  }
+
+  // the filter is the same for all the time steps, and the meshes must exist before calculating in parallel
+  QgsMeshMemoryDatasetGroup filter( QStringLiteral( "filter" ), firstDsu->outputType() );
+  if ( mUseMask )
+  {
+    firstDsu->populateMaskFilter( filter, mOutputMask );
+  }
+  else
+  {
+    firstDsu->populateSpatialFilter( filter, mOutputExtent );
+  }
+
+  outputGroup = std::make_unique<QgsMeshMemoryDatasetGroup>( mOutputGroupName, firstDsu->outputType() );
+
+  // dataset values are fetched from the provider in this thread, then the time steps of the batch are calculated in parallel
+  const int batchSize = std::max( 1, QThread::idealThreadCount() );
+  std::vector<std::unique_ptr<QgsMeshCalcUtils>> batch;
+  batch.reserve( batchSize );
+
+  const std::function<std::shared_ptr<QgsMeshMemoryDataset>( int )> calculateTimeStep = [&calcNode, &batch, &filter]( int batchIndex ) -> std::shared_ptr<QgsMeshMemoryDataset>
+  {
+    const QgsMeshCalcUtils &dsu = *batch[batchIndex];
+    QgsMeshMemoryDatasetGroup timeStepGroup( QString(), dsu.outputType() );
+    if ( !calcNode.calculate( dsu, timeStepGroup ) || timeStepGroup.memoryDatasets.isEmpty() )
+      return nullptr;
+
+    dsu.filter( timeStepGroup, filter );
+    return timeStepGroup.memoryDatasets.at( 0 );
+  };
+
+  for ( int first = 0; first < datasetIndexes.count(); first += batchSize )
+  {
+    const int last = std::min( first + batchSize, static_cast<int>( datasetIndexes.count() ) );
+
+    batch.clear();
+    QVector<int> batchIndexes;
+    for ( int i = first; i < last; ++i )
+    {
+      if ( feedback && feedback->isCanceled() )
+      {
+        return Canceled;
+      }
+
+      if ( i == 0 )
+        batch.emplace_back( std::move( firstDsu ) );
+      else
+        batch.emplace_back( std::make_unique<QgsMeshCalcUtils>( mMeshLayer, usedGroupNames, datasetIndexes.at( i ) ) );
+
+      if ( !batch.back()->isValid() )
+      {
+        return InvalidDatasets;
+      }
+      batchIndexes.append( i - first );
+    }
+
+    const QVector<std::shared_ptr<QgsMeshMemoryDataset>> datasets = QtConcurrent::blockingMapped<QVector<std::shared_ptr<QgsMeshMemoryDataset>>>( batchIndexes, calculateTimeStep );
+    for ( const std::shared_ptr<QgsMeshMemoryDataset> &dataset : datasets )
+    {
+      if ( !dataset )
+      {
+        return EvaluateError;
+      }
+      outputGroup->addDataset( dataset );
+    }
+
+    if ( feedback )
+    {
+      if ( feedback->isCanceled() )
+      {
+        return Canceled;
+      }
+      feedback->setProgress( 80.0 * last / datasetIndexes.count() );
+    }
+  }
+
+  return Success;
+}
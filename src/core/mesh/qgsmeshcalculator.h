@@ -21,6 +21,7 @@
 #include <QString>
 #include <QVector>
 #include <QStringList>
+#include <memory>
 
 #include "qgis_core.h"
 #include "qgis_sip.h"
@@ -31,6 +32,7 @@
 
 class QgsMeshLayer;
 class QgsFeedback;
+class QgsMeshCalcNode;
 
 /**
  * \ingroup core
@@ -220,6 +222,12 @@ class CORE_EXPORT QgsMeshCalculator
   private:
     QgsMeshCalculator();
 
+    /**
+     * Calculates the expression one time step after the other for the datasets at \a datasetIndexes,
+     * the time steps of a batch being calculated in parallel
+     */
+    Result calculateByTimeStep( const QgsMeshCalcNode &calcNode, const QList<int> &datasetIndexes, std::unique_ptr<QgsMeshMemoryDatasetGroup> &outputGroup, QgsFeedback *feedback ) const;
+
     QString mFormulaString;
     QString mOutputDriver;
     QString mOutputGroupName;
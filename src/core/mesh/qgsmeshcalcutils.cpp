@@ -31,6 +31,17 @@ const double D_TRUE = 1.0;
 const double D_FALSE = 0.0;
 const double D_NODATA = std::numeric_limits<double>::quiet_NaN();
 
+static int _datasetGroupIndex( const QgsMeshLayer *layer, const QString &datasetGroupName )
+{
+  const QList<int> indexes = layer->datasetGroupsIndexes();
+  for ( const int groupIndex : indexes )
+  {
+    if ( layer->datasetGroupMetadata( groupIndex ).name() == datasetGroupName )
+      return groupIndex;
+  }
+  return -1;
+}
+
 std::shared_ptr<QgsMeshMemoryDatasetGroup> QgsMeshCalcUtils::createMemoryDatasetGroup( const QString &datasetGroupName, const QgsInterval &relativeTime, const QgsInterval &startTime, const QgsInterval &endTime ) const
 {
   std::shared_ptr<QgsMeshMemoryDatasetGroup> grp;
@@ -401,6 +412,136 @@ QgsMeshCalcUtils::QgsMeshCalcUtils( QgsMeshLayer *layer,
   mIgnoreTime = true;
 }
 
+QgsMeshCalcUtils::QgsMeshCalcUtils( QgsMeshLayer *layer,
+                                    const QStringList &usedGroupNames,
+                                    int datasetIndex )
+  : mMeshLayer( layer )
+  , mIsValid( false )
+{
+  // Layer must be valid
+  if ( !mMeshLayer || !mMeshLayer->dataProvider() )
+    return;
+
+  // Resolve output type of the calculation
+  mOutputType = determineResultDataType( layer, usedGroupNames );
+
+  // Data on edges are not implemented
+  if ( mOutputType == QgsMeshDatasetGroupMetadata::DataOnEdges )
+    return;
+
+  // Support for meshes with edges are not implemented
+  if ( mMeshLayer->dataProvider()->contains( QgsMesh::ElementType::Edge ) )
+    return;
+
+  double time = 0.0;
+  bool timeVarying = false;
+  for ( const QString &groupName : usedGroupNames )
+  {
+    const int groupIndex = _datasetGroupIndex( mMeshLayer, groupName );
+    if ( groupIndex < 0 )
+      return;
+
+    // groups that are not time varying are used for all the time steps
+    const int count = mMeshLayer->datasetCount( groupIndex );
+    const int index = count > 1 ? datasetIndex : 0;
+    if ( index < 0 || index >= count )
+      return;
+
+    const QgsMeshDatasetGroupMetadata meta = mMeshLayer->datasetGroupMetadata( groupIndex );
+    const std::shared_ptr<QgsMeshMemoryDatasetGroup> grp = std::make_shared<QgsMeshMemoryDatasetGroup>();
+    grp->setIsScalar( meta.isScalar() );
+    grp->setDataType( mOutputType );
+    grp->setMinimumMaximum( meta.minimum(), meta.maximum() );
+    grp->setName( meta.name() );
+
+    const std::shared_ptr<QgsMeshMemoryDataset> ds = createMemoryDataset( QgsMeshDatasetIndex( groupIndex, index ) );
+    if ( count > 1 )
+    {
+      time = ds->time;
+      timeVarying = true;
+    }
+    grp->addDataset( ds );
+
+    mDatasetGroupMap.insert( groupName, grp );
+  }
+
+  // datasets of the groups that are not time varying are used at the time of the time step
+  if ( timeVarying )
+  {
+    for ( const std::shared_ptr<QgsMeshMemoryDatasetGroup> &grp : qAsConst( mDatasetGroupMap ) )
+      grp->memoryDatasets.at( 0 )->time = time;
+  }
+
+  mDatasetGroupMapForAggregate = mDatasetGroupMap;
+  mTimes.push_back( time );
+
+  mIsValid = true;
+}
+
+QList<int> QgsMeshCalcUtils::timeStepDatasetIndexes( QgsMeshLayer *layer, const QStringList &usedGroupNames, double startTime, double endTime, bool *ok )
+{
+  if ( ok )
+    *ok = false;
+
+  if ( !layer )
+    return QList<int>();
+
+  // same rules as the constructor for the whole time range, but only with the metadata of the datasets
+  QVector<double> times;
+  bool timesPopulated = false;
+  for ( const QString &groupName : usedGroupNames )
+  {
+    const int groupIndex = _datasetGroupIndex( layer, groupName );
+    if ( groupIndex < 0 )
+      return QList<int>();
+
+    const int count = layer->datasetCount( groupIndex );
+    if ( count == 0 )
+      return QList<int>();
+
+    if ( count > 1 )
+    {
+      if ( timesPopulated && count != times.size() )
+        return QList<int>();
+
+      for ( int datasetIndex = 0; datasetIndex < count; ++datasetIndex )
+      {
+        const double time = layer->datasetMetadata( QgsMeshDatasetIndex( groupIndex, datasetIndex ) ).time();
+        if ( timesPopulated )
+        {
+          if ( !qgsDoubleNear( times[datasetIndex], time ) )
+            return QList<int>();
+        }
+        else
+        {
+          times.append( time );
+        }
+      }
+
+      timesPopulated = true;
+    }
+  }
+
+  if ( ok )
+    *ok = true;
+
+  QList<int> indexes;
+  if ( times.isEmpty() )
+  {
+    indexes.append( 0 );
+    return indexes;
+  }
+
+  for ( int i = 0; i < times.size(); ++i )
+  {
+    if ( qgsDoubleNear( times[i], startTime ) ||
+         qgsDoubleNear( times[i], endTime ) ||
+         ( ( times[i] >= startTime ) && ( times[i] <= endTime ) ) )
+      indexes.append( i );
+  }
+  return indexes;
+}
+
 bool  QgsMeshCalcUtils::isValid() const
 {
   return mIsValid;
@@ -1347,6 +1488,11 @@ void QgsMeshCalcUtils::filter( QgsMeshMemoryDatasetGroup &group1, const QgsGeome
   return func2( group1, filter, std::bind( & QgsMeshCalcUtils::ffilter, this, std::placeholders::_1, std::placeholders::_2 ) );
 }
 
+void QgsMeshCalcUtils::filter( QgsMeshMemoryDatasetGroup &group1, const QgsMeshMemoryDatasetGroup &filter ) const
+{
+  return func2( group1, filter, std::bind( & QgsMeshCalcUtils::ffilter, this, std::placeholders::_1, std::placeholders::_2 ) );
+}
+
 void QgsMeshCalcUtils::sumAggregated( QgsMeshMemoryDatasetGroup &group1 ) const
 {
   return funcAggr( group1, std::bind( & QgsMeshCalcUtils::fsumAggregated, this, std::placeholders::_1 ) );
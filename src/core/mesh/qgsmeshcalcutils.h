@@ -109,6 +109,39 @@ class CORE_EXPORT QgsMeshCalcUtils
                       const QgsInterval &startTime,
                       const QgsInterval &endTime );
 
+    /**
+     * Creates the utils and validates the input for a calculation only for the datasets at index \a datasetIndex
+     *
+     * The constructor only fetches the values of the dataset at \a datasetIndex in each group, or of the single dataset
+     * of the groups that are not time varying, so that a calculation over a time range can be done one time step after
+     * the other, with the indexes returned by timeStepDatasetIndexes(). Aggregate functions are not supported,
+     * as they need all the datasets of the time range.
+     *
+     * \param layer mesh layer
+     * \param usedGroupNames dataset group's names that are used in the expression
+     * \param datasetIndex index of the datasets in the time varying groups
+     *
+     * \since QGIS 3.30
+     */
+    QgsMeshCalcUtils( QgsMeshLayer *layer,
+                      const QStringList &usedGroupNames,
+                      int datasetIndex );
+
+    /**
+     * Returns the indexes of the datasets of the time steps of a calculation between \a startTime and \a endTime,
+     * without fetching the dataset values.
+     *
+     * The time steps are the ones of a calculation with the utils created for the whole time range,
+     * and a single time step with index 0 is returned if none of the groups is time varying.
+     * \a ok is set to FALSE if the groups are missing or do not have the same times.
+     *
+     * \since QGIS 3.30
+     */
+    static QList<int> timeStepDatasetIndexes( QgsMeshLayer *layer,
+        const QStringList &usedGroupNames,
+        double startTime,
+        double endTime,
+        bool *ok = nullptr );
 
     //! Returns whether the input parameters are consistent and valid for given mesh layer
     bool isValid() const;
@@ -155,6 +188,18 @@ class CORE_EXPORT QgsMeshCalcUtils
     //! Creates a spatial filter from geometry
     void filter( QgsMeshMemoryDatasetGroup &group1, const QgsGeometry &mask ) const;
 
+    /**
+     * Applies a \a filter group created with populateSpatialFilter() or populateMaskFilter()
+     * \since QGIS 3.30
+     */
+    void filter( QgsMeshMemoryDatasetGroup &group1, const QgsMeshMemoryDatasetGroup &filter ) const;
+
+    //! Creates spatial filter group from rectagle
+    void populateSpatialFilter( QgsMeshMemoryDatasetGroup &filter, const QgsRectangle &extent ) const; // create a filter from extent
+
+    //! Creates mask filter group from geometry
+    void populateMaskFilter( QgsMeshMemoryDatasetGroup &filter, const QgsGeometry &mask ) const; // create a filter from mask
+
     //! Operator NOT
     void logicalNot( QgsMeshMemoryDatasetGroup &group1 ) const;
 
@@ -317,12 +362,6 @@ class CORE_EXPORT QgsMeshCalcUtils
     //! Activates all datasets in group
     void activate( QgsMeshMemoryDatasetGroup &group ) const;
 
-    //! Creates spatial filter group from rectagle
-    void populateSpatialFilter( QgsMeshMemoryDatasetGroup &filter, const QgsRectangle &extent ) const; // create a filter from extent
-
-    //! Creates mask filter group from geometry
-    void populateMaskFilter( QgsMeshMemoryDatasetGroup &filter, const QgsGeometry &mask ) const; // create a filter from mask
-
     //! Calculates unary operators
     void func1( QgsMeshMemoryDatasetGroup &group,
                 std::function<double( double )> func ) const;
@@ -36,6 +36,57 @@
 #include "qgsrendercontext.h"
 #include "qgselevationmap.h"
 
+#include <QThread>
+#include <QtConcurrent>
+
+//! Memory budget of the interpolated raster cache of a mesh layer, in kilobytes
+static constexpr int MAX_INTERPOLATED_RASTER_CACHE_KB = 256 * 1024;
+
+//! Minimum count of triangles for which the interpolation is spread over several threads
+static constexpr int MIN_TRIANGLES_FOR_PARALLEL_INTERPOLATION = 1000;
+
+QgsMeshLayerInterpolatedRasterCache::QgsMeshLayerInterpolatedRasterCache()
+  : mBlocks( MAX_INTERPOLATED_RASTER_CACHE_KB )
+{
+}
+
+QgsRasterBlock *QgsMeshLayerInterpolatedRasterCache::block( const QString &key, int width, int height )
+{
+  QByteArray data;
+  {
+    const QMutexLocker locker( &mMutex );
+    const QByteArray *cached = mBlocks.object( key );
+    if ( !cached )
+      return nullptr;
+    data = *cached;
+  }
+
+  if ( static_cast<qgssize>( data.size() ) != static_cast<qgssize>( width ) * height * sizeof( double ) )
+    return nullptr;
+
+  std::unique_ptr<QgsRasterBlock> block = std::make_unique<QgsRasterBlock>( Qgis::DataType::Float64, width, height );
+  block->setNoDataValue( std::numeric_limits<double>::quiet_NaN() );
+  block->setData( data );
+  return block.release();
+}
+
+void QgsMeshLayerInterpolatedRasterCache::insert( const QString &key, const QgsRasterBlock *block )
+{
+  if ( !block || block->dataType() != Qgis::DataType::Float64 )
+    return;
+
+  QByteArray *data = new QByteArray( block->data() );
+  const int cost = static_cast<int>( data->size() / 1024 ) + 1;
+  const QMutexLocker locker( &mMutex );
+  mBlocks.insert( key, data, cost ); // takes ownership, deletes the data if too large for the cache
+}
+
+void QgsMeshLayerInterpolatedRasterCache::clear()
+{
+  const QMutexLocker locker( &mMutex );
+  mBlocks.clear();
+}
+
 QgsMeshLayerInterpolator::QgsMeshLayerInterpolator(
   const QgsTriangularMesh &m,
   const QVector<double> &datasetValues,
@@ -72,36 +123,119 @@ int QgsMeshLayerInterpolator::bandCount() const
 
 QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent, int width, int height, QgsRasterBlockFeedback *feedback )
 {
-  std::unique_ptr<QgsRasterBlock> outputBlock( new QgsRasterBlock( Qgis::DataType::Float64, width, height ) );
-  const double noDataValue = std::numeric_limits<double>::quiet_NaN();
-  outputBlock->setNoDataValue( noDataValue );
-  outputBlock->setIsNoData();  // assume initially that all values are unset
-  double *data = reinterpret_cast<double *>( outputBlock->bits() );
-
-  QList<int> spatialIndexTriangles;
-  int indexCount;
-  if ( mSpatialIndexActive )
+  QString cacheKey;
+  std::unique_ptr<QgsRasterBlock> outputBlock;
+  if ( mRasterCache )
   {
-    spatialIndexTriangles = mTriangularMesh.faceIndexesForRectangle( extent );
-    indexCount = spatialIndexTriangles.count();
+    cacheKey = QStringLiteral( "%1|%2|%3|%4|%5" ).arg( mRasterCacheKey,
+               extent.toString( 17 ) )
+               .arg( width )
+               .arg( height )
+               .arg( mContext.mapToPixel().mapRotation() );
+    outputBlock.reset( mRasterCache->block( cacheKey, width, height ) );
   }
-  else
+
+  if ( !outputBlock )
   {
-    indexCount = mTriangularMesh.triangles().count();
+    outputBlock.reset( new QgsRasterBlock( Qgis::DataType::Float64, width, height ) );
+    const double noDataValue = std::numeric_limits<double>::quiet_NaN();
+    outputBlock->setNoDataValue( noDataValue );
+    outputBlock->setIsNoData();  // assume initially that all values are unset
+    double *data = reinterpret_cast<double *>( outputBlock->bits() );
+
+    if ( mTriangularMesh.contains( QgsMesh::ElementType::Edge ) )
+    {
+      return outputBlock.release();
+    }
+
+    QList<int> spatialIndexTriangles;
+    int indexCount;
+    if ( mSpatialIndexActive )
+    {
+      spatialIndexTriangles = mTriangularMesh.faceIndexesForRectangle( extent );
+      indexCount = spatialIndexTriangles.count();
+    }
+    else
+    {
+      indexCount = mTriangularMesh.triangles().count();
+    }
+
+    const QVector<QgsMeshVertex> &vertices = mTriangularMesh.vertices();
+
+    // currently expecting that triangulation does not add any new extra vertices on the way
+    if ( mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
+      Q_ASSERT( mDatasetValues.count() == mTriangularMesh.vertices().count() );
+
+    // gather the active triangles intersecting the extent, with their limits in pixels
+    QVector<TriangleLimits> triangles;
+    triangles.reserve( indexCount );
+    for ( int i = 0; i < indexCount; ++i )
+    {
+      const int triangleIndex = mSpatialIndexActive ? spatialIndexTriangles[i] : i;
+      const QgsMeshFace &face = mTriangularMesh.triangles()[triangleIndex];
+
+      if ( face.isEmpty() )
+        continue;
+
+      const int nativeFaceIndex = mTriangularMesh.trianglesToNativeFaces()[triangleIndex];
+      const bool isActive = mActiveFaceFlagValues.active( nativeFaceIndex );
+      if ( !isActive )
+        continue;
+
+      const QgsRectangle bbox = QgsMeshLayerUtils::triangleBoundingBox( vertices[face[0]], vertices[face[1]], vertices[face[2]] );
+      if ( !extent.intersects( bbox ) )
+        continue;
+
+      TriangleLimits limits;
+      limits.triangleIndex = triangleIndex;
+      QgsMeshLayerUtils::boundingBoxToScreenRectangle( mContext.mapToPixel(), mOutputSize, bbox, limits.leftLim, limits.rightLim, limits.topLim, limits.bottomLim );
+      if ( limits.topLim > limits.bottomLim || limits.leftLim > limits.rightLim )
+        continue;
+
+      triangles.append( limits );
+    }
+
+    // interpolate bands of rows in parallel, each band only writes its own rows
+    // and keeps the order of the triangles, so that the result is the same as a serial interpolation
+    const int rowCount = std::min( height, mOutputSize.height() );
+    const int bandCount = triangles.count() < MIN_TRIANGLES_FOR_PARALLEL_INTERPOLATION ? 1 : std::min( rowCount, QThread::idealThreadCount() * 4 );
+    if ( bandCount <= 1 )
+    {
+      interpolateRows( triangles, 0, rowCount - 1, data, width, feedback );
+    }
+    else
+    {
+      const int bandHeight = ( rowCount + bandCount - 1 ) / bandCount;
+      QVector<QPair<int, int>> bands;
+      for ( int firstRow = 0; firstRow < rowCount; firstRow += bandHeight )
+        bands.append( qMakePair( firstRow, std::min( firstRow + bandHeight, rowCount ) - 1 ) );
+
+      QtConcurrent::blockingMap( bands, [this, &triangles, data, width, feedback]( const QPair<int, int> &band )
+      {
+        interpolateRows( triangles, band.first, band.second, data, width, feedback );
+      } );
+    }
+
+    const bool canceled = ( feedback && feedback->isCanceled() ) || mContext.renderingStopped();
+    if ( mRasterCache && !canceled )
+      mRasterCache->insert( cacheKey, outputBlock.get() );
   }
 
-  if ( mTriangularMesh.contains( QgsMesh::ElementType::Edge ) )
+  if ( mRenderElevation )
   {
-    return outputBlock.release();
+    QgsElevationMap *elevationMap = mContext.elevationMap();
+    if ( elevationMap && elevationMap->isValid() )
+      elevationMap->fillWithRasterBlock( outputBlock.get(), 0, 0, mElevationScale, mElevationOffset );
   }
 
-  const QVector<QgsMeshVertex> &vertices = mTriangularMesh.vertices();
+  return outputBlock.release();
+}
 
-  // currently expecting that triangulation does not add any new extra vertices on the way
-  if ( mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
-    Q_ASSERT( mDatasetValues.count() == mTriangularMesh.vertices().count() );
+void QgsMeshLayerInterpolator::interpolateRows( const QVector<TriangleLimits> &triangles, int firstRow, int lastRow, double *data, int width, QgsRasterBlockFeedback *feedback ) const
+{
+  const QVector<QgsMeshVertex> &vertices = mTriangularMesh.vertices();
 
-  for ( int i = 0; i < indexCount; ++i )
+  for ( const TriangleLimits &limits : triangles )
   {
     if ( feedback && feedback->isCanceled() )
       break;
@@ -109,35 +243,17 @@ QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent
     if ( mContext.renderingStopped() )
       break;
 
-    int triangleIndex;
-    if ( mSpatialIndexActive )
-      triangleIndex = spatialIndexTriangles[i];
-    else
-      triangleIndex = i;
-
-    const QgsMeshFace &face = mTriangularMesh.triangles()[triangleIndex];
-
-    if ( face.isEmpty() )
+    const int topLim = std::max( limits.topLim, firstRow );
+    const int bottomLim = std::min( limits.bottomLim, lastRow );
+    if ( topLim > bottomLim )
       continue;
 
+    const QgsMeshFace &face = mTriangularMesh.triangles()[limits.triangleIndex];
     const int v1 = face[0], v2 = face[1], v3 = face[2];
     const QgsPointXY &p1 = vertices[v1], &p2 = vertices[v2], &p3 = vertices[v3];
 
-    const int nativeFaceIndex = mTriangularMesh.trianglesToNativeFaces()[triangleIndex];
-    const bool isActive = mActiveFaceFlagValues.active( nativeFaceIndex );
-    if ( !isActive )
-      continue;
-
-    const QgsRectangle bbox = QgsMeshLayerUtils::triangleBoundingBox( p1, p2, p3 );
-    if ( !extent.intersects( bbox ) )
-      continue;
-
-    // Get the BBox of the element in pixels
-    int topLim, bottomLim, leftLim, rightLim;
-    QgsMeshLayerUtils::boundingBoxToScreenRectangle( mContext.mapToPixel(), mOutputSize, bbox, leftLim, rightLim, topLim, bottomLim );
-
     double value( 0 ), value1( 0 ), value2( 0 ), value3( 0 );
-    const int faceIdx = mTriangularMesh.trianglesToNativeFaces()[triangleIndex];
+    const int faceIdx = mTriangularMesh.trianglesToNativeFaces()[limits.triangleIndex];
 
     if ( mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
     {
@@ -152,7 +268,7 @@ QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent
     for ( int j = topLim; j <= bottomLim; j++ )
     {
       double *line = data + ( j * width );
-      for ( int k = leftLim; k <= rightLim; k++ )
+      for ( int k = limits.leftLim; k <= limits.rightLim; k++ )
       {
         double val;
         const QgsPointXY p = mContext.mapToPixel().toMapCoordinates( k, j );
@@ -175,23 +291,12 @@ QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent
                   p
                 );
         }
+        // the block has a NaN no data value, so unset pixels are already flagged as no data
         if ( !std::isnan( val ) )
-        {
           line[k] = val;
-          outputBlock->setIsData( j, k );
-        }
       }
     }
   }
-
-  if ( mRenderElevation )
-  {
-    QgsElevationMap *elevationMap = mContext.elevationMap();
-    if ( elevationMap && elevationMap->isValid() )
-      elevationMap->fillWithRasterBlock( outputBlock.get(), 0, 0, mElevationScale, mElevationOffset );
-  }
-
-  return outputBlock.release();
 }
 
 void QgsMeshLayerInterpolator::setSpatialIndexActive( bool active )
@@ -199,6 +304,12 @@ void QgsMeshLayerInterpolator::setSpatialIndexActive( bool active )
   mSpatialIndexActive = active;
 }
 
+void QgsMeshLayerInterpolator::setRasterCache( QgsMeshLayerInterpolatedRasterCache *cache, const QString &key )
+{
+  mRasterCache = cache;
+  mRasterCacheKey = key;
+}
+
 void QgsMeshLayerInterpolator::setElevationMapSettings( bool renderElevationMap, double elevationScale, double elevationOffset )
 {
   mRenderElevation = renderElevationMap;
@@ -28,6 +28,8 @@ class QgsMeshDatasetIndex;
 #include "qgis_sip.h"
 
 #include <QSize>
+#include <QCache>
+#include <QMutex>
 #include "qgsmaplayerrenderer.h"
 #include "qgstriangularmesh.h"
 #include "qgsrasterinterface.h"
@@ -44,6 +46,41 @@ class QgsRenderContext;
 
 ///@cond PRIVATE
 
+/**
+ * \ingroup core
+ * \brief Cache of the raster blocks interpolated from the scalar datasets of a mesh layer
+ *
+ * The cache is shared by the renderers of a mesh layer, so that the frames of a temporal animation
+ * are interpolated only once when they are rendered again. Blocks are stored as their Float64 values
+ * with NaN no data, up to a total memory budget.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_NO_EXPORT QgsMeshLayerInterpolatedRasterCache SIP_SKIP
+{
+  public:
+    //! Ctor
+    QgsMeshLayerInterpolatedRasterCache();
+
+    /**
+     * Returns a new block with the values stored for \a key, or NULLPTR if there is no such block
+     * or if its size does not match \a width and \a height.
+     */
+    QgsRasterBlock *block( const QString &key, int width, int height );
+
+    //! Stores the values of a Float64 \a block for \a key
+    void insert( const QString &key, const QgsRasterBlock *block );
+
+    //! Removes all the stored blocks
+    void clear();
+
+  private:
+    QMutex mMutex;
+    //! Cost of the entries in kilobytes
+    QCache<QString, QByteArray> mBlocks;
+};
+
 /**
  * \ingroup core
  * \brief Interpolate mesh scalar dataset to raster block
@@ -72,7 +109,28 @@ class QgsMeshLayerInterpolator : public QgsRasterInterface SIP_SKIP
 
     void setElevationMapSettings( bool renderElevationMap, double elevationScale, double elevationOffset );
 
+    /**
+     * Sets the \a cache used to store the interpolated blocks. The \a key identifies the dataset values
+     * and the triangular mesh, the extent and size of the block are appended to it.
+     * The cache is not owned by the interpolator and must outlive it.
+     * \since QGIS 3.30
+     */
+    void setRasterCache( QgsMeshLayerInterpolatedRasterCache *cache, const QString &key );
+
   private:
+
+    //! Pixel limits of a triangle to interpolate
+    struct TriangleLimits
+    {
+      int triangleIndex;
+      int topLim;
+      int bottomLim;
+      int leftLim;
+      int rightLim;
+    };
+
+    void interpolateRows( const QVector<TriangleLimits> &triangles, int firstRow, int lastRow, double *data, int width, QgsRasterBlockFeedback *feedback ) const;
+
     const QgsTriangularMesh &mTriangularMesh;
     const QVector<double> &mDatasetValues;
     const QgsMeshDataBlock &mActiveFaceFlagValues;
@@ -84,6 +142,9 @@ class QgsMeshLayerInterpolator : public QgsRasterInterface SIP_SKIP
     bool mRenderElevation = false;
     double mElevationScale = 1.0;
     double mElevationOffset = 0.0;
+
+    QgsMeshLayerInterpolatedRasterCache *mRasterCache = nullptr;
+    QString mRasterCacheKey;
 };
 
 ///@endcond
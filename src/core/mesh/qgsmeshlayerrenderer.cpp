@@ -97,6 +97,7 @@ void QgsMeshLayerRenderer::copyTriangularMeshes( QgsMeshLayer *layer, QgsRenderC
     const double triangleSize = simplificationSettings.meshResolution() * context.mapToPixel().mapUnitsPerPixel();
     mTriangularMesh = *( layer->triangularMesh( triangleSize ) );
     mIsMeshSimplificationActive = true;
+    mSimplifiedTriangleSize = triangleSize;
   }
   else
   {
@@ -133,6 +134,22 @@ void QgsMeshLayerRenderer::copyScalarDatasetValues( QgsMeshLayer *layer )
   const int datasetGroupCount = layer->datasetGroupCount();
   const QgsMeshRendererScalarSettings::DataResamplingMethod method = mRendererSettings.scalarSettings( datasetIndex.group() ).dataResamplingMethod();
   QgsMeshLayerRendererCache *cache = layer->rendererCache();
+
+  // interpolated rasters are kept for each dataset, so that animation frames are interpolated once,
+  // but not while the mesh is edited
+  if ( ( cache->mDatasetGroupsCount != datasetGroupCount ) ||
+       ( !QgsMesh3dAveragingMethod::equals( cache->mScalarAveragingMethod.get(), mRendererSettings.averagingMethod() ) ) )
+    cache->mInterpolatedRasters->clear();
+  if ( !mIsEditable && datasetIndex.isValid() )
+  {
+    mInterpolatedRasterCache = cache->mInterpolatedRasters;
+    mInterpolatedRasterCacheKey = QStringLiteral( "%1|%2|%3|%4|%5" ).arg( datasetIndex.group() )
+                                  .arg( datasetIndex.dataset() )
+                                  .arg( static_cast<int>( method ) )
+                                  .arg( mSimplifiedTriangleSize, 0, 'g', 17 )
+                                  .arg( renderContext()->coordinateTransform().destinationCrs().toWkt() );
+  }
+
   if ( ( cache->mDatasetGroupsCount == datasetGroupCount ) &&
        ( cache->mActiveScalarDatasetIndex == datasetIndex ) &&
        ( cache->mDataInterpolationMethod ==  method ) &&
@@ -570,6 +587,8 @@ void QgsMeshLayerRenderer::renderScalarDatasetOnFaces( const QgsMeshRendererScal
                                          mOutputSize );
   interpolator.setSpatialIndexActive( mIsMeshSimplificationActive );
   interpolator.setElevationMapSettings( mRenderElevationMap, mElevationScale, mElevationOffset );
+  if ( mInterpolatedRasterCache )
+    interpolator.setRasterCache( mInterpolatedRasterCache.get(), mInterpolatedRasterCacheKey );
   QgsSingleBandPseudoColorRenderer renderer( &interpolator, 0, sh );  // takes ownership of sh
   renderer.setClassificationMin( scalarSettings.classificationMinimum() );
   renderer.setClassificationMax( scalarSettings.classificationMaximum() );
@@ -34,6 +34,7 @@ class QgsMeshLayer;
 #include "qgsmeshdataprovider.h"
 #include "qgsmeshtracerenderer.h"
 #include "qgsmapclippingregion.h"
+#include "qgsmeshlayerinterpolator.h"
 
 class QgsRenderContext;
 
@@ -77,6 +78,9 @@ struct CORE_NO_EXPORT QgsMeshLayerRendererCache
   double mVectorDatasetGroupMagMaximum = std::numeric_limits<double>::quiet_NaN();
   QgsMeshDatasetGroupMetadata::DataType mVectorDataType = QgsMeshDatasetGroupMetadata::DataType::DataOnVertices;
   std::unique_ptr<QgsMesh3dAveragingMethod> mVectorAveragingMethod;
+
+  // rasters interpolated from the scalar datasets, shared with the renderers
+  std::shared_ptr<QgsMeshLayerInterpolatedRasterCache> mInterpolatedRasters = std::make_shared<QgsMeshLayerInterpolatedRasterCache>();
 };
 
 
@@ -114,6 +118,7 @@ class QgsMeshLayerRenderer : public QgsMapLayerRenderer
     void calculateOutputSize();
     QgsPointXY fractionPoint( const QgsPointXY &p1, const QgsPointXY &p2, double fraction ) const;
     bool mIsMeshSimplificationActive = false;
+    double mSimplifiedTriangleSize = 0;
     QColor colorAt( QgsColorRampShader *shader, double val ) const;
     bool mIsEditable = false;
 
@@ -136,6 +141,8 @@ class QgsMeshLayerRenderer : public QgsMapLayerRenderer
     QgsMeshDatasetGroupMetadata::DataType mScalarDataType = QgsMeshDatasetGroupMetadata::DataOnVertices;
     double mScalarDatasetMinimum = std::numeric_limits<double>::quiet_NaN();
     double mScalarDatasetMaximum = std::numeric_limits<double>::quiet_NaN();
+    std::shared_ptr<QgsMeshLayerInterpolatedRasterCache> mInterpolatedRasterCache;
+    QString mInterpolatedRasterCacheKey;
 
     // copy of the vector dataset
     QgsMeshDataBlock mVectorDatasetValues;
@@ -23,6 +23,8 @@
 #include "qgsmeshlayerutils.h"
 
 #include <QPointer>
+#include <QThread>
+#include <QtConcurrent>
 
 ///@cond PRIVATE
 
@@ -43,7 +45,12 @@ QgsVector QgsMeshVectorValueInterpolator::vectorValue( const QgsPointXY &point )
     }
   }
 
-  //point is not on the face associated with mCacheIndex --> search for the face containing the point
+  //point is not on the face associated with mCacheIndex --> search for the face containing the point,
+  //first in the lookup grid if the face is not ambiguous, then with the spatial index
+  QgsVector gridValue;
+  if ( vectorValueFromLookupGrid( point, gridValue ) )
+    return gridValue;
+
   QList<int> potentialFaceIndexes = mTriangularMesh.faceIndexesForRectangle( QgsRectangle( point, point ) );
   mCacheFaceIndex = -1;
   for ( const int faceIndex : potentialFaceIndexes )
@@ -62,6 +69,150 @@ QgsVector QgsMeshVectorValueInterpolator::vectorValue( const QgsPointXY &point )
 
 }
 
+//! Maximum count of faces that can contain the points of a pixel of the face lookup grid
+static constexpr int FACE_LOOKUP_CAPACITY = 3;
+
+//! Value of the first face of a pixel of the face lookup grid when more faces can contain its points
+static constexpr int FACE_LOOKUP_OVERFLOW = -2;
+
+bool QgsMeshVectorValueInterpolator::vectorValueFromLookupGrid( const QgsPointXY &point, QgsVector &vector ) const
+{
+  if ( mFaceLookupGrid.isEmpty() )
+    return false;
+
+  const QgsPointXY fieldPosition = mFaceLookupMapToPixel.transform( point );
+  const int i = static_cast<int>( std::round( fieldPosition.x() ) );
+  const int j = static_cast<int>( std::round( fieldPosition.y() ) );
+  if ( i < 0 || j < 0 || i >= mFaceLookupSize.width() || j >= mFaceLookupSize.height() )
+    return false;
+
+  const int *faces = mFaceLookupGrid.constData() + FACE_LOOKUP_CAPACITY * ( j * mFaceLookupSize.width() + i );
+  if ( faces[0] == FACE_LOOKUP_OVERFLOW )
+    return false;
+
+  // the grid contains all the faces that can contain the point, so if only one gives a valid vector,
+  // it is the face that would be found with the spatial index
+  int foundFaceIndex = -1;
+  QgsVector foundValue;
+  for ( int k = 0; k < FACE_LOOKUP_CAPACITY && faces[k] >= 0; ++k )
+  {
+    const QgsVector res = interpolatedValuePrivate( faces[k], point );
+    if ( isVectorValid( res ) )
+    {
+      if ( foundFaceIndex != -1 )
+        return false;
+      foundFaceIndex = faces[k];
+      foundValue = res;
+    }
+  }
+
+  mCacheFaceIndex = foundFaceIndex;
+  if ( foundFaceIndex == -1 )
+  {
+    vector = QgsVector( std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN() );
+    return true;
+  }
+
+  activeFaceFilter( foundValue, foundFaceIndex );
+  vector = foundValue;
+  return true;
+}
+
+void QgsMeshVectorValueInterpolator::buildFaceLookupGrid( const QgsMapToPixel &mapToPixel, const QSize &size )
+{
+  mFaceLookupMapToPixel = mapToPixel;
+  mFaceLookupSize = size;
+  mFaceLookupGrid.clear();
+  if ( size.isEmpty() )
+    return;
+
+  mFaceLookupGrid = QVector<int>( FACE_LOOKUP_CAPACITY * size.width() * size.height(), -1 );
+
+  struct FaceLimits
+  {
+    int faceIndex;
+    int left;
+    int right;
+    int top;
+    int bottom;
+  };
+
+  // pixels of the field that can contain the points of the bounding box of each face,
+  // with a margin of one pixel for the rounding of the positions
+  const QVector<QgsMeshFace> &triangles = mTriangularMesh.triangles();
+  const QVector<QgsMeshVertex> &vertices = mTriangularMesh.vertices();
+  QVector<FaceLimits> facesLimits;
+  facesLimits.reserve( triangles.count() );
+  for ( int faceIndex = 0; faceIndex < triangles.count(); ++faceIndex )
+  {
+    const QgsMeshFace &face = triangles.at( faceIndex );
+    if ( face.count() < 3 )
+      continue;
+
+    const QgsRectangle bbox = QgsMeshLayerUtils::triangleBoundingBox( vertices.at( face.at( 0 ) ), vertices.at( face.at( 1 ) ), vertices.at( face.at( 2 ) ) );
+    const QgsPointXY corners[4] = { mapToPixel.transform( bbox.xMinimum(), bbox.yMinimum() ),
+                                    mapToPixel.transform( bbox.xMinimum(), bbox.yMaximum() ),
+                                    mapToPixel.transform( bbox.xMaximum(), bbox.yMinimum() ),
+                                    mapToPixel.transform( bbox.xMaximum(), bbox.yMaximum() )
+                                  };
+    double xMin = corners[0].x(), xMax = corners[0].x(), yMin = corners[0].y(), yMax = corners[0].y();
+    for ( const QgsPointXY &corner : corners )
+    {
+      xMin = std::min( xMin, corner.x() );
+      xMax = std::max( xMax, corner.x() );
+      yMin = std::min( yMin, corner.y() );
+      yMax = std::max( yMax, corner.y() );
+    }
+
+    FaceLimits limits;
+    limits.faceIndex = faceIndex;
+    limits.left = std::max( static_cast<int>( std::floor( xMin ) ) - 1, 0 );
+    limits.right = std::min( static_cast<int>( std::ceil( xMax ) ) + 1, size.width() - 1 );
+    limits.top = std::max( static_cast<int>( std::floor( yMin ) ) - 1, 0 );
+    limits.bottom = std::min( static_cast<int>( std::ceil( yMax ) ) + 1, size.height() - 1 );
+    if ( limits.left > limits.right || limits.top > limits.bottom )
+      continue;
+
+    facesLimits.append( limits );
+  }
+
+  // fill bands of rows in parallel, each band only writes its own rows
+  const int bandCount = std::max( 1, std::min( size.height(), QThread::idealThreadCount() * 4 ) );
+  const int bandHeight = ( size.height() + bandCount - 1 ) / bandCount;
+  QVector<QPair<int, int>> bands;
+  for ( int firstRow = 0; firstRow < size.height(); firstRow += bandHeight )
+    bands.append( qMakePair( firstRow, std::min( firstRow + bandHeight, size.height() ) - 1 ) );
+
+  int *grid = mFaceLookupGrid.data();
+  const int width = size.width();
+  QtConcurrent::blockingMap( bands, [&facesLimits, grid, width]( const QPair<int, int> &band )
+  {
+    for ( const FaceLimits &limits : facesLimits )
+    {
+      const int top = std::max( limits.top, band.first );
+      const int bottom = std::min( limits.bottom, band.second );
+      for ( int j = top; j <= bottom; ++j )
+      {
+        for ( int i = limits.left; i <= limits.right; ++i )
+        {
+          int *faces = grid + FACE_LOOKUP_CAPACITY * ( j * width + i );
+          if ( faces[0] == FACE_LOOKUP_OVERFLOW )
+            continue;
+
+          int k = 0;
+          while ( k < FACE_LOOKUP_CAPACITY && faces[k] >= 0 )
+            ++k;
+
+          if ( k < FACE_LOOKUP_CAPACITY )
+            faces[k] = limits.faceIndex;
+          else
+            faces[0] = FACE_LOOKUP_OVERFLOW;
+        }
+      }
+    }
+  } );
+}
+
 QgsMeshVectorValueInterpolator &QgsMeshVectorValueInterpolator::operator=( const QgsMeshVectorValueInterpolator &other )
 {
   mTriangularMesh = other.mTriangularMesh;
@@ -70,6 +221,9 @@ QgsMeshVectorValueInterpolator &QgsMeshVectorValueInterpolator::operator=( const
   mFaceCache = other.mFaceCache;
   mCacheFaceIndex = other.mCacheFaceIndex;
   mUseScalarActiveFaceFlagValues = other.mUseScalarActiveFaceFlagValues;
+  mFaceLookupGrid = other.mFaceLookupGrid;
+  mFaceLookupMapToPixel = other.mFaceLookupMapToPixel;
+  mFaceLookupSize = other.mFaceLookupSize;
 
   return *this;
 }
@@ -155,7 +309,10 @@ QgsMeshVectorValueInterpolator::QgsMeshVectorValueInterpolator( const QgsMeshVec
   mActiveFaceFlagValues( other.mActiveFaceFlagValues ),
   mFaceCache( other.mFaceCache ),
   mCacheFaceIndex( other.mCacheFaceIndex ),
-  mUseScalarActiveFaceFlagValues( other.mUseScalarActiveFaceFlagValues )
+  mUseScalarActiveFaceFlagValues( other.mUseScalarActiveFaceFlagValues ),
+  mFaceLookupGrid( other.mFaceLookupGrid ),
+  mFaceLookupMapToPixel( other.mFaceLookupMapToPixel ),
+  mFaceLookupSize( other.mFaceLookupSize )
 {}
 
 void QgsMeshVectorValueInterpolator::updateCacheFaceIndex( const QgsPointXY &point ) const
@@ -303,6 +460,8 @@ void QgsMeshStreamField::updateSize( const QgsRenderContext &renderContext )
     mValid = false;
     mFieldSize = QSize();
     mFieldTopLeftInDeviceCoordinates = QPoint();
+    if ( mVectorValueInterpolator )
+      mVectorValueInterpolator->buildFaceLookupGrid( QgsMapToPixel(), QSize() );
     initField();
     return;
   }
@@ -370,6 +529,9 @@ void QgsMeshStreamField::updateSize( const QgsRenderContext &renderContext )
                                     deviceMapToPixel.mapRotation()
                                   );
 
+  if ( mVectorValueInterpolator )
+    mVectorValueInterpolator->buildFaceLookupGrid( mMapToFieldPixel, mFieldSize );
+
   initField();
   mValid = true;
 }
@@ -77,6 +77,18 @@ class QgsMeshVectorValueInterpolator
     //! Assignment operator
     QgsMeshVectorValueInterpolator &operator=( const QgsMeshVectorValueInterpolator &other );
 
+    /**
+     * Builds a grid of the faces that can contain the points of each pixel of a field of \a size,
+     * with \a mapToPixel to convert map points to positions in the field.
+     *
+     * The grid is used in place of the spatial index of the mesh to find the face of a point,
+     * when there is no ambiguity on this face. It is built on worker threads.
+     * An empty \a size removes the grid.
+     *
+     * \since QGIS 3.30
+     */
+    void buildFaceLookupGrid( const QgsMapToPixel &mapToPixel, const QSize &size );
+
   protected:
     void updateCacheFaceIndex( const QgsPointXY &point ) const;
 
@@ -92,6 +104,16 @@ class QgsMeshVectorValueInterpolator
 
     void activeFaceFilter( QgsVector &vector, int faceIndex ) const;
 
+    /**
+     * Finds the vector at \a point with the faces of the lookup grid, returns FALSE if the grid cannot
+     * be used for this point and the spatial index has to be used
+     */
+    bool vectorValueFromLookupGrid( const QgsPointXY &point, QgsVector &vector ) const;
+
+    QVector<int> mFaceLookupGrid;
+    QgsMapToPixel mFaceLookupMapToPixel;
+    QSize mFaceLookupSize;
+
     virtual QgsVector interpolatedValuePrivate( int faceIndex, const QgsPointXY point ) const = 0;
 };
 
@@ -15,8 +15,10 @@
  *                                                                         *
  ***************************************************************************/
 
+#include <functional>
 #include <memory>
 #include <QList>
+#include <QtConcurrent>
 #include "qgspolygon.h"
 #include "qgslinestring.h"
 #include "qgstriangularmesh.h"
@@ -115,6 +117,58 @@ static void triangulateFaces( const QgsMeshFace &face,
   }
 }
 
+//! Number of vertices or faces processed together by a worker thread when updating the triangular mesh
+static constexpr int UPDATE_BLOCK_SIZE = 50000;
+
+// Returns the ranges of elements, as [begin, end) pairs, processed by the worker threads
+static QVector< QPair< int, int > > _updateBlocks( int count )
+{
+  QVector< QPair< int, int > > blocks;
+  for ( int begin = 0; begin < count; begin += UPDATE_BLOCK_SIZE )
+    blocks << qMakePair( begin, std::min( count, begin + UPDATE_BLOCK_SIZE ) );
+  return blocks;
+}
+
+// Transforms the vertices in place in a single call to the transform, or vertex by vertex if some cannot be transformed
+static void _transformVertices( QgsMeshVertex *vertices, int count, const QgsCoordinateTransform &transform )
+{
+  std::vector< double > x( count );
+  std::vector< double > y( count );
+  // as with QgsPoint::transform(), the z values of the vertices are not transformed
+  std::vector< double > z( count, 0.0 );
+  for ( int i = 0; i < count; ++i )
+  {
+    x[i] = vertices[i].x();
+    y[i] = vertices[i].y();
+  }
+
+  try
+  {
+    transform.transformCoords( count, x.data(), y.data(), z.data() );
+    for ( int i = 0; i < count; ++i )
+    {
+      vertices[i].setX( x[i] );
+      vertices[i].setY( y[i] );
+    }
+  }
+  catch ( QgsCsException & )
+  {
+    for ( int i = 0; i < count; ++i )
+    {
+      try
+      {
+        vertices[i].transform( transform );
+      }
+      catch ( QgsCsException &cse )
+      {
+        Q_UNUSED( cse )
+        QgsDebugMsg( QStringLiteral( "Caught CRS exception %1" ).arg( cse.what() ) );
+        vertices[i] = QgsMeshVertex();
+      }
+    }
+  }
+}
+
 void QgsTriangularMesh::triangulate( const QgsMeshFace &face, int nativeIndex )
 {
   triangulateFaces( face, nativeIndex, mTriangularMesh.faces, mTrianglesToNativeFaces, mTriangularMesh );
@@ -186,31 +240,57 @@ bool QgsTriangularMesh::update( QgsMesh *nativeMesh, const QgsCoordinateTransfor
 
   // TRANSFORM VERTICES
   mCoordinateTransform = transform;
-  mTriangularMesh.vertices.resize( nativeMesh->vertices.size() );
+  mTriangularMesh.vertices = nativeMesh->vertices;
+  if ( mCoordinateTransform.isValid() )
+  {
+    QgsMeshVertex *vertices = mTriangularMesh.vertices.data();
+    const QgsCoordinateTransform coordinateTransform = mCoordinateTransform;
+    QVector< QPair< int, int > > vertexBlocks = _updateBlocks( mTriangularMesh.vertices.size() );
+    QtConcurrent::blockingMap( vertexBlocks, [vertices, coordinateTransform]( const QPair< int, int > &block )
+    {
+      _transformVertices( vertices + block.first, block.second - block.first, coordinateTransform );
+    } );
+  }
   mExtent.setMinimal();
-  for ( int i = 0; i < nativeMesh->vertices.size(); ++i )
+  for ( int i = 0; i < mTriangularMesh.vertices.size(); ++i )
   {
-    mTriangularMesh.vertices[i] = nativeToTriangularCoordinates( nativeMesh->vertices.at( i ) );
     mExtent.include( mTriangularMesh.vertices.at( i ) );
   }
 
   if ( needUpdateFrame )
   {
     // CREATE TRIANGULAR MESH
-    for ( int i = 0; i < nativeMesh->faces.size(); ++i )
+    // faces are triangulated by blocks on worker threads, then the triangles are gathered in the order of the native faces
+    struct TriangulatedBlock
+    {
+      QVector<QgsMeshFace> faces;
+      QVector<int> trianglesToNativeFaces;
+    };
+    const QgsMesh &triangularMesh = mTriangularMesh;
+    const QVector<TriangulatedBlock> triangulatedBlocks = QtConcurrent::blockingMapped< QVector<TriangulatedBlock> >( _updateBlocks( nativeMesh->faces.size() ),
+        std::function< TriangulatedBlock( const QPair< int, int > & )>( [nativeMesh, &triangularMesh]( const QPair< int, int > &block )
     {
-      const QgsMeshFace &face = nativeMesh->faces.at( i ) ;
-      triangulate( face, i );
+      TriangulatedBlock triangulatedBlock;
+      for ( int i = block.first; i < block.second; ++i )
+        triangulateFaces( nativeMesh->faces.at( i ), i, triangulatedBlock.faces, triangulatedBlock.trianglesToNativeFaces, triangularMesh );
+      return triangulatedBlock;
+    } ) );
+    for ( const TriangulatedBlock &triangulatedBlock : triangulatedBlocks )
+    {
+      mTriangularMesh.faces.append( triangulatedBlock.faces );
+      mTrianglesToNativeFaces.append( triangulatedBlock.trianglesToNativeFaces );
     }
   }
 
   // CALCULATE CENTROIDS
   mNativeMeshFaceCentroids.resize( nativeMesh->faces.size() );
-  for ( int i = 0; i < nativeMesh->faces.size(); ++i )
+  QgsMeshVertex *centroids = mNativeMeshFaceCentroids.data();
+  QVector< QPair< int, int > > faceBlocks = _updateBlocks( nativeMesh->faces.size() );
+  QtConcurrent::blockingMap( faceBlocks, [this, nativeMesh, centroids]( const QPair< int, int > &block )
   {
-    const QgsMeshFace &face = nativeMesh->faces.at( i ) ;
-    mNativeMeshFaceCentroids[i] = calculateCentroid( face );
-  }
+    for ( int i = block.first; i < block.second; ++i )
+      centroids[i] = calculateCentroid( nativeMesh->faces.at( i ) );
+  } );
 
   // CALCULATE SPATIAL INDEX
   mSpatialFaceIndex = QgsMeshSpatialIndex( mTriangularMesh, nullptr, QgsMesh::ElementType::Face );
@@ -262,20 +342,29 @@ bool QgsTriangularMesh::update( QgsMesh *nativeMesh )
 void QgsTriangularMesh::finalizeTriangles()
 {
   mAverageTriangleSize = 0;
-  for ( int i = 0; i < mTriangularMesh.faceCount(); ++i )
+  QgsMeshFace *faces = mTriangularMesh.faces.data();
+  const QVector< double > blockSizes = QtConcurrent::blockingMapped< QVector< double > >( _updateBlocks( mTriangularMesh.faceCount() ),
+                                       std::function< double( const QPair< int, int > & )>( [this, faces]( const QPair< int, int > &block )
   {
-    QgsMeshFace &face = mTriangularMesh.faces[i];
+    double blockSize = 0;
+    for ( int i = block.first; i < block.second; ++i )
+    {
+      QgsMeshFace &face = faces[i];
 
-    const QgsMeshVertex &v0 = mTriangularMesh.vertex( face[0] );
-    const QgsMeshVertex &v1 = mTriangularMesh.vertex( face[1] );
-    const QgsMeshVertex &v2 = mTriangularMesh.vertex( face[2] );
+      const QgsMeshVertex &v0 = mTriangularMesh.vertex( face[0] );
+      const QgsMeshVertex &v1 = mTriangularMesh.vertex( face[1] );
+      const QgsMeshVertex &v2 = mTriangularMesh.vertex( face[2] );
 
-    QgsRectangle bbox = QgsMeshLayerUtils::triangleBoundingBox( v0, v1, v2 );
+      QgsRectangle bbox = QgsMeshLayerUtils::triangleBoundingBox( v0, v1, v2 );
 
-    mAverageTriangleSize += std::fmax( bbox.width(), bbox.height() );
+      blockSize += std::fmax( bbox.width(), bbox.height() );
 
-    QgsMeshUtils::setCounterClockwise( face, v0, v1, v2 );
-  }
+      QgsMeshUtils::setCounterClockwise( face, v0, v1, v2 );
+    }
+    return blockSize;
+  } ) );
+  for ( double blockSize : blockSizes )
+    mAverageTriangleSize += blockSize;
   mAverageTriangleSize /= mTriangularMesh.faceCount();
 }
 
@@ -36,6 +36,8 @@
 #include <QBuffer>
 #include <QNetworkReply>
 #include <QRecursiveMutex>
+#include <QMutex>
+#include <QHash>
 #include <QThreadStorage>
 #include <QAuthenticator>
 #include <QStandardPaths>
@@ -43,6 +45,8 @@
 
 const QgsSettingsEntryInteger *QgsNetworkAccessManager::settingsNetworkTimeout = new QgsSettingsEntryInteger( QStringLiteral( "network-timeout" ), QgsSettings::sTreeNetwork, 60000, QObject::tr( "Network timeout" ) );
 
+const QgsSettingsEntryBool *QgsNetworkAccessManager::settingsNetworkHttp2Enabled = new QgsSettingsEntryBool( QStringLiteral( "http2-enabled" ), QgsSettings::sTreeNetwork, true, QObject::tr( "Whether HTTP/2 is allowed for HTTPS requests" ) );
+
 #ifndef QT_NO_SSL
 #include <QSslConfiguration>
 #endif
@@ -55,6 +59,16 @@ QgsNetworkAccessManager *QgsNetworkAccessManager::sMainNAM = nullptr;
 static std::vector< std::pair< QString, std::function< void( QNetworkRequest * ) > > > sCustomPreprocessors;
 static std::vector< std::pair< QString, std::function< void( const QNetworkRequest &, QNetworkReply * ) > > > sCustomReplyPreprocessors;
 
+#ifndef QT_NO_SSL
+/// @cond PRIVATE
+
+//! TLS session tickets by host and port, shared by the managers of all threads so that they can resume sessions
+static QMutex sSslSessionTicketsMutex;
+static QHash< QString, QByteArray > sSslSessionTickets;
+
+/// @endcond
+#endif
+
 /// @cond PRIVATE
 class QgsNetworkProxyFactory : public QNetworkProxyFactory
 {
@@ -304,6 +318,26 @@ QNetworkReply *QgsNetworkAccessManager::createRequest( QNetworkAccessManager::Op
 
 #ifndef QT_NO_SSL
   const bool ishttps = pReq->url().scheme().compare( QLatin1String( "https" ), Qt::CaseInsensitive ) == 0;
+  const QString hostport( ishttps ? QStringLiteral( "%1:%2" )
+                          .arg( pReq->url().host().trimmed() )
+                          .arg( pReq->url().port() != -1 ? pReq->url().port() : 443 ) : QString() );
+  // sessions are not resumed for requests using client certificates, as they may differ between requests
+  const bool resumeSslSession = ishttps && pReq->sslConfiguration().localCertificate().isNull();
+  if ( ishttps && !pReq->attribute( QNetworkRequest::Http2AllowedAttribute ).isValid() )
+    pReq->setAttribute( QNetworkRequest::Http2AllowedAttribute, settingsNetworkHttp2Enabled->value() );
+  if ( resumeSslSession )
+  {
+    // each thread has its own manager, so without a shared ticket every thread does a full handshake with the same hosts
+    QSslConfiguration sslconfig( pReq->sslConfiguration() );
+    sslconfig.setSslOption( QSsl::SslOptionDisableSessionPersistence, false );
+    {
+      const QMutexLocker locker( &sSslSessionTicketsMutex );
+      const auto ticketIt = sSslSessionTickets.constFind( hostport );
+      if ( ticketIt != sSslSessionTickets.constEnd() )
+        sslconfig.setSessionTicket( ticketIt.value() );
+    }
+    pReq->setSslConfiguration( sslconfig );
+  }
   if ( ishttps && !QgsApplication::authManager()->isDisabled() )
   {
     QgsDebugMsgLevel( QStringLiteral( "Adding trusted CA certs to request" ), 3 );
@@ -311,9 +345,6 @@ QNetworkReply *QgsNetworkAccessManager::createRequest( QNetworkAccessManager::Op
     // Merge trusted CAs with any additional CAs added by the authentication methods
     sslconfig.setCaCertificates( QgsAuthCertUtils::casMerge( QgsApplication::authManager()->trustedCaCertsCache(), sslconfig.caCertificates( ) ) );
     // check for SSL cert custom config
-    const QString hostport( QStringLiteral( "%1:%2" )
-                            .arg( pReq->url().host().trimmed() )
-                            .arg( pReq->url().port() != -1 ? pReq->url().port() : 443 ) );
     const QgsAuthConfigSslServer servconfig = QgsApplication::authManager()->sslCertCustomConfigByHost( hostport.trimmed() );
     if ( !servconfig.isNull() )
     {
@@ -361,6 +392,22 @@ QNetworkReply *QgsNetworkAccessManager::createRequest( QNetworkAccessManager::Op
   connect( reply, &QNetworkReply::downloadProgress, this, &QgsNetworkAccessManager::onReplyDownloadProgress );
 #ifndef QT_NO_SSL
   connect( reply, &QNetworkReply::sslErrors, this, &QgsNetworkAccessManager::onReplySslErrors );
+
+  if ( resumeSslSession )
+  {
+    connect( reply, &QNetworkReply::finished, reply, [reply, hostport]
+    {
+      if ( reply->error() != QNetworkReply::NoError )
+        return;
+
+      const QByteArray ticket = reply->sslConfiguration().sessionTicket();
+      if ( ticket.isEmpty() )
+        return;
+
+      const QMutexLocker locker( &sSslSessionTicketsMutex );
+      sSslSessionTickets.insert( hostport, ticket );
+    } );
+  }
 #endif
 
   for ( const auto &replyPreprocessor :  sCustomReplyPreprocessors )
@@ -665,6 +665,13 @@ class CORE_EXPORT QgsNetworkAccessManager : public QNetworkAccessManager
 #ifndef SIP_RUN
     //! Settings entry network timeout
     static const QgsSettingsEntryInteger *settingsNetworkTimeout;
+
+    /**
+     * Settings entry whether HTTP/2 is allowed for HTTPS requests which do not set the
+     * QNetworkRequest::Http2AllowedAttribute attribute themselves.
+     * \since QGIS 3.30
+     */
+    static const QgsSettingsEntryBool *settingsNetworkHttp2Enabled;
 #endif
 
     /**
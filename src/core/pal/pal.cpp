@@ -44,7 +44,10 @@
 #include "qgssettings.h"
 #include "qgslabelingengine.h"
 #include "qgsrendercontext.h"
+#include <QThreadPool>
+#include <QtConcurrentMap>
 #include <cfloat>
+#include <limits>
 #include <list>
 
 using namespace pal;
@@ -120,7 +123,6 @@ std::unique_ptr<Problem> Pal::extractProblem( const QgsRectangle &extent, const
 
   // prepare map boundary
   geos::unique_ptr mapBoundaryGeos( QgsGeos::asGeos( mapBoundary ) );
-  geos::prepared_unique_ptr mapBoundaryPrepared( GEOSPrepare_r( QgsGeos::getGEOSHandler(), mapBoundaryGeos.get() ) );
 
   int obstacleCount = 0;
 
@@ -169,13 +171,18 @@ std::unique_ptr<Problem> Pal::extractProblem( const QgsRectangle &extent, const
 
     QMutexLocker locker( &layer->mMutex );
 
+    std::vector< PartCandidates > partCandidates = createPartCandidates( layer, mapBoundaryGeos.get() );
+    if ( isCanceled() )
+      return nullptr;
+
     const double featureStep = !layer->mFeatureParts.empty() ? step / layer->mFeatureParts.size() : 1;
     std::size_t featureIndex = 0;
-    // generate candidates for all features
+    // collect the candidates of all features, in the order of the features
     for ( const std::unique_ptr< FeaturePart > &featurePart : std::as_const( layer->mFeatureParts ) )
     {
       if ( feedback )
         feedback->setProgress( index * step + featureIndex * featureStep );
+      PartCandidates &created = partCandidates[ featureIndex ];
       featureIndex++;
 
       if ( isCanceled() )
@@ -194,23 +201,7 @@ std::unique_ptr<Problem> Pal::extractProblem( const QgsRectangle &extent, const
         }
       }
 
-      // generate candidates for the feature part
-      std::vector< std::unique_ptr< LabelPosition > > candidates = featurePart->createCandidates( this );
-
-      if ( isCanceled() )
-        break;
-
-      // purge candidates that are outside the bbox
-      candidates.erase( std::remove_if( candidates.begin(), candidates.end(), [&mapBoundaryPrepared, this]( std::unique_ptr< LabelPosition > &candidate )
-      {
-        if ( showPartialLabels() )
-          return !candidate->intersects( mapBoundaryPrepared.get() );
-        else
-          return !candidate->within( mapBoundaryPrepared.get() );
-      } ), candidates.end() );
-
-      if ( isCanceled() )
-        break;
+      std::vector< std::unique_ptr< LabelPosition > > candidates = std::move( created.candidates );
 
       if ( !candidates.empty() )
       {
@@ -232,8 +223,8 @@ std::unique_ptr<Problem> Pal::extractProblem( const QgsRectangle &extent, const
       }
       else
       {
-        // no candidates, so generate a default "point on surface" one
-        std::unique_ptr< LabelPosition > unplacedPosition = featurePart->createCandidatePointOnSurface( featurePart.get() );
+        // no candidates, so use the default "point on surface" one
+        std::unique_ptr< LabelPosition > unplacedPosition = std::move( created.unplacedPosition );
         if ( !unplacedPosition )
           continue;
 
@@ -453,6 +444,10 @@ std::unique_ptr<Problem> Pal::extractProblem( const QgsRectangle &extent, const
       // sort candidates list, best label to worst
       std::sort( feat->candidates.begin(), feat->candidates.end(), CostCalculator::candidateSortGrow );
 
+      // keep the label where it was previously placed, if that position is still a candidate
+      if ( !mPreviousPositions.isEmpty() )
+        preferPreviousPosition( feat.get() );
+
       // but if we ARE showing all labels (including conflicts), let's go ahead and prune them now.
       // Since we've calculated all their costs and sorted them, if we've hit the situation that ALL
       // candidates have conflicts, then at least when we pick the first candidate to display it will be
@@ -558,6 +553,121 @@ std::unique_ptr<Problem> Pal::extractProblem( const QgsRectangle &extent, const
   return prob;
 }
 
+std::vector< Pal::PartCandidates > Pal::createPartCandidates( Layer *layer, const GEOSGeometry *mapBoundary )
+{
+  std::vector< PartCandidates > partCandidates( layer->mFeatureParts.size() );
+
+  // the parts of a label feature share its geometries, which are not thread safe, so they
+  // are processed by the same thread
+  std::vector< std::vector< std::size_t > > featureParts;
+  QHash< const QgsLabelFeature *, std::size_t > featureIndexes;
+  for ( std::size_t i = 0; i < layer->mFeatureParts.size(); ++i )
+  {
+    const QgsLabelFeature *labelFeature = layer->mFeatureParts[i]->feature();
+    auto it = featureIndexes.constFind( labelFeature );
+    if ( it == featureIndexes.constEnd() )
+    {
+      it = featureIndexes.insert( labelFeature, featureParts.size() );
+      featureParts.emplace_back();
+    }
+    featureParts[ *it ].emplace_back( i );
+  }
+
+  // split the features into batches, each one using its own prepared map boundary
+  const std::size_t batchCount = std::min( featureParts.size(), static_cast< std::size_t >( 4 * std::max( 1, QThreadPool::globalInstance()->maxThreadCount() ) ) );
+  std::vector< std::pair< std::size_t, std::size_t > > batches;
+  for ( std::size_t batch = 0; batch < batchCount; ++batch )
+  {
+    batches.emplace_back( featureParts.size() * batch / batchCount, featureParts.size() * ( batch + 1 ) / batchCount );
+  }
+
+  auto createBatchCandidates = [this, layer, mapBoundary, &featureParts, &partCandidates]( const std::pair< std::size_t, std::size_t > &batch )
+  {
+    GEOSContextHandle_t geosctxt = QgsGeos::getGEOSHandler();
+    const geos::prepared_unique_ptr mapBoundaryPrepared( GEOSPrepare_r( geosctxt, mapBoundary ) );
+
+    for ( std::size_t feature = batch.first; feature < batch.second; ++feature )
+    {
+      for ( const std::size_t partIndex : featureParts[ feature ] )
+      {
+        if ( isCanceled() )
+          return;
+
+        FeaturePart *featurePart = layer->mFeatureParts[ partIndex ].get();
+        PartCandidates &created = partCandidates[ partIndex ];
+
+        // generate candidates for the feature part
+        created.candidates = featurePart->createCandidates( this );
+
+        if ( isCanceled() )
+          return;
+
+        // purge candidates that are outside the bbox
+        created.candidates.erase( std::remove_if( created.candidates.begin(), created.candidates.end(), [&mapBoundaryPrepared, this]( std::unique_ptr< LabelPosition > &candidate )
+        {
+          if ( showPartialLabels() )
+            return !candidate->intersects( mapBoundaryPrepared.get() );
+          else
+            return !candidate->within( mapBoundaryPrepared.get() );
+        } ), created.candidates.end() );
+
+        if ( created.candidates.empty() )
+        {
+          // no candidates, so generate a default "point on surface" one
+          created.unplacedPosition = featurePart->createCandidatePointOnSurface( featurePart );
+        }
+      }
+    }
+  };
+
+  QtConcurrent::blockingMap( batches, createBatchCandidates );
+
+  return partCandidates;
+}
+
+void Pal::preferPreviousPosition( Feats *feature ) const
+{
+  const auto providerIt = mPreviousPositions.constFind( feature->feature->feature()->provider() );
+  if ( providerIt == mPreviousPositions.constEnd() )
+    return;
+
+  const auto featureIt = providerIt->constFind( feature->feature->featureId() );
+  if ( featureIt == providerIt->constEnd() )
+    return;
+
+  // a candidate matches a previous position if it has the same size and angle, and is close to it
+  auto closestCandidate = feature->candidates.end();
+  double closestDistance = std::numeric_limits< double >::max();
+  for ( const PreviousPosition &previous : *featureIt )
+  {
+    const double tolerance = 0.5 * previous.height;
+    for ( auto it = feature->candidates.begin(); it != feature->candidates.end(); ++it )
+    {
+      const LabelPosition *candidate = it->get();
+      if ( candidate->nextPart() || candidate->hasHardObstacleConflict() )
+        continue;
+
+      if ( std::fabs( candidate->getWidth() - previous.width ) > 0.01 * previous.width
+           || std::fabs( candidate->getHeight() - previous.height ) > 0.01 * previous.height
+           || std::fabs( std::remainder( candidate->getAlpha() - previous.alpha, 2 * M_PI ) ) > 0.01 )
+        continue;
+
+      const double distance = std::sqrt( std::pow( candidate->getX() - previous.x, 2 ) + std::pow( candidate->getY() - previous.y, 2 ) );
+      if ( distance <= tolerance && distance < closestDistance )
+      {
+        closestDistance = distance;
+        closestCandidate = it;
+      }
+    }
+  }
+
+  if ( closestCandidate == feature->candidates.end() || closestCandidate == feature->candidates.begin() )
+    return;
+
+  ( *closestCandidate )->setCost( feature->candidates.front()->cost() );
+  std::rotate( feature->candidates.begin(), closestCandidate, closestCandidate + 1 );
+}
+
 void Pal::registerCancellationCallback( Pal::FnIsCanceled fnCanceled, void *context )
 {
   fnIsCanceled = fnCanceled;
@@ -36,12 +36,16 @@
 #include "qgis_core.h"
 #include "qgsgeometry.h"
 #include "qgsgeos.h"
+#include "qgsfeatureid.h"
 #include <QList>
+#include <QHash>
+#include <QVector>
 #include <iostream>
 #include <ctime>
 #include <QMutex>
 #include <QStringList>
 #include <unordered_map>
+#include <vector>
 
 // TODO ${MAJOR} ${MINOR} etc instead of 0.2
 
@@ -55,6 +59,7 @@ namespace pal
   class PalStat;
   class Problem;
   class PointSet;
+  class Feats;
 
   //! Search method to use
   enum SearchMethod
@@ -244,8 +249,58 @@ namespace pal
        */
       bool candidatesAreConflicting( const LabelPosition *lp1, const LabelPosition *lp2 ) const;
 
+      /**
+       * \brief Placement of a label by a previous labeling of the map.
+       * \since QGIS 3.30
+       */
+      struct PreviousPosition
+      {
+        //! X coordinate of the bottom left corner of the label, in the pre-rotated coordinates of the candidates
+        double x = 0;
+        //! Y coordinate of the bottom left corner of the label, in the pre-rotated coordinates of the candidates
+        double y = 0;
+        //! Angle of the label, in radians
+        double alpha = 0;
+        //! Width of the label, in map units
+        double width = 0;
+        //! Height of the label, in map units
+        double height = 0;
+      };
+
+      /**
+       * Sets the label \a positions placed by a previous labeling of the map (e.g. before the map was panned),
+       * by label provider and feature ID.
+       *
+       * When a feature has a candidate matching its previous position, this candidate is preferred over the
+       * other candidates of the same cost or higher, so that labels stay in place between renders.
+       *
+       * \since QGIS 3.30
+       */
+      void setPreviousPositions( const QHash< const QgsAbstractLabelProvider *, QHash< QgsFeatureId, QVector< PreviousPosition > > > &positions ) { mPreviousPositions = positions; }
+
     private:
 
+      /**
+       * Moves the candidate of a \a feature matching its previous position first, giving it the cost of the
+       * best candidate.
+       */
+      void preferPreviousPosition( Feats *feature ) const;
+
+      //! Candidates created for a feature part
+      struct PartCandidates
+      {
+        std::vector< std::unique_ptr< LabelPosition > > candidates;
+        //! Default "point on surface" candidate, only created if the part has no candidate within the map boundary
+        std::unique_ptr< LabelPosition > unplacedPosition;
+      };
+
+      /**
+       * Creates the candidates of all the feature parts of a \a layer, keeping only the candidates within
+       * the \a mapBoundary. The parts are processed in parallel, and their candidates are returned in the
+       * order of the parts.
+       */
+      std::vector< PartCandidates > createPartCandidates( Layer *layer, const GEOSGeometry *mapBoundary );
+
       std::unordered_map< QgsAbstractLabelProvider *, std::unique_ptr< Layer > > mLayers;
 
       QMutex mMutex;
@@ -279,6 +334,8 @@ namespace pal
 
       Qgis::LabelPlacementEngineVersion mPlacementVersion = Qgis::LabelPlacementEngineVersion::Version2;
 
+      QHash< const QgsAbstractLabelProvider *, QHash< QgsFeatureId, QVector< PreviousPosition > > > mPreviousPositions;
+
       //! Callback that may be called from PAL to check whether the job has not been canceled in meanwhile
       FnIsCanceled fnIsCanceled = nullptr;
       //! Application-specific context for the cancellation check function
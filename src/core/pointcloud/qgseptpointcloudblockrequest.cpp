@@ -38,6 +38,8 @@ QgsEptPointCloudBlockRequest::QgsEptPointCloudBlockRequest( const IndexedPointCl
   QNetworkRequest nr( mUri );
   nr.setAttribute( QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache );
   nr.setAttribute( QNetworkRequest::CacheSaveControlAttribute, true );
+  // node requests are many and small, multiplex them over a single connection when the server supports it
+  nr.setAttribute( QNetworkRequest::Http2AllowedAttribute, true );
   mTileDownloadManagerReply.reset( QgsApplication::tileDownloadManager()->get( nr ) );
   connect( mTileDownloadManagerReply.get(), &QgsTileDownloadManagerReply::finished, this, &QgsEptPointCloudBlockRequest::blockFinishedLoading );
 }
@@ -65,6 +65,7 @@ void QgsEptPointCloudIndex::load( const QString &fileName )
 
   const QDir directory = QFileInfo( fileName ).absoluteDir();
   mDirectory = directory.absolutePath();
+  mUri = fileName;
 
   const QByteArray dataJson = f.readAll();
   bool success = loadSchema( dataJson );
@@ -303,6 +304,9 @@ bool QgsEptPointCloudIndex::loadSchema( const QByteArray &dataJson )
 
 QgsPointCloudBlock *QgsEptPointCloudIndex::nodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request )
 {
+  if ( QgsPointCloudBlock *cached = cachedNodeData( n, request ) )
+    return cached;
+
   mHierarchyMutex.lock();
   const bool found = mHierarchy.contains( n );
   mHierarchyMutex.unlock();
@@ -317,25 +321,29 @@ QgsPointCloudBlock *QgsEptPointCloudIndex::nodeData( const IndexedPointCloudNode
   requestAttributes.extend( attributes(), filterExpression.referencedAttributes() );
   QgsRectangle filterRect = request.filterRect();
 
+  QgsPointCloudBlock *block = nullptr;
   if ( mDataType == QLatin1String( "binary" ) )
   {
     const QString filename = QStringLiteral( "%1/ept-data/%2.bin" ).arg( mDirectory, n.toString() );
-    return QgsEptDecoder::decompressBinary( filename, attributes(), requestAttributes, scale(), offset(), filterExpression, filterRect );
+    block = QgsEptDecoder::decompressBinary( filename, attributes(), requestAttributes, scale(), offset(), filterExpression, filterRect );
   }
   else if ( mDataType == QLatin1String( "zstandard" ) )
   {
     const QString filename = QStringLiteral( "%1/ept-data/%2.zst" ).arg( mDirectory, n.toString() );
-    return QgsEptDecoder::decompressZStandard( filename, attributes(), request.attributes(), scale(), offset(), filterExpression, filterRect );
+    block = QgsEptDecoder::decompressZStandard( filename, attributes(), request.attributes(), scale(), offset(), filterExpression, filterRect );
   }
   else if ( mDataType == QLatin1String( "laszip" ) )
   {
     const QString filename = QStringLiteral( "%1/ept-data/%2.laz" ).arg( mDirectory, n.toString() );
-    return QgsLazDecoder::decompressLaz( filename, requestAttributes, filterExpression, filterRect );
+    block = QgsLazDecoder::decompressLaz( filename, requestAttributes, filterExpression, filterRect );
   }
   else
   {
     return nullptr;  // unsupported
   }
+
+  storeNodeDataToCache( block, n, request );
+  return block;
 }
 
 QgsPointCloudBlockRequest *QgsEptPointCloudIndex::asyncNodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request )
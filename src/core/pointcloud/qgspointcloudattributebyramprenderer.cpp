@@ -51,11 +51,9 @@ void QgsPointCloudAttributeByRampRenderer::renderBlock( const QgsPointCloudBlock
 {
   const QgsRectangle visibleExtent = context.renderContext().extent();
 
-  const char *ptr = block->data();
   int count = block->pointCount();
   const QgsPointCloudAttributeCollection request = block->attributes();
 
-  const std::size_t recordSize = request.pointRecordSize();
   int attributeOffset = 0;
   const QgsPointCloudAttribute *attribute = request.find( mAttribute, attributeOffset );
   if ( !attribute )
@@ -77,6 +75,37 @@ void QgsPointCloudAttributeByRampRenderer::renderBlock( const QgsPointCloudBlock
   const QgsCoordinateTransform ct = context.renderContext().coordinateTransform();
   const bool reproject = ct.isValid();
 
+  // coordinates and attribute values are read for the whole block at once, one array at a time
+  std::vector< double > xValues;
+  std::vector< double > yValues;
+  std::vector< double > zValues;
+  blockPointsXYZ( context, block, xValues, yValues, considerZ ? &zValues : nullptr );
+
+  std::vector< double > attributeValues;
+  blockAttributeValues( block, attributeOffset, attributeType, attributeValues );
+  if ( applyXOffset || applyYOffset || applyZOffset )
+  {
+    double attributeScale = 1;
+    double attributeShift = 0;
+    if ( applyXOffset )
+    {
+      attributeScale = context.scale().x();
+      attributeShift = context.offset().x();
+    }
+    else if ( applyYOffset )
+    {
+      attributeScale = context.scale().y();
+      attributeShift = context.offset().y();
+    }
+    else
+    {
+      attributeScale = context.scale().z() * context.zValueScale();
+      attributeShift = context.offset().z() * context.zValueScale() + context.zValueFixedOffset();
+    }
+    for ( double &attributeValue : attributeValues )
+      attributeValue = attributeShift + attributeScale * attributeValue;
+  }
+
   int red = 0;
   int green = 0;
   int blue = 0;
@@ -91,12 +120,13 @@ void QgsPointCloudAttributeByRampRenderer::renderBlock( const QgsPointCloudBlock
     if ( considerZ )
     {
       // z value filtering is cheapest, if we're doing it...
-      z = pointZ( context, ptr, i );
+      z = zValues[i];
       if ( !zRange.contains( z ) )
         continue;
     }
 
-    pointXY( context, ptr, i, x, y );
+    x = xValues[i];
+    y = yValues[i];
     if ( visibleExtent.contains( x, y ) )
     {
       if ( reproject )
@@ -111,17 +141,7 @@ void QgsPointCloudAttributeByRampRenderer::renderBlock( const QgsPointCloudBlock
         }
       }
 
-      double attributeValue = 0;
-      context.getAttribute( ptr, i * recordSize + attributeOffset, attributeType, attributeValue );
-
-      if ( applyXOffset )
-        attributeValue = context.offset().x() + context.scale().x() * attributeValue;
-      if ( applyYOffset )
-        attributeValue = context.offset().y() + context.scale().y() * attributeValue;
-      if ( applyZOffset )
-        attributeValue = ( context.offset().z() + context.scale().z() * attributeValue ) * context.zValueScale() + context.zValueFixedOffset();
-
-      mColorRampShader.shade( attributeValue, &red, &green, &blue, &alpha );
+      mColorRampShader.shade( attributeValues[i], &red, &green, &blue, &alpha );
       drawPoint( x, y, QColor( red, green, blue, alpha ), context );
       if ( renderElevation )
         drawPointToElevationMap( x, y, z, context );
@@ -69,11 +69,9 @@ void QgsPointCloudClassifiedRenderer::renderBlock( const QgsPointCloudBlock *blo
 {
   const QgsRectangle visibleExtent = context.renderContext().extent();
 
-  const char *ptr = block->data();
   int count = block->pointCount();
   const QgsPointCloudAttributeCollection request = block->attributes();
 
-  const std::size_t recordSize = request.pointRecordSize();
   int attributeOffset = 0;
   const QgsPointCloudAttribute *attribute = request.find( mAttribute, attributeOffset );
   if ( !attribute )
@@ -100,6 +98,15 @@ void QgsPointCloudClassifiedRenderer::renderBlock( const QgsPointCloudBlock *blo
     colors.insert( category.value(), category.color() );
   }
 
+  // coordinates and attribute values are read for the whole block at once, one array at a time
+  std::vector< double > xValues;
+  std::vector< double > yValues;
+  std::vector< double > zValues;
+  blockPointsXYZ( context, block, xValues, yValues, considerZ ? &zValues : nullptr );
+
+  std::vector< int > attributeValues;
+  blockAttributeValues( block, attributeOffset, attributeType, attributeValues );
+
   for ( int i = 0; i < count; ++i )
   {
     if ( context.renderContext().renderingStopped() )
@@ -110,18 +117,17 @@ void QgsPointCloudClassifiedRenderer::renderBlock( const QgsPointCloudBlock *blo
     // z value filtering is cheapest, if we're doing it...
     if ( considerZ )
     {
-      z = pointZ( context, ptr, i );
+      z = zValues[i];
       if ( !zRange.contains( z ) )
         continue;
     }
 
-    int attributeValue = 0;
-    context.getAttribute( ptr, i * recordSize + attributeOffset, attributeType, attributeValue );
-    const QColor color = colors.value( attributeValue );
+    const QColor color = colors.value( attributeValues[i] );
     if ( !color.isValid() )
       continue;
 
-    pointXY( context, ptr, i, x, y );
+    x = xValues[i];
+    y = yValues[i];
     if ( visibleExtent.contains( x, y ) )
     {
       if ( reproject )
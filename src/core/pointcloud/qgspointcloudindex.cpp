@@ -22,11 +22,18 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QSaveFile>
 #include <QTime>
 #include <QtDebug>
 
 #include "qgstiledownloadmanager.h"
 #include "qgspointcloudstatistics.h"
+#include "qgspointcloudrequest.h"
+#include "qgsapplication.h"
+#include "qgslogger.h"
 
 IndexedPointCloudNode::IndexedPointCloudNode():
   mD( -1 ),
@@ -362,4 +369,95 @@ void QgsPointCloudIndex::copyCommonProperties( QgsPointCloudIndex *destination )
   destination->mAttributes = mAttributes;
   destination->mSpan = mSpan;
   destination->mFilterExpression = mFilterExpression;
+  destination->mUri = mUri;
+}
+
+///@cond PRIVATE
+
+//! Decoded blocks of point cloud nodes, shared by all the indexes
+static QCache< QString, QgsPointCloudBlock > sBlockCache( 256 * 1024 * 1024 ); // cost in bytes of the block data
+//! Mutex to protect the decoded blocks cache
+static QMutex sBlockCacheMutex;
+
+///@endcond
+
+// Returns the key of a block in the decoded blocks cache
+static QString _blockCacheKey( const QString &uri, const IndexedPointCloudNode &n, const QgsPointCloudRequest &request, const QgsPointCloudExpression &filterExpression )
+{
+  QStringList attributes;
+  const QVector<QgsPointCloudAttribute> requestAttributes = request.attributes().attributes();
+  for ( const QgsPointCloudAttribute &attribute : requestAttributes )
+    attributes << QStringLiteral( "%1:%2" ).arg( attribute.name() ).arg( static_cast< int >( attribute.type() ) );
+
+  return QStringLiteral( "%1|%2|%3|%4|%5" ).arg( uri, n.toString(), attributes.join( ',' ),
+         request.filterRect().isNull() ? QString() : request.filterRect().toString( 17 ),
+         filterExpression.isValid() ? filterExpression.dump() : QString() );
+}
+
+QgsPointCloudBlock *QgsPointCloudIndex::cachedNodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request ) const
+{
+  if ( mUri.isEmpty() )
+    return nullptr;
+
+  const QString key = _blockCacheKey( mUri, n, request, mFilterExpression );
+  const QMutexLocker locker( &sBlockCacheMutex );
+  if ( const QgsPointCloudBlock *cached = sBlockCache.object( key ) )
+    return new QgsPointCloudBlock( *cached );
+  return nullptr;
+}
+
+void QgsPointCloudIndex::storeNodeDataToCache( const QgsPointCloudBlock *data, const IndexedPointCloudNode &n, const QgsPointCloudRequest &request ) const
+{
+  if ( !data || mUri.isEmpty() )
+    return;
+
+  const int cost = std::max( 1, data->pointCount() * data->pointRecordSize() );
+  const QString key = _blockCacheKey( mUri, n, request, mFilterExpression );
+  const QMutexLocker locker( &sBlockCacheMutex );
+  sBlockCache.insert( key, new QgsPointCloudBlock( *data ), cost );
+}
+
+// Returns the path of the file storing the statistics of a dataset in the statistics cache
+static QString _statisticsCacheFilePath( const QString &uri, qint64 pointCount, const QgsRectangle &extent, double zMin, double zMax, const QgsPointCloudExpression &filterExpression )
+{
+  QString key = QStringLiteral( "%1|%2|%3|%4|%5|%6" ).arg( uri ).arg( pointCount ).arg( extent.toString( 17 ) ).arg( qgsDoubleToString( zMin ), qgsDoubleToString( zMax ),
+                filterExpression.isValid() ? filterExpression.dump() : QString() );
+  const QFileInfo fileInfo( uri );
+  if ( fileInfo.exists() )
+    key += QStringLiteral( "|%1|%2" ).arg( fileInfo.size() ).arg( fileInfo.lastModified().toMSecsSinceEpoch() );
+
+  const QString hash = QString::fromLatin1( QCryptographicHash::hash( key.toUtf8(), QCryptographicHash::Sha1 ).toHex() );
+  return QgsApplication::qgisSettingsDirPath() + QStringLiteral( "cache/pointcloud_statistics/%1.json" ).arg( hash );
+}
+
+QgsPointCloudStatistics QgsPointCloudIndex::cachedStatistics() const
+{
+  if ( mUri.isEmpty() )
+    return QgsPointCloudStatistics();
+
+  QFile file( _statisticsCacheFilePath( mUri, pointCount(), mExtent, mZMin, mZMax, mFilterExpression ) );
+  if ( !file.open( QIODevice::ReadOnly ) )
+    return QgsPointCloudStatistics();
+
+  return QgsPointCloudStatistics::fromStatisticsJson( file.readAll() );
+}
+
+bool QgsPointCloudIndex::storeStatisticsToCache( const QgsPointCloudStatistics &stats ) const
+{
+  if ( mUri.isEmpty() || stats.sampledPointsCount() == 0 )
+    return false;
+
+  const QString path = _statisticsCacheFilePath( mUri, pointCount(), mExtent, mZMin, mZMax, mFilterExpression );
+  if ( !QDir().mkpath( QFileInfo( path ).absolutePath() ) )
+    return false;
+
+  // the statistics are written to a temporary file first, so that concurrent readers never see partial statistics
+  QSaveFile file( path );
+  if ( !file.open( QIODevice::WriteOnly ) )
+  {
+    QgsDebugMsg( QStringLiteral( "Could not write point cloud statistics to %1" ).arg( path ) );
+    return false;
+  }
+  file.write( stats.toStatisticsJson() );
+  return file.commit();
 }
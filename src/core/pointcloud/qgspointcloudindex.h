@@ -223,6 +223,29 @@ class CORE_EXPORT QgsPointCloudIndex: public QObject
      */
     virtual QgsPointCloudStatistics metadataStatistics() const;
 
+    /**
+     * Returns the statistics of the dataset stored in the local statistics cache by storeStatisticsToCache(),
+     * or empty statistics if the cache has none for the dataset.
+     *
+     * Cached statistics are identified by the file name or URL of the dataset, its point count and extent,
+     * the filter expression of the index and, for local files, the size and modification time of the file,
+     * so that they are no longer used once the dataset is changed.
+     *
+     * \see storeStatisticsToCache()
+     * \since QGIS 3.30
+     */
+    QgsPointCloudStatistics cachedStatistics() const;
+
+    /**
+     * Stores the statistics \a stats of the dataset in the local statistics cache of the user profile, so that they
+     * are not calculated again when the dataset is opened again, e.g. for remote datasets which cannot store them.
+     *
+     * \returns TRUE if the statistics were stored
+     * \see cachedStatistics()
+     * \since QGIS 3.30
+     */
+    bool storeStatisticsToCache( const QgsPointCloudStatistics &stats ) const;
+
     //! Returns root node of the index
     IndexedPointCloudNode root() { return IndexedPointCloudNode( 0, 0, 0, 0 ); }
 
@@ -332,6 +355,31 @@ class CORE_EXPORT QgsPointCloudIndex: public QObject
     //! Sets native attributes of the data
     void setAttributes( const QgsPointCloudAttributeCollection &attributes );
 
+    /**
+     * Returns a copy of the block of node \a n decoded for the \a request, read from the cache of decoded
+     * blocks shared by all point cloud indexes, or NULLPTR if the block is not in the cache.
+     *
+     * It is caller responsibility to free the block.
+     *
+     * \see storeNodeDataToCache()
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    QgsPointCloudBlock *cachedNodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request ) const SIP_SKIP;
+
+    /**
+     * Stores a copy of the block \a data of node \a n decoded for the \a request in the cache of decoded
+     * blocks shared by all point cloud indexes, so that the 2D, 3D and profile views do not decode it again.
+     * The least recently used blocks are removed from the cache when it exceeds its memory budget.
+     *
+     * \see cachedNodeData()
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    void storeNodeDataToCache( const QgsPointCloudBlock *data, const IndexedPointCloudNode &n, const QgsPointCloudRequest &request ) const SIP_SKIP;
+
+    QString mUri; //!< File name or URL of the data, identifying the blocks of the index in the cache
+
     QgsRectangle mExtent;  //!< 2D extent of data
     double mZMin = 0, mZMax = 0;   //!< Vertical extent of data
 
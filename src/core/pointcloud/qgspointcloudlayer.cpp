@@ -870,6 +870,9 @@ void QgsPointCloudLayer::calculateStatistics()
     }
   }
 #endif
+  // statistics calculated earlier for a dataset which cannot store them, e.g. a remote dataset
+  if ( mStatistics.sampledPointsCount() == 0 )
+    mStatistics = mDataProvider->index()->cachedStatistics();
   if ( mStatistics.sampledPointsCount() != 0 )
   {
     mStatisticsCalculationState = QgsPointCloudLayer::PointCloudStatisticsCalculationState::Calculated;
@@ -928,15 +931,18 @@ void QgsPointCloudLayer::calculateStatistics()
     emit statisticsCalculationStateChanged( mStatisticsCalculationState );
     resetRenderer();
     mStatsCalculationTask = 0;
+    bool statisticsWritten = false;
 #ifdef HAVE_COPC
     if ( mDataProvider && mDataProvider->index() && mDataProvider->index()->isValid() && mDataProvider->name() == QLatin1String( "pdal" ) && mStatistics.sampledPointsCount() != 0 )
     {
       if ( QgsCopcPointCloudIndex *index = qobject_cast<QgsCopcPointCloudIndex *>( mDataProvider->index() ) )
       {
-        index->writeStatistics( mStatistics );
+        statisticsWritten = index->writeStatistics( mStatistics );
       }
     }
 #endif
+    if ( !statisticsWritten && mDataProvider && mDataProvider->index() && mDataProvider->index()->isValid() )
+      mDataProvider->index()->storeStatisticsToCache( mStatistics );
   } );
 
   // In case the statistics calculation fails, QgsTask::taskTerminated will be called
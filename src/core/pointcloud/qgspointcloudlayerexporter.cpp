@@ -19,6 +19,7 @@
 #include <QFileInfo>
 #include <QApplication>
 #include <QThread>
+#include <QtConcurrent>
 
 #include "qgspointcloudlayerexporter.h"
 #include "qgsmemoryproviderutils.h"
@@ -358,9 +359,26 @@ void QgsPointCloudLayerExporter::ExporterBase::run()
   request.setAttributes( mParent->requestedAttributeCollection() );
   std::unique_ptr<QgsPointCloudBlock> block = nullptr;
   qint64 pointsExported = 0;
-  for ( const IndexedPointCloudNode &node : nodes )
+
+  // the data of the next node is decoded in the background while the points of the current node are exported
+  QgsPointCloudIndex *index = mParent->mIndex;
+  auto decodeNode = [index, request]( const IndexedPointCloudNode & node )
+  {
+    return QtConcurrent::run( [index, request, node]
+    {
+      return index->nodeData( node, request );
+    } );
+  };
+  QFuture< QgsPointCloudBlock * > nextBlock;
+  if ( !nodes.isEmpty() )
+    nextBlock = decodeNode( nodes.at( 0 ) );
+
+  for ( int nodeIndex = 0; nodeIndex < nodes.size(); ++nodeIndex )
   {
-    block.reset( mParent->mIndex->nodeData( node, request ) );
+    block.reset( nextBlock.result() );
+    if ( nodeIndex + 1 < nodes.size() )
+      nextBlock = decodeNode( nodes.at( nodeIndex + 1 ) );
+
     const QgsPointCloudAttributeCollection attributesCollection = block->attributes();
     const char *ptr = block->data();
     int count = block->pointCount();
@@ -371,6 +389,18 @@ void QgsPointCloudLayerExporter::ExporterBase::run()
     const QgsPointCloudAttribute::DataType xType = attributesCollection.find( QStringLiteral( "X" ), xOffset )->type();
     const QgsPointCloudAttribute::DataType yType = attributesCollection.find( QStringLiteral( "Y" ), yOffset )->type();
     const QgsPointCloudAttribute::DataType zType = attributesCollection.find( QStringLiteral( "Z" ), zOffset )->type();
+
+    // the filter geometry does not need to be tested for each point of nodes well inside it,
+    // the node extent is grown by the quantization of the coordinates to keep rounding errors inside
+    bool testFilterGeometry = static_cast< bool >( mParent->mFilterGeometryEngine );
+    if ( testFilterGeometry )
+    {
+      QgsRectangle nodeExtent = mParent->mIndex->nodeMapExtent( nodes.at( nodeIndex ) );
+      nodeExtent.grow( std::max( std::fabs( scale.x() ), std::fabs( scale.y() ) ) );
+      const QgsGeometry nodeGeometry = QgsGeometry::fromRect( nodeExtent );
+      testFilterGeometry = !mParent->mFilterGeometryEngine->relatePattern( nodeGeometry.constGet(), QStringLiteral( "T**FF*FF*" ) );
+    }
+
     for ( int i = 0; i < count; ++i )
     {
 
@@ -381,6 +411,8 @@ void QgsPointCloudLayerExporter::ExporterBase::run()
         if ( mParent->mFeedback->isCanceled() )
         {
           mParent->setLastError( QObject::tr( "Canceled by user" ) );
+          if ( nodeIndex + 1 < nodes.size() )
+            delete nextBlock.result();
           return;
         }
       }
@@ -397,7 +429,7 @@ void QgsPointCloudLayerExporter::ExporterBase::run()
                                            x, y, z );
       if ( ! mParent->mZRange.contains( z ) ||
            ! mParent->mExtent.contains( x, y ) ||
-           ( mParent->mFilterGeometryEngine && ! mParent->mFilterGeometryEngine->contains( x, y ) ) )
+           ( testFilterGeometry && ! mParent->mFilterGeometryEngine->contains( x, y ) ) )
       {
         ++pointsSkipped;
         continue;
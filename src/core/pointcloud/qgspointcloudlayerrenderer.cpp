@@ -15,8 +15,14 @@
  *                                                                         *
  ***************************************************************************/
 
+#include <functional>
+
 #include <QElapsedTimer>
+#include <QFuture>
 #include <QPointer>
+#include <QQueue>
+#include <QThread>
+#include <QtConcurrent>
 
 #include "qgspointcloudlayerrenderer.h"
 #include "qgspointcloudlayer.h"
@@ -36,6 +42,69 @@
 #include "qgsmapclippingutils.h"
 #include "qgspointcloudblockrequest.h"
 
+//! Maximum number of pending requests of remote nodes
+static constexpr int MAX_PENDING_NODE_REQUESTS = 32;
+
+///@cond PRIVATE
+
+/**
+ * Decodes the blocks of local point cloud nodes on worker threads, at most one node per core
+ * ahead of the block returned to the render thread, and returns them in the order of the nodes.
+ */
+class QgsPointCloudBlockPrefetcher
+{
+  public:
+    QgsPointCloudBlockPrefetcher( QgsPointCloudIndex *index, const QVector<IndexedPointCloudNode> &nodes, const QgsPointCloudRequest &request )
+      : mIndex( index )
+      , mNodes( nodes )
+      , mRequest( request )
+      , mMaxPendingBlocks( std::max( 1, QThread::idealThreadCount() ) )
+    {
+      fetchBlocks();
+    }
+
+    ~QgsPointCloudBlockPrefetcher()
+    {
+      // blocks still being decoded when rendering is canceled must be waited for, then discarded
+      for ( QFuture< QgsPointCloudBlock * > &pendingBlock : mPendingBlocks )
+        delete pendingBlock.result();
+    }
+
+    bool hasNext() const { return !mPendingBlocks.isEmpty(); }
+
+    //! Waits for the block of the next node, which may be NULLPTR if the node could not be read
+    std::unique_ptr< QgsPointCloudBlock > next()
+    {
+      std::unique_ptr< QgsPointCloudBlock > block( mPendingBlocks.takeFirst().result() );
+      fetchBlocks();
+      return block;
+    }
+
+  private:
+    void fetchBlocks()
+    {
+      while ( mNextNode < mNodes.size() && mPendingBlocks.size() < mMaxPendingBlocks )
+      {
+        const IndexedPointCloudNode n = mNodes.at( mNextNode++ );
+        QgsPointCloudIndex *index = mIndex;
+        const QgsPointCloudRequest request = mRequest;
+        mPendingBlocks << QtConcurrent::run( [index, n, request]
+        {
+          return index->nodeData( n, request );
+        } );
+      }
+    }
+
+    QgsPointCloudIndex *mIndex = nullptr;
+    const QVector<IndexedPointCloudNode> mNodes;
+    const QgsPointCloudRequest mRequest;
+    const int mMaxPendingBlocks;
+    int mNextNode = 0;
+    QList< QFuture< QgsPointCloudBlock * > > mPendingBlocks;
+};
+
+///@endcond
+
 QgsPointCloudLayerRenderer::QgsPointCloudLayerRenderer( QgsPointCloudLayer *layer, QgsRenderContext &context )
   : QgsMapLayerRenderer( layer->id(), &context )
   , mLayer( layer )
@@ -184,7 +253,9 @@ bool QgsPointCloudLayerRenderer::render()
     return false;
   }
   double rootErrorPixels = rootErrorInMapCoordinates / mapUnitsPerPixel; // in pixels
-  const QVector<IndexedPointCloudNode> nodes = traverseTree( pc, context.renderContext(), pc->root(), maximumError, rootErrorPixels );
+  const QVector<IndexedPointCloudNode> nodes = mRenderer->pointBudget() > 0
+      ? traverseTreeWithPointBudget( pc, context.renderContext(), maximumError, rootErrorPixels, mRenderer->pointBudget() )
+      : traverseTree( pc, context.renderContext(), pc->root(), maximumError, rootErrorPixels );
 
   QgsPointCloudRequest request;
   request.setAttributes( mAttributes );
@@ -236,7 +307,8 @@ bool QgsPointCloudLayerRenderer::render()
 int QgsPointCloudLayerRenderer::renderNodesSync( const QVector<IndexedPointCloudNode> &nodes, QgsPointCloudIndex *pc, QgsPointCloudRenderContext &context, QgsPointCloudRequest &request, bool &canceled )
 {
   int nodesDrawn = 0;
-  for ( const IndexedPointCloudNode &n : nodes )
+  QgsPointCloudBlockPrefetcher prefetcher( pc, nodes, request );
+  while ( prefetcher.hasNext() )
   {
     if ( context.renderContext().renderingStopped() )
     {
@@ -244,7 +316,7 @@ int QgsPointCloudLayerRenderer::renderNodesSync( const QVector<IndexedPointCloud
       canceled = true;
       break;
     }
-    std::unique_ptr<QgsPointCloudBlock> block( pc->nodeData( n, request ) );
+    std::unique_ptr<QgsPointCloudBlock> block = prefetcher.next();
 
     if ( !block )
       continue;
@@ -282,70 +354,101 @@ int QgsPointCloudLayerRenderer::renderNodesAsync( const QVector<IndexedPointClou
   if ( context.feedback() && context.feedback()->isCanceled() )
     return 0;
 
-  // Async loading of nodes
+  // nodes are requested from the coarsest to the finest level, and within a level from the center of the map
+  // to its edges, so that the most visible details arrive first
+  const QgsPointXY viewCenter = context.renderContext().extent().center();
+  QVector< QPair< double, IndexedPointCloudNode > > sortedNodes;
+  sortedNodes.reserve( nodes.size() );
+  for ( const IndexedPointCloudNode &n : nodes )
+    sortedNodes << qMakePair( pc->nodeMapExtent( n ).center().sqrDist( viewCenter ), n );
+  std::stable_sort( sortedNodes.begin(), sortedNodes.end(), []( const QPair< double, IndexedPointCloudNode > &a, const QPair< double, IndexedPointCloudNode > &b )
+  {
+    if ( a.second.d() != b.second.d() )
+      return a.second.d() < b.second.d();
+    return a.first < b.first;
+  } );
+
+  // Async loading of nodes, with a limited number of pending requests so that the
+  // nodes which are not requested yet are simply dropped if rendering gets canceled
   QVector<QgsPointCloudBlockRequest *> blockRequests;
   QEventLoop loop;
   if ( context.feedback() )
     QObject::connect( context.feedback(), &QgsFeedback::canceled, &loop, &QEventLoop::quit );
 
-  for ( int i = 0; i < nodes.size(); ++i )
+  int nextNode = 0;
+  std::function< void() > requestNodes;
+  requestNodes = [ this, pc, &request, &sortedNodes, &nextNode, &requestNodes, &canceled, &nodesDrawn, &loop, &blockRequests, &context ]()
   {
-    const IndexedPointCloudNode &n = nodes[i];
-    const QString nStr = n.toString();
-    QgsPointCloudBlockRequest *blockRequest = pc->asyncNodeData( n, request );
-    blockRequests.append( blockRequest );
-    QObject::connect( blockRequest, &QgsPointCloudBlockRequest::finished, &loop,
-                      [ this, &canceled, &nodesDrawn, &loop, &blockRequests, &context, nStr, blockRequest ]()
+    while ( nextNode < sortedNodes.size() && blockRequests.size() < MAX_PENDING_NODE_REQUESTS )
     {
-      blockRequests.removeOne( blockRequest );
+      const IndexedPointCloudNode &n = sortedNodes.at( nextNode++ ).second;
+      const QString nStr = n.toString();
+      QgsPointCloudBlockRequest *blockRequest = pc->asyncNodeData( n, request );
+      if ( !blockRequest )
+      {
+        QgsDebugMsg( QStringLiteral( "Unable to request node %1" ).arg( nStr ) );
+        continue;
+      }
+      blockRequests.append( blockRequest );
+      QObject::connect( blockRequest, &QgsPointCloudBlockRequest::finished, &loop,
+                        [ this, &canceled, &nodesDrawn, &loop, &blockRequests, &context, &requestNodes, nStr, blockRequest ]()
+      {
+        blockRequests.removeOne( blockRequest );
 
-      // If all blocks are loaded, exit the event loop
-      if ( blockRequests.isEmpty() )
-        loop.exit();
+        std::unique_ptr<QgsPointCloudBlock> block( blockRequest->block() );
 
-      std::unique_ptr<QgsPointCloudBlock> block( blockRequest->block() );
+        blockRequest->deleteLater();
 
-      blockRequest->deleteLater();
+        if ( context.feedback() && context.feedback()->isCanceled() )
+        {
+          canceled = true;
+          loop.exit();
+          return;
+        }
 
-      if ( context.feedback() && context.feedback()->isCanceled() )
-      {
-        canceled = true;
-        return;
-      }
+        requestNodes();
 
-      if ( !block )
-      {
-        QgsDebugMsg( QStringLiteral( "Unable to load node %1, error: %2" ).arg( nStr, blockRequest->errorStr() ) );
-        return;
-      }
+        // If all blocks are loaded, exit the event loop
+        if ( blockRequests.isEmpty() )
+          loop.exit();
 
-      QgsVector3D contextScale = context.scale();
-      QgsVector3D contextOffset = context.offset();
+        if ( !block )
+        {
+          QgsDebugMsg( QStringLiteral( "Unable to load node %1, error: %2" ).arg( nStr, blockRequest->errorStr() ) );
+          return;
+        }
 
-      context.setScale( block->scale() );
-      context.setOffset( block->offset() );
-      context.setAttributes( block->attributes() );
+        QgsVector3D contextScale = context.scale();
+        QgsVector3D contextOffset = context.offset();
 
-      mRenderer->renderBlock( block.get(), context );
+        context.setScale( block->scale() );
+        context.setOffset( block->offset() );
+        context.setAttributes( block->attributes() );
 
-      context.setScale( contextScale );
-      context.setOffset( contextOffset );
+        mRenderer->renderBlock( block.get(), context );
 
-      ++nodesDrawn;
+        context.setScale( contextScale );
+        context.setOffset( contextOffset );
 
-      // as soon as first block is rendered, we can start showing layer updates.
-      // but if we are blocking render updates (so that a previously cached image is being shown), we wait
-      // at most e.g. 3 seconds before we start forcing progressive updates.
-      if ( !mBlockRenderUpdates || mElapsedTimer.elapsed() > MAX_TIME_TO_USE_CACHED_PREVIEW_IMAGE )
-      {
-        mReadyToCompose = true;
-      }
+        ++nodesDrawn;
 
-    } );
-  }
+        // as soon as first block is rendered, we can start showing layer updates.
+        // but if we are blocking render updates (so that a previously cached image is being shown), we wait
+        // at most e.g. 3 seconds before we start forcing progressive updates.
+        if ( !mBlockRenderUpdates || mElapsedTimer.elapsed() > MAX_TIME_TO_USE_CACHED_PREVIEW_IMAGE )
+        {
+          mReadyToCompose = true;
+        }
+
+      } );
+    }
+  };
+
+  requestNodes();
 
   // Wait for all point cloud nodes to finish loading
-  loop.exec();
+  if ( !blockRequests.isEmpty() )
+    loop.exec();
 
   // Rendering may have got canceled and the event loop exited before finished()
   // was called for all blocks, so let's clean up anything that is left
@@ -373,7 +476,8 @@ int QgsPointCloudLayerRenderer::renderNodesSorted( const QVector<IndexedPointClo
   // And pairs of byte array start positions paired with their Z values for sorting
   QVector<QPair<int, double>> allPairs;
 
-  for ( const IndexedPointCloudNode &n : nodes )
+  QgsPointCloudBlockPrefetcher prefetcher( pc, nodes, request );
+  while ( prefetcher.hasNext() )
   {
     if ( context.renderContext().renderingStopped() )
     {
@@ -381,7 +485,7 @@ int QgsPointCloudLayerRenderer::renderNodesSorted( const QVector<IndexedPointClo
       canceled = true;
       break;
     }
-    std::unique_ptr<QgsPointCloudBlock> block( pc->nodeData( n, request ) );
+    std::unique_ptr<QgsPointCloudBlock> block = prefetcher.next();
 
     if ( !block )
       continue;
@@ -510,12 +614,7 @@ QVector<IndexedPointCloudNode> QgsPointCloudLayerRenderer::traverseTree( const Q
     return nodes;
   }
 
-  if ( !context.extent().intersects( pc->nodeMapExtent( n ) ) )
-    return nodes;
-
-  const QgsDoubleRange nodeZRange = pc->nodeZRange( n );
-  const QgsDoubleRange adjustedNodeZRange = QgsDoubleRange( nodeZRange.lower() + mZOffset, nodeZRange.upper() + mZOffset );
-  if ( !context.zRange().isInfinite() && !context.zRange().overlaps( adjustedNodeZRange ) )
+  if ( !nodeIsVisible( pc, context, n ) )
     return nodes;
 
   if ( pc->nodePointCount( n ) > 0 )
@@ -534,4 +633,68 @@ QVector<IndexedPointCloudNode> QgsPointCloudLayerRenderer::traverseTree( const Q
   return nodes;
 }
 
+QVector<IndexedPointCloudNode> QgsPointCloudLayerRenderer::traverseTreeWithPointBudget( const QgsPointCloudIndex *pc,
+    const QgsRenderContext &context,
+    double maxErrorPixels,
+    double rootErrorPixels,
+    int pointBudget )
+{
+  QVector<IndexedPointCloudNode> nodes;
+
+  // nodes are visited level by level, so that the coarsest nodes are kept when the budget is reached
+  QQueue< QPair< IndexedPointCloudNode, double > > queue;
+  queue.enqueue( qMakePair( pc->root(), rootErrorPixels ) );
+  qint64 pointCount = 0;
+  while ( !queue.isEmpty() )
+  {
+    if ( context.renderingStopped() )
+    {
+      QgsDebugMsgLevel( QStringLiteral( "canceled" ), 2 );
+      break;
+    }
+
+    const QPair< IndexedPointCloudNode, double > item = queue.dequeue();
+    const IndexedPointCloudNode &n = item.first;
+    if ( !nodeIsVisible( pc, context, n ) )
+      continue;
+
+    const int nodePointCount = pc->nodePointCount( n );
+    if ( nodePointCount > 0 )
+    {
+      if ( !nodes.isEmpty() && pointCount + nodePointCount > pointBudget )
+      {
+        QgsDebugMsgLevel( QStringLiteral( "point budget of %1 reached with %2 points" ).arg( pointBudget ).arg( pointCount ), 2 );
+        break;
+      }
+      nodes.append( n );
+      pointCount += nodePointCount;
+    }
+
+    const double childrenErrorPixels = item.second / 2.0;
+    if ( childrenErrorPixels < maxErrorPixels )
+      continue;
+
+    const QList<IndexedPointCloudNode> children = pc->nodeChildren( n );
+    for ( const IndexedPointCloudNode &nn : children )
+    {
+      queue.enqueue( qMakePair( nn, childrenErrorPixels ) );
+    }
+  }
+
+  return nodes;
+}
+
+bool QgsPointCloudLayerRenderer::nodeIsVisible( const QgsPointCloudIndex *pc, const QgsRenderContext &context, const IndexedPointCloudNode &n ) const
+{
+  if ( !context.extent().intersects( pc->nodeMapExtent( n ) ) )
+    return false;
+
+  const QgsDoubleRange nodeZRange = pc->nodeZRange( n );
+  const QgsDoubleRange adjustedNodeZRange = QgsDoubleRange( nodeZRange.lower() + mZOffset, nodeZRange.upper() + mZOffset );
+  if ( !context.zRange().isInfinite() && !context.zRange().overlaps( adjustedNodeZRange ) )
+    return false;
+
+  return true;
+}
+
 QgsPointCloudLayerRenderer::~QgsPointCloudLayerRenderer() = default;
@@ -160,6 +160,30 @@ QStringList QgsPointCloudRenderer::legendRuleKeys() const
   return QStringList();
 }
 
+void QgsPointCloudRenderer::blockPointsXYZ( QgsPointCloudRenderContext &context, const QgsPointCloudBlock *block, std::vector< double > &x, std::vector< double > &y, std::vector< double > *z )
+{
+  // be wary when copying this code!! In the renderer we explicitly request x/y/z as qint32 values, but in other
+  // situations these may be floats or doubles!
+  const int count = block->pointCount();
+  const std::size_t recordSize = context.pointRecordSize();
+
+  auto readAxis = [block, count, recordSize]( int attributeOffset, double offset, double scale, std::vector< double > &values )
+  {
+    values.resize( count );
+    const char *ptr = block->data() + attributeOffset;
+    double *value = values.data();
+    for ( int i = 0; i < count; ++i, ptr += recordSize )
+      value[i] = offset + scale * *reinterpret_cast< const qint32 * >( ptr );
+  };
+
+  readAxis( context.xOffset(), context.offset().x(), context.scale().x(), x );
+  readAxis( context.yOffset(), context.offset().y(), context.scale().y(), y );
+  if ( z )
+  {
+    readAxis( context.zOffset(), context.offset().z() * context.zValueScale() + context.zValueFixedOffset(), context.scale().z() * context.zValueScale(), *z );
+  }
+}
+
 void QgsPointCloudRenderer::drawPointToElevationMap( double x, double y, double z, QgsPointCloudRenderContext &context ) const
 {
   const QPointF originalXY( x, y );
@@ -192,6 +216,7 @@ void QgsPointCloudRenderer::copyCommonProperties( QgsPointCloudRenderer *destina
   destination->setPointSizeMapUnitScale( mPointSizeMapUnitScale );
   destination->setMaximumScreenError( mMaximumScreenError );
   destination->setMaximumScreenErrorUnit( mMaximumScreenErrorUnit );
+  destination->setPointBudget( mPointBudget );
   destination->setPointSymbol( mPointSymbol );
   destination->setDrawOrder2d( mDrawOrder2d );
 }
@@ -204,6 +229,7 @@ void QgsPointCloudRenderer::restoreCommonProperties( const QDomElement &element,
 
   mMaximumScreenError = element.attribute( QStringLiteral( "maximumScreenError" ), QStringLiteral( "0.3" ) ).toDouble();
   mMaximumScreenErrorUnit = QgsUnitTypes::decodeRenderUnit( element.attribute( QStringLiteral( "maximumScreenErrorUnit" ), QStringLiteral( "MM" ) ) );
+  mPointBudget = element.attribute( QStringLiteral( "pointBudget" ), QStringLiteral( "0" ) ).toInt();
   mPointSymbol = static_cast< Qgis::PointCloudSymbol >( element.attribute( QStringLiteral( "pointSymbol" ), QStringLiteral( "0" ) ).toInt() );
   mDrawOrder2d = static_cast< Qgis::PointCloudDrawOrder >( element.attribute( QStringLiteral( "drawOrder2d" ), QStringLiteral( "0" ) ).toInt() );
 }
@@ -216,6 +242,7 @@ void QgsPointCloudRenderer::saveCommonProperties( QDomElement &element, const Qg
 
   element.setAttribute( QStringLiteral( "maximumScreenError" ), qgsDoubleToString( mMaximumScreenError ) );
   element.setAttribute( QStringLiteral( "maximumScreenErrorUnit" ), QgsUnitTypes::encodeUnit( mMaximumScreenErrorUnit ) );
+  element.setAttribute( QStringLiteral( "pointBudget" ), QString::number( mPointBudget ) );
   element.setAttribute( QStringLiteral( "pointSymbol" ), QString::number( static_cast< int >( mPointSymbol ) ) );
   element.setAttribute( QStringLiteral( "drawOrder2d" ), QString::number( static_cast< int >( mDrawOrder2d ) ) );
 }
@@ -25,8 +25,10 @@
 #include "qgsvector3d.h"
 #include "qgspointcloudattribute.h"
 #include "qgselevationmap.h"
+#include "qgspointcloudblock.h"
+
+#include <vector>
 
-class QgsPointCloudBlock;
 class QgsLayerTreeLayer;
 class QgsLayerTreeModelLegendNode;
 class QgsPointCloudLayer;
@@ -562,6 +564,26 @@ class CORE_EXPORT QgsPointCloudRenderer
      */
     void setMaximumScreenErrorUnit( QgsUnitTypes::RenderUnit unit );
 
+    /**
+     * Returns the maximum number of points rendered in 2D for each map render, or 0 if the number of points is not limited.
+     *
+     * The nodes of the point cloud are then visited from the coarsest to the finest levels of detail, and the finer nodes
+     * are left out when the budget is reached, regardless of the maximum screen error.
+     *
+     * \see setPointBudget()
+     * \since QGIS 3.30
+     */
+    int pointBudget() const { return mPointBudget; }
+
+    /**
+     * Sets the maximum number of points rendered in 2D for each map render. A \a budget of 0 means
+     * that the number of points is not limited.
+     *
+     * \see pointBudget()
+     * \since QGIS 3.30
+     */
+    void setPointBudget( int budget ) { mPointBudget = std::max( 0, budget ); }
+
     /**
      * Creates a set of legend nodes representing the renderer.
      */
@@ -624,6 +646,37 @@ class CORE_EXPORT QgsPointCloudRenderer
       };
     }
 
+#ifndef SIP_RUN
+
+    /**
+     * Retrieves the x, y and z coordinates of all the points of a \a block at once, stored in contiguous arrays.
+     *
+     * The coordinates are read one axis at a time, so this is faster than calling pointXY() and pointZ() for each point
+     * when most points of the block are rendered. Z values include the z scale and offset of the context, as with pointZ(), and
+     * are only retrieved if \a z is not NULLPTR.
+     *
+     * \since QGIS 3.30
+     */
+    static void blockPointsXYZ( QgsPointCloudRenderContext &context, const QgsPointCloudBlock *block, std::vector< double > &x, std::vector< double > &y, std::vector< double > *z = nullptr );
+
+    /**
+     * Retrieves the values of the attribute of type \a type stored at \a attributeOffset in the records of all the points
+     * of a \a block at once, stored in a contiguous array.
+     *
+     * \since QGIS 3.30
+     */
+    template <typename T>
+    static void blockAttributeValues( const QgsPointCloudBlock *block, int attributeOffset, QgsPointCloudAttribute::DataType type, std::vector< T > &values )
+    {
+      const int count = block->pointCount();
+      const std::size_t recordSize = block->pointRecordSize();
+      const char *ptr = block->data() + attributeOffset;
+      values.resize( count );
+      for ( int i = 0; i < count; ++i, ptr += recordSize )
+        QgsPointCloudRenderContext::getAttribute( ptr, 0, type, values[i] );
+    }
+#endif
+
 #ifndef SIP_RUN   // intentionally left out from SIP to avoid API breaks in future when we move elevation post-processing elsewhere
 
     /**
@@ -666,6 +719,7 @@ class CORE_EXPORT QgsPointCloudRenderer
 
     double mMaximumScreenError = 0.3;
     QgsUnitTypes::RenderUnit mMaximumScreenErrorUnit = QgsUnitTypes::RenderMillimeters;
+    int mPointBudget = 0;
 
     double mPointSize = 1;
     QgsUnitTypes::RenderUnit mPointSizeUnit = QgsUnitTypes::RenderMillimeters;
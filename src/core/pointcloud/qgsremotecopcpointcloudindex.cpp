@@ -85,6 +85,7 @@ QList<IndexedPointCloudNode> QgsRemoteCopcPointCloudIndex::nodeChildren( const I
 void QgsRemoteCopcPointCloudIndex::load( const QString &url )
 {
   mUrl = QUrl( url );
+  mUri = url;
   mLazInfo.reset( new QgsLazInfo( QgsLazInfo::fromUrl( mUrl ) ) );
   mIsValid = mLazInfo->isValid();
   if ( mIsValid )
@@ -103,6 +104,9 @@ void QgsRemoteCopcPointCloudIndex::load( const QString &url )
 
 QgsPointCloudBlock *QgsRemoteCopcPointCloudIndex::nodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request )
 {
+  if ( QgsPointCloudBlock *cached = cachedNodeData( n, request ) )
+    return cached;
+
   std::unique_ptr<QgsPointCloudBlockRequest> blockRequest( asyncNodeData( n, request ) );
   if ( !blockRequest )
     return nullptr;
@@ -116,6 +120,7 @@ QgsPointCloudBlock *QgsRemoteCopcPointCloudIndex::nodeData( const IndexedPointCl
     QgsDebugMsg( QStringLiteral( "Error downloading node %1 data, error : %2 " ).arg( n.toString(), blockRequest->errorStr() ) );
   }
 
+  storeNodeDataToCache( blockRequest->block(), n, request );
   return blockRequest->block();
 }
 
@@ -28,10 +28,18 @@
 #include "qgsprocessingparametertype.h"
 #include "qgsexpressioncontextutils.h"
 #include "qgsprocessingmodelgroupbox.h"
+#include "qgsprocessingfeaturepipeline.h"
 
 #include <QFile>
 #include <QTextStream>
 #include <QRegularExpression>
+#include <QEventLoop>
+#include <QMutex>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <exception>
+
 ///@cond NOT_STABLE
 
 QgsProcessingModelAlgorithm::QgsProcessingModelAlgorithm( const QString &name, const QString &group, const QString &groupId )
@@ -294,6 +302,72 @@ bool QgsProcessingModelAlgorithm::childOutputIsRequired( const QString &childId,
   return false;
 }
 
+QString QgsProcessingModelAlgorithm::streamingConsumerForChildAlgorithm( const QString &childId, const QgsProcessingAlgorithm *algorithm ) const
+{
+  const QgsProcessingFeatureBasedAlgorithm *featureAlgorithm = dynamic_cast< const QgsProcessingFeatureBasedAlgorithm * >( algorithm );
+  if ( !featureAlgorithm || !QgsProcessingFeaturePipeline::canStream( featureAlgorithm ) )
+    return QString();
+
+  const auto childAlgIt = mChildAlgorithms.constFind( childId );
+  if ( childAlgIt == mChildAlgorithms.constEnd() || !childAlgIt->modelOutputs().isEmpty() )
+    return QString();
+
+  // the features must only be used as the source of another feature based algorithm
+  QString consumerId;
+  QMap< QString, QgsProcessingModelChildAlgorithm >::const_iterator childIt = mChildAlgorithms.constBegin();
+  for ( ; childIt != mChildAlgorithms.constEnd(); ++childIt )
+  {
+    const QMap<QString, QgsProcessingModelChildParameterSources> candidateChildParams = childIt->parameterSources();
+    QMap<QString, QgsProcessingModelChildParameterSources>::const_iterator childParamIt = candidateChildParams.constBegin();
+    for ( ; childParamIt != candidateChildParams.constEnd(); ++childParamIt )
+    {
+      for ( const QgsProcessingModelChildParameterSource &source : childParamIt.value() )
+      {
+        if ( source.source() != QgsProcessingModelChildParameterSource::ChildOutput || source.outputChildId() != childId )
+          continue;
+
+        if ( !consumerId.isEmpty() || !childIt->isActive() )
+          return QString();
+
+        const QgsProcessingFeatureBasedAlgorithm *consumerAlgorithm = dynamic_cast< const QgsProcessingFeatureBasedAlgorithm * >( childIt->algorithm() );
+        if ( !consumerAlgorithm
+             || consumerAlgorithm->flags() & QgsProcessingAlgorithm::FlagNoThreading
+             || childParamIt.key() != QgsProcessingFeaturePipeline::inputParameterName( consumerAlgorithm )
+             || childParamIt.value().size() != 1 )
+          return QString();
+
+        consumerId = childIt->childId();
+      }
+    }
+  }
+
+  if ( consumerId.isEmpty() )
+    return QString();
+
+  // the streamed algorithm completes with the consumer, so everything else depending on it must wait for the consumer
+  QSet< QString > consumerDependents = dependentChildAlgorithms( consumerId );
+  consumerDependents.insert( consumerId );
+  if ( dependentChildAlgorithms( childId ) != consumerDependents )
+    return QString();
+
+  return consumerId;
+}
+
+//! A child algorithm running on a worker thread, concurrently with the independent branches of the model
+struct QgsProcessingModelRunningChild
+{
+  std::unique_ptr< QgsProcessingAlgorithm > algorithm;
+  QVariantMap parameters;
+  std::unique_ptr< QgsProcessingContext > context;
+  std::unique_ptr< QgsProcessingRecordingFeedback > feedback;
+  std::unique_ptr< QThread > thread;
+  QVariantMap results;
+  //! Exception thrown by the algorithm
+  std::exception_ptr exception;
+  bool skipGenericLogging = true;
+  QElapsedTimer time;
+};
+
 QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   QSet< QString > toExecute;
@@ -324,253 +398,463 @@ QVariantMap QgsProcessingModelAlgorithm::processAlgorithm( const QVariantMap &pa
 
   const bool verboseLog = context.logLevel() == QgsProcessingContext::Verbose;
 
+  // chained feature based algorithms stream their features instead of writing them to temporary layers,
+  // except when logging the execution of each algorithm
+  const bool streamChildOutputs = !verboseLog;
+  std::map< QString, std::unique_ptr< QgsProcessingFeaturePipeline > > pendingPipelines;
+
   QVariantMap finalResults;
   QSet< QString > executed;
-  bool executedAlg = true;
-  while ( executedAlg && executed.count() < toExecute.count() )
-  {
-    executedAlg = false;
-    for ( const QString &childId : std::as_const( toExecute ) )
-    {
-      if ( feedback && feedback->isCanceled() )
-        break;
 
-      if ( executed.contains( childId ) )
-        continue;
+  // children running on worker threads, concurrently with the independent branches of the model
+  std::map< QString, std::unique_ptr< QgsProcessingModelRunningChild > > running;
+  QStringList completed;
+  QMutex completedMutex;
+  QEventLoop waitLoop;
 
-      bool canExecute = true;
-      const QSet< QString > dependencies = dependsOnChildAlgorithms( childId );
-      for ( const QString &dependency : dependencies )
+  // independent children run concurrently, with up to one thread per processor
+  const int maxRunningChildren = QThreadPool::globalInstance()->maxThreadCount();
+  const bool runChildrenConcurrently = maxRunningChildren > 1;
+
+  // returns the ID of a child completed on a worker thread, or an empty string if none completed and wait is FALSE
+  const auto takeCompletedChild = [&completed, &completedMutex, &waitLoop]( bool wait ) -> QString
+  {
+    while ( true )
+    {
       {
-        if ( !executed.contains( dependency ) )
-        {
-          canExecute = false;
-          break;
-        }
+        QMutexLocker locker( &completedMutex );
+        if ( !completed.isEmpty() || !wait )
+          return completed.isEmpty() ? QString() : completed.takeFirst();
       }
+      // events are processed while waiting, as the children may need this thread, e.g. to access the layers it owns
+      waitLoop.exec();
+    }
+  };
 
-      if ( !canExecute )
+  const auto stopRunningChildren = [&running, &takeCompletedChild]
+  {
+    for ( auto &runningChild : running )
+      runningChild.second->feedback->cancel();
+    while ( !running.empty() )
+    {
+      auto runningIt = running.find( takeCompletedChild( true ) );
+      if ( runningIt == running.end() )
         continue;
 
-      executedAlg = true;
+      runningIt->second->thread->wait();
+      running.erase( runningIt );
+    }
+  };
 
-      const QgsProcessingModelChildAlgorithm &child = mChildAlgorithms[ childId ];
-      std::unique_ptr< QgsProcessingAlgorithm > childAlg( child.algorithm()->create( child.configuration() ) );
+  // children running on worker threads have a context of their own, without the temporary layers of the model
+  // context, so the children reading these layers must run on the model thread
+  std::function< bool( const QVariant & ) > referencesTemporaryLayer;
+  referencesTemporaryLayer = [&context, &referencesTemporaryLayer]( const QVariant & value ) -> bool
+  {
+    if ( value.type() == QVariant::List || value.type() == QVariant::StringList )
+    {
+      const QVariantList values = value.toList();
+      return std::any_of( values.constBegin(), values.constEnd(), referencesTemporaryLayer );
+    }
 
-      const bool skipGenericLogging = !verboseLog || childAlg->flags() & QgsProcessingAlgorithm::FlagSkipGenericModelLogging;
-      if ( feedback && !skipGenericLogging )
-        feedback->pushDebugInfo( QObject::tr( "Prepare algorithm: %1" ).arg( childId ) );
+    QString layerString;
+    if ( QgsMapLayer *layer = qobject_cast< QgsMapLayer * >( qvariant_cast< QObject * >( value ) ) )
+      layerString = layer->id();
+    else if ( value.canConvert< QgsProcessingFeatureSourceDefinition >() )
+      layerString = value.value< QgsProcessingFeatureSourceDefinition >().source.staticValue().toString();
+    else if ( value.type() == QVariant::String )
+      layerString = value.toString();
 
-      QgsExpressionContext expContext = baseContext;
-      expContext << QgsExpressionContextUtils::processingAlgorithmScope( child.algorithm(), parameters, context )
-                 << createExpressionContextScopeForChildAlgorithm( childId, context, parameters, childResults );
-      context.setExpressionContext( expContext );
+    if ( layerString.isEmpty() )
+      return false;
 
-      QString error;
-      QVariantMap childParams = parametersForChildAlgorithm( child, parameters, childResults, expContext, error );
-      if ( !error.isEmpty() )
-        throw QgsProcessingException( error );
+    QgsMapLayerStore *store = context.temporaryLayerStore();
+    return store->mapLayer( layerString ) || !store->mapLayersByName( layerString ).isEmpty();
+  };
 
-      if ( feedback && !skipGenericLogging )
-        feedback->setProgressText( QObject::tr( "Running %1 [%2/%3]" ).arg( child.description() ).arg( executed.count() + 1 ).arg( toExecute.count() ) );
+  // completes a child algorithm after it ran with the given run context
+  const auto completeChild = [&]( const QString & childId, std::unique_ptr< QgsProcessingAlgorithm > childAlg, QVariantMap results, QgsProcessingContext & runContext, bool skipGenericLogging, qint64 elapsed )
+  {
+    const QgsProcessingModelChildAlgorithm &child = mChildAlgorithms[ childId ];
+    QThread *modelThread = QThread::currentThread();
 
-      childInputs.insert( childId, QgsProcessingUtils::removePointerValuesFromMap( childParams ) );
-      QStringList params;
-      for ( auto childParamIt = childParams.constBegin(); childParamIt != childParams.constEnd(); ++childParamIt )
-      {
-        params << QStringLiteral( "%1: %2" ).arg( childParamIt.key(),
-               child.algorithm()->parameterDefinition( childParamIt.key() )->valueAsPythonString( childParamIt.value(), context ) );
-      }
+    QVariantMap ppRes;
+    auto postProcessOnMainThread = [modelThread, &ppRes, &childAlg, &runContext, &modelFeedback]
+    {
+      Q_ASSERT_X( QThread::currentThread() == qApp->thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "childAlg->postProcess() must be run on the main thread" );
+      ppRes = childAlg->postProcess( runContext, &modelFeedback );
+      runContext.pushToThread( modelThread );
+    };
+
+    // Make sure we only run postProcess steps on the main thread!
+    if ( modelThread == qApp->thread() )
+      ppRes = childAlg->postProcess( runContext, &modelFeedback );
+    else
+    {
+      runContext.pushToThread( qApp->thread() );
+      QMetaObject::invokeMethod( qApp, postProcessOnMainThread, Qt::BlockingQueuedConnection );
+    }
 
-      if ( feedback && !skipGenericLogging )
-      {
-        feedback->pushInfo( QObject::tr( "Input Parameters:" ) );
-        feedback->pushCommandInfo( QStringLiteral( "{ %1 }" ).arg( params.join( QLatin1String( ", " ) ) ) );
-      }
+    Q_ASSERT_X( QThread::currentThread() == runContext.thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "context was not transferred back to model thread" );
 
-      QElapsedTimer childTime;
-      childTime.start();
+    if ( &runContext != &context )
+      context.takeResultsFrom( runContext );
 
-      bool ok = false;
+    if ( !ppRes.isEmpty() )
+      results = ppRes;
 
-      QThread *modelThread = QThread::currentThread();
+    childResults.insert( childId, results );
 
-      auto prepareOnMainThread = [modelThread, &ok, &childAlg, &childParams, &context, &modelFeedback]
+    // look through child alg's outputs to determine whether any of these should be copied
+    // to the final model outputs
+    QMap<QString, QgsProcessingModelOutput> outputs = child.modelOutputs();
+    QMap<QString, QgsProcessingModelOutput>::const_iterator outputIt = outputs.constBegin();
+    for ( ; outputIt != outputs.constEnd(); ++outputIt )
+    {
+      switch ( mInternalVersion )
       {
-        Q_ASSERT_X( QThread::currentThread() == qApp->thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "childAlg->prepare() must be run on the main thread" );
-        ok = childAlg->prepare( childParams, context, &modelFeedback );
-        context.pushToThread( modelThread );
-      };
+        case QgsProcessingModelAlgorithm::InternalVersion::Version1:
+          finalResults.insert( childId + ':' + outputIt->name(), results.value( outputIt->childOutputName() ) );
+          break;
+        case QgsProcessingModelAlgorithm::InternalVersion::Version2:
+          if ( const QgsProcessingParameterDefinition *modelParam = modelParameterFromChildIdAndOutputName( child.childId(), outputIt.key() ) )
+          {
+            finalResults.insert( modelParam->name(), results.value( outputIt->childOutputName() ) );
+          }
+          break;
+      }
+    }
 
-      // Make sure we only run prepare steps on the main thread!
-      if ( modelThread == qApp->thread() )
-        ok = childAlg->prepare( childParams, context, &modelFeedback );
-      else
+    executed.insert( childId );
+
+    std::function< void( const QString &, const QString & )> pruneAlgorithmBranchRecursive;
+    pruneAlgorithmBranchRecursive = [&]( const QString & id, const QString &branch = QString() )
+    {
+      const QSet<QString> toPrune = dependentChildAlgorithms( id, branch );
+      for ( const QString &targetId : toPrune )
       {
-        context.pushToThread( qApp->thread() );
-        QMetaObject::invokeMethod( qApp, prepareOnMainThread, Qt::BlockingQueuedConnection );
+        if ( executed.contains( targetId ) )
+          continue;
+
+        executed.insert( targetId );
+        pruneAlgorithmBranchRecursive( targetId, branch );
       }
+    };
 
-      Q_ASSERT_X( QThread::currentThread() == context.thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "context was not transferred back to model thread" );
+    // prune remaining algorithms if they are dependent on a branch from this child which didn't eventuate
+    const QgsProcessingOutputDefinitions outputDefs = childAlg->outputDefinitions();
+    for ( const QgsProcessingOutputDefinition *outputDef : outputDefs )
+    {
+      if ( outputDef->type() == QgsProcessingOutputConditionalBranch::typeName() && !results.value( outputDef->name() ).toBool() )
+      {
+        pruneAlgorithmBranchRecursive( childId, outputDef->name() );
+      }
+    }
 
-      if ( !ok )
+    if ( childAlg->flags() & QgsProcessingAlgorithm::FlagPruneModelBranchesBasedOnAlgorithmResults )
+    {
+      // check if any dependent algorithms should be canceled based on the outputs of this algorithm run
+      // first find all direct dependencies of this algorithm by looking through all remaining child algorithms
+      for ( const QString &candidateId : std::as_const( toExecute ) )
       {
-        const QString error = ( childAlg->flags() & QgsProcessingAlgorithm::FlagCustomException ) ? QString() : QObject::tr( "Error encountered while running %1" ).arg( child.description() );
-        throw QgsProcessingException( error );
+        if ( executed.contains( candidateId ) )
+          continue;
+
+        // a pending algorithm was found..., check it's parameter sources to see if it links to any of the current
+        // algorithm's outputs
+        const QgsProcessingModelChildAlgorithm &candidate = mChildAlgorithms[ candidateId ];
+        const QMap<QString, QgsProcessingModelChildParameterSources> candidateParams = candidate.parameterSources();
+        QMap<QString, QgsProcessingModelChildParameterSources>::const_iterator paramIt = candidateParams.constBegin();
+        bool pruned = false;
+        for ( ; paramIt != candidateParams.constEnd(); ++paramIt )
+        {
+          for ( const QgsProcessingModelChildParameterSource &source : paramIt.value() )
+          {
+            if ( source.source() == QgsProcessingModelChildParameterSource::ChildOutput && source.outputChildId() == childId )
+            {
+              // ok, this one is dependent on the current alg. Did we get a value for it?
+              if ( !results.contains( source.outputName() ) )
+              {
+                // oh no, nothing returned for this parameter. Gotta trim the branch back!
+                pruned = true;
+                // skip the dependent alg..
+                executed.insert( candidateId );
+                //... and everything which depends on it
+                pruneAlgorithmBranchRecursive( candidateId, QString() );
+                break;
+              }
+            }
+          }
+          if ( pruned )
+            break;
+        }
       }
+    }
 
-      QVariantMap results;
-      try
+    childAlg.reset( nullptr );
+    modelFeedback.setCurrentStep( executed.count() );
+    if ( feedback && !skipGenericLogging )
+      feedback->pushInfo( QObject::tr( "OK. Execution took %1 s (%n output(s)).", nullptr, results.count() ).arg( elapsed / 1000.0 ) );
+  };
+
+  // completes a child which ran on a worker thread
+  const auto completeRunningChild = [&]( const QString & childId )
+  {
+    auto runningIt = running.find( childId );
+    std::unique_ptr< QgsProcessingModelRunningChild > runningChild = std::move( runningIt->second );
+    running.erase( runningIt );
+    runningChild->thread->wait();
+
+    runningChild->feedback->report( &modelFeedback );
+
+    if ( runningChild->exception )
+    {
+      stopRunningChildren();
+      const QString error = ( runningChild->algorithm->flags() & QgsProcessingAlgorithm::FlagCustomException ) ? QString() : QObject::tr( "Error encountered while running %1" ).arg( mChildAlgorithms[ childId ].description() );
+      throw QgsProcessingException( error );
+    }
+
+    completeChild( childId, std::move( runningChild->algorithm ), runningChild->results, *runningChild->context, runningChild->skipGenericLogging, runningChild->time.elapsed() );
+  };
+
+  try
+  {
+    bool executedAlg = true;
+    while ( ( executedAlg || !running.empty() ) && executed.count() < toExecute.count() )
+    {
+      executedAlg = false;
+      for ( const QString &childId : std::as_const( toExecute ) )
       {
-        if ( childAlg->flags() & QgsProcessingAlgorithm::FlagNoThreading )
+        if ( feedback && feedback->isCanceled() )
+          break;
+
+        if ( executed.contains( childId ) || running.count( childId ) )
+          continue;
+
+        bool canExecute = true;
+        const QSet< QString > dependencies = dependsOnChildAlgorithms( childId );
+        for ( const QString &dependency : dependencies )
         {
-          // child algorithm run step must be called on main thread
-          auto runOnMainThread = [modelThread, &context, &modelFeedback, &results, &childAlg, &childParams]
+          if ( !executed.contains( dependency ) )
           {
-            Q_ASSERT_X( QThread::currentThread() == qApp->thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "childAlg->runPrepared() must be run on the main thread" );
-            results = childAlg->runPrepared( childParams, context, &modelFeedback );
-            context.pushToThread( modelThread );
-          };
+            canExecute = false;
+            break;
+          }
+        }
+
+        if ( !canExecute )
+          continue;
+
+        executedAlg = true;
+
+        const QgsProcessingModelChildAlgorithm &child = mChildAlgorithms[ childId ];
+        std::unique_ptr< QgsProcessingAlgorithm > childAlg( child.algorithm()->create( child.configuration() ) );
+
+        const bool skipGenericLogging = !verboseLog || childAlg->flags() & QgsProcessingAlgorithm::FlagSkipGenericModelLogging;
+        if ( feedback && !skipGenericLogging )
+          feedback->pushDebugInfo( QObject::tr( "Prepare algorithm: %1" ).arg( childId ) );
+
+        QgsExpressionContext expContext = baseContext;
+        expContext << QgsExpressionContextUtils::processingAlgorithmScope( child.algorithm(), parameters, context )
+                   << createExpressionContextScopeForChildAlgorithm( childId, context, parameters, childResults );
+        context.setExpressionContext( expContext );
+
+        QString error;
+        QVariantMap childParams = parametersForChildAlgorithm( child, parameters, childResults, expContext, error );
+        if ( !error.isEmpty() )
+          throw QgsProcessingException( error );
 
-          if ( feedback && !skipGenericLogging && modelThread != qApp->thread() )
-            feedback->pushWarning( QObject::tr( "Algorithm “%1” cannot be run in a background thread, switching to main thread for this step" ).arg( childAlg->displayName() ) );
+        if ( feedback && !skipGenericLogging )
+          feedback->setProgressText( QObject::tr( "Running %1 [%2/%3]" ).arg( child.description() ).arg( executed.count() + running.size() + 1 ).arg( toExecute.count() ) );
 
-          context.pushToThread( qApp->thread() );
-          QMetaObject::invokeMethod( qApp, runOnMainThread, Qt::BlockingQueuedConnection );
+        childInputs.insert( childId, QgsProcessingUtils::removePointerValuesFromMap( childParams ) );
+        QStringList params;
+        for ( auto childParamIt = childParams.constBegin(); childParamIt != childParams.constEnd(); ++childParamIt )
+        {
+          params << QStringLiteral( "%1: %2" ).arg( childParamIt.key(),
+                 child.algorithm()->parameterDefinition( childParamIt.key() )->valueAsPythonString( childParamIt.value(), context ) );
         }
-        else
+
+        if ( feedback && !skipGenericLogging )
         {
-          // safe to run on model thread
-          results = childAlg->runPrepared( childParams, context, &modelFeedback );
+          feedback->pushInfo( QObject::tr( "Input Parameters:" ) );
+          feedback->pushCommandInfo( QStringLiteral( "{ %1 }" ).arg( params.join( QLatin1String( ", " ) ) ) );
         }
-      }
-      catch ( QgsProcessingException & )
-      {
-        const QString error = ( childAlg->flags() & QgsProcessingAlgorithm::FlagCustomException ) ? QString() : QObject::tr( "Error encountered while running %1" ).arg( child.description() );
-        throw QgsProcessingException( error );
-      }
 
-      Q_ASSERT_X( QThread::currentThread() == context.thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "context was not transferred back to model thread" );
+        std::unique_ptr< QgsProcessingFeaturePipeline > upstreamPipeline;
+        auto pipelineIt = pendingPipelines.find( childId );
+        if ( pipelineIt != pendingPipelines.end() )
+        {
+          upstreamPipeline = std::move( pipelineIt->second );
+          pendingPipelines.erase( pipelineIt );
+        }
 
-      QVariantMap ppRes;
-      auto postProcessOnMainThread = [modelThread, &ppRes, &childAlg, &context, &modelFeedback]
-      {
-        Q_ASSERT_X( QThread::currentThread() == qApp->thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "childAlg->postProcess() must be run on the main thread" );
-        ppRes = childAlg->postProcess( context, &modelFeedback );
-        context.pushToThread( modelThread );
-      };
+        const QString streamingConsumer = streamChildOutputs ? streamingConsumerForChildAlgorithm( childId, childAlg.get() ) : QString();
 
-      // Make sure we only run postProcess steps on the main thread!
-      if ( modelThread == qApp->thread() )
-        ppRes = childAlg->postProcess( context, &modelFeedback );
-      else
-      {
-        context.pushToThread( qApp->thread() );
-        QMetaObject::invokeMethod( qApp, postProcessOnMainThread, Qt::BlockingQueuedConnection );
-      }
+        // children which can run on a worker thread are prepared and run with a context of their own
+        std::unique_ptr< QgsProcessingModelRunningChild > runningChild;
+        if ( runChildrenConcurrently && streamingConsumer.isEmpty() && !upstreamPipeline
+             && !( childAlg->flags() & QgsProcessingAlgorithm::FlagNoThreading )
+             && !referencesTemporaryLayer( QVariant( childParams.values() ) ) )
+        {
+          runningChild = std::make_unique< QgsProcessingModelRunningChild >();
+          runningChild->parameters = childParams;
+          runningChild->context = std::make_unique< QgsProcessingContext >();
+          runningChild->context->copyThreadSafeSettings( context );
+          runningChild->feedback = std::make_unique< QgsProcessingRecordingFeedback >();
+          runningChild->context->setFeedback( runningChild->feedback.get() );
+          QObject::connect( &modelFeedback, &QgsFeedback::canceled, runningChild->feedback.get(), &QgsFeedback::cancel, Qt::DirectConnection );
+          runningChild->skipGenericLogging = skipGenericLogging;
+        }
+        QgsProcessingContext &runContext = runningChild ? *runningChild->context : context;
 
-      Q_ASSERT_X( QThread::currentThread() == context.thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "context was not transferred back to model thread" );
+        QElapsedTimer childTime;
+        childTime.start();
 
-      if ( !ppRes.isEmpty() )
-        results = ppRes;
+        bool ok = false;
 
-      childResults.insert( childId, results );
+        QThread *modelThread = QThread::currentThread();
 
-      // look through child alg's outputs to determine whether any of these should be copied
-      // to the final model outputs
-      QMap<QString, QgsProcessingModelOutput> outputs = child.modelOutputs();
-      QMap<QString, QgsProcessingModelOutput>::const_iterator outputIt = outputs.constBegin();
-      for ( ; outputIt != outputs.constEnd(); ++outputIt )
-      {
-        switch ( mInternalVersion )
+        auto prepareOnMainThread = [modelThread, &ok, &childAlg, &childParams, &runContext, &modelFeedback]
         {
-          case QgsProcessingModelAlgorithm::InternalVersion::Version1:
-            finalResults.insert( childId + ':' + outputIt->name(), results.value( outputIt->childOutputName() ) );
-            break;
-          case QgsProcessingModelAlgorithm::InternalVersion::Version2:
-            if ( const QgsProcessingParameterDefinition *modelParam = modelParameterFromChildIdAndOutputName( child.childId(), outputIt.key() ) )
-            {
-              finalResults.insert( modelParam->name(), results.value( outputIt->childOutputName() ) );
-            }
-            break;
+          Q_ASSERT_X( QThread::currentThread() == qApp->thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "childAlg->prepare() must be run on the main thread" );
+          ok = childAlg->prepare( childParams, runContext, &modelFeedback );
+          runContext.pushToThread( modelThread );
+        };
+
+        // Make sure we only run prepare steps on the main thread!
+        if ( modelThread == qApp->thread() )
+          ok = childAlg->prepare( childParams, runContext, &modelFeedback );
+        else
+        {
+          runContext.pushToThread( qApp->thread() );
+          QMetaObject::invokeMethod( qApp, prepareOnMainThread, Qt::BlockingQueuedConnection );
         }
-      }
 
-      executed.insert( childId );
+        Q_ASSERT_X( QThread::currentThread() == runContext.thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "context was not transferred back to model thread" );
 
-      std::function< void( const QString &, const QString & )> pruneAlgorithmBranchRecursive;
-      pruneAlgorithmBranchRecursive = [&]( const QString & id, const QString &branch = QString() )
-      {
-        const QSet<QString> toPrune = dependentChildAlgorithms( id, branch );
-        for ( const QString &targetId : toPrune )
+        if ( !ok )
         {
-          if ( executed.contains( targetId ) )
-            continue;
-
-          executed.insert( targetId );
-          pruneAlgorithmBranchRecursive( targetId, branch );
+          const QString error = ( childAlg->flags() & QgsProcessingAlgorithm::FlagCustomException ) ? QString() : QObject::tr( "Error encountered while running %1" ).arg( child.description() );
+          throw QgsProcessingException( error );
         }
-      };
 
-      // prune remaining algorithms if they are dependent on a branch from this child which didn't eventuate
-      const QgsProcessingOutputDefinitions outputDefs = childAlg->outputDefinitions();
-      for ( const QgsProcessingOutputDefinition *outputDef : outputDefs )
-      {
-        if ( outputDef->type() == QgsProcessingOutputConditionalBranch::typeName() && !results.value( outputDef->name() ).toBool() )
+        if ( !streamingConsumer.isEmpty() )
         {
-          pruneAlgorithmBranchRecursive( childId, outputDef->name() );
+          // the features are processed while the consumer algorithm reads them, so the algorithm doesn't run now
+          if ( !upstreamPipeline )
+            upstreamPipeline = std::make_unique< QgsProcessingFeaturePipeline >();
+
+          std::unique_ptr< QgsProcessingFeatureBasedAlgorithm > featureAlg( static_cast< QgsProcessingFeatureBasedAlgorithm * >( childAlg.release() ) );
+          QVariantMap results;
+          results.insert( QStringLiteral( "OUTPUT" ), upstreamPipeline->appendStage( std::move( featureAlg ), childParams, context, &modelFeedback ) );
+          pendingPipelines[ streamingConsumer ] = std::move( upstreamPipeline );
+
+          childResults.insert( childId, results );
+          executed.insert( childId );
+          modelFeedback.setCurrentStep( executed.count() );
+          continue;
         }
-      }
 
-      if ( childAlg->flags() & QgsProcessingAlgorithm::FlagPruneModelBranchesBasedOnAlgorithmResults )
-      {
-        // check if any dependent algorithms should be canceled based on the outputs of this algorithm run
-        // first find all direct dependencies of this algorithm by looking through all remaining child algorithms
-        for ( const QString &candidateId : std::as_const( toExecute ) )
+        if ( upstreamPipeline )
         {
-          if ( executed.contains( candidateId ) )
-            continue;
+          if ( QgsProcessingFeatureBasedAlgorithm *featureAlg = dynamic_cast< QgsProcessingFeatureBasedAlgorithm * >( childAlg.get() ) )
+            featureAlg->setUpstreamPipeline( upstreamPipeline.get() );
+        }
 
-          // a pending algorithm was found..., check it's parameter sources to see if it links to any of the current
-          // algorithm's outputs
-          const QgsProcessingModelChildAlgorithm &candidate = mChildAlgorithms[ candidateId ];
-          const QMap<QString, QgsProcessingModelChildParameterSources> candidateParams = candidate.parameterSources();
-          QMap<QString, QgsProcessingModelChildParameterSources>::const_iterator paramIt = candidateParams.constBegin();
-          bool pruned = false;
-          for ( ; paramIt != candidateParams.constEnd(); ++paramIt )
+        if ( runningChild )
+        {
+          // one thread per processor, the other children wait for a running one to complete
+          while ( static_cast< int >( running.size() ) >= maxRunningChildren )
+            completeRunningChild( takeCompletedChild( true ) );
+
+          // run on a worker thread, while the model continues with the children which don't depend on this one
+          runningChild->algorithm = std::move( childAlg );
+          runningChild->time = childTime;
+          QgsProcessingModelRunningChild *runningChildPtr = runningChild.get();
+          runningChild->thread.reset( QThread::create( [runningChildPtr, childId, modelThread, &completed, &completedMutex, &waitLoop]
           {
-            for ( const QgsProcessingModelChildParameterSource &source : paramIt.value() )
+            try
             {
-              if ( source.source() == QgsProcessingModelChildParameterSource::ChildOutput && source.outputChildId() == childId )
-              {
-                // ok, this one is dependent on the current alg. Did we get a value for it?
-                if ( !results.contains( source.outputName() ) )
-                {
-                  // oh no, nothing returned for this parameter. Gotta trim the branch back!
-                  pruned = true;
-                  // skip the dependent alg..
-                  executed.insert( candidateId );
-                  //... and everything which depends on it
-                  pruneAlgorithmBranchRecursive( candidateId, QString() );
-                  break;
-                }
-              }
+              runningChildPtr->results = runningChildPtr->algorithm->runPrepared( runningChildPtr->parameters, *runningChildPtr->context, runningChildPtr->feedback.get() );
             }
-            if ( pruned )
-              break;
+            catch ( ... )
+            {
+              runningChildPtr->exception = std::current_exception();
+            }
+            runningChildPtr->context->pushToThread( modelThread );
+
+            {
+              QMutexLocker locker( &completedMutex );
+              completed.append( childId );
+            }
+            QMetaObject::invokeMethod( &waitLoop, "quit", Qt::QueuedConnection );
+          } ) );
+
+          runContext.pushToThread( runningChild->thread.get() );
+          runningChild->thread->start();
+          running[ childId ] = std::move( runningChild );
+          continue;
+        }
+
+        QVariantMap results;
+        try
+        {
+          if ( childAlg->flags() & QgsProcessingAlgorithm::FlagNoThreading )
+          {
+            // child algorithm run step must be called on main thread
+            auto runOnMainThread = [modelThread, &context, &modelFeedback, &results, &childAlg, &childParams]
+            {
+              Q_ASSERT_X( QThread::currentThread() == qApp->thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "childAlg->runPrepared() must be run on the main thread" );
+              results = childAlg->runPrepared( childParams, context, &modelFeedback );
+              context.pushToThread( modelThread );
+            };
+
+            if ( feedback && !skipGenericLogging && modelThread != qApp->thread() )
+              feedback->pushWarning( QObject::tr( "Algorithm “%1” cannot be run in a background thread, switching to main thread for this step" ).arg( childAlg->displayName() ) );
+
+            context.pushToThread( qApp->thread() );
+            QMetaObject::invokeMethod( qApp, runOnMainThread, Qt::BlockingQueuedConnection );
+          }
+          else
+          {
+            // safe to run on model thread
+            results = childAlg->runPrepared( childParams, context, &modelFeedback );
           }
         }
+        catch ( QgsProcessingException & )
+        {
+          const QString error = ( childAlg->flags() & QgsProcessingAlgorithm::FlagCustomException ) ? QString() : QObject::tr( "Error encountered while running %1" ).arg( child.description() );
+          throw QgsProcessingException( error );
+        }
+
+        Q_ASSERT_X( QThread::currentThread() == context.thread(), "QgsProcessingModelAlgorithm::processAlgorithm", "context was not transferred back to model thread" );
+
+        upstreamPipeline.reset();
+
+        completeChild( childId, std::move( childAlg ), results, context, skipGenericLogging, childTime.elapsed() );
       }
 
-      childAlg.reset( nullptr );
-      modelFeedback.setCurrentStep( executed.count() );
-      if ( feedback && !skipGenericLogging )
-        feedback->pushInfo( QObject::tr( "OK. Execution took %1 s (%n output(s)).", nullptr, results.count() ).arg( childTime.elapsed() / 1000.0 ) );
-    }
+      if ( feedback && feedback->isCanceled() )
+        break;
 
-    if ( feedback && feedback->isCanceled() )
-      break;
+      // complete the children which ran on the worker threads, waiting for one when no other child could start
+      for ( QString completedId = takeCompletedChild( !executedAlg && !running.empty() ); !completedId.isEmpty(); completedId = takeCompletedChild( false ) )
+      {
+        completeRunningChild( completedId );
+        executedAlg = true;
+      }
+    }
+  }
+  catch ( ... )
+  {
+    stopRunningChildren();
+    throw;
   }
+
+  // only left running when canceled
+  stopRunningChildren();
+
   if ( feedback )
     feedback->pushDebugInfo( QObject::tr( "Model processed OK. Executed %n algorithm(s) total in %1 s.", nullptr, executed.count() ).arg( totalTime.elapsed() / 1000.0 ) );
 
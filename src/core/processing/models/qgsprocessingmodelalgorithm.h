@@ -597,6 +597,15 @@ class CORE_EXPORT QgsProcessingModelAlgorithm : public QgsProcessingAlgorithm
      */
     bool childOutputIsRequired( const QString &childId, const QString &outputName ) const;
 
+    /**
+     * Returns the ID of the child algorithm the features output by the child algorithm \a childId
+     * can be streamed to, without writing them to a layer, or an empty string if there is none.
+     *
+     * This is the case when both are feature based algorithms and the features are only
+     * read by the child algorithm consuming them.
+     */
+    QString streamingConsumerForChildAlgorithm( const QString &childId, const QgsProcessingAlgorithm *algorithm ) const;
+
     /**
      * Checks whether the output vector type given by \a outputType is compatible
      * with the list of acceptable data types specified by \a acceptableDataTypes.
@@ -27,11 +27,16 @@
 #include "qgsmessagelog.h"
 #include "qgsvectorlayer.h"
 #include "qgsprocessingfeedback.h"
+#include "qgsprocessingfeaturepipeline.h"
 #include "qgsmeshlayer.h"
 #include "qgspointcloudlayer.h"
 #include "qgsexpressioncontextutils.h"
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+#include <exception>
 
 QgsProcessingAlgorithm::~QgsProcessingAlgorithm()
 {
@@ -1082,6 +1087,14 @@ QgsCoordinateReferenceSystem QgsProcessingFeatureBasedAlgorithm::sourceCrs() con
 QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   prepareSource( parameters, context );
+  if ( mUpstreamPipeline && !QgsProcessingFeaturePipeline::canStreamTo( request() ) )
+  {
+    // the features are fetched in order or filtered, so they must be stored in the source layer first
+    mUpstreamPipeline->materialize( context, feedback );
+    mUpstreamPipeline = nullptr;
+    prepareSource( parameters, context );
+  }
+
   QString dest;
   std::unique_ptr< QgsFeatureSink > sink( parameterAsSink( parameters, QStringLiteral( "OUTPUT" ), context, dest,
                                           outputFields( mSource->fields() ),
@@ -1098,27 +1111,57 @@ QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariant
   algContext.appendScopes( createExpressionContext( parameters, context, mSource.get() ).takeScopes() );
   context.setExpressionContext( algContext );
 
-  long count = mSource->featureCount();
-
-  QgsFeature f;
-  QgsFeatureIterator it = mSource->getFeatures( request(), sourceFlags() );
+  QgsFeatureIterator it;
+  std::function< bool( QgsFeature & ) > nextFeature;
+  std::function< double( long long ) > progress;
+  if ( mUpstreamPipeline )
+  {
+    // the features are streamed by the algorithms preceding this one in a model, the source is an empty layer
+    mUpstreamPipeline->start( feedback );
+    nextFeature = [this, feedback]( QgsFeature & f ) { return mUpstreamPipeline->nextFeature( f, feedback ); };
+    progress = [this]( long long ) { return mUpstreamPipeline->progress(); };
+  }
+  else
+  {
+    const long count = mSource->featureCount();
+    const double step = count > 0 ? 100.0 / count : 1;
+    it = mSource->getFeatures( request(), sourceFlags() );
+    nextFeature = [&it]( QgsFeature & f ) { return it.nextFeature( f ); };
+    progress = [step]( long long current ) { return current * step; };
+  }
 
-  double step = count > 0 ? 100.0 / count : 1;
-  int current = 0;
-  while ( it.nextFeature( f ) )
+  // thread safe algorithms process the features on the worker threads, the iteration and sink stay on this thread
+  const int threadCount = ( flags() & FlagSupportsParallelFeatureProcessing ) ? QThreadPool::globalInstance()->maxThreadCount() : 1;
+  if ( threadCount > 1 )
+  {
+    processFeaturesInParallel( nextFeature, progress, sink.get(), threadCount, context, feedback );
+  }
+  else
   {
-    if ( feedback->isCanceled() )
+    QgsFeature f;
+    long long current = 0;
+    while ( nextFeature( f ) )
     {
-      break;
-    }
+      if ( feedback->isCanceled() )
+      {
+        break;
+      }
 
-    context.expressionContext().setFeature( f );
-    const QgsFeatureList transformed = processFeature( f, context, feedback );
-    for ( QgsFeature transformedFeature : transformed )
-      sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+      context.expressionContext().setFeature( f );
+      const QgsFeatureList transformed = processFeature( f, context, feedback );
+      for ( QgsFeature transformedFeature : transformed )
+        sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
 
-    feedback->setProgress( current * step );
-    current++;
+      feedback->setProgress( progress( current ) );
+      current++;
+    }
+  }
+
+  if ( mUpstreamPipeline )
+  {
+    QgsProcessingFeaturePipeline *pipeline = mUpstreamPipeline;
+    mUpstreamPipeline = nullptr;
+    pipeline->finish( context );
   }
 
   mSource.reset();
@@ -1131,6 +1174,135 @@ QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariant
   return outputs;
 }
 
+///@cond PRIVATE
+
+// number of features processed at once by each worker thread
+constexpr int PARALLEL_PROCESSING_CHUNK_SIZE = 64;
+
+//! Features processed by a worker thread, with the context and feedback used for them
+struct QgsProcessingFeatureChunk
+{
+  QgsFeatureList features;
+  QVector< QgsFeatureList > outputs;
+  std::unique_ptr< QgsProcessingContext > context;
+  std::unique_ptr< QgsProcessingRecordingFeedback > feedback;
+  //! Exception thrown while processing the features after the outputs
+  std::exception_ptr exception;
+};
+
+///@endcond
+
+void QgsProcessingFeatureBasedAlgorithm::processFeaturesInParallel( const std::function< bool( QgsFeature & ) > &nextFeature, const std::function< double( long long ) > &progress,
+    QgsFeatureSink *sink, int threadCount, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  // the chunks of one set are processed by the worker threads while the other set is written to the sink
+  // and refilled, so at most two sets of features are held in memory and the order of the features is kept
+  std::vector< QgsProcessingFeatureChunk > chunkSets[2];
+  for ( std::vector< QgsProcessingFeatureChunk > &chunks : chunkSets )
+  {
+    chunks.resize( threadCount );
+    for ( QgsProcessingFeatureChunk &chunk : chunks )
+    {
+      chunk.context = std::make_unique< QgsProcessingContext >();
+      chunk.context->copyThreadSafeSettings( context );
+      chunk.feedback = std::make_unique< QgsProcessingRecordingFeedback >();
+      chunk.context->setFeedback( chunk.feedback.get() );
+      QObject::connect( feedback, &QgsFeedback::canceled, chunk.feedback.get(), &QgsFeedback::cancel, Qt::DirectConnection );
+    }
+  }
+
+  const auto fillChunks = [&nextFeature]( std::vector< QgsProcessingFeatureChunk > &chunks ) -> bool
+  {
+    bool hasFeatures = false;
+    QgsFeature f;
+    for ( QgsProcessingFeatureChunk &chunk : chunks )
+    {
+      chunk.features.clear();
+      while ( chunk.features.size() < PARALLEL_PROCESSING_CHUNK_SIZE && nextFeature( f ) )
+        chunk.features.append( f );
+      hasFeatures = hasFeatures || !chunk.features.isEmpty();
+    }
+    return hasFeatures;
+  };
+
+  const auto processChunk = [this]( QgsProcessingFeatureChunk &chunk )
+  {
+    chunk.outputs.clear();
+    chunk.outputs.reserve( chunk.features.size() );
+    chunk.exception = nullptr;
+    for ( const QgsFeature &f : std::as_const( chunk.features ) )
+    {
+      if ( chunk.feedback->isCanceled() )
+        break;
+
+      chunk.context->expressionContext().setFeature( f );
+      try
+      {
+        chunk.outputs.append( processFeature( f, *chunk.context, chunk.feedback.get() ) );
+      }
+      catch ( ... )
+      {
+        // rethrown from the algorithm thread once the outputs of the previous features are written
+        chunk.exception = std::current_exception();
+        break;
+      }
+    }
+  };
+
+  long long current = 0;
+  const auto writeChunks = [sink, feedback, &progress, &current]( std::vector< QgsProcessingFeatureChunk > &chunks ) -> std::exception_ptr
+  {
+    for ( QgsProcessingFeatureChunk &chunk : chunks )
+    {
+      chunk.feedback->report( feedback );
+      for ( const QgsFeatureList &outputs : std::as_const( chunk.outputs ) )
+      {
+        for ( QgsFeature transformedFeature : outputs )
+          sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+
+        feedback->setProgress( progress( current ) );
+        current++;
+      }
+      chunk.outputs.clear();
+      if ( chunk.exception )
+        return chunk.exception;
+    }
+    return nullptr;
+  };
+
+  std::vector< QgsProcessingFeatureChunk > *processing = &chunkSets[0];
+  std::vector< QgsProcessingFeatureChunk > *processed = &chunkSets[1];
+  bool hasFeatures = fillChunks( *processing );
+  QFuture< void > future;
+  if ( hasFeatures )
+    future = QtConcurrent::map( *processing, processChunk );
+
+  while ( hasFeatures )
+  {
+    // read the next features while the current ones are processed
+    const bool hasNextFeatures = !feedback->isCanceled() && fillChunks( *processed );
+    future.waitForFinished();
+
+    std::swap( processing, processed );
+    if ( hasNextFeatures )
+      future = QtConcurrent::map( *processing, processChunk );
+
+    if ( const std::exception_ptr exception = writeChunks( *processed ) )
+    {
+      future.waitForFinished();
+      std::rethrow_exception( exception );
+    }
+    hasFeatures = hasNextFeatures;
+  }
+
+  // e.g. layers created while processing the features
+  for ( std::vector< QgsProcessingFeatureChunk > &chunks : chunkSets )
+  {
+    for ( QgsProcessingFeatureChunk &chunk : chunks )
+      context.takeResultsFrom( *chunk.context );
+  }
+}
+
 QgsFeatureRequest QgsProcessingFeatureBasedAlgorithm::request() const
 {
   return QgsFeatureRequest();
@@ -28,11 +28,13 @@
 #include <QString>
 #include <QVariant>
 #include <QIcon>
+#include <functional>
 
 class QgsProcessingProvider;
 class QgsProcessingFeedback;
 class QgsFeatureSink;
 class QgsProcessingModelAlgorithm;
+class QgsProcessingFeaturePipeline;
 class QgsProcessingAlgorithmConfigurationWidget;
 class QgsMeshLayer;
 class QgsPointCloudLayer;
@@ -82,6 +84,7 @@ class CORE_EXPORT QgsProcessingAlgorithm
       FlagSkipGenericModelLogging = 1 << 12, //!< When running as part of a model, the generic algorithm setup and results logging should be skipped
       FlagNotAvailableInStandaloneTool = 1 << 13, //!< Algorithm should not be available from the standalone "qgis_process" tool. Used to flag algorithms which make no sense outside of the QGIS application, such as "select by..." style algorithms.
       FlagRequiresProject = 1 << 14, //!< The algorithm requires that a valid QgsProject is available from the processing context in order to execute
+      FlagSupportsParallelFeatureProcessing = 1 << 15, //!< The processFeature() implementation of the QgsProcessingFeatureBasedAlgorithm is thread safe, and features can be processed in parallel on worker threads (since QGIS 3.30)
       FlagDeprecated = FlagHideFromToolbox | FlagHideFromModeler, //!< Algorithm is deprecated
     };
     Q_DECLARE_FLAGS( Flags, Flag )
@@ -1133,9 +1136,10 @@ Q_DECLARE_OPERATORS_FOR_FLAGS( QgsProcessingAlgorithm::Flags )
  *
  * Using QgsProcessingFeatureBasedAlgorithm as the base class for feature based algorithms allows
  * shortcutting much of the common algorithm code for handling iterating over sources and pushing
- * features to output sinks. It also allows the algorithm execution to be optimised in future
- * (for instance allowing automatic multi-thread processing of the algorithm, or use of the
- * algorithm in "chains", avoiding the need for temporary outputs in multi-step models).
+ * features to output sinks. It also allows the algorithm execution to be optimised, e.g. by
+ * processing the features on multiple threads (see QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing)
+ * or by chaining the algorithm with the other feature based algorithms of a model, avoiding the need
+ * for temporary outputs in multi-step models.
  *
  * \since QGIS 3.0
  */
@@ -1173,9 +1177,27 @@ class CORE_EXPORT QgsProcessingFeatureBasedAlgorithm : public QgsProcessingAlgor
      * prevent the algorithm execution from continuing. This can be annoying for users though as it
      * can break valid model execution - so use with extreme caution, and consider using
      * \a feedback to instead report non-fatal processing failures for features instead.
+     *
+     * If the algorithm flags() include QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing,
+     * this method is called concurrently from several threads, each with its own \a context
+     * and \a feedback objects. The outputs are still added to the sink in the order of the source
+     * features, and messages pushed to the \a feedback are reported in the same order.
      */
     virtual QgsFeatureList processFeature( const QgsFeature &feature, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) SIP_THROW( QgsProcessingException ) = 0 SIP_VIRTUALERRORHANDLER( processing_exception_handler );
 
+    /**
+     * Sets the \a pipeline streaming the features to process in place of the features of the source.
+     *
+     * This is used by models to chain feature based algorithms without writing their outputs to
+     * temporary layers. The source of the algorithm must be the layer returned by
+     * QgsProcessingFeaturePipeline::appendStage() for the last stage of the \a pipeline.
+     * Ownership is not transferred, and the pipeline is only used by the next run of the algorithm.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    void setUpstreamPipeline( QgsProcessingFeaturePipeline *pipeline ) SIP_SKIP { mUpstreamPipeline = pipeline; }
+
   protected:
 
     void initAlgorithm( const QVariantMap &configuration = QVariantMap() ) override;
@@ -1307,8 +1329,21 @@ class CORE_EXPORT QgsProcessingFeatureBasedAlgorithm : public QgsProcessingAlgor
 
   private:
 
+    /**
+     * Processes the features read by \a nextFeature in parallel on \a threadCount threads, adding the
+     * outputs to the \a sink in the order of the features.
+     *
+     * The \a progress function returns the progress after reading the given count of features.
+     */
+    void processFeaturesInParallel( const std::function< bool( QgsFeature & ) > &nextFeature, const std::function< double( long long ) > &progress,
+                                    QgsFeatureSink *sink, int threadCount, QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+
     std::unique_ptr< QgsProcessingFeatureSource > mSource;
 
+    QgsProcessingFeaturePipeline *mUpstreamPipeline = nullptr;
+
+    friend class QgsProcessingFeaturePipeline;
+
 };
 
 // clazy:excludeall=qstring-allocations
@@ -16,6 +16,12 @@
  ***************************************************************************/
 
 #include "qgsprocessingbatch.h"
+#include "qgsprocessingalgorithm.h"
+#include "qgsprocessingalgrunnertask.h"
+#include "qgsprocessingcontext.h"
+#include "qgsapplication.h"
+
+#include <QThread>
 
 QgsProcessingBatchFeedback::QgsProcessingBatchFeedback( int tasks, QgsProcessingFeedback *feedback )
   :  QgsProcessingMultiStepFeedback( tasks, feedback )
@@ -35,3 +41,365 @@ QStringList QgsProcessingBatchFeedback::popErrors()
   mErrors.clear();
   return res;
 }
+
+//
+// QgsProcessingBatchRowFeedback
+//
+
+QgsProcessingBatchRowFeedback::QgsProcessingBatchRowFeedback()
+  : QgsProcessingFeedback( false )
+{
+
+}
+
+void QgsProcessingBatchRowFeedback::setProgressText( const QString &text )
+{
+  addMessage( MessageType::ProgressText, text );
+  QgsProcessingFeedback::setProgressText( text );
+}
+
+void QgsProcessingBatchRowFeedback::reportError( const QString &error, bool fatalError )
+{
+  {
+    const QMutexLocker locker( &mMutex );
+    mErrors.append( error );
+  }
+  addMessage( fatalError ? MessageType::FatalError : MessageType::Error, error );
+  QgsProcessingFeedback::reportError( error, fatalError );
+}
+
+void QgsProcessingBatchRowFeedback::pushWarning( const QString &warning )
+{
+  addMessage( MessageType::Warning, warning );
+  QgsProcessingFeedback::pushWarning( warning );
+}
+
+void QgsProcessingBatchRowFeedback::pushInfo( const QString &info )
+{
+  addMessage( MessageType::Info, info );
+  QgsProcessingFeedback::pushInfo( info );
+}
+
+void QgsProcessingBatchRowFeedback::pushCommandInfo( const QString &info )
+{
+  addMessage( MessageType::CommandInfo, info );
+  QgsProcessingFeedback::pushCommandInfo( info );
+}
+
+void QgsProcessingBatchRowFeedback::pushDebugInfo( const QString &info )
+{
+  addMessage( MessageType::DebugInfo, info );
+  QgsProcessingFeedback::pushDebugInfo( info );
+}
+
+void QgsProcessingBatchRowFeedback::pushConsoleInfo( const QString &info )
+{
+  addMessage( MessageType::ConsoleInfo, info );
+  QgsProcessingFeedback::pushConsoleInfo( info );
+}
+
+QStringList QgsProcessingBatchRowFeedback::errors() const
+{
+  const QMutexLocker locker( &mMutex );
+  return mErrors;
+}
+
+void QgsProcessingBatchRowFeedback::replay( QgsProcessingFeedback *feedback ) const
+{
+  if ( !feedback )
+    return;
+
+  QList< QPair< MessageType, QString > > messages;
+  {
+    const QMutexLocker locker( &mMutex );
+    messages = mMessages;
+  }
+
+  for ( const QPair< MessageType, QString > &message : std::as_const( messages ) )
+  {
+    switch ( message.first )
+    {
+      case MessageType::ProgressText:
+        feedback->setProgressText( message.second );
+        break;
+      case MessageType::Error:
+        feedback->reportError( message.second, false );
+        break;
+      case MessageType::FatalError:
+        feedback->reportError( message.second, true );
+        break;
+      case MessageType::Warning:
+        feedback->pushWarning( message.second );
+        break;
+      case MessageType::Info:
+        feedback->pushInfo( message.second );
+        break;
+      case MessageType::CommandInfo:
+        feedback->pushCommandInfo( message.second );
+        break;
+      case MessageType::DebugInfo:
+        feedback->pushDebugInfo( message.second );
+        break;
+      case MessageType::ConsoleInfo:
+        feedback->pushConsoleInfo( message.second );
+        break;
+    }
+  }
+}
+
+void QgsProcessingBatchRowFeedback::addMessage( MessageType type, const QString &message )
+{
+  const QMutexLocker locker( &mMutex );
+  mMessages.append( qMakePair( type, message ) );
+}
+
+//
+// QgsProcessingBatchExecutor
+//
+
+QgsProcessingBatchExecutor::QgsProcessingBatchExecutor( const QgsProcessingAlgorithm *algorithm, const QList<QVariantMap> &parameters,
+    const ContextFactory &contextFactory, QObject *parent )
+  : QObject( parent )
+  , mAlgorithm( algorithm )
+  , mContextFactory( contextFactory )
+  , mRows( parameters.size() )
+  , mMaximumConcurrentRows( std::max( 1, QThread::idealThreadCount() ) )
+{
+  for ( int row = 0; row < parameters.size(); ++row )
+    mRows[row].parameters = parameters.at( row );
+}
+
+QgsProcessingBatchExecutor::~QgsProcessingBatchExecutor()
+{
+  // the tasks refer to the contexts and feedback objects of their rows, so they must not outlive them
+  for ( Row &row : mRows )
+  {
+    if ( row.task )
+    {
+      disconnect( row.task, nullptr, this, nullptr );
+      row.task->cancel();
+      row.task->waitForFinished( -1 );
+    }
+  }
+}
+
+void QgsProcessingBatchExecutor::setMaximumConcurrentRows( int rows )
+{
+  mMaximumConcurrentRows = std::max( 1, rows );
+}
+
+void QgsProcessingBatchExecutor::start( QgsProcessingFeedback *feedback )
+{
+  if ( mStarted )
+    return;
+
+  mStarted = true;
+  mFeedback = feedback;
+  if ( mFeedback )
+    connect( mFeedback, &QgsFeedback::canceled, this, &QgsProcessingBatchExecutor::cancel );
+
+  startRows();
+}
+
+void QgsProcessingBatchExecutor::cancel()
+{
+  if ( mCanceled || mFinished )
+    return;
+
+  mCanceled = true;
+  for ( Row &row : mRows )
+  {
+    if ( row.state != RowState::Running )
+      continue;
+
+    if ( row.task )
+      row.task->cancel();
+    else if ( row.feedback )
+      row.feedback->cancel();
+  }
+
+  reportRows();
+}
+
+QVariantMap QgsProcessingBatchExecutor::rowParameters( int row ) const
+{
+  if ( row < 0 || row >= rowCount() )
+    return QVariantMap();
+
+  return mRows[row].parameters;
+}
+
+QgsProcessingContext *QgsProcessingBatchExecutor::rowContext( int row ) const
+{
+  if ( row < 0 || row >= rowCount() )
+    return nullptr;
+
+  return mRows[row].context.get();
+}
+
+QgsProcessingBatchRowFeedback *QgsProcessingBatchExecutor::rowFeedback( int row ) const
+{
+  if ( row < 0 || row >= rowCount() )
+    return nullptr;
+
+  return mRows[row].feedback.get();
+}
+
+double QgsProcessingBatchExecutor::rowElapsedSeconds( int row ) const
+{
+  if ( row < 0 || row >= rowCount() )
+    return 0;
+
+  return mRows[row].elapsed / 1000.0;
+}
+
+bool QgsProcessingBatchExecutor::canStartRow() const
+{
+  if ( mCanceled || mNextRow >= rowCount() )
+    return false;
+
+  const bool threaded = !( mAlgorithm->flags() & QgsProcessingAlgorithm::FlagNoThreading );
+  const int maxRunning = threaded ? mMaximumConcurrentRows : 1;
+  if ( mRunningRows >= maxRunning )
+    return false;
+
+  // finished rows keep their contexts (and any layers they hold) until they are reported, so
+  // don't let the started rows run too far ahead of a slow row which has still to be reported
+  return mNextRow - mNextReportRow < 2 * maxRunning;
+}
+
+void QgsProcessingBatchExecutor::startRows()
+{
+  // rows of non-threaded algorithms complete from within startRow(), so guard against
+  // starting rows recursively from rowCompleted()
+  if ( mStartingRows )
+    return;
+
+  mStartingRows = true;
+  // reporting rows may allow further rows to start
+  reportRows();
+  while ( canStartRow() )
+  {
+    startRow( mNextRow++ );
+    reportRows();
+  }
+  mStartingRows = false;
+}
+
+void QgsProcessingBatchExecutor::startRow( int rowIndex )
+{
+  Row &row = mRows[rowIndex];
+  row.state = RowState::Running;
+  mRunningRows++;
+
+  row.feedback = std::make_unique< QgsProcessingBatchRowFeedback >();
+  connect( row.feedback.get(), &QgsFeedback::progressChanged, this, [this, rowIndex]( double progress )
+  {
+    if ( mRows[rowIndex].state != RowState::Running )
+      return;
+
+    mRows[rowIndex].progress = progress;
+    updateProgress();
+  } );
+
+  // important - each row gets a new context
+  // this avoids holding onto resources and layers from earlier rows,
+  // and allows rows to run concurrently without sharing their contexts
+  row.context.reset( mContextFactory( rowIndex, row.feedback.get() ) );
+  row.parameters = mAlgorithm->preprocessParameters( row.parameters );
+  row.timer.start();
+
+  if ( !( mAlgorithm->flags() & QgsProcessingAlgorithm::FlagNoThreading ) )
+  {
+    QgsProcessingAlgRunnerTask *task = new QgsProcessingAlgRunnerTask( mAlgorithm, row.parameters, *row.context, row.feedback.get(), QgsTask::CanCancel | QgsTask::Hidden );
+    if ( task->algorithmCanceled() )
+    {
+      delete task;
+      rowCompleted( rowIndex, false, QVariantMap() );
+      return;
+    }
+
+    row.task = task;
+    connect( task, &QgsProcessingAlgRunnerTask::executed, this, [this, rowIndex]( bool successful, const QVariantMap &results )
+    {
+      mRows[rowIndex].task = nullptr;
+      rowCompleted( rowIndex, successful, results );
+    } );
+    QgsApplication::taskManager()->addTask( task );
+  }
+  else
+  {
+    // have to execute in main thread, no tasks allowed
+    bool ok = false;
+    const QVariantMap results = mAlgorithm->run( row.parameters, *row.context, row.feedback.get(), &ok );
+    rowCompleted( rowIndex, ok, results );
+  }
+}
+
+void QgsProcessingBatchExecutor::rowCompleted( int rowIndex, bool successful, const QVariantMap &results )
+{
+  Row &row = mRows[rowIndex];
+  row.state = RowState::Finished;
+  row.canceled = mCanceled && !successful;
+  row.successful = successful && !row.canceled;
+  row.results = results;
+  row.elapsed = row.timer.elapsed();
+  mRunningRows--;
+
+  updateProgress();
+  startRows();
+}
+
+void QgsProcessingBatchExecutor::reportRows()
+{
+  // slots connected to rowFinished() may cancel the batch, which reports rows again
+  if ( mFinished || mReportingRows )
+    return;
+
+  mReportingRows = true;
+  while ( mNextReportRow < rowCount() && mRows[mNextReportRow].state == RowState::Finished )
+  {
+    const int rowIndex = mNextReportRow++;
+    Row &row = mRows[rowIndex];
+
+    row.state = RowState::Reported;
+    // canceled rows are not reported, they just stop the batch
+    if ( !row.canceled )
+      emit rowFinished( rowIndex, row.successful, row.results );
+
+    row.results.clear();
+    row.context.reset();
+    row.feedback.reset();
+  }
+  mReportingRows = false;
+
+  if ( mNextReportRow == rowCount() || ( mCanceled && mRunningRows == 0 ) )
+  {
+    mFinished = true;
+    emit finished( mCanceled );
+  }
+}
+
+void QgsProcessingBatchExecutor::updateProgress()
+{
+  if ( !mFeedback || mRows.empty() )
+    return;
+
+  double progress = 0;
+  for ( const Row &row : mRows )
+  {
+    switch ( row.state )
+    {
+      case RowState::Queued:
+        break;
+      case RowState::Running:
+        progress += row.progress;
+        break;
+      case RowState::Finished:
+      case RowState::Reported:
+        progress += 100;
+        break;
+    }
+  }
+  mFeedback->setProgress( progress / static_cast< double >( mRows.size() ) );
+}
@@ -23,6 +23,17 @@
 
 #include "qgsprocessingfeedback.h"
 
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QPointer>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class QgsProcessingAlgorithm;
+class QgsProcessingAlgRunnerTask;
+class QgsProcessingContext;
+
 /**
  * \class QgsProcessingBatchFeedback
  * \ingroup core
@@ -54,6 +65,239 @@ class CORE_EXPORT QgsProcessingBatchFeedback : public QgsProcessingMultiStepFeed
     QStringList mErrors;
 };
 
+#ifndef SIP_RUN
+
+/**
+ * \class QgsProcessingBatchRowFeedback
+ * \ingroup core
+ * \brief Processing feedback subclass for a single row of a batch run by QgsProcessingBatchExecutor.
+ *
+ * Rows run concurrently, so the messages reported by a row are kept by this feedback object
+ * until the row is reported, and can then be replayed in row order into another
+ * feedback object.
+ *
+ * \note Not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsProcessingBatchRowFeedback : public QgsProcessingFeedback
+{
+    Q_OBJECT
+
+  public:
+
+    /**
+     * Constructor for QgsProcessingBatchRowFeedback.
+     */
+    QgsProcessingBatchRowFeedback();
+
+    void setProgressText( const QString &text ) override;
+    void reportError( const QString &error, bool fatalError = false ) override;
+    void pushWarning( const QString &warning ) override;
+    void pushInfo( const QString &info ) override;
+    void pushCommandInfo( const QString &info ) override;
+    void pushDebugInfo( const QString &info ) override;
+    void pushConsoleInfo( const QString &info ) override;
+
+    /**
+     * Returns the errors reported by the row.
+     */
+    QStringList errors() const;
+
+    /**
+     * Pushes all messages reported by the row to the specified \a feedback, in the order
+     * they were reported.
+     */
+    void replay( QgsProcessingFeedback *feedback ) const;
+
+  private:
+
+    enum class MessageType
+    {
+      ProgressText,
+      Error,
+      FatalError,
+      Warning,
+      Info,
+      CommandInfo,
+      DebugInfo,
+      ConsoleInfo,
+    };
+
+    void addMessage( MessageType type, const QString &message );
+
+    mutable QMutex mMutex;
+    QList< QPair< MessageType, QString > > mMessages;
+    QStringList mErrors;
+};
+
+/**
+ * \class QgsProcessingBatchExecutor
+ * \ingroup core
+ * \brief Runs the rows of a batch of a processing algorithm, running several rows concurrently
+ * when the algorithm is thread safe.
+ *
+ * Each row is run by a QgsProcessingAlgRunnerTask, using a processing context created for the row
+ * by a context factory and its own QgsProcessingBatchRowFeedback. Up to maximumConcurrentRows() rows
+ * are run at the same time, while algorithms with the QgsProcessingAlgorithm::FlagNoThreading flag
+ * are run one row at a time in the main thread.
+ *
+ * Rows are reported by the rowFinished() signal strictly in row order, regardless of the order in
+ * which they complete. The context and feedback of a row are available from the slots connected
+ * to rowFinished() and are destroyed after the row has been reported.
+ *
+ * \note Not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsProcessingBatchExecutor : public QObject
+{
+    Q_OBJECT
+
+  public:
+
+    /**
+     * Creates a new processing context for the specified \a row of the batch, using the
+     * row's \a feedback. Ownership of the returned context is transferred to the executor.
+     */
+    typedef std::function< QgsProcessingContext *( int row, QgsProcessingFeedback *feedback ) > ContextFactory;
+
+    /**
+     * Constructor for QgsProcessingBatchExecutor, for running the \a algorithm once for
+     * each of the entries in the \a parameters list.
+     *
+     * The \a contextFactory is called in the main thread just before a row is started.
+     *
+     * The \a algorithm must exist for the lifetime of the executor.
+     */
+    QgsProcessingBatchExecutor( const QgsProcessingAlgorithm *algorithm, const QList< QVariantMap > &parameters,
+                                const ContextFactory &contextFactory, QObject *parent = nullptr );
+    ~QgsProcessingBatchExecutor() override;
+
+    /**
+     * Sets the maximum number of \a rows which are run at the same time.
+     *
+     * This must be called before start(). The default is QThread::idealThreadCount().
+     *
+     * \see maximumConcurrentRows()
+     */
+    void setMaximumConcurrentRows( int rows );
+
+    /**
+     * Returns the maximum number of rows which are run at the same time.
+     *
+     * \see setMaximumConcurrentRows()
+     */
+    int maximumConcurrentRows() const { return mMaximumConcurrentRows; }
+
+    /**
+     * Returns the number of rows in the batch.
+     */
+    int rowCount() const { return static_cast< int >( mRows.size() ); }
+
+    /**
+     * Starts running the batch. The overall progress of the batch is reported to \a feedback,
+     * and canceling \a feedback cancels the batch.
+     */
+    void start( QgsProcessingFeedback *feedback );
+
+    /**
+     * Cancels the batch. Running rows are canceled and no further rows are started.
+     */
+    void cancel();
+
+    /**
+     * Returns TRUE if the batch was canceled.
+     */
+    bool isCanceled() const { return mCanceled; }
+
+    /**
+     * Returns the parameters used to run the specified \a row, after preprocessing by the algorithm.
+     */
+    QVariantMap rowParameters( int row ) const;
+
+    /**
+     * Returns the processing context of the specified \a row, or NULLPTR if the row
+     * has not been started or has already been reported.
+     */
+    QgsProcessingContext *rowContext( int row ) const;
+
+    /**
+     * Returns the feedback of the specified \a row, or NULLPTR if the row
+     * has not been started or has already been reported.
+     */
+    QgsProcessingBatchRowFeedback *rowFeedback( int row ) const;
+
+    /**
+     * Returns the time in seconds taken to run the specified \a row.
+     */
+    double rowElapsedSeconds( int row ) const;
+
+  signals:
+
+    /**
+     * Emitted when the specified \a row has finished running. Rows are reported in row order.
+     *
+     * If the row was run without errors then \a successful will be TRUE. The \a results argument
+     * contains the results reported by the algorithm.
+     */
+    void rowFinished( int row, bool successful, const QVariantMap &results );
+
+    /**
+     * Emitted when all rows have been reported, or when the batch was canceled and
+     * all running rows have stopped.
+     *
+     * \warning The executor must not be deleted directly from slots connected to its signals,
+     * use QObject::deleteLater() instead.
+     */
+    void finished( bool canceled );
+
+  private:
+
+    enum class RowState
+    {
+      Queued,
+      Running,
+      Finished,
+      Reported,
+    };
+
+    struct Row
+    {
+      QVariantMap parameters;
+      std::unique_ptr< QgsProcessingContext > context;
+      std::unique_ptr< QgsProcessingBatchRowFeedback > feedback;
+      QPointer< QgsProcessingAlgRunnerTask > task;
+      RowState state = RowState::Queued;
+      bool successful = false;
+      bool canceled = false;
+      QVariantMap results;
+      double progress = 0;
+      QElapsedTimer timer;
+      qint64 elapsed = 0;
+    };
+
+    bool canStartRow() const;
+    void startRows();
+    void startRow( int row );
+    void rowCompleted( int row, bool successful, const QVariantMap &results );
+    void reportRows();
+    void updateProgress();
+
+    const QgsProcessingAlgorithm *mAlgorithm = nullptr;
+    ContextFactory mContextFactory;
+    std::vector< Row > mRows;
+    int mMaximumConcurrentRows = 1;
+    QPointer< QgsProcessingFeedback > mFeedback;
+    int mNextRow = 0;
+    int mNextReportRow = 0;
+    int mRunningRows = 0;
+    bool mStarted = false;
+    bool mFinished = false;
+    bool mCanceled = false;
+    bool mStartingRows = false;
+    bool mReportingRows = false;
+};
+
+#endif
 
 #endif // QGSPROCESSINGBATCH_H
 
@@ -0,0 +1,413 @@
+/***************************************************************************
+                         qgsprocessingfeaturepipeline.cpp
+                         --------------------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsprocessingfeaturepipeline.h"
+#include "qgsprocessingalgorithm.h"
+#include "qgsprocessingcontext.h"
+#include "qgsmemoryproviderutils.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectordataprovider.h"
+
+#include <QMutexLocker>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+
+///@cond PRIVATE
+
+// number of features passed at once between two stages
+constexpr int PIPELINE_CHUNK_SIZE = 64;
+
+// number of chunks a stage can process ahead of the next stage
+constexpr int PIPELINE_QUEUE_CAPACITY = 8;
+
+//
+// QgsProcessingRecordingFeedback
+//
+
+QgsProcessingRecordingFeedback::QgsProcessingRecordingFeedback()
+  : QgsProcessingFeedback( false )
+{
+}
+
+void QgsProcessingRecordingFeedback::reportError( const QString &error, bool fatalError )
+{
+  mMessages.append( { Message::Error, error, fatalError } );
+}
+
+void QgsProcessingRecordingFeedback::pushWarning( const QString &warning )
+{
+  mMessages.append( { Message::Warning, warning, false } );
+}
+
+void QgsProcessingRecordingFeedback::pushInfo( const QString &info )
+{
+  mMessages.append( { Message::Info, info, false } );
+}
+
+void QgsProcessingRecordingFeedback::pushCommandInfo( const QString &info )
+{
+  mMessages.append( { Message::CommandInfo, info, false } );
+}
+
+void QgsProcessingRecordingFeedback::pushDebugInfo( const QString &info )
+{
+  mMessages.append( { Message::DebugInfo, info, false } );
+}
+
+void QgsProcessingRecordingFeedback::pushConsoleInfo( const QString &info )
+{
+  mMessages.append( { Message::ConsoleInfo, info, false } );
+}
+
+QVector<QgsProcessingRecordingFeedback::Message> QgsProcessingRecordingFeedback::takeMessages()
+{
+  QVector< Message > messages;
+  messages.swap( mMessages );
+  return messages;
+}
+
+void QgsProcessingRecordingFeedback::report( QgsProcessingFeedback *feedback )
+{
+  report( mMessages, feedback );
+  mMessages.clear();
+}
+
+void QgsProcessingRecordingFeedback::report( const QVector<Message> &messages, QgsProcessingFeedback *feedback )
+{
+  for ( const Message &message : messages )
+  {
+    switch ( message.type )
+    {
+      case Message::Error:
+        feedback->reportError( message.text, message.fatalError );
+        break;
+      case Message::Warning:
+        feedback->pushWarning( message.text );
+        break;
+      case Message::Info:
+        feedback->pushInfo( message.text );
+        break;
+      case Message::CommandInfo:
+        feedback->pushCommandInfo( message.text );
+        break;
+      case Message::DebugInfo:
+        feedback->pushDebugInfo( message.text );
+        break;
+      case Message::ConsoleInfo:
+        feedback->pushConsoleInfo( message.text );
+        break;
+    }
+  }
+}
+
+//
+// QgsProcessingFeatureQueue
+//
+
+QgsProcessingFeatureQueue::QgsProcessingFeatureQueue( int capacity )
+  : mCapacity( std::max( capacity, 1 ) )
+{
+}
+
+bool QgsProcessingFeatureQueue::push( Chunk &&chunk )
+{
+  QMutexLocker locker( &mMutex );
+  while ( !mAborted && static_cast< int >( mChunks.size() ) >= mCapacity )
+    mNotFull.wait( &mMutex );
+
+  if ( mAborted )
+    return false;
+
+  mChunks.emplace_back( std::move( chunk ) );
+  mNotEmpty.wakeOne();
+  return true;
+}
+
+bool QgsProcessingFeatureQueue::pop( Chunk &chunk )
+{
+  QMutexLocker locker( &mMutex );
+  while ( !mAborted && !mFinished && mChunks.empty() )
+    mNotEmpty.wait( &mMutex );
+
+  if ( mAborted || mChunks.empty() )
+    return false;
+
+  chunk = std::move( mChunks.front() );
+  mChunks.pop_front();
+  mNotFull.wakeOne();
+  return true;
+}
+
+void QgsProcessingFeatureQueue::finish()
+{
+  QMutexLocker locker( &mMutex );
+  mFinished = true;
+  mNotEmpty.wakeAll();
+}
+
+void QgsProcessingFeatureQueue::abort()
+{
+  QMutexLocker locker( &mMutex );
+  mAborted = true;
+  mChunks.clear();
+  mNotEmpty.wakeAll();
+  mNotFull.wakeAll();
+}
+
+//
+// QgsProcessingFeaturePipeline
+//
+
+QgsProcessingFeaturePipeline::~QgsProcessingFeaturePipeline()
+{
+  stop();
+}
+
+bool QgsProcessingFeaturePipeline::canStream( const QgsProcessingFeatureBasedAlgorithm *algorithm )
+{
+  // the stages run on background threads, and the output is the only result of a streamed algorithm
+  return !( algorithm->flags() & QgsProcessingAlgorithm::FlagNoThreading )
+         && !( algorithm->flags() & QgsProcessingAlgorithm::FlagPruneModelBranchesBasedOnAlgorithmResults )
+         && algorithm->outputDefinitions().size() == 1;
+}
+
+bool QgsProcessingFeaturePipeline::canStreamTo( const QgsFeatureRequest &request )
+{
+  return request.filterType() == QgsFeatureRequest::FilterNone
+         && request.spatialFilterType() == Qgis::SpatialFilterType::NoFilter
+         && request.orderBy().isEmpty()
+         && request.limit() < 0;
+}
+
+QString QgsProcessingFeaturePipeline::inputParameterName( const QgsProcessingFeatureBasedAlgorithm *algorithm )
+{
+  return algorithm->inputParameterName();
+}
+
+QString QgsProcessingFeaturePipeline::appendStage( std::unique_ptr<QgsProcessingFeatureBasedAlgorithm> algorithm, const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  if ( !mStages.empty() && !canStreamTo( algorithm->request() ) )
+  {
+    // the algorithm reads ordered or filtered features, so the features of the previous stages are stored first
+    materialize( context, feedback );
+  }
+
+  algorithm->prepareSource( parameters, context );
+
+  Stage stage;
+  stage.context = std::make_unique< QgsProcessingContext >();
+  stage.context->copyThreadSafeSettings( context );
+  stage.feedback = std::make_unique< QgsProcessingRecordingFeedback >();
+  stage.context->setFeedback( stage.feedback.get() );
+
+  QgsExpressionContext expressionContext = context.expressionContext();
+  expressionContext.appendScopes( algorithm->createExpressionContext( parameters, context, algorithm->mSource.get() ).takeScopes() );
+  stage.context->setExpressionContext( expressionContext );
+
+  if ( mStages.empty() )
+    mFeatureCount = algorithm->mSource->featureCount();
+
+  stage.outputFields = algorithm->outputFields( algorithm->mSource->fields() );
+  std::unique_ptr< QgsVectorLayer > layer( QgsMemoryProviderUtils::createMemoryLayer( algorithm->outputName(), stage.outputFields,
+      algorithm->outputWkbType( algorithm->mSource->wkbType() ),
+      algorithm->outputCrs( algorithm->mSource->sourceCrs() ), false ) );
+  stage.outputLayer = layer.get();
+  const QString layerId = layer->id();
+  context.temporaryLayerStore()->addMapLayer( layer.release() );
+
+  stage.algorithm = std::move( algorithm );
+  mStages.emplace_back( std::move( stage ) );
+  return layerId;
+}
+
+void QgsProcessingFeaturePipeline::start( QgsProcessingFeedback *feedback )
+{
+  if ( mStages.empty() )
+    return;
+
+  const Stage &head = mStages.front();
+  mIterator = head.algorithm->mSource->getFeatures( head.algorithm->request(), head.algorithm->sourceFlags() );
+
+  mQueues.clear();
+  for ( Stage &stage : mStages )
+  {
+    mQueues.emplace_back( std::make_unique< QgsProcessingFeatureQueue >( PIPELINE_QUEUE_CAPACITY ) );
+    if ( feedback )
+      QObject::connect( feedback, &QgsFeedback::canceled, stage.feedback.get(), &QgsFeedback::cancel, Qt::DirectConnection );
+  }
+
+  // every stage waits for the previous one, so they all need their own thread
+  mThreadPool.setMaxThreadCount( stageCount() );
+  for ( int i = 0; i < stageCount(); ++i )
+    mFutures << QtConcurrent::run( &mThreadPool, [this, i, feedback] { runStage( i, feedback ); } );
+}
+
+bool QgsProcessingFeaturePipeline::nextFeature( QgsFeature &feature, QgsProcessingFeedback *feedback )
+{
+  if ( mQueues.empty() )
+    return false;
+
+  while ( mChunkIndex >= mChunk.features.size() )
+  {
+    if ( !mQueues.back()->pop( mChunk ) )
+      return false;
+
+    mChunkIndex = 0;
+    mSourceCount += mChunk.sourceCount;
+    if ( feedback )
+      QgsProcessingRecordingFeedback::report( mChunk.messages, feedback );
+  }
+
+  feature = mChunk.features.at( mChunkIndex++ );
+  return true;
+}
+
+double QgsProcessingFeaturePipeline::progress() const
+{
+  return mFeatureCount > 0 ? 100.0 * mSourceCount / mFeatureCount : 0;
+}
+
+void QgsProcessingFeaturePipeline::finish( QgsProcessingContext &context )
+{
+  stop();
+
+  for ( Stage &stage : mStages )
+    context.takeResultsFrom( *stage.context );
+
+  for ( const Stage &stage : mStages )
+  {
+    if ( stage.exception )
+      std::rethrow_exception( stage.exception );
+  }
+}
+
+void QgsProcessingFeaturePipeline::materialize( QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  if ( mStages.empty() )
+    return;
+
+  QgsVectorLayer *layer = mStages.back().outputLayer;
+  start( feedback );
+
+  QgsFeatureList features;
+  QgsFeature f;
+  while ( nextFeature( f, feedback ) )
+  {
+    if ( feedback && feedback->isCanceled() )
+      break;
+
+    features.append( f );
+    if ( features.size() >= PIPELINE_CHUNK_SIZE )
+    {
+      layer->dataProvider()->addFeatures( features, QgsFeatureSink::FastInsert );
+      features.clear();
+      if ( feedback )
+        feedback->setProgress( progress() );
+    }
+  }
+  if ( !features.isEmpty() )
+    layer->dataProvider()->addFeatures( features, QgsFeatureSink::FastInsert );
+
+  finish( context );
+
+  mStages.clear();
+  mQueues.clear();
+  mFutures.clear();
+  mIterator = QgsFeatureIterator();
+  mChunk = QgsProcessingFeatureQueue::Chunk();
+  mChunkIndex = 0;
+  mSourceCount = 0;
+  mFeatureCount = -1;
+}
+
+void QgsProcessingFeaturePipeline::runStage( int index, QgsProcessingFeedback *feedback )
+{
+  Stage &stage = mStages[ index ];
+  QgsProcessingFeatureQueue *input = index > 0 ? mQueues[ index - 1 ].get() : nullptr;
+  QgsProcessingFeatureQueue *output = mQueues[ index ].get();
+
+  try
+  {
+    QgsProcessingFeatureQueue::Chunk chunk;
+    while ( !( feedback && feedback->isCanceled() ) )
+    {
+      if ( input )
+      {
+        if ( !input->pop( chunk ) )
+          break;
+      }
+      else
+      {
+        chunk = QgsProcessingFeatureQueue::Chunk();
+        QgsFeature f;
+        while ( chunk.features.size() < PIPELINE_CHUNK_SIZE && mIterator.nextFeature( f ) )
+          chunk.features.append( f );
+        if ( chunk.features.isEmpty() )
+          break;
+        chunk.sourceCount = chunk.features.size();
+      }
+
+      QgsProcessingFeatureQueue::Chunk processed;
+      processed.sourceCount = chunk.sourceCount;
+      processed.messages = std::move( chunk.messages );
+      processed.features.reserve( chunk.features.size() );
+      for ( const QgsFeature &f : std::as_const( chunk.features ) )
+      {
+        if ( stage.feedback->isCanceled() )
+          break;
+
+        stage.context->expressionContext().setFeature( f );
+        const QgsFeatureList transformed = stage.algorithm->processFeature( f, *stage.context, stage.feedback.get() );
+        for ( QgsFeature transformedFeature : transformed )
+        {
+          // the next stage expects features with the fields of its source
+          transformedFeature.setFields( stage.outputFields, false );
+          processed.features.append( transformedFeature );
+        }
+      }
+      processed.messages += stage.feedback->takeMessages();
+
+      if ( !output->push( std::move( processed ) ) )
+        break;
+    }
+  }
+  catch ( ... )
+  {
+    // rethrown by finish(), the other stages are stopped
+    stage.exception = std::current_exception();
+    if ( input )
+      input->abort();
+    output->abort();
+    return;
+  }
+
+  if ( input )
+    input->abort();
+  output->finish();
+}
+
+void QgsProcessingFeaturePipeline::stop()
+{
+  for ( const std::unique_ptr< QgsProcessingFeatureQueue > &queue : mQueues )
+    queue->abort();
+
+  for ( QFuture< void > &future : mFutures )
+    future.waitForFinished();
+  mFutures.clear();
+}
+
+///@endcond
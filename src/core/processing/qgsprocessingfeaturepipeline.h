@@ -0,0 +1,275 @@
+/***************************************************************************
+                         qgsprocessingfeaturepipeline.h
+                         ------------------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPROCESSINGFEATUREPIPELINE_H
+#define QGSPROCESSINGFEATUREPIPELINE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsprocessingfeedback.h"
+#include "qgsfeature.h"
+#include "qgsfeatureiterator.h"
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+#include <QFuture>
+
+#include <deque>
+#include <exception>
+#include <memory>
+#include <vector>
+
+class QgsProcessingContext;
+class QgsVectorLayer;
+class QgsProcessingFeatureBasedAlgorithm;
+
+///@cond PRIVATE
+
+/**
+ * \ingroup core
+ * \brief Feedback recording the messages pushed while features are processed on a worker thread,
+ * so that they can be reported from the algorithm thread in the order of the features.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsProcessingRecordingFeedback : public QgsProcessingFeedback
+{
+  public:
+
+    //! A recorded message
+    struct Message
+    {
+      enum Type
+      {
+        Error,
+        Warning,
+        Info,
+        CommandInfo,
+        DebugInfo,
+        ConsoleInfo,
+      };
+
+      Type type;
+      QString text;
+      bool fatalError;
+    };
+
+    QgsProcessingRecordingFeedback();
+
+    void reportError( const QString &error, bool fatalError = false ) override;
+    void pushWarning( const QString &warning ) override;
+    void pushInfo( const QString &info ) override;
+    void pushCommandInfo( const QString &info ) override;
+    void pushDebugInfo( const QString &info ) override;
+    void pushConsoleInfo( const QString &info ) override;
+
+    //! Returns the recorded messages, and clears them
+    QVector< Message > takeMessages();
+
+    //! Pushes the recorded messages to \a feedback, and clears them
+    void report( QgsProcessingFeedback *feedback );
+
+    //! Pushes the \a messages to \a feedback
+    static void report( const QVector< Message > &messages, QgsProcessingFeedback *feedback );
+
+  private:
+
+    QVector< Message > mMessages;
+};
+
+/**
+ * \ingroup core
+ * \brief Bounded queue of features passed between the stages of a QgsProcessingFeaturePipeline.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsProcessingFeatureQueue
+{
+  public:
+
+    //! Features passed at once between two stages
+    struct Chunk
+    {
+      QgsFeatureList features;
+      //! Messages pushed while the features were processed by the upstream stages
+      QVector< QgsProcessingRecordingFeedback::Message > messages;
+      //! Number of features of the pipeline source these features were created from
+      long long sourceCount = 0;
+    };
+
+    /**
+     * Constructor for QgsProcessingFeatureQueue, holding at most \a capacity chunks.
+     */
+    explicit QgsProcessingFeatureQueue( int capacity );
+
+    /**
+     * Appends a \a chunk, waiting while the queue is full.
+     * Returns FALSE if the queue was aborted.
+     */
+    bool push( Chunk &&chunk );
+
+    /**
+     * Takes the first chunk, waiting while the queue is empty.
+     * Returns FALSE if the queue was aborted, or is finished and empty.
+     */
+    bool pop( Chunk &chunk );
+
+    //! Signals that no more chunks will be pushed
+    void finish();
+
+    //! Stops the queue, ending any push() or pop()
+    void abort();
+
+  private:
+
+    QMutex mMutex;
+    QWaitCondition mNotEmpty;
+    QWaitCondition mNotFull;
+    std::deque< Chunk > mChunks;
+    int mCapacity = 1;
+    bool mFinished = false;
+    bool mAborted = false;
+};
+
+/**
+ * \ingroup core
+ * \brief Chains feature based algorithms, streaming the features output by each algorithm to
+ * the next one instead of writing them to an intermediate layer.
+ *
+ * Each stage of the pipeline runs on its own thread, and passes its outputs to the next stage
+ * through a bounded QgsProcessingFeatureQueue. The algorithm following the last stage reads the
+ * features of the pipeline in place of the features of its source, see
+ * QgsProcessingFeatureBasedAlgorithm::setUpstreamPipeline().
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsProcessingFeaturePipeline
+{
+  public:
+
+    QgsProcessingFeaturePipeline() = default;
+
+    //! Stops any running stage
+    ~QgsProcessingFeaturePipeline();
+
+    //! QgsProcessingFeaturePipeline cannot be copied
+    QgsProcessingFeaturePipeline( const QgsProcessingFeaturePipeline &other ) = delete;
+    //! QgsProcessingFeaturePipeline cannot be copied
+    QgsProcessingFeaturePipeline &operator=( const QgsProcessingFeaturePipeline &other ) = delete;
+
+    /**
+     * Returns TRUE if the outputs of the feature based \a algorithm can be streamed to another algorithm.
+     */
+    static bool canStream( const QgsProcessingFeatureBasedAlgorithm *algorithm );
+
+    /**
+     * Returns TRUE if the features can be streamed to an algorithm fetching its source features
+     * with the given \a request, i.e. the request does not filter or order the features.
+     */
+    static bool canStreamTo( const QgsFeatureRequest &request );
+
+    /**
+     * Returns the name of the parameter of the \a algorithm for the source of the features it processes.
+     */
+    static QString inputParameterName( const QgsProcessingFeatureBasedAlgorithm *algorithm );
+
+    /**
+     * Appends a stage running the prepared \a algorithm with the given \a parameters. The first
+     * stage reads the features of its source, and the next stages process the features streamed
+     * by the previous stage.
+     *
+     * Returns the ID of an empty layer stored in the \a context, with the fields, geometry type and
+     * crs of the stage outputs. It must be used as the source of the next stage, or of the algorithm
+     * reading the pipeline, so that they are prepared for the streamed features.
+     *
+     * If the \a algorithm cannot be streamed to, the existing stages are run first by materialize().
+     */
+    QString appendStage( std::unique_ptr< QgsProcessingFeatureBasedAlgorithm > algorithm, const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+
+    //! Returns the number of stages
+    int stageCount() const { return static_cast< int >( mStages.size() ); }
+
+    /**
+     * Starts the stages on their threads.
+     *
+     * The \a feedback is checked for cancellation by the stages.
+     */
+    void start( QgsProcessingFeedback *feedback );
+
+    /**
+     * Reads the next \a feature output by the last stage, returning FALSE once all the features were read.
+     *
+     * The messages pushed by the stages are reported to the \a feedback, which must belong to the
+     * thread calling this method.
+     */
+    bool nextFeature( QgsFeature &feature, QgsProcessingFeedback *feedback );
+
+    //! Returns the progress of the pipeline, from the number of source features processed by the stages
+    double progress() const;
+
+    /**
+     * Stops and waits for the stages, and moves the results of their contexts to the \a context.
+     *
+     * Rethrows the first exception thrown by a stage.
+     */
+    void finish( QgsProcessingContext &context );
+
+    /**
+     * Runs the stages, storing the outputs of the last stage in its output layer, and removes
+     * all the stages.
+     *
+     * Any source prepared from the output layer must be prepared again to read the stored features.
+     */
+    void materialize( QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+
+  private:
+
+    struct Stage
+    {
+      std::unique_ptr< QgsProcessingFeatureBasedAlgorithm > algorithm;
+      std::unique_ptr< QgsProcessingContext > context;
+      std::unique_ptr< QgsProcessingRecordingFeedback > feedback;
+      QgsFields outputFields;
+      //! Empty layer with the schema of the outputs, owned by the model context
+      QgsVectorLayer *outputLayer = nullptr;
+      std::exception_ptr exception;
+    };
+
+    void runStage( int index, QgsProcessingFeedback *feedback );
+    void stop();
+
+    std::vector< Stage > mStages;
+    //! The output queue of each stage
+    std::vector< std::unique_ptr< QgsProcessingFeatureQueue > > mQueues;
+    QgsFeatureIterator mIterator;
+    long long mFeatureCount = -1;
+
+    QThreadPool mThreadPool;
+    QList< QFuture< void > > mFutures;
+
+    QgsProcessingFeatureQueue::Chunk mChunk;
+    int mChunkIndex = 0;
+    long long mSourceCount = 0;
+};
+
+///@endcond
+
+#endif // QGSPROCESSINGFEATUREPIPELINE_H
@@ -51,6 +51,31 @@ std::function< void( const QgsCoordinateReferenceSystem &sourceCrs,
 std::function< void( const QgsCoordinateReferenceSystem &sourceCrs,
                      const QgsCoordinateReferenceSystem &destinationCrs )> QgsCoordinateTransformPrivate::sDynamicCrsToDynamicCrsWarningHandler = nullptr;
 
+#if defined(USE_THREAD_LOCAL) && !defined(Q_OS_WIN)
+
+/**
+ * The proj object last returned by QgsCoordinateTransformPrivate::threadLocalProjData()
+ * in the current thread, so that transforming many geometries with the same transform
+ * does not need to lock and search the proj objects of the transform each time.
+ */
+struct ThreadLocalProjDataCache
+{
+  const QgsCoordinateTransformPrivate *transform = nullptr;
+  quint64 serial = 0;
+  PJ_CONTEXT *context = nullptr;
+  ProjData projData = nullptr;
+};
+
+thread_local ThreadLocalProjDataCache sLastProjData;
+
+#endif
+
+quint64 QgsCoordinateTransformPrivate::nextProjSerial()
+{
+  static std::atomic< quint64 > sSerial { 0 };
+  return ++sSerial;
+}
+
 Q_NOWARN_DEPRECATED_PUSH // because of deprecated members
 QgsCoordinateTransformPrivate::QgsCoordinateTransformPrivate()
 {
@@ -278,14 +303,26 @@ static void proj_logger( void *, int level, const char *message )
 
 ProjData QgsCoordinateTransformPrivate::threadLocalProjData()
 {
+  PJ_CONTEXT *context = QgsProjContext::get();
+
+#if defined(USE_THREAD_LOCAL) && !defined(Q_OS_WIN)
+  // the serial is unique across all transforms, so a transform allocated at the address of
+  // a deleted one will never match
+  const quint64 serial = mProjSerial.load( std::memory_order_acquire );
+  if ( sLastProjData.transform == this && sLastProjData.serial == serial && sLastProjData.context == context )
+    return sLastProjData.projData;
+#endif
+
   QgsReadWriteLocker locker( mProjLock, QgsReadWriteLocker::Read );
 
-  PJ_CONTEXT *context = QgsProjContext::get();
   const QMap < uintptr_t, ProjData >::const_iterator it = mProjProjections.constFind( reinterpret_cast< uintptr_t>( context ) );
 
   if ( it != mProjProjections.constEnd() )
   {
     ProjData res = it.value();
+#if defined(USE_THREAD_LOCAL) && !defined(Q_OS_WIN)
+    sLastProjData = ThreadLocalProjDataCache{ this, serial, context, res };
+#endif
     return res;
   }
 
@@ -542,6 +579,9 @@ ProjData QgsCoordinateTransformPrivate::threadLocalProjData()
 
   ProjData res = transform.release();
   mProjProjections.insert( reinterpret_cast< uintptr_t>( context ), res );
+#if defined(USE_THREAD_LOCAL) && !defined(Q_OS_WIN)
+  sLastProjData = ThreadLocalProjDataCache{ this, mProjSerial.load( std::memory_order_acquire ), context, res };
+#endif
   return res;
 }
 
@@ -600,6 +640,7 @@ void QgsCoordinateTransformPrivate::freeProj()
   const QgsReadWriteLocker locker( mProjLock, QgsReadWriteLocker::Write );
   if ( mProjProjections.isEmpty() && mProjFallbackProjections.isEmpty() )
     return;
+  mProjSerial = nextProjSerial();
   QMap < uintptr_t, ProjData >::const_iterator it = mProjProjections.constBegin();
 
   // During destruction of PJ* objects, the errno is set in the underlying
@@ -633,6 +674,7 @@ bool QgsCoordinateTransformPrivate::removeObjectsBelongingToCurrentThread( void
   QMap < uintptr_t, ProjData >::iterator it = mProjProjections.find( reinterpret_cast< uintptr_t>( pj_context ) );
   if ( it != mProjProjections.end() )
   {
+    mProjSerial = nextProjSerial();
     proj_destroy( it.value() );
     mProjProjections.erase( it );
   }
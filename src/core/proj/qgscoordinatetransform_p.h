@@ -32,6 +32,7 @@
 //
 
 #include <QSharedData>
+#include <atomic>
 
 struct PJconsts;
 typedef struct PJconsts PJ;
@@ -116,6 +117,14 @@ class QgsCoordinateTransformPrivate : public QSharedData
     bool mIsReversed = false;
 
     QReadWriteLock mProjLock;
+
+    /**
+     * Identifies the current set of proj objects of this transform across all instances, changed
+     * whenever the proj objects are destroyed. Used to validate the per thread cache of the last
+     * proj object returned by threadLocalProjData().
+     */
+    std::atomic< quint64 > mProjSerial { nextProjSerial() };
+
     QMap < uintptr_t, ProjData > mProjProjections;
     QMap < uintptr_t, ProjData > mProjFallbackProjections;
 
@@ -181,6 +190,8 @@ class QgsCoordinateTransformPrivate : public QSharedData
 
     void freeProj();
 
+    static quint64 nextProjSerial();
+
     static std::function< void( const QgsCoordinateReferenceSystem &sourceCrs,
                                 const QgsCoordinateReferenceSystem &destinationCrs,
                                 const QgsDatumTransform::GridDetails &grid )> sMissingRequiredGridHandler;
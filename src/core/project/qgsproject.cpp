@@ -28,6 +28,7 @@
 #include "qgspluginlayer.h"
 #include "qgspluginlayerregistry.h"
 #include "qgsprojectfiletransform.h"
+#include "qgsprojectdocumentcache.h"
 #include "qgssnappingconfig.h"
 #include "qgspathresolver.h"
 #include "qgsprojectstorage.h"
@@ -69,8 +70,12 @@
 #include "qgscombinedstylemodel.h"
 #include "qgsprojectgpssettings.h"
 #include "qgsthreadingutils.h"
+#include "qgsprovidermetadata.h"
+#include "qgsproviderregistry.h"
+#include "qgsauthmanager.h"
 
 #include <algorithm>
+#include <functional>
 #include <QApplication>
 #include <QFileInfo>
 #include <QDomNode>
@@ -82,6 +87,10 @@
 #include <QStandardPaths>
 #include <QUuid>
 #include <QRegularExpression>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QThread>
+#include <QtConcurrentMap>
 
 #ifdef _MSC_VER
 #include <sys/utime.h>
@@ -1343,6 +1352,12 @@ bool QgsProject::_getMapLayers( const QDomDocument &doc, QList<QDomNode> &broken
   const QVector<QDomNode> sortedLayerNodes = depSorter.sortedLayerNodes();
   const int totalLayerCount = sortedLayerNodes.count();
 
+  if ( !( flags & Qgis::ProjectReadFlag::DontResolveLayers ) )
+  {
+    profile.switchTask( tr( "Creating layer providers" ) );
+    preloadProviders( sortedLayerNodes, flags );
+  }
+
   int i = 0;
   for ( const QDomNode &node : sortedLayerNodes )
   {
@@ -1379,9 +1394,127 @@ bool QgsProject::_getMapLayers( const QDomDocument &doc, QList<QDomNode> &broken
     i++;
   }
 
+  // providers which were not used by their layers
+  mPreloadedProviders.clear();
+
   return returnStatus;
 }
 
+void QgsProject::preloadProviders( const QVector<QDomNode> &layerNodes, Qgis::ProjectReadFlags flags )
+{
+  QGIS_PROTECT_QOBJECT_THREAD_ACCESS
+
+  mPreloadedProviders.clear();
+
+  // the providers are kept apart from mPreloadedProviders until they are all created, as the project
+  // may be cleared or read again by the events processed while waiting for them
+  std::vector< PreloadedProvider > preloadedProviders;
+
+  QgsReadWriteContext context;
+  context.setPathResolver( pathResolver() );
+  context.setProjectTranslator( this );
+  context.setTransformContext( transformContext() );
+
+  const bool trustLayerMetadata = ( mFlags & Qgis::ProjectFlag::TrustStoredLayerStatistics ) || ( flags & Qgis::ProjectReadFlag::TrustLayerMetadata ) || ( flags & Qgis::ProjectReadFlag::LazyLoadLayers );
+  const thread_local QRegularExpression authConfigRegularExpression( "authcfg=([a-z]|[A-Z]|[0-9]){7}" );
+
+  for ( const QDomNode &node : layerNodes )
+  {
+    const QDomElement element = node.toElement();
+    if ( element.attribute( QStringLiteral( "embedded" ) ) == QLatin1String( "1" ) )
+      continue;
+
+    bool ok = false;
+    const QgsMapLayerType layerType = QgsMapLayerFactory::typeFromString( element.attribute( QStringLiteral( "type" ) ), ok );
+    if ( !ok || ( layerType != QgsMapLayerType::VectorLayer && layerType != QgsMapLayerType::RasterLayer ) )
+      continue;
+
+    // the providers of vector layers are created when the layers are used
+    if ( layerType == QgsMapLayerType::VectorLayer && ( flags & Qgis::ProjectReadFlag::LazyLoadLayers ) )
+      continue;
+
+    const QString providerKey = element.namedItem( QStringLiteral( "provider" ) ).toElement().text();
+    const QgsProviderMetadata *metadata = QgsProviderRegistry::instance()->providerMetadata( providerKey );
+    if ( !metadata || !( metadata->providerCapabilities() & QgsProviderMetadata::ProviderCapability::ParallelCreateProvider ) )
+      continue;
+
+    // the data source is resolved by the layer itself, as when reading it
+    std::unique_ptr< QgsMapLayer > layer;
+    if ( layerType == QgsMapLayerType::VectorLayer )
+      layer = std::make_unique< QgsVectorLayer >();
+    else
+      layer = std::make_unique< QgsRasterLayer >();
+
+    PreloadedProvider preloaded;
+    preloaded.layerId = element.namedItem( QStringLiteral( "id" ) ).toElement().text();
+    preloaded.dataSource = layer->dataSourceFromXml( element, context, preloaded.providerKey );
+    preloaded.options = QgsDataProvider::ProviderOptions { context.transformContext() };
+    if ( trustLayerMetadata )
+      preloaded.flags |= QgsDataProvider::FlagTrustDataSource;
+
+    if ( layerType == QgsMapLayerType::VectorLayer && preloaded.providerKey == QLatin1String( "postgres" ) )
+    {
+      // as in QgsVectorLayer::setDataProvider(), the primary key unicity is only checked if layer metadata is not trusted
+      const QString checkUnicityKey { QStringLiteral( "checkPrimaryKeyUnicity" ) };
+      QgsDataSourceUri uri( preloaded.dataSource );
+      if ( ! uri.hasParam( checkUnicityKey ) )
+      {
+        uri.setParam( checkUnicityKey, trustLayerMetadata ? "0" : "1" );
+        preloaded.dataSource = uri.uri( false );
+      }
+    }
+    else if ( layerType == QgsMapLayerType::RasterLayer && ( flags & Qgis::ProjectReadFlag::ForceReadOnlyLayers ) )
+    {
+      preloaded.flags |= QgsDataProvider::ForceReadOnly;
+    }
+
+    // the master password must be asked from the main thread, before creating the provider
+    if ( authConfigRegularExpression.match( preloaded.dataSource ).hasMatch() && !QgsApplication::authManager()->setMasterPassword( true ) )
+      continue;
+
+    preloadedProviders.emplace_back( std::move( preloaded ) );
+  }
+
+  if ( preloadedProviders.size() < 2 )
+  {
+    // nothing to win over creating the provider with its layer
+    return;
+  }
+
+  emit loadingLayer( tr( "Creating layer providers" ) );
+
+  QThread *projectThread = thread();
+  const std::function< void( PreloadedProvider & ) > createProvider = [projectThread]( PreloadedProvider & preloaded )
+  {
+    preloaded.provider.reset( QgsProviderRegistry::instance()->createProvider( preloaded.providerKey, preloaded.dataSource, preloaded.options, preloaded.flags ) );
+    if ( preloaded.provider )
+      preloaded.provider->moveToThread( projectThread );
+  };
+
+  // providers may need the events of the main thread while they are created, e.g. for network requests or authentication.
+  // User input is excluded from the local event loop, but queued signals and timers are still delivered, which
+  // is why the providers are only handed to the project once the loop is left
+  QFutureWatcher< void > watcher;
+  QEventLoop loop;
+  connect( &watcher, &QFutureWatcher< void >::finished, &loop, &QEventLoop::quit );
+  watcher.setFuture( QtConcurrent::map( preloadedProviders, createProvider ) );
+  if ( !watcher.isFinished() )
+    loop.exec( QEventLoop::ExcludeUserInputEvents );
+  watcher.waitForFinished();
+
+  // let the providers replace what they could not share on the worker threads, e.g. database connections
+  if ( projectThread == QCoreApplication::instance()->thread() )
+  {
+    for ( PreloadedProvider &preloaded : preloadedProviders )
+    {
+      if ( preloaded.provider )
+        preloaded.provider->movedToMainThread();
+    }
+  }
+
+  mPreloadedProviders = std::move( preloadedProviders );
+}
+
 bool QgsProject::addLayer( const QDomElement &layerElem, QList<QDomNode> &brokenNodes, QgsReadWriteContext &context, Qgis::ProjectReadFlags flags )
 {
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS
@@ -1465,6 +1598,19 @@ bool QgsProject::addLayer( const QDomElement &layerElem, QList<QDomNode> &broken
   Q_ASSERT( ! layerId.isEmpty() );
   const bool layerWasStored { layerStore()->mapLayer( layerId ) != nullptr };
 
+  // use the provider created in advance, which the layer takes if its source did not change
+  auto preloaded = std::find_if( mPreloadedProviders.begin(), mPreloadedProviders.end(), [&layerId]( const PreloadedProvider & provider )
+  {
+    return provider.layerId == layerId;
+  } );
+  if ( preloaded != mPreloadedProviders.end() )
+  {
+    mapLayer->mPreloadedProvider = std::move( preloaded->provider );
+    mapLayer->mPreloadedProviderKey = preloaded->providerKey;
+    mapLayer->mPreloadedDataSource = preloaded->dataSource;
+    mPreloadedProviders.erase( preloaded );
+  }
+
   // have the layer restore state that is stored in Dom node
   QgsMapLayer::ReadFlags layerFlags = QgsMapLayer::ReadFlags();
   if ( flags & Qgis::ProjectReadFlag::DontResolveLayers )
@@ -1475,6 +1621,9 @@ bool QgsProject::addLayer( const QDomElement &layerElem, QList<QDomNode> &broken
   // Propagate open layers in read-only mode
   if ( ( flags & Qgis::ProjectReadFlag::ForceReadOnlyLayers ) )
     layerFlags |= QgsMapLayer::FlagForceReadOnly;
+  // Layers created lazily rely on the stored layer metadata until their provider is created
+  if ( ( flags & Qgis::ProjectReadFlag::LazyLoadLayers ) && !( flags & Qgis::ProjectReadFlag::DontResolveLayers ) )
+    layerFlags |= QgsMapLayer::FlagDeferProviderCreation | QgsMapLayer::FlagTrustLayerMetadata | QgsMapLayer::FlagReadExtentFromXml;
 
   profile.switchTask( tr( "Load layer source" ) );
   const bool layerIsValid = mapLayer->readLayerXml( layerElem, context, layerFlags ) && mapLayer->isValid();
@@ -1636,11 +1785,23 @@ bool QgsProject::readProjectFile( const QString &filename, Qgis::ProjectReadFlag
     return false;
   }
 
+  // the cached document is already upgraded, only the version of the file is needed
+  std::unique_ptr< QgsProjectDocumentCache > documentCache;
+  QByteArray projectContent;
+  QString cachedFileVersion;
+  bool documentFromCache = false;
+  if ( !mDocumentCacheDirectory.isEmpty() )
+  {
+    documentCache = std::make_unique< QgsProjectDocumentCache >( mDocumentCacheDirectory );
+    projectContent = projectFile.readAll();
+    documentFromCache = documentCache->readDocument( projectContent, *doc, cachedFileVersion );
+  }
+
   // location of problem associated with errorMsg
   int line, column;
   QString errorMsg;
 
-  if ( !doc->setContent( &projectFile, &errorMsg, &line, &column ) )
+  if ( !documentFromCache && !( documentCache ? doc->setContent( projectContent, &errorMsg, &line, &column ) : doc->setContent( &projectFile, &errorMsg, &line, &column ) ) )
   {
     const QString errorString = tr( "Project file read error in file %1: %2 at line %3 column %4" )
                                 .arg( projectFile.fileName(), errorMsg ).arg( line ).arg( column );
@@ -1659,7 +1820,7 @@ bool QgsProject::readProjectFile( const QString &filename, Qgis::ProjectReadFlag
   QgsDebugMsgLevel( "Opened document " + projectFile.fileName(), 2 );
 
   // get project version string, if any
-  const QgsProjectVersion fileVersion = getVersion( *doc );
+  const QgsProjectVersion fileVersion = documentFromCache ? QgsProjectVersion( cachedFileVersion ) : getVersion( *doc );
   const QgsProjectVersion thisVersion( Qgis::version() );
 
   profile.switchTask( tr( "Updating project file" ) );
@@ -1675,15 +1836,17 @@ bool QgsProject::readProjectFile( const QString &filename, Qgis::ProjectReadFlag
                           "). Problems may occur." );
     }
 
-    QgsProjectFileTransform projectFile( *doc, fileVersion );
-
     // Shows a warning when an old project file is read.
     Q_NOWARN_DEPRECATED_PUSH
     emit oldProjectVersionWarning( fileVersion.text() );
     Q_NOWARN_DEPRECATED_POP
     emit readVersionMismatchOccurred( fileVersion.text() );
 
-    projectFile.updateRevision( thisVersion );
+    if ( !documentFromCache )
+    {
+      QgsProjectFileTransform projectFile( *doc, fileVersion );
+      projectFile.updateRevision( thisVersion );
+    }
   }
   else if ( fileVersion > thisVersion )
   {
@@ -1695,6 +1858,13 @@ bool QgsProject::readProjectFile( const QString &filename, Qgis::ProjectReadFlag
     emit readVersionMismatchOccurred( fileVersion.text() );
   }
 
+  if ( documentCache && !documentFromCache )
+  {
+    profile.switchTask( tr( "Storing project document in cache" ) );
+    if ( !documentCache->writeDocument( projectContent, *doc, fileVersion.text() ) )
+      QgsDebugMsg( QStringLiteral( "Could not store project document in cache %1" ).arg( mDocumentCacheDirectory ) );
+  }
+
   // start new project, just keep the file name and auxiliary storage
   profile.switchTask( tr( "Creating auxiliary storage" ) );
   const QString fileName = mFile.fileName();
@@ -3368,6 +3538,20 @@ void QgsProject::setBadLayerHandler( QgsProjectBadLayerHandler *handler )
   mBadLayerHandler = handler;
 }
 
+void QgsProject::setDocumentCacheDirectory( const QString &directory )
+{
+  QGIS_PROTECT_QOBJECT_THREAD_ACCESS
+
+  mDocumentCacheDirectory = directory;
+}
+
+QString QgsProject::documentCacheDirectory() const
+{
+  QGIS_PROTECT_QOBJECT_THREAD_ACCESS
+
+  return mDocumentCacheDirectory;
+}
+
 QString QgsProject::layerIsEmbedded( const QString &id ) const
 {
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS
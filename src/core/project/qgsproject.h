@@ -26,6 +26,7 @@
 #include "qgis.h"
 
 #include <memory>
+#include <vector>
 #include <QHash>
 #include <QList>
 #include <QObject>
@@ -658,6 +659,27 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
      */
     void setBadLayerHandler( QgsProjectBadLayerHandler *handler SIP_TRANSFER );
 
+    /**
+     * Sets the \a directory of the binary cache of project documents used when reading project files.
+     *
+     * When set, the parsed and upgraded document of a project file is stored in the cache, and is
+     * loaded from it instead of parsing the XML of the file again as long as its content does not
+     * change. An empty \a directory disables the cache, which is the default.
+     *
+     * \see documentCacheDirectory()
+     * \since QGIS 3.30
+     */
+    void setDocumentCacheDirectory( const QString &directory );
+
+    /**
+     * Returns the directory of the binary cache of project documents, or an empty string if
+     * the cache is disabled.
+     *
+     * \see setDocumentCacheDirectory()
+     * \since QGIS 3.30
+     */
+    QString documentCacheDirectory() const;
+
     /**
      * Returns the source project file path if the layer with matching \a id is embedded from other project file.
      *
@@ -2211,6 +2233,35 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
      */
     bool addLayer( const QDomElement &layerElem, QList<QDomNode> &brokenNodes, QgsReadWriteContext &context, Qgis::ProjectReadFlags flags = Qgis::ProjectReadFlags() ) SIP_SKIP;
 
+    /**
+     * Creates the providers of the layers of \a layerNodes in advance, on worker threads, for the providers
+     * supporting it. The created providers are then used by addLayer().
+     *
+     * The \a flags argument is used to create the providers as the layers would.
+     *
+     * The events of the project thread, except user input, are processed while the providers are
+     * created, so slots connected to queued signals and timers may run before this method returns.
+     *
+     * \note not available in Python bindings
+     */
+    void preloadProviders( const QVector<QDomNode> &layerNodes, Qgis::ProjectReadFlags flags ) SIP_SKIP;
+
+#ifndef SIP_RUN
+
+    //! Provider created in advance by preloadProviders(), with the key and data source it was created for
+    struct PreloadedProvider
+    {
+      QString layerId;
+      QString providerKey;
+      QString dataSource;
+      QgsDataProvider::ProviderOptions options;
+      QgsDataProvider::ReadFlags flags;
+      std::unique_ptr< QgsDataProvider > provider;
+    };
+
+    std::vector< PreloadedProvider > mPreloadedProviders;
+#endif
+
     /**
      * Remove auxiliary layer of the corresponding layer.
      */
@@ -2258,6 +2309,8 @@ class CORE_EXPORT QgsProject : public QObject, public QgsExpressionContextGenera
 
     QgsProjectBadLayerHandler *mBadLayerHandler = nullptr;
 
+    QString mDocumentCacheDirectory;
+
     /**
      * Embedded layers which are defined in other projects. Key: layer id,
      * value: pair< project file path, save layer yes / no (e.g. if the layer is part of an embedded group, loading/saving is done by the legend)
@@ -0,0 +1,181 @@
+/***************************************************************************
+  qgsprojectdocumentcache.cpp
+  ---------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsprojectdocumentcache.h"
+#include "qgis.h"
+#include "qgslogger.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QDomDocument>
+#include <QFile>
+#include <QSaveFile>
+
+///@cond PRIVATE
+
+//! Magic number of the cache entries
+constexpr quint32 PROJECT_DOCUMENT_CACHE_MAGIC = 0x51475043;
+
+//! Version of the format of the cache entries, to be increased when it changes
+constexpr quint32 PROJECT_DOCUMENT_CACHE_FORMAT = 1;
+
+///@endcond
+
+QgsProjectDocumentCache::QgsProjectDocumentCache( const QString &directory )
+  : mDirectory( directory )
+{
+}
+
+bool QgsProjectDocumentCache::readDocument( const QByteArray &content, QDomDocument &document, QString &fileVersion ) const
+{
+  QFile file( entryPath( content ) );
+  if ( !file.open( QIODevice::ReadOnly ) )
+    return false;
+
+  QDataStream stream( &file );
+  stream.setVersion( QDataStream::Qt_5_12 );
+
+  quint32 magic = 0;
+  quint32 format = 0;
+  QString qgisVersion;
+  QByteArray hash;
+  stream >> magic >> format >> qgisVersion >> hash >> fileVersion;
+  if ( stream.status() != QDataStream::Ok || magic != PROJECT_DOCUMENT_CACHE_MAGIC || format != PROJECT_DOCUMENT_CACHE_FORMAT
+       || qgisVersion != Qgis::version() || hash != QCryptographicHash::hash( content, QCryptographicHash::Sha256 ) )
+  {
+    QgsDebugMsgLevel( QStringLiteral( "Ignoring stale project document cache entry %1" ).arg( file.fileName() ), 2 );
+    return false;
+  }
+
+  QDomDocument cachedDocument( QStringLiteral( "qgis" ) );
+  if ( !readNode( stream, cachedDocument, cachedDocument ) )
+  {
+    QgsDebugMsg( QStringLiteral( "Invalid project document cache entry %1" ).arg( file.fileName() ) );
+    return false;
+  }
+
+  document = cachedDocument;
+  return true;
+}
+
+bool QgsProjectDocumentCache::writeDocument( const QByteArray &content, const QDomDocument &document, const QString &fileVersion ) const
+{
+  if ( !QDir().mkpath( mDirectory ) )
+    return false;
+
+  // entries are replaced atomically, as several processes may share the cache
+  QSaveFile file( entryPath( content ) );
+  if ( !file.open( QIODevice::WriteOnly ) )
+    return false;
+
+  QDataStream stream( &file );
+  stream.setVersion( QDataStream::Qt_5_12 );
+  stream << PROJECT_DOCUMENT_CACHE_MAGIC << PROJECT_DOCUMENT_CACHE_FORMAT << Qgis::version()
+         << QCryptographicHash::hash( content, QCryptographicHash::Sha256 ) << fileVersion;
+  writeNode( stream, document );
+
+  if ( stream.status() != QDataStream::Ok )
+  {
+    file.cancelWriting();
+    return false;
+  }
+  return file.commit();
+}
+
+QString QgsProjectDocumentCache::entryPath( const QByteArray &content ) const
+{
+  // the key includes the QGIS version, as the upgrade of the document depends on it
+  QCryptographicHash hash( QCryptographicHash::Sha1 );
+  hash.addData( content );
+  hash.addData( Qgis::version().toUtf8() );
+  return QDir( mDirectory ).filePath( QStringLiteral( "%1.qgc" ).arg( QString::fromLatin1( hash.result().toHex() ) ) );
+}
+
+void QgsProjectDocumentCache::writeNode( QDataStream &stream, const QDomNode &node )
+{
+  // comments and processing instructions are not needed to read the project
+  quint32 count = 0;
+  for ( QDomNode child = node.firstChild(); !child.isNull(); child = child.nextSibling() )
+  {
+    if ( child.isElement() || child.isText() )
+      ++count;
+  }
+
+  stream << count;
+  for ( QDomNode child = node.firstChild(); !child.isNull(); child = child.nextSibling() )
+  {
+    if ( child.isElement() )
+    {
+      const QDomElement element = child.toElement();
+      const QDomNamedNodeMap attributes = element.attributes();
+      stream << static_cast< quint8 >( QDomNode::ElementNode ) << element.tagName() << static_cast< quint32 >( attributes.count() );
+      for ( int i = 0; i < attributes.count(); ++i )
+      {
+        const QDomAttr attribute = attributes.item( i ).toAttr();
+        stream << attribute.name() << attribute.value();
+      }
+      writeNode( stream, child );
+    }
+    else if ( child.isText() )
+    {
+      // CDATA sections are text nodes too
+      stream << static_cast< quint8 >( child.nodeType() ) << child.nodeValue();
+    }
+  }
+}
+
+bool QgsProjectDocumentCache::readNode( QDataStream &stream, QDomDocument &document, QDomNode &parent )
+{
+  quint32 count = 0;
+  stream >> count;
+  for ( quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i )
+  {
+    quint8 type = 0;
+    QString value;
+    stream >> type >> value;
+    switch ( static_cast< QDomNode::NodeType >( type ) )
+    {
+      case QDomNode::ElementNode:
+      {
+        QDomElement element = document.createElement( value );
+        quint32 attributeCount = 0;
+        stream >> attributeCount;
+        for ( quint32 j = 0; j < attributeCount && stream.status() == QDataStream::Ok; ++j )
+        {
+          QString name;
+          QString attributeValue;
+          stream >> name >> attributeValue;
+          element.setAttribute( name, attributeValue );
+        }
+        parent.appendChild( element );
+        if ( !readNode( stream, document, element ) )
+          return false;
+        break;
+      }
+
+      case QDomNode::TextNode:
+        parent.appendChild( document.createTextNode( value ) );
+        break;
+
+      case QDomNode::CDATASectionNode:
+        parent.appendChild( document.createCDATASection( value ) );
+        break;
+
+      default:
+        return false;
+    }
+  }
+  return stream.status() == QDataStream::Ok;
+}
@@ -0,0 +1,87 @@
+/***************************************************************************
+  qgsprojectdocumentcache.h
+  ---------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPROJECTDOCUMENTCACHE_H
+#define QGSPROJECTDOCUMENTCACHE_H
+
+#include "qgis_core.h"
+
+#include <QString>
+
+#define SIP_NO_FILE
+
+class QByteArray;
+class QDataStream;
+class QDomDocument;
+class QDomNode;
+
+/**
+ * \ingroup core
+ * \brief A cache of parsed and upgraded project documents, stored in a binary form on disk.
+ *
+ * Reading a large project file requires parsing its XML and upgrading it with QgsProjectFileTransform
+ * when it was saved by an older version of QGIS. The cache stores the resulting document as a compact binary
+ * serialization of its nodes, which can be loaded directly instead of parsing the XML again.
+ *
+ * The entries are keyed by a hash of the content of the project file and by the QGIS version, so
+ * modified projects and projects read by another version of QGIS are never loaded from stale entries.
+ *
+ * \see QgsProject::setDocumentCacheDirectory()
+ * \note Not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsProjectDocumentCache
+{
+  public:
+
+    /**
+     * Constructor for QgsProjectDocumentCache, storing its entries in \a directory.
+     */
+    explicit QgsProjectDocumentCache( const QString &directory );
+
+    /**
+     * Returns the directory of the cache entries.
+     */
+    QString directory() const { return mDirectory; }
+
+    /**
+     * Loads the cached \a document of the project file with the \a content contents.
+     *
+     * The \a fileVersion argument is set to the version of QGIS which saved the project file,
+     * before it was upgraded.
+     *
+     * Returns FALSE if the cache has no valid entry for the project.
+     */
+    bool readDocument( const QByteArray &content, QDomDocument &document, QString &fileVersion ) const;
+
+    /**
+     * Stores the \a document parsed and upgraded from the project file with the \a content contents,
+     * which was saved by the \a fileVersion version of QGIS.
+     *
+     * Returns FALSE if the entry could not be written.
+     */
+    bool writeDocument( const QByteArray &content, const QDomDocument &document, const QString &fileVersion ) const;
+
+  private:
+
+    //! Returns the path of the cache entry of a project file with the \a content contents
+    QString entryPath( const QByteArray &content ) const;
+
+    static void writeNode( QDataStream &stream, const QDomNode &node );
+    static bool readNode( QDataStream &stream, QDomDocument &document, QDomNode &parent );
+
+    QString mDirectory;
+};
+
+#endif // QGSPROJECTDOCUMENTCACHE_H
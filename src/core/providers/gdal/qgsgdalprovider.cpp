@@ -162,6 +162,13 @@ QgsGdalProvider::QgsGdalProvider( const QString &uri, const ProviderOptions &opt
     CPLSetConfigOption( "AAIGRID_DATATYPE", "Float64" );
   }
 
+  if ( !CPLGetConfigOption( "GDAL_HTTP_MERGE_CONSECUTIVE_RANGES", nullptr ) )
+  {
+    // the tiles of a block read from a remote cloud optimized GeoTIFF are mostly adjacent in
+    // the file, so fetch consecutive ranges with a single range of the multi-range requests
+    CPLSetConfigOption( "GDAL_HTTP_MERGE_CONSECUTIVE_RANGES", "YES" );
+  }
+
   // To get buildSupportedRasterFileFilter the provider is called with empty uri
   if ( uri.isEmpty() )
   {
@@ -1726,7 +1733,8 @@ QgsRasterDataProvider::ProviderCapabilities QgsGdalProvider::providerCapabilitie
   return ProviderCapability::ProviderHintBenefitsFromResampling |
          ProviderCapability::ProviderHintCanPerformProviderResampling |
          ProviderCapability::ReloadData |
-         ProviderCapability::NativeRasterAttributeTable;
+         ProviderCapability::NativeRasterAttributeTable |
+         ProviderCapability::ProviderHintCanReadInParallel;
 }
 
 QList<QgsProviderSublayerDetails> QgsGdalProvider::sublayerDetails( GDALDatasetH dataset, const QString &baseUri )
@@ -2144,6 +2152,15 @@ QString QgsGdalProvider::buildPyramids( const QList<QgsRasterPyramid> &rasterPyr
     }
   }
 
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+  // compute the overviews with all the CPUs, unless the user chose otherwise
+  if ( !myConfigOptionsOld.contains( QStringLiteral( "GDAL_NUM_THREADS" ) ) && !CPLGetConfigOption( "GDAL_NUM_THREADS", nullptr ) )
+  {
+    myConfigOptionsOld[ QStringLiteral( "GDAL_NUM_THREADS" ) ] = QString();
+    CPLSetConfigOption( "GDAL_NUM_THREADS", "ALL_CPUS" );
+  }
+#endif
+
   //
   // Iterate through the Raster Layer Pyramid Vector, building any pyramid
   // marked as exists in each RasterPyramid struct.
@@ -2214,7 +2231,8 @@ QString QgsGdalProvider::buildPyramids( const QList<QgsRasterPyramid> &rasterPyr
       {
         QByteArray key = it.key().toLocal8Bit();
         QByteArray value = it.value().toLocal8Bit();
-        CPLSetConfigOption( key.data(), value.data() );
+        // options which were not set before are unset again
+        CPLSetConfigOption( key.data(), it.value().isNull() ? nullptr : value.data() );
       }
 
       // TODO print exact error message
@@ -2241,7 +2259,7 @@ QString QgsGdalProvider::buildPyramids( const QList<QgsRasterPyramid> &rasterPyr
   {
     QByteArray key = it.key().toLocal8Bit();
     QByteArray value = it.value().toLocal8Bit();
-    CPLSetConfigOption( key.data(), value.data() );
+    CPLSetConfigOption( key.data(), it.value().isNull() ? nullptr : value.data() );
   }
 
   QgsDebugMsgLevel( QStringLiteral( "Pyramid overviews built" ), 2 );
@@ -289,6 +289,15 @@ GDALDatasetH QgsGdalProviderBase::gdalOpen( const QString &uri, unsigned int nOp
     CPLSetThreadLocalConfigOption( "OGR_GPKG_FOREIGN_KEY_CHECK", "NO" );
   }
 
+  // listing the directory of a file served over HTTP means downloading and parsing the index page
+  // of the server before reading the file itself. Sidecar files are still probed individually.
+  const bool modify_GDAL_DISABLE_READDIR_ON_OPEN = parts.value( QStringLiteral( "path" ) ).toString().startsWith( QLatin1String( "/vsicurl/" ), Qt::CaseInsensitive )
+      && !CPLGetConfigOption( "GDAL_DISABLE_READDIR_ON_OPEN", nullptr );
+  if ( modify_GDAL_DISABLE_READDIR_ON_OPEN )
+  {
+    CPLSetThreadLocalConfigOption( "GDAL_DISABLE_READDIR_ON_OPEN", "YES" );
+  }
+
   QString gdalUri = encodeGdalUri( parts );
   GDALDatasetH hDS = GDALOpenEx( gdalUri.toUtf8().constData(), nOpenFlags, nullptr, papszOpenOptions, nullptr );
 
@@ -342,6 +351,11 @@ GDALDatasetH QgsGdalProviderBase::gdalOpen( const QString &uri, unsigned int nOp
     CPLSetThreadLocalConfigOption( "OGR_GPKG_FOREIGN_KEY_CHECK", nullptr );
   }
 
+  if ( modify_GDAL_DISABLE_READDIR_ON_OPEN )
+  {
+    CPLSetThreadLocalConfigOption( "GDAL_DISABLE_READDIR_ON_OPEN", nullptr );
+  }
+
   return hDS;
 }
 
@@ -13,12 +13,14 @@
  *                                                                         *
  ***************************************************************************/
 #include "qgsmemoryfeatureiterator.h"
+#include "qgsfeaturebatch.h"
 #include "qgsmemoryprovider.h"
 
 #include "qgsgeometry.h"
 #include "qgsgeometryengine.h"
 #include "qgslogger.h"
 #include "qgsspatialindex.h"
+#include "qgsspatialfilterevaluator.h"
 #include "qgsmessagelog.h"
 #include "qgsproject.h"
 #include "qgsexception.h"
@@ -50,30 +52,8 @@ QgsMemoryFeatureIterator::QgsMemoryFeatureIterator( QgsMemoryFeatureSource *sour
     mSubsetExpression->prepare( mSource->expressionContext() );
   }
 
-  // prepare spatial filter geometries for optimal speed
-  switch ( mRequest.spatialFilterType() )
-  {
-    case Qgis::SpatialFilterType::NoFilter:
-      break;
-
-    case Qgis::SpatialFilterType::BoundingBox:
-      if ( !mFilterRect.isNull() && mRequest.flags() & QgsFeatureRequest::ExactIntersect )
-      {
-        mSelectRectGeom = QgsGeometry::fromRect( mFilterRect );
-        mSelectRectEngine.reset( QgsGeometry::createGeometryEngine( mSelectRectGeom.constGet() ) );
-        mSelectRectEngine->prepareGeometry();
-      }
-      break;
-
-    case Qgis::SpatialFilterType::DistanceWithin:
-      if ( !mRequest.referenceGeometry().isEmpty() )
-      {
-        mDistanceWithinGeom = mRequest.referenceGeometry();
-        mDistanceWithinEngine.reset( QgsGeometry::createGeometryEngine( mDistanceWithinGeom.constGet() ) );
-        mDistanceWithinEngine->prepareGeometry();
-      }
-      break;
-  }
+  // exact spatial filters are tested on the candidate features in parallel
+  mSpatialFilter = QgsSpatialFilterEvaluator::fromRequest( mRequest, mFilterRect );
 
   // if there's spatial index, use it!
   // (but don't use it when selection rect is not specified)
@@ -86,8 +66,7 @@ QgsMemoryFeatureIterator::QgsMemoryFeatureIterator( QgsMemoryFeatureSource *sour
   else if ( mRequest.filterType() == QgsFeatureRequest::FilterFid )
   {
     mUsingFeatureIdList = true;
-    const QgsFeatureMap::const_iterator it = mSource->mFeatures.constFind( mRequest.filterFid() );
-    if ( it != mSource->mFeatures.constEnd() )
+    if ( mSource->mFeatures.contains( mRequest.filterFid() ) )
       mFeatureIdList.append( mRequest.filterFid() );
   }
   else if ( mRequest.filterType() == QgsFeatureRequest::FilterFids )
@@ -116,12 +95,69 @@ bool QgsMemoryFeatureIterator::fetchFeature( QgsFeature &feature )
   if ( mClosed )
     return false;
 
-  if ( mUsingFeatureIdList )
-    return nextFeatureUsingList( feature );
+  bool hasFeature = false;
+  if ( mSpatialFilter )
+  {
+    hasFeature = mSpatialFilter->nextFeature( feature, [this]( QgsFeature & candidate ) { return nextCandidate( candidate ); } );
+
+    // intersections are tested in the source crs, distances in the destination crs
+    if ( hasFeature && mSpatialFilter->predicate() == QgsSpatialFilterEvaluator::Predicate::Intersects )
+      geometryToDestinationCrs( feature, mTransform );
+  }
   else
-    return nextFeatureTraverseAll( feature );
+  {
+    hasFeature = nextCandidate( feature );
+  }
+
+  feature.setValid( hasFeature );
+  if ( !hasFeature )
+    close();
+
+  return hasFeature;
+}
+
+bool QgsMemoryFeatureIterator::nextCandidate( QgsFeature &feature )
+{
+  const bool hasFeature = mUsingFeatureIdList ? nextFeatureUsingList( feature ) : nextFeatureTraverseAll( feature );
+
+  // geometry must be in destination crs before we can perform distance within check
+  if ( hasFeature && ( !mSpatialFilter || mSpatialFilter->predicate() == QgsSpatialFilterEvaluator::Predicate::DistanceWithin ) )
+    geometryToDestinationCrs( feature, mTransform );
+
+  return hasFeature;
+}
+
+
+bool QgsMemoryFeatureIterator::providerCanFetchBatch() const
+{
+  // all other filters are handled by fetchFeature()
+  return mRequest.filterType() != QgsFeatureRequest::FilterExpression;
 }
 
+void QgsMemoryFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  if ( mClosed )
+    return;
+
+  if ( mUsingFeatureIdList || !mFilterRect.isNull() || mSubsetExpression || mRequest.spatialFilterType() != Qgis::SpatialFilterType::NoFilter )
+  {
+    QgsAbstractFeatureIterator::fetchBatch( batch, maxFeatures );
+    return;
+  }
+
+  // every feature matches: read the attributes straight from the stored features
+  const QgsMemoryFeatureStore &features = mSource->mFeatures;
+  batch.reserve( maxFeatures );
+  while ( batch.size() < maxFeatures && mSelectRow < features.rowCount() )
+  {
+    if ( features.rowHasFeature( mSelectRow ) )
+      batch.appendFeature( features.rowFeature( mSelectRow ) );
+    ++mSelectRow;
+  }
+
+  if ( mSelectRow >= features.rowCount() )
+    close();
+}
 
 bool QgsMemoryFeatureIterator::nextFeatureUsingList( QgsFeature &feature )
 {
@@ -130,16 +166,10 @@ bool QgsMemoryFeatureIterator::nextFeatureUsingList( QgsFeature &feature )
   // option 1: we have a list of features to traverse
   while ( mFeatureIdListIterator != mFeatureIdList.constEnd() )
   {
-    feature = mSource->mFeatures.value( *mFeatureIdListIterator );
+    feature = mSource->mFeatures.feature( *mFeatureIdListIterator );
     if ( !mFilterRect.isNull() )
     {
-      if ( mRequest.spatialFilterType() == Qgis::SpatialFilterType::BoundingBox && mRequest.flags() & QgsFeatureRequest::ExactIntersect )
-      {
-        // do exact check in case we're doing intersection
-        if ( feature.hasGeometry() && mSelectRectEngine->intersects( feature.geometry().constGet() ) )
-          hasFeature = true;
-      }
-      else if ( mSource->mSpatialIndex )
+      if ( mSource->mSpatialIndex )
       {
         // using a spatial index - so we already know that the bounding box intersects correctly
         hasFeature = true;
@@ -164,28 +194,11 @@ bool QgsMemoryFeatureIterator::nextFeatureUsingList( QgsFeature &feature )
         hasFeature = false;
     }
 
-    if ( hasFeature )
-    {
-      // geometry must be in destination crs before we can perform distance within check
-      geometryToDestinationCrs( feature, mTransform );
-    }
-
-    if ( hasFeature && mRequest.spatialFilterType() == Qgis::SpatialFilterType::DistanceWithin )
-    {
-      hasFeature = mDistanceWithinEngine->distance( feature.geometry().constGet() ) <= mRequest.distanceWithin();
-    }
-
     ++mFeatureIdListIterator;
     if ( hasFeature )
       break;
   }
 
-  feature.setValid( hasFeature );
-  if ( !hasFeature )
-  {
-    close();
-  }
-
   return hasFeature;
 }
 
@@ -195,65 +208,35 @@ bool QgsMemoryFeatureIterator::nextFeatureTraverseAll( QgsFeature &feature )
   bool hasFeature = false;
 
   // option 2: traversing the whole layer
-  while ( mSelectIterator != mSource->mFeatures.constEnd() )
+  const QgsMemoryFeatureStore &features = mSource->mFeatures;
+  while ( mSelectRow < features.rowCount() )
   {
-    hasFeature = false;
-    feature = *mSelectIterator;
-    if ( mFilterRect.isNull() )
-    {
-      // selection rect empty => using all features
-      hasFeature = true;
-    }
-    else
-    {
-      if ( mRequest.spatialFilterType() == Qgis::SpatialFilterType::BoundingBox && mRequest.flags() & QgsFeatureRequest::ExactIntersect )
-      {
-        // using exact test when checking for intersection
-        if ( feature.hasGeometry() && mSelectRectEngine->intersects( feature.geometry().constGet() ) )
-          hasFeature = true;
-      }
-      else
-      {
-        // check just bounding box against rect when not using intersection
-        if ( feature.hasGeometry() && feature.geometry().boundingBox().intersects( mFilterRect ) )
-          hasFeature = true;
-      }
-    }
+    const int row = mSelectRow++;
+    if ( !features.rowHasFeature( row ) )
+      continue;
 
-    if ( hasFeature && mSubsetExpression )
+    // selection rect empty => using all features, otherwise check just bounding box against rect,
+    // before the feature is built. Exact intersections are tested by the spatial filter
+    if ( !mFilterRect.isNull() && ( !features.rowHasGeometry( row ) || !features.rowBoundingBox( row ).intersects( mFilterRect ) ) )
+      continue;
+
+    feature = features.rowFeature( row );
+    hasFeature = true;
+
+    if ( mSubsetExpression )
     {
       mSource->expressionContext()->setFeature( feature );
       if ( !mSubsetExpression->evaluate( mSource->expressionContext() ).toBool() )
         hasFeature = false;
     }
 
-    if ( hasFeature )
-    {
-      // geometry must be in destination crs before we can perform distance within check
-      geometryToDestinationCrs( feature, mTransform );
-    }
-
-    if ( hasFeature && mRequest.spatialFilterType() == Qgis::SpatialFilterType::DistanceWithin )
-    {
-      hasFeature = mDistanceWithinEngine->distance( feature.geometry().constGet() ) <= mRequest.distanceWithin();
-    }
-
-    ++mSelectIterator;
     if ( hasFeature )
       break;
   }
 
   // copy feature
   if ( hasFeature )
-  {
-    feature.setValid( true );
     feature.setFields( mSource->mFields ); // allow name-based attribute lookups
-  }
-  else
-  {
-    feature.setValid( false );
-    close();
-  }
 
   return hasFeature;
 }
@@ -266,7 +249,10 @@ bool QgsMemoryFeatureIterator::rewind()
   if ( mUsingFeatureIdList )
     mFeatureIdListIterator = mFeatureIdList.constBegin();
   else
-    mSelectIterator = mSource->mFeatures.constBegin();
+    mSelectRow = 0;
+
+  if ( mSpatialFilter )
+    mSpatialFilter->reset();
 
   return true;
 }
@@ -22,6 +22,7 @@
 #include "qgsfields.h"
 #include "qgsgeometry.h"
 #include "qgscoordinatetransform.h"
+#include "qgsmemoryfeaturestore.h"
 
 ///@cond PRIVATE
 
@@ -30,6 +31,7 @@ class QgsMemoryProvider;
 typedef QMap<QgsFeatureId, QgsFeature> QgsFeatureMap;
 
 class QgsSpatialIndex;
+class QgsSpatialFilterEvaluator;
 
 
 class QgsMemoryFeatureSource final: public QgsAbstractFeatureSource
@@ -43,7 +45,7 @@ class QgsMemoryFeatureSource final: public QgsAbstractFeatureSource
 
   private:
     QgsFields mFields;
-    QgsFeatureMap mFeatures;
+    QgsMemoryFeatureStore mFeatures;
     std::unique_ptr< QgsSpatialIndex > mSpatialIndex;
     QString mSubsetString;
     std::unique_ptr< QgsExpressionContext > mExpressionContext;
@@ -66,17 +68,18 @@ class QgsMemoryFeatureIterator final: public QgsAbstractFeatureIteratorFromSourc
   protected:
 
     bool fetchFeature( QgsFeature &feature ) override;
+    bool providerCanFetchBatch() const override;
+    void fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) override;
 
   private:
+    //! Retrieves the next feature matching the filters, apart from the exact spatial filter
+    bool nextCandidate( QgsFeature &feature );
     bool nextFeatureUsingList( QgsFeature &feature );
     bool nextFeatureTraverseAll( QgsFeature &feature );
 
-    QgsGeometry mSelectRectGeom;
-    std::unique_ptr< QgsGeometryEngine > mSelectRectEngine;
-    QgsGeometry mDistanceWithinGeom;
-    std::unique_ptr< QgsGeometryEngine > mDistanceWithinEngine;
+    std::unique_ptr< QgsSpatialFilterEvaluator > mSpatialFilter;
     QgsRectangle mFilterRect;
-    QgsFeatureMap::const_iterator mSelectIterator;
+    int mSelectRow = 0;
     bool mUsingFeatureIdList = false;
     QList<QgsFeatureId> mFeatureIdList;
     QList<QgsFeatureId>::const_iterator mFeatureIdListIterator;
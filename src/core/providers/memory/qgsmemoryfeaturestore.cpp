@@ -0,0 +1,694 @@
+/***************************************************************************
+    qgsmemoryfeaturestore.cpp
+    ---------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgsmemoryfeaturestore.h"
+#include "qgswkbgeometryview.h"
+
+#include <QSharedData>
+
+#include <algorithm>
+
+///@cond PRIVATE
+
+// removed rows are only dropped once they outnumber the features, so that deleting features stays cheap
+constexpr int COMPACT_MINIMUM_REMOVED_COUNT = 1024;
+constexpr int COMPACT_MINIMUM_UNUSED_WKB_SIZE = 1024 * 1024;
+// the WKB is split in buffers of this size, as a single QByteArray can't exceed 2 GiB
+constexpr int WKB_CHUNK_SIZE = 64 * 1024 * 1024;
+
+/**
+ * A column of attribute values of the same field.
+ *
+ * Values are kept in a vector of the native type when they all have the type of the field,
+ * and in a vector of variants otherwise.
+ */
+class QgsMemoryFeatureColumn
+{
+  public:
+
+    enum class Storage
+    {
+      Integer,
+      Double,
+      String,
+      Variant,
+    };
+
+    enum NullState : quint8
+    {
+      NotNull = 0,
+      TypedNull, //!< Null value of the field type
+      Invalid, //!< Invalid variant
+    };
+
+    explicit QgsMemoryFeatureColumn( QVariant::Type type = QVariant::Invalid, int rowCount = 0 )
+      : mType( type )
+    {
+      switch ( type )
+      {
+        case QVariant::Int:
+        case QVariant::LongLong:
+        case QVariant::Bool:
+          mStorage = Storage::Integer;
+          break;
+        case QVariant::Double:
+          mStorage = Storage::Double;
+          break;
+        case QVariant::String:
+          mStorage = Storage::String;
+          break;
+        default:
+          mStorage = Storage::Variant;
+          break;
+      }
+      resize( rowCount );
+    }
+
+    QVariant value( int row ) const
+    {
+      if ( mStorage == Storage::Variant )
+        return mVariants.at( row );
+
+      switch ( static_cast< NullState >( mNulls.at( row ) ) )
+      {
+        case Invalid:
+          return QVariant();
+        case TypedNull:
+          return QVariant( mType );
+        case NotNull:
+          break;
+      }
+
+      switch ( mStorage )
+      {
+        case Storage::Integer:
+          if ( mType == QVariant::Int )
+            return static_cast< int >( mIntegers.at( row ) );
+          else if ( mType == QVariant::Bool )
+            return static_cast< bool >( mIntegers.at( row ) );
+          return static_cast< qlonglong >( mIntegers.at( row ) );
+        case Storage::Double:
+          return mDoubles.at( row );
+        case Storage::String:
+          return mStrings.at( row );
+        case Storage::Variant:
+          break;
+      }
+      return QVariant();
+    }
+
+    void setValue( int row, const QVariant &value )
+    {
+      if ( mStorage != Storage::Variant && value.isValid() && value.type() != mType )
+      {
+        // the value would not be read back with its own type
+        convertToVariants();
+      }
+
+      if ( mStorage == Storage::Variant )
+      {
+        mVariants[row] = value;
+        return;
+      }
+
+      if ( !value.isValid() )
+      {
+        clearValue( row );
+        mNulls[row] = Invalid;
+        return;
+      }
+      if ( value.isNull() )
+      {
+        clearValue( row );
+        mNulls[row] = TypedNull;
+        return;
+      }
+
+      mNulls[row] = NotNull;
+      switch ( mStorage )
+      {
+        case Storage::Integer:
+          mIntegers[row] = value.toLongLong();
+          break;
+        case Storage::Double:
+          mDoubles[row] = value.toDouble();
+          break;
+        case Storage::String:
+          mStrings[row] = value.toString();
+          break;
+        case Storage::Variant:
+          break;
+      }
+    }
+
+    void resize( int rowCount )
+    {
+      switch ( mStorage )
+      {
+        case Storage::Integer:
+          mIntegers.resize( rowCount );
+          break;
+        case Storage::Double:
+          mDoubles.resize( rowCount );
+          break;
+        case Storage::String:
+          mStrings.resize( rowCount );
+          break;
+        case Storage::Variant:
+          mVariants.resize( rowCount );
+          return;
+      }
+      // new values are invalid, like the attributes added to existing features
+      const int previousCount = mNulls.size();
+      mNulls.resize( rowCount );
+      for ( int row = previousCount; row < rowCount; ++row )
+        mNulls[row] = Invalid;
+    }
+
+    void insertRow( int row )
+    {
+      switch ( mStorage )
+      {
+        case Storage::Integer:
+          mIntegers.insert( row, 0 );
+          break;
+        case Storage::Double:
+          mDoubles.insert( row, 0 );
+          break;
+        case Storage::String:
+          mStrings.insert( row, QString() );
+          break;
+        case Storage::Variant:
+          mVariants.insert( row, QVariant() );
+          return;
+      }
+      mNulls.insert( row, Invalid );
+    }
+
+    //! Releases the memory of the value at \a row
+    void clearValue( int row )
+    {
+      if ( mStorage == Storage::String )
+        mStrings[row].clear();
+      else if ( mStorage == Storage::Variant )
+        mVariants[row].clear();
+    }
+
+    //! Drops the rows which are set in \a removed
+    void compact( const QVector< bool > &removed )
+    {
+      int target = 0;
+      for ( int row = 0; row < removed.size(); ++row )
+      {
+        if ( removed.at( row ) )
+          continue;
+
+        switch ( mStorage )
+        {
+          case Storage::Integer:
+            mIntegers[target] = mIntegers.at( row );
+            break;
+          case Storage::Double:
+            mDoubles[target] = mDoubles.at( row );
+            break;
+          case Storage::String:
+            mStrings[target].swap( mStrings[row] );
+            break;
+          case Storage::Variant:
+            mVariants[target].swap( mVariants[row] );
+            break;
+        }
+        if ( mStorage != Storage::Variant )
+          mNulls[target] = mNulls.at( row );
+        ++target;
+      }
+      resize( target );
+      squeeze();
+    }
+
+    void squeeze()
+    {
+      mIntegers.squeeze();
+      mDoubles.squeeze();
+      mStrings.squeeze();
+      mVariants.squeeze();
+      mNulls.squeeze();
+    }
+
+  private:
+
+    void convertToVariants()
+    {
+      const int rowCount = mNulls.size();
+      QVector< QVariant > variants;
+      variants.reserve( rowCount );
+      for ( int row = 0; row < rowCount; ++row )
+        variants << value( row );
+
+      mStorage = Storage::Variant;
+      mVariants = variants;
+      mIntegers.clear();
+      mDoubles.clear();
+      mStrings.clear();
+      mNulls.clear();
+      squeeze();
+    }
+
+    QVariant::Type mType = QVariant::Invalid;
+    Storage mStorage = Storage::Variant;
+    QVector< qint64 > mIntegers;
+    QVector< double > mDoubles;
+    QVector< QString > mStrings;
+    QVector< QVariant > mVariants;
+    QVector< quint8 > mNulls;
+};
+
+class QgsMemoryFeatureStoreData : public QSharedData
+{
+  public:
+
+    QgsMemoryFeatureStore::Layout layout = QgsMemoryFeatureStore::Layout::Features;
+
+    //! Feature ids of the rows, in increasing order
+    QVector< QgsFeatureId > ids;
+    //! TRUE for the rows of removed features
+    QVector< bool > removed;
+    int removedCount = 0;
+
+    //! Features layout storage
+    QVector< QgsFeature > features;
+
+    //! Columnar layout storage
+    QList< QVariant::Type > fieldTypes;
+    QVector< QgsMemoryFeatureColumn > columns;
+    //! WKB of the geometries, a geometry is never split between two chunks
+    QVector< QByteArray > wkbChunks;
+    //! Position of the first byte of each chunk in the whole WKB
+    QVector< qint64 > wkbChunkStarts;
+    //! Size of the whole WKB
+    qint64 wkbSize = 0;
+    //! Size from which a new chunk is started
+    int wkbChunkSize = WKB_CHUNK_SIZE;
+    //! Position of the WKB of each row in the whole WKB
+    QVector< qint64 > wkbOffsets;
+    //! Size of the WKB of each row, or -1 if the feature has no geometry
+    QVector< int > wkbSizes;
+    //! Size of the WKB of replaced or removed geometries still in the chunks
+    qint64 unusedWkbSize = 0;
+
+    void insertRow( int row, QgsFeatureId id )
+    {
+      ids.insert( row, id );
+      removed.insert( row, false );
+      if ( layout == QgsMemoryFeatureStore::Layout::Features )
+      {
+        features.insert( row, QgsFeature() );
+        return;
+      }
+
+      for ( QgsMemoryFeatureColumn &column : columns )
+        column.insertRow( row );
+      wkbOffsets.insert( row, 0 );
+      wkbSizes.insert( row, -1 );
+    }
+
+    void setRowGeometry( int row, const QgsGeometry &geometry )
+    {
+      const int size = wkbSizes.at( row );
+      if ( size > 0 )
+        unusedWkbSize += size;
+
+      if ( geometry.isNull() )
+      {
+        wkbSizes[row] = -1;
+      }
+      else
+      {
+        const QByteArray geometryWkb = geometry.asWkb();
+        wkbOffsets[row] = appendWkb( geometryWkb.constData(), geometryWkb.size() );
+        wkbSizes[row] = geometryWkb.size();
+      }
+
+      if ( unusedWkbSize > COMPACT_MINIMUM_UNUSED_WKB_SIZE && unusedWkbSize > wkbSize / 2 )
+        compactWkb();
+    }
+
+    //! Appends \a size bytes of WKB to the last chunk, or to a new chunk if they don't fit, and returns their position
+    qint64 appendWkb( const char *data, int size )
+    {
+      if ( wkbChunks.isEmpty() || static_cast< qint64 >( wkbChunks.constLast().size() ) + size > wkbChunkSize )
+      {
+        wkbChunks.append( QByteArray() );
+        wkbChunkStarts.append( wkbSize );
+      }
+
+      const qint64 position = wkbSize;
+      wkbChunks.last().append( data, size );
+      wkbSize += size;
+      return position;
+    }
+
+    //! Returns the WKB at \a position in the \a chunks starting at \a chunkStarts in the \a chunks starting at \a chunkStarts
+    static const char *wkbData( const QVector< QByteArray > &chunks, const QVector< qint64 > &chunkStarts, qint64 position )
+    {
+      const int chunk = static_cast< int >( std::upper_bound( chunkStarts.constBegin(), chunkStarts.constEnd(), position ) - chunkStarts.constBegin() ) - 1;
+      return chunks.at( chunk ).constData() + ( position - chunkStarts.at( chunk ) );
+    }
+
+    QByteArray rowWkb( int row ) const
+    {
+      // the returned array shares the WKB buffer, and must not outlive the store
+      return QByteArray::fromRawData( wkbData( wkbChunks, wkbChunkStarts, wkbOffsets.at( row ) ), wkbSizes.at( row ) );
+    }
+
+    void compactWkb()
+    {
+      QVector< QByteArray > chunks;
+      chunks.swap( wkbChunks );
+      QVector< qint64 > chunkStarts;
+      chunkStarts.swap( wkbChunkStarts );
+      wkbSize = 0;
+      for ( int row = 0; row < wkbSizes.size(); ++row )
+      {
+        const int size = wkbSizes.at( row );
+        if ( size < 0 )
+          continue;
+        wkbOffsets[row] = appendWkb( wkbData( chunks, chunkStarts, wkbOffsets.at( row ) ), size );
+      }
+      unusedWkbSize = 0;
+    }
+
+    void compact()
+    {
+      int target = 0;
+      for ( int row = 0; row < ids.size(); ++row )
+      {
+        if ( removed.at( row ) )
+          continue;
+
+        ids[target] = ids.at( row );
+        if ( layout == QgsMemoryFeatureStore::Layout::Features )
+        {
+          features[target] = features.at( row );
+        }
+        else
+        {
+          wkbOffsets[target] = wkbOffsets.at( row );
+          wkbSizes[target] = wkbSizes.at( row );
+        }
+        ++target;
+      }
+
+      for ( QgsMemoryFeatureColumn &column : columns )
+        column.compact( removed );
+
+      ids.resize( target );
+      ids.squeeze();
+      removed.fill( false, target );
+      removed.squeeze();
+      removedCount = 0;
+      if ( layout == QgsMemoryFeatureStore::Layout::Features )
+      {
+        features.resize( target );
+        features.squeeze();
+      }
+      else
+      {
+        wkbOffsets.resize( target );
+        wkbOffsets.squeeze();
+        wkbSizes.resize( target );
+        wkbSizes.squeeze();
+        compactWkb();
+      }
+    }
+};
+
+QgsMemoryFeatureStore::QgsMemoryFeatureStore( Layout layout, const QList< QVariant::Type > &fieldTypes )
+  : d( new QgsMemoryFeatureStoreData() )
+{
+  d->layout = layout;
+  for ( const QVariant::Type type : fieldTypes )
+    appendField( type );
+}
+
+QgsMemoryFeatureStore::QgsMemoryFeatureStore( const QgsMemoryFeatureStore &other ) = default;
+
+QgsMemoryFeatureStore &QgsMemoryFeatureStore::operator=( const QgsMemoryFeatureStore &other ) = default;
+
+QgsMemoryFeatureStore::~QgsMemoryFeatureStore() = default;
+
+QgsMemoryFeatureStore::Layout QgsMemoryFeatureStore::layout() const
+{
+  return d->layout;
+}
+
+int QgsMemoryFeatureStore::count() const
+{
+  return d->ids.size() - d->removedCount;
+}
+
+bool QgsMemoryFeatureStore::contains( QgsFeatureId id ) const
+{
+  return rowOf( id ) >= 0;
+}
+
+QgsFeature QgsMemoryFeatureStore::feature( QgsFeatureId id ) const
+{
+  const int row = rowOf( id );
+  return row >= 0 ? rowFeature( row ) : QgsFeature();
+}
+
+void QgsMemoryFeatureStore::insert( const QgsFeature &feature )
+{
+  const QgsFeatureId id = feature.id();
+  // features are mostly added with increasing ids
+  auto it = !d->ids.isEmpty() && d->ids.constLast() < id ? d->ids.constEnd() : std::lower_bound( d->ids.constBegin(), d->ids.constEnd(), id );
+  const int row = static_cast< int >( it - d->ids.constBegin() );
+  if ( it == d->ids.constEnd() || *it != id )
+  {
+    d->insertRow( row, id );
+  }
+  else if ( d->removed.at( row ) )
+  {
+    d->removed[row] = false;
+    d->removedCount--;
+  }
+
+  if ( d->layout == Layout::Features )
+  {
+    d->features[row] = feature;
+    return;
+  }
+
+  const QgsAttributes attributes = feature.attributes();
+  for ( int field = 0; field < d->columns.size(); ++field )
+    d->columns[field].setValue( row, attributes.value( field ) );
+  d->setRowGeometry( row, feature.geometry() );
+}
+
+bool QgsMemoryFeatureStore::remove( QgsFeatureId id )
+{
+  const int row = rowOf( id );
+  if ( row < 0 )
+    return false;
+
+  d->removed[row] = true;
+  d->removedCount++;
+  if ( d->layout == Layout::Features )
+  {
+    d->features[row] = QgsFeature();
+  }
+  else
+  {
+    for ( QgsMemoryFeatureColumn &column : d->columns )
+      column.clearValue( row );
+    d->setRowGeometry( row, QgsGeometry() );
+  }
+
+  if ( d->removedCount > COMPACT_MINIMUM_REMOVED_COUNT && d->removedCount > d->ids.size() / 2 )
+    d->compact();
+  return true;
+}
+
+void QgsMemoryFeatureStore::clear()
+{
+  const Layout layout = d->layout;
+  const QList< QVariant::Type > fieldTypes = d->fieldTypes;
+  const int wkbChunkSize = d->wkbChunkSize;
+  *this = QgsMemoryFeatureStore( layout, fieldTypes );
+  d->wkbChunkSize = wkbChunkSize;
+}
+
+QVariant QgsMemoryFeatureStore::attribute( QgsFeatureId id, int field ) const
+{
+  const int row = rowOf( id );
+  if ( row < 0 )
+    return QVariant();
+
+  if ( d->layout == Layout::Features )
+    return d->features.at( row ).attribute( field );
+  return field >= 0 && field < d->columns.size() ? d->columns.at( field ).value( row ) : QVariant();
+}
+
+bool QgsMemoryFeatureStore::setAttribute( QgsFeatureId id, int field, const QVariant &value )
+{
+  const int row = rowOf( id );
+  if ( row < 0 )
+    return false;
+
+  if ( d->layout == Layout::Features )
+    return d->features[row].setAttribute( field, value );
+
+  if ( field < 0 || field >= d->columns.size() )
+    return false;
+  d->columns[field].setValue( row, value );
+  return true;
+}
+
+bool QgsMemoryFeatureStore::setGeometry( QgsFeatureId id, const QgsGeometry &geometry )
+{
+  const int row = rowOf( id );
+  if ( row < 0 )
+    return false;
+
+  if ( d->layout == Layout::Features )
+    d->features[row].setGeometry( geometry );
+  else
+    d->setRowGeometry( row, geometry );
+  return true;
+}
+
+void QgsMemoryFeatureStore::appendField( QVariant::Type type )
+{
+  d->fieldTypes.append( type );
+  if ( d->layout == Layout::Features )
+  {
+    for ( int row = 0; row < d->features.size(); ++row )
+    {
+      if ( d->removed.at( row ) )
+        continue;
+      QgsFeature &f = d->features[row];
+      QgsAttributes attr = f.attributes();
+      attr.append( QVariant() );
+      f.setAttributes( attr );
+    }
+    return;
+  }
+
+  d->columns.append( QgsMemoryFeatureColumn( type, d->ids.size() ) );
+}
+
+void QgsMemoryFeatureStore::removeField( int index )
+{
+  if ( index < 0 || index >= d->fieldTypes.size() )
+    return;
+
+  d->fieldTypes.removeAt( index );
+  if ( d->layout == Layout::Features )
+  {
+    for ( int row = 0; row < d->features.size(); ++row )
+    {
+      if ( d->removed.at( row ) )
+        continue;
+      QgsFeature &f = d->features[row];
+      QgsAttributes attr = f.attributes();
+      attr.remove( index );
+      f.setAttributes( attr );
+    }
+    return;
+  }
+
+  d->columns.remove( index );
+}
+
+int QgsMemoryFeatureStore::rowCount() const
+{
+  return d->ids.size();
+}
+
+bool QgsMemoryFeatureStore::rowHasFeature( int row ) const
+{
+  return !d->removed.at( row );
+}
+
+QgsFeatureId QgsMemoryFeatureStore::rowId( int row ) const
+{
+  return d->ids.at( row );
+}
+
+QgsFeature QgsMemoryFeatureStore::rowFeature( int row ) const
+{
+  if ( d->layout == Layout::Features )
+    return d->features.at( row );
+
+  QgsFeature feature( d->ids.at( row ) );
+  QgsAttributes attributes( d->columns.size() );
+  for ( int field = 0; field < d->columns.size(); ++field )
+    attributes[field] = d->columns.at( field ).value( row );
+  feature.setAttributes( attributes );
+  feature.setGeometry( rowGeometry( row ) );
+  feature.setValid( true );
+  return feature;
+}
+
+bool QgsMemoryFeatureStore::rowHasGeometry( int row ) const
+{
+  if ( d->layout == Layout::Features )
+    return d->features.at( row ).hasGeometry();
+  return d->wkbSizes.at( row ) >= 0;
+}
+
+QgsGeometry QgsMemoryFeatureStore::rowGeometry( int row ) const
+{
+  if ( d->layout == Layout::Features )
+    return d->features.at( row ).geometry();
+
+  if ( d->wkbSizes.at( row ) < 0 )
+    return QgsGeometry();
+
+  QgsGeometry geometry;
+  // fromWkb() copies the WKB into the created geometry
+  geometry.fromWkb( d->rowWkb( row ) );
+  return geometry;
+}
+
+QgsRectangle QgsMemoryFeatureStore::rowBoundingBox( int row ) const
+{
+  if ( d->layout == Layout::Features )
+  {
+    const QgsFeature &feature = d->features.at( row );
+    return feature.hasGeometry() ? feature.geometry().boundingBox() : QgsRectangle();
+  }
+
+  if ( d->wkbSizes.at( row ) < 0 )
+    return QgsRectangle();
+
+  return QgsWkbGeometryView( d->rowWkb( row ) ).boundingBox();
+}
+
+void QgsMemoryFeatureStore::setWkbChunkSize( int size )
+{
+  d->wkbChunkSize = size;
+}
+
+int QgsMemoryFeatureStore::rowOf( QgsFeatureId id ) const
+{
+  const auto it = std::lower_bound( d->ids.constBegin(), d->ids.constEnd(), id );
+  if ( it == d->ids.constEnd() || *it != id )
+    return -1;
+
+  const int row = static_cast< int >( it - d->ids.constBegin() );
+  return d->removed.at( row ) ? -1 : row;
+}
+
+///@endcond
@@ -0,0 +1,149 @@
+/***************************************************************************
+    qgsmemoryfeaturestore.h
+    ---------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSMEMORYFEATURESTORE_H
+#define QGSMEMORYFEATURESTORE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeature.h"
+
+#include <QSharedDataPointer>
+
+///@cond PRIVATE
+
+class QgsMemoryFeatureStoreData;
+
+/**
+ * \ingroup core
+ * \brief Storage of the features of the memory provider.
+ *
+ * Features are stored in rows ordered by feature id, and looked up by a binary search.
+ * Removed features leave empty rows until enough rows are removed for the store to be
+ * compacted, so row numbers are only stable while the store is not modified.
+ *
+ * With the Columnar layout the attributes are stored in one typed column per field,
+ * and the geometries as WKB in buffers of 64 MiB. Features are built from the columns when
+ * they are read, which uses several times less memory than storing the features themselves,
+ * at the cost of parsing the geometries on each read.
+ *
+ * The store is implicitly shared, so a copy is an inexpensive snapshot of the features.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsMemoryFeatureStore
+{
+  public:
+
+    //! Layout of the stored features
+    enum class Layout
+    {
+      Features, //!< Features stored as they are added
+      Columnar, //!< Attributes stored in typed columns, and geometries as WKB
+    };
+
+    /**
+     * Constructor for an empty store with the given \a layout, for features
+     * with attributes of the \a fieldTypes.
+     */
+    explicit QgsMemoryFeatureStore( Layout layout = Layout::Features, const QList< QVariant::Type > &fieldTypes = QList< QVariant::Type >() );
+
+    QgsMemoryFeatureStore( const QgsMemoryFeatureStore &other );
+    QgsMemoryFeatureStore &operator=( const QgsMemoryFeatureStore &other );
+    ~QgsMemoryFeatureStore();
+
+    //! Returns the layout of the stored features
+    Layout layout() const;
+
+    //! Returns the number of features in the store
+    int count() const;
+
+    //! Returns TRUE if the store has no features
+    bool isEmpty() const { return count() == 0; }
+
+    //! Returns TRUE if the store has a feature with the given \a id
+    bool contains( QgsFeatureId id ) const;
+
+    //! Returns the feature with the given \a id, or an invalid feature if there is none
+    QgsFeature feature( QgsFeatureId id ) const;
+
+    /**
+     * Adds a \a feature to the store, replacing the stored feature with the same id.
+     * The feature must have an attribute for each field of the store.
+     */
+    void insert( const QgsFeature &feature );
+
+    //! Removes the feature with the given \a id, returning FALSE if there is none
+    bool remove( QgsFeatureId id );
+
+    //! Removes all the features
+    void clear();
+
+    //! Returns the value of the attribute \a field of the feature \a id
+    QVariant attribute( QgsFeatureId id, int field ) const;
+
+    //! Sets the \a value of the attribute \a field of the feature \a id, returning FALSE if there is no such feature
+    bool setAttribute( QgsFeatureId id, int field, const QVariant &value );
+
+    //! Sets the \a geometry of the feature \a id, returning FALSE if there is no such feature
+    bool setGeometry( QgsFeatureId id, const QgsGeometry &geometry );
+
+    //! Appends a field of the given \a type, with null values for the existing features
+    void appendField( QVariant::Type type );
+
+    //! Removes the field at \a index
+    void removeField( int index );
+
+    //! Returns the number of rows, including the rows of removed features
+    int rowCount() const;
+
+    //! Returns TRUE if the \a row contains a feature, i.e. the feature was not removed
+    bool rowHasFeature( int row ) const;
+
+    //! Returns the id of the feature at \a row
+    QgsFeatureId rowId( int row ) const;
+
+    //! Returns the feature at \a row
+    QgsFeature rowFeature( int row ) const;
+
+    //! Returns TRUE if the feature at \a row has a geometry
+    bool rowHasGeometry( int row ) const;
+
+    //! Returns the geometry of the feature at \a row
+    QgsGeometry rowGeometry( int row ) const;
+
+    /**
+     * Returns the bounding box of the geometry of the feature at \a row.
+     *
+     * With the Columnar layout the bounding box is read from the WKB, without creating the geometry.
+     */
+    QgsRectangle rowBoundingBox( int row ) const;
+
+  private:
+
+    QSharedDataPointer< QgsMemoryFeatureStoreData > d;
+
+    //! Returns the row of the feature \a id, or -1 if there is none
+    int rowOf( QgsFeatureId id ) const;
+
+    //! Sets the \a size from which the WKB of the Columnar layout is stored in a new buffer
+    void setWkbChunkSize( int size );
+
+    friend class TestQgsMemoryFeatureStore;
+};
+
+///@endcond
+
+#endif // QGSMEMORYFEATURESTORE_H
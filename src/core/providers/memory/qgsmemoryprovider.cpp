@@ -75,6 +75,11 @@ QgsMemoryProvider::QgsMemoryProvider( const QString &uri, const ProviderOptions
 
   mNextFeatureId = 1;
 
+  if ( query.hasQueryItem( QStringLiteral( "storage" ) ) && query.queryItemValue( QStringLiteral( "storage" ) ) == QLatin1String( "columnar" ) )
+  {
+    mFeatures = QgsMemoryFeatureStore( QgsMemoryFeatureStore::Layout::Columnar );
+  }
+
   setNativeTypes( QList< NativeType >()
                   << QgsVectorDataProvider::NativeType( tr( "Whole Number (integer)" ), QStringLiteral( "integer" ), QVariant::Int, 0, 10 )
                   // Decimal number from OGR/Shapefile/dbf may come with length up to 32 and
@@ -277,6 +282,10 @@ QString QgsMemoryProvider::dataSourceUri( bool expandAuthConfig ) const
   {
     query.addQueryItem( QStringLiteral( "index" ), QStringLiteral( "yes" ) );
   }
+  if ( mFeatures.layout() == QgsMemoryFeatureStore::Layout::Columnar )
+  {
+    query.addQueryItem( QStringLiteral( "storage" ), QStringLiteral( "columnar" ) );
+  }
 
   QgsAttributeList attrs = const_cast<QgsMemoryProvider *>( this )->attributeIndexes();
   for ( int i = 0; i < attrs.size(); i++ )
@@ -340,11 +349,10 @@ QgsRectangle QgsMemoryProvider::extent() const
     if ( mSubsetString.isEmpty() )
     {
       // fast way - iterate through all features
-      const auto constMFeatures = mFeatures;
-      for ( const QgsFeature &feat : constMFeatures )
+      for ( int row = 0; row < mFeatures.rowCount(); ++row )
       {
-        if ( feat.hasGeometry() )
-          mExtent.combineExtentWith( feat.geometry().boundingBox() );
+        if ( mFeatures.rowHasFeature( row ) && mFeatures.rowHasGeometry( row ) )
+          mExtent.combineExtentWith( mFeatures.rowBoundingBox( row ) );
       }
     }
     else
@@ -501,7 +509,7 @@ bool QgsMemoryProvider::addFeatures( QgsFeatureList &flist, Flags flags )
       continue;
     }
 
-    mFeatures.insert( mNextFeatureId, *it );
+    mFeatures.insert( *it );
     addedFids.insert( mNextFeatureId );
 
     if ( it->hasGeometry() )
@@ -539,17 +547,15 @@ bool QgsMemoryProvider::deleteFeatures( const QgsFeatureIds &id )
 {
   for ( QgsFeatureIds::const_iterator it = id.begin(); it != id.end(); ++it )
   {
-    const QgsFeatureMap::iterator fit = mFeatures.find( *it );
-
     // check whether such feature exists
-    if ( fit == mFeatures.end() )
+    if ( !mFeatures.contains( *it ) )
       continue;
 
     // update spatial index
     if ( mSpatialIndex )
-      mSpatialIndex->deleteFeature( *fit );
+      mSpatialIndex->deleteFeature( mFeatures.feature( *it ) );
 
-    mFeatures.erase( fit );
+    mFeatures.remove( *it );
   }
 
   updateExtents();
@@ -597,13 +603,7 @@ bool QgsMemoryProvider::addAttributes( const QList<QgsField> &attributes )
     mFields.append( field );
     fieldWasAdded = true;
 
-    for ( QgsFeatureMap::iterator fit = mFeatures.begin(); fit != mFeatures.end(); ++fit )
-    {
-      QgsFeature &f = fit.value();
-      QgsAttributes attr = f.attributes();
-      attr.append( QVariant() );
-      f.setAttributes( attr );
-    }
+    mFeatures.appendField( field.type() );
   }
   return fieldWasAdded;
 }
@@ -642,14 +642,7 @@ bool QgsMemoryProvider::deleteAttributes( const QgsAttributeIds &attributes )
   {
     const int idx = *it;
     mFields.remove( idx );
-
-    for ( QgsFeatureMap::iterator fit = mFeatures.begin(); fit != mFeatures.end(); ++fit )
-    {
-      QgsFeature &f = fit.value();
-      QgsAttributes attr = f.attributes();
-      attr.remove( idx );
-      f.setAttributes( attr );
-    }
+    mFeatures.removeField( idx );
   }
   clearMinMaxCache();
   return true;
@@ -664,8 +657,7 @@ bool QgsMemoryProvider::changeAttributeValues( const QgsChangedAttributesMap &at
   QString errorMessage;
   for ( QgsChangedAttributesMap::const_iterator it = attr_map.begin(); it != attr_map.end(); ++it )
   {
-    const QgsFeatureMap::iterator fit = mFeatures.find( it.key() );
-    if ( fit == mFeatures.end() )
+    if ( !mFeatures.contains( it.key() ) )
       continue;
 
     const QgsAttributeMap &attrs = it.value();
@@ -690,8 +682,8 @@ bool QgsMemoryProvider::changeAttributeValues( const QgsChangedAttributesMap &at
         result = false;
         break;
       }
-      rollBackAttrs.insert( it2.key(), fit->attribute( it2.key() ) );
-      fit->setAttribute( it2.key(), attrValue );
+      rollBackAttrs.insert( it2.key(), mFeatures.attribute( it.key(), it2.key() ) );
+      mFeatures.setAttribute( it.key(), it2.key(), attrValue );
     }
     rollBackMap.insert( it.key(), rollBackAttrs );
   }
@@ -712,19 +704,18 @@ bool QgsMemoryProvider::changeGeometryValues( const QgsGeometryMap &geometry_map
 {
   for ( QgsGeometryMap::const_iterator it = geometry_map.begin(); it != geometry_map.end(); ++it )
   {
-    const QgsFeatureMap::iterator fit = mFeatures.find( it.key() );
-    if ( fit == mFeatures.end() )
+    if ( !mFeatures.contains( it.key() ) )
       continue;
 
     // update spatial index
     if ( mSpatialIndex )
-      mSpatialIndex->deleteFeature( *fit );
+      mSpatialIndex->deleteFeature( mFeatures.feature( it.key() ) );
 
-    fit->setGeometry( it.value() );
+    mFeatures.setGeometry( it.key(), it.value() );
 
     // update spatial index
-    if ( mSpatialIndex )
-      mSpatialIndex->addFeature( *fit );
+    if ( mSpatialIndex && !it.value().isNull() )
+      mSpatialIndex->addFeature( it.key(), it.value().boundingBox() );
   }
 
   updateExtents();
@@ -766,9 +757,10 @@ bool QgsMemoryProvider::createSpatialIndex()
     mSpatialIndex = new QgsSpatialIndex();
 
     // add existing features to index
-    for ( QgsFeatureMap::iterator it = mFeatures.begin(); it != mFeatures.end(); ++it )
+    for ( int row = 0; row < mFeatures.rowCount(); ++row )
     {
-      mSpatialIndex->addFeature( *it );
+      if ( mFeatures.rowHasFeature( row ) && mFeatures.rowHasGeometry( row ) )
+        mSpatialIndex->addFeature( mFeatures.rowId( row ), mFeatures.rowBoundingBox( row ) );
     }
   }
   return true;
@@ -19,6 +19,7 @@
 #include "qgscoordinatereferencesystem.h"
 #include "qgsfields.h"
 #include "qgsprovidermetadata.h"
+#include "qgsmemoryfeaturestore.h"
 
 ///@cond PRIVATE
 typedef QMap<QgsFeatureId, QgsFeature> QgsFeatureMap;
@@ -87,7 +88,7 @@ class QgsMemoryProvider final: public QgsVectorDataProvider
     mutable QgsRectangle mExtent;
 
     // features
-    QgsFeatureMap mFeatures;
+    QgsMemoryFeatureStore mFeatures;
     QgsFeatureId mNextFeatureId;
 
     // indexing
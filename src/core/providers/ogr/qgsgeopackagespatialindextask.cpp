@@ -0,0 +1,79 @@
+/***************************************************************************
+  qgsgeopackagespatialindextask.cpp - QgsGeoPackageSpatialIndexTask
+
+ ---------------------
+ begin                : October 2022
+ copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgsgeopackagespatialindextask.h"
+#include "qgsogrutils.h"
+#include "qgsmessagelog.h"
+#include "qgssqliteutils.h"
+
+#include <cpl_error.h>
+
+
+///@cond PRIVATE
+
+
+QgsGeoPackageSpatialIndexTask::QgsGeoPackageSpatialIndexTask( const QString &path, const QString &layerName )
+  : QgsTask( tr( "Creating spatial index of %1" ).arg( layerName ), QgsTask::Flags() )
+  , mPath( path )
+  , mLayerName( layerName )
+{
+
+}
+
+bool QgsGeoPackageSpatialIndexTask::createSpatialIndex( GDALDatasetH dataset, const QString &layerName, QString *errorMessage )
+{
+  OGRLayerH layer = GDALDatasetGetLayerByName( dataset, layerName.toUtf8().constData() );
+  if ( !layer )
+  {
+    if ( errorMessage )
+      *errorMessage = tr( "Layer %1 not found" ).arg( layerName );
+    return false;
+  }
+
+  // the R-tree is filled by a single statement, instead of by triggers on each insertion
+  const QString sql = QStringLiteral( "SELECT CreateSpatialIndex(%1, %2)" ).arg( QgsSqliteUtils::quotedString( layerName ),
+                      QgsSqliteUtils::quotedString( QString::fromUtf8( OGR_L_GetGeometryColumn( layer ) ) ) );
+  CPLErrorReset();
+  if ( OGRLayerH result = GDALDatasetExecuteSQL( dataset, sql.toUtf8().constData(), nullptr, nullptr ) )
+    GDALDatasetReleaseResultSet( dataset, result );
+  if ( CPLGetLastErrorType() == CE_Failure )
+  {
+    if ( errorMessage )
+      *errorMessage = tr( "Creation of spatial index failed (OGR error: %1)" ).arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
+    return false;
+  }
+  return true;
+}
+
+bool QgsGeoPackageSpatialIndexTask::run()
+{
+  gdal::dataset_unique_ptr dataset( GDALOpenEx( mPath.toUtf8().constData(), GDAL_OF_VECTOR | GDAL_OF_UPDATE, nullptr, nullptr, nullptr ) );
+  if ( !dataset )
+  {
+    mErrorMessage = tr( "Opening of data source in update mode failed (OGR error: %1)" ).arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
+    return false;
+  }
+  return createSpatialIndex( dataset.get(), mLayerName, &mErrorMessage );
+}
+
+void QgsGeoPackageSpatialIndexTask::finished( bool result )
+{
+  if ( !result )
+  {
+    QgsMessageLog::logMessage( mErrorMessage, tr( "OGR" ) );
+    emit errorOccurred( mErrorMessage );
+  }
+}
+
+///@endcond
@@ -0,0 +1,78 @@
+/***************************************************************************
+  qgsgeopackagespatialindextask.h - QgsGeoPackageSpatialIndexTask
+
+ ---------------------
+ begin                : October 2022
+ copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSGEOPACKAGESPATIALINDEXTASK_H
+#define QGSGEOPACKAGESPATIALINDEXTASK_H
+
+
+///@cond PRIVATE
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgstaskmanager.h"
+
+#include <gdal.h>
+
+
+/**
+ * \class QgsGeoPackageSpatialIndexTask
+ * QgsTask task which builds the spatial index of a GeoPackage layer in bulk, as a background
+ * task. This is used by QgsVectorFileWriter to create the index of layers written without
+ * a spatial index once all their features are written.
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsGeoPackageSpatialIndexTask : public QgsTask
+{
+    Q_OBJECT
+
+  public:
+
+    /**
+     * Constructor for QgsGeoPackageSpatialIndexTask, building the spatial index of the
+     * \a layerName layer of the GeoPackage at \a path.
+     */
+    QgsGeoPackageSpatialIndexTask( const QString &path, const QString &layerName );
+
+    /**
+     * Builds the spatial index of the \a layerName layer of an opened GeoPackage \a dataset.
+     * Returns FALSE and sets \a errorMessage if the index cannot be built.
+     */
+    static bool createSpatialIndex( GDALDatasetH dataset, const QString &layerName, QString *errorMessage = nullptr );
+
+  signals:
+
+    /**
+     * Emitted when an error occurs which prevented the spatial index being built, with
+     * the \a errorMessage of the error.
+     */
+    void errorOccurred( const QString &errorMessage );
+
+  protected:
+
+    bool run() override;
+    void finished( bool result ) override;
+
+  private:
+
+    QString mPath;
+    QString mLayerName;
+    QString mErrorMessage;
+
+};
+
+
+///@endcond
+
+#endif // QGSGEOPACKAGESPATIALINDEXTASK_H
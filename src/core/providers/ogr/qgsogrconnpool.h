@@ -92,7 +92,13 @@ class QgsOgrConnPoolGroup : public QObject, public QgsConnectionPoolGroup<QgsOgr
     //! QgsOgrConnPoolGroup cannot be copied
     QgsOgrConnPoolGroup &operator=( const QgsOgrConnPoolGroup &other ) = delete;
 
-    void ref() { ++mRefCount; }
+    void ref()
+    {
+      // while providers use the datasource, keep one handle open so that the next requests
+      // don't have to open it again after being idle for a while
+      if ( ++mRefCount == 1 )
+        setWarmConnectionCount( 1 );
+    }
     bool unref()
     {
       Q_ASSERT( mRefCount > 0 );
@@ -27,8 +27,12 @@
 #include "qgsogrtransaction.h"
 #include "qgssymbol.h"
 #include "qgsgeometryengine.h"
+#include "qgsspatialfilterevaluator.h"
 #include "qgsdbquerylog.h"
+#include "qgsfeaturebatch.h"
+#include "qgslogger.h"
 
+#include <QHash>
 #include <QTextCodec>
 #include <QFile>
 
@@ -41,6 +45,292 @@
 
 ///@cond PRIVATE
 
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+
+/**
+ * Fills feature batches from the record batches of an OGR Arrow stream,
+ * which avoids creating an OGRFeature for every feature.
+ */
+class QgsOgrArrowBatchReader
+{
+  public:
+
+    ~QgsOgrArrowBatchReader()
+    {
+      if ( mArray.release )
+        mArray.release( &mArray );
+      if ( mSchema.release )
+        mSchema.release( &mSchema );
+      if ( mStream.release )
+        mStream.release( &mStream );
+    }
+
+    /**
+     * Opens the Arrow stream of \a layer and maps its columns to the columns of \a batch.
+     * \a fetchedAttributes lists the attributes fetched by the request (all attributes if empty).
+     * Returns FALSE if the stream cannot be used to fill the batch.
+     */
+    bool open( OGRLayerH layer, const QgsFeatureBatch &batch, const QgsFields &fields, bool firstFieldIsFid, const QVector< int > &fetchedAttributes, QTextCodec *encoding )
+    {
+      mEncoding = encoding;
+
+      char **options = nullptr;
+      options = CSLSetNameValue( options, "INCLUDE_FID", "YES" );
+      const bool ok = OGR_L_GetArrowStream( layer, &mStream, options );
+      CSLDestroy( options );
+      if ( !ok || mStream.get_schema( &mStream, &mSchema ) != 0 )
+        return false;
+
+      QString fidColumn = QString::fromUtf8( OGR_L_GetFIDColumn( layer ) );
+      if ( fidColumn.isEmpty() )
+        fidColumn = QStringLiteral( "OGC_FID" );
+
+      QHash< QString, int > children;
+      for ( int child = 0; child < mSchema.n_children; ++child )
+      {
+        const char *name = mSchema.children[child]->name;
+        children.insert( encoding ? encoding->toUnicode( name ) : QString::fromUtf8( name ), child );
+      }
+
+      mFidChild = children.value( fidColumn, -1 );
+      if ( mFidChild < 0 || formatForChild( mFidChild ) != Format::Int64 )
+        return false;
+
+      mColumnChildren.resize( batch.columnCount() );
+      mColumnFormats.resize( batch.columnCount() );
+      for ( int i = 0; i < batch.columnCount(); ++i )
+      {
+        const int idx = batch.columnFieldIndex( i );
+        if ( firstFieldIsFid && idx == 0 )
+        {
+          mColumnChildren[i] = mFidChild;
+          mColumnFormats[i] = Format::Int64;
+        }
+        else if ( idx >= fields.count() || ( !fetchedAttributes.isEmpty() && !std::binary_search( fetchedAttributes.constBegin(), fetchedAttributes.constEnd(), idx ) ) )
+        {
+          // attributes which are not fetched are left NULL
+          mColumnChildren[i] = -1;
+          continue;
+        }
+        else
+        {
+          mColumnChildren[i] = children.value( fields.at( idx ).name(), -1 );
+          if ( mColumnChildren[i] < 0 )
+            return false;
+          mColumnFormats[i] = formatForChild( mColumnChildren[i] );
+        }
+
+        if ( !canFill( batch.column( i ).type(), mColumnFormats[i], fields.at( idx ).type() ) )
+          return false;
+      }
+
+      return true;
+    }
+
+    /**
+     * Appends up to \a maxFeatures features to \a batch.
+     * Returns FALSE once the stream is exhausted or failed.
+     */
+    bool read( QgsFeatureBatch &batch, int maxFeatures )
+    {
+      while ( batch.size() < maxFeatures )
+      {
+        if ( !mArray.release || mRow >= mArray.length )
+        {
+          if ( mArray.release )
+            mArray.release( &mArray );
+          mRow = 0;
+          if ( mStream.get_next( &mStream, &mArray ) != 0 )
+          {
+            QgsDebugMsg( QStringLiteral( "Error while reading Arrow stream: %1" ).arg( QString::fromUtf8( mStream.get_last_error( &mStream ) ) ) );
+            return false;
+          }
+          if ( !mArray.release )
+            return false;
+          continue;
+        }
+
+        const int64_t rows = std::min< int64_t >( mArray.length - mRow, maxFeatures - batch.size() );
+        for ( int64_t row = mRow; row < mRow + rows; ++row )
+        {
+          batch.appendId( value< int64_t >( mArray.children[mFidChild], row ) );
+          for ( int i = 0; i < batch.columnCount(); ++i )
+          {
+            QgsFeatureBatch::Column &column = batch.column( i );
+            const int child = mColumnChildren.at( i );
+            if ( child < 0 )
+            {
+              column.appendNull();
+              continue;
+            }
+            appendValue( column, mArray.children[child], mColumnFormats.at( i ), row );
+          }
+        }
+        mRow += rows;
+      }
+      return true;
+    }
+
+  private:
+
+    //! Arrow formats which can be read into batches
+    enum class Format
+    {
+      Unsupported,
+      Bool,
+      Int8,
+      Int16,
+      Int32,
+      Int64,
+      Float,
+      Double,
+      Utf8,
+      LargeUtf8,
+      Date32,
+    };
+
+    Format formatForChild( int child ) const
+    {
+      const QByteArray format( mSchema.children[child]->format );
+      if ( format == "b" )
+        return Format::Bool;
+      else if ( format == "c" )
+        return Format::Int8;
+      else if ( format == "s" )
+        return Format::Int16;
+      else if ( format == "i" )
+        return Format::Int32;
+      else if ( format == "l" )
+        return Format::Int64;
+      else if ( format == "f" )
+        return Format::Float;
+      else if ( format == "g" )
+        return Format::Double;
+      else if ( format == "u" )
+        return Format::Utf8;
+      else if ( format == "U" )
+        return Format::LargeUtf8;
+      else if ( format == "tdD" )
+        return Format::Date32;
+      return Format::Unsupported;
+    }
+
+    static bool canFill( QgsFeatureBatch::ColumnType type, Format format, QVariant::Type fieldType )
+    {
+      switch ( type )
+      {
+        case QgsFeatureBatch::ColumnType::Int64:
+          return format == Format::Bool || format == Format::Int8 || format == Format::Int16 || format == Format::Int32 || format == Format::Int64;
+        case QgsFeatureBatch::ColumnType::Double:
+          return format != Format::Unsupported && format != Format::Utf8 && format != Format::LargeUtf8 && format != Format::Date32;
+        case QgsFeatureBatch::ColumnType::String:
+          return format == Format::Utf8 || format == Format::LargeUtf8;
+        case QgsFeatureBatch::ColumnType::Variant:
+          return format == Format::Date32 && fieldType == QVariant::Date;
+      }
+      return false;
+    }
+
+    static bool isValid( const ArrowArray *array, int64_t row )
+    {
+      const uint8_t *validity = static_cast< const uint8_t * >( array->buffers[0] );
+      if ( !validity || array->null_count == 0 )
+        return true;
+      const int64_t idx = array->offset + row;
+      return validity[idx >> 3] & ( 1 << ( idx & 7 ) );
+    }
+
+    template< typename T > static T value( const ArrowArray *array, int64_t row )
+    {
+      return static_cast< const T * >( array->buffers[1] )[array->offset + row];
+    }
+
+    void appendValue( QgsFeatureBatch::Column &column, const ArrowArray *array, Format format, int64_t row ) const
+    {
+      if ( !isValid( array, row ) )
+      {
+        column.appendNull();
+        return;
+      }
+
+      const int64_t idx = array->offset + row;
+      switch ( format )
+      {
+        case Format::Bool:
+        {
+          const bool v = static_cast< const uint8_t * >( array->buffers[1] )[idx >> 3] & ( 1 << ( idx & 7 ) );
+          if ( column.type() == QgsFeatureBatch::ColumnType::Double )
+            column.appendDouble( v ? 1 : 0 );
+          else
+            column.appendInt64( v ? 1 : 0 );
+          break;
+        }
+        case Format::Int8:
+          appendNumber( column, value< int8_t >( array, row ) );
+          break;
+        case Format::Int16:
+          appendNumber( column, value< int16_t >( array, row ) );
+          break;
+        case Format::Int32:
+          appendNumber( column, value< int32_t >( array, row ) );
+          break;
+        case Format::Int64:
+          appendNumber( column, value< int64_t >( array, row ) );
+          break;
+        case Format::Float:
+          column.appendDouble( value< float >( array, row ) );
+          break;
+        case Format::Double:
+          column.appendDouble( value< double >( array, row ) );
+          break;
+        case Format::Utf8:
+        {
+          const int32_t *offsets = static_cast< const int32_t * >( array->buffers[1] );
+          appendString( column, static_cast< const char * >( array->buffers[2] ) + offsets[idx], offsets[idx + 1] - offsets[idx] );
+          break;
+        }
+        case Format::LargeUtf8:
+        {
+          const int64_t *offsets = static_cast< const int64_t * >( array->buffers[1] );
+          appendString( column, static_cast< const char * >( array->buffers[2] ) + offsets[idx], static_cast< int >( offsets[idx + 1] - offsets[idx] ) );
+          break;
+        }
+        case Format::Date32:
+          column.appendValue( QDate( 1970, 1, 1 ).addDays( value< int32_t >( array, row ) ) );
+          break;
+        case Format::Unsupported:
+          column.appendNull();
+          break;
+      }
+    }
+
+    template< typename T > static void appendNumber( QgsFeatureBatch::Column &column, T v )
+    {
+      if ( column.type() == QgsFeatureBatch::ColumnType::Double )
+        column.appendDouble( static_cast< double >( v ) );
+      else
+        column.appendInt64( static_cast< qint64 >( v ) );
+    }
+
+    void appendString( QgsFeatureBatch::Column &column, const char *data, int length ) const
+    {
+      if ( mEncoding )
+        column.appendString( mEncoding->toUnicode( data, length ) );
+      else
+        column.appendUtf8( data, length );
+    }
+
+    ArrowArrayStream mStream{};
+    ArrowSchema mSchema{};
+    ArrowArray mArray{};
+    int64_t mRow = 0;
+    int mFidChild = -1;
+    QVector< int > mColumnChildren;
+    QVector< Format > mColumnFormats;
+    QTextCodec *mEncoding = nullptr;
+};
+
+#endif
 
 QgsOgrFeatureIterator::QgsOgrFeatureIterator( QgsOgrFeatureSource *source, bool ownSource, const QgsFeatureRequest &request, QgsTransaction *transaction )
   : QgsAbstractFeatureIteratorFromSource<QgsOgrFeatureSource>( source, ownSource, request )
@@ -202,22 +492,8 @@ QgsOgrFeatureIterator::QgsOgrFeatureIterator( QgsOgrFeatureSource *source, bool
     }
   }
 
-  // prepare spatial filter geometries for optimal speed
-  switch ( mRequest.spatialFilterType() )
-  {
-    case Qgis::SpatialFilterType::NoFilter:
-    case Qgis::SpatialFilterType::BoundingBox:
-      break;
-
-    case Qgis::SpatialFilterType::DistanceWithin:
-      if ( !mRequest.referenceGeometry().isEmpty() )
-      {
-        mDistanceWithinGeom = mRequest.referenceGeometry();
-        mDistanceWithinEngine.reset( QgsGeometry::createGeometryEngine( mDistanceWithinGeom.constGet() ) );
-        mDistanceWithinEngine->prepareGeometry();
-      }
-      break;
-  }
+  // OGR only filters on the bounding box, exact spatial filters are tested on the candidate features in parallel
+  mSpatialFilter = QgsSpatialFilterEvaluator::fromRequest( mRequest, mFilterRect );
 
   if ( request.filterType() == QgsFeatureRequest::FilterExpression )
   {
@@ -375,8 +651,18 @@ bool QgsOgrFeatureIterator::fetchFeatureWithId( QgsFeatureId id, QgsFeature &fea
   if ( !readFeature( std::move( fet ), feature ) )
     return false;
 
-  feature.setValid( true );
+  // intersections are tested in the source crs, distances in the destination crs
+  if ( mSpatialFilter && mSpatialFilter->predicate() == QgsSpatialFilterEvaluator::Predicate::Intersects
+       && !mSpatialFilter->test( feature.geometry().constGet() ) )
+    return false;
+
   geometryToDestinationCrs( feature, mTransform );
+
+  if ( mSpatialFilter && mSpatialFilter->predicate() == QgsSpatialFilterEvaluator::Predicate::DistanceWithin
+       && !mSpatialFilter->test( feature.geometry().constGet() ) )
+    return false;
+
+  feature.setValid( true );
   return true;
 }
 
@@ -388,10 +674,9 @@ bool QgsOgrFeatureIterator::checkFeature( gdal::ogr_feature_unique_ptr &fet, Qgs
   if ( !mFilterRect.isNull() && ( !feature.hasGeometry() || feature.geometry().isEmpty() ) )
     return false;
 
-  geometryToDestinationCrs( feature, mTransform );
-
-  if ( mDistanceWithinEngine && mDistanceWithinEngine->distance( feature.geometry().constGet() ) > mRequest.distanceWithin() )
-    return false;
+  // geometry must be in destination crs before we can perform distance within check
+  if ( !mSpatialFilter || mSpatialFilter->predicate() == QgsSpatialFilterEvaluator::Predicate::DistanceWithin )
+    geometryToDestinationCrs( feature, mTransform );
 
   // we have a feature, end this cycle
   feature.setValid( true );
@@ -415,17 +700,16 @@ bool QgsOgrFeatureIterator::fetchFeature( QgsFeature &feature )
   if ( mClosed || !mOgrLayer )
     return false;
 
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+  // the layer cannot be read feature by feature while an Arrow stream is open
+  mArrowReader.reset();
+#endif
+  mFeatureReadingStarted = true;
+
   if ( mRequest.filterType() == QgsFeatureRequest::FilterFid )
   {
-    bool result = fetchFeatureWithId( mRequest.filterFid(), feature );
+    const bool result = fetchFeatureWithId( mRequest.filterFid(), feature );
     close(); // the feature has been read or was not found: we have finished here
-
-    if ( result && mDistanceWithinEngine )
-    {
-      result = mDistanceWithinEngine->distance( feature.geometry().constGet() ) <= mRequest.distanceWithin();
-      feature.setValid( result );
-    }
-
     return result;
   }
   else if ( mRequest.filterType() == QgsFeatureRequest::FilterFids )
@@ -436,22 +720,35 @@ bool QgsOgrFeatureIterator::fetchFeature( QgsFeature &feature )
       ++mFilterFidsIt;
 
       if ( fetchFeatureWithId( nextId, feature ) )
-      {
-        bool result = true;
-        if ( mDistanceWithinEngine )
-        {
-          result = mDistanceWithinEngine->distance( feature.geometry().constGet() ) <= mRequest.distanceWithin();
-          feature.setValid( result );
-        }
-
-        if ( result )
-          return true;
-      }
+        return true;
     }
     close();
     return false;
   }
 
+  bool result = false;
+  if ( mSpatialFilter )
+  {
+    result = mSpatialFilter->nextFeature( feature, [this]( QgsFeature & candidate ) { return nextCandidate( candidate ); } );
+
+    // intersections are tested in the source crs, distances in the destination crs
+    if ( result && mSpatialFilter->predicate() == QgsSpatialFilterEvaluator::Predicate::Intersects )
+      geometryToDestinationCrs( feature, mTransform );
+  }
+  else
+  {
+    result = nextCandidate( feature );
+  }
+
+  if ( result )
+    return true;
+
+  close();
+  return false;
+}
+
+bool QgsOgrFeatureIterator::nextCandidate( QgsFeature &feature )
+{
   gdal::ogr_feature_unique_ptr fet;
 
   // OSM layers (especially large ones) need the GDALDataset::GetNextFeature() call rather than OGRLayer::GetNextFeature()
@@ -479,10 +776,169 @@ bool QgsOgrFeatureIterator::fetchFeature( QgsFeature &feature )
     }
   }
 
-  close();
   return false;
 }
 
+bool QgsOgrFeatureIterator::providerCanFetchBatch() const
+{
+  // the attributes are read straight from the OGR features, which skips the geometry
+  // and all the checks done on it
+  if ( mFetchGeometry || mSpatialFilter || ( mRequest.flags() & QgsFeatureRequest::EmbeddedSymbols ) )
+    return false;
+
+  switch ( mRequest.filterType() )
+  {
+    case QgsFeatureRequest::FilterNone:
+      return true;
+    case QgsFeatureRequest::FilterExpression:
+      return mExpressionCompiled;
+    case QgsFeatureRequest::FilterFid:
+    case QgsFeatureRequest::FilterFids:
+      return false;
+  }
+  return false;
+}
+
+void QgsOgrFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  QMutexLocker locker( mSharedDS ? &mSharedDS->mutex() : nullptr );
+
+  QgsCPLHTTPFetchOverrider oCPLHTTPFetcher( mAuthCfg, mInterruptionChecker );
+  QgsSetCPLHTTPFetchOverriderInitiatorClass( oCPLHTTPFetcher, QStringLiteral( "QgsOgrFeatureIterator" ) )
+
+  if ( mClosed || !mOgrLayer )
+    return;
+
+  // see fetchFeature() regarding GDALDataset::GetNextFeature()
+  const bool readFromDataset = !QgsOgrProviderUtils::canDriverShareSameDatasetAmongLayers( mSource->mDriverName );
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+  // read whole record batches through the Arrow stream of the layer, unless features were already read one by one
+  if ( !readFromDataset && !mFeatureReadingStarted && !mArrowReaderFailed )
+  {
+    if ( !mArrowReader )
+    {
+      mArrowReader = std::make_unique< QgsOgrArrowBatchReader >();
+      if ( !mArrowReader->open( mOgrLayer, batch, mSource->mFields, mFirstFieldIsFid, mRequestAttributes, mSource->mEncoding ) )
+      {
+        mArrowReader.reset();
+        mArrowReaderFailed = true;
+        resetReading();
+      }
+    }
+
+    if ( mArrowReader )
+    {
+      if ( !mArrowReader->read( batch, maxFeatures ) )
+        close();
+      return;
+    }
+  }
+#endif
+
+  batch.reserve( maxFeatures );
+  gdal::ogr_feature_unique_ptr fet;
+  while ( batch.size() < maxFeatures )
+  {
+    if ( readFromDataset )
+    {
+      OGRLayerH nextFeatureBelongingLayer;
+      fet.reset( GDALDatasetGetNextFeature( mConn->ds, &nextFeatureBelongingLayer, nullptr, nullptr, nullptr ) );
+      if ( fet && nextFeatureBelongingLayer != mOgrLayer )
+        continue;
+    }
+    else
+    {
+      fet.reset( OGR_L_GetNextFeature( mOgrLayer ) );
+    }
+
+    if ( !fet )
+    {
+      close();
+      return;
+    }
+
+    readBatchRow( fet.get(), batch );
+  }
+}
+
+void QgsOgrFeatureIterator::readBatchRow( OGRFeatureH ogrFet, QgsFeatureBatch &batch ) const
+{
+  batch.appendId( OGR_F_GetFID( ogrFet ) );
+
+  const bool subsetOfAttributes = mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes;
+  const int fieldCount = mSource->mFields.count();
+  const int columnCount = batch.columnCount();
+  for ( int i = 0; i < columnCount; ++i )
+  {
+    QgsFeatureBatch::Column &column = batch.column( i );
+    const int idx = batch.columnFieldIndex( i );
+
+    // attributes which are not fetched are ignored by OGR
+    if ( idx >= fieldCount || ( subsetOfAttributes && !std::binary_search( mRequestAttributes.constBegin(), mRequestAttributes.constEnd(), idx ) ) )
+    {
+      column.appendNull();
+      continue;
+    }
+
+    if ( mFirstFieldIsFid && idx == 0 )
+    {
+      column.appendValue( static_cast<qint64>( OGR_F_GetFID( ogrFet ) ) );
+      continue;
+    }
+
+    const int ogrIdx = mFirstFieldIsFid ? idx - 1 : idx;
+    if ( !OGR_F_IsFieldSetAndNotNull( ogrFet, ogrIdx ) )
+    {
+      column.appendNull();
+      continue;
+    }
+
+    // read the common types without going through a QVariant
+    const QVariant::Type fieldType = mFieldsWithoutFid.at( ogrIdx ).type();
+    switch ( column.type() )
+    {
+      case QgsFeatureBatch::ColumnType::Int64:
+        if ( fieldType == QVariant::Bool )
+        {
+          column.appendInt64( OGR_F_GetFieldAsInteger( ogrFet, ogrIdx ) ? 1 : 0 );
+          continue;
+        }
+        else if ( fieldType == QVariant::Int || fieldType == QVariant::LongLong )
+        {
+          column.appendInt64( OGR_F_GetFieldAsInteger64( ogrFet, ogrIdx ) );
+          continue;
+        }
+        break;
+
+      case QgsFeatureBatch::ColumnType::Double:
+        if ( fieldType == QVariant::Double )
+        {
+          column.appendDouble( OGR_F_GetFieldAsDouble( ogrFet, ogrIdx ) );
+          continue;
+        }
+        break;
+
+      case QgsFeatureBatch::ColumnType::String:
+        if ( fieldType == QVariant::String )
+        {
+          const char *value = OGR_F_GetFieldAsString( ogrFet, ogrIdx );
+          if ( mSource->mEncoding )
+            column.appendString( mSource->mEncoding->toUnicode( value ) );
+          else
+            column.appendUtf8( value, static_cast< int >( strlen( value ) ) );
+          continue;
+        }
+        break;
+
+      case QgsFeatureBatch::ColumnType::Variant:
+        break;
+    }
+
+    column.appendValue( getFeatureAttribute( ogrFet, idx ) );
+  }
+}
+
 void QgsOgrFeatureIterator::resetReading()
 {
   if ( ! mAllowResetReading )
@@ -507,16 +963,30 @@ bool QgsOgrFeatureIterator::rewind()
   if ( mClosed || !mOgrLayer )
     return false;
 
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+  mArrowReader.reset();
+  mArrowReaderFailed = false;
+#endif
+  mFeatureReadingStarted = false;
+
   resetReading();
 
   mFilterFidsIt = mFilterFids.begin();
 
+  if ( mSpatialFilter )
+    mSpatialFilter->reset();
+
   return true;
 }
 
 
 bool QgsOgrFeatureIterator::close()
 {
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+  // the stream must be released before the layer
+  mArrowReader.reset();
+#endif
+
   if ( mSharedDS )
   {
     iteratorClosed();
@@ -579,7 +1049,6 @@ bool QgsOgrFeatureIterator::readFeature( const gdal::ogr_feature_unique_ptr &fet
   feature.setId( OGR_F_GetFID( fet.get() ) );
   feature.setFields( mSource->mFields ); // allow name-based attribute lookups
 
-  const bool useExactIntersect = mRequest.spatialFilterType() == Qgis::SpatialFilterType::BoundingBox && ( mRequest.flags() & QgsFeatureRequest::ExactIntersect );
   const bool geometryTypeFilter = mSource->mOgrGeometryTypeFilter != wkbUnknown;
   if ( mFetchGeometry || mRequest.spatialFilterType() != Qgis::SpatialFilterType::NoFilter || geometryTypeFilter )
   {
@@ -606,12 +1075,8 @@ bool QgsOgrFeatureIterator::readFeature( const gdal::ogr_feature_unique_ptr &fet
       // OK
     }
     else if ( ( geometryTypeFilter && ( !feature.hasGeometry() || QgsOgrProviderUtils::ogrWkbSingleFlattenAndLinear( ( OGRwkbGeometryType )feature.geometry().wkbType() ) != mSource->mOgrGeometryTypeFilter ) )
-              || ( !mFilterRect.isNull() &&
-                   ( !feature.hasGeometry()
-                     || ( useExactIntersect && !feature.geometry().intersects( mFilterRect ) )
-                     || ( !useExactIntersect && !feature.geometry().boundingBoxIntersects( mFilterRect ) )
-                   )
-                 ) )
+              // exact intersections are tested by the spatial filter
+              || ( !mFilterRect.isNull() && ( !feature.hasGeometry() || !feature.geometry().boundingBoxIntersects( mFilterRect ) ) ) )
     {
       return false;
     }
@@ -33,6 +33,8 @@
 class QgsOgrFeatureIterator;
 class QgsOgrProvider;
 class QgsOgrDataset;
+class QgsOgrArrowBatchReader;
+class QgsSpatialFilterEvaluator;
 using QgsOgrDatasetSharedPtr = std::shared_ptr< QgsOgrDataset>;
 
 class QgsOgrFeatureSource final: public QgsAbstractFeatureSource
@@ -81,11 +83,19 @@ class QgsOgrFeatureIterator final: public QgsAbstractFeatureIteratorFromSource<Q
     bool checkFeature( gdal::ogr_feature_unique_ptr &fet, QgsFeature &feature ) ;
     bool fetchFeature( QgsFeature &feature ) override;
     bool nextFeatureFilterExpression( QgsFeature &f ) override;
+    bool providerCanFetchBatch() const override;
+    void fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) override;
 
   private:
 
+    //! Reads the next feature matching the filters, apart from the exact spatial filter
+    bool nextCandidate( QgsFeature &feature );
+
     bool readFeature( const gdal::ogr_feature_unique_ptr &fet, QgsFeature &feature ) const;
 
+    //! Appends the id and the attributes of an OGR feature to a batch, reading the values straight into the batch columns
+    void readBatchRow( OGRFeatureH ogrFet, QgsFeatureBatch &batch ) const;
+
     //! Gets an attribute associated with a feature
     QVariant getFeatureAttribute( OGRFeatureH ogrFet, int attindex ) const;
 
@@ -118,11 +128,19 @@ class QgsOgrFeatureIterator final: public QgsAbstractFeatureIteratorFromSource<Q
      * a transaction for SQLITE-based layers */
     bool mAllowResetReading = true;
 
-    QgsGeometry mDistanceWithinGeom;
-    std::unique_ptr< QgsGeometryEngine > mDistanceWithinEngine;
+    std::unique_ptr< QgsSpatialFilterEvaluator > mSpatialFilter;
 
     QVector< int > mRequestAttributes;
 
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+    //! Arrow stream used to fill batches, created by the first fetchBatch() call
+    std::unique_ptr< QgsOgrArrowBatchReader > mArrowReader;
+    //! Set when the layer cannot be read through an Arrow stream
+    bool mArrowReaderFailed = false;
+#endif
+    //! Set when features have been read one by one since the last rewind
+    bool mFeatureReadingStarted = false;
+
     bool fetchFeatureWithId( QgsFeatureId id, QgsFeature &feature ) const;
 
     void resetReading();
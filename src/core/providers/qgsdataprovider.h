@@ -604,6 +604,19 @@ class CORE_EXPORT QgsDataProvider : public QObject
      */
     virtual void setTransformContext( const QgsCoordinateTransformContext &transformContext ) SIP_SKIP;
 
+    /**
+     * Called on the main thread once the provider, created on a worker thread, has been moved to
+     * the main thread.
+     *
+     * The default implementation does nothing, subclasses may override to replace the resources
+     * which could not be shared while they were created on the worker thread, e.g. database
+     * connections shared with the other providers.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    virtual void movedToMainThread() SIP_SKIP {}
+
     /**
      * String sequence used for separating components of sublayers strings.
      * \note Replaces the static const SUBLAYER_SEPARATOR
@@ -336,16 +336,32 @@ void QgsProviderRegistry::init()
 #endif
   QgsDebugMsg( QStringLiteral( "Loaded %1 providers (%2) " ).arg( mProviders.size() ).arg( providerList().join( ';' ) ) );
 
+  // now initialize all providers
+  for ( Providers::const_iterator it = mProviders.begin(); it != mProviders.end(); ++it )
+  {
+    const QgsScopedRuntimeProfile profile( QObject::tr( "Initialize %1" ).arg( it->first ) );
+
+    // call initProvider() - allows provider to register its services to QGIS
+    it->second->initProvider();
+  }
+} // QgsProviderRegistry ctor
+
+void QgsProviderRegistry::initFileFilters() const
+{
+  const QMutexLocker locker( &mFileFiltersMutex );
+  if ( mFileFiltersInitialized )
+    return;
+
+  const QgsScopedRuntimeProfile profile( QObject::tr( "Build data provider file filters" ) );
+
   QStringList pointCloudWildcards;
   QStringList pointCloudFilters;
 
-  // now initialize all providers
+  // now get the file filters of all providers
   for ( Providers::const_iterator it = mProviders.begin(); it != mProviders.end(); ++it )
   {
     const QString &key = it->first;
 
-    const QgsScopedRuntimeProfile profile( QObject::tr( "Initialize %1" ).arg( key ) );
-
     QgsProviderMetadata *meta = it->second;
 
     // now get vector file filters, if any
@@ -398,9 +414,6 @@ void QgsProviderRegistry::init()
         pointCloudWildcards.append( QgsFileUtils::wildcardsFromFilter( filter ).split( ' ' ) );
       }
     }
-
-    // call initProvider() - allows provider to register its services to QGIS
-    meta->initProvider();
   }
 
   if ( !pointCloudFilters.empty() )
@@ -418,7 +431,9 @@ void QgsProviderRegistry::init()
 
   // load protocol drivers (only OGR)
   mProtocolDrivers =  QgsOgrProviderUtils::protocolDrivers();
-} // QgsProviderRegistry ctor
+
+  mFileFiltersInitialized = true;
+}
 
 
 // typedef for the unload dataprovider function
@@ -835,41 +850,49 @@ bool QgsProviderRegistry::registerProvider( QgsProviderMetadata *providerMetadat
 
 QString QgsProviderRegistry::fileVectorFilters() const
 {
+  initFileFilters();
   return mVectorFileFilters;
 }
 
 QString QgsProviderRegistry::fileRasterFilters() const
 {
+  initFileFilters();
   return mRasterFileFilters;
 }
 
 QString QgsProviderRegistry::fileMeshFilters() const
 {
+  initFileFilters();
   return mMeshFileFilters;
 }
 
 QString QgsProviderRegistry::fileMeshDatasetFilters() const
 {
+  initFileFilters();
   return mMeshDatasetFileFilters;
 }
 
 QString QgsProviderRegistry::filePointCloudFilters() const
 {
+  initFileFilters();
   return mPointCloudFileFilters;
 }
 
 QString QgsProviderRegistry::databaseDrivers() const
 {
+  initFileFilters();
   return mDatabaseDrivers;
 }
 
 QString QgsProviderRegistry::directoryDrivers() const
 {
+  initFileFilters();
   return mDirectoryDrivers;
 }
 
 QString QgsProviderRegistry::protocolDrivers() const
 {
+  initFileFilters();
   return mProtocolDrivers;
 }
 
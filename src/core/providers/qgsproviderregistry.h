@@ -23,6 +23,7 @@
 
 #include <QDir>
 #include <QLibrary>
+#include <QMutex>
 #include <QString>
 
 #include "qgsdataprovider.h"
@@ -695,42 +696,52 @@ class CORE_EXPORT QgsProviderRegistry
     void init();
     void clean();
 
+    /**
+     * Builds the file filters and the driver strings of the providers, on their first use.
+     * Building them queries every GDAL and OGR driver, which is not needed by most applications at startup.
+     */
+    void initFileFilters() const;
+
     //! Associative container of provider metadata handles
     Providers mProviders;
 
     //! Directory in which provider plugins are installed
     QDir mLibraryDirectory;
 
+    //! Protects the lazy initialization of the file filters and driver strings
+    mutable QMutex mFileFiltersMutex;
+    mutable bool mFileFiltersInitialized = false;
+
     /**
      * File filter string for vector files
      *
-     * Built once when registry is constructed by appending strings returned
+     * Built once when first requested by appending strings returned
      * from iteratively calling vectorFileFilter() for each visited data
      * provider.  The alternative would have been to do this each time
      * fileVectorFilters was invoked; instead we only have to build it the
      * one time.
      */
-    QString mVectorFileFilters;
+    mutable QString mVectorFileFilters;
 
     /**
      * File filter string for raster files
      */
-    QString mRasterFileFilters;
+    mutable QString mRasterFileFilters;
 
     /**
      * File filter string for raster files
      */
-    QString mMeshFileFilters;
+    mutable QString mMeshFileFilters;
 
     /**
      * File filter string for raster files
      */
-    QString mMeshDatasetFileFilters;
+    mutable QString mMeshDatasetFileFilters;
 
     /**
      * File filter string for point cloud files
      */
-    QString mPointCloudFileFilters;
+    mutable QString mPointCloudFileFilters;
 
     /**
      * Available database drivers string for vector databases
@@ -738,14 +749,14 @@ class CORE_EXPORT QgsProviderRegistry
      * This is a string of form:
      * DriverNameToShow,DriverName;DriverNameToShow,DriverName;...
      */
-    QString mDatabaseDrivers;
+    mutable QString mDatabaseDrivers;
 
     /**
      * Available directory drivers string for vector databases
      * This is a string of form:
      * DriverNameToShow,DriverName;DriverNameToShow,DriverName;...
      */
-    QString mDirectoryDrivers;
+    mutable QString mDirectoryDrivers;
 
     /**
      * Available protocol drivers string for vector databases
@@ -753,7 +764,7 @@ class CORE_EXPORT QgsProviderRegistry
      * This is a string of form:
      * DriverNameToShow,DriverName;DriverNameToShow,DriverName;...
      */
-    QString mProtocolDrivers;
+    mutable QString mProtocolDrivers;
 
     QList< UnusableUriHandlerInterface * > mUnusableUriHandlers;
 
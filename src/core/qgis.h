@@ -1540,6 +1540,8 @@ class CORE_EXPORT Qgis
       HighQualityImageTransforms = 0x4000, //!< Enable high quality image transformations, which results in better appearance of scaled or rotated raster components of a map (since QGIS 3.24)
       SkipSymbolRendering      = 0x8000, //!< Disable symbol rendering while still drawing labels if enabled (since QGIS 3.24)
       ForceRasterMasks         = 0x10000,  //!< Force symbol masking to be applied using a raster method. This is considerably faster when compared to the vector method, but results in a inferior quality output. (since QGIS 3.26.1)
+      ParallelFeatureRendering = 0x20000, //!< Allow the features of a single vector layer to be rendered by several threads, when the layer renderer supports it (since QGIS 3.30)
+      RecordProfile            = 0x40000, //!< Record a detailed profile of the time spent in the stages of layer rendering in the "render" group of QgsApplication::profiler() (since QGIS 3.30)
     };
     //! Map settings flags
     Q_DECLARE_FLAGS( MapSettingsFlags, MapSettingsFlag ) SIP_MONKEYPATCH_FLAGS_UNNEST( QgsMapSettings, Flags )
@@ -1572,6 +1574,8 @@ class CORE_EXPORT Qgis
       RenderingSubSymbol       = 0x10000, //!< Set whenever a sub-symbol of a parent symbol is currently being rendered. Can be used during symbol and symbol layer rendering to determine whether the symbol being rendered is a subsymbol. (Since QGIS 3.24)
       HighQualityImageTransforms = 0x20000, //!< Enable high quality image transformations, which results in better appearance of scaled or rotated raster components of a map (since QGIS 3.24)
       SkipSymbolRendering      = 0x40000, //!< Disable symbol rendering while still drawing labels if enabled (since QGIS 3.24)
+      ParallelFeatureRendering = 0x80000, //!< Allow the features of a single vector layer to be rendered by several threads, when the layer renderer supports it (since QGIS 3.30)
+      RecordProfile            = 0x100000, //!< Record a detailed profile of the time spent in the stages of layer rendering in the "render" group of QgsApplication::profiler() (since QGIS 3.30)
     };
     //! Render context flags
     Q_DECLARE_FLAGS( RenderContextFlags, RenderContextFlag ) SIP_MONKEYPATCH_FLAGS_UNNEST( QgsRenderContext, Flags )
@@ -2382,6 +2386,7 @@ class CORE_EXPORT Qgis
       DontLoad3DViews SIP_MONKEYPATCH_COMPAT_NAME( FlagDontLoad3DViews ) = 1 << 4, //!< Skip loading 3D views (since QGIS 3.26)
       DontLoadProjectStyles = 1 << 5, //!< Skip loading project style databases (deprecated -- use ProjectCapability::ProjectStyles flag instead)
       ForceReadOnlyLayers = 1 << 6, //!< Open layers in a read-only mode. (since QGIS 3.28)
+      LazyLoadLayers = 1 << 7, //!< Create the data providers of vector layers only when the layers are first rendered, identified or queried, using the layer metadata stored in the project until then. Implies TrustLayerMetadata. Dramatically improves project read time and memory use if only a few layers are actually used. (since QGIS 3.30)
     };
     Q_ENUM( ProjectReadFlag )
 
@@ -35,6 +35,15 @@
 #include <QUuid>
 #include <QTextStream>
 
+///@cond PRIVATE
+
+//! Number of rendered features of a layer kept in memory before they are written to its temporary layer
+constexpr int MAX_COLLATED_FEATURES = 1000;
+
+///@endcond
+
+QgsAbstractGeoPdfExporter::~QgsAbstractGeoPdfExporter() = default;
+
 bool QgsAbstractGeoPdfExporter::geoPDFCreationAvailable()
 {
   // test if GDAL has read support in PDF driver
@@ -159,48 +168,81 @@ void QgsAbstractGeoPdfExporter::pushRenderedFeature( const QString &layerId, con
   // collate all the features which belong to the same layer, replacing their geometries with the rendered feature bounds
   QgsFeature f = feature.feature;
   f.setGeometry( feature.renderedBounds );
-  mCollatedFeatures[ group ][ layerId ].append( f );
+  QgsFeatureList &features = mCollatedFeatures[ group ][ layerId ];
+  features.append( f );
+
+  // write the features to disk in batches, exports with many features would otherwise exhaust the memory
+  if ( features.size() >= MAX_COLLATED_FEATURES && !mFeatureWriteFailed )
+  {
+    if ( !writeCollatedFeatures( group, layerId ) )
+      mFeatureWriteFailed = true;
+  }
+}
+
+bool QgsAbstractGeoPdfExporter::writeCollatedFeatures( const QString &group, const QString &layerId )
+{
+  QgsFeatureList &features = mCollatedFeatures[ group ][ layerId ];
+  if ( features.isEmpty() )
+    return true;
+
+  TemporaryLayer &layer = mTemporaryLayers[ group ][ layerId ];
+  if ( !layer.writer )
+  {
+    // the fields and geometry type of the layer are taken from its first feature
+    layer.filePath = generateTemporaryFilepath( layerId + group + QStringLiteral( ".gpkg" ) );
+    QgsVectorFileWriter::SaveVectorOptions saveOptions;
+    saveOptions.driverName = QStringLiteral( "GPKG" );
+    saveOptions.symbologyExport = QgsVectorFileWriter::NoSymbology;
+    layer.writer.reset( QgsVectorFileWriter::create( layer.filePath, features.first().fields(), features.first().geometry().wkbType(), QgsCoordinateReferenceSystem(), QgsCoordinateTransformContext(), saveOptions, QgsFeatureSink::RegeneratePrimaryKey, nullptr, &layer.layerName ) );
+    if ( layer.writer->hasError() )
+    {
+      mErrorMessage = layer.writer->errorMessage();
+      QgsDebugMsg( mErrorMessage );
+      return false;
+    }
+  }
+
+  if ( !layer.writer->addFeatures( features, QgsFeatureSink::FastInsert ) )
+  {
+    mErrorMessage = layer.writer->errorMessage();
+    QgsDebugMsg( mErrorMessage );
+    return false;
+  }
+  features.clear();
+  return true;
 }
 
 bool QgsAbstractGeoPdfExporter::saveTemporaryLayers()
 {
+  QMutexLocker locker( &mMutex );
+  if ( mFeatureWriteFailed )
+    return false;
+
+  // write out the features remaining in memory
   for ( auto groupIt = mCollatedFeatures.constBegin(); groupIt != mCollatedFeatures.constEnd(); ++groupIt )
   {
     for ( auto it = groupIt->constBegin(); it != groupIt->constEnd(); ++it )
     {
-      const QString filePath = generateTemporaryFilepath( it.key() + groupIt.key() + QStringLiteral( ".gpkg" ) );
-
-      VectorComponentDetail detail = componentDetailForLayerId( it.key() );
-      detail.sourceVectorPath = filePath;
-      detail.group = groupIt.key();
-
-      // write out features to disk
-      const QgsFeatureList features = it.value();
-      QString layerName;
-      QgsVectorFileWriter::SaveVectorOptions saveOptions;
-      saveOptions.driverName = QStringLiteral( "GPKG" );
-      saveOptions.symbologyExport = QgsVectorFileWriter::NoSymbology;
-      std::unique_ptr< QgsVectorFileWriter > writer( QgsVectorFileWriter::create( filePath, features.first().fields(), features.first().geometry().wkbType(), QgsCoordinateReferenceSystem(), QgsCoordinateTransformContext(), saveOptions, QgsFeatureSink::RegeneratePrimaryKey, nullptr, &layerName ) );
-      if ( writer->hasError() )
-      {
-        mErrorMessage = writer->errorMessage();
-        QgsDebugMsg( mErrorMessage );
+      if ( !writeCollatedFeatures( groupIt.key(), it.key() ) )
         return false;
-      }
-      for ( const QgsFeature &feature : features )
-      {
-        QgsFeature f = feature;
-        if ( !writer->addFeature( f, QgsFeatureSink::FastInsert ) )
-        {
-          mErrorMessage = writer->errorMessage();
-          QgsDebugMsg( mErrorMessage );
-          return false;
-        }
-      }
-      detail.sourceVectorLayer = layerName;
+    }
+  }
+
+  for ( auto groupIt = mTemporaryLayers.begin(); groupIt != mTemporaryLayers.end(); ++groupIt )
+  {
+    for ( auto it = groupIt->second.begin(); it != groupIt->second.end(); ++it )
+    {
+      // closes the dataset
+      it->second.writer.reset();
+
+      VectorComponentDetail detail = componentDetailForLayerId( it->first );
+      detail.sourceVectorPath = it->second.filePath;
+      detail.sourceVectorLayer = it->second.layerName;
+      detail.group = groupIt->first;
       mVectorComponents << detail;
     }
   }
+  mTemporaryLayers.clear();
   return true;
 }
 
@@ -23,6 +23,9 @@
 #include <QDateTime>
 #include <QPainter>
 
+#include <map>
+#include <memory>
+
 #include "qgsfeature.h"
 #include "qgsabstractmetadatabase.h"
 #include "qgspolygon.h"
@@ -32,6 +35,7 @@
 
 
 class QgsGeoPdfRenderedFeatureHandler;
+class QgsVectorFileWriter;
 
 /**
  * \class QgsAbstractGeoPdfExporter
@@ -77,7 +81,7 @@ class CORE_EXPORT QgsAbstractGeoPdfExporter
      */
     QgsAbstractGeoPdfExporter() = default;
 
-    virtual ~QgsAbstractGeoPdfExporter() = default;
+    virtual ~QgsAbstractGeoPdfExporter();
 
     /**
      * Contains information about a feature rendered inside the PDF.
@@ -190,6 +194,9 @@ class CORE_EXPORT QgsAbstractGeoPdfExporter
      * Called multiple times during the rendering operation, whenever a \a feature associated with the specified
      * \a layerId is rendered.
      *
+     * The features are written to temporary datasets in batches while the rendering is in progress, so that
+     * exports with many features do not need to keep all of them in memory.
+     *
      * The optional \a group argument can be used to differentiate features from the same layer exported
      * multiple times as part of different layer groups.
      */
@@ -349,8 +356,27 @@ class CORE_EXPORT QgsAbstractGeoPdfExporter
 
   private:
 
+    //! Temporary dataset storing the rendered features of a layer and group
+    struct TemporaryLayer
+    {
+      QString filePath;
+      QString layerName;
+      std::unique_ptr< QgsVectorFileWriter > writer;
+    };
+
     QMutex mMutex;
+    //! Rendered features not yet written to their temporary layer
     QMap< QString, QMap< QString, QgsFeatureList > > mCollatedFeatures;
+    std::map< QString, std::map< QString, TemporaryLayer > > mTemporaryLayers;
+    bool mFeatureWriteFailed = false;
+
+    /**
+     * Writes the collated features of the layer with given \a layerId and \a group to its
+     * temporary layer, creating it as required.
+     *
+     * Must be called with the mutex locked.
+     */
+    bool writeCollatedFeatures( const QString &group, const QString &layerId );
 
     /**
      * Returns the PDF output component details for the layer with given \a layerId.
@@ -164,6 +164,7 @@ const char *QgsApplication::QGIS_APPLICATION_NAME = "QGIS3";
 QgsApplication::ApplicationMembers *QgsApplication::sApplicationMembers = nullptr;
 QgsAuthManager *QgsApplication::sAuthManager = nullptr;
 int ABISYM( QgsApplication::sMaxThreads ) = -1;
+int QgsApplication::sMaxConcurrentConnectionsPerPool = CONN_POOL_MAX_CONCURRENT_CONNS;
 
 Q_GLOBAL_STATIC( QStringList, sFileOpenEventList )
 Q_GLOBAL_STATIC( QString, sPrefixPath )
@@ -1481,19 +1482,31 @@ void QgsApplication::initQgis()
   QgsProviderRegistry::instance( pluginPath() );
 
   // create data item provider registry
-  ( void )QgsApplication::dataItemProviderRegistry();
+  {
+    const QgsScopedRuntimeProfile profile( tr( "Create data item provider registry" ) );
+    ( void )QgsApplication::dataItemProviderRegistry();
+  }
 
   // create project instance if doesn't exist
-  QgsProject::instance();
+  {
+    const QgsScopedRuntimeProfile profile( tr( "Create project" ) );
+    QgsProject::instance();
+  }
 
   // Initialize authentication manager and connect to database
-  authManager()->init( pluginPath(), qgisAuthDatabaseFilePath() );
+  {
+    const QgsScopedRuntimeProfile profile( tr( "Initialize authentication manager" ) );
+    authManager()->init( pluginPath(), qgisAuthDatabaseFilePath() );
+  }
 
   // Make sure we have a NAM created on the main thread.
   // Note that this might call QgsApplication::authManager to
   // setup the proxy configuration that's why it needs to be
   // called after the QgsAuthManager instance has been created
-  QgsNetworkAccessManager::instance();
+  {
+    const QgsScopedRuntimeProfile profile( tr( "Create network access manager" ) );
+    QgsNetworkAccessManager::instance();
+  }
 
 }
 
@@ -2063,7 +2076,12 @@ int QgsApplication::scaleIconSize( int standardSize, bool applyDevicePixelRatio
 
 int QgsApplication::maxConcurrentConnectionsPerPool() const
 {
-  return CONN_POOL_MAX_CONCURRENT_CONNS;
+  return sMaxConcurrentConnectionsPerPool;
+}
+
+void QgsApplication::setMaxConcurrentConnectionsPerPool( int count )
+{
+  sMaxConcurrentConnectionsPerPool = std::max( 1, count );
 }
 
 void QgsApplication::setTranslation( const QString &translation )
@@ -1029,10 +1029,22 @@ class CORE_EXPORT QgsApplication : public QApplication
      * \note QGIS may in some situations allocate more than this amount
      *       of connections to avoid deadlocks.
      *
+     * \see setMaxConcurrentConnectionsPerPool()
      * \since QGIS 3.4
      */
     int maxConcurrentConnectionsPerPool() const;
 
+    /**
+     * Sets the maximum number of concurrent connections per connections pool.
+     *
+     * The \a count applies to the connections to a data source opened after the call,
+     * e.g. it should be set at startup by servers rendering with many threads.
+     *
+     * \see maxConcurrentConnectionsPerPool()
+     * \since QGIS 3.30
+     */
+    static void setMaxConcurrentConnectionsPerPool( int count );
+
     /**
      * Set translation locale code
      *
@@ -1123,6 +1135,8 @@ class CORE_EXPORT QgsApplication : public QApplication
     */
     static int ABISYM( sMaxThreads );
 
+    static int sMaxConcurrentConnectionsPerPool;
+
     QMap<QString, QIcon> mIconCache;
     QMap<Cursor, QCursor> mCursorCache;
 
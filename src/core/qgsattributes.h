@@ -32,6 +32,7 @@
 
 #include "qgsfields.h"
 #include "qgsvariantutils.h"
+#include "qgsunsetattributevalue.h"
 
 
 class QgsRectangle;
@@ -132,7 +133,7 @@ class QgsAttributes : public QVector<QVariant>
       if ( index < 0 || index >= size() )
         return false;
 
-      return at( index ).userType() == QMetaType::type( "QgsUnsetAttributeValue" );
+      return at( index ).userType() == qMetaTypeId< QgsUnsetAttributeValue >();
     }
 
     inline bool operator!=( const QgsAttributes &v ) const { return !( *this == v ); }
@@ -87,6 +87,10 @@ QgsAuxiliaryLayer::QgsAuxiliaryLayer( const QString &pkField, const QString &fil
   mJoinInfo.setEditable( true );
   mJoinInfo.setUpsertOnEdit( true );
   mJoinInfo.setCascadedDelete( true );
+  // auxiliary fields are read for each rendered or labeled feature, so they are cached in memory instead
+  // of being looked up with a request on the auxiliary layer for every feature. The cache is rebuilt
+  // lazily by the next feature iterator after the auxiliary layer is modified
+  mJoinInfo.setUsingMemoryCache( true );
   mJoinInfo.setJoinFieldNamesBlockList( QStringList() << QStringLiteral( "rowid" ) ); // introduced by ogr provider
 }
 
@@ -124,6 +124,8 @@ class CORE_EXPORT QgsAuxiliaryLayer : public QgsVectorLayer
 
     /**
      * Returns information to use for joining with primary key and so on.
+     *
+     * Since QGIS 3.30 the join caches the auxiliary layer in memory.
      */
     QgsVectorLayerJoinInfo joinInfo() const;
 
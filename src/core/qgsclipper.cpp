@@ -20,9 +20,11 @@
 #include "qgsgeometry.h"
 #include "qgslogger.h"
 
+#include <algorithm>
+
 // Where has all the code gone?
 
-// It's been inlined, so its in the qgsclipper.h file.
+// Most of it has been inlined, so its in the qgsclipper.h file.
 
 // But the static members must be initialized outside the class! (or GCC 4 dies)
 
@@ -37,6 +39,117 @@ const double QgsClipper::MIN_Y = -16000;
 
 const double QgsClipper::SMALL_NUM = 1e-12;
 
+//! Buffers reused by the trimPolygon() calls of a thread, beyond this number of points they are released after each call
+constexpr int MAX_RETAINED_TRIM_BUFFER_SIZE = 1 << 16;
+
+/**
+ * Intermediate results of the trimPolygon() boundary passes.
+ *
+ * Rendering trims the rings of each feature, so the buffers are kept by the rendering thread
+ * instead of being allocated for each ring.
+ */
+struct QgsClipperTrimBuffers
+{
+  QPolygonF points;
+  QVector< double > x;
+  QVector< double > y;
+  QVector< double > z;
+
+  void releaseIfLarge()
+  {
+    if ( points.capacity() > MAX_RETAINED_TRIM_BUFFER_SIZE )
+      points = QPolygonF();
+    if ( x.capacity() > MAX_RETAINED_TRIM_BUFFER_SIZE )
+    {
+      x = QVector< double >();
+      y = QVector< double >();
+      z = QVector< double >();
+    }
+  }
+};
+
+#if defined(USE_THREAD_LOCAL) && !defined(Q_OS_WIN)
+thread_local QgsClipperTrimBuffers sTrimBuffers;
+#endif
+
+void QgsClipper::trimPolygon( QPolygonF &pts, const QgsRectangle &clipRect )
+{
+#if defined(USE_THREAD_LOCAL) && !defined(Q_OS_WIN)
+  QgsClipperTrimBuffers &buffers = sTrimBuffers;
+#else
+  QgsClipperTrimBuffers buffers;
+#endif
+  QPolygonF &tmpPts = buffers.points;
+  tmpPts.reserve( pts.size() );
+
+  // the pass of a boundary which contains all the points would only copy them, so it is skipped,
+  // e.g. for all the passes of polygons inside the clip rectangle
+  const auto trimToBoundary = [&pts, &tmpPts, &clipRect]( Boundary boundary, double boundaryValue )
+  {
+    if ( std::all_of( pts.constBegin(), pts.constEnd(), [boundary, boundaryValue]( QPointF pt ) { return inside( pt, boundary, boundaryValue ); } ) )
+      return;
+
+    tmpPts.resize( 0 );
+    trimPolygonToBoundary( pts, tmpPts, clipRect, boundary, boundaryValue );
+    pts.swap( tmpPts );
+  };
+
+  trimToBoundary( XMax, clipRect.xMaximum() );
+  trimToBoundary( YMax, clipRect.yMaximum() );
+  trimToBoundary( XMin, clipRect.xMinimum() );
+  trimToBoundary( YMin, clipRect.yMinimum() );
+
+  tmpPts.resize( 0 );
+  buffers.releaseIfLarge();
+}
+
+void QgsClipper::trimPolygon( QVector<double> &x, QVector<double> &y, QVector<double> &z, const QgsBox3d &clipRect )
+{
+#if defined(USE_THREAD_LOCAL) && !defined(Q_OS_WIN)
+  QgsClipperTrimBuffers &buffers = sTrimBuffers;
+#else
+  QgsClipperTrimBuffers buffers;
+#endif
+  QVector< double > &tempX = buffers.x;
+  QVector< double > &tempY = buffers.y;
+  QVector< double > &tempZ = buffers.z;
+  tempX.resize( 0 );
+  tempY.resize( 0 );
+  tempZ.resize( 0 );
+  const int size = x.size();
+  tempX.reserve( size );
+  tempY.reserve( size );
+  tempZ.reserve( size );
+
+  trimPolygonToBoundary( x, y, z, tempX, tempY, tempZ, clipRect, XMax, clipRect.xMaximum() );
+  x.resize( 0 );
+  y.resize( 0 );
+  z.resize( 0 );
+  trimPolygonToBoundary( tempX, tempY, tempZ, x, y, z, clipRect, YMax, clipRect.yMaximum() );
+  tempX.resize( 0 );
+  tempY.resize( 0 );
+  tempZ.resize( 0 );
+  trimPolygonToBoundary( x, y, z, tempX, tempY, tempZ, clipRect, XMin, clipRect.xMinimum() );
+  x.resize( 0 );
+  y.resize( 0 );
+  z.resize( 0 );
+  trimPolygonToBoundary( tempX, tempY, tempZ, x, y, z, clipRect, YMin, clipRect.yMinimum() );
+
+  if ( !clipRect.is2d() )
+  {
+    tempX.resize( 0 );
+    tempY.resize( 0 );
+    tempZ.resize( 0 );
+    trimPolygonToBoundary( x, y, z, tempX, tempY, tempZ, clipRect, ZMax, clipRect.zMaximum() );
+    x.resize( 0 );
+    y.resize( 0 );
+    z.resize( 0 );
+    trimPolygonToBoundary( tempX, tempY, tempZ, x, y, z, clipRect, ZMin, clipRect.zMinimum() );
+  }
+
+  buffers.releaseIfLarge();
+}
+
 void QgsClipper::clipped3dLine( const QVector< double > &xIn, const QVector< double > &yIn, const QVector<double> &zIn, QVector<double> &x, QVector<double> &y, QVector<double> &z, const QgsBox3d &clipExtent )
 {
   double p0x, p0y, p0z, p1x = 0.0, p1y = 0.0, p1z = 0.0; //original coordinates
@@ -282,57 +282,6 @@ inline void QgsClipper::trimFeature( QVector<double> &x,
   trimFeatureToBoundary( tmpX, tmpY, x, y, YMin, shapeOpen );
 }
 
-inline void QgsClipper::trimPolygon( QPolygonF &pts, const QgsRectangle &clipRect )
-{
-  QPolygonF tmpPts;
-  tmpPts.reserve( pts.size() );
-
-  trimPolygonToBoundary( pts, tmpPts, clipRect, XMax, clipRect.xMaximum() );
-  pts.resize( 0 );
-  trimPolygonToBoundary( tmpPts, pts, clipRect, YMax, clipRect.yMaximum() );
-  tmpPts.resize( 0 );
-  trimPolygonToBoundary( pts, tmpPts, clipRect, XMin, clipRect.xMinimum() );
-  pts.resize( 0 );
-  trimPolygonToBoundary( tmpPts, pts, clipRect, YMin, clipRect.yMinimum() );
-}
-
-inline void QgsClipper::trimPolygon( QVector<double> &x, QVector<double> &y, QVector<double> &z, const QgsBox3d &clipRect )
-{
-  QVector< double > tempX;
-  QVector< double > tempY;
-  QVector< double > tempZ;
-  const int size = x.size();
-  tempX.reserve( size );
-  tempY.reserve( size );
-  tempZ.reserve( size );
-
-  trimPolygonToBoundary( x, y, z, tempX, tempY, tempZ, clipRect, XMax, clipRect.xMaximum() );
-  x.resize( 0 );
-  y.resize( 0 );
-  z.resize( 0 );
-  trimPolygonToBoundary( tempX, tempY, tempZ, x, y, z, clipRect, YMax, clipRect.yMaximum() );
-  tempX.resize( 0 );
-  tempY.resize( 0 );
-  tempZ.resize( 0 );
-  trimPolygonToBoundary( x, y, z, tempX, tempY, tempZ, clipRect, XMin, clipRect.xMinimum() );
-  x.resize( 0 );
-  y.resize( 0 );
-  z.resize( 0 );
-  trimPolygonToBoundary( tempX, tempY, tempZ, x, y, z, clipRect, YMin, clipRect.yMinimum() );
-
-  if ( !clipRect.is2d() )
-  {
-    tempX.resize( 0 );
-    tempY.resize( 0 );
-    tempZ.resize( 0 );
-    trimPolygonToBoundary( x, y, z, tempX, tempY, tempZ, clipRect, ZMax, clipRect.zMaximum() );
-    x.resize( 0 );
-    y.resize( 0 );
-    z.resize( 0 );
-    trimPolygonToBoundary( tempX, tempY, tempZ, x, y, z, clipRect, ZMin, clipRect.zMinimum() );
-  }
-}
-
 // An auxiliary function that is part of the polygon trimming
 // code. Will trim the given polygon to the given boundary and return
 // the trimmed polygon in the out pointer. Uses Sutherland and
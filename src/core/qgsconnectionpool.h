@@ -35,6 +35,43 @@
 #define CONN_POOL_EXPIRATION_TIME           60    // in seconds
 #define CONN_POOL_SPARE_CONNECTIONS          2    // number of spare connections in case all the base connections are used but we have a nested request with the risk of a deadlock
 
+/**
+ * \ingroup core
+ * \brief Usage statistics of the connections of a QgsConnectionPool to a single server or datasource.
+ *
+ * The statistics show whether acquirers wait for connections, i.e. whether the maximum number of
+ * concurrent connections of the pool limits the throughput of the threads using it.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+struct QgsConnectionPoolStatistics
+{
+  //! Number of connections currently acquired
+  int activeConnections = 0;
+
+  //! Number of open connections waiting in the pool to be acquired
+  int idleConnections = 0;
+
+  //! Number of connections opened by the pool
+  long long createdConnections = 0;
+
+  //! Total time in milliseconds spent opening the connections
+  qint64 totalCreationTime = 0;
+
+  //! Number of connections acquired from the pool
+  long long acquisitions = 0;
+
+  //! Number of requests for a connection which timed out, were canceled, or failed to open a connection
+  long long failedAcquisitions = 0;
+
+  //! Total time in milliseconds spent waiting for a connection by the requests
+  qint64 totalWaitTime = 0;
+
+  //! Longest time in milliseconds spent waiting for a connection by a request
+  qint64 maximumWaitTime = 0;
+};
+
 
 /**
  * \ingroup core
@@ -125,7 +162,11 @@ class QgsConnectionPoolGroup
           if ( !qgsConnectionPool_ConnectionIsValid( i.c ) )
           {
             qgsConnectionPool_ConnectionDestroy( i.c );
+            QElapsedTimer creationTimer;
+            creationTimer.start();
             qgsConnectionPool_ConnectionCreate( connInfo, i.c );
+            ++stats.createdConnections;
+            stats.totalCreationTime += creationTimer.elapsed();
           }
 
 
@@ -142,6 +183,8 @@ class QgsConnectionPoolGroup
         }
       }
 
+      QElapsedTimer creationTimer;
+      creationTimer.start();
       T c;
       qgsConnectionPool_ConnectionCreate( connInfo, c );
       if ( !c )
@@ -153,6 +196,8 @@ class QgsConnectionPoolGroup
 
       connMutex.lock();
       acquiredConns.append( c );
+      ++stats.createdConnections;
+      stats.totalCreationTime += creationTimer.elapsed();
       connMutex.unlock();
       return c;
     }
@@ -184,6 +229,81 @@ class QgsConnectionPoolGroup
       sem.release(); // this can unlock a thread waiting in acquire()
     }
 
+    /**
+     * Opens connections until the group holds \a count open connections, so that the next
+     * requests don't have to wait for them to be opened. The \a count is limited to the
+     * maximum number of concurrent connections per pool.
+     *
+     * As other idle connections, the opened connections are closed when they are not
+     * acquired after some time.
+     *
+     * \since QGIS 3.30
+     */
+    void warmUp( int count )
+    {
+      count = std::min( count, QgsApplication::instance()->maxConcurrentConnectionsPerPool() );
+      for ( ;; )
+      {
+        {
+          QMutexLocker locker( &connMutex );
+          if ( conns.count() + acquiredConns.count() >= count )
+            break;
+        }
+
+        QElapsedTimer creationTimer;
+        creationTimer.start();
+        T c;
+        qgsConnectionPool_ConnectionCreate( connInfo, c );
+        if ( !c )
+          break;
+
+        QMutexLocker locker( &connMutex );
+        ++stats.createdConnections;
+        stats.totalCreationTime += creationTimer.elapsed();
+        Item i;
+        i.c = c;
+        i.lastUsedTime = QTime::currentTime();
+        conns.push( i );
+
+        if ( !expirationTimer->isActive() )
+        {
+          // will call the slot directly or queue the call (if the object lives in a different thread)
+          QMetaObject::invokeMethod( expirationTimer->parent(), "startExpirationTimer" );
+        }
+      }
+    }
+
+    /**
+     * Records a request for a connection of the group, which waited \a waitTime milliseconds
+     * and \a acquired a connection or not.
+     *
+     * \since QGIS 3.30
+     */
+    void recordAcquisition( qint64 waitTime, bool acquired )
+    {
+      QMutexLocker locker( &connMutex );
+      if ( acquired )
+        ++stats.acquisitions;
+      else
+        ++stats.failedAcquisitions;
+      stats.totalWaitTime += waitTime;
+      stats.maximumWaitTime = std::max( stats.maximumWaitTime, waitTime );
+    }
+
+    /**
+     * Returns the usage statistics of the connections of the group.
+     *
+     * \since QGIS 3.30
+     */
+    QgsConnectionPoolStatistics statistics()
+    {
+      QMutexLocker locker( &connMutex );
+      QgsConnectionPoolStatistics result = stats;
+      result.activeConnections = acquiredConns.count();
+      result.idleConnections = conns.count();
+      return result;
+    }
+
     void invalidateConnections()
     {
       connMutex.lock();
@@ -216,9 +336,10 @@ class QgsConnectionPoolGroup
 
       QTime now = QTime::currentTime();
 
-      // what connections have expired?
+      // what connections have expired? The most recently used connections, at the top
+      // of the stack, are kept open when the group keeps warm connections
       QList<int> toDelete;
-      for ( int i = 0; i < conns.count(); ++i )
+      for ( int i = 0; i < conns.count() - mWarmConnectionCount; ++i )
       {
         if ( conns.at( i ).lastUsedTime.secsTo( now ) >= CONN_POOL_EXPIRATION_TIME )
           toDelete.append( i );
@@ -232,12 +353,25 @@ class QgsConnectionPoolGroup
         conns.remove( index );
       }
 
-      if ( conns.isEmpty() )
+      if ( conns.count() <= mWarmConnectionCount )
         expirationTimer->stop();
 
       connMutex.unlock();
     }
 
+    /**
+     * Sets the number of idle connections which are kept open when they expire, so that they can be
+     * reused by later requests without opening them again. Defaults to 0, i.e. all the idle connections
+     * are closed after some time.
+     *
+     * \since QGIS 3.30
+     */
+    void setWarmConnectionCount( int count )
+    {
+      const QMutexLocker locker( &connMutex );
+      mWarmConnectionCount = count;
+    }
+
   protected:
 
     QString connInfo;
@@ -246,6 +380,8 @@ class QgsConnectionPoolGroup
     QMutex connMutex;
     QSemaphore sem;
     QTimer *expirationTimer = nullptr;
+    QgsConnectionPoolStatistics stats;
+    int mWarmConnectionCount = 0;
 
 };
 
@@ -306,25 +442,26 @@ class QgsConnectionPool
       T_Group *group = *it;
       mMutex.unlock();
 
+      QElapsedTimer timer;
+      timer.start();
+
+      T conn = nullptr;
       if ( feedback )
       {
-        QElapsedTimer timer;
-        timer.start();
-
         while ( !feedback->isCanceled() )
         {
-          if ( T conn = group->acquire( 300, requestMayBeNested ) )
-            return conn;
-
-          if ( timeout > 0 && timer.elapsed() >= timeout )
-            return nullptr;
+          conn = group->acquire( 300, requestMayBeNested );
+          if ( conn || ( timeout > 0 && timer.elapsed() >= timeout ) )
+            break;
         }
-        return nullptr;
       }
       else
       {
-        return group->acquire( timeout, requestMayBeNested );
+        conn = group->acquire( timeout, requestMayBeNested );
       }
+
+      group->recordAcquisition( timer.elapsed(), static_cast< bool >( conn ) );
+      return conn;
     }
 
     //! Release an existing connection so it will get back into the pool and can be reused
@@ -355,6 +492,38 @@ class QgsConnectionPool
     }
 
 
+    /**
+     * Opens connections to the specified resource until \a count connections are open,
+     * e.g. to avoid opening them when a server starts handling requests.
+     *
+     * \since QGIS 3.30
+     */
+    void warmUpConnections( const QString &connInfo, int count )
+    {
+      mMutex.lock();
+      typename T_Groups::iterator it = mGroups.find( connInfo );
+      if ( it == mGroups.end() )
+      {
+        it = mGroups.insert( connInfo, new T_Group( connInfo ) );
+      }
+      T_Group *group = *it;
+      mMutex.unlock();
+
+      group->warmUp( count );
+    }
+
+    /**
+     * Returns the usage statistics of the connections to the specified resource.
+     *
+     * \since QGIS 3.30
+     */
+    QgsConnectionPoolStatistics statistics( const QString &connInfo )
+    {
+      QMutexLocker locker( &mMutex );
+      typename T_Groups::const_iterator it = mGroups.constFind( connInfo );
+      return it == mGroups.constEnd() ? QgsConnectionPoolStatistics() : ( *it )->statistics();
+    }
+
   protected:
     T_Groups mGroups;
     QMutex mMutex;
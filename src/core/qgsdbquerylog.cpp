@@ -15,6 +15,7 @@
 
 #include "qgsdbquerylog.h"
 #include "qgsapplication.h"
+#include "qgsmessagelog.h"
 #include <QDateTime>
 
 //
@@ -35,6 +36,7 @@ QgsDatabaseQueryLogEntry::QgsDatabaseQueryLogEntry( const QString &query )
 //
 
 bool QgsDatabaseQueryLog::sEnabled = false;
+int QgsDatabaseQueryLog::sSlowQueryThreshold = 0;
 
 QgsDatabaseQueryLog::QgsDatabaseQueryLog( QObject *parent )
   : QObject( parent )
@@ -52,13 +54,25 @@ void QgsDatabaseQueryLog::log( const QgsDatabaseQueryLogEntry &query )
 
 void QgsDatabaseQueryLog::finished( const QgsDatabaseQueryLogEntry &query )
 {
-  if ( !sEnabled )
+  const int slowQueryThreshold = sSlowQueryThreshold;
+  if ( !sEnabled && slowQueryThreshold <= 0 )
     return;
 
   // record time of completion
   QgsDatabaseQueryLogEntry finishedQuery = query;
   finishedQuery.finishedTime = QDateTime::currentMSecsSinceEpoch();
 
+  const quint64 elapsed = finishedQuery.finishedTime - finishedQuery.startedTime;
+  if ( slowQueryThreshold > 0 && elapsed >= static_cast< quint64 >( slowQueryThreshold ) )
+  {
+    const QString rows = finishedQuery.fetchedRows >= 0 ? QObject::tr( "%n row(s)", nullptr, finishedQuery.fetchedRows ) : QObject::tr( "unknown rows" );
+    QgsMessageLog::logMessage( QObject::tr( "Slow %1 query (%2 ms, %3) from %4: %5" ).arg( finishedQuery.provider ).arg( elapsed ).arg( rows, finishedQuery.initiatorClass, finishedQuery.query ),
+                               QObject::tr( "Database" ), Qgis::MessageLevel::Warning );
+  }
+
+  if ( !sEnabled )
+    return;
+
   QMetaObject::invokeMethod( QgsApplication::databaseQueryLog(), "queryFinishedPrivate", Qt::QueuedConnection, Q_ARG( QgsDatabaseQueryLogEntry, finishedQuery ) );
 }
 
@@ -160,6 +160,28 @@ class CORE_EXPORT QgsDatabaseQueryLog: public QObject
      */
     static bool enabled() { return sEnabled; }
 
+    /**
+     * Sets the \a threshold duration (in milliseconds) from which finished queries are reported as slow
+     * queries in the message log.
+     *
+     * Slow queries are reported even when the query log is disabled. A threshold of 0 or less disables the
+     * reports, which is the default.
+     *
+     * \note Not available in Python bindings
+     * \see slowQueryThreshold()
+     * \since QGIS 3.30
+     */
+    static void setSlowQueryThreshold( int threshold ) SIP_SKIP { sSlowQueryThreshold = threshold; }
+
+    /**
+     * Returns the threshold duration (in milliseconds) from which finished queries are reported as slow
+     * queries in the message log, or 0 or less if slow queries are not reported.
+     *
+     * \see setSlowQueryThreshold()
+     * \since QGIS 3.30
+     */
+    static int slowQueryThreshold() { return sSlowQueryThreshold; }
+
     /**
      * Logs a database \a query as starting.
      *
@@ -209,6 +231,7 @@ class CORE_EXPORT QgsDatabaseQueryLog: public QObject
   private:
 
     static bool sEnabled;
+    static int sSlowQueryThreshold;
 
 };
 
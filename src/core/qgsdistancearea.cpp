@@ -177,10 +177,15 @@ double QgsDistanceArea::measure( const QgsAbstractGeometry *geomV2, MeasureType
         return 0.0;
       }
 
-      QgsLineString *lineString = curve->curveToLine();
-      const double length = measureLine( lineString );
-      delete lineString;
-      return length;
+      // line strings are measured directly, without a segmentized copy
+      std::unique_ptr< QgsLineString > segmentized;
+      const QgsLineString *lineString = qgsgeometry_cast< const QgsLineString * >( curve );
+      if ( !lineString )
+      {
+        segmentized.reset( curve->curveToLine() );
+        lineString = segmentized.get();
+      }
+      return measureLine( lineString );
     }
     else
     {
@@ -188,7 +193,13 @@ double QgsDistanceArea::measure( const QgsAbstractGeometry *geomV2, MeasureType
       if ( !surface )
         return 0.0;
 
-      QgsPolygon *polygon = surface->surfaceToPolygon();
+      std::unique_ptr< QgsPolygon > segmentized;
+      const QgsPolygon *polygon = qgsgeometry_cast< const QgsPolygon * >( surface );
+      if ( !polygon )
+      {
+        segmentized.reset( surface->surfaceToPolygon() );
+        polygon = segmentized.get();
+      }
 
       double area = 0;
       const QgsCurve *outerRing = polygon->exteriorRing();
@@ -199,7 +210,6 @@ double QgsDistanceArea::measure( const QgsAbstractGeometry *geomV2, MeasureType
         const QgsCurve *innerRing = polygon->interiorRing( i );
         area -= measurePolygon( innerRing );
       }
-      delete polygon;
       return area;
     }
   }
@@ -288,6 +298,12 @@ double QgsDistanceArea::measureLine( const QgsCurve *curve ) const
     return 0.0;
   }
 
+  if ( willUseEllipsoid() )
+  {
+    if ( const QgsLineString *lineString = qgsgeometry_cast< const QgsLineString * >( curve ) )
+      return measureLineEllipsoidal( lineString->xVector(), lineString->yVector() );
+  }
+
   QgsPointSequence linePointsV2;
   QVector<QgsPointXY> linePoints;
   curve->points( linePointsV2 );
@@ -300,47 +316,46 @@ double QgsDistanceArea::measureLine( const QVector<QgsPointXY> &points ) const
   if ( points.size() < 2 )
     return 0;
 
-  double total = 0;
-  QgsPointXY p1, p2;
-
   if ( willUseEllipsoid() )
   {
-    if ( !mGeod )
-      computeAreaInit();
-    Q_ASSERT_X( static_cast<bool>( mGeod ), "QgsDistanceArea::measureLine()", "Error creating geod_geodesic object" );
-    if ( !mGeod )
-      return 0;
+    QVector<double> x;
+    QVector<double> y;
+    x.reserve( points.size() );
+    y.reserve( points.size() );
+    for ( const QgsPointXY &point : points )
+    {
+      x << point.x();
+      y << point.y();
+    }
+    return measureLineEllipsoidal( x, y );
   }
 
-  try
+  double total = 0;
+  QgsPointXY p1 = points[0];
+  for ( const QgsPointXY &p2 : points )
   {
-    if ( willUseEllipsoid() )
-      p1 = mCoordTransform.transform( points[0] );
-    else
-      p1 = points[0];
-
-    for ( QVector<QgsPointXY>::const_iterator i = points.constBegin(); i != points.constEnd(); ++i )
-    {
-      if ( willUseEllipsoid() )
-      {
-        p2 = mCoordTransform.transform( *i );
+    total += measureLine( p1, p2 );
+    p1 = p2;
+  }
+  return total;
+}
 
-        double distance = 0;
-        double azimuth1 = 0;
-        double azimuth2 = 0;
-        geod_inverse( mGeod.get(), p1.y(), p1.x(), p2.y(), p2.x(), &distance, &azimuth1, &azimuth2 );
-        total += distance;
-      }
-      else
-      {
-        p2 = *i;
-        total += measureLine( p1, p2 );
-      }
+double QgsDistanceArea::measureLineEllipsoidal( QVector<double> x, QVector<double> y ) const
+{
+  if ( x.size() < 2 )
+    return 0;
 
-      p1 = p2;
-    }
+  if ( !mGeod )
+    computeAreaInit();
+  Q_ASSERT_X( static_cast<bool>( mGeod ), "QgsDistanceArea::measureLine()", "Error creating geod_geodesic object" );
+  if ( !mGeod )
+    return 0;
 
-    return total;
+  try
+  {
+    // a single transform call for all the vertices avoids the overhead of transforming them one by one
+    QVector<double> z( x.size(), 0.0 );
+    mCoordTransform.transformInPlace( x, y, z );
   }
   catch ( QgsCsException &cse )
   {
@@ -349,6 +364,16 @@ double QgsDistanceArea::measureLine( const QVector<QgsPointXY> &points ) const
     return 0.0;
   }
 
+  double total = 0;
+  for ( int i = 1; i < x.size(); ++i )
+  {
+    double distance = 0;
+    double azimuth1 = 0;
+    double azimuth2 = 0;
+    geod_inverse( mGeod.get(), y.at( i - 1 ), x.at( i - 1 ), y.at( i ), x.at( i ), &distance, &azimuth1, &azimuth2 );
+    total += distance;
+  }
+  return total;
 }
 
 double QgsDistanceArea::measureLine( const QgsPointXY &p1, const QgsPointXY &p2 ) const
@@ -805,6 +830,12 @@ double QgsDistanceArea::measurePolygon( const QgsCurve *curve ) const
     return 0.0;
   }
 
+  if ( willUseEllipsoid() )
+  {
+    if ( const QgsLineString *lineString = qgsgeometry_cast< const QgsLineString * >( curve ) )
+      return measurePolygonEllipsoidal( lineString->xVector(), lineString->yVector() );
+  }
+
   QgsPointSequence linePointsV2;
   curve->points( linePointsV2 );
   QVector<QgsPointXY> linePoints;
@@ -815,21 +846,32 @@ double QgsDistanceArea::measurePolygon( const QgsCurve *curve ) const
 
 double QgsDistanceArea::measurePolygon( const QVector<QgsPointXY> &points ) const
 {
-  try
+  if ( willUseEllipsoid() )
   {
-    if ( willUseEllipsoid() )
-    {
-      QVector<QgsPointXY> pts;
-      for ( QVector<QgsPointXY>::const_iterator i = points.constBegin(); i != points.constEnd(); ++i )
-      {
-        pts.append( mCoordTransform.transform( *i ) );
-      }
-      return computePolygonArea( pts );
-    }
-    else
+    QVector<double> x;
+    QVector<double> y;
+    x.reserve( points.size() );
+    y.reserve( points.size() );
+    for ( const QgsPointXY &point : points )
     {
-      return computePolygonArea( points );
+      x << point.x();
+      y << point.y();
     }
+    return measurePolygonEllipsoidal( x, y );
+  }
+
+  return computePolygonArea( points );
+}
+
+double QgsDistanceArea::measurePolygonEllipsoidal( QVector<double> x, QVector<double> y ) const
+{
+  if ( x.isEmpty() )
+    return 0;
+
+  try
+  {
+    QVector<double> z( x.size(), 0.0 );
+    mCoordTransform.transformInPlace( x, y, z );
   }
   catch ( QgsCsException &cse )
   {
@@ -837,6 +879,12 @@ double QgsDistanceArea::measurePolygon( const QVector<QgsPointXY> &points ) cons
     QgsMessageLog::logMessage( QObject::tr( "Caught a coordinate system exception while trying to transform a point. Unable to calculate polygon area." ) );
     return 0.0;
   }
+
+  QVector<QgsPointXY> points;
+  points.reserve( x.size() );
+  for ( int i = 0; i < x.size(); ++i )
+    points << QgsPointXY( x.at( i ), y.at( i ) );
+  return computePolygonArea( points );
 }
 
 
@@ -408,6 +408,18 @@ class CORE_EXPORT QgsDistanceArea
     double measureLine( const QgsCurve *curve ) const;
     double measurePolygon( const QgsCurve *curve ) const;
 
+    /**
+     * Measures the length on the ellipsoid of the line with the \a x and \a y coordinates in the source CRS.
+     * The vertices are transformed to the ellipsoid at once.
+     */
+    double measureLineEllipsoidal( QVector<double> x, QVector<double> y ) const;
+
+    /**
+     * Measures the area on the ellipsoid of the ring with the \a x and \a y coordinates in the source CRS.
+     * The vertices are transformed to the ellipsoid at once.
+     */
+    double measurePolygonEllipsoidal( QVector<double> x, QVector<double> y ) const;
+
 };
 
 #endif
@@ -116,7 +116,8 @@ bool QgsExpressionContextScope::hasVariable( const QString &name ) const
 
 QVariant QgsExpressionContextScope::variable( const QString &name ) const
 {
-  return hasVariable( name ) ? mVariables.value( name ).value : QVariant();
+  const auto it = mVariables.constFind( name );
+  return it != mVariables.constEnd() ? it->value : QVariant();
 }
 
 QStringList QgsExpressionContextScope::variableNames() const
@@ -367,8 +368,7 @@ QgsExpressionContext::~QgsExpressionContext()
 
 bool QgsExpressionContext::hasVariable( const QString &name ) const
 {
-  const auto constMStack = mStack;
-  for ( const QgsExpressionContextScope *scope : constMStack )
+  for ( const QgsExpressionContextScope *scope : std::as_const( mStack ) )
   {
     if ( scope->hasVariable( name ) )
       return true;
@@ -378,8 +378,16 @@ bool QgsExpressionContext::hasVariable( const QString &name ) const
 
 QVariant QgsExpressionContext::variable( const QString &name ) const
 {
-  const QgsExpressionContextScope *scope = activeScopeForVariable( name );
-  return scope ? scope->variable( name ) : QVariant();
+  // a single lookup per scope, as variables are read for every evaluated feature
+  QList< QgsExpressionContextScope * >::const_iterator it = mStack.constEnd();
+  while ( it != mStack.constBegin() )
+  {
+    --it;
+    const auto variableIt = ( *it )->mVariables.constFind( name );
+    if ( variableIt != ( *it )->mVariables.constEnd() )
+      return variableIt->value;
+  }
+  return QVariant();
 }
 
 QVariantMap QgsExpressionContext::variablesToMap() const
@@ -452,6 +452,10 @@ class CORE_EXPORT QgsExpressionContextScope
     QList< QgsMapLayerStore * > layerStores() const;
 
   private:
+
+    //! QgsExpressionContext reads the variables directly, to look them up once per scope
+    friend class QgsExpressionContext;
+
     QString mName;
     QHash<QString, StaticVariable> mVariables;
     QHash<QString, QgsScopedExpressionFunction * > mFunctions;
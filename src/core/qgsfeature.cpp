@@ -318,7 +318,7 @@ bool QgsFeature::isUnsetValue( int fieldIdx ) const
   if ( fieldIdx < 0 || fieldIdx >= d->attributes.count() )
     return false;
 
-  return d->attributes.at( fieldIdx ).userType() == QMetaType::type( "QgsUnsetAttributeValue" );
+  return d->attributes.at( fieldIdx ).userType() == qMetaTypeId< QgsUnsetAttributeValue >();
 }
 
 const QgsSymbol *QgsFeature::embeddedSymbol() const
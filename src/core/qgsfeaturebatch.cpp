@@ -0,0 +1,240 @@
+/***************************************************************************
+    qgsfeaturebatch.cpp
+    ---------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsfeaturebatch.h"
+#include "qgsfeature.h"
+#include "qgsvariantutils.h"
+
+QgsFeatureBatch::Column::Column( ColumnType type )
+  : mType( type )
+{
+  if ( mType == ColumnType::String )
+    mStringOffsets.append( 0 );
+}
+
+QVariant QgsFeatureBatch::Column::value( int row ) const
+{
+  switch ( mType )
+  {
+    case ColumnType::Int64:
+      return isNull( row ) ? QVariant( QVariant::LongLong ) : QVariant( mInt64Values.at( row ) );
+
+    case ColumnType::Double:
+      return isNull( row ) ? QVariant( QVariant::Double ) : QVariant( mDoubleValues.at( row ) );
+
+    case ColumnType::String:
+      return isNull( row ) ? QVariant( QVariant::String ) : QVariant( stringValue( row ) );
+
+    case ColumnType::Variant:
+      return mVariantValues.at( row );
+  }
+  return QVariant();
+}
+
+QString QgsFeatureBatch::Column::stringValue( int row ) const
+{
+  if ( mType != ColumnType::String || isNull( row ) )
+    return QString();
+
+  const qint32 start = mStringOffsets.at( row );
+  return QString::fromUtf8( mStringData.constData() + start, mStringOffsets.at( row + 1 ) - start );
+}
+
+void QgsFeatureBatch::Column::appendNull()
+{
+  switch ( mType )
+  {
+    case ColumnType::Int64:
+      mInt64Values.append( 0 );
+      break;
+
+    case ColumnType::Double:
+      mDoubleValues.append( 0 );
+      break;
+
+    case ColumnType::String:
+      mStringOffsets.append( mStringData.size() );
+      break;
+
+    case ColumnType::Variant:
+      mVariantValues.append( QVariant() );
+      break;
+  }
+  appendValidity( false );
+}
+
+void QgsFeatureBatch::Column::appendUtf8( const char *data, int length )
+{
+  mStringData.append( data, length );
+  mStringOffsets.append( mStringData.size() );
+  appendValidity( true );
+}
+
+void QgsFeatureBatch::Column::appendString( const QString &value )
+{
+  const QByteArray utf8 = value.toUtf8();
+  appendUtf8( utf8.constData(), utf8.size() );
+}
+
+void QgsFeatureBatch::Column::appendValue( const QVariant &value )
+{
+  if ( mType == ColumnType::Variant )
+  {
+    mVariantValues.append( value );
+    appendValidity( !QgsVariantUtils::isNull( value ) );
+    return;
+  }
+
+  if ( QgsVariantUtils::isNull( value ) )
+  {
+    appendNull();
+    return;
+  }
+
+  bool ok = false;
+  switch ( mType )
+  {
+    case ColumnType::Int64:
+    {
+      const qint64 v = value.toLongLong( &ok );
+      if ( ok )
+        appendInt64( v );
+      break;
+    }
+
+    case ColumnType::Double:
+    {
+      const double v = value.toDouble( &ok );
+      if ( ok )
+        appendDouble( v );
+      break;
+    }
+
+    case ColumnType::String:
+      appendString( value.toString() );
+      ok = true;
+      break;
+
+    case ColumnType::Variant:
+      break;
+  }
+
+  if ( !ok )
+    appendNull();
+}
+
+void QgsFeatureBatch::Column::clear()
+{
+  mSize = 0;
+  mValidity.resize( 0 );
+  mInt64Values.resize( 0 );
+  mDoubleValues.resize( 0 );
+  mStringData.resize( 0 );
+  mVariantValues.resize( 0 );
+  mStringOffsets.resize( mType == ColumnType::String ? 1 : 0 );
+}
+
+void QgsFeatureBatch::Column::reserve( int size )
+{
+  mValidity.reserve( ( size + 7 ) / 8 );
+  switch ( mType )
+  {
+    case ColumnType::Int64:
+      mInt64Values.reserve( size );
+      break;
+
+    case ColumnType::Double:
+      mDoubleValues.reserve( size );
+      break;
+
+    case ColumnType::String:
+      mStringOffsets.reserve( size + 1 );
+      break;
+
+    case ColumnType::Variant:
+      mVariantValues.reserve( size );
+      break;
+  }
+}
+
+QgsFeatureBatch::ColumnType QgsFeatureBatch::columnTypeForField( QVariant::Type type )
+{
+  switch ( type )
+  {
+    case QVariant::Bool:
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+      return ColumnType::Int64;
+
+    case QVariant::Double:
+      return ColumnType::Double;
+
+    case QVariant::String:
+      return ColumnType::String;
+
+    default:
+      return ColumnType::Variant;
+  }
+}
+
+QgsFeatureBatch::QgsFeatureBatch( const QgsFields &fields, const QgsAttributeList &attributes )
+  : mFields( fields )
+  , mAttributes( attributes.isEmpty() ? fields.allAttributesList() : attributes )
+{
+  mColumns.reserve( mAttributes.size() );
+  for ( int idx : std::as_const( mAttributes ) )
+  {
+    mColumns.append( Column( columnTypeForField( mFields.at( idx ).type() ) ) );
+  }
+}
+
+QgsAttributes QgsFeatureBatch::attributes( int row ) const
+{
+  QgsAttributes attributes( mFields.count() );
+  for ( int i = 0; i < mColumns.size(); ++i )
+  {
+    attributes[ mAttributes.at( i ) ] = mColumns.at( i ).value( row );
+  }
+  return attributes;
+}
+
+void QgsFeatureBatch::appendFeature( const QgsFeature &feature )
+{
+  mIds.append( feature.id() );
+  const QgsAttributes attributes = feature.attributes();
+  for ( int i = 0; i < mColumns.size(); ++i )
+  {
+    const int idx = mAttributes.at( i );
+    if ( idx < attributes.size() )
+      mColumns[ i ].appendValue( attributes.at( idx ) );
+    else
+      mColumns[ i ].appendNull();
+  }
+}
+
+void QgsFeatureBatch::clear()
+{
+  mIds.resize( 0 );
+  for ( Column &column : mColumns )
+    column.clear();
+}
+
+void QgsFeatureBatch::reserve( int size )
+{
+  mIds.reserve( size );
+  for ( Column &column : mColumns )
+    column.reserve( size );
+}
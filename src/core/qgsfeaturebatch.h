@@ -0,0 +1,258 @@
+/***************************************************************************
+    qgsfeaturebatch.h
+    ---------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSFEATUREBATCH_H
+#define QGSFEATUREBATCH_H
+
+#include "qgis_core.h"
+#include "qgsfeatureid.h"
+#include "qgsfields.h"
+#include "qgsattributes.h"
+
+#include <QByteArray>
+#include <QVariant>
+#include <QVector>
+
+#define SIP_NO_FILE
+
+class QgsFeature;
+
+/**
+ * \ingroup core
+ * \class QgsFeatureBatch
+ *
+ * \brief Column oriented storage for the attributes of a batch of features.
+ *
+ * A batch stores the feature ids of up to a fixed number of features together with
+ * one typed column per requested attribute. Columns follow the Apache Arrow memory
+ * layout: numeric values are stored in contiguous arrays, strings as a single UTF-8
+ * buffer with an offsets array, and NULL values are tracked in a validity bitmap
+ * (one bit per row, least significant bit first, bit set when the value is not NULL).
+ *
+ * Batches are filled by QgsFeatureIterator::nextBatch(). Providers which can read
+ * their attributes in a columnar way fill the columns directly, all other providers
+ * go through a fallback which converts the features one by one.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsFeatureBatch
+{
+  public:
+
+    //! Storage type of a batch column
+    enum class ColumnType
+    {
+      Int64, //!< Integer and boolean values, stored as 64 bit integers
+      Double, //!< Floating point values
+      String, //!< UTF-8 encoded strings
+      Variant, //!< Any other attribute type, stored as QVariant values
+    };
+
+    /**
+     * \ingroup core
+     * \brief A single typed column of a QgsFeatureBatch.
+     * \since QGIS 3.30
+     */
+    class CORE_EXPORT Column
+    {
+      public:
+
+        /**
+         * Constructor for a column of the given \a type.
+         */
+        explicit Column( ColumnType type = ColumnType::Variant );
+
+        //! Returns the storage type of the column
+        ColumnType type() const { return mType; }
+
+        //! Returns the number of values stored in the column
+        int size() const { return mSize; }
+
+        //! Returns TRUE if the value at \a row is NULL
+        bool isNull( int row ) const { return !( mValidity.at( row >> 3 ) & ( 1 << ( row & 7 ) ) ); }
+
+        /**
+         * Returns the validity bitmap of the column, one bit per row, set when the value is not NULL.
+         */
+        const QByteArray &validity() const { return mValidity; }
+
+        /**
+         * Returns the integer values of an Int64 column. NULL rows contain 0.
+         */
+        const QVector< qint64 > &int64Values() const { return mInt64Values; }
+
+        /**
+         * Returns the values of a Double column. NULL rows contain 0.
+         */
+        const QVector< double > &doubleValues() const { return mDoubleValues; }
+
+        /**
+         * Returns the UTF-8 encoded data of a String column.
+         * \see stringOffsets()
+         */
+        const QByteArray &stringData() const { return mStringData; }
+
+        /**
+         * Returns the offsets of the strings of a String column within stringData().
+         * The string of \a row spans from offset \a row to offset \a row + 1, so the
+         * vector contains size() + 1 entries.
+         */
+        const QVector< qint32 > &stringOffsets() const { return mStringOffsets; }
+
+        /**
+         * Returns the values of a Variant column.
+         */
+        const QVector< QVariant > &variantValues() const { return mVariantValues; }
+
+        //! Returns the value at \a row converted to a QVariant.
+        QVariant value( int row ) const;
+
+        //! Returns the string at \a row from a String column.
+        QString stringValue( int row ) const;
+
+        //! Appends a NULL value
+        void appendNull();
+
+        //! Appends an integer value to an Int64 column
+        void appendInt64( qint64 value )
+        {
+          mInt64Values.append( value );
+          appendValidity( true );
+        }
+
+        //! Appends a value to a Double column
+        void appendDouble( double value )
+        {
+          mDoubleValues.append( value );
+          appendValidity( true );
+        }
+
+        //! Appends \a length bytes of UTF-8 encoded \a data to a String column
+        void appendUtf8( const char *data, int length );
+
+        //! Appends a string to a String column
+        void appendString( const QString &value );
+
+        /**
+         * Appends a \a value to the column, converting it to the column type.
+         * NULL or invalid values, as well as values which cannot be converted, are stored as NULL.
+         */
+        void appendValue( const QVariant &value );
+
+        //! Removes all values from the column, keeping the allocated memory
+        void clear();
+
+        //! Reserves space for \a size values
+        void reserve( int size );
+
+      private:
+
+        void appendValidity( bool valid )
+        {
+          if ( ( mSize & 7 ) == 0 )
+            mValidity.append( '\0' );
+          if ( valid )
+            mValidity.data()[ mSize >> 3 ] |= static_cast< char >( 1 << ( mSize & 7 ) );
+          ++mSize;
+        }
+
+        ColumnType mType = ColumnType::Variant;
+        int mSize = 0;
+        QByteArray mValidity;
+        QVector< qint64 > mInt64Values;
+        QVector< double > mDoubleValues;
+        QByteArray mStringData;
+        QVector< qint32 > mStringOffsets;
+        QVector< QVariant > mVariantValues;
+    };
+
+    /**
+     * Returns the column type used to store values of a field of the given \a type.
+     */
+    static ColumnType columnTypeForField( QVariant::Type type );
+
+    /**
+     * Constructor for an empty batch.
+     *
+     * The batch contains one column for each of the \a attributes indexes from \a fields,
+     * in the same order. If \a attributes is empty, all fields are used.
+     *
+     * Iterators only fill the attributes they fetch, so if the request used to create the
+     * iterator only fetches a subset of attributes, the batch should not contain other attributes.
+     */
+    explicit QgsFeatureBatch( const QgsFields &fields = QgsFields(), const QgsAttributeList &attributes = QgsAttributeList() );
+
+    //! Returns the fields of the batch
+    QgsFields fields() const { return mFields; }
+
+    //! Returns the number of features stored in the batch
+    int size() const { return mIds.size(); }
+
+    //! Returns TRUE if the batch does not contain any feature
+    bool isEmpty() const { return mIds.isEmpty(); }
+
+    //! Returns the ids of the features stored in the batch
+    const QVector< QgsFeatureId > &ids() const { return mIds; }
+
+    //! Returns the number of columns
+    int columnCount() const { return mColumns.size(); }
+
+    //! Returns the field index of the column at \a column
+    int columnFieldIndex( int column ) const { return mAttributes.at( column ); }
+
+    //! Returns the field indexes of all columns
+    const QgsAttributeList &attributes() const { return mAttributes; }
+
+    //! Returns the column at \a column
+    const Column &column( int column ) const { return mColumns.at( column ); }
+
+    /**
+     * Returns the column at \a column, for use by feature iterators filling the batch.
+     */
+    Column &column( int column ) { return mColumns[ column ]; }
+
+    /**
+     * Returns the index of the column storing the field at \a fieldIndex, or -1 if the field is not part of the batch.
+     */
+    int columnIndex( int fieldIndex ) const { return mAttributes.indexOf( fieldIndex ); }
+
+    //! Returns the attribute values of the feature at \a row
+    QgsAttributes attributes( int row ) const;
+
+    /**
+     * Starts a new row for the feature with the given \a id.
+     * Iterators must append exactly one value to every column after calling this method.
+     */
+    void appendId( QgsFeatureId id ) { mIds.append( id ); }
+
+    /**
+     * Appends the id and the attribute values of \a feature to the batch.
+     */
+    void appendFeature( const QgsFeature &feature );
+
+    //! Removes all features from the batch, keeping the columns and the allocated memory
+    void clear();
+
+    //! Reserves space for \a size features
+    void reserve( int size );
+
+  private:
+
+    QgsFields mFields;
+    QgsAttributeList mAttributes;
+    QVector< QgsFeatureId > mIds;
+    QVector< Column > mColumns;
+};
+
+#endif // QGSFEATUREBATCH_H
@@ -21,6 +21,7 @@
 #include "qgsexpressionsorter_p.h"
 #include "qgsfeedback.h"
 #include "qgscoordinatetransform.h"
+#include "qgsfeaturebatch.h"
 
 QgsAbstractFeatureIterator::QgsAbstractFeatureIterator( const QgsFeatureRequest &request )
   : mRequest( request )
@@ -77,6 +78,32 @@ bool QgsAbstractFeatureIterator::nextFeature( QgsFeature &f )
   return dataOk;
 }
 
+bool QgsAbstractFeatureIterator::nextBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  batch.clear();
+
+  if ( mRequest.limit() >= 0 )
+    maxFeatures = static_cast< int >( std::min( static_cast< long long >( maxFeatures ), mRequest.limit() - mFetchedCount ) );
+
+  if ( maxFeatures <= 0 || ( mRequest.feedback() && mRequest.feedback()->isCanceled() ) )
+    return false;
+
+  // locally ordered features are served from the cache
+  if ( !mUseCachedFeatures && providerCanFetchBatch() )
+  {
+    fetchBatch( batch, maxFeatures );
+    mFetchedCount += batch.size();
+  }
+  else
+  {
+    QgsFeature f;
+    while ( batch.size() < maxFeatures && nextFeature( f ) )
+      batch.appendFeature( f );
+  }
+
+  return !batch.isEmpty();
+}
+
 bool QgsAbstractFeatureIterator::nextFeatureFilterExpression( QgsFeature &f )
 {
   while ( fetchFeature( f ) )
@@ -252,6 +279,18 @@ bool QgsAbstractFeatureIterator::providerCanSimplify( QgsSimplifyMethod::MethodT
   return false;
 }
 
+bool QgsAbstractFeatureIterator::providerCanFetchBatch() const
+{
+  return false;
+}
+
+void QgsAbstractFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  QgsFeature f;
+  while ( batch.size() < maxFeatures && fetchFeature( f ) )
+    batch.appendFeature( f );
+}
+
 bool QgsAbstractFeatureIterator::prepareOrderBy( const QList<QgsFeatureRequest::OrderByClause> &orderBys )
 {
   Q_UNUSED( orderBys )
@@ -20,6 +20,7 @@
 #include "qgsindexedfeature.h"
 
 class QgsFeedback;
+class QgsFeatureBatch;
 
 /**
  * \ingroup core
@@ -46,6 +47,18 @@ class CORE_EXPORT QgsAbstractFeatureIterator
     //! fetch next feature, return TRUE on success
     virtual bool nextFeature( QgsFeature &f );
 
+    /**
+     * Fetches the attributes of up to \a maxFeatures next features into \a batch.
+     *
+     * The batch is cleared first. Iterators which support it fill the batch columns directly,
+     * otherwise the features are fetched one by one with nextFeature().
+     *
+     * \returns TRUE if at least one feature was fetched
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    bool nextBatch( QgsFeatureBatch &batch, int maxFeatures ) SIP_SKIP;
+
     //! reset the iterator to the starting position
     virtual bool rewind() = 0;
     //! end of iterating: free the resources / lock
@@ -138,6 +151,31 @@ class CORE_EXPORT QgsAbstractFeatureIterator
      */
     virtual bool nextFeatureFilterFids( QgsFeature &f );
 
+    /**
+     * Returns TRUE if the iterator can fill batches natively with fetchBatch() for the current request.
+     *
+     * Iterators should only return TRUE if their fetchBatch() implementation honors all
+     * the filters of the request, as the generic filtering of nextFeature() is bypassed.
+     * The default implementation returns FALSE.
+     *
+     * \see fetchBatch()
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    virtual bool providerCanFetchBatch() const SIP_SKIP;
+
+    /**
+     * Fills the cleared \a batch with up to \a maxFeatures features.
+     *
+     * Only called when providerCanFetchBatch() returns TRUE. The default implementation
+     * appends the features returned by fetchFeature().
+     *
+     * \see providerCanFetchBatch()
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    virtual void fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) SIP_SKIP;
+
     /**
      * Transforms \a feature's geometry according to the specified coordinate \a transform.
      * If \a feature has no geometry or \a transform is invalid then calling this method
@@ -324,6 +362,23 @@ class CORE_EXPORT QgsFeatureIterator
     QgsFeatureIterator &operator=( const QgsFeatureIterator &other );
 
     bool nextFeature( QgsFeature &f );
+
+    /**
+     * Fetches the attributes of up to \a maxFeatures next features into \a batch,
+     * in a column oriented layout.
+     *
+     * The batch should be created with the fields of the iterated source and the
+     * attributes fetched by the request, and the same batch layout should be used
+     * for all the calls on an iterator. Mixing nextBatch() and nextFeature() calls
+     * on the same iterator is not supported.
+     *
+     * \returns TRUE if at least one feature was fetched
+     * \see QgsFeatureBatch
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    bool nextBatch( QgsFeatureBatch &batch, int maxFeatures ) SIP_SKIP;
+
     bool rewind();
     bool close();
 
@@ -401,6 +456,11 @@ inline bool QgsFeatureIterator::nextFeature( QgsFeature &f )
   return mIter ? mIter->nextFeature( f ) : false;
 }
 
+inline bool QgsFeatureIterator::nextBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  return mIter ? mIter->nextBatch( batch, maxFeatures ) : false;
+}
+
 inline bool QgsFeatureIterator::rewind()
 {
   if ( mIter )
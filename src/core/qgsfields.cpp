@@ -351,6 +351,11 @@ int QgsFields::lookupField( const QString &fieldName ) const
   if ( fieldName.isEmpty() ) //shortcut
     return -1;
 
+  // exact matches are found in the name index, unless a field was renamed through the non-const accessors
+  const int exactIdx = d->nameToIndex.value( fieldName, -1 );
+  if ( exactIdx >= 0 && exactIdx < count() && d->fields.at( exactIdx ).field.name() == fieldName )
+    return exactIdx;
+
   for ( int idx = 0; idx < count(); ++idx )
   {
     if ( d->fields[idx].field.name() == fieldName )
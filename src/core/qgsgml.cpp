@@ -26,6 +26,7 @@
 #include "qgsapplication.h"
 #include <QBuffer>
 #include <QList>
+#include <QLocale>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QProgressDialog>
@@ -1370,29 +1371,49 @@ int QgsGmlStreamingParser::pointsFromCoordinateString( QList<QgsPointXY> &points
 
 int QgsGmlStreamingParser::pointsFromPosListString( QList<QgsPointXY> &points, const QString &coordString, int dimension ) const
 {
-  // coordinates separated by spaces
-#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
-  QStringList coordinates = coordString.split( ' ', QString::SkipEmptyParts );
-#else
-  const QStringList coordinates = coordString.split( ' ', Qt::SkipEmptyParts );
-#endif
+  // coordinates separated by white spaces. Pos lists can be very long, so the coordinates are
+  // referenced in place instead of splitting the string into a list of new strings
+  QVector< QStringView > coordinates;
+  coordinates.reserve( coordString.size() / 8 );
+  const QStringView coordView( coordString );
+  int tokenStart = -1;
+  for ( int i = 0; i <= coordView.size(); ++i )
+  {
+    if ( i == coordView.size() || coordView.at( i ).isSpace() )
+    {
+      if ( tokenStart >= 0 )
+      {
+        coordinates << coordView.mid( tokenStart, i - tokenStart );
+        tokenStart = -1;
+      }
+    }
+    else if ( tokenStart < 0 )
+    {
+      tokenStart = i;
+    }
+  }
 
   if ( coordinates.size() % dimension != 0 )
   {
     QgsDebugMsg( QStringLiteral( "Wrong number of coordinates" ) );
   }
 
+  // same conversion as QString::toDouble()
+  QLocale cLocale = QLocale::c();
+  cLocale.setNumberOptions( QLocale::RejectGroupSeparator );
+
   const int ncoor = coordinates.size() / dimension;
+  points.reserve( points.size() + ncoor );
   for ( int i = 0; i < ncoor; i++ )
   {
     bool conversionSuccess;
-    const double x = coordinates.value( i * dimension ).toDouble( &conversionSuccess );
+    const double x = cLocale.toDouble( coordinates.at( i * dimension ), &conversionSuccess );
     if ( !conversionSuccess )
     {
       continue;
     }
-    const double y = coordinates.value( i * dimension + 1 ).toDouble( &conversionSuccess );
-    if ( !conversionSuccess )
+    const double y = i * dimension + 1 < coordinates.size() ? cLocale.toDouble( coordinates.at( i * dimension + 1 ), &conversionSuccess ) : 0;
+    if ( !conversionSuccess || i * dimension + 1 >= coordinates.size() )
     {
       continue;
     }
@@ -81,6 +81,49 @@ QString QgsJsonExporter::exportFeature( const QgsFeature &feature, const QVarian
 }
 
 json QgsJsonExporter::exportFeatureToJsonObject( const QgsFeature &feature, const QVariantMap &extraProperties, const QVariant &id ) const
+{
+  return exportFeatureToJsonObject( feature, extraProperties, id, mIncludeAttributes ? exportedAttributes( mLayer ? mLayer->fields() : feature.fields() ) : QVector< ExportedAttribute >() );
+}
+
+QVector< QgsJsonExporter::ExportedAttribute > QgsJsonExporter::exportedAttributes( const QgsFields &fields ) const
+{
+  // List of formatters through we want to pass the values
+  const QStringList formattersAllowList
+  {
+    QStringLiteral( "KeyValue" ),
+    QStringLiteral( "List" ),
+    QStringLiteral( "ValueRelation" ),
+    QStringLiteral( "ValueMap" )
+  };
+
+  QVector< ExportedAttribute > attributes;
+  attributes.reserve( fields.count() );
+  for ( int i = 0; i < fields.count(); ++i )
+  {
+    if ( ( !mAttributeIndexes.isEmpty() && !mAttributeIndexes.contains( i ) ) || mExcludedAttributeIndexes.contains( i ) )
+      continue;
+
+    ExportedAttribute attribute;
+    attribute.index = i;
+    if ( mLayer )
+    {
+      const QgsEditorWidgetSetup setup = fields.at( i ).editorWidgetSetup();
+      const QgsFieldFormatter *fieldFormatter = QgsApplication::fieldFormatterRegistry()->fieldFormatter( setup.type() );
+      if ( formattersAllowList.contains( fieldFormatter->id() ) )
+      {
+        attribute.formatter = fieldFormatter;
+        attribute.config = setup.config();
+      }
+    }
+
+    attribute.name = ( mAttributeDisplayName ? mLayer->attributeDisplayName( i ) : fields.at( i ).name() ).toStdString();
+    attributes << attribute;
+  }
+  return attributes;
+}
+
+json QgsJsonExporter::exportFeatureToJsonObject( const QgsFeature &feature, const QVariantMap &extraProperties, const QVariant &id,
+    const QVector< ExportedAttribute > &attributes ) const
 {
   json featureJson
   {
@@ -151,35 +194,15 @@ json QgsJsonExporter::exportFeatureToJsonObject( const QgsFeature &feature, cons
     //read all attribute values from the feature
     if ( mIncludeAttributes )
     {
-      QgsFields fields = mLayer ? mLayer->fields() : feature.fields();
-      // List of formatters through we want to pass the values
-      QStringList formattersAllowList;
-      formattersAllowList << QStringLiteral( "KeyValue" )
-                          << QStringLiteral( "List" )
-                          << QStringLiteral( "ValueRelation" )
-                          << QStringLiteral( "ValueMap" );
-
-      for ( int i = 0; i < fields.count(); ++i )
+      const QgsAttributes featureAttributes = feature.attributes();
+      for ( const ExportedAttribute &attribute : attributes )
       {
-        if ( ( !mAttributeIndexes.isEmpty() && !mAttributeIndexes.contains( i ) ) || mExcludedAttributeIndexes.contains( i ) )
-          continue;
-
-        QVariant val = feature.attributes().at( i );
+        QVariant val = featureAttributes.at( attribute.index );
 
-        if ( mLayer )
-        {
-          const QgsEditorWidgetSetup setup = fields.at( i ).editorWidgetSetup();
-          const QgsFieldFormatter *fieldFormatter = QgsApplication::fieldFormatterRegistry()->fieldFormatter( setup.type() );
-          if ( formattersAllowList.contains( fieldFormatter->id() ) )
-            val = fieldFormatter->representValue( mLayer.data(), i, setup.config(), QVariant(), val );
-        }
+        if ( attribute.formatter )
+          val = attribute.formatter->representValue( mLayer.data(), attribute.index, attribute.config, QVariant(), val );
 
-        QString name = fields.at( i ).name();
-        if ( mAttributeDisplayName )
-        {
-          name = mLayer->attributeDisplayName( i );
-        }
-        properties[ name.toStdString() ] = QgsJsonUtils::jsonFromVariant( val );
+        properties[ attribute.name ] = QgsJsonUtils::jsonFromVariant( val );
         attributeCounter++;
       }
     }
@@ -244,9 +267,16 @@ json QgsJsonExporter::exportFeaturesToJsonObject( const QgsFeatureList &features
     { "type", "FeatureCollection" },
     { "features", json::array() }
   };
+  json &featuresJson = data["features"];
+
+  // the exported attributes only depend on the fields, which are the same for all the features of a layer
+  const QVector< ExportedAttribute > layerAttributes = mLayer && mIncludeAttributes ? exportedAttributes( mLayer->fields() ) : QVector< ExportedAttribute >();
   for ( const QgsFeature &feature : std::as_const( features ) )
   {
-    data["features"].push_back( exportFeatureToJsonObject( feature ) );
+    if ( mLayer || !mIncludeAttributes )
+      featuresJson.push_back( exportFeatureToJsonObject( feature, QVariantMap(), QVariant(), layerAttributes ) );
+    else
+      featuresJson.push_back( exportFeatureToJsonObject( feature ) );
   }
   return data;
 }
@@ -26,6 +26,7 @@
 #include <QJsonObject>
 
 class QTextCodec;
+class QgsFieldFormatter;
 
 /**
  * \ingroup core
@@ -254,6 +255,26 @@ class CORE_EXPORT QgsJsonExporter
 
   private:
 
+    //! Attribute exported to the properties of the features
+    struct ExportedAttribute
+    {
+      //! Index of the field
+      int index = -1;
+      //! Name of the property
+      std::string name;
+      //! Field formatter used to represent the value, or NULLPTR if the raw value is exported
+      const QgsFieldFormatter *formatter = nullptr;
+      //! Configuration of the field formatter
+      QVariantMap config;
+    };
+
+    //! Returns the attributes of features with the \a fields fields to include in their properties
+    QVector< ExportedAttribute > exportedAttributes( const QgsFields &fields ) const;
+
+    //! Returns a json object representation of a feature, with the precomputed exported \a attributes
+    json exportFeatureToJsonObject( const QgsFeature &feature, const QVariantMap &extraProperties,
+                                    const QVariant &id, const QVector< ExportedAttribute > &attributes ) const;
+
     //! Maximum number of decimal places for geometry coordinates
     int mPrecision;
 
@@ -836,6 +836,26 @@ QString QgsMapLayer::decodedSource( const QString &source, const QString &dataPr
   return source;
 }
 
+QString QgsMapLayer::dataSourceFromXml( const QDomElement &layerElement, const QgsReadWriteContext &context, QString &providerKey ) const
+{
+  QGIS_PROTECT_QOBJECT_THREAD_ACCESS
+
+  providerKey = layerElement.namedItem( QStringLiteral( "provider" ) ).toElement().text();
+  const QString dataSource = context.pathResolver().readPath( layerElement.namedItem( QStringLiteral( "datasource" ) ).toElement().text() );
+  return decodedSource( dataSource, providerKey, context );
+}
+
+QgsDataProvider *QgsMapLayer::takePreloadedProvider( const QString &providerKey, const QString &dataSource )
+{
+  QGIS_PROTECT_QOBJECT_THREAD_ACCESS
+
+  std::unique_ptr< QgsDataProvider > provider = std::move( mPreloadedProvider );
+  if ( !provider || providerKey != mPreloadedProviderKey || dataSource != mPreloadedDataSource )
+    return nullptr;
+
+  return provider.release();
+}
+
 void QgsMapLayer::resolveReferences( QgsProject *project )
 {
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS
@@ -634,6 +634,7 @@ class CORE_EXPORT QgsMapLayer : public QObject
       FlagTrustLayerMetadata = 1 << 1, //!< Trust layer metadata. Improves layer load time by skipping expensive checks like primary key unicity, geometry type and srid and by using estimated metadata on layer load. Since QGIS 3.16
       FlagReadExtentFromXml = 1 << 2, //!< Read extent from xml and skip get extent from provider.
       FlagForceReadOnly = 1 << 3, //!< Force open as read only.
+      FlagDeferProviderCreation = 1 << 4, //!< Create the data provider only when the layer is first used, using the layer metadata from xml until then. Only supported by vector layers (since QGIS 3.30)
     };
     Q_DECLARE_FLAGS( ReadFlags, ReadFlag )
 
@@ -2083,6 +2084,20 @@ class CORE_EXPORT QgsMapLayer : public QObject
     QString generalHtmlMetadata() const;
 #endif
 
+#ifndef SIP_RUN
+
+    /**
+     * Takes the provider created in advance for the layer while its project is read, if it was created
+     * by the \a providerKey provider for the \a dataSource data source. Returns NULLPTR otherwise, in
+     * which case the layer must create its provider itself.
+     *
+     * \note Not available in Python bindings.
+     *
+     * \since QGIS 3.30
+     */
+    QgsDataProvider *takePreloadedProvider( const QString &providerKey, const QString &dataSource );
+#endif
+
   private:
 
     virtual QString baseURI( PropertyType type ) const;
@@ -2179,6 +2194,18 @@ class CORE_EXPORT QgsMapLayer : public QObject
     //! Maptip template
     QString mMapTipTemplate;
 
+    /**
+     * Returns the data source of the layer stored in \a layerElement, resolved as by readLayerXml(),
+     * and sets \a providerKey to the key of its provider.
+     */
+    QString dataSourceFromXml( const QDomElement &layerElement, const QgsReadWriteContext &context, QString &providerKey ) const;
+
+    //! Provider created in advance by QgsProject, see takePreloadedProvider()
+    std::unique_ptr< QgsDataProvider > mPreloadedProvider;
+    QString mPreloadedProviderKey;
+    QString mPreloadedDataSource;
+
+    friend class QgsProject;
     friend class QgsVectorLayer;
     friend class TestQgsMapLayer;
 };
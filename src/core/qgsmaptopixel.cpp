@@ -20,6 +20,7 @@
 #include <QTextStream>
 #include <QVector>
 #include <QTransform>
+#include <QPolygonF>
 
 #include "qgslogger.h"
 #include "qgspointxy.h"
@@ -187,6 +188,85 @@ QString QgsMapToPixel::showParameters() const
   return rep;
 }
 
+void QgsMapToPixel::transformCoords( int count, double *x, double *y ) const
+{
+  if ( mMatrix.type() == QTransform::TxProject )
+  {
+    for ( int i = 0; i < count; ++i )
+      transformInPlace( x[i], y[i] );
+    return;
+  }
+
+  // keep the coefficients in locals, so that the loops do not alias the matrix and can be vectorized
+  const double m11 = mMatrix.m11();
+  const double m12 = mMatrix.m12();
+  const double m21 = mMatrix.m21();
+  const double m22 = mMatrix.m22();
+  const double dx = mMatrix.dx();
+  const double dy = mMatrix.dy();
+
+  if ( m12 == 0 && m21 == 0 )
+  {
+    // no rotation, same operations as QTransform::map() for scaling matrices
+    for ( int i = 0; i < count; ++i )
+    {
+      x[i] = m11 * x[i] + dx;
+      y[i] = m22 * y[i] + dy;
+    }
+  }
+  else
+  {
+    for ( int i = 0; i < count; ++i )
+    {
+      const double mapX = x[i];
+      const double mapY = y[i];
+      x[i] = m11 * mapX + m21 * mapY + dx;
+      y[i] = m12 * mapX + m22 * mapY + dy;
+    }
+  }
+}
+
+void QgsMapToPixel::transformPolygon( QPolygonF &polygon ) const
+{
+  const int count = polygon.size();
+  if ( mMatrix.type() == QTransform::TxProject )
+  {
+    QPointF *ptr = polygon.data();
+    for ( int i = 0; i < count; ++i, ++ptr )
+      transformInPlace( ptr->rx(), ptr->ry() );
+    return;
+  }
+
+  const double m11 = mMatrix.m11();
+  const double m12 = mMatrix.m12();
+  const double m21 = mMatrix.m21();
+  const double m22 = mMatrix.m22();
+  const double dx = mMatrix.dx();
+  const double dy = mMatrix.dy();
+
+  // QPointF stores its coordinates as two consecutive qreal values
+  static_assert( sizeof( QPointF ) == 2 * sizeof( double ), "QPointF must be made of two doubles" );
+  double *coords = reinterpret_cast< double * >( polygon.data() );
+  if ( m12 == 0 && m21 == 0 )
+  {
+    for ( int i = 0; i < count; ++i )
+    {
+      coords[2 * i] = m11 * coords[2 * i] + dx;
+      coords[2 * i + 1] = m22 * coords[2 * i + 1] + dy;
+    }
+  }
+  else
+  {
+    for ( int i = 0; i < count; ++i )
+    {
+      const double mapX = coords[2 * i];
+      const double mapY = coords[2 * i + 1];
+      coords[2 * i] = m11 * mapX + m21 * mapY + dx;
+      coords[2 * i + 1] = m12 * mapX + m22 * mapY + dy;
+    }
+  }
+}
+
 QTransform QgsMapToPixel::transform() const
 {
   // NOTE: operations are done in the reverse order in which
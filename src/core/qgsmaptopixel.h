@@ -28,6 +28,7 @@
 #include <memory>
 
 class QPoint;
+class QPolygonF;
 
 /**
  * \ingroup core
@@ -165,8 +166,41 @@ class CORE_EXPORT QgsMapToPixel
       for ( int i = 0; i < x.size(); ++i )
         transformInPlace( x[i], y[i] );
     }
+
+    /**
+     * Transforms device coordinates to map coordinates.
+     *
+     * This method modifies the given coordinates in place.
+     * \note not available in Python bindings
+     */
+    void transformInPlace( QVector<double> &x, QVector<double> &y ) const SIP_SKIP
+    {
+      assert( x.size() == y.size() );
+      transformCoords( x.size(), x.data(), y.data() );
+    }
 #endif
 
+    /**
+     * Transforms an array of \a count coordinates, stored in the \a x and \a y arrays,
+     * from map (world) coordinates to device coordinates in place.
+     *
+     * This is considerably faster than calling transformInPlace() for each point, as
+     * the affine matrix is applied in a single loop which the compiler can vectorize.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    void transformCoords( int count, double *x, double *y ) const SIP_SKIP;
+
+    /**
+     * Transforms all the points of a \a polygon from map (world) coordinates to device
+     * coordinates in place.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    void transformPolygon( QPolygonF &polygon ) const SIP_SKIP;
+
     /**
      * Transforms device coordinates to map (world) coordinates.
      */
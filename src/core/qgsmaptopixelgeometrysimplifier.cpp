@@ -26,7 +26,9 @@
 #include "qgslinestring.h"
 #include "qgspolygon.h"
 #include "qgsgeometrycollection.h"
+#include "qgsgeometryfactory.h"
 #include "qgsvertexid.h"
+#include "qgswkbgeometryview.h"
 
 QgsMapToPixelSimplifier::QgsMapToPixelSimplifier( int simplifyFlags, double tolerance, SimplifyAlgorithm simplifyAlgorithm )
   : mSimplifyFlags( simplifyFlags )
@@ -66,25 +68,21 @@ bool QgsMapToPixelSimplifier::equalSnapToGrid( double x1, double y1, double x2,
 
 #include "simplify/effectivearea.h"
 
+//! Returns the effective areas buffers of the current thread, reused between geometries
+static EFFECTIVE_AREAS &effectiveAreas()
+{
+  static thread_local EFFECTIVE_AREAS sEffectiveAreas;
+  return sEffectiveAreas;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 
-//! Generalize the WKB-geometry using the BBOX of the original geometry
-static std::unique_ptr< QgsAbstractGeometry > generalizeWkbGeometryByBoundingBox(
-  QgsWkbTypes::Type wkbType,
-  const QgsAbstractGeometry &geometry,
+//! Returns the geometry of type \a geometryType approximating a geometry by its \a envelope
+static std::unique_ptr< QgsAbstractGeometry > boundingBoxGeometry(
+  unsigned int geometryType,
   const QgsRectangle &envelope,
   bool isRing )
 {
-  const unsigned int geometryType = QgsWkbTypes::singleType( QgsWkbTypes::flatType( wkbType ) );
-
-  // If the geometry is already minimal skip the generalization
-  const int minimumSize = geometryType == QgsWkbTypes::LineString ? 2 : 5;
-
-  if ( geometry.nCoordinates() <= minimumSize )
-  {
-    return std::unique_ptr< QgsAbstractGeometry >( geometry.clone() );
-  }
-
   const double x1 = envelope.xMinimum();
   const double y1 = envelope.yMinimum();
   const double x2 = envelope.xMaximum();
@@ -119,6 +117,26 @@ static std::unique_ptr< QgsAbstractGeometry > generalizeWkbGeometryByBoundingBox
   }
 }
 
+//! Generalize the WKB-geometry using the BBOX of the original geometry
+static std::unique_ptr< QgsAbstractGeometry > generalizeWkbGeometryByBoundingBox(
+  QgsWkbTypes::Type wkbType,
+  const QgsAbstractGeometry &geometry,
+  const QgsRectangle &envelope,
+  bool isRing )
+{
+  const unsigned int geometryType = QgsWkbTypes::singleType( QgsWkbTypes::flatType( wkbType ) );
+
+  // If the geometry is already minimal skip the generalization
+  const int minimumSize = geometryType == QgsWkbTypes::LineString ? 2 : 5;
+
+  if ( geometry.nCoordinates() <= minimumSize )
+  {
+    return std::unique_ptr< QgsAbstractGeometry >( geometry.clone() );
+  }
+
+  return boundingBoxGeometry( geometryType, envelope, isRing );
+}
+
 std::unique_ptr< QgsAbstractGeometry > QgsMapToPixelSimplifier::simplifyGeometry( int simplifyFlags,
     SimplifyAlgorithm simplifyAlgorithm,
     const QgsAbstractGeometry &geometry, double map2pixelTol,
@@ -238,21 +256,28 @@ std::unique_ptr< QgsAbstractGeometry > QgsMapToPixelSimplifier::simplifyGeometry
       {
         map2pixelTol *= map2pixelTol; //-> Use mappixelTol for 'Area' calculations.
 
-        EFFECTIVE_AREAS ea( srcCurve );
+        EFFECTIVE_AREAS &ea = effectiveAreas();
+        ea.setPoints( srcCurve );
 
         const int set_area = 0;
         ptarray_calc_areas( &ea, isaLinearRing ? 4 : 2, set_area, map2pixelTol );
 
+        const double *resArea = ea.res_arealist.data();
         for ( int i = 0; i < numPoints; ++i )
         {
-          if ( ea.res_arealist[ i ] > map2pixelTol )
+          if ( resArea[ i ] > map2pixelTol )
           {
             if ( output )
-              output->insertVertex( QgsVertexId( 0, 0, output->numPoints() ), ea.inpts.at( i ) );
+            {
+              QgsPoint point;
+              Qgis::VertexType type;
+              srcCurve.pointAt( i, point, type );
+              output->insertVertex( QgsVertexId( 0, 0, output->numPoints() ), point );
+            }
             else
             {
-              lineStringX.append( ea.inpts.at( i ).x() );
-              lineStringY.append( ea.inpts.at( i ).y() );
+              lineStringX.append( ea.xData[i] );
+              lineStringY.append( ea.yData[i] );
             }
           }
         }
@@ -371,6 +396,341 @@ std::unique_ptr< QgsAbstractGeometry > QgsMapToPixelSimplifier::simplifyGeometry
   return std::unique_ptr< QgsAbstractGeometry >( geometry.clone() );
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+// Simplification of geometries read from their WKB
+
+//! Reads the points of a linestring or a ring from \a wkbPtr, returning their bounding box
+static QgsRectangle readWkbPoints( const QgsConstWkbPtr &wkbPtr, int dimensions, QVector< double > &x, QVector< double > &y )
+{
+  int numPoints = 0;
+  wkbPtr >> numPoints;
+  x.resize( numPoints );
+  y.resize( numPoints );
+
+  const int skipZM = ( dimensions - 2 ) * static_cast< int >( sizeof( double ) );
+  double xMin = std::numeric_limits< double >::max();
+  double yMin = std::numeric_limits< double >::max();
+  double xMax = std::numeric_limits< double >::lowest();
+  double yMax = std::numeric_limits< double >::lowest();
+  double *xOut = x.data();
+  double *yOut = y.data();
+  for ( int i = 0; i < numPoints; ++i )
+  {
+    wkbPtr >> *xOut >> *yOut;
+    wkbPtr += skipZM;
+    xMin = std::min( xMin, *xOut );
+    yMin = std::min( yMin, *yOut );
+    xMax = std::max( xMax, *xOut++ );
+    yMax = std::max( yMax, *yOut++ );
+  }
+  return numPoints > 0 ? QgsRectangle( xMin, yMin, xMax, yMax, false ) : QgsRectangle();
+}
+
+std::unique_ptr< QgsLineString > QgsMapToPixelSimplifier::simplifyWkbPoints( int simplifyFlags,
+    SimplifyAlgorithm simplifyAlgorithm,
+    const QVector< double > &x, const QVector< double > &y,
+    const QgsRectangle &envelope, double map2pixelTol,
+    bool isaLinearRing )
+{
+  const int numPoints = x.size();
+
+  // Can replace the points by their BBOX ?
+  if ( ( simplifyFlags & QgsMapToPixelSimplifier::SimplifyEnvelope ) &&
+       isGeneralizableByMapBoundingBox( envelope, map2pixelTol ) )
+  {
+    if ( numPoints <= 2 )
+      return nullptr;
+    return std::unique_ptr< QgsLineString >( qgsgeometry_cast< QgsLineString * >( boundingBoxGeometry( QgsWkbTypes::LineString, envelope, isaLinearRing ).release() ) );
+  }
+
+  bool isGeneralizable = simplifyFlags & QgsMapToPixelSimplifier::SimplifyGeometry;
+  if ( numPoints <= ( isaLinearRing ? 4 : 2 ) )
+    isGeneralizable = false;
+  if ( numPoints == 0 )
+    return nullptr;
+
+  const double *xData = x.constData();
+  const double *yData = y.constData();
+
+  // Check whether the LinearRing is really closed.
+  if ( isaLinearRing )
+  {
+    isaLinearRing = qgsDoubleNear( xData[0], xData[numPoints - 1] ) &&
+                    qgsDoubleNear( yData[0], yData[numPoints - 1] );
+  }
+
+  QVector< double > lineStringX;
+  QVector< double > lineStringY;
+  lineStringX.reserve( numPoints );
+  lineStringY.reserve( numPoints );
+
+  double lastX = 0.0, lastY = 0.0;
+  bool isLongSegment;
+  bool hasLongSegments = false; //-> To avoid replace the simplified geometry by its BBOX when there are 'long' segments.
+
+  switch ( simplifyAlgorithm )
+  {
+    case SnapToGrid:
+    {
+      const double gridOriginX = envelope.xMinimum();
+      const double gridOriginY = envelope.yMinimum();
+
+      // Use a factor for the maximum displacement distance for simplification, similar as GeoServer does
+      const float gridInverseSizeXY = map2pixelTol != 0 ? ( float )( 1.0f / ( 0.8 * map2pixelTol ) ) : 0.0f;
+
+      for ( int i = 0; i < numPoints; ++i )
+      {
+        const double px = xData[i];
+        const double py = yData[i];
+        if ( i == 0 ||
+             !isGeneralizable ||
+             !equalSnapToGrid( px, py, lastX, lastY, gridOriginX, gridOriginY, gridInverseSizeXY ) ||
+             ( !isaLinearRing && ( i == 1 || i >= numPoints - 2 ) ) )
+        {
+          lineStringX.append( px );
+          lineStringY.append( py );
+          lastX = px;
+          lastY = py;
+        }
+      }
+      break;
+    }
+
+    case Distance:
+    {
+      map2pixelTol *= map2pixelTol; //-> Use mappixelTol for 'LengthSquare' calculations.
+
+      for ( int i = 0; i < numPoints; ++i )
+      {
+        const double px = xData[i];
+        const double py = yData[i];
+
+        isLongSegment = false;
+
+        if ( i == 0 ||
+             !isGeneralizable ||
+             ( isLongSegment = ( calculateLengthSquared2D( px, py, lastX, lastY ) > map2pixelTol ) ) ||
+             ( !isaLinearRing && ( i == 1 || i >= numPoints - 2 ) ) )
+        {
+          lineStringX.append( px );
+          lineStringY.append( py );
+          lastX = px;
+          lastY = py;
+
+          hasLongSegments |= isLongSegment;
+        }
+      }
+      break;
+    }
+
+    case Visvalingam:
+    {
+      map2pixelTol *= map2pixelTol; //-> Use mappixelTol for 'Area' calculations.
+
+      EFFECTIVE_AREAS &ea = effectiveAreas();
+      ea.setPoints( numPoints, xData, yData );
+
+      const int set_area = 0;
+      ptarray_calc_areas( &ea, isaLinearRing ? 4 : 2, set_area, map2pixelTol );
+
+      const double *resArea = ea.res_arealist.data();
+      for ( int i = 0; i < numPoints; ++i )
+      {
+        if ( resArea[i] > map2pixelTol )
+        {
+          lineStringX.append( xData[i] );
+          lineStringY.append( yData[i] );
+        }
+      }
+      break;
+    }
+
+    case SnappedToGridGlobal:
+      return nullptr;
+  }
+
+  if ( lineStringX.size() < ( isaLinearRing ? 4 : 2 ) )
+  {
+    // we simplified the geometry too much!
+    if ( !hasLongSegments && numPoints > 2 )
+    {
+      // approximate the geometry's shape by its bounding box
+      // (rect for linear ring / one segment for line string)
+      return std::unique_ptr< QgsLineString >( qgsgeometry_cast< QgsLineString * >( boundingBoxGeometry( QgsWkbTypes::LineString, envelope, isaLinearRing ).release() ) );
+    }
+    else
+    {
+      // keep the original geometry
+      return nullptr;
+    }
+  }
+
+  if ( isaLinearRing )
+  {
+    // make sure we keep the linear ring closed
+    if ( !qgsDoubleNear( lastX, lineStringX.at( 0 ) ) || !qgsDoubleNear( lastY, lineStringY.at( 0 ) ) )
+    {
+      lineStringX.append( lineStringX.at( 0 ) );
+      lineStringY.append( lineStringY.at( 0 ) );
+    }
+  }
+
+  return std::make_unique< QgsLineString >( lineStringX, lineStringY );
+}
+
+std::unique_ptr< QgsAbstractGeometry > QgsMapToPixelSimplifier::simplifyWkbGeometry( int simplifyFlags,
+    SimplifyAlgorithm simplifyAlgorithm,
+    const QgsConstWkbPtr &wkbPtr, double map2pixelTol,
+    QVector< double > &x, QVector< double > &y )
+{
+  const QgsWkbTypes::Type wkbType = wkbPtr.readHeader();
+  const int dimensions = QgsWkbTypes::coordDimensions( wkbType );
+
+  switch ( QgsWkbTypes::flatType( wkbType ) )
+  {
+    case QgsWkbTypes::LineString:
+    {
+      const QgsRectangle envelope = readWkbPoints( wkbPtr, dimensions, x, y );
+      return simplifyWkbPoints( simplifyFlags, simplifyAlgorithm, x, y, envelope, map2pixelTol, false );
+    }
+
+    case QgsWkbTypes::Polygon:
+    {
+      int numRings = 0;
+      wkbPtr >> numRings;
+      if ( numRings == 0 )
+        return nullptr;
+
+      // the envelope of a polygon is the one of its exterior ring
+      const QgsRectangle envelope = readWkbPoints( wkbPtr, dimensions, x, y );
+      if ( ( simplifyFlags & QgsMapToPixelSimplifier::SimplifyEnvelope ) &&
+           isGeneralizableByMapBoundingBox( envelope, map2pixelTol ) )
+      {
+        int numPoints = x.size();
+        for ( int i = 1; i < numRings; ++i )
+        {
+          int ringPoints = 0;
+          wkbPtr >> ringPoints;
+          wkbPtr += ringPoints * dimensions * static_cast< int >( sizeof( double ) );
+          numPoints += ringPoints;
+        }
+        if ( numPoints <= 5 )
+          return nullptr;
+        return boundingBoxGeometry( QgsWkbTypes::Polygon, envelope, false );
+      }
+
+      std::unique_ptr< QgsLineString > extRing = simplifyWkbPoints( simplifyFlags, simplifyAlgorithm, x, y, envelope, map2pixelTol, true );
+      if ( !extRing )
+        return nullptr;
+
+      std::unique_ptr< QgsPolygon > polygon = std::make_unique< QgsPolygon >();
+      polygon->setExteriorRing( extRing.release() );
+      for ( int i = 1; i < numRings; ++i )
+      {
+        const QgsRectangle ringEnvelope = readWkbPoints( wkbPtr, dimensions, x, y );
+        std::unique_ptr< QgsLineString > ring = simplifyWkbPoints( simplifyFlags, simplifyAlgorithm, x, y, ringEnvelope, map2pixelTol, true );
+        if ( !ring )
+          return nullptr;
+        polygon->addInteriorRing( ring.release() );
+      }
+      return std::move( polygon );
+    }
+
+    default:
+      return nullptr;
+  }
+}
+
+QgsGeometry QgsMapToPixelSimplifier::simplify( const QgsWkbGeometryView &geometry ) const
+{
+  if ( geometry.wkb().isEmpty() )
+  {
+    return QgsGeometry();
+  }
+  if ( mSimplifyFlags == QgsMapToPixelSimplifier::NoFlags )
+  {
+    return geometry.geometry();
+  }
+
+  // only the linear geometries simplified with the Distance, SnapToGrid or Visvalingam algorithms are read directly,
+  // the effective areas of the Visvalingam algorithm being computed in 2d
+  const QgsWkbTypes::Type wkbType = geometry.wkbType();
+  const QgsWkbTypes::Type flatType = QgsWkbTypes::flatType( wkbType );
+  if ( !geometry.isDirectlyReadable() ||
+       mSimplifyAlgorithm == SnappedToGridGlobal ||
+       ( mSimplifyAlgorithm == Visvalingam && QgsWkbTypes::hasZ( wkbType ) ) ||
+       ( flatType != QgsWkbTypes::LineString && flatType != QgsWkbTypes::Polygon &&
+         flatType != QgsWkbTypes::MultiLineString && flatType != QgsWkbTypes::MultiPolygon ) )
+  {
+    return simplify( geometry.geometry() );
+  }
+
+  const bool isaLinearRing = QgsWkbTypes::singleType( flatType ) == QgsWkbTypes::Polygon;
+  const int numPoints = geometry.vertexCount();
+
+  if ( numPoints <= ( isaLinearRing ? 6 : 3 ) )
+  {
+    // No simplify simple geometries
+    return geometry.geometry();
+  }
+
+  const QgsRectangle envelope = geometry.boundingBox();
+  if ( std::max( envelope.width(), envelope.height() ) / numPoints > mTolerance * 2.0 )
+  {
+    //points are in average too far apart to lead to any significant simplification
+    return geometry.geometry();
+  }
+
+  // the coordinates buffers are reused between geometries, avoiding allocations for each feature
+  static thread_local QVector< double > x;
+  static thread_local QVector< double > y;
+
+  std::unique_ptr< QgsAbstractGeometry > simplified;
+  try
+  {
+    const QgsConstWkbPtr wkbPtr( geometry.wkb() );
+    if ( QgsWkbTypes::isMultiType( flatType ) )
+    {
+      if ( ( mSimplifyFlags & QgsMapToPixelSimplifier::SimplifyEnvelope ) &&
+           isGeneralizableByMapBoundingBox( envelope, mTolerance ) )
+      {
+        // minimal geometries were already excluded above
+        return QgsGeometry( boundingBoxGeometry( QgsWkbTypes::singleType( flatType ), envelope, false ) );
+      }
+
+      wkbPtr.readHeader();
+      int numGeoms = 0;
+      wkbPtr >> numGeoms;
+      std::unique_ptr< QgsGeometryCollection > collection( qgsgeometry_cast< QgsGeometryCollection * >( QgsGeometryFactory::geomFromWkbType( wkbType ).release() ) );
+      collection->reserve( numGeoms );
+      for ( int i = 0; i < numGeoms; ++i )
+      {
+        std::unique_ptr< QgsAbstractGeometry > part = simplifyWkbGeometry( mSimplifyFlags, mSimplifyAlgorithm, wkbPtr, mTolerance, x, y );
+        if ( !part )
+          return simplify( geometry.geometry() );
+        collection->addGeometry( part.release() );
+      }
+      simplified = std::move( collection );
+    }
+    else
+    {
+      simplified = simplifyWkbGeometry( mSimplifyFlags, mSimplifyAlgorithm, wkbPtr, mTolerance, x, y );
+    }
+  }
+  catch ( const QgsWkbException &e )
+  {
+    Q_UNUSED( e )
+    QgsDebugMsg( "WKB exception while simplifying geometry: " + e.what() );
+    simplified.reset();
+  }
+
+  // the parts which cannot be simplified from the WKB keep their original geometry
+  if ( !simplified )
+    return simplify( geometry.geometry() );
+
+  return QgsGeometry( std::move( simplified ) );
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 
 bool QgsMapToPixelSimplifier::isGeneralizableByMapBoundingBox( const QgsRectangle &envelope, double map2pixelTol )
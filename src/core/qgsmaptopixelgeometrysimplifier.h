@@ -26,6 +26,8 @@
 class QgsAbstractGeometry;
 class QgsWkbPtr;
 class QgsConstWkbPtr;
+class QgsWkbGeometryView;
+class QgsLineString;
 
 
 /**
@@ -62,6 +64,15 @@ class CORE_EXPORT QgsMapToPixelSimplifier : public QgsAbstractGeometrySimplifier
     //! Simplify the geometry using the specified tolerance
     static std::unique_ptr<QgsAbstractGeometry> simplifyGeometry( int simplifyFlags, SimplifyAlgorithm simplifyAlgorithm, const QgsAbstractGeometry &geometry, double map2pixelTol, bool isaLinearRing );
 
+    /**
+     * Simplify the linestring or polygon read from \a wkbPtr using the specified tolerance, with the same result as simplifyGeometry().
+     * Returns nullptr if the geometry must be created to be simplified.
+     */
+    static std::unique_ptr<QgsAbstractGeometry> simplifyWkbGeometry( int simplifyFlags, SimplifyAlgorithm simplifyAlgorithm, const QgsConstWkbPtr &wkbPtr, double map2pixelTol, QVector< double > &x, QVector< double > &y );
+
+    //! Simplify the points read from a linestring or a ring, or returns nullptr if the original points must be kept
+    static std::unique_ptr<QgsLineString> simplifyWkbPoints( int simplifyFlags, SimplifyAlgorithm simplifyAlgorithm, const QVector< double > &x, const QVector< double > &y, const QgsRectangle &envelope, double map2pixelTol, bool isaLinearRing );
+
   protected:
     //! Current simplification flags
     int mSimplifyFlags;
@@ -92,6 +103,17 @@ class CORE_EXPORT QgsMapToPixelSimplifier : public QgsAbstractGeometrySimplifier
     QgsGeometry simplify( const QgsGeometry &geometry ) const override;
     QgsAbstractGeometry *simplify( const QgsAbstractGeometry *geometry ) const override SIP_FACTORY;
 
+    /**
+     * Simplifies the geometry stored as WKB in \a geometry.
+     *
+     * Linestrings, polygons and their multi types are simplified directly from their WKB with the Distance and SnapToGrid
+     * algorithms, without creating the geometry objects of the original geometry.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    QgsGeometry simplify( const QgsWkbGeometryView &geometry ) const SIP_SKIP;
+
     //! Sets the tolerance of the vector layer managed
     void setTolerance( double value ) { mTolerance = value; }
 
@@ -204,3 +204,37 @@ void QgsMbTiles::setTileData( int z, int x, int y, const QByteArray &data ) cons
     return;
   }
 }
+
+bool QgsMbTiles::beginTransaction() const
+{
+  if ( !mDatabase )
+  {
+    QgsDebugMsg( QStringLiteral( "MBTiles database not open: " ) + mFilename );
+    return false;
+  }
+
+  QString errorMessage;
+  if ( mDatabase.exec( QStringLiteral( "BEGIN" ), errorMessage ) != SQLITE_OK )
+  {
+    QgsDebugMsg( QStringLiteral( "MBTile failed to begin transaction: " ) + errorMessage );
+    return false;
+  }
+  return true;
+}
+
+bool QgsMbTiles::commitTransaction() const
+{
+  if ( !mDatabase )
+  {
+    QgsDebugMsg( QStringLiteral( "MBTiles database not open: " ) + mFilename );
+    return false;
+  }
+
+  QString errorMessage;
+  if ( mDatabase.exec( QStringLiteral( "COMMIT" ), errorMessage ) != SQLITE_OK )
+  {
+    QgsDebugMsg( QStringLiteral( "MBTile failed to commit transaction: " ) + errorMessage );
+    return false;
+  }
+  return true;
+}
@@ -78,6 +78,23 @@ class CORE_EXPORT QgsMbTiles
      */
     void setTileData( int z, int x, int y, const QByteArray &data ) const;
 
+    /**
+     * Starts a transaction, so that the tiles added with setTileData() are written to the file
+     * at once when the transaction is committed, which is much faster than writing them one by one.
+     * \returns TRUE on success
+     * \see commitTransaction()
+     * \since QGIS 3.30
+     */
+    bool beginTransaction() const;
+
+    /**
+     * Commits the transaction started with beginTransaction().
+     * \returns TRUE on success
+     * \see beginTransaction()
+     * \since QGIS 3.30
+     */
+    bool commitTransaction() const;
+
   private:
     QString mFilename;
     sqlite3_database_unique_ptr mDatabase;
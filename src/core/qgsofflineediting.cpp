@@ -789,8 +789,11 @@ void QgsOfflineEditing::convertToOfflineLayer( QgsVectorLayer *layer, sqlite3 *d
   if ( newLayer && newLayer->isValid() )
   {
 
-    // copy features
-    newLayer->startEditing();
+    // copy features, directly to the provider as the edit buffer and its undo stack are not needed for a new layer
+    QgsVectorDataProvider *newProvider = newLayer->dataProvider();
+    const QgsFields newFields = newProvider->fields();
+    const QgsFields fields = layer->fields();
+    QgsFeatureList newFeatures;
     QgsFeature f;
 
     QgsFeatureRequest req;
@@ -831,20 +834,26 @@ void QgsOfflineEditing::convertToOfflineLayer( QgsVectorLayer *layer, sqlite3 *d
       for ( int it = 0; it < attrs.count(); ++it )
       {
         QVariant attr = attrs.at( it );
-        if ( layer->fields().at( it ).type() == QVariant::StringList || layer->fields().at( it ).type() == QVariant::List )
+        if ( fields.at( it ).type() == QVariant::StringList || fields.at( it ).type() == QVariant::List )
         {
           attr = QgsJsonUtils::encodeValue( attr );
         }
         newAttrs[column++] = attr;
       }
       f.setAttributes( newAttrs );
-
-      newLayer->addFeature( f );
+      // like the edit buffer does when committing added features
+      QgsVectorLayerUtils::matchAttributesToFields( f, newFields );
+      newFeatures << f;
 
       emit progressUpdated( featureCount++ );
     }
-    if ( newLayer->commitChanges() )
+
+    // all the features are added in a single call, which the providers run in a single transaction
+    if ( newProvider->addFeatures( newFeatures, QgsFeatureSink::RollBackOnErrors ) )
     {
+      newFeatures.clear();
+      newLayer->updateExtents();
+
       emit progressModeSet( QgsOfflineEditing::ProcessFeatures, layer->dataProvider()->featureCount() );
       featureCount = 1;
 
@@ -879,7 +888,7 @@ void QgsOfflineEditing::convertToOfflineLayer( QgsVectorLayer *layer, sqlite3 *d
     }
     else
     {
-      showWarning( newLayer->commitErrors().join( QLatin1Char( '\n' ) ) );
+      showWarning( newProvider->errors().join( QLatin1Char( '\n' ) ) );
     }
 
     // mark as offline layer
@@ -985,7 +985,8 @@ bool QgsPointLocator::init( int maxFeaturesToIndex, bool relaxed )
     mInitTask = new QgsPointLocatorInitTask( this );
     connect( mInitTask, &QgsPointLocatorInitTask::taskTerminated, this, &QgsPointLocator::onInitTaskFinished );
     connect( mInitTask, &QgsPointLocatorInitTask::taskCompleted, this, &QgsPointLocator::onInitTaskFinished );
-    QgsApplication::taskManager()->addTask( mInitTask );
+    // snapping waits on the index, so it is queued ahead of background tasks like exports
+    QgsApplication::taskManager()->addTask( mInitTask, 100 );
     return true;
   }
   else
@@ -1214,7 +1215,8 @@ void QgsPointLocator::onFeatureAdded( QgsFeatureId fid )
       std::unique_ptr< QgsFeatureRenderer > renderer( mLayer->renderer() ? mLayer->renderer()->clone() : nullptr );
       QgsRenderContext *ctx = nullptr;
 
-      mContext->expressionContext() << QgsExpressionContextUtils::layerScope( mLayer );
+      // the layer scope is removed afterwards, the context would otherwise grow with each added feature
+      QgsExpressionContextScopePopper popper( mContext->expressionContext(), QgsExpressionContextUtils::layerScope( mLayer ) );
       ctx = mContext.get();
       if ( renderer && ctx )
       {
@@ -1233,39 +1235,42 @@ void QgsPointLocator::onFeatureAdded( QgsFeatureId fid )
       }
     }
 
-    if ( mTransform.isValid() )
+    indexGeometry( fid, f.geometry() );
+  }
+}
+
+void QgsPointLocator::indexGeometry( QgsFeatureId fid, QgsGeometry geometry )
+{
+  if ( mTransform.isValid() )
+  {
+    try
     {
-      try
-      {
-        QgsGeometry transformedGeom = f.geometry();
-        transformedGeom.transform( mTransform );
-        f.setGeometry( transformedGeom );
-      }
-      catch ( const QgsException &e )
-      {
-        Q_UNUSED( e )
-        // See https://github.com/qgis/QGIS/issues/20749
-        QgsDebugMsg( QStringLiteral( "could not transform geometry to map, skipping the snap for it (%1)" ).arg( e.what() ) );
-        return;
-      }
+      geometry.transform( mTransform );
     }
-
-    const QgsRectangle bbox = f.geometry().boundingBox();
-    if ( bbox.isFinite() )
+    catch ( const QgsException &e )
     {
-      const SpatialIndex::Region r( rect2region( bbox ) );
-      mRTree->insertData( 0, nullptr, r, f.id() );
+      Q_UNUSED( e )
+      // See https://github.com/qgis/QGIS/issues/20749
+      QgsDebugMsg( QStringLiteral( "could not transform geometry to map, skipping the snap for it (%1)" ).arg( e.what() ) );
+      return;
+    }
+  }
 
-      auto it = mGeoms.find( f.id() );
-      if ( it != mGeoms.end() )
-      {
-        delete *it;
-        *it = new QgsGeometry( f.geometry() );
-      }
-      else
-      {
-        mGeoms[fid] = new QgsGeometry( f.geometry() );
-      }
+  const QgsRectangle bbox = geometry.boundingBox();
+  if ( bbox.isFinite() )
+  {
+    const SpatialIndex::Region r( rect2region( bbox ) );
+    mRTree->insertData( 0, nullptr, r, fid );
+
+    auto it = mGeoms.find( fid );
+    if ( it != mGeoms.end() )
+    {
+      delete *it;
+      *it = new QgsGeometry( geometry );
+    }
+    else
+    {
+      mGeoms[fid] = new QgsGeometry( geometry );
     }
   }
 }
@@ -1301,9 +1306,19 @@ void QgsPointLocator::onFeatureDeleted( QgsFeatureId fid )
 
 void QgsPointLocator::onGeometryChanged( QgsFeatureId fid, const QgsGeometry &geom )
 {
-  Q_UNUSED( geom )
+  if ( mIsIndexing || !mRTree || mContext )
+  {
+    // the feature has to be fetched again, e.g. to check whether it is still rendered
+    onFeatureDeleted( fid );
+    onFeatureAdded( fid );
+    return;
+  }
+
+  // the index is updated from the changed geometry directly, without fetching the feature from the layer,
+  // as this happens for each vertex edit
   onFeatureDeleted( fid );
-  onFeatureAdded( fid );
+  if ( !geom.isNull() )
+    indexGeometry( fid, geom );
 }
 
 void QgsPointLocator::onAttributeValueChanged( QgsFeatureId fid, int idx, const QVariant &value )
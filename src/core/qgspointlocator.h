@@ -490,6 +490,12 @@ class CORE_EXPORT QgsPointLocator : public QObject
      */
     bool prepare( bool relaxed );
 
+    /**
+     * Transforms the \a geometry of the feature with the given \a fid to the destination CRS and
+     * inserts it in the index.
+     */
+    void indexGeometry( QgsFeatureId fid, QgsGeometry geometry );
+
     //! Storage manager
     std::unique_ptr< SpatialIndex::IStorageManager > mStorage;
 
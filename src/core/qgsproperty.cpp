@@ -432,6 +432,8 @@ bool QgsProperty::prepare( const QgsExpressionContext &context ) const
     case FieldBasedProperty:
     {
       d.detach();
+      d->evaluationCache.reset();
+      d->evaluationCacheSlot = -1;
       // cache field index to avoid subsequent lookups
       const QgsFields f = context.fields();
       d->cachedFieldIdx = f.lookupField( d->fieldName );
@@ -441,6 +443,8 @@ bool QgsProperty::prepare( const QgsExpressionContext &context ) const
     case ExpressionBasedProperty:
     {
       d.detach();
+      d->evaluationCache.reset();
+      d->evaluationCacheSlot = -1;
       if ( !d->expression.prepare( &context ) )
       {
         d->expressionReferencedCols.clear();
@@ -463,6 +467,21 @@ bool QgsProperty::prepare( const QgsExpressionContext &context ) const
   return false;
 }
 
+bool QgsProperty::prepare( const QgsExpressionContext &context, const std::shared_ptr< QgsPropertyEvaluationCache > &cache ) const
+{
+  if ( !prepare( context ) )
+    return false;
+
+  // unresolved fields are looked up again on evaluation, which would prepare the property again
+  if ( cache && d->active && ( ( d->type == FieldBasedProperty && d->cachedFieldIdx >= 0 ) || d->type == ExpressionBasedProperty ) )
+  {
+    d->evaluationCacheSlot = cache->slot( *this, context );
+    if ( d->evaluationCacheSlot >= 0 )
+      d->evaluationCache = cache;
+  }
+  return true;
+}
+
 QSet<QString> QgsProperty::referencedFields( const QgsExpressionContext &context, bool ignoreContext ) const
 {
   if ( !d->active )
@@ -588,7 +607,23 @@ QVariant QgsProperty::value( const QgsExpressionContext &context, const QVariant
     *ok = false;
 
   bool valOk = false;
-  QVariant val = propertyValue( context, defaultValue, &valOk );
+  QVariant val;
+  if ( d->evaluationCache && context.hasFeature() )
+  {
+    // properties with the same source share its value for each feature
+    if ( !d->evaluationCache->value( d->evaluationCacheSlot, context, val, valOk ) )
+    {
+      val = propertyValue( context, QVariant(), &valOk );
+      d->evaluationCache->setValue( d->evaluationCacheSlot, val, valOk );
+    }
+    if ( !valOk )
+      val = defaultValue;
+  }
+  else
+  {
+    val = propertyValue( context, defaultValue, &valOk );
+  }
+
   if ( !d->transformer && !valOk ) // if transformer present, let it handle null values
     return defaultValue;
 
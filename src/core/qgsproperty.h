@@ -27,9 +27,11 @@
 #include <QDomDocument>
 #include <QColor>
 #include <QDateTime>
+#include <memory>
 
 class QgsPropertyTransformer;
 class QgsPropertyPrivate;
+class QgsPropertyEvaluationCache;
 
 /**
  * \ingroup core
@@ -377,6 +379,17 @@ class CORE_EXPORT QgsProperty
      */
     bool prepare( const QgsExpressionContext &context = QgsExpressionContext() ) const;
 
+    /**
+     * Prepares the property against a specified expression context, sharing its source value
+     * with the other properties prepared with the same \a cache for each feature.
+     *
+     * Returns TRUE if preparation was successful.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    bool prepare( const QgsExpressionContext &context, const std::shared_ptr< QgsPropertyEvaluationCache > &cache ) const SIP_SKIP;
+
     /**
      * Returns the set of any fields referenced by the property for a specified
      * expression context.
@@ -33,6 +33,9 @@
 #include <QVariant>
 #include "qgsexpression.h"
 #include "qgspropertytransformer.h"
+#include "qgspropertyevaluationcache.h"
+
+#include <memory>
 
 class QgsPropertyPrivate : public QSharedData
 {
@@ -83,6 +86,10 @@ class QgsPropertyPrivate : public QSharedData
     //! Cached set of referenced columns
     mutable QSet< QString > expressionReferencedCols;
 
+    //! Cache shared with other properties, not copied as the copies are prepared on their own
+    mutable std::shared_ptr< QgsPropertyEvaluationCache > evaluationCache;
+    mutable int evaluationCacheSlot = -1;
+
   private:
     QgsPropertyPrivate &operator=( const QgsPropertyPrivate & ) = delete;
 };
@@ -251,6 +251,20 @@ bool QgsPropertyCollection::prepare( const QgsExpressionContext &context ) const
   return result;
 }
 
+bool QgsPropertyCollection::prepare( const QgsExpressionContext &context, const std::shared_ptr< QgsPropertyEvaluationCache > &cache ) const
+{
+  bool result = true;
+  QHash<int, QgsProperty>::const_iterator it = mProperties.constBegin();
+  for ( ; it != mProperties.constEnd(); ++it )
+  {
+    if ( !it.value().isActive() )
+      continue;
+
+    result = result && it.value().prepare( context, cache );
+  }
+  return result;
+}
+
 QSet< QString > QgsPropertyCollection::referencedFields( const QgsExpressionContext &context, bool ignoreContext ) const
 {
   QSet< QString > cols;
@@ -356,6 +356,17 @@ class CORE_EXPORT QgsPropertyCollection : public QgsAbstractPropertyCollection
 
     QVariant value( int key, const QgsExpressionContext &context, const QVariant &defaultValue = QVariant() ) const override;
     bool prepare( const QgsExpressionContext &context = QgsExpressionContext() ) const override;
+
+    /**
+     * Prepares the collection against a specified expression context, with the source values of its
+     * properties shared through \a cache.
+     *
+     * \see QgsProperty::prepare()
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    bool prepare( const QgsExpressionContext &context, const std::shared_ptr< QgsPropertyEvaluationCache > &cache ) const SIP_SKIP;
+
     QSet< QString > referencedFields( const QgsExpressionContext &context = QgsExpressionContext(), bool ignoreContext = false ) const override;
     bool isActive( int key ) const override;
     bool hasActiveProperties() const override;
@@ -0,0 +1,127 @@
+/***************************************************************************
+     qgspropertyevaluationcache.cpp
+     ------------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgspropertyevaluationcache.h"
+#include "qgsexpression.h"
+#include "qgsexpressioncontext.h"
+#include "qgsexpressionfunction.h"
+#include "qgsexpressionnodeimpl.h"
+#include "qgsfeature.h"
+#include "qgsproperty.h"
+
+#include <QSet>
+
+int QgsPropertyEvaluationCache::slot( const QgsProperty &property, const QgsExpressionContext &context )
+{
+  if ( !property.isActive() )
+    return -1;
+
+  QString source;
+  switch ( property.propertyType() )
+  {
+    case QgsProperty::FieldBasedProperty:
+      source = QStringLiteral( "field:%1" ).arg( property.field() );
+      break;
+
+    case QgsProperty::ExpressionBasedProperty:
+    {
+      source = QStringLiteral( "expression:%1" ).arg( property.expressionString() );
+      if ( mSlots.contains( source ) )
+        break;
+
+      const QgsExpression expression( property.expressionString() );
+      if ( expression.hasParserError() || !dependsOnAttributesOnly( expression, context ) )
+        return -1;
+      break;
+    }
+
+    case QgsProperty::StaticProperty:
+    case QgsProperty::InvalidProperty:
+      return -1;
+  }
+
+  auto it = mSlots.constFind( source );
+  if ( it != mSlots.constEnd() )
+    return it.value();
+
+  const int slot = mValues.size();
+  mValues.append( SlotValue() );
+  mSlots.insert( source, slot );
+  return slot;
+}
+
+bool QgsPropertyEvaluationCache::value( int slot, const QgsExpressionContext &context, QVariant &value, bool &ok )
+{
+  // features are identified by their id and the shared data of their attributes, which is
+  // detached whenever an attribute is changed
+  const QgsFeature feature = context.feature();
+  const QgsAttributes attributes = feature.attributes();
+  if ( mGeneration == 0 || feature.id() != mFeatureId || attributes.constData() != mAttributes.constData() )
+  {
+    mGeneration++;
+    mFeatureId = feature.id();
+    mAttributes = attributes;
+    return false;
+  }
+
+  const SlotValue &slotValue = mValues.at( slot );
+  if ( slotValue.generation != mGeneration )
+    return false;
+
+  value = slotValue.value;
+  ok = slotValue.ok;
+  return true;
+}
+
+void QgsPropertyEvaluationCache::setValue( int slot, const QVariant &value, bool ok )
+{
+  SlotValue &slotValue = mValues[ slot ];
+  slotValue.value = value;
+  slotValue.ok = ok;
+  slotValue.generation = mGeneration;
+}
+
+bool QgsPropertyEvaluationCache::dependsOnAttributesOnly( const QgsExpression &expression, const QgsExpressionContext &context )
+{
+  // functions which only read their arguments, or the attributes of the context feature
+  static const QSet< QString > sFunctions
+  {
+    QStringLiteral( "abs" ), QStringLiteral( "sqrt" ), QStringLiteral( "exp" ), QStringLiteral( "ln" ), QStringLiteral( "log10" ), QStringLiteral( "log" ),
+    QStringLiteral( "round" ), QStringLiteral( "floor" ), QStringLiteral( "ceil" ), QStringLiteral( "pi" ), QStringLiteral( "sin" ), QStringLiteral( "cos" ),
+    QStringLiteral( "tan" ), QStringLiteral( "asin" ), QStringLiteral( "acos" ), QStringLiteral( "atan" ), QStringLiteral( "atan2" ), QStringLiteral( "degrees" ),
+    QStringLiteral( "radians" ), QStringLiteral( "min" ), QStringLiteral( "max" ), QStringLiteral( "clamp" ), QStringLiteral( "scale_linear" ), QStringLiteral( "scale_exp" ),
+    QStringLiteral( "to_int" ), QStringLiteral( "to_real" ), QStringLiteral( "to_string" ), QStringLiteral( "coalesce" ), QStringLiteral( "if" ), QStringLiteral( "nullif" ),
+    QStringLiteral( "upper" ), QStringLiteral( "lower" ), QStringLiteral( "title" ), QStringLiteral( "trim" ), QStringLiteral( "length" ), QStringLiteral( "char" ),
+    QStringLiteral( "replace" ), QStringLiteral( "regexp_replace" ), QStringLiteral( "substr" ), QStringLiteral( "left" ), QStringLiteral( "right" ), QStringLiteral( "lpad" ),
+    QStringLiteral( "rpad" ), QStringLiteral( "concat" ), QStringLiteral( "strpos" ), QStringLiteral( "format_number" ), QStringLiteral( "attribute" ),
+    QStringLiteral( "color_rgb" ), QStringLiteral( "color_rgba" ), QStringLiteral( "color_hsl" ), QStringLiteral( "color_hsla" ), QStringLiteral( "color_hsv" ),
+    QStringLiteral( "color_hsva" ), QStringLiteral( "color_cmyk" ), QStringLiteral( "color_cmyka" ), QStringLiteral( "color_part" ), QStringLiteral( "set_color_part" ),
+    QStringLiteral( "darker" ), QStringLiteral( "lighter" ),
+  };
+
+  if ( !expression.referencedVariables().isEmpty() )
+    return false;
+
+  const QList< const QgsExpressionNode * > nodes = expression.nodes();
+  for ( const QgsExpressionNode *node : nodes )
+  {
+    if ( node->nodeType() != QgsExpressionNode::ntFunction )
+      continue;
+
+    const QString name = QgsExpression::Functions().at( static_cast< const QgsExpressionNodeFunction * >( node )->fnIndex() )->name();
+    if ( !sFunctions.contains( name ) || context.hasFunction( name ) )
+      return false;
+  }
+  return true;
+}
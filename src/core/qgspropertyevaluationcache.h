@@ -0,0 +1,100 @@
+/***************************************************************************
+     qgspropertyevaluationcache.h
+     ----------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSPROPERTYEVALUATIONCACHE_H
+#define QGSPROPERTYEVALUATIONCACHE_H
+
+#include "qgis_core.h"
+#include "qgsattributes.h"
+#include "qgsfeatureid.h"
+
+#include <QHash>
+#include <QVariant>
+#include <QVector>
+
+#define SIP_NO_FILE
+
+class QgsExpression;
+class QgsExpressionContext;
+class QgsProperty;
+
+/**
+ * \ingroup core
+ * \class QgsPropertyEvaluationCache
+ * \brief Shares the source values of data defined properties for the feature being rendered.
+ *
+ * Properties prepared with the same cache which read the same field, or evaluate the same
+ * expression, are assigned the same slot. The source value of a slot is computed once for
+ * each feature, the property transformers are still applied separately for each property.
+ *
+ * Expressions are only cached when their value depends solely on the feature attributes, ie. they
+ * do not use variables, geometries or functions reading other parts of the expression context.
+ *
+ * A cache is created by QgsSymbol::startRender() for all the data defined properties of the symbol
+ * and its symbol layers.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsPropertyEvaluationCache
+{
+  public:
+
+    QgsPropertyEvaluationCache() = default;
+
+    /**
+     * Returns the slot storing the source value of \a property, prepared with \a context,
+     * or -1 if the value of the property cannot be cached.
+     */
+    int slot( const QgsProperty &property, const QgsExpressionContext &context );
+
+    /**
+     * Returns the number of slots, ie. the number of distinct property sources cached.
+     */
+    int slotCount() const { return mValues.size(); }
+
+    /**
+     * Retrieves the source \a value and \a ok flag stored in \a slot for the feature of \a context.
+     *
+     * Returns FALSE if the value was not computed yet for this feature, in which case it
+     * should be stored with setValue().
+     */
+    bool value( int slot, const QgsExpressionContext &context, QVariant &value, bool &ok );
+
+    /**
+     * Stores the source \a value and \a ok flag of \a slot for the current feature.
+     */
+    void setValue( int slot, const QVariant &value, bool ok );
+
+  private:
+
+    struct SlotValue
+    {
+      QVariant value;
+      bool ok = false;
+      quint64 generation = 0;
+    };
+
+    static bool dependsOnAttributesOnly( const QgsExpression &expression, const QgsExpressionContext &context );
+
+    QHash< QString, int > mSlots;
+    QVector< SlotValue > mValues;
+
+    //! Incremented each time the feature changes, 0 until a feature is met
+    quint64 mGeneration = 0;
+    QgsFeatureId mFeatureId = FID_NULL;
+    //! Kept to identify the feature attributes through their implicitly shared data
+    QgsAttributes mAttributes;
+};
+
+#endif // QGSPROPERTYEVALUATIONCACHE_H
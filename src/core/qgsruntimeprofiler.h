@@ -219,6 +219,16 @@ class CORE_EXPORT QgsRuntimeProfiler : public QAbstractItemModel
      */
     void end( const QString &group = "startup" );
 
+    /**
+     * Manually adds a profile event with the given \a name and total \a time (in seconds).
+     *
+     * The event is added as a child of the currently active event of the \a group, if any.
+     * This is useful for recording operations timed elsewhere, e.g. by a map renderer job.
+     *
+     * \since QGIS 3.30
+     */
+    void record( const QString &name, double time, const QString &group = "startup" );
+
     /**
      * Returns the profile time for the specified \a name.
      * \since QGIS 3.14
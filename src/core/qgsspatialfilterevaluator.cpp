@@ -0,0 +1,171 @@
+/***************************************************************************
+    qgsspatialfilterevaluator.cpp
+    ---------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsspatialfilterevaluator.h"
+#include "qgsfeaturerequest.h"
+#include "qgsgeometryengine.h"
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+//! Lists smaller than this are tested on the calling thread
+constexpr int MINIMUM_PARALLEL_TEST_COUNT = 64;
+
+//! Number of features tested by a worker thread at once
+constexpr int PARALLEL_TEST_CHUNK_SIZE = 32;
+
+QgsSpatialFilterEvaluator::QgsSpatialFilterEvaluator( Predicate predicate, const QgsGeometry &geometry, double distance )
+  : mPredicate( predicate )
+  , mGeometry( geometry )
+  , mDistance( distance )
+  , mEngine( createEngine() )
+{
+}
+
+QgsSpatialFilterEvaluator::~QgsSpatialFilterEvaluator() = default;
+
+std::unique_ptr< QgsSpatialFilterEvaluator > QgsSpatialFilterEvaluator::fromRequest( const QgsFeatureRequest &request, const QgsRectangle &filterRect )
+{
+  switch ( request.spatialFilterType() )
+  {
+    case Qgis::SpatialFilterType::NoFilter:
+      return nullptr;
+
+    case Qgis::SpatialFilterType::BoundingBox:
+      if ( filterRect.isNull() || !( request.flags() & QgsFeatureRequest::ExactIntersect ) )
+        return nullptr;
+      return std::make_unique< QgsSpatialFilterEvaluator >( Predicate::Intersects, QgsGeometry::fromRect( filterRect ) );
+
+    case Qgis::SpatialFilterType::DistanceWithin:
+      if ( request.referenceGeometry().isEmpty() )
+        return nullptr;
+      return std::make_unique< QgsSpatialFilterEvaluator >( Predicate::DistanceWithin, request.referenceGeometry(), request.distanceWithin() );
+  }
+  return nullptr;
+}
+
+std::unique_ptr< QgsGeometryEngine > QgsSpatialFilterEvaluator::createEngine() const
+{
+  std::unique_ptr< QgsGeometryEngine > engine( QgsGeometry::createGeometryEngine( mGeometry.constGet() ) );
+  engine->prepareGeometry();
+  return engine;
+}
+
+std::unique_ptr< QgsGeometryEngine > QgsSpatialFilterEvaluator::acquireEngine() const
+{
+  {
+    const QMutexLocker locker( &mIdleEnginesMutex );
+    if ( !mIdleEngines.empty() )
+    {
+      std::unique_ptr< QgsGeometryEngine > engine = std::move( mIdleEngines.back() );
+      mIdleEngines.pop_back();
+      return engine;
+    }
+  }
+
+  // prepared geometries build their index the first time they are used, so each thread needs its own
+  return createEngine();
+}
+
+void QgsSpatialFilterEvaluator::releaseEngine( std::unique_ptr< QgsGeometryEngine > engine ) const
+{
+  const QMutexLocker locker( &mIdleEnginesMutex );
+  mIdleEngines.emplace_back( std::move( engine ) );
+}
+
+bool QgsSpatialFilterEvaluator::test( QgsGeometryEngine *engine, const QgsAbstractGeometry *geometry ) const
+{
+  switch ( mPredicate )
+  {
+    case Predicate::Intersects:
+      return geometry && engine->intersects( geometry );
+
+    case Predicate::DistanceWithin:
+      return engine->distance( geometry ) <= mDistance;
+  }
+  return false;
+}
+
+bool QgsSpatialFilterEvaluator::test( const QgsAbstractGeometry *geometry ) const
+{
+  return test( mEngine.get(), geometry );
+}
+
+QVector< bool > QgsSpatialFilterEvaluator::test( const QgsFeatureList &features ) const
+{
+  const int count = features.size();
+  QVector< bool > results( count );
+  bool *out = results.data();
+
+  if ( count < MINIMUM_PARALLEL_TEST_COUNT || QThread::idealThreadCount() <= 1 )
+  {
+    for ( int i = 0; i < count; ++i )
+      out[i] = test( mEngine.get(), features.at( i ).geometry().constGet() );
+    return results;
+  }
+
+  QVector< QPair< int, int > > chunks;
+  chunks.reserve( count / PARALLEL_TEST_CHUNK_SIZE + 1 );
+  for ( int start = 0; start < count; start += PARALLEL_TEST_CHUNK_SIZE )
+    chunks.append( qMakePair( start, std::min( start + PARALLEL_TEST_CHUNK_SIZE, count ) ) );
+
+  // each chunk writes its own results, so the output keeps the order of the features
+  QtConcurrent::blockingMap( chunks, [this, &features, out]( const QPair< int, int > &chunk )
+  {
+    std::unique_ptr< QgsGeometryEngine > engine = acquireEngine();
+    for ( int i = chunk.first; i < chunk.second; ++i )
+      out[i] = test( engine.get(), features.at( i ).geometry().constGet() );
+    releaseEngine( std::move( engine ) );
+  } );
+
+  return results;
+}
+
+bool QgsSpatialFilterEvaluator::nextFeature( QgsFeature &feature, const std::function< bool( QgsFeature & ) > &fetchCandidate )
+{
+  while ( mReadAheadIndex >= mReadAhead.size() )
+  {
+    mReadAhead.clear();
+    mReadAheadIndex = 0;
+
+    QgsFeature candidate;
+    while ( mReadAhead.size() < mReadAheadSize && fetchCandidate( candidate ) )
+      mReadAhead.append( candidate );
+
+    if ( mReadAhead.isEmpty() )
+      return false;
+
+    const QVector< bool > results = test( mReadAhead );
+    int matches = 0;
+    for ( int i = 0; i < mReadAhead.size(); ++i )
+    {
+      if ( results.at( i ) )
+      {
+        if ( matches != i )
+          mReadAhead[ matches ] = mReadAhead.at( i );
+        matches++;
+      }
+    }
+    mReadAhead.erase( mReadAhead.begin() + matches, mReadAhead.end() );
+  }
+
+  feature = mReadAhead.at( mReadAheadIndex++ );
+  return true;
+}
+
+void QgsSpatialFilterEvaluator::reset()
+{
+  mReadAhead.clear();
+  mReadAheadIndex = 0;
+}
@@ -0,0 +1,149 @@
+/***************************************************************************
+    qgsspatialfilterevaluator.h
+    ---------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSSPATIALFILTEREVALUATOR_H
+#define QGSSPATIALFILTEREVALUATOR_H
+
+#include "qgis_core.h"
+#include "qgsfeature.h"
+#include "qgsgeometry.h"
+
+#include <QMutex>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#define SIP_NO_FILE
+
+class QgsFeatureRequest;
+class QgsGeometryEngine;
+class QgsRectangle;
+
+/**
+ * \ingroup core
+ * \class QgsSpatialFilterEvaluator
+ * \brief Evaluates the exact spatial filter of a feature request against feature geometries, using
+ * several threads.
+ *
+ * This is used by the feature iterators of providers which cannot evaluate spatial predicates
+ * themselves, for the exact intersection of the filter rectangle and for distance within filters.
+ * The filter geometry is prepared once for each thread testing geometries.
+ *
+ * nextFeature() reads ahead the candidate features of an iterator, tests their geometries in parallel
+ * and returns the matching ones in their original order.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsSpatialFilterEvaluator
+{
+  public:
+
+    //! Spatial predicates
+    enum class Predicate
+    {
+      Intersects, //!< Geometries must intersect the filter geometry
+      DistanceWithin, //!< Geometries must be within a distance of the filter geometry
+    };
+
+    /**
+     * Constructor for QgsSpatialFilterEvaluator, testing geometries against the filter \a geometry
+     * with the specified \a predicate. The \a distance is used by the DistanceWithin predicate.
+     */
+    QgsSpatialFilterEvaluator( Predicate predicate, const QgsGeometry &geometry, double distance = 0 );
+
+    ~QgsSpatialFilterEvaluator();
+
+    QgsSpatialFilterEvaluator( const QgsSpatialFilterEvaluator &other ) = delete;
+    QgsSpatialFilterEvaluator &operator=( const QgsSpatialFilterEvaluator &other ) = delete;
+
+    /**
+     * Creates an evaluator for the spatial filter of \a request which requires testing feature geometries,
+     * or returns nullptr if the request has no such filter.
+     *
+     * The \a filterRect must be the filter rectangle of the request in the source CRS, as returned by
+     * QgsAbstractFeatureIterator::filterRectToSourceCrs(). Exact intersections are tested against this
+     * rectangle, distances against the reference geometry of the request in its destination CRS.
+     */
+    static std::unique_ptr< QgsSpatialFilterEvaluator > fromRequest( const QgsFeatureRequest &request, const QgsRectangle &filterRect );
+
+    /**
+     * Returns the spatial predicate tested.
+     */
+    Predicate predicate() const { return mPredicate; }
+
+    /**
+     * Tests a single \a geometry against the filter, on the calling thread.
+     */
+    bool test( const QgsAbstractGeometry *geometry ) const;
+
+    /**
+     * Tests the geometries of \a features against the filter, using several threads for larger lists.
+     *
+     * Returns the result of each feature, in the order of the list.
+     */
+    QVector< bool > test( const QgsFeatureList &features ) const;
+
+    /**
+     * Retrieves the next \a feature matching the filter.
+     *
+     * Candidate features are read by \a fetchCandidate, which returns FALSE once there are no more
+     * candidates. Up to readAheadSize() candidates are read at once, and tested in parallel.
+     *
+     * \see reset()
+     */
+    bool nextFeature( QgsFeature &feature, const std::function< bool( QgsFeature & ) > &fetchCandidate );
+
+    /**
+     * Discards the candidates read ahead by nextFeature(), e.g. when the iterator is rewound.
+     */
+    void reset();
+
+    /**
+     * Sets the maximum number of candidate features read ahead by nextFeature().
+     *
+     * \see readAheadSize()
+     */
+    void setReadAheadSize( int size ) { mReadAheadSize = std::max( size, 1 ); }
+
+    /**
+     * Returns the maximum number of candidate features read ahead by nextFeature().
+     *
+     * \see setReadAheadSize()
+     */
+    int readAheadSize() const { return mReadAheadSize; }
+
+  private:
+
+    std::unique_ptr< QgsGeometryEngine > createEngine() const;
+    std::unique_ptr< QgsGeometryEngine > acquireEngine() const;
+    void releaseEngine( std::unique_ptr< QgsGeometryEngine > engine ) const;
+    bool test( QgsGeometryEngine *engine, const QgsAbstractGeometry *geometry ) const;
+
+    Predicate mPredicate = Predicate::Intersects;
+    QgsGeometry mGeometry;
+    double mDistance = 0;
+
+    //! Engine used by the calling thread
+    std::unique_ptr< QgsGeometryEngine > mEngine;
+
+    //! Engines prepared by the worker threads, which are not used at the moment
+    mutable QMutex mIdleEnginesMutex;
+    mutable std::vector< std::unique_ptr< QgsGeometryEngine > > mIdleEngines;
+
+    QgsFeatureList mReadAhead;
+    int mReadAheadIndex = 0;
+    int mReadAheadSize = 256;
+};
+
+#endif // QGSSPATIALFILTEREVALUATOR_H
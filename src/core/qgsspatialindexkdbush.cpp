@@ -72,7 +72,7 @@ QList<QgsSpatialIndexKDBushData> QgsSpatialIndexKDBush::within( const QgsPointXY
   return result;
 }
 
-void QgsSpatialIndexKDBush::within( const QgsPointXY &point, double radius, const std::function<void( QgsSpatialIndexKDBushData )> &visitor )
+void QgsSpatialIndexKDBush::within( const QgsPointXY &point, double radius, const std::function<void( QgsSpatialIndexKDBushData )> &visitor ) const
 {
   d->index->within( point.x(), point.y(), radius, visitor );
 }
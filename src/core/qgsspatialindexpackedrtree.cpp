@@ -0,0 +1,644 @@
+/***************************************************************************
+                             qgsspatialindexpackedrtree.cpp
+                             ------------------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsspatialindexpackedrtree.h"
+#include "qgsfeatureiterator.h"
+#include "qgsfeedback.h"
+#include "qgsfeaturesource.h"
+#include "qgslogger.h"
+
+#include <QFile>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <vector>
+
+///@cond PRIVATE
+
+//! Identifies the files written by QgsSpatialIndexPackedRTree::writeToFile()
+static const char PACKED_RTREE_MAGIC[8] = { 'Q', 'G', 'S', 'P', 'R', 'T', 'R', 1 };
+
+//! Stored in the files to detect a different byte order
+constexpr quint32 PACKED_RTREE_BYTE_ORDER = 0x01020304;
+
+//! Items are sorted on several threads from this count
+constexpr std::size_t PARALLEL_BUILD_MINIMUM_COUNT = 100000;
+
+//! Number of items sorted at once by a thread
+constexpr std::size_t PARALLEL_BUILD_CHUNK_SIZE = 65536;
+
+//! Header of the index files, followed by the level bounds, the node boxes and the node ids
+struct QgsPackedRTreeFileHeader
+{
+  char magic[8];
+  quint32 byteOrder;
+  quint32 nodeSize;
+  quint64 itemCount;
+  quint64 nodeCount;
+  quint64 levelCount;
+  double extent[4];
+};
+
+/**
+ * Returns the position along a Hilbert curve of the cell at \a x, \a y of a 65536 x 65536 grid.
+ *
+ * From "Fast Hilbert curve generation, sorting, and range queries" by rawrunprotected,
+ * as in the flatbush library.
+ */
+static quint32 hilbertIndex( quint32 x, quint32 y )
+{
+  quint32 a = x ^ y;
+  quint32 b = 0xFFFF ^ a;
+  quint32 c = 0xFFFF ^ ( x | y );
+  quint32 d = x & ( y ^ 0xFFFF );
+
+  quint32 A = a | ( b >> 1 );
+  quint32 B = ( a >> 1 ) ^ a;
+  quint32 C = ( ( c >> 1 ) ^ ( b & ( d >> 1 ) ) ) ^ c;
+  quint32 D = ( ( a & ( c >> 1 ) ) ^ ( d >> 1 ) ) ^ d;
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  A = ( a & ( a >> 2 ) ) ^ ( b & ( b >> 2 ) );
+  B = ( a & ( b >> 2 ) ) ^ ( b & ( ( a ^ b ) >> 2 ) );
+  C ^= ( a & ( c >> 2 ) ) ^ ( b & ( d >> 2 ) );
+  D ^= ( b & ( c >> 2 ) ) ^ ( ( a ^ b ) & ( d >> 2 ) );
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  A = ( a & ( a >> 4 ) ) ^ ( b & ( b >> 4 ) );
+  B = ( a & ( b >> 4 ) ) ^ ( b & ( ( a ^ b ) >> 4 ) );
+  C ^= ( a & ( c >> 4 ) ) ^ ( b & ( d >> 4 ) );
+  D ^= ( b & ( c >> 4 ) ) ^ ( ( a ^ b ) & ( d >> 4 ) );
+
+  a = A;
+  b = B;
+  c = C;
+  d = D;
+  C ^= ( a & ( c >> 8 ) ) ^ ( b & ( d >> 8 ) );
+  D ^= ( b & ( c >> 8 ) ) ^ ( ( a ^ b ) & ( d >> 8 ) );
+
+  a = C ^ ( C >> 1 );
+  b = D ^ ( D >> 1 );
+
+  quint32 i0 = x ^ y;
+  quint32 i1 = b | ( 0xFFFF ^ ( i0 | a ) );
+
+  i0 = ( i0 | ( i0 << 8 ) ) & 0x00FF00FF;
+  i0 = ( i0 | ( i0 << 4 ) ) & 0x0F0F0F0F;
+  i0 = ( i0 | ( i0 << 2 ) ) & 0x33333333;
+  i0 = ( i0 | ( i0 << 1 ) ) & 0x55555555;
+
+  i1 = ( i1 | ( i1 << 8 ) ) & 0x00FF00FF;
+  i1 = ( i1 | ( i1 << 4 ) ) & 0x0F0F0F0F;
+  i1 = ( i1 | ( i1 << 2 ) ) & 0x33333333;
+  i1 = ( i1 | ( i1 << 1 ) ) & 0x55555555;
+
+  return ( i1 << 1 ) | i0;
+}
+
+/**
+ * The nodes of the tree are stored level by level, starting with the leaves, in flat arrays.
+ * Each node has four box coordinates and an id, which is the feature id for the leaves and
+ * the position of the first child node for the other levels.
+ */
+class QgsSpatialIndexPackedRTreePrivate
+{
+  public:
+
+    QgsSpatialIndexPackedRTreePrivate() = default;
+
+    QgsSpatialIndexPackedRTreePrivate( QgsFeatureIterator &fi, QgsFeedback *feedback, const std::function< bool( const QgsFeature & ) > *callback )
+    {
+      std::vector< QgsFeatureId > ids;
+      std::vector< double > boxes;
+
+      QgsFeature f;
+      while ( fi.nextFeature( f ) )
+      {
+        // like QgsSpatialIndex, the features read before a cancellation are still indexed
+        if ( feedback && feedback->isCanceled() )
+          break;
+
+        if ( callback && !( *callback )( f ) )
+          break;
+
+        if ( !f.hasGeometry() )
+          continue;
+
+        const QgsRectangle rect = f.geometry().boundingBox();
+        if ( !rect.isFinite() )
+          continue;
+
+        ids.emplace_back( f.id() );
+        boxes.insert( boxes.end(), { rect.xMinimum(), rect.yMinimum(), rect.xMaximum(), rect.yMaximum() } );
+      }
+
+      build( ids, boxes, QgsSpatialIndexPackedRTree::DEFAULT_NODE_SIZE );
+    }
+
+    QgsSpatialIndexPackedRTreePrivate( const QVector< QgsFeatureId > &featureIds, const QVector< QgsRectangle > &bounds, int nodeSize )
+    {
+      std::vector< QgsFeatureId > ids;
+      std::vector< double > boxes;
+      const int count = std::min( featureIds.size(), bounds.size() );
+      ids.reserve( count );
+      boxes.reserve( 4 * static_cast< std::size_t >( count ) );
+      for ( int i = 0; i < count; ++i )
+      {
+        const QgsRectangle &rect = bounds.at( i );
+        if ( !rect.isFinite() )
+          continue;
+
+        ids.emplace_back( featureIds.at( i ) );
+        boxes.insert( boxes.end(), { rect.xMinimum(), rect.yMinimum(), rect.xMaximum(), rect.yMaximum() } );
+      }
+
+      build( ids, boxes, std::max( nodeSize, 2 ) );
+    }
+
+    void build( const std::vector< QgsFeatureId > &itemIds, const std::vector< double > &itemBoxes, int size );
+    void initializeLevels();
+    bool map( const QString &path );
+
+    //! Returns the end of the level containing the node at \a nodeIndex
+    std::size_t levelEnd( std::size_t nodeIndex ) const
+    {
+      return *std::upper_bound( levelBounds.begin(), levelBounds.end(), nodeIndex );
+    }
+
+    QAtomicInt ref = 1;
+
+    int nodeSize = QgsSpatialIndexPackedRTree::DEFAULT_NODE_SIZE;
+    std::size_t itemCount = 0;
+    std::size_t nodeCount = 0;
+    std::vector< std::size_t > levelBounds;
+    QgsRectangle extent;
+
+    //! Four coordinates for each node
+    const double *boxes = nullptr;
+    const qint64 *ids = nullptr;
+
+    //! Node arrays of an index built in memory
+    std::vector< double > ownedBoxes;
+    std::vector< qint64 > ownedIds;
+
+    //! Mapped file of an index loaded with fromFile()
+    std::unique_ptr< QFile > file;
+};
+
+void QgsSpatialIndexPackedRTreePrivate::build( const std::vector< QgsFeatureId > &itemIds, const std::vector< double > &itemBoxes, int size )
+{
+  nodeSize = size;
+  itemCount = itemIds.size();
+  initializeLevels();
+  if ( itemCount == 0 )
+    return;
+
+  double xMin = std::numeric_limits< double >::max();
+  double yMin = std::numeric_limits< double >::max();
+  double xMax = std::numeric_limits< double >::lowest();
+  double yMax = std::numeric_limits< double >::lowest();
+  for ( std::size_t i = 0; i < itemCount; ++i )
+  {
+    xMin = std::min( xMin, itemBoxes[4 * i] );
+    yMin = std::min( yMin, itemBoxes[4 * i + 1] );
+    xMax = std::max( xMax, itemBoxes[4 * i + 2] );
+    yMax = std::max( yMax, itemBoxes[4 * i + 3] );
+  }
+  extent = QgsRectangle( xMin, yMin, xMax, yMax, false );
+
+  // sort the items along a Hilbert curve through the centers of their boxes
+  const double width = xMax - xMin;
+  const double height = yMax - yMin;
+  std::vector< std::pair< quint32, std::size_t > > order( itemCount );
+  const auto computeOrder = [&]( std::size_t start, std::size_t end )
+  {
+    for ( std::size_t i = start; i < end; ++i )
+    {
+      const double *box = itemBoxes.data() + 4 * i;
+      const quint32 x = width > 0 ? static_cast< quint32 >( 0xFFFF * ( ( box[0] + box[2] ) / 2 - xMin ) / width ) : 0;
+      const quint32 y = height > 0 ? static_cast< quint32 >( 0xFFFF * ( ( box[1] + box[3] ) / 2 - yMin ) / height ) : 0;
+      order[i] = std::make_pair( hilbertIndex( x, y ), i );
+    }
+  };
+
+  if ( itemCount < PARALLEL_BUILD_MINIMUM_COUNT )
+  {
+    computeOrder( 0, itemCount );
+    std::sort( order.begin(), order.end() );
+  }
+  else
+  {
+    // each thread sorts a chunk of the items, the sorted chunks are then merged pairwise
+    std::vector< std::pair< std::size_t, std::size_t > > chunks;
+    for ( std::size_t start = 0; start < itemCount; start += PARALLEL_BUILD_CHUNK_SIZE )
+      chunks.emplace_back( start, std::min( start + PARALLEL_BUILD_CHUNK_SIZE, itemCount ) );
+
+    QtConcurrent::blockingMap( chunks, [&]( const std::pair< std::size_t, std::size_t > &chunk )
+    {
+      computeOrder( chunk.first, chunk.second );
+      std::sort( order.begin() + chunk.first, order.begin() + chunk.second );
+    } );
+
+    while ( chunks.size() > 1 )
+    {
+      std::vector< std::pair< std::size_t, std::size_t > > merged;
+      std::vector< std::pair< std::size_t, std::size_t > > merges;
+      for ( std::size_t i = 0; i < chunks.size(); i += 2 )
+      {
+        if ( i + 1 < chunks.size() )
+        {
+          merged.emplace_back( chunks[i].first, chunks[i + 1].second );
+          merges.emplace_back( i, i + 1 );
+        }
+        else
+        {
+          merged.emplace_back( chunks[i] );
+        }
+      }
+
+      QtConcurrent::blockingMap( merges, [&]( const std::pair< std::size_t, std::size_t > &merge )
+      {
+        std::inplace_merge( order.begin() + chunks[merge.first].first, order.begin() + chunks[merge.second].first, order.begin() + chunks[merge.second].second );
+      } );
+      chunks = std::move( merged );
+    }
+  }
+
+  ownedBoxes.resize( 4 * nodeCount );
+  ownedIds.resize( nodeCount );
+  for ( std::size_t i = 0; i < itemCount; ++i )
+  {
+    const std::size_t item = order[i].second;
+    std::memcpy( ownedBoxes.data() + 4 * i, itemBoxes.data() + 4 * item, 4 * sizeof( double ) );
+    ownedIds[i] = itemIds[item];
+  }
+
+  // each parent node covers the boxes of up to nodeSize consecutive nodes of the level below
+  std::size_t pos = 0;
+  std::size_t parent = itemCount;
+  for ( std::size_t level = 0; level < levelBounds.size() - 1; ++level )
+  {
+    const std::size_t end = levelBounds[level];
+    while ( pos < end )
+    {
+      const std::size_t firstChild = pos;
+      double nodeXMin = std::numeric_limits< double >::max();
+      double nodeYMin = std::numeric_limits< double >::max();
+      double nodeXMax = std::numeric_limits< double >::lowest();
+      double nodeYMax = std::numeric_limits< double >::lowest();
+      for ( int j = 0; j < nodeSize && pos < end; ++j, ++pos )
+      {
+        const double *box = ownedBoxes.data() + 4 * pos;
+        nodeXMin = std::min( nodeXMin, box[0] );
+        nodeYMin = std::min( nodeYMin, box[1] );
+        nodeXMax = std::max( nodeXMax, box[2] );
+        nodeYMax = std::max( nodeYMax, box[3] );
+      }
+
+      double *box = ownedBoxes.data() + 4 * parent;
+      box[0] = nodeXMin;
+      box[1] = nodeYMin;
+      box[2] = nodeXMax;
+      box[3] = nodeYMax;
+      ownedIds[parent] = static_cast< qint64 >( firstChild );
+      parent++;
+    }
+  }
+
+  boxes = ownedBoxes.data();
+  ids = ownedIds.data();
+}
+
+void QgsSpatialIndexPackedRTreePrivate::initializeLevels()
+{
+  levelBounds.clear();
+  nodeCount = 0;
+  if ( itemCount == 0 )
+    return;
+
+  // number of nodes of each level, up to a single root node
+  std::size_t levelCount = itemCount;
+  nodeCount = itemCount;
+  levelBounds.emplace_back( nodeCount );
+  do
+  {
+    levelCount = ( levelCount + nodeSize - 1 ) / nodeSize;
+    nodeCount += levelCount;
+    levelBounds.emplace_back( nodeCount );
+  }
+  while ( levelCount != 1 );
+}
+
+bool QgsSpatialIndexPackedRTreePrivate::map( const QString &path )
+{
+  file = std::make_unique< QFile >( path );
+  if ( !file->open( QIODevice::ReadOnly ) )
+    return false;
+
+  const qint64 fileSize = file->size();
+  if ( fileSize < static_cast< qint64 >( sizeof( QgsPackedRTreeFileHeader ) ) )
+    return false;
+
+  const uchar *data = file->map( 0, fileSize );
+  if ( !data )
+    return false;
+
+  QgsPackedRTreeFileHeader header;
+  std::memcpy( &header, data, sizeof( header ) );
+  if ( std::memcmp( header.magic, PACKED_RTREE_MAGIC, sizeof( PACKED_RTREE_MAGIC ) ) != 0
+       || header.byteOrder != PACKED_RTREE_BYTE_ORDER
+       || header.nodeSize < 2 )
+    return false;
+
+  // the levels are recomputed from the item count, which validates the node count of the file
+  nodeSize = static_cast< int >( header.nodeSize );
+  itemCount = header.itemCount;
+  initializeLevels();
+  if ( nodeCount != header.nodeCount || levelBounds.size() != header.levelCount )
+    return false;
+
+  const qint64 expectedSize = static_cast< qint64 >( sizeof( QgsPackedRTreeFileHeader ) + header.levelCount * sizeof( quint64 ) + nodeCount * ( 4 * sizeof( double ) + sizeof( qint64 ) ) );
+  if ( fileSize != expectedSize )
+    return false;
+
+  const uchar *levelData = data + sizeof( QgsPackedRTreeFileHeader );
+  for ( std::size_t level = 0; level < levelBounds.size(); ++level )
+  {
+    quint64 bound = 0;
+    std::memcpy( &bound, levelData + level * sizeof( quint64 ), sizeof( quint64 ) );
+    if ( bound != levelBounds[level] )
+      return false;
+  }
+
+  boxes = reinterpret_cast< const double * >( levelData + header.levelCount * sizeof( quint64 ) );
+  ids = reinterpret_cast< const qint64 * >( levelData + header.levelCount * sizeof( quint64 ) + 4 * nodeCount * sizeof( double ) );
+
+  // the children of a node must be stored before it in the level below, so that searches stay within the arrays
+  for ( std::size_t level = 1; level < levelBounds.size(); ++level )
+  {
+    const std::size_t childLevelStart = level > 1 ? levelBounds[level - 2] : 0;
+    for ( std::size_t node = levelBounds[level - 1]; node < levelBounds[level]; ++node )
+    {
+      if ( ids[node] < static_cast< qint64 >( childLevelStart ) || ids[node] >= static_cast< qint64 >( levelBounds[level - 1] ) )
+        return false;
+    }
+  }
+
+  extent = itemCount > 0 ? QgsRectangle( header.extent[0], header.extent[1], header.extent[2], header.extent[3], false ) : QgsRectangle();
+  return true;
+}
+
+///@endcond
+
+QgsSpatialIndexPackedRTree::QgsSpatialIndexPackedRTree()
+  : d( new QgsSpatialIndexPackedRTreePrivate() )
+{
+}
+
+QgsSpatialIndexPackedRTree::QgsSpatialIndexPackedRTree( QgsFeatureIterator &fi, QgsFeedback *feedback )
+  : d( new QgsSpatialIndexPackedRTreePrivate( fi, feedback, nullptr ) )
+{
+}
+
+QgsSpatialIndexPackedRTree::QgsSpatialIndexPackedRTree( const QgsFeatureSource &source, QgsFeedback *feedback )
+{
+  QgsFeatureIterator it = source.getFeatures( QgsFeatureRequest().setNoAttributes() );
+  d = new QgsSpatialIndexPackedRTreePrivate( it, feedback, nullptr );
+}
+
+///@cond PRIVATE (avoid doxygen error)
+QgsSpatialIndexPackedRTree::QgsSpatialIndexPackedRTree( QgsFeatureIterator &fi, const std::function<bool ( const QgsFeature & )> &callback, QgsFeedback *feedback )
+  : d( new QgsSpatialIndexPackedRTreePrivate( fi, feedback, &callback ) )
+{
+}
+///@endcond
+
+QgsSpatialIndexPackedRTree::QgsSpatialIndexPackedRTree( const QVector<QgsFeatureId> &ids, const QVector<QgsRectangle> &bounds, int nodeSize )
+  : d( new QgsSpatialIndexPackedRTreePrivate( ids, bounds, nodeSize ) )
+{
+}
+
+QgsSpatialIndexPackedRTree::QgsSpatialIndexPackedRTree( QgsSpatialIndexPackedRTreePrivate *data )
+  : d( data )
+{
+}
+
+QgsSpatialIndexPackedRTree::QgsSpatialIndexPackedRTree( const QgsSpatialIndexPackedRTree &other ): d( other.d )
+{
+  d->ref.ref();
+}
+
+QgsSpatialIndexPackedRTree &QgsSpatialIndexPackedRTree::operator=( const QgsSpatialIndexPackedRTree &other )
+{
+  if ( this != &other )
+  {
+    if ( !d->ref.deref() )
+    {
+      delete d;
+    }
+
+    d = other.d;
+    d->ref.ref();
+  }
+  return *this;
+}
+
+QgsSpatialIndexPackedRTree::~QgsSpatialIndexPackedRTree()
+{
+  if ( !d->ref.deref() )
+    delete d;
+}
+
+QList<QgsFeatureId> QgsSpatialIndexPackedRTree::intersects( const QgsRectangle &rectangle ) const
+{
+  QList<QgsFeatureId> result;
+  intersects( rectangle, [&result]( QgsFeatureId id ) { result << id; } );
+  return result;
+}
+
+void QgsSpatialIndexPackedRTree::intersects( const QgsRectangle &rectangle, const std::function<void ( QgsFeatureId )> &visitor ) const
+{
+  if ( d->nodeCount == 0 )
+    return;
+
+  const double xMin = rectangle.xMinimum();
+  const double yMin = rectangle.yMinimum();
+  const double xMax = rectangle.xMaximum();
+  const double yMax = rectangle.yMaximum();
+
+  // start from the root, which is the last node
+  std::size_t nodeIndex = d->nodeCount - 1;
+  std::vector< std::size_t > pending;
+  while ( true )
+  {
+    const std::size_t end = std::min( nodeIndex + d->nodeSize, d->levelEnd( nodeIndex ) );
+    const bool leaves = nodeIndex < d->itemCount;
+    for ( std::size_t pos = nodeIndex; pos < end; ++pos )
+    {
+      const double *box = d->boxes + 4 * pos;
+      if ( xMax < box[0] || yMax < box[1] || xMin > box[2] || yMin > box[3] )
+        continue;
+
+      if ( leaves )
+        visitor( d->ids[pos] );
+      else
+        pending.emplace_back( static_cast< std::size_t >( d->ids[pos] ) );
+    }
+
+    if ( pending.empty() )
+      break;
+
+    nodeIndex = pending.back();
+    pending.pop_back();
+  }
+}
+
+QList<QgsFeatureId> QgsSpatialIndexPackedRTree::nearestNeighbor( const QgsPointXY &point, int neighbors, double maxDistance ) const
+{
+  QList<QgsFeatureId> result;
+  if ( d->nodeCount == 0 || neighbors <= 0 )
+    return result;
+
+  struct Candidate
+  {
+    double squaredDistance;
+    qint64 value;
+    bool leaf;
+
+    bool operator>( const Candidate &other ) const { return squaredDistance > other.squaredDistance; }
+  };
+
+  const double x = point.x();
+  const double y = point.y();
+  const double maxSquaredDistance = maxDistance * maxDistance;
+
+  // closest candidates first, features come before the nodes at the same distance
+  std::priority_queue< Candidate, std::vector< Candidate >, std::greater< Candidate > > candidates;
+  std::size_t nodeIndex = d->nodeCount - 1;
+  while ( true )
+  {
+    const std::size_t end = std::min( nodeIndex + d->nodeSize, d->levelEnd( nodeIndex ) );
+    const bool leaves = nodeIndex < d->itemCount;
+    for ( std::size_t pos = nodeIndex; pos < end; ++pos )
+    {
+      const double *box = d->boxes + 4 * pos;
+      const double dx = x < box[0] ? box[0] - x : ( x > box[2] ? x - box[2] : 0 );
+      const double dy = y < box[1] ? box[1] - y : ( y > box[3] ? y - box[3] : 0 );
+      const double squaredDistance = dx * dx + dy * dy;
+      if ( maxDistance > 0 && squaredDistance > maxSquaredDistance )
+        continue;
+
+      candidates.push( Candidate{ squaredDistance, d->ids[pos], leaves } );
+    }
+
+    while ( !candidates.empty() && candidates.top().leaf )
+    {
+      result << candidates.top().value;
+      candidates.pop();
+      if ( result.size() == neighbors )
+        return result;
+    }
+
+    if ( candidates.empty() )
+      break;
+
+    nodeIndex = static_cast< std::size_t >( candidates.top().value );
+    candidates.pop();
+  }
+
+  return result;
+}
+
+qgssize QgsSpatialIndexPackedRTree::size() const
+{
+  return d->itemCount;
+}
+
+QgsRectangle QgsSpatialIndexPackedRTree::extent() const
+{
+  return d->extent;
+}
+
+int QgsSpatialIndexPackedRTree::nodeSize() const
+{
+  return d->nodeSize;
+}
+
+bool QgsSpatialIndexPackedRTree::writeToFile( const QString &path ) const
+{
+  QFile file( path );
+  if ( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+  {
+    QgsDebugMsg( QStringLiteral( "Could not open %1 for writing" ).arg( path ) );
+    return false;
+  }
+
+  QgsPackedRTreeFileHeader header;
+  std::memcpy( header.magic, PACKED_RTREE_MAGIC, sizeof( PACKED_RTREE_MAGIC ) );
+  header.byteOrder = PACKED_RTREE_BYTE_ORDER;
+  header.nodeSize = static_cast< quint32 >( d->nodeSize );
+  header.itemCount = d->itemCount;
+  header.nodeCount = d->nodeCount;
+  header.levelCount = d->levelBounds.size();
+  header.extent[0] = d->extent.xMinimum();
+  header.extent[1] = d->extent.yMinimum();
+  header.extent[2] = d->extent.xMaximum();
+  header.extent[3] = d->extent.yMaximum();
+
+  bool ok = file.write( reinterpret_cast< const char * >( &header ), sizeof( header ) ) == sizeof( header );
+  for ( const std::size_t bound : d->levelBounds )
+  {
+    const quint64 value = bound;
+    ok = ok && file.write( reinterpret_cast< const char * >( &value ), sizeof( value ) ) == sizeof( value );
+  }
+
+  const qint64 boxesSize = static_cast< qint64 >( 4 * d->nodeCount * sizeof( double ) );
+  const qint64 idsSize = static_cast< qint64 >( d->nodeCount * sizeof( qint64 ) );
+  if ( d->nodeCount > 0 )
+  {
+    ok = ok && file.write( reinterpret_cast< const char * >( d->boxes ), boxesSize ) == boxesSize;
+    ok = ok && file.write( reinterpret_cast< const char * >( d->ids ), idsSize ) == idsSize;
+  }
+
+  if ( !ok )
+    QgsDebugMsg( QStringLiteral( "Could not write the spatial index to %1" ).arg( path ) );
+  return ok;
+}
+
+QgsSpatialIndexPackedRTree QgsSpatialIndexPackedRTree::fromFile( const QString &path, bool *ok )
+{
+  std::unique_ptr< QgsSpatialIndexPackedRTreePrivate > data = std::make_unique< QgsSpatialIndexPackedRTreePrivate >();
+  const bool res = data->map( path );
+  if ( ok )
+    *ok = res;
+
+  if ( !res )
+  {
+    QgsDebugMsg( QStringLiteral( "Could not read a spatial index from %1" ).arg( path ) );
+    return QgsSpatialIndexPackedRTree();
+  }
+
+  return QgsSpatialIndexPackedRTree( data.release() );
+}
@@ -0,0 +1,187 @@
+/***************************************************************************
+                             qgsspatialindexpackedrtree.h
+                             ----------------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSSPATIALINDEXPACKEDRTREE_H
+#define QGSSPATIALINDEXPACKEDRTREE_H
+
+class QgsFeatureIterator;
+class QgsFeedback;
+class QgsFeatureSource;
+class QgsSpatialIndexPackedRTreePrivate;
+class QgsFeature;
+
+#include "qgis_core.h"
+#include "qgis_sip.h"
+#include "qgsfeatureid.h"
+#include "qgspointxy.h"
+#include "qgsrectangle.h"
+#include <QList>
+#include <QVector>
+#include <functional>
+
+/**
+ * \class QgsSpatialIndexPackedRTree
+ * \ingroup core
+ *
+ * \brief A fast static spatial index for feature bounding boxes, based on a packed Hilbert R-tree.
+ *
+ * Compared to QgsSpatialIndex, this index:
+ *
+ * - is static (features cannot be added or removed from the index after construction)
+ * - is bulk loaded, sorting the bounding boxes along a Hilbert curve, which is much faster
+ *   and uses much less memory
+ * - stores its nodes in flat arrays, which can be written to a file and mapped back into memory
+ *   with fromFile() without rebuilding the index
+ *
+ * The intersects() and nearestNeighbor() searches match those of QgsSpatialIndex with no stored
+ * feature geometries, i.e. they test the bounding boxes of the features.
+ *
+ * QgsSpatialIndexPackedRTree objects are implicitly shared and can be inexpensively copied.
+ *
+ * \see QgsSpatialIndex, which is an general, mutable index for geometry bounding boxes.
+ * \see QgsSpatialIndexKDBush, which is a static index for points.
+ * \since QGIS 3.30
+*/
+class CORE_EXPORT QgsSpatialIndexPackedRTree
+{
+  public:
+
+    //! Default number of entries of each node of the tree
+    static constexpr int DEFAULT_NODE_SIZE = 16;
+
+    /**
+     * Constructor for an empty QgsSpatialIndexPackedRTree.
+     */
+    QgsSpatialIndexPackedRTree();
+
+    /**
+     * Constructor - creates the index and bulk loads it with the bounding boxes of features from the iterator.
+     *
+     * The optional \a feedback object can be used to allow cancellation of bulk feature loading. Ownership
+     * of \a feedback is not transferred, and callers must take care that the lifetime of feedback exceeds
+     * that of the spatial index construction.
+     *
+     * Features without geometry are ignored and not included in the index.
+     */
+    explicit QgsSpatialIndexPackedRTree( QgsFeatureIterator &fi, QgsFeedback *feedback = nullptr );
+
+    /**
+     * Constructor - creates the index and bulk loads it with the bounding boxes of features from the source.
+     *
+     * The optional \a feedback object can be used to allow cancellation of bulk feature loading. Ownership
+     * of \a feedback is not transferred, and callers must take care that the lifetime of feedback exceeds
+     * that of the spatial index construction.
+     *
+     * Features without geometry are ignored and not included in the index.
+     */
+    explicit QgsSpatialIndexPackedRTree( const QgsFeatureSource &source, QgsFeedback *feedback = nullptr );
+
+#ifndef SIP_RUN
+
+    /**
+     * Constructor - creates the index and bulk loads it with the bounding boxes of features from the iterator.
+     *
+     * This constructor allows for a \a callback function to be specified, which is
+     * called for each added feature in turn. It allows for bulk spatial index load along with other feature
+     * based operations on a single iteration through a feature source. If \a callback returns FALSE, the
+     * load and iteration is canceled.
+     *
+     * Features without geometry are ignored and not included in the index.
+     *
+     * \note Not available in Python bindings
+     */
+    explicit QgsSpatialIndexPackedRTree( QgsFeatureIterator &fi, const std::function< bool( const QgsFeature & ) > &callback, QgsFeedback *feedback = nullptr );
+#endif
+
+    /**
+     * Constructor - creates the index and bulk loads it with the given feature \a ids and their \a bounds.
+     *
+     * The lists must have the same size. The \a nodeSize sets the number of entries of each node of the tree.
+     */
+    QgsSpatialIndexPackedRTree( const QVector< QgsFeatureId > &ids, const QVector< QgsRectangle > &bounds, int nodeSize = DEFAULT_NODE_SIZE );
+
+    //! Copy constructor
+    QgsSpatialIndexPackedRTree( const QgsSpatialIndexPackedRTree &other );
+
+    //! Assignment operator
+    QgsSpatialIndexPackedRTree &operator=( const QgsSpatialIndexPackedRTree &other );
+
+    ~QgsSpatialIndexPackedRTree();
+
+    /**
+     * Returns the list of features with a bounding box which intersects the specified \a rectangle.
+     */
+    QList<QgsFeatureId> intersects( const QgsRectangle &rectangle ) const;
+
+    /**
+     * Calls a \a visitor function for all features with a bounding box which intersects the specified \a rectangle.
+     *
+     * \note Not available in Python bindings
+     */
+    void intersects( const QgsRectangle &rectangle, const std::function<void( QgsFeatureId )> &visitor ) const SIP_SKIP;
+
+    /**
+     * Returns the nearest \a neighbors (feature IDs) to the specified \a point, ordered by the distance
+     * from the point to their bounding box.
+     *
+     * If \a maxDistance is specified, then only features whose bounding box is within the search distance of
+     * the point are returned. Ties are broken arbitrarily.
+     */
+    QList<QgsFeatureId> nearestNeighbor( const QgsPointXY &point, int neighbors = 1, double maxDistance = 0 ) const;
+
+    /**
+     * Returns the number of features in the index.
+     */
+    qgssize size() const;
+
+    /**
+     * Returns the bounding box of all the features in the index.
+     */
+    QgsRectangle extent() const;
+
+    /**
+     * Returns the number of entries of each node of the tree.
+     */
+    int nodeSize() const;
+
+    /**
+     * Writes the index to a file at \a path, returning TRUE on success.
+     *
+     * The file uses the byte order of the platform.
+     *
+     * \see fromFile()
+     */
+    bool writeToFile( const QString &path ) const;
+
+    /**
+     * Loads an index written by writeToFile() from the file at \a path.
+     *
+     * The file is mapped into memory, so loading the index does not read it and its nodes are shared
+     * between the processes using the same file.
+     *
+     * If \a ok is specified, it is set to FALSE if the file cannot be read, in which case an empty index is returned.
+     */
+    static QgsSpatialIndexPackedRTree fromFile( const QString &path, bool *ok SIP_OUT = nullptr );
+
+  private:
+
+    //! Implicitly shared data pointer
+    QgsSpatialIndexPackedRTreePrivate *d = nullptr;
+
+    explicit QgsSpatialIndexPackedRTree( QgsSpatialIndexPackedRTreePrivate *data );
+};
+
+#endif // QGSSPATIALINDEXPACKEDRTREE_H
@@ -25,10 +25,12 @@
 #include "qgstemporalnavigationobject.h"
 #include "qgsmapdecoration.h"
 #include "qgsmapsettings.h"
-#include "qgsmaprenderercustompainterjob.h"
+#include "qgsmaprendererparalleljob.h"
 #include "qgsexpressioncontextutils.h"
 
 #include <QRegularExpression>
+#include <QtConcurrentRun>
+#include <QFuture>
 
 QgsDateTimeRange QgsTemporalUtils::calculateTemporalRangeForProject( QgsProject *project )
 {
@@ -109,12 +111,16 @@ bool QgsTemporalUtils::exportAnimation( const QgsMapSettings &mapSettings, const
   const long long totalFrames = navigator.totalFrameCount();
   long long currentFrame = 0;
 
+  // the previous frame is encoded and written in the background while the next one is rendered
+  QFuture< void > pendingSave;
+
   while ( currentFrame < totalFrames )
   {
     if ( feedback )
     {
       if ( feedback->isCanceled() )
       {
+        pendingSave.waitForFinished();
         error = QObject::tr( "Export canceled" );
         return false;
       }
@@ -142,11 +148,14 @@ bool QgsTemporalUtils::exportAnimation( const QgsMapSettings &mapSettings, const
     img.setDotsPerMeterY( 1000 * ms.outputDpi() / 25.4 );
     img.fill( ms.backgroundColor().rgb() );
 
-    QPainter p( &img );
-    QgsMapRendererCustomPainterJob job( ms, &p );
+    // layers are rendered concurrently, then composed over the opaque background
+    QgsMapRendererParallelJob job( ms );
     job.start();
     job.waitForFinished();
 
+    QPainter p( &img );
+    p.drawImage( QPointF( 0, 0 ), job.renderedImage() );
+
     QgsRenderContext context = QgsRenderContext::fromMapSettings( ms );
     context.setPainter( &p );
 
@@ -158,11 +167,16 @@ bool QgsTemporalUtils::exportAnimation( const QgsMapSettings &mapSettings, const
 
     p.end();
 
-    img.save( path );
+    pendingSave.waitForFinished();
+    pendingSave = QtConcurrent::run( [img, path]
+    {
+      img.save( path );
+    } );
 
     ++currentFrame;
   }
 
+  pendingSave.waitForFinished();
   return true;
 }
 
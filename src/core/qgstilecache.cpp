@@ -17,18 +17,40 @@
 
 #include "qgsnetworkaccessmanager.h"
 #include "qgsapplication.h"
+#include "qgssettingsregistrycore.h"
 #include <QAbstractNetworkCache>
 #include <QImage>
 #include <QUrl>
 
-QCache<QUrl, QImage> QgsTileCache::sTileCache( 256 );
+#include <algorithm>
+#include <limits>
+
+QCache<QUrl, QImage> QgsTileCache::sTileCache;
 QMutex QgsTileCache::sTileCacheMutex;
 
 
+void QgsTileCache::initializeMaxCost()
+{
+  static bool sInitialized = false;
+  if ( sInitialized )
+    return;
+
+  const qlonglong sizeMb = std::clamp( QgsSettingsRegistryCore::settingsTileCacheSize->value(), 1LL, static_cast< qlonglong >( std::numeric_limits< int >::max() / 1024 ) );
+  sTileCache.setMaxCost( static_cast< int >( sizeMb * 1024 ) );
+  sInitialized = true;
+}
+
+int QgsTileCache::imageCost( const QImage &image )
+{
+  // in kilobytes, so the cost of any cache size fits an int
+  return std::max( 1, static_cast< int >( image.sizeInBytes() / 1024 ) );
+}
+
 void QgsTileCache::insertTile( const QUrl &url, const QImage &image )
 {
   const QMutexLocker locker( &sTileCacheMutex );
-  sTileCache.insert( url, new QImage( image ) );
+  initializeMaxCost();
+  sTileCache.insert( url, new QImage( image ), imageCost( image ) );
 }
 
 bool QgsTileCache::tile( const QUrl &url, QImage &image )
@@ -38,32 +60,38 @@ bool QgsTileCache::tile( const QUrl &url, QImage &image )
   QgsNetworkAccessManager::instance()->preprocessRequest( &req );
   const QUrl adjUrl = req.url();
 
-  const QMutexLocker locker( &sTileCacheMutex );
-  bool success = false;
-  if ( QImage *i = sTileCache.object( adjUrl ) )
   {
-    image = *i;
-    success = true;
-  }
-  else if ( QgsNetworkAccessManager::instance()->cache()->metaData( adjUrl ).isValid() )
-  {
-    if ( QIODevice *data = QgsNetworkAccessManager::instance()->cache()->data( adjUrl ) )
+    const QMutexLocker locker( &sTileCacheMutex );
+    if ( QImage *i = sTileCache.object( adjUrl ) )
     {
-      const QByteArray imageData = data->readAll();
-      delete data;
-
-      image = QImage::fromData( imageData );
-
-      // cache it as well (mutex is already locked)
-      // Check for null because it could be a redirect (see: https://github.com/qgis/QGIS/issues/24336 )
-      if ( ! image.isNull( ) )
-      {
-        sTileCache.insert( adjUrl, new QImage( image ) );
-        success = true;
-      }
+      image = *i;
+      return true;
     }
   }
-  return success;
+
+  // the disk cache has its own lock, and the mutex is not held while decoding the image
+  // so that tiles requested by several rendering threads are decoded in parallel
+  if ( !QgsNetworkAccessManager::instance()->cache()->metaData( adjUrl ).isValid() )
+    return false;
+
+  QIODevice *data = QgsNetworkAccessManager::instance()->cache()->data( adjUrl );
+  if ( !data )
+    return false;
+
+  const QByteArray imageData = data->readAll();
+  delete data;
+
+  image = QImage::fromData( imageData );
+
+  // Check for null because it could be a redirect (see: https://github.com/qgis/QGIS/issues/24336 )
+  if ( image.isNull() )
+    return false;
+
+  // cache it as well
+  const QMutexLocker locker( &sTileCacheMutex );
+  initializeMaxCost();
+  sTileCache.insert( adjUrl, new QImage( image ), imageCost( image ) );
+  return true;
 }
 
 int QgsTileCache::totalCost()
@@ -75,5 +103,6 @@ int QgsTileCache::totalCost()
 int QgsTileCache::maxCost()
 {
   const QMutexLocker locker( &sTileCacheMutex );
+  initializeMaxCost();
   return sTileCache.maxCost();
 }
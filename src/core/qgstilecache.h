@@ -29,7 +29,8 @@ class QUrl;
  * A simple tile cache implementation. Tiles are cached according to their URL.
  * There is a small in-memory cache and a secondary caching in the local disk.
  * The in-memory cache is there to save CPU time otherwise wasted to read and
- * uncompress data saved on the disk.
+ * uncompress data saved on the disk. Its size is limited by the memory used by
+ * the decoded images, see QgsSettingsRegistryCore::settingsTileCacheSize.
  *
  * The class is thread safe (its methods can be called from any thread).
  *
@@ -50,12 +51,18 @@ class CORE_EXPORT QgsTileCache
      */
     static bool tile( const QUrl &url, QImage &image );
 
-    //! how many tiles are stored in the in-memory cache
+    //! how many kilobytes of decoded tiles are stored in the in-memory cache
     static int totalCost();
-    //! how many tiles can be stored in the in-memory cache
+    //! how many kilobytes of decoded tiles can be stored in the in-memory cache
     static int maxCost();
 
   private:
+    //! Sets the size of the in-memory cache from the settings, the mutex must be locked
+    static void initializeMaxCost();
+
+    //! Returns the cost of the \a image in the in-memory cache
+    static int imageCost( const QImage &image );
+
     //! in-memory cache
     static QCache<QUrl, QImage> sTileCache;
     //! mutex to protect the in-memory cache
@@ -131,7 +131,9 @@ QgsTracerGraph *makeGraph( const QVector<QgsPolylineXY> &edges )
 {
   QgsTracerGraph *g = new QgsTracerGraph();
   g->joinedVertices = 0;
+  g->e.reserve( edges.size() );
   QHash<QgsPointXY, int> point2vertex;
+  point2vertex.reserve( edges.size() );
 
   const auto constEdges = edges;
   for ( const QgsPolylineXY &line : constEdges )
@@ -581,6 +583,7 @@ bool QgsTracer::initGraph()
   t3.start();
 
   mGraph.reset( makeGraph( mpl ) );
+  mGraphExtent = mExtent;
 
   int timeMake = t3.elapsed();
 
@@ -650,6 +653,12 @@ void QgsTracer::setExtent( const QgsRectangle &extent )
     return;
 
   mExtent = extent;
+
+  // a graph built for a larger extent already contains all the linework of the new extent,
+  // e.g. when zooming in the canvas
+  if ( mGraph && ( mGraphExtent.isEmpty() || ( !extent.isEmpty() && mGraphExtent.contains( extent ) ) ) )
+    return;
+
   invalidateGraph();
 }
 
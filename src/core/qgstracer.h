@@ -191,6 +191,8 @@ class CORE_EXPORT QgsTracer : public QObject
     std::unique_ptr<QgsRenderContext> mRenderContext;
     //! Extent for graph building (empty extent means no limit)
     QgsRectangle mExtent;
+    //! Extent for which the current graph was built (empty extent means no limit)
+    QgsRectangle mGraphExtent;
 
     //! Offset in map units that should be applied to the traced paths
     double mOffset = 0;
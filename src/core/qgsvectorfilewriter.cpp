@@ -38,6 +38,7 @@
 #include "qgsexpressioncontextutils.h"
 #include "qgsreadwritelocker.h"
 #include "qgssymbol.h"
+#include "qgsgeopackagespatialindextask.h"
 
 #include <QFile>
 #include <QFileInfo>
@@ -49,10 +50,14 @@
 #include <QMutex>
 #include <QRegularExpression>
 #include <QJsonDocument>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 
 #include <cassert>
 #include <cstdlib> // size_t
+#include <functional>
 #include <limits> // std::numeric_limits
+#include <numeric>
 
 #include <ogr_srs_api.h>
 #include <cpl_error.h>
@@ -142,12 +147,55 @@ QgsVectorFileWriter *QgsVectorFileWriter::create(
   QString *newLayer
 )
 {
+  bool deferSpatialIndex = false;
+  const QStringList layerOptions = layerOptionsForSpatialIndexCreation( options.layerOptions, options.driverName, geometryType,
+                                   options.actionOnExistingFile, options.spatialIndexCreation, deferSpatialIndex );
+
+  QString finalFileName;
   Q_NOWARN_DEPRECATED_PUSH
-  return new QgsVectorFileWriter( fileName, options.fileEncoding, fields, geometryType, srs,
-                                  options.driverName, options.datasourceOptions, options.layerOptions,
-                                  newFilename, options.symbologyExport, options.fieldValueConverter, options.layerName,
-                                  options.actionOnExistingFile, newLayer, transformContext, sinkFlags, options.fieldNameSource );
+  QgsVectorFileWriter *writer = new QgsVectorFileWriter( fileName, options.fileEncoding, fields, geometryType, srs,
+      options.driverName, options.datasourceOptions, layerOptions,
+      &finalFileName, options.symbologyExport, options.fieldValueConverter, options.layerName,
+      options.actionOnExistingFile, newLayer, transformContext, sinkFlags, options.fieldNameSource );
   Q_NOWARN_DEPRECATED_POP
+
+  if ( newFilename && !finalFileName.isEmpty() )
+    *newFilename = finalFileName;
+
+  if ( deferSpatialIndex && writer->mError == NoError )
+  {
+    writer->mSpatialIndexCreation = options.spatialIndexCreation;
+    writer->mSpatialIndexFileName = finalFileName;
+  }
+  return writer;
+}
+
+QStringList QgsVectorFileWriter::layerOptionsForSpatialIndexCreation( const QStringList &layerOptions, const QString &driverName, QgsWkbTypes::Type geometryType,
+    ActionOnExistingFile action, SpatialIndexCreation spatialIndexCreation, bool &deferred )
+{
+  deferred = false;
+  if ( spatialIndexCreation == SpatialIndexOnInsert || driverName != QLatin1String( "GPKG" ) || geometryType == QgsWkbTypes::NoGeometry
+       || ( action != CreateOrOverwriteFile && action != CreateOrOverwriteLayer ) )
+    return layerOptions;
+
+  QStringList options;
+  options.reserve( layerOptions.size() + 1 );
+  for ( const QString &option : layerOptions )
+  {
+    if ( option.startsWith( QLatin1String( "SPATIAL_INDEX=" ), Qt::CaseInsensitive ) )
+    {
+      // a layer created without spatial index keeps none
+      if ( !CPLTestBool( option.mid( 14 ).toUtf8().constData() ) )
+        return layerOptions;
+      continue;
+    }
+    options << option;
+  }
+
+  // no R-tree triggers are run on insertion, the index is built by createSpatialIndex() once the writer is destroyed
+  options << QStringLiteral( "SPATIAL_INDEX=NO" );
+  deferred = true;
+  return options;
 }
 
 bool QgsVectorFileWriter::supportsFeatureStyles( const QString &driverName )
@@ -375,6 +423,17 @@ void QgsVectorFileWriter::init( QString vectorFileName,
     return;
   }
 
+  if ( action == CreateOrOverwriteFile && driverName == QLatin1String( "GPKG" ) )
+  {
+    // a new file is discarded anyway if the export fails, so don't wait for the disk on each commit and
+    // let SQLite keep more pages of the tables and of the R-tree in memory while bulk loading
+    for ( const char *pragma : { "PRAGMA synchronous = OFF", "PRAGMA cache_size = -65536" } )
+    {
+      if ( OGRLayerH result = OGR_DS_ExecuteSQL( mDS.get(), pragma, nullptr, nullptr ) )
+        OGR_DS_ReleaseResultSet( mDS.get(), result );
+    }
+  }
+
   QString layerName( layerNameIn );
   if ( layerName.isEmpty() )
     layerName = QFileInfo( vectorFileName ).baseName();
@@ -909,7 +968,7 @@ void QgsVectorFileWriter::init( QString vectorFileName,
   }
 }
 
-OGRGeometryH QgsVectorFileWriter::createEmptyGeometry( QgsWkbTypes::Type wkbType )
+OGRGeometryH QgsVectorFileWriter::createEmptyGeometry( QgsWkbTypes::Type wkbType ) const
 {
   return OGR_G_CreateGeometry( ogrTypeFromWkbType( wkbType ) );
 }
@@ -2626,6 +2685,19 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
   QgsLocaleNumC l; // Make sure the decimal delimiter is a dot
   Q_UNUSED( l )
 
+  QString error;
+  gdal::ogr_feature_unique_ptr poFeature = prepareFeature( feature, error );
+  if ( !poFeature && !error.isEmpty() )
+  {
+    mErrorMessage = error;
+    mError = ErrFeatureWriteFailed;
+    QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
+  }
+  return poFeature;
+}
+
+gdal::ogr_feature_unique_ptr QgsVectorFileWriter::prepareFeature( const QgsFeature &feature, QString &error ) const
+{
   gdal::ogr_feature_unique_ptr poFeature( OGR_F_Create( OGR_L_GetLayerDefn( mLayer ) ) );
 
   // attribute handling
@@ -2667,11 +2739,9 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
     QString errorMessage;
     if ( ! field.convertCompatible( attrValue, &errorMessage ) )
     {
-      mErrorMessage = QObject::tr( "Error converting value (%1) for attribute field %2: %3" )
-                      .arg( feature.attribute( fldIdx ).toString(),
-                            mFields.at( fldIdx ).name(), errorMessage );
-      QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
-      mError = ErrFeatureWriteFailed;
+      error = QObject::tr( "Error converting value (%1) for attribute field %2: %3" )
+              .arg( feature.attribute( fldIdx ).toString(),
+                    mFields.at( fldIdx ).name(), errorMessage );
       return nullptr;
     }
 
@@ -2924,13 +2994,11 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
         FALLTHROUGH
 
       default:
-        mErrorMessage = QObject::tr( "Invalid variant type for field %1[%2]: received %3 with type %4" )
-                        .arg( mFields.at( fldIdx ).name() )
-                        .arg( ogrField )
-                        .arg( attrValue.typeName(),
-                              attrValue.toString() );
-        QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
-        mError = ErrFeatureWriteFailed;
+        error = QObject::tr( "Invalid variant type for field %1[%2]: received %3 with type %4" )
+                .arg( mFields.at( fldIdx ).name() )
+                .arg( ogrField )
+                .arg( attrValue.typeName(),
+                      attrValue.toString() );
         return nullptr;
     }
   }
@@ -3020,10 +3088,8 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
 
         if ( !mGeom2 )
         {
-          mErrorMessage = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
-                          .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
-          mError = ErrFeatureWriteFailed;
-          QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
+          error = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
+                  .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
           return nullptr;
         }
 
@@ -3035,10 +3101,8 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
         OGRErr err = OGR_G_ImportFromWkb( mGeom2, reinterpret_cast<unsigned char *>( const_cast<char *>( wkb.constData() ) ), wkb.length() );
         if ( err != OGRERR_NONE )
         {
-          mErrorMessage = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
-                          .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
-          mError = ErrFeatureWriteFailed;
-          QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
+          error = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
+                  .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
           return nullptr;
         }
 
@@ -3056,10 +3120,8 @@ gdal::ogr_feature_unique_ptr QgsVectorFileWriter::createFeature( const QgsFeatur
         OGRErr err = OGR_G_ImportFromWkb( ogrGeom, reinterpret_cast<unsigned char *>( const_cast<char *>( wkb.constData() ) ), wkb.length() );
         if ( err != OGRERR_NONE )
         {
-          mErrorMessage = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
-                          .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
-          mError = ErrFeatureWriteFailed;
-          QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
+          error = QObject::tr( "Feature geometry not imported (OGR error: %1)" )
+                  .arg( QString::fromUtf8( CPLGetLastErrorMsg() ) );
           return nullptr;
         }
 
@@ -3107,8 +3169,22 @@ QgsVectorFileWriter::~QgsVectorFileWriter()
       QgsDebugMsg( QStringLiteral( "Error while committing transaction on OGRLayer." ) );
     }
   }
+
+  const QString spatialIndexLayerName = mSpatialIndexCreation != SpatialIndexOnInsert && mLayer ? QString::fromUtf8( OGR_L_GetName( mLayer ) ) : QString();
+  if ( mSpatialIndexCreation == SpatialIndexDeferred && !spatialIndexLayerName.isEmpty() )
+  {
+    QString error;
+    if ( !QgsGeoPackageSpatialIndexTask::createSpatialIndex( mDS.get(), spatialIndexLayerName, &error ) )
+      QgsMessageLog::logMessage( error, QObject::tr( "OGR" ) );
+  }
+
   mDS.reset();
 
+  if ( mSpatialIndexCreation == SpatialIndexInBackground && !spatialIndexLayerName.isEmpty() )
+  {
+    QgsApplication::taskManager()->addTask( new QgsGeoPackageSpatialIndexTask( mSpatialIndexFileName, spatialIndexLayerName ) );
+  }
+
   if ( mOgrRef )
   {
     OSRRelease( mOgrRef );
@@ -3493,9 +3569,17 @@ QgsVectorFileWriter::WriterError QgsVectorFileWriter::writeAsVectorFormatV2( Pre
   writer->mFields = details.sourceFields;
 
   // write all features
+  const bool pipelined = writer->canExportFeaturesPipelined();
+  if ( pipelined )
+  {
+    err = writer->exportFeaturesPipelined( details, options, errorMessage, n, errors, lastProgressReport );
+    if ( err != NoError )
+      return err;
+  }
+
   long saved = 0;
   int initialProgress = lastProgressReport;
-  while ( details.sourceFeatureIterator.nextFeature( fet ) )
+  while ( !pipelined && details.sourceFeatureIterator.nextFeature( fet ) )
   {
     if ( options.feedback && options.feedback->isCanceled() )
     {
@@ -4171,6 +4255,204 @@ QgsVectorFileWriter::WriterError QgsVectorFileWriter::exportFeaturesSymbolLevels
   return ( nErrors > 0 ) ? QgsVectorFileWriter::ErrFeatureWriteFailed : QgsVectorFileWriter::NoError;
 }
 
+///@cond PRIVATE
+
+//! Number of features prepared on worker threads while the previous batch is written
+constexpr std::size_t VECTOR_WRITER_BATCH_SIZE = 1000;
+
+///@endcond
+
+bool QgsVectorFileWriter::canExportFeaturesPipelined() const
+{
+  // styles are computed with the render context, and field value converters or transforms may not be thread safe
+  return mSymbologyExport == NoSymbology && !mFieldValueConverter && !mCoordinateTransform;
+}
+
+QgsVectorFileWriter::WriterError QgsVectorFileWriter::exportFeaturesPipelined( PreparedWriterDetails &details, const SaveVectorOptions &options,
+    QString *errorMessage, int &written, int &errors, int &lastProgressReport )
+{
+  struct PipelinedFeature
+  {
+    QgsFeature feature;
+    QString transformError;
+    bool skipped = false;
+    gdal::ogr_feature_unique_ptr ogrFeature;
+    QString error;
+  };
+
+  const long long total = details.featureCount;
+  const int initialProgress = lastProgressReport;
+  long long saved = 0;
+  bool stopped = false;
+
+  std::vector< PipelinedFeature > preparing;
+  std::vector< PipelinedFeature > writing;
+  std::vector< int > indices;
+  preparing.reserve( VECTOR_WRITER_BATCH_SIZE );
+  writing.reserve( VECTOR_WRITER_BATCH_SIZE );
+  indices.reserve( VECTOR_WRITER_BATCH_SIZE );
+
+  // features are written in their input order, and errors are reported as by the sequential export. Only
+  // the write thread touches the layer and the error state of the writer while it is running
+  const std::function< void() > writeBatch = [this, &writing, &written, &errors, &stopped, errorMessage]()
+  {
+    for ( PipelinedFeature &pipelined : writing )
+    {
+      if ( pipelined.skipped )
+        continue;
+
+      bool ok = static_cast< bool >( pipelined.ogrFeature );
+      if ( !ok && !pipelined.error.isEmpty() )
+      {
+        mErrorMessage = pipelined.error;
+        mError = ErrFeatureWriteFailed;
+        QgsMessageLog::logMessage( mErrorMessage, QObject::tr( "OGR" ) );
+      }
+      else if ( ok )
+      {
+        ok = writeFeature( mLayer, pipelined.ogrFeature.get() );
+      }
+
+      if ( !ok )
+      {
+        if ( mError != NoError && errorMessage )
+        {
+          if ( errorMessage->isEmpty() )
+          {
+            *errorMessage = QObject::tr( "Feature write errors:" );
+          }
+          *errorMessage += '\n' + mErrorMessage;
+        }
+        errors++;
+
+        if ( errors > 1000 )
+        {
+          if ( errorMessage )
+          {
+            *errorMessage += QObject::tr( "Stopping after %n error(s)", nullptr, errors );
+          }
+
+          written = -1;
+          stopped = true;
+          return;
+        }
+      }
+      written++;
+    }
+  };
+
+  QFuture< void > writeFuture;
+  QgsFeature fet;
+  bool hasMoreFeatures = true;
+  while ( hasMoreFeatures && !stopped )
+  {
+    if ( options.feedback && options.feedback->isCanceled() )
+    {
+      writeFuture.waitForFinished();
+      return Canceled;
+    }
+
+    preparing.clear();
+    while ( preparing.size() < VECTOR_WRITER_BATCH_SIZE && ( hasMoreFeatures = details.sourceFeatureIterator.nextFeature( fet ) ) )
+    {
+      if ( details.attributes.empty() && options.skipAttributeCreation )
+      {
+        fet.initAttributes( 0 );
+      }
+      PipelinedFeature pipelined;
+      pipelined.feature = fet;
+      preparing.emplace_back( std::move( pipelined ) );
+    }
+    if ( preparing.empty() )
+      break;
+
+    saved += static_cast< long long >( preparing.size() );
+    if ( options.feedback )
+    {
+      //avoid spamming progress reports
+      int newProgress = static_cast<int>( initialProgress + ( ( 100.0 - initialProgress ) * saved ) / total );
+      if ( newProgress < 100 && newProgress != lastProgressReport )
+      {
+        lastProgressReport = newProgress;
+        options.feedback->setProgress( lastProgressReport );
+      }
+    }
+
+    indices.resize( preparing.size() );
+    std::iota( indices.begin(), indices.end(), 0 );
+
+    if ( details.shallTransform )
+    {
+      const QgsCoordinateTransform &ct = options.ct;
+      QtConcurrent::blockingMap( indices, [&preparing, &ct]( const int &index )
+      {
+        PipelinedFeature &pipelined = preparing[index];
+        if ( !pipelined.feature.hasGeometry() )
+          return;
+
+        // transforms cache their last error, so each feature uses its own copy
+        QgsCoordinateTransform featureTransform = ct;
+        try
+        {
+          QgsGeometry g = pipelined.feature.geometry();
+          g.transform( featureTransform );
+          pipelined.feature.setGeometry( g );
+        }
+        catch ( QgsCsException &e )
+        {
+          pipelined.transformError = e.what();
+        }
+      } );
+
+      for ( const PipelinedFeature &pipelined : preparing )
+      {
+        if ( pipelined.transformError.isEmpty() )
+          continue;
+
+        QString msg = QObject::tr( "Failed to transform a point while drawing a feature with ID '%1'. Writing stopped. (Exception: %2)" )
+                      .arg( pipelined.feature.id() ).arg( pipelined.transformError );
+        QgsLogger::warning( msg );
+        writeFuture.waitForFinished();
+        if ( errorMessage )
+          *errorMessage = msg;
+
+        return ErrProjection;
+      }
+    }
+
+    // prepared geometries may not be queried from several threads
+    if ( details.filterRectEngine )
+    {
+      for ( PipelinedFeature &pipelined : preparing )
+      {
+        pipelined.skipped = pipelined.feature.hasGeometry() && !details.filterRectEngine->intersects( pipelined.feature.geometry().constGet() );
+      }
+    }
+
+    {
+      QgsLocaleNumC l; // Make sure the decimal delimiter is a dot
+      Q_UNUSED( l )
+
+      QtConcurrent::blockingMap( indices, [this, &preparing]( const int &index )
+      {
+        PipelinedFeature &pipelined = preparing[index];
+        if ( !pipelined.skipped )
+          pipelined.ogrFeature = prepareFeature( pipelined.feature, pipelined.error );
+      } );
+    }
+
+    writeFuture.waitForFinished();
+    if ( stopped )
+      break;
+
+    std::swap( writing, preparing );
+    writeFuture = QtConcurrent::run( writeBatch );
+  }
+
+  writeFuture.waitForFinished();
+  return NoError;
+}
+
 double QgsVectorFileWriter::mmScaleFactor( double scale, QgsUnitTypes::RenderUnit symbolUnits, QgsUnitTypes::DistanceUnit mapUnits )
 {
   if ( symbolUnits == QgsUnitTypes::RenderMillimeters )
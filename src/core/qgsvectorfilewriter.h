@@ -288,6 +288,23 @@ class CORE_EXPORT QgsVectorFileWriter : public QgsFeatureSink
       AppendToLayerAddFields
     };
 
+    /**
+     * Enumeration to describe when the spatial index of a new layer is created, for formats
+     * whose spatial index can be built once all features are written (currently GeoPackage).
+     * \since QGIS 3.30
+     */
+    enum SpatialIndexCreation
+    {
+      //! The spatial index is updated by the format driver on each feature insertion
+      SpatialIndexOnInsert,
+
+      //! The spatial index is built in bulk once all features are written, when the writer is destroyed
+      SpatialIndexDeferred,
+
+      //! The spatial index is built in bulk by a background task, once the writer is destroyed
+      SpatialIndexInBackground
+    };
+
 #ifndef SIP_RUN
 
     /**
@@ -553,6 +570,16 @@ class CORE_EXPORT QgsVectorFileWriter : public QgsFeatureSink
          * \since QGIS 3.20
          */
         QgsLayerMetadata layerMetadata;
+
+        /**
+         * Controls when the spatial index of a new layer is created. Deferring the creation of the
+         * index avoids updating it on each insertion, which is faster for large layers.
+         *
+         * Layer options disabling the spatial index are respected.
+         *
+         * \since QGIS 3.30
+         */
+        QgsVectorFileWriter::SpatialIndexCreation spatialIndexCreation = QgsVectorFileWriter::SpatialIndexOnInsert;
     };
 
 #ifndef SIP_RUN
@@ -918,7 +945,7 @@ class CORE_EXPORT QgsVectorFileWriter : public QgsFeatureSink
 
   protected:
     //! \note not available in Python bindings
-    OGRGeometryH createEmptyGeometry( QgsWkbTypes::Type wkbType ) SIP_SKIP;
+    OGRGeometryH createEmptyGeometry( QgsWkbTypes::Type wkbType ) const SIP_SKIP;
 
     gdal::ogr_datasource_unique_ptr mDS;
     OGRLayerH mLayer = nullptr;
@@ -1042,12 +1069,40 @@ class CORE_EXPORT QgsVectorFileWriter : public QgsFeatureSink
     bool mUsingTransaction = false;
     QSet< QVariant::Type > mSupportedListSubTypes;
 
+    //! When the spatial index of the layer, created without one, is built
+    SpatialIndexCreation mSpatialIndexCreation = SpatialIndexOnInsert;
+    QString mSpatialIndexFileName;
+
+    //! Returns the layer options to use to create a layer without spatial index, if its creation is deferred
+    static QStringList layerOptionsForSpatialIndexCreation( const QStringList &layerOptions, const QString &driverName, QgsWkbTypes::Type geometryType,
+        ActionOnExistingFile action, SpatialIndexCreation spatialIndexCreation, bool &deferred );
+
     void createSymbolLayerTable( QgsVectorLayer *vl, const QgsCoordinateTransform &ct, OGRDataSourceH ds );
     gdal::ogr_feature_unique_ptr createFeature( const QgsFeature &feature );
+
+    /**
+     * Converts \a feature to an OGR feature, without setting the C numeric locale or the error state of the writer.
+     * Returns nullptr on failure, setting \a error when the failure is an error.
+     *
+     * Unless a field value converter or a coordinate transform is used by the writer, several
+     * threads can prepare features at the same time.
+     */
+    gdal::ogr_feature_unique_ptr prepareFeature( const QgsFeature &feature, QString &error ) const;
     bool writeFeature( OGRLayerH layer, OGRFeatureH feature );
 
     //! Writes features considering symbol level order
     QgsVectorFileWriter::WriterError exportFeaturesSymbolLevels( const PreparedWriterDetails &details, QgsFeatureIterator &fit, const QgsCoordinateTransform &ct, QString *errorMessage = nullptr );
+
+    //! Returns TRUE if exported features can be transformed and prepared on worker threads
+    bool canExportFeaturesPipelined() const;
+
+    /**
+     * Writes features by batches, which are transformed and prepared on worker threads while a
+     * dedicated thread writes the previous batch to the layer.
+     *
+     * The \a written and \a errors counts are set as for a sequential export.
+     */
+    QgsVectorFileWriter::WriterError exportFeaturesPipelined( PreparedWriterDetails &details, const SaveVectorOptions &options, QString *errorMessage, int &written, int &errors, int &lastProgressReport );
     double mmScaleFactor( double scale, QgsUnitTypes::RenderUnit symbolUnits, QgsUnitTypes::DistanceUnit mapUnits );
     double mapUnitScaleFactor( double scale, QgsUnitTypes::RenderUnit symbolUnits, QgsUnitTypes::DistanceUnit mapUnits );
 
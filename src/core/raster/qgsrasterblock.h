@@ -253,6 +253,25 @@ class CORE_EXPORT QgsRasterBlock
       return static_cast< const quint8 * >( mData );
     }
 
+#ifndef SIP_RUN
+
+    /**
+     * Calls \a function once with a QgsRasterBlockView over the values of the block, typed after
+     * the data type of the block.
+     *
+     * The \a function is a generic callable, e.g. a lambda taking a \c{const auto &view} argument, so
+     * that loops over the values are compiled for each data type and dispatched once for the whole
+     * block instead of once per pixel by value().
+     *
+     * \returns FALSE if the block data is not allocated or is of a color or complex data type, in which
+     * case \a function is not called.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    template <typename Function> bool visitValues( Function &&function ) const;
+#endif
+
     /**
      * \brief Read a single color
      *  \param row row index
@@ -652,6 +671,10 @@ class CORE_EXPORT QgsRasterBlock
     int height() const SIP_HOLDGIL { return mHeight; }
 
   private:
+#ifndef SIP_RUN
+    template <typename T> friend class QgsRasterBlockView;
+#endif
+
     static QImage::Format imageFormat( Qgis::DataType dataType );
     static Qgis::DataType dataType( QImage::Format format );
 
@@ -876,6 +899,114 @@ inline bool QgsRasterBlock::isNoDataValue( double value ) const SIP_SKIP
   return std::isnan( value ) || qgsDoubleNear( value, mNoDataValue );
 }
 
+#ifndef SIP_RUN
+
+/**
+ * \ingroup core
+ * \brief Typed read only access to the values of a QgsRasterBlock.
+ *
+ * The view reads the values of a block of data type \a T without the data type switch of
+ * QgsRasterBlock::value(). Views are obtained through QgsRasterBlock::visitValues().
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+template <typename T>
+class QgsRasterBlockView
+{
+  public:
+
+    /**
+     * Constructor for a view over the values of a \a block, which must be of the data type matching \a T.
+     */
+    explicit QgsRasterBlockView( const QgsRasterBlock *block )
+      : mBlock( block )
+      , mData( static_cast< const T * >( block->mData ) )
+      , mCount( static_cast< qgssize >( block->width() ) * block->height() )
+      , mHasNoDataValue( block->hasNoDataValue() )
+      , mHasNoDataBitmap( !block->hasNoDataValue() && block->hasNoData() )
+      , mNoDataValue( block->noDataValue() )
+    {}
+
+    //! Returns the number of values of the block.
+    qgssize count() const { return mCount; }
+
+    //! Returns the values of the block.
+    const T *data() const { return mData; }
+
+    //! Returns the value at the data matrix \a index.
+    T value( qgssize index ) const { return mData[index]; }
+
+    /**
+     * Returns the value at the data matrix \a index, with \a isNoData set to TRUE if the pixel
+     * represents a nodata value.
+     */
+    T valueAndNoData( qgssize index, bool &isNoData ) const
+    {
+      const T value = mData[index];
+      if ( mHasNoDataValue )
+        isNoData = std::isnan( static_cast< double >( value ) ) || qgsDoubleNear( static_cast< double >( value ), mNoDataValue );
+      else
+        isNoData = mHasNoDataBitmap && mBlock->isNoData( index );
+      return value;
+    }
+
+  private:
+    const QgsRasterBlock *mBlock = nullptr;
+    const T *mData = nullptr;
+    qgssize mCount = 0;
+    bool mHasNoDataValue = false;
+    bool mHasNoDataBitmap = false;
+    double mNoDataValue = 0;
+};
+
+template <typename Function>
+bool QgsRasterBlock::visitValues( Function &&function ) const
+{
+  if ( !mData )
+    return false;
+
+  switch ( mDataType )
+  {
+    case Qgis::DataType::Byte:
+      function( QgsRasterBlockView< quint8 >( this ) );
+      return true;
+    case Qgis::DataType::Int8:
+      function( QgsRasterBlockView< qint8 >( this ) );
+      return true;
+    case Qgis::DataType::UInt16:
+      function( QgsRasterBlockView< quint16 >( this ) );
+      return true;
+    case Qgis::DataType::Int16:
+      function( QgsRasterBlockView< qint16 >( this ) );
+      return true;
+    case Qgis::DataType::UInt32:
+      function( QgsRasterBlockView< quint32 >( this ) );
+      return true;
+    case Qgis::DataType::Int32:
+      function( QgsRasterBlockView< qint32 >( this ) );
+      return true;
+    case Qgis::DataType::Float32:
+      function( QgsRasterBlockView< float >( this ) );
+      return true;
+    case Qgis::DataType::Float64:
+      function( QgsRasterBlockView< double >( this ) );
+      return true;
+    case Qgis::DataType::CInt16:
+    case Qgis::DataType::CInt32:
+    case Qgis::DataType::CFloat32:
+    case Qgis::DataType::CFloat64:
+    case Qgis::DataType::ARGB32:
+    case Qgis::DataType::ARGB32_Premultiplied:
+    case Qgis::DataType::UnknownDataType:
+      break;
+  }
+  return false;
+}
+
+#endif
+
 #endif
 
 
+
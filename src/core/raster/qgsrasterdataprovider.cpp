@@ -30,9 +30,13 @@
 #include <QUrl>
 #include <QUrlQuery>
 #include <QSet>
+#include <algorithm>
 
 #define ERR(message) QgsError(message, "Raster provider")
 
+//! Size in pixels of the raster tiles whose points are sampled together by samplePoints()
+static constexpr int SAMPLE_TILE_SIZE = 256;
+
 void QgsRasterDataProvider::setUseSourceNoDataValue( int bandNo, bool use )
 {
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS
@@ -352,6 +356,157 @@ double QgsRasterDataProvider::sample( const QgsPointXY &point, int band,
   return value.toDouble( ok );
 }
 
+QVector<double> QgsRasterDataProvider::samplePoints( const QVector<QgsPointXY> &points, int band, bool bilinear, QgsRasterBlockFeedback *feedback )
+{
+  QGIS_PROTECT_QOBJECT_THREAD_ACCESS
+
+  QVector< double > values( points.size(), std::numeric_limits<double>::quiet_NaN() );
+  if ( points.isEmpty() || band < 1 || band > bandCount() )
+    return values;
+
+  const QgsRectangle rasterExtent = extent();
+  const int rasterWidth = xSize();
+  const int rasterHeight = ySize();
+  if ( !( capabilities() & Size ) || rasterWidth <= 0 || rasterHeight <= 0 )
+  {
+    // no native resolution to group the points by tiles
+    for ( int i = 0; i < points.size(); ++i )
+    {
+      if ( feedback && feedback->isCanceled() )
+        break;
+
+      bool ok = false;
+      const double value = sample( points.at( i ), band, &ok );
+      if ( ok )
+        values[i] = value;
+    }
+    return values;
+  }
+
+  const double pixelSizeX = rasterExtent.width() / rasterWidth;
+  const double pixelSizeY = rasterExtent.height() / rasterHeight;
+
+  // position of a point in pixels from the top left corner of the raster
+  struct PixelPosition
+  {
+    int index = 0;
+    double column = 0;
+    double row = 0;
+    int pixelColumn = 0;
+    int pixelRow = 0;
+    int tile = 0;
+  };
+
+  const int tileColumns = ( rasterWidth + SAMPLE_TILE_SIZE - 1 ) / SAMPLE_TILE_SIZE;
+  std::vector< PixelPosition > positions;
+  positions.reserve( points.size() );
+  for ( int i = 0; i < points.size(); ++i )
+  {
+    const QgsPointXY &point = points.at( i );
+    if ( !rasterExtent.contains( point ) )
+      continue;
+
+    PixelPosition position;
+    position.index = i;
+    position.column = ( point.x() - rasterExtent.xMinimum() ) / pixelSizeX;
+    position.row = ( rasterExtent.yMaximum() - point.y() ) / pixelSizeY;
+    position.pixelColumn = std::clamp( static_cast< int >( std::floor( position.column ) ), 0, rasterWidth - 1 );
+    position.pixelRow = std::clamp( static_cast< int >( std::floor( position.row ) ), 0, rasterHeight - 1 );
+    position.tile = ( position.pixelRow / SAMPLE_TILE_SIZE ) * tileColumns + position.pixelColumn / SAMPLE_TILE_SIZE;
+    positions.emplace_back( position );
+  }
+
+  std::stable_sort( positions.begin(), positions.end(), []( const PixelPosition & a, const PixelPosition & b ) { return a.tile < b.tile; } );
+
+  // the pixels around a point used for bilinear interpolation, between the pixel centers
+  auto bilinearPixels = [rasterWidth, rasterHeight]( const PixelPosition & position, int & column0, int & column1, int & row0, int & row1, double & dx, double & dy )
+  {
+    const double x = position.column - 0.5;
+    const double y = position.row - 0.5;
+    const int column = static_cast< int >( std::floor( x ) );
+    const int row = static_cast< int >( std::floor( y ) );
+    dx = x - column;
+    dy = y - row;
+    column0 = std::clamp( column, 0, rasterWidth - 1 );
+    column1 = std::clamp( column + 1, 0, rasterWidth - 1 );
+    row0 = std::clamp( row, 0, rasterHeight - 1 );
+    row1 = std::clamp( row + 1, 0, rasterHeight - 1 );
+  };
+
+  auto tileBegin = positions.cbegin();
+  while ( tileBegin != positions.cend() )
+  {
+    if ( feedback && feedback->isCanceled() )
+      break;
+
+    auto tileEnd = tileBegin;
+    int minColumn = rasterWidth;
+    int maxColumn = -1;
+    int minRow = rasterHeight;
+    int maxRow = -1;
+    for ( ; tileEnd != positions.cend() && tileEnd->tile == tileBegin->tile; ++tileEnd )
+    {
+      minColumn = std::min( minColumn, tileEnd->pixelColumn );
+      maxColumn = std::max( maxColumn, tileEnd->pixelColumn );
+      minRow = std::min( minRow, tileEnd->pixelRow );
+      maxRow = std::max( maxRow, tileEnd->pixelRow );
+      if ( bilinear )
+      {
+        int column0, column1, row0, row1;
+        double dx, dy;
+        bilinearPixels( *tileEnd, column0, column1, row0, row1, dx, dy );
+        minColumn = std::min( minColumn, column0 );
+        maxColumn = std::max( maxColumn, column1 );
+        minRow = std::min( minRow, row0 );
+        maxRow = std::max( maxRow, row1 );
+      }
+    }
+
+    // read the pixels needed by the points of the tile at once
+    const int blockWidth = maxColumn - minColumn + 1;
+    const int blockHeight = maxRow - minRow + 1;
+    const QgsRectangle blockExtent( rasterExtent.xMinimum() + minColumn * pixelSizeX,
+                                    rasterExtent.yMaximum() - ( maxRow + 1 ) * pixelSizeY,
+                                    rasterExtent.xMinimum() + ( maxColumn + 1 ) * pixelSizeX,
+                                    rasterExtent.yMaximum() - minRow * pixelSizeY );
+    const std::unique_ptr< QgsRasterBlock > rasterBlock( block( band, blockExtent, blockWidth, blockHeight, feedback ) );
+    if ( rasterBlock && rasterBlock->isValid() )
+    {
+      bool isNoData = false;
+      for ( auto it = tileBegin; it != tileEnd; ++it )
+      {
+        double value = rasterBlock->valueAndNoData( it->pixelRow - minRow, it->pixelColumn - minColumn, isNoData );
+        if ( isNoData )
+          continue;
+
+        if ( bilinear )
+        {
+          int column0, column1, row0, row1;
+          double dx, dy;
+          bilinearPixels( *it, column0, column1, row0, row1, dx, dy );
+          bool isNoData00 = false;
+          bool isNoData01 = false;
+          bool isNoData10 = false;
+          bool isNoData11 = false;
+          const double value00 = rasterBlock->valueAndNoData( row0 - minRow, column0 - minColumn, isNoData00 );
+          const double value01 = rasterBlock->valueAndNoData( row0 - minRow, column1 - minColumn, isNoData01 );
+          const double value10 = rasterBlock->valueAndNoData( row1 - minRow, column0 - minColumn, isNoData10 );
+          const double value11 = rasterBlock->valueAndNoData( row1 - minRow, column1 - minColumn, isNoData11 );
+          if ( !isNoData00 && !isNoData01 && !isNoData10 && !isNoData11 )
+          {
+            value = ( value00 * ( 1 - dx ) + value01 * dx ) * ( 1 - dy ) + ( value10 * ( 1 - dx ) + value11 * dx ) * dy;
+          }
+        }
+        values[ it->index ] = value;
+      }
+    }
+
+    tileBegin = tileEnd;
+  }
+
+  return values;
+}
+
 QString QgsRasterDataProvider::lastErrorFormat()
 {
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS
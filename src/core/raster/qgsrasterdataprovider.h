@@ -105,6 +105,7 @@ class CORE_EXPORT QgsRasterDataProvider : public QgsDataProvider, public QgsRast
       ReloadData = 1 << 5, //!< Is able to force reload data / clear local caches. Since QGIS 3.18, see QgsDataProvider::reloadProviderData()
       DpiDependentData = 1 << 6, //! Provider's rendering is dependent on requested pixel size of the viewport (since QGIS 3.20)
       NativeRasterAttributeTable = 1 << 7, //!< Indicates that the provider supports native raster attribute table (since QGIS 3.30)
+      ProviderHintCanReadInParallel = 1 << 8, //!< Provider clones can read blocks concurrently, so that parts of the raster can be rendered in parallel (since QGIS 3.30)
     };
 
     //! Provider capabilities
@@ -428,6 +429,25 @@ class CORE_EXPORT QgsRasterDataProvider : public QgsDataProvider, public QgsRast
                            bool *ok SIP_OUT = nullptr,
                            const QgsRectangle &boundingBox = QgsRectangle(), int width = 0, int height = 0, int dpi = 96 );
 
+    /**
+     * Samples the raster values from the specified \a band at a list of \a points.
+     *
+     * This is much more efficient than calling sample() for each point: the points are grouped by the
+     * raster tiles they fall in, and the pixels of each tile are read in a single block for all its points.
+     *
+     * If \a bilinear is TRUE, the values are interpolated between the centers of the four pixels nearest to
+     * each point. The value of the pixel containing the point is used when one of these pixels has no data.
+     *
+     * Providers without a native resolution (e.g. WMS) fall back to sampling each point at the highest resolution.
+     *
+     * \returns the values at the \a points, in their order, with NaN for the points outside the raster extent,
+     * on no data pixels, or for an invalid band number.
+     *
+     * \see sample()
+     * \since QGIS 3.30
+     */
+    virtual QVector< double > samplePoints( const QVector< QgsPointXY > &points, int band, bool bilinear = false, QgsRasterBlockFeedback *feedback = nullptr );
+
     /**
      * \brief Returns the caption error text for the last error in this provider
      *
@@ -24,6 +24,7 @@
 
 #include <QCoreApplication> // for tr()
 #include <QImage>
+#include <QMutex>
 
 #include "qgsfeedback.h"
 #include "qgsrasterbandstats.h"
@@ -84,7 +85,12 @@ class CORE_EXPORT QgsRasterBlockFeedback : public QgsFeedback
      * \see errors()
      * \since QGIS 3.8.0
      */
-    void appendError( const QString &error ) { mErrors.append( error ); }
+    void appendError( const QString &error )
+    {
+      // blocks may be read from several threads at once
+      const QMutexLocker locker( &mErrorsMutex );
+      mErrors.append( error );
+    }
 
     /**
      * Returns a list of any errors encountered while retrieving the raster block.
@@ -92,7 +98,11 @@ class CORE_EXPORT QgsRasterBlockFeedback : public QgsFeedback
      * \see appendError()
      * \since QGIS 3.8.0
      */
-    QStringList errors() const { return mErrors; }
+    QStringList errors() const
+    {
+      const QMutexLocker locker( &mErrorsMutex );
+      return mErrors;
+    }
 
     /**
      * Returns the render context of the associated block reading
@@ -123,6 +133,7 @@ class CORE_EXPORT QgsRasterBlockFeedback : public QgsFeedback
 
     //! List of errors encountered while retrieving block
     QStringList mErrors;
+    mutable QMutex mErrorsMutex;
 
     QgsRenderContext mRenderContext;
 };
@@ -18,6 +18,59 @@
 #include "qgsrasterviewport.h"
 #include "qgsrasterdataprovider.h"
 
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <deque>
+
+///@cond PRIVATE
+
+/**
+ * Copies of the input of an iterator which are not being read by a prefetching thread.
+ */
+class QgsRasterIteratorInputPool
+{
+  public:
+
+    explicit QgsRasterIteratorInputPool( const QList< QgsRasterInterface * > &inputs )
+      : mInputs( inputs )
+    {}
+
+    //! Takes an input, there is always one available as the pool has as many threads as inputs
+    QgsRasterInterface *take()
+    {
+      const QMutexLocker locker( &mMutex );
+      return mInputs.takeLast();
+    }
+
+    //! Gives back an \a input once it was read
+    void release( QgsRasterInterface *input )
+    {
+      const QMutexLocker locker( &mMutex );
+      mInputs.append( input );
+    }
+
+  private:
+
+    QMutex mMutex;
+    QList< QgsRasterInterface * > mInputs;
+};
+
+///@endcond
+
+//! Returns the data provider at the source of \a input
+static QgsRasterDataProvider *_inputProvider( QgsRasterInterface *input )
+{
+  for ( QgsRasterInterface *ri = input; ri; ri = ri->input() )
+  {
+    if ( QgsRasterDataProvider *provider = dynamic_cast< QgsRasterDataProvider * >( ri ) )
+      return provider;
+  }
+  return nullptr;
+}
+
 QgsRasterIterator::QgsRasterIterator( QgsRasterInterface *input )
   : mInput( input )
   , mMaximumTileWidth( DEFAULT_MAXIMUM_TILE_WIDTH )
@@ -35,6 +88,11 @@ QgsRasterIterator::QgsRasterIterator( QgsRasterInterface *input )
   }
 }
 
+QgsRasterIterator::~QgsRasterIterator()
+{
+  discardPrefetchedParts( -1 );
+}
+
 QgsRectangle QgsRasterIterator::subRegion( const QgsRectangle &rasterExtent, int rasterWidth, int rasterHeight, const QgsRectangle &subRegion, int &subRegionWidth, int &subRegionHeight, int &subRegionLeft, int &subRegionTop )
 {
   const double xRes = rasterExtent.width() / rasterWidth;
@@ -93,7 +151,44 @@ void QgsRasterIterator::startRasterRead( int bandNumber, qgssize nCols, qgssize
   pInfo.nRows = nRows;
   pInfo.currentCol = 0;
   pInfo.currentRow = 0;
+  pInfo.tileWidth = 0;
+  pInfo.tileHeight = 0;
+
+  // at the native resolution, parts covering whole blocks of the input avoid reading a block for several parts
+  if ( mAlignToInputBlocks && nCols == static_cast< qgssize >( mInput->xSize() ) && nRows == static_cast< qgssize >( mInput->ySize() ) )
+  {
+    const int xBlockSize = mInput->xBlockSize();
+    const int yBlockSize = mInput->yBlockSize();
+    if ( xBlockSize > 0 && xBlockSize < mMaximumTileWidth )
+      pInfo.tileWidth = mMaximumTileWidth / xBlockSize * xBlockSize;
+    if ( yBlockSize > 0 && yBlockSize < mMaximumTileHeight )
+      pInfo.tileHeight = mMaximumTileHeight / yBlockSize * yBlockSize;
+  }
   mRasterPartInfos.insert( bandNumber, pInfo );
+
+  if ( mPrefetchCount > 0 && !mPrefetchThreadPool )
+  {
+    if ( !mPrefetchInputs.isEmpty() )
+    {
+      // each copy of the input is read by its own thread
+      mPrefetchInputPool = std::make_shared< QgsRasterIteratorInputPool >( mPrefetchInputs );
+      mPrefetchThreadPool = std::make_unique< QThreadPool >();
+      mPrefetchThreadPool->setMaxThreadCount( mPrefetchInputs.size() );
+    }
+    // providers are not thread safe, the parts are prefetched through a clone of the provider
+    else if ( QgsRasterDataProvider *provider = dynamic_cast< QgsRasterDataProvider * >( mInput ) )
+    {
+      if ( QgsRasterDataProvider *clone = provider->clone() )
+      {
+        clone->moveToThread( nullptr );
+        mPrefetchInput.reset( clone );
+        mPrefetchInputPool = std::make_shared< QgsRasterIteratorInputPool >( QList< QgsRasterInterface * >() << clone );
+        mPrefetchThreadPool = std::make_unique< QThreadPool >();
+        // a single thread reads the parts in the order of the iteration
+        mPrefetchThreadPool->setMaxThreadCount( 1 );
+      }
+    }
+  }
 }
 
 bool QgsRasterIterator::next( int bandNumber, int &columns, int &rows, int &topLeftColumn, int &topLeftRow, QgsRectangle &blockExtent )
@@ -147,41 +242,193 @@ bool QgsRasterIterator::readNextRasterPartInternal( int bandNumber, int &nCols,
     return false;
   }
 
-  //read data block
-  nCols = static_cast< int >( std::min( static_cast< qgssize >( mMaximumTileWidth ), pInfo.nCols - pInfo.currentCol ) );
-  nRows = static_cast< int >( std::min( static_cast< qgssize >( mMaximumTileHeight ), pInfo.nRows - pInfo.currentRow ) );
+  const QgsRectangle blockRect = partExtent( pInfo, pInfo.currentCol, pInfo.currentRow, nCols, nRows );
   QgsDebugMsgLevel( QStringLiteral( "nCols = %1 nRows = %2" ).arg( nCols ).arg( nRows ), 4 );
 
-  //get subrectangle
-  const QgsRectangle viewPortExtent = mExtent;
-  const double xmin = viewPortExtent.xMinimum() + pInfo.currentCol / static_cast< double >( pInfo.nCols ) * viewPortExtent.width();
-  const double xmax = pInfo.currentCol + nCols == pInfo.nCols ? viewPortExtent.xMaximum() :  // avoid extra FP math if not necessary
-                      viewPortExtent.xMinimum() + ( pInfo.currentCol + nCols ) / static_cast< double >( pInfo.nCols ) * viewPortExtent.width();
-  const double ymin = pInfo.currentRow + nRows == pInfo.nRows ? viewPortExtent.yMinimum() :  // avoid extra FP math if not necessary
-                      viewPortExtent.yMaximum() - ( pInfo.currentRow + nRows ) / static_cast< double >( pInfo.nRows ) * viewPortExtent.height();
-  const double ymax = viewPortExtent.yMaximum() - pInfo.currentRow / static_cast< double >( pInfo.nRows ) * viewPortExtent.height();
-  const QgsRectangle blockRect( xmin, ymin, xmax, ymax );
-
   if ( blockExtent )
     *blockExtent = blockRect;
 
-  if ( block )
-    block->reset( mInput->block( bandNumber, blockRect, nCols, nRows, mFeedback ) );
+  bool prefetched = false;
+  for ( auto it = mPrefetchedParts.begin(); it != mPrefetchedParts.end(); ++it )
+  {
+    if ( it->bandNumber != bandNumber )
+      continue;
+
+    // the first part prefetched for the band is the current part, unless the iteration was restarted
+    if ( block && it->col == pInfo.currentCol && it->row == pInfo.currentRow )
+    {
+      block->reset( it->block.result() );
+      mPrefetchedParts.erase( it );
+      prefetched = true;
+    }
+    else if ( !block && it->col == pInfo.currentCol && it->row == pInfo.currentRow )
+    {
+      it->block.waitForFinished();
+      delete it->block.result();
+      mPrefetchedParts.erase( it );
+    }
+    else
+    {
+      discardPrefetchedParts( bandNumber );
+    }
+    break;
+  }
+
   topLeftCol = pInfo.currentCol;
   topLeftRow = pInfo.currentRow;
 
-  pInfo.currentCol += nCols;
-  if ( pInfo.currentCol == pInfo.nCols && pInfo.currentRow + nRows == pInfo.nRows ) //end of raster
+  advance( pInfo, pInfo.currentCol, pInfo.currentRow, nCols, nRows );
+
+  // the next parts are read while the current part is read or processed
+  if ( block && mPrefetchInputPool )
+    prefetchParts( bandNumber, pInfo );
+
+  if ( block && !prefetched )
+    block->reset( mInput->block( bandNumber, blockRect, nCols, nRows, mFeedback ) );
+
+  return true;
+}
+
+QgsRectangle QgsRasterIterator::partExtent( const RasterPartInfo &info, qgssize col, qgssize row, int &nCols, int &nRows ) const
+{
+  const int tileWidth = info.tileWidth > 0 ? info.tileWidth : mMaximumTileWidth;
+  const int tileHeight = info.tileHeight > 0 ? info.tileHeight : mMaximumTileHeight;
+  nCols = static_cast< int >( std::min( static_cast< qgssize >( tileWidth ), info.nCols - col ) );
+  nRows = static_cast< int >( std::min( static_cast< qgssize >( tileHeight ), info.nRows - row ) );
+
+  //get subrectangle
+  const QgsRectangle viewPortExtent = mExtent;
+  const double xmin = viewPortExtent.xMinimum() + col / static_cast< double >( info.nCols ) * viewPortExtent.width();
+  const double xmax = col + nCols == info.nCols ? viewPortExtent.xMaximum() :  // avoid extra FP math if not necessary
+                      viewPortExtent.xMinimum() + ( col + nCols ) / static_cast< double >( info.nCols ) * viewPortExtent.width();
+  const double ymin = row + nRows == info.nRows ? viewPortExtent.yMinimum() :  // avoid extra FP math if not necessary
+                      viewPortExtent.yMaximum() - ( row + nRows ) / static_cast< double >( info.nRows ) * viewPortExtent.height();
+  const double ymax = viewPortExtent.yMaximum() - row / static_cast< double >( info.nRows ) * viewPortExtent.height();
+  return QgsRectangle( xmin, ymin, xmax, ymax );
+}
+
+void QgsRasterIterator::advance( const RasterPartInfo &info, qgssize &col, qgssize &row, int nCols, int nRows )
+{
+  col += nCols;
+  if ( col == info.nCols && row + nRows == info.nRows ) //end of raster
   {
-    pInfo.currentRow = pInfo.nRows;
+    row = info.nRows;
   }
-  else if ( pInfo.currentCol == pInfo.nCols ) //start new row
+  else if ( col == info.nCols ) //start new row
   {
-    pInfo.currentCol = 0;
-    pInfo.currentRow += nRows;
+    col = 0;
+    row += nRows;
   }
+}
 
-  return true;
+void QgsRasterIterator::prefetchParts( int bandNumber, const RasterPartInfo &info )
+{
+  // skip the parts already prefetched, which directly follow the current part
+  qgssize col = info.currentCol;
+  qgssize row = info.currentRow;
+  int nCols = 0;
+  int nRows = 0;
+  int count = 0;
+  for ( const PrefetchedPart &part : std::as_const( mPrefetchedParts ) )
+  {
+    if ( part.bandNumber != bandNumber )
+      continue;
+    partExtent( info, col, row, nCols, nRows );
+    advance( info, col, row, nCols, nRows );
+    ++count;
+  }
+
+  for ( ; count < mPrefetchCount && !( col == info.nCols && row == info.nRows ); ++count )
+  {
+    const QgsRectangle extent = partExtent( info, col, row, nCols, nRows );
+
+    PrefetchedPart part;
+    part.bandNumber = bandNumber;
+    part.col = col;
+    part.row = row;
+    const std::shared_ptr< QgsRasterIteratorInputPool > inputPool = mPrefetchInputPool;
+    QgsRasterBlockFeedback *feedback = mFeedback;
+    part.block = QtConcurrent::run( mPrefetchThreadPool.get(), [inputPool, bandNumber, extent, nCols, nRows, feedback]() -> QgsRasterBlock *
+    {
+      QgsRasterInterface *input = inputPool->take();
+      QgsRasterDataProvider *provider = _inputProvider( input );
+      if ( provider )
+        provider->moveToThread( QThread::currentThread() );
+
+      QgsRasterBlock *block = input->block( bandNumber, extent, nCols, nRows, feedback );
+
+      if ( provider )
+        provider->moveToThread( nullptr );
+      inputPool->release( input );
+      return block;
+    } );
+    mPrefetchedParts.append( part );
+
+    advance( info, col, row, nCols, nRows );
+  }
+}
+
+void QgsRasterIterator::discardPrefetchedParts( int bandNumber )
+{
+  for ( auto it = mPrefetchedParts.begin(); it != mPrefetchedParts.end(); )
+  {
+    if ( bandNumber < 0 || it->bandNumber == bandNumber )
+    {
+      it->block.waitForFinished();
+      delete it->block.result();
+      it = mPrefetchedParts.erase( it );
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+bool QgsRasterIterator::processRasterParts( int bandNumber, const std::function<bool ( const QgsRasterBlock *, int, int, const QgsRectangle & )> &function, int threadCount )
+{
+  QThreadPool threadPool;
+  threadPool.setMaxThreadCount( threadCount > 0 ? threadCount : QThreadPool::globalInstance()->maxThreadCount() );
+
+  // the parts being processed, at most two per thread so that they are not all held in memory
+  std::deque< QFuture< bool > > futures;
+  const size_t maxPendingParts = 2 * static_cast< size_t >( threadPool.maxThreadCount() );
+  bool result = true;
+
+  int nCols = 0;
+  int nRows = 0;
+  int topLeftCol = 0;
+  int topLeftRow = 0;
+  QgsRectangle blockExtent;
+  std::unique_ptr< QgsRasterBlock > block;
+  while ( result && readNextRasterPart( bandNumber, nCols, nRows, block, topLeftCol, topLeftRow, &blockExtent ) )
+  {
+    if ( mFeedback && mFeedback->isCanceled() )
+    {
+      result = false;
+      break;
+    }
+
+    std::shared_ptr< QgsRasterBlock > partBlock( block.release() );
+    futures.emplace_back( QtConcurrent::run( &threadPool, [&function, partBlock, topLeftCol, topLeftRow, blockExtent]()
+    {
+      return function( partBlock.get(), topLeftCol, topLeftRow, blockExtent );
+    } ) );
+
+    while ( futures.size() >= maxPendingParts || ( !futures.empty() && futures.front().isFinished() ) )
+    {
+      result = futures.front().result() && result;
+      futures.pop_front();
+    }
+  }
+
+  for ( QFuture< bool > &future : futures )
+    result = future.result() && result;
+
+  if ( mFeedback && mFeedback->isCanceled() )
+    result = false;
+
+  return result;
 }
 
 void QgsRasterIterator::stopRasterRead( int bandNumber )
@@ -191,6 +438,8 @@ void QgsRasterIterator::stopRasterRead( int bandNumber )
 
 void QgsRasterIterator::removePartInfo( int bandNumber )
 {
+  discardPrefetchedParts( bandNumber );
+
   const auto partIt = mRasterPartInfos.constFind( bandNumber );
   if ( partIt != mRasterPartInfos.constEnd() )
   {
@@ -19,13 +19,19 @@
 #include "qgsrectangle.h"
 #include "qgis_sip.h"
 #include <QMap>
+#include <QFuture>
+
+#include <functional>
+#include <memory>
 
 class QgsMapToPixel;
 class QgsRasterBlock;
 class QgsRasterBlockFeedback;
 class QgsRasterInterface;
+class QgsRasterIteratorInputPool;
 class QgsRasterProjector;
 struct QgsRasterViewPort;
+class QThreadPool;
 
 /**
  * \ingroup core
@@ -40,6 +46,15 @@ class CORE_EXPORT QgsRasterIterator
      */
     QgsRasterIterator( QgsRasterInterface *input );
 
+    ~QgsRasterIterator();
+
+#ifndef SIP_RUN
+    //! QgsRasterIterator cannot be copied
+    QgsRasterIterator( const QgsRasterIterator &other ) = delete;
+    //! QgsRasterIterator cannot be copied
+    QgsRasterIterator &operator=( const QgsRasterIterator &other ) = delete;
+#endif
+
     /**
      * Given an overall raster extent and width and height in pixels, calculates the sub region
      * of the raster covering the specified \a subRegion.
@@ -125,6 +140,26 @@ class CORE_EXPORT QgsRasterIterator
                              int &topLeftCol, int &topLeftRow,
                              QgsRectangle *blockExtent = nullptr ) SIP_SKIP;
 
+    /**
+     * Reads all the remaining parts of the raster band started with startRasterRead(), and calls
+     * \a function for each of them, from up to \a threadCount threads. A negative \a threadCount
+     * uses as many threads as the global thread pool.
+     *
+     * The parts are read by the calling thread (or by the prefetching thread, see setPrefetchCount()),
+     * while the \a function processes the previous parts in parallel, so the \a function must
+     * be thread safe. It receives the block of the part, its top left column and row, and its extent,
+     * and can return FALSE to stop the iteration.
+     *
+     * Returns FALSE if the iteration was stopped by \a function or canceled through the feedback
+     * passed to startRasterRead().
+     *
+     * \note Not available in Python bindings
+     * \since QGIS 3.30
+     */
+    bool processRasterParts( int bandNumber,
+                             const std::function< bool( const QgsRasterBlock *block, int topLeftCol, int topLeftRow, const QgsRectangle &blockExtent ) > &function,
+                             int threadCount = -1 ) SIP_SKIP;
+
     /**
      * Cancels the raster iteration and resets the iterator.
      */
@@ -163,6 +198,66 @@ class CORE_EXPORT QgsRasterIterator
      */
     int maximumTileHeight() const { return mMaximumTileHeight; }
 
+    /**
+     * Sets the number of parts read in advance by readNextRasterPart(), on a background
+     * thread while the caller processes the current part.
+     *
+     * Parts are only prefetched when the input of the iterator is a raster data provider, which
+     * is read through a clone of the provider. A \a count of 0 (the default) disables prefetching.
+     *
+     * Must be set before startRasterRead() is called.
+     *
+     * \see prefetchCount()
+     * \since QGIS 3.30
+     */
+    void setPrefetchCount( int count ) { mPrefetchCount = count; }
+
+    /**
+     * Returns the number of parts read in advance by readNextRasterPart().
+     *
+     * \see setPrefetchCount()
+     * \since QGIS 3.30
+     */
+    int prefetchCount() const { return mPrefetchCount; }
+
+    /**
+     * Sets copies of the input of the iterator, such as the last interfaces of copies of a raster pipe,
+     * used to read parts in advance concurrently, each copy on its own thread.
+     *
+     * Parts are then prefetched for any input of the iterator, and not only for raster data providers.
+     * The copies must produce the same blocks as the input, and stay valid until the iteration ends. The
+     * data providers of the copies must not have any thread affinity (see QObject::moveToThread()), as
+     * they are moved to the thread reading them.
+     *
+     * Must be set before startRasterRead() is called, along with a prefetch count at least as large as
+     * the number of \a inputs.
+     *
+     * \see setPrefetchCount()
+     * \note Not available in Python bindings
+     * \since QGIS 3.30
+     */
+    void setPrefetchInputs( const QList< QgsRasterInterface * > &inputs ) SIP_SKIP { mPrefetchInputs = inputs; }
+
+    /**
+     * Sets whether the size of the parts should be a multiple of the size of the blocks of the input
+     * (see QgsRasterInterface::xBlockSize()), when the raster is read at its native resolution, so that
+     * each block of the input is read at once.
+     *
+     * Must be set before startRasterRead() is called.
+     *
+     * \see alignToInputBlocks()
+     * \since QGIS 3.30
+     */
+    void setAlignToInputBlocks( bool align ) { mAlignToInputBlocks = align; }
+
+    /**
+     * Returns TRUE if the size of the parts is a multiple of the size of the blocks of the input.
+     *
+     * \see setAlignToInputBlocks()
+     * \since QGIS 3.30
+     */
+    bool alignToInputBlocks() const { return mAlignToInputBlocks; }
+
     //! Default maximum tile width
     static const int DEFAULT_MAXIMUM_TILE_WIDTH = 2000;
 
@@ -177,6 +272,17 @@ class CORE_EXPORT QgsRasterIterator
       qgssize currentRow;
       qgssize nCols;
       qgssize nRows;
+      int tileWidth;
+      int tileHeight;
+    };
+
+    //! A part being read in advance
+    struct PrefetchedPart
+    {
+      int bandNumber = 0;
+      qgssize col = 0;
+      qgssize row = 0;
+      QFuture< QgsRasterBlock * > block;
     };
 
     QgsRasterInterface *mInput = nullptr;
@@ -187,9 +293,29 @@ class CORE_EXPORT QgsRasterIterator
     int mMaximumTileWidth;
     int mMaximumTileHeight;
 
+    int mPrefetchCount = 0;
+    bool mAlignToInputBlocks = false;
+    //! Clone of the input provider, read by the prefetching thread
+    std::unique_ptr< QgsRasterInterface > mPrefetchInput;
+    //! Copies of the input, read by the prefetching threads
+    QList< QgsRasterInterface * > mPrefetchInputs;
+    //! The copies of the input which are not being read
+    std::shared_ptr< QgsRasterIteratorInputPool > mPrefetchInputPool;
+    std::unique_ptr< QThreadPool > mPrefetchThreadPool;
+    QList< PrefetchedPart > mPrefetchedParts;
+
     //! Remove part into and release memory
     void removePartInfo( int bandNumber );
     bool readNextRasterPartInternal( int bandNumber, int &nCols, int &nRows, std::unique_ptr<QgsRasterBlock> *block, int &topLeftCol, int &topLeftRow, QgsRectangle *blockExtent );
+
+    //! Calculates the size and extent of the part of \a info starting at \a col and \a row
+    QgsRectangle partExtent( const RasterPartInfo &info, qgssize col, qgssize row, int &nCols, int &nRows ) const;
+    //! Moves \a col and \a row to the part following the part of size \a nCols x \a nRows
+    static void advance( const RasterPartInfo &info, qgssize &col, qgssize &row, int nCols, int nRows );
+    //! Starts reading the parts following the current part of \a info, up to the prefetch count
+    void prefetchParts( int bandNumber, const RasterPartInfo &info );
+    //! Waits for the prefetched parts of \a bandNumber, or of all bands if \a bandNumber is -1, and discards them
+    void discardPrefetchedParts( int bandNumber );
 };
 
 #endif // QGSRASTERITERATOR_H
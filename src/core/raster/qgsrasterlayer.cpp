@@ -726,7 +726,11 @@ void QgsRasterLayer::setDataProvider( QString const &provider, const QgsDataProv
   if ( QgsApplication::profiler()->groupIsActive( QStringLiteral( "projectload" ) ) )
     profile = std::make_unique< QgsScopedRuntimeProfile >( tr( "Create %1 provider" ).arg( provider ), QStringLiteral( "projectload" ) );
 
-  mDataProvider = qobject_cast< QgsRasterDataProvider * >( QgsProviderRegistry::instance()->createProvider( mProviderKey, mDataSource, options, flags ) );
+  std::unique_ptr< QgsDataProvider > preloadedProvider( takePreloadedProvider( mProviderKey, mDataSource ) );
+  if ( qobject_cast< QgsRasterDataProvider * >( preloadedProvider.get() ) )
+    mDataProvider = qobject_cast< QgsRasterDataProvider * >( preloadedProvider.release() );
+  else
+    mDataProvider = qobject_cast< QgsRasterDataProvider * >( QgsProviderRegistry::instance()->createProvider( mProviderKey, mDataSource, options, flags ) );
   if ( !mDataProvider )
   {
     //QgsMessageLog::logMessage( tr( "Cannot instantiate the data provider" ), tr( "Raster" ) );
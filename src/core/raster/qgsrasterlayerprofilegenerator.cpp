@@ -173,6 +173,40 @@ bool QgsRasterLayerProfileGenerator::generateProfile( const QgsProfileGeneration
   if ( mFeedback->isCanceled() )
     return false;
 
+  // when the raster has a native resolution, the points along the curve are sampled at once, reading
+  // each raster tile a single time for all the points it contains
+  const bool samplePointsInBulk = !std::isnan( stepDistance ) && mRasterProvider->xSize() > 0 && mRasterProvider->ySize() > 0;
+  if ( samplePointsInBulk )
+  {
+    QVector< QgsPointXY > points;
+    points.reserve( profilePoints.size() );
+    for ( const QgsPointXY &point : std::as_const( profilePoints ) )
+      points << point;
+
+    const QVector< double > values = mRasterProvider->samplePoints( points, mBand, false, mFeedback.get() );
+    if ( mFeedback->isCanceled() )
+      return false;
+
+    const QgsRectangle rasterExtent = mRasterProvider->extent();
+    for ( int i = 0; i < points.size(); ++i )
+    {
+      if ( !rasterExtent.contains( points.at( i ) ) )
+        continue;
+
+      const double val = values.at( i );
+      QgsPoint pixel( points.at( i ).x(), points.at( i ).y(), std::isnan( val ) ? std::numeric_limits<double>::quiet_NaN() : val * mScale + mOffset );
+      try
+      {
+        pixel.transform( rasterToTargetTransform );
+      }
+      catch ( QgsCsException & )
+      {
+        continue;
+      }
+      mResults->mRawPoints.append( pixel );
+    }
+  }
+
   // calculate the portion of the raster which actually covers the curve
   int subRegionWidth = 0;
   int subRegionHeight = 0;
@@ -216,7 +250,7 @@ bool QgsRasterLayerProfileGenerator::generateProfile( const QgsProfileGeneration
   int blockTopLeftRow = 0;
   QgsRectangle blockExtent;
 
-  while ( it.next( mBand, blockColumns, blockRows, blockTopLeftColumn, blockTopLeftRow, blockExtent ) )
+  while ( !samplePointsInBulk && it.next( mBand, blockColumns, blockRows, blockTopLeftColumn, blockTopLeftRow, blockExtent ) )
   {
     if ( mFeedback->isCanceled() )
       return false;
@@ -35,6 +35,10 @@
 #include <QElapsedTimer>
 #include <QPointer>
 #include <QThread>
+#include <QThreadPool>
+
+//! Minimum height in pixels of the parts of a raster rendered in parallel
+static const int MINIMUM_PARALLEL_PART_HEIGHT = 256;
 
 ///@cond PRIVATE
 
@@ -361,8 +365,38 @@ bool QgsRasterLayerRenderer::render()
   // important -- disable SmoothPixmapTransform for raster layer renders. We want individual pixels to be clearly defined!
   renderContext()->painter()->setRenderHint( QPainter::SmoothPixmapTransform, false );
 
-  // Drawer to pipe?
+  // when the provider can be read concurrently, the parts of the raster are rendered in parallel
+  // through copies of the pipe, while the parts already rendered are drawn
+  std::vector< std::unique_ptr< QgsRasterPipe > > partPipes;
   QgsRasterIterator iterator( mPipe->last() );
+  const int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+  if ( threadCount > 1 && ( mPipe->provider()->providerCapabilities() & QgsRasterDataProvider::ProviderHintCanReadInParallel ) )
+  {
+    const int width = static_cast< int >( mRasterViewPort->mWidth );
+    const int height = static_cast< int >( mRasterViewPort->mHeight );
+    const int partHeight = std::max( MINIMUM_PARALLEL_PART_HEIGHT, static_cast< int >( std::ceil( height / static_cast< double >( threadCount ) ) ) );
+    if ( partHeight < iterator.maximumTileHeight() )
+      iterator.setMaximumTileHeight( partHeight );
+
+    const int columnCount = iterator.maximumTileWidth() > 0 ? static_cast< int >( std::ceil( width / static_cast< double >( iterator.maximumTileWidth() ) ) ) : 1;
+    const int rowCount = static_cast< int >( std::ceil( height / static_cast< double >( iterator.maximumTileHeight() ) ) );
+    // the first part is rendered by this thread
+    const int pipeCount = std::min( threadCount, columnCount * rowCount - 1 );
+    QList< QgsRasterInterface * > partInputs;
+    for ( int i = 0; i < pipeCount; ++i )
+    {
+      std::unique_ptr< QgsRasterPipe > pipe = std::make_unique< QgsRasterPipe >( *mPipe );
+      pipe->moveToThread( nullptr );
+      partInputs << pipe->last();
+      partPipes.emplace_back( std::move( pipe ) );
+    }
+    if ( !partInputs.isEmpty() )
+    {
+      iterator.setPrefetchInputs( partInputs );
+      iterator.setPrefetchCount( partInputs.size() );
+    }
+  }
+
   QgsRasterDrawer drawer( &iterator );
   drawer.draw( *( renderContext() ), mRasterViewPort, mFeedback );
 
@@ -100,28 +100,26 @@ QgsRasterBlock *QgsRasterNuller::block( int bandNo, QgsRectangle  const &extent,
     outputBlock->setNoDataValue( noDataValue );
   }
 
-  bool isNoData = false;
-  for ( int i = 0; i < height; i++ )
+  const QgsRasterRangeList noData = mNoData.value( bandNo - 1 );
+  const qgssize count = static_cast< qgssize >( width ) * height;
+  if ( !outputBlock->bits() || !inputBlock->bits() )
   {
-    for ( int j = 0; j < width; j++ )
-    {
-      const double value = inputBlock->valueAndNoData( i, j, isNoData );
+    return outputBlock.release();
+  }
 
-      if ( QgsRasterRange::contains( value, mNoData.value( bandNo - 1 ) ) )
-      {
-        isNoData = true;
-      }
-      outputBlock->setValue( i, j, inputBlock->value( i, j ) );
-      if ( isNoData )
-      {
-        outputBlock->setIsNoData( i, j );
-      }
-      else
+  memcpy( outputBlock->bits(), inputBlock->bits(), count * outputBlock->dataTypeSize() );
+  inputBlock->visitValues( [&]( const auto & view )
+  {
+    bool isNoData = false;
+    for ( qgssize i = 0; i < count; i++ )
+    {
+      const double value = view.valueAndNoData( i, isNoData );
+      if ( isNoData || QgsRasterRange::contains( value, noData ) )
       {
-        outputBlock->setValue( i, j, value );
+        outputBlock->setIsNoData( i );
       }
     }
-  }
+  } );
   return outputBlock.release();
 }
 
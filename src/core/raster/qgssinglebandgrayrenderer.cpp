@@ -135,50 +135,57 @@ QgsRasterBlock *QgsSingleBandGrayRenderer::block( int bandNo, const QgsRectangle
   }
 
   const QRgb myDefaultColor = renderColorForNodataPixel();
-  bool isNoData = false;
-  for ( qgssize i = 0; i < ( qgssize )width * height; i++ )
+  const bool shaded = inputBlock->visitValues( [&]( const auto & view )
   {
-    double grayVal = inputBlock->valueAndNoData( i, isNoData );
-
-    if ( isNoData )
-    {
-      outputBlock->setColor( i, myDefaultColor );
-      continue;
-    }
-
-    double currentAlpha = mOpacity;
-    if ( mRasterTransparency )
+    bool isNoData = false;
+    for ( qgssize i = 0; i < view.count(); i++ )
     {
-      currentAlpha = mRasterTransparency->alphaValue( grayVal, mOpacity * 255 ) / 255.0;
-    }
-    if ( mAlphaBand > 0 )
-    {
-      currentAlpha *= alphaBlock->value( i ) / 255.0;
-    }
+      double grayVal = view.valueAndNoData( i, isNoData );
 
-    if ( mContrastEnhancement )
-    {
-      if ( !mContrastEnhancement->isValueInDisplayableRange( grayVal ) )
+      if ( isNoData )
       {
         outputBlock->setColor( i, myDefaultColor );
         continue;
       }
-      grayVal = mContrastEnhancement->enhanceContrast( grayVal );
-    }
 
-    if ( mGradient == WhiteToBlack )
-    {
-      grayVal = 255 - grayVal;
-    }
+      double currentAlpha = mOpacity;
+      if ( mRasterTransparency )
+      {
+        currentAlpha = mRasterTransparency->alphaValue( grayVal, mOpacity * 255 ) / 255.0;
+      }
+      if ( mAlphaBand > 0 )
+      {
+        currentAlpha *= alphaBlock->value( i ) / 255.0;
+      }
 
-    if ( qgsDoubleNear( currentAlpha, 1.0 ) )
-    {
-      outputBlock->setColor( i, qRgba( grayVal, grayVal, grayVal, 255 ) );
-    }
-    else
-    {
-      outputBlock->setColor( i, qRgba( currentAlpha * grayVal, currentAlpha * grayVal, currentAlpha * grayVal, currentAlpha * 255 ) );
+      if ( mContrastEnhancement )
+      {
+        if ( !mContrastEnhancement->isValueInDisplayableRange( grayVal ) )
+        {
+          outputBlock->setColor( i, myDefaultColor );
+          continue;
+        }
+        grayVal = mContrastEnhancement->enhanceContrast( grayVal );
+      }
+
+      if ( mGradient == WhiteToBlack )
+      {
+        grayVal = 255 - grayVal;
+      }
+
+      if ( qgsDoubleNear( currentAlpha, 1.0 ) )
+      {
+        outputBlock->setColor( i, qRgba( grayVal, grayVal, grayVal, 255 ) );
+      }
+      else
+      {
+        outputBlock->setColor( i, qRgba( currentAlpha * grayVal, currentAlpha * grayVal, currentAlpha * grayVal, currentAlpha * 255 ) );
+      }
     }
+  } );
+  if ( !shaded )
+  {
+    outputBlock->setIsNoData();
   }
 
   return outputBlock.release();
@@ -28,6 +28,8 @@
 #include <QDomElement>
 #include <QImage>
 
+#include <vector>
+
 QgsSingleBandPseudoColorRenderer::QgsSingleBandPseudoColorRenderer( QgsRasterInterface *input, int band, QgsRasterShader *shader )
   : QgsRasterRenderer( input, QStringLiteral( "singlebandpseudocolor" ) )
   , mShader( shader )
@@ -196,6 +198,59 @@ QgsRasterRenderer *QgsSingleBandPseudoColorRenderer::create( const QDomElement &
   return r;
 }
 
+///@cond PRIVATE
+
+// Colors the pixels of an integer block from a table of the colors of all the values
+// between the minimum and the maximum of the block. Returns FALSE when the range of
+// values is wider than the block, as computing the table would then cost more than
+// shading each pixel.
+template <typename T, typename ShadeFunction>
+static bool _shadeThroughLookupTable( const T *data, qgssize count, const QgsRasterBlock *block, QRgb *output, QRgb noDataColor, const ShadeFunction &shade )
+{
+  if ( count == 0 )
+    return false;
+
+  T min = data[0];
+  T max = data[0];
+  for ( qgssize i = 1; i < count; ++i )
+  {
+    min = std::min( min, data[i] );
+    max = std::max( max, data[i] );
+  }
+
+  const qgssize size = static_cast< qgssize >( static_cast< qint64 >( max ) - min ) + 1;
+  if ( size > count )
+    return false;
+
+  const bool hasNoDataValue = block->hasNoDataValue();
+  const double noDataValue = block->noDataValue();
+  std::vector< QRgb > table( size );
+  for ( qgssize j = 0; j < size; ++j )
+  {
+    const double value = static_cast< double >( min ) + static_cast< double >( j );
+    table[j] = hasNoDataValue && qgsDoubleNear( value, noDataValue ) ? noDataColor : shade( value );
+  }
+
+  if ( !block->hasNoData() || hasNoDataValue )
+  {
+    for ( qgssize i = 0; i < count; ++i )
+    {
+      output[i] = table[ static_cast< qint64 >( data[i] ) - min ];
+    }
+  }
+  else
+  {
+    // no data bitmap
+    for ( qgssize i = 0; i < count; ++i )
+    {
+      output[i] = block->isNoData( i ) ? noDataColor : table[ static_cast< qint64 >( data[i] ) - min ];
+    }
+  }
+  return true;
+}
+
+///@endcond
+
 QgsRasterBlock *QgsSingleBandPseudoColorRenderer::block( int bandNo, QgsRectangle  const &extent, int width, int height, QgsRasterBlockFeedback *feedback )
 {
   Q_UNUSED( bandNo )
@@ -240,22 +295,13 @@ QgsRasterBlock *QgsSingleBandPseudoColorRenderer::block( int bandNo, QgsRectangl
   QRgb *outputBlockData = outputBlock->colorData();
   const QgsRasterShaderFunction *fcn = mShader->rasterShaderFunction();
 
-  const qgssize count = ( qgssize )width * height;
-  bool isNoData = false;
-  for ( qgssize i = 0; i < count; i++ )
+  // premultiplied color of a value, with the opacity of the alpha band pixel
+  auto shadeValue = [ = ]( double val, double alphaBandOpacity ) -> QRgb
   {
-    const double val = inputBlock->valueAndNoData( i, isNoData );
-    if ( isNoData )
-    {
-      outputBlockData[i] = myDefaultColor;
-      continue;
-    }
-
     int red, green, blue, alpha;
     if ( !fcn->shade( val, &red, &green, &blue, &alpha ) )
     {
-      outputBlockData[i] = myDefaultColor;
-      continue;
+      return myDefaultColor;
     }
 
     if ( alpha < 255 )
@@ -268,25 +314,73 @@ QgsRasterBlock *QgsSingleBandPseudoColorRenderer::block( int bandNo, QgsRectangl
 
     if ( !hasTransparency )
     {
-      outputBlockData[i] = qRgba( red, green, blue, alpha );
+      return qRgba( red, green, blue, alpha );
     }
-    else
+
+    //opacity
+    double currentOpacity = mOpacity;
+    if ( mRasterTransparency )
     {
-      //opacity
-      double currentOpacity = mOpacity;
-      if ( mRasterTransparency )
-      {
-        currentOpacity = mRasterTransparency->alphaValue( val, mOpacity * 255 ) / 255.0;
-      }
-      if ( mAlphaBand > 0 )
-      {
-        currentOpacity *= alphaBlock->value( i ) / 255.0;
-      }
+      currentOpacity = mRasterTransparency->alphaValue( val, mOpacity * 255 ) / 255.0;
+    }
+    if ( mAlphaBand > 0 )
+    {
+      currentOpacity *= alphaBandOpacity;
+    }
+
+    return qRgba( currentOpacity * red, currentOpacity * green, currentOpacity * blue, currentOpacity * alpha );
+  };
 
-      outputBlockData[i] = qRgba( currentOpacity * red, currentOpacity * green, currentOpacity * blue, currentOpacity * alpha );
+  const qgssize count = ( qgssize )width * height;
+
+  // without an alpha band, the color of a pixel only depends on its value, so integer
+  // blocks are colored through a table of the colors of the values they contain
+  if ( mAlphaBand <= 0 )
+  {
+    auto shadeIntegerValue = [ = ]( double val ) { return shadeValue( val, 1.0 ); };
+    bool shaded = false;
+    switch ( inputBlock->dataType() )
+    {
+      case Qgis::DataType::Byte:
+        shaded = _shadeThroughLookupTable( reinterpret_cast< const quint8 * >( inputBlock->bits() ), count, inputBlock.get(), outputBlockData, myDefaultColor, shadeIntegerValue );
+        break;
+      case Qgis::DataType::Int8:
+        shaded = _shadeThroughLookupTable( reinterpret_cast< const qint8 * >( inputBlock->bits() ), count, inputBlock.get(), outputBlockData, myDefaultColor, shadeIntegerValue );
+        break;
+      case Qgis::DataType::UInt16:
+        shaded = _shadeThroughLookupTable( reinterpret_cast< const quint16 * >( inputBlock->bits() ), count, inputBlock.get(), outputBlockData, myDefaultColor, shadeIntegerValue );
+        break;
+      case Qgis::DataType::Int16:
+        shaded = _shadeThroughLookupTable( reinterpret_cast< const qint16 * >( inputBlock->bits() ), count, inputBlock.get(), outputBlockData, myDefaultColor, shadeIntegerValue );
+        break;
+      case Qgis::DataType::UInt32:
+        shaded = _shadeThroughLookupTable( reinterpret_cast< const quint32 * >( inputBlock->bits() ), count, inputBlock.get(), outputBlockData, myDefaultColor, shadeIntegerValue );
+        break;
+      case Qgis::DataType::Int32:
+        shaded = _shadeThroughLookupTable( reinterpret_cast< const qint32 * >( inputBlock->bits() ), count, inputBlock.get(), outputBlockData, myDefaultColor, shadeIntegerValue );
+        break;
+      default:
+        break;
+    }
+    if ( shaded )
+    {
+      return outputBlock.release();
     }
   }
 
+  bool isNoData = false;
+  for ( qgssize i = 0; i < count; i++ )
+  {
+    const double val = inputBlock->valueAndNoData( i, isNoData );
+    if ( isNoData )
+    {
+      outputBlockData[i] = myDefaultColor;
+      continue;
+    }
+
+    outputBlockData[i] = shadeValue( val, mAlphaBand > 0 ? alphaBlock->value( i ) / 255.0 : 1.0 );
+  }
+
   return outputBlock.release();
 }
 
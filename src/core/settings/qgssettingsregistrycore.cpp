@@ -101,6 +101,8 @@ const QgsSettingsEntryBool *QgsSettingsRegistryCore::settingsLayerTreeShowFeatur
 
 const QgsSettingsEntryBool *QgsSettingsRegistryCore::settingsEnableWMSTilePrefetching = new QgsSettingsEntryBool( QStringLiteral( "enable_wms_tile_prefetch" ), QgsSettings::sTreeWms, false, QStringLiteral( "Whether to include WMS layers when rendering tiles adjacent to the visible map area" ) );
 
+const QgsSettingsEntryInteger64 *QgsSettingsRegistryCore::settingsTileCacheSize = new QgsSettingsEntryInteger64( QStringLiteral( "tile-cache-size" ), QgsSettings::sTreeNetwork, 128, QStringLiteral( "Maximum size in megabytes of the in-memory cache of decoded tiles. It is read when the cache is first used." ), Qgis::SettingsOptions(), 1 );
+
 QgsSettingsRegistryCore::QgsSettingsRegistryCore()
   : QgsSettingsRegistry()
 {
@@ -159,6 +159,12 @@ class CORE_EXPORT QgsSettingsRegistryCore : public QgsSettingsRegistry
     //! Settings entry enable WMS tile prefetching.
     static const QgsSettingsEntryBool *settingsEnableWMSTilePrefetching;
 
+    /**
+     * Settings entry size in megabytes of the in-memory cache of decoded tiles.
+     * \since QGIS 3.30
+     */
+    static const QgsSettingsEntryInteger64 *settingsTileCacheSize;
+
   private:
     void migrateOldSettings();
     void backwardCompatibility();
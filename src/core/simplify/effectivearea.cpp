@@ -23,44 +23,86 @@
  **********************************************************************/
 
 #include "effectivearea.h"
+#include "qgslinestring.h"
 #include "qgspoint.h"
 
-static MINHEAP initiate_minheap( int npoints )
+void EFFECTIVE_AREAS::setPoints( int count, const double *x, const double *y, const double *z )
 {
-  MINHEAP tree;
-  tree.key_array = ( areanode ** )lwalloc( npoints * sizeof( void * ) );
-  tree.maxSize = npoints;
-  tree.usedSize = 0;
-  return tree;
+  npoints = count;
+  xData = x;
+  yData = y;
+  zData = z;
+
+  // the buffers keep their capacity, so that reusing the structure does not allocate again
+  if ( static_cast< int >( initial_arealist.size() ) < npoints )
+  {
+    initial_arealist.resize( npoints );
+    res_arealist.resize( npoints );
+    minheap_keys.resize( npoints );
+  }
+}
+
+void EFFECTIVE_AREAS::setPoints( const QgsCurve &curve )
+{
+  if ( const QgsLineString *line = qgsgeometry_cast< const QgsLineString * >( &curve ) )
+  {
+    setPoints( line->numPoints(), line->xData(), line->yData(), line->zData() );
+    return;
+  }
+
+  QgsPointSequence points;
+  curve.points( points );
+  const int count = points.size();
+  const bool is3d = curve.is3D();
+  curveX.resize( count );
+  curveY.resize( count );
+  curveZ.resize( is3d ? count : 0 );
+  for ( int i = 0; i < count; ++i )
+  {
+    curveX[i] = points.at( i ).x();
+    curveY[i] = points.at( i ).y();
+    if ( is3d )
+      curveZ[i] = points.at( i ).z();
+  }
+  setPoints( count, curveX.constData(), curveY.constData(), is3d ? curveZ.constData() : nullptr );
 }
 
-static void destroy_minheap( MINHEAP tree )
+static MINHEAP initiate_minheap( EFFECTIVE_AREAS *ea )
 {
-  lwfree( tree.key_array );
+  MINHEAP tree;
+  tree.key_array = ea->minheap_keys.data();
+  tree.maxSize = ea->npoints;
+  tree.usedSize = 0;
+  return tree;
 }
 
 /**
- * Calculate the area of a triangle in 2d
+ * Calculate the area of the triangle of the points \a p1, \a p2 and \a p3 in 2d
  */
-static double triarea2d( const QgsPoint &P1, const QgsPoint &P2, const QgsPoint &P3 )
+static double triarea2d( const EFFECTIVE_AREAS *ea, int p1, int p2, int p3 )
 {
-  return std::fabs( 0.5 * ( ( P1.x() - P2.x() ) * ( P3.y() - P2.y() ) - ( P1.y() - P2.y() ) * ( P3.x() - P2.x() ) ) );
+  const double *x = ea->xData;
+  const double *y = ea->yData;
+  return std::fabs( 0.5 * ( ( x[p1] - x[p2] ) * ( y[p3] - y[p2] ) - ( y[p1] - y[p2] ) * ( x[p3] - x[p2] ) ) );
 }
 
 /**
- * Calculate the area of a triangle in 3d space
+ * Calculate the area of the triangle of the points \a p1, \a p2 and \a p3 in 3d space
  */
-static double triarea3d( const QgsPoint &P1, const QgsPoint &P2, const QgsPoint &P3 )
+static double triarea3d( const EFFECTIVE_AREAS *ea, int p1, int p2, int p3 )
 {
   //LWDEBUG( 2, "Entered  triarea3d" );
   double ax, bx, ay, by, az, bz, cx, cy, cz, area;
 
-  ax = P1.x() - P2.x();
-  bx = P3.x() - P2.x();
-  ay = P1.y() - P2.y();
-  by = P3.y() - P2.y();
-  az = P1.z() - P2.z();
-  bz = P3.z() - P2.z();
+  const double *x = ea->xData;
+  const double *y = ea->yData;
+  const double *z = ea->zData;
+  ax = x[p1] - x[p2];
+  bx = x[p3] - x[p2];
+  ay = y[p1] - y[p2];
+  by = y[p3] - y[p2];
+  az = z[p1] - z[p2];
+  bz = z[p3] - z[p2];
 
   cx = ay * bz - az * by;
   cy = az * bx - ax * bz;
@@ -70,6 +112,11 @@ static double triarea3d( const QgsPoint &P1, const QgsPoint &P2, const QgsPoint
   return area;
 }
 
+static double triarea( const EFFECTIVE_AREAS *ea, int p1, int p2, int p3 )
+{
+  return ea->zData ? triarea3d( ea, p1, p2, p3 ) : triarea2d( ea, p1, p2, p3 );
+}
+
 /**
  * We create the minheap by ordering the minheap array by the areas in the areanode structs that the minheap keys refer to
  */
@@ -192,23 +239,22 @@ static void minheap_update( MINHEAP *tree, areanode *arealist, int idx )
 static void tune_areas( EFFECTIVE_AREAS *ea, int avoid_collaps, int set_area, double trshld )
 {
   //LWDEBUG( 2, "Entered  tune_areas" );
-  QgsPoint P1;
-  QgsPoint P2;
-  QgsPoint P3;
   double area;
   int go_on = 1;
   double check_order_min_area = 0;
 
-  const int npoints = ea->inpts.size();
+  const int npoints = ea->npoints;
   int i;
   int current, before_current, after_current;
 
-  MINHEAP tree = initiate_minheap( npoints );
+  areanode *arealist = ea->initial_arealist.data();
+  double *res_arealist = ea->res_arealist.data();
+  MINHEAP tree = initiate_minheap( ea );
 
   // Add all keys (index in initial_arealist) into minheap array
   for ( i = 0; i < npoints; i++ )
   {
-    tree.key_array[i] = ea->initial_arealist + i;
+    tree.key_array[i] = arealist + i;
     //LWDEBUGF( 2, "add nr %d, with area %lf, and %lf", i, ea->initial_arealist[i].area, tree.key_array[i]->area );
   }
   tree.usedSize = npoints;
@@ -228,67 +274,51 @@ static void tune_areas( EFFECTIVE_AREAS *ea, int avoid_collaps, int set_area, do
   while ( go_on )
   {
     // Get a reference to the point with the currently smallest effective area
-    current = minheap_pop( &tree, ea->initial_arealist ) - ea->initial_arealist;
+    current = minheap_pop( &tree, arealist ) - arealist;
 
     // We have found the smallest area. That is the resulting effective area for the "current" point
     if ( i < npoints - avoid_collaps )
-      ea->res_arealist[current] = ea->initial_arealist[current].area;
+      res_arealist[current] = arealist[current].area;
     else
-      ea->res_arealist[current] = FLT_MAX;
+      res_arealist[current] = FLT_MAX;
 
-    if ( ea->res_arealist[current] < check_order_min_area )
-      lwerror( "Oh no, this is a bug. For some reason the minHeap returned our points in the wrong order. Please file a ticket in PostGIS ticket system, or send a mail at the mailing list. Returned area = %lf, and last area = %lf", ea->res_arealist[current], check_order_min_area );
+    if ( res_arealist[current] < check_order_min_area )
+      lwerror( "Oh no, this is a bug. For some reason the minHeap returned our points in the wrong order. Please file a ticket in PostGIS ticket system, or send a mail at the mailing list. Returned area = %lf, and last area = %lf", res_arealist[current], check_order_min_area );
 
-    check_order_min_area = ea->res_arealist[current];
+    check_order_min_area = res_arealist[current];
 
     // The found smallest area point is now regarded as eliminated and we have to recalculate the area the adjacent (ignoring earlier eliminated points) points gives
 
     // Find point before and after
-    before_current = ea->initial_arealist[current].prev;
-    after_current  = ea->initial_arealist[current].next;
-
-    P2 = ea->inpts.at( before_current );
-    P3 = ea->inpts.at( after_current );
+    before_current = arealist[current].prev;
+    after_current  = arealist[current].next;
 
     // Check if point before current point is the first in the point array.
     if ( before_current > 0 )
     {
-      P1 = ea->inpts.at( ea->initial_arealist[before_current].prev );
+      area = triarea( ea, arealist[before_current].prev, before_current, after_current );
 
-      if ( ea->is3d )
-        area = triarea3d( P1, P2, P3 );
-      else
-        area = triarea2d( P1, P2, P3 );
-
-      ea->initial_arealist[before_current].area = FP_MAX( area, ea->res_arealist[current] );
-      minheap_update( &tree, ea->initial_arealist, ea->initial_arealist[before_current].treeindex );
+      arealist[before_current].area = FP_MAX( area, res_arealist[current] );
+      minheap_update( &tree, arealist, arealist[before_current].treeindex );
     }
     if ( after_current < npoints - 1 ) // Check if point after current point is the last in the point array.
     {
-      P1 = P2;
-      P2 = P3;
-      P3 = ea->inpts.at( ea->initial_arealist[after_current].next );
-
-      if ( ea->is3d )
-        area = triarea3d( P1, P2, P3 );
-      else
-        area = triarea2d( P1, P2, P3 );
+      area = triarea( ea, before_current, after_current, arealist[after_current].next );
 
-      ea->initial_arealist[after_current].area = FP_MAX( area, ea->res_arealist[current] );
-      minheap_update( &tree, ea->initial_arealist, ea->initial_arealist[after_current].treeindex );
+      arealist[after_current].area = FP_MAX( area, res_arealist[current] );
+      minheap_update( &tree, arealist, arealist[after_current].treeindex );
     }
 
     // rearrange the nodes so the eliminated point will be ignored on the next run
-    ea->initial_arealist[before_current].next = ea->initial_arealist[current].next;
-    ea->initial_arealist[after_current ].prev = ea->initial_arealist[current].prev;
+    arealist[before_current].next = arealist[current].next;
+    arealist[after_current ].prev = arealist[current].prev;
 
     // Check if we are finished
-    if ( ( !set_area && ea->res_arealist[current] > trshld ) || ( ea->initial_arealist[0].next == ( npoints - 1 ) ) )
+    if ( ( !set_area && res_arealist[current] > trshld ) || ( arealist[0].next == ( npoints - 1 ) ) )
       go_on = 0;
 
     i++;
   }
-  destroy_minheap( tree );
 }
 
 /**
@@ -298,44 +328,39 @@ void ptarray_calc_areas( EFFECTIVE_AREAS *ea, int avoid_collaps, int set_area, d
 {
   //LWDEBUG( 2, "Entered  ptarray_calc_areas" );
   int i;
-  const int npoints = ea->inpts.size();
-  double area;
+  const int npoints = ea->npoints;
+  areanode *arealist = ea->initial_arealist.data();
+  double *res_arealist = ea->res_arealist.data();
 
-  QgsPoint P1;
-  QgsPoint P2;
-  QgsPoint P3;
-  P1 = ea->inpts.at( 0 );
-  P2 = ea->inpts.at( 1 );
+  // all the points of lines of less than 3 points are kept
+  if ( npoints < 3 )
+  {
+    for ( i = 0; i < npoints; i++ )
+      res_arealist[i] = FLT_MAX;
+    return;
+  }
 
   // The first and last point shall always have the maximum effective area. We use float max to not make trouble for bbox
-  ea->initial_arealist[0].area = ea->initial_arealist[npoints - 1].area = FLT_MAX;
-  ea->res_arealist[0] = ea->res_arealist[npoints - 1] = FLT_MAX;
+  arealist[0].area = arealist[npoints - 1].area = FLT_MAX;
+  res_arealist[0] = res_arealist[npoints - 1] = FLT_MAX;
 
-  ea->initial_arealist[0].next = 1;
-  ea->initial_arealist[0].prev = 0;
+  arealist[0].next = 1;
+  arealist[0].prev = 0;
 
   for ( i = 1; i < ( npoints ) - 1; i++ )
   {
-    ea->initial_arealist[i].next = i + 1;
-    ea->initial_arealist[i].prev = i - 1;
-    P3 = ea->inpts.at( i + 1 );
-
-    if ( ea->is3d )
-      area = triarea3d( P1, P2, P3 );
-    else
-      area = triarea2d( P1, P2, P3 );
+    arealist[i].next = i + 1;
+    arealist[i].prev = i - 1;
 
     //LWDEBUGF( 4, "Write area %lf to point %d on address %p", area, i, &( ea->initial_arealist[i].area ) );
-    ea->initial_arealist[i].area = area;
-    P1 = P2;
-    P2 = P3;
+    arealist[i].area = triarea( ea, i - 1, i, i + 1 );
   }
-  ea->initial_arealist[npoints - 1].next = npoints - 1;
-  ea->initial_arealist[npoints - 1].prev = npoints - 2;
+  arealist[npoints - 1].next = npoints - 1;
+  arealist[npoints - 1].prev = npoints - 2;
 
   for ( i = 1; i < ( npoints ) - 1; i++ )
   {
-    ea->res_arealist[i] = FLT_MAX;
+    res_arealist[i] = FLT_MAX;
   }
   tune_areas( ea, avoid_collaps, set_area, trshld );
 }
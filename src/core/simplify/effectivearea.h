@@ -25,6 +25,8 @@
 #include "qgsabstractgeometry.h"
 #include "qgscurve.h"
 
+#include <vector>
+
 #define SIP_NO_FILE
 
 #ifndef _EFFECTIVEAREA_H
@@ -68,32 +70,46 @@ struct MINHEAP
 
 /**
  * Structure to hold point array and its arealist.
+ *
+ * The points are read from coordinate arrays, and the buffers are kept between calls to
+ * setPoints() so that an instance can be reused to simplify many geometries.
  */
 struct EFFECTIVE_AREAS
 {
-  EFFECTIVE_AREAS( const QgsCurve &curve )
-    : is3d( curve.is3D() )
-  {
-    curve.points( inpts );
-    initial_arealist = new areanode[ inpts.size()];
-    res_arealist = new double[ inpts.size()];
-  }
+  EFFECTIVE_AREAS() = default;
 
-  ~EFFECTIVE_AREAS()
+  EFFECTIVE_AREAS( const QgsCurve &curve )
   {
-    delete [] initial_arealist;
-    delete [] res_arealist;
+    setPoints( curve );
   }
 
   EFFECTIVE_AREAS( const EFFECTIVE_AREAS &other ) = delete;
   EFFECTIVE_AREAS &operator=( const EFFECTIVE_AREAS &other ) = delete;
 
-  bool is3d;
-  QgsPointSequence inpts;
-  areanode *initial_arealist = nullptr;
-  double *res_arealist = nullptr;
-
-
+  /**
+   * Sets the \a count points from the \a x, \a y and optional \a z coordinate arrays, which must
+   * stay valid until the areas are computed.
+   */
+  void setPoints( int count, const double *x, const double *y, const double *z = nullptr );
+
+  //! Sets the points of a \a curve, which must stay valid until the areas are computed
+  void setPoints( const QgsCurve &curve );
+
+  int npoints = 0;
+  const double *xData = nullptr;
+  const double *yData = nullptr;
+  //! The z coordinates, or NULLPTR for 2d points
+  const double *zData = nullptr;
+
+  //! Coordinates of the curves which are not linestrings
+  QVector< double > curveX;
+  QVector< double > curveY;
+  QVector< double > curveZ;
+
+  std::vector< areanode > initial_arealist;
+  std::vector< double > res_arealist;
+  //! Storage of the minheap keys
+  std::vector< areanode * > minheap_keys;
 };
 
 void ptarray_calc_areas( EFFECTIVE_AREAS *ea, int avoid_collaps, int set_area, double trshld );
@@ -24,6 +24,96 @@
 
 #include "qgsexpressioncontextutils.h"
 
+#include <QMutex>
+
+///@cond PRIVATE
+
+//! Maximum number of generated geometries stored in the cache
+constexpr int GEOMETRY_GENERATOR_CACHE_SIZE = 100000;
+
+/**
+ * Cache of the geometries generated for features, keyed by feature id.
+ *
+ * An entry is only returned when the geometry, fields and attributes of the feature did not change
+ * since the geometry was generated.
+ */
+class QgsGeometryGeneratorCache
+{
+  public:
+
+    bool lookup( const QgsFeature &feature, QgsGeometry &result ) const
+    {
+      const QMutexLocker locker( &mMutex );
+      auto it = mEntries.constFind( feature.id() );
+      if ( it == mEntries.constEnd() || !it->input.equals( feature.geometry() )
+           || it->fields != feature.fields() || it->attributes != feature.attributes() )
+        return false;
+
+      result = it->result;
+      return true;
+    }
+
+    void insert( const QgsFeature &feature, const QgsGeometry &result )
+    {
+      const QMutexLocker locker( &mMutex );
+      if ( mEntries.size() >= GEOMETRY_GENERATOR_CACHE_SIZE && !mEntries.contains( feature.id() ) )
+        mEntries.clear();
+      mEntries.insert( feature.id(), Entry{ feature.geometry(), feature.fields(), feature.attributes(), result } );
+    }
+
+  private:
+
+    struct Entry
+    {
+      QgsGeometry input;
+      QgsFields fields;
+      QgsAttributes attributes;
+      QgsGeometry result;
+    };
+
+    mutable QMutex mMutex;
+    QHash< QgsFeatureId, Entry > mEntries;
+};
+
+/**
+ * Returns TRUE if the result of the geometry generator \a expression only depends on the
+ * geometry and attributes of the feature, so that it can be cached.
+ */
+static bool isCacheableExpression( const QgsExpression &expression )
+{
+  static const QSet< QString > sPureFunctions
+  {
+    QStringLiteral( "$geometry" ), QStringLiteral( "buffer" ), QStringLiteral( "single_sided_buffer" ), QStringLiteral( "offset_curve" ),
+    QStringLiteral( "tapered_buffer" ), QStringLiteral( "buffer_by_m" ), QStringLiteral( "wedge_buffer" ), QStringLiteral( "make_line" ),
+    QStringLiteral( "make_point" ), QStringLiteral( "make_point_m" ), QStringLiteral( "make_polygon" ), QStringLiteral( "make_circle" ),
+    QStringLiteral( "make_ellipse" ), QStringLiteral( "make_rectangle_3points" ), QStringLiteral( "make_regular_polygon" ),
+    QStringLiteral( "make_square" ), QStringLiteral( "make_triangle" ), QStringLiteral( "centroid" ), QStringLiteral( "point_on_surface" ),
+    QStringLiteral( "pole_of_inaccessibility" ), QStringLiteral( "convex_hull" ), QStringLiteral( "simplify" ), QStringLiteral( "simplify_vw" ),
+    QStringLiteral( "smooth" ), QStringLiteral( "densify_by_count" ), QStringLiteral( "densify_by_distance" ), QStringLiteral( "extend" ),
+    QStringLiteral( "bounds" ), QStringLiteral( "oriented_bbox" ), QStringLiteral( "minimal_circle" ), QStringLiteral( "start_point" ),
+    QStringLiteral( "end_point" ), QStringLiteral( "point_n" ), QStringLiteral( "line_interpolate_point" ), QStringLiteral( "line_substring" ),
+    QStringLiteral( "line_merge" ), QStringLiteral( "segments_to_lines" ), QStringLiteral( "boundary" ), QStringLiteral( "collect_geometries" ),
+    QStringLiteral( "difference" ), QStringLiteral( "intersection" ), QStringLiteral( "sym_difference" ), QStringLiteral( "combine" ),
+    QStringLiteral( "translate" ), QStringLiteral( "rotate" ), QStringLiteral( "reverse" ), QStringLiteral( "exterior_ring" ),
+    QStringLiteral( "interior_ring_n" ), QStringLiteral( "geometry_n" ), QStringLiteral( "force_rhr" ), QStringLiteral( "force_polygon_cw" ),
+    QStringLiteral( "force_polygon_ccw" ), QStringLiteral( "geom_from_wkt" ), QStringLiteral( "make_valid" ), QStringLiteral( "coalesce" ),
+    QStringLiteral( "if" ), QStringLiteral( "to_real" ), QStringLiteral( "to_int" ), QStringLiteral( "project" ),
+  };
+
+  if ( expression.hasParserError() || !expression.referencedVariables().isEmpty() )
+    return false;
+
+  const QSet< QString > functions = expression.referencedFunctions();
+  for ( const QString &function : functions )
+  {
+    if ( !sPureFunctions.contains( function ) )
+      return false;
+  }
+  return true;
+}
+
+///@endcond
+
 QgsGeometryGeneratorSymbolLayer::~QgsGeometryGeneratorSymbolLayer() = default;
 
 QgsSymbolLayer *QgsGeometryGeneratorSymbolLayer::create( const QVariantMap &properties )
@@ -58,6 +148,7 @@ QgsGeometryGeneratorSymbolLayer::QgsGeometryGeneratorSymbolLayer( const QString
   : QgsSymbolLayer( Qgis::SymbolType::Hybrid )
   , mExpression( new QgsExpression( expression ) )
   , mSymbolType( Qgis::SymbolType::Marker )
+  , mGeometryCache( std::make_shared< QgsGeometryGeneratorCache >() )
 {
 
 }
@@ -96,6 +187,7 @@ void QgsGeometryGeneratorSymbolLayer::setSymbolType( Qgis::SymbolType symbolType
 void QgsGeometryGeneratorSymbolLayer::startRender( QgsSymbolRenderContext &context )
 {
   mExpression->prepare( &context.renderContext().expressionContext() );
+  mUseGeometryCache = isCacheableExpression( *mExpression );
 
   subSymbol()->startRender( context.renderContext() );
 }
@@ -187,6 +279,7 @@ QgsSymbolLayer *QgsGeometryGeneratorSymbolLayer::clone() const
 
   clone->setSymbolType( mSymbolType );
   clone->setUnits( mUnits );
+  clone->mGeometryCache = mGeometryCache;
 
   copyDataDefinedProperties( clone );
   copyPaintEffect( clone );
@@ -267,6 +360,8 @@ void QgsGeometryGeneratorSymbolLayer::drawPreviewIcon( QgsSymbolRenderContext &c
 void QgsGeometryGeneratorSymbolLayer::setGeometryExpression( const QString &exp )
 {
   mExpression.reset( new QgsExpression( exp ) );
+  // the cached geometries are shared with the clones, which keep the previous expression
+  mGeometryCache = std::make_shared< QgsGeometryGeneratorCache >();
 }
 
 QString QgsGeometryGeneratorSymbolLayer::geometryExpression() const
@@ -458,7 +553,13 @@ void QgsGeometryGeneratorSymbolLayer::render( QgsSymbolRenderContext &context, Q
       case QgsUnitTypes::RenderMetersInMapUnits: // unsupported, not exposed as an option
       case QgsUnitTypes::RenderPercentage: // unsupported, not exposed as an option
       {
-        QgsGeometry geom = mExpression->evaluate( &expressionContext ).value<QgsGeometry>();
+        QgsGeometry geom;
+        if ( !mUseGeometryCache || !mGeometryCache->lookup( f, geom ) )
+        {
+          geom = mExpression->evaluate( &expressionContext ).value<QgsGeometry>();
+          if ( mUseGeometryCache && !f.geometry().isNull() )
+            mGeometryCache->insert( f, geom );
+        }
         f.setGeometry( coerceToExpectedType( geom ) );
         break;
       }
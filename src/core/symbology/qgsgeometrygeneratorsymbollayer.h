@@ -20,9 +20,12 @@
 #include "qgis.h"
 #include "qgssymbollayer.h"
 
+#include <memory>
+
 class QgsFillSymbol;
 class QgsLineSymbol;
 class QgsMarkerSymbol;
+class QgsGeometryGeneratorCache;
 
 /**
  * \ingroup core
@@ -165,6 +168,13 @@ class CORE_EXPORT QgsGeometryGeneratorSymbolLayer : public QgsSymbolLayer
 
     bool mRenderingFeature = false;
     bool mHasRenderedFeature = false;
+
+    /**
+     * Cache of the geometries generated in map units, shared between the clones of the symbol layer.
+     * Only used when the expression is a pure function of the feature.
+     */
+    std::shared_ptr< QgsGeometryGeneratorCache > mGeometryCache;
+    bool mUseGeometryCache = false;
 };
 
 #endif // QGSGEOMETRYGENERATORSYMBOLLAYER_H
@@ -33,6 +33,9 @@
 #include <QDomDocument>
 #include <QDomElement>
 
+#include <cmath>
+#include <limits>
+
 QgsHeatmapRenderer::QgsHeatmapRenderer()
   : QgsFeatureRenderer( QStringLiteral( "heatmapRenderer" ) )
 {
@@ -52,6 +55,19 @@ void QgsHeatmapRenderer::initializeValues( QgsRenderContext &context )
   mFeaturesRendered = 0;
   mRadiusPixels = std::round( context.convertToPainterUnits( mRadius, mRadiusUnit, mRadiusMapUnitScale ) / mRenderQuality );
   mRadiusSquared = mRadiusPixels * mRadiusPixels;
+
+  // the kernel only depends on the offsets in pixels from the points, so it is computed once for all the points
+  const int kernelSize = 2 * mRadiusPixels + 1;
+  mKernelValues.resize( kernelSize * kernelSize );
+  for ( int dy = -mRadiusPixels; dy <= mRadiusPixels; ++dy )
+  {
+    for ( int dx = -mRadiusPixels; dx <= mRadiusPixels; ++dx )
+    {
+      const double distanceSquared = std::pow( dx, 2.0 ) + std::pow( dy, 2.0 );
+      mKernelValues[( dy + mRadiusPixels ) * kernelSize + dx + mRadiusPixels] = distanceSquared > mRadiusSquared
+          ? std::numeric_limits< double >::quiet_NaN() : quarticKernel( std::sqrt( distanceSquared ), mRadiusPixels );
+    }
+  }
 }
 
 void QgsHeatmapRenderer::startRender( QgsRenderContext &context, const QgsFields &fields )
@@ -142,6 +158,9 @@ bool QgsHeatmapRenderer::renderFeature( const QgsFeature &feature, QgsRenderCont
   //convert point to multipoint
   const QgsMultiPointXY multiPoint = convertToMultipoint( &geom );
 
+  const int kernelSize = 2 * mRadiusPixels + 1;
+  const double *kernelValues = mKernelValues.constData();
+
   //loop through all points in multipoint
   for ( QgsMultiPointXY::const_iterator pointIt = multiPoint.constBegin(); pointIt != multiPoint.constEnd(); ++pointIt )
   {
@@ -160,13 +179,13 @@ bool QgsHeatmapRenderer::renderFeature( const QgsFeature &feature, QgsRenderCont
         {
           continue;
         }
-        const double distanceSquared = std::pow( pointX - x, 2.0 ) + std::pow( pointY - y, 2.0 );
-        if ( distanceSquared > mRadiusSquared )
+        const double kernelValue = kernelValues[( pointY - y + mRadiusPixels ) * kernelSize + pointX - x + mRadiusPixels];
+        if ( std::isnan( kernelValue ) )
         {
           continue;
         }
 
-        const double score = weight * quarticKernel( std::sqrt( distanceSquared ), mRadiusPixels );
+        const double score = weight * kernelValue;
         const double value = mValues.at( index ) + score;
         if ( value > mCalculatedMaxValue )
         {
@@ -238,6 +257,10 @@ void QgsHeatmapRenderer::renderImage( QgsRenderContext &context )
 
   const double scaleMax = mExplicitMax > 0 ? mExplicitMax : mCalculatedMaxValue;
 
+  // most pixels of a heatmap are usually empty or saturated, so the colors of these pixels are only computed once
+  const QRgb emptyColor = mGradientRamp->color( 0 ).rgba();
+  const QRgb saturatedColor = mGradientRamp->color( 1.0 ).rgba();
+
   int idx = 0;
   double pixVal = 0;
   QColor pixColor;
@@ -253,9 +276,19 @@ void QgsHeatmapRenderer::renderImage( QgsRenderContext &context )
       pixVal = mValues.at( idx ) > 0 ? std::min( ( mValues.at( idx ) / scaleMax ), 1.0 ) : 0;
 
       //convert value to color from ramp
-      pixColor = mGradientRamp->color( pixVal );
-
-      scanLine[widthIndex] = pixColor.rgba();
+      if ( pixVal == 0 )
+      {
+        scanLine[widthIndex] = emptyColor;
+      }
+      else if ( pixVal == 1.0 )
+      {
+        scanLine[widthIndex] = saturatedColor;
+      }
+      else
+      {
+        pixColor = mGradientRamp->color( pixVal );
+        scanLine[widthIndex] = pixColor.rgba();
+      }
       idx++;
     }
   }
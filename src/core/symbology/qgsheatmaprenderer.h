@@ -188,6 +188,8 @@ class CORE_EXPORT QgsHeatmapRenderer : public QgsFeatureRenderer
     double mRadius = 10;
     int mRadiusPixels = 0;
     double mRadiusSquared = 0;
+    //! Kernel values for the pixel offsets within the radius, NaN for offsets outside of the radius
+    QVector<double> mKernelValues;
     QgsUnitTypes::RenderUnit mRadiusUnit = QgsUnitTypes::RenderMillimeters;
     QgsMapUnitScale mRadiusMapUnitScale;
 
@@ -1151,6 +1151,16 @@ void QgsSimpleMarkerSymbolLayer::startRender( QgsSymbolRenderContext &context )
     mCache = QImage();
     mSelCache = QImage();
   }
+
+  // when only the size, rotation or colors are data defined the markers are drawn from
+  // images of the markers sharing the same (rounded) size, angle and colors
+  mSprites.clear();
+  mSpritePixelCount = 0;
+  mUsingSprites = !mUsingCache && !context.renderContext().forceVectorOutput()
+                  && !mDataDefinedProperties.isActive( QgsSymbolLayer::PropertyName )
+                  && !mDataDefinedProperties.isActive( QgsSymbolLayer::PropertyStrokeWidth ) && !mDataDefinedProperties.isActive( QgsSymbolLayer::PropertyStrokeStyle )
+                  && !mDataDefinedProperties.isActive( QgsSymbolLayer::PropertyJoinStyle ) && !mDataDefinedProperties.isActive( QgsSymbolLayer::PropertyCapStyle );
+  mCachedOpacity = context.opacity();
 }
 
 
@@ -1352,12 +1362,111 @@ void QgsSimpleMarkerSymbolLayer::renderPoint( QPointF point, QgsSymbolRenderCont
                           point.y() - s / 2.0 + offset.y(),
                           s, s ), img );
   }
-  else
+  else if ( !mUsingSprites || !qgsDoubleNear( mCachedOpacity, context.opacity() ) || !renderSprite( point, context ) )
   {
     QgsSimpleMarkerSymbolLayerBase::renderPoint( point, context );
   }
 }
 
+bool QgsSimpleMarkerSymbolLayer::renderSprite( QPointF point, QgsSymbolRenderContext &context )
+{
+  bool hasDataDefinedSize = false;
+  const double scaledSize = calculateSize( context, hasDataDefinedSize );
+
+  bool hasDataDefinedRotation = false;
+  QPointF offset;
+  double angle = 0;
+  calculateOffsetAndRotation( context, scaledSize, hasDataDefinedRotation, offset, angle );
+
+  // the marker shape is already scaled and rotated, unless the size or rotation are data defined
+  double size = 0;
+  if ( hasDataDefinedSize )
+  {
+    size = context.renderContext().convertToPainterUnits( scaledSize, mSizeUnit, mSizeMapUnitScale );
+    if ( mSizeUnit == QgsUnitTypes::RenderMetersInMapUnits && context.renderContext().flags() & Qgis::RenderContextFlag::RenderSymbolPreview )
+    {
+      size = std::min( std::max( context.renderContext().convertToPainterUnits( mSize, QgsUnitTypes::RenderMillimeters ), 3.0 ), 100.0 );
+    }
+    size = std::round( size * 4 ) / 4;
+  }
+  const int angleDegrees = hasDataDefinedRotation ? ( static_cast< int >( std::round( angle ) ) % 360 + 360 ) % 360 : 0;
+
+  QBrush brush = context.selected() ? mSelBrush : mBrush;
+  QPen pen = context.selected() ? mSelPen : mPen;
+  bool ok = true;
+  if ( !context.selected() && mDataDefinedProperties.isActive( QgsSymbolLayer::PropertyFillColor ) )
+  {
+    context.setOriginalValueVariable( QgsSymbolLayerUtils::encodeColor( mColor ) );
+    QColor c = mDataDefinedProperties.valueAsColor( QgsSymbolLayer::PropertyFillColor, context.renderContext().expressionContext(), mColor, &ok );
+    if ( ok )
+    {
+      c.setAlphaF( c.alphaF() * context.opacity() );
+      brush.setColor( c );
+    }
+  }
+  if ( mDataDefinedProperties.isActive( QgsSymbolLayer::PropertyStrokeColor ) )
+  {
+    context.setOriginalValueVariable( QgsSymbolLayerUtils::encodeColor( mStrokeColor ) );
+    QColor c = mDataDefinedProperties.valueAsColor( QgsSymbolLayer::PropertyStrokeColor, context.renderContext().expressionContext(), mStrokeColor, &ok );
+    if ( ok )
+    {
+      c.setAlphaF( c.alphaF() * context.opacity() );
+      pen.setColor( c );
+    }
+  }
+
+  const QPair< quint64, quint64 > key( static_cast< quint64 >( brush.color().rgba() ) << 32 | pen.color().rgba(),
+                                       ( static_cast< quint64 >( size * 4 ) << 10 | static_cast< quint64 >( angleDegrees ) ) << 1 | ( context.selected() ? 1 : 0 ) );
+
+  auto it = mSprites.constFind( key );
+  if ( it == mSprites.constEnd() )
+  {
+    QTransform transform;
+    double imageSize = hasDataDefinedSize ? size : context.renderContext().convertToPainterUnits( mSize, mSizeUnit, mSizeMapUnitScale );
+    if ( hasDataDefinedSize )
+      transform.scale( size / 2.0, size / 2.0 );
+    if ( angleDegrees != 0 )
+    {
+      transform.rotate( angleDegrees );
+      imageSize *= std::abs( std::sin( angleDegrees * M_PI / 180 ) ) + std::abs( std::cos( angleDegrees * M_PI / 180 ) );
+    }
+    else if ( !hasDataDefinedRotation && !qgsDoubleNear( mAngle, 0.0 ) )
+    {
+      imageSize *= std::abs( std::sin( mAngle * M_PI / 180 ) ) + std::abs( std::cos( mAngle * M_PI / 180 ) );
+    }
+
+    // calculate necessary image size, as for the single cached image
+    const double pw = static_cast< int >( std::round( ( ( qgsDoubleNear( pen.widthF(), 0.0 ) ? 1 : pen.widthF() * 4 ) + 1 ) ) ) / 2 * 2;
+    const int imageWidth = ( static_cast< int >( imageSize ) + pw ) / 2 * 2 + 1;
+    if ( imageWidth > MAXIMUM_CACHE_WIDTH || mSpritePixelCount + imageWidth * imageWidth > MAXIMUM_SPRITE_PIXEL_COUNT )
+      return false;
+
+    QImage image( QSize( imageWidth, imageWidth ), QImage::Format_ARGB32_Premultiplied );
+    image.fill( 0 );
+
+    QPainter p;
+    p.begin( &image );
+    p.setRenderHint( QPainter::Antialiasing );
+    p.setBrush( shapeIsFilled( mShape ) ? brush : Qt::NoBrush );
+    p.setPen( pen );
+    p.translate( QPointF( imageWidth / 2.0, imageWidth / 2.0 ) );
+    if ( !mPolygon.isEmpty() )
+      p.drawPolygon( transform.map( mPolygon ) );
+    else
+      p.drawPath( transform.map( mPath ) );
+    p.end();
+
+    mSpritePixelCount += imageWidth * imageWidth;
+    it = mSprites.insert( key, image );
+  }
+
+  const double s = it->width();
+  context.renderContext().painter()->drawImage( QRectF( point.x() - s / 2.0 + offset.x(),
+      point.y() - s / 2.0 + offset.y(),
+      s, s ), *it );
+  return true;
+}
+
 QVariantMap QgsSimpleMarkerSymbolLayer::properties() const
 {
   QVariantMap map;
@@ -32,6 +32,7 @@
 #include <QPicture>
 #include <QPolygonF>
 #include <QFont>
+#include <QHash>
 
 class QgsFillSymbol;
 class QgsPathResolver;
@@ -421,8 +422,32 @@ class CORE_EXPORT QgsSimpleMarkerSymbolLayer : public QgsSimpleMarkerSymbolLayer
     // cppcheck-suppress unusedPrivateFunction
     void draw( QgsSymbolRenderContext &context, Qgis::MarkerShape shape, const QPolygonF &polygon, const QPainterPath &path ) override SIP_FORCE;
 
+    /**
+     * Draws the marker at \a point using a rendered image of a marker with the same size, angle and colors,
+     * rendering this image first if it is not yet cached.
+     *
+     * The size and angle are rounded to a quarter of pixel and to a degree respectively.
+     * Returns FALSE if the marker cannot be drawn from an image.
+     */
+    bool renderSprite( QPointF point, QgsSymbolRenderContext &context );
+
     double mCachedOpacity = 1.0;
 
+    /**
+     * TRUE if using rendered images of markers sharing the same size, angle and colors for drawing.
+     * This is used instead of the single cached image when the size, angle or colors are data defined.
+     */
+    bool mUsingSprites = false;
+
+    //! Rendered images of markers, by colors, size, angle and selection state
+    QHash< QPair< quint64, quint64 >, QImage > mSprites;
+
+    //! Total number of pixels of the rendered images of markers
+    qint64 mSpritePixelCount = 0;
+
+    //! Maximum total number of pixels of the rendered images of markers
+    static const qint64 MAXIMUM_SPRITE_PIXEL_COUNT = 16 * 1024 * 1024;
+
 };
 
 /**
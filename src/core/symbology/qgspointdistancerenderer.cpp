@@ -18,7 +18,6 @@
 #include "qgspointdistancerenderer.h"
 #include "qgsgeometry.h"
 #include "qgssymbollayerutils.h"
-#include "qgsspatialindex.h"
 #include "qgsmultipoint.h"
 #include "qgslogger.h"
 #include "qgsstyleentityvisitor.h"
@@ -101,10 +100,32 @@ bool QgsPointDistanceRenderer::renderFeature( const QgsFeature &feature, QgsRend
     // create a new feature which is JUST this point, no other parts from the multi-point
     QgsFeature pointFeature = transformedFeature;
     pointFeature.setGeometry( QgsGeometry( point->clone() ) );
-    const QList<QgsFeatureId> intersectList = mSpatialIndex->intersects( searchRect( point, searchDistance ) );
+
+    // the first points of the nearby groups are looked up in the cells of the grid covering the search rectangle,
+    // which is much cheaper than inserting each point into an R-tree when rendering many points
+    const QgsRectangle rect = searchRect( point, searchDistance );
+    QList<QgsFeatureId> intersectList;
+    const qint64 maxCellX = gridCell( rect.xMaximum() );
+    const qint64 maxCellY = gridCell( rect.yMaximum() );
+    for ( qint64 cellX = gridCell( rect.xMinimum() ); cellX <= maxCellX; ++cellX )
+    {
+      for ( qint64 cellY = gridCell( rect.yMinimum() ); cellY <= maxCellY; ++cellY )
+      {
+        const auto cellIt = mGroupGrid.constFind( qMakePair( cellX, cellY ) );
+        if ( cellIt == mGroupGrid.constEnd() )
+          continue;
+
+        for ( const QPair< QgsFeatureId, QgsPointXY > &entry : *cellIt )
+        {
+          if ( rect.contains( entry.second ) )
+            intersectList << entry.first;
+        }
+      }
+    }
+
     if ( intersectList.empty() )
     {
-      mSpatialIndex->addFeature( pointFeature );
+      mGroupGrid[ qMakePair( gridCell( point->x() ), gridCell( point->y() ) ) ].append( qMakePair( pointFeature.id(), QgsPointXY( *point ) ) );
       // create new group
       ClusteredGroup newGroup;
       newGroup << GroupedFeature( pointFeature, symbol->clone(), selected, label );
@@ -327,7 +348,11 @@ void QgsPointDistanceRenderer::startRender( QgsRenderContext &context, const Qgs
   mClusteredGroups.clear();
   mGroupIndex.clear();
   mGroupLocations.clear();
-  mSpatialIndex = new QgsSpatialIndex;
+  mGroupGrid.clear();
+
+  // the cells of the grid have the size of the search distance, so that each search covers at most 3 x 3 cells
+  const double searchDistance = context.convertToMapUnits( mTolerance, mToleranceUnit, mToleranceMapUnitScale );
+  mGridCellSize = searchDistance > 0 ? searchDistance : 1;
 
   if ( mLabelAttributeName.isEmpty() )
   {
@@ -366,8 +391,7 @@ void QgsPointDistanceRenderer::stopRender( QgsRenderContext &context )
   mClusteredGroups.clear();
   mGroupIndex.clear();
   mGroupLocations.clear();
-  delete mSpatialIndex;
-  mSpatialIndex = nullptr;
+  mGroupGrid.clear();
 
   mRenderer->stopRender( context );
 }
@@ -386,6 +410,11 @@ QgsRectangle QgsPointDistanceRenderer::searchRect( const QgsPoint *p, double dis
   return QgsRectangle( p->x() - distance, p->y() - distance, p->x() + distance, p->y() + distance );
 }
 
+qint64 QgsPointDistanceRenderer::gridCell( double coordinate ) const
+{
+  return static_cast< qint64 >( std::floor( coordinate / mGridCellSize ) );
+}
+
 void QgsPointDistanceRenderer::printGroupInfo() const
 {
 #ifdef QGISDEBUG
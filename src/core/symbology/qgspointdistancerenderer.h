@@ -264,7 +264,11 @@ class CORE_EXPORT QgsPointDistanceRenderer: public QgsFeatureRenderer
     //! Mapping of feature ID to approximate group location
     QMap<QgsFeatureId, QgsPointXY > mGroupLocations;
 
-    //! Spatial index for fast lookup of nearby points.
+    /**
+     * Spatial index for fast lookup of nearby points.
+     *
+     * \deprecated since QGIS 3.30, this index is not used anymore and is always NULLPTR.
+     */
     QgsSpatialIndex *mSpatialIndex = nullptr;
 
     /**
@@ -290,6 +294,15 @@ class CORE_EXPORT QgsPointDistanceRenderer: public QgsFeatureRenderer
     //! Creates a search rectangle with specified distance tolerance.
     QgsRectangle searchRect( const QgsPoint *p, double distance ) const;
 
+    //! Returns the cell of the group grid containing the \a coordinate, along the x or y axis
+    qint64 gridCell( double coordinate ) const;
+
+    //! Grid of the locations of the first points of the groups, with the feature ids of these points
+    QHash< QPair< qint64, qint64 >, QVector< QPair< QgsFeatureId, QgsPointXY > > > mGroupGrid;
+
+    //! Size of the cells of the group grid, in map units
+    double mGridCellSize = 1;
+
     //! Debugging function to check the entries in the clustered groups
     void printGroupInfo() const;
 
@@ -16,6 +16,7 @@
 #include "qgsrulebasedrenderer.h"
 #include "qgssymbollayer.h"
 #include "qgsexpression.h"
+#include "qgsexpressionnodeimpl.h"
 #include "qgssymbollayerutils.h"
 #include "qgsrendercontext.h"
 #include "qgsvectorlayer.h"
@@ -32,6 +33,7 @@
 #include "qgslinesymbol.h"
 #include "qgsfillsymbol.h"
 #include "qgsmarkersymbol.h"
+#include "qgsvariantutils.h"
 
 #include <QSet>
 
@@ -418,6 +420,8 @@ void QgsRuleBasedRenderer::Rule::toSld( QDomDocument &doc, QDomElement &element,
 bool QgsRuleBasedRenderer::Rule::startRender( QgsRenderContext &context, const QgsFields &fields, QString &filter )
 {
   mActiveChildren.clear();
+  mChildrenFilterFieldIndex = -1;
+  mChildrenByFilterValue.clear();
 
   if ( ! mIsActive )
     return false;
@@ -447,6 +451,8 @@ bool QgsRuleBasedRenderer::Rule::startRender( QgsRenderContext &context, const Q
     }
   }
 
+  prepareChildrenFilterLookup( fields );
+
   // subfilters (on the same level) are joined with OR
   // Finally they are joined with their parent (this) with AND
   QString sf;
@@ -587,9 +593,15 @@ QgsRuleBasedRenderer::Rule::RenderResult QgsRuleBasedRenderer::Rule::renderFeatu
 
   bool matchedAChild = false;
 
-  // process children
-  const auto constMChildren = mChildren;
-  for ( Rule *rule : constMChildren )
+  // process children, only those whose filters can match when they are all comparisons of the same field with strings
+  RuleList children = mChildren;
+  if ( mChildrenFilterFieldIndex >= 0 )
+  {
+    const QVariant value = featToRender.feat.attribute( mChildrenFilterFieldIndex );
+    if ( value.type() == QVariant::String )
+      children = QgsVariantUtils::isNull( value ) ? RuleList() : mChildrenByFilterValue.value( value.toString() );
+  }
+  for ( Rule *rule : std::as_const( children ) )
   {
     // Don't process else rules yet
     if ( !rule->isElse() )
@@ -740,6 +752,54 @@ void QgsRuleBasedRenderer::Rule::stopRender( QgsRenderContext &context )
 
   mActiveChildren.clear();
   mSymbolNormZLevels.clear();
+  mChildrenFilterFieldIndex = -1;
+  mChildrenByFilterValue.clear();
+}
+
+void QgsRuleBasedRenderer::Rule::prepareChildrenFilterLookup( const QgsFields &fields )
+{
+  // a common case -- rules like those of a categorized renderer, with "field" = 'value' filters. Their
+  // children can be looked up by the value of the field of each feature, instead of evaluating all the filters
+  int fieldIndex = -1;
+  QHash< QString, RuleList > childrenByValue;
+  for ( Rule *rule : std::as_const( mChildren ) )
+  {
+    if ( rule->isElse() )
+      continue;
+
+    if ( !rule->mFilter || rule->mFilter->hasParserError() || !rule->mFilter->rootNode() ||
+         rule->mFilter->rootNode()->nodeType() != QgsExpressionNode::ntBinaryOperator )
+      return;
+
+    const QgsExpressionNodeBinaryOperator *op = static_cast< const QgsExpressionNodeBinaryOperator * >( rule->mFilter->rootNode() );
+    if ( op->op() != QgsExpressionNodeBinaryOperator::boEQ )
+      return;
+
+    const QgsExpressionNode *left = op->opLeft();
+    const QgsExpressionNode *right = op->opRight();
+    if ( left->nodeType() == QgsExpressionNode::ntLiteral )
+      std::swap( left, right );
+    if ( left->nodeType() != QgsExpressionNode::ntColumnRef || right->nodeType() != QgsExpressionNode::ntLiteral )
+      return;
+
+    // only string literals, for which the comparison with a string value is a simple string comparison
+    const QVariant value = static_cast< const QgsExpressionNodeLiteral * >( right )->value();
+    if ( value.type() != QVariant::String || QgsVariantUtils::isNull( value ) )
+      return;
+
+    const int ruleFieldIndex = fields.lookupField( static_cast< const QgsExpressionNodeColumnRef * >( left )->name() );
+    if ( ruleFieldIndex < 0 || ( fieldIndex >= 0 && ruleFieldIndex != fieldIndex ) )
+      return;
+
+    fieldIndex = ruleFieldIndex;
+    childrenByValue[ value.toString() ].append( rule );
+  }
+
+  if ( fieldIndex < 0 )
+    return;
+
+  mChildrenFilterFieldIndex = fieldIndex;
+  mChildrenByFilterValue = childrenByValue;
 }
 
 QgsRuleBasedRenderer::Rule *QgsRuleBasedRenderer::Rule::create( QDomElement &ruleElem, QgsSymbolMap &symbolMap )
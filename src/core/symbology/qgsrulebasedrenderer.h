@@ -484,6 +484,16 @@ class CORE_EXPORT QgsRuleBasedRenderer : public QgsFeatureRenderer
         QSet<int> mSymbolNormZLevels;
         RuleList mActiveChildren;
 
+        // temporary while rendering, set when the filters of all the children compare the same field with string literals
+        int mChildrenFilterFieldIndex = -1;
+        QHash< QString, RuleList > mChildrenByFilterValue;
+
+        /**
+         * Prepares the lookup of the children by the value of the field of their filters, when the filters of
+         * all the children which are not else rules are equality tests of the same field with string literals.
+         */
+        void prepareChildrenFilterLookup( const QgsFields &fields );
+
         /**
          * Check which child rules are else rules and update the internal list of else rules
          *
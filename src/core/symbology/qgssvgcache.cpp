@@ -83,7 +83,7 @@ int QgsSvgCacheEntry::dataSize() const
   }
   if ( image )
   {
-    size += ( image->width() * image->height() * 32 );
+    size += image->sizeInBytes();
   }
   return size;
 }
@@ -137,22 +137,14 @@ QImage QgsSvgCache::svgAsImage( const QString &file, double size, const QColor &
   //update stats for memory usage
   if ( !currentEntry->image )
   {
-    const QSvgRenderer r( currentEntry->svgContent );
-    double hwRatio = 1.0;
-    if ( r.viewBoxF().width() > 0 )
-    {
-      if ( currentEntry->fixedAspectRatio > 0 )
-      {
-        hwRatio = currentEntry->fixedAspectRatio;
-      }
-      else
-      {
-        hwRatio = r.viewBoxF().height() / r.viewBoxF().width();
-      }
-    }
+    // the same renderer is used to size and render the image, so the SVG content is only parsed once
+    QSvgRenderer r( currentEntry->svgContent );
+    QSizeF viewBoxSize;
+    QSizeF scaledSize;
+    const QSize imageSize = sizeForImage( *currentEntry, r, viewBoxSize, scaledSize );
     long cachedDataSize = 0;
     cachedDataSize += currentEntry->svgContent.size();
-    cachedDataSize += static_cast< int >( currentEntry->size * currentEntry->size * hwRatio * 32 );
+    cachedDataSize += static_cast< long >( imageSize.width() ) * imageSize.height() * 4;
     if ( cachedDataSize > mMaxCacheSize / 2 )
     {
       fitsInCache = false;
@@ -169,7 +161,7 @@ QImage QgsSvgCache::svgAsImage( const QString &file, double size, const QColor &
     }
     else
     {
-      cacheImage( currentEntry );
+      cacheImage( currentEntry, r );
       result = *( currentEntry->image );
     }
     trimToMaximumSize();
@@ -417,7 +409,7 @@ bool QgsSvgCache::checkReply( QNetworkReply *reply, const QString &path ) const
   return true;
 }
 
-void QgsSvgCache::cacheImage( QgsSvgCacheEntry *entry )
+void QgsSvgCache::cacheImage( QgsSvgCacheEntry *entry, QSvgRenderer &renderer )
 {
   if ( !entry )
   {
@@ -428,7 +420,7 @@ void QgsSvgCache::cacheImage( QgsSvgCacheEntry *entry )
 
   QSizeF viewBoxSize;
   QSizeF scaledSize;
-  const QSize imageSize = sizeForImage( *entry, viewBoxSize, scaledSize );
+  const QSize imageSize = sizeForImage( *entry, renderer, viewBoxSize, scaledSize );
 
   // cast double image sizes to int for QImage
   std::unique_ptr< QImage > image = std::make_unique< QImage >( imageSize, QImage::Format_ARGB32_Premultiplied );
@@ -437,20 +429,19 @@ void QgsSvgCache::cacheImage( QgsSvgCacheEntry *entry )
   const bool isFixedAR = entry->fixedAspectRatio > 0;
 
   QPainter p( image.get() );
-  QSvgRenderer r( entry->svgContent );
   if ( qgsDoubleNear( viewBoxSize.width(), viewBoxSize.height() ) )
   {
-    r.render( &p );
+    renderer.render( &p );
   }
   else
   {
     QSizeF s( viewBoxSize );
     s.scale( scaledSize.width(), scaledSize.height(), isFixedAR ? Qt::IgnoreAspectRatio : Qt::KeepAspectRatio );
     const QRectF rect( ( imageSize.width() - s.width() ) / 2, ( imageSize.height() - s.height() ) / 2, s.width(), s.height() );
-    r.render( &p, rect );
+    renderer.render( &p, rect );
   }
 
-  mTotalSize += ( image->width() * image->height() * 32 );
+  mTotalSize += image->sizeInBytes();
   entry->image = std::move( image );
 }
 
@@ -809,12 +800,17 @@ void QgsSvgCache::containsElemParams( const QDomElement &elem, bool &hasFillPara
 }
 
 QSize QgsSvgCache::sizeForImage( const QgsSvgCacheEntry &entry, QSizeF &viewBoxSize, QSizeF &scaledSize ) const
+{
+  const QSvgRenderer r( entry.svgContent );
+  return sizeForImage( entry, r, viewBoxSize, scaledSize );
+}
+
+QSize QgsSvgCache::sizeForImage( const QgsSvgCacheEntry &entry, const QSvgRenderer &renderer, QSizeF &viewBoxSize, QSizeF &scaledSize ) const
 {
   const bool isFixedAR = entry.fixedAspectRatio > 0;
 
-  const QSvgRenderer r( entry.svgContent );
   double hwRatio = 1.0;
-  viewBoxSize = r.viewBoxF().size();
+  viewBoxSize = renderer.viewBoxF().size();
   if ( viewBoxSize.width() > 0 )
   {
     if ( isFixedAR )
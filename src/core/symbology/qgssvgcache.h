@@ -24,6 +24,7 @@
 #include <QPicture>
 
 class QDomElement;
+class QSvgRenderer;
 
 #ifndef SIP_RUN
 
@@ -303,7 +304,8 @@ class CORE_EXPORT QgsSvgCache : public QgsAbstractContentCache< QgsSvgCacheEntry
   private:
 
     void replaceParamsAndCacheSvg( QgsSvgCacheEntry *entry, bool blocking = false );
-    void cacheImage( QgsSvgCacheEntry *entry );
+    //! Renders the image of an \a entry with the \a renderer of its SVG content
+    void cacheImage( QgsSvgCacheEntry *entry, QSvgRenderer &renderer );
     void cachePicture( QgsSvgCacheEntry *entry, bool forceVectorOutput = false );
     //! Returns entry from cache or creates a new entry if it does not exist already
     QgsSvgCacheEntry *cacheEntry( const QString &path, double size, const QColor &fill, const QColor &stroke, double strokeWidth,
@@ -328,6 +330,12 @@ class CORE_EXPORT QgsSvgCache : public QgsAbstractContentCache< QgsSvgCacheEntry
      */
     QSize sizeForImage( const QgsSvgCacheEntry &entry, QSizeF &viewBoxSize, QSizeF &scaledSize ) const;
 
+    /**
+     * Returns the target size (in pixels) and calculates the \a viewBoxSize
+     * for a cache \a entry, using an existing \a renderer of its SVG content.
+     */
+    QSize sizeForImage( const QgsSvgCacheEntry &entry, const QSvgRenderer &renderer, QSizeF &viewBoxSize, QSizeF &scaledSize ) const;
+
     /**
      * Returns a rendered image for a cached picture \a entry.
      */
@@ -43,6 +43,7 @@
 #include "qgspolygon.h"
 #include "qgsclipper.h"
 #include "qgsproperty.h"
+#include "qgspropertyevaluationcache.h"
 #include "qgscolorschemeregistry.h"
 #include "qgsapplication.h"
 #include "qgsexpressioncontextutils.h"
@@ -55,6 +56,88 @@
 
 QgsPropertiesDefinition QgsSymbol::sPropertyDefinitions;
 
+//! Coordinate buffers reused by a thread, beyond this number of points they are released after each feature
+constexpr int MAX_RETAINED_COORDINATE_BUFFER_SIZE = 1 << 16;
+
+/**
+ * Temporary coordinate arrays used while converting 3D curves to screen coordinates.
+ *
+ * A rendering thread converts one curve at a time, so the arrays are kept between features
+ * instead of being allocated and freed for each part of each feature.
+ */
+struct QgsSymbolCoordinateBuffers
+{
+  QVector< double > x;
+  QVector< double > y;
+  QVector< double > z;
+  QVector< double > preTransformZ;
+  QVector< double > tempX;
+  QVector< double > tempY;
+  QVector< double > tempZ;
+
+  //! Copies the coordinates of \a curve to the x, y and z buffers, without sharing the curve data
+  void setCoordinates( const QgsLineString &curve )
+  {
+    copy( curve.xVector(), x );
+    copy( curve.yVector(), y );
+    copy( curve.zVector(), z );
+  }
+
+  static void copy( const QVector< double > &source, QVector< double > &destination )
+  {
+    destination.resize( source.size() );
+    std::copy( source.constBegin(), source.constEnd(), destination.begin() );
+  }
+
+  void clear()
+  {
+    for ( QVector< double > *buffer : { &x, &y, &z, &preTransformZ, &tempX, &tempY, &tempZ } )
+    {
+      if ( buffer->capacity() > MAX_RETAINED_COORDINATE_BUFFER_SIZE )
+        *buffer = QVector< double >();
+      else
+        buffer->resize( 0 );
+    }
+  }
+};
+
+#if defined(USE_THREAD_LOCAL) && !defined(Q_OS_WIN)
+thread_local QgsSymbolCoordinateBuffers sCoordinateBuffers;
+#endif
+
+/**
+ * Gives access to the coordinate buffers of the current thread, and clears them once the
+ * conversion of a curve is done.
+ */
+class QgsSymbolCoordinateBuffersScope
+{
+  public:
+    QgsSymbolCoordinateBuffersScope()
+#if defined(USE_THREAD_LOCAL) && !defined(Q_OS_WIN)
+      : mBuffers( sCoordinateBuffers )
+#endif
+    {
+      mBuffers.clear();
+    }
+
+    ~QgsSymbolCoordinateBuffersScope()
+    {
+      mBuffers.clear();
+    }
+
+    QgsSymbolCoordinateBuffersScope( const QgsSymbolCoordinateBuffersScope &other ) = delete;
+    QgsSymbolCoordinateBuffersScope &operator=( const QgsSymbolCoordinateBuffersScope &other ) = delete;
+
+    QgsSymbolCoordinateBuffers &buffers() { return mBuffers; }
+
+  private:
+#if defined(USE_THREAD_LOCAL) && !defined(Q_OS_WIN)
+    QgsSymbolCoordinateBuffers &mBuffers;
+#else
+    QgsSymbolCoordinateBuffers mBuffers;
+#endif
+};
+
 Q_NOWARN_DEPRECATED_PUSH // because of deprecated mLayer
 QgsSymbol::QgsSymbol( Qgis::SymbolType type, const QgsSymbolLayerList &layers )
   : mType( type )
@@ -91,9 +174,11 @@ QPolygonF QgsSymbol::_getLineString3d( QgsRenderContext &context, const QgsCurve
 
   QgsCoordinateTransform ct = context.coordinateTransform();
   const QgsMapToPixel &mtp = context.mapToPixel();
-  QVector< double > pointsX;
-  QVector< double > pointsY;
-  QVector< double > pointsZ;
+  QgsSymbolCoordinateBuffersScope bufferScope;
+  QgsSymbolCoordinateBuffers &buffers = bufferScope.buffers();
+  QVector< double > &pointsX = buffers.x;
+  QVector< double > &pointsY = buffers.y;
+  QVector< double > &pointsZ = buffers.z;
 
   // apply clipping for large lines to achieve a better rendering performance
   if ( clipToExtent && nPoints > 1 && !( context.flags() & Qgis::RenderContextFlag::ApplyClipAfterReprojection ) )
@@ -104,13 +189,13 @@ QPolygonF QgsSymbol::_getLineString3d( QgsRenderContext &context, const QgsCurve
     const QgsBox3d clipRect( e.xMinimum() - cw, e.yMinimum() - ch, -HUGE_VAL, e.xMaximum() + cw, e.yMaximum() + ch, HUGE_VAL ); // TODO also need to be clipped according to z axis
 
     const QgsLineString *lineString = nullptr;
+    std::unique_ptr< QgsLineString > segmentized;
     if ( const QgsLineString *ls = qgsgeometry_cast< const QgsLineString * >( &curve ) )
     {
       lineString = ls;
     }
     else
     {
-      std::unique_ptr< QgsLineString > segmentized;
       segmentized.reset( qgsgeometry_cast< QgsLineString * >( curve.segmentize( ) ) );
       lineString = segmentized.get();
     }
@@ -122,29 +207,26 @@ QPolygonF QgsSymbol::_getLineString3d( QgsRenderContext &context, const QgsCurve
     // clone...
     if ( const QgsLineString *ls = qgsgeometry_cast<const QgsLineString *>( &curve ) )
     {
-      pointsX = ls->xVector();
-      pointsY = ls->yVector();
-      pointsZ = ls->zVector();
+      buffers.setCoordinates( *ls );
     }
     else
     {
       std::unique_ptr< QgsLineString > segmentized;
       segmentized.reset( qgsgeometry_cast< QgsLineString * >( curve.segmentize( ) ) );
 
-      pointsX = segmentized->xVector();
-      pointsY = segmentized->yVector();
-      pointsZ = segmentized->zVector();
+      buffers.setCoordinates( *segmentized );
     }
   }
 
   // transform the points to screen coordinates
-  const QVector< double > preTransformPointsZ = pointsZ;
+  const QVector< double > &preTransformPointsZ = buffers.preTransformZ;
   bool wasTransformed = false;
   if ( ct.isValid() )
   {
     //create x, y arrays
     const int nVertices = pointsX.size();
     wasTransformed = true;
+    QgsSymbolCoordinateBuffers::copy( pointsZ, buffers.preTransformZ );
 
     try
     {
@@ -211,26 +293,21 @@ QPolygonF QgsSymbol::_getLineString3d( QgsRenderContext &context, const QgsCurve
     const double ch = e.height() / 10;
     const QgsBox3d clipRect( e.xMinimum() - cw, e.yMinimum() - ch, -HUGE_VAL, e.xMaximum() + cw, e.yMaximum() + ch, HUGE_VAL ); // TODO also need to be clipped according to z axis
 
-    QVector< double > tempX;
-    QVector< double > tempY;
-    QVector< double > tempZ;
-    QgsClipper::clipped3dLine( pointsX, pointsY, pointsZ, tempX, tempY, tempZ, clipRect );
-    pointsX = tempX;
-    pointsY = tempY;
-    pointsZ = tempZ;
+    QgsClipper::clipped3dLine( pointsX, pointsY, pointsZ, buffers.tempX, buffers.tempY, buffers.tempZ, clipRect );
+    std::swap( pointsX, buffers.tempX );
+    std::swap( pointsY, buffers.tempY );
+    std::swap( pointsZ, buffers.tempZ );
   }
 
   const int polygonSize = pointsX.size();
+  mtp.transformCoords( polygonSize, pointsX.data(), pointsY.data() );
   QPolygonF out( polygonSize );
   const double *x = pointsX.constData();
   const double *y = pointsY.constData();
   QPointF *dest = out.data();
   for ( int i = 0; i < polygonSize; ++i )
   {
-    double screenX = *x++;
-    double screenY = *y++;
-    mtp.transformInPlace( screenX, screenY );
-    *dest++ = QPointF( screenX, screenY );
+    *dest++ = QPointF( *x++, *y++ );
   }
 
   return out;
@@ -288,11 +365,7 @@ QPolygonF QgsSymbol::_getLineString2d( QgsRenderContext &context, const QgsCurve
     pts = QgsClipper::clippedLine( pts, clipRect );
   }
 
-  QPointF *ptr = pts.data();
-  for ( int i = 0; i < pts.size(); ++i, ++ptr )
-  {
-    mtp.transformInPlace( ptr->rx(), ptr->ry() );
-  }
+  mtp.transformPolygon( pts );
 
   return pts;
 }
@@ -311,13 +384,15 @@ QPolygonF QgsSymbol::_getPolygonRing3d( QgsRenderContext &context, const QgsCurv
   const QgsCoordinateTransform ct = context.coordinateTransform();
   const QgsMapToPixel &mtp = context.mapToPixel();
 
-  QVector< double > pointsX;
-  QVector< double > pointsY;
-  QVector< double > pointsZ;
-
   if ( curve.numPoints() < 1 )
     return QPolygonF();
 
+  QgsSymbolCoordinateBuffersScope bufferScope;
+  QgsSymbolCoordinateBuffers &buffers = bufferScope.buffers();
+  QVector< double > &pointsX = buffers.x;
+  QVector< double > &pointsY = buffers.y;
+  QVector< double > &pointsZ = buffers.z;
+
   bool reverseRing = false;
   if ( correctRingOrientation )
   {
@@ -348,9 +423,7 @@ QPolygonF QgsSymbol::_getPolygonRing3d( QgsRenderContext &context, const QgsCurv
       lineString = segmentized.get();
     }
 
-    pointsX = lineString->xVector();
-    pointsY = lineString->yVector();
-    pointsZ = lineString->zVector();
+    buffers.setCoordinates( *lineString );
 
     QgsClipper::trimPolygon( pointsX, pointsY, pointsZ, clipRect );
   }
@@ -359,18 +432,14 @@ QPolygonF QgsSymbol::_getPolygonRing3d( QgsRenderContext &context, const QgsCurv
     // clone...
     if ( const QgsLineString *ls = qgsgeometry_cast<const QgsLineString *>( &curve ) )
     {
-      pointsX = ls->xVector();
-      pointsY = ls->yVector();
-      pointsZ = ls->zVector();
+      buffers.setCoordinates( *ls );
     }
     else
     {
       std::unique_ptr< QgsLineString > segmentized;
       segmentized.reset( qgsgeometry_cast< QgsLineString * >( curve.segmentize( ) ) );
 
-      pointsX = segmentized->xVector();
-      pointsY = segmentized->yVector();
-      pointsZ = segmentized->zVector();
+      buffers.setCoordinates( *segmentized );
     }
   }
 
@@ -382,12 +451,13 @@ QPolygonF QgsSymbol::_getPolygonRing3d( QgsRenderContext &context, const QgsCurv
   }
 
   //transform the QPolygonF to screen coordinates
-  const QVector< double > preTransformPointsZ = pointsZ;
+  const QVector< double > &preTransformPointsZ = buffers.preTransformZ;
   bool wasTransformed = false;
   if ( ct.isValid() )
   {
     const int nVertices = pointsX.size();
     wasTransformed = true;
+    QgsSymbolCoordinateBuffers::copy( pointsZ, buffers.preTransformZ );
     try
     {
       ct.transformCoords( nVertices, pointsX.data(), pointsY.data(), pointsZ.data(), Qgis::TransformDirection::Forward );
@@ -456,16 +526,14 @@ QPolygonF QgsSymbol::_getPolygonRing3d( QgsRenderContext &context, const QgsCurv
   }
 
   const int polygonSize = pointsX.size();
+  mtp.transformCoords( polygonSize, pointsX.data(), pointsY.data() );
   QPolygonF out( polygonSize );
   const double *x = pointsX.constData();
   const double *y = pointsY.constData();
   QPointF *dest = out.data();
   for ( int i = 0; i < polygonSize; ++i )
   {
-    double screenX = *x++;
-    double screenY = *y++;
-    mtp.transformInPlace( screenX, screenY );
-    *dest++ = QPointF( screenX, screenY );
+    *dest++ = QPointF( *x++, *y++ );
   }
 
   if ( !out.empty() && !out.isClosed() )
@@ -534,11 +602,7 @@ QPolygonF QgsSymbol::_getPolygonRing2d( QgsRenderContext &context, const QgsCurv
     QgsClipper::trimPolygon( poly, clipRect );
   }
 
-  QPointF *ptr = poly.data();
-  for ( int i = 0; i < poly.size(); ++i, ++ptr )
-  {
-    mtp.transformInPlace( ptr->rx(), ptr->ry() );
-  }
+  mtp.transformPolygon( poly );
 
   if ( !poly.empty() && !poly.isClosed() )
     poly << poly.at( 0 );
@@ -856,7 +920,12 @@ void QgsSymbol::startRender( QgsRenderContext &context, const QgsFields &fields
 
   mSymbolRenderContext->setExpressionContextScope( scope.release() );
 
-  mDataDefinedProperties.prepare( context.expressionContext() );
+  // properties of the symbol and its layers reading the same source evaluate it once per feature
+  const std::shared_ptr< QgsPropertyEvaluationCache > propertyEvaluationCache = std::make_shared< QgsPropertyEvaluationCache >();
+  mSymbolRenderContext->setPropertyEvaluationCache( propertyEvaluationCache );
+  symbolContext.setPropertyEvaluationCache( propertyEvaluationCache );
+
+  mDataDefinedProperties.prepare( context.expressionContext(), propertyEvaluationCache );
 
   const auto constMLayers = mLayers;
   for ( QgsSymbolLayer *layer : constMLayers )
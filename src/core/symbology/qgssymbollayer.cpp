@@ -275,7 +275,7 @@ QColor QgsSymbolLayer::fillColor() const
 
 void QgsSymbolLayer::prepareExpressions( const QgsSymbolRenderContext &context )
 {
-  mDataDefinedProperties.prepare( context.renderContext().expressionContext() );
+  mDataDefinedProperties.prepare( context.renderContext().expressionContext(), context.propertyEvaluationCache() );
 
   if ( !context.fields().isEmpty() )
   {
@@ -16,6 +16,7 @@
 #include "qgssymbolrendercontext.h"
 #include "qgsrendercontext.h"
 #include "qgslegendpatchshape.h"
+#include "qgspropertyevaluationcache.h"
 
 QgsSymbolRenderContext::QgsSymbolRenderContext( QgsRenderContext &c, QgsUnitTypes::RenderUnit u, qreal opacity, bool selected, Qgis::SymbolRenderHints renderHints, const QgsFeature *f, const QgsFields &fields, const QgsMapUnitScale &mapUnitScale )
   : mRenderContext( c )
@@ -78,3 +79,13 @@ void QgsSymbolRenderContext::setPatchShape( const QgsLegendPatchShape &patchShap
 {
   mPatchShape.reset( new QgsLegendPatchShape( patchShape ) );
 }
+
+std::shared_ptr< QgsPropertyEvaluationCache > QgsSymbolRenderContext::propertyEvaluationCache() const
+{
+  return mPropertyEvaluationCache;
+}
+
+void QgsSymbolRenderContext::setPropertyEvaluationCache( const std::shared_ptr< QgsPropertyEvaluationCache > &cache )
+{
+  mPropertyEvaluationCache = cache;
+}
@@ -23,10 +23,13 @@
 #include "qgsfields.h"
 #include "qgswkbtypes.h"
 
+#include <memory>
+
 class QgsRenderContext;
 class QgsFeature;
 class QgsLegendPatchShape;
 class QgsExpressionContextScope;
+class QgsPropertyEvaluationCache;
 
 /**
  * \ingroup core
@@ -236,6 +239,26 @@ class CORE_EXPORT QgsSymbolRenderContext
      */
     void setPatchShape( const QgsLegendPatchShape &shape );
 
+    /**
+     * Returns the cache sharing the source values of the data defined properties prepared
+     * with this context, or NULLPTR if not set.
+     *
+     * \see setPropertyEvaluationCache()
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    std::shared_ptr< QgsPropertyEvaluationCache > propertyEvaluationCache() const SIP_SKIP;
+
+    /**
+     * Sets the \a cache sharing the source values of the data defined properties prepared
+     * with this context.
+     *
+     * \see propertyEvaluationCache()
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    void setPropertyEvaluationCache( const std::shared_ptr< QgsPropertyEvaluationCache > &cache ) SIP_SKIP;
+
   private:
 
 #ifdef SIP_RUN
@@ -255,6 +278,7 @@ class CORE_EXPORT QgsSymbolRenderContext
     int mGeometryPartNum;
     QgsWkbTypes::GeometryType mOriginalGeometryType = QgsWkbTypes::UnknownGeometry;
     std::unique_ptr< QgsLegendPatchShape > mPatchShape;
+    std::shared_ptr< QgsPropertyEvaluationCache > mPropertyEvaluationCache;
 };
 
 
@@ -29,6 +29,8 @@
 #include <optional>
 
 #include <QTextBoundaryFinder>
+#include <QCache>
+#include <QMutex>
 
 Q_GUI_EXPORT extern int qt_defaultDpiX();
 Q_GUI_EXPORT extern int qt_defaultDpiY();
@@ -43,6 +45,55 @@ static void _fixQPictureDPI( QPainter *p )
             static_cast< double >( qt_defaultDpiY() ) / p->device()->logicalDpiY() );
 }
 
+///@cond PRIVATE
+
+// maximum number of path elements held by the text path cache
+static constexpr int TEXT_PATH_CACHE_MAX_ELEMENTS = 2000000;
+
+/**
+ * Cache of the outlines of rendered text, shared by all render threads. The same text is often
+ * drawn many times with the same font (e.g. the labels of a street split into several features),
+ * and creating its outlines is the most expensive part of drawing it.
+ */
+struct QgsTextPathCache
+{
+  QMutex mutex;
+  QCache< QString, QPainterPath > paths{ TEXT_PATH_CACHE_MAX_ELEMENTS };
+};
+
+Q_GLOBAL_STATIC( QgsTextPathCache, sTextPathCache )
+
+///@endcond
+
+static void _addTextToPath( QPainterPath &path, double x, double y, const QFont &font, const QString &text )
+{
+  // QFont::key() does not include the spacing and shaping properties of the font
+  const QString key = font.key() + '|' + QString::number( font.letterSpacing() ) + '|' + QString::number( static_cast< int >( font.letterSpacingType() ) )
+                      + '|' + QString::number( font.wordSpacing() ) + '|' + QString::number( static_cast< int >( font.capitalization() ) )
+                      + '|' + QString::number( font.kerning() ) + '|' + QString::number( font.stretch() ) + '|' + QString::number( static_cast< int >( font.hintingPreference() ) )
+                      + '|' + text;
+
+  QPainterPath textPath;
+  bool found = false;
+  {
+    const QMutexLocker locker( &sTextPathCache()->mutex );
+    if ( const QPainterPath *cachedPath = sTextPathCache()->paths.object( key ) )
+    {
+      textPath = *cachedPath;
+      found = true;
+    }
+  }
+
+  if ( !found )
+  {
+    textPath.addText( 0, 0, font, text );
+    const QMutexLocker locker( &sTextPathCache()->mutex );
+    sTextPathCache()->paths.insert( key, new QPainterPath( textPath ), std::max( 1, textPath.elementCount() ) );
+  }
+
+  path.addPath( textPath.translated( x, y ) );
+}
+
 Qgis::TextHorizontalAlignment QgsTextRenderer::convertQtHAlignment( Qt::Alignment alignment )
 {
   if ( alignment & Qt::AlignLeft )
@@ -372,7 +423,7 @@ double QgsTextRenderer::drawBuffer( QgsRenderContext &context, const QgsTextRend
           applyExtraSpacingForLineJustification( fragmentFont, component.extraWordSpacing, component.extraLetterSpacing );
 
         const double yOffset = metrics.fragmentVerticalOffset( component.blockIndex, fragmentIndex, mode );
-        path.addText( xOffset, yOffset, fragmentFont, fragment.text() );
+        _addTextToPath( path, xOffset, yOffset, fragmentFont, fragment.text() );
 
         xOffset += metrics.fragmentHorizontalAdvance( component.blockIndex, fragmentIndex, mode );
 
@@ -406,7 +457,7 @@ double QgsTextRenderer::drawBuffer( QgsRenderContext &context, const QgsTextRend
         {
           double partXOffset = ( blockMaximumCharacterWidth - ( fragmentMetrics.horizontalAdvance( part ) / scaleFactor - letterSpacing ) ) / 2;
           partYOffset += fragmentMetrics.ascent() / scaleFactor;
-          path.addText( partXOffset, partYOffset + fragmentYOffset, fragmentFont, part );
+          _addTextToPath( path, partXOffset, partYOffset + fragmentYOffset, fragmentFont, part );
           partYOffset += letterSpacing;
         }
         partLastDescent = fragmentMetrics.descent() / scaleFactor;
@@ -537,7 +588,7 @@ void QgsTextRenderer::drawMask( QgsRenderContext &context, const QgsTextRenderer
     const QFont fragmentFont = metrics.fragmentFont( component.blockIndex, fragmentIndex );
 
     const double fragmentYOffset = metrics.fragmentVerticalOffset( component.blockIndex, fragmentIndex, mode );
-    path.addText( xOffset, fragmentYOffset, fragmentFont, fragment.text() );
+    _addTextToPath( path, xOffset, fragmentYOffset, fragmentFont, fragment.text() );
 
     xOffset += metrics.fragmentHorizontalAdvance( component.blockIndex, fragmentIndex, mode );
     fragmentIndex++;
@@ -1641,7 +1692,7 @@ void QgsTextRenderer::drawTextInternalHorizontal( QgsRenderContext &context, con
 
           const double yOffset = metrics.fragmentVerticalOffset( blockIndex, fragmentIndex, mode );
 
-          path.addText( xOffset, yOffset, fragmentFont, fragment.text() );
+          _addTextToPath( path, xOffset, yOffset, fragmentFont, fragment.text() );
 
           QColor textColor = fragment.characterFormat().textColor().isValid() ? fragment.characterFormat().textColor() : format.color();
           textColor.setAlphaF( fragment.characterFormat().textColor().isValid() ? textColor.alphaF() * format.opacity() : format.opacity() );
@@ -1904,7 +1955,7 @@ void QgsTextRenderer::drawTextInternalVertical( QgsRenderContext &context, const
         {
           double partXOffset = ( blockMaximumCharacterWidth - ( fragmentMetrics.horizontalAdvance( part ) / fontScale - letterSpacing ) ) / 2;
           partYOffset += fragmentMetrics.ascent() / fontScale;
-          path.addText( partXOffset * fontScale, partYOffset * fontScale, fragmentFont, part );
+          _addTextToPath( path, partXOffset * fontScale, partYOffset * fontScale, fragmentFont, part );
           partYOffset += letterSpacing;
         }
 
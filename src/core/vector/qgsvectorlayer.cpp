@@ -58,6 +58,7 @@
 #include "qgsvectorlayereditpassthrough.h"
 #include "qgsvectorlayereditutils.h"
 #include "qgsvectorlayerfeatureiterator.h"
+#include "qgsvectorlayerreprojectioncache.h"
 #include "qgsvectorlayerjoinbuffer.h"
 #include "qgsvectorlayerlabeling.h"
 #include "qgsvectorlayerrenderer.h"
@@ -94,6 +95,7 @@
 #include <QPolygonF>
 #include <QProgressDialog>
 #include <QString>
+#include <QThread>
 #include <QDomNode>
 #include <QVector>
 #include <QStringBuilder>
@@ -233,6 +235,28 @@ QgsVectorLayer::QgsVectorLayer( const QString &vectorLayerPath,
   connect( this, &QgsVectorLayer::dataSourceChanged, this, &QgsVectorLayer::supportsEditingChanged );
   connect( this, &QgsVectorLayer::readOnlyChanged, this, &QgsVectorLayer::supportsEditingChanged );
 
+  // keep reprojected geometries in sync with edits
+  connect( this, &QgsVectorLayer::geometryChanged, this, [ = ]( QgsFeatureId fid )
+  {
+    if ( mReprojectionCache )
+      mReprojectionCache->invalidate( fid );
+  } );
+  connect( this, &QgsVectorLayer::featureDeleted, this, [ = ]( QgsFeatureId fid )
+  {
+    if ( mReprojectionCache )
+      mReprojectionCache->invalidate( fid );
+  } );
+  // committing changes the ids of added features, and rolling back restores the original geometries
+  const auto clearReprojectionCache = [ = ]
+  {
+    if ( mReprojectionCache )
+      mReprojectionCache->clear();
+  };
+  connect( this, &QgsMapLayer::dataChanged, this, clearReprojectionCache );
+  connect( this, &QgsMapLayer::dataSourceChanged, this, clearReprojectionCache );
+  connect( this, &QgsVectorLayer::afterCommitChanges, this, clearReprojectionCache );
+  connect( this, &QgsVectorLayer::afterRollBack, this, clearReprojectionCache );
+
   // Default simplify drawing settings
   QgsSettings settings;
   mSimplifyMethod.setSimplifyHints( QgsVectorLayer::settingsSimplifyDrawingHints->valueWithDefaultOverride( mSimplifyMethod.simplifyHints() ) );
@@ -456,6 +480,7 @@ QgsMapLayerRenderer *QgsVectorLayer::createMapRenderer( QgsRenderContext &render
   // non fatal for now -- the "rasterize" processing algorithm is not thread safe and calls this
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS_NON_FATAL
 
+  createDeferredProvider();
   return new QgsVectorLayerRenderer( this, rendererContext );
 }
 
@@ -735,6 +760,7 @@ QgsVectorDataProvider *QgsVectorLayer::dataProvider()
   // non fatal for now -- the "rasterize" processing algorithm is not thread safe and calls this
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS_NON_FATAL
 
+  createDeferredProvider();
   return mDataProvider;
 }
 
@@ -743,9 +769,49 @@ const QgsVectorDataProvider *QgsVectorLayer::dataProvider() const
   // non fatal for now -- the "rasterize" processing algorithm is not thread safe and calls this
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS_NON_FATAL
 
+  createDeferredProvider();
   return mDataProvider;
 }
 
+bool QgsVectorLayer::isProviderCreationDeferred() const
+{
+  QGIS_PROTECT_QOBJECT_THREAD_ACCESS_NON_FATAL
+
+  return mProviderCreationDeferred;
+}
+
+bool QgsVectorLayer::createDeferredProvider() const
+{
+  if ( !mProviderCreationDeferred )
+    return mDataProvider;
+
+  // the provider belongs to the layer, it can't be created from another thread
+  if ( QThread::currentThread() != thread() )
+  {
+    QgsDebugMsg( QStringLiteral( "Deferred data provider of layer %1 can't be created from another thread" ).arg( id() ) );
+    return false;
+  }
+
+  QgsVectorLayer *layer = const_cast< QgsVectorLayer * >( this );
+  if ( !layer->setDataProvider( mProviderKey, mDeferredProviderOptions, mDeferredProviderFlags ) )
+  {
+    QgsDebugMsg( QStringLiteral( "Could not set deferred data provider for layer %1" ).arg( publicSource() ) );
+    return false;
+  }
+
+  if ( !mDeferredProviderEncoding.isEmpty() )
+  {
+    mDataProvider->setEncoding( mDeferredProviderEncoding );
+    layer->updateFields();
+  }
+
+  // the key field of the auxiliary layer was unknown while reading the project
+  if ( !mAuxiliaryLayer && !mAuxiliaryLayerKey.isEmpty() && project() )
+    layer->loadAuxiliaryLayer( *project()->auxiliaryStorage() );
+
+  return true;
+}
+
 QgsMapLayerTemporalProperties *QgsVectorLayer::temporalProperties()
 {
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS
@@ -947,7 +1013,8 @@ QgsVectorLayerFeatureCounter *QgsVectorLayer::countSymbolFeatures( bool storeSym
     mFeatureCounter = new QgsVectorLayerFeatureCounter( this, QgsExpressionContext(), storeSymbolFids );
     connect( mFeatureCounter, &QgsTask::taskCompleted, this, &QgsVectorLayer::onFeatureCounterCompleted, Qt::UniqueConnection );
     connect( mFeatureCounter, &QgsTask::taskTerminated, this, &QgsVectorLayer::onFeatureCounterTerminated, Qt::UniqueConnection );
-    QgsApplication::taskManager()->addTask( mFeatureCounter );
+    // feature counts are shown in the layer tree, so they are queued ahead of background tasks like exports
+    QgsApplication::taskManager()->addTask( mFeatureCounter, 100 );
   }
 
   return mFeatureCounter;
@@ -1155,6 +1222,39 @@ bool QgsVectorLayer::simplifyDrawingCanbeApplied( const QgsRenderContext &render
   return false;
 }
 
+void QgsVectorLayer::setReprojectionCacheMaximumSize( int bytes )
+{
+  QGIS_PROTECT_QOBJECT_THREAD_ACCESS
+
+  if ( bytes <= 0 )
+  {
+    // renderers still running keep their own reference to the cache
+    mReprojectionCache.reset();
+  }
+  else if ( mReprojectionCache )
+  {
+    mReprojectionCache->setMaximumSize( bytes );
+  }
+  else
+  {
+    mReprojectionCache = std::make_shared< QgsVectorLayerReprojectionCache >( bytes );
+  }
+}
+
+int QgsVectorLayer::reprojectionCacheMaximumSize() const
+{
+  QGIS_PROTECT_QOBJECT_THREAD_ACCESS
+
+  return mReprojectionCache ? mReprojectionCache->maximumSize() : 0;
+}
+
+std::shared_ptr< QgsVectorLayerReprojectionCache > QgsVectorLayer::reprojectionCache() const
+{
+  QGIS_PROTECT_QOBJECT_THREAD_ACCESS
+
+  return mReprojectionCache;
+}
+
 QgsConditionalLayerStyles *QgsVectorLayer::conditionalStyles() const
 {
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS
@@ -1167,7 +1267,7 @@ QgsFeatureIterator QgsVectorLayer::getFeatures( const QgsFeatureRequest &request
   // non fatal for now -- the aggregate expression functions are not thread safe and call this
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS_NON_FATAL
 
-  if ( !isValid() || !mDataProvider )
+  if ( !isValid() || !createDeferredProvider() )
     return QgsFeatureIterator();
 
   return QgsFeatureIterator( new QgsVectorLayerFeatureIterator( new QgsVectorLayerFeatureSource( this ), true, request ) );
@@ -1665,7 +1765,7 @@ bool QgsVectorLayer::startEditing()
   if ( project() && project()->transactionMode() == Qgis::TransactionMode::BufferedGroups )
     return project()->startEditing( this );
 
-  if ( !isValid() || !mDataProvider )
+  if ( !isValid() || !createDeferredProvider() )
   {
     return false;
   }
@@ -1766,7 +1866,16 @@ bool QgsVectorLayer::readXml( const QDomNode &layer_node, QgsReadWriteContext &c
   {
     flags |= QgsDataProvider::FlagTrustDataSource;
   }
-  if ( ( mReadFlags & QgsMapLayer::FlagDontResolveLayers ) || !setDataProvider( mProviderKey, options, flags ) )
+  // the provider creation can only be deferred if the geometry type of the layer is known
+  if ( ( mReadFlags & QgsMapLayer::FlagDeferProviderCreation ) && !( mReadFlags & QgsMapLayer::FlagDontResolveLayers ) && elem.hasAttribute( QStringLiteral( "wkbType" ) ) )
+  {
+    mProviderCreationDeferred = true;
+    mDeferredProviderOptions = options;
+    mDeferredProviderFlags = flags;
+    mWkbType = qgsEnumKeyToValue( elem.attribute( QStringLiteral( "wkbType" ) ), mWkbType );
+    setValid( true );
+  }
+  else if ( ( mReadFlags & QgsMapLayer::FlagDontResolveLayers ) || !setDataProvider( mProviderKey, options, flags ) )
   {
     if ( !( mReadFlags & QgsMapLayer::FlagDontResolveLayers ) )
     {
@@ -1791,6 +1900,10 @@ bool QgsVectorLayer::readXml( const QDomNode &layer_node, QgsReadWriteContext &c
     {
       mDataProvider->setEncoding( encodingString );
     }
+    else if ( mProviderCreationDeferred )
+    {
+      mDeferredProviderEncoding = encodingString;
+    }
   }
 
   // load vector joins - does not resolve references to layers yet
@@ -1997,6 +2110,7 @@ bool QgsVectorLayer::setDataProvider( QString const &provider, const QgsDataProv
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS
 
   mProviderKey = provider;
+  mProviderCreationDeferred = false;
   delete mDataProvider;
 
   // For Postgres provider primary key unicity is tested at construction time,
@@ -2019,7 +2133,11 @@ bool QgsVectorLayer::setDataProvider( QString const &provider, const QgsDataProv
   if ( QgsApplication::profiler()->groupIsActive( QStringLiteral( "projectload" ) ) )
     profile = std::make_unique< QgsScopedRuntimeProfile >( tr( "Create %1 provider" ).arg( provider ), QStringLiteral( "projectload" ) );
 
-  mDataProvider = qobject_cast<QgsVectorDataProvider *>( QgsProviderRegistry::instance()->createProvider( provider, mDataSource, options, flags ) );
+  std::unique_ptr< QgsDataProvider > preloadedProvider( takePreloadedProvider( provider, mDataSource ) );
+  if ( qobject_cast< QgsVectorDataProvider * >( preloadedProvider.get() ) )
+    mDataProvider = qobject_cast< QgsVectorDataProvider * >( preloadedProvider.release() );
+  else
+    mDataProvider = qobject_cast<QgsVectorDataProvider *>( QgsProviderRegistry::instance()->createProvider( provider, mDataSource, options, flags ) );
   if ( !mDataProvider )
   {
     setValid( false );
@@ -2940,6 +3058,9 @@ bool QgsVectorLayer::writeSymbology( QDomNode &node, QDomDocument &doc, QString
 {
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS
 
+  // the configuration of the fields can't be written without the fields of the provider
+  createDeferredProvider();
+
   QDomElement layerElement = node.toElement();
   writeCommonStyle( layerElement, doc, context, categories );
 
@@ -3768,7 +3889,7 @@ long long QgsVectorLayer::featureCount() const
 {
   QGIS_PROTECT_QOBJECT_THREAD_ACCESS
 
-  if ( !mDataProvider )
+  if ( !createDeferredProvider() )
     return static_cast< long long >( Qgis::FeatureCountState::UnknownCount );
   return mDataProvider->featureCount() +
          ( mEditBuffer && ! mDataProvider->transaction() ? mEditBuffer->addedFeatures().size() - mEditBuffer->deletedFeatureIds().size() : 0 );
@@ -4977,8 +5098,9 @@ QVariant QgsVectorLayer::aggregate( QgsAggregateCalculator::Aggregate aggregate,
   {
     // aggregate is based on a field - if it's a provider field, we could possibly hand over the calculation
     // to the provider itself
+    // providers don't know about the uncommitted changes of the edit buffer
     QgsFields::FieldOrigin origin = mFields.fieldOrigin( attrIndex );
-    if ( origin == QgsFields::OriginProvider )
+    if ( origin == QgsFields::OriginProvider && !( mEditBuffer && mEditBuffer->isModified() ) )
     {
       bool providerOk = false;
       QVariant val = mDataProvider->aggregate( aggregate, attrIndex, parameters, context, providerOk, fids );
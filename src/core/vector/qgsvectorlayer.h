@@ -25,6 +25,7 @@
 #include <QStringList>
 #include <QFont>
 #include <QMutex>
+#include <memory>
 
 #include "qgis.h"
 #include "qgsmaplayer.h"
@@ -70,6 +71,7 @@ class QgsVectorLayerJoinInfo;
 class QgsVectorLayerEditBuffer;
 class QgsVectorLayerJoinBuffer;
 class QgsVectorLayerFeatureCounter;
+class QgsVectorLayerReprojectionCache;
 class QgsAbstractVectorLayerLabeling;
 class QgsPalLayerSettings;
 class QgsPoint;
@@ -138,6 +140,10 @@ typedef QSet<int> QgsAttributeIds;
  *   definition is any string accepted by QgsCoordinateReferenceSystem::createFromString()
  * - index=yes
  *   Specifies that the layer will be constructed with a spatial index
+ * - storage=columnar
+ *   Stores the attributes in typed columns and the geometries as WKB, which uses
+ *   several times less memory for large layers, at the cost of creating the features
+ *   each time they are read (since QGIS 3.30)
  * - field=name:type(length,precision)
  *   Defines an attribute of the layer. Multiple field parameters can be added
  *   to the data provider definition. type is one of "integer", "double", "string".
@@ -371,6 +377,14 @@ typedef QSet<int> QgsAttributeIds;
  *
  *   Determines whether the provider generates a spatial index.  The default is no.
  *
+ * - indexFile=(yes|no)
+ *
+ *   Determines whether the results of scanning the file, the byte offsets of its
+ *   records and the spatial index are saved in a sidecar file next to it
+ *   (with a .qdtidx extension), so that they are read from the sidecar rather than
+ *   rebuilt when the layer is loaded again and the file has not changed.
+ *   The default is no.  (Since QGIS 3.30)
+ *
  * - watchFile=(yes|no)
  *
  *   Defines whether the file will be monitored for changes. The default is
@@ -661,8 +675,27 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
      */
     QString displayExpression() const;
 
+    /**
+     * Returns the data provider of the layer.
+     *
+     * If the creation of the provider was deferred, it is created by this call.
+     *
+     * \see isProviderCreationDeferred()
+     */
     QgsVectorDataProvider *dataProvider() FINAL;
     const QgsVectorDataProvider *dataProvider() const FINAL SIP_SKIP;
+
+    /**
+     * Returns TRUE if the layer was read with the QgsMapLayer::FlagDeferProviderCreation flag and
+     * its data provider has not been created yet.
+     *
+     * The provider is created when the layer is first rendered or queried, e.g. by dataProvider(),
+     * getFeatures() or createMapRenderer(). Until then, the extent, geometry type and CRS of the layer
+     * are the ones stored in the project, and fields() only contains the joined and expression fields.
+     *
+     * \since QGIS 3.30
+     */
+    bool isProviderCreationDeferred() const;
     QgsMapLayerTemporalProperties *temporalProperties() override;
     QgsMapLayerElevationProperties *elevationProperties() override;
     QgsAbstractProfileGenerator *createProfileGenerator( const QgsProfileRequest &request ) override SIP_FACTORY;
@@ -2370,6 +2403,40 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
      */
     bool simplifyDrawingCanbeApplied( const QgsRenderContext &renderContext, QgsVectorSimplifyMethod::SimplifyHint simplifyHint ) const;
 
+    /**
+     * Sets the maximum size, in bytes, of the cache storing the feature geometries reprojected to the
+     * destination CRS when rendering the layer.
+     *
+     * When this cache is enabled, rendering the layer again with the same destination CRS, e.g. when
+     * panning or zooming a map, reuses the reprojected geometries instead of reprojecting them for each frame.
+     * The cached geometries of edited features are invalidated automatically.
+     *
+     * A size of 0, the default, disables the cache.
+     *
+     * \see reprojectionCacheMaximumSize()
+     * \since QGIS 3.30
+     */
+    void setReprojectionCacheMaximumSize( int bytes );
+
+    /**
+     * Returns the maximum size, in bytes, of the cache storing the feature geometries reprojected to the
+     * destination CRS when rendering the layer, or 0 if the cache is disabled.
+     *
+     * \see setReprojectionCacheMaximumSize()
+     * \since QGIS 3.30
+     */
+    int reprojectionCacheMaximumSize() const;
+
+    /**
+     * Returns the cache storing the feature geometries reprojected when rendering the layer,
+     * or NULLPTR if the cache is disabled.
+     *
+     * \see setReprojectionCacheMaximumSize()
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    std::shared_ptr< QgsVectorLayerReprojectionCache > reprojectionCache() const SIP_SKIP;
+
     /**
      * Returns the conditional styles that are set for this layer. Style information is
      * used to render conditional formatting in the attribute table.
@@ -2896,6 +2963,12 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
     //! Returns the minimum or maximum value
     void minimumOrMaximumValue( int index, QVariant *minimum, QVariant *maximum ) const;
 
+    /**
+     * Creates the data provider of the layer if its creation was deferred.
+     * Returns FALSE if the layer has no data provider.
+     */
+    bool createDeferredProvider() const;
+
     void createEditBuffer();
     void clearEditBuffer();
 
@@ -2918,6 +2991,12 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
     //! Flag indicating whether the layer has been created in read-only mode (editing disabled) or not
     bool mDataSourceReadOnly = false;
 
+    //! TRUE if the data provider will be created when the layer is first used, see createDeferredProvider()
+    bool mProviderCreationDeferred = false;
+    QgsDataProvider::ProviderOptions mDeferredProviderOptions;
+    QgsDataProvider::ReadFlags mDeferredProviderFlags;
+    QString mDeferredProviderEncoding;
+
     /**
      * Flag indicating whether the layer has been converted in read-only mode (editing disabled) or not
      * \see setReadOnly()
@@ -2974,6 +3053,9 @@ class CORE_EXPORT QgsVectorLayer : public QgsMapLayer, public QgsExpressionConte
     //! Simplification object which holds the information about how to simplify the features for fast rendering
     QgsVectorSimplifyMethod mSimplifyMethod;
 
+    //! Cache of the geometries reprojected when rendering, shared with the layer renderers
+    std::shared_ptr< QgsVectorLayerReprojectionCache > mReprojectionCache;
+
     //! Labeling configuration
     QgsAbstractVectorLayerLabeling *mLabeling = nullptr;
 
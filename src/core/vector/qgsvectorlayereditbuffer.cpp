@@ -290,9 +290,10 @@ bool QgsVectorLayerEditBuffer::changeAttributeValue( QgsFeatureId fid, int field
     return false;
   }
 
-  if ( field < 0 || field >= L->fields().count() ||
-       L->fields().fieldOrigin( field ) == QgsFields::OriginJoin ||
-       L->fields().fieldOrigin( field ) == QgsFields::OriginExpression )
+  const QgsFields fields = L->fields();
+  if ( field < 0 || field >= fields.count() ||
+       fields.fieldOrigin( field ) == QgsFields::OriginJoin ||
+       fields.fieldOrigin( field ) == QgsFields::OriginExpression )
     return false;
 
   L->undoStack()->push( new QgsVectorLayerUndoCommandChangeAttribute( this, fid, field, newValue, oldValue ) );
@@ -32,6 +32,13 @@
 #include <QThreadStorage>
 #include <QStack>
 
+///@cond PRIVATE
+
+//! Maximum number of join values memoized by the direct lookups of a join
+constexpr int MAX_DIRECT_JOIN_LOOKUPS = 10000;
+
+///@endcond
+
 QgsVectorLayerFeatureSource::QgsVectorLayerFeatureSource( const QgsVectorLayer *layer )
 {
   const QMutexLocker locker( &layer->mFeatureSourceConstructorMutex );
@@ -129,6 +136,11 @@ QString QgsVectorLayerFeatureSource::id() const
   return mId;
 }
 
+void QgsVectorLayerFeatureSource::setProviderFeatureSource( QgsAbstractFeatureSource *source )
+{
+  mProviderFeatureSource.reset( source );
+}
+
 
 QgsVectorLayerFeatureIterator::QgsVectorLayerFeatureIterator( QgsVectorLayerFeatureSource *source, bool ownSource, const QgsFeatureRequest &request )
   : QgsAbstractFeatureIteratorFromSource<QgsVectorLayerFeatureSource>( source, ownSource, request )
@@ -1100,6 +1112,32 @@ bool QgsVectorLayerFeatureIterator::providerCanSimplify( QgsSimplifyMethod::Meth
   return false;
 }
 
+bool QgsVectorLayerFeatureIterator::providerCanFetchBatch() const
+{
+  // the provider features must not need any change or check from the layer side
+  return !mSource->mHasEditBuffer && !mHasVirtualAttributes
+         && mRequest.filterType() != QgsFeatureRequest::FilterFid
+         && ( mRequest.filterType() != QgsFeatureRequest::FilterExpression || mProviderRequest.filterType() == QgsFeatureRequest::FilterExpression )
+         && mRequest.invalidGeometryCheck() == QgsFeatureRequest::GeometryNoCheck
+         && ( mTransform.isShortCircuited() || ( mRequest.flags() & QgsFeatureRequest::NoGeometry ) )
+         && !mDistanceWithinEngine;
+}
+
+void QgsVectorLayerFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  if ( mClosed )
+    return;
+
+  if ( mProviderIterator.isClosed() && mSource->mProviderFeatureSource )
+  {
+    mProviderIterator = mSource->mProviderFeatureSource->getFeatures( mProviderRequest );
+    mProviderIterator.setInterruptionChecker( mInterruptionChecker );
+  }
+
+  if ( !mProviderIterator.nextBatch( batch, maxFeatures ) )
+    close();
+}
+
 
 void QgsVectorLayerFeatureIterator::FetchJoinInfo::addJoinedAttributesCached( QgsFeature &f, const QVariant &joinValue ) const
 {
@@ -1129,7 +1167,21 @@ void QgsVectorLayerFeatureIterator::FetchJoinInfo::addJoinedAttributesDirect( Qg
   }
 #endif
 
-  // no memory cache, query the joined values by setting substring
+  // no memory cache, but the values already looked up while iterating are memoized, as many
+  // features usually share the same join value
+  const bool memoize = !QgsVariantUtils::isNull( joinValue );
+  const QString lookupKey = memoize ? joinValue.toString() : QString();
+  if ( memoize )
+  {
+    const auto lookupIt = directLookups.constFind( lookupKey );
+    if ( lookupIt != directLookups.constEnd() )
+    {
+      setJoinedAttributes( f, lookupIt.value() );
+      return;
+    }
+  }
+
+  // query the joined values by setting substring
   QString subsetString;
 
   const QString joinFieldName = joinInfo->joinFieldName();
@@ -1159,53 +1211,70 @@ void QgsVectorLayerFeatureIterator::FetchJoinInfo::addJoinedAttributesDirect( Qg
     subsetString += '=' + v;
   }
 
-  QList<int> joinedAttributeIndices;
-
-  // maybe user requested just a subset of layer's attributes
-  // so we do not have to cache everything
-  if ( joinInfo->hasSubset() )
-  {
-    const QStringList subsetNames = QgsVectorLayerJoinInfo::joinFieldNamesSubset( *joinInfo, joinLayerFields );
-    const QVector<int> subsetIndices = QgsVectorLayerJoinBuffer::joinSubsetIndices( joinLayerFields, subsetNames );
-    joinedAttributeIndices = qgis::setToList( qgis::listToSet( attributes ).intersect( qgis::listToSet( subsetIndices.toList() ) ) );
-  }
-  else
+  if ( !directLookupAttributes )
   {
-    joinedAttributeIndices = attributes;
-  }
+    QList<int> joinedAttributeIndices;
+
+    // maybe user requested just a subset of layer's attributes
+    // so we do not have to cache everything
+    if ( joinInfo->hasSubset() )
+    {
+      const QStringList subsetNames = QgsVectorLayerJoinInfo::joinFieldNamesSubset( *joinInfo, joinLayerFields );
+      const QVector<int> subsetIndices = QgsVectorLayerJoinBuffer::joinSubsetIndices( joinLayerFields, subsetNames );
+      joinedAttributeIndices = qgis::setToList( qgis::listToSet( attributes ).intersect( qgis::listToSet( subsetIndices.toList() ) ) );
+    }
+    else
+    {
+      joinedAttributeIndices = attributes;
+    }
 
-  // we don't need the join field, it is already present in the other table
-  joinedAttributeIndices.removeAll( joinField );
+    // we don't need the join field, it is already present in the other table
+    joinedAttributeIndices.removeAll( joinField );
+    directLookupAttributes = joinedAttributeIndices;
+  }
 
   // select (no geometry)
   QgsFeatureRequest request;
   request.setFlags( QgsFeatureRequest::NoGeometry );
-  request.setSubsetOfAttributes( joinedAttributeIndices );
+  request.setSubsetOfAttributes( *directLookupAttributes );
   request.setFilterExpression( subsetString );
   request.setLimit( 1 );
   QgsFeatureIterator fi = joinSource->getFeatures( request );
 
   // get first feature
-  const QList<int> sourceAttrIndexes = attributesSourceToDestLayerMap.keys();
   QgsFeature fet;
+  QgsAttributes attr;
   if ( fi.nextFeature( fet ) )
   {
-    const QgsAttributes attr = fet.attributes();
-
-    for ( const int sourceAttrIndex : sourceAttrIndexes )
-    {
-      if ( sourceAttrIndex == joinField )
-        continue;
-
-      const int destAttrIndex = attributesSourceToDestLayerMap.value( sourceAttrIndex );
-
-      f.setAttribute( destAttrIndex, attr.at( sourceAttrIndex ) );
-    }
+    attr = fet.attributes();
+    setJoinedAttributes( f, attr );
   }
   else
   {
     // no suitable join feature found, keeping empty (null) attributes
   }
+
+  if ( memoize )
+  {
+    // bound the memory used by the lookups of layers with many distinct join values
+    if ( directLookups.size() >= MAX_DIRECT_JOIN_LOOKUPS )
+      directLookups.clear();
+    directLookups.insert( lookupKey, attr );
+  }
+}
+
+void QgsVectorLayerFeatureIterator::FetchJoinInfo::setJoinedAttributes( QgsFeature &f, const QgsAttributes &joinedAttributes ) const
+{
+  if ( joinedAttributes.isEmpty() )
+    return;
+
+  for ( auto it = attributesSourceToDestLayerMap.constBegin(); it != attributesSourceToDestLayerMap.constEnd(); ++it )
+  {
+    if ( it.key() == joinField )
+      continue;
+
+    f.setAttribute( it.value(), joinedAttributes.at( it.key() ) );
+  }
 }
 
 
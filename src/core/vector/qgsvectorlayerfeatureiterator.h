@@ -27,6 +27,7 @@
 #include <QPointer>
 #include <QSet>
 #include <memory>
+#include <optional>
 
 typedef QMap<QgsFeatureId, QgsFeature> QgsFeatureMap SIP_SKIP;
 
@@ -91,6 +92,16 @@ class CORE_EXPORT QgsVectorLayerFeatureSource : public QgsAbstractFeatureSource
      */
     QString id() const;
 
+    /**
+     * Replaces the source of the data provider features with another \a source, such as the source of
+     * the overview features of the layer. Ownership of \a source is transferred.
+     *
+     * \see QgsVectorLayerOverviews::createFeatureSource()
+     * \note not available in Python bindings
+     * \since QGIS 3.30
+     */
+    void setProviderFeatureSource( QgsAbstractFeatureSource *source ) SIP_SKIP;
+
   protected:
 
     std::unique_ptr< QgsAbstractFeatureSource > mProviderFeatureSource;
@@ -209,8 +220,32 @@ class CORE_EXPORT QgsVectorLayerFeatureIterator : public QgsAbstractFeatureItera
       //!< Index of field (of the joined layer) must have equal value
       int joinField;
 
+#ifndef SIP_RUN
+
+      /**
+       * Attributes of the joined features already looked up by value in the joined layer, when the
+       * join has no memory cache. Join values without joined feature have empty attributes.
+       *
+       * \note Not available in Python bindings
+       * \since QGIS 3.30
+       */
+      mutable QHash< QString, QgsAttributes > directLookups;
+
+      /**
+       * Indices of the attributes of the joined layer requested by the direct lookups, computed by the first lookup.
+       *
+       * \note Not available in Python bindings
+       * \since QGIS 3.30
+       */
+      mutable std::optional< QgsAttributeList > directLookupAttributes;
+#endif
+
       void addJoinedAttributesCached( QgsFeature &f, const QVariant &joinValue ) const;
       void addJoinedAttributesDirect( QgsFeature &f, const QVariant &joinValue ) const;
+
+    private:
+      //! Sets the attributes of \a f joined from the \a joinedAttributes of a joined feature
+      void setJoinedAttributes( QgsFeature &f, const QgsAttributes &joinedAttributes ) const;
     };
 
     bool isValid() const override;
@@ -347,6 +382,15 @@ class CORE_EXPORT QgsVectorLayerFeatureIterator : public QgsAbstractFeatureItera
     //! returns whether the iterator supports simplify geometries on provider side
     bool providerCanSimplify( QgsSimplifyMethod::MethodType methodType ) const override;
 
+    /**
+     * Returns TRUE if the features of the provider iterator are returned unchanged, i.e. when the layer
+     * has no edit buffer and no joined or expression fields are fetched, and the request has no filter
+     * applied by the layer. The batches are then filled by the provider iterator.
+     */
+    bool providerCanFetchBatch() const override;
+
+    void fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) override;
+
     void createOrderedJoinList();
 
     /**
@@ -0,0 +1,338 @@
+/***************************************************************************
+  qgsvectorlayeroverviews.cpp
+  --------------------------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsvectorlayeroverviews.h"
+#include "qgsfeatureiterator.h"
+#include "qgsfeedback.h"
+#include "qgsproviderregistry.h"
+#include "qgsunittypes.h"
+#include "qgsvectordataprovider.h"
+#include "qgsvectorfilewriter.h"
+#include "qgsvectorlayer.h"
+
+#include <algorithm>
+#include <memory>
+
+#define OVERVIEWS_PATH_PROPERTY QStringLiteral( "overviews/path" )
+#define OVERVIEWS_SCALES_PROPERTY QStringLiteral( "overviews/scales" )
+
+///@cond PRIVATE
+
+static QString _overviewLayerName( int index )
+{
+  return QStringLiteral( "overview_%1" ).arg( index );
+}
+
+/**
+ * Feature source reading the features of an overview with the fields of the layer data provider.
+ */
+class QgsVectorLayerOverviewFeatureSource : public QgsAbstractFeatureSource
+{
+  public:
+
+    QgsVectorLayerOverviewFeatureSource( QgsAbstractFeatureSource *overviewSource, const QgsFields &fields, const QVector< int > &overviewIndexes )
+      : mOverviewSource( overviewSource )
+      , mFields( fields )
+      , mOverviewIndexes( overviewIndexes )
+    {}
+
+    QgsFeatureIterator getFeatures( const QgsFeatureRequest &request ) override;
+
+    std::unique_ptr< QgsAbstractFeatureSource > mOverviewSource;
+    QgsFields mFields;
+    //! Index of the overview field for each field of the layer data provider, or -1
+    QVector< int > mOverviewIndexes;
+};
+
+/**
+ * Iterator mapping the overview features to the fields of the layer data provider.
+ *
+ * Filtering and ordering are applied by the overview iterator.
+ */
+class QgsVectorLayerOverviewFeatureIterator : public QgsAbstractFeatureIteratorFromSource< QgsVectorLayerOverviewFeatureSource >
+{
+  public:
+
+    QgsVectorLayerOverviewFeatureIterator( QgsVectorLayerOverviewFeatureSource *source, bool ownSource, const QgsFeatureRequest &request )
+      : QgsAbstractFeatureIteratorFromSource< QgsVectorLayerOverviewFeatureSource >( source, ownSource, request )
+    {
+      QgsFeatureRequest overviewRequest( mRequest );
+      if ( mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes )
+      {
+        QgsAttributeList attributes;
+        for ( const int attribute : mRequest.subsetOfAttributes() )
+        {
+          const int overviewIndex = mSource->mOverviewIndexes.value( attribute, -1 );
+          if ( overviewIndex >= 0 )
+            attributes << overviewIndex;
+        }
+        overviewRequest.setSubsetOfAttributes( attributes );
+      }
+      mOverviewIterator = mSource->mOverviewSource->getFeatures( overviewRequest );
+      mValid = mOverviewIterator.isValid();
+    }
+
+    ~QgsVectorLayerOverviewFeatureIterator() override
+    {
+      close();
+    }
+
+    bool rewind() override
+    {
+      if ( mClosed )
+        return false;
+      return mOverviewIterator.rewind();
+    }
+
+    bool close() override
+    {
+      if ( mClosed )
+        return false;
+      mOverviewIterator.close();
+      iteratorClosed();
+      mClosed = true;
+      return true;
+    }
+
+  protected:
+
+    bool fetchFeature( QgsFeature &feature ) override
+    {
+      feature.setValid( false );
+      if ( mClosed )
+        return false;
+
+      QgsFeature overviewFeature;
+      if ( !mOverviewIterator.nextFeature( overviewFeature ) )
+        return false;
+
+      const QgsAttributes overviewAttributes = overviewFeature.attributes();
+      QgsAttributes attributes( mSource->mFields.count() );
+      for ( int i = 0; i < attributes.count(); ++i )
+      {
+        const int overviewIndex = mSource->mOverviewIndexes.at( i );
+        if ( overviewIndex >= 0 && overviewIndex < overviewAttributes.count() )
+          attributes[i] = overviewAttributes.at( overviewIndex );
+      }
+
+      feature.setId( overviewFeature.id() );
+      feature.setFields( mSource->mFields, false );
+      feature.setAttributes( attributes );
+      feature.setGeometry( overviewFeature.geometry() );
+      feature.setValid( true );
+      return true;
+    }
+
+    bool nextFeatureFilterExpression( QgsFeature &feature ) override
+    {
+      return fetchFeature( feature );
+    }
+
+    bool nextFeatureFilterFids( QgsFeature &feature ) override
+    {
+      return fetchFeature( feature );
+    }
+
+  private:
+
+    bool prepareOrderBy( const QList<QgsFeatureRequest::OrderByClause> &orderBys ) override
+    {
+      Q_UNUSED( orderBys )
+      return true;
+    }
+
+    QgsFeatureIterator mOverviewIterator;
+};
+
+QgsFeatureIterator QgsVectorLayerOverviewFeatureSource::getFeatures( const QgsFeatureRequest &request )
+{
+  return QgsFeatureIterator( new QgsVectorLayerOverviewFeatureIterator( this, false, request ) );
+}
+
+///@endcond
+
+double QgsVectorLayerOverviews::tolerance( const QgsVectorLayer *layer, double scale )
+{
+  // size of a pixel at 96 dpi, in meters
+  const double metersPerPixel = scale * 0.0254 / 96;
+  return metersPerPixel * QgsUnitTypes::fromUnitToUnitFactor( QgsUnitTypes::DistanceMeters, layer->crs().mapUnits() );
+}
+
+bool QgsVectorLayerOverviews::build( QgsVectorLayer *layer, const QString &path, const QList< double > &scales, QgsFeedback *feedback, QString *errorMessage )
+{
+  if ( !layer || !layer->dataProvider() || !layer->isSpatial() )
+  {
+    if ( errorMessage )
+      *errorMessage = QObject::tr( "Overviews can only be built for vector layers with geometries" );
+    return false;
+  }
+
+  QList< double > sortedScales;
+  for ( const double scale : scales )
+  {
+    if ( scale > 0 && !sortedScales.contains( scale ) )
+      sortedScales << scale;
+  }
+  std::sort( sortedScales.begin(), sortedScales.end() );
+  if ( sortedScales.isEmpty() )
+  {
+    if ( errorMessage )
+      *errorMessage = QObject::tr( "No overview scale set" );
+    return false;
+  }
+
+  QgsVectorDataProvider *provider = layer->dataProvider();
+  const QgsFields providerFields = provider->fields();
+
+  // the feature ids are stored in the "fid" column, which is the feature id column of the GeoPackage
+  QgsFields overviewFields;
+  overviewFields.append( QgsField( QStringLiteral( "fid" ), QVariant::LongLong ) );
+  QVector< int > providerIndexes;
+  providerIndexes << -1;
+  for ( int i = 0; i < providerFields.count(); ++i )
+  {
+    if ( providerFields.at( i ).name().compare( QLatin1String( "fid" ), Qt::CaseInsensitive ) == 0 )
+      continue;
+    overviewFields.append( providerFields.at( i ) );
+    providerIndexes << i;
+  }
+
+  const long long featureCount = provider->featureCount();
+  for ( int level = 0; level < sortedScales.count(); ++level )
+  {
+    QgsVectorFileWriter::SaveVectorOptions options;
+    options.driverName = QStringLiteral( "GPKG" );
+    options.layerName = _overviewLayerName( level );
+    options.actionOnExistingFile = level == 0 ? QgsVectorFileWriter::CreateOrOverwriteFile : QgsVectorFileWriter::CreateOrOverwriteLayer;
+    std::unique_ptr< QgsVectorFileWriter > writer( QgsVectorFileWriter::create( path, overviewFields, provider->wkbType(), provider->crs(), layer->transformContext(), options ) );
+    if ( writer->hasError() != QgsVectorFileWriter::NoError )
+    {
+      if ( errorMessage )
+        *errorMessage = writer->errorMessage();
+      return false;
+    }
+
+    const double tolerance = QgsVectorLayerOverviews::tolerance( layer, sortedScales.at( level ) );
+    QgsFeatureIterator it = provider->getFeatures();
+    QgsFeature feature;
+    long long current = 0;
+    while ( it.nextFeature( feature ) )
+    {
+      if ( feedback && feedback->isCanceled() )
+        return false;
+
+      QgsAttributes attributes;
+      attributes.reserve( providerIndexes.count() );
+      attributes << feature.id();
+      for ( int i = 1; i < providerIndexes.count(); ++i )
+        attributes << feature.attribute( providerIndexes.at( i ) );
+
+      QgsFeature overviewFeature( overviewFields, feature.id() );
+      overviewFeature.setAttributes( attributes );
+      if ( feature.hasGeometry() )
+      {
+        // keep features too small to be simplified as they are, so that they are still rendered
+        const QgsGeometry simplified = feature.geometry().simplify( tolerance );
+        overviewFeature.setGeometry( simplified.isEmpty() ? feature.geometry() : simplified );
+      }
+
+      if ( !writer->addFeature( overviewFeature ) )
+      {
+        if ( errorMessage )
+          *errorMessage = writer->errorMessage();
+        return false;
+      }
+
+      if ( feedback && featureCount > 0 )
+        feedback->setProgress( 100.0 * ( level + static_cast< double >( ++current ) / featureCount ) / sortedScales.count() );
+    }
+  }
+
+  QStringList scaleStrings;
+  for ( const double scale : std::as_const( sortedScales ) )
+    scaleStrings << qgsDoubleToString( scale );
+  layer->setCustomProperty( OVERVIEWS_PATH_PROPERTY, path );
+  layer->setCustomProperty( OVERVIEWS_SCALES_PROPERTY, scaleStrings );
+  return true;
+}
+
+void QgsVectorLayerOverviews::remove( QgsVectorLayer *layer )
+{
+  layer->removeCustomProperty( OVERVIEWS_PATH_PROPERTY );
+  layer->removeCustomProperty( OVERVIEWS_SCALES_PROPERTY );
+}
+
+QString QgsVectorLayerOverviews::path( const QgsVectorLayer *layer )
+{
+  return layer->customProperty( OVERVIEWS_PATH_PROPERTY ).toString();
+}
+
+QList< double > QgsVectorLayerOverviews::scales( const QgsVectorLayer *layer )
+{
+  QList< double > scales;
+  const QStringList scaleStrings = layer->customProperty( OVERVIEWS_SCALES_PROPERTY ).toStringList();
+  for ( const QString &scaleString : scaleStrings )
+  {
+    bool ok = false;
+    const double scale = scaleString.toDouble( &ok );
+    if ( ok && scale > 0 )
+      scales << scale;
+  }
+  std::sort( scales.begin(), scales.end() );
+  return scales;
+}
+
+QgsAbstractFeatureSource *QgsVectorLayerOverviews::createFeatureSource( const QgsVectorLayer *layer, double scale )
+{
+  if ( !layer->dataProvider() || scale <= 0 )
+    return nullptr;
+
+  const QString overviewsPath = path( layer );
+  if ( overviewsPath.isEmpty() )
+    return nullptr;
+
+  // use the smallest overview scale reached by the map
+  const QList< double > overviewScales = scales( layer );
+  int level = -1;
+  for ( int i = 0; i < overviewScales.count(); ++i )
+  {
+    if ( overviewScales.at( i ) <= scale )
+      level = i;
+  }
+  if ( level < 0 )
+    return nullptr;
+
+  const QString uri = QgsProviderRegistry::instance()->encodeUri( QStringLiteral( "ogr" ), QVariantMap
+  {
+    {QStringLiteral( "path" ), overviewsPath },
+    {QStringLiteral( "layerName" ), _overviewLayerName( level ) }
+  } );
+  const QgsDataProvider::ProviderOptions options { layer->transformContext() };
+  std::unique_ptr< QgsVectorDataProvider > overviewProvider( qobject_cast< QgsVectorDataProvider * >( QgsProviderRegistry::instance()->createProvider( QStringLiteral( "ogr" ), uri, options ) ) );
+  if ( !overviewProvider || !overviewProvider->isValid() )
+    return nullptr;
+
+  const QString subset = layer->dataProvider()->subsetString();
+  if ( !subset.isEmpty() && !overviewProvider->setSubsetString( subset ) )
+    return nullptr;
+
+  const QgsFields fields = layer->dataProvider()->fields();
+  const QgsFields overviewFields = overviewProvider->fields();
+  QVector< int > overviewIndexes;
+  overviewIndexes.reserve( fields.count() );
+  for ( const QgsField &field : fields )
+    overviewIndexes << overviewFields.lookupField( field.name() );
+
+  return new QgsVectorLayerOverviewFeatureSource( overviewProvider->featureSource(), fields, overviewIndexes );
+}
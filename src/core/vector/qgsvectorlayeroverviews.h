@@ -0,0 +1,96 @@
+/***************************************************************************
+  qgsvectorlayeroverviews.h
+  --------------------------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSVECTORLAYEROVERVIEWS_H
+#define QGSVECTORLAYEROVERVIEWS_H
+
+#include "qgis_core.h"
+#include "qgis_sip.h"
+
+#include <QList>
+#include <QString>
+
+class QgsAbstractFeatureSource;
+class QgsFeedback;
+class QgsVectorLayer;
+
+/**
+ * \ingroup core
+ * \class QgsVectorLayerOverviews
+ * \brief Builds and reads the overviews of a vector layer, i.e. copies of its features with
+ * geometries generalized for rendering at small map scales.
+ *
+ * The overviews are stored as the layers of a GeoPackage next to the data source of the layer,
+ * one for each scale. Overview features keep the feature IDs and attributes of the layer features,
+ * with geometries simplified to a tolerance of a pixel at the scale of the overview. When the map is
+ * rendered at or beyond the scale of an overview, its geometries are read in place of the layer ones.
+ *
+ * The location and the scales of the overviews are stored in the custom properties of the layer,
+ * so that they are saved in the project. Overviews are not updated when the features of the
+ * layer are changed, and must then be built again.
+ *
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsVectorLayerOverviews
+{
+  public:
+
+    /**
+     * Builds the overviews of a \a layer for the given map \a scales, storing them in the GeoPackage at \a path.
+     *
+     * An existing file at \a path is overwritten. Once built, the overviews are used to render the layer.
+     *
+     * \returns TRUE if the overviews were built, or FALSE if they could not be written or
+     * the \a feedback was canceled, with the \a errorMessage set in case of error.
+     */
+    static bool build( QgsVectorLayer *layer, const QString &path, const QList< double > &scales, QgsFeedback *feedback = nullptr, QString *errorMessage SIP_OUT = nullptr );
+
+    /**
+     * Removes the overviews from a \a layer, so that its features are always rendered at full resolution.
+     *
+     * The overviews file is not deleted.
+     */
+    static void remove( QgsVectorLayer *layer );
+
+    /**
+     * Returns the path of the GeoPackage storing the overviews of a \a layer, or an empty string if the
+     * layer has no overviews.
+     */
+    static QString path( const QgsVectorLayer *layer );
+
+    /**
+     * Returns the map scales of the overviews of a \a layer, from the largest to the smallest scale
+     * (i.e. sorted by increasing scale denominator).
+     */
+    static QList< double > scales( const QgsVectorLayer *layer );
+
+    /**
+     * Creates a source of the overview features of a \a layer to render at the map \a scale, or NULLPTR if
+     * the layer has no overview for this scale, or if its overviews cannot be read.
+     *
+     * The source provides the features with the fields of the layer data provider, so that it can replace
+     * the data provider source in a QgsVectorLayerFeatureSource. It must be created in the thread of the layer.
+     *
+     * \note not available in Python bindings
+     */
+    static QgsAbstractFeatureSource *createFeatureSource( const QgsVectorLayer *layer, double scale ) SIP_SKIP SIP_FACTORY;
+
+    /**
+     * Returns the tolerance, in the map units of a \a layer, used to simplify the geometries of an
+     * overview for the map \a scale.
+     */
+    static double tolerance( const QgsVectorLayer *layer, double scale );
+};
+
+#endif // QGSVECTORLAYEROVERVIEWS_H
@@ -31,6 +31,8 @@
 #include "qgsvectorlayerfeatureiterator.h"
 #include "qgsvectorlayerlabeling.h"
 #include "qgsvectorlayerlabelprovider.h"
+#include "qgsvectorlayerreprojectioncache.h"
+#include "qgsvectorlayeroverviews.h"
 #include "qgspainteffect.h"
 #include "qgsfeaturefilterprovider.h"
 #include "qgsexception.h"
@@ -42,14 +44,120 @@
 #include "qgsvectorlayertemporalproperties.h"
 #include "qgsmapclippingutils.h"
 #include "qgsfeaturerenderergenerator.h"
+#include "qgsruntimeprofiler.h"
+#include "qgsapplication.h"
 
 #include <QPicture>
+#include <QThread>
 #include <QTimer>
+#include <QtConcurrentRun>
+
+#include <deque>
+
+///@cond PRIVATE
+
+/**
+ * Draws features with their geometries reprojected to the destination CRS, as stored in the
+ * reprojection cache of the layer. The features are drawn with a render context without
+ * coordinate transform, exactly as the features of a layer in the destination CRS would be.
+ */
+class QgsVectorLayerReprojectedRendering
+{
+  public:
+
+    QgsVectorLayerReprojectedRendering( const std::shared_ptr< QgsVectorLayerReprojectionCache > &cache, quint64 generation,
+                                        const QgsCoordinateTransform &transform, const QgsRectangle &mapExtent,
+                                        const QgsVectorSimplifyMethod &simplifyMethod )
+      : mCache( cache )
+      , mGeneration( generation )
+      , mTransformKey( QgsVectorLayerReprojectionCache::transformKey( transform ) )
+      , mTransform( transform )
+      , mMapExtent( mapExtent )
+      , mSimplifyMethod( simplifyMethod )
+    {}
+
+    /**
+     * Draws \a feature with \a renderer, setting \a rendered to the result of QgsFeatureRenderer::renderFeature().
+     *
+     * Returns FALSE if the geometry of the feature cannot be reprojected, in which case the feature
+     * must be drawn as usual.
+     */
+    bool renderFeature( QgsFeatureRenderer *renderer, const QgsFeature &feature, QgsRenderContext &context,
+                        bool selected, bool drawVertexMarker, bool &rendered ) const
+    {
+      QgsGeometry geometry;
+      if ( !mCache->geometry( mTransformKey, feature.id(), geometry ) )
+      {
+        geometry = feature.geometry();
+        try
+        {
+          if ( geometry.transform( mTransform ) != Qgis::GeometryOperationResult::Success )
+            return false;
+        }
+        catch ( QgsCsException & )
+        {
+          return false;
+        }
+        mCache->insert( mTransformKey, feature.id(), geometry, mGeneration );
+      }
+
+      QgsFeature reprojected = feature;
+      reprojected.setGeometry( geometry );
+
+      const ContextState state( context, mMapExtent, mSimplifyMethod );
+      rendered = renderer->renderFeature( reprojected, context, -1, selected, drawVertexMarker );
+      return true;
+    }
+
+  private:
+
+    //! Switches the render context to the destination CRS, and restores it when destroyed
+    class ContextState
+    {
+      public:
+        ContextState( QgsRenderContext &context, const QgsRectangle &mapExtent, const QgsVectorSimplifyMethod &simplifyMethod )
+          : mContext( context )
+          , mTransform( context.coordinateTransform() )
+          , mExtent( context.extent() )
+          , mSimplifyMethod( context.vectorSimplifyMethod() )
+        {
+          context.setCoordinateTransform( QgsCoordinateTransform() );
+          context.setExtent( mapExtent );
+          context.setVectorSimplifyMethod( simplifyMethod );
+        }
+
+        ~ContextState()
+        {
+          mContext.setCoordinateTransform( mTransform );
+          mContext.setExtent( mExtent );
+          mContext.setVectorSimplifyMethod( mSimplifyMethod );
+        }
+
+        ContextState( const ContextState & ) = delete;
+        ContextState &operator=( const ContextState & ) = delete;
+
+      private:
+        QgsRenderContext &mContext;
+        QgsCoordinateTransform mTransform;
+        QgsRectangle mExtent;
+        QgsVectorSimplifyMethod mSimplifyMethod;
+    };
+
+    std::shared_ptr< QgsVectorLayerReprojectionCache > mCache;
+    quint64 mGeneration = 0;
+    QString mTransformKey;
+    QgsCoordinateTransform mTransform;
+    QgsRectangle mMapExtent;
+    QgsVectorSimplifyMethod mSimplifyMethod;
+};
+
+///@endcond
 
 QgsVectorLayerRenderer::QgsVectorLayerRenderer( QgsVectorLayer *layer, QgsRenderContext &context )
   : QgsMapLayerRenderer( layer->id(), &context )
   , mFeedback( std::make_unique< QgsFeedback >() )
   , mLayer( layer )
+  , mLayerName( layer->name() )
   , mFields( layer->fields() )
   , mSource( std::make_unique< QgsVectorLayerFeatureSource >( layer ) )
   , mNoSetLayerExpressionContext( layer->customProperty( QStringLiteral( "_noset_layer_expression_context" ) ).toBool() )
@@ -88,6 +196,25 @@ QgsVectorLayerRenderer::QgsVectorLayerRenderer( QgsVectorLayer *layer, QgsRender
 
   mSelectedFeatureIds = layer->selectedFeatureIds();
 
+  // at small scales, read the generalized geometries of the layer overviews
+  bool usingOverview = false;
+  if ( !layer->isEditable() )
+  {
+    if ( QgsAbstractFeatureSource *overviewSource = QgsVectorLayerOverviews::createFeatureSource( layer, context.rendererScale() ) )
+    {
+      mSource->setProviderFeatureSource( overviewSource );
+      usingOverview = true;
+    }
+  }
+
+  // the reprojection cache stores the full resolution geometries of the layer
+  mReprojectionCache = usingOverview ? nullptr : layer->reprojectionCache();
+  if ( mReprojectionCache )
+  {
+    // the feature source is a snapshot of the layer, geometries invalidated after this point must not be stored
+    mReprojectionCacheGeneration = mReprojectionCache->generation();
+  }
+
   mDrawVertexMarkers = nullptr != layer->editBuffer();
 
   mGeometryType = layer->geometryType();
@@ -219,6 +346,10 @@ bool QgsVectorLayerRenderer::render()
     mElapsedTimer.start();
   }
 
+  std::unique_ptr< QgsScopedRuntimeProfile > profile;
+  if ( renderContext()->testFlag( Qgis::RenderContextFlag::RecordProfile ) )
+    profile = std::make_unique< QgsScopedRuntimeProfile >( mLayerName, QStringLiteral( "render" ) );
+
   bool res = true;
   for ( const std::unique_ptr< QgsFeatureRenderer > &renderer : mRenderers )
   {
@@ -236,6 +367,10 @@ bool QgsVectorLayerRenderer::renderInternal( QgsFeatureRenderer *renderer )
   QgsRenderContext &context = *renderContext();
   context.setSymbologyReferenceScale( renderer->referenceScale() );
 
+  std::unique_ptr< QgsScopedRuntimeProfile > profile;
+  if ( context.testFlag( Qgis::RenderContextFlag::RecordProfile ) )
+    profile = std::make_unique< QgsScopedRuntimeProfile >( QObject::tr( "Preparing render" ), QStringLiteral( "render" ) );
+
   if ( renderer->type() == QLatin1String( "nullSymbol" ) )
   {
     // a little shortcut for the null symbol renderer - most of the time it is not going to render anything
@@ -314,6 +449,12 @@ bool QgsVectorLayerRenderer::renderInternal( QgsFeatureRenderer *renderer )
     featureRequest.setFlags( featureRequest.flags() | QgsFeatureRequest::EmbeddedSymbols );
   }
 
+  mReprojectedRendering.reset();
+  const bool useReprojectionCache = canUseReprojectionCache( renderer );
+  // cached geometries are simplified when rendered, in the destination CRS
+  QgsVectorSimplifyMethod reprojectedSimplifyMethod;
+  reprojectedSimplifyMethod.setSimplifyHints( QgsVectorSimplifyMethod::NoSimplification );
+
   // enable the simplification of the geometries (Using the current map2pixel context) before send it to renderer engine.
   if ( mSimplifyGeometry )
   {
@@ -371,11 +512,16 @@ bool QgsVectorLayerRenderer::renderInternal( QgsFeatureRenderer *renderer )
       simplifyMethod.setTolerance( map2pixelTol );
       simplifyMethod.setThreshold( mSimplifyMethod.threshold() );
       simplifyMethod.setForceLocalOptimization( mSimplifyMethod.forceLocalOptimization() );
-      featureRequest.setSimplifyMethod( simplifyMethod );
+      if ( !useReprojectionCache )
+        featureRequest.setSimplifyMethod( simplifyMethod );
 
       QgsVectorSimplifyMethod vectorMethod = mSimplifyMethod;
       vectorMethod.setTolerance( map2pixelTol );
       context.setVectorSimplifyMethod( vectorMethod );
+
+      reprojectedSimplifyMethod = mSimplifyMethod;
+      reprojectedSimplifyMethod.setTolerance( mSimplifyMethod.threshold() * mtp.mapUnitsPerPixel() );
+      reprojectedSimplifyMethod.setForceLocalOptimization( true );
     }
     else
     {
@@ -391,11 +537,20 @@ bool QgsVectorLayerRenderer::renderInternal( QgsFeatureRenderer *renderer )
     context.setVectorSimplifyMethod( vectorMethod );
   }
 
+  if ( useReprojectionCache )
+  {
+    mReprojectedRendering = std::make_unique< QgsVectorLayerReprojectedRendering >( mReprojectionCache, mReprojectionCacheGeneration,
+                            context.coordinateTransform(), context.mapExtent(), reprojectedSimplifyMethod );
+  }
+
   featureRequest.setFeedback( mFeedback.get() );
   // also set the interruption checker for the expression context, in case the renderer uses some complex expression
   // which could benefit from early exit paths...
   context.expressionContext().setFeedback( mFeedback.get() );
 
+  if ( profile )
+    profile->switchTask( QObject::tr( "Rendering features" ) );
+
   QgsFeatureIterator fit = mSource->getFeatures( featureRequest );
   // Attach an interruption checker so that iterators that have potentially
   // slow fetchFeature() implementations, such as in the WFS provider, can
@@ -405,6 +560,8 @@ bool QgsVectorLayerRenderer::renderInternal( QgsFeatureRenderer *renderer )
 
   if ( ( renderer->capabilities() & QgsFeatureRenderer::SymbolLevels ) && renderer->usingSymbolLevels() )
     drawRendererLevels( renderer, fit );
+  else if ( canDrawRendererInParallel( renderer ) )
+    drawRendererParallel( renderer, fit );
   else
     drawRenderer( renderer, fit );
 
@@ -419,6 +576,7 @@ bool QgsVectorLayerRenderer::renderInternal( QgsFeatureRenderer *renderer )
   }
 
   context.expressionContext().setFeedback( nullptr );
+  mReprojectedRendering.reset();
   return true;
 }
 
@@ -438,9 +596,27 @@ void QgsVectorLayerRenderer::drawRenderer( QgsFeatureRenderer *renderer, QgsFeat
     clipEngine->prepareGeometry();
   }
 
+  // when profiling, the time of each feature is split between fetching, symbol rendering and label registration
+  const bool recordProfile = context.testFlag( Qgis::RenderContextFlag::RecordProfile );
+  QElapsedTimer profileTimer;
+  qint64 fetchTime = 0;
+  qint64 symbolTime = 0;
+  qint64 labelingTime = 0;
+  auto addProfileTime = [recordProfile, &profileTimer]( qint64 & time )
+  {
+    if ( recordProfile )
+    {
+      time += profileTimer.nsecsElapsed();
+      profileTimer.start();
+    }
+  };
+  if ( recordProfile )
+    profileTimer.start();
+
   QgsFeature fet;
   while ( fit.nextFeature( fet ) )
   {
+    addProfileTime( fetchTime );
     try
     {
       if ( context.renderingStopped() )
@@ -468,12 +644,14 @@ void QgsVectorLayerRenderer::drawRenderer( QgsFeatureRenderer *renderer, QgsFeat
       bool rendered = false;
       if ( !context.testFlag( Qgis::RenderContextFlag::SkipSymbolRendering ) )
       {
-        rendered = renderer->renderFeature( fet, context, -1, sel, drawMarker );
+        if ( !mReprojectedRendering || !mReprojectedRendering->renderFeature( renderer, fet, context, sel, drawMarker, rendered ) )
+          rendered = renderer->renderFeature( fet, context, -1, sel, drawMarker );
       }
       else
       {
         rendered = renderer->willRenderFeature( fet, context );
       }
+      addProfileTime( symbolTime );
 
       // labeling - register feature
       if ( rendered )
@@ -519,6 +697,7 @@ void QgsVectorLayerRenderer::drawRenderer( QgsFeatureRenderer *renderer, QgsFeat
             context.setFeatureClipGeometry( QgsGeometry() );
         }
       }
+      addProfileTime( labelingTime );
     }
     catch ( const QgsCsException &cse )
     {
@@ -527,10 +706,19 @@ void QgsVectorLayerRenderer::drawRenderer( QgsFeatureRenderer *renderer, QgsFeat
                    .arg( fet.id() ).arg( cse.what() ) );
     }
   }
+  addProfileTime( fetchTime );
 
   delete context.expressionContext().popScope();
 
   stopRenderer( renderer, nullptr );
+
+  if ( recordProfile )
+  {
+    QgsApplication::profiler()->record( QObject::tr( "Fetching features" ), fetchTime / 1e9, QStringLiteral( "render" ) );
+    QgsApplication::profiler()->record( QObject::tr( "Rendering symbols" ), symbolTime / 1e9, QStringLiteral( "render" ) );
+    if ( isMainRenderer && ( mLabelProvider || mDiagramProvider ) )
+      QgsApplication::profiler()->record( QObject::tr( "Registering labels" ), labelingTime / 1e9, QStringLiteral( "render" ) );
+  }
 }
 
 void QgsVectorLayerRenderer::drawRendererLevels( QgsFeatureRenderer *renderer, QgsFeatureIterator &fit )
@@ -713,6 +901,278 @@ void QgsVectorLayerRenderer::drawRendererLevels( QgsFeatureRenderer *renderer, Q
   stopRenderer( renderer, selRenderer );
 }
 
+///@cond PRIVATE
+
+//! Number of features drawn by a thread of the parallel feature rendering at once
+constexpr int PARALLEL_RENDERING_BATCH_SIZE = 20000;
+
+//! A thread of the parallel feature rendering, drawing batches of features on its own image
+struct QgsVectorLayerRenderingSlot
+{
+  QImage image;
+  QPainter painter;
+  std::unique_ptr< QgsFeatureRenderer > renderer;
+  std::unique_ptr< QgsRenderContext > context;
+  QgsFeatureList features;
+  QFuture< void > future;
+};
+
+static void drawFeatureBatch( QgsFeatureRenderer *renderer, QgsRenderContext &context, const QgsFeatureList &features,
+                              const QgsFeatureIds &selectedFeatureIds, const QgsGeometry &clipFeatureGeom, bool applyClipGeometries,
+                              bool setExpressionContextFeature, const QgsVectorLayerReprojectedRendering *reprojectedRendering,
+                              QgsFeedback *feedback )
+{
+  for ( const QgsFeature &fet : features )
+  {
+    if ( feedback->isCanceled() )
+      break;
+
+    try
+    {
+      if ( applyClipGeometries )
+        context.setFeatureClipGeometry( clipFeatureGeom );
+
+      if ( setExpressionContextFeature )
+        context.expressionContext().setFeature( fet );
+
+      const bool sel = context.showSelection() && selectedFeatureIds.contains( fet.id() );
+      bool rendered = false;
+      if ( !reprojectedRendering || !reprojectedRendering->renderFeature( renderer, fet, context, sel, false, rendered ) )
+        renderer->renderFeature( fet, context, -1, sel, false );
+    }
+    catch ( const QgsCsException &cse )
+    {
+      Q_UNUSED( cse )
+      QgsDebugMsg( QStringLiteral( "Failed to transform a point while drawing a feature with ID '%1'. Ignoring this feature. %2" )
+                   .arg( fet.id() ).arg( cse.what() ) );
+    }
+  }
+}
+
+///@endcond
+
+//! Returns TRUE if \a symbol or one of its sub symbols contains a geometry generator symbol layer
+static bool containsGeometryGenerator( const QgsSymbol *symbol )
+{
+  const QgsSymbolLayerList layers = symbol->symbolLayers();
+  for ( QgsSymbolLayer *layer : layers )
+  {
+    if ( layer->layerType() == QLatin1String( "GeometryGenerator" ) )
+      return true;
+    if ( const QgsSymbol *subSymbol = layer->subSymbol() )
+    {
+      if ( containsGeometryGenerator( subSymbol ) )
+        return true;
+    }
+  }
+  return false;
+}
+
+bool QgsVectorLayerRenderer::canUseReprojectionCache( QgsFeatureRenderer *renderer )
+{
+  QgsRenderContext &context = *renderContext();
+  if ( !mReprojectionCache || context.testFlag( Qgis::RenderContextFlag::SkipSymbolRendering ) )
+    return false;
+
+  const QgsCoordinateTransform transform = context.coordinateTransform();
+  if ( !transform.isValid() || transform.isShortCircuited() )
+    return false;
+
+  // the feature clipping geometry is in the layer CRS
+  if ( mApplyClipGeometries )
+    return false;
+
+  // features drawn with symbol levels are not drawn through the cache
+  if ( ( renderer->capabilities() & QgsFeatureRenderer::SymbolLevels ) && renderer->usingSymbolLevels() )
+    return false;
+
+  // renderers whose symbols are selected through the expression context feature, which remains
+  // the original one. Others, e.g. the rule based renderer, evaluate the drawn feature.
+  static const QStringList sRenderers
+  {
+    QStringLiteral( "singleSymbol" ),
+    QStringLiteral( "categorizedSymbol" ),
+    QStringLiteral( "graduatedSymbol" )
+  };
+  if ( !sRenderers.contains( renderer->type() ) )
+    return false;
+
+  // geometry generators evaluate the original geometry and convert their result with the render context transform
+  const QgsSymbolList symbols = renderer->symbols( context );
+  return std::none_of( symbols.begin(), symbols.end(), []( const QgsSymbol * symbol ) { return containsGeometryGenerator( symbol ); } );
+}
+
+bool QgsVectorLayerRenderer::canDrawRendererInParallel( QgsFeatureRenderer *renderer ) const
+{
+  const QgsRenderContext &context = *renderContext();
+  if ( !context.testFlag( Qgis::RenderContextFlag::ParallelFeatureRendering )
+       || context.testFlag( Qgis::RenderContextFlag::SkipSymbolRendering )
+       || QThread::idealThreadCount() < 2 )
+    return false;
+
+  // labels, diagrams, vertex markers, masks and rendered feature handlers
+  // rely on the features being drawn one after the other on a single painter
+  if ( mLabelProvider || mDiagramProvider || mDrawVertexMarkers
+       || context.hasRenderedFeatureHandlers() || context.maskIdProvider() || context.currentMaskId() >= 0 )
+    return false;
+
+  // renderers drawing each feature on its own, the others (e.g. point clusters
+  // or heatmaps) need to see all the features. The rule based renderer queues
+  // the features and only draws them in stopRender(), in rendering passes.
+  static const QStringList sParallelRenderers
+  {
+    QStringLiteral( "singleSymbol" ),
+    QStringLiteral( "categorizedSymbol" ),
+    QStringLiteral( "graduatedSymbol" )
+  };
+  if ( !sParallelRenderers.contains( renderer->type() ) )
+    return false;
+
+  // composing the batch images with source over gives the same result as drawing all the
+  // features on the same image, as long as the features themselves are drawn with source over.
+  // Paint effects replace the painter with a QPicture one and are excluded by the device check.
+  QPainter *painter = context.painter();
+  return painter && painter->device() && painter->device()->devType() == QInternal::Image
+         && painter->compositionMode() == QPainter::CompositionMode_SourceOver
+         && !painter->hasClipping();
+}
+
+void QgsVectorLayerRenderer::drawRendererParallel( QgsFeatureRenderer *renderer, QgsFeatureIterator &fit )
+{
+  const bool isMainRenderer = renderer == mRenderer;
+  const QgsFeatureIds selectedFeatureIds = isMainRenderer ? mSelectedFeatureIds : QgsFeatureIds();
+
+  QgsRenderContext &context = *renderContext();
+  QPainter *painter = context.painter();
+  const QImage *target = static_cast< const QImage * >( painter->device() );
+
+  std::unique_ptr< QgsGeometryEngine > clipEngine;
+  if ( mApplyClipFilter )
+  {
+    clipEngine.reset( QgsGeometry::createGeometryEngine( mClipFilterGeom.constGet() ) );
+    clipEngine->prepareGeometry();
+  }
+
+  std::vector< std::unique_ptr< QgsVectorLayerRenderingSlot > > renderingSlots;
+  std::deque< QgsVectorLayerRenderingSlot * > pending;
+  std::deque< QgsVectorLayerRenderingSlot * > available;
+  const int maxSlots = std::max( 2, QThread::idealThreadCount() );
+
+  // composes the batch of the oldest pending slot on the layer image, preserving the feature order
+  auto composeOldest = [&]
+  {
+    QgsVectorLayerRenderingSlot *slot = pending.front();
+    pending.pop_front();
+    slot->future.waitForFinished();
+    slot->painter.end();
+
+    painter->save();
+    painter->resetTransform();
+    painter->drawImage( 0, 0, slot->image );
+    painter->restore();
+    slot->image.fill( Qt::transparent );
+
+    mReadyToCompose = true;
+    available.push_back( slot );
+  };
+
+  auto startBatch = [&]( QgsFeatureList &features )
+  {
+    if ( static_cast< int >( pending.size() ) >= maxSlots )
+      composeOldest();
+
+    QgsVectorLayerRenderingSlot *slot = nullptr;
+    if ( !available.empty() )
+    {
+      slot = available.front();
+      available.pop_front();
+    }
+    else
+    {
+      renderingSlots.emplace_back( std::make_unique< QgsVectorLayerRenderingSlot >() );
+      slot = renderingSlots.back().get();
+      slot->image = QImage( target->size(), QImage::Format_ARGB32_Premultiplied );
+      slot->image.setDevicePixelRatio( target->devicePixelRatioF() );
+      slot->image.setDotsPerMeterX( target->dotsPerMeterX() );
+      slot->image.setDotsPerMeterY( target->dotsPerMeterY() );
+      slot->image.fill( Qt::transparent );
+      slot->context = std::make_unique< QgsRenderContext >( context );
+      slot->context->setPainter( &slot->painter );
+    }
+
+    slot->painter.begin( &slot->image );
+    slot->painter.setRenderHints( painter->renderHints() );
+    slot->painter.setTransform( painter->transform() );
+    if ( !slot->renderer )
+    {
+      // symbols keep per render state, so each thread draws with its own renderer
+      slot->renderer.reset( renderer->clone() );
+      slot->renderer->startRender( *slot->context, mFields );
+    }
+
+    slot->features = std::move( features );
+    features = QgsFeatureList();
+
+    QgsVectorLayerRenderingSlot *runningSlot = slot;
+    QgsFeedback *feedback = mFeedback.get();
+    const QgsGeometry clipFeatureGeom = mClipFeatureGeom;
+    const bool applyClipGeometries = mApplyClipGeometries;
+    const bool setExpressionContextFeature = !mNoSetLayerExpressionContext;
+    const QgsVectorLayerReprojectedRendering *reprojectedRendering = mReprojectedRendering.get();
+    slot->future = QtConcurrent::run( [ = ]
+    {
+      drawFeatureBatch( runningSlot->renderer.get(), *runningSlot->context, runningSlot->features, selectedFeatureIds,
+                        clipFeatureGeom, applyClipGeometries, setExpressionContextFeature, reprojectedRendering, feedback );
+    } );
+    pending.push_back( slot );
+  };
+
+  QgsFeatureList batch;
+  batch.reserve( PARALLEL_RENDERING_BATCH_SIZE );
+  QgsFeature fet;
+  while ( fit.nextFeature( fet ) )
+  {
+    if ( context.renderingStopped() )
+    {
+      QgsDebugMsgLevel( QStringLiteral( "Drawing of vector layer %1 canceled." ).arg( layerId() ), 2 );
+      break;
+    }
+
+    if ( !fet.hasGeometry() || fet.geometry().isEmpty() )
+      continue; // skip features without geometry
+
+    if ( clipEngine && !clipEngine->intersects( fet.geometry().constGet() ) )
+      continue; // skip features outside of clipping region
+
+    batch << fet;
+    if ( batch.size() >= PARALLEL_RENDERING_BATCH_SIZE )
+      startBatch( batch );
+  }
+
+  if ( renderingSlots.empty() )
+  {
+    // a single batch, not worth the threads
+    drawFeatureBatch( renderer, context, batch, selectedFeatureIds, mClipFeatureGeom, mApplyClipGeometries,
+                      !mNoSetLayerExpressionContext, mReprojectedRendering.get(), mFeedback.get() );
+    mReadyToCompose = true;
+  }
+  else
+  {
+    if ( !batch.isEmpty() && !context.renderingStopped() )
+      startBatch( batch );
+
+    while ( !pending.empty() )
+      composeOldest();
+
+    for ( const std::unique_ptr< QgsVectorLayerRenderingSlot > &slot : renderingSlots )
+    {
+      slot->renderer->stopRender( *slot->context );
+    }
+  }
+
+  stopRenderer( renderer, nullptr );
+}
+
 void QgsVectorLayerRenderer::stopRenderer( QgsFeatureRenderer *renderer, QgsSingleSymbolRenderer *selRenderer )
 {
   QgsRenderContext &context = *renderContext();
@@ -27,6 +27,8 @@ class QgsDiagramLayerSettings;
 class QgsFeatureIterator;
 class QgsSingleSymbolRenderer;
 class QgsMapClippingRegion;
+class QgsVectorLayerReprojectionCache;
+class QgsVectorLayerReprojectedRendering;
 
 #define SIP_NO_FILE
 
@@ -94,6 +96,24 @@ class QgsVectorLayerRenderer : public QgsMapLayerRenderer
      */
     void drawRendererLevels( QgsFeatureRenderer *renderer, QgsFeatureIterator &fit );
 
+    /**
+     * Returns TRUE if the features can be drawn with \a renderer by several threads,
+     * each drawing consecutive batches of features on its own image.
+     */
+    bool canDrawRendererInParallel( QgsFeatureRenderer *renderer ) const;
+
+    /**
+     * Draw layer with \a renderer on several threads, the batch images are composed
+     * in the feature order. QgsFeatureRenderer::startRender() needs to be called before using this method
+     */
+    void drawRendererParallel( QgsFeatureRenderer *renderer, QgsFeatureIterator &fit );
+
+    /**
+     * Returns TRUE if the features can be drawn with \a renderer using the geometries
+     * reprojected to the destination CRS stored in the layer reprojection cache.
+     */
+    bool canUseReprojectionCache( QgsFeatureRenderer *renderer );
+
     //! Stop version 2 renderer and selected renderer (if required)
     void stopRenderer( QgsFeatureRenderer *renderer, QgsSingleSymbolRenderer *selRenderer );
 
@@ -107,6 +127,9 @@ class QgsVectorLayerRenderer : public QgsMapLayerRenderer
     //! The rendered layer
     QgsVectorLayer *mLayer = nullptr;
 
+    //! Name of the rendered layer, used to record the rendering profile
+    QString mLayerName;
+
     QgsFields mFields; // TODO: use fields from mSource
 
     QgsFeatureIds mSelectedFeatureIds;
@@ -159,6 +182,11 @@ class QgsVectorLayerRenderer : public QgsMapLayerRenderer
 
     bool mNoSetLayerExpressionContext = false;
 
+    std::shared_ptr< QgsVectorLayerReprojectionCache > mReprojectionCache;
+    quint64 mReprojectionCacheGeneration = 0;
+    //! Set while drawing with a renderer able to use the reprojection cache
+    std::unique_ptr< QgsVectorLayerReprojectedRendering > mReprojectedRendering;
+
 };
 
 
@@ -0,0 +1,97 @@
+/***************************************************************************
+  qgsvectorlayerreprojectioncache.cpp
+  --------------------------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsvectorlayerreprojectioncache.h"
+#include "qgscoordinatetransform.h"
+
+QgsVectorLayerReprojectionCache::QgsVectorLayerReprojectionCache( int maximumSize )
+  : mGeometries( maximumSize )
+{
+}
+
+QString QgsVectorLayerReprojectionCache::transformKey( const QgsCoordinateTransform &transform )
+{
+  return QStringLiteral( "%1\n%2\n%3" ).arg( transform.sourceCrs().toWkt( QgsCoordinateReferenceSystem::WKT_PREFERRED ),
+         transform.destinationCrs().toWkt( QgsCoordinateReferenceSystem::WKT_PREFERRED ),
+         transform.coordinateOperation() );
+}
+
+void QgsVectorLayerReprojectionCache::setMaximumSize( int maximumSize )
+{
+  const QMutexLocker locker( &mMutex );
+  mGeometries.setMaxCost( maximumSize );
+}
+
+int QgsVectorLayerReprojectionCache::maximumSize() const
+{
+  const QMutexLocker locker( &mMutex );
+  return mGeometries.maxCost();
+}
+
+quint64 QgsVectorLayerReprojectionCache::generation() const
+{
+  const QMutexLocker locker( &mMutex );
+  return mGeneration;
+}
+
+bool QgsVectorLayerReprojectionCache::geometry( const QString &transformKey, QgsFeatureId id, QgsGeometry &geometry )
+{
+  const QMutexLocker locker( &mMutex );
+  if ( transformKey != mTransformKey )
+    return false;
+
+  // QCache::object() also marks the geometry as the most recently used one
+  const QgsGeometry *cached = mGeometries.object( id );
+  if ( !cached )
+    return false;
+
+  geometry = *cached;
+  return true;
+}
+
+void QgsVectorLayerReprojectionCache::insert( const QString &transformKey, QgsFeatureId id, const QgsGeometry &geometry, quint64 generation )
+{
+  const QMutexLocker locker( &mMutex );
+  if ( generation != mGeneration || geometry.isNull() )
+    return;
+
+  if ( transformKey != mTransformKey )
+  {
+    mGeometries.clear();
+    mTransformKey = transformKey;
+  }
+
+  // QCache takes ownership of the geometry, and deletes it right away if it exceeds the maximum size
+  mGeometries.insert( id, new QgsGeometry( geometry ), geometry.constGet()->wkbSize() );
+}
+
+void QgsVectorLayerReprojectionCache::invalidate( QgsFeatureId id )
+{
+  const QMutexLocker locker( &mMutex );
+  mGeneration++;
+  mGeometries.remove( id );
+}
+
+void QgsVectorLayerReprojectionCache::clear()
+{
+  const QMutexLocker locker( &mMutex );
+  mGeneration++;
+  mGeometries.clear();
+}
+
+int QgsVectorLayerReprojectionCache::count() const
+{
+  const QMutexLocker locker( &mMutex );
+  return mGeometries.count();
+}
@@ -0,0 +1,122 @@
+/***************************************************************************
+  qgsvectorlayerreprojectioncache.h
+  --------------------------------------
+  Date                 : October 2022
+  Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSVECTORLAYERREPROJECTIONCACHE_H
+#define QGSVECTORLAYERREPROJECTIONCACHE_H
+
+#include "qgis_core.h"
+#include "qgsfeatureid.h"
+#include "qgsgeometry.h"
+
+#include <QCache>
+#include <QMutex>
+
+#define SIP_NO_FILE
+
+class QgsCoordinateTransform;
+
+/**
+ * \ingroup core
+ * \class QgsVectorLayerReprojectionCache
+ * \brief Stores feature geometries of a vector layer reprojected to a destination CRS, so that
+ * they are not reprojected again each time the layer is rendered.
+ *
+ * Geometries are cached for a single transform at a time, identified by transformKey(). Storing
+ * a geometry for another transform discards the previously cached geometries. The least recently
+ * used geometries are discarded once the cached geometries exceed the maximum size.
+ *
+ * The cache is owned by the vector layer, which invalidates the geometries of edited features.
+ * It may be used from several threads at once.
+ *
+ * \see QgsVectorLayer::setReprojectionCacheMaximumSize()
+ * \note not available in Python bindings
+ * \since QGIS 3.30
+ */
+class CORE_EXPORT QgsVectorLayerReprojectionCache
+{
+  public:
+
+    /**
+     * Constructor for QgsVectorLayerReprojectionCache, storing up to \a maximumSize bytes of geometries.
+     */
+    explicit QgsVectorLayerReprojectionCache( int maximumSize );
+
+    /**
+     * Returns a key identifying the source and destination CRS and the coordinate operation of a \a transform.
+     */
+    static QString transformKey( const QgsCoordinateTransform &transform );
+
+    /**
+     * Sets the maximum size of the cached geometries, in bytes.
+     *
+     * \see maximumSize()
+     */
+    void setMaximumSize( int maximumSize );
+
+    /**
+     * Returns the maximum size of the cached geometries, in bytes.
+     *
+     * \see setMaximumSize()
+     */
+    int maximumSize() const;
+
+    /**
+     * Returns the current generation of the cache, which changes each time cached geometries are
+     * invalidated.
+     *
+     * Geometries fetched before an invalidation must not be stored, so renderers should retrieve the
+     * generation before fetching features and pass it to insert().
+     */
+    quint64 generation() const;
+
+    /**
+     * Retrieves the \a geometry of the feature with matching \a id reprojected with the transform
+     * matching \a transformKey.
+     *
+     * Returns FALSE if the geometry is not cached.
+     */
+    bool geometry( const QString &transformKey, QgsFeatureId id, QgsGeometry &geometry );
+
+    /**
+     * Stores the \a geometry of the feature with matching \a id reprojected with the transform
+     * matching \a transformKey.
+     *
+     * The geometry is ignored if cached geometries were invalidated since \a generation.
+     */
+    void insert( const QString &transformKey, QgsFeatureId id, const QgsGeometry &geometry, quint64 generation );
+
+    /**
+     * Discards the cached geometries of the feature with matching \a id.
+     */
+    void invalidate( QgsFeatureId id );
+
+    /**
+     * Discards all cached geometries.
+     */
+    void clear();
+
+    /**
+     * Returns the number of cached geometries.
+     */
+    int count() const;
+
+  private:
+
+    mutable QMutex mMutex;
+    QString mTransformKey;
+    QCache< QgsFeatureId, QgsGeometry > mGeometries;
+    quint64 mGeneration = 0;
+};
+
+#endif // QGSVECTORLAYERREPROJECTIONCACHE_H
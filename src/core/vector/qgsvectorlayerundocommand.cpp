@@ -224,9 +224,10 @@ QgsVectorLayerUndoCommandChangeAttribute::QgsVectorLayerUndoCommandChangeAttribu
     const QgsChangedAttributesMap::const_iterator it = mBuffer->mChangedAttributeValues.constFind( mFid );
     if ( it != mBuffer->mChangedAttributeValues.constEnd() )
     {
-      if ( it->contains( mFieldIndex ) )
+      const QgsAttributeMap::const_iterator fieldIt = it->constFind( mFieldIndex );
+      if ( fieldIt != it->constEnd() )
       {
-        mOldValue = mBuffer->mChangedAttributeValues[mFid][mFieldIndex];
+        mOldValue = fieldIt.value();
         mFirstChange = false;
       }
     }
@@ -260,9 +261,13 @@ void QgsVectorLayerUndoCommandChangeAttribute::undo()
   else if ( mFirstChange )
   {
     // existing feature
-    mBuffer->mChangedAttributeValues[mFid].remove( mFieldIndex );
-    if ( mBuffer->mChangedAttributeValues[mFid].isEmpty() )
-      mBuffer->mChangedAttributeValues.remove( mFid );
+    const QgsChangedAttributesMap::iterator it = mBuffer->mChangedAttributeValues.find( mFid );
+    if ( it != mBuffer->mChangedAttributeValues.end() )
+    {
+      it->remove( mFieldIndex );
+      if ( it->isEmpty() )
+        mBuffer->mChangedAttributeValues.erase( it );
+    }
 
     if ( !mOldValue.isValid() )
     {
@@ -296,12 +301,8 @@ void QgsVectorLayerUndoCommandChangeAttribute::redo()
   }
   else
   {
-    // changed attribute of existing feature
-    if ( !mBuffer->mChangedAttributeValues.contains( mFid ) )
-    {
-      mBuffer->mChangedAttributeValues.insert( mFid, QgsAttributeMap() );
-    }
-
+    // changed attribute of existing feature, the map of the feature is created by the first change.
+    // A single lookup is done, as large edits (e.g. the field calculator) push one command per feature
     mBuffer->mChangedAttributeValues[mFid].insert( mFieldIndex, mNewValue );
   }
 
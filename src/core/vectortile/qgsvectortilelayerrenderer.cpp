@@ -15,7 +15,14 @@
 
 #include "qgsvectortilelayerrenderer.h"
 
+#include <QCache>
+#include <QCryptographicHash>
 #include <QElapsedTimer>
+#include <QFuture>
+#include <QMutex>
+#include <QtConcurrent>
+#include <algorithm>
+#include <limits>
 
 #include "qgsexpressioncontextutils.h"
 #include "qgsfeedback.h"
@@ -31,6 +38,50 @@
 #include "qgsmapclippingutils.h"
 #include "qgsrendercontext.h"
 
+///@cond PRIVATE
+
+//! Features of recently decoded tiles, so that the tiles are not parsed again when the map is panned or refreshed
+static QCache< QString, QgsVectorTileFeatures > sDecodedTilesCache( 64 * 1024 * 1024 ); // cost in bytes of decoded features
+//! Mutex to protect the decoded tiles cache
+static QMutex sDecodedTilesCacheMutex;
+
+//! Returns an estimate of the memory used by decoded \a features, in bytes
+static int decodedFeaturesSize( const QgsVectorTileFeatures &features )
+{
+  qint64 size = 0;
+  for ( auto it = features.constBegin(); it != features.constEnd(); ++it )
+  {
+    size += it.key().size() * static_cast< qint64 >( sizeof( QChar ) );
+    for ( const QgsFeature &feature : it.value() )
+    {
+      size += sizeof( QgsFeature );
+      if ( feature.hasGeometry() )
+        size += feature.geometry().constGet()->wkbSize();
+
+      const QgsAttributes attributes = feature.attributes();
+      size += attributes.size() * static_cast< qint64 >( sizeof( QVariant ) );
+      for ( const QVariant &attribute : attributes )
+      {
+        if ( attribute.type() == QVariant::String )
+          size += attribute.toString().size() * static_cast< qint64 >( sizeof( QChar ) );
+      }
+    }
+  }
+  return static_cast< int >( std::clamp( size, static_cast< qint64 >( 1 ), static_cast< qint64 >( std::numeric_limits< int >::max() ) ) );
+}
+
+//! Decoded features of a tile
+struct QgsVectorTileDecodedTile
+{
+  QgsTileXYZ id;
+  QgsVectorTileFeatures features;
+  bool valid = false;
+  //! Time spent decoding the tile (ms)
+  int decodeTime = 0;
+};
+
+///@endcond
+
 QgsVectorTileLayerRenderer::QgsVectorTileLayerRenderer( QgsVectorTileLayer *layer, QgsRenderContext &context )
   : QgsMapLayerRenderer( layer->id(), &context )
   , mSourceType( layer->sourceType() )
@@ -124,6 +175,40 @@ bool QgsVectorTileLayerRenderer::render()
     }
   }
 
+  // tiles are decoded by worker threads as they arrive, and drawn in this thread
+  auto decodeTileAsync = [this]( const QgsVectorTileRawData & rawTile )
+  {
+    return QtConcurrent::run( [this, rawTile]
+    {
+      QElapsedTimer tDecode;
+      tDecode.start();
+
+      QgsVectorTileDecodedTile decodedTile;
+      decodedTile.id = rawTile.id;
+      if ( !mFeedback->isCanceled() )
+        decodedTile.valid = decodeTile( rawTile, decodedTile.features );
+      decodedTile.decodeTime = tDecode.elapsed();
+      return decodedTile;
+    } );
+  };
+
+  QList< QFuture< QgsVectorTileDecodedTile > > pendingTiles;
+  auto drawDecodedTiles = [this, &pendingTiles]( bool wait )
+  {
+    while ( !pendingTiles.isEmpty() && ( wait || pendingTiles.constFirst().isFinished() ) )
+    {
+      const QgsVectorTileDecodedTile decodedTile = pendingTiles.takeFirst().result();
+      mTotalDecodeTime += decodedTile.decodeTime;
+      if ( renderContext()->renderingStopped() )
+        continue;
+
+      if ( decodedTile.valid )
+        drawTile( decodedTile.id, decodedTile.features );
+      else
+        QgsDebugMsgLevel( QStringLiteral( "Failed to parse raw tile data! " ) + decodedTile.id.toString(), 2 );
+    }
+  };
+
   std::unique_ptr<QgsVectorTileLoader> asyncLoader;
   QList<QgsVectorTileRawData> rawTiles;
   if ( !isAsync )
@@ -137,11 +222,12 @@ bool QgsVectorTileLayerRenderer::render()
   else
   {
     asyncLoader.reset( new QgsVectorTileLoader( mSourcePath, mTileMatrix, mTileRange, viewCenter, mAuthCfg, mHeaders, mFeedback.get() ) );
-    QObject::connect( asyncLoader.get(), &QgsVectorTileLoader::tileRequestFinished, asyncLoader.get(), [this]( const QgsVectorTileRawData & rawTile )
+    QObject::connect( asyncLoader.get(), &QgsVectorTileLoader::tileRequestFinished, asyncLoader.get(), [&pendingTiles, &decodeTileAsync, &drawDecodedTiles]( const QgsVectorTileRawData & rawTile )
     {
       QgsDebugMsgLevel( QStringLiteral( "Got tile asynchronously: " ) + rawTile.id.toString(), 2 );
       if ( !rawTile.data.isEmpty() )
-        decodeAndDrawTile( rawTile );
+        pendingTiles << decodeTileAsync( rawTile );
+      drawDecodedTiles( false );
     } );
   }
 
@@ -187,6 +273,25 @@ bool QgsVectorTileLayerRenderer::render()
     }
   }
 
+  mTransform = ctx.coordinateTransform();
+
+  // decoded features depend on the source, the fields and layers required by the renderer and labeling, and the transform
+  // to the destination CRS, including the coordinate operation picked by the transform context
+  QStringList cacheKeyParts { mSourceType, mSourcePath };
+  if ( mTransform.isValid() )
+  {
+    cacheKeyParts << mTransform.sourceCrs().toWkt( QgsCoordinateReferenceSystem::WKT_PREFERRED )
+                  << mTransform.destinationCrs().toWkt( QgsCoordinateReferenceSystem::WKT_PREFERRED )
+                  << mTransform.coordinateOperation()
+                  << QString::number( mTransform.allowFallbackTransforms() );
+  }
+  for ( auto it = mPerLayerFields.constBegin(); it != mPerLayerFields.constEnd(); ++it )
+    cacheKeyParts << it.key() + ':' + it.value().names().join( ',' );
+  QStringList requiredLayers = qgis::setToList( mRequiredLayers );
+  std::sort( requiredLayers.begin(), requiredLayers.end() );
+  cacheKeyParts << requiredLayers.join( ',' );
+  mDecodedTilesCacheKey = cacheKeyParts.join( '|' );
+
   if ( !isAsync )
   {
     for ( const QgsVectorTileRawData &rawTile : std::as_const( rawTiles ) )
@@ -194,8 +299,9 @@ bool QgsVectorTileLayerRenderer::render()
       if ( ctx.renderingStopped() )
         break;
 
-      decodeAndDrawTile( rawTile );
+      pendingTiles << decodeTileAsync( rawTile );
     }
+    drawDecodedTiles( true );
   }
   else
   {
@@ -204,6 +310,9 @@ bool QgsVectorTileLayerRenderer::render()
     asyncLoader->downloadBlocking();
     if ( !asyncLoader->error().isEmpty() )
       mErrors.append( asyncLoader->error() );
+
+    // draw the tiles still being decoded
+    drawDecodedTiles( true );
   }
 
   if ( ctx.flags() & Qgis::RenderContextFlag::DrawSelection )
@@ -223,44 +332,51 @@ bool QgsVectorTileLayerRenderer::forceRasterRender() const
   return renderContext()->testFlag( Qgis::RenderContextFlag::UseAdvancedEffects ) && ( !qgsDoubleNear( mLayerOpacity, 1.0 ) );
 }
 
-void QgsVectorTileLayerRenderer::decodeAndDrawTile( const QgsVectorTileRawData &rawTile )
+bool QgsVectorTileLayerRenderer::decodeTile( const QgsVectorTileRawData &rawTile, QgsVectorTileFeatures &features ) const
 {
-  QgsRenderContext &ctx = *renderContext();
-
-  QgsDebugMsgLevel( QStringLiteral( "Drawing tile " ) + rawTile.id.toString(), 2 );
-
-  QElapsedTimer tLoad;
-  tLoad.start();
+  // the tiles can be updated by the source, so the key includes their content
+  const QString cacheKey = QStringLiteral( "%1|%2|%3" ).arg( mDecodedTilesCacheKey, rawTile.id.toString(), QString::fromLatin1( QCryptographicHash::hash( rawTile.data, QCryptographicHash::Sha1 ).toHex() ) );
+  {
+    const QMutexLocker locker( &sDecodedTilesCacheMutex );
+    if ( const QgsVectorTileFeatures *cachedFeatures = sDecodedTilesCache.object( cacheKey ) )
+    {
+      features = *cachedFeatures;
+      return true;
+    }
+  }
 
   // currently only MVT encoding supported
   QgsVectorTileMVTDecoder decoder( mTileMatrixSet );
   if ( !decoder.decode( rawTile.id, rawTile.data ) )
-  {
-    QgsDebugMsgLevel( QStringLiteral( "Failed to parse raw tile data! " ) + rawTile.id.toString(), 2 );
-    return;
-  }
+    return false;
 
-  if ( ctx.renderingStopped() )
-    return;
+  features = decoder.layerFeatures( mPerLayerFields, mTransform, &mRequiredLayers );
 
-  const QgsCoordinateTransform ct = ctx.coordinateTransform();
+  const QMutexLocker locker( &sDecodedTilesCacheMutex );
+  sDecodedTilesCache.insert( cacheKey, new QgsVectorTileFeatures( features ), decodedFeaturesSize( features ) );
+  return true;
+}
 
-  QgsVectorTileRendererData tile( rawTile.id );
+void QgsVectorTileLayerRenderer::drawTile( const QgsTileXYZ &id, const QgsVectorTileFeatures &features )
+{
+  QgsRenderContext &ctx = *renderContext();
+
+  QgsDebugMsgLevel( QStringLiteral( "Drawing tile " ) + id.toString(), 2 );
+
+  QgsVectorTileRendererData tile( id );
   tile.setFields( mPerLayerFields );
-  tile.setFeatures( decoder.layerFeatures( mPerLayerFields, ct, &mRequiredLayers ) );
+  tile.setFeatures( features );
 
   try
   {
-    tile.setTilePolygon( QgsVectorTileUtils::tilePolygon( rawTile.id, ct, mTileMatrix, ctx.mapToPixel() ) );
+    tile.setTilePolygon( QgsVectorTileUtils::tilePolygon( id, mTransform, mTileMatrix, ctx.mapToPixel() ) );
   }
   catch ( QgsCsException & )
   {
-    QgsDebugMsgLevel( QStringLiteral( "Failed to generate tile polygon " ) + rawTile.id.toString(), 2 );
+    QgsDebugMsgLevel( QStringLiteral( "Failed to generate tile polygon " ) + id.toString(), 2 );
     return;
   }
 
-  mTotalDecodeTime += tLoad.elapsed();
-
   // calculate tile polygon in screen coordinates
 
   if ( ctx.renderingStopped() )
@@ -28,6 +28,7 @@ class QgsVectorTileLabelProvider;
 #include "qgsmapclippingregion.h"
 #include "qgshttpheaders.h"
 #include "qgsvectortilematrixset.h"
+#include "qgscoordinatetransform.h"
 
 /**
  * \ingroup core
@@ -51,7 +52,16 @@ class QgsVectorTileLayerRenderer : public QgsMapLayerRenderer
     bool forceRasterRender() const override;
 
   private:
-    void decodeAndDrawTile( const QgsVectorTileRawData &rawTile );
+
+    /**
+     * Decodes the features of a raw tile into \a features, or reads them from the cache of decoded
+     * tiles if the tile was already decoded with the same fields and destination CRS.
+     * Returns FALSE if the tile could not be parsed. It may be called from worker threads.
+     */
+    bool decodeTile( const QgsVectorTileRawData &rawTile, QgsVectorTileFeatures &features ) const;
+
+    //! Draws the decoded \a features of a tile and registers their labels
+    void drawTile( const QgsTileXYZ &id, const QgsVectorTileFeatures &features );
 
     // data coming from the vector tile layer
 
@@ -91,6 +101,12 @@ class QgsVectorTileLayerRenderer : public QgsMapLayerRenderer
     //! Cached list of layers required for renderer and labeling
     QSet< QString > mRequiredLayers;
 
+    //! Transform of the features from the tiles to the map
+    QgsCoordinateTransform mTransform;
+
+    //! Part of the keys of the decoded tiles cache depending on the source, fields and destination CRS
+    QString mDecodedTilesCacheKey;
+
     //! Selected features, to draw on top in a selected style
     QList< QgsFeature > mSelectedFeatures;
 
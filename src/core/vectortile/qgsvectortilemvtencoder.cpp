@@ -241,6 +241,38 @@ void QgsVectorTileMVTEncoder::addLayer( QgsVectorLayer *layer, QgsFeedback *feed
   mKnownValues.clear();
 }
 
+void QgsVectorTileMVTEncoder::addLayerFeatures( const QString &layerName, const QgsFields &fields, const QgsFeatureList &features, QgsFeedback *feedback )
+{
+  if ( features.isEmpty() || ( feedback && feedback->isCanceled() ) )
+    return;
+
+  // clip to the tile extent with its buffer
+  const double bufferRatio = static_cast<double>( mBuffer ) / mResolution;
+  QgsRectangle tileExtent = mTileExtent;
+  tileExtent.grow( bufferRatio * mTileExtent.width() );
+
+  vector_tile::Tile_Layer *tileLayer = tile.add_layers();
+  tileLayer->set_name( layerName.toUtf8() );
+  tileLayer->set_version( 2 );  // 2 means MVT spec version 2.1
+  tileLayer->set_extent( static_cast<::google::protobuf::uint32>( mResolution ) );
+
+  for ( int i = 0; i < fields.count(); ++i )
+  {
+    tileLayer->add_keys( fields[i].name().toUtf8() );
+  }
+
+  for ( QgsFeature f : features )
+  {
+    if ( feedback && feedback->isCanceled() )
+      break;
+
+    f.setGeometry( f.geometry().clipped( tileExtent ) );
+    addFeature( tileLayer, f );
+  }
+
+  mKnownValues.clear();
+}
+
 void QgsVectorTileMVTEncoder::addFeature( vector_tile::Tile_Layer *tileLayer, const QgsFeature &f )
 {
   QgsGeometry g = f.geometry();
@@ -66,6 +66,18 @@ class CORE_EXPORT QgsVectorTileMVTEncoder
      */
     void addLayer( QgsVectorLayer *layer, QgsFeedback *feedback = nullptr, QString filterExpression = QString(), QString layerName = QString() );
 
+    /**
+     * Adds the \a features of a layer named \a layerName with the given \a fields. The geometries
+     * of the features must be in the CRS of the tile matrix, they are clipped to the tile extent
+     * and its buffer. Unlike addLayer(), this method does not use the vector layer, so that
+     * tiles can be encoded in worker threads from features fetched beforehand.
+     *
+     * Optional feedback object may be provided to support cancellation.
+     *
+     * \since QGIS 3.30
+     */
+    void addLayerFeatures( const QString &layerName, const QgsFields &fields, const QgsFeatureList &features, QgsFeedback *feedback = nullptr );
+
     //! Encodes MVT using data stored previously with addLayer() calls
     QByteArray encode() const;
 
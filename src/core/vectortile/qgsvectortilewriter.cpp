@@ -25,6 +25,7 @@
 #include "qgsvectortilemvtencoder.h"
 #include "qgsvectortileutils.h"
 #include "qgsziputils.h"
+#include "qgsspatialindex.h"
 
 #include <nlohmann/json.hpp>
 
@@ -32,7 +33,112 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QUrl>
+#include <QtConcurrentMap>
 
+// number of tiles along the side of the blocks of tiles encoded in parallel
+static const int TILE_BLOCK_SIZE = 16;
+
+
+///@cond PRIVATE
+
+//! Features of a layer fetched for a block of tiles
+struct BlockLayer
+{
+  QString name;
+  QgsFields fields;
+  QgsFeatureList features;
+  //! Index of the features, by their position in the list
+  QgsSpatialIndex index;
+};
+
+//! Encoded data of a tile
+struct EncodedTile
+{
+  QgsTileXYZ id;
+  QByteArray data;
+};
+
+///@endcond
+
+// Fetches the features of the layers for a block of tiles, with their geometries in the CRS of the tiles
+static std::vector< BlockLayer > _fetchBlockFeatures( const QList<QgsVectorTileWriter::Layer> &layers, const QgsCoordinateTransformContext &transformContext,
+    const QgsTileMatrix &tileMatrix, const QgsTileRange &blockRange, QgsFeedback *feedback )
+{
+  std::vector< BlockLayer > blockLayers;
+
+  const int zoomLevel = tileMatrix.zoomLevel();
+  QgsRectangle blockExtent = tileMatrix.tileExtent( QgsTileXYZ( blockRange.startColumn(), blockRange.startRow(), zoomLevel ) );
+  blockExtent.combineExtentWith( tileMatrix.tileExtent( QgsTileXYZ( blockRange.endColumn(), blockRange.endRow(), zoomLevel ) ) );
+
+  // add the buffer of the encoded tiles
+  const QgsVectorTileMVTEncoder encoder( QgsTileXYZ( blockRange.startColumn(), blockRange.startRow(), zoomLevel ), tileMatrix );
+  const double tileSize = tileMatrix.tileExtent( QgsTileXYZ( blockRange.startColumn(), blockRange.startRow(), zoomLevel ) ).width();
+  const double bufferRatio = static_cast<double>( encoder.tileBuffer() ) / encoder.resolution();
+  blockExtent.grow( bufferRatio * tileSize );
+
+  for ( const QgsVectorTileWriter::Layer &layer : layers )
+  {
+    if ( ( layer.minZoom() >= 0 && zoomLevel < layer.minZoom() ) ||
+         ( layer.maxZoom() >= 0 && zoomLevel > layer.maxZoom() ) )
+      continue;
+
+    QgsVectorLayer *vl = layer.layer();
+    const QgsCoordinateTransform ct( vl->crs(), tileMatrix.crs(), transformContext );
+
+    QgsRectangle layerBlockExtent;
+    try
+    {
+      QgsCoordinateTransform extentTransform = ct;
+      extentTransform.setBallparkTransformsAreAppropriate( true );
+      layerBlockExtent = extentTransform.transformBoundingBox( blockExtent, Qgis::TransformDirection::Reverse );
+      if ( !layerBlockExtent.intersects( vl->extent() ) )
+        continue;  // block is completely outside of the layer's extent
+    }
+    catch ( const QgsCsException & )
+    {
+      QgsDebugMsg( "Failed to reproject block extent to the layer" );
+      continue;
+    }
+
+    BlockLayer blockLayer;
+    blockLayer.name = layer.layerName().isEmpty() ? vl->name() : layer.layerName();
+    blockLayer.fields = vl->fields();
+
+    QgsFeatureRequest request;
+    request.setFilterRect( layerBlockExtent );
+    if ( !layer.filterExpression().isEmpty() )
+      request.setFilterExpression( layer.filterExpression() );
+    QgsFeatureIterator fit = vl->getFeatures( request );
+
+    QgsFeature f;
+    while ( fit.nextFeature( f ) )
+    {
+      if ( feedback && feedback->isCanceled() )
+        break;
+
+      QgsGeometry g = f.geometry();
+      try
+      {
+        g.transform( ct );
+      }
+      catch ( const QgsCsException & )
+      {
+        QgsDebugMsg( "Failed to reproject geometry " + QString::number( f.id() ) );
+        continue;
+      }
+      f.setGeometry( g );
+
+      // the index refers to the features by their position in the list
+      blockLayer.index.addFeature( blockLayer.features.size(), g.boundingBox() );
+      blockLayer.features << f;
+    }
+
+    if ( !blockLayer.features.isEmpty() )
+      blockLayers.emplace_back( std::move( blockLayer ) );
+  }
+
+  return blockLayers;
+}
 
 QgsVectorTileWriter::QgsVectorTileWriter()
 {
@@ -172,55 +278,109 @@ bool QgsVectorTileWriter::writeTiles( QgsFeedback *feedback )
   {
     const QgsTileMatrix tileMatrix = QgsTileMatrix::fromTileMatrix( zoomLevel, mRootTileMatrix );
 
+    // the tiles are encoded in parallel by blocks of tiles, sharing the features of the block
+    // which are fetched once for all its tiles
     QgsTileRange tileRange = tileMatrix.tileRangeFromExtent( outputExtent );
-    for ( int row = tileRange.startRow(); row <= tileRange.endRow(); ++row )
+    for ( int blockRow = tileRange.startRow(); blockRow <= tileRange.endRow(); blockRow += TILE_BLOCK_SIZE )
     {
-      for ( int col = tileRange.startColumn(); col <= tileRange.endColumn(); ++col )
+      for ( int blockCol = tileRange.startColumn(); blockCol <= tileRange.endColumn(); blockCol += TILE_BLOCK_SIZE )
       {
-        QgsTileXYZ tileID( col, row, zoomLevel );
-        QgsVectorTileMVTEncoder encoder( tileID );
-        encoder.setTransformContext( mTransformContext );
+        const QgsTileRange blockRange( blockCol, std::min( blockCol + TILE_BLOCK_SIZE - 1, tileRange.endColumn() ),
+                                       blockRow, std::min( blockRow + TILE_BLOCK_SIZE - 1, tileRange.endRow() ) );
 
-        for ( const Layer &layer : std::as_const( mLayers ) )
+        const std::vector< BlockLayer > blockLayers = _fetchBlockFeatures( mLayers, mTransformContext, tileMatrix, blockRange, feedback );
+
+        if ( feedback && feedback->isCanceled() )
         {
-          if ( ( layer.minZoom() >= 0 && zoomLevel < layer.minZoom() ) ||
-               ( layer.maxZoom() >= 0 && zoomLevel > layer.maxZoom() ) )
-            continue;
+          mErrorMessage = tr( "Operation has been canceled" );
+          return false;
+        }
 
-          encoder.addLayer( layer.layer(), feedback, layer.filterExpression(), layer.layerName() );
+        std::vector< EncodedTile > tiles;
+        for ( int row = blockRange.startRow(); row <= blockRange.endRow(); ++row )
+        {
+          for ( int col = blockRange.startColumn(); col <= blockRange.endColumn(); ++col )
+          {
+            EncodedTile tile;
+            tile.id = QgsTileXYZ( col, row, zoomLevel );
+            tiles.emplace_back( tile );
+          }
         }
 
+        const bool compress = static_cast< bool >( mbtiles );
+        QtConcurrent::blockingMap( tiles, [&blockLayers, &tileMatrix, compress, feedback]( EncodedTile & tile )
+        {
+          QgsVectorTileMVTEncoder encoder( tile.id, tileMatrix );
+
+          // select the features of the block in the tile extent and its buffer
+          QgsRectangle tileExtent = tileMatrix.tileExtent( tile.id );
+          tileExtent.grow( static_cast<double>( encoder.tileBuffer() ) / encoder.resolution() * tileExtent.width() );
+
+          for ( const BlockLayer &layer : blockLayers )
+          {
+            QList< QgsFeatureId > indices = layer.index.intersects( tileExtent );
+            if ( indices.isEmpty() )
+              continue;
+
+            // keep the order of the layer features
+            std::sort( indices.begin(), indices.end() );
+            QgsFeatureList features;
+            features.reserve( indices.size() );
+            for ( QgsFeatureId index : std::as_const( indices ) )
+              features << layer.features.at( static_cast< int >( index ) );
+
+            encoder.addLayerFeatures( layer.name, layer.fields, features, feedback );
+          }
+
+          tile.data = encoder.encode();
+          if ( compress && !tile.data.isEmpty() )
+          {
+            QByteArray gzipTileData;
+            QgsZipUtils::encodeGzip( tile.data, gzipTileData );
+            tile.data = gzipTileData;
+          }
+        } );
+
         if ( feedback && feedback->isCanceled() )
         {
           mErrorMessage = tr( "Operation has been canceled" );
           return false;
         }
 
-        QByteArray tileData = encoder.encode();
+        // the tiles of the block are inserted in a single transaction
+        if ( mbtiles )
+          mbtiles->beginTransaction();
 
-        ++tilesCreated;
-        if ( feedback )
+        for ( const EncodedTile &tile : tiles )
         {
-          feedback->setProgress( static_cast<double>( tilesCreated ) / tilesToCreate * 100 );
+          if ( tile.data.isEmpty() )
+          {
+            // skipping empty tile - no need to write it
+            continue;
+          }
+
+          if ( sourceType == QLatin1String( "xyz" ) )
+          {
+            if ( !writeTileFileXYZ( sourcePath, tile.id, tileMatrix, tile.data ) )
+              return false;  // error message already set
+          }
+          else  // mbtiles
+          {
+            int rowTMS = pow( 2, tile.id.zoomLevel() ) - tile.id.row() - 1;
+            mbtiles->setTileData( tile.id.zoomLevel(), tile.id.column(), rowTMS, tile.data );
+          }
         }
 
-        if ( tileData.isEmpty() )
+        if ( mbtiles && !mbtiles->commitTransaction() )
         {
-          // skipping empty tile - no need to write it
-          continue;
+          mErrorMessage = tr( "Failed to write tiles to MBTiles file: " ) + sourcePath;
+          return false;
         }
 
-        if ( sourceType == QLatin1String( "xyz" ) )
-        {
-          if ( !writeTileFileXYZ( sourcePath, tileID, tileMatrix, tileData ) )
-            return false;  // error message already set
-        }
-        else  // mbtiles
+        tilesCreated += static_cast< int >( tiles.size() );
+        if ( feedback )
         {
-          QByteArray gzipTileData;
-          QgsZipUtils::encodeGzip( tileData, gzipTileData );
-          int rowTMS = pow( 2, tileID.zoomLevel() ) - tileID.row() - 1;
-          mbtiles->setTileData( tileID.zoomLevel(), tileID.column(), rowTMS, gzipTileData );
+          feedback->setProgress( static_cast<double>( tilesCreated ) / tilesToCreate * 100 );
         }
       }
     }
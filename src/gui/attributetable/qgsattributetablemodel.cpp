@@ -245,7 +245,8 @@ void QgsAttributeTableModel::featureAdded( QgsFeatureId fid )
   if ( mFeat.id() != fid )
     featOk = loadFeatureAtId( fid );
 
-  if ( featOk && mFeatureRequest.acceptFeature( mFeat ) )
+  // while the model is reset, the features are added from an iterator over the features matching the request
+  if ( featOk && ( mResettingModel || mFeatureRequest.acceptFeature( mFeat ) ) )
   {
     for ( SortCache &cache : mSortCaches )
     {
@@ -271,8 +272,11 @@ void QgsAttributeTableModel::featureAdded( QgsFeatureId fid )
       mIdRowMap.insert( fid, n );
       mRowIdMap.insert( n, fid );
       if ( !mResettingModel )
+      {
         endInsertRows();
-      reload( index( rowCount() - 1, 0 ), index( rowCount() - 1, columnCount() ) );
+        // views are not notified of the changes of single rows while the whole model is reset
+        reload( index( rowCount() - 1, 0 ), index( rowCount() - 1, columnCount() ) );
+      }
       if ( mBulkEditCommandRunning && !mResettingModel )
       {
         mInsertedRowsChanges.append( fid );
@@ -496,6 +500,9 @@ void QgsAttributeTableModel::loadLayer()
       featureAdded( mFeat.id() );
     }
 
+    // the last loaded feature must not be used as the cached feature of the model
+    mFeat.setId( std::numeric_limits<int>::min() );
+
     emit finished();
     connect( mLayerCache, &QgsVectorLayerCache::invalidated, this, &QgsAttributeTableModel::loadLayer, Qt::UniqueConnection );
   }
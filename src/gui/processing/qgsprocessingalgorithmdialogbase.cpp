@@ -716,7 +716,7 @@ QString QgsProcessingAlgorithmDialogBase::formatHelp( QgsProcessingAlgorithm *al
 
 void QgsProcessingAlgorithmDialogBase::processEvents()
 {
-  if ( mAlgorithmTask )
+  if ( mAlgorithmTask || mRunningBackgroundTasks )
   {
     // no need to call this - the algorithm is running in a thread.
     // in fact, calling it causes a crash on Windows when the algorithm
@@ -807,6 +807,11 @@ void QgsProcessingAlgorithmDialogBase::setCurrentTask( QgsProcessingAlgRunnerTas
   QgsApplication::taskManager()->addTask( mAlgorithmTask );
 }
 
+void QgsProcessingAlgorithmDialogBase::setRunningBackgroundTasks( bool running )
+{
+  mRunningBackgroundTasks = running;
+}
+
 QString QgsProcessingAlgorithmDialogBase::formatStringForLog( const QString &string )
 {
   QString s = string;
@@ -376,6 +376,15 @@ class GUI_EXPORT QgsProcessingAlgorithmDialogBase : public QDialog, public QgsPr
      */
     void setCurrentTask( QgsProcessingAlgRunnerTask *task SIP_TRANSFER );
 
+    /**
+     * Sets whether the dialog is \a running algorithms in background tasks which are not
+     * managed by setCurrentTask(). Events are not processed when feedback is reported while
+     * these tasks are running.
+     *
+     * \since QGIS 3.30
+     */
+    void setRunningBackgroundTasks( bool running );
+
     /**
      * Formats an input \a string for display in the log tab.
      *
@@ -450,6 +459,7 @@ class GUI_EXPORT QgsProcessingAlgorithmDialogBase : public QDialog, public QgsPr
     QgsPanelWidget *mMainWidget = nullptr;
     std::unique_ptr< QgsProcessingAlgorithm > mAlgorithm;
     QgsProcessingAlgRunnerTask *mAlgorithmTask = nullptr;
+    bool mRunningBackgroundTasks = false;
 
     bool mHelpCollapsed = false;
 
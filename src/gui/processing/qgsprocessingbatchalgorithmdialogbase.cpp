@@ -50,17 +50,29 @@ void QgsProcessingBatchAlgorithmDialogBase::blockAdditionalControlsWhileRunning(
 void QgsProcessingBatchAlgorithmDialogBase::execute( const QList<QVariantMap> &parameters )
 {
   mQueuedParameters = parameters;
-  mCurrentStep = 0;
   mTotalSteps = mQueuedParameters.size();
   mResults.clear();
   mErrors.clear();
 
   mFeedback.reset( createFeedback() );
 
-  mBatchFeedback = std::make_unique< QgsProcessingBatchFeedback >( mTotalSteps, mFeedback.get() );
+  // rows are run concurrently when the algorithm can run in background threads, each with
+  // its own context and feedback. They are reported in row order by onRowFinished().
+  mExecutor = new QgsProcessingBatchExecutor( algorithm(), mQueuedParameters, [this]( int, QgsProcessingFeedback * feedback )
+  {
+    // important - we create a new context for each row
+    // this avoids holding onto resources and layers from earlier rows,
+    // and allows batch processing of many more items then is possible
+    // if we hold on to these layers
+    return createContext( feedback );
+  }, this );
+  if ( QgsApplication::maxThreads() > 0 )
+    mExecutor->setMaximumConcurrentRows( QgsApplication::maxThreads() );
+  connect( mExecutor, &QgsProcessingBatchExecutor::rowFinished, this, &QgsProcessingBatchAlgorithmDialogBase::onRowFinished );
+  connect( mExecutor, &QgsProcessingBatchExecutor::finished, this, &QgsProcessingBatchAlgorithmDialogBase::allTasksComplete );
 
   mProxyTask = new QgsProxyProgressTask( tr( "Batch Processing - %1" ).arg( algorithm()->displayName() ), true );
-  connect( mProxyTask, &QgsProxyProgressTask::canceled, mBatchFeedback.get(), &QgsFeedback::cancel );
+  connect( mProxyTask, &QgsProxyProgressTask::canceled, mFeedback.get(), &QgsFeedback::cancel );
   connect( mFeedback.get(), &QgsFeedback::progressChanged, mProxyTask, &QgsProxyProgressTask::setProxyProgress );
   QgsApplication::taskManager()->addTask( mProxyTask );
 
@@ -72,76 +84,45 @@ void QgsProcessingBatchAlgorithmDialogBase::execute( const QList<QVariantMap> &p
   showLog();
   repaint();
 
+  setRunningBackgroundTasks( !( algorithm()->flags() & QgsProcessingAlgorithm::FlagNoThreading ) );
+  setInfo( tr( "<b>Algorithm %1 starting&hellip;</b>" ).arg( algorithm()->displayName() ), false, false );
+
   mTotalTimer.restart();
-  if ( mTotalSteps > 0 )
-    executeNext();
+  mExecutor->start( mFeedback.get() );
 }
 
 bool QgsProcessingBatchAlgorithmDialogBase::isFinalized()
 {
-  return mQueuedParameters.empty();
+  return !mExecutor;
 }
 
-void QgsProcessingBatchAlgorithmDialogBase::executeNext()
+void QgsProcessingBatchAlgorithmDialogBase::algExecuted( bool successful, const QVariantMap &results )
 {
-  if ( mQueuedParameters.empty() || mFeedback->isCanceled() )
-  {
-    allTasksComplete( false );
-    return;
-  }
-
-  mBatchFeedback->setCurrentStep( mCurrentStep++ );
-  setProgressText( QStringLiteral( "\n" ) + tr( "Processing algorithm %1/%2…" ).arg( mCurrentStep ).arg( mTotalSteps ) );
-  setInfo( tr( "<b>Algorithm %1 starting&hellip;</b>" ).arg( algorithm()->displayName() ), false, false );
+  // rows are run by the batch executor, not as the dialog's current task
+  QgsProcessingAlgorithmDialogBase::algExecuted( successful, results );
+}
 
-  pushInfo( tr( "Input parameters:" ) );
+void QgsProcessingBatchAlgorithmDialogBase::onRowFinished( int row, bool ok, const QVariantMap &results )
+{
+  QgsProcessingContext *context = mExecutor->rowContext( row );
+  QgsProcessingBatchRowFeedback *rowFeedback = mExecutor->rowFeedback( row );
+  const QVariantMap parameters = mExecutor->rowParameters( row );
+  const double elapsed = mExecutor->rowElapsedSeconds( row );
 
-  // important - we create a new context for each iteration
-  // this avoids holding onto resources and layers from earlier iterations,
-  // and allows batch processing of many more items then is possible
-  // if we hold on to these layers
-  mTaskContext.reset( createContext( mBatchFeedback.get() ) );
+  setProgressText( QStringLiteral( "\n" ) + tr( "Processing algorithm %1/%2…" ).arg( row + 1 ).arg( mTotalSteps ) );
 
-  const QVariantMap paramsJson = algorithm()->asMap( mQueuedParameters.constFirst(), *mTaskContext ).value( QStringLiteral( "inputs" ) ).toMap();
+  pushInfo( tr( "Input parameters:" ) );
+  const QVariantMap paramsJson = algorithm()->asMap( mQueuedParameters.at( row ), *context ).value( QStringLiteral( "inputs" ) ).toMap();
   pushCommandInfo( QString::fromStdString( QgsJsonUtils::jsonFromVariant( paramsJson ).dump() ) );
   pushInfo( QString() );
 
-  mCurrentParameters = algorithm()->preprocessParameters( mQueuedParameters.constFirst() );
-  mQueuedParameters.pop_front();
+  // the row's own messages, which were held back while rows ran concurrently
+  rowFeedback->replay( mFeedback.get() );
 
-  mCurrentStepTimer.restart();
-  if ( !( algorithm()->flags() & QgsProcessingAlgorithm::FlagNoThreading ) )
-  {
-    QgsProcessingAlgRunnerTask *task = new QgsProcessingAlgRunnerTask( algorithm(), mCurrentParameters, *mTaskContext, mBatchFeedback.get(), QgsTask::CanCancel | QgsTask::Hidden );
-    if ( task->algorithmCanceled() )
-      onTaskComplete( false, {} );
-    else
-    {
-      setCurrentTask( task );
-    }
-  }
-  else
-  {
-    // have to execute in main thread, no tasks allowed
-    bool ok = false;
-    const QVariantMap results = algorithm()->run( mCurrentParameters, *mTaskContext, mBatchFeedback.get(), &ok );
-    onTaskComplete( ok, results );
-  }
-}
-
-void QgsProcessingBatchAlgorithmDialogBase::algExecuted( bool successful, const QVariantMap &results )
-{
-  // parent class cleanup first!
-  QgsProcessingAlgorithmDialogBase::algExecuted( successful, results );
-  onTaskComplete( successful, results );
-}
-
-void QgsProcessingBatchAlgorithmDialogBase::onTaskComplete( bool ok, const QVariantMap &results )
-{
   if ( ok )
   {
     setInfo( tr( "Algorithm %1 correctly executed…" ).arg( algorithm()->displayName() ), false, false );
-    pushInfo( tr( "Execution completed in %1 seconds" ).arg( mCurrentStepTimer.elapsed() / 1000.0, 2 ) );
+    pushInfo( tr( "Execution completed in %1 seconds" ).arg( elapsed, 2 ) );
     pushInfo( tr( "Results:" ) );
 
     pushCommandInfo( QString::fromStdString( QgsJsonUtils::jsonFromVariant( results ).dump() ) );
@@ -149,31 +130,22 @@ void QgsProcessingBatchAlgorithmDialogBase::onTaskComplete( bool ok, const QVari
 
     mResults.append( QVariantMap(
     {
-      { QStringLiteral( "parameters" ), mCurrentParameters },
+      { QStringLiteral( "parameters" ), parameters },
       { QStringLiteral( "results" ), results }
     } ) );
 
-    handleAlgorithmResults( algorithm(), *mTaskContext, mBatchFeedback.get(), mCurrentParameters );
-    executeNext();
-  }
-  else if ( mBatchFeedback->isCanceled() )
-  {
-    setInfo( tr( "Algorithm %1 canceled…" ).arg( algorithm()->displayName() ), false, false );
-    pushInfo( tr( "Execution canceled after %1 seconds" ).arg( mCurrentStepTimer.elapsed() / 1000.0, 2 ) );
-    allTasksComplete( true );
+    handleAlgorithmResults( algorithm(), *context, rowFeedback, parameters );
   }
   else
   {
-    const QStringList taskErrors = mBatchFeedback->popErrors();
     setInfo( tr( "Algorithm %1 failed…" ).arg( algorithm()->displayName() ), false, false );
-    reportError( tr( "Execution failed after %1 seconds" ).arg( mCurrentStepTimer.elapsed() / 1000.0, 2 ), false );
+    reportError( tr( "Execution failed after %1 seconds" ).arg( elapsed, 2 ), false );
 
     mErrors.append( QVariantMap(
     {
-      { QStringLiteral( "parameters" ), mCurrentParameters },
-      { QStringLiteral( "errors" ), taskErrors }
+      { QStringLiteral( "parameters" ), parameters },
+      { QStringLiteral( "errors" ), rowFeedback->errors() }
     } ) );
-    executeNext();
   }
 }
 
@@ -191,9 +163,17 @@ void QgsProcessingBatchAlgorithmDialogBase::taskTriggered( QgsTask *task )
 
 void QgsProcessingBatchAlgorithmDialogBase::allTasksComplete( bool canceled )
 {
-  mBatchFeedback.reset();
+  setRunningBackgroundTasks( false );
+  if ( canceled )
+  {
+    setInfo( tr( "Algorithm %1 canceled…" ).arg( algorithm()->displayName() ), false, false );
+    pushInfo( tr( "Execution canceled after %1 seconds" ).arg( mTotalTimer.elapsed() / 1000.0, 2 ) );
+  }
+
+  // we are called from the executor's finished signal, so it can't be deleted right away
+  mExecutor->deleteLater();
+  mExecutor = nullptr;
   mFeedback.reset();
-  mTaskContext.reset();
   mQueuedParameters.clear();
   if ( mProxyTask )
   {
@@ -22,7 +22,7 @@
 
 #include <QElapsedTimer>
 
-class QgsProcessingBatchFeedback;
+class QgsProcessingBatchExecutor;
 class QgsProxyProgressTask;
 
 ///@cond NOT_STABLE
@@ -94,28 +94,23 @@ class GUI_EXPORT QgsProcessingBatchAlgorithmDialogBase : public QgsProcessingAlg
 
   private slots:
 
-    void onTaskComplete( bool ok, const QVariantMap &results );
+    void onRowFinished( int row, bool ok, const QVariantMap &results );
     void taskTriggered( QgsTask *task );
 
   private:
 
-    void executeNext();
     void allTasksComplete( bool canceled );
 
     QPushButton *mButtonRunSingle = nullptr;
 
-    int mCurrentStep = 0;
     int mTotalSteps = 0;
     QList< QVariantMap > mQueuedParameters;
-    QVariantMap mCurrentParameters;
     QPointer< QgsProxyProgressTask > mProxyTask;
     std::unique_ptr< QgsProcessingFeedback > mFeedback;
-    std::unique_ptr< QgsProcessingBatchFeedback > mBatchFeedback;
-    std::unique_ptr< QgsProcessingContext > mTaskContext;
+    QgsProcessingBatchExecutor *mExecutor = nullptr;
     QList< QVariantMap > mResults;
     QList< QVariantMap > mErrors;
     QElapsedTimer mTotalTimer;
-    QElapsedTimer mCurrentStepTimer;
 };
 
 ///@endcond
@@ -779,6 +779,9 @@ void QgsMapCanvas::refreshMap()
   connect( mJob, &QgsMapRendererJob::finished, this, &QgsMapCanvas::rendererJobFinished );
   mJob->setCache( mCache );
   mJob->setLayerRenderingTimeHints( mLastLayerRenderTime );
+  // keep labels where they were placed by the previous render, e.g. when the map is panned
+  if ( mLabelingResults )
+    mJob->setPreviousLabelPositions( mLabelingResults->allLabels() );
 
   mJob->start();
 
@@ -298,10 +298,17 @@ void QgsFieldCalculator::accept()
     std::unique_ptr< QgsScopedProxyProgressTask > task = std::make_unique< QgsScopedProxyProgressTask >( tr( "Calculating field" ) );
     const long long count = mOnlyUpdateSelectedCheckBox->isChecked() ? mVectorLayer->selectedFeatureCount() : mVectorLayer->featureCount();
     long long i = 0;
+    int lastProgressReport = 0;
     while ( fit.nextFeature( feature ) )
     {
       i++;
-      task->setProgress( i / static_cast< double >( count ) * 100 );
+      // the progress is forwarded to the task manager through a queued call, so only report it when it changes
+      const int newProgress = static_cast< int >( i / static_cast< double >( count ) * 100 );
+      if ( newProgress != lastProgressReport )
+      {
+        lastProgressReport = newProgress;
+        task->setProgress( lastProgressReport );
+      }
 
       expContext.setFeature( feature );
       expContext.lastScope()->addVariable( QgsExpressionContextScope::StaticVariable( QStringLiteral( "row_number" ), rownum, true ) );
@@ -324,7 +331,7 @@ void QgsFieldCalculator::accept()
       else
       {
         ( void )field.convertCompatible( value );
-        mVectorLayer->changeAttributeValue( feature.id(), mAttributeId, value, newField ? emptyAttribute : feature.attributes().value( mAttributeId ) );
+        mVectorLayer->changeAttributeValue( feature.id(), mAttributeId, value, newField ? emptyAttribute : feature.attribute( mAttributeId ) );
       }
 
       rownum++;
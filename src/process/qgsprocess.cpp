@@ -370,42 +370,11 @@ int QgsProcessingExec::run( const QStringList &constArgs )
         std::cerr << QStringLiteral( "Could not parse JSON parameters: %1" ).arg( error ).toLocal8Bit().constData() << std::endl;
         return 1;
       }
-      if ( !json.contains( QStringLiteral( "inputs" ) ) )
-      {
-        std::cerr << QStringLiteral( "JSON parameters object must contain an \"inputs\" key." ).toLocal8Bit().constData() << std::endl;
+      if ( !parseJsonParameters( json, params, ellipsoid, distanceUnit, areaUnit, projectPath ) )
         return 1;
-      }
-
-      params = json.value( QStringLiteral( "inputs" ) ).toMap();
 
       // JSON format for input parameters implies JSON output format
       useJson = true;
-
-      ellipsoid = json.value( QStringLiteral( "ellipsoid" ) ).toString();
-      projectPath = json.value( QStringLiteral( "project_path" ) ).toString();
-      if ( json.contains( "distance_units" ) )
-      {
-        bool ok = false;
-        const QString distanceUnitsString = json.value( QStringLiteral( "distance_units" ) ).toString();
-        distanceUnit = QgsUnitTypes::decodeDistanceUnit( distanceUnitsString, &ok );
-        if ( !ok )
-        {
-          std::cerr << QStringLiteral( "%1 is not a valid distance unit value." ).arg( distanceUnitsString ).toLocal8Bit().constData() << std::endl;
-          return 1;
-        }
-      }
-
-      if ( json.contains( "area_units" ) )
-      {
-        bool ok = false;
-        const QString areaUnitsString = json.value( QStringLiteral( "area_units" ) ).toString();
-        areaUnit = QgsUnitTypes::decodeAreaUnit( areaUnitsString, &ok );
-        if ( !ok )
-        {
-          std::cerr << QStringLiteral( "%1 is not a valid area unit value." ).arg( areaUnitsString ).toLocal8Bit().constData() << std::endl;
-          return 1;
-        }
-      }
     }
     else
     {
@@ -514,6 +483,11 @@ int QgsProcessingExec::run( const QStringList &constArgs )
 
     return execute( algId, params, ellipsoid, distanceUnit, areaUnit, logLevel, useJson, projectPath );
   }
+  else if ( command == QLatin1String( "run-batch" ) )
+  {
+    loadPlugins();
+    return executeBatch( logLevel );
+  }
   else
   {
     std::cerr << QStringLiteral( "Command %1 not known!\n" ).arg( command ).toLocal8Bit().constData();
@@ -544,7 +518,9 @@ void QgsProcessingExec::showUsage( const QString &appName )
       << "\t\t\tAlternatively, a '-' character in place of the parameters argument indicates that the parameters should be read from STDIN as a JSON object. The JSON should be structured as a map containing at least the \"inputs\" key specifying a map of input parameter values. This implies the --json option for output as a JSON object.\n"
       << "\t\t\tIf required, the ellipsoid to use for distance and area calculations can be specified via the \"--ELLIPSOID=name\" argument.\n"
       << "\t\t\tIf required, an existing QGIS project to use during the algorithm execution can be specified via the \"--PROJECT_PATH=path\" argument.\n"
-      << "\t\t\tWhen passing parameters as a JSON object from STDIN, these extra arguments can be provided as an \"ellipsoid\" and a \"project_path\" key respectively.\n";
+      << "\t\t\tWhen passing parameters as a JSON object from STDIN, these extra arguments can be provided as an \"ellipsoid\" and a \"project_path\" key respectively.\n"
+      << "\trun-batch\truns several algorithms in a single process, avoiding the startup cost of each run. The algorithms are read from STDIN, one JSON object per line, with the same structure as the JSON parameters of the run command and an additional \"algorithm\" key specifying the algorithm id or a path to a model file.\n"
+      << "\t\t\tThe results of each algorithm are written to STDOUT as a JSON object on a single line, as soon as the algorithm completes. A project used by consecutive algorithms is only loaded once.\n";
 
   std::cout << msg.join( QString() ).toLocal8Bit().constData();
 }
@@ -998,7 +974,92 @@ int QgsProcessingExec::showAlgorithmHelp( const QString &inputId, bool useJson )
   return 0;
 }
 
-int QgsProcessingExec::execute( const QString &inputId, const QVariantMap &inputs, const QString &ellipsoid, QgsUnitTypes::DistanceUnit distanceUnit, QgsUnitTypes::AreaUnit areaUnit, QgsProcessingContext::LogLevel logLevel, bool useJson, const QString &projectPath )
+bool QgsProcessingExec::parseJsonParameters( const QVariantMap &json, QVariantMap &parameters, QString &ellipsoid, QgsUnitTypes::DistanceUnit &distanceUnit, QgsUnitTypes::AreaUnit &areaUnit, QString &projectPath )
+{
+  if ( !json.contains( QStringLiteral( "inputs" ) ) )
+  {
+    std::cerr << QStringLiteral( "JSON parameters object must contain an \"inputs\" key." ).toLocal8Bit().constData() << std::endl;
+    return false;
+  }
+
+  parameters = json.value( QStringLiteral( "inputs" ) ).toMap();
+
+  ellipsoid = json.value( QStringLiteral( "ellipsoid" ) ).toString();
+  projectPath = json.value( QStringLiteral( "project_path" ) ).toString();
+  distanceUnit = QgsUnitTypes::DistanceUnknownUnit;
+  if ( json.contains( "distance_units" ) )
+  {
+    bool ok = false;
+    const QString distanceUnitsString = json.value( QStringLiteral( "distance_units" ) ).toString();
+    distanceUnit = QgsUnitTypes::decodeDistanceUnit( distanceUnitsString, &ok );
+    if ( !ok )
+    {
+      std::cerr << QStringLiteral( "%1 is not a valid distance unit value." ).arg( distanceUnitsString ).toLocal8Bit().constData() << std::endl;
+      return false;
+    }
+  }
+
+  areaUnit = QgsUnitTypes::AreaUnknownUnit;
+  if ( json.contains( "area_units" ) )
+  {
+    bool ok = false;
+    const QString areaUnitsString = json.value( QStringLiteral( "area_units" ) ).toString();
+    areaUnit = QgsUnitTypes::decodeAreaUnit( areaUnitsString, &ok );
+    if ( !ok )
+    {
+      std::cerr << QStringLiteral( "%1 is not a valid area unit value." ).arg( areaUnitsString ).toLocal8Bit().constData() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int QgsProcessingExec::executeBatch( QgsProcessingContext::LogLevel logLevel )
+{
+  int result = 0;
+  for ( std::string line; std::getline( std::cin, line ); )
+  {
+    if ( QString::fromStdString( line ).trimmed().isEmpty() )
+      continue;
+
+    QString error;
+    const QVariantMap json = QgsJsonUtils::parseJson( line, error ).toMap();
+    const QString algId = json.value( QStringLiteral( "algorithm" ) ).toString();
+
+    QVariantMap params;
+    QString ellipsoid;
+    QgsUnitTypes::DistanceUnit distanceUnit = QgsUnitTypes::DistanceUnknownUnit;
+    QgsUnitTypes::AreaUnit areaUnit = QgsUnitTypes::AreaUnknownUnit;
+    QString projectPath;
+    int jobResult = 1;
+    if ( !error.isEmpty() )
+    {
+      std::cerr << QStringLiteral( "Could not parse JSON parameters: %1" ).arg( error ).toLocal8Bit().constData() << std::endl;
+    }
+    else if ( algId.isEmpty() )
+    {
+      std::cerr << QStringLiteral( "JSON parameters object must contain an \"algorithm\" key." ).toLocal8Bit().constData() << std::endl;
+    }
+    else if ( parseJsonParameters( json, params, ellipsoid, distanceUnit, areaUnit, projectPath ) )
+    {
+      jobResult = execute( algId, params, ellipsoid, distanceUnit, areaUnit, logLevel, true, projectPath, true );
+    }
+
+    if ( jobResult != 0 )
+    {
+      // keep one output line per algorithm, so that results can be matched with the input lines
+      QVariantMap failureJson;
+      failureJson.insert( QStringLiteral( "algorithm" ), algId );
+      failureJson.insert( QStringLiteral( "error" ), QStringLiteral( "The algorithm could not be executed, see the error output for details" ) );
+      std::cout << QgsJsonUtils::jsonFromVariant( failureJson ).dump();
+      result = 1;
+    }
+    std::cout << std::endl;
+  }
+  return result;
+}
+
+int QgsProcessingExec::execute( const QString &inputId, const QVariantMap &inputs, const QString &ellipsoid, QgsUnitTypes::DistanceUnit distanceUnit, QgsUnitTypes::AreaUnit areaUnit, QgsProcessingContext::LogLevel logLevel, bool useJson, const QString &projectPath, bool singleLineJson )
 {
   QVariantMap json;
   if ( useJson )
@@ -1099,10 +1160,16 @@ int QgsProcessingExec::execute( const QString &inputId, const QVariantMap &input
   if ( !projectPath.isEmpty() )
   {
     project = QgsProject::instance();
-    if ( !project->read( projectPath ) )
+    // in batch mode, the project is kept loaded between the algorithms using it
+    if ( projectPath != mLoadedProjectPath )
     {
-      std::cerr << QStringLiteral( "Could not load the QGIS project \"%1\"\n" ).arg( projectPath ).toLocal8Bit().constData();
-      return 1;
+      mLoadedProjectPath.clear();
+      if ( !project->read( projectPath ) )
+      {
+        std::cerr << QStringLiteral( "Could not load the QGIS project \"%1\"\n" ).arg( projectPath ).toLocal8Bit().constData();
+        return 1;
+      }
+      mLoadedProjectPath = projectPath;
     }
     json.insert( QStringLiteral( "project_path" ), projectPath );
   }
@@ -1255,7 +1322,7 @@ int QgsProcessingExec::execute( const QString &inputId, const QVariantMap &input
     if ( useJson )
     {
       json.insert( QStringLiteral( "results" ), resultsJson );
-      std::cout << QgsJsonUtils::jsonFromVariant( json ).dump( 2 );
+      std::cout << QgsJsonUtils::jsonFromVariant( json ).dump( singleLineJson ? -1 : 2 );
     }
     return 0;
   }
@@ -80,6 +80,24 @@ class QgsProcessingExec
     void listPlugins( bool useJson, bool showLoaded );
     int enablePlugin( const QString &name, bool enabled );
     int showAlgorithmHelp( const QString &id, bool useJson );
+
+    /**
+     * Reads the inputs, ellipsoid, units and project path of an algorithm run from a \a json object.
+     * Returns FALSE and reports the error if the object is not valid.
+     */
+    bool parseJsonParameters( const QVariantMap &json,
+                              QVariantMap &parameters,
+                              QString &ellipsoid,
+                              QgsUnitTypes::DistanceUnit &distanceUnit,
+                              QgsUnitTypes::AreaUnit &areaUnit,
+                              QString &projectPath );
+
+    /**
+     * Runs the algorithms read from STDIN, one JSON object per line, and writes their results
+     * to STDOUT, one JSON object per line.
+     */
+    int executeBatch( QgsProcessingContext::LogLevel logLevel );
+
     int execute( const QString &algId,
                  const QVariantMap &parameters,
                  const QString &ellipsoid,
@@ -87,7 +105,8 @@ class QgsProcessingExec
                  QgsUnitTypes::AreaUnit areaUnit,
                  QgsProcessingContext::LogLevel logLevel,
                  bool useJson,
-                 const QString &projectPath = QString() );
+                 const QString &projectPath = QString(),
+                 bool singleLineJson = false );
 
     void addVersionInformation( QVariantMap &json );
     void addAlgorithmInformation( QVariantMap &json, const QgsProcessingAlgorithm *algorithm );
@@ -95,6 +114,9 @@ class QgsProcessingExec
 
 
     bool mSkipPython = false;
+
+    //! Path of the project currently loaded in the project instance
+    QString mLoadedProjectPath;
 #ifdef WITH_BINDINGS
     std::unique_ptr< QgsPythonUtils > mPythonUtils;
     std::unique_ptr<QgsPythonUtils> loadPythonSupport();
@@ -21,12 +21,15 @@
 #include "qgsblockingnetworkrequest.h"
 #include "qgsreadwritelocker.h"
 #include "qgsjsonutils.h"
+#include "qgsfeedback.h"
 
 #include <QUrlQuery>
 #include <QNetworkRequest>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 #include <QFile>
+#include <QtConcurrentRun>
+#include <QThread>
 
 #include <nlohmann/json.hpp>
 
@@ -77,6 +80,8 @@ void QgsAfsSharedData::clearCache()
   mObjectIds.clear();
   mObjectIdToFeatureId.clear();
   mDeletedFeatureIds.clear();
+  mLastBatchStartId = -1;
+  discardPrefetchedBatch();
   QString error;
   getObjectIds( error );
 }
@@ -183,10 +188,13 @@ bool QgsAfsSharedData::getFeature( QgsFeatureId id, QgsFeature &f, const QgsRect
 
     // Query
     QString errorTitle, errorMessage;
-    queryData = QgsArcGisRestQueryUtils::getObjects(
-                  mDataSource.param( QStringLiteral( "url" ) ), authcfg, objectIds, mDataSource.param( QStringLiteral( "crs" ) ), true,
-                  QStringList(), QgsWkbTypes::hasM( mGeometryType ), QgsWkbTypes::hasZ( mGeometryType ),
-                  filterRect, errorTitle, errorMessage, mDataSource.httpHeaders(), feedback );
+    if ( !takePrefetchedBatch( objectIds, filterRect, queryData, feedback ) )
+    {
+      queryData = QgsArcGisRestQueryUtils::getObjects(
+                    mDataSource.param( QStringLiteral( "url" ) ), authcfg, objectIds, mDataSource.param( QStringLiteral( "crs" ) ), true,
+                    QStringList(), QgsWkbTypes::hasM( mGeometryType ), QgsWkbTypes::hasZ( mGeometryType ),
+                    filterRect, errorTitle, errorMessage, mDataSource.httpHeaders(), feedback );
+    }
 
     if ( feedback && feedback->isCanceled() )
     {
@@ -269,6 +277,23 @@ bool QgsAfsSharedData::getFeature( QgsFeatureId id, QgsFeature &f, const QgsRect
     mCache.insert( feature.id(), feature );
   }
 
+  // when the features are iterated in order, the next batch is downloaded while this one is used
+  const bool sequential = startId == mLastBatchStartId + mMaximumFetchObjectsCount;
+  mLastBatchStartId = startId;
+  if ( sequential )
+  {
+    const int nextStartId = startId + mMaximumFetchObjectsCount;
+    const int nextStopId = std::min< size_t >( nextStartId + mMaximumFetchObjectsCount, mObjectIds.length() );
+    QList<quint32> nextObjectIds;
+    for ( int i = nextStartId; i < nextStopId; ++i )
+    {
+      if ( !mDeletedFeatureIds.contains( i ) && !mCache.contains( i ) )
+        nextObjectIds.append( mObjectIds.at( i ) );
+    }
+    if ( !nextObjectIds.empty() )
+      prefetchBatch( nextObjectIds, filterRect );
+  }
+
   // If added to cache, return feature
   it = mCache.constFind( id );
   if ( it != mCache.constEnd() )
@@ -280,6 +305,70 @@ bool QgsAfsSharedData::getFeature( QgsFeatureId id, QgsFeature &f, const QgsRect
   return false;
 }
 
+void QgsAfsSharedData::prefetchBatch( const QList<quint32> &objectIds, const QgsRectangle &filterRect )
+{
+  QMutexLocker locker( &mPrefetchMutex );
+  if ( !mPrefetchedObjectIds.isEmpty() && !mPrefetchedBatch.isFinished() )
+    return;
+
+  // the download must not refer to this object, which may be deleted before it finishes
+  const QString url = mDataSource.param( QStringLiteral( "url" ) );
+  const QString authcfg = mDataSource.authConfigId();
+  const QString crs = mDataSource.param( QStringLiteral( "crs" ) );
+  const QgsHttpHeaders headers = mDataSource.httpHeaders();
+  const bool fetchM = QgsWkbTypes::hasM( mGeometryType );
+  const bool fetchZ = QgsWkbTypes::hasZ( mGeometryType );
+  const std::shared_ptr<QgsFeedback> feedback = std::make_shared<QgsFeedback>();
+  mPrefetchedObjectIds = objectIds;
+  mPrefetchedFilterRect = filterRect;
+  mPrefetchFeedback = feedback;
+  mPrefetchedBatch = QtConcurrent::run( [url, authcfg, objectIds, crs, fetchM, fetchZ, filterRect, headers, feedback]
+  {
+    QString errorTitle, errorMessage;
+    return QgsArcGisRestQueryUtils::getObjects( url, authcfg, objectIds, crs, true, QStringList(), fetchM, fetchZ,
+           filterRect, errorTitle, errorMessage, headers, feedback.get() );
+  } );
+}
+
+bool QgsAfsSharedData::takePrefetchedBatch( const QList<quint32> &objectIds, const QgsRectangle &filterRect, QVariantMap &queryData )
+{
+  QMutexLocker locker( &mPrefetchMutex );
+  if ( mPrefetchedObjectIds.isEmpty() || mPrefetchedObjectIds != objectIds || mPrefetchedFilterRect != filterRect )
+    return false;
+
+  mPrefetchedObjectIds.clear();
+  const QFuture<QVariantMap> batch = mPrefetchedBatch;
+  const std::shared_ptr<QgsFeedback> batchFeedback = std::move( mPrefetchFeedback );
+  locker.unlock();
+
+  // the download in the background doesn't know the feedback of the caller, which is checked while waiting
+  while ( !batch.isFinished() )
+  {
+    if ( feedback && feedback->isCanceled() )
+    {
+      if ( batchFeedback )
+        batchFeedback->cancel();
+      return false;
+    }
+    QThread::msleep( 10 );
+  }
+
+  // a failed download is done again, with the error handling of getFeature()
+  queryData = batch.result();
+  return !queryData.isEmpty();
+}
+
+void QgsAfsSharedData::discardPrefetchedBatch()
+{
+  QMutexLocker locker( &mPrefetchMutex );
+  mPrefetchedObjectIds.clear();
+  if ( mPrefetchFeedback )
+  {
+    mPrefetchFeedback->cancel();
+    mPrefetchFeedback.reset();
+  }
+}
+
 QgsFeatureIds QgsAfsSharedData::getFeatureIdsInExtent( const QgsRectangle &extent, QgsFeedback *feedback )
 {
   QString errorTitle;
@@ -330,6 +419,7 @@ bool QgsAfsSharedData::deleteFeatures( const QgsFeatureIds &ids, QString &error,
     mCache.remove( id );
     mDeletedFeatureIds.insert( id );
   }
+  discardPrefetchedBatch();
 
   return true;
 }
@@ -439,6 +529,7 @@ bool QgsAfsSharedData::updateFeatures( const QgsFeatureList &features, bool incl
   {
     mCache.remove( feature.id() );
   }
+  discardPrefetchedBatch();
   return true;
 }
 
@@ -477,6 +568,7 @@ bool QgsAfsSharedData::addFields( const QString &adminUrl, const QList<QgsField>
   // All good. Now we remove the cached versions of features so that they'll get re-fetched from the service
   QgsReadWriteLocker locker( mReadWriteLock, QgsReadWriteLocker::Write );
   mCache.clear();
+  discardPrefetchedBatch();
 
   for ( const QgsField &field : attributes )
   {
@@ -526,6 +618,7 @@ bool QgsAfsSharedData::deleteFields( const QString &adminUrl, const QgsAttribute
   // All good. Now we remove the cached versions of features so that they'll get re-fetched from the service
   QgsReadWriteLocker locker( mReadWriteLock, QgsReadWriteLocker::Write );
   mCache.clear();
+  discardPrefetchedBatch();
 
   for ( const QString &name : std::as_const( fieldNames ) )
   {
@@ -18,6 +18,8 @@
 
 #include <QObject>
 #include <QMutex>
+#include <QFuture>
+#include <memory>
 #include "qgsfields.h"
 #include "qgsfeature.h"
 #include "qgsdatasourceuri.h"
@@ -70,6 +72,16 @@ class QgsAfsSharedData : public QObject
 
     QVariantMap postData( const QUrl &url, const QByteArray &payload, QgsFeedback *feedback, bool &ok, QString &errorText ) const;
 
+    //! Starts downloading the features with the \a objectIds in the background
+    void prefetchBatch( const QList<quint32> &objectIds, const QgsRectangle &filterRect );
+    /**
+     * Waits for the download of the features with the \a objectIds if it was started in the background, returns FALSE otherwise.
+     * The download is canceled and FALSE is returned if the \a feedback is canceled while waiting.
+     */
+    bool takePrefetchedBatch( const QList<quint32> &objectIds, const QgsRectangle &filterRect, QVariantMap &queryData, QgsFeedback *feedback );
+    //! Discards and cancels the features downloaded in the background, e.g. after the features were edited
+    void discardPrefetchedBatch();
+
     friend class QgsAfsProvider;
     mutable QReadWriteLock mReadWriteLock{ QReadWriteLock::Recursive };
     QgsDataSourceUri mDataSource;
@@ -87,6 +99,17 @@ class QgsAfsSharedData : public QObject
 
     QSet<QgsFeatureId> mDeletedFeatureIds;
     QMap<QgsFeatureId, QgsFeature> mCache;
+
+    //! Start of the last batch of features stored in the cache, to detect when the features are iterated in order
+    int mLastBatchStartId = -1;
+
+    QMutex mPrefetchMutex;
+    //! Batch of features downloaded in the background while the features of the previous batch are used
+    QFuture<QVariantMap> mPrefetchedBatch;
+    //! Feedback of the download in the background, shared with the download which may outlive this object
+    std::shared_ptr<QgsFeedback> mPrefetchFeedback;
+    QList<quint32> mPrefetchedObjectIds;
+    QgsRectangle mPrefetchedFilterRect;
     QgsCoordinateReferenceSystem mSourceCRS;
 };
 
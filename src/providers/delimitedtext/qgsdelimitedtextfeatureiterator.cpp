@@ -21,10 +21,10 @@
 #include "qgslogger.h"
 #include "qgsmessagelog.h"
 #include "qgsproject.h"
-#include "qgsspatialindex.h"
+#include "qgsspatialindexpackedrtree.h"
 #include "qgsexception.h"
 #include "qgsexpressioncontextutils.h"
-#include "qgsgeometryengine.h"
+#include "qgsspatialfilterevaluator.h"
 
 #include <QtAlgorithms>
 #include <QTextStream>
@@ -97,21 +97,11 @@ QgsDelimitedTextFeatureIterator::QgsDelimitedTextFeatureIterator( QgsDelimitedTe
     }
   }
 
-  // prepare spatial filter geometries for optimal speed
-  switch ( mRequest.spatialFilterType() )
+  // the bounding box is tested while reading the records, exact intersections and distances
+  // are tested on the candidate features in parallel
+  if ( hasGeometry && ( ( mTestGeometry && mTestGeometryExact ) || mRequest.spatialFilterType() == Qgis::SpatialFilterType::DistanceWithin ) )
   {
-    case Qgis::SpatialFilterType::NoFilter:
-    case Qgis::SpatialFilterType::BoundingBox:
-      break;
-
-    case Qgis::SpatialFilterType::DistanceWithin:
-      if ( !mRequest.referenceGeometry().isEmpty() )
-      {
-        mDistanceWithinGeom = mRequest.referenceGeometry();
-        mDistanceWithinEngine.reset( QgsGeometry::createGeometryEngine( mDistanceWithinGeom.constGet() ) );
-        mDistanceWithinEngine->prepareGeometry();
-      }
-      break;
+    mSpatialFilter = QgsSpatialFilterEvaluator::fromRequest( mRequest, mFilterRect );
   }
 
   if ( request.filterType() == QgsFeatureRequest::FilterFid )
@@ -155,7 +145,7 @@ QgsDelimitedTextFeatureIterator::QgsDelimitedTextFeatureIterator( QgsDelimitedTe
        && (
          !( mRequest.flags() & QgsFeatureRequest::NoGeometry )
          || mTestGeometry
-         || mDistanceWithinEngine
+         || mSpatialFilter
          || ( mTestSubset && mSource->mSubsetExpression->needsGeometry() )
          || ( request.filterType() == QgsFeatureRequest::FilterExpression && request.filterExpression()->needsGeometry() )
        )
@@ -213,6 +203,52 @@ bool QgsDelimitedTextFeatureIterator::fetchFeature( QgsFeature &feature )
   if ( mClosed )
     return false;
 
+  bool gotFeature = false;
+  if ( mSpatialFilter )
+  {
+    gotFeature = mSpatialFilter->nextFeature( feature, [this]( QgsFeature & candidate ) { return nextCandidate( candidate ); } );
+
+    // intersections are tested in the source crs, distances in the destination crs
+    if ( gotFeature && mSpatialFilter->predicate() == QgsSpatialFilterEvaluator::Predicate::Intersects )
+      geometryToDestinationCrs( feature, mTransform );
+  }
+  else
+  {
+    gotFeature = nextCandidate( feature );
+  }
+
+  // CC: 2013-05-08:  What is the intent of rewind/close.  The following
+  // line from previous implementation means that we cannot rewind the iterator
+  // after reading last record? Is this correct?  This line can be removed if
+  // not.
+
+  if ( !gotFeature )
+    close();
+
+  return gotFeature;
+}
+
+bool QgsDelimitedTextFeatureIterator::nextCandidate( QgsFeature &feature )
+{
+  while ( nextRecordFeature( feature ) )
+  {
+    if ( mSpatialFilter && mSpatialFilter->predicate() == QgsSpatialFilterEvaluator::Predicate::Intersects )
+      return true;
+
+    // geometry must be in destination crs before we can perform distance within check
+    geometryToDestinationCrs( feature, mTransform );
+
+    // a geometry which cannot be transformed is not within the distance
+    if ( mSpatialFilter && !feature.hasGeometry() )
+      continue;
+
+    return true;
+  }
+  return false;
+}
+
+bool QgsDelimitedTextFeatureIterator::nextRecordFeature( QgsFeature &feature )
+{
   bool gotFeature = false;
   if ( mMode == FileScan )
   {
@@ -241,16 +277,6 @@ bool QgsDelimitedTextFeatureIterator::fetchFeature( QgsFeature &feature )
     }
   }
 
-  // CC: 2013-05-08:  What is the intent of rewind/close.  The following
-  // line from previous implementation means that we cannot rewind the iterator
-  // after reading last record? Is this correct?  This line can be removed if
-  // not.
-
-  if ( !gotFeature )
-    close();
-
-  geometryToDestinationCrs( feature, mTransform );
-
   return gotFeature;
 }
 
@@ -268,6 +294,10 @@ bool QgsDelimitedTextFeatureIterator::rewind()
   {
     mNextId = 0;
   }
+
+  if ( mSpatialFilter )
+    mSpatialFilter->reset();
+
   return true;
 }
 
@@ -285,52 +315,16 @@ bool QgsDelimitedTextFeatureIterator::close()
 
 bool QgsDelimitedTextFeatureIterator::testSpatialFilter( const QgsPointXY &pt ) const
 {
-  if ( mDistanceWithinEngine )
-  {
-    if ( !mTransform.isShortCircuited() )
-    {
-      QgsFeature candidate;
-      candidate.setGeometry( QgsGeometry::fromPointXY( pt ) );
-      geometryToDestinationCrs( candidate, mTransform );
-      return mDistanceWithinEngine->distance( candidate.geometry().constGet() ) <= mRequest.distanceWithin();
-    }
-    else
-    {
-      const QgsGeometry ptGeom( QgsGeometry::fromPointXY( pt ) );
-      return mDistanceWithinEngine->distance( ptGeom.constGet() ) <= mRequest.distanceWithin();
-    }
-  }
-  else if ( mTestGeometry )
-  {
+  if ( mTestGeometry )
     return mFilterRect.contains( pt );
-  }
   else
     return true;
 }
 
 bool QgsDelimitedTextFeatureIterator::testSpatialFilter( const QgsGeometry &geom ) const
 {
-  if ( mDistanceWithinEngine )
-  {
-    if ( !mTransform.isShortCircuited() )
-    {
-      QgsFeature candidate;
-      candidate.setGeometry( geom );
-      geometryToDestinationCrs( candidate, mTransform );
-      return candidate.hasGeometry() && mDistanceWithinEngine->distance( candidate.geometry().constGet() ) <= mRequest.distanceWithin();
-    }
-    else
-    {
-      return mDistanceWithinEngine->distance( geom.constGet() ) <= mRequest.distanceWithin();
-    }
-  }
-  else if ( mTestGeometry )
-  {
-    if ( mTestGeometryExact )
-      return geom.intersects( mFilterRect );
-    else
-      return geom.boundingBox().intersects( mFilterRect );
-  }
+  if ( mTestGeometry )
+    return geom.boundingBox().intersects( mFilterRect );
   else
     return true;
 }
@@ -389,7 +383,7 @@ bool QgsDelimitedTextFeatureIterator::nextFeatureInternal( QgsFeature &feature )
         geom = loadGeometryXY( tokens, nullGeom );
       }
 
-      if ( ( geom.isNull() && !nullGeom ) || ( nullGeom && mTestGeometry ) || ( nullGeom && mDistanceWithinEngine ) )
+      if ( ( geom.isNull() && !nullGeom ) || ( nullGeom && mTestGeometry ) || ( nullGeom && mSpatialFilter ) )
       {
         // if we didn't get a geom and not because it's null, or we got a null
         // geom and we are testing for intersecting geometries then ignore this
@@ -616,7 +610,7 @@ QgsDelimitedTextFeatureSource::QgsDelimitedTextFeatureSource( const QgsDelimited
   , mSubsetExpression( p->mSubsetExpression ? new QgsExpression( *p->mSubsetExpression ) : nullptr )
   , mExtent( p->mExtent )
   , mUseSpatialIndex( p->mUseSpatialIndex )
-  , mSpatialIndex( p->mSpatialIndex ? new QgsSpatialIndex( *p->mSpatialIndex ) : nullptr )
+  , mSpatialIndex( p->mSpatialIndex ? new QgsSpatialIndexPackedRTree( *p->mSpatialIndex ) : nullptr )
   , mUseSubsetIndex( p->mUseSubsetIndex )
   , mSubsetIndex( p->mSubsetIndex )
   , mFile( nullptr )
@@ -647,6 +641,7 @@ QgsDelimitedTextFeatureSource::QgsDelimitedTextFeatureSource( const QgsDelimited
 
   mFile.reset( new QgsDelimitedTextFile() );
   mFile->setFromUrl( url );
+  mFile->setRecordOffsets( p->mRecordOffsets );
 
   mExpressionContext << QgsExpressionContextUtils::globalScope()
                      << QgsExpressionContextUtils::projectScope( QgsProject::instance() );
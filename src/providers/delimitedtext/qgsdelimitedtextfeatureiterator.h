@@ -23,6 +23,8 @@
 
 #include "qgsdelimitedtextprovider.h"
 
+class QgsSpatialFilterEvaluator;
+
 class QgsDelimitedTextFeatureSource final: public QgsAbstractFeatureSource
 {
   public:
@@ -36,7 +38,7 @@ class QgsDelimitedTextFeatureSource final: public QgsAbstractFeatureSource
     QgsExpressionContext mExpressionContext;
     QgsRectangle mExtent;
     bool mUseSpatialIndex;
-    std::unique_ptr< QgsSpatialIndex > mSpatialIndex;
+    std::unique_ptr< QgsSpatialIndexPackedRTree > mSpatialIndex;
     bool mUseSubsetIndex;
     QList<quintptr> mSubsetIndex;
     std::unique_ptr< QgsDelimitedTextFile > mFile;
@@ -76,14 +78,14 @@ class QgsDelimitedTextFeatureIterator final: public QgsAbstractFeatureIteratorFr
     bool close() override;
 
     /**
-     * Check to see if the point is within the selection rectangle or within
-     * the desired distance from the reference geometry.
+     * Check to see if the point is within the selection rectangle.
      */
     bool testSpatialFilter( const QgsPointXY &point ) const;
 
     /**
-     * Check to see if the geometry is within the selection rectangle or within
-     * the desired distance from the reference geometry.
+     * Check to see if the geometry bounding box intersects the selection rectangle.
+     * Exact intersections and distances are tested by the spatial filter
+     * once the candidate features are read.
      */
     bool testSpatialFilter( const QgsGeometry &geom ) const;
 
@@ -94,6 +96,10 @@ class QgsDelimitedTextFeatureIterator final: public QgsAbstractFeatureIteratorFr
 
     bool setNextFeatureId( qint64 fid );
 
+    //! Retrieves the next feature matching the filters, apart from the exact spatial filter
+    bool nextCandidate( QgsFeature &feature );
+    bool nextRecordFeature( QgsFeature &feature );
+
     bool nextFeatureInternal( QgsFeature &feature );
     QgsGeometry loadGeometryWkt( const QStringList &tokens, bool &isNull );
     QgsGeometry loadGeometryXY( const QStringList &tokens, bool &isNull );
@@ -109,8 +115,7 @@ class QgsDelimitedTextFeatureIterator final: public QgsAbstractFeatureIteratorFr
     QgsRectangle mFilterRect;
     QgsCoordinateTransform mTransform;
 
-    QgsGeometry mDistanceWithinGeom;
-    std::unique_ptr< QgsGeometryEngine > mDistanceWithinEngine;
+    std::unique_ptr< QgsSpatialFilterEvaluator > mSpatialFilter;
 };
 
 
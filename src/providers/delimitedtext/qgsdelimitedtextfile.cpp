@@ -29,6 +29,8 @@
 #include <QUrl>
 #include <QUrlQuery>
 
+#include <algorithm>
+
 QgsDelimitedTextFile::QgsDelimitedTextFile( const QString &url )
   : mFileName( QString() )
   , mEncoding( QStringLiteral( "UTF-8" ) )
@@ -369,6 +371,15 @@ void QgsDelimitedTextFile::setTypeCSV( const QString &delim, const QString &quot
   mQuoteChar = decodeChars( quote );
   mEscapeChar = decodeChars( escape );
   mParser = &QgsDelimitedTextFile::parseQuoted;
+
+  // Lookup table of the special Latin-1 characters for the parser
+  std::fill( std::begin( mCharClasses ), std::end( mCharClasses ), 0 );
+  for ( const QChar c : std::as_const( mDelimChars ) )
+    if ( c.unicode() < 256 ) mCharClasses[c.unicode()] |= CharDelimiter;
+  for ( const QChar c : std::as_const( mQuoteChar ) )
+    if ( c.unicode() < 256 ) mCharClasses[c.unicode()] |= CharQuote;
+  for ( const QChar c : std::as_const( mEscapeChar ) )
+    if ( c.unicode() < 256 ) mCharClasses[c.unicode()] |= CharEscape;
   mDefinitionValid = !mDelimChars.isEmpty();
   if ( ! mDefinitionValid )
   {
@@ -499,9 +510,66 @@ bool QgsDelimitedTextFile::setNextRecordId( long nextRecordId )
 
   mHoldCurrentRecord = nextRecordId == mRecordLineNumber;
   if ( mHoldCurrentRecord ) return true;
+
+  // Jump to the closest known record before the requested one, unless
+  // reading on from the current line is shorter
+  if ( ! mRecordOffsets.isEmpty() )
+  {
+    auto known = std::upper_bound( mRecordOffsets.constBegin(), mRecordOffsets.constEnd(), nextRecordId,
+                                   []( long id, const QPair< qint64, qint64 > &offset ) { return id < offset.first; } );
+    if ( known != mRecordOffsets.constBegin() )
+    {
+      --known;
+      if ( known->first - 1 > mLineNumber || mLineNumber > nextRecordId - 1 )
+        seekToRecord( static_cast< long >( known->first ), known->second );
+    }
+  }
   return setNextLineNumber( nextRecordId );
 }
 
+void QgsDelimitedTextFile::setTrackRecordOffsets( bool track )
+{
+  if ( track == mTrackRecordOffsets ) return;
+  mTrackRecordOffsets = track;
+  if ( track && mFile ) reset();
+}
+
+bool QgsDelimitedTextFile::seekToRecord( long recordId, qint64 offset )
+{
+  // The first line is read from the start of the file to identify the end of line character
+  if ( recordId <= 1 ) return false;
+  if ( mLineNumber == 0 )
+  {
+    QString buffer;
+    if ( nextLine( buffer, false ) != RecordOk ) return false;
+  }
+  if ( mFirstEOLChar.isNull() || ! mFile->seek( offset ) ) return false;
+
+  mLineNumber = recordId - 1;
+  mRecordNumber = -1;
+  mRecordLineNumber = -1;
+  mBuffer = mCodec->toUnicode( mFile->read( mMaxBufferSize ) );
+  mPosInBuffer = 0;
+  mNextLineOffset = offset;
+  return true;
+}
+
+int QgsDelimitedTextFile::charClass( QChar c ) const
+{
+  if ( c.unicode() < 256 ) return mCharClasses[c.unicode()];
+  int result = 0;
+  if ( mDelimChars.contains( c ) ) result |= CharDelimiter;
+  if ( mQuoteChar.contains( c ) ) result |= CharQuote;
+  if ( mEscapeChar.contains( c ) ) result |= CharEscape;
+  return result;
+}
+
+qint64 QgsDelimitedTextFile::encodedSize( const QChar *text, int size ) const
+{
+  QTextCodec::ConverterState state( QTextCodec::IgnoreHeader );
+  return mCodec->fromUnicode( text, size, &state ).size();
+}
+
 QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextRecord( QStringList &record )
 {
 
@@ -524,6 +592,7 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextRecord( QStringList &reco
 
     mCurrentRecord.clear();
     mRecordLineNumber = mLineNumber;
+    mRecordOffset = mLineOffset;
     if ( mRecordNumber >= 0 )
     {
       mRecordNumber++;
@@ -579,7 +648,10 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
   if ( mLineNumber == 0 )
   {
     mPosInBuffer = 0;
-    mBuffer = mCodec->toUnicode( mFile->read( mMaxBufferSize ) );
+    const QByteArray data = mFile->read( mMaxBufferSize );
+    // The codec drops the UTF-8 byte order mark
+    mNextLineOffset = mCodec->mibEnum() == 106 && data.startsWith( "\xEF\xBB\xBF" ) ? 3 : 0;
+    mBuffer = mCodec->toUnicode( data );
   }
 
   while ( !mBuffer.isEmpty() )
@@ -588,6 +660,7 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
     // We should rather use mFile->readLine(), but it fails to detect \r
     // line endings.
     int eolPos = -1;
+    qint64 lineSize = 0;
     {
       if ( mLineNumber == 0 )
       {
@@ -639,6 +712,8 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
 
       // Extract the current line from the buffer
       buffer = mBuffer.mid( mPosInBuffer, eolPos - mPosInBuffer );
+      if ( mTrackRecordOffsets )
+        lineSize = encodedSize( mBuffer.constData() + mPosInBuffer, nextPos - mPosInBuffer );
       // Update current position in buffer to be the one next to the end of
       // line character(s)
       mPosInBuffer = nextPos;
@@ -653,6 +728,8 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
         // and set the buffer to null so that we don't iterate any more.
         buffer = mBuffer;
         mBuffer = QString();
+        if ( mTrackRecordOffsets )
+          lineSize = encodedSize( buffer.constData(), buffer.size() );
       }
       else
       {
@@ -664,6 +741,8 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
         continue;
       }
     }
+    mLineOffset = mNextLineOffset;
+    mNextLineOffset += lineSize;
     mLineNumber++;
     if ( skipBlank && buffer.isEmpty() ) continue;
     return RecordOk;
@@ -806,6 +885,28 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::parseQuoted( QString &buffer,
       break;
     }
 
+    // Copy runs of ordinary characters at once rather than one at a time
+    if ( ! escaped && ( quoted || ! ended ) )
+    {
+      const QChar *chars = buffer.constData();
+      const int runStart = cp;
+      if ( quoted )
+      {
+        // Delimiters are ordinary characters within quotes
+        while ( cp < cpmax && ( charClass( chars[cp] ) & ~CharDelimiter ) == 0 ) cp++;
+      }
+      else
+      {
+        while ( cp < cpmax && charClass( chars[cp] ) == 0 && ! chars[cp].isSpace() ) cp++;
+        if ( cp > runStart ) started = true;
+      }
+      if ( cp > runStart )
+      {
+        field.append( chars + runStart, cp - runStart );
+        continue;
+      }
+    }
+
     const QChar c = buffer[cp];
     cp++;
 
@@ -827,12 +928,13 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::parseQuoted( QString &buffer,
 
     bool isQuote = false;
     bool isEscape = false;
-    const bool isDelim = mDelimChars.contains( c );
+    const int cls = charClass( c );
+    const bool isDelim = cls & CharDelimiter;
     if ( ! isDelim )
     {
-      const bool isQuoteChar = mQuoteChar.contains( c );
+      const bool isQuoteChar = cls & CharQuote;
       isQuote = quoted ? c == quoteChar : isQuoteChar;
-      isEscape = mEscapeChar.contains( c );
+      isEscape = cls & CharEscape;
       if ( isQuoteChar && isEscape ) isEscape = isQuote;
     }
 
@@ -19,6 +19,8 @@
 #define QGSDELIMITEDTEXTFILE_H
 
 #include <QStringList>
+#include <QPair>
+#include <QVector>
 #include <QRegularExpression>
 #include <QUrl>
 #include <QObject>
@@ -292,6 +294,29 @@ class QgsDelimitedTextFile : public QObject
      */
     bool setNextRecordId( long nextRecordId );
 
+    /**
+     * Set to track the byte offsets of the records in the file while reading it.
+     * The offset of the last record read is returned by recordOffset().  Enabling
+     * the tracking resets the file, as the offsets are counted from its start.
+     * \param track True to track the offsets, false otherwise
+     */
+    void setTrackRecordOffsets( bool track );
+
+    /**
+     * Returns the byte offset in the file of the start of the last record read,
+     *  or -1 if the record offsets are not tracked.
+     */
+    qint64 recordOffset() const { return mTrackRecordOffsets ? mRecordOffset : -1; }
+
+    /**
+     * Set the byte offsets of known records, as pairs of record id and offset
+     *  ordered by record id.  When set, setNextRecordId() seeks to the closest
+     *  known record preceding the requested one rather than reading all the
+     *  lines from the start of the file.
+     *  \param offsets The record ids and their byte offsets in the file
+     */
+    void setRecordOffsets( const QVector< QPair< qint64, qint64 > > &offsets ) { mRecordOffsets = offsets; }
+
     /**
      * Number record number of records visited. After scanning the file
      *  serves as a record count.
@@ -391,6 +416,25 @@ class QgsDelimitedTextFile : public QObject
      */
     bool setNextLineNumber( long nextLineNumber );
 
+    /**
+     * Move the file to the record starting at \a recordId, at byte offset \a offset.
+     */
+    bool seekToRecord( long recordId, qint64 offset );
+
+    //! Classes of the characters special to the quoted parser
+    enum CharClass
+    {
+      CharDelimiter = 1,
+      CharQuote = 2,
+      CharEscape = 4
+    };
+
+    //! Returns the combination of CharClass flags of \a c
+    int charClass( QChar c ) const;
+
+    //! Returns the number of bytes used to encode \a size characters of \a text in the file
+    qint64 encodedSize( const QChar *text, int size ) const;
+
     /**
      * Utility routine to add a field to a record, accounting for trimming
      *  and discarding, and maximum field count
@@ -423,6 +467,7 @@ class QgsDelimitedTextFile : public QObject
     QString mDelimChars;
     QString mQuoteChar;
     QString mEscapeChar;
+    quint8 mCharClasses[256] = {};
 
     // Information extracted from file
     QStringList mFieldNames;
@@ -439,6 +484,13 @@ class QgsDelimitedTextFile : public QObject
     long mMaxRecordNumber = -1;
     int mMaxFieldCount = 0;
 
+    // Byte offsets of the records
+    bool mTrackRecordOffsets = false;
+    qint64 mNextLineOffset = 0;
+    qint64 mLineOffset = 0;
+    qint64 mRecordOffset = -1;
+    QVector< QPair< qint64, qint64 > > mRecordOffsets;
+
     QString mDefaultFieldName;
     QRegularExpression mDefaultFieldRegexp;
 };
@@ -21,12 +21,15 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QDataStream>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QStringList>
 #include <QSettings>
 #include <QRegularExpression>
 #include <QUrl>
 #include <QUrlQuery>
+#include <QThread>
+#include <QtConcurrentMap>
 
 #include "qgsapplication.h"
 #include "qgscoordinateutils.h"
@@ -40,7 +43,7 @@
 #include "qgsmessagelog.h"
 #include "qgsmessageoutput.h"
 #include "qgsrectangle.h"
-#include "qgsspatialindex.h"
+#include "qgsspatialindexpackedrtree.h"
 #include "qgis.h"
 #include "qgsexpressioncontextutils.h"
 #include "qgsproviderregistry.h"
@@ -58,6 +61,35 @@ const QString QgsDelimitedTextProvider::TEXT_PROVIDER_DESCRIPTION = QStringLiter
 
 static const int SUBSET_ID_THRESHOLD_FACTOR = 10;
 
+// Records are read from the closest record with a known byte offset, one every
+// RECORD_OFFSET_INTERVAL records
+
+static const int RECORD_OFFSET_INTERVAL = 64;
+
+// Number of records read ahead by the scan of the file, and minimum number of
+// records of a batch for their geometries to be parsed on several threads
+
+static const int SCAN_BATCH_SIZE = 4096;
+static const int PARALLEL_PARSE_MINIMUM_COUNT = 256;
+
+// A record read ahead by the scan of the file, with its parsed geometry
+
+struct ScanRecord
+{
+  QStringList parts;
+  long recordId = -1;
+  bool hasGeometry = false;
+  bool geometryValid = false;
+  bool wktHasPrefix = false;
+  QgsGeometry geometry;
+  QgsPoint point;
+};
+
+// Identifies the index files written by the provider
+
+static const quint32 INDEX_FILE_MAGIC = 0x51445449; // "QDTI"
+static const quint32 INDEX_FILE_VERSION = 1;
+
 QRegularExpression QgsDelimitedTextProvider::sWktPrefixRegexp( QStringLiteral( "^\\s*(?:\\d+\\s+|SRID\\=\\d+\\;)" ), QRegularExpression::CaseInsensitiveOption );
 QRegularExpression QgsDelimitedTextProvider::sCrdDmsRegexp( QStringLiteral( "^\\s*(?:([-+nsew])\\s*)?(\\d{1,3})(?:[^0-9.]+([0-5]?\\d))?[^0-9.]+([0-5]?\\d(?:\\.\\d+)?)[^0-9.]*([-+nsew])?\\s*$" ), QRegularExpression::CaseInsensitiveOption );
 
@@ -151,6 +183,11 @@ QgsDelimitedTextProvider::QgsDelimitedTextProvider( const QString &uri, const Pr
     mBuildSpatialIndex = ! query.queryItemValue( QStringLiteral( "spatialIndex" ) ).toLower().startsWith( 'n' );
   }
 
+  if ( query.hasQueryItem( QStringLiteral( "indexFile" ) ) )
+  {
+    mUseIndexFile = ! query.queryItemValue( QStringLiteral( "indexFile" ) ).toLower().startsWith( 'n' );
+  }
+
   if ( query.hasQueryItem( QStringLiteral( "subset" ) ) )
   {
     // We need to specify FullyDecoded so that %25 is decoded as %
@@ -298,7 +335,7 @@ void QgsDelimitedTextProvider::resetIndexes() const
 
   mSubsetIndex.clear();
   if ( mBuildSpatialIndex && mGeomRep != GeomNone )
-    mSpatialIndex = std::make_unique< QgsSpatialIndex >();
+    mSpatialIndex = std::make_unique< QgsSpatialIndexPackedRTree >();
 }
 
 bool QgsDelimitedTextProvider::createSpatialIndex()
@@ -412,6 +449,18 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes, bool forceFullScan,
     return;
   }
 
+  // Restore the results of a previous scan of the file if it is unchanged
+
+  if ( mUseIndexFile && readIndexFile( buildIndexes ) )
+  {
+    QgsDebugMsgLevel( QStringLiteral( "Delimited text scan read from index file %1" ).arg( indexFileName() ), 2 );
+    mUseSpatialIndex = buildSpatialIndex;
+    mValid = mGeometryType != QgsWkbTypes::UnknownGeometry;
+    mLayerValid = mValid;
+    connect( mFile.get(), &QgsDelimitedTextFile::fileUpdated, this, &QgsDelimitedTextProvider::onFileUpdated );
+    return;
+  }
+
   // Scan the entire file to determine
   // 1) the number of fields (this is handled by QgsDelimitedTextFile mFile
   // 2) the number of valid features.  Note that the selection of valid features
@@ -421,7 +470,6 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes, bool forceFullScan,
   //
   // Also build subset and spatial indexes.
 
-  QStringList parts;
   long nEmptyRecords = 0;
   long nBadFormatRecords = 0;
   long nIncompatibleGeometry = 0;
@@ -443,34 +491,123 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes, bool forceFullScan,
   QMap<int, QPair<QString, QString>> boolCandidates;
   const QList<QPair<QString, QString>> boolLiterals { booleanLiterals() };
 
+  QVector<QgsFeatureId> spatialIndexIds;
+  QVector<QgsRectangle> spatialIndexBounds;
+
+  // The record offsets are only stored in the index file, which requires a full scan
+  const bool trackRecordOffsets = mUseIndexFile && ( forceFullScan || ! mReadFlags.testFlag( ReadFlag::SkipFullScan ) );
+  long nRecords = 0;
+  mRecordOffsets.clear();
+  mFile->setTrackRecordOffsets( trackRecordOffsets );
+
+  // Records are read ahead in batches, so that their geometries can be parsed
+  // on several threads.  The fast scan only reads the first records.
+  const int batchSize = ! forceFullScan && mReadFlags.testFlag( ReadFlag::SkipFullScan ) ? 1 : SCAN_BATCH_SIZE;
+  QVector<ScanRecord> batch;
+  int batchPos = 0;
+  bool endOfFile = false;
+
+  const auto parseGeometry = [this]( ScanRecord & record )
+  {
+    const QStringList &parts = record.parts;
+    if ( mGeomRep == GeomAsWkt )
+    {
+      record.hasGeometry = mWktFieldIndex < parts.size() && !parts[mWktFieldIndex].isEmpty();
+      if ( record.hasGeometry )
+      {
+        QString sWkt = parts[mWktFieldIndex];
+        record.wktHasPrefix = sWkt.indexOf( sWktPrefixRegexp ) >= 0;
+        record.geometry = geomFromWkt( sWkt, record.wktHasPrefix );
+        record.geometryValid = !record.geometry.isNull();
+      }
+    }
+    else if ( mGeomRep == GeomAsXy )
+    {
+      // Get the x and y values, first checking to make sure they
+      // aren't null.
+
+      QString sX = mXFieldIndex < parts.size() ? parts[mXFieldIndex] : QString();
+      QString sY = mYFieldIndex < parts.size() ? parts[mYFieldIndex] : QString();
+      QString sZ, sM;
+      if ( mZFieldIndex > -1 )
+        sZ = mZFieldIndex < parts.size() ? parts[mZFieldIndex] : QString();
+      if ( mMFieldIndex > -1 )
+        sM = mMFieldIndex < parts.size() ? parts[mMFieldIndex] : QString();
+      record.hasGeometry = !sX.isEmpty() || !sY.isEmpty();
+      if ( record.hasGeometry )
+      {
+        record.geometryValid = pointFromXY( sX, sY, record.point, mDecimalPoint, mXyDms );
+        if ( record.geometryValid && ( !sZ.isEmpty() || sM.isEmpty() ) )
+          appendZM( sZ, sM, record.point, mDecimalPoint );
+      }
+    }
+  };
+
+  const auto readBatch = [&]()
+  {
+    batch.clear();
+    batchPos = 0;
+    QStringList parts;
+    while ( batch.size() < batchSize && !( feedback && feedback->isCanceled() ) )
+    {
+      const QgsDelimitedTextFile::Status status = mFile->nextRecord( parts );
+      if ( status == QgsDelimitedTextFile::RecordEOF )
+      {
+        endOfFile = true;
+        break;
+      }
+      if ( trackRecordOffsets && nRecords++ % RECORD_OFFSET_INTERVAL == 0 )
+        mRecordOffsets.append( qMakePair( static_cast< qint64 >( mFile->recordId() ), mFile->recordOffset() ) );
+      if ( status != QgsDelimitedTextFile::RecordOk )
+      {
+        nBadFormatRecords++;
+        recordInvalidLine( tr( "Invalid record format at line %1" ), mFile->recordId() );
+        continue;
+      }
+      // Skip over empty records
+      if ( recordIsEmpty( parts ) )
+      {
+        nEmptyRecords++;
+        continue;
+      }
+
+      ScanRecord record;
+      record.parts = parts;
+      record.recordId = mFile->recordId();
+      batch.append( record );
+    }
+
+    if ( mGeomRep == GeomNone )
+      return;
+    if ( batch.size() >= PARALLEL_PARSE_MINIMUM_COUNT && QThread::idealThreadCount() > 1 )
+      QtConcurrent::blockingMap( batch, parseGeometry );
+    else
+      std::for_each( batch.begin(), batch.end(), parseGeometry );
+  };
+
   while ( true )
   {
     if ( feedback && feedback->isCanceled() )
     {
       break;
     }
-    const QgsDelimitedTextFile::Status status = mFile->nextRecord( parts );
-    if ( status == QgsDelimitedTextFile::RecordEOF )
-      break;
-    if ( status != QgsDelimitedTextFile::RecordOk )
-    {
-      nBadFormatRecords++;
-      recordInvalidLine( tr( "Invalid record format at line %1" ) );
-      continue;
-    }
-    // Skip over empty records
-    if ( recordIsEmpty( parts ) )
+    if ( batchPos >= batch.size() )
     {
-      nEmptyRecords++;
-      continue;
+      if ( endOfFile )
+        break;
+      readBatch();
+      if ( batch.isEmpty() )
+        continue;
     }
+    ScanRecord &record = batch[batchPos++];
+    QStringList &parts = record.parts;
 
     // Check geometries are valid
     bool geomValid = true;
 
     if ( mGeomRep == GeomAsWkt )
     {
-      if ( mWktFieldIndex >= parts.size() || parts[mWktFieldIndex].isEmpty() )
+      if ( !record.hasGeometry )
       {
         nEmptyGeometry++;
         mNumberFeatures++;
@@ -480,13 +617,11 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes, bool forceFullScan,
         // Get the wkt - confirm it is valid, get the type, and
         // if compatible with the rest of file, add to the extents
 
-        QString sWkt = parts[mWktFieldIndex];
-        QgsGeometry geom;
-        if ( !mWktHasPrefix && sWkt.indexOf( sWktPrefixRegexp ) >= 0 )
+        const QgsGeometry &geom = record.geometry;
+        if ( record.wktHasPrefix )
           mWktHasPrefix = true;
-        geom = geomFromWkt( sWkt, mWktHasPrefix );
 
-        if ( !geom.isNull() )
+        if ( record.geometryValid )
         {
           const QgsWkbTypes::Type type = geom.wkbType();
           if ( type != QgsWkbTypes::NoGeometry )
@@ -511,10 +646,8 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes, bool forceFullScan,
               }
               if ( buildSpatialIndex )
               {
-                QgsFeature f;
-                f.setId( mFile->recordId() );
-                f.setGeometry( geom );
-                mSpatialIndex->addFeature( f );
+                spatialIndexIds.append( record.recordId );
+                spatialIndexBounds.append( geom.boundingBox() );
               }
             }
             else
@@ -528,37 +661,23 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes, bool forceFullScan,
         {
           geomValid = false;
           nInvalidGeometry++;
-          recordInvalidLine( tr( "Invalid WKT at line %1" ) );
+          recordInvalidLine( tr( "Invalid WKT at line %1" ), record.recordId );
         }
       }
     }
     else if ( mGeomRep == GeomAsXy )
     {
-      // Get the x and y values, first checking to make sure they
-      // aren't null.
-
-      QString sX = mXFieldIndex < parts.size() ? parts[mXFieldIndex] : QString();
-      QString sY = mYFieldIndex < parts.size() ? parts[mYFieldIndex] : QString();
-      QString sZ, sM;
-      if ( mZFieldIndex > -1 )
-        sZ = mZFieldIndex < parts.size() ? parts[mZFieldIndex] : QString();
-      if ( mMFieldIndex > -1 )
-        sM = mMFieldIndex < parts.size() ? parts[mMFieldIndex] : QString();
-      if ( sX.isEmpty() && sY.isEmpty() )
+      if ( !record.hasGeometry )
       {
         nEmptyGeometry++;
         mNumberFeatures++;
       }
       else
       {
-        QgsPoint pt;
-        const bool ok = pointFromXY( sX, sY, pt, mDecimalPoint, mXyDms );
+        const QgsPoint &pt = record.point;
 
-        if ( ok )
+        if ( record.geometryValid )
         {
-          if ( !sZ.isEmpty() || sM.isEmpty() )
-            appendZM( sZ, sM, pt, mDecimalPoint );
-
           if ( foundFirstGeometry )
           {
             mExtent.combineExtentWith( pt.x(), pt.y() );
@@ -578,17 +697,15 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes, bool forceFullScan,
           mNumberFeatures++;
           if ( buildSpatialIndex && std::isfinite( pt.x() ) && std::isfinite( pt.y() ) )
           {
-            QgsFeature f;
-            f.setId( mFile->recordId() );
-            f.setGeometry( QgsGeometry::fromPointXY( pt ) );
-            mSpatialIndex->addFeature( f );
+            spatialIndexIds.append( record.recordId );
+            spatialIndexBounds.append( QgsRectangle( pt.x(), pt.y(), pt.x(), pt.y() ) );
           }
         }
         else
         {
           geomValid = false;
           nInvalidGeometry++;
-          recordInvalidLine( tr( "Invalid X or Y fields at line %1" ) );
+          recordInvalidLine( tr( "Invalid X or Y fields at line %1" ), record.recordId );
         }
       }
     }
@@ -608,7 +725,7 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes, bool forceFullScan,
       continue;
 
     if ( buildSubsetIndex )
-      mSubsetIndex.append( mFile->recordId() );
+      mSubsetIndex.append( record.recordId );
 
 
     // If we are going to use this record, then assess the potential types of each column
@@ -733,6 +850,12 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes, bool forceFullScan,
     }
   }
 
+  const bool scanCanceled = feedback && feedback->isCanceled();
+  mFile->setTrackRecordOffsets( false );
+
+  if ( buildSpatialIndex )
+    mSpatialIndex = std::make_unique< QgsSpatialIndexPackedRTree >( spatialIndexIds, spatialIndexBounds );
+
   // Final progress changed
   if ( feedback )
   {
@@ -899,6 +1022,9 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes, bool forceFullScan,
   mValid = mGeometryType != QgsWkbTypes::UnknownGeometry;
   mLayerValid = mValid;
 
+  if ( mValid && trackRecordOffsets && ! scanCanceled )
+    writeIndexFile( buildIndexes );
+
   // If it is valid, then watch for changes to the file
   connect( mFile.get(), &QgsDelimitedTextFile::fileUpdated, this, &QgsDelimitedTextProvider::onFileUpdated );
 }
@@ -971,6 +1097,8 @@ void QgsDelimitedTextProvider::rescanFile() const
   mExtent = QgsRectangle();
   QgsFeature f;
   bool foundFirstGeometry = false;
+  QVector<QgsFeatureId> spatialIndexIds;
+  QVector<QgsRectangle> spatialIndexBounds;
   while ( fi.nextFeature( f ) )
   {
     if ( mGeometryType != QgsWkbTypes::NullGeometry && f.hasGeometry() )
@@ -986,7 +1114,10 @@ void QgsDelimitedTextProvider::rescanFile() const
         mExtent.combineExtentWith( bbox );
       }
       if ( buildSpatialIndex )
-        mSpatialIndex->addFeature( f );
+      {
+        spatialIndexIds.append( f.id() );
+        spatialIndexBounds.append( f.geometry().boundingBox() );
+      }
     }
     if ( buildSubsetIndex )
       mSubsetIndex.append( ( quintptr ) f.id() );
@@ -1001,6 +1132,8 @@ void QgsDelimitedTextProvider::rescanFile() const
       mSubsetIndex.clear();
   }
 
+  if ( buildSpatialIndex )
+    mSpatialIndex = std::make_unique< QgsSpatialIndexPackedRTree >( spatialIndexIds, spatialIndexBounds );
   mUseSpatialIndex = buildSpatialIndex;
 }
 
@@ -1126,11 +1259,11 @@ bool QgsDelimitedTextProvider::recordIsEmpty( QStringList &record )
   return true;
 }
 
-void QgsDelimitedTextProvider::recordInvalidLine( const QString &message )
+void QgsDelimitedTextProvider::recordInvalidLine( const QString &message, long recordId )
 {
   if ( mInvalidLines.size() < mMaxInvalidLines )
   {
-    mInvalidLines.append( message.arg( mFile->recordId() ) );
+    mInvalidLines.append( message.arg( recordId ) );
   }
   else
   {
@@ -1296,6 +1429,163 @@ void QgsDelimitedTextProvider::setUriParameter( const QString &parameter, const
   setDataSourceUri( QString::fromLatin1( url.toEncoded() ) );
 }
 
+QString QgsDelimitedTextProvider::indexFileName() const
+{
+  return mFile->fileName() + QStringLiteral( ".qdtidx" );
+}
+
+QString QgsDelimitedTextProvider::indexFileDefinition() const
+{
+  // Parameters which don't change the results of the scan
+  const QStringList ignoredItems
+  {
+    QStringLiteral( "subset" ),
+    QStringLiteral( "quiet" ),
+    QStringLiteral( "watchFile" ),
+    QStringLiteral( "spatialIndex" ),
+    QStringLiteral( "indexFile" ),
+    QStringLiteral( "crs" )
+  };
+
+  const QUrl url = QUrl::fromEncoded( dataSourceUri().toLatin1() );
+  QStringList items;
+  const QList<QPair<QString, QString> > queryItems { QUrlQuery( url ).queryItems( QUrl::ComponentFormattingOption::FullyDecoded ) };
+  for ( const QPair<QString, QString> &queryItem : queryItems )
+  {
+    if ( ! ignoredItems.contains( queryItem.first ) )
+      items.append( queryItem.first + '=' + queryItem.second );
+  }
+  // Field types read from a CSVT file
+  items.append( readCsvtFieldTypes( mFile->fileName() ).join( ',' ) );
+  return items.join( '&' );
+}
+
+bool QgsDelimitedTextProvider::readIndexFile( bool buildIndexes )
+{
+  QFile file( indexFileName() );
+  if ( ! file.open( QIODevice::ReadOnly ) )
+    return false;
+
+  QDataStream in( &file );
+  quint32 magic = 0;
+  quint32 version = 0;
+  in >> magic >> version;
+  if ( magic != INDEX_FILE_MAGIC || version != INDEX_FILE_VERSION )
+    return false;
+
+  // The index file must match the current file and parameters
+  QString definition;
+  qint64 fileSize = -1;
+  qint64 fileModified = -1;
+  in >> definition >> fileSize >> fileModified;
+  const QFileInfo fileInfo( mFile->fileName() );
+  if ( in.status() != QDataStream::Ok || definition != indexFileDefinition()
+       || fileSize != fileInfo.size() || fileModified != fileInfo.lastModified().toMSecsSinceEpoch() )
+  {
+    QgsDebugMsgLevel( QStringLiteral( "Index file %1 is out of date" ).arg( file.fileName() ), 2 );
+    return false;
+  }
+
+  int fieldCount = 0;
+  QList<int> columns;
+  QgsFields fields;
+  QMap<int, QPair<QString, QString>> fieldBooleanLiterals;
+  bool wktHasPrefix = false;
+  qint32 wkbType = QgsWkbTypes::Unknown;
+  qint32 geometryType = QgsWkbTypes::UnknownGeometry;
+  qint64 numberFeatures = 0;
+  QgsRectangle extent;
+  bool indexesBuilt = false;
+  bool useSubsetIndex = false;
+  QVector<qint64> subsetIndex;
+  qint64 spatialIndexSize = -1;
+  QVector<QPair<qint64, qint64>> recordOffsets;
+  in >> fieldCount >> columns >> fields >> fieldBooleanLiterals >> wktHasPrefix >> wkbType >> geometryType
+     >> numberFeatures >> extent >> indexesBuilt >> useSubsetIndex >> subsetIndex >> spatialIndexSize >> recordOffsets;
+  if ( in.status() != QDataStream::Ok || ( buildIndexes && ! indexesBuilt ) )
+    return false;
+
+  const bool loadSpatialIndex = buildIndexes && mSpatialIndex;
+  QgsSpatialIndexPackedRTree spatialIndex;
+  if ( loadSpatialIndex )
+  {
+    bool ok = false;
+    spatialIndex = QgsSpatialIndexPackedRTree::fromFile( indexFileName() + QStringLiteral( ".rtree" ), &ok );
+    if ( ! ok || static_cast< qint64 >( spatialIndex.size() ) != spatialIndexSize )
+      return false;
+  }
+
+  mFieldCount = fieldCount;
+  attributeColumns = columns;
+  attributeFields = fields;
+  mFieldBooleanLiterals = fieldBooleanLiterals;
+  mWktHasPrefix = wktHasPrefix;
+  mWkbType = static_cast< QgsWkbTypes::Type >( wkbType );
+  mGeometryType = static_cast< QgsWkbTypes::GeometryType >( geometryType );
+  mNumberFeatures = numberFeatures;
+  mExtent = extent;
+  mRecordOffsets = recordOffsets;
+
+  if ( buildIndexes && mBuildSubsetIndex && mGeomRep != GeomNone )
+  {
+    mUseSubsetIndex = useSubsetIndex;
+    mSubsetIndex.clear();
+    mSubsetIndex.reserve( subsetIndex.size() );
+    for ( const qint64 recordId : std::as_const( subsetIndex ) )
+      mSubsetIndex.append( static_cast< quintptr >( recordId ) );
+  }
+
+  if ( loadSpatialIndex )
+    *mSpatialIndex = spatialIndex;
+
+  return true;
+}
+
+void QgsDelimitedTextProvider::writeIndexFile( bool indexesBuilt ) const
+{
+  // The spatial index is written first, as the index file records its size. It is replaced
+  // rather than overwritten, as the previous file may still be mapped by other layers.
+  qint64 spatialIndexSize = -1;
+  if ( indexesBuilt && mSpatialIndex )
+  {
+    const QString spatialIndexFileName = indexFileName() + QStringLiteral( ".rtree" );
+    const QString temporaryFileName = spatialIndexFileName + QStringLiteral( ".tmp" );
+    if ( ! mSpatialIndex->writeToFile( temporaryFileName ) )
+      return;
+    QFile::remove( spatialIndexFileName );
+    if ( ! QFile::rename( temporaryFileName, spatialIndexFileName ) )
+    {
+      QgsDebugMsg( QStringLiteral( "Could not write spatial index file %1" ).arg( spatialIndexFileName ) );
+      QFile::remove( temporaryFileName );
+      return;
+    }
+    spatialIndexSize = static_cast< qint64 >( mSpatialIndex->size() );
+  }
+
+  QSaveFile file( indexFileName() );
+  if ( ! file.open( QIODevice::WriteOnly ) )
+  {
+    QgsDebugMsg( QStringLiteral( "Could not write index file %1" ).arg( file.fileName() ) );
+    return;
+  }
+
+  QVector<qint64> subsetIndex;
+  subsetIndex.reserve( mSubsetIndex.size() );
+  for ( const quintptr recordId : std::as_const( mSubsetIndex ) )
+    subsetIndex.append( static_cast< qint64 >( recordId ) );
+
+  const QFileInfo fileInfo( mFile->fileName() );
+  QDataStream out( &file );
+  out << INDEX_FILE_MAGIC << INDEX_FILE_VERSION
+      << indexFileDefinition() << static_cast< qint64 >( fileInfo.size() ) << static_cast< qint64 >( fileInfo.lastModified().toMSecsSinceEpoch() )
+      << mFieldCount << attributeColumns << attributeFields << mFieldBooleanLiterals << mWktHasPrefix
+      << static_cast< qint32 >( mWkbType ) << static_cast< qint32 >( mGeometryType ) << static_cast< qint64 >( mNumberFeatures ) << mExtent
+      << indexesBuilt << mUseSubsetIndex << subsetIndex << spatialIndexSize << mRecordOffsets;
+
+  if ( ! file.commit() )
+    QgsDebugMsg( QStringLiteral( "Could not write index file %1" ).arg( file.fileName() ) );
+}
+
 void QgsDelimitedTextProvider::onFileUpdated()
 {
   if ( ! mRescanRequired )
@@ -1304,6 +1594,8 @@ void QgsDelimitedTextProvider::onFileUpdated()
     messages.append( tr( "The file has been updated by another application - reloading" ) );
     reportErrors( messages );
     mRescanRequired = true;
+    // The record offsets no longer match the file
+    mRecordOffsets.clear();
     emit dataChanged();
   }
 }
@@ -38,7 +38,7 @@ class QgsFeedback;
 
 class QgsDelimitedTextFeatureIterator;
 class QgsExpression;
-class QgsSpatialIndex;
+class QgsSpatialIndexPackedRTree;
 
 /**
  * \class QgsDelimitedTextProvider
@@ -158,11 +158,38 @@ class QgsDelimitedTextProvider final: public QgsVectorDataProvider
     void resetCachedSubset() const;
     void resetIndexes() const;
     void clearInvalidLines() const;
-    void recordInvalidLine( const QString &message );
+    void recordInvalidLine( const QString &message, long recordId );
     void reportErrors( const QStringList &messages = QStringList(), bool showDialog = false ) const;
     static bool recordIsEmpty( QStringList &record );
     void setUriParameter( const QString &parameter, const QString &value );
 
+    /**
+     * Returns the name of the sidecar file used to persist the results of the
+     * file scan and the record offsets.  The spatial index is written next to it,
+     * in a file with an additional ".rtree" suffix.
+     */
+    QString indexFileName() const;
+
+    /**
+     * Returns a string identifying the parameters affecting the scan of the file,
+     * so that an index file written with other parameters is not reused.
+     */
+    QString indexFileDefinition() const;
+
+    /**
+     * Restores the results of the file scan from the index file, if it matches the
+     * current file and parameters.  The spatial index is only loaded if
+     * \a loadSpatialIndex is true.
+     * \returns True if the index file was read
+     */
+    bool readIndexFile( bool loadSpatialIndex );
+
+    /**
+     * Writes the results of the file scan, the record offsets and the spatial index to the index file.
+     * \param indexesBuilt True if the subset and spatial indexes were built by the scan
+     */
+    void writeIndexFile( bool indexesBuilt ) const;
+
 
     static QgsGeometry geomFromWkt( QString &sWkt, bool wktHasPrefixRegexp );
     static bool pointFromXY( QString &sX, QString &sY, QgsPoint &point, const QString &decimalPoint, bool xyDms );
@@ -240,7 +267,12 @@ class QgsDelimitedTextProvider final: public QgsVectorDataProvider
     bool mBuildSpatialIndex = false;
     mutable bool mUseSpatialIndex;
     mutable bool mCachedUseSpatialIndex;
-    mutable std::unique_ptr< QgsSpatialIndex > mSpatialIndex;
+    mutable std::unique_ptr< QgsSpatialIndexPackedRTree > mSpatialIndex;
+
+    // Sidecar index file
+    bool mUseIndexFile = false;
+    // Byte offsets of every RECORD_OFFSET_INTERVAL records as pairs of record id and offset
+    mutable QVector< QPair< qint64, qint64 > > mRecordOffsets;
 
     // Store user-defined column types (i.e. types that are not automatically determined)
     QgsStringMap mUserDefinedFieldTypes;
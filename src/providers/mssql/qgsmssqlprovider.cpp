@@ -1136,6 +1136,11 @@ bool QgsMssqlProvider::isValid() const
 
 bool QgsMssqlProvider::addFeatures( QgsFeatureList &flist, Flags flags )
 {
+  // consecutive features with the same statement reuse the prepared query, only their values are bound again
+  QSqlQuery query = createQuery();
+  query.setForwardOnly( true );
+  QString preparedStatement;
+
   for ( QgsFeatureList::iterator it = flist.begin(); it != flist.end(); ++it )
   {
     if ( it->hasGeometry() && mWkbType == QgsWkbTypes::NoGeometry )
@@ -1188,8 +1193,6 @@ bool QgsMssqlProvider::addFeatures( QgsFeatureList &flist, Flags flags )
     statement += QStringLiteral( "INSERT INTO [%1].[%2] (" ).arg( mSchemaName, mTableName );
 
     bool first = true;
-    QSqlQuery query = createQuery();
-    query.setForwardOnly( true );
 
     const QgsAttributes attrs = it->attributes();
 
@@ -1278,17 +1281,27 @@ bool QgsMssqlProvider::addFeatures( QgsFeatureList &flist, Flags flags )
     }
 
     // use prepared statement to prevent from sql injection
-    if ( !query.prepare( statement ) )
+    if ( statement != preparedStatement )
     {
-      const QString msg = query.lastError().text();
-      QgsDebugMsg( QStringLiteral( "SQL:%1\n  Error:%2" ).arg( query.lastQuery(), query.lastError().text() ) );
-      if ( !mSkipFailures )
+      preparedStatement.clear();
+      if ( !query.prepare( statement ) )
       {
-        pushError( msg );
-        return false;
+        const QString msg = query.lastError().text();
+        QgsDebugMsg( QStringLiteral( "SQL:%1\n  Error:%2" ).arg( query.lastQuery(), query.lastError().text() ) );
+        if ( !mSkipFailures )
+        {
+          pushError( msg );
+          return false;
+        }
+        else
+          continue;
       }
-      else
-        continue;
+      preparedStatement = statement;
+    }
+    else
+    {
+      // releases the results of the previous feature
+      query.finish();
     }
 
     for ( int i = 0; i < attrs.count(); ++i )
@@ -100,7 +100,7 @@ bool QgsPdalIndexingTask::runUntwine()
 
   const std::vector<std::string> files = {mFile.toStdString()};
   untwineProcess.start( files, mOutputPath.toStdString(), options );
-  const int lastPercent = 0;
+  int lastPercent = 0;
   while ( true )
   {
     QThread::msleep( 100 );
@@ -115,6 +115,7 @@ bool QgsPdalIndexingTask::runUntwine()
       }
 #endif
       setProgress( percent );
+      lastPercent = percent;
     }
 
     if ( isCanceled() )
@@ -39,6 +39,9 @@
 #include <QThread>
 
 #include <climits>
+#include <cstring>
+#include <limits>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -50,6 +53,8 @@
 #endif
 
 const int PG_DEFAULT_TIMEOUT = 30;
+//! Maximum number of statements prepared by QgsPostgresConn::PQexecCachedPrepared() per connection
+const int PREPARED_STATEMENT_CACHE_SIZE = 100;
 
 QgsPostgresResult::~QgsPostgresResult()
 {
@@ -1626,6 +1631,78 @@ PGresult *QgsPostgresConn::PQexecPrepared( const QString &stmtName, const QStrin
   return res;
 }
 
+PGresult *QgsPostgresConn::PQexecCachedPrepared( const QString &query, const QStringList &params, const QString &originatorClass, const QString &queryOrigin )
+{
+  QMutexLocker locker( &mLock );
+
+  QList<QByteArray> qparam;
+  std::vector<const char *> param( params.size() );
+  qparam.reserve( params.size() );
+  for ( int i = 0; i < params.size(); i++ )
+  {
+    qparam << params[i].toUtf8();
+    param[i] = params[i].isNull() ? nullptr : qparam[i].constData();
+  }
+
+  std::unique_ptr<QgsDatabaseQueryLogWrapper> logWrapper = std::make_unique<QgsDatabaseQueryLogWrapper>( query, mConnInfo, QStringLiteral( "postgres" ), originatorClass, queryOrigin );
+
+  PGresult *res = nullptr;
+  // the statements are dropped when the connection is reset, they are then prepared again
+  for ( int attempt = 0; attempt < 2; ++attempt )
+  {
+    QString stmtName = mPreparedStatements.value( query );
+    if ( stmtName.isEmpty() )
+    {
+      if ( mPreparedStatements.size() >= PREPARED_STATEMENT_CACHE_SIZE )
+      {
+        for ( auto it = mPreparedStatements.constBegin(); it != mPreparedStatements.constEnd(); ++it )
+          ::PQclear( ::PQexec( mConn, QStringLiteral( "DEALLOCATE %1" ).arg( it.value() ).toUtf8() ) );
+        mPreparedStatements.clear();
+      }
+
+      stmtName = QStringLiteral( "qgis_stmt_%1" ).arg( ++mNextPreparedStatementId );
+      res = ::PQprepare( mConn, stmtName.toUtf8(), query.toUtf8(), params.size(), nullptr );
+      if ( ::PQresultStatus( res ) != PGRES_COMMAND_OK )
+        break;
+
+      ::PQclear( res );
+      mPreparedStatements.insert( query, stmtName );
+    }
+
+    res = ::PQexecPrepared( mConn, stmtName.toUtf8(), params.size(), param.data(), nullptr, nullptr, 1 );
+    if ( ::PQresultStatus( res ) == PGRES_TUPLES_OK || ::PQresultStatus( res ) == PGRES_COMMAND_OK )
+      break;
+
+    // the statement may have been invalidated, e.g. by a change of the result type of the query
+    mPreparedStatements.remove( query );
+    const char *sqlState = ::PQresultErrorField( res, PG_DIAG_SQLSTATE );
+    if ( qstrcmp( sqlState, "26000" ) != 0 )
+    {
+      ::PQclear( ::PQexec( mConn, QStringLiteral( "DEALLOCATE %1" ).arg( stmtName ).toUtf8() ) );
+
+      // "cached plan must not change result type", e.g. after a column was added to the table. The statement
+      // is prepared again, unless the error aborted a transaction block
+      if ( qstrcmp( sqlState, "0A000" ) != 0 || ::PQtransactionStatus( mConn ) != PQTRANS_IDLE )
+        break;
+    }
+
+    ::PQclear( res );
+    res = nullptr;
+  }
+
+  const int errorStatus = ::PQresultStatus( res );
+  if ( errorStatus != PGRES_TUPLES_OK && errorStatus != PGRES_COMMAND_OK )
+  {
+    logWrapper->setError( res ? QString::fromUtf8( ::PQresultErrorMessage( res ) ) : PQerrorMessage() );
+  }
+  else
+  {
+    logWrapper->setFetchedRows( ::PQntuples( res ) );
+  }
+
+  return res;
+}
+
 void QgsPostgresConn::PQfinish()
 {
   QMutexLocker locker( &mLock );
@@ -1643,6 +1720,14 @@ int QgsPostgresConn::PQstatus() const
   return ::PQstatus( mConn );
 }
 
+int QgsPostgresConn::PQtransactionStatus() const
+{
+  QMutexLocker locker( &mLock );
+
+  Q_ASSERT( mConn );
+  return ::PQtransactionStatus( mConn );
+}
+
 QString QgsPostgresConn::PQerrorMessage() const
 {
   QMutexLocker locker( &mLock );
@@ -1651,6 +1736,41 @@ QString QgsPostgresConn::PQerrorMessage() const
   return QString::fromUtf8( ::PQerrorMessage( mConn ) );
 }
 
+PGresult *QgsPostgresConn::PQcopyFromStdin( const QString &query, const QByteArray &data, const QString &originatorClass, const QString &queryOrigin )
+{
+  QMutexLocker locker( &mLock );
+
+  QgsDatabaseQueryLogWrapper logWrapper( query, mConnInfo, QStringLiteral( "postgres" ), originatorClass, queryOrigin );
+
+  PGresult *res = ::PQexec( mConn, query.toUtf8() );
+  if ( !res || ::PQresultStatus( res ) != PGRES_COPY_IN )
+  {
+    logWrapper.setError( res ? QString::fromUtf8( ::PQresultErrorMessage( res ) ) : PQerrorMessage() );
+    return res;
+  }
+  ::PQclear( res );
+
+  // errors in the data are reported by the result of the COPY
+  ::PQputCopyData( mConn, data.constData(), data.size() );
+  ::PQputCopyEnd( mConn, nullptr );
+
+  res = nullptr;
+  while ( PGresult *next = ::PQgetResult( mConn ) )
+  {
+    if ( res )
+      ::PQclear( res );
+    res = next;
+  }
+
+  if ( !res || ::PQresultStatus( res ) != PGRES_COMMAND_OK )
+  {
+    const QString error { tr( "Erroneous query: %1 returned %2" ).arg( query, res ? QString::fromUtf8( ::PQresultErrorMessage( res ) ) : PQerrorMessage() ) };
+    logWrapper.setError( error );
+    QgsMessageLog::logMessage( error, tr( "PostGIS" ) );
+  }
+  return res;
+}
+
 int QgsPostgresConn::PQsendQuery( const QString &query )
 {
   QMutexLocker locker( &mLock );
@@ -1783,6 +1903,52 @@ qint64 QgsPostgresConn::getBinaryInt( QgsPostgresResult &queryResult, int row, i
   return oid;
 }
 
+double QgsPostgresConn::getBinaryDouble( QgsPostgresResult &queryResult, int row, int col )
+{
+  QMutexLocker locker( &mLock );
+  const char *p = PQgetvalue( queryResult.result(), row, col );
+  const size_t s = PQgetlength( queryResult.result(), row, col );
+
+  switch ( s )
+  {
+    case 4:
+    {
+      quint32 bits;
+      memcpy( &bits, p, sizeof( bits ) );
+      if ( mSwapEndian )
+        bits = ntohl( bits );
+
+      float value;
+      memcpy( &value, &bits, sizeof( value ) );
+      return value;
+    }
+
+    case 8:
+    {
+      quint32 bits0;
+      quint32 bits1;
+      memcpy( &bits0, p, sizeof( bits0 ) );
+      memcpy( &bits1, p + sizeof( quint32 ), sizeof( bits1 ) );
+      if ( mSwapEndian )
+      {
+        bits0 = ntohl( bits0 );
+        bits1 = ntohl( bits1 );
+      }
+
+      const quint64 bits = ( static_cast< quint64 >( bits0 ) << 32 ) | bits1;
+      double value;
+      memcpy( &value, &bits, sizeof( value ) );
+      return value;
+    }
+
+    default:
+      QgsDebugMsg( QStringLiteral( "unexpected size %1" ).arg( s ) );
+      break;
+  }
+
+  return std::numeric_limits< double >::quiet_NaN();
+}
+
 QString QgsPostgresConn::fieldExpressionForWhereClause( const QgsField &fld, QVariant::Type valueType, QString expr )
 {
   QString out;
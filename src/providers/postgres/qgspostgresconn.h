@@ -22,6 +22,7 @@
 #include <QStringList>
 #include <QVector>
 #include <QMap>
+#include <QHash>
 #include <QMutex>
 
 #include "qgis.h"
@@ -318,9 +319,24 @@ class QgsPostgresConn : public QObject
     void PQfinish();
     QString PQerrorMessage() const;
     int PQstatus() const;
+    int PQtransactionStatus() const;
     PGresult *PQprepare( const QString &stmtName, const QString &query, int nParams, const Oid *paramTypes, const QString &originatorClass = QString(), const QString &queryOrigin = QString() );
     PGresult *PQexecPrepared( const QString &stmtName, const QStringList &params, const QString &originatorClass = QString(), const QString &queryOrigin = QString() );
 
+    /**
+     * Runs a \a query with the parameters \a params through a prepared statement cached
+     * by the connection, so that a query run repeatedly with other parameters is only parsed
+     * and planned once. The statement is prepared the first time the query is run, and its
+     * results are returned in binary format. Thread-safe.
+     */
+    PGresult *PQexecCachedPrepared( const QString &query, const QStringList &params, const QString &originatorClass = QString(), const QString &queryOrigin = QString() );
+
+    /**
+     * Runs a COPY FROM STDIN \a query with the rows of \a data, in the text format of COPY.
+     * Returns the result of the COPY, thread-safe.
+     */
+    PGresult *PQcopyFromStdin( const QString &query, const QByteArray &data, const QString &originatorClass = QString(), const QString &queryOrigin = QString() );
+
     /**
      * PQsendQuery is used for asynchronous queries (with PQgetResult)
      * Thread safety must be ensured by the caller by calling QgsPostgresConn::lock() and QgsPostgresConn::unlock()
@@ -405,6 +421,12 @@ class QgsPostgresConn : public QObject
 
     qint64 getBinaryInt( QgsPostgresResult &queryResult, int row, int col );
 
+    /**
+     * Returns the floating point value at \a row and \a col of a result of a binary cursor,
+     * for columns of type float4 or float8.
+     */
+    double getBinaryDouble( QgsPostgresResult &queryResult, int row, int col );
+
     QString fieldExpressionForWhereClause( const QgsField &fld, QVariant::Type valueType = QVariant::LastType, QString expr = "%1" );
 
     QString fieldExpression( const QgsField &fld, QString expr = "%1" );
@@ -524,6 +546,10 @@ class QgsPostgresConn : public QObject
 
     int mNextCursorId;
 
+    //! Names of the statements prepared by PQexecCachedPrepared(), by query
+    QHash<QString, QString> mPreparedStatements;
+    int mNextPreparedStatementId = 0;
+
     bool mShared; //!< Whether the connection is shared by more providers (must not be if going to be used in worker threads)
 
     bool mTransaction;
@@ -194,6 +194,42 @@ QgsSqlExpressionCompiler::Result QgsPostgresExpressionCompiler::compileNode( con
         result = quotedIdentifier( mGeometryColumn );
         return Complete;
       }
+      else if ( fd->name() == QLatin1String( "to_datetime" ) )
+      {
+        // temporal filters cast date fields with to_datetime(), which is compiled
+        // for date and timestamp columns so the filter can use the server indexes
+        const QList< QgsExpressionNode * > args = n->args()->list();
+        if ( !args.isEmpty() && args.at( 0 )->nodeType() == QgsExpressionNode::ntColumnRef )
+        {
+          bool hasFormat = false;
+          for ( int i = 1; i < args.size(); ++i )
+          {
+            if ( args.at( i )->nodeType() != QgsExpressionNode::ntLiteral
+                 || !static_cast<const QgsExpressionNodeLiteral *>( args.at( i ) )->value().isNull() )
+              hasFormat = true;
+          }
+
+          const QString column = static_cast<const QgsExpressionNodeColumnRef *>( args.at( 0 ) )->name();
+          const int fieldIndex = mFields.lookupField( column );
+          if ( !hasFormat && fieldIndex >= 0 )
+          {
+            switch ( mFields.at( fieldIndex ).type() )
+            {
+              case QVariant::DateTime:
+                result = quotedIdentifier( mFields.at( fieldIndex ).name() );
+                return Complete;
+
+              case QVariant::Date:
+                result = QStringLiteral( "(%1)::timestamp" ).arg( quotedIdentifier( mFields.at( fieldIndex ).name() ) );
+                return Complete;
+
+              default:
+                break;
+            }
+          }
+        }
+        return Fail;
+      }
 #if 0
       /*
        * These methods are tricky
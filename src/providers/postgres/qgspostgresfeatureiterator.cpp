@@ -24,10 +24,30 @@
 #include "qgssettings.h"
 #include "qgsexception.h"
 #include "qgsgeometryengine.h"
+#include "qgsvariantutils.h"
 
 #include <QElapsedTimer>
 #include <QObject>
 
+// bounds of the number of features fetched at once from the cursor
+static const int MINIMUM_FEATURE_QUEUE_SIZE = 2000;
+static const int MAXIMUM_FEATURE_QUEUE_SIZE = 20000;
+
+// Returns TRUE if the values of a field are read in the binary format of the cursor,
+// rather than converted from their text representation
+static bool _readBinaryValue( const QgsField &field )
+{
+  switch ( field.type() )
+  {
+    case QVariant::Int:
+      return field.typeName() == QLatin1String( "int2" ) || field.typeName() == QLatin1String( "int4" );
+    case QVariant::Double:
+      return field.typeName() == QLatin1String( "float8" );
+    default:
+      return false;
+  }
+}
+
 QgsPostgresFeatureIterator::QgsPostgresFeatureIterator( QgsPostgresFeatureSource *source, bool ownSource, const QgsFeatureRequest &request )
   : QgsAbstractFeatureIteratorFromSource<QgsPostgresFeatureSource>( source, ownSource, request )
 {
@@ -74,6 +94,39 @@ QgsPostgresFeatureIterator::QgsPostgresFeatureIterator( QgsPostgresFeatureSource
 
   bool limitAtProvider = ( mRequest.limit() >= 0 );
 
+  // the integer primary key of the requested feature, as a query parameter
+  QString fidParam;
+  if ( request.filterType() == QgsFeatureRequest::FilterFid )
+  {
+    switch ( mSource->mPrimaryKeyType )
+    {
+      case PktInt:
+        fidParam = QString::number( QgsPostgresUtils::fid_to_int32pk( mRequest.filterFid() ) );
+        break;
+
+      case PktInt64:
+      case PktUint64:
+      {
+        const QVariantList pkVals = mSource->mShared->lookupKey( mRequest.filterFid() );
+        if ( !pkVals.isEmpty() && !QgsVariantUtils::isNull( pkVals[0] ) )
+          fidParam = pkVals[0].toString();
+        break;
+      }
+
+      case PktOid:
+      case PktTid:
+      case PktFidMap:
+      case PktUnknown:
+        break;
+    }
+  }
+
+  // requests for a single feature or a few ones are usually repeated with other feature ids or filter
+  // rectangles, e.g. to identify features, so they are run through prepared statements to be only planned once
+  mUsePreparedStatement = mRequest.spatialFilterType() != Qgis::SpatialFilterType::DistanceWithin
+                          && ( !fidParam.isEmpty()
+                               || ( request.filterType() == QgsFeatureRequest::FilterNone && limitAtProvider && mRequest.limit() <= MINIMUM_FEATURE_QUEUE_SIZE ) );
+
   mCursorName = mConn->uniqueCursorName();
   QString whereClause;
 
@@ -82,7 +135,7 @@ QgsPostgresFeatureIterator::QgsPostgresFeatureIterator( QgsPostgresFeatureSource
 
   if ( !mFilterRect.isNull() && !mSource->mGeometryColumn.isNull() )
   {
-    whereClause = whereClauseRect();
+    whereClause = whereClauseRect( mUsePreparedStatement ? &mQueryParams : nullptr );
   }
 
   // prepare spatial filter geometries for optimal speed
@@ -122,7 +175,15 @@ QgsPostgresFeatureIterator::QgsPostgresFeatureIterator( QgsPostgresFeatureSource
     whereClause = QgsPostgresUtils::andWhereClauses( whereClause, '(' + mSource->mSqlWhereClause + ')' );
   }
 
-  if ( request.filterType() == QgsFeatureRequest::FilterFid )
+  if ( mUsePreparedStatement && !fidParam.isEmpty() )
+  {
+    const QgsField pkField = mSource->mFields.at( mSource->mPrimaryKeyAttrs.at( 0 ) );
+    mQueryParams << fidParam;
+    const QString fidWhereClause = QStringLiteral( "%1=$%2" ).arg( mSource->mPrimaryKeyType == PktInt ? QgsPostgresConn::quotedIdentifier( pkField.name() ) : mConn->fieldExpression( pkField ) ).arg( mQueryParams.size() );
+
+    whereClause = QgsPostgresUtils::andWhereClauses( whereClause, fidWhereClause );
+  }
+  else if ( request.filterType() == QgsFeatureRequest::FilterFid )
   {
     QString fidWhereClause = QgsPostgresUtils::whereClause( mRequest.filterFid(), mSource->mFields, mConn, mSource->mPrimaryKeyType, mSource->mPrimaryKeyAttrs, mSource->mShared );
 
@@ -273,6 +334,67 @@ QgsPostgresFeatureIterator::~QgsPostgresFeatureIterator()
 }
 
 
+bool QgsPostgresFeatureIterator::sendFetch()
+{
+  const QString fetch = QStringLiteral( "FETCH FORWARD %1 FROM %2" ).arg( mFeatureQueueSize ).arg( mCursorName );
+  QgsDebugMsgLevel( QStringLiteral( "fetching %1 features." ).arg( mFeatureQueueSize ), 4 );
+
+  mFetchLogWrapper = std::make_unique< QgsDatabaseQueryLogWrapper >( fetch, mSource->mConnInfo, QStringLiteral( "postgres" ), QStringLiteral( "QgsPostgresFeatureIterator" ), QGS_QUERY_LOG_ORIGIN );
+  mPendingFetchSize = mFeatureQueueSize;
+
+  if ( mConn->PQsendQuery( fetch ) == 0 ) // fetch features asynchronously
+  {
+    const QString error { QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ) };
+    QgsMessageLog::logMessage( error, QObject::tr( "PostGIS" ) );
+    mFetchLogWrapper->setError( error );
+    mFetchLogWrapper.reset();
+    return false;
+  }
+
+  mFetchPending = true;
+  return true;
+}
+
+long long QgsPostgresFeatureIterator::readFetchResults( std::vector< std::unique_ptr< QgsPostgresResult > > *results )
+{
+  long long fetchedRows { 0 };
+  if ( !mFetchPending )
+    return fetchedRows;
+
+  for ( ;; )
+  {
+    std::unique_ptr< QgsPostgresResult > queryResult = std::make_unique< QgsPostgresResult >( mConn->PQgetResult() );
+    if ( !queryResult->result() )
+      break;
+
+    if ( queryResult->PQresultStatus() != PGRES_TUPLES_OK )
+    {
+      // discarded results may come from a canceled FETCH
+      if ( results )
+        QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
+      continue;
+    }
+
+    const int rows = queryResult->PQntuples();
+    if ( rows == 0 )
+      continue;
+
+    fetchedRows += rows;
+    if ( results )
+      results->push_back( std::move( queryResult ) );
+  }
+
+  mFetchPending = false;
+  if ( mFetchLogWrapper )
+  {
+    if ( fetchedRows > 0 )
+      mFetchLogWrapper->setFetchedRows( fetchedRows );
+    mFetchLogWrapper.reset();
+  }
+  return fetchedRows;
+}
+
+
 bool QgsPostgresFeatureIterator::fetchFeature( QgsFeature &feature )
 {
   feature.setValid( false );
@@ -282,72 +404,62 @@ bool QgsPostgresFeatureIterator::fetchFeature( QgsFeature &feature )
 
   while ( true )
   {
-    if ( mFeatureQueue.empty() && !mLastFetch )
+    if ( mFeatureQueue.empty() && !mLastFetch && mPreparedResult )
     {
-#if 0 //disabled dynamic queue size
-      QElapsedTimer timer;
-      timer.start();
-#endif
-
-      QString fetch = QStringLiteral( "FETCH FORWARD %1 FROM %2" ).arg( mFeatureQueueSize ).arg( mCursorName );
-      QgsDebugMsgLevel( QStringLiteral( "fetching %1 features." ).arg( mFeatureQueueSize ), 4 );
-
+      // the prepared statement returned all the features at once
       lock();
-
-      QgsDatabaseQueryLogWrapper logWrapper { fetch, mSource->mConnInfo, QStringLiteral( "postgres" ), QStringLiteral( "QgsPostgresFeatureIterator" ), QGS_QUERY_LOG_ORIGIN };
-
-      if ( mConn->PQsendQuery( fetch ) == 0 ) // fetch features asynchronously
+      const int rows = mPreparedResult->PQntuples();
+      for ( int row = 0; row < rows; row++ )
       {
-        const QString error { QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ) };
-        QgsMessageLog::logMessage( error, QObject::tr( "PostGIS" ) );
-        logWrapper.setError( error );
+        mFeatureQueue.enqueue( QgsFeature() );
+        getFeature( *mPreparedResult, row, mFeatureQueue.back() );
       }
+      unlock();
+      mLastFetch = true;
+    }
+    else if ( mFeatureQueue.empty() && !mLastFetch )
+    {
+      lock();
 
-      QgsPostgresResult queryResult;
-      long long fetchedRows { 0 };
-      for ( ;; )
-      {
-        queryResult = mConn->PQgetResult();
-        if ( !queryResult.result() )
-          break;
+      if ( !mFetchPending )
+        sendFetch();
 
-        if ( queryResult.PQresultStatus() != PGRES_TUPLES_OK )
-        {
-          QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
-          break;
-        }
+      QElapsedTimer timer;
+      timer.start();
 
-        int rows = queryResult.PQntuples();
-        if ( rows == 0 )
-          continue;
-        else
-          fetchedRows += rows;
+      const int fetchSize = mPendingFetchSize;
+      std::vector< std::unique_ptr< QgsPostgresResult > > results;
+      const long long fetchedRows = readFetchResults( &results );
+      const qint64 waitTime = timer.restart();
 
-        mLastFetch = rows < mFeatureQueueSize;
+      mLastFetch = fetchedRows < fetchSize;
 
+      // let the server prepare the next features while the fetched ones are decoded
+      if ( mPipelineFetches && !mLastFetch )
+        sendFetch();
+
+      for ( const std::unique_ptr< QgsPostgresResult > &queryResult : results )
+      {
+        const int rows = queryResult->PQntuples();
         for ( int row = 0; row < rows; row++ )
         {
           mFeatureQueue.enqueue( QgsFeature() );
-          getFeature( queryResult, row, mFeatureQueue.back() );
+          getFeature( *queryResult, row, mFeatureQueue.back() );
         } // for each row in queue
       }
       unlock();
 
-      if ( fetchedRows > 0 )
+      // fetch more features at once when waiting for the server takes longer than decoding them,
+      // and fewer when decoding them delays the first features of the queue too much
+      const qint64 decodeTime = timer.elapsed();
+      if ( waitTime > decodeTime && mFeatureQueueSize < MAXIMUM_FEATURE_QUEUE_SIZE )
       {
-        logWrapper.setFetchedRows( fetchedRows );
+        mFeatureQueueSize = std::min( 2 * mFeatureQueueSize, MAXIMUM_FEATURE_QUEUE_SIZE );
       }
-
-#if 0 //disabled dynamic queue size
-      if ( timer.elapsed() > 500 && mFeatureQueueSize > 1 )
+      else if ( decodeTime > 500 && mFeatureQueueSize > MINIMUM_FEATURE_QUEUE_SIZE )
       {
-        mFeatureQueueSize /= 2;
+        mFeatureQueueSize = std::max( mFeatureQueueSize / 2, MINIMUM_FEATURE_QUEUE_SIZE );
       }
-      else if ( timer.elapsed() < 50 && mFeatureQueueSize < 10000 )
-      {
-        mFeatureQueueSize *= 2;
-      }
-#endif
     }
 
     if ( mFeatureQueue.empty() )
@@ -436,8 +548,10 @@ bool QgsPostgresFeatureIterator::rewind()
     return false;
 
   // move cursor to first record
+  readFetchResults( nullptr );
 
-  mConn->LoggedPQexecNR( "QgsPostgresFeatureIterator", QStringLiteral( "move absolute 0 in %1" ).arg( mCursorName ) );
+  if ( !mUsePreparedStatement )
+    mConn->LoggedPQexecNR( "QgsPostgresFeatureIterator", QStringLiteral( "move absolute 0 in %1" ).arg( mCursorName ) );
   mFeatureQueue.clear();
   mFetched = 0;
   mLastFetch = false;
@@ -450,7 +564,18 @@ bool QgsPostgresFeatureIterator::close()
   if ( !mConn )
     return false;
 
-  mConn->closeCursor( mCursorName );
+  // don't wait for the rows of a pipelined FETCH when the iteration is stopped early
+  const bool fetchCanceled = mFetchPending && !mIsTransactionConnection && mConn->PQCancel();
+  readFetchResults( nullptr );
+  if ( !mUsePreparedStatement )
+  {
+    mConn->closeCursor( mCursorName );
+
+    // canceling aborts the read only transaction of the cursor
+    if ( fetchCanceled && mConn->PQtransactionStatus() == PQTRANS_INERROR )
+      mConn->LoggedPQexecNR( "QgsPostgresFeatureIterator", QStringLiteral( "ROLLBACK" ) );
+  }
+  mPreparedResult.reset();
 
   if ( !mIsTransactionConnection )
   {
@@ -471,7 +596,7 @@ bool QgsPostgresFeatureIterator::close()
 
 ///////////////
 
-QString QgsPostgresFeatureIterator::whereClauseRect()
+QString QgsPostgresFeatureIterator::whereClauseRect( QStringList *params )
 {
   QgsRectangle rect = mFilterRect;
   if ( mSource->mSpatialColType == SctGeography )
@@ -493,6 +618,17 @@ QString QgsPostgresFeatureIterator::whereClauseRect()
            .arg( rect.asWktCoordinates(),
                  bboxSrid );
   }
+  else if ( params )
+  {
+    const int first = params->size() + 1;
+    qBox = QStringLiteral( "st_makeenvelope($%1::float8,$%2::float8,$%3::float8,$%4::float8,%5)" )
+           .arg( first ).arg( first + 1 ).arg( first + 2 ).arg( first + 3 )
+           .arg( bboxSrid );
+    *params << qgsDoubleToString( rect.xMinimum() )
+            << qgsDoubleToString( rect.yMinimum() )
+            << qgsDoubleToString( rect.xMaximum() )
+            << qgsDoubleToString( rect.yMaximum() );
+  }
   else
   {
     qBox = QStringLiteral( "st_makeenvelope(%1,%2,%3,%4,%5)" )
@@ -718,9 +854,10 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
                mConn->majorVersion() > 2 )
           {
             // For postgis >= 2.2 Use ST_RemoveRepeatedPoints instead
-            // Do it only if threshold is <= 1 pixel to avoid holes in adjacent polygons
-            // We should perhaps use it always for Linestrings, even if threshold > 1 ?
-            if ( mRequest.simplifyMethod().threshold() <= 1.0f )
+            // Do it only if threshold is <= 1 pixel to avoid holes in adjacent polygons,
+            // lines have no such issue and are always simplified that way
+            if ( mRequest.simplifyMethod().threshold() <= 1.0f ||
+                 QgsWkbTypes::geometryType( usedGeomType ) == QgsWkbTypes::LineGeometry )
             {
               simplifyPostgisMethod = QStringLiteral( "st_removerepeatedpoints" );
               postSimplification = true; // Ask to apply a post-filtering simplification
@@ -807,7 +944,25 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
     if ( mSource->mPrimaryKeyAttrs.contains( idx ) )
       continue;
 
-    query += delim + mConn->fieldExpression( mSource->mFields.at( idx ) );
+    const QgsField field = mSource->mFields.at( idx );
+    if ( _readBinaryValue( field ) )
+      query += delim + QgsPostgresConn::quotedIdentifier( field.name() );
+    else
+      query += delim + mConn->fieldExpression( field );
+  }
+
+  // decoding geometry attributes may query the connection for their CRS, so it must then
+  // not wait for the results of the next FETCH. Limited requests are not pipelined either,
+  // the next FETCH would mostly transfer rows beyond the limit
+  mPipelineFetches = !mIsTransactionConnection && mRequest.limit() < 0;
+  for ( int idx : constAllAttributesList )
+  {
+    const QgsField &field = mSource->mFields.at( idx );
+    if ( field.type() == QVariant::UserType || field.subType() == QVariant::UserType )
+    {
+      mPipelineFetches = false;
+      break;
+    }
   }
 
   query += " FROM " + mSource->mQuery;
@@ -821,7 +976,19 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
   if ( !orderBy.isEmpty() )
     query += QStringLiteral( " ORDER BY %1 " ).arg( orderBy );
 
-  if ( !mConn->openCursor( mCursorName, query ) )
+  if ( mUsePreparedStatement )
+  {
+    mPreparedResult = std::make_unique< QgsPostgresResult >( mConn->PQexecCachedPrepared( query, mQueryParams, QStringLiteral( "QgsPostgresFeatureIterator" ), QGS_QUERY_LOG_ORIGIN ) );
+    if ( mPreparedResult->PQresultStatus() != PGRES_TUPLES_OK )
+    {
+      QgsMessageLog::logMessage( QObject::tr( "Query failed: %1\nDatabase error: %2" ).arg( query, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
+      mPreparedResult.reset();
+      if ( closeOnFail )
+        close();
+      return false;
+    }
+  }
+  else if ( !mConn->openCursor( mCursorName, query ) )
   {
     // reloading the fields might help next time around
     // TODO how to cleanly force reload of fields?  P->loadFields();
@@ -1048,6 +1215,27 @@ void QgsPostgresFeatureIterator::getFeatureAttribute( int idx, QgsPostgresResult
       }
       break;
     }
+    case QVariant::Int:
+    case QVariant::Double:
+    {
+      if ( !_readBinaryValue( fld ) )
+      {
+        v = QgsPostgresProvider::convertValue( fld.type(), fld.subType(), queryResult.PQgetvalue( row, col ), fld.typeName(), mConn );
+      }
+      else if ( ::PQgetisnull( queryResult.result(), row, col ) )
+      {
+        v = QVariant( fld.type() );
+      }
+      else if ( fld.type() == QVariant::Int )
+      {
+        v = static_cast< int >( mConn->getBinaryInt( queryResult, row, col ) );
+      }
+      else
+      {
+        v = mConn->getBinaryDouble( queryResult, row, col );
+      }
+      break;
+    }
     default:
     {
       v = QgsPostgresProvider::convertValue( fld.type(), fld.subType(), queryResult.PQgetvalue( row, col ), fld.typeName(), mConn );
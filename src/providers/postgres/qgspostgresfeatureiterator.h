@@ -18,6 +18,8 @@
 #include "qgsfeatureiterator.h"
 
 #include <QQueue>
+#include <memory>
+#include <vector>
 
 #include "qgspostgresprovider.h"
 #include "qgscoordinatetransform.h"
@@ -25,6 +27,7 @@
 class QgsPostgresProvider;
 class QgsPostgresResult;
 class QgsPostgresTransaction;
+class QgsDatabaseQueryLogWrapper;
 
 
 class QgsPostgresFeatureSource final: public QgsAbstractFeatureSource
@@ -92,11 +95,27 @@ class QgsPostgresFeatureIterator final: public QgsAbstractFeatureIteratorFromSou
     QgsPostgresConn *mConn = nullptr;
 
 
-    QString whereClauseRect();
+    /**
+     * Returns the where clause selecting the features in the filter rectangle. If \a params is set,
+     * the coordinates of the rectangle are appended to it and the clause refers to them as parameters.
+     */
+    QString whereClauseRect( QStringList *params = nullptr );
     bool getFeature( QgsPostgresResult &queryResult, int row, QgsFeature &feature );
     void getFeatureAttribute( int idx, QgsPostgresResult &queryResult, int row, int &col, QgsFeature &feature );
     bool declareCursor( const QString &whereClause, long limit = -1, bool closeOnFail = true, const QString &orderBy = QString() );
 
+    /**
+     * Sends a FETCH of the next features of the cursor, without waiting for its results.
+     * Returns FALSE if the query could not be sent.
+     */
+    bool sendFetch();
+
+    /**
+     * Waits for the results of the pending FETCH and appends them to \a results, or discards
+     * them if \a results is NULLPTR. Returns the number of fetched rows.
+     */
+    long long readFetchResults( std::vector< std::unique_ptr< QgsPostgresResult > > *results );
+
     QString mCursorName;
 
     /**
@@ -111,6 +130,33 @@ class QgsPostgresFeatureIterator final: public QgsAbstractFeatureIteratorFromSou
     //! Number of retrieved features
     int mFetched = 0;
 
+    //! TRUE if a FETCH was sent and its results were not read yet
+    bool mFetchPending = false;
+
+    //! Number of features requested by the last FETCH
+    int mPendingFetchSize = 0;
+
+    //! Query log entry of the pending FETCH
+    std::unique_ptr< QgsDatabaseQueryLogWrapper > mFetchLogWrapper;
+
+    /**
+     * TRUE if the next FETCH can be sent while the features of the current one are decoded,
+     * i.e. if the connection is not shared and decoding the attributes does not query it.
+     */
+    bool mPipelineFetches = false;
+
+    /**
+     * TRUE if the query is run through a prepared statement cached by the connection instead of
+     * a cursor, i.e. for small requests which are repeated with other feature ids or filter rectangles.
+     */
+    bool mUsePreparedStatement = false;
+
+    //! Parameters of the query run through a prepared statement
+    QStringList mQueryParams;
+
+    //! Results of the query run through a prepared statement
+    std::unique_ptr< QgsPostgresResult > mPreparedResult;
+
     //! Sets to true, if geometry is in the requested columns
     bool mFetchGeometry = false;
 
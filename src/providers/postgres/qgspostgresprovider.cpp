@@ -33,6 +33,7 @@
 #include "qgspostgresconnpool.h"
 #include "qgspostgresdataitems.h"
 #include "qgspostgresfeatureiterator.h"
+#include "qgspostgresexpressioncompiler.h"
 #include "qgspostgrestransaction.h"
 #include "qgspostgreslistener.h"
 #include "qgspostgresprojectstorage.h"
@@ -52,6 +53,8 @@
 #include "qgspostgresprovidermetadatautils.h"
 #include <QRegularExpression>
 
+#include <nlohmann/json.hpp>
+
 const QString QgsPostgresProvider::POSTGRES_KEY = QStringLiteral( "postgres" );
 const QString QgsPostgresProvider::POSTGRES_DESCRIPTION = QStringLiteral( "PostgreSQL/PostGIS data provider" );
 
@@ -327,6 +330,26 @@ QgsPostgresConn *QgsPostgresProvider::connectionRO() const
   return mTransaction ? mTransaction->connection() : mConnectionRO;
 }
 
+void QgsPostgresProvider::movedToMainThread()
+{
+  if ( !mConnectionRO )
+    return;
+
+  // the shared connection is returned when the provider was already created on the main thread
+  QgsPostgresConn *conn = QgsPostgresConn::connectDb( mUri, true );
+  if ( !conn )
+    return;
+
+  if ( conn != mConnectionRO )
+  {
+#ifndef QGISDEBUG
+    conn->PQexecNR( QStringLiteral( "set client_min_messages to error" ) );
+#endif
+    std::swap( conn, mConnectionRO );
+  }
+  conn->unref();
+}
+
 void QgsPostgresProvider::setListening( bool isListening )
 {
   if ( !mValid )
@@ -2045,6 +2068,91 @@ QVariant QgsPostgresProvider::minimumValue( int index ) const
   }
 }
 
+QVariant QgsPostgresProvider::aggregate( QgsAggregateCalculator::Aggregate aggregate, int index, const QgsAggregateCalculator::AggregateParameters &parameters,
+    QgsExpressionContext *context, bool &ok, QgsFeatureIds *fids ) const
+{
+  ok = false;
+
+  // feature id filters can't be passed to the database efficiently
+  if ( fids || index < 0 || index >= mAttributeFields.count() )
+    return QVariant();
+
+  // only numeric aggregates are calculated by the database, their results match the ones of QgsStatisticalSummary
+  const QgsField fld = field( index );
+  if ( !fld.isNumeric() )
+    return QVariant();
+
+  const QString column = quotedIdentifier( fld.name() );
+  QString aggregateSql;
+  switch ( aggregate )
+  {
+    case QgsAggregateCalculator::Count:
+      aggregateSql = QStringLiteral( "count(%1)" ).arg( column );
+      break;
+    case QgsAggregateCalculator::CountDistinct:
+      aggregateSql = QStringLiteral( "count(DISTINCT %1)" ).arg( column );
+      break;
+    case QgsAggregateCalculator::CountMissing:
+      aggregateSql = QStringLiteral( "count(*)-count(%1)" ).arg( column );
+      break;
+    case QgsAggregateCalculator::Min:
+      aggregateSql = QStringLiteral( "min(%1)" ).arg( column );
+      break;
+    case QgsAggregateCalculator::Max:
+      aggregateSql = QStringLiteral( "max(%1)" ).arg( column );
+      break;
+    case QgsAggregateCalculator::Sum:
+      aggregateSql = QStringLiteral( "coalesce(sum(%1),0)" ).arg( column );
+      break;
+    case QgsAggregateCalculator::Mean:
+      aggregateSql = QStringLiteral( "avg(%1)" ).arg( column );
+      break;
+    case QgsAggregateCalculator::Median:
+      aggregateSql = QStringLiteral( "percentile_cont(0.5) WITHIN GROUP (ORDER BY %1)" ).arg( column );
+      break;
+    case QgsAggregateCalculator::StDev:
+      aggregateSql = QStringLiteral( "stddev_pop(%1)" ).arg( column );
+      break;
+    case QgsAggregateCalculator::Range:
+      aggregateSql = QStringLiteral( "max(%1)-min(%1)" ).arg( column );
+      break;
+
+    default:
+      return QVariant();
+  }
+
+  QString where = filterWhereClause();
+  if ( !parameters.filter.isEmpty() )
+  {
+    QgsExpression filterExpression( parameters.filter );
+    if ( context )
+      filterExpression.prepare( context );
+
+    QgsPostgresFeatureSource source( this );
+    QgsPostgresExpressionCompiler compiler( &source );
+    if ( compiler.compile( &filterExpression ) != QgsSqlExpressionCompiler::Complete )
+      return QVariant();
+
+    where += ( where.isEmpty() ? QStringLiteral( " WHERE " ) : QStringLiteral( " AND " ) ) + '(' + compiler.result() + ')';
+  }
+
+  // the aggregate is cast to a double precision value, as QgsStatisticalSummary returns doubles
+  const QString sql = QStringLiteral( "SELECT (%1)::float8 FROM %2%3" ).arg( aggregateSql, mQuery, where );
+
+  QgsPostgresResult res( connectionRO()->LoggedPQexec( "QgsPostgresProvider", sql ) );
+  if ( res.PQresultStatus() != PGRES_TUPLES_OK || res.PQntuples() != 1 )
+  {
+    pushError( res.PQresultErrorMessage() );
+    return QVariant();
+  }
+
+  ok = true;
+  if ( res.PQgetisnull( 0, 0 ) )
+    return QVariant();
+
+  return res.PQgetvalue( 0, 0 ).toDouble();
+}
+
 // Returns the list of unique values of an attribute
 QSet<QVariant> QgsPostgresProvider::uniqueValues( int index, int limit ) const
 {
@@ -2399,6 +2507,149 @@ QString QgsPostgresProvider::paramValue( const QString &fieldValue, const QStrin
   return fieldValue;
 }
 
+QString QgsPostgresProvider::insertValue( QgsFeature &feature, int attrIdx, const QString &defaultValue ) const
+{
+  const QVariant value = attrIdx < feature.attributeCount() ? feature.attribute( attrIdx ) : QVariant( QVariant::Int );
+
+  QString v;
+  if ( QgsVariantUtils::isNull( value ) )
+  {
+    QgsField fld = field( attrIdx );
+    v = paramValue( defaultValue, defaultValue );
+    feature.setAttribute( attrIdx, convertValue( fld.type(), fld.subType(), v, fld.typeName() ) );
+  }
+  else
+  {
+    // the conversion functions expects the list as a string, so convert it
+    if ( value.type() == QVariant::StringList )
+    {
+      QStringList list_vals = value.toStringList();
+      // all strings need to be double quoted to allow special postgres
+      // array characters such as {, or whitespace in the string
+      // but we need to escape all double quotes and backslashes
+      list_vals.replaceInStrings( "\\", "\\\\" );
+      list_vals.replaceInStrings( "\"", "\\\"" );
+      v = QStringLiteral( "{\"" ) + value.toStringList().join( QLatin1String( "\",\"" ) ) + QStringLiteral( "\"}" );
+    }
+    else if ( value.type() == QVariant::List )
+    {
+      v = "{" + value.toStringList().join( "," ) + "}";
+    }
+    else
+    {
+      v = paramValue( value.toString(), defaultValue );
+    }
+
+    if ( v != value.toString() )
+    {
+      QgsField fld = field( attrIdx );
+      feature.setAttribute( attrIdx, convertValue( fld.type(), fld.subType(), v, fld.typeName() ) );
+    }
+  }
+
+  return v;
+}
+
+// Returns a value in the text format of COPY
+static QByteArray _copyValue( const QString &value )
+{
+  if ( value.isNull() )
+    return QByteArrayLiteral( "\\N" );
+
+  QByteArray copyValue = value.toUtf8();
+  copyValue.replace( '\\', "\\\\" );
+  copyValue.replace( '\t', "\\t" );
+  copyValue.replace( '\n', "\\n" );
+  copyValue.replace( '\r', "\\r" );
+  return copyValue;
+}
+
+// Returns the text of a json value, as quoted by QgsPostgresConn::quotedJsonValue()
+static QString _copyJsonValue( const QVariant &value )
+{
+  // where json is a string literal just use it rather than dump
+  if ( value.type() == QVariant::String )
+  {
+    const QString valueStr = value.toString();
+    if ( valueStr.size() > 1 && valueStr.startsWith( '\"' ) && valueStr.endsWith( '\"' ) )
+      return valueStr;
+  }
+  return QString::fromStdString( QgsJsonUtils::jsonFromVariant( value ).dump() );
+}
+
+void QgsPostgresProvider::addFeaturesWithCopy( QgsPostgresConn *conn, QgsFeatureList &flist, const QList<int> &fieldIds )
+{
+  QString columns;
+  QString delim;
+  if ( !mGeometryColumn.isNull() )
+  {
+    columns += quotedIdentifier( mGeometryColumn );
+    delim = ',';
+  }
+
+  QStringList typeNames;
+  for ( int idx : fieldIds )
+  {
+    columns += delim + quotedIdentifier( field( idx ).name() );
+    delim = ',';
+    typeNames << field( idx ).typeName();
+  }
+
+  const QByteArray sridPrefix = QStringLiteral( "SRID=%1;" ).arg( mRequestedSrid.isEmpty() ? mDetectedSrid : mRequestedSrid ).toUtf8();
+  const bool forceMulti = QgsWkbTypes::isMultiType( wkbType() );
+
+  QByteArray data;
+  for ( QgsFeature &feature : flist )
+  {
+    QByteArray row;
+    if ( !mGeometryColumn.isNull() )
+    {
+      const QgsGeometry geom = feature.geometry();
+      if ( geom.isNull() )
+      {
+        row += QByteArrayLiteral( "\\N" );
+      }
+      else
+      {
+        QgsGeometry convertedGeom( convertToProviderType( geom ) );
+        if ( convertedGeom.isNull() )
+          convertedGeom = geom;
+        if ( forceMulti && !convertedGeom.isMultipart() )
+          convertedGeom.convertToMultiType();
+
+        // hex WKB prefixed by its SRID, as read by the geometry input function
+        row += sridPrefix + convertedGeom.asWkb().toHex();
+      }
+      row += '\t';
+    }
+
+    for ( int i = 0; i < fieldIds.size(); ++i )
+    {
+      // the values are encoded as in the insert statements, the default values are never used
+      const int idx = fieldIds.at( i );
+      const QVariant value = feature.attributes().value( idx, QVariant( QVariant::Int ) );
+      const QString &typeName = typeNames.at( i );
+      if ( QgsVariantUtils::isNull( value ) )
+        row += _copyValue( QString() );
+      else if ( typeName == QLatin1String( "json" ) || typeName == QLatin1String( "jsonb" ) )
+        row += _copyValue( _copyJsonValue( value ) );
+      else if ( typeName == QLatin1String( "bytea" ) )
+        row += _copyValue( QStringLiteral( "\\x" ) + QString::fromLatin1( value.toByteArray().toHex() ) );
+      else
+        row += _copyValue( insertValue( feature, idx, QString() ) );
+      row += '\t';
+    }
+
+    row[ row.size() - 1 ] = '\n';
+    data += row;
+  }
+
+  const QString copy = QStringLiteral( "COPY %1(%2) FROM STDIN" ).arg( mQuery, columns );
+  QgsPostgresResult result( conn->PQcopyFromStdin( copy, data, QStringLiteral( "QgsPostgresProvider" ), QGS_QUERY_LOG_ORIGIN ) );
+  if ( result.PQresultStatus() != PGRES_COMMAND_OK )
+    throw PGException( result );
+}
+
 
 /* private */
 bool QgsPostgresProvider::getTopoLayerInfo()
@@ -2544,6 +2795,16 @@ bool QgsPostgresProvider::addFeatures( QgsFeatureList &flist, Flags flags )
     QStringList defaultValues;
     QList<int> fieldId;
 
+    // attributes of the columns inserted by COPY, whether set by parameters or by constants. The
+    // constant columns set to their default value are left to the default of the table
+    QList<int> insertedFieldId;
+
+    // features inserted without returning their keys are streamed with COPY, unless some
+    // column values are converted by SQL functions
+    const QString srid = mRequestedSrid.isEmpty() ? mDetectedSrid : mRequestedSrid;
+    bool useCopy = ( flags & QgsFeatureSink::FastInsert ) &&
+                   ( mGeometryColumn.isNull() || ( mSpatialColType == SctGeometry && !srid.isEmpty() ) );
+
     if ( !mGeometryColumn.isNull() )
     {
       insert += quotedIdentifier( mGeometryColumn );
@@ -2592,6 +2853,7 @@ bool QgsPostgresProvider::addFeatures( QgsFeatureList &flist, Flags flags )
           values += delim + QStringLiteral( "$%1" ).arg( defaultValues.size() + offset );
           delim = ',';
           fieldId << idx;
+          insertedFieldId << idx;
           defaultValues << defaultValueClause( idx );
         }
       }
@@ -2642,7 +2904,12 @@ bool QgsPostgresProvider::addFeatures( QgsFeatureList &flist, Flags flags )
       if ( mIdentityFields[idx] == 'a' )
         overrideIdentity = true;
 
+      if ( fieldTypeName == QLatin1String( "geometry" ) || fieldTypeName == QLatin1String( "geography" ) )
+        useCopy = false;
+
       QString defVal = defaultValueClause( idx );
+      if ( i < flist.size() || !qgsVariantEqual( v, defVal ) || defVal.isNull() )
+        insertedFieldId << idx;
 
       if ( i == flist.size() )
       {
@@ -2736,6 +3003,39 @@ bool QgsPostgresProvider::addFeatures( QgsFeatureList &flist, Flags flags )
       }
     }
 
+    // COPY can't evaluate the default values of the parameters, which are set for null values
+    // or when the value is the default value clause itself
+    for ( int i = 0; useCopy && i < fieldId.size(); ++i )
+    {
+      const QString &defaultValue = defaultValues.at( i );
+      if ( defaultValue.isNull() )
+        continue;
+
+      for ( const QgsFeature &feature : std::as_const( flist ) )
+      {
+        const QVariant value = feature.attributes().value( fieldId.at( i ), QVariant( QVariant::Int ) );
+        if ( QgsVariantUtils::isNull( value ) || value.toString() == defaultValue )
+        {
+          useCopy = false;
+          break;
+        }
+      }
+    }
+
+    // rows can't be streamed into identity columns generated always
+    if ( useCopy && !overrideIdentity && ( !mGeometryColumn.isNull() || !insertedFieldId.isEmpty() ) )
+    {
+      addFeaturesWithCopy( conn, flist, insertedFieldId );
+
+      returnvalue &= conn->commit();
+      if ( mTransaction )
+        mTransaction->dirtyLastSavePoint();
+
+      mShared->addFeaturesCounted( flist.size() );
+      conn->unlock();
+      return returnvalue;
+    }
+
     QgsDebugMsgLevel( QStringLiteral( "prepare addfeatures: %1" ).arg( insert ), 2 );
     QgsPostgresResult stmt( conn->PQprepare( QStringLiteral( "addfeatures" ), insert, fieldId.size() + offset - 1, nullptr, QStringLiteral( "QgsPostgresProvider" ), QGS_QUERY_LOG_ORIGIN ) );
 
@@ -2744,8 +3044,6 @@ bool QgsPostgresProvider::addFeatures( QgsFeatureList &flist, Flags flags )
 
     for ( QgsFeatureList::iterator features = flist.begin(); features != flist.end(); ++features )
     {
-      QgsAttributes attrs = features->attributes();
-
       QStringList params;
       if ( !mGeometryColumn.isNull() )
       {
@@ -2755,46 +3053,7 @@ bool QgsPostgresProvider::addFeatures( QgsFeatureList &flist, Flags flags )
       params.reserve( fieldId.size() );
       for ( int i = 0; i < fieldId.size(); i++ )
       {
-        int attrIdx = fieldId[i];
-        QVariant value = attrIdx < attrs.length() ? attrs.at( attrIdx ) : QVariant( QVariant::Int );
-
-        QString v;
-        if ( QgsVariantUtils::isNull( value ) )
-        {
-          QgsField fld = field( attrIdx );
-          v = paramValue( defaultValues[ i ], defaultValues[ i ] );
-          features->setAttribute( attrIdx, convertValue( fld.type(), fld.subType(), v, fld.typeName() ) );
-        }
-        else
-        {
-          // the conversion functions expects the list as a string, so convert it
-          if ( value.type() == QVariant::StringList )
-          {
-            QStringList list_vals = value.toStringList();
-            // all strings need to be double quoted to allow special postgres
-            // array characters such as {, or whitespace in the string
-            // but we need to escape all double quotes and backslashes
-            list_vals.replaceInStrings( "\\", "\\\\" );
-            list_vals.replaceInStrings( "\"", "\\\"" );
-            v = QStringLiteral( "{\"" ) + value.toStringList().join( QLatin1String( "\",\"" ) ) + QStringLiteral( "\"}" );
-          }
-          else if ( value.type() == QVariant::List )
-          {
-            v = "{" + value.toStringList().join( "," ) + "}";
-          }
-          else
-          {
-            v = paramValue( value.toString(), defaultValues[ i ] );
-          }
-
-          if ( v != value.toString() )
-          {
-            QgsField fld = field( attrIdx );
-            features->setAttribute( attrIdx, convertValue( fld.type(), fld.subType(), v, fld.typeName() ) );
-          }
-        }
-
-        params << v;
+        params << insertValue( *features, fieldId[i], defaultValues[ i ] );
       }
 
       QgsPostgresResult result( conn->PQexecPrepared( QStringLiteral( "addfeatures" ), params, QStringLiteral( "QgsPostgresProvider" ), QGS_QUERY_LOG_ORIGIN ) );
@@ -6181,5 +6440,5 @@ bool QgsPostgresProviderMetadata::saveLayerMetadata( const QString &uri, const Q
 
 QgsProviderMetadata::ProviderCapabilities QgsPostgresProviderMetadata::providerCapabilities() const
 {
-  return QgsProviderMetadata::ProviderCapability::SaveLayerMetadata;
+  return QgsProviderMetadata::ProviderCapability::SaveLayerMetadata | QgsProviderMetadata::ProviderCapability::ParallelCreateProvider;
 }
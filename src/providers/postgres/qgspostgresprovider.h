@@ -164,6 +164,8 @@ class QgsPostgresProvider final: public QgsVectorDataProvider
     QVariant minimumValue( int index ) const override;
     QVariant maximumValue( int index ) const override;
     QSet< QVariant > uniqueValues( int index, int limit = -1 ) const override;
+    QVariant aggregate( QgsAggregateCalculator::Aggregate aggregate, int index, const QgsAggregateCalculator::AggregateParameters &parameters,
+                        QgsExpressionContext *context, bool &ok, QgsFeatureIds *fids = nullptr ) const override;
     QStringList uniqueStringsMatching( int index, const QString &substring, int limit = -1,
                                        QgsFeedback *feedback = nullptr ) const override;
     void enumValues( int index, QStringList &enumList ) const override;
@@ -245,6 +247,12 @@ class QgsPostgresProvider final: public QgsVectorDataProvider
      */
     void setListening( bool isListening ) override;
 
+    /**
+     * Replaces the read-only connection opened on the worker thread the provider was created on,
+     * which could not be shared, by the connection shared by the providers of the same database.
+     */
+    void movedToMainThread() override;
+
     Qgis::VectorLayerTypeFlags vectorLayerTypeFlags() const override;
 
     void handlePostCloneOperations( QgsVectorDataProvider *source ) override;
@@ -482,6 +490,22 @@ class QgsPostgresProvider final: public QgsVectorDataProvider
 
     QString paramValue( const QString &fieldvalue, const QString &defaultValue ) const;
 
+    /**
+     * Returns the value of the attribute \a attrIdx of a \a feature to insert, evaluating the
+     * \a defaultValue for null values, and updates the feature attribute to the inserted value.
+     */
+    QString insertValue( QgsFeature &feature, int attrIdx, const QString &defaultValue ) const;
+
+    /**
+     * Inserts the features of \a flist through a COPY on \a conn, with the geometry and
+     * the attributes \a fieldIds of the features.
+     *
+     * The values are encoded according to the type of their column. The default values of
+     * the columns are not evaluated, so null values are inserted as NULL.
+     * \throws PGException if the features could not be inserted
+     */
+    void addFeaturesWithCopy( QgsPostgresConn *conn, QgsFeatureList &flist, const QList<int> &fieldIds );
+
     QgsPostgresConn *mConnectionRO = nullptr ; //!< Read-only database connection (initially)
     QgsPostgresConn *mConnectionRW = nullptr ; //!< Read-write database connection (on update)
 
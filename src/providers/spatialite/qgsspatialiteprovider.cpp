@@ -4169,6 +4169,7 @@ bool QgsSpatiaLiteProvider::addFeatures( QgsFeatureList &flist, Flags flags )
       baseSeparator = ',';
     }
 
+    QString preparedSql;
     for ( QgsFeatureList::iterator feature = flist.begin(); feature != flist.end(); ++feature )
     {
 
@@ -4209,8 +4210,21 @@ bool QgsSpatiaLiteProvider::addFeatures( QgsFeatureList &flist, Flags flags )
       sql += values;
       sql += ')';
 
-      // SQLite prepared statement
-      ret = sqlite3_prepare_v2( sqliteHandle( ), sql.toUtf8().constData(), -1, &stmt, nullptr );
+      // SQLite prepared statement, reused while the features insert the same columns
+      if ( !stmt || sql != preparedSql )
+      {
+        sqlite3_finalize( stmt );
+        stmt = nullptr;
+        ret = sqlite3_prepare_v2( sqliteHandle( ), sql.toUtf8().constData(), -1, &stmt, nullptr );
+        preparedSql = sql;
+      }
+      else
+      {
+        // unbound parameters of the previous feature must be NULL again
+        sqlite3_reset( stmt );
+        sqlite3_clear_bindings( stmt );
+        ret = SQLITE_OK;
+      }
       if ( ret == SQLITE_OK )
       {
 
@@ -4332,8 +4346,6 @@ bool QgsSpatiaLiteProvider::addFeatures( QgsFeatureList &flist, Flags flags )
         QgsDatabaseQueryLogWrapper logWrapper( QString( expandedSql ), uri( ).uri( false ), QStringLiteral( "spatialite" ), QStringLiteral( "QgsSpatiaLiteProvider" ), QStringLiteral( "addFeatures" ) );
         sqlite3_free( expandedSql );
 
-        sqlite3_finalize( stmt );
-
         if ( ret == SQLITE_DONE || ret == SQLITE_ROW )
         {
           // update feature id
@@ -4355,6 +4367,9 @@ bool QgsSpatiaLiteProvider::addFeatures( QgsFeatureList &flist, Flags flags )
       }
     } // prepared statement
 
+    sqlite3_finalize( stmt );
+    stmt = nullptr;
+
     if ( ret == SQLITE_DONE || ret == SQLITE_ROW )
     {
       ret = exec_sql( sqliteHandle(), QStringLiteral( "RELEASE SAVEPOINT \"%1\"" ).arg( savepointId ), uri().uri(), errMsg, QGS_QUERY_LOG_ORIGIN );
@@ -18,6 +18,7 @@ email                : hugo dot mercier at oslandia dot com
 #include <iostream>
 #include <cstdint>
 #include <stdexcept>
+#include <algorithm>
 
 #include <QCoreApplication>
 #include <QBuffer>
@@ -480,29 +481,38 @@ int vtableRename( sqlite3_vtab *vtab, const char *newName )
   return SQLITE_OK;
 }
 
+// flags of the index number passed from vtableBestIndex to vtableFilter
+// the index string holds the used columns and the comparison expressions, separated by INDEX_STRING_SEPARATOR
+constexpr int INDEX_FID_FILTER = 1;
+constexpr int INDEX_RTREE_FILTER = 2;
+constexpr int INDEX_EXPRESSION_FILTER = 4;
+constexpr char INDEX_STRING_SEPARATOR = '\x1f';
+
 int vtableBestIndex( sqlite3_vtab *pvtab, sqlite3_index_info *indexInfo )
 {
   VTable *vtab = reinterpret_cast< VTable * >( pvtab );
+  const QgsFields fields = vtab->fields();
+
+  int fidConstraint = -1;
+  int rtreeConstraint = -1;
+  QList< int > expressionConstraints;
+  QStringList expressions;
   for ( int i = 0; i < indexInfo->nConstraint; i++ )
   {
+    if ( !indexInfo->aConstraint[i].usable )
+      continue;
+
     // request for primary key filter with '='
-    if ( ( indexInfo->aConstraint[i].usable ) &&
-         ( vtab->pkColumn() == indexInfo->aConstraint[i].iColumn ) &&
+    if ( ( vtab->pkColumn() == indexInfo->aConstraint[i].iColumn ) &&
          ( indexInfo->aConstraint[i].op == SQLITE_INDEX_CONSTRAINT_EQ ) )
     {
-      indexInfo->aConstraintUsage[i].argvIndex = 1;
-      indexInfo->aConstraintUsage[i].omit = 1;
-      indexInfo->idxNum = 1; // PK filter
-      indexInfo->estimatedCost = 1.0;
-      indexInfo->idxStr = nullptr;
-      indexInfo->needToFreeIdxStr = 0;
-      return SQLITE_OK;
+      fidConstraint = i;
+      break;
     }
 
     // request for filter with a comparison operator
-    if ( ( indexInfo->aConstraint[i].usable ) &&
-         ( indexInfo->aConstraint[i].iColumn >= 0 ) &&
-         ( indexInfo->aConstraint[i].iColumn < vtab->fields().count() ) &&
+    if ( ( indexInfo->aConstraint[i].iColumn >= 0 ) &&
+         ( indexInfo->aConstraint[i].iColumn < fields.count() ) &&
          ( ( indexInfo->aConstraint[i].op == SQLITE_INDEX_CONSTRAINT_EQ ) || // if no PK
            ( indexInfo->aConstraint[i].op == SQLITE_INDEX_CONSTRAINT_GT ) ||
            ( indexInfo->aConstraint[i].op == SQLITE_INDEX_CONSTRAINT_LE ) ||
@@ -513,12 +523,7 @@ int vtableBestIndex( sqlite3_vtab *pvtab, sqlite3_index_info *indexInfo )
 #endif
          ) )
     {
-      indexInfo->aConstraintUsage[i].argvIndex = 1;
-      indexInfo->aConstraintUsage[i].omit = 1;
-      indexInfo->idxNum = 3; // expression filter
-      indexInfo->estimatedCost = 2.0; // probably better than no index
-
-      QString expr = QgsExpression::quotedColumnRef( vtab->fields().at( indexInfo->aConstraint[i].iColumn ).name() );
+      QString expr = QgsExpression::quotedColumnRef( fields.at( indexInfo->aConstraint[i].iColumn ).name() );
       switch ( indexInfo->aConstraint[i].op )
       {
         case SQLITE_INDEX_CONSTRAINT_EQ:
@@ -544,36 +549,72 @@ int vtableBestIndex( sqlite3_vtab *pvtab, sqlite3_index_info *indexInfo )
         default:
           break;
       }
+      if ( expr.contains( INDEX_STRING_SEPARATOR ) )
+        continue;
 
-      QByteArray ba = expr.toUtf8();
-      char *cp = ( char * )sqlite3_malloc( ba.size() + 1 );
-      memcpy( cp, ba.constData(), ba.size() + 1 );
-
-      indexInfo->idxStr = cp;
-      indexInfo->needToFreeIdxStr = 1;
-      return SQLITE_OK;
+      // all the comparisons of the constraints are passed to the source, combined with AND
+      expressionConstraints << i;
+      expressions << expr;
+      continue;
     }
 
     // request for rtree filtering
-    if ( ( indexInfo->aConstraint[i].usable ) &&
-         // request on _search_frame_ column
-         ( vtab->fields().count() + 1 == indexInfo->aConstraint[i].iColumn ) &&
-         ( indexInfo->aConstraint[i].op == SQLITE_INDEX_CONSTRAINT_EQ ) )
+    if ( // request on _search_frame_ column
+      ( fields.count() + 1 == indexInfo->aConstraint[i].iColumn ) &&
+      ( indexInfo->aConstraint[i].op == SQLITE_INDEX_CONSTRAINT_EQ ) &&
+      rtreeConstraint < 0 )
     {
-      indexInfo->aConstraintUsage[i].argvIndex = 1;
-      // do not test for equality, since it is used for filtering, not to return an actual value
-      indexInfo->aConstraintUsage[i].omit = 1;
-      indexInfo->idxNum = 2; // RTree filter
-      indexInfo->estimatedCost = 1.0;
-      indexInfo->idxStr = nullptr;
-      indexInfo->needToFreeIdxStr = 0;
-      return SQLITE_OK;
+      rtreeConstraint = i;
     }
   }
+
   indexInfo->idxNum = 0;
   indexInfo->estimatedCost = 10.0;
-  indexInfo->idxStr = nullptr;
-  indexInfo->needToFreeIdxStr = 0;
+  int argvIndex = 0;
+  if ( fidConstraint >= 0 )
+  {
+    indexInfo->aConstraintUsage[fidConstraint].argvIndex = ++argvIndex;
+    indexInfo->aConstraintUsage[fidConstraint].omit = 1;
+    indexInfo->idxNum = INDEX_FID_FILTER;
+    indexInfo->estimatedCost = 1.0;
+    expressions.clear();
+  }
+  else
+  {
+    if ( rtreeConstraint >= 0 )
+    {
+      indexInfo->aConstraintUsage[rtreeConstraint].argvIndex = ++argvIndex;
+      // do not test for equality, since it is used for filtering, not to return an actual value
+      indexInfo->aConstraintUsage[rtreeConstraint].omit = 1;
+      indexInfo->idxNum |= INDEX_RTREE_FILTER;
+      indexInfo->estimatedCost = 1.0;
+    }
+    if ( !expressionConstraints.isEmpty() )
+    {
+      for ( int constraint : std::as_const( expressionConstraints ) )
+      {
+        indexInfo->aConstraintUsage[constraint].argvIndex = ++argvIndex;
+        indexInfo->aConstraintUsage[constraint].omit = 1;
+      }
+      indexInfo->idxNum |= INDEX_EXPRESSION_FILTER;
+      // probably better than no index, and better with more constraints
+      indexInfo->estimatedCost = std::min( indexInfo->estimatedCost, 2.0 / expressionConstraints.size() );
+    }
+  }
+
+  // columns used by the statement, so that only those are fetched from the source
+  QString usedColumns;
+#if SQLITE_VERSION_NUMBER >= 3010000
+  usedColumns = QString::number( static_cast< qulonglong >( indexInfo->colUsed ) );
+#endif
+  expressions.prepend( usedColumns );
+
+  QByteArray ba = expressions.join( INDEX_STRING_SEPARATOR ).toUtf8();
+  char *cp = ( char * )sqlite3_malloc( ba.size() + 1 );
+  memcpy( cp, ba.constData(), ba.size() + 1 );
+
+  indexInfo->idxStr = cp;
+  indexInfo->needToFreeIdxStr = 1;
   return SQLITE_OK;
 }
 
@@ -595,55 +636,82 @@ int vtableClose( sqlite3_vtab_cursor *cursor )
 
 int vtableFilter( sqlite3_vtab_cursor *cursor, int idxNum, const char *idxStr, int argc, sqlite3_value **argv )
 {
-  Q_UNUSED( argc )
+  VTableCursor *c = reinterpret_cast<VTableCursor *>( cursor );
+  const QStringList indexParts = QString::fromUtf8( idxStr ).split( INDEX_STRING_SEPARATOR );
 
   QgsFeatureRequest request;
-  if ( idxNum == 1 )
+  int argvIndex = 0;
+  if ( idxNum & INDEX_FID_FILTER && argvIndex < argc )
   {
     // id filter
-    request.setFilterFid( sqlite3_value_int( argv[0] ) );
+    request.setFilterFid( sqlite3_value_int64( argv[argvIndex++] ) );
   }
-  else if ( idxNum == 2 )
+  if ( idxNum & INDEX_RTREE_FILTER && argvIndex < argc )
   {
     // rtree filter
-    const char *blob = reinterpret_cast< const char * >( sqlite3_value_blob( argv[0] ) );
+    sqlite3_value *value = argv[argvIndex++];
+    const char *blob = reinterpret_cast< const char * >( sqlite3_value_blob( value ) );
     if ( blob )
     {
-      int bytes = sqlite3_value_bytes( argv[0] );
+      int bytes = sqlite3_value_bytes( value );
       QgsRectangle r( spatialiteBlobBbox( blob, bytes ) );
       request.setFilterRect( r );
     }
   }
-  else if ( idxNum == 3 )
+  if ( idxNum & INDEX_EXPRESSION_FILTER )
   {
-    // comparison operator filter
+    // comparison operator filters
     // build an expression filter and rely on expression compiler if available
-    QString expr = idxStr;
-    switch ( sqlite3_value_type( argv[0] ) )
+    QStringList expressions;
+    for ( int i = 1; i < indexParts.size() && argvIndex < argc; ++i )
     {
-      case SQLITE_INTEGER:
-        expr += QString::number( sqlite3_value_int64( argv[0] ) );
-        break;
-      case SQLITE_FLOAT:
-        expr += QString::number( sqlite3_value_double( argv[0] ) );
-        break;
-      case SQLITE_TEXT:
+      sqlite3_value *value = argv[argvIndex++];
+      QString expr = indexParts.at( i );
+      switch ( sqlite3_value_type( value ) )
       {
-        int n = sqlite3_value_bytes( argv[0] );
-        const char *t = reinterpret_cast<const char *>( sqlite3_value_text( argv[0] ) );
-        QString str = QString::fromUtf8( t, n );
-        expr += QgsExpression::quotedString( str );
-        break;
+        case SQLITE_INTEGER:
+          expr += QString::number( sqlite3_value_int64( value ) );
+          break;
+        case SQLITE_FLOAT:
+          expr += QString::number( sqlite3_value_double( value ) );
+          break;
+        case SQLITE_TEXT:
+        {
+          int n = sqlite3_value_bytes( value );
+          const char *t = reinterpret_cast<const char *>( sqlite3_value_text( value ) );
+          QString str = QString::fromUtf8( t, n );
+          expr += QgsExpression::quotedString( str );
+          break;
+        }
+        case SQLITE_NULL:
+        case SQLITE_BLOB: // comparison to blob ignored
+        default:
+          expr += QLatin1String( " is null" );
+          break;
       }
-      case SQLITE_NULL:
-      case SQLITE_BLOB: // comparison to blob ignored
-      default:
-        expr += QLatin1String( " is null" );
-        break;
+      expressions << expr;
     }
-    request.setFilterExpression( expr );
+    request.setFilterExpression( expressions.size() == 1 ? expressions.at( 0 ) : QStringLiteral( "(%1)" ).arg( expressions.join( QLatin1String( ") AND (" ) ) ) );
   }
-  VTableCursor *c = reinterpret_cast<VTableCursor *>( cursor );
+
+  // fetch only the attributes and the geometry used by the statement. Columns above 63 are
+  // all flagged by the last bit
+  bool usedColumnsOk = false;
+  const qulonglong usedColumns = indexParts.value( 0 ).toULongLong( &usedColumnsOk );
+  const int fieldCount = c->nColumns();
+  if ( usedColumnsOk && fieldCount < 63 )
+  {
+    QgsAttributeList attributes;
+    for ( int i = 0; i < fieldCount; ++i )
+    {
+      if ( usedColumns & ( 1ULL << i ) )
+        attributes << i;
+    }
+    request.setSubsetOfAttributes( attributes );
+    if ( !( usedColumns & ( 1ULL << fieldCount ) ) )
+      request.setFlags( request.flags() | QgsFeatureRequest::NoGeometry );
+  }
+
   c->filter( request );
   return SQLITE_OK;
 }
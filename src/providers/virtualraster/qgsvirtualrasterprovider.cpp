@@ -18,9 +18,21 @@
 #include "qgsrasterprojector.h"
 #include "qgsapplication.h"
 
+#include <QtConcurrentMap>
+#include <QThread>
+
+#include <atomic>
+
 #define PROVIDER_KEY QStringLiteral( "virtualraster" )
 #define PROVIDER_DESCRIPTION QStringLiteral( "Virtual Raster data provider" )
 
+///@cond PRIVATE
+
+//! Minimum number of rows of the output block evaluated by each thread
+constexpr int MINIMUM_ROWS_PER_TASK = 16;
+
+///@endcond
+
 QgsVirtualRasterProvider::QgsVirtualRasterProvider( const QString &uri, const QgsDataProvider::ProviderOptions &providerOptions )
   : QgsRasterDataProvider( uri, providerOptions )
 {
@@ -171,6 +183,7 @@ QgsRasterBlock *QgsVirtualRasterProvider::block( int bandNo, const QgsRectangle
       {
         qDeleteAll( inputBlocks );
         QgsDebugMsg( "Canceled = 3, User canceled calculation" );
+        return tblock.release();
       }
     }
     else
@@ -181,35 +194,51 @@ QgsRasterBlock *QgsVirtualRasterProvider::block( int bandNo, const QgsRectangle
     inputBlocks.insert( it->ref, block.release() );
   }
 
-  QgsRasterMatrix resultMatrix( width, 1, nullptr, -FLT_MAX );
+  // the rows are evaluated by several threads, each one on a range of consecutive rows
+  const int taskCount = std::max( 1, std::min( QThread::idealThreadCount(), height / MINIMUM_ROWS_PER_TASK ) );
+  const int rowsPerTask = ( height + taskCount - 1 ) / taskCount;
+  QVector< int > taskStartRows;
+  for ( int startRow = 0; startRow < height; startRow += rowsPerTask )
+    taskStartRows << startRow;
 
-  for ( int i = 0; i < height; ++i )
+  std::atomic< int > evaluatedRows( 0 );
+  std::atomic< bool > calculationError( false );
+  QtConcurrent::blockingMap( taskStartRows, [&]( int startRow )
   {
-    if ( feedback )
+    // QMap::find() may detach the map, so each thread uses its own copy
+    QMap< QString, QgsRasterBlock * > taskInputBlocks = inputBlocks;
+    QgsRasterMatrix resultMatrix( width, 1, nullptr, -FLT_MAX );
+    const int endRow = std::min( startRow + rowsPerTask, height );
+    for ( int i = startRow; i < endRow; ++i )
     {
-      feedback->setProgress( 100.0 * static_cast< double >( i ) / height );
-    }
-
-    if ( feedback && feedback->isCanceled() )
-    {
-      break;
-    }
+      if ( ( feedback && feedback->isCanceled() ) || calculationError )
+      {
+        break;
+      }
 
-    if ( mCalcNode->calculate( inputBlocks, resultMatrix, i ) )
-    {
-      for ( int j = 0; j < width; ++j )
+      if ( mCalcNode->calculate( taskInputBlocks, resultMatrix, i ) )
       {
-        outputData [ i * width + j ] = resultMatrix.data()[j];
+        for ( int j = 0; j < width; ++j )
+        {
+          outputData [ i * width + j ] = resultMatrix.data()[j];
+        }
       }
+      else
+      {
+        calculationError = true;
+        QgsDebugMsg( "calcNode was not run in a correct way" );
+      }
+      ++evaluatedRows;
     }
-    else
-    {
-      qDeleteAll( inputBlocks );
-      inputBlocks.clear();
-      QgsDebugMsg( "calcNode was not run in a correct way" );
-    }
+  } );
+
+  if ( feedback && !feedback->isCanceled() )
+  {
+    feedback->setProgress( 100.0 * static_cast< double >( evaluatedRows ) / height );
   }
 
+  qDeleteAll( inputBlocks );
+
   Q_ASSERT( tblock );
   return tblock.release();
 }
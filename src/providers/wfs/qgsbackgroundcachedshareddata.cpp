@@ -548,6 +548,12 @@ void QgsBackgroundCachedSharedData::serializeFeatures( QVector<QgsFeatureUniqueI
   Q_ASSERT( hexwkbGeomIdx >= 0 );
   int md5Idx = ( mDistinctSelect ) ? dataProviderFields.indexFromName( QgsBackgroundCachedFeatureIteratorConstants::FIELD_MD5 ) : -1;
 
+  // index in the cache of each user visible field, looked up once for all the features
+  QVector<int> cachedFieldIndices;
+  cachedFieldIndices.reserve( mFields.size() );
+  for ( int i = 0; i < mFields.size(); i++ )
+    cachedFieldIndices << dataProviderFields.indexFromName( mMapUserVisibleFieldNameToSpatialiteColumnName[mFields.at( i ).name()] );
+
   QSet<QString> existingUniqueIds;
   QSet<QString> existingMD5s;
   if ( mDistinctSelect )
@@ -622,7 +628,7 @@ void QgsBackgroundCachedSharedData::serializeFeatures( QVector<QgsFeatureUniqueI
     //and the attributes
     for ( int i = 0; i < mFields.size(); i++ )
     {
-      int idx = dataProviderFields.indexFromName( mMapUserVisibleFieldNameToSpatialiteColumnName[mFields.at( i ).name()] );
+      const int idx = cachedFieldIndices.at( i );
       if ( idx >= 0 )
       {
         const QVariant &v = srcFeature.attributes().value( i );
@@ -661,6 +667,10 @@ void QgsBackgroundCachedSharedData::serializeFeatures( QVector<QgsFeatureUniqueI
     // That way we will always have a consistent feature id, even in case of
     // paging or BBOX request
     Q_ASSERT( featureListToCache.size() == updatedFeatureList.size() );
+
+    // the id cache is updated in a single transaction, instead of one per statement
+    QString transactionErrorMsg;
+    const bool inTransaction = !updatedFeatureList.isEmpty() && mCacheIdDb.exec( QStringLiteral( "BEGIN" ), transactionErrorMsg ) == SQLITE_OK;
     for ( int i = 0; i < updatedFeatureList.size(); i++ )
     {
       int resultCode;
@@ -728,6 +738,11 @@ void QgsBackgroundCachedSharedData::serializeFeatures( QVector<QgsFeatureUniqueI
       updatedFeatureList[i].first.setId( qgisId );
     }
 
+    if ( inTransaction && mCacheIdDb.exec( QStringLiteral( "COMMIT" ), transactionErrorMsg ) != SQLITE_OK )
+    {
+      QgsMessageLog::logMessage( QObject::tr( "Problem when updating id cache: %1" ).arg( transactionErrorMsg ), mComponentTranslated );
+    }
+
     {
       QMutexLocker locker( &mMutex );
       if ( mRequestLimit != 1 )
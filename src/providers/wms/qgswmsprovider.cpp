@@ -79,6 +79,9 @@
 #endif
 
 #define ERR(message) QGS_ERROR_MESSAGE(message,"WMS provider")
+
+//! Maximum number of tiles of the lower resolution prefetched for a view
+constexpr int MAX_PREFETCHED_TILES = 64;
 #define QGS_ERROR(message) QgsError(message,"WMS provider")
 
 QString QgsWmsProvider::WMS_KEY = QStringLiteral( "wms" );
@@ -741,6 +744,80 @@ void QgsWmsProvider::fetchOtherResTiles( QgsTileMode tileMode,
                     .arg( otherResTiles.count() ), 3 );
 }
 
+void QgsWmsProvider::prefetchOtherResTiles( QgsTileMode tileMode, const QgsRectangle &viewExtent, double tres, QgsRasterBlockFeedback *feedback )
+{
+  if ( !mTileMatrixSet || mSettings.mIsMBTiles )
+    return;
+
+  if ( !mSettings.mXyz && !QgsSettingsRegistryCore::settingsEnableWMSTilePrefetching->value() )
+    return;
+
+  const QgsWmtsTileMatrix *tmOther = mTileMatrixSet->findOtherResolution( tres, 1 );
+  if ( !tmOther )
+    return;
+
+  const QgsWmtsTileMatrixLimits *tml = nullptr;
+  if ( mTileLayer &&
+       mTileLayer->setLinks.contains( mTileMatrixSet->identifier ) &&
+       mTileLayer->setLinks[ mTileMatrixSet->identifier ].limits.contains( tmOther->identifier ) )
+  {
+    tml = &mTileLayer->setLinks[ mTileMatrixSet->identifier ].limits[ tmOther->identifier ];
+  }
+
+  int col0, row0, col1, row1;
+  tmOther->viewExtentIntersection( viewExtent, tml, col0, row0, col1, row1 );
+  if ( ( col1 - col0 + 1 ) * ( row1 - row0 + 1 ) > MAX_PREFETCHED_TILES )
+    return;
+
+  TilePositions tiles;
+  for ( int row = row0; row <= row1; row++ )
+  {
+    for ( int col = col0; col <= col1; col++ )
+    {
+      tiles << TilePosition( row, col );
+    }
+  }
+
+  TileRequests requests;
+  switch ( tileMode )
+  {
+    case WMSC:
+      createTileRequestsWMSC( tmOther, tiles, requests );
+      break;
+
+    case WMTS:
+      createTileRequestsWMTS( tmOther, tiles, requests );
+      break;
+
+    case XYZ:
+      createTileRequestsXYZ( tmOther, tiles, requests, feedback );
+      break;
+  }
+
+  for ( const TileRequest &r : std::as_const( requests ) )
+  {
+    if ( feedback && feedback->isCanceled() )
+      return;
+
+    QImage cachedImage;
+    if ( QgsTileCache::tile( r.url, cachedImage ) )
+      continue;
+
+    QNetworkRequest request( r.url );
+    QgsSetRequestInitiatorClass( request, QStringLiteral( "QgsWmsProvider" ) );
+    mSettings.authorization().setAuthorization( request );
+    request.setRawHeader( "Accept", "*/*" );
+    request.setAttribute( QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache );
+    request.setAttribute( QNetworkRequest::CacheSaveControlAttribute, true );
+
+    // the download continues in the worker thread of the manager when the reply is deleted,
+    // and its result is stored in the network cache
+    delete QgsApplication::tileDownloadManager()->get( request );
+  }
+
+  QgsDebugMsgLevel( QStringLiteral( "Prefetched tiles: res %1, %2 requests" ).arg( tmOther->tres ).arg( requests.count() ), 3 );
+}
+
 uint qHash( QgsWmsProvider::TilePosition tp )
 {
   return ( uint ) tp.col + ( ( uint ) tp.row << 16 );
@@ -1125,6 +1202,11 @@ QImage *QgsWmsProvider::draw( const QgsRectangle &viewExtent, int pixelWidth, in
 
       effectiveViewExtent = handler.effectiveViewExtent();
       sourceResolution = handler.sourceResolution();
+
+      // the view was not cached, so the user is browsing a new area: prepare the lower
+      // resolution used when zooming out, which is also drawn as preview while loading tiles
+      if ( !tempTm && !( feedback && feedback->isCanceled() ) )
+        prefetchOtherResTiles( tileMode, viewExtent, tm->tres, feedback );
     }
 
     QgsDebugMsgLevel( QStringLiteral( "TILE CACHE total: %1 / %2" ).arg( QgsTileCache::totalCost() ).arg( QgsTileCache::maxCost() ), 3 );
@@ -5221,6 +5303,12 @@ QList<QgsMapLayerType> QgsWmsProviderMetadata::supportedLayerTypes() const
   return { QgsMapLayerType::RasterLayer };
 }
 
+QgsProviderMetadata::ProviderCapabilities QgsWmsProviderMetadata::providerCapabilities() const
+{
+  // capabilities are downloaded with the network access manager of the creating thread, in a local event loop
+  return QgsProviderMetadata::ProviderCapability::ParallelCreateProvider;
+}
+
 #ifndef HAVE_STATIC_PROVIDERS
 QGISEXTERN QgsProviderMetadata *providerMetadataFactory()
 {
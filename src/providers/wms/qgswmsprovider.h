@@ -471,6 +471,12 @@ class QgsWmsProvider final: public QgsRasterDataProvider
     //! Gets tiles from a different resolution to cover the missing areas
     void fetchOtherResTiles( QgsTileMode tileMode, const QgsRectangle &viewExtent, int imageWidth, QList<QRectF> &missing, double tres, int resOffset, QList<TileImage> &otherResTiles, QgsRasterBlockFeedback *feedback = nullptr );
 
+    /**
+     * Starts the download of the tiles of the next lower resolution covering the \a viewExtent, so they are
+     * available from the network cache when the user zooms out. The requests are not awaited.
+     */
+    void prefetchOtherResTiles( QgsTileMode tileMode, const QgsRectangle &viewExtent, double tres, QgsRasterBlockFeedback *feedback = nullptr );
+
     /**
      * Returns the full url to request legend graphic
      * The visibleExtent isi only used if provider supports contextual
@@ -734,6 +740,7 @@ class QgsWmsProviderMetadata final: public QgsProviderMetadata
     QVariantMap decodeUri( const QString &uri ) const override;
     QString encodeUri( const QVariantMap &parts ) const override;
     QList< QgsMapLayerType > supportedLayerTypes() const override;
+    QgsProviderMetadata::ProviderCapabilities providerCapabilities() const override;
 };
 
 #endif
@@ -23,9 +23,17 @@
 #include "qgsfcgiserverrequest.h"
 #include "qgsapplication.h"
 #include "qgscommandlineutils.h"
+#include "qgsserversettings.h"
 
 #include <fcgi_stdio.h>
+#include <fcgiapp.h>
 #include <cstdlib>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
 
 #include <QFontDatabase>
 #include <QString>
@@ -42,6 +50,160 @@ int fcgi_accept()
 #endif
 }
 
+///@cond PRIVATE
+
+//! Returns TRUE if the client of the \a request accepts gzip encoded responses
+static bool acceptsGzip( const QgsServerRequest &request )
+{
+  const QStringList encodings = request.header( QStringLiteral( "Accept-Encoding" ) ).split( ',' );
+  for ( const QString &encoding : encodings )
+  {
+    const QStringList parts = encoding.split( ';' );
+    if ( parts.at( 0 ).trimmed().compare( QLatin1String( "gzip" ), Qt::CaseInsensitive ) != 0 )
+      continue;
+    // q=0 explicitly refuses the encoding
+    return !( parts.size() > 1 && parts.at( 1 ).trimmed().remove( ' ' ) == QLatin1String( "q=0" ) );
+  }
+  return false;
+}
+
+/**
+ * A request accepted by one of the FCGI worker threads and waiting for
+ * being handled by the server on the main thread.
+ */
+struct FcgiRequestContext
+{
+  FCGX_Request fcgxRequest;
+  std::unique_ptr<QgsFcgiServerRequest> request;
+  bool done = false;
+};
+
+/**
+ * Pool of threads accepting FCGI requests and reading their content
+ * concurrently.
+ *
+ * QgsServer::handleRequest() is not reentrant (it relies on the server
+ * interface singleton and on QgsProject::instance()), so the accepted
+ * requests are queued and handled one at a time on the main thread, in
+ * the same way the development server does. Each worker blocks until its
+ * response has been written, so client I/O for up to N requests overlaps
+ * with rendering while all of them share the same project cache.
+ */
+class FcgiWorkerPool
+{
+  public:
+
+    explicit FcgiWorkerPool( int workers, bool compressResponses )
+      : mRunningWorkers( workers )
+      , mCompressResponses( compressResponses )
+    {
+      FCGX_Init();
+      for ( int i = 0; i < workers; ++i )
+      {
+        mThreads.emplace_back( &FcgiWorkerPool::acceptLoop, this );
+      }
+    }
+
+    ~FcgiWorkerPool()
+    {
+      for ( std::thread &thread : mThreads )
+      {
+        if ( thread.joinable() )
+          thread.join();
+      }
+    }
+
+    /**
+     * Handles the queued requests until all the workers have terminated,
+     * must be called from the main thread.
+     */
+    void exec( QgsServer &server )
+    {
+      while ( true )
+      {
+        std::unique_lock<std::mutex> queueLocker( mQueueMutex );
+        mQueueCondition.wait( queueLocker, [ = ] { return ! mQueue.empty() || mRunningWorkers == 0; } );
+        if ( mQueue.empty() )
+        {
+          break;
+        }
+
+        FcgiRequestContext *context = mQueue.front();
+        mQueue.pop();
+        queueLocker.unlock();
+
+        QgsFcgiServerResponse response( context->request->method(), &context->fcgxRequest );
+        response.setCompressionEnabled( mCompressResponses && acceptsGzip( *context->request ) );
+        if ( ! context->request->hasError() )
+        {
+          server.handleRequest( *context->request, response );
+        }
+        else
+        {
+          response.sendError( 400, "Bad request" );
+        }
+
+        queueLocker.lock();
+        context->done = true;
+        queueLocker.unlock();
+        mDoneCondition.notify_all();
+      }
+    }
+
+  private:
+
+    void acceptLoop()
+    {
+      FcgiRequestContext context;
+      FCGX_InitRequest( &context.fcgxRequest, 0, 0 );
+
+      while ( true )
+      {
+        int rc = 0;
+        {
+          // Some platforms require accept() calls to be serialized
+          const std::lock_guard<std::mutex> acceptLocker( mAcceptMutex );
+          rc = FCGX_Accept_r( &context.fcgxRequest );
+        }
+        if ( rc < 0 )
+        {
+          break;
+        }
+
+        // Read the request parameters and body in the worker thread
+        context.request = std::make_unique<QgsFcgiServerRequest>( &context.fcgxRequest );
+        context.done = false;
+
+        {
+          std::unique_lock<std::mutex> queueLocker( mQueueMutex );
+          mQueue.push( &context );
+          mQueueCondition.notify_one();
+          mDoneCondition.wait( queueLocker, [ &context ] { return context.done; } );
+        }
+
+        context.request.reset();
+        FCGX_Finish_r( &context.fcgxRequest );
+      }
+
+      FCGX_Free( &context.fcgxRequest, 1 );
+
+      const std::lock_guard<std::mutex> queueLocker( mQueueMutex );
+      --mRunningWorkers;
+      mQueueCondition.notify_one();
+    }
+
+    std::vector<std::thread> mThreads;
+    std::mutex mAcceptMutex;
+    std::mutex mQueueMutex;
+    std::condition_variable mQueueCondition;
+    std::condition_variable mDoneCondition;
+    std::queue<FcgiRequestContext *> mQueue;
+    int mRunningWorkers = 0;
+    bool mCompressResponses = false;
+};
+
+///@endcond
+
 int main( int argc, char *argv[] )
 {
   if ( argc >= 2 )
@@ -83,11 +245,25 @@ int main( int argc, char *argv[] )
   QFontDatabase fontDB;
 #endif
 
+  QgsServerSettings settings;
+  settings.load();
+  const int fcgiWorkers = settings.fcgiWorkers();
+
+  if ( fcgiWorkers > 0 && ! FCGX_IsCGI() )
+  {
+    QgsMessageLog::logMessage( QStringLiteral( "Starting %1 FCGI worker threads" ).arg( fcgiWorkers ), QStringLiteral( "Server" ), Qgis::MessageLevel::Info );
+    FcgiWorkerPool pool( fcgiWorkers, settings.compressResponses() );
+    pool.exec( server );
+    QgsApplication::exitQgis();
+    return 0;
+  }
+
   // Starts FCGI loop
   while ( fcgi_accept() >= 0 )
   {
     QgsFcgiServerRequest  request;
     QgsFcgiServerResponse response( request.method() );
+    response.setCompressionEnabled( settings.compressResponses() && acceptsGzip( request ) );
     if ( ! request.hasError() )
     {
       server.handleRequest( request, response );
@@ -63,6 +63,9 @@ void QgsAccessControl::unresolveFilterFeatures()
 {
   mFilterFeaturesExpressions.clear();
   mResolved = false;
+
+  const QMutexLocker locker( &mLayerPermissionsMutex );
+  mLayerPermissions.clear();
 }
 
 //! Filter the features of the layer
@@ -108,60 +111,63 @@ QString QgsAccessControl::extraSubsetString( const QgsVectorLayer *layer ) const
   return sqls.isEmpty() ? QString() : QStringLiteral( "((" ).append( sqls.join( QLatin1String( ") AND (" ) ) ).append( "))" );
 }
 
-//! Returns the layer read right
-bool QgsAccessControl::layerReadPermission( const QgsMapLayer *layer ) const
+QgsAccessControlFilter::LayerPermissions QgsAccessControl::layerPermissions( const QgsMapLayer *layer ) const
 {
+  // the services check the permissions of each layer several times per request,
+  // the plugins are only asked once per layer until the next request
+  {
+    const QMutexLocker locker( &mLayerPermissionsMutex );
+    const auto cached = mLayerPermissions.constFind( layer->id() );
+    if ( cached != mLayerPermissions.constEnd() )
+      return *cached;
+  }
+
+  // the plugins are asked without holding the lock, as they may call back into the access control
+  // or wait for the Python interpreter held by another thread waiting for the lock
+
+  QgsAccessControlFilter::LayerPermissions permissions;
+  permissions.canRead = true;
+  permissions.canUpdate = true;
+  permissions.canInsert = true;
+  permissions.canDelete = true;
+
   QgsAccessControlFilterMap::const_iterator acIterator;
   for ( acIterator = mPluginsAccessControls->constBegin(); acIterator != mPluginsAccessControls->constEnd(); ++acIterator )
   {
-    if ( !acIterator.value()->layerPermissions( layer ).canRead )
-    {
-      return false;
-    }
+    const QgsAccessControlFilter::LayerPermissions pluginPermissions = acIterator.value()->layerPermissions( layer );
+    permissions.canRead = permissions.canRead && pluginPermissions.canRead;
+    permissions.canUpdate = permissions.canUpdate && pluginPermissions.canUpdate;
+    permissions.canInsert = permissions.canInsert && pluginPermissions.canInsert;
+    permissions.canDelete = permissions.canDelete && pluginPermissions.canDelete;
   }
-  return true;
+
+  const QMutexLocker locker( &mLayerPermissionsMutex );
+  mLayerPermissions.insert( layer->id(), permissions );
+  return permissions;
+}
+
+//! Returns the layer read right
+bool QgsAccessControl::layerReadPermission( const QgsMapLayer *layer ) const
+{
+  return layerPermissions( layer ).canRead;
 }
 
 //! Returns the layer insert right
 bool QgsAccessControl::layerInsertPermission( const QgsVectorLayer *layer ) const
 {
-  QgsAccessControlFilterMap::const_iterator acIterator;
-  for ( acIterator = mPluginsAccessControls->constBegin(); acIterator != mPluginsAccessControls->constEnd(); ++acIterator )
-  {
-    if ( !acIterator.value()->layerPermissions( layer ).canInsert )
-    {
-      return false;
-    }
-  }
-  return true;
+  return layerPermissions( layer ).canInsert;
 }
 
 //! Returns the layer update right
 bool QgsAccessControl::layerUpdatePermission( const QgsVectorLayer *layer ) const
 {
-  QgsAccessControlFilterMap::const_iterator acIterator;
-  for ( acIterator = mPluginsAccessControls->constBegin(); acIterator != mPluginsAccessControls->constEnd(); ++acIterator )
-  {
-    if ( !acIterator.value()->layerPermissions( layer ).canUpdate )
-    {
-      return false;
-    }
-  }
-  return true;
+  return layerPermissions( layer ).canUpdate;
 }
 
 //! Returns the layer delete right
 bool QgsAccessControl::layerDeletePermission( const QgsVectorLayer *layer ) const
 {
-  QgsAccessControlFilterMap::const_iterator acIterator;
-  for ( acIterator = mPluginsAccessControls->constBegin(); acIterator != mPluginsAccessControls->constEnd(); ++acIterator )
-  {
-    if ( !acIterator.value()->layerPermissions( layer ).canDelete )
-    {
-      return false;
-    }
-  }
-  return true;
+  return layerPermissions( layer ).canDelete;
 }
 
 //! Returns the authorized layer attributes
@@ -210,4 +216,7 @@ bool QgsAccessControl::fillCacheKey( QStringList &cacheKey ) const
 void QgsAccessControl::registerAccessControl( QgsAccessControlFilter *accessControl, int priority )
 {
   mPluginsAccessControls->insert( priority, accessControl );
+
+  const QMutexLocker locker( &mLayerPermissionsMutex );
+  mLayerPermissions.clear();
 }
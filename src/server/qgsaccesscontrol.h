@@ -24,6 +24,9 @@
 #include "qgis_server.h"
 #include "qgis_sip.h"
 
+#include <QHash>
+#include <QMutex>
+
 SIP_IF_MODULE( HAVE_SERVER_PYTHON_PLUGINS )
 
 
@@ -53,6 +56,8 @@ class SERVER_EXPORT QgsAccessControl : public QgsFeatureFilterProvider
       mPluginsAccessControls = new QgsAccessControlFilterMap( *copy.mPluginsAccessControls );
       mFilterFeaturesExpressions = copy.mFilterFeaturesExpressions;
       mResolved = copy.mResolved;
+      const QMutexLocker locker( &copy.mLayerPermissionsMutex );
+      mLayerPermissions = copy.mLayerPermissions;
     }
 
 
@@ -70,6 +75,9 @@ class SERVER_EXPORT QgsAccessControl : public QgsFeatureFilterProvider
         mPluginsAccessControls = new QgsAccessControlFilterMap( *other.mPluginsAccessControls );
         mFilterFeaturesExpressions = other.mFilterFeaturesExpressions;
         mResolved = other.mResolved;
+        const QMutexLocker otherLocker( &other.mLayerPermissionsMutex );
+        const QMutexLocker locker( &mLayerPermissionsMutex );
+        mLayerPermissions = other.mLayerPermissions;
       }
       return *this;
     }
@@ -86,7 +94,8 @@ class SERVER_EXPORT QgsAccessControl : public QgsFeatureFilterProvider
     void resolveFilterFeatures( const QList<QgsMapLayer *> &layers );
 
     /**
-     *  Clear expression's cache computed from `resolveFilterFeatures`
+     *  Clear expression's cache computed from `resolveFilterFeatures`, and the
+     *  layer permissions cached for the current request
      */
     void unresolveFilterFeatures();
 
@@ -170,12 +179,19 @@ class SERVER_EXPORT QgsAccessControl : public QgsFeatureFilterProvider
   private:
     QString resolveFilterFeatures( const QgsVectorLayer *layer ) const;
 
+    //! Returns the permissions granted on the layer by all the access control plugins
+    QgsAccessControlFilter::LayerPermissions layerPermissions( const QgsMapLayer *layer ) const;
+
     //! The AccessControl plugins registry
     QgsAccessControlFilterMap *mPluginsAccessControls = nullptr;
 
     QMap<QString, QString> mFilterFeaturesExpressions;
     bool mResolved;
 
+    //! Layer permissions of the current request, by layer id
+    mutable QHash<QString, QgsAccessControlFilter::LayerPermissions> mLayerPermissions;
+    mutable QMutex mLayerPermissionsMutex;
+
 };
 
 #endif
@@ -64,7 +64,7 @@ void QgsConfigCache::initialize( QgsServerSettings *settings )
     return;
   }
 
-  sInstance = new QgsConfigCache( getStrategyFromSettings( settings ) );
+  sInstance = new QgsConfigCache( settings );
 }
 
 QgsConfigCache *QgsConfigCache::instance()
@@ -80,7 +80,7 @@ QgsConfigCache *QgsConfigCache::instance()
 QgsConfigCache::QgsConfigCache( QgsServerSettings *settings )
   : QgsConfigCache( getStrategyFromSettings( settings ) )
 {
-
+  mSettings = settings;
 }
 
 QgsConfigCache::QgsConfigCache( QgsAbstractCacheStrategy *strategy )
@@ -96,94 +96,139 @@ QgsConfigCache::QgsConfigCache() : QgsConfigCache( new QgsFileSystemCacheStrateg
 
 const QgsProject *QgsConfigCache::project( const QString &path, const QgsServerSettings *settings )
 {
+  const QMutexLocker locker( &mMutex );
+
   if ( !mProjectCache[ path ] )
   {
-    // disable the project style database -- this incurs unwanted cost and is not required
-    std::unique_ptr<QgsProject> prj( new QgsProject( nullptr, Qgis::ProjectCapabilities() ) );
+    if ( QgsProject *prj = loadProject( path, settings ) )
+    {
+      cacheProject( path, prj );
+    }
+  }
 
-    // This is required by virtual layers that call QgsProject::instance() inside the constructor :(
-    QgsProject::setInstance( prj.get() );
+  auto entry = mProjectCache[ path ];
+  return entry ? entry->second.get() : nullptr;
+}
 
-    QgsStoreBadLayerInfo *badLayerHandler = new QgsStoreBadLayerInfo();
-    prj->setBadLayerHandler( badLayerHandler );
+void QgsConfigCache::preloadProjects( const QStringList &paths, const QgsServerSettings *settings )
+{
+  for ( const QString &path : paths )
+  {
+    const QString projectPath = path.trimmed();
+    if ( projectPath.isEmpty() )
+    {
+      continue;
+    }
 
-    // Always skip original styles storage
-    Qgis::ProjectReadFlags readFlags = Qgis::ProjectReadFlag::DontStoreOriginalStyles
-                                       | Qgis::ProjectReadFlag::DontLoad3DViews;
-    if ( settings )
+    try
     {
-      // Activate trust layer metadata flag
-      if ( settings->trustLayerMetadata() )
+      if ( project( projectPath, settings ) )
       {
-        readFlags |= Qgis::ProjectReadFlag::TrustLayerMetadata;
-      }
-      // Activate force layer read only flag
-      if ( settings->forceReadOnlyLayers() )
-      {
-        readFlags |= Qgis::ProjectReadFlag::ForceReadOnlyLayers;
-      }
-      // Activate don't load layouts flag
-      if ( settings->getPrintDisabled() )
-      {
-        readFlags |= Qgis::ProjectReadFlag::DontLoadLayouts;
+        QgsMessageLog::logMessage(
+          QStringLiteral( "Project '%1' preloaded" ).arg( projectPath ),
+          QStringLiteral( "Server" ), Qgis::MessageLevel::Info );
       }
     }
+    catch ( QgsServerException &ex )
+    {
+      QgsMessageLog::logMessage(
+        QStringLiteral( "Error when preloading project '%1': %2" ).arg( projectPath, ex.what() ),
+        QStringLiteral( "Server" ), Qgis::MessageLevel::Critical );
+    }
+  }
+}
+
+QgsProject *QgsConfigCache::loadProject( const QString &path, const QgsServerSettings *settings )
+{
+  // disable the project style database -- this incurs unwanted cost and is not required
+  std::unique_ptr<QgsProject> prj( new QgsProject( nullptr, Qgis::ProjectCapabilities() ) );
+
+  // This is required by virtual layers that call QgsProject::instance() inside the constructor :(
+  QgsProject::setInstance( prj.get() );
+
+  QgsStoreBadLayerInfo *badLayerHandler = new QgsStoreBadLayerInfo();
+  prj->setBadLayerHandler( badLayerHandler );
+
+  // Always skip original styles storage
+  Qgis::ProjectReadFlags readFlags = Qgis::ProjectReadFlag::DontStoreOriginalStyles
+                                     | Qgis::ProjectReadFlag::DontLoad3DViews;
+  if ( settings )
+  {
+    // Activate trust layer metadata flag
+    if ( settings->trustLayerMetadata() )
+    {
+      readFlags |= Qgis::ProjectReadFlag::TrustLayerMetadata;
+    }
+    // Activate force layer read only flag
+    if ( settings->forceReadOnlyLayers() )
+    {
+      readFlags |= Qgis::ProjectReadFlag::ForceReadOnlyLayers;
+    }
+    // Activate don't load layouts flag
+    if ( settings->getPrintDisabled() )
+    {
+      readFlags |= Qgis::ProjectReadFlag::DontLoadLayouts;
+    }
+    // Load unchanged projects from the binary document cache
+    prj->setDocumentCacheDirectory( settings->projectDocumentCacheDirectory() );
+  }
 
-    if ( prj->read( path, readFlags ) )
+  if ( prj->read( path, readFlags ) )
+  {
+    if ( !badLayerHandler->badLayers().isEmpty() )
     {
-      if ( !badLayerHandler->badLayers().isEmpty() )
+      // if bad layers are not restricted layers so service failed
+      QStringList unrestrictedBadLayers;
+      // test bad layers through restrictedlayers
+      const QStringList badLayerIds = badLayerHandler->badLayers();
+      const QMap<QString, QString> badLayerNames = badLayerHandler->badLayerNames();
+      const QStringList resctrictedLayers = QgsServerProjectUtils::wmsRestrictedLayers( *prj );
+      for ( const QString &badLayerId : badLayerIds )
       {
-        // if bad layers are not restricted layers so service failed
-        QStringList unrestrictedBadLayers;
-        // test bad layers through restrictedlayers
-        const QStringList badLayerIds = badLayerHandler->badLayers();
-        const QMap<QString, QString> badLayerNames = badLayerHandler->badLayerNames();
-        const QStringList resctrictedLayers = QgsServerProjectUtils::wmsRestrictedLayers( *prj );
-        for ( const QString &badLayerId : badLayerIds )
+        // if this bad layer is in restricted layers
+        // it doesn't need to be added to unrestricted bad layers
+        if ( badLayerNames.contains( badLayerId ) &&
+             resctrictedLayers.contains( badLayerNames.value( badLayerId ) ) )
         {
-          // if this bad layer is in restricted layers
-          // it doesn't need to be added to unrestricted bad layers
-          if ( badLayerNames.contains( badLayerId ) &&
-               resctrictedLayers.contains( badLayerNames.value( badLayerId ) ) )
-          {
-            continue;
-          }
-          unrestrictedBadLayers.append( badLayerId );
+          continue;
         }
-        if ( !unrestrictedBadLayers.isEmpty() )
+        unrestrictedBadLayers.append( badLayerId );
+      }
+      if ( !unrestrictedBadLayers.isEmpty() )
+      {
+        // This is a critical error unless QGIS_SERVER_IGNORE_BAD_LAYERS is set to TRUE
+        if ( ! settings || ! settings->ignoreBadLayers() )
+        {
+          QgsMessageLog::logMessage(
+            QStringLiteral( "Error, Layer(s) %1 not valid in project %2" ).arg( unrestrictedBadLayers.join( QLatin1String( ", " ) ), path ),
+            QStringLiteral( "Server" ), Qgis::MessageLevel::Critical );
+          throw QgsServerException( QStringLiteral( "Layer(s) not valid" ) );
+        }
+        else
         {
-          // This is a critical error unless QGIS_SERVER_IGNORE_BAD_LAYERS is set to TRUE
-          if ( ! settings || ! settings->ignoreBadLayers() )
-          {
-            QgsMessageLog::logMessage(
-              QStringLiteral( "Error, Layer(s) %1 not valid in project %2" ).arg( unrestrictedBadLayers.join( QLatin1String( ", " ) ), path ),
-              QStringLiteral( "Server" ), Qgis::MessageLevel::Critical );
-            throw QgsServerException( QStringLiteral( "Layer(s) not valid" ) );
-          }
-          else
-          {
-            QgsMessageLog::logMessage(
-              QStringLiteral( "Warning, Layer(s) %1 not valid in project %2" ).arg( unrestrictedBadLayers.join( QLatin1String( ", " ) ), path ),
-              QStringLiteral( "Server" ), Qgis::MessageLevel::Warning );
-          }
+          QgsMessageLog::logMessage(
+            QStringLiteral( "Warning, Layer(s) %1 not valid in project %2" ).arg( unrestrictedBadLayers.join( QLatin1String( ", " ) ), path ),
+            QStringLiteral( "Server" ), Qgis::MessageLevel::Warning );
         }
       }
-      cacheProject( path, prj.release() );
-    }
-    else
-    {
-      QgsMessageLog::logMessage(
-        QStringLiteral( "Error when loading project file '%1': %2 " ).arg( path, prj->error() ),
-        QStringLiteral( "Server" ), Qgis::MessageLevel::Critical );
     }
+    return prj.release();
+  }
+  else
+  {
+    QgsMessageLog::logMessage(
+      QStringLiteral( "Error when loading project file '%1': %2 " ).arg( path, prj->error() ),
+      QStringLiteral( "Server" ), Qgis::MessageLevel::Critical );
   }
 
-  auto entry = mProjectCache[ path ];
-  return entry ? entry->second.get() : nullptr;
+  return nullptr;
 }
 
+
 QList<QgsProject *> QgsConfigCache::projects() const
 {
+  const QMutexLocker locker( &mMutex );
+
   QList<QgsProject *> projects;
 
   const auto constKeys {  mProjectCache.keys() };
@@ -197,6 +242,8 @@ QList<QgsProject *> QgsConfigCache::projects() const
 
 QDomDocument *QgsConfigCache::xmlDocument( const QString &filePath )
 {
+  const QMutexLocker locker( &mMutex );
+
   //first open file
   QFile configFile( filePath );
   if ( !configFile.exists() )
@@ -243,6 +290,8 @@ void QgsConfigCache::cacheProject( const QString &path, QgsProject *project )
 
 void QgsConfigCache::removeEntry( const QString &path )
 {
+  const QMutexLocker locker( &mMutex );
+
   mProjectCache.remove( path );
 
   //xml document must be removed last, as other config cache destructors may require it
@@ -255,12 +304,77 @@ void QgsConfigCache::removeEntry( const QString &path )
 
 void QgsConfigCache::removeChangedEntry( const QString &path )
 {
-  removeEntry( path );
+  const QMutexLocker locker( &mMutex );
+
+  if ( mSettings && mSettings->projectCacheBackgroundReload() && mProjectCache.contains( path ) )
+  {
+    scheduleReload( path );
+  }
+  else
+  {
+    removeEntry( path );
+  }
+}
+
+void QgsConfigCache::scheduleReload( const QString &path )
+{
+  if ( mPendingReloads.contains( path ) )
+  {
+    return;
+  }
+
+  // The reload runs from the event loop, the cached version is served
+  // until the new one is loaded
+  mPendingReloads.insert( path );
+  QTimer::singleShot( 0, this, [this, path] { reloadEntry( path ); } );
+}
+
+void QgsConfigCache::reloadEntry( const QString &path )
+{
+  const QMutexLocker locker( &mMutex );
+
+  mPendingReloads.remove( path );
+  if ( !mProjectCache.contains( path ) )
+  {
+    return;
+  }
+
+  std::unique_ptr<QgsProject> prj;
+  try
+  {
+    prj.reset( loadProject( path, mSettings ) );
+  }
+  catch ( QgsServerException & )
+  {
+    // already logged by loadProject
+  }
+
+  if ( !prj )
+  {
+    QgsMessageLog::logMessage(
+      QStringLiteral( "Reload of project '%1' failed, keeping the cached version" ).arg( path ),
+      QStringLiteral( "Server" ), Qgis::MessageLevel::Warning );
+    // watch the file again, it may have been replaced rather than modified
+    mStrategy->entryInserted( path );
+    return;
+  }
+
+  // replaces and deletes the cached version
+  cacheProject( path, prj.release() );
+
+  //xml document must be removed last, as other config cache destructors may require it
+  mXmlDocumentCache.remove( path );
+
+  QgsMessageLog::logMessage(
+    QStringLiteral( "Project '%1' reloaded" ).arg( path ),
+    QStringLiteral( "Server" ), Qgis::MessageLevel::Info );
 }
 
 
 void QgsConfigCache::removeChangedEntries()
 {
+  const QMutexLocker locker( &mMutex );
+
   // QCache::keys returns a QList so it is safe
   // to mutate while iterating
   const auto constKeys {  mProjectCache.keys() };
@@ -269,7 +383,14 @@ void QgsConfigCache::removeChangedEntries()
     const auto entry = mProjectCache[ path ];
     if ( entry && entry->first < entry->second->lastModified() )
     {
-      removeEntry( path );
+      if ( mSettings && mSettings->projectCacheBackgroundReload() )
+      {
+        scheduleReload( path );
+      }
+      else
+      {
+        removeEntry( path );
+      }
     }
   }
 }
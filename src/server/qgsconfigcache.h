@@ -25,6 +25,8 @@
 #include <QFileSystemWatcher>
 #include <QObject>
 #include <QDomDocument>
+#include <QRecursiveMutex>
+#include <QSet>
 
 #include "qgis_server.h"
 #include "qgis_sip.h"
@@ -111,6 +113,16 @@ class SERVER_EXPORT QgsConfigCache : public QObject
      */
     const QgsProject *project( const QString &path, const QgsServerSettings *settings = nullptr );
 
+    /**
+     * Loads the projects from the given \a paths in the cache, so that the
+     * first requests do not wait for the project loading. Errors are logged.
+     * \param paths the filenames of the QGIS projects
+     * \param settings QGIS server settings
+     * \see QgsServerSettings::projectPreload()
+     * \since QGIS 3.30
+     */
+    void preloadProjects( const QStringList &paths, const QgsServerSettings *settings = nullptr );
+
     /**
      * Returns the name of the current strategy
      * \since QGIS 3.26
@@ -143,10 +155,28 @@ class SERVER_EXPORT QgsConfigCache : public QObject
 
     std::unique_ptr<QgsAbstractCacheStrategy> mStrategy;
 
+    //! Guards the caches against concurrent access from request worker threads
+    mutable QRecursiveMutex mMutex;
+
   private:
     //! Insert project in cache
     void cacheProject( const QString &path, QgsProject *project );
 
+    //! Reads a project, returns NULLPTR in case of errors
+    QgsProject *loadProject( const QString &path, const QgsServerSettings *settings );
+
+    //! Schedules a reload of a changed project, served from cache meanwhile
+    void scheduleReload( const QString &path );
+
+    //! Replaces a cached project with a newly loaded version, if it can be loaded
+    void reloadEntry( const QString &path );
+
+    //! Settings the cache was initialized with
+    const QgsServerSettings *mSettings = nullptr;
+
+    //! Projects waiting for a reload
+    QSet<QString> mPendingReloads;
+
     static QgsConfigCache *sInstance;
 
   public slots:
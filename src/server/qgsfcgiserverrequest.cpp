@@ -26,13 +26,33 @@
 #include <QDebug>
 
 QgsFcgiServerRequest::QgsFcgiServerRequest()
+{
+  init();
+}
+
+QgsFcgiServerRequest::QgsFcgiServerRequest( FCGX_Request *fcgxRequest )
+  : mFcgxRequest( fcgxRequest )
+{
+  init();
+}
+
+const char *QgsFcgiServerRequest::envParam( const char *name ) const
+{
+  if ( mFcgxRequest )
+  {
+    return FCGX_GetParam( name, mFcgxRequest->envp );
+  }
+  return getenv( name );
+}
+
+void QgsFcgiServerRequest::init()
 {
   // Get the REQUEST_URI from the environment
-  QString uri = getenv( "REQUEST_URI" );
+  QString uri = envParam( "REQUEST_URI" );
 
   if ( uri.isEmpty() )
   {
-    uri = getenv( "SCRIPT_NAME" );
+    uri = envParam( "SCRIPT_NAME" );
   }
 
   QUrl url;
@@ -41,9 +61,9 @@ QgsFcgiServerRequest::QgsFcgiServerRequest()
   // Store the URL before the server rewrite that could have been set in QUERY_STRING
   setOriginalUrl( url );
 
-  const QString qs = getenv( "QUERY_STRING" );
+  const QString qs = envParam( "QUERY_STRING" );
   const QString questionMark = qs.isEmpty() ? QString() : QChar( '?' );
-  const QString extraPath = QStringLiteral( "%1%2%3" ).arg( getenv( "PATH_INFO" ) ).arg( questionMark ).arg( qs );
+  const QString extraPath = QStringLiteral( "%1%2%3" ).arg( envParam( "PATH_INFO" ) ).arg( questionMark ).arg( qs );
 
   QUrl baseUrl;
   if ( uri.endsWith( extraPath ) )
@@ -72,7 +92,7 @@ QgsFcgiServerRequest::QgsFcgiServerRequest()
   QgsServerRequest::Method method = GetMethod;
 
   // Get method
-  const char *me = getenv( "REQUEST_METHOD" );
+  const char *me = envParam( "REQUEST_METHOD" );
 
   if ( me )
   {
@@ -113,7 +133,7 @@ QgsFcgiServerRequest::QgsFcgiServerRequest()
     const QString headerName = QgsStringUtils::capitalize(
                                  QString( headerKey ).replace( QLatin1Char( '_' ), QLatin1Char( ' ' ) ), Qgis::Capitalization::TitleCase
                                ).replace( QLatin1Char( ' ' ), QLatin1Char( '-' ) );
-    const char *result = getenv( QStringLiteral( "HTTP_%1" ).arg( headerKey ).toStdString().c_str() );
+    const char *result = envParam( QStringLiteral( "HTTP_%1" ).arg( headerKey ).toStdString().c_str() );
     if ( result && strlen( result ) > 0 )
     {
       setHeader( headerName, result );
@@ -133,13 +153,13 @@ void QgsFcgiServerRequest::fillUrl( QUrl &url ) const
   // Check if host is defined
   if ( url.host().isEmpty() )
   {
-    url.setHost( getenv( "SERVER_NAME" ) );
+    url.setHost( envParam( "SERVER_NAME" ) );
   }
 
   // Port ?
   if ( url.port( -1 ) == -1 )
   {
-    const QString portString = getenv( "SERVER_PORT" );
+    const QString portString = envParam( "SERVER_PORT" );
     if ( !portString.isEmpty() )
     {
       bool portOk;
@@ -154,7 +174,7 @@ void QgsFcgiServerRequest::fillUrl( QUrl &url ) const
   // scheme
   if ( url.scheme().isEmpty() )
   {
-    QString( getenv( "HTTPS" ) ).compare( QLatin1String( "on" ), Qt::CaseInsensitive ) == 0
+    QString( envParam( "HTTPS" ) ).compare( QLatin1String( "on" ), Qt::CaseInsensitive ) == 0
     ? url.setScheme( QStringLiteral( "https" ) )
     : url.setScheme( QStringLiteral( "http" ) );
   }
@@ -169,7 +189,7 @@ QByteArray QgsFcgiServerRequest::data() const
 void QgsFcgiServerRequest::readData()
 {
   // Check if we have CONTENT_LENGTH defined
-  const char *lengthstr = getenv( "CONTENT_LENGTH" );
+  const char *lengthstr = envParam( "CONTENT_LENGTH" );
   if ( lengthstr )
   {
     bool success = false;
@@ -178,7 +198,7 @@ void QgsFcgiServerRequest::readData()
     // normally passed by any CGI web server and it is implemented only
     // to allow unit tests to inject a request body and simulate a POST
     // request
-    const char *request_body  = getenv( "REQUEST_BODY" );
+    const char *request_body  = envParam( "REQUEST_BODY" );
     if ( success && request_body )
     {
       QString body( request_body );
@@ -191,10 +211,23 @@ void QgsFcgiServerRequest::readData()
 #endif
     if ( success )
     {
-      // XXX This not efficient at all  !!
-      for ( int i = 0; i < length; ++i )
+      if ( mFcgxRequest )
+      {
+        if ( length > 0 )
+        {
+          const int offset = mData.size();
+          mData.resize( offset + length );
+          const int read = FCGX_GetStr( mData.data() + offset, length, mFcgxRequest->in );
+          mData.resize( offset + read );
+        }
+      }
+      else
       {
-        mData.append( getchar() );
+        // XXX This not efficient at all  !!
+        for ( int i = 0; i < length; ++i )
+        {
+          mData.append( getchar() );
+        }
       }
     }
     else
@@ -248,9 +281,9 @@ void QgsFcgiServerRequest::printRequestInfos( const QUrl &url ) const
   QgsMessageLog::logMessage( QStringLiteral( "------------------------------------------------" ), QStringLiteral( "Server" ), Qgis::MessageLevel::Info );
   for ( const auto &envVar : envVars )
   {
-    if ( getenv( envVar.toStdString().c_str() ) )
+    if ( envParam( envVar.toStdString().c_str() ) )
     {
-      QgsMessageLog::logMessage( QStringLiteral( "%1: %2" ).arg( envVar ).arg( QString( getenv( envVar.toStdString().c_str() ) ) ), QStringLiteral( "Server" ), Qgis::MessageLevel::Info );
+      QgsMessageLog::logMessage( QStringLiteral( "%1: %2" ).arg( envVar ).arg( QString( envParam( envVar.toStdString().c_str() ) ) ), QStringLiteral( "Server" ), Qgis::MessageLevel::Info );
     }
   }
 
@@ -272,8 +305,8 @@ QString QgsFcgiServerRequest::header( const QString &name ) const
   // https://tools.ietf.org/html/rfc3875#section-4.1.18
   if ( result.isEmpty() )
   {
-    result = qgetenv( QStringLiteral( "HTTP_%1" ).arg(
-                        name.toUpper().replace( QLatin1Char( '-' ), QLatin1Char( '_' ) ) ).toStdString().c_str() );
+    result = envParam( QStringLiteral( "HTTP_%1" ).arg(
+                         name.toUpper().replace( QLatin1Char( '-' ), QLatin1Char( '_' ) ) ).toStdString().c_str() );
   }
   return result;
 }
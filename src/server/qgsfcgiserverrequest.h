@@ -22,6 +22,10 @@
 
 #include "qgsserverrequest.h"
 
+#ifndef SIP_RUN
+struct FCGX_Request;
+#endif
+
 
 /**
  * \ingroup server
@@ -32,8 +36,25 @@
 class SERVER_EXPORT QgsFcgiServerRequest: public QgsServerRequest
 {
   public:
+
+    /**
+     * Constructor for QgsFcgiServerRequest, reading the request from the
+     * process environment and the FCGI standard input.
+     */
     QgsFcgiServerRequest();
 
+    /**
+     * Constructor for QgsFcgiServerRequest, reading the request from
+     * the parameters and input stream of an explicitly accepted \a fcgxRequest.
+     *
+     * This is used by multi-threaded FCGI accept loops, where each thread
+     * owns its own FCGX_Request. The \a fcgxRequest must stay valid (i.e.
+     * not be finished) for the lifetime of this object.
+     *
+     * \since QGIS 3.30
+     */
+    explicit QgsFcgiServerRequest( FCGX_Request *fcgxRequest ) SIP_SKIP;
+
     QByteArray data() const override;
 
     /**
@@ -50,8 +71,13 @@ class SERVER_EXPORT QgsFcgiServerRequest: public QgsServerRequest
     QString header( const QString &name ) const override;
 
   private:
+    void init();
     void readData();
 
+    // Returns the value of a CGI environment variable, either from the
+    // explicit FCGX request or from the process environment
+    const char *envParam( const char *name ) const;
+
     // Log request info: print debug infos
     // about the request
     void printRequestInfos( const QUrl &url ) const;
@@ -62,6 +88,7 @@ class SERVER_EXPORT QgsFcgiServerRequest: public QgsServerRequest
 
     QByteArray mData;
     bool       mHasError = false;
+    FCGX_Request *mFcgxRequest = nullptr;
 };
 
 #endif
@@ -23,17 +23,94 @@
 #include <fcgi_stdio.h>
 #include <QDebug>
 
+#include <zlib.h>
+
+///@cond PRIVATE
+
+//! Returns TRUE if the body of a response with the \a contentType is worth compressing
+static bool isCompressibleContentType( const QString &contentType )
+{
+  // images and archives are already compressed
+  const QString type = contentType.trimmed().toLower();
+  return type.startsWith( QLatin1String( "text/" ) )
+         || type.contains( QLatin1String( "xml" ) )
+         || type.contains( QLatin1String( "json" ) )
+         || type.contains( QLatin1String( "javascript" ) )
+         || type.contains( QLatin1String( "gml" ) );
+}
+
+/**
+ * Incremental gzip compression of the body of a response.
+ */
+class QgsFcgiServerResponse::GzipStream
+{
+  public:
+
+    GzipStream()
+    {
+      mStream.zalloc = Z_NULL;
+      mStream.zfree = Z_NULL;
+      mStream.opaque = Z_NULL;
+      // 16 added to the window bits selects the gzip format
+      mValid = deflateInit2( &mStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY ) == Z_OK;
+    }
+
+    ~GzipStream()
+    {
+      if ( mValid )
+        deflateEnd( &mStream );
+    }
+
+    GzipStream( const GzipStream & ) = delete;
+    GzipStream &operator=( const GzipStream & ) = delete;
+
+    bool isValid() const { return mValid; }
+
+    /**
+     * Compresses \a data, the output is flushed so the client can decode everything
+     * sent so far. The stream is terminated if \a finish is TRUE.
+     */
+    QByteArray compress( const QByteArray &data, bool finish )
+    {
+      QByteArray result;
+      mStream.next_in = reinterpret_cast< Bytef * >( const_cast< char * >( data.constData() ) );
+      mStream.avail_in = static_cast< uInt >( data.size() );
+
+      char chunk[16384];
+      do
+      {
+        mStream.next_out = reinterpret_cast< Bytef * >( chunk );
+        mStream.avail_out = sizeof( chunk );
+        deflate( &mStream, finish ? Z_FINISH : Z_SYNC_FLUSH );
+        result.append( chunk, static_cast< int >( sizeof( chunk ) - mStream.avail_out ) );
+      }
+      while ( mStream.avail_out == 0 );
+
+      return result;
+    }
+
+  private:
+    z_stream mStream;
+    bool mValid = false;
+};
+
+///@endcond
+
 //
 // QgsFcgiServerResponse
 //
 
-QgsFcgiServerResponse::QgsFcgiServerResponse( QgsServerRequest::Method method )
+QgsFcgiServerResponse::QgsFcgiServerResponse( QgsServerRequest::Method method, FCGX_Request *fcgxRequest )
   : mMethod( method )
+  , mFcgxRequest( fcgxRequest )
+  , mFeedback( new QgsFeedback )
 {
   mBuffer.open( QIODevice::ReadWrite );
   setDefaultHeaders();
 }
 
+QgsFcgiServerResponse::~QgsFcgiServerResponse() = default;
+
 void QgsFcgiServerResponse::removeHeader( const QString &key )
 {
   mHeaders.remove( key );
@@ -97,27 +174,35 @@ void QgsFcgiServerResponse::finish()
       mHeaders.insert( QStringLiteral( "Content-Length" ), QString::number( mBuffer.pos() ) );
     }
   }
-  flush();
+  sendBuffer( true );
   mFinished = true;
 }
 
 void QgsFcgiServerResponse::flush()
 {
-  if ( ! mHeadersSent )
+  sendBuffer( false );
+}
+
+void QgsFcgiServerResponse::sendBuffer( bool finishing )
+{
+  if ( ! mHeadersSent && mCompressionEnabled && mMethod != QgsServerRequest::HeadMethod
+       && isCompressibleContentType( header( QStringLiteral( "Content-Type" ) ) ) )
   {
-    // Send all headers
-    QMap<QString, QString>::const_iterator it;
-    for ( it = mHeaders.constBegin(); it != mHeaders.constEnd(); ++it )
+    mGzipStream = std::make_unique< GzipStream >();
+    if ( mGzipStream->isValid() )
     {
-      fputs( it.key().toUtf8(), FCGI_stdout );
-      fputs( ": ", FCGI_stdout );
-      fputs( it.value().toUtf8(), FCGI_stdout );
-      fputs( "\n", FCGI_stdout );
+      mHeaders.insert( QStringLiteral( "Content-Encoding" ), QStringLiteral( "gzip" ) );
+      mHeaders.insert( QStringLiteral( "Vary" ), QStringLiteral( "Accept-Encoding" ) );
+      // the length is only known if the whole body is compressed at once
+      mHeaders.remove( QStringLiteral( "Content-Length" ) );
+    }
+    else
+    {
+      mGzipStream.reset();
     }
-    fputs( "\n", FCGI_stdout );
-    mHeadersSent = true;
   }
 
+  QByteArray body;
   mBuffer.seek( 0 );
   if ( mMethod == QgsServerRequest::HeadMethod )
   {
@@ -125,14 +210,44 @@ void QgsFcgiServerResponse::flush()
     // write headers for HEAD requests
     mBuffer.buffer().clear();
   }
+  else if ( mGzipStream && ( finishing || mBuffer.bytesAvailable() > 0 ) )
+  {
+    body = mGzipStream->compress( mBuffer.buffer(), finishing );
+    mBuffer.buffer().clear();
+    if ( finishing && ! mHeadersSent )
+      mHeaders.insert( QStringLiteral( "Content-Length" ), QString::number( body.size() ) );
+  }
+
+  if ( ! mHeadersSent )
+  {
+    // Send all headers
+    QMap<QString, QString>::const_iterator it;
+    QByteArray headers;
+    for ( it = mHeaders.constBegin(); it != mHeaders.constEnd(); ++it )
+    {
+      headers.append( it.key().toUtf8() );
+      headers.append( ": " );
+      headers.append( it.value().toUtf8() );
+      headers.append( "\n" );
+    }
+    headers.append( "\n" );
+    writeRaw( headers.constData(), headers.size() );
+    mHeadersSent = true;
+  }
+
+  if ( mGzipStream )
+  {
+    writeRaw( body.constData(), body.size() );
+#ifdef QGISDEBUG
+    qDebug() << QStringLiteral( "Sent %1 compressed bytes" ).arg( body.size() );
+#endif
+  }
   else if ( mBuffer.bytesAvailable() > 0 )
   {
     QByteArray &ba = mBuffer.buffer();
-    const size_t count   = fwrite( ( void * )ba.data(), ba.size(), 1, FCGI_stdout );
+    writeRaw( ba.constData(), ba.size() );
 #ifdef QGISDEBUG
-    qDebug() << QStringLiteral( "Sent %1 blocks of %2 bytes" ).arg( count ).arg( ba.size() );
-#else
-    Q_UNUSED( count )
+    qDebug() << QStringLiteral( "Sent %1 bytes" ).arg( ba.size() );
 #endif
     // Reset the internal buffer
     ba.clear();
@@ -140,6 +255,29 @@ void QgsFcgiServerResponse::flush()
 }
 
 
+void QgsFcgiServerResponse::writeRaw( const char *data, int size )
+{
+  // Do not keep on writing to a broken connection
+  if ( size <= 0 || mFeedback->isCanceled() )
+    return;
+
+  bool ok = true;
+  if ( mFcgxRequest )
+  {
+    ok = FCGX_PutStr( data, size, mFcgxRequest->out ) == size;
+  }
+  else
+  {
+    ok = fwrite( ( void * )data, size, 1, FCGI_stdout ) == 1;
+  }
+
+  if ( !ok )
+  {
+    QgsMessageLog::logMessage( QStringLiteral( "Error writing response, the client has probably disconnected" ), QStringLiteral( "Server" ), Qgis::MessageLevel::Warning );
+    mFeedback->cancel();
+  }
+}
+
 void QgsFcgiServerResponse::clear()
 {
   mHeaders.clear();
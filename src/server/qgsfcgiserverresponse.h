@@ -24,9 +24,12 @@
 
 #include "qgsserverrequest.h"
 #include "qgsserverresponse.h"
+#include "qgsfeedback.h"
 
 #include <QBuffer>
 
+struct FCGX_Request;
+
 /**
  * \ingroup server
  * \class QgsFcgiServerResponse
@@ -40,8 +43,12 @@ class SERVER_EXPORT QgsFcgiServerResponse: public QgsServerResponse
     /**
      * Constructor for QgsFcgiServerResponse.
      * \param method The HTTP method (Get by default)
+     * \param fcgxRequest optional explicitly accepted FCGX request to write the
+     * response to, if not set the response is written to the FCGI standard output (since QGIS 3.30)
      */
-    QgsFcgiServerResponse( QgsServerRequest::Method method = QgsServerRequest::GetMethod );
+    QgsFcgiServerResponse( QgsServerRequest::Method method = QgsServerRequest::GetMethod, FCGX_Request *fcgxRequest = nullptr );
+
+    ~QgsFcgiServerResponse() override;
 
     void setHeader( const QString &key, const QString &value ) override;
 
@@ -71,18 +78,48 @@ class SERVER_EXPORT QgsFcgiServerResponse: public QgsServerResponse
 
     void truncate() override;
 
+    /**
+     * Returns the feedback object, canceled as soon as writing to the
+     * FCGI output stream fails, i.e. when the client has disconnected.
+     *
+     * \since QGIS 3.30
+     */
+    QgsFeedback *feedback() const override { return mFeedback.get(); }
+
     /**
      * Set the default headers
      */
     void setDefaultHeaders();
 
+    /**
+     * Sets whether the body of text responses (XML, JSON, HTML...) is compressed with gzip.
+     *
+     * This must only be enabled if the client accepts the gzip encoding. The body is
+     * compressed each time the response is flushed, so streamed responses are compressed too.
+     *
+     * \since QGIS 3.30
+     */
+    void setCompressionEnabled( bool enabled ) { mCompressionEnabled = enabled; }
+
   private:
+    class GzipStream;
+
     QMap<QString, QString> mHeaders;
     QBuffer mBuffer;
     bool mFinished    = false;
     bool mHeadersSent = false;
     QgsServerRequest::Method mMethod;
     int mStatusCode = 0;
+    FCGX_Request *mFcgxRequest = nullptr;
+    std::unique_ptr<QgsFeedback> mFeedback;
+    bool mCompressionEnabled = false;
+    std::unique_ptr<GzipStream> mGzipStream;
+
+    // Writes raw bytes to the FCGX request output stream or the FCGI standard output
+    void writeRaw( const char *data, int size );
+
+    // Sends the headers if needed and the buffered body, the compressed body is terminated when finishing
+    void sendBuffer( bool finishing );
 };
 
 #endif
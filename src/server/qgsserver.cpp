@@ -46,6 +46,10 @@
 #include <QNetworkDiskCache>
 #include <QSettings>
 #include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
 
 // TODO: remove, it's only needed by a single debug message
 #include <fcgi_stdio.h>
@@ -66,6 +70,65 @@ QgsServiceRegistry *QgsServer::sServiceRegistry = nullptr;
 
 Q_GLOBAL_STATIC( QgsServerSettings, sSettings );
 
+namespace
+{
+  // Returns the index of the most recent top level "server" profile event with the given name
+  QModelIndex serverProfileIndex( const QString &name )
+  {
+    QgsRuntimeProfiler *profiler = QgsApplication::profiler();
+    for ( int row = profiler->rowCount() - 1; row >= 0; row-- )
+    {
+      const QModelIndex idx = profiler->index( row, 0 );
+      if ( profiler->data( idx, QgsRuntimeProfilerNode::Roles::Group ).toString() == QLatin1String( "server" )
+           && profiler->data( idx, QgsRuntimeProfilerNode::Roles::Name ).toString() == name )
+        return idx;
+    }
+    return QModelIndex();
+  }
+
+  // Appends one Server-Timing metric for each descendant of the profile event at parent
+  void serverTimingMetrics( const QModelIndex &parent, const QString &prefix, QStringList &metrics )
+  {
+    QgsRuntimeProfiler *profiler = QgsApplication::profiler();
+    for ( int row = 0; row < profiler->rowCount( parent ); row++ )
+    {
+      const QModelIndex idx = profiler->index( row, 0, parent );
+      const QString name = profiler->data( idx, QgsRuntimeProfilerNode::Roles::Name ).toString();
+
+      // metric names are HTTP tokens, the description is a quoted string
+      QString token = name.toLower();
+      token.replace( QRegularExpression( QStringLiteral( "[^a-z0-9]+" ) ), QStringLiteral( "-" ) );
+      token = prefix + token;
+      QString description = name;
+      description.replace( '\\', QLatin1String( "\\\\" ) ).replace( '"', QLatin1String( "\\\"" ) );
+
+      metrics << QStringLiteral( "%1;desc=\"%2\";dur=%3" )
+              .arg( token, description, QString::number( profiler->data( idx, QgsRuntimeProfilerNode::Roles::Elapsed ).toDouble() * 1000.0, 'f', 1 ) );
+
+      serverTimingMetrics( idx, token + '.', metrics );
+    }
+  }
+
+  // Returns the profile event at idx and its descendants as a JSON object
+  QJsonObject profileToJson( const QModelIndex &idx )
+  {
+    QgsRuntimeProfiler *profiler = QgsApplication::profiler();
+    QJsonObject event;
+    event.insert( QStringLiteral( "name" ), profiler->data( idx, QgsRuntimeProfilerNode::Roles::Name ).toString() );
+    event.insert( QStringLiteral( "elapsed_ms" ), profiler->data( idx, QgsRuntimeProfilerNode::Roles::Elapsed ).toDouble() * 1000.0 );
+
+    QJsonArray children;
+    for ( int row = 0; row < profiler->rowCount( idx ); row++ )
+    {
+      children.append( profileToJson( profiler->index( row, 0, idx ) ) );
+    }
+    if ( !children.isEmpty() )
+      event.insert( QStringLiteral( "children" ), children );
+
+    return event;
+  }
+}
+
 QgsServer::QgsServer()
 {
   // QgsApplication must exist
@@ -368,6 +431,9 @@ bool QgsServer::init()
   // Initialize config cache
   QgsConfigCache::initialize( sSettings );
 
+  // Warm-up the config cache
+  QgsConfigCache::instance()->preloadProjects( sSettings()->projectPreload(), sSettings() );
+
   sInitialized = true;
   QgsMessageLog::logMessage( QStringLiteral( "Server initialized" ), QStringLiteral( "Server" ), Qgis::MessageLevel::Info );
   return true;
@@ -474,6 +540,7 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
           if ( ! configFilePath.isEmpty() )
           {
             // Note that  QgsConfigCache::project( ... ) call QgsProject::setInstance(...)
+            const QgsScopedRuntimeProfile projectProfile { QStringLiteral( "Project loading" ), QStringLiteral( "server" ) };
             project = mConfigCache->project( configFilePath, sServerInterface->serverSettings() );
           }
         }
@@ -501,6 +568,7 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
         if ( params.service().isEmpty() && ( api = sServiceRegistry->apiForRequest( request ) ) )
         {
           const QgsServerApiContext context { api->rootPath(), &request, &responseDecorator, project, sServerInterface };
+          const QgsScopedRuntimeProfile apiProfile { api->name(), QStringLiteral( "server" ) };
           api->executeRequest( context );
         }
         else
@@ -521,6 +589,7 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
           QgsService *service = sServiceRegistry->getService( params.service(), params.version() );
           if ( service )
           {
+            const QgsScopedRuntimeProfile serviceProfile { QStringLiteral( "%1 %2" ).arg( service->name(), params.request() ), QStringLiteral( "server" ) };
             service->executeRequest( request, responseDecorator, project );
           }
           else
@@ -544,6 +613,16 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
       }
     }
 
+    // Report the duration of the processing steps, as long as the headers
+    // have not been flushed yet by a streamed response
+    if ( sSettings->serverTimingHeader() && !response.headersSent() )
+    {
+      QStringList metrics;
+      serverTimingMetrics( serverProfileIndex( QStringLiteral( "handleRequest" ) ), QString(), metrics );
+      if ( !metrics.isEmpty() )
+        response.setHeader( QStringLiteral( "Server-Timing" ), metrics.join( QLatin1String( ", " ) ) );
+    }
+
     // Terminate the response
     // This may also throw exceptions if there are errors in python plugins code
     try
@@ -589,6 +668,14 @@ void QgsServer::handleRequest( QgsServerRequest &request, QgsServerResponse &res
         const auto idx { QgsApplication::profiler()->index( row, 0 ) };
         profileFormatter( idx, 0 );
       }
+
+      // Same profile as a single machine readable line
+      const QModelIndex requestIdx = serverProfileIndex( QStringLiteral( "handleRequest" ) );
+      if ( requestIdx.isValid() )
+      {
+        const QJsonDocument profile( profileToJson( requestIdx ) );
+        QgsMessageLog::logMessage( QStringLiteral( "Profile JSON: %1" ).arg( QString::fromUtf8( profile.toJson( QJsonDocument::Compact ) ) ), QStringLiteral( "Server" ), Qgis::MessageLevel::Info );
+      }
     }
   }
 
@@ -20,6 +20,7 @@
 #include "qgsserverresponse.h"
 #include "qgsmessagelog.h"
 #include "qgsserverexception.h"
+#include "qgsfeedback.h"
 
 
 void QgsServerResponse::write( const QString &data )
@@ -96,3 +97,8 @@ void QgsServerResponse::write( const QgsServerException &ex )
   setHeader( "Content-Type", responseFormat );
   write( ba );
 }
+
+QgsFeedback *QgsServerResponse::feedback() const
+{
+  return nullptr;
+}
@@ -27,6 +27,7 @@
 #include <QIODevice>
 
 class QgsServerException;
+class QgsFeedback;
 
 /**
  * \ingroup server
@@ -195,6 +196,18 @@ class SERVER_EXPORT QgsServerResponse
      * Clear internal buffer
      */
     virtual void truncate() = 0;
+
+    /**
+     * Returns the feedback object, canceled when the response cannot be
+     * delivered anymore (e.g. when the client has disconnected).
+     *
+     * Services producing long streamed responses should check it to stop
+     * computing content nobody will read. The default implementation
+     * returns NULLPTR.
+     *
+     * \since QGIS 3.30
+     */
+    virtual QgsFeedback *feedback() const;
 };
 
 #endif
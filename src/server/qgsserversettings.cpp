@@ -389,6 +389,105 @@ void QgsServerSettings::initSettings()
                                    };
   mSettings[ sApplicationName.envVar ] = sApplicationName;
 
+  // number of FCGI accept worker threads
+  const Setting sFcgiWorkers = { QgsServerSettingsEnv::QGIS_SERVER_FCGI_WORKERS,
+                                 QgsServerSettingsEnv::DEFAULT_VALUE,
+                                 QStringLiteral( "Number of threads accepting FastCGI requests, 0 disables the worker pool" ),
+                                 QStringLiteral( "/qgis/server_fcgi_workers" ),
+                                 QVariant::Int,
+                                 QVariant( 0 ),
+                                 QVariant()
+                               };
+  mSettings[ sFcgiWorkers.envVar ] = sFcgiWorkers;
+
+  // WMTS tile cache size
+  const Setting sWmtsTileCacheSize = { QgsServerSettingsEnv::QGIS_SERVER_WMTS_TILE_CACHE_SIZE,
+                                       QgsServerSettingsEnv::DEFAULT_VALUE,
+                                       QStringLiteral( "Size in bytes of the WMTS tile memory cache, 0 disables the cache" ),
+                                       QStringLiteral( "/qgis/server_wmts_tile_cache_size" ),
+                                       QVariant::LongLong,
+                                       QVariant( 0 ),
+                                       QVariant()
+                                     };
+  mSettings[ sWmtsTileCacheSize.envVar ] = sWmtsTileCacheSize;
+
+  // WMTS metatile size
+  const Setting sWmtsMetatileSize = { QgsServerSettingsEnv::QGIS_SERVER_WMTS_METATILE_SIZE,
+                                      QgsServerSettingsEnv::DEFAULT_VALUE,
+                                      QStringLiteral( "Number of tiles per side of the metatiles rendered by WMTS GetTile" ),
+                                      QStringLiteral( "/qgis/server_wmts_metatile_size" ),
+                                      QVariant::Int,
+                                      QVariant( 1 ),
+                                      QVariant()
+                                    };
+  mSettings[ sWmtsMetatileSize.envVar ] = sWmtsMetatileSize;
+
+  // Server-Timing header
+  const Setting sServerTimingHeader = { QgsServerSettingsEnv::QGIS_SERVER_TIMING_HEADER,
+                                        QgsServerSettingsEnv::DEFAULT_VALUE,
+                                        QStringLiteral( "Add a Server-Timing header with the duration of the processing steps to the responses" ),
+                                        QStringLiteral( "/qgis/server_timing_header" ),
+                                        QVariant::Bool,
+                                        QVariant( false ),
+                                        QVariant()
+                                      };
+  mSettings[ sServerTimingHeader.envVar ] = sServerTimingHeader;
+
+  // WMS PNG compression level
+  const Setting sWmsPngCompressionLevel = { QgsServerSettingsEnv::QGIS_SERVER_WMS_PNG_COMPRESSION_LEVEL,
+                                            QgsServerSettingsEnv::DEFAULT_VALUE,
+                                            QStringLiteral( "The zlib compression level (0-9) of the PNG images written by WMS, -1 for the default level" ),
+                                            QStringLiteral( "/qgis/server_wms_png_compression_level" ),
+                                            QVariant::Int,
+                                            QVariant( -1 ),
+                                            QVariant()
+                                          };
+  mSettings[ sWmsPngCompressionLevel.envVar ] = sWmsPngCompressionLevel;
+
+  // projects loaded when the server starts
+  const Setting sProjectPreload = { QgsServerSettingsEnv::QGIS_SERVER_PROJECT_PRELOAD,
+                                    QgsServerSettingsEnv::DEFAULT_VALUE,
+                                    QStringLiteral( "List of comma separated project files loaded in the project cache when the server starts" ),
+                                    QStringLiteral( "/qgis/server_project_preload" ),
+                                    QVariant::String,
+                                    QVariant( "" ),
+                                    QVariant()
+                                  };
+  mSettings[ sProjectPreload.envVar ] = sProjectPreload;
+
+  // reload changed projects outside of the requests
+  const Setting sProjectCacheBackgroundReload = { QgsServerSettingsEnv::QGIS_SERVER_PROJECT_CACHE_BACKGROUND_RELOAD,
+                                                  QgsServerSettingsEnv::DEFAULT_VALUE,
+                                                  QStringLiteral( "Reload changed projects outside of the requests and keep serving the cached version meanwhile" ),
+                                                  QStringLiteral( "/qgis/server_project_cache_background_reload" ),
+                                                  QVariant::Bool,
+                                                  QVariant( false ),
+                                                  QVariant()
+                                                };
+  mSettings[ sProjectCacheBackgroundReload.envVar ] = sProjectCacheBackgroundReload;
+
+  // binary cache of the project documents
+  const Setting sProjectDocumentCacheDirectory = { QgsServerSettingsEnv::QGIS_SERVER_PROJECT_DOCUMENT_CACHE_DIRECTORY,
+                                                   QgsServerSettingsEnv::DEFAULT_VALUE,
+                                                   QStringLiteral( "Directory of the binary cache of parsed project documents" ),
+                                                   QStringLiteral( "/qgis/server_project_document_cache_directory" ),
+                                                   QVariant::String,
+                                                   QVariant( "" ),
+                                                   QVariant()
+                                                 };
+  mSettings[ sProjectDocumentCacheDirectory.envVar ] = sProjectDocumentCacheDirectory;
+
+  // gzip compression of the responses
+  const Setting sCompressResponses = { QgsServerSettingsEnv::QGIS_SERVER_COMPRESS_RESPONSES,
+                                       QgsServerSettingsEnv::DEFAULT_VALUE,
+                                       QStringLiteral( "Compress the text responses with gzip when the client accepts it" ),
+                                       QStringLiteral( "/qgis/server_compress_responses" ),
+                                       QVariant::Bool,
+                                       QVariant( false ),
+                                       QVariant()
+                                     };
+  mSettings[ sCompressResponses.envVar ] = sCompressResponses;
+
 }
 
 void QgsServerSettings::load()
@@ -709,3 +808,53 @@ QString QgsServerSettings::applicationName() const
 {
   return value( QgsServerSettingsEnv::QGIS_SERVER_APPLICATION_NAME ).toString().trimmed();
 }
+
+int QgsServerSettings::fcgiWorkers() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_FCGI_WORKERS ).toInt();
+}
+
+qint64 QgsServerSettings::wmtsTileCacheSize() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_WMTS_TILE_CACHE_SIZE ).toLongLong();
+}
+
+int QgsServerSettings::wmtsMetatileSize() const
+{
+  return std::max( 1, value( QgsServerSettingsEnv::QGIS_SERVER_WMTS_METATILE_SIZE ).toInt() );
+}
+
+bool QgsServerSettings::serverTimingHeader() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_TIMING_HEADER, false ).toBool();
+}
+
+int QgsServerSettings::wmsPngCompressionLevel() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_WMS_PNG_COMPRESSION_LEVEL ).toInt();
+}
+
+QStringList QgsServerSettings::projectPreload() const
+{
+  const QString strVal { value( QgsServerSettingsEnv::QGIS_SERVER_PROJECT_PRELOAD ).toString().trimmed() };
+  if ( strVal.isEmpty() )
+  {
+    return QStringList();
+  }
+  return strVal.split( ',' );
+}
+
+bool QgsServerSettings::projectCacheBackgroundReload() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_PROJECT_CACHE_BACKGROUND_RELOAD, false ).toBool();
+}
+
+QString QgsServerSettings::projectDocumentCacheDirectory() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_PROJECT_DOCUMENT_CACHE_DIRECTORY ).toString();
+}
+
+bool QgsServerSettings::compressResponses() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_COMPRESS_RESPONSES ).toBool();
+}
@@ -82,6 +82,15 @@ class SERVER_EXPORT QgsServerSettingsEnv : public QObject
       QGIS_SERVER_PROJECT_CACHE_STRATEGY, //! Set the project cache strategy. Possible values are 'filesystem', 'periodic' or 'off' (since QGIS 3.26).
       QGIS_SERVER_ALLOWED_EXTRA_SQL_TOKENS, //! Adds these tokens to the list of allowed tokens that the services accept when filtering features (since QGIS 3.28).
       QGIS_SERVER_APPLICATION_NAME, //! Define the QGIS Server application name (since QGIS 3.30).
+      QGIS_SERVER_FCGI_WORKERS, //! Number of threads accepting FastCGI requests concurrently, 0 keeps the legacy single accept loop (since QGIS 3.30).
+      QGIS_SERVER_WMTS_TILE_CACHE_SIZE, //! Size in bytes of the built-in WMTS tile memory cache, 0 disables the cache (since QGIS 3.30).
+      QGIS_SERVER_WMTS_METATILE_SIZE, //! Number of tiles per side of the metatiles rendered by WMTS GetTile when the tile cache is enabled (since QGIS 3.30).
+      QGIS_SERVER_TIMING_HEADER, //! Adds a Server-Timing header with the duration of the processing steps to the responses (since QGIS 3.30).
+      QGIS_SERVER_WMS_PNG_COMPRESSION_LEVEL, //! Sets the zlib compression level (0-9) of the PNG images written by WMS, default is -1 which uses the zlib default level (since QGIS 3.30).
+      QGIS_SERVER_PROJECT_PRELOAD, //! Comma separated list of projects loaded in the project cache when the server starts (since QGIS 3.30).
+      QGIS_SERVER_PROJECT_CACHE_BACKGROUND_RELOAD, //! Reloads changed projects outside of the requests and keeps serving the cached version until the reload succeeds (since QGIS 3.30).
+      QGIS_SERVER_PROJECT_DOCUMENT_CACHE_DIRECTORY, //! Directory of the binary cache of parsed project documents, used to skip the parsing of unchanged project files. The cache is disabled by default (since QGIS 3.30).
+      QGIS_SERVER_COMPRESS_RESPONSES, //! Compresses the text responses (XML, JSON, HTML...) of the FastCGI server with gzip when the client accepts it, defaults to FALSE (since QGIS 3.30).
     };
     Q_ENUM( EnvVar )
 };
@@ -350,6 +359,113 @@ class SERVER_EXPORT QgsServerSettings
      */
     QString applicationName() const;
 
+    /**
+     * Returns the number of worker threads used by the FastCGI binary to
+     * accept and read incoming requests.
+     *
+     * The default value is 0, meaning that requests are accepted by the
+     * legacy single-threaded loop. The value can be changed by setting the
+     * environment variable QGIS_SERVER_FCGI_WORKERS.
+     *
+     * \note request handling itself is still serialized on the main thread.
+     * \since QGIS 3.30
+     */
+    int fcgiWorkers() const;
+
+    /**
+     * Returns the size in bytes of the built-in WMTS tile memory cache.
+     *
+     * The default value is 0, meaning that the built-in cache is disabled and
+     * only cache plugins are used. The value can be changed by setting the
+     * environment variable QGIS_SERVER_WMTS_TILE_CACHE_SIZE.
+     *
+     * \since QGIS 3.30
+     */
+    qint64 wmtsTileCacheSize() const;
+
+    /**
+     * Returns the number of tiles per side of the metatiles rendered by
+     * WMTS GetTile requests when the built-in tile cache is enabled.
+     *
+     * A metatile is rendered with a single WMS GetMap request and sliced into
+     * tiles, so labels crossing tile boundaries are placed only once. The
+     * default value is 1 (no metatiling), the value can be changed by setting
+     * the environment variable QGIS_SERVER_WMTS_METATILE_SIZE.
+     *
+     * \see wmtsTileCacheSize()
+     * \since QGIS 3.30
+     */
+    int wmtsMetatileSize() const;
+
+    /**
+     * Returns TRUE if a Server-Timing HTTP header reporting the duration of
+     * the main processing steps of the request (project loading, layers
+     * rendering, image encoding, ...) should be added to the responses.
+     * The default value is FALSE, the value can be changed by setting the
+     * environment variable QGIS_SERVER_TIMING_HEADER.
+     *
+     * \since QGIS 3.30
+     */
+    bool serverTimingHeader() const;
+
+    /**
+     * Returns the zlib compression level (0 to 9) used to encode the PNG
+     * images returned by the WMS service. Lower levels encode faster at the
+     * cost of larger images. The default value is -1, which uses the zlib
+     * default level, the value can be changed by setting the environment
+     * variable QGIS_SERVER_WMS_PNG_COMPRESSION_LEVEL.
+     *
+     * \since QGIS 3.30
+     */
+    int wmsPngCompressionLevel() const;
+
+    /**
+     * Returns the list of projects loaded in the project cache when the
+     * server starts, so that the first requests do not wait for the project
+     * loading. The default value is an empty list, the value can be changed by
+     * setting the environment variable QGIS_SERVER_PROJECT_PRELOAD to a comma
+     * separated list of project files.
+     *
+     * \since QGIS 3.30
+     */
+    QStringList projectPreload() const;
+
+    /**
+     * Returns TRUE if projects changed on disk are reloaded by the project
+     * cache outside of the requests, the cached version being served until
+     * the new version is successfully loaded. Otherwise, changed projects are
+     * removed from the cache and loaded again by the next request.
+     * The default value is FALSE, the value can be changed by setting the
+     * environment variable QGIS_SERVER_PROJECT_CACHE_BACKGROUND_RELOAD.
+     *
+     * \since QGIS 3.30
+     */
+    bool projectCacheBackgroundReload() const;
+
+    /**
+     * Returns the directory of the binary cache of parsed project documents,
+     * used by the project cache to avoid parsing unchanged project files again
+     * when they are loaded, e.g. when the server restarts.
+     * The default value is an empty string, which disables the cache, the value can
+     * be changed by setting the environment variable QGIS_SERVER_PROJECT_DOCUMENT_CACHE_DIRECTORY.
+     *
+     * \see QgsProject::setDocumentCacheDirectory()
+     * \since QGIS 3.30
+     */
+    QString projectDocumentCacheDirectory() const;
+
+    /**
+     * Returns TRUE if the text responses of the FastCGI server, such as XML,
+     * JSON or HTML documents, are compressed with gzip for the clients sending
+     * an Accept-Encoding header which includes gzip. The body is compressed
+     * while it is written, so streamed responses are compressed too.
+     * The default value is FALSE, the value can be changed by setting the
+     * environment variable QGIS_SERVER_COMPRESS_RESPONSES.
+     *
+     * \since QGIS 3.30
+     */
+    bool compressResponses() const;
+
     /**
      * Returns the string representation of a setting.
      * \since QGIS 3.16
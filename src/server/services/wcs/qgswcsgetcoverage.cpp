@@ -34,6 +34,13 @@
 namespace QgsWcs
 {
 
+  ///@cond PRIVATE
+
+  //! Size of the chunks of the coverage file sent to the client
+  constexpr qint64 COVERAGE_CHUNK_SIZE = 1024 * 1024;
+
+  ///@endcond
+
   /**
    * Output WCS DescribeCoverage response
    */
@@ -42,11 +49,30 @@ namespace QgsWcs
   {
     Q_UNUSED( version )
 
-    response.write( getCoverageData( serverIface, project, request ) );
+    QTemporaryFile tempFile;
+    tempFile.open();
+    writeCoverageFile( serverIface, project, request, tempFile.fileName() );
+
+    // the coverage is sent in chunks, so large coverages are never held in memory
     response.setHeader( "Content-Type", "image/tiff" );
+    tempFile.seek( 0 );
+    while ( !tempFile.atEnd() )
+    {
+      response.write( tempFile.read( COVERAGE_CHUNK_SIZE ) );
+      response.flush();
+    }
   }
 
   QByteArray getCoverageData( QgsServerInterface *serverIface, const QgsProject *project, const QgsServerRequest &request )
+  {
+    QTemporaryFile tempFile;
+    tempFile.open();
+    writeCoverageFile( serverIface, project, request, tempFile.fileName() );
+    tempFile.seek( 0 );
+    return tempFile.readAll();
+  }
+
+  void writeCoverageFile( QgsServerInterface *serverIface, const QgsProject *project, const QgsServerRequest &request, const QString &fileName )
   {
     const QgsServerRequest::Parameters parameters = request.parameters();
 
@@ -186,9 +212,7 @@ namespace QgsWcs
       }
     }
 
-    QTemporaryFile tempFile;
-    tempFile.open();
-    QgsRasterFileWriter fileWriter( tempFile.fileName() );
+    QgsRasterFileWriter fileWriter( fileName );
 
     // clone pipe/provider
     QgsRasterPipe pipe;
@@ -213,7 +237,6 @@ namespace QgsWcs
     {
       throw QgsRequestNotWellFormedException( QStringLiteral( "Cannot write raster error code: %1" ).arg( err ) );
     }
-    return tempFile.readAll();
   }
 
 } // namespace QgsWcs
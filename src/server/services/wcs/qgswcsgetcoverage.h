@@ -35,6 +35,12 @@ namespace QgsWcs
    */
   QByteArray getCoverageData( QgsServerInterface *serverIface, const QgsProject *project, const QgsServerRequest &request );
 
+  /**
+   * Writes the coverage data to a GeoTIFF file
+   * \since QGIS 3.30
+   */
+  void writeCoverageFile( QgsServerInterface *serverIface, const QgsProject *project, const QgsServerRequest &request, const QString &fileName );
+
 } // namespace QgsWcs
 
 #endif
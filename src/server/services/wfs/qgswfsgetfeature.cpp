@@ -36,6 +36,7 @@
 #include "qgsjsonutils.h"
 #include "qgsexpressioncontextutils.h"
 #include "qgswkbtypes.h"
+#include "qgsfeedback.h"
 
 #include "qgswfsgetfeature.h"
 
@@ -212,8 +213,10 @@ namespace QgsWfs
     long iteratedFeatures = 0;
     // sent features
     QgsFeature feature;
+    // canceled by the response when the client disconnects
+    QgsFeedback *feedback = response.feedback();
     qIt = aRequest.queries.begin();
-    for ( ; qIt != aRequest.queries.end(); ++qIt )
+    for ( ; qIt != aRequest.queries.end() && !( feedback && feedback->isCanceled() ); ++qIt )
     {
       getFeatureQuery &query = *qIt;
       QString typeName = query.typeName;
@@ -422,6 +425,7 @@ namespace QgsWfs
       }
 
       // Iterate through features
+      featureRequest.setFeedback( feedback );
       QgsFeatureIterator fit = vlayer->getFeatures( featureRequest );
 
       if ( mWfsParameters.resultType() == QgsWfsParameters::ResultType::HITS )
@@ -466,6 +470,10 @@ namespace QgsWfs
             ++sentFeatures;
           }
           ++iteratedFeatures;
+
+          // Stop iterating when the response cannot be delivered anymore
+          if ( feedback && feedback->isCanceled() )
+            break;
         }
       }
     }
@@ -409,6 +409,59 @@ namespace QgsWfs
       QMap<QString, int>::const_iterator fieldMapIt;
       QString fieldName;
       bool conversionSuccess;
+
+      // the same values are set on all the features, they are converted once
+      QgsAttributeMap newValues;
+      QString valuesError;
+      QMap< QString, QString >::const_iterator it = propertyMap.constBegin();
+      for ( ; it != propertyMap.constEnd(); ++it )
+      {
+        fieldName = it.key();
+        fieldMapIt = fieldMap.find( fieldName );
+        if ( fieldMapIt == fieldMap.constEnd() )
+        {
+          continue;
+        }
+        QgsField field = fields.at( fieldMapIt.value() );
+        QVariant value = it.value();
+        if ( QgsVariantUtils::isNull( value ) )
+        {
+          if ( field.constraints().constraints() & QgsFieldConstraints::Constraint::ConstraintNotNull )
+          {
+            valuesError = QStringLiteral( "NOT NULL constraint error on layer '%1', field '%2'" ).arg( typeName, field.name() );
+            break;
+          }
+        }
+        else  // Not NULL
+        {
+          if ( field.type() == QVariant::Type::Int )
+          {
+            value = it.value().toInt( &conversionSuccess );
+          }
+          else if ( field.type() == QVariant::Type::Double )
+          {
+            value = it.value().toDouble( &conversionSuccess );
+          }
+          else if ( field.type() == QVariant::Type::LongLong )
+          {
+            value = it.value().toLongLong( &conversionSuccess );
+          }
+          else
+          {
+            conversionSuccess = true;
+          }
+
+          if ( !conversionSuccess )
+          {
+            valuesError = QStringLiteral( "Property conversion error on layer '%1'" ).arg( typeName );
+            break;
+          }
+        }
+        newValues.insert( fieldMapIt.value(), value );
+      }
+
+      const QgsGeometry geometry = geometryElem.isNull() ? QgsGeometry() : QgsOgcUtils::geometryFromGML( geometryElem );
+
       // Update the features
       while ( fit.nextFeature( feature ) )
       {
@@ -421,73 +474,22 @@ namespace QgsWfs
           break;
         }
 #endif
-        QMap< QString, QString >::const_iterator it = propertyMap.constBegin();
-        for ( ; it != propertyMap.constEnd(); ++it )
+        if ( !valuesError.isEmpty() )
         {
-          fieldName = it.key();
-          fieldMapIt = fieldMap.find( fieldName );
-          if ( fieldMapIt == fieldMap.constEnd() )
-          {
-            continue;
-          }
-          QgsField field = fields.at( fieldMapIt.value() );
-          QVariant value = it.value();
-          if ( QgsVariantUtils::isNull( value ) )
-          {
-            if ( field.constraints().constraints() & QgsFieldConstraints::Constraint::ConstraintNotNull )
-            {
-              action.error = true;
-              action.errorMsg = QStringLiteral( "NOT NULL constraint error on layer '%1', field '%2'" ).arg( typeName, field.name() );
-              vlayer->rollBack();
-              break;
-            }
-          }
-          else  // Not NULL
-          {
-            if ( field.type() == QVariant::Type::Int )
-            {
-              value = it.value().toInt( &conversionSuccess );
-              if ( !conversionSuccess )
-              {
-                action.error = true;
-                action.errorMsg = QStringLiteral( "Property conversion error on layer '%1'" ).arg( typeName );
-                vlayer->rollBack();
-                break;
-              }
-            }
-            else if ( field.type() == QVariant::Type::Double )
-            {
-              value = it.value().toDouble( &conversionSuccess );
-              if ( !conversionSuccess )
-              {
-                action.error = true;
-                action.errorMsg = QStringLiteral( "Property conversion error on layer '%1'" ).arg( typeName );
-                vlayer->rollBack();
-                break;
-              }
-            }
-            else if ( field.type() == QVariant::Type::LongLong )
-            {
-              value = it.value().toLongLong( &conversionSuccess );
-              if ( !conversionSuccess )
-              {
-                action.error = true;
-                action.errorMsg = QStringLiteral( "Property conversion error on layer '%1'" ).arg( typeName );
-                vlayer->rollBack();
-                break;
-              }
-            }
-          }
-          vlayer->changeAttributeValue( feature.id(), fieldMapIt.value(), value );
+          action.error = true;
+          action.errorMsg = valuesError;
+          vlayer->rollBack();
+          break;
         }
-        if ( action.error )
+
+        if ( !newValues.isEmpty() )
         {
-          break;
+          vlayer->changeAttributeValues( feature.id(), newValues );
         }
 
         if ( !geometryElem.isNull() )
         {
-          QgsGeometry g = QgsOgcUtils::geometryFromGML( geometryElem );
+          QgsGeometry g = geometry;
           if ( g.isNull() )
           {
             action.error = true;
@@ -36,12 +36,75 @@
 #include "qgslogger.h"
 
 #include <QTextCodec>
+#include <QMutex>
+#include <QElapsedTimer>
 
 #ifdef HAVE_SERVER_PYTHON_PLUGINS
 #include "qgsfilterrestorer.h"
 #include "qgsaccesscontrol.h"
 #endif
 
+///@cond PRIVATE
+
+//! Milliseconds during which the number of features matched by a query is reused by the next pages
+constexpr qint64 MATCHED_FEATURES_COUNT_CACHE_MS = 30000;
+
+//! Maximum number of queries in the cache of matched features counts
+constexpr int MATCHED_FEATURES_COUNT_CACHE_SIZE = 100;
+
+//! Short-lived cache of the number of features matched by the queries of the items handler
+class QgsWfs3MatchedFeaturesCountCache
+{
+  public:
+
+    //! Returns TRUE and sets \a count if the count of the query with the \a key is in the cache
+    static bool count( const QString &key, long &count )
+    {
+      const QMutexLocker locker( &sMutex );
+      const auto it = sEntries.constFind( key );
+      if ( it == sEntries.constEnd() || it->timer.hasExpired( MATCHED_FEATURES_COUNT_CACHE_MS ) )
+        return false;
+      count = it->count;
+      return true;
+    }
+
+    //! Stores the \a count of the query with the \a key
+    static void setCount( const QString &key, long count )
+    {
+      const QMutexLocker locker( &sMutex );
+      if ( sEntries.size() >= MATCHED_FEATURES_COUNT_CACHE_SIZE )
+      {
+        for ( auto it = sEntries.begin(); it != sEntries.end(); )
+        {
+          if ( it->timer.hasExpired( MATCHED_FEATURES_COUNT_CACHE_MS ) )
+            it = sEntries.erase( it );
+          else
+            ++it;
+        }
+        if ( sEntries.size() >= MATCHED_FEATURES_COUNT_CACHE_SIZE )
+          sEntries.clear();
+      }
+      Entry &entry = sEntries[ key ];
+      entry.count = count;
+      entry.timer.start();
+    }
+
+  private:
+
+    struct Entry
+    {
+      long count = 0;
+      QElapsedTimer timer;
+    };
+
+    static QMutex sMutex;
+    static QHash< QString, Entry > sEntries;
+};
+
+QMutex QgsWfs3MatchedFeaturesCountCache::sMutex;
+QHash< QString, QgsWfs3MatchedFeaturesCountCache::Entry > QgsWfs3MatchedFeaturesCountCache::sEntries;
+
+///@endcond
 
 QgsWfs3APIHandler::QgsWfs3APIHandler( const QgsServerOgcApi *api ):
   mApi( api )
@@ -1337,20 +1400,40 @@ void QgsWfs3CollectionsItemsHandler::handleRequest( const QgsServerApiContext &c
       {
         matchedFeaturesCount = mapLayer->featureCount();
       }
+      else if ( i < limit + offset )
+      {
+        // all the matching features were already iterated
+        matchedFeaturesCount = i;
+      }
       else
       {
-        if ( filterExpression.isEmpty() )
+        // crawling clients request the pages of a query one after the other, the count is
+        // reused for a short time instead of iterating all the matching features for each page
+        const bool cacheable = featureRequest.filterType() == QgsFeatureRequest::FilterNone || featureRequest.filterType() == QgsFeatureRequest::FilterExpression;
+        const QString countKey = QStringLiteral( "%1|%2|%3|%4|%5" ).arg( context.project()->fileName(),
+                                 mapLayer->id(),
+                                 mapLayer->subsetString(),
+                                 featureRequest.filterExpression() ? featureRequest.filterExpression()->expression() : QString(),
+                                 featureRequest.filterRect().toString() );
+
+        if ( !cacheable || !QgsWfs3MatchedFeaturesCountCache::count( countKey, matchedFeaturesCount ) )
         {
-          featureRequest.setNoAttributes();
-        }
+          if ( filterExpression.isEmpty() )
+          {
+            featureRequest.setNoAttributes();
+          }
 
-        featureRequest.setFlags( QgsFeatureRequest::Flag::NoGeometry );
-        featureRequest.setLimit( -1 );
-        features = mapLayer->getFeatures( featureRequest );
+          featureRequest.setFlags( QgsFeatureRequest::Flag::NoGeometry );
+          featureRequest.setLimit( -1 );
+          features = mapLayer->getFeatures( featureRequest );
 
-        while ( features.nextFeature( feat ) )
-        {
-          matchedFeaturesCount++;
+          while ( features.nextFeature( feat ) )
+          {
+            matchedFeaturesCount++;
+          }
+
+          if ( cacheable )
+            QgsWfs3MatchedFeaturesCountCache::setCount( countKey, matchedFeaturesCount );
         }
       }
 
@@ -21,9 +21,26 @@
 #include "qgsmaprendererparalleljob.h"
 #include "qgsmaprenderercustompainterjob.h"
 #include "qgsapplication.h"
+#include "qgsruntimeprofiler.h"
 
 namespace QgsWms
 {
+  namespace
+  {
+    // Adds the rendering time of each layer to the server profile of the current request
+    void recordLayerRenderingTimes( const QgsMapSettings &mapSettings, const QHash<QgsMapLayer *, int> &times )
+    {
+      const QList<QgsMapLayer *> layers = mapSettings.layers();
+      for ( QgsMapLayer *layer : layers )
+      {
+        const auto it = times.constFind( layer );
+        if ( it != times.constEnd() )
+        {
+          QgsApplication::profiler()->record( layer->name(), it.value() / 1000.0, QStringLiteral( "server" ) );
+        }
+      }
+    }
+  }
 
   QgsMapRendererJobProxy::QgsMapRendererJobProxy(
     bool parallelRendering
@@ -72,6 +89,7 @@ namespace QgsWms
       }
 
       mErrors = renderJob.errors();
+      recordLayerRenderingTimes( mapSettings, renderJob.perLayerRenderingTime() );
     }
     else
     {
@@ -82,6 +100,7 @@ namespace QgsWms
 #endif
       renderJob.renderSynchronously();
       mErrors = renderJob.errors();
+      recordLayerRenderingTimes( mapSettings, renderJob.perLayerRenderingTime() );
     }
   }
 
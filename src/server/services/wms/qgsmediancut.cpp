@@ -24,6 +24,8 @@
 #include <QList>
 #include <QMultiMap>
 #include <QHash>
+#include <QThread>
+#include <QtConcurrentMap>
 
 namespace QgsWms
 {
@@ -34,23 +36,39 @@ namespace QgsWms
   namespace
   {
 
-    void imageColors( QHash<QRgb, int> &colors, const QImage &image )
+    // Minimum number of pixels for the color histogram to be computed in parallel
+    constexpr int PARALLEL_COLORS_MIN_PIXELS = 512 * 512;
+
+    struct ColorsBlock
     {
-      colors.clear();
-      const int width = image.width();
-      const int height = image.height();
+      const QImage *image = nullptr;
+      int beginLine = 0;
+      int endLine = 0;
+      QHash<QRgb, int> colors;
+    };
+
+    void blockColors( ColorsBlock &block )
+    {
+      const int width = block.image->width();
 
       const QRgb *currentScanLine = nullptr;
-      QHash<QRgb, int>::iterator colorIt;
-      for ( int i = 0; i < height; ++i )
+      QHash<QRgb, int>::iterator colorIt = block.colors.end();
+      for ( int i = block.beginLine; i < block.endLine; ++i )
       {
-        currentScanLine = ( const QRgb * )( image.scanLine( i ) );
+        currentScanLine = ( const QRgb * )( block.image->constScanLine( i ) );
         for ( int j = 0; j < width; ++j )
         {
-          colorIt = colors.find( currentScanLine[j] );
-          if ( colorIt == colors.end() )
+          // rendered maps have long runs of identical pixels, skip the lookup for these
+          if ( colorIt != block.colors.end() && colorIt.key() == currentScanLine[j] )
           {
-            colors.insert( currentScanLine[j], 1 );
+            colorIt.value()++;
+            continue;
+          }
+
+          colorIt = block.colors.find( currentScanLine[j] );
+          if ( colorIt == block.colors.end() )
+          {
+            colorIt = block.colors.insert( currentScanLine[j], 1 );
           }
           else
           {
@@ -60,6 +78,46 @@ namespace QgsWms
       }
     }
 
+    void imageColors( QHash<QRgb, int> &colors, const QImage &image )
+    {
+      colors.clear();
+      const int height = image.height();
+
+      int nBlocks = 1;
+      if ( static_cast< qint64 >( image.width() ) * height >= PARALLEL_COLORS_MIN_PIXELS )
+      {
+        nBlocks = std::max( 1, std::min( QThread::idealThreadCount(), height ) );
+      }
+
+      QVector<ColorsBlock> blocks( nBlocks );
+      const int blockLen = height / nBlocks;
+      for ( int block = 0; block < nBlocks; ++block )
+      {
+        blocks[block].image = &image;
+        blocks[block].beginLine = block * blockLen;
+        //make sure last block goes to end of image
+        blocks[block].endLine = block < ( nBlocks - 1 ) ? ( block + 1 ) * blockLen : height;
+      }
+
+      if ( nBlocks == 1 )
+      {
+        blockColors( blocks[0] );
+      }
+      else
+      {
+        QtConcurrent::blockingMap( blocks, blockColors );
+      }
+
+      colors = std::move( blocks[0].colors );
+      for ( int block = 1; block < nBlocks; ++block )
+      {
+        for ( auto it = blocks[block].colors.constBegin(); it != blocks[block].colors.constEnd(); ++it )
+        {
+          colors[ it.key() ] += it.value();
+        }
+      }
+    }
+
     bool minMaxRange( const QgsColorBox &colorBox, int &redRange, int &greenRange, int &blueRange, int &alphaRange )
     {
       if ( colorBox.size() < 1 )
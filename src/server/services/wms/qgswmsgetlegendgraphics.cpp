@@ -30,7 +30,9 @@
 #include "qgswmsrenderer.h"
 #include "qgsserverprojectutils.h"
 
+#include <QBuffer>
 #include <QImage>
+#include <QImageReader>
 #include <QJsonObject>
 #include <QJsonDocument>
 
@@ -106,12 +108,14 @@ namespace QgsWms
     QgsServerCacheManager *cacheManager = serverIface->cacheManager();
     if ( cacheManager && !imageSaveFormat.isEmpty() )
     {
-      QImage image;
-      const QByteArray content = cacheManager->getCachedImage( project, request, accessControl );
-      if ( !content.isEmpty() && image.loadFromData( content ) )
+      QByteArray content = cacheManager->getCachedImage( project, request, accessControl );
+      QBuffer buffer( &content );
+      // the cached content is the encoded image of an identical request, it is sent
+      // as is instead of being decoded and encoded again
+      if ( !content.isEmpty() && QImageReader( &buffer ).canRead() )
       {
         response.setHeader( QStringLiteral( "Content-Type" ), imageContentType );
-        image.save( response.io(), qPrintable( imageSaveFormat ) );
+        response.write( content );
         return;
       }
     }
@@ -160,7 +164,7 @@ namespace QgsWms
       tree->clear();
       if ( result )
       {
-        writeImage( response, *result, parameters.formatAsString(), context.imageQuality() );
+        writeImage( response, *result, parameters.formatAsString(), context.imageQuality(), context.settings().wmsPngCompressionLevel() );
 #ifdef HAVE_SERVER_PYTHON_PLUGINS
         if ( cacheManager )
         {
@@ -22,6 +22,8 @@
 #include "qgswmsgetmap.h"
 #include "qgswmsrenderer.h"
 #include "qgswmsserviceexception.h"
+#include "qgsapplication.h"
+#include "qgsruntimeprofiler.h"
 
 #include <QImage>
 
@@ -57,7 +59,8 @@ namespace QgsWms
     if ( result )
     {
       const QString format = request.parameters().value( QStringLiteral( "FORMAT" ), QStringLiteral( "PNG" ) );
-      writeImage( response, *result, format, context.imageQuality() );
+      const QgsScopedRuntimeProfile profile( QStringLiteral( "Image encoding" ), QStringLiteral( "server" ) );
+      writeImage( response, *result, format, context.imageQuality(), context.settings().wmsPngCompressionLevel() );
     }
     else
     {
@@ -48,6 +48,7 @@
 #include "qgsvectortilelayer.h"
 #include "qgsmessagelog.h"
 #include "qgsrenderer.h"
+#include "qgsvectorlayerfeatureiterator.h"
 #include "qgsfeature.h"
 #include "qgsaccesscontrol.h"
 #include "qgsfeaturerequest.h"
@@ -82,6 +83,7 @@
 #include <QTemporaryFile>
 #include <QDir>
 #include <QUrl>
+#include <QtConcurrentMap>
 #include <nlohmann/json.hpp>
 
 //for printing
@@ -103,6 +105,7 @@
 #include "qgsfeaturefilterprovidergroup.h"
 #include "qgsogcutils.h"
 #include "qgsunittypes.h"
+#include "qgsruntimeprofiler.h"
 
 namespace QgsWms
 {
@@ -950,7 +953,10 @@ namespace QgsWms
 
     QgsMapSettings mapSettings;
     mapSettings.setFlag( Qgis::MapSettingsFlag::RenderBlocking );
-    configureLayers( layers, &mapSettings );
+    {
+      const QgsScopedRuntimeProfile profile( QStringLiteral( "Layers configuration" ), QStringLiteral( "server" ) );
+      configureLayers( layers, &mapSettings );
+    }
 
     // create the output image and the painter
     std::unique_ptr<QPainter> painter;
@@ -963,10 +969,16 @@ namespace QgsWms
     mapSettings.setLayers( layers );
 
     // rendering step for layers
-    painter.reset( layersRendering( mapSettings, *image ) );
+    {
+      const QgsScopedRuntimeProfile profile( QStringLiteral( "Layers rendering" ), QStringLiteral( "server" ) );
+      painter.reset( layersRendering( mapSettings, *image ) );
+    }
 
     // rendering step for annotations
-    annotationsRendering( painter.get(), mapSettings );
+    {
+      const QgsScopedRuntimeProfile profile( QStringLiteral( "Annotations rendering" ), QStringLiteral( "server" ) );
+      annotationsRendering( painter.get(), mapSettings );
+    }
 
     // painting is terminated
     painter->end();
@@ -1321,6 +1333,9 @@ namespace QgsWms
 
     mapSettings.setFlag( Qgis::MapSettingsFlag::RenderMapTile, mContext.renderMapTiles() );
 
+    // large vector layers are drawn by several threads with parallel rendering
+    mapSettings.setFlag( Qgis::MapSettingsFlag::ParallelFeatureRendering, mContext.settings().parallelRendering() );
+
     // set selection color
     mapSettings.setSelectionColor( mProject->selectionColor() );
 
@@ -1465,6 +1480,44 @@ namespace QgsWms
     //layers can have assigned a different name for GetCapabilities
     QHash<QString, QString> layerAliasMap = QgsServerProjectUtils::wmsFeatureInfoLayerAliasMap( *mProject );
 
+    // with parallel rendering, the features of the queried vector layers are
+    // fetched concurrently and the document is then written in the query order
+    std::vector<std::unique_ptr<VectorFeatureInfoQuery>> vectorQueries;
+    QHash<QgsVectorLayer *, const VectorFeatureInfoQuery *> prefetchedQueries;
+    if ( mContext.settings().parallelRendering() )
+    {
+      for ( const QString &queryLayer : queryLayers )
+      {
+        for ( QgsMapLayer *layer : std::as_const( layers ) )
+        {
+          if ( queryLayer != mContext.layerNickname( *layer ) )
+          {
+            continue;
+          }
+
+          QgsVectorLayer *vectorLayer = qobject_cast<QgsVectorLayer *>( layer );
+          if ( vectorLayer && layer->flags().testFlag( QgsMapLayer::Identifiable ) && !prefetchedQueries.contains( vectorLayer ) )
+          {
+            vectorQueries.emplace_back( prepareVectorFeatureInfoQuery( vectorLayer, infoPoint.get(), featureCount, mapSettings, renderContext, featuresRect.get(), filterGeom.get() ) );
+            prefetchedQueries.insert( vectorLayer, vectorQueries.back().get() );
+          }
+          break;
+        }
+      }
+
+      if ( vectorQueries.size() > 1 )
+      {
+        QtConcurrent::blockingMap( vectorQueries, []( std::unique_ptr<VectorFeatureInfoQuery> &query ) { fetchVectorFeatureInfo( *query ); } );
+      }
+      else
+      {
+        for ( std::unique_ptr<VectorFeatureInfoQuery> &query : vectorQueries )
+        {
+          fetchVectorFeatureInfo( *query );
+        }
+      }
+    }
+
     for ( const QString &queryLayer : queryLayers )
     {
       bool validLayer = false;
@@ -1510,7 +1563,7 @@ namespace QgsWms
             QgsVectorLayer *vectorLayer = qobject_cast<QgsVectorLayer *>( layer );
             if ( vectorLayer )
             {
-              ( void )featureInfoFromVectorLayer( vectorLayer, infoPoint.get(), featureCount, result, layerElement, mapSettings, renderContext, version, featuresRect.get(), filterGeom.get() );
+              ( void )featureInfoFromVectorLayer( vectorLayer, infoPoint.get(), featureCount, result, layerElement, mapSettings, renderContext, version, featuresRect.get(), filterGeom.get(), prefetchedQueries.value( vectorLayer ) );
               break;
             }
           }
@@ -1632,23 +1685,36 @@ namespace QgsWms
     return result;
   }
 
-  bool QgsRenderer::featureInfoFromVectorLayer( QgsVectorLayer *layer,
+  struct QgsRenderer::VectorFeatureInfoQuery
+  {
+    QgsVectorLayer *layer = nullptr;
+    QgsWkbTypes::Type wkbType = QgsWkbTypes::Unknown;
+    QgsFeatureRequest request;
+    QgsRectangle searchRect;
+    bool hasGeometry = false;
+    int maxFeatures = 1;
+    QStringList attributes;
+    std::unique_ptr<QgsVectorLayerFeatureSource> source;
+    std::unique_ptr<QgsFeatureRenderer> renderer;
+    QgsRenderContext renderContext;
+    QgsFeatureList features;
+  };
+
+  std::unique_ptr<QgsRenderer::VectorFeatureInfoQuery> QgsRenderer::prepareVectorFeatureInfoQuery( QgsVectorLayer *layer,
       const QgsPointXY *infoPoint,
       int nFeatures,
-      QDomDocument &infoDocument,
-      QDomElement &layerElement,
       const QgsMapSettings &mapSettings,
-      QgsRenderContext &renderContext,
-      const QString &version,
-      QgsRectangle *featureBBox,
+      const QgsRenderContext &renderContext,
+      bool withFeatureBBox,
       QgsGeometry *filterGeom ) const
   {
-    if ( !layer )
-    {
-      return false;
-    }
+    std::unique_ptr<VectorFeatureInfoQuery> query = std::make_unique<VectorFeatureInfoQuery>();
+    query->layer = layer;
+    query->wkbType = layer->wkbType();
+    query->maxFeatures = nFeatures;
+    query->renderContext = renderContext;
 
-    QgsFeatureRequest fReq;
+    QgsFeatureRequest &fReq = query->request;
 
     // Transform filter geometry to layer CRS
     std::unique_ptr<QgsGeometry> layerFilterGeom;
@@ -1663,7 +1729,7 @@ namespace QgsWms
     QgsRectangle layerRect = mapSettings.mapToLayerCoordinates( layer, mapRect );
 
 
-    QgsRectangle searchRect;
+    QgsRectangle &searchRect = query->searchRect;
 
     //info point could be 0 in case there is only an attribute filter
     if ( infoPoint )
@@ -1680,17 +1746,12 @@ namespace QgsWms
     }
 
     //do a select with searchRect and go through all the features
-
-    QgsFeature feature;
-    QgsAttributes featureAttributes;
-    int featureCounter = 0;
     layer->updateFields();
     const QgsFields fields = layer->fields();
     bool addWktGeometry = ( QgsServerProjectUtils::wmsFeatureInfoAddWktGeometry( *mProject ) && mWmsParameters.withGeometry() );
-    bool segmentizeWktGeometry = QgsServerProjectUtils::wmsFeatureInfoSegmentizeWktGeometry( *mProject );
 
-    bool hasGeometry = QgsServerProjectUtils::wmsFeatureInfoAddWktGeometry( *mProject ) || addWktGeometry || featureBBox || layerFilterGeom;
-    fReq.setFlags( ( ( hasGeometry ) ? QgsFeatureRequest::NoFlags : QgsFeatureRequest::NoGeometry ) | QgsFeatureRequest::ExactIntersect );
+    query->hasGeometry = QgsServerProjectUtils::wmsFeatureInfoAddWktGeometry( *mProject ) || addWktGeometry || withFeatureBBox || layerFilterGeom;
+    fReq.setFlags( ( ( query->hasGeometry ) ? QgsFeatureRequest::NoFlags : QgsFeatureRequest::NoGeometry ) | QgsFeatureRequest::ExactIntersect );
 
     if ( ! searchRect.isEmpty() )
     {
@@ -1717,34 +1778,44 @@ namespace QgsWms
     {
       attributes.append( field.name() );
     }
-    attributes = mContext.accessControl()->layerAttributes( layer, attributes );
-    fReq.setSubsetOfAttributes( attributes, layer->fields() );
+    query->attributes = mContext.accessControl()->layerAttributes( layer, attributes );
+    fReq.setSubsetOfAttributes( query->attributes, layer->fields() );
 #endif
 
-    QgsFeatureIterator fit = layer->getFeatures( fReq );
-    std::unique_ptr< QgsFeatureRenderer > r2( layer->renderer() ? layer->renderer()->clone() : nullptr );
+    query->source = std::make_unique<QgsVectorLayerFeatureSource>( layer );
+    query->renderer.reset( layer->renderer() ? layer->renderer()->clone() : nullptr );
+
+    return query;
+  }
+
+  void QgsRenderer::fetchVectorFeatureInfo( VectorFeatureInfoQuery &query )
+  {
+    QgsFeatureRenderer *r2 = query.renderer.get();
+    QgsRenderContext &renderContext = query.renderContext;
     if ( r2 )
     {
-      r2->startRender( renderContext, layer->fields() );
+      r2->startRender( renderContext, query.source->fields() );
     }
 
-    bool featureBBoxInitialized = false;
+    QgsFeatureIterator fit = query.source->getFeatures( query.request );
+    QgsFeature feature;
+    int featureCounter = 0;
     while ( fit.nextFeature( feature ) )
     {
-      if ( layer->wkbType() == QgsWkbTypes::NoGeometry && ! searchRect.isEmpty() )
+      if ( query.wkbType == QgsWkbTypes::NoGeometry && ! query.searchRect.isEmpty() )
       {
         break;
       }
 
       ++featureCounter;
-      if ( featureCounter > nFeatures )
+      if ( featureCounter > query.maxFeatures )
       {
         break;
       }
 
       renderContext.expressionContext().setFeature( feature );
 
-      if ( layer->wkbType() != QgsWkbTypes::NoGeometry && ! searchRect.isEmpty() )
+      if ( query.wkbType != QgsWkbTypes::NoGeometry && ! query.searchRect.isEmpty() )
       {
         if ( !r2 )
         {
@@ -1759,6 +1830,56 @@ namespace QgsWms
         }
       }
 
+      query.features << feature;
+    }
+
+    if ( r2 )
+    {
+      r2->stopRender( renderContext );
+    }
+  }
+
+  bool QgsRenderer::featureInfoFromVectorLayer( QgsVectorLayer *layer,
+      const QgsPointXY *infoPoint,
+      int nFeatures,
+      QDomDocument &infoDocument,
+      QDomElement &layerElement,
+      const QgsMapSettings &mapSettings,
+      QgsRenderContext &renderContext,
+      const QString &version,
+      QgsRectangle *featureBBox,
+      QgsGeometry *filterGeom,
+      const VectorFeatureInfoQuery *prefetchedQuery ) const
+  {
+    if ( !layer )
+    {
+      return false;
+    }
+
+    std::unique_ptr<VectorFeatureInfoQuery> ownQuery;
+    const VectorFeatureInfoQuery *query = prefetchedQuery;
+    if ( !query )
+    {
+      ownQuery = prepareVectorFeatureInfoQuery( layer, infoPoint, nFeatures, mapSettings, renderContext, featureBBox, filterGeom );
+      fetchVectorFeatureInfo( *ownQuery );
+      query = ownQuery.get();
+    }
+
+    QgsAttributes featureAttributes;
+    const QgsFields fields = layer->fields();
+    bool addWktGeometry = ( QgsServerProjectUtils::wmsFeatureInfoAddWktGeometry( *mProject ) && mWmsParameters.withGeometry() );
+    bool segmentizeWktGeometry = QgsServerProjectUtils::wmsFeatureInfoSegmentizeWktGeometry( *mProject );
+    const bool hasGeometry = query->hasGeometry;
+
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+    QStringList attributes = query->attributes;
+#endif
+
+    bool featureBBoxInitialized = false;
+    for ( const QgsFeature &feature : std::as_const( query->features ) )
+    {
+      renderContext.expressionContext().setFeature( feature );
+
       QgsRectangle box;
       if ( layer->wkbType() != QgsWkbTypes::NoGeometry && hasGeometry )
       {
@@ -1886,10 +2007,6 @@ namespace QgsWms
         }
       }
     }
-    if ( r2 )
-    {
-      r2->stopRender( renderContext );
-    }
 
     return true;
   }
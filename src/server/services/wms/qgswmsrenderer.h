@@ -198,6 +198,9 @@ namespace QgsWms
       QDomDocument featureInfoDocument( QList<QgsMapLayer *> &layers, const QgsMapSettings &mapSettings,
                                         const QImage *outputImage, const QString &version ) const;
 
+      // Features of a vector layer selected for a GetFeatureInfo response
+      struct VectorFeatureInfoQuery;
+
       /**
        * Appends feature info xml for the layer to the layer element of the
        * feature info dom document.
@@ -211,6 +214,7 @@ namespace QgsWms
        * \param version WMS version
        * \param featureBBox The bounding box of the selected features in output CRS
        * \param filterGeom Geometry for filtering selected features
+       * \param prefetchedQuery Features already fetched for the layer, if NULLPTR they are fetched here
        * \returns TRUE in case of success
        */
       bool featureInfoFromVectorLayer( QgsVectorLayer *layer,
@@ -222,7 +226,33 @@ namespace QgsWms
                                        QgsRenderContext &renderContext,
                                        const QString &version,
                                        QgsRectangle *featureBBox = nullptr,
-                                       QgsGeometry *filterGeom = nullptr ) const;
+                                       QgsGeometry *filterGeom = nullptr,
+                                       const VectorFeatureInfoQuery *prefetchedQuery = nullptr ) const;
+
+      /**
+       * Prepares the request selecting the features of a vector layer reported
+       * by GetFeatureInfo. Must be called from the main thread.
+       * \param layer The vector layer
+       * \param infoPoint The point coordinates
+       * \param nFeatures The number of features
+       * \param mapSettings Map settings with extent, CRS, ...
+       * \param renderContext Context to use for feature rendering
+       * \param withFeatureBBox TRUE if the bounding box of the selected features is requested
+       * \param filterGeom Geometry for filtering selected features
+       */
+      std::unique_ptr<VectorFeatureInfoQuery> prepareVectorFeatureInfoQuery( QgsVectorLayer *layer,
+          const QgsPointXY *infoPoint,
+          int nFeatures,
+          const QgsMapSettings &mapSettings,
+          const QgsRenderContext &renderContext,
+          bool withFeatureBBox,
+          QgsGeometry *filterGeom ) const;
+
+      /**
+       * Fetches the features selected by a query prepared with prepareVectorFeatureInfoQuery().
+       * Only uses the copies held by the query, so it can be called from any thread.
+       */
+      static void fetchVectorFeatureInfo( VectorFeatureInfoQuery &query );
 
       /**
        * Recursively called to write tab layout groups to XML
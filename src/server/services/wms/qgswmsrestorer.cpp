@@ -30,6 +30,7 @@ QgsLayerRestorer::QgsLayerRestorer( const QList<QgsMapLayer *> &layers )
   {
     QgsLayerSettings settings;
     settings.name = layer->name();
+    settings.mOpacity = 1.0;
 
     settings.mNamedStyle = layer->styleManager()->currentStyle();
 
@@ -51,7 +52,7 @@ QgsLayerRestorer::QgsLayerRestorer( const QList<QgsMapLayer *> &layers )
       {
         QgsRasterLayer *rLayer = qobject_cast<QgsRasterLayer *>( layer );
 
-        if ( rLayer )
+        if ( rLayer && rLayer->renderer() )
         {
           settings.mOpacity = rLayer->renderer()->opacity();
         }
@@ -85,10 +86,19 @@ QgsLayerRestorer::~QgsLayerRestorer()
       layer->removeCustomProperty( "sldStyleName" );
     }
 
-    // Then restore the previous style
+    // Then restore the previous state. The project is shared by all the
+    // requests handled by this process, so only touch what the request
+    // actually changed: some of the setters below emit signals and
+    // trigger repaints even when the value is unchanged.
     const QgsLayerSettings settings = it.value();
-    layer->styleManager()->setCurrentStyle( settings.mNamedStyle );
-    layer->setName( it.value().name );
+    if ( layer->styleManager()->currentStyle() != settings.mNamedStyle )
+    {
+      layer->styleManager()->setCurrentStyle( settings.mNamedStyle );
+    }
+    if ( layer->name() != settings.name )
+    {
+      layer->setName( settings.name );
+    }
 
     switch ( layer->type() )
     {
@@ -98,9 +108,12 @@ QgsLayerRestorer::~QgsLayerRestorer()
 
         if ( vLayer )
         {
-          vLayer->setOpacity( settings.mOpacity );
-          vLayer->selectByIds( settings.mSelectedFeatureIds );
-          vLayer->setSubsetString( settings.mFilter );
+          if ( !qgsDoubleNear( vLayer->opacity(), settings.mOpacity ) )
+            vLayer->setOpacity( settings.mOpacity );
+          if ( vLayer->selectedFeatureIds() != settings.mSelectedFeatureIds )
+            vLayer->selectByIds( settings.mSelectedFeatureIds );
+          if ( vLayer->subsetString() != settings.mFilter )
+            vLayer->setSubsetString( settings.mFilter );
         }
         break;
       }
@@ -108,7 +121,7 @@ QgsLayerRestorer::~QgsLayerRestorer()
       {
         QgsRasterLayer *rLayer = qobject_cast<QgsRasterLayer *>( layer );
 
-        if ( rLayer )
+        if ( rLayer && rLayer->renderer() && !qgsDoubleNear( rLayer->renderer()->opacity(), settings.mOpacity ) )
         {
           rLayer->renderer()->setOpacity( settings.mOpacity );
         }
@@ -109,7 +109,7 @@ namespace QgsWms
 
   // Write image response
   void writeImage( QgsServerResponse &response, QImage &img, const QString &formatStr,
-                   int imageQuality )
+                   int imageQuality, int pngCompressionLevel )
   {
     const ImageOutputFormat outputFormat = parseImageFormat( formatStr );
     QImage  result;
@@ -177,6 +177,13 @@ namespace QgsWms
       {
         result.save( response.io(), qPrintable( saveFormat ), imageQuality );
       }
+      else if ( pngCompressionLevel >= 0 )
+      {
+        // The Qt PNG writer maps the quality to the zlib compression level with
+        // ( 100 - quality ) * 9 / 91, a low level trades size for encoding speed
+        const int level = std::min( pngCompressionLevel, 9 );
+        result.save( response.io(), qPrintable( saveFormat ), 100 - ( level * 91 + 8 ) / 9 );
+      }
       else
       {
         result.save( response.io(), qPrintable( saveFormat ) );
@@ -67,9 +67,15 @@ namespace QgsWms
 
   /**
    * Write image response
+   *
+   * \param response the response to write the encoded image to
+   * \param img the image to encode
+   * \param formatStr the requested image format
+   * \param imageQuality the JPEG/WebP quality, -1 for the default quality
+   * \param pngCompressionLevel the zlib compression level (0-9) of PNG images, -1 for the default level
    */
   void writeImage( QgsServerResponse &response, QImage &img, const QString &formatStr,
-                   int imageQuality = -1 );
+                   int imageQuality = -1, int pngCompressionLevel = -1 );
 } // namespace QgsWms
 
 #endif
@@ -17,12 +17,96 @@
 #include "qgswmtsutils.h"
 #include "qgswmtsparameters.h"
 #include "qgswmtsgettile.h"
+#include "qgswmtstilecache.h"
+#include "qgsbufferserverresponse.h"
+#include "qgsserverprojectutils.h"
 
+#include <QBuffer>
 #include <QImage>
 
 namespace QgsWmts
 {
 
+  namespace
+  {
+    const int tileSize = 256;
+
+    QString tileContentType( const QgsWmtsParameters &params )
+    {
+      return params.format() == QgsWmtsParameters::Format::JPG ? QStringLiteral( "image/jpeg" ) : QStringLiteral( "image/png" );
+    }
+
+    QByteArray encodeTile( const QImage &image, const QgsWmtsParameters &params, const QgsProject *project )
+    {
+      QByteArray content;
+      QBuffer buffer( &content );
+      buffer.open( QIODevice::WriteOnly );
+      if ( params.format() == QgsWmtsParameters::Format::JPG )
+      {
+        image.save( &buffer, "JPEG", QgsServerProjectUtils::wmsImageQuality( *project ) );
+      }
+      else
+      {
+        image.save( &buffer, "PNG" );
+      }
+      return content;
+    }
+
+    /**
+     * Renders the metatile containing the requested tile with a single WMS
+     * GetMap request, slices it and stores every tile in \a tileCache.
+     * Returns the content of the requested tile or an empty array if the
+     * metatile could not be rendered.
+     */
+    QByteArray renderMetatile( QgsServerInterface *serverIface, const QgsProject *project,
+                               const QgsWmtsParameters &params, QgsWmtsTileCache &tileCache, int metatileSize )
+    {
+      metatileDef metatile;
+      QUrlQuery query = translateWmtsParamToWmsQueryItem( QStringLiteral( "GetMap" ), params, project, serverIface, metatileSize, metatile );
+
+      // Render the metatile losslessly, tiles are encoded in the requested format after slicing
+      const QString formatName = QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::FORMAT );
+      query.removeQueryItem( formatName );
+      query.addQueryItem( formatName, QStringLiteral( "image/png" ) );
+
+      const QgsServerParameters wmsParams( query );
+      const QgsServerRequest wmsRequest( "?" + query.query( QUrl::FullyDecoded ) );
+      QgsService *service = serverIface->serviceRegistry()->getService( wmsParams.service(), wmsParams.version() );
+      if ( !service )
+      {
+        return QByteArray();
+      }
+
+      QgsBufferServerResponse wmsResponse;
+      service->executeRequest( wmsRequest, wmsResponse, project );
+      wmsResponse.finish();
+
+      QImage metatileImage;
+      if ( !metatileImage.loadFromData( wmsResponse.body() ) )
+      {
+        return QByteArray();
+      }
+
+      const int row = params.tileRowAsInt();
+      const int col = params.tileColAsInt();
+      QByteArray requestedTile;
+      for ( int r = 0; r < metatile.rows; ++r )
+      {
+        for ( int c = 0; c < metatile.cols; ++c )
+        {
+          const QImage tileImage = metatileImage.copy( c * tileSize, r * tileSize, tileSize, tileSize );
+          const QByteArray content = encodeTile( tileImage, params, project );
+          tileCache.insertTile( QgsWmtsTileCache::tileKey( project, params, metatile.firstRow + r, metatile.firstCol + c ), content );
+          if ( metatile.firstRow + r == row && metatile.firstCol + c == col )
+          {
+            requestedTile = content;
+          }
+        }
+      }
+      return requestedTile;
+    }
+  }
+
   void writeGetTile( QgsServerInterface *serverIface, const QgsProject *project,
                      const QString &version, const QgsServerRequest &request,
                      QgsServerResponse &response )
@@ -66,6 +150,44 @@ namespace QgsWmts
     }
 #endif
 
+    // Built-in tile cache
+    const QgsServerSettings *settings = serverIface->serverSettings();
+    QgsWmtsTileCache *tileCache = nullptr;
+    if ( settings && settings->wmtsTileCacheSize() > 0 )
+    {
+      bool cacheable = true;
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+      // Do not share tiles if access control plugins make them user dependent
+      QStringList accessControlCacheKey;
+      cacheable = !accessControl || accessControl->fillCacheKey( accessControlCacheKey );
+#endif
+      if ( cacheable )
+      {
+        tileCache = QgsWmtsTileCache::instance( settings->wmtsTileCacheSize() );
+      }
+    }
+
+    if ( tileCache )
+    {
+      const QString key = QgsWmtsTileCache::tileKey( project, params, params.tileRowAsInt(), params.tileColAsInt() );
+      QByteArray content = tileCache->tile( key );
+      if ( content.isEmpty() )
+      {
+        content = renderMetatile( serverIface, project, params, *tileCache, settings->wmtsMetatileSize() );
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+        if ( cacheManager && !content.isEmpty() )
+          cacheManager->setCachedImage( &content, project, request, accessControl );
+#endif
+      }
+
+      if ( !content.isEmpty() )
+      {
+        response.setHeader( QStringLiteral( "Content-Type" ), tileContentType( params ) );
+        response.write( content );
+        return;
+      }
+    }
+
     const QgsServerParameters wmsParams( query );
     const QgsServerRequest wmsRequest( "?" + query.query( QUrl::FullyDecoded ) );
     QgsService *service = serverIface->serviceRegistry()->getService( wmsParams.service(), wmsParams.version() );
@@ -0,0 +1,68 @@
+/***************************************************************************
+                              qgswmtstilecache.cpp
+                              --------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS Contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgswmtstilecache.h"
+#include "qgswmtsparameters.h"
+#include "qgsproject.h"
+
+#include <QDateTime>
+
+#include <limits>
+
+namespace QgsWmts
+{
+
+  QgsWmtsTileCache *QgsWmtsTileCache::instance( qint64 maxCost )
+  {
+    static QgsWmtsTileCache sInstance;
+
+    const QMutexLocker locker( &sInstance.mMutex );
+    // QCache costs are int, cap the size accordingly
+    const int cost = static_cast<int>( std::min<qint64>( maxCost, std::numeric_limits<int>::max() ) );
+    if ( sInstance.mTiles.maxCost() != cost )
+    {
+      sInstance.mTiles.setMaxCost( cost );
+    }
+    return &sInstance;
+  }
+
+  QString QgsWmtsTileCache::tileKey( const QgsProject *project, const QgsWmtsParameters &params, int row, int col )
+  {
+    return QStringLiteral( "%1|%2|%3|%4|%5|%6|%7|%8" ).arg(
+             project->fileName(),
+             project->lastModified().toString( Qt::ISODateWithMs ),
+             params.layer(),
+             params.formatAsString(),
+             params.tileMatrixSet(),
+             params.tileMatrix(),
+             QString::number( row ),
+             QString::number( col ) );
+  }
+
+  QByteArray QgsWmtsTileCache::tile( const QString &key ) const
+  {
+    const QMutexLocker locker( &mMutex );
+    const QByteArray *content = mTiles.object( key );
+    return content ? *content : QByteArray();
+  }
+
+  void QgsWmtsTileCache::insertTile( const QString &key, const QByteArray &content )
+  {
+    const QMutexLocker locker( &mMutex );
+    mTiles.insert( key, new QByteArray( content ), content.size() );
+  }
+
+} // namespace QgsWmts
@@ -0,0 +1,76 @@
+/***************************************************************************
+                              qgswmtstilecache.h
+                              ------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS Contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSWMTSTILECACHE_H
+#define QGSWMTSTILECACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+#include <QString>
+
+class QgsProject;
+
+namespace QgsWmts
+{
+  class QgsWmtsParameters;
+
+  /**
+   * \ingroup server
+   * \brief In-memory cache of encoded WMTS tiles.
+   *
+   * Tiles are keyed by project (path and last modification time), layer,
+   * format, tile matrix set, tile matrix, row and column, so any
+   * change to the project file invalidates its tiles. The cache cost is the
+   * encoded tile size in bytes.
+   *
+   * \since QGIS 3.30
+   */
+  class QgsWmtsTileCache
+  {
+    public:
+
+      /**
+       * Returns the cache shared by all WMTS requests, resized to
+       * \a maxCost bytes.
+       */
+      static QgsWmtsTileCache *instance( qint64 maxCost );
+
+      /**
+       * Returns the key for the tile at \a row and \a col of the tile
+       * matrix requested by \a params.
+       */
+      static QString tileKey( const QgsProject *project, const QgsWmtsParameters &params, int row, int col );
+
+      /**
+       * Returns the encoded tile stored for \a key or an empty array.
+       */
+      QByteArray tile( const QString &key ) const;
+
+      /**
+       * Stores the encoded \a content of a tile for \a key.
+       */
+      void insertTile( const QString &key, const QByteArray &content );
+
+    private:
+
+      mutable QMutex mMutex;
+      QCache<QString, QByteArray> mTiles;
+  };
+
+} // namespace QgsWmts
+
+#endif // QGSWMTSTILECACHE_H
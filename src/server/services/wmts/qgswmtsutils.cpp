@@ -626,6 +626,14 @@ namespace QgsWmts
   QUrlQuery translateWmtsParamToWmsQueryItem( const QString &request, const QgsWmtsParameters &params,
       const QgsProject *project, QgsServerInterface *serverIface )
   {
+    metatileDef metatile;
+    return translateWmtsParamToWmsQueryItem( request, params, project, serverIface, 1, metatile );
+  }
+
+  QUrlQuery translateWmtsParamToWmsQueryItem( const QString &request, const QgsWmtsParameters &params,
+      const QgsProject *project, QgsServerInterface *serverIface,
+      int metatileSize, metatileDef &metatile )
+  {
 #ifndef HAVE_SERVER_PYTHON_PLUGINS
     ( void )serverIface;
 #endif
@@ -758,11 +766,18 @@ namespace QgsWmts
       throw QgsRequestNotWellFormedException( QStringLiteral( "TileCol is unknown" ) );
     }
 
+    // Align the metatile on multiples of its size and clip it to the tile matrix
+    metatileSize = std::max( 1, metatileSize );
+    metatile.firstCol = tc - tc % metatileSize;
+    metatile.firstRow = tr - tr % metatileSize;
+    metatile.cols = std::min( metatileSize, tm.col - metatile.firstCol );
+    metatile.rows = std::min( metatileSize, tm.row - metatile.firstRow );
+
     const double res = tm.resolution;
-    const double minx = tm.left + tc * ( tileSize * res );
-    const double miny = tm.top - ( tr + 1 ) * ( tileSize * res );
-    const double maxx = tm.left + ( tc + 1 ) * ( tileSize * res );
-    const double maxy = tm.top - tr * ( tileSize * res );
+    const double minx = tm.left + metatile.firstCol * ( tileSize * res );
+    const double miny = tm.top - ( metatile.firstRow + metatile.rows ) * ( tileSize * res );
+    const double maxx = tm.left + ( metatile.firstCol + metatile.cols ) * ( tileSize * res );
+    const double maxy = tm.top - metatile.firstRow * ( tileSize * res );
     QString bbox;
     if ( tms.hasAxisInverted )
     {
@@ -791,8 +806,8 @@ namespace QgsWmts
     query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::STYLES ), QString() );
     query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::CRS ), tms.ref );
     query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::BBOX ), bbox );
-    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::WIDTH ), QStringLiteral( "256" ) );
-    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::HEIGHT ), QStringLiteral( "256" ) );
+    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::WIDTH ), QString::number( tileSize * metatile.cols ) );
+    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::HEIGHT ), QString::number( tileSize * metatile.rows ) );
     query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::FORMAT ), format );
     if ( params.format() == QgsWmtsParameters::Format::PNG )
     {
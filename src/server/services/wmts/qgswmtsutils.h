@@ -120,6 +120,25 @@ namespace QgsWmts
     double minScale = 0.0;
   };
 
+  /**
+   * Block of adjacent tiles of a tile matrix rendered at once
+   * \since QGIS 3.30
+   */
+  struct metatileDef
+  {
+    //! Column of the top left tile
+    int firstCol = 0;
+
+    //! Row of the top left tile
+    int firstRow = 0;
+
+    //! Number of tile columns, may be lower than the metatile size at the tile matrix edges
+    int cols = 1;
+
+    //! Number of tile rows, may be lower than the metatile size at the tile matrix edges
+    int rows = 1;
+  };
+
   /**
    * Returns the highest version supported by this implementation
    */
@@ -149,6 +168,19 @@ namespace QgsWmts
   QUrlQuery translateWmtsParamToWmsQueryItem( const QString &request, const QgsWmtsParameters &params,
       const QgsProject *project, QgsServerInterface *serverIface );
 
+  /**
+   * Translate WMTS parameters to a WMS query item covering the block of
+   * \a metatileSize x \a metatileSize tiles containing the requested tile.
+   *
+   * Metatiles are aligned on multiples of \a metatileSize and clipped to the
+   * tile matrix extent, the tiles covered by the query are returned in \a metatile.
+   *
+   * \since QGIS 3.30
+   */
+  QUrlQuery translateWmtsParamToWmsQueryItem( const QString &request, const QgsWmtsParameters &params,
+      const QgsProject *project, QgsServerInterface *serverIface,
+      int metatileSize, metatileDef &metatile );
+
 } // namespace QgsWmts
 
 #endif
@@ -209,6 +209,64 @@ class TestAlignRaster : public QObject
       QCOMPARE( out.identify( 106.2, -6.4 ), 14. ); // = (1+2+5+6)
     }
 
+    void testMultipleRasters()
+    {
+      const QString tmpFile1( _tempFile( QStringLiteral( "multiple-1" ) ) );
+      const QString tmpFile2( _tempFile( QStringLiteral( "multiple-2" ) ) );
+
+      // the rasters are warped concurrently
+      QgsAlignRaster align;
+      QgsAlignRaster::List rasters;
+      rasters << QgsAlignRaster::Item( SRC_FILE, tmpFile1 );
+      rasters << QgsAlignRaster::Item( SRC_FILE, tmpFile2 );
+      rasters[1].resampleMethod = QgsAlignRaster::RA_Average;
+      rasters[1].rescaleValues = true;
+      align.setRasters( rasters );
+      align.setParametersFromRaster( SRC_FILE, QString(), QSizeF( 0.4, 0.4 ) );
+      const bool res = align.run();
+      QVERIFY( res );
+
+      QgsAlignRaster::RasterInfo out1( tmpFile1 );
+      QVERIFY( out1.isValid() );
+      QCOMPARE( out1.rasterSize(), QSize( 2, 2 ) );
+      QgsAlignRaster::RasterInfo out2( tmpFile2 );
+      QVERIFY( out2.isValid() );
+      QCOMPARE( out2.rasterSize(), QSize( 2, 2 ) );
+      QCOMPARE( out2.identify( 106.2, -6.4 ), 14. ); // = (1+2+5+6)
+    }
+
+    void testVirtualOutput()
+    {
+      const QString tmpFile( QStringLiteral( "%1/aligntest-virtual.vrt" ).arg( QDir::tempPath() ) );
+
+      QgsAlignRaster align;
+      QgsAlignRaster::List rasters;
+      rasters << QgsAlignRaster::Item( SRC_FILE, tmpFile );
+      align.setRasters( rasters );
+      align.setVirtualOutput( true );
+      QVERIFY( align.virtualOutput() );
+      align.setParametersFromRaster( SRC_FILE );
+      QPointF offset = align.gridOffset();
+      offset.rx() += 0.25;
+      align.setGridOffset( offset );
+      const bool res = align.run();
+      QVERIFY( res );
+
+      QgsAlignRaster::RasterInfo out( tmpFile );
+      QVERIFY( out.isValid() );
+      QCOMPARE( out.rasterSize(), QSize( 3, 4 ) );
+      QCOMPARE( out.cellSize(), QSizeF( 0.2, 0.2 ) );
+      QCOMPARE( out.identify( 106.1, -6.9 ), 13. );
+      QCOMPARE( out.identify( 106.2, -6.9 ), 13. );
+      QCOMPARE( out.identify( 106.3, -6.9 ), 14. );
+
+      // values cannot be rescaled on the fly
+      rasters[0].rescaleValues = true;
+      align.setRasters( rasters );
+      QVERIFY( !align.run() );
+      QVERIFY( !align.errorMessage().isEmpty() );
+    }
+
     void testReprojectToOtherCRS()
     {
       const QString tmpFile( _tempFile( QStringLiteral( "reproject-utm-47n" ) ) );
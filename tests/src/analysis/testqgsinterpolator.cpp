@@ -18,8 +18,12 @@ Email                : nyall dot dawson at gmail dot com
 #include "qgsdualedgetriangulation.h"
 #include "qgstininterpolator.h"
 #include "qgsidwinterpolator.h"
+#include "qgsgridfilewriter.h"
+#include "qgsrasterlayer.h"
 #include "qgsvectorlayer.h"
 
+#include <QTemporaryDir>
+
 class TestQgsInterpolator : public QObject
 {
     Q_OBJECT
@@ -35,6 +39,7 @@ class TestQgsInterpolator : public QObject
 
     void TIN_IDW_Interpolator_with_attribute();
     void TIN_IDW_Interpolator_with_Z();
+    void IDW_Interpolator_nearest_points();
 
   private:
 };
@@ -441,5 +446,73 @@ void TestQgsInterpolator::TIN_IDW_Interpolator_with_attribute()
   QVERIFY( qgsDoubleNear( resutlIDW, 3.5108401084, 0.00000001 ) );
 }
 
+void TestQgsInterpolator::IDW_Interpolator_nearest_points()
+{
+  std::unique_ptr<QgsVectorLayer>mLayerPoint = std::make_unique<QgsVectorLayer>( QStringLiteral( "PointZ?crs=epsg:3857" ),
+      QStringLiteral( "point" ),
+      QStringLiteral( "memory" ) );
+
+  QgsFeatureList flist;
+  const QStringList wkts { QStringLiteral( "PointZ (0.0 0.0 1.0)" ), QStringLiteral( "PointZ (2.0 0.0 2.0)" ), QStringLiteral( "PointZ (0.0 2.0 3.0)" ), QStringLiteral( "PointZ (2.0 2.0 4.0)" ) };
+  for ( const QString &wkt : wkts )
+  {
+    QgsFeature f( mLayerPoint->fields() );
+    f.setGeometry( QgsGeometry::fromWkt( wkt ) );
+    flist << f;
+  }
+  mLayerPoint->dataProvider()->addFeatures( flist );
+
+  QgsInterpolator::LayerData layerdata;
+  layerdata.source = mLayerPoint.get();
+  layerdata.valueSource = QgsInterpolator::ValueZ;
+  QList<QgsInterpolator::LayerData> layerDataList;
+  layerDataList.append( layerdata );
+
+  QgsIDWInterpolator idw( layerDataList );
+  QVERIFY( idw.supportsParallelInterpolation() );
+  double resultIDW = -1;
+
+  // all points
+  idw.setMaxPointCount( 4 );
+  QCOMPARE( idw.maxPointCount(), 4 );
+  QCOMPARE( idw.interpolatePoint( 0.5, 0.5, resultIDW, nullptr ), 0 );
+  QVERIFY( qgsDoubleNear( resultIDW, 1.6176470588, 0.00000001 ) );
+
+  // nearest points only
+  idw.setMaxPointCount( 1 );
+  QCOMPARE( idw.interpolatePoint( 0.5, 0.5, resultIDW, nullptr ), 0 );
+  QVERIFY( qgsDoubleNear( resultIDW, 1.0, 0.00000001 ) );
+  idw.setMaxPointCount( 2 );
+  QCOMPARE( idw.interpolatePoint( 0.25, 0.5, resultIDW, nullptr ), 0 );
+  QVERIFY( qgsDoubleNear( resultIDW, 1.2380952381, 0.00000001 ) );
+
+  // points within the search radius only
+  idw.setMaxPointCount( 0 );
+  idw.setSearchRadius( 1 );
+  QCOMPARE( idw.searchRadius(), 1.0 );
+  QCOMPARE( idw.interpolatePoint( 0.5, 0.5, resultIDW, nullptr ), 0 );
+  QVERIFY( qgsDoubleNear( resultIDW, 1.0, 0.00000001 ) );
+  QVERIFY( idw.interpolatePoint( 1, 1, resultIDW, nullptr ) != 0 );
+
+  // grid written to a GeoTIFF file, with the nearest point of each cell
+  idw.setMaxPointCount( 1 );
+  idw.setSearchRadius( 0 );
+  const QTemporaryDir dir;
+  const QString path = dir.filePath( QStringLiteral( "idw.tif" ) );
+  QgsGridFileWriter writer( &idw, path, QgsRectangle( 0, 0, 2, 2 ), 2, 2 );
+  QCOMPARE( writer.writeFile(), 0 );
+
+  QgsRasterLayer raster( path, QStringLiteral( "idw" ), QStringLiteral( "gdal" ) );
+  QVERIFY( raster.isValid() );
+  QCOMPARE( raster.width(), 2 );
+  QCOMPARE( raster.height(), 2 );
+  bool ok = false;
+  QCOMPARE( raster.dataProvider()->sample( QgsPointXY( 0.5, 1.5 ), 1, &ok ), 3.0 );
+  QVERIFY( ok );
+  QCOMPARE( raster.dataProvider()->sample( QgsPointXY( 1.5, 1.5 ), 1, &ok ), 4.0 );
+  QCOMPARE( raster.dataProvider()->sample( QgsPointXY( 0.5, 0.5 ), 1, &ok ), 1.0 );
+  QCOMPARE( raster.dataProvider()->sample( QgsPointXY( 1.5, 0.5 ), 1, &ok ), 2.0 );
+}
+
 QGSTEST_MAIN( TestQgsInterpolator )
 #include "testqgsinterpolator.moc"
@@ -18,6 +18,7 @@ Email                : zilolv at gmail dot com
 
 #include "qgsmeshcalculator.h"
 #include "qgsmeshcalcnode.h"
+#include "qgsmeshcalcutils.h"
 #include "qgsmeshvirtualdatasetgroup.h"
 #include "qgsmeshdataprovider.h"
 #include "qgsmeshlayer.h"
@@ -51,6 +52,7 @@ class TestQgsMeshCalculator : public QObject
     void calcWithMixedLayers();
 
     void calcAndSave();
+    void calcByTimeStep();
 
     void virtualDatasetGroup();
     void test_dataset_group_dependency();
@@ -320,6 +322,51 @@ void TestQgsMeshCalculator::calcAndSave()
   QVERIFY( fileInfo.exists() );
 }
 
+void TestQgsMeshCalculator::calcByTimeStep()
+{
+  const QgsRectangle extent( 1000.000, 1000.000, 3000.000, 3000.000 );
+
+  int sourceGroupIndex = -1;
+  for ( const int groupIndex : mpMeshLayer->datasetGroupsIndexes() )
+  {
+    if ( mpMeshLayer->datasetGroupMetadata( groupIndex ).name() == QLatin1String( "VertexScalarDataset" ) )
+      sourceGroupIndex = groupIndex;
+  }
+  QVERIFY( sourceGroupIndex >= 0 );
+
+  // without aggregate functions, time steps are calculated one after the other
+  QCOMPARE( QgsMeshCalcUtils::timeStepDatasetIndexes( mpMeshLayer, QStringList() << QStringLiteral( "VertexScalarDataset" ), 0, 3600 ), QList<int>() << 0 << 1 );
+  QCOMPARE( QgsMeshCalcUtils::timeStepDatasetIndexes( mpMeshLayer, QStringList() << QStringLiteral( "Bed Elevation" ), 0, 3600 ), QList<int>() << 0 );
+  bool ok = true;
+  QVERIFY( QgsMeshCalcUtils::timeStepDatasetIndexes( mpMeshLayer, QStringList() << QStringLiteral( "Missing" ), 0, 3600, &ok ).isEmpty() );
+  QVERIFY( !ok );
+
+  QgsMeshCalculator rc( QStringLiteral( "\"VertexScalarDataset\" + 2" ),
+                        QStringLiteral( "NewVertexScalarDatasetByTimeStep" ),
+                        extent,
+                        QgsMeshDatasetGroup::Memory,
+                        mpMeshLayer,
+                        0,
+                        3600
+                      );
+  const int groupCount = mpMeshLayer->datasetGroupCount();
+  QCOMPARE( static_cast< int >( rc.processCalculation() ), 0 );
+  QCOMPARE( mpMeshLayer->datasetGroupCount(), groupCount + 1 );
+
+  const int newGroupIndex = mpMeshLayer->datasetGroupsIndexes().last();
+  QCOMPARE( mpMeshLayer->datasetCount( newGroupIndex ), 2 );
+  for ( int i = 0; i < 2; ++i )
+  {
+    QCOMPARE( mpMeshLayer->datasetMetadata( QgsMeshDatasetIndex( newGroupIndex, i ) ).time(),
+              mpMeshLayer->datasetMetadata( QgsMeshDatasetIndex( sourceGroupIndex, i ) ).time() );
+    for ( int v = 0; v < 5; ++v )
+    {
+      QCOMPARE( mpMeshLayer->datasetValue( QgsMeshDatasetIndex( newGroupIndex, i ), v ).scalar(),
+                mpMeshLayer->datasetValue( QgsMeshDatasetIndex( sourceGroupIndex, i ), v ).scalar() + 2 );
+    }
+  }
+}
+
 void TestQgsMeshCalculator::virtualDatasetGroup()
 {
   QString formula = QStringLiteral( "\"VertexScalarDataset\" + 2" );
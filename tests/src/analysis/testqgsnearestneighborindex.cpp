@@ -0,0 +1,117 @@
+/***************************************************************************
+                         testqgsnearestneighborindex.cpp
+                         ---------------------
+    begin                : October 2022
+    copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include "qgsnearestneighborindex.h"
+#include "qgsgeometry.h"
+
+class TestQgsNearestNeighborIndex: public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase(); // will be called after the last testfunction was executed.
+    void init() {} // will be called before each testfunction is executed.
+    void cleanup() {} // will be called after every testfunction.
+    void empty();
+    void points();
+    void lines();
+};
+
+void TestQgsNearestNeighborIndex::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsNearestNeighborIndex::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsNearestNeighborIndex::empty()
+{
+  QgsNearestNeighborIndex index;
+  index.addFeature( 1, QgsGeometry() );
+  index.build();
+  QCOMPARE( index.size(), 0 );
+  QVERIFY( index.nearestNeighbors( QgsGeometry::fromPointXY( QgsPointXY( 1, 1 ) ), 1 ).isEmpty() );
+}
+
+void TestQgsNearestNeighborIndex::points()
+{
+  // a grid of 100 x 100 points, spanning several levels of the tree
+  QgsNearestNeighborIndex index;
+  for ( int i = 0; i < 10000; ++i )
+    index.addFeature( i, QgsGeometry::fromPointXY( QgsPointXY( i % 100, i / 100 ) ) );
+  index.build();
+  QCOMPARE( index.size(), 10000 );
+
+  QList< QgsNearestNeighborIndex::Neighbor > nearest = index.nearestNeighbors( QgsGeometry::fromPointXY( QgsPointXY( 10.1, 20.2 ) ), 1 );
+  QCOMPARE( nearest.size(), 1 );
+  QCOMPARE( nearest.at( 0 ).id, 2010LL );
+  QGSCOMPARENEAR( nearest.at( 0 ).distance, std::sqrt( 0.01 + 0.04 ), 1e-9 );
+  QCOMPARE( index.geometry( nearest.at( 0 ).index ).asWkt(), QStringLiteral( "Point (10 20)" ) );
+
+  // neighbors sorted by distance
+  nearest = index.nearestNeighbors( QgsGeometry::fromPointXY( QgsPointXY( 10.1, 20.2 ) ), 3 );
+  QCOMPARE( nearest.size(), 3 );
+  QCOMPARE( nearest.at( 0 ).id, 2010LL );
+  QCOMPARE( nearest.at( 1 ).id, 2110LL );
+  QCOMPARE( nearest.at( 2 ).id, 2011LL );
+
+  // features at the same distance as the last neighbor are kept, the excluded feature is skipped
+  nearest = index.nearestNeighbors( QgsGeometry::fromPointXY( QgsPointXY( 50, 50 ) ), 1, 0, 5050 );
+  QCOMPARE( nearest.size(), 4 );
+  for ( const QgsNearestNeighborIndex::Neighbor &neighbor : std::as_const( nearest ) )
+    QGSCOMPARENEAR( neighbor.distance, 1, 1e-9 );
+
+  // points at the origin
+  nearest = index.nearestNeighbors( QgsGeometry::fromPointXY( QgsPointXY( -1, -1 ) ), 1 );
+  QCOMPARE( nearest.size(), 1 );
+  QCOMPARE( nearest.at( 0 ).id, 0LL );
+
+  // maximum distance
+  QVERIFY( index.nearestNeighbors( QgsGeometry::fromPointXY( QgsPointXY( -10, -10 ) ), 1, 5 ).isEmpty() );
+  QCOMPARE( index.nearestNeighbors( QgsGeometry::fromPointXY( QgsPointXY( -3, 0 ) ), 5, 4 ).size(), 4 );
+}
+
+void TestQgsNearestNeighborIndex::lines()
+{
+  QgsNearestNeighborIndex index;
+  // long diagonal line, with a bounding box containing the other lines
+  index.addFeature( 1, QgsGeometry::fromWkt( QStringLiteral( "LineString (0 0, 100 100)" ) ) );
+  index.addFeature( 2, QgsGeometry::fromWkt( QStringLiteral( "LineString (0 90, 10 90)" ) ) );
+  index.addFeature( 3, QgsGeometry::fromWkt( QStringLiteral( "LineString (90 0, 90 10)" ) ) );
+  index.build();
+
+  // exact distances are used, not the distances to the bounding boxes
+  QList< QgsNearestNeighborIndex::Neighbor > nearest = index.nearestNeighbors( QgsGeometry::fromPointXY( QgsPointXY( 5, 80 ) ), 1 );
+  QCOMPARE( nearest.size(), 1 );
+  QCOMPARE( nearest.at( 0 ).id, 2LL );
+  QGSCOMPARENEAR( nearest.at( 0 ).distance, 10, 1e-9 );
+
+  nearest = index.nearestNeighbors( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((80 20, 85 20, 85 25, 80 25, 80 20))" ) ), 3 );
+  QCOMPARE( nearest.size(), 3 );
+  QCOMPARE( nearest.at( 0 ).id, 3LL );
+  QGSCOMPARENEAR( nearest.at( 0 ).distance, std::sqrt( 25 + 100 ), 1e-9 );
+  QCOMPARE( nearest.at( 1 ).id, 1LL );
+  QCOMPARE( nearest.at( 2 ).id, 2LL );
+}
+
+QGSTEST_MAIN( TestQgsNearestNeighborIndex )
+#include "testqgsnearestneighborindex.moc"
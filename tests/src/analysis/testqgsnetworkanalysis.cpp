@@ -25,6 +25,11 @@ Email                : nyall dot dawson at gmail dot com
 #include "qgsgraphbuilder.h"
 #include "qgsgraph.h"
 #include "qgsgraphanalyzer.h"
+#include "qgsgraphcontractionhierarchy.h"
+#include "qgscompactgraph.h"
+#include "qgscompactgraphbuilder.h"
+
+#include <QTemporaryDir>
 
 class TestQgsNetworkAnalysis : public QObject
 {
@@ -43,6 +48,8 @@ class TestQgsNetworkAnalysis : public QObject
     void dijkkjkjkskkjsktra();
     void testRouteFail();
     void testRouteFail2();
+    void testContractionHierarchy();
+    void testCompactGraph();
 
   private:
     std::unique_ptr< QgsVectorLayer > buildNetwork();
@@ -575,7 +582,192 @@ void TestQgsNetworkAnalysis::testRouteFail2()
   QCOMPARE( resultCost.at( endVertexIdx ), 9.01 );
 }
 
+void TestQgsNetworkAnalysis::testContractionHierarchy()
+{
+  // grid of 8 x 8 vertices with edges of varying costs, most of them in both directions
+  QgsGraph graph;
+  for ( int y = 0; y < 8; ++y )
+  {
+    for ( int x = 0; x < 8; ++x )
+      graph.addVertex( QgsPointXY( x, y ) );
+  }
+  for ( int y = 0; y < 8; ++y )
+  {
+    for ( int x = 0; x < 8; ++x )
+    {
+      const int vertex = y * 8 + x;
+      if ( x < 7 )
+      {
+        graph.addEdge( vertex, vertex + 1, QVector< QVariant >() << 1 + ( x * 7 + y * 3 ) % 5 );
+        if ( ( x + y ) % 4 != 0 )
+          graph.addEdge( vertex + 1, vertex, QVector< QVariant >() << 1 + ( x * 3 + y * 5 ) % 4 );
+      }
+      if ( y < 7 )
+      {
+        graph.addEdge( vertex, vertex + 8, QVector< QVariant >() << 1 + ( x * 5 + y ) % 6 );
+        graph.addEdge( vertex + 8, vertex, QVector< QVariant >() << 1 + ( x + y * 7 ) % 3 );
+      }
+    }
+  }
+  // a vertex without any edge
+  const int isolatedVertex = graph.addVertex( QgsPointXY( 20, 20 ) );
+
+  QgsGraphContractionHierarchy hierarchy;
+  QVERIFY( !hierarchy.isValid() );
+  QVERIFY( std::isinf( hierarchy.shortestPathCost( 0, 1 ) ) );
+  QVERIFY( hierarchy.build( &graph, 0 ) );
+  QVERIFY( hierarchy.isValid() );
+  QCOMPARE( hierarchy.vertexCount(), graph.vertexCount() );
+
+  // same costs as dijkstra, with paths of adjacent edges
+  QVector< QVector< double > > dijkstraCosts;
+  for ( int start = 0; start < graph.vertexCount(); ++start )
+  {
+    QVector<double> resultCost;
+    QgsGraphAnalyzer::dijkstra( &graph, start, 0, nullptr, &resultCost );
+    dijkstraCosts << resultCost;
+
+    for ( int end = 0; end < graph.vertexCount(); ++end )
+    {
+      double cost = 0;
+      const QVector<int> path = hierarchy.shortestPath( start, end, &cost );
+      QCOMPARE( cost, resultCost.at( end ) );
+      QCOMPARE( hierarchy.shortestPathCost( start, end ), resultCost.at( end ) );
+      if ( start == end || std::isinf( cost ) )
+      {
+        QVERIFY( path.isEmpty() );
+        continue;
+      }
+
+      QCOMPARE( graph.edge( path.first() ).fromVertex(), start );
+      QCOMPARE( graph.edge( path.last() ).toVertex(), end );
+      double pathCost = 0;
+      for ( int i = 0; i < path.count(); ++i )
+      {
+        if ( i > 0 )
+          QCOMPARE( graph.edge( path.at( i ) ).fromVertex(), graph.edge( path.at( i - 1 ) ).toVertex() );
+        pathCost += graph.edge( path.at( i ) ).cost( 0 ).toDouble();
+      }
+      QCOMPARE( pathCost, cost );
+    }
+  }
+  QVERIFY( std::isinf( hierarchy.shortestPathCost( 0, isolatedVertex ) ) );
+  QVERIFY( std::isinf( hierarchy.shortestPathCost( 0, 1000 ) ) );
+
+  // cost matrix
+  const QVector<int> startVertices = QVector<int>() << 0 << 9 << 63 << isolatedVertex;
+  const QVector<int> endVertices = QVector<int>() << 7 << 0 << 36 << isolatedVertex << 56;
+  const QVector< QVector< double > > matrix = hierarchy.costMatrix( startVertices, endVertices );
+  QCOMPARE( matrix.count(), startVertices.count() );
+  for ( int i = 0; i < startVertices.count(); ++i )
+  {
+    QCOMPARE( matrix.at( i ).count(), endVertices.count() );
+    for ( int j = 0; j < endVertices.count(); ++j )
+      QCOMPARE( matrix.at( i ).at( j ), dijkstraCosts.at( startVertices.at( i ) ).at( endVertices.at( j ) ) );
+  }
+
+  // write and read back
+  const QTemporaryDir dir;
+  const QString path = dir.filePath( QStringLiteral( "hierarchy.qgch" ) );
+  QString error;
+  QVERIFY( hierarchy.writeToFile( path, &error ) );
+  QVERIFY( error.isEmpty() );
+
+  QgsGraphContractionHierarchy readHierarchy;
+  QVERIFY( readHierarchy.readFromFile( path, &error ) );
+  QVERIFY( readHierarchy.isValid() );
+  QCOMPARE( readHierarchy.vertexCount(), hierarchy.vertexCount() );
+  QCOMPARE( readHierarchy.shortcutCount(), hierarchy.shortcutCount() );
+  for ( int end = 0; end < graph.vertexCount(); ++end )
+  {
+    QCOMPARE( readHierarchy.shortestPathCost( 5, end ), dijkstraCosts.at( 5 ).at( end ) );
+    QCOMPARE( readHierarchy.shortestPath( 5, end ), hierarchy.shortestPath( 5, end ) );
+  }
+
+  QVERIFY( !readHierarchy.readFromFile( dir.filePath( QStringLiteral( "missing.qgch" ) ), &error ) );
+  QVERIFY( !error.isEmpty() );
+  QVERIFY( !readHierarchy.isValid() );
+}
+
+
+void TestQgsNetworkAnalysis::testCompactGraph()
+{
+  std::unique_ptr<QgsVectorLayer> network = buildNetwork();
+  QgsFeature ff( 0 );
+  QgsFeatureList flist;
+  ff.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "LineString(10 10, 20 10 )" ) ) );
+  ff.setAttributes( QgsAttributes() << 2 );
+  flist << ff;
+  ff.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "LineString(10 20, 10 10 )" ) ) );
+  ff.setAttributes( QgsAttributes() << 3 );
+  flist << ff;
+  ff.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "LineString(20 -10, 20 10 )" ) ) );
+  ff.setAttributes( QgsAttributes() << 4 );
+  flist << ff;
+  network->dataProvider()->addFeatures( flist );
+
+  std::unique_ptr< QgsVectorLayerDirector > director = std::make_unique< QgsVectorLayerDirector > ( network.get(),
+      -1, QString(), QString(), QString(), QgsVectorLayerDirector::DirectionBoth );
+  std::unique_ptr< QgsNetworkStrategy > strategy = std::make_unique< TestNetworkStrategy >();
+  director->addStrategy( strategy.release() );
 
+  QVector<QgsPointXY > snapped;
+  std::unique_ptr< QgsGraphBuilder > builder = std::make_unique< QgsGraphBuilder > ( network->sourceCrs(), true, 0 );
+  director->makeGraph( builder.get(), QVector<QgsPointXY>(), snapped );
+  std::unique_ptr< QgsGraph > graph( builder->takeGraph() );
+
+  std::unique_ptr< QgsCompactGraphBuilder > compactBuilder = std::make_unique< QgsCompactGraphBuilder > ( network->sourceCrs(), true, 0 );
+  director->makeGraph( compactBuilder.get(), QVector<QgsPointXY>(), snapped );
+  std::unique_ptr< QgsCompactGraph > compactGraph( compactBuilder->takeCompactGraph() );
+
+  QCOMPARE( compactGraph->vertexCount(), graph->vertexCount() );
+  QCOMPARE( compactGraph->edgeCount(), graph->edgeCount() );
+  QCOMPARE( compactGraph->strategyCount(), 1 );
+
+  const QgsCompactGraph converted = QgsCompactGraph::fromGraph( *graph );
+  QCOMPARE( converted.vertexCount(), graph->vertexCount() );
+  QCOMPARE( converted.edgeCount(), graph->edgeCount() );
+
+  for ( const QgsCompactGraph *g : { compactGraph.get(), &converted } )
+  {
+    // vertices keep their indices, edges are grouped by start vertex
+    for ( int vertex = 0; vertex < graph->vertexCount(); ++vertex )
+    {
+      QCOMPARE( g->vertexPoint( vertex ), graph->vertex( vertex ).point() );
+      QCOMPARE( g->findVertex( graph->vertex( vertex ).point() ), vertex );
+      QCOMPARE( g->outgoingEdgeCount( vertex ), graph->vertex( vertex ).outgoingEdges().count() );
+      QCOMPARE( g->incomingEdges( vertex ).count(), graph->vertex( vertex ).incomingEdges().count() );
+      for ( int i = 0; i < g->outgoingEdgeCount( vertex ); ++i )
+        QCOMPARE( g->edgeFromVertex( g->firstOutgoingEdge( vertex ) + i ), vertex );
+      for ( const int edge : g->incomingEdges( vertex ) )
+        QCOMPARE( g->edgeToVertex( edge ), vertex );
+    }
+    QCOMPARE( g->findVertex( QgsPointXY( 100, 100 ) ), -1 );
+
+    // same shortest paths as over the graph
+    for ( int start = 0; start < graph->vertexCount(); ++start )
+    {
+      QVector<int> resultTree;
+      QVector<double> resultCost;
+      QgsGraphAnalyzer::dijkstra( graph.get(), start, 0, &resultTree, &resultCost );
+
+      QVector<int> compactTree;
+      QVector<double> compactCost;
+      QgsGraphAnalyzer::dijkstra( g, start, 0, &compactTree, &compactCost );
+      QCOMPARE( compactCost, resultCost );
+      for ( int vertex = 0; vertex < graph->vertexCount(); ++vertex )
+      {
+        if ( resultTree.at( vertex ) == -1 )
+        {
+          QCOMPARE( compactTree.at( vertex ), -1 );
+          continue;
+        }
+        QCOMPARE( g->edgeToVertex( compactTree.at( vertex ) ), vertex );
+        QCOMPARE( compactCost.at( g->edgeFromVertex( compactTree.at( vertex ) ) ) + g->edgeCost( compactTree.at( vertex ), 0 ), compactCost.at( vertex ) );
+      }
+    }
+  }
+}
 
 QGSTEST_MAIN( TestQgsNetworkAnalysis )
 #include "testqgsnetworkanalysis.moc"
@@ -28,6 +28,7 @@
 #endif
 
 #include <QDir>
+#include <QThreadPool>
 
 // If true regenerate raster reference images
 const bool REGENERATE_REFERENCES = false;
@@ -48,6 +49,7 @@ class TestNineCellFilters : public QObject
     void testAspect();
     void testRuggedness();
     void testTotalCurvature();
+    void testThreadCount();
 #ifdef HAVE_OPENCL
     void testHillshadeCl();
     void testSlopeCl();
@@ -173,6 +175,38 @@ void TestNineCellFilters::testRuggedness()
   _testAlg<QgsRuggednessFilter>( QStringLiteral( "ruggedness" ) );
 }
 
+void TestNineCellFilters::testThreadCount()
+{
+#ifdef HAVE_OPENCL
+  QgsOpenClUtils::setEnabled( false );
+#endif
+
+  // the output does not depend on the number of threads processing the rows
+  auto readOutput = [this]( const QString & file, int threadCount ) -> std::vector< float >
+  {
+    const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount( threadCount );
+    QgsHillshadeFilter filter( SRC_FILE, file, QStringLiteral( "GTiff" ), 300, 40 );
+    const int res = filter.processRaster();
+    QThreadPool::globalInstance()->setMaxThreadCount( maxThreadCount );
+    if ( res != 0 )
+      return std::vector< float >();
+
+    const gdal::dataset_unique_ptr ds( GDALOpen( file.toUtf8().constData(), GA_ReadOnly ) );
+    const int xSize = GDALGetRasterXSize( ds.get() );
+    const int ySize = GDALGetRasterYSize( ds.get() );
+    std::vector< float > values( static_cast< std::size_t >( xSize ) * ySize );
+    if ( GDALRasterIO( GDALGetRasterBand( ds.get(), 1 ), GF_Read, 0, 0, xSize, ySize, values.data(), xSize, ySize, GDT_Float32, 0, 0 ) != CE_None )
+      return std::vector< float >();
+    return values;
+  };
+
+  const std::vector< float > singleThread = readOutput( tempFile( QStringLiteral( "hillshade_1_thread" ) ), 1 );
+  const std::vector< float > multipleThreads = readOutput( tempFile( QStringLiteral( "hillshade_4_threads" ) ), 4 );
+  QVERIFY( !singleThread.empty() );
+  QVERIFY( singleThread == multipleThreads );
+}
+
 void TestNineCellFilters::_rasterCompare( QgsAlignRaster::RasterInfo &out,  QgsAlignRaster::RasterInfo &ref )
 {
   const QSize refSize( ref.rasterSize() );
@@ -27,6 +27,8 @@
 #include <QtTest/QSignalSpy>
 #include <QList>
 #include <QFileInfo>
+#include <QThreadPool>
+#include <QThread>
 #include "qgis.h"
 #include "qgstest.h"
 #include "qgsrasterlayer.h"
@@ -55,7 +57,9 @@
 #include "qgspointcloudlayer.h"
 #include "qgsannotationlayer.h"
 #include "qgsjsonutils.h"
+#include "qgsprocessingbatch.h"
 #include "json.hpp"
+#include <atomic>
 
 class DummyAlgorithm : public QgsProcessingAlgorithm
 {
@@ -551,6 +555,43 @@ class DummyAlgorithm2 : public QgsProcessingAlgorithm
 
 };
 
+class DummyFeatureBasedAlgorithm : public QgsProcessingFeatureBasedAlgorithm
+{
+  public:
+
+    DummyFeatureBasedAlgorithm( Flags flags, int failAt = -1 ) : mFlags( flags ), mFailAt( failAt ) {}
+
+    QString name() const override { return QStringLiteral( "dummyfeaturebased" ); }
+    QString displayName() const override { return QStringLiteral( "dummyfeaturebased" ); }
+    Flags flags() const override { return QgsProcessingFeatureBasedAlgorithm::flags() | mFlags; }
+    DummyFeatureBasedAlgorithm *createInstance() const override { return new DummyFeatureBasedAlgorithm( mFlags, mFailAt ); }
+
+  protected:
+
+    QString outputName() const override { return QStringLiteral( "output" ); }
+    QgsFeatureList processFeature( const QgsFeature &feature, QgsProcessingContext &, QgsProcessingFeedback *feedback ) override
+    {
+      const int value = feature.attribute( 0 ).toInt();
+      if ( value == mFailAt )
+        throw QgsProcessingException( QStringLiteral( "failed at %1" ).arg( value ) );
+      if ( value % 100 == 0 )
+        feedback->pushInfo( QString::number( value ) );
+
+      // features with multiples of 3 are dropped, odd ones are duplicated
+      QgsFeatureList outputs;
+      if ( value % 3 != 0 )
+        outputs << feature;
+      if ( value % 3 != 0 && value % 2 != 0 )
+        outputs << feature;
+      return outputs;
+    }
+
+  private:
+
+    Flags mFlags;
+    int mFailAt = -1;
+};
+
 class DummyProvider3 : public QgsProcessingProvider // clazy:exclude=missing-qobject-macro
 {
   public:
@@ -691,6 +732,53 @@ class DummyPluginLayer: public QgsPluginLayer
     void setTransformContext( const QgsCoordinateTransformContext &transformContext ) override { Q_UNUSED( transformContext ); };
 };
 
+class DummyBatchAlgorithm : public QgsProcessingAlgorithm
+{
+  public:
+
+    DummyBatchAlgorithm( Flags flags ) : mFlags( flags ) {}
+
+    void initAlgorithm( const QVariantMap & = QVariantMap() ) override
+    {
+      addParameter( new QgsProcessingParameterNumber( QStringLiteral( "ROW" ) ) );
+      addParameter( new QgsProcessingParameterNumber( QStringLiteral( "DELAY" ) ) );
+      addParameter( new QgsProcessingParameterBoolean( QStringLiteral( "FAIL" ), QString(), false ) );
+      addOutput( new QgsProcessingOutputNumber( QStringLiteral( "OUTPUT" ), QString() ) );
+    }
+    QString name() const override { return QStringLiteral( "batch" ); }
+    QString displayName() const override { return QStringLiteral( "batch" ); }
+    Flags flags() const override { return mFlags; }
+    DummyBatchAlgorithm *createInstance() const override { return new DummyBatchAlgorithm( mFlags ); }
+
+    QVariantMap processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override
+    {
+      const int running = ++sRunning;
+      int maxRunning = sMaxRunning;
+      while ( running > maxRunning && !sMaxRunning.compare_exchange_weak( maxRunning, running ) ) {}
+
+      const int row = parameterAsInt( parameters, QStringLiteral( "ROW" ), context );
+      feedback->pushInfo( QStringLiteral( "row %1" ).arg( row ) );
+      QThread::msleep( static_cast< unsigned long >( parameterAsInt( parameters, QStringLiteral( "DELAY" ), context ) ) );
+      feedback->setProgress( 50 );
+      --sRunning;
+
+      if ( parameterAsBoolean( parameters, QStringLiteral( "FAIL" ), context ) )
+        throw QgsProcessingException( QStringLiteral( "row %1 failed" ).arg( row ) );
+
+      return QVariantMap( { { QStringLiteral( "OUTPUT" ), row } } );
+    }
+
+    static std::atomic< int > sRunning;
+    static std::atomic< int > sMaxRunning;
+
+  private:
+
+    Flags mFlags;
+};
+
+std::atomic< int > DummyBatchAlgorithm::sRunning{ 0 };
+std::atomic< int > DummyBatchAlgorithm::sMaxRunning{ 0 };
+
 class TestQgsProcessing: public QObject
 {
     Q_OBJECT
@@ -783,6 +871,7 @@ class TestQgsProcessing: public QObject
     void combineLayerExtent();
     void processingFeatureSource();
     void processingFeatureSink();
+    void parallelFeatureProcessing();
     void algorithmScope();
     void validateInputCrs();
     void generateIteratingDestination();
@@ -808,6 +897,7 @@ class TestQgsProcessing: public QObject
     void sourceTypeToString();
     void formatHelp();
     void preprocessParameters();
+    void batchExecutor();
 
   private:
 
@@ -10941,6 +11031,74 @@ void TestQgsProcessing::processingFeatureSink()
   QCOMPARE( pythonCode, QStringLiteral( "QgsProcessingParameterFeatureSink('layer', '', optional=True, type=QgsProcessing.TypeMapLayer, createByDefault=True, defaultValue='memory:defaultlayer')" ) );
 }
 
+void TestQgsProcessing::parallelFeatureProcessing()
+{
+  class RecordingFeedback : public QgsProcessingFeedback
+  {
+    public:
+      void pushInfo( const QString &info ) override { messages << info; }
+      QStringList messages;
+  };
+
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Point?field=value:integer" ), QStringLiteral( "v1" ), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  for ( int i = 0; i < 2000; ++i )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+  QgsProject p;
+  p.addMapLayer( layer );
+
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), layer->id() );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+  const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+  QThreadPool::globalInstance()->setMaxThreadCount( 4 );
+
+  const auto runAlgorithm = [&]( QgsProcessingAlgorithm::Flags flags, QList< int > &values, QStringList &messages, int failAt = -1 ) -> bool
+  {
+    const std::unique_ptr< QgsProcessingAlgorithm > alg( DummyFeatureBasedAlgorithm( flags, failAt ).create() );
+    QgsProcessingContext context;
+    context.setProject( &p );
+    RecordingFeedback feedback;
+    bool ok = false;
+    const QVariantMap results = alg->run( parameters, context, &feedback, &ok );
+    messages = feedback.messages;
+    if ( QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) ) )
+    {
+      QgsFeature f;
+      QgsFeatureIterator it = output->getFeatures();
+      while ( it.nextFeature( f ) )
+        values << f.attribute( 0 ).toInt();
+    }
+    return ok;
+  };
+
+  QList< int > serialValues;
+  QStringList serialMessages;
+  QVERIFY( runAlgorithm( QgsProcessingAlgorithm::Flags(), serialValues, serialMessages ) );
+  QCOMPARE( serialValues.size(), 2000 );
+  QCOMPARE( serialMessages.size(), 20 );
+
+  // same outputs and messages, in the same order
+  QList< int > parallelValues;
+  QStringList parallelMessages;
+  QVERIFY( runAlgorithm( QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing, parallelValues, parallelMessages ) );
+  QCOMPARE( parallelValues, serialValues );
+  QCOMPARE( parallelMessages, serialMessages );
+
+  // exceptions are raised from the algorithm thread
+  parallelValues.clear();
+  QVERIFY( !runAlgorithm( QgsProcessingAlgorithm::FlagSupportsParallelFeatureProcessing, parallelValues, parallelMessages, 1500 ) );
+
+  QThreadPool::globalInstance()->setMaxThreadCount( maxThreadCount );
+}
+
 void TestQgsProcessing::algorithmScope()
 {
   QgsProcessingContext pc;
@@ -11749,5 +11907,111 @@ void TestQgsProcessing::preprocessParameters()
   QCOMPARE( outputs.value( QStringLiteral( "DISTANCE" ) ).value< QgsProperty >().expressionString(), QStringLiteral( "A_FIELD * 200" ) );
 }
 
+void TestQgsProcessing::batchExecutor()
+{
+  for ( const bool threaded : { true, false } )
+  {
+    DummyBatchAlgorithm alg( threaded ? QgsProcessingAlgorithm::Flags() : QgsProcessingAlgorithm::FlagNoThreading );
+    DummyBatchAlgorithm::sMaxRunning = 0;
+
+    // later rows complete first, and the third row fails
+    QList< QVariantMap > parameters;
+    for ( int row = 0; row < 6; ++row )
+    {
+      parameters << QVariantMap(
+      {
+        { QStringLiteral( "ROW" ), row },
+        { QStringLiteral( "DELAY" ), ( 6 - row ) * 30 },
+        { QStringLiteral( "FAIL" ), row == 2 }
+      } );
+    }
+
+    QList< int > createdContexts;
+    QgsProcessingBatchExecutor executor( &alg, parameters, [&createdContexts]( int row, QgsProcessingFeedback * feedback )
+    {
+      createdContexts << row;
+      QgsProcessingContext *context = new QgsProcessingContext();
+      context->setFeedback( feedback );
+      return context;
+    } );
+    executor.setMaximumConcurrentRows( 3 );
+    QCOMPARE( executor.rowCount(), 6 );
+
+    QList< int > reportedRows;
+    QList< bool > reportedSuccess;
+    QgsProcessingFeedback rowLog( false );
+    QStringList errors;
+    connect( &executor, &QgsProcessingBatchExecutor::rowFinished, this, [&]( int row, bool successful, const QVariantMap & results )
+    {
+      // the row's context and feedback are available until it is reported
+      QVERIFY( executor.rowContext( row ) );
+      QVERIFY( executor.rowFeedback( row ) );
+      QCOMPARE( executor.rowParameters( row ).value( QStringLiteral( "ROW" ) ).toInt(), row );
+      executor.rowFeedback( row )->replay( &rowLog );
+      errors << executor.rowFeedback( row )->errors();
+
+      reportedRows << row;
+      reportedSuccess << successful;
+      if ( successful )
+        QCOMPARE( results.value( QStringLiteral( "OUTPUT" ) ).toInt(), row );
+    } );
+    QSignalSpy finishedSpy( &executor, &QgsProcessingBatchExecutor::finished );
+
+    QgsProcessingFeedback feedback( false );
+    executor.start( &feedback );
+    if ( finishedSpy.isEmpty() )
+      QVERIFY( finishedSpy.wait( 10000 ) );
+
+    QCOMPARE( finishedSpy.count(), 1 );
+    QCOMPARE( finishedSpy.at( 0 ).at( 0 ).toBool(), false );
+    QCOMPARE( reportedRows, QList< int >() << 0 << 1 << 2 << 3 << 4 << 5 );
+    QCOMPARE( reportedSuccess, QList< bool >() << true << true << false << true << true << true );
+    QCOMPARE( createdContexts, QList< int >() << 0 << 1 << 2 << 3 << 4 << 5 );
+    QCOMPARE( feedback.progress(), 100.0 );
+    QCOMPARE( errors, QStringList() << QStringLiteral( "row 2 failed" ) );
+    QVERIFY( rowLog.textLog().startsWith( QStringLiteral( "row 0\nrow 1\nrow 2\n" ) ) );
+    QVERIFY( rowLog.textLog().indexOf( QStringLiteral( "row 5" ) ) > rowLog.textLog().indexOf( QStringLiteral( "row 4" ) ) );
+
+    // contexts and feedback are released once rows are reported
+    QVERIFY( !executor.rowContext( 0 ) );
+    QVERIFY( !executor.rowFeedback( 5 ) );
+
+    if ( threaded && QThreadPool::globalInstance()->maxThreadCount() > 1 )
+      QVERIFY( DummyBatchAlgorithm::sMaxRunning > 1 );
+    else if ( !threaded )
+      QCOMPARE( DummyBatchAlgorithm::sMaxRunning.load(), 1 );
+  }
+
+  // canceling stops the batch
+  DummyBatchAlgorithm alg( QgsProcessingAlgorithm::Flags() );
+  QList< QVariantMap > parameters;
+  for ( int row = 0; row < 20; ++row )
+    parameters << QVariantMap( { { QStringLiteral( "ROW" ), row }, { QStringLiteral( "DELAY" ), 20 } } );
+
+  QgsProcessingBatchExecutor executor( &alg, parameters, []( int, QgsProcessingFeedback * feedback )
+  {
+    QgsProcessingContext *context = new QgsProcessingContext();
+    context->setFeedback( feedback );
+    return context;
+  } );
+  executor.setMaximumConcurrentRows( 2 );
+  QgsProcessingFeedback feedback( false );
+  QList< int > reportedRows;
+  connect( &executor, &QgsProcessingBatchExecutor::rowFinished, this, [&]( int row, bool, const QVariantMap & )
+  {
+    reportedRows << row;
+    if ( row == 1 )
+      feedback.cancel();
+  } );
+  QSignalSpy finishedSpy( &executor, &QgsProcessingBatchExecutor::finished );
+  executor.start( &feedback );
+  QVERIFY( finishedSpy.wait( 10000 ) );
+  QCOMPARE( finishedSpy.at( 0 ).at( 0 ).toBool(), true );
+  QVERIFY( executor.isCanceled() );
+  QVERIFY( reportedRows.size() < 20 );
+  for ( int i = 0; i < reportedRows.size(); ++i )
+    QCOMPARE( reportedRows.at( i ), i );
+}
+
 QGSTEST_MAIN( TestQgsProcessing )
 #include "testqgsprocessing.moc"
@@ -1073,6 +1073,32 @@ void TestQgsProcessingAlgsPt1::kmeansCluster()
   QCOMPARE( features[ 0 ].cluster, -1 );
   QCOMPARE( features[ 1 ].cluster, -1 );
   QCOMPARE( features[ 2 ].cluster, -1 );
+
+  // two distant groups of points, spanning several chunks of points assigned in parallel
+  features.clear();
+  for ( int i = 0; i < 15000; ++i )
+  {
+    features.emplace_back( QgsKMeansClusteringAlgorithm::Feature( QgsPointXY( i % 100, i / 100 ) ) );
+    features.emplace_back( QgsKMeansClusteringAlgorithm::Feature( QgsPointXY( 10000 + i % 100, i / 100 ) ) );
+  }
+  k = 2;
+  centers.resize( 2 );
+  QgsKMeansClusteringAlgorithm::initClustersPlusPlus( features, centers, k, nullptr );
+  QgsKMeansClusteringAlgorithm::calculateKMeans( features, centers, k, nullptr );
+  QVERIFY( features[ 0 ].cluster != features[ 1 ].cluster );
+  for ( std::size_t i = 2; i < features.size(); ++i )
+    QCOMPARE( features[ i ].cluster, features[ i % 2 ].cluster );
+
+  // mini-batches
+  for ( QgsKMeansClusteringAlgorithm::Feature &feature : features )
+    feature.cluster = -1;
+  QgsKMeansClusteringAlgorithm::initClustersPlusPlus( features, centers, k, nullptr );
+  QgsKMeansClusteringAlgorithm::calculateMiniBatchKMeans( features, centers, k, 500, nullptr );
+  QVERIFY( features[ 0 ].cluster != features[ 1 ].cluster );
+  for ( std::size_t i = 2; i < features.size(); ++i )
+    QCOMPARE( features[ i ].cluster, features[ i % 2 ].cluster );
+  QGSCOMPARENEAR( centers[ features[ 0 ].cluster ].x(), 49.5, 5 );
+  QGSCOMPARENEAR( centers[ features[ 1 ].cluster ].x(), 10049.5, 5 );
 }
 
 void TestQgsProcessingAlgsPt1::categorizeByStyle()
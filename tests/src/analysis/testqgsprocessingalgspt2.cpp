@@ -106,6 +106,7 @@ class TestQgsProcessingAlgsPt2: public QObject
     void fileDownloader();
 
     void rasterize();
+    void rasterizePolygons();
 
     void convertGpxFeatureType();
     void convertGpsData();
@@ -118,6 +119,8 @@ class TestQgsProcessingAlgsPt2: public QObject
     void splitVectorLayer();
     void buffer();
     void splitWithLines();
+    void odMatrix();
+    void dissolve();
 
   private:
 
@@ -1208,6 +1211,76 @@ void TestQgsProcessingAlgsPt2::rasterize()
   QVERIFY( checker.compareImages( "rasterize", 500 ) );
 }
 
+void TestQgsProcessingAlgsPt2::rasterizePolygons()
+{
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:rasterizepolygons" ) ) );
+  QVERIFY( alg != nullptr );
+
+  std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?crs=epsg:3857&field=value:double" ), QStringLiteral( "polygons" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsFeature f( layer->fields() );
+  f.setAttributes( QgsAttributes() << 1.0 );
+  f.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 600 0, 600 600, 0 600, 0 0))" ) ) );
+  QgsFeature f2( layer->fields() );
+  f2.setAttributes( QgsAttributes() << 2.0 );
+  f2.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((500 500, 1100 500, 1100 1100, 500 1100, 500 500))" ) ) );
+  QgsFeature f3( layer->fields() );
+  f3.setAttributes( QgsAttributes() << QVariant() );
+  f3.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 700, 300 700, 300 1000, 0 1000, 0 700))" ) ) );
+  QVERIFY( layer->dataProvider()->addFeatures( QgsFeatureList() << f << f2 << f3 ) );
+
+  const QString outputTif = QDir::tempPath() + "/rasterize_polygons_output.tif";
+  if ( QFile::exists( outputTif ) )
+    QFile::remove( outputTif );
+
+  // the 1100 x 1100 pixels output spans several tiles in both directions
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( layer.get() ) );
+  parameters.insert( QStringLiteral( "FIELD" ), QStringLiteral( "value" ) );
+  parameters.insert( QStringLiteral( "PIXEL_SIZE" ), 1 );
+  parameters.insert( QStringLiteral( "NODATA" ), -1 );
+  parameters.insert( QStringLiteral( "OUTPUT" ), outputTif );
+
+  std::unique_ptr< QgsProcessingContext > context = std::make_unique< QgsProcessingContext >();
+  QgsProcessingFeedback feedback;
+  bool ok = false;
+  const QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+  QCOMPARE( results.value( QStringLiteral( "OUTPUT" ) ).toString(), outputTif );
+
+  std::unique_ptr< QgsRasterLayer > raster = std::make_unique< QgsRasterLayer >( outputTif, QStringLiteral( "raster" ), QStringLiteral( "gdal" ) );
+  QVERIFY( raster->isValid() );
+  QCOMPARE( raster->width(), 1100 );
+  QCOMPARE( raster->height(), 1100 );
+  QCOMPARE( raster->extent(), QgsRectangle( 0, 0, 1100, 1100 ) );
+
+  QgsRasterDataProvider *provider = raster->dataProvider();
+  QCOMPARE( provider->sample( QgsPointXY( 0.5, 0.5 ), 1 ), 1.0 );
+  QCOMPARE( provider->sample( QgsPointXY( 599.5, 10.5 ), 1 ), 1.0 );
+  QVERIFY( std::isnan( provider->sample( QgsPointXY( 600.5, 10.5 ), 1 ) ) );
+  // the last polygon wins where polygons overlap
+  QCOMPARE( provider->sample( QgsPointXY( 550.5, 550.5 ), 1 ), 2.0 );
+  QCOMPARE( provider->sample( QgsPointXY( 1099.5, 1099.5 ), 1 ), 2.0 );
+  // polygons without a burn value are skipped
+  QVERIFY( std::isnan( provider->sample( QgsPointXY( 100.5, 800.5 ), 1 ) ) );
+
+  // fixed burn value
+  raster.reset();
+  QFile::remove( outputTif );
+  parameters.remove( QStringLiteral( "FIELD" ) );
+  parameters.insert( QStringLiteral( "BURN" ), 5 );
+  parameters.insert( QStringLiteral( "EXTENT" ), QStringLiteral( "0,400,0,400 [EPSG:3857]" ) );
+  alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+
+  raster = std::make_unique< QgsRasterLayer >( outputTif, QStringLiteral( "raster" ), QStringLiteral( "gdal" ) );
+  QVERIFY( raster->isValid() );
+  QCOMPARE( raster->width(), 400 );
+  QCOMPARE( raster->height(), 400 );
+  QCOMPARE( raster->dataProvider()->sample( QgsPointXY( 10.5, 10.5 ), 1 ), 5.0 );
+  QCOMPARE( raster->dataProvider()->sample( QgsPointXY( 200.5, 390.5 ), 1 ), 5.0 );
+}
+
 void TestQgsProcessingAlgsPt2::convertGpxFeatureType()
 {
   // test generation of babel argument lists
@@ -1896,5 +1969,160 @@ bool TestQgsProcessingAlgsPt2::imageCheck( const QString &testName, const QStrin
   return equal;
 }
 
+void TestQgsProcessingAlgsPt2::odMatrix()
+{
+  std::unique_ptr< QgsVectorLayer > network = std::make_unique< QgsVectorLayer >( QStringLiteral( "LineString?crs=epsg:3857" ), QStringLiteral( "network" ), QStringLiteral( "memory" ) );
+  QVERIFY( network->isValid() );
+  QgsFeature f;
+  f.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "LineString (0 0, 10 0, 10 10)" ) ) );
+  network->dataProvider()->addFeature( f );
+
+  // the points of the multipoint origin are separate origins with the same ID
+  std::unique_ptr< QgsVectorLayer > origins = std::make_unique< QgsVectorLayer >( QStringLiteral( "MultiPoint?crs=epsg:3857&field=name:string" ), QStringLiteral( "origins" ), QStringLiteral( "memory" ) );
+  QVERIFY( origins->isValid() );
+  QgsFeature origin( origins->fields() );
+  origin.setAttributes( QgsAttributes() << QStringLiteral( "a" ) );
+  origin.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "MultiPoint ((0 0), (10 0))" ) ) );
+  origins->dataProvider()->addFeature( origin );
+  origin.setAttributes( QgsAttributes() << QStringLiteral( "b" ) );
+  origin.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "MultiPoint ((10 10))" ) ) );
+  origins->dataProvider()->addFeature( origin );
+
+  std::unique_ptr< QgsVectorLayer > destinations = std::make_unique< QgsVectorLayer >( QStringLiteral( "Point?crs=epsg:3857&field=name:string" ), QStringLiteral( "destinations" ), QStringLiteral( "memory" ) );
+  QVERIFY( destinations->isValid() );
+  QgsFeature destination( destinations->fields() );
+  destination.setAttributes( QgsAttributes() << QStringLiteral( "x" ) );
+  destination.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Point (10 10)" ) ) );
+  destinations->dataProvider()->addFeature( destination );
+  destination.setAttributes( QgsAttributes() << QStringLiteral( "y" ) );
+  destination.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Point (0 0)" ) ) );
+  destinations->dataProvider()->addFeature( destination );
+
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:odmatrix" ) ) );
+  QVERIFY( alg != nullptr );
+
+  const auto runMatrix = [&]( const QString & startIdField, const QString & endIdField )
+  {
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( network.get() ) );
+    parameters.insert( QStringLiteral( "STRATEGY" ), 0 );
+    parameters.insert( QStringLiteral( "START_POINTS" ), QVariant::fromValue( origins.get() ) );
+    parameters.insert( QStringLiteral( "START_ID_FIELD" ), startIdField );
+    parameters.insert( QStringLiteral( "END_POINTS" ), QVariant::fromValue( destinations.get() ) );
+    parameters.insert( QStringLiteral( "END_ID_FIELD" ), endIdField );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+    bool ok = false;
+    std::unique_ptr< QgsProcessingContext > context = std::make_unique< QgsProcessingContext >();
+    QgsProcessingFeedback feedback;
+    const QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+    QStringList rows;
+    if ( !ok )
+      return rows;
+
+    QgsVectorLayer *resultLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+    if ( !resultLayer )
+      return rows;
+
+    QgsFeatureIterator it = resultLayer->getFeatures();
+    QgsFeature row;
+    while ( it.nextFeature( row ) )
+      rows << QStringLiteral( "%1,%2,%3" ).arg( row.attribute( 0 ).toString(), row.attribute( 1 ).toString(), row.attribute( 2 ).toString() );
+    return rows;
+  };
+
+  // rows follow the order of the origin points, then of the destinations
+  QCOMPARE( runMatrix( QStringLiteral( "name" ), QStringLiteral( "name" ) ), QStringList()
+            << QStringLiteral( "a,x,20" ) << QStringLiteral( "a,y,0" )
+            << QStringLiteral( "a,x,10" ) << QStringLiteral( "a,y,10" )
+            << QStringLiteral( "b,x,0" ) << QStringLiteral( "b,y,20" ) );
+
+  // without ID fields the points are identified by the number of their feature
+  QCOMPARE( runMatrix( QString(), QString() ), QStringList()
+            << QStringLiteral( "1,1,20" ) << QStringLiteral( "1,2,0" )
+            << QStringLiteral( "1,1,10" ) << QStringLiteral( "1,2,10" )
+            << QStringLiteral( "2,1,0" ) << QStringLiteral( "2,2,20" ) );
+}
+
+void TestQgsProcessingAlgsPt2::dissolve()
+{
+  // a grid of squares, more than are united in a single chunk, with the classes of the left and right halves interleaved
+  std::unique_ptr< QgsVectorLayer > unsorted = std::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?crs=epsg:3857&field=cls:string" ), QStringLiteral( "unsorted" ), QStringLiteral( "memory" ) );
+  std::unique_ptr< QgsVectorLayer > sorted = std::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?crs=epsg:3857&field=cls:string" ), QStringLiteral( "sorted" ), QStringLiteral( "memory" ) );
+  QgsFeatureList left;
+  QgsFeatureList right;
+  QgsFeatureList interleaved;
+  QVector< QgsGeometry > squares;
+  for ( int y = 0; y < 20; ++y )
+  {
+    for ( int x = 0; x < 20; ++x )
+    {
+      QgsFeature f( unsorted->fields() );
+      f.setAttributes( QgsAttributes() << ( x < 10 ? QStringLiteral( "left" ) : QStringLiteral( "right" ) ) );
+      f.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, y, x + 1, y + 1 ) ) );
+      squares << f.geometry();
+      interleaved << f;
+      ( x < 10 ? left : right ) << f;
+    }
+  }
+  QVERIFY( unsorted->dataProvider()->addFeatures( interleaved ) );
+  QVERIFY( sorted->dataProvider()->addFeatures( left ) );
+  QVERIFY( sorted->dataProvider()->addFeatures( right ) );
+
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:dissolve" ) ) );
+  QVERIFY( alg != nullptr );
+
+  const auto runDissolve = [&]( QgsVectorLayer * layer, const QString & field, bool sortedInput )
+  {
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( layer ) );
+    if ( !field.isEmpty() )
+      parameters.insert( QStringLiteral( "FIELD" ), QStringList() << field );
+    parameters.insert( QStringLiteral( "SORTED_INPUT" ), sortedInput );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+    bool ok = false;
+    std::unique_ptr< QgsProcessingContext > context = std::make_unique< QgsProcessingContext >();
+    QgsProcessingFeedback feedback;
+    const QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+    QMap< QString, QgsGeometry > geometries;
+    if ( !ok )
+      return geometries;
+
+    QgsVectorLayer *resultLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+    if ( !resultLayer )
+      return geometries;
+
+    QgsFeatureIterator it = resultLayer->getFeatures();
+    QgsFeature f;
+    while ( it.nextFeature( f ) )
+      geometries.insert( f.attribute( 0 ).toString(), f.geometry() );
+    return geometries;
+  };
+
+  const auto sameArea = []( const QgsGeometry & geometry, const QgsGeometry & expected )
+  {
+    return qgsDoubleNear( geometry.area(), expected.area() ) && qgsDoubleNear( geometry.symDifference( expected ).area(), 0 );
+  };
+
+  // the chunked union of all the features matches the sequential union
+  const QMap< QString, QgsGeometry > all = runDissolve( unsorted.get(), QString(), false );
+  QCOMPARE( all.size(), 1 );
+  const QgsGeometry sequentialUnion = QgsGeometry::unaryUnion( squares );
+  QVERIFY( sameArea( all.first(), sequentialUnion ) );
+  QVERIFY( sameArea( all.first(), QgsGeometry::fromRect( QgsRectangle( 0, 0, 20, 20 ) ) ) );
+
+  // dissolving the sorted features as they are read gives the same classes as dissolving the unsorted features
+  const QMap< QString, QgsGeometry > unsortedClasses = runDissolve( unsorted.get(), QStringLiteral( "cls" ), false );
+  const QMap< QString, QgsGeometry > sortedClasses = runDissolve( sorted.get(), QStringLiteral( "cls" ), true );
+  QCOMPARE( unsortedClasses.keys(), QStringList() << QStringLiteral( "left" ) << QStringLiteral( "right" ) );
+  QCOMPARE( sortedClasses.keys(), unsortedClasses.keys() );
+  const QStringList classes = unsortedClasses.keys();
+  for ( const QString &cls : classes )
+    QVERIFY( sameArea( sortedClasses.value( cls ), unsortedClasses.value( cls ) ) );
+  QVERIFY( sameArea( sortedClasses.value( QStringLiteral( "left" ) ), QgsGeometry::fromRect( QgsRectangle( 0, 0, 10, 20 ) ) ) );
+  QVERIFY( sameArea( sortedClasses.value( QStringLiteral( "right" ) ), QgsGeometry::fromRect( QgsRectangle( 10, 0, 20, 20 ) ) ) );
+}
+
 QGSTEST_MAIN( TestQgsProcessingAlgsPt2 )
 #include "testqgsprocessingalgspt2.moc"
@@ -24,6 +24,8 @@
 #include "qgsexpressioncontextutils.h"
 #include "qgsxmlutils.h"
 #include "qgsprocessingprovider.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectordataprovider.h"
 
 
 class DummyAlgorithm2 : public QgsProcessingAlgorithm
@@ -96,6 +98,8 @@ class TestQgsProcessingModelAlgorithm: public QObject
     void modelExecution();
     void modelBranchPruning();
     void modelBranchPruningConditional();
+    void modelStreamedChildAlgorithms();
+    void modelConcurrentChildAlgorithms();
     void modelWithProviderWithLimitedTypes();
     void modelVectorOutputIsCompatibleType();
     void modelAcceptableValues();
@@ -1616,6 +1620,180 @@ void TestQgsProcessingModelAlgorithm::modelBranchPruning()
   QVERIFY( !results.contains( QStringLiteral( "buffer3:BUFFER3_OUTPUT" ) ) );
 }
 
+void TestQgsProcessingModelAlgorithm::modelStreamedChildAlgorithms()
+{
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3111&field=id:integer" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  for ( int i = 0; i < 1000; ++i )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, -i ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+  QgsProject p;
+  p.addMapLayer( layer );
+
+  // a chain of feature based algorithms, the last one requesting its features sorted
+  QgsProcessingModelAlgorithm model;
+  QgsProcessingModelParameter param;
+  param.setParameterName( QStringLiteral( "LAYER" ) );
+  model.addModelParameter( new QgsProcessingParameterFeatureSource( QStringLiteral( "LAYER" ) ), param );
+
+  QgsProcessingModelChildAlgorithm algc1;
+  algc1.setChildId( QStringLiteral( "multi" ) );
+  algc1.setAlgorithmId( QStringLiteral( "native:promotetomulti" ) );
+  algc1.addParameterSources( QStringLiteral( "INPUT" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromModelParameter( QStringLiteral( "LAYER" ) ) );
+  model.addChildAlgorithm( algc1 );
+
+  QgsProcessingModelChildAlgorithm algc2;
+  algc2.setChildId( QStringLiteral( "number" ) );
+  algc2.setAlgorithmId( QStringLiteral( "native:addautoincrementalfield" ) );
+  algc2.addParameterSources( QStringLiteral( "INPUT" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromChildOutput( QStringLiteral( "multi" ), QStringLiteral( "OUTPUT" ) ) );
+  algc2.addParameterSources( QStringLiteral( "FIELD_NAME" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromStaticValue( QStringLiteral( "n1" ) ) );
+  model.addChildAlgorithm( algc2 );
+
+  QgsProcessingModelChildAlgorithm algc3;
+  algc3.setChildId( QStringLiteral( "sorted" ) );
+  algc3.setAlgorithmId( QStringLiteral( "native:addautoincrementalfield" ) );
+  algc3.addParameterSources( QStringLiteral( "INPUT" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromChildOutput( QStringLiteral( "number" ), QStringLiteral( "OUTPUT" ) ) );
+  algc3.addParameterSources( QStringLiteral( "FIELD_NAME" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromStaticValue( QStringLiteral( "n2" ) ) );
+  algc3.addParameterSources( QStringLiteral( "SORT_EXPRESSION" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromStaticValue( QStringLiteral( "-\"n1\"" ) ) );
+  QMap<QString, QgsProcessingModelOutput> outputs;
+  QgsProcessingModelOutput out( QStringLiteral( "SORTED" ) );
+  out.setChildOutputName( QStringLiteral( "OUTPUT" ) );
+  outputs.insert( QStringLiteral( "SORTED" ), out );
+  algc3.setModelOutputs( outputs );
+  model.addChildAlgorithm( algc3 );
+
+  QVariantMap params;
+  params.insert( QStringLiteral( "LAYER" ), QStringLiteral( "points" ) );
+  params.insert( QStringLiteral( "sorted:SORTED" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+  auto checkOutput = [&params, &model]( QgsProcessingContext & context, long long expectedMultiCount )
+  {
+    QgsProcessingFeedback feedback;
+    bool ok = false;
+    const QVariantMap results = model.run( params, context, &feedback, &ok );
+    QVERIFY( ok );
+
+    QgsVectorLayer *output = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( QStringLiteral( "sorted:SORTED" ) ).toString() ) );
+    QVERIFY( output );
+    QCOMPARE( output->featureCount(), 1000LL );
+    QCOMPARE( output->wkbType(), QgsWkbTypes::MultiPoint );
+    QCOMPARE( output->fields().names(), QStringList() << QStringLiteral( "id" ) << QStringLiteral( "n1" ) << QStringLiteral( "n2" ) );
+    QgsFeatureIterator it = output->getFeatures();
+    QgsFeature f;
+    while ( it.nextFeature( f ) )
+    {
+      QCOMPARE( f.attribute( QStringLiteral( "n1" ) ).toInt(), f.attribute( QStringLiteral( "id" ) ).toInt() );
+      QCOMPARE( f.attribute( QStringLiteral( "n2" ) ).toInt(), 999 - f.attribute( QStringLiteral( "n1" ) ).toInt() );
+      QCOMPARE( f.geometry().asWkt(), QStringLiteral( "MultiPoint ((%1 %2))" ).arg( f.attribute( QStringLiteral( "id" ) ).toInt() ).arg( -f.attribute( QStringLiteral( "id" ) ).toInt() ) );
+    }
+
+    // intermediate outputs of streamed algorithms are empty layers
+    const QVariantMap childResults = results.value( QStringLiteral( "CHILD_RESULTS" ) ).toMap();
+    QgsVectorLayer *multi = qobject_cast< QgsVectorLayer * >( QgsProcessingUtils::mapLayerFromString( childResults.value( QStringLiteral( "multi" ) ).toMap().value( QStringLiteral( "OUTPUT" ) ).toString(), context ) );
+    QVERIFY( multi );
+    QCOMPARE( multi->featureCount(), expectedMultiCount );
+    QCOMPARE( multi->wkbType(), QgsWkbTypes::MultiPoint );
+  };
+
+  QgsProcessingContext context;
+  context.setProject( &p );
+  checkOutput( context, 0 );
+
+  // not streamed when logging the execution of each algorithm
+  QgsProcessingContext verboseContext;
+  verboseContext.setProject( &p );
+  verboseContext.setLogLevel( QgsProcessingContext::Verbose );
+  checkOutput( verboseContext, 1000 );
+}
+
+void TestQgsProcessingModelAlgorithm::modelConcurrentChildAlgorithms()
+{
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3111&field=id:integer" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  for ( int i = 0; i < 100; ++i )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+  QgsProject p;
+  p.addMapLayer( layer );
+
+  // two independent branches reading the same layer
+  QgsProcessingModelAlgorithm model;
+  QgsProcessingModelParameter param;
+  param.setParameterName( QStringLiteral( "LAYER" ) );
+  model.addModelParameter( new QgsProcessingParameterFeatureSource( QStringLiteral( "LAYER" ) ), param );
+
+  QgsProcessingModelChildAlgorithm algc1;
+  algc1.setChildId( QStringLiteral( "multi" ) );
+  algc1.setAlgorithmId( QStringLiteral( "native:promotetomulti" ) );
+  algc1.addParameterSources( QStringLiteral( "INPUT" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromModelParameter( QStringLiteral( "LAYER" ) ) );
+  QMap<QString, QgsProcessingModelOutput> outputs1;
+  QgsProcessingModelOutput out1( QStringLiteral( "MULTI" ) );
+  out1.setChildOutputName( QStringLiteral( "OUTPUT" ) );
+  outputs1.insert( QStringLiteral( "MULTI" ), out1 );
+  algc1.setModelOutputs( outputs1 );
+  model.addChildAlgorithm( algc1 );
+
+  QgsProcessingModelChildAlgorithm algc2;
+  algc2.setChildId( QStringLiteral( "buffer" ) );
+  algc2.setAlgorithmId( QStringLiteral( "native:buffer" ) );
+  algc2.addParameterSources( QStringLiteral( "INPUT" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromModelParameter( QStringLiteral( "LAYER" ) ) );
+  algc2.addParameterSources( QStringLiteral( "DISTANCE" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromStaticValue( 0.5 ) );
+  QMap<QString, QgsProcessingModelOutput> outputs2;
+  QgsProcessingModelOutput out2( QStringLiteral( "BUFFERED" ) );
+  out2.setChildOutputName( QStringLiteral( "OUTPUT" ) );
+  outputs2.insert( QStringLiteral( "BUFFERED" ), out2 );
+  algc2.setModelOutputs( outputs2 );
+  model.addChildAlgorithm( algc2 );
+
+  QVariantMap params;
+  params.insert( QStringLiteral( "LAYER" ), QStringLiteral( "points" ) );
+  params.insert( QStringLiteral( "multi:MULTI" ), QgsProcessing::TEMPORARY_OUTPUT );
+  params.insert( QStringLiteral( "buffer:BUFFERED" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+  QgsProcessingContext context;
+  context.setProject( &p );
+  QgsProcessingFeedback feedback;
+  bool ok = false;
+  QVariantMap results = model.run( params, context, &feedback, &ok );
+  QVERIFY( ok );
+
+  // the outputs of the branches are moved to the model context
+  QgsVectorLayer *multi = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( QStringLiteral( "multi:MULTI" ) ).toString() ) );
+  QVERIFY( multi );
+  QCOMPARE( multi->featureCount(), 100LL );
+  QCOMPARE( multi->wkbType(), QgsWkbTypes::MultiPoint );
+  QgsVectorLayer *buffered = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( QStringLiteral( "buffer:BUFFERED" ) ).toString() ) );
+  QVERIFY( buffered );
+  QCOMPARE( buffered->featureCount(), 100LL );
+  QCOMPARE( buffered->wkbType(), QgsWkbTypes::MultiPolygon );
+
+  const QVariantMap childResults = results.value( QStringLiteral( "CHILD_RESULTS" ) ).toMap();
+  QCOMPARE( childResults.value( QStringLiteral( "multi" ) ).toMap().value( QStringLiteral( "OUTPUT" ) ), results.value( QStringLiteral( "multi:MULTI" ) ) );
+  QCOMPARE( childResults.value( QStringLiteral( "buffer" ) ).toMap().value( QStringLiteral( "OUTPUT" ) ), results.value( QStringLiteral( "buffer:BUFFERED" ) ) );
+
+  // an exception raised by a branch fails the model
+  QgsProcessingModelChildAlgorithm algc3;
+  algc3.setChildId( QStringLiteral( "raise" ) );
+  algc3.setAlgorithmId( QStringLiteral( "native:raiseexception" ) );
+  algc3.addParameterSources( QStringLiteral( "MESSAGE" ), QList< QgsProcessingModelChildParameterSource >() << QgsProcessingModelChildParameterSource::fromStaticValue( QStringLiteral( "branch failed" ) ) );
+  model.addChildAlgorithm( algc3 );
+
+  QgsProcessingContext failingContext;
+  failingContext.setProject( &p );
+  results = model.run( params, failingContext, &feedback, &ok );
+  QVERIFY( !ok );
+}
+
 void TestQgsProcessingModelAlgorithm::modelBranchPruningConditional()
 {
   QgsProcessingContext context;
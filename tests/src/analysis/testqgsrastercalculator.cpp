@@ -59,6 +59,7 @@ class TestQgsRasterCalculator : public QObject
 
     void calcWithLayers();
     void calcWithReprojectedLayers();
+    void calcWithTiles(); //test a calculation on an output of several blocks
 
     void errors();
     void toString();
@@ -506,6 +507,53 @@ void TestQgsRasterCalculator::calcWithLayers()
   delete block;
 }
 
+void TestQgsRasterCalculator::calcWithTiles()
+{
+  QgsRasterCalculatorEntry entry1;
+  entry1.bandNumber = 1;
+  entry1.raster = mpLandsatRasterLayer;
+  entry1.ref = QStringLiteral( "landsat@1" );
+
+  QgsRasterCalculatorEntry entry2;
+  entry2.bandNumber = 2;
+  entry2.raster = mpLandsatRasterLayer;
+  entry2.ref = QStringLiteral( "landsat@2" );
+
+  QgsCoordinateReferenceSystem crs( QStringLiteral( "EPSG:32633" ) );
+  const QgsRectangle extent = mpLandsatRasterLayer->extent();
+
+  QTemporaryFile tmpFile;
+  tmpFile.open(); // fileName is not available until open
+  QString tmpName = tmpFile.fileName();
+  tmpFile.close();
+
+  // the output is larger than a block in both directions, with partial blocks on its edges
+  const int columns = 1100;
+  const int rows = 700;
+  QgsRasterCalculator rc( QStringLiteral( "( \"landsat@1\" - \"landsat@2\" ) * 2 + 1" ),
+                          tmpName,
+                          QStringLiteral( "GTiff" ),
+                          extent, crs, columns, rows, { entry1, entry2 },
+                          QgsProject::instance()->transformContext() );
+  QCOMPARE( static_cast< int >( rc.processCalculation() ), 0 );
+
+  std::unique_ptr< QgsRasterLayer > result = std::make_unique< QgsRasterLayer >( tmpName, QStringLiteral( "result" ) );
+  QCOMPARE( result->width(), columns );
+  QCOMPARE( result->height(), rows );
+
+  std::unique_ptr< QgsRasterBlock > block( result->dataProvider()->block( 1, extent, columns, rows ) );
+  std::unique_ptr< QgsRasterBlock > band1( mpLandsatRasterLayer->dataProvider()->block( 1, extent, columns, rows ) );
+  std::unique_ptr< QgsRasterBlock > band2( mpLandsatRasterLayer->dataProvider()->block( 2, extent, columns, rows ) );
+  for ( int row = 0; row < rows; row += 7 )
+  {
+    for ( int column = 0; column < columns; column += 11 )
+    {
+      QCOMPARE( block->value( row, column ), ( band1->value( row, column ) - band2->value( row, column ) ) * 2 + 1 );
+    }
+  }
+  QCOMPARE( block->value( rows - 1, columns - 1 ), ( band1->value( rows - 1, columns - 1 ) - band2->value( rows - 1, columns - 1 ) ) * 2 + 1 );
+}
+
 void TestQgsRasterCalculator::calcWithReprojectedLayers()
 {
   QgsRasterCalculatorEntry entry1;
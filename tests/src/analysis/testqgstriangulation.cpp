@@ -22,6 +22,8 @@ Email                : vcloarec at gmail dot com
 #include "qgsprovidermetadata.h"
 #include "qgsproviderregistry.h"
 
+#include <QRandomGenerator>
+
 class TestQgsTriangulation : public QObject
 {
     Q_OBJECT
@@ -34,6 +36,7 @@ class TestQgsTriangulation : public QObject
     void init() ;// will be called before each testfunction is executed.
     void cleanup() ;// will be called after every testfunction.
     void dualEdge();
+    void dualEdgeAddPoints();
 
     void meshTriangulation();
     void meshTriangulationWithOnlyBreakLine();
@@ -166,6 +169,48 @@ void TestQgsTriangulation::dualEdge()
   QCOMPARE( mesh.vertexCount(), 5 );
 }
 
+void TestQgsTriangulation::dualEdgeAddPoints()
+{
+  QRandomGenerator generator( 42 );
+  QVector<QgsPoint> points;
+  for ( int i = 0; i < 2000; ++i )
+    points << QgsPoint( generator.bounded( 1000.0 ), generator.bounded( 1000.0 ), i );
+  // duplicated point
+  points << QgsPoint( points.at( 10 ).x(), points.at( 10 ).y(), 5000 );
+
+  QgsDualEdgeTriangulation expectedTriangulation;
+  for ( const QgsPoint &point : std::as_const( points ) )
+    expectedTriangulation.addPoint( point );
+
+  QgsDualEdgeTriangulation triangulation;
+  QVERIFY( triangulation.addPoints( points ) );
+
+  const QgsMesh expectedMesh = expectedTriangulation.triangulationToMesh();
+  const QgsMesh mesh = triangulation.triangulationToMesh();
+
+  // points keep their order, with the highest z value of the duplicated points
+  QCOMPARE( mesh.vertexCount(), 2000 );
+  QCOMPARE( mesh.vertices, expectedMesh.vertices );
+  QCOMPARE( mesh.vertex( 10 ).z(), 5000.0 );
+
+  // the Delaunay triangulation of points in general position is unique
+  const auto normalizedFaces = []( const QgsMesh & mesh )
+  {
+    QSet< QString > faces;
+    for ( QgsMeshFace face : mesh.faces )
+    {
+      std::rotate( face.begin(), std::min_element( face.begin(), face.end() ), face.end() );
+      QStringList indices;
+      for ( const int index : std::as_const( face ) )
+        indices << QString::number( index );
+      faces.insert( indices.join( ',' ) );
+    }
+    return faces;
+  };
+  QCOMPARE( mesh.faceCount(), expectedMesh.faceCount() );
+  QCOMPARE( normalizedFaces( mesh ), normalizedFaces( expectedMesh ) );
+}
+
 void TestQgsTriangulation::meshTriangulation()
 {
   QgsMeshTriangulation meshTri;
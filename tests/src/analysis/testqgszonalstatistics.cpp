@@ -23,6 +23,8 @@
 #include "qgszonalstatistics.h"
 #include "qgsproject.h"
 #include "qgsvectorlayerutils.h"
+#include "qgsrasterdataprovider.h"
+#include "qgsrasterblock.h"
 
 /**
  * \ingroup UnitTests
@@ -42,6 +44,7 @@ class TestQgsZonalStatistics : public QObject
     void testReprojection();
     void testNoData();
     void testSmallPolygons();
+    void testPixelCenters();
     void testShortName();
 
   private:
@@ -344,6 +347,45 @@ void TestQgsZonalStatistics::testSmallPolygons()
   QGSCOMPARENEAR( f.attribute( QStringLiteral( "nmean" ) ).toDouble(), 864.285638, 0.01 );
 }
 
+void TestQgsZonalStatistics::testPixelCenters()
+{
+  // the pixels counted are those whose center is inside the polygon, including for rings with holes and slanted edges
+  const QgsRectangle extent = mRasterLayer->extent();
+  const double cellSizeX = mRasterLayer->rasterUnitsPerPixelX();
+  const double cellSizeY = mRasterLayer->rasterUnitsPerPixelY();
+  auto point = [&extent]( double x, double y )
+  {
+    return QStringLiteral( "%1 %2" ).arg( extent.xMinimum() + x * extent.width(), 0, 'f', 6 ).arg( extent.yMinimum() + y * extent.height(), 0, 'f', 6 );
+  };
+  const QgsGeometry geometry = QgsGeometry::fromWkt( QStringLiteral( "Polygon((%1, %2, %3, %4, %1),(%5, %6, %7, %5))" )
+                               .arg( point( 0.03, 0.02 ), point( 0.96, 0.09 ), point( 0.98, 0.97 ), point( 0.06, 0.92 ) )
+                               .arg( point( 0.31, 0.33 ), point( 0.72, 0.38 ), point( 0.49, 0.71 ) ) );
+  QVERIFY( geometry.isGeosValid() );
+
+  const int width = mRasterLayer->width();
+  const int height = mRasterLayer->height();
+  const std::unique_ptr< QgsRasterBlock > block( mRasterLayer->dataProvider()->block( 1, extent, width, height ) );
+  double expectedCount = 0;
+  double expectedSum = 0;
+  for ( int row = 0; row < height; ++row )
+  {
+    for ( int col = 0; col < width; ++col )
+    {
+      const QgsGeometry cellCenter = QgsGeometry::fromPointXY( QgsPointXY( extent.xMinimum() + ( col + 0.5 ) * cellSizeX, extent.yMaximum() - ( row + 0.5 ) * cellSizeY ) );
+      if ( !block->isNoData( row, col ) && geometry.contains( cellCenter ) )
+      {
+        expectedCount++;
+        expectedSum += block->value( row, col );
+      }
+    }
+  }
+  QVERIFY( expectedCount > 1 );
+
+  const QMap<QgsZonalStatistics::Statistic, QVariant> results = QgsZonalStatistics::calculateStatistics( mRasterLayer->dataProvider(), geometry, cellSizeX, cellSizeY, 1, QgsZonalStatistics::Count | QgsZonalStatistics::Sum );
+  QCOMPARE( results.value( QgsZonalStatistics::Count ).toDouble(), expectedCount );
+  QGSCOMPARENEAR( results.value( QgsZonalStatistics::Sum ).toDouble(), expectedSum, 1e-6 );
+}
+
 void TestQgsZonalStatistics::testShortName()
 {
   QCOMPARE( QgsZonalStatistics::shortName( QgsZonalStatistics::Count ), QStringLiteral( "count" ) );
@@ -168,6 +168,8 @@ class TestQgsGeometry : public QgsTest
 
     void wktParser();
 
+    void asGeosWithPrecision();
+
   private:
     //! Must be called before each render test
     void initPainterTest();
@@ -2905,5 +2907,18 @@ void TestQgsGeometry::wktParser()
   QVERIFY( mline.fromWkt( "MultiLineString EMPTY" ) );
   QCOMPARE( mline.asWkt(), QStringLiteral( "MultiLineString EMPTY" ) );
 }
+void TestQgsGeometry::asGeosWithPrecision()
+{
+  const QgsGeometry polygon = QgsGeometry::fromWkt( QStringLiteral( "PolygonZ ((0.1 0.2 1.4, 10.3 0.4 2.6, 10.2 9.9 3.1, 0.1 0.2 1.4))" ) );
+  geos::unique_ptr geos = QgsGeos::asGeos( polygon.constGet(), 1 );
+  QVERIFY( geos );
+  QCOMPARE( QgsGeos::fromGeos( geos.get() )->asWkt(), QStringLiteral( "PolygonZ ((0 0 1, 10 0 3, 10 10 3, 0 0 1))" ) );
+
+  const QgsGeometry line = QgsGeometry::fromWkt( QStringLiteral( "LineString (0.4 0.6, 2.5 3.7)" ) );
+  geos = QgsGeos::asGeos( line.constGet(), 0.5 );
+  QVERIFY( geos );
+  QCOMPARE( QgsGeos::fromGeos( geos.get() )->asWkt(), QStringLiteral( "LineString (0.5 0.5, 2.5 3.5)" ) );
+}
+
 QGSTEST_MAIN( TestQgsGeometry )
 #include "testqgsgeometry.moc"
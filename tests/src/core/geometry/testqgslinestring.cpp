@@ -1181,6 +1181,31 @@ void TestQgsLineString::toWkbFromWkb()
 
   QVERIFY( !ls2.fromWkb( wkb2ptr ) );
   QCOMPARE( ls2.wkbType(), QgsWkbTypes::LineString );
+
+  // truncated WKB, missing the last ordinate
+  const QByteArray truncatedWkb = wkb1.left( wkb1.size() - 8 );
+  QgsConstWkbPtr truncatedWkbPtr( truncatedWkb );
+  bool errorThrown = false;
+  try
+  {
+    ls2.fromWkb( truncatedWkbPtr );
+  }
+  catch ( QgsWkbException & )
+  {
+    errorThrown = true;
+  }
+  QVERIFY( errorThrown );
+
+  // Z only
+  QgsLineString ls3;
+  ls3.setPoints( QgsPointSequence() << QgsPoint( QgsWkbTypes::PointZ, 1, 2, 3 )
+                 << QgsPoint( QgsWkbTypes::PointZ, 11, 12, 13 ) );
+  const QByteArray wkb3 = ls3.asWkb();
+  QgsConstWkbPtr wkb3ptr( wkb3 );
+  QVERIFY( ls2.fromWkb( wkb3ptr ) );
+  QCOMPARE( ls2.wkbType(), QgsWkbTypes::LineStringZ );
+  QCOMPARE( ls2.pointN( 0 ), ls3.pointN( 0 ) );
+  QCOMPARE( ls2.pointN( 1 ), ls3.pointN( 1 ) );
 }
 
 void TestQgsLineString::toWktFromWkt()
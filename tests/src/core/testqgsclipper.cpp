@@ -41,6 +41,8 @@ class TestQgsClipper: public QgsTest
     void basic();
     void basicWithZ();
     void basicWithZInf();
+    void repeatedTrims();
+    void trimInsidePolygon();
     void epsg4978LineRendering();
 
   private:
@@ -143,6 +145,64 @@ void TestQgsClipper::basicWithZInf()
   QVERIFY( ! checkBoundingBox( QgsLineString( x, y, z ), clipRectInner ) );
 }
 
+void TestQgsClipper::repeatedTrims()
+{
+  // the intermediate buffers are reused between calls, results must not depend on the previous calls
+  const QgsRectangle clipRect( 0.0, 0.0, 10.0, 10.0 );
+  QPolygonF large;
+  for ( int i = 0; i < 100000; ++i )
+    large << QPointF( 5 + 20 * std::cos( i * 2 * M_PI / 100000 ), 5 + 20 * std::sin( i * 2 * M_PI / 100000 ) );
+  QgsClipper::trimPolygon( large, clipRect );
+  QVERIFY( checkBoundingBox( large, clipRect ) );
+
+  for ( int i = 0; i < 3; ++i )
+  {
+    QPolygonF polygon;
+    polygon << QPointF( 1.0, 9.0 ) << QPointF( 11.0, 11.0 ) << QPointF( 9.0, 1.0 );
+    QgsClipper::trimPolygon( polygon, clipRect );
+    QCOMPARE( polygon.size(), 5 );
+    QVERIFY( checkBoundingBox( polygon, clipRect ) );
+
+    QVector< double > x = { 1.0, 11.0, 9.0 };
+    QVector< double > y = { 9.0, 11.0, 1.0 };
+    QVector< double > z = { 1.0, 11.0, 9.0 };
+    const QgsBox3d clipRect3d( 0.0, 0.0, 0.0, 10.0, 10.0, 10.0 );
+    QgsClipper::trimPolygon( x, y, z, clipRect3d );
+    QCOMPARE( x.size(), 5 );
+    QCOMPARE( z.size(), 5 );
+    QVERIFY( checkBoundingBox( QgsLineString( x, y, z ), clipRect3d ) );
+  }
+}
+
+void TestQgsClipper::trimInsidePolygon()
+{
+  const QgsRectangle clipRect( 0.0, 0.0, 10.0, 10.0 );
+
+  // polygons inside the clip rectangle are unchanged
+  QPolygonF polygon;
+  polygon << QPointF( 1.0, 1.0 ) << QPointF( 9.0, 5.0 ) << QPointF( 1.0, 9.0 );
+  const QPolygonF inside = polygon;
+  QgsClipper::trimPolygon( polygon, clipRect );
+  QCOMPARE( polygon, inside );
+
+  // points on a boundary are outside of it
+  polygon.clear();
+  polygon << QPointF( 1.0, 1.0 ) << QPointF( 10.0, 5.0 ) << QPointF( 1.0, 9.0 );
+  QgsClipper::trimPolygon( polygon, clipRect );
+  QCOMPARE( polygon, QPolygonF() << QPointF( 1.0, 1.0 ) << QPointF( 10.0, 5.0 ) << QPointF( 10.0, 5.0 ) << QPointF( 1.0, 9.0 ) );
+
+  // polygons crossing a single boundary
+  polygon.clear();
+  polygon << QPointF( 1.0, 1.0 ) << QPointF( 5.0, -5.0 ) << QPointF( 9.0, 1.0 ) << QPointF( 5.0, 9.0 );
+  QgsClipper::trimPolygon( polygon, clipRect );
+  QCOMPARE( polygon.size(), 5 );
+  QVERIFY( checkBoundingBox( polygon, clipRect ) );
+
+  polygon.clear();
+  QgsClipper::trimPolygon( polygon, clipRect );
+  QVERIFY( polygon.isEmpty() );
+}
+
 void TestQgsClipper::basic()
 {
   // QgsClipper is static only
@@ -15,6 +15,7 @@
  *                                                                         *
  ***************************************************************************/
 #include "qgsapplication.h"
+#include "qgsconnectionpool.h"
 #include "qgsfeatureiterator.h"
 #include "qgsgeometry.h"
 #include "qgspoint.h"
@@ -28,6 +29,59 @@
 #include <QFutureWatcher>
 #include "qgstest.h"
 
+struct TestConn
+{
+  QString name;
+  bool valid = true;
+};
+
+inline QString qgsConnectionPool_ConnectionToName( TestConn *c )
+{
+  return c->name;
+}
+
+inline void qgsConnectionPool_ConnectionCreate( const QString &connInfo, TestConn *&c )
+{
+  c = new TestConn;
+  c->name = connInfo;
+}
+
+inline void qgsConnectionPool_ConnectionDestroy( TestConn *c )
+{
+  delete c;
+}
+
+inline void qgsConnectionPool_InvalidateConnection( TestConn *c )
+{
+  c->valid = false;
+}
+
+inline bool qgsConnectionPool_ConnectionIsValid( TestConn *c )
+{
+  return c->valid;
+}
+
+class TestConnPoolGroup : public QObject, public QgsConnectionPoolGroup<TestConn *>
+{
+    Q_OBJECT
+
+  public:
+    explicit TestConnPoolGroup( const QString &name )
+      : QgsConnectionPoolGroup<TestConn *>( name )
+    {
+      initTimer( this );
+    }
+
+  protected slots:
+    void handleConnectionExpired() { onConnectionExpired(); }
+    void startExpirationTimer() { expirationTimer->start(); }
+    void stopExpirationTimer() { expirationTimer->stop(); }
+};
+
+class TestConnPool : public QgsConnectionPool<TestConn *, TestConnPoolGroup>
+{
+};
+
 class TestQgsConnectionPool: public QObject
 {
     Q_OBJECT
@@ -36,6 +90,7 @@ class TestQgsConnectionPool: public QObject
     void initTestCase();
     void cleanupTestCase();
     void layersFromSameDatasetGPX();
+    void statistics();
 
   private:
     struct ReadJob
@@ -142,5 +197,54 @@ void TestQgsConnectionPool::layersFromSameDatasetGPX()
   QFile( testFile.fileName() ).remove();
 }
 
+void TestQgsConnectionPool::statistics()
+{
+  TestConnPool pool;
+  const QString connInfo = QStringLiteral( "test" );
+  QCOMPARE( pool.statistics( connInfo ).createdConnections, 0LL );
+
+  pool.warmUpConnections( connInfo, 2 );
+  QgsConnectionPoolStatistics stats = pool.statistics( connInfo );
+  QCOMPARE( stats.createdConnections, 2LL );
+  QCOMPARE( stats.idleConnections, 2 );
+  QCOMPARE( stats.activeConnections, 0 );
+  QCOMPARE( stats.acquisitions, 0LL );
+
+  // warmed up connections are acquired before new ones are opened
+  TestConn *c1 = pool.acquireConnection( connInfo );
+  TestConn *c2 = pool.acquireConnection( connInfo );
+  TestConn *c3 = pool.acquireConnection( connInfo );
+  QVERIFY( c1 && c2 && c3 );
+  stats = pool.statistics( connInfo );
+  QCOMPARE( stats.createdConnections, 3LL );
+  QCOMPARE( stats.idleConnections, 0 );
+  QCOMPARE( stats.activeConnections, 3 );
+  QCOMPARE( stats.acquisitions, 3LL );
+  QCOMPARE( stats.failedAcquisitions, 0LL );
+  QVERIFY( stats.maximumWaitTime <= stats.totalWaitTime );
+
+  pool.releaseConnection( c1 );
+  pool.releaseConnection( c2 );
+  pool.releaseConnection( c3 );
+  stats = pool.statistics( connInfo );
+  QCOMPARE( stats.idleConnections, 3 );
+  QCOMPARE( stats.activeConnections, 0 );
+
+  // no connection is opened when enough are open
+  pool.warmUpConnections( connInfo, 2 );
+  QCOMPARE( pool.statistics( connInfo ).createdConnections, 3LL );
+
+  // requests which can't get a connection in time are failed acquisitions
+  QList< TestConn * > connections;
+  while ( TestConn *c = pool.acquireConnection( connInfo, 0 ) )
+    connections << c;
+  QVERIFY( !connections.isEmpty() );
+  stats = pool.statistics( connInfo );
+  QCOMPARE( stats.failedAcquisitions, 1LL );
+  QCOMPARE( stats.activeConnections, connections.count() );
+  for ( TestConn *c : std::as_const( connections ) )
+    pool.releaseConnection( c );
+}
+
 QGSTEST_MAIN( TestQgsConnectionPool )
 #include "testqgsconnectionpool.moc"
@@ -53,6 +53,7 @@ class TestQgsCoordinateTransform: public QObject
     void testDeprecated4240to4326();
     void testCustomProjTransform();
     void testTransformationIsPossible();
+    void benchmarkTransformCoords();
 };
 
 
@@ -811,5 +812,27 @@ void TestQgsCoordinateTransform::testTransformationIsPossible()
 }
 
 
+void TestQgsCoordinateTransform::benchmarkTransformCoords()
+{
+  const QgsCoordinateTransform ct( QgsCoordinateReferenceSystem::fromEpsgId( 4326 ), QgsCoordinateReferenceSystem::fromEpsgId( 3857 ), QgsCoordinateTransformContext() );
+  QVERIFY( ct.isValid() );
+
+  QVector< double > sourceX;
+  QVector< double > sourceY;
+  for ( int i = 0; i < 10000; ++i )
+  {
+    sourceX << -180 + ( i % 360 );
+    sourceY << -60 + ( i % 120 );
+  }
+
+  QBENCHMARK
+  {
+    QVector< double > x = sourceX;
+    QVector< double > y = sourceY;
+    QVector< double > z( x.size() );
+    ct.transformCoords( x.size(), x.data(), y.data(), z.data() );
+  }
+}
+
 QGSTEST_MAIN( TestQgsCoordinateTransform )
 #include "testqgscoordinatetransform.moc"
@@ -43,6 +43,7 @@ class TestQgsDistanceArea: public QObject
     void regression13601();
     void collections();
     void measureUnits();
+    void measureLineStringVertices();
     void measureAreaAndUnits();
     void emptyPolygon();
     void regression14675();
@@ -287,6 +288,32 @@ void TestQgsDistanceArea::measureUnits()
   QGSCOMPARENEAR( result, 2328.0988253106957, 0.001 );
 }
 
+void TestQgsDistanceArea::measureLineStringVertices()
+{
+  // line strings are transformed at once, results must match the measures of their segments
+  QgsDistanceArea calc;
+  calc.setEllipsoid( QStringLiteral( "WGS84" ) );
+  calc.setSourceCrs( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:2272" ) ), QgsProject::instance()->transformContext() );
+  QgsPolylineXY points;
+  points << QgsPointXY( 1341683.9854275715, 408256.9562717728 )
+         << QgsPointXY( 1349321.7807031618, 408256.9562717728 )
+         << QgsPointXY( 1349321.7807031618, 418256.9562717728 )
+         << QgsPointXY( 1341683.9854275715, 418256.9562717728 );
+
+  double segments = 0;
+  for ( int i = 1; i < points.size(); ++i )
+    segments += calc.measureLine( points.at( i - 1 ), points.at( i ) );
+  QGSCOMPARENEAR( calc.measureLine( points ), segments, 0.000001 );
+  QGSCOMPARENEAR( calc.measureLength( QgsGeometry::fromPolylineXY( points ) ), segments, 0.000001 );
+
+  points << points.at( 0 );
+  QgsPolygonXY polygon;
+  polygon << points;
+  QVERIFY( calc.measurePolygon( points ) > 0 );
+  QGSCOMPARENEAR( calc.measureArea( QgsGeometry::fromPolygonXY( polygon ) ), calc.measurePolygon( points ), 0.000001 );
+  QGSCOMPARENEAR( calc.measurePerimeter( QgsGeometry::fromPolygonXY( polygon ) ), segments + calc.measureLine( points.at( 3 ), points.at( 0 ) ), 0.000001 );
+}
+
 void TestQgsDistanceArea::measureAreaAndUnits()
 {
   QgsDistanceArea da;
@@ -5735,6 +5735,31 @@ class TestQgsExpression: public QObject
 
     }
 
+    void benchmarkEvaluate()
+    {
+      QgsFields fields;
+      fields.append( QgsField( QStringLiteral( "name" ), QVariant::String ) );
+      fields.append( QgsField( QStringLiteral( "population" ), QVariant::Int ) );
+      QgsFeature feature( fields );
+      feature.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 10, 0 0))" ) ) );
+
+      QgsExpressionContext context;
+      context.setFields( fields );
+      QgsExpression exp( QStringLiteral( "CASE WHEN \"population\" > 500 AND $area > 50 THEN upper(\"name\") ELSE lower(\"name\") || '_' || to_string(\"population\") END" ) );
+      QVERIFY( exp.prepare( &context ) );
+
+      QBENCHMARK
+      {
+        for ( int i = 0; i < 1000; ++i )
+        {
+          feature.setAttributes( QgsAttributes() << QStringLiteral( "Name" ) << i );
+          context.setFeature( feature );
+          exp.evaluate( &context );
+        }
+      }
+      QCOMPARE( exp.evaluate( &context ).toString(), QStringLiteral( "NAME" ) );
+    }
+
 };
 
 QGSTEST_MAIN( TestQgsExpression )
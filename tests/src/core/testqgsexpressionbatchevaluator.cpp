@@ -0,0 +1,200 @@
+/***************************************************************************
+     testqgsexpressionbatchevaluator.cpp
+     -----------------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgsexpression.h"
+#include "qgsexpressionbatchevaluator.h"
+#include "qgsexpressioncontext.h"
+#include "qgsfeature.h"
+#include "qgsfeaturebatch.h"
+
+class TestQgsExpressionBatchEvaluator: public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void evaluate_data();
+    void evaluate();
+    void skippedBranches_data();
+    void skippedBranches();
+    void evalErrors();
+
+  private:
+    QgsFields mFields;
+    QgsFeatureList mFeatures;
+};
+
+void TestQgsExpressionBatchEvaluator::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  mFields.append( QgsField( QStringLiteral( "i" ), QVariant::Int ) );
+  mFields.append( QgsField( QStringLiteral( "d" ), QVariant::Double ) );
+  mFields.append( QgsField( QStringLiteral( "s" ), QVariant::String ) );
+
+  for ( int i = 0; i < 20; ++i )
+  {
+    QgsFeature f( mFields, i );
+    f.setAttributes( QgsAttributes() << ( i == 7 ? QVariant( QVariant::Int ) : QVariant( i - 10 ) )
+                     << ( i == 3 ? QVariant( QVariant::Double ) : QVariant( i * 0.75 ) )
+                     << ( i == 11 ? QVariant( QVariant::String ) : QVariant( QStringLiteral( "Ab%1" ).arg( i % 4 ) ) ) );
+    mFeatures << f;
+  }
+}
+
+void TestQgsExpressionBatchEvaluator::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsExpressionBatchEvaluator::evaluate_data()
+{
+  QTest::addColumn<QString>( "expression" );
+  QTest::addColumn<bool>( "vectorized" );
+
+  QTest::newRow( "field" ) << QStringLiteral( "\"i\"" ) << true;
+  QTest::newRow( "literal" ) << QStringLiteral( "5" ) << true;
+  QTest::newRow( "int arithmetic" ) << QStringLiteral( "\"i\" * 2 + 3 - \"i\" % 3" ) << true;
+  QTest::newRow( "mixed arithmetic" ) << QStringLiteral( "\"i\" * \"d\" - 1.5" ) << true;
+  QTest::newRow( "division" ) << QStringLiteral( "\"d\" / \"i\"" ) << true;
+  QTest::newRow( "null arithmetic" ) << QStringLiteral( "\"d\" * NULL" ) << true;
+  QTest::newRow( "power" ) << QStringLiteral( "\"d\" ^ 2" ) << true;
+  QTest::newRow( "unary" ) << QStringLiteral( "-\"i\"" ) << true;
+  QTest::newRow( "comparison" ) << QStringLiteral( "\"i\" >= \"d\"" ) << true;
+  QTest::newRow( "string comparison" ) << QStringLiteral( "\"s\" = 'Ab2'" ) << true;
+  QTest::newRow( "string ordering" ) << QStringLiteral( "\"s\" < 'Ab2'" ) << true;
+  QTest::newRow( "logic" ) << QStringLiteral( "\"i\" > 0 and \"d\" < 10 or \"i\" = -10" ) << true;
+  QTest::newRow( "not" ) << QStringLiteral( "not (\"i\" > 0)" ) << true;
+  QTest::newRow( "is null" ) << QStringLiteral( "\"i\" is null" ) << true;
+  QTest::newRow( "concat" ) << QStringLiteral( "\"s\" || '_x'" ) << true;
+  QTest::newRow( "case" ) << QStringLiteral( "CASE WHEN \"i\" < -5 THEN 1 WHEN \"i\" > 5 THEN \"d\" ELSE 0 END" ) << true;
+  QTest::newRow( "case strings" ) << QStringLiteral( "CASE WHEN \"i\" > 0 THEN \"s\" ELSE 'none' END" ) << true;
+  QTest::newRow( "math functions" ) << QStringLiteral( "abs(\"i\") + sqrt(\"d\") + floor(\"d\") + ceil(\"d\") + round(\"d\")" ) << true;
+  QTest::newRow( "string functions" ) << QStringLiteral( "upper(\"s\") || lower(\"s\")" ) << true;
+  QTest::newRow( "length" ) << QStringLiteral( "length(\"s\")" ) << true;
+  QTest::newRow( "coalesce" ) << QStringLiteral( "coalesce(\"d\", \"i\", 0)" ) << true;
+  QTest::newRow( "fallback function" ) << QStringLiteral( "left(\"s\", 1) || 'x'" ) << false;
+  QTest::newRow( "fallback in" ) << QStringLiteral( "\"i\" in (1, 2, 3)" ) << false;
+  QTest::newRow( "fallback int division" ) << QStringLiteral( "\"d\" // 2" ) << false;
+  QTest::newRow( "fallback mixed" ) << QStringLiteral( "\"s\" + 1" ) << false;
+  QTest::newRow( "fallback like" ) << QStringLiteral( "\"s\" like 'A%2'" ) << false;
+}
+
+void TestQgsExpressionBatchEvaluator::evaluate()
+{
+  QFETCH( QString, expression );
+  QFETCH( bool, vectorized );
+
+  QgsFeatureBatch batch( mFields );
+  for ( const QgsFeature &f : std::as_const( mFeatures ) )
+    batch.appendFeature( f );
+
+  QgsExpression exp( expression );
+  QVERIFY( !exp.hasParserError() );
+  QgsExpressionContext context;
+  QgsExpressionBatchEvaluator evaluator( &exp );
+  const QgsFeatureBatch::Column result = evaluator.evaluate( batch, &context );
+  QCOMPARE( evaluator.usedRowFallback(), !vectorized );
+  QCOMPARE( result.size(), mFeatures.size() );
+
+  for ( int row = 0; row < mFeatures.size(); ++row )
+  {
+    context.setFeature( mFeatures.at( row ) );
+    const QVariant expected = exp.evaluate( &context );
+    const QVariant value = result.value( row );
+    QCOMPARE( value.isNull(), expected.isNull() );
+    if ( !expected.isNull() )
+    {
+      if ( expected.type() == QVariant::Double || value.type() == QVariant::Double )
+        QGSCOMPARENEAR( value.toDouble(), expected.toDouble(), 1e-9 );
+      else
+        QCOMPARE( value.toString(), expected.toString() );
+    }
+  }
+}
+
+void TestQgsExpressionBatchEvaluator::skippedBranches_data()
+{
+  QTest::addColumn<QString>( "expression" );
+
+  // to_int() raises an error for all the non NULL strings
+  QTest::newRow( "case then" ) << QStringLiteral( "CASE WHEN \"s\" = 'x' THEN to_int(\"s\") ELSE 1 END" );
+  QTest::newRow( "case when" ) << QStringLiteral( "CASE WHEN \"s\" IS NULL OR \"s\" <> 'x' THEN 1 WHEN to_int(\"s\") > 0 THEN 2 END" );
+  QTest::newRow( "case else" ) << QStringLiteral( "CASE WHEN \"s\" IS NULL OR \"s\" <> 'x' THEN 1 ELSE to_int(\"s\") END" );
+  QTest::newRow( "and" ) << QStringLiteral( "\"s\" = 'x' and to_int(\"s\") > 0" );
+  QTest::newRow( "or" ) << QStringLiteral( "\"s\" is null or \"s\" like 'A%' or to_int(\"s\") > 0" );
+}
+
+void TestQgsExpressionBatchEvaluator::skippedBranches()
+{
+  QFETCH( QString, expression );
+
+  QgsFeatureBatch batch( mFields );
+  for ( const QgsFeature &f : std::as_const( mFeatures ) )
+    batch.appendFeature( f );
+
+  // the branches not taken by any feature must not be evaluated
+  QgsExpression exp( expression );
+  QVERIFY( !exp.hasParserError() );
+  QgsExpressionContext context;
+  QgsExpressionBatchEvaluator evaluator( &exp );
+  const QgsFeatureBatch::Column result = evaluator.evaluate( batch, &context );
+  QVERIFY( !exp.hasEvalError() );
+  QCOMPARE( result.size(), mFeatures.size() );
+
+  for ( int row = 0; row < mFeatures.size(); ++row )
+  {
+    context.setFeature( mFeatures.at( row ) );
+    const QVariant expected = exp.evaluate( &context );
+    QVERIFY( !exp.hasEvalError() );
+    QCOMPARE( result.value( row ).isNull(), expected.isNull() );
+    if ( !expected.isNull() )
+      QCOMPARE( result.value( row ).toLongLong(), expected.toLongLong() );
+  }
+}
+
+void TestQgsExpressionBatchEvaluator::evalErrors()
+{
+  QgsFeatureBatch batch( mFields );
+  for ( const QgsFeature &f : std::as_const( mFeatures ) )
+    batch.appendFeature( f );
+
+  // only the features taking the branch raise an error, and get a NULL value
+  QgsExpression exp( QStringLiteral( "coalesce(CASE WHEN \"i\" > 0 THEN to_int(\"s\") ELSE \"i\" END, 100)" ) );
+  QgsExpressionContext context;
+  QgsExpressionBatchEvaluator evaluator( &exp );
+  const QgsFeatureBatch::Column result = evaluator.evaluate( batch, &context );
+  QVERIFY( exp.hasEvalError() );
+  QCOMPARE( result.size(), mFeatures.size() );
+
+  for ( int row = 0; row < mFeatures.size(); ++row )
+  {
+    context.setFeature( mFeatures.at( row ) );
+    const QVariant expected = exp.evaluate( &context );
+    QCOMPARE( result.value( row ).isNull(), expected.isNull() );
+    if ( !expected.isNull() )
+      QCOMPARE( result.value( row ).toLongLong(), expected.toLongLong() );
+  }
+  QCOMPARE( result.value( 15 ), QVariant() );
+  QCOMPARE( result.value( 7 ).toLongLong(), 100LL );
+  QCOMPARE( result.value( 2 ).toLongLong(), -8LL );
+}
+
+QGSTEST_MAIN( TestQgsExpressionBatchEvaluator )
+#include "testqgsexpressionbatchevaluator.moc"
@@ -0,0 +1,238 @@
+/***************************************************************************
+     testqgsexpressionbytecode.cpp
+     -----------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgsexpression.h"
+#include "qgsexpressionbytecode_p.h"
+#include "qgsexpressioncontext.h"
+#include "qgsexpressionfunction.h"
+#include "qgsexpressionnode.h"
+#include "qgsfeature.h"
+
+class TestQgsExpressionBytecode: public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void evaluate_data();
+    void evaluate();
+    void notCompiled_data();
+    void notCompiled();
+    void disabled();
+    void evaluatedOnce_data();
+    void evaluatedOnce();
+
+  private:
+    QgsFields mFields;
+    QgsFeatureList mFeatures;
+};
+
+void TestQgsExpressionBytecode::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  mFields.append( QgsField( QStringLiteral( "i" ), QVariant::Int ) );
+  mFields.append( QgsField( QStringLiteral( "d" ), QVariant::Double ) );
+  mFields.append( QgsField( QStringLiteral( "s" ), QVariant::String ) );
+  mFields.append( QgsField( QStringLiteral( "l" ), QVariant::LongLong ) );
+  // declared as integer, but some features hold doubles
+  mFields.append( QgsField( QStringLiteral( "m" ), QVariant::Int ) );
+
+  for ( int i = 0; i < 20; ++i )
+  {
+    QgsFeature f( mFields, i );
+    f.setAttributes( QgsAttributes() << ( i == 7 ? QVariant( QVariant::Int ) : QVariant( i - 10 ) )
+                     << ( i == 3 ? QVariant( QVariant::Double ) : QVariant( i * 0.75 ) )
+                     << ( i == 11 ? QVariant( QVariant::String ) : QVariant( QStringLiteral( "Ab%1" ).arg( i % 4 ) ) )
+                     << QVariant( 10000000000LL * i )
+                     << ( i % 5 == 0 ? QVariant( i * 0.5 ) : QVariant( i ) ) );
+    mFeatures << f;
+  }
+}
+
+void TestQgsExpressionBytecode::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsExpressionBytecode::evaluate_data()
+{
+  QTest::addColumn<QString>( "expression" );
+  QTest::addColumn<bool>( "fallback" );
+
+  QTest::newRow( "field" ) << QStringLiteral( "\"i\"" ) << false;
+  QTest::newRow( "int arithmetic" ) << QStringLiteral( "\"i\" * 2 + 3 - \"i\" % 3" ) << false;
+  QTest::newRow( "long arithmetic" ) << QStringLiteral( "\"l\" + \"i\"" ) << false;
+  QTest::newRow( "mixed arithmetic" ) << QStringLiteral( "\"i\" * \"d\" - 1.5" ) << false;
+  QTest::newRow( "division" ) << QStringLiteral( "\"d\" / \"i\"" ) << false;
+  QTest::newRow( "modulo by zero" ) << QStringLiteral( "7 % (\"i\" + 10)" ) << false;
+  QTest::newRow( "int division" ) << QStringLiteral( "\"d\" // 2" ) << true;
+  QTest::newRow( "null arithmetic" ) << QStringLiteral( "\"d\" * NULL" ) << false;
+  QTest::newRow( "power" ) << QStringLiteral( "\"d\" ^ 2" ) << false;
+  QTest::newRow( "unary" ) << QStringLiteral( "-\"l\" + 1" ) << false;
+  QTest::newRow( "constant folding" ) << QStringLiteral( "\"i\" * (2 + 3 * 4)" ) << false;
+  QTest::newRow( "comparison" ) << QStringLiteral( "\"i\" >= \"d\"" ) << false;
+  QTest::newRow( "string comparison" ) << QStringLiteral( "\"s\" = 'Ab2'" ) << false;
+  QTest::newRow( "string ordering" ) << QStringLiteral( "\"s\" < 'Ab2'" ) << false;
+  QTest::newRow( "logic" ) << QStringLiteral( "\"i\" > 0 and \"d\" < 10 or \"i\" = -10" ) << false;
+  QTest::newRow( "not" ) << QStringLiteral( "not (\"i\" > 0)" ) << false;
+  QTest::newRow( "is null" ) << QStringLiteral( "\"i\" is null" ) << false;
+  QTest::newRow( "is not" ) << QStringLiteral( "\"s\" is not 'Ab1'" ) << false;
+  QTest::newRow( "concat" ) << QStringLiteral( "\"s\" || '_' || \"i\" || \"d\"" ) << false;
+  QTest::newRow( "case" ) << QStringLiteral( "CASE WHEN \"i\" < -5 THEN 1 WHEN \"i\" > 5 THEN \"d\" ELSE 0 END" ) << false;
+  QTest::newRow( "case strings" ) << QStringLiteral( "CASE WHEN \"i\" > 0 THEN \"s\" END" ) << false;
+  QTest::newRow( "math functions" ) << QStringLiteral( "abs(\"i\") + sqrt(\"d\") + floor(\"d\") + ceil(\"d\") + round(\"d\")" ) << false;
+  QTest::newRow( "string functions" ) << QStringLiteral( "upper(\"s\") || lower(\"s\") || length(\"s\")" ) << false;
+  QTest::newRow( "coalesce" ) << QStringLiteral( "coalesce(\"d\", \"i\", 0)" ) << false;
+  QTest::newRow( "uncompiled function" ) << QStringLiteral( "left(\"s\", 1) || \"i\"" ) << false;
+  QTest::newRow( "uncompiled in" ) << QStringLiteral( "\"i\" in (1, 2, 3) or \"i\" > 5" ) << false;
+  QTest::newRow( "uncompiled round" ) << QStringLiteral( "\"s\" || round(\"d\", 1)" ) << false;
+  QTest::newRow( "uncompiled case branch" ) << QStringLiteral( "CASE WHEN \"i\" > 0 THEN left(\"s\", 1) ELSE upper(\"s\") END" ) << false;
+  QTest::newRow( "string addition" ) << QStringLiteral( "\"s\" + \"s\"" ) << true;
+  QTest::newRow( "type mismatch" ) << QStringLiteral( "\"m\" * 2" ) << true;
+}
+
+void TestQgsExpressionBytecode::evaluate()
+{
+  QFETCH( QString, expression );
+  QFETCH( bool, fallback );
+
+  QgsExpression exp( expression );
+  QVERIFY( !exp.hasParserError() );
+  QgsExpressionContext context;
+  context.setFields( mFields );
+  QVERIFY( exp.prepare( &context ) );
+
+  std::unique_ptr< QgsExpressionBytecode > program = QgsExpressionBytecode::compile( const_cast< QgsExpressionNode * >( exp.rootNode() ), &context );
+  QVERIFY( program );
+
+  for ( const QgsFeature &feature : std::as_const( mFeatures ) )
+  {
+    context.setFeature( feature );
+    const QVariant expected = const_cast< QgsExpressionNode * >( exp.rootNode() )->eval( &exp, &context );
+    QVERIFY( !exp.hasEvalError() );
+
+    QVariant value;
+    if ( program->evaluate( &exp, &context, value ) )
+    {
+      QCOMPARE( value.isNull(), expected.isNull() );
+      QCOMPARE( value.type(), expected.type() );
+      if ( !expected.isNull() )
+        QCOMPARE( value, expected );
+    }
+
+    // same results through QgsExpression::evaluate()
+    const QVariant evaluated = exp.evaluate( &context );
+    QCOMPARE( evaluated.isNull(), expected.isNull() );
+    QCOMPARE( evaluated.type(), expected.type() );
+    if ( !expected.isNull() )
+      QCOMPARE( evaluated, expected );
+  }
+  QCOMPARE( program->fallbackCount() > 0, fallback );
+}
+
+void TestQgsExpressionBytecode::notCompiled_data()
+{
+  QTest::addColumn<QString>( "expression" );
+
+  QTest::newRow( "static" ) << QStringLiteral( "1 + 2" );
+  QTest::newRow( "function only" ) << QStringLiteral( "left(\"s\", 2)" );
+  QTest::newRow( "like only" ) << QStringLiteral( "\"s\" like 'A%'" );
+  QTest::newRow( "arithmetic after uncompiled" ) << QStringLiteral( "round(\"d\", 1) * 2" );
+  QTest::newRow( "comparison after uncompiled" ) << QStringLiteral( "\"i\" in (1, 2, 3) or \"d\" > 5" );
+}
+
+void TestQgsExpressionBytecode::notCompiled()
+{
+  QFETCH( QString, expression );
+
+  QgsExpression exp( expression );
+  QgsExpressionContext context;
+  context.setFields( mFields );
+  exp.prepare( &context );
+  QVERIFY( !QgsExpressionBytecode::compile( const_cast< QgsExpressionNode * >( exp.rootNode() ), &context ) );
+}
+
+void TestQgsExpressionBytecode::disabled()
+{
+  // a program giving up for every feature stops being used
+  QgsExpression exp( QStringLiteral( "\"s\" + 1" ) );
+  QgsExpressionContext context;
+  context.setFields( mFields );
+  exp.prepare( &context );
+  std::unique_ptr< QgsExpressionBytecode > program = QgsExpressionBytecode::compile( const_cast< QgsExpressionNode * >( exp.rootNode() ), &context );
+  QVERIFY( program );
+
+  QgsFeature feature = mFeatures.at( 0 );
+  context.setFeature( feature );
+  QVariant value;
+  for ( int i = 0; i < 64; ++i )
+    QVERIFY( !program->evaluate( &exp, &context, value ) );
+  QVERIFY( !program->isWorthwhile() );
+
+  QCOMPARE( exp.evaluate( &context ), QVariant() );
+}
+
+void TestQgsExpressionBytecode::evaluatedOnce_data()
+{
+  QTest::addColumn<QString>( "expression" );
+
+  QTest::newRow( "type mismatch before" ) << QStringLiteral( "\"m\" * 2 || bytecode_calls()" );
+  QTest::newRow( "arithmetic after" ) << QStringLiteral( "bytecode_calls() * \"m\"" );
+  QTest::newRow( "logic after" ) << QStringLiteral( "bytecode_calls() > 0 and \"d\" > 1" );
+  QTest::newRow( "case branch" ) << QStringLiteral( "CASE WHEN \"l\" >= 0 THEN bytecode_calls() || \"s\" ELSE 0 END" );
+}
+
+void TestQgsExpressionBytecode::evaluatedOnce()
+{
+  QFETCH( QString, expression );
+
+  // counts its calls, the program must never give up after evaluating it through the tree
+  class CallsFunction : public QgsExpressionFunction
+  {
+    public:
+      CallsFunction() : QgsExpressionFunction( QStringLiteral( "bytecode_calls" ), 0, QString() ) {}
+      QVariant func( const QVariantList &, const QgsExpressionContext *, QgsExpression *, const QgsExpressionNodeFunction * ) override { return ++calls; }
+      int calls = 0;
+  };
+
+  CallsFunction *function = new CallsFunction();
+  QVERIFY( QgsExpression::registerFunction( function ) );
+
+  QgsExpression exp( expression );
+  QVERIFY( !exp.hasParserError() );
+  QgsExpressionContext context;
+  context.setFields( mFields );
+  QVERIFY( exp.prepare( &context ) );
+
+  for ( const QgsFeature &feature : std::as_const( mFeatures ) )
+  {
+    context.setFeature( feature );
+    const int calls = function->calls;
+    exp.evaluate( &context );
+    QVERIFY( !exp.hasEvalError() );
+    QCOMPARE( function->calls, calls + 1 );
+  }
+
+  QVERIFY( QgsExpression::unregisterFunction( QStringLiteral( "bytecode_calls" ) ) );
+  delete function;
+}
+
+QGSTEST_MAIN( TestQgsExpressionBytecode )
+#include "testqgsexpressionbytecode.moc"
@@ -0,0 +1,198 @@
+/***************************************************************************
+     testqgsfeaturebatch.cpp
+     ------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgsfeaturebatch.h"
+#include "qgsfeatureiterator.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectordataprovider.h"
+
+class TestQgsFeatureBatch: public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void columns();
+    void memoryProvider();
+    void vectorLayer();
+    void fallback();
+
+  private:
+    std::unique_ptr< QgsVectorLayer > createLayer() const;
+};
+
+void TestQgsFeatureBatch::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsFeatureBatch::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+std::unique_ptr< QgsVectorLayer > TestQgsFeatureBatch::createLayer() const
+{
+  std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "Point?field=id:integer&field=value:double&field=name:string&field=day:date" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  for ( int i = 0; i < 10; ++i )
+  {
+    QgsFeature f( layer->fields() );
+    f.setAttributes( QgsAttributes() << i
+                     << ( i == 3 ? QVariant() : QVariant( i * 1.5 ) )
+                     << ( i == 5 ? QVariant() : QVariant( QStringLiteral( "name %1" ).arg( i ) ) )
+                     << QDate( 2022, 10, i + 1 ) );
+    features << f;
+  }
+  layer->dataProvider()->addFeatures( features );
+  return layer;
+}
+
+void TestQgsFeatureBatch::columns()
+{
+  QgsFeatureBatch::Column intColumn( QgsFeatureBatch::ColumnType::Int64 );
+  intColumn.appendInt64( 5 );
+  intColumn.appendNull();
+  intColumn.appendValue( QStringLiteral( "7" ) );
+  intColumn.appendValue( QStringLiteral( "x" ) );
+  QCOMPARE( intColumn.size(), 4 );
+  QVERIFY( !intColumn.isNull( 0 ) );
+  QVERIFY( intColumn.isNull( 1 ) );
+  QVERIFY( !intColumn.isNull( 2 ) );
+  QVERIFY( intColumn.isNull( 3 ) );
+  QCOMPARE( intColumn.int64Values().at( 2 ), 7LL );
+  QCOMPARE( intColumn.value( 0 ), QVariant( 5LL ) );
+  QVERIFY( intColumn.value( 1 ).isNull() );
+  QCOMPARE( intColumn.validity().size(), 1 );
+
+  QgsFeatureBatch::Column stringColumn( QgsFeatureBatch::ColumnType::String );
+  for ( int i = 0; i < 10; ++i )
+  {
+    if ( i == 4 )
+      stringColumn.appendNull();
+    else
+      stringColumn.appendString( QStringLiteral( "é%1" ).arg( i ) );
+  }
+  QCOMPARE( stringColumn.size(), 10 );
+  QCOMPARE( stringColumn.validity().size(), 2 );
+  QCOMPARE( stringColumn.stringOffsets().size(), 11 );
+  QCOMPARE( stringColumn.stringValue( 9 ), QStringLiteral( "é9" ) );
+  QVERIFY( stringColumn.isNull( 4 ) );
+  QVERIFY( stringColumn.stringValue( 4 ).isNull() );
+  QCOMPARE( stringColumn.stringOffsets().at( 4 ), stringColumn.stringOffsets().at( 5 ) );
+
+  stringColumn.clear();
+  QCOMPARE( stringColumn.size(), 0 );
+  QCOMPARE( stringColumn.stringOffsets().size(), 1 );
+}
+
+void TestQgsFeatureBatch::memoryProvider()
+{
+  std::unique_ptr< QgsVectorLayer > layer = createLayer();
+
+  QgsFeatureBatch batch( layer->fields() );
+  QCOMPARE( batch.columnCount(), 4 );
+  QCOMPARE( batch.column( 0 ).type(), QgsFeatureBatch::ColumnType::Int64 );
+  QCOMPARE( batch.column( 1 ).type(), QgsFeatureBatch::ColumnType::Double );
+  QCOMPARE( batch.column( 2 ).type(), QgsFeatureBatch::ColumnType::String );
+  QCOMPARE( batch.column( 3 ).type(), QgsFeatureBatch::ColumnType::Variant );
+
+  QgsFeatureIterator it = layer->dataProvider()->getFeatures( QgsFeatureRequest().setFlags( QgsFeatureRequest::NoGeometry ) );
+  QVERIFY( it.nextBatch( batch, 4 ) );
+  QCOMPARE( batch.size(), 4 );
+  QVERIFY( batch.column( 1 ).isNull( 3 ) );
+  QCOMPARE( batch.column( 1 ).doubleValues().at( 2 ), 3.0 );
+  QCOMPARE( batch.column( 2 ).stringValue( 0 ), QStringLiteral( "name 0" ) );
+  QCOMPARE( batch.attributes( 1 ), QgsAttributes() << 1LL << 1.5 << QStringLiteral( "name 1" ) << QDate( 2022, 10, 2 ) );
+
+  QVERIFY( it.nextBatch( batch, 4 ) );
+  QCOMPARE( batch.size(), 4 );
+  QCOMPARE( batch.column( 0 ).int64Values().at( 0 ), 4LL );
+  QVERIFY( batch.column( 2 ).isNull( 1 ) );
+
+  QVERIFY( it.nextBatch( batch, 4 ) );
+  QCOMPARE( batch.size(), 2 );
+  QVERIFY( !it.nextBatch( batch, 4 ) );
+  QVERIFY( batch.isEmpty() );
+
+  // limit
+  it = layer->dataProvider()->getFeatures( QgsFeatureRequest().setLimit( 3 ) );
+  QVERIFY( it.nextBatch( batch, 10 ) );
+  QCOMPARE( batch.size(), 3 );
+  QVERIFY( !it.nextBatch( batch, 10 ) );
+}
+
+void TestQgsFeatureBatch::vectorLayer()
+{
+  std::unique_ptr< QgsVectorLayer > layer = createLayer();
+
+  // without edit buffer the batches are filled by the provider iterator
+  QgsFeatureBatch batch( layer->fields() );
+  QgsFeatureIterator it = layer->getFeatures();
+  QVERIFY( it.nextBatch( batch, 6 ) );
+  QCOMPARE( batch.size(), 6 );
+  QCOMPARE( batch.column( 0 ).int64Values(), QVector< qint64 >() << 0 << 1 << 2 << 3 << 4 << 5 );
+  QVERIFY( batch.column( 1 ).isNull( 3 ) );
+  QVERIFY( it.nextBatch( batch, 6 ) );
+  QCOMPARE( batch.size(), 4 );
+  QVERIFY( !it.nextBatch( batch, 6 ) );
+
+  it = layer->getFeatures( QgsFeatureRequest().setLimit( 3 ) );
+  QVERIFY( it.nextBatch( batch, 10 ) );
+  QCOMPARE( batch.size(), 3 );
+  QVERIFY( !it.nextBatch( batch, 10 ) );
+
+  // the changes of the edit buffer are part of the batches
+  QVERIFY( layer->startEditing() );
+  QVERIFY( layer->changeAttributeValue( 2, 2, QStringLiteral( "changed" ) ) );
+  QgsFeature added( layer->fields() );
+  added.setAttributes( QgsAttributes() << 10 << 15.0 << QStringLiteral( "added" ) << QDate( 2022, 10, 11 ) );
+  QVERIFY( layer->addFeature( added ) );
+  it = layer->getFeatures();
+  QVERIFY( it.nextBatch( batch, 100 ) );
+  QCOMPARE( batch.size(), 11 );
+  QStringList names;
+  for ( int i = 0; i < batch.size(); ++i )
+    names << batch.column( 2 ).stringValue( i );
+  QVERIFY( names.contains( QStringLiteral( "changed" ) ) );
+  QVERIFY( names.contains( QStringLiteral( "added" ) ) );
+  QVERIFY( !names.contains( QStringLiteral( "name 1" ) ) );
+  layer->rollBack();
+}
+
+void TestQgsFeatureBatch::fallback()
+{
+  std::unique_ptr< QgsVectorLayer > layer = createLayer();
+
+  // expression filters and ordering go through nextFeature()
+  QgsFeatureBatch batch( layer->fields(), QgsAttributeList() << 2 << 0 );
+  QgsFeatureRequest request;
+  request.setFilterExpression( QStringLiteral( "id > 5" ) );
+  request.addOrderBy( QStringLiteral( "id" ), false );
+  QgsFeatureIterator it = layer->getFeatures( request );
+  QVERIFY( it.nextBatch( batch, 100 ) );
+  QCOMPARE( batch.size(), 4 );
+  QCOMPARE( batch.columnFieldIndex( 0 ), 2 );
+  QCOMPARE( batch.column( 0 ).stringValue( 0 ), QStringLiteral( "name 9" ) );
+  QCOMPARE( batch.column( 1 ).int64Values(), QVector< qint64 >() << 9 << 8 << 7 << 6 );
+  QVERIFY( !it.nextBatch( batch, 100 ) );
+}
+
+QGSTEST_MAIN( TestQgsFeatureBatch )
+#include "testqgsfeaturebatch.moc"
@@ -54,6 +54,8 @@ class TestQgsGeometryImport: public QObject
     void delimiters_data();
     void delimiters();
 
+    void benchmarkLinestringWkb();
+
   private:
     bool compareLineStrings( const QgsPolylineXY &polyline, QVariantList &line );
 
@@ -276,5 +278,21 @@ void TestQgsGeometryImport::delimiters()
   QCOMPARE( gInput.asWkt(), expected );
 }
 
+void TestQgsGeometryImport::benchmarkLinestringWkb()
+{
+  QgsPolylineXY polyline;
+  polyline.reserve( 10000 );
+  for ( int i = 0; i < 10000; ++i )
+    polyline << QgsPointXY( i, i % 100 );
+  const QByteArray wkb = QgsGeometry::fromPolylineXY( polyline ).asWkb();
+
+  QBENCHMARK
+  {
+    QgsGeometry geom;
+    geom.fromWkb( wkb );
+    QCOMPARE( geom.constGet()->nCoordinates(), 10000 );
+  }
+}
+
 QGSTEST_MAIN( TestQgsGeometryImport )
 #include "testqgsgeometryimport.moc"
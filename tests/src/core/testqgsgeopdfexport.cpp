@@ -53,6 +53,7 @@ class TestQgsGeoPdfExport : public QgsTest
     void initTestCase();// will be called before the first testfunction is executed.
     void cleanupTestCase();// will be called after the last testfunction was executed.
     void testCollectingFeatures();
+    void testCollectingManyFeatures();
     void testComposition();
     void testMetadata();
     void testGeoref();
@@ -156,6 +157,43 @@ void TestQgsGeoPdfExport::testCollectingFeatures()
   QCOMPARE( f.geometry().asWkt(), QStringLiteral( "LineString (1 1, 2 2)" ) );
 }
 
+void TestQgsGeoPdfExport::testCollectingManyFeatures()
+{
+  if ( !QgsAbstractGeoPdfExporter::geoPDFCreationAvailable() )
+  {
+    QSKIP( "This test requires GeoPDF creation abilities", SkipSingle );
+  }
+
+  TestGeoPdfExporter geoPdfExporter;
+
+  QgsFields fields;
+  fields.append( QgsField( QStringLiteral( "a1" ), QVariant::Int ) );
+  QgsFeature f( fields );
+
+  // enough features to be written to the temporary layer in several batches
+  for ( int i = 0; i < 2500; ++i )
+  {
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry( new QgsPoint( i, i ) ) );
+    geoPdfExporter.pushRenderedFeature( QStringLiteral( "layer1" ), QgsAbstractGeoPdfExporter::RenderedFeature( f, QgsGeometry::fromRect( QgsRectangle( i, 10, i + 1, 20 ) ) ) );
+  }
+  // only the last batch is kept in memory
+  QVERIFY( geoPdfExporter.mCollatedFeatures.value( QString() ).value( QStringLiteral( "layer1" ) ).count() < 2500 );
+
+  QVERIFY( geoPdfExporter.saveTemporaryLayers() );
+  QCOMPARE( geoPdfExporter.mVectorComponents.count(), 1 );
+  const QgsAbstractGeoPdfExporter::VectorComponentDetail component = geoPdfExporter.mVectorComponents.at( 0 );
+  QCOMPARE( component.mapLayerId, QStringLiteral( "layer1" ) );
+
+  std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "%1|layerName=%2" ).arg( component.sourceVectorPath, component.sourceVectorLayer ), QStringLiteral( "layer" ), QStringLiteral( "ogr" ) );
+  QVERIFY( layer->isValid() );
+  QCOMPARE( layer->featureCount(), 2500L );
+  QgsFeatureIterator it = layer->getFeatures();
+  QVERIFY( it.nextFeature( f ) );
+  QCOMPARE( f.attributes().at( 1 ).toInt(), 0 );
+  QCOMPARE( f.geometry().asWkt(), QStringLiteral( "Polygon ((0 10, 1 10, 1 20, 0 20, 0 10))" ) );
+}
+
 void TestQgsGeoPdfExport::testComposition()
 {
   TestGeoPdfExporter geoPdfExporter;
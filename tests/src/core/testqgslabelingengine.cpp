@@ -110,6 +110,7 @@ class TestQgsLabelingEngine : public QgsTest
     void labelingResults();
     void labelingResultsCurved();
     void labelingResultsWithCallouts();
+    void previousLabelPositions();
     void pointsetExtend();
     void curvedOverrun();
     void parallelOverrun();
@@ -4276,6 +4277,86 @@ void TestQgsLabelingEngine::labelingResultsWithCallouts()
   QGSCOMPARENEAR( callouts.at( callout1IsFirstLayer ? 1 : 0 ).destination().y(), 6974872.0, 10 );
 }
 
+void TestQgsLabelingEngine::previousLabelPositions()
+{
+  // test that labels are kept at their position from a previous render
+  QgsPalLayerSettings settings;
+  setDefaultLabelParams( settings );
+  settings.fieldName = QStringLiteral( "'X'" );
+  settings.isExpression = true;
+  settings.placement = Qgis::LabelPlacement::AroundPoint;
+  settings.dist = 2;
+
+  std::unique_ptr< QgsVectorLayer> vl( new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:4326&field=id:integer" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) ) );
+  vl->setRenderer( new QgsNullSymbolRenderer() );
+
+  QgsFeature f;
+  f.setAttributes( QgsAttributes() << 1 );
+  f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 5, 5 ) ) );
+  QVERIFY( vl->dataProvider()->addFeature( f ) );
+
+  vl->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );
+  vl->setLabelsEnabled( true );
+
+  QgsMapSettings mapSettings;
+  mapSettings.setLabelingEngineSettings( createLabelEngineSettings() );
+  mapSettings.setDestinationCrs( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ) );
+  mapSettings.setOutputSize( QSize( 600, 600 ) );
+  mapSettings.setExtent( QgsRectangle( 0, 0, 10, 10 ) );
+  mapSettings.setLayers( QList<QgsMapLayer *>() << vl.get() );
+  mapSettings.setOutputDpi( 96 );
+
+  auto render = [&mapSettings]( const QList< QgsLabelPosition > &previousPositions ) -> QList< QgsLabelPosition >
+  {
+    QgsMapRendererSequentialJob job( mapSettings );
+    job.setPreviousLabelPositions( previousPositions );
+    job.start();
+    job.waitForFinished();
+    std::unique_ptr< QgsLabelingResults > results( job.takeLabelingResults() );
+    return results->allLabels();
+  };
+
+  const QList< QgsLabelPosition > defaultLabels = render( QList< QgsLabelPosition >() );
+  QCOMPARE( defaultLabels.size(), 1 );
+
+  // block the best position, so that the label is placed elsewhere
+  mapSettings.setLabelBlockingRegions( QList< QgsLabelBlockingRegion >() << QgsLabelBlockingRegion( defaultLabels.at( 0 ).labelGeometry.buffer( 0.1, 4 ) ) );
+  const QList< QgsLabelPosition > blockedLabels = render( QList< QgsLabelPosition >() );
+  QCOMPARE( blockedLabels.size(), 1 );
+  QVERIFY( !blockedLabels.at( 0 ).labelRect.intersects( defaultLabels.at( 0 ).labelRect ) );
+
+  // without the blocking region the label stays where it was previously placed
+  mapSettings.setLabelBlockingRegions( QList< QgsLabelBlockingRegion >() );
+  QList< QgsLabelPosition > labels = render( blockedLabels );
+  QCOMPARE( labels.size(), 1 );
+  QGSCOMPARENEAR( labels.at( 0 ).labelRect.xMinimum(), blockedLabels.at( 0 ).labelRect.xMinimum(), 0.0001 );
+  QGSCOMPARENEAR( labels.at( 0 ).labelRect.yMinimum(), blockedLabels.at( 0 ).labelRect.yMinimum(), 0.0001 );
+
+  // including once the map is panned
+  mapSettings.setExtent( QgsRectangle( 0.5, 0.3, 10.5, 10.3 ) );
+  labels = render( blockedLabels );
+  QCOMPARE( labels.size(), 1 );
+  QGSCOMPARENEAR( labels.at( 0 ).labelRect.xMinimum(), blockedLabels.at( 0 ).labelRect.xMinimum(), 0.0001 );
+  QGSCOMPARENEAR( labels.at( 0 ).labelRect.yMinimum(), blockedLabels.at( 0 ).labelRect.yMinimum(), 0.0001 );
+
+  // and when the map is rotated
+  mapSettings.setRotation( 30 );
+  const QList< QgsLabelPosition > rotatedLabels = render( QList< QgsLabelPosition >() );
+  QCOMPARE( rotatedLabels.size(), 1 );
+  mapSettings.setExtent( QgsRectangle( 0, 0, 10, 10 ) );
+  labels = render( rotatedLabels );
+  QCOMPARE( labels.size(), 1 );
+  QGSCOMPARENEAR( labels.at( 0 ).labelRect.xMinimum(), rotatedLabels.at( 0 ).labelRect.xMinimum(), 0.0001 );
+  QGSCOMPARENEAR( labels.at( 0 ).labelRect.yMinimum(), rotatedLabels.at( 0 ).labelRect.yMinimum(), 0.0001 );
+  mapSettings.setRotation( 0 );
+
+  // without previous positions the label is placed at its best position again
+  labels = render( QList< QgsLabelPosition >() );
+  QCOMPARE( labels.size(), 1 );
+  QGSCOMPARENEAR( labels.at( 0 ).labelRect.xMinimum(), defaultLabels.at( 0 ).labelRect.xMinimum(), 0.0001 );
+  QGSCOMPARENEAR( labels.at( 0 ).labelRect.yMinimum(), defaultLabels.at( 0 ).labelRect.yMinimum(), 0.0001 );
+}
+
 void TestQgsLabelingEngine::pointsetExtend()
 {
   // test extending pointsets by distance
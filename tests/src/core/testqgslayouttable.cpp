@@ -87,6 +87,7 @@ class TestQgsLayoutTable : public QgsTest
     void wrappedText();
     void testBaseSort();
     void testExpressionSort();
+    void testExpressionRowNumber();
     void testScopeForCell();
     void testDataDefinedTextFormatForCell();
     void testIntegerNullCell();
@@ -1833,6 +1834,28 @@ void TestQgsLayoutTable::testExpressionSort()
   compareTable( table, expectedRows );
 }
 
+void TestQgsLayoutTable::testExpressionRowNumber()
+{
+  QgsLayout l( QgsProject::instance() );
+  l.initializeDefaults();
+  QgsLayoutItemAttributeTable *table = new QgsLayoutItemAttributeTable( &l );
+  table->setVectorLayer( mVectorLayer );
+  table->setDisplayOnlyVisibleFeatures( false );
+  table->setMaximumNumberOfFeatures( 3 );
+  QgsLayoutTableColumn col;
+  col.setAttribute( "@row_number * 10" );
+  col.setHeading( "exp" );
+  table->columns() = {col};
+  table->refresh();
+
+  // expressions are evaluated for each row
+  QVector<QStringList> expectedRows;
+  expectedRows << ( QStringList() << QStringLiteral( "10" ) );
+  expectedRows << ( QStringList() << QStringLiteral( "20" ) );
+  expectedRows << ( QStringList() << QStringLiteral( "30" ) );
+  compareTable( table, expectedRows );
+}
+
 void TestQgsLayoutTable::testScopeForCell()
 {
   QgsLayout l( QgsProject::instance() );
@@ -34,6 +34,7 @@ class TestQgsMapRendererCache: public QObject
     void cleanup(); // will be called after every testfunction.
 
     void testCache();
+    void testMaximumSize();
 };
 
 
@@ -154,6 +155,55 @@ void TestQgsMapRendererCache::testCache()
   QVERIFY( !cache.hasAnyCacheImage( imgRedKey ) );
 }
 
+void TestQgsMapRendererCache::testMaximumSize()
+{
+  QgsMapRendererCache cache;
+  QCOMPARE( cache.maximumCacheSize(), 0LL );
+
+  const QgsRectangle extent( 0, 0, 100, 200 );
+  const QgsMapToPixel mtp( 1, 50, 50, 100, 100, 0.0 );
+  cache.updateParameters( extent, mtp );
+
+  QImage imgRed( 100, 100, QImage::Format::Format_ARGB32_Premultiplied );
+  imgRed.fill( Qt::red );
+  QImage imgBlue( 100, 100, QImage::Format::Format_ARGB32_Premultiplied );
+  imgBlue.fill( Qt::blue );
+  QImage imgGreen( 100, 100, QImage::Format::Format_ARGB32_Premultiplied );
+  imgGreen.fill( Qt::green );
+  const qint64 imageSize = imgRed.sizeInBytes();
+
+  cache.setCacheImage( QStringLiteral( "red" ), imgRed );
+  cache.setCacheImage( QStringLiteral( "blue" ), imgBlue );
+  QCOMPARE( cache.cacheSize(), 2 * imageSize );
+
+  // red is the least recently used image and gets evicted
+  cache.setMaximumCacheSize( 2 * imageSize );
+  ( void )cache.cacheImage( QStringLiteral( "blue" ) );
+  cache.setCacheImage( QStringLiteral( "green" ), imgGreen );
+  QVERIFY( !cache.hasCacheImage( QStringLiteral( "red" ) ) );
+  QVERIFY( cache.hasCacheImage( QStringLiteral( "blue" ) ) );
+  QVERIFY( cache.hasCacheImage( QStringLiteral( "green" ) ) );
+  QVERIFY( cache.cacheSize() <= 2 * imageSize );
+
+  // cold images are compressed instead of evicted
+  cache.clear();
+  cache.updateParameters( extent, mtp );
+  cache.setCompressColdImages( true );
+  QVERIFY( cache.compressColdImages() );
+  cache.setCacheImage( QStringLiteral( "red" ), imgRed );
+  cache.setCacheImage( QStringLiteral( "blue" ), imgBlue );
+  cache.setCacheImage( QStringLiteral( "green" ), imgGreen );
+  QVERIFY( cache.hasCacheImage( QStringLiteral( "red" ) ) );
+  QVERIFY( cache.hasCacheImage( QStringLiteral( "blue" ) ) );
+  QVERIFY( cache.hasCacheImage( QStringLiteral( "green" ) ) );
+  QVERIFY( cache.cacheSize() <= 2 * imageSize );
+
+  const QImage red = cache.cacheImage( QStringLiteral( "red" ) );
+  QCOMPARE( red.size(), imgRed.size() );
+  QCOMPARE( red.format(), imgRed.format() );
+  QCOMPARE( red.pixelColor( 10, 20 ), QColor( Qt::red ) );
+}
+
 
 QGSTEST_MAIN( TestQgsMapRendererCache )
 #include "testqgsmaprenderercache.moc"
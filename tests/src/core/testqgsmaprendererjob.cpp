@@ -55,6 +55,7 @@
 #include "qgsfillsymbol.h"
 #include "qgsrasterlayerelevationproperties.h"
 #include "qgsrasterresamplefilter.h"
+#include "qgsruntimeprofiler.h"
 
 //qgs unit test utility class
 #include "qgsmultirenderchecker.h"
@@ -101,6 +102,7 @@ class TestQgsMapRendererJob : public QgsTest
 
     void labelSink();
     void skipSymbolRendering();
+    void recordProfile();
 
     void customNullPainterJob();
 
@@ -1040,6 +1042,44 @@ void TestQgsMapRendererJob::skipSymbolRendering()
   QVERIFY( imageCheck( QStringLiteral( "skip_symbol_rendering" ), img ) );
 }
 
+void TestQgsMapRendererJob::recordProfile()
+{
+  std::unique_ptr< QgsVectorLayer > pointsLayer = std::make_unique< QgsVectorLayer >( TEST_DATA_DIR + QStringLiteral( "/points.shp" ),
+      QStringLiteral( "points" ), QStringLiteral( "ogr" ) );
+  QVERIFY( pointsLayer->isValid() );
+
+  QgsMapSettings mapSettings;
+  mapSettings.setDestinationCrs( pointsLayer->crs() );
+  mapSettings.setExtent( pointsLayer->extent() );
+  mapSettings.setOutputSize( QSize( 512, 512 ) );
+  mapSettings.setOutputDpi( 96 );
+  mapSettings.setLayers( QList< QgsMapLayer * >() << pointsLayer.get() );
+
+  QgsApplication::profiler()->clear( QStringLiteral( "render" ) );
+
+  // nothing is recorded by default
+  QgsMapRendererSequentialJob renderJob( mapSettings );
+  renderJob.start();
+  renderJob.waitForFinished();
+  QCoreApplication::processEvents();
+  QVERIFY( QgsApplication::profiler()->childGroups( QString(), QStringLiteral( "render" ) ).isEmpty() );
+
+  mapSettings.setFlag( Qgis::MapSettingsFlag::RecordProfile, true );
+  QgsMapRendererSequentialJob profiledJob( mapSettings );
+  profiledJob.start();
+  profiledJob.waitForFinished();
+  // events of the render threads are forwarded to the main thread profiler
+  QCoreApplication::processEvents();
+
+  QCOMPARE( QgsApplication::profiler()->childGroups( QString(), QStringLiteral( "render" ) ), QStringList() << QStringLiteral( "points" ) );
+  QCOMPARE( QgsApplication::profiler()->childGroups( QStringLiteral( "points" ), QStringLiteral( "render" ) ),
+            QStringList() << QStringLiteral( "Preparing render" ) << QStringLiteral( "Rendering features" ) );
+  QCOMPARE( QgsApplication::profiler()->childGroups( QStringLiteral( "points/Rendering features" ), QStringLiteral( "render" ) ),
+            QStringList() << QStringLiteral( "Fetching features" ) << QStringLiteral( "Rendering symbols" ) );
+
+  QgsApplication::profiler()->clear( QStringLiteral( "render" ) );
+}
+
 void TestQgsMapRendererJob::customNullPainterJob()
 {
   std::unique_ptr< QgsVectorLayer > pointsLayer = std::make_unique< QgsVectorLayer >( TEST_DATA_DIR + QStringLiteral( "/points.shp" ),
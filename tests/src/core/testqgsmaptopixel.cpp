@@ -19,6 +19,7 @@
 #include <qgsrectangle.h>
 #include <qgsmaptopixel.h>
 #include <qgspoint.h>
+#include <QPolygonF>
 #include "qgslogger.h"
 
 class TestQgsMapToPixel: public QObject
@@ -31,6 +32,7 @@ class TestQgsMapToPixel: public QObject
     void fromScale();
     void equality();
     void toMapCoordinates();
+    void transformCoords();
 };
 
 void TestQgsMapToPixel::isValid()
@@ -185,6 +187,39 @@ void TestQgsMapToPixel::toMapCoordinates()
   QCOMPARE( p, QgsPointXY( 20, 20 ) );
 }
 
+void TestQgsMapToPixel::transformCoords()
+{
+  // batched transforms must give the same results as transforming each point
+  const QList< double > rotations { 0, 30, 90 };
+  for ( const double rotation : rotations )
+  {
+    const QgsMapToPixel m2p( 0.5, 10, 20, 100, 50, rotation );
+
+    QVector< double > x;
+    QVector< double > y;
+    QPolygonF polygon;
+    for ( int i = 0; i < 37; ++i )
+    {
+      x << i * 1.5 - 3;
+      y << 20 - i * 0.7;
+      polygon << QPointF( x.last(), y.last() );
+    }
+    const QVector< double > mapX = x;
+    const QVector< double > mapY = y;
+
+    m2p.transformCoords( x.size(), x.data(), y.data() );
+    m2p.transformPolygon( polygon );
+    for ( int i = 0; i < mapX.size(); ++i )
+    {
+      const QgsPointXY expected = m2p.transform( mapX.at( i ), mapY.at( i ) );
+      QGSCOMPARENEAR( x.at( i ), expected.x(), 1e-9 );
+      QGSCOMPARENEAR( y.at( i ), expected.y(), 1e-9 );
+      QGSCOMPARENEAR( polygon.at( i ).x(), expected.x(), 1e-9 );
+      QGSCOMPARENEAR( polygon.at( i ).y(), expected.y(), 1e-9 );
+    }
+  }
+}
+
 QGSTEST_MAIN( TestQgsMapToPixel )
 #include "testqgsmaptopixel.moc"
 
@@ -29,6 +29,7 @@
 #include <qgsapplication.h>
 #include <qgsgeometry.h>
 #include <qgsmaptopixelgeometrysimplifier.h>
+#include <qgswkbgeometryview.h>
 #if 0
 #include <qgspoint.h>
 #include "qgsgeometryutils.h"
@@ -78,6 +79,7 @@ class TestQgsMapToPixelGeometrySimplifier : public QObject
     void testVisvalingam();
     void testRingValidity();
     void testAbstractGeometrySimplify();
+    void testWkbGeometryViewSimplify();
 
 };
 
@@ -255,5 +257,51 @@ void TestQgsMapToPixelGeometrySimplifier::testAbstractGeometrySimplify()
   QCOMPARE( simplified->asWkt( 2 ), QStringLiteral( "LineString (1 1, 2 1.1, 3 0.9, 4 1)" ) );
 }
 
+void TestQgsMapToPixelGeometrySimplifier::testWkbGeometryViewSimplify()
+{
+  // geometries simplified from their WKB must match the ones simplified from their geometry objects
+  const QStringList wkts
+  {
+    QStringLiteral( "LineString (0 0, 1 1, 2 0, 3 1, 4 0, 20 1, 20 0, 10 0, 5 0)" ),
+    QStringLiteral( "LineStringZM (0 0 1 2, 1 1 1 2, 2 0 1 2, 3 1 1 2, 4 0 1 2, 20 1 1 2, 20 0 1 2, 10 0 1 2, 5 0 1 2)" ),
+    QStringLiteral( "LineStringZ (0 0 0, 1 1 10, 2 0 0, 3 1 10, 4 0 0, 20 1 5, 20 0 0, 10 0 0, 5 0 0)" ),
+    QStringLiteral( "LineString( 1 1, 2 1.1, 2.1 1.09, 3 0.9, 4 1 )" ),
+    QStringLiteral( "LineString( 1 1, 50 1.5, 100 2, 100 200 )" ),
+    QStringLiteral( "Polygon ((0 0, 30 0, 30 30, 0 30, 0 0),(10.0001 10.00002, 10.0005 10.00002, 10.0005 10.00004, 10.00001 10.00004, 10.0001 10.00002 ))" ),
+    QStringLiteral( "Polygon ((0 0, 1 0.1, 2 0, 3 0.1, 4 0, 4 4, 3 4.1, 2 4, 1 4.1, 0 4, 0 0))" ),
+    QStringLiteral( "MultiPolygonZ (((0 0 1, 1 0.1 1, 2 0 1, 3 0.1 1, 4 0 1, 4 4 1, 0 4 1, 0 0 1)),((10 10 2, 11 10 2, 11 11 2, 10 11 2, 10 10 2)))" ),
+    QStringLiteral( "MultiLineString ((0 0, 1 1, 2 0, 3 1, 4 0, 20 1),(0 10, 1 11, 2 10, 3 11))" ),
+    QStringLiteral( "MultiCurve (LineString (5 5, 3 5, 3 3, 0 3),CircularString (0 0, 2 1, 2 2))" ),
+    QStringLiteral( "Point (1 2)" ),
+  };
+
+  const QList< int > flags
+  {
+    QgsMapToPixelSimplifier::SimplifyGeometry,
+    QgsMapToPixelSimplifier::SimplifyEnvelope,
+    QgsMapToPixelSimplifier::SimplifyGeometry | QgsMapToPixelSimplifier::SimplifyEnvelope
+  };
+
+  for ( const QString &wkt : wkts )
+  {
+    const QgsGeometry g = QgsGeometry::fromWkt( wkt );
+    const QgsWkbGeometryView view( g.asWkb() );
+    for ( const int fl : flags )
+    {
+      for ( const QgsMapToPixelSimplifier::SimplifyAlgorithm algorithm : { QgsMapToPixelSimplifier::Distance, QgsMapToPixelSimplifier::SnapToGrid, QgsMapToPixelSimplifier::Visvalingam } )
+      {
+        for ( const double tolerance : { 0.01, 0.5, 5.0, 30.0 } )
+        {
+          const QgsMapToPixelSimplifier simplifier( fl, tolerance, algorithm );
+          QCOMPARE( simplifier.simplify( view ).asWkt(), simplifier.simplify( g ).asWkt() );
+        }
+      }
+    }
+  }
+
+  const QgsMapToPixelSimplifier simplifier( QgsMapToPixelSimplifier::SimplifyGeometry, 5 );
+  QVERIFY( simplifier.simplify( QgsWkbGeometryView( QByteArray() ) ).isNull() );
+}
+
 QGSTEST_MAIN( TestQgsMapToPixelGeometrySimplifier )
 #include "testqgsmaptopixelgeometrysimplifier.moc"
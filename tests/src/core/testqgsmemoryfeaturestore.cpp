@@ -0,0 +1,227 @@
+/***************************************************************************
+     testqgsmemoryfeaturestore.cpp
+     -----------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+#include <QString>
+
+#include <qgsapplication.h>
+#include "qgsfeatureiterator.h"
+#include "qgsgeometry.h"
+#include "qgsmemoryfeaturestore.h"
+#include "qgsvectordataprovider.h"
+#include "qgsvectorlayer.h"
+
+Q_DECLARE_METATYPE( QgsMemoryFeatureStore::Layout )
+
+static QgsFeature _feature( QgsFeatureId id, const QgsAttributes &attributes, const QString &wkt = QString() )
+{
+  QgsFeature f( id );
+  f.setAttributes( attributes );
+  if ( !wkt.isEmpty() )
+    f.setGeometry( QgsGeometry::fromWkt( wkt ) );
+  f.setValid( true );
+  return f;
+}
+
+class TestQgsMemoryFeatureStore : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+
+    void initTestCase()
+    {
+      QgsApplication::init();
+      QgsApplication::initQgis();
+    }
+    void cleanupTestCase()
+    {
+      QgsApplication::exitQgis();
+    }
+
+    void testStore_data()
+    {
+      QTest::addColumn<QgsMemoryFeatureStore::Layout>( "layout" );
+
+      QTest::newRow( "features" ) << QgsMemoryFeatureStore::Layout::Features;
+      QTest::newRow( "columnar" ) << QgsMemoryFeatureStore::Layout::Columnar;
+    }
+
+    void testStore()
+    {
+      QFETCH( QgsMemoryFeatureStore::Layout, layout );
+
+      QgsMemoryFeatureStore store( layout, QList< QVariant::Type >() << QVariant::Int << QVariant::Double << QVariant::String << QVariant::Bool << QVariant::Date );
+      QCOMPARE( store.layout(), layout );
+      QVERIFY( store.isEmpty() );
+
+      store.insert( _feature( 1, QgsAttributes() << 5 << 1.5 << QStringLiteral( "a" ) << true << QDate( 2022, 10, 1 ), QStringLiteral( "Point (1 2)" ) ) );
+      store.insert( _feature( 2, QgsAttributes() << QVariant( QVariant::Int ) << QVariant() << QString() << false << QVariant( QVariant::Date ) ) );
+      store.insert( _feature( 3, QgsAttributes() << 7 << -2.0 << QStringLiteral( "c" ) << QVariant( QVariant::Bool ) << QDate(), QStringLiteral( "LineString (0 0, 10 5)" ) ) );
+      QCOMPARE( store.count(), 3 );
+      QVERIFY( store.contains( 2 ) );
+      QVERIFY( !store.contains( 4 ) );
+
+      // values are read back with their types and null state
+      QgsFeature f = store.feature( 1 );
+      QCOMPARE( f.id(), 1LL );
+      QCOMPARE( f.attributes(), QgsAttributes() << 5 << 1.5 << QStringLiteral( "a" ) << true << QDate( 2022, 10, 1 ) );
+      QCOMPARE( f.attribute( 0 ).type(), QVariant::Int );
+      QCOMPARE( f.attribute( 3 ).type(), QVariant::Bool );
+      QCOMPARE( f.geometry().asWkt(), QStringLiteral( "Point (1 2)" ) );
+
+      f = store.feature( 2 );
+      QVERIFY( !f.hasGeometry() );
+      QVERIFY( f.attribute( 0 ).isNull() );
+      QCOMPARE( f.attribute( 0 ).type(), QVariant::Int );
+      QVERIFY( !f.attribute( 1 ).isValid() );
+      QCOMPARE( f.attribute( 3 ), QVariant( false ) );
+
+      QCOMPARE( store.attribute( 3, 2 ), QVariant( QStringLiteral( "c" ) ) );
+      QVERIFY( !store.feature( 4 ).isValid() );
+
+      // a value of another type than the field is kept as it is
+      QVERIFY( store.setAttribute( 3, 0, QStringLiteral( "x" ) ) );
+      QCOMPARE( store.attribute( 3, 0 ), QVariant( QStringLiteral( "x" ) ) );
+      QCOMPARE( store.attribute( 1, 0 ), QVariant( 5 ) );
+      QVERIFY( !store.setAttribute( 4, 0, 1 ) );
+
+      QVERIFY( store.setGeometry( 2, QgsGeometry::fromWkt( QStringLiteral( "Point (5 5)" ) ) ) );
+      QVERIFY( store.setGeometry( 1, QgsGeometry() ) );
+      QCOMPARE( store.feature( 2 ).geometry().asWkt(), QStringLiteral( "Point (5 5)" ) );
+      QVERIFY( !store.feature( 1 ).hasGeometry() );
+      QCOMPARE( store.feature( 3 ).geometry().asWkt(), QStringLiteral( "LineString (0 0, 10 5)" ) );
+
+      // rows
+      QCOMPARE( store.rowCount(), 3 );
+      QCOMPARE( store.rowId( 2 ), 3LL );
+      QVERIFY( store.rowHasGeometry( 2 ) );
+      QVERIFY( !store.rowHasGeometry( 0 ) );
+      QCOMPARE( store.rowBoundingBox( 2 ), QgsRectangle( 0, 0, 10, 5 ) );
+
+      // fields
+      store.appendField( QVariant::LongLong );
+      QVERIFY( !store.attribute( 1, 5 ).isValid() );
+      QVERIFY( store.setAttribute( 1, 5, QVariant( 1234567890123LL ) ) );
+      QCOMPARE( store.attribute( 1, 5 ), QVariant( 1234567890123LL ) );
+      store.removeField( 1 );
+      QCOMPARE( store.feature( 1 ).attributes(), QgsAttributes() << 5 << QStringLiteral( "a" ) << true << QDate( 2022, 10, 1 ) << QVariant( 1234567890123LL ) );
+
+      // a copy is not affected by changes to the store
+      const QgsMemoryFeatureStore copy = store;
+      QVERIFY( store.remove( 2 ) );
+      QVERIFY( !store.remove( 2 ) );
+      QCOMPARE( store.count(), 2 );
+      QVERIFY( !store.contains( 2 ) );
+      QVERIFY( !store.rowHasFeature( 1 ) );
+      QCOMPARE( copy.count(), 3 );
+      QCOMPARE( copy.feature( 2 ).geometry().asWkt(), QStringLiteral( "Point (5 5)" ) );
+
+      // removed ids can be added again, and ids out of order are inserted at their row
+      store.insert( _feature( 2, QgsAttributes() << 8 << QStringLiteral( "b" ) << true << QDate() << 1LL ) );
+      store.insert( _feature( 0, QgsAttributes() << 9 << QStringLiteral( "z" ) << false << QDate() << 2LL ) );
+      QCOMPARE( store.count(), 4 );
+      QCOMPARE( store.rowId( 0 ), 0LL );
+      QCOMPARE( store.attribute( 2, 1 ), QVariant( QStringLiteral( "b" ) ) );
+      QCOMPARE( store.attribute( 1, 1 ), QVariant( QStringLiteral( "a" ) ) );
+
+      store.clear();
+      QVERIFY( store.isEmpty() );
+      QCOMPARE( store.rowCount(), 0 );
+      QCOMPARE( copy.count(), 3 );
+    }
+
+    void testCompact()
+    {
+      QgsMemoryFeatureStore store( QgsMemoryFeatureStore::Layout::Columnar, QList< QVariant::Type >() << QVariant::Int << QVariant::String );
+      for ( int i = 1; i <= 5000; ++i )
+        store.insert( _feature( i, QgsAttributes() << i << QString::number( i ), QStringLiteral( "Point (%1 0)" ).arg( i ) ) );
+      for ( int i = 1; i <= 4000; ++i )
+        QVERIFY( store.remove( i ) );
+
+      // removed rows are dropped once they outnumber the features
+      QCOMPARE( store.count(), 1000 );
+      QVERIFY( store.rowCount() < 5000 );
+      QCOMPARE( store.feature( 4500 ).attributes(), QgsAttributes() << 4500 << QStringLiteral( "4500" ) );
+      QCOMPARE( store.feature( 5000 ).geometry().asWkt(), QStringLiteral( "Point (5000 0)" ) );
+    }
+
+    void testWkbChunks()
+    {
+      QgsMemoryFeatureStore store( QgsMemoryFeatureStore::Layout::Columnar, QList< QVariant::Type >() << QVariant::Int );
+      // a few points per chunk, and lines which don't fit in a single chunk
+      store.setWkbChunkSize( 100 );
+
+      const auto wkt = []( int i )
+      {
+        return i % 100 == 0 ? QStringLiteral( "LineString (%1 0, %1 1, %1 2, %1 3, %1 4, %1 5, %1 6, %1 7)" ).arg( i ) : QStringLiteral( "Point (%1 0)" ).arg( i );
+      };
+      for ( int i = 1; i <= 3000; ++i )
+        store.insert( _feature( i, QgsAttributes() << i, wkt( i ) ) );
+
+      for ( int i = 1; i <= 3000; ++i )
+      {
+        QCOMPARE( store.feature( i ).geometry().asWkt(), wkt( i ) );
+        QCOMPARE( store.rowBoundingBox( i - 1 ), QgsGeometry::fromWkt( wkt( i ) ).boundingBox() );
+      }
+
+      // the remaining geometries are moved to new chunks when the store is compacted
+      for ( int i = 1; i <= 2000; ++i )
+        QVERIFY( store.remove( i ) );
+      QCOMPARE( store.count(), 1000 );
+      for ( int i = 2001; i <= 3000; ++i )
+        QCOMPARE( store.feature( i ).geometry().asWkt(), wkt( i ) );
+
+      // replaced geometries
+      QVERIFY( store.setGeometry( 2500, QgsGeometry::fromWkt( wkt( 100 ) ) ) );
+      QCOMPARE( store.feature( 2500 ).geometry().asWkt(), wkt( 100 ) );
+      QCOMPARE( store.feature( 2501 ).geometry().asWkt(), wkt( 2501 ) );
+    }
+
+    void testProvider()
+    {
+      QgsVectorLayer layer( QStringLiteral( "Point?crs=epsg:4326&field=id:integer&field=name:string(20)&storage=columnar" ), QStringLiteral( "columnar" ), QStringLiteral( "memory" ) );
+      QVERIFY( layer.isValid() );
+      QVERIFY( layer.dataProvider()->dataSourceUri().contains( QLatin1String( "storage=columnar" ) ) );
+
+      QgsFeatureList features;
+      for ( int i = 0; i < 10; ++i )
+        features << _feature( 0, QgsAttributes() << i << QStringLiteral( "f%1" ).arg( i ), QStringLiteral( "Point (%1 %1)" ).arg( i ) );
+      QVERIFY( layer.dataProvider()->addFeatures( features ) );
+      QCOMPARE( layer.dataProvider()->featureCount(), 10LL );
+      QCOMPARE( layer.dataProvider()->extent(), QgsRectangle( 0, 0, 9, 9 ) );
+
+      QVERIFY( layer.dataProvider()->deleteFeatures( QgsFeatureIds() << features.at( 3 ).id() ) );
+      QgsChangedAttributesMap changes;
+      changes[features.at( 4 ).id()][1] = QStringLiteral( "changed" );
+      QVERIFY( layer.dataProvider()->changeAttributeValues( changes ) );
+
+      QgsFeatureIterator it = layer.getFeatures( QgsFeatureRequest().setFilterRect( QgsRectangle( 2.5, 2.5, 5.5, 5.5 ) ) );
+      QgsFeature f;
+      QStringList names;
+      while ( it.nextFeature( f ) )
+        names << f.attribute( QStringLiteral( "name" ) ).toString();
+      QCOMPARE( names, QStringList() << QStringLiteral( "changed" ) << QStringLiteral( "f5" ) );
+
+      // clones keep the storage and the features
+      std::unique_ptr< QgsVectorLayer > clone( layer.clone() );
+      QCOMPARE( clone->featureCount(), 9LL );
+      QVERIFY( clone->dataProvider()->dataSourceUri().contains( QLatin1String( "storage=columnar" ) ) );
+    }
+};
+
+QGSTEST_MAIN( TestQgsMemoryFeatureStore )
+
+#include "testqgsmemoryfeaturestore.moc"
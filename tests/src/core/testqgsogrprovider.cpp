@@ -24,6 +24,8 @@
 #include <qgsproviderregistry.h>
 #include <qgsvectorlayer.h>
 #include <qgsnetworkaccessmanager.h>
+#include <qgsfeaturebatch.h>
+#include <qgsvectordataprovider.h>
 
 #include <QObject>
 #include <QThread>
@@ -51,6 +53,7 @@ class TestQgsOgrProvider : public QgsTest
     void encodeUri();
     void testThread();
     void testCsvFeatureAddition();
+    void testFeatureBatch();
 
   private:
     QString mTestDataDir;
@@ -400,5 +403,47 @@ void TestQgsOgrProvider::testCsvFeatureAddition()
 }
 
 
+void TestQgsOgrProvider::testFeatureBatch()
+{
+  const QString csvFilename = QDir::tempPath() + "/csvfeaturebatchtest.csv";
+  QFile csvFile( csvFilename );
+  if ( csvFile.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+  {
+    QTextStream textStream( &csvFile );
+    textStream << QLatin1String( "col1,col2,col3\n" );
+    for ( int i = 0; i < 25; ++i )
+      textStream << QStringLiteral( "%1,%2,\"%3\"\n" ).arg( i ).arg( i % 3 == 0 ? QString() : QString::number( i * 2 ) ).arg( QStringLiteral( "row %1" ).arg( i ) );
+    csvFile.close();
+  }
+
+  std::unique_ptr< QgsVectorLayer > csvLayer = std::make_unique< QgsVectorLayer >( csvFilename, QStringLiteral( "csv" ) );
+  QVERIFY( csvLayer->isValid() );
+
+  QgsFeatureRequest request;
+  request.setFlags( QgsFeatureRequest::NoGeometry );
+  request.setSubsetOfAttributes( QgsAttributeList() << 0 << 1 );
+
+  QList< QgsAttributes > expected;
+  QgsFeatureIterator it = csvLayer->dataProvider()->getFeatures( request );
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+    expected << ( QgsAttributes() << f.attribute( 0 ) << f.attribute( 1 ) );
+  QCOMPARE( expected.size(), 25 );
+
+  QgsFeatureBatch batch( csvLayer->fields(), QgsAttributeList() << 0 << 1 );
+  it = csvLayer->dataProvider()->getFeatures( request );
+  QList< QgsAttributes > values;
+  while ( it.nextBatch( batch, 10 ) )
+  {
+    QVERIFY( batch.size() <= 10 );
+    for ( int row = 0; row < batch.size(); ++row )
+      values << ( QgsAttributes() << batch.column( 0 ).value( row ) << batch.column( 1 ).value( row ) );
+  }
+  QCOMPARE( values, expected );
+
+  csvLayer.reset();
+  QFile::remove( csvFilename );
+}
+
 QGSTEST_MAIN( TestQgsOgrProvider )
 #include "testqgsogrprovider.moc"
@@ -29,6 +29,7 @@
 #include "qgssymbollayerutils.h"
 #include "qgslayoutmanager.h"
 #include "qgsmarkersymbol.h"
+#include "qgsrasterlayer.h"
 
 
 class TestQgsProject : public QObject
@@ -50,6 +51,9 @@ class TestQgsProject : public QObject
     void testLocalFiles();
     void testLocalUrlFiles();
     void testReadFlags();
+    void testLazyLoadLayers();
+    void testPreloadProviders();
+    void testDocumentCache();
     void testSetGetCrs();
     void testEmbeddedLayerGroupFromQgz();
     void projectSaveUser();
@@ -489,6 +493,139 @@ void TestQgsProject::testReadFlags()
   QCOMPARE( p3.layoutManager()->layouts().count(), 0 );
 }
 
+void TestQgsProject::testLazyLoadLayers()
+{
+  const QTemporaryDir dir;
+  QVERIFY( dir.isValid() );
+  const QString projectPath = dir.path() + QStringLiteral( "/lazy.qgs" );
+
+  {
+    QgsProject p;
+    QgsVectorLayer *layer = new QgsVectorLayer( QString( TEST_DATA_DIR ) + QStringLiteral( "/points.shp" ), QStringLiteral( "points" ) );
+    QVERIFY( layer->isValid() );
+    p.addMapLayer( layer );
+    QVERIFY( p.write( projectPath ) );
+  }
+
+  QgsProject p;
+  QVERIFY( p.read( projectPath, Qgis::ProjectReadFlag::LazyLoadLayers ) );
+  QCOMPARE( p.mapLayers().count(), 1 );
+  QgsVectorLayer *layer = qobject_cast< QgsVectorLayer * >( p.mapLayers().first() );
+  QVERIFY( layer );
+
+  // the layer is valid and uses the stored metadata, without provider
+  QVERIFY( layer->isValid() );
+  QVERIFY( layer->isProviderCreationDeferred() );
+  QCOMPARE( layer->wkbType(), QgsWkbTypes::Point );
+  QVERIFY( !layer->extent().isEmpty() );
+  QVERIFY( layer->fields().isEmpty() );
+
+  // the provider is created when the layer is queried
+  QCOMPARE( layer->featureCount(), 17LL );
+  QVERIFY( !layer->isProviderCreationDeferred() );
+  QVERIFY( layer->dataProvider() );
+  QVERIFY( !layer->fields().isEmpty() );
+}
+
+void TestQgsProject::testPreloadProviders()
+{
+  const QTemporaryDir dir;
+  QVERIFY( dir.isValid() );
+
+  // a project with several layers of a provider created in parallel, and projects with one of these layers, which are loaded sequentially
+  const QStringList sources
+  {
+    QStringLiteral( "type=xyz&url=file://%1/{z}/{x}/{y}.png&zmax=19&zmin=0" ).arg( dir.path() ),
+    QStringLiteral( "type=xyz&url=file://%1/{z}/{x}/{y}.png&zmax=12&zmin=2" ).arg( dir.path() ),
+    QStringLiteral( "contextualWMSLegend=0&crs=EPSG:4326&format=image/png&layers=missing&styles=&url=http://127.0.0.1:1/wms" ),
+  };
+  const QString preloadedProjectPath = dir.path() + QStringLiteral( "/preloaded.qgs" );
+  {
+    QgsProject p;
+    for ( int i = 0; i < sources.size(); ++i )
+    {
+      QgsProject single;
+      QgsRasterLayer *layer = new QgsRasterLayer( sources.at( i ), QStringLiteral( "layer %1" ).arg( i ), QStringLiteral( "wms" ) );
+      single.addMapLayer( layer->clone() );
+      QVERIFY( single.write( dir.path() + QStringLiteral( "/single%1.qgs" ).arg( i ) ) );
+      p.addMapLayer( layer );
+    }
+    QCOMPARE( p.mapLayers().count(), sources.size() );
+    QVERIFY( p.write( preloadedProjectPath ) );
+  }
+
+  for ( const Qgis::ProjectReadFlags flags : { Qgis::ProjectReadFlags(), Qgis::ProjectReadFlags( Qgis::ProjectReadFlag::TrustLayerMetadata | Qgis::ProjectReadFlag::ForceReadOnlyLayers ) } )
+  {
+    QgsProject preloaded;
+    preloaded.read( preloadedProjectPath, flags );
+    QCOMPARE( preloaded.mapLayers().count(), sources.size() );
+
+    for ( int i = 0; i < sources.size(); ++i )
+    {
+      QgsProject single;
+      single.read( dir.path() + QStringLiteral( "/single%1.qgs" ).arg( i ), flags );
+      QCOMPARE( single.mapLayers().count(), 1 );
+      const QgsMapLayer *expected = single.mapLayers().first();
+      QCOMPARE( preloaded.mapLayersByName( expected->name() ).count(), 1 );
+      const QgsMapLayer *layer = preloaded.mapLayersByName( expected->name() ).first();
+      QCOMPARE( layer->providerType(), expected->providerType() );
+      QCOMPARE( layer->source(), expected->source() );
+      QCOMPARE( layer->isValid(), expected->isValid() );
+      QCOMPARE( layer->flags(), expected->flags() );
+      QCOMPARE( layer->readOnly(), expected->readOnly() );
+      QCOMPARE( layer->crs(), expected->crs() );
+      QCOMPARE( !layer->dataProvider(), !expected->dataProvider() );
+      if ( layer->dataProvider() )
+      {
+        QCOMPARE( layer->dataProvider()->isValid(), expected->dataProvider()->isValid() );
+        QCOMPARE( layer->dataProvider()->thread(), preloaded.thread() );
+      }
+    }
+  }
+}
+
+void TestQgsProject::testDocumentCache()
+{
+  const QTemporaryDir dir;
+  QVERIFY( dir.isValid() );
+  const QString projectPath = dir.path() + QStringLiteral( "/cached.qgs" );
+  const QString cachePath = dir.path() + QStringLiteral( "/cache" );
+
+  {
+    QgsProject p;
+    QgsVectorLayer *layer = new QgsVectorLayer( QString( TEST_DATA_DIR ) + QStringLiteral( "/points.shp" ), QStringLiteral( "points" ) );
+    QVERIFY( layer->isValid() );
+    p.addMapLayer( layer );
+    p.setTitle( QStringLiteral( "cached <project> & title" ) );
+    QVERIFY( p.write( projectPath ) );
+  }
+
+  // the first read stores the document in the cache
+  QgsProject p;
+  p.setDocumentCacheDirectory( cachePath );
+  QCOMPARE( p.documentCacheDirectory(), cachePath );
+  QVERIFY( p.read( projectPath ) );
+  QCOMPARE( QDir( cachePath ).entryList( QDir::Files ).count(), 1 );
+
+  // the second one reads it from the cache
+  QgsProject p2;
+  p2.setDocumentCacheDirectory( cachePath );
+  QVERIFY( p2.read( projectPath ) );
+  QCOMPARE( p2.title(), QStringLiteral( "cached <project> & title" ) );
+  QCOMPARE( p2.mapLayers().count(), 1 );
+  QVERIFY( p2.mapLayers().first()->isValid() );
+  QCOMPARE( p2.mapLayers().first()->name(), QStringLiteral( "points" ) );
+
+  // a modified project gets a new entry
+  p2.setTitle( QStringLiteral( "new title" ) );
+  QVERIFY( p2.write( projectPath ) );
+  QgsProject p3;
+  p3.setDocumentCacheDirectory( cachePath );
+  QVERIFY( p3.read( projectPath ) );
+  QCOMPARE( p3.title(), QStringLiteral( "new title" ) );
+  QCOMPARE( QDir( cachePath ).entryList( QDir::Files ).count(), 2 );
+}
+
 void TestQgsProject::testEmbeddedLayerGroupFromQgz()
 {
   QString path = QString( TEST_DATA_DIR ) + QStringLiteral( "/embedded_groups/project1.qgz" );
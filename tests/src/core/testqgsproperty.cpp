@@ -23,6 +23,8 @@
 #include "qgscolorrampimpl.h"
 #include "qgssymbollayerutils.h"
 #include "qgspropertytransformer.h"
+#include "qgspropertyevaluationcache.h"
+#include "qgsvariantutils.h"
 #include <QObject>
 
 enum PropertyKeys
@@ -97,6 +99,7 @@ class TestQgsProperty : public QObject
     void isProjectColor();
     void referencedFieldsIgnoreContext();
     void mapToMap();
+    void evaluationCache();
 
   private:
 
@@ -2007,5 +2010,69 @@ void TestQgsProperty::mapToMap()
   QCOMPARE( QgsProperty::variantMapToPropertyMap( variantMap ), propertyMap );
 }
 
+void TestQgsProperty::evaluationCache()
+{
+  QgsFields fields;
+  fields.append( QgsField( QStringLiteral( "field1" ), QVariant::Int ) );
+  fields.append( QgsField( QStringLiteral( "field2" ), QVariant::Int ) );
+  QgsFeature ft( fields, 1 );
+  ft.setAttributes( QgsAttributes() << QVariant( 5 ) << QVariant( 7 ) );
+
+  QgsExpressionContext context;
+  context.setFields( fields );
+  QgsExpressionContextScope *scope = new QgsExpressionContextScope();
+  scope->setVariable( QStringLiteral( "var1" ), 3 );
+  context.appendScope( scope );
+
+  const QgsProperty p1 = QgsProperty::fromExpression( QStringLiteral( "\"field1\" * 2 + \"field2\"" ) );
+  QgsProperty p2 = QgsProperty::fromExpression( QStringLiteral( "\"field1\" * 2 + \"field2\"" ) );
+  p2.setTransformer( new QgsGenericNumericTransformer( 0, 100, 0, 10 ) );
+  const QgsProperty p3 = QgsProperty::fromField( QStringLiteral( "field2" ) );
+  const QgsProperty p4 = QgsProperty::fromExpression( QStringLiteral( "\"field1\" + @var1" ) );
+  const QgsProperty p5 = QgsProperty::fromExpression( QStringLiteral( "$id" ) );
+
+  const std::shared_ptr< QgsPropertyEvaluationCache > cache = std::make_shared< QgsPropertyEvaluationCache >();
+  QVERIFY( p1.prepare( context, cache ) );
+  QVERIFY( p2.prepare( context, cache ) );
+  QVERIFY( p3.prepare( context, cache ) );
+  QVERIFY( p4.prepare( context, cache ) );
+  QVERIFY( p5.prepare( context, cache ) );
+  // identical expressions share a slot, variables and feature functions are not cached
+  QCOMPARE( cache->slotCount(), 2 );
+  QCOMPARE( cache->slot( p1, context ), cache->slot( p2, context ) );
+  QCOMPARE( cache->slot( p4, context ), -1 );
+  QCOMPARE( cache->slot( p5, context ), -1 );
+  QCOMPARE( cache->slot( QgsProperty::fromValue( 5 ), context ), -1 );
+
+  context.setFeature( ft );
+  QCOMPARE( p1.value( context, -1 ).toInt(), 17 );
+  QCOMPARE( p2.value( context, -1 ).toDouble(), 1.7 );
+  QCOMPARE( p3.value( context, -1 ).toInt(), 7 );
+  QCOMPARE( p4.value( context, -1 ).toInt(), 8 );
+  QCOMPARE( p5.value( context, -1 ).toInt(), 1 );
+
+  // changed attributes
+  ft.setAttribute( 0, 10 );
+  context.setFeature( ft );
+  QCOMPARE( p1.value( context, -1 ).toInt(), 27 );
+  QCOMPARE( p2.value( context, -1 ).toDouble(), 2.7 );
+  QCOMPARE( p4.value( context, -1 ).toInt(), 13 );
+
+  // another feature
+  QgsFeature ft2( fields, 2 );
+  ft2.setAttributes( QgsAttributes() << QVariant( 1 ) << QVariant() );
+  context.setFeature( ft2 );
+  QCOMPARE( p1.value( context, -1 ), QVariant( -1 ) );
+  QVERIFY( QgsVariantUtils::isNull( p3.value( context, -1 ) ) );
+  QCOMPARE( p5.value( context, -1 ).toInt(), 2 );
+
+  // preparing again without the cache stops using it
+  QVERIFY( p1.prepare( context ) );
+  ft2.setAttribute( 1, 4 );
+  context.setFeature( ft2 );
+  QCOMPARE( p1.value( context, -1 ).toInt(), 6 );
+  QCOMPARE( p2.value( context, -1 ).toDouble(), 0.6 );
+}
+
 QGSTEST_MAIN( TestQgsProperty )
 #include "testqgsproperty.moc"
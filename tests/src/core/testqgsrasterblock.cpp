@@ -39,6 +39,7 @@ class TestQgsRasterBlock : public QObject
 
     void testBasic();
     void testWrite();
+    void testVisitValues();
 
   private:
 
@@ -242,6 +243,52 @@ void TestQgsRasterBlock::testWrite()
   delete block;
 }
 
+void TestQgsRasterBlock::testVisitValues()
+{
+  QgsRasterBlock block( Qgis::DataType::Int16, 3, 2 );
+  for ( qgssize i = 0; i < 6; ++i )
+    block.setValue( i, static_cast< double >( i ) - 2 );
+  block.setNoDataValue( 1 );
+
+  QList< double > values;
+  QList< bool > noData;
+  QVERIFY( block.visitValues( [&]( const auto & view )
+  {
+    QCOMPARE( view.count(), static_cast< qgssize >( 6 ) );
+    bool isNoData = false;
+    for ( qgssize i = 0; i < view.count(); ++i )
+    {
+      values << view.valueAndNoData( i, isNoData );
+      noData << isNoData;
+    }
+  } ) );
+  QCOMPARE( values, QList< double >() << -2 << -1 << 0 << 1 << 2 << 3 );
+  QCOMPARE( noData, QList< bool >() << false << false << false << true << false << false );
+
+  // no data bitmap
+  QgsRasterBlock floatBlock( Qgis::DataType::Float32, 2, 1 );
+  floatBlock.setValue( 0, 0.5 );
+  floatBlock.setValue( 1, 1.5 );
+  QVERIFY( floatBlock.setIsNoData( 1 ) );
+  values.clear();
+  noData.clear();
+  QVERIFY( floatBlock.visitValues( [&]( const auto & view )
+  {
+    bool isNoData = false;
+    for ( qgssize i = 0; i < view.count(); ++i )
+    {
+      values << view.valueAndNoData( i, isNoData );
+      noData << isNoData;
+    }
+  } ) );
+  QCOMPARE( values.at( 0 ), 0.5 );
+  QCOMPARE( noData, QList< bool >() << false << true );
+
+  // color blocks have no values
+  QgsRasterBlock colorBlock( Qgis::DataType::ARGB32, 2, 2 );
+  QVERIFY( !colorBlock.visitValues( []( const auto & ) {} ) );
+}
+
 QGSTEST_MAIN( TestQgsRasterBlock )
 
 #include "testqgsrasterblock.moc"
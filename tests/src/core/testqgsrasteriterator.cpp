@@ -15,12 +15,14 @@
 
 #include "qgstest.h"
 #include <QObject>
+#include <QMutex>
 #include <QString>
 #include <QTemporaryFile>
 
 #include "qgsrasterlayer.h"
 #include "qgsrasterdataprovider.h"
 #include "qgsrasteriterator.h"
+#include "qgsrasterpipe.h"
 
 /**
  * \ingroup UnitTests
@@ -41,6 +43,10 @@ class TestQgsRasterIterator : public QObject
     void testBasic();
     void testNoBlock();
     void testSubRegion();
+    void testPrefetch();
+    void testPrefetchInputs();
+    void testAlignToInputBlocks();
+    void testProcessRasterParts();
 
   private:
 
@@ -424,6 +430,185 @@ void TestQgsRasterIterator::testSubRegion()
 
 }
 
+void TestQgsRasterIterator::testPrefetch()
+{
+  QgsRasterDataProvider *provider = mpRasterLayer->dataProvider();
+  QgsRasterIterator it( provider );
+  it.setMaximumTileHeight( 2500 );
+  it.setMaximumTileWidth( 3000 );
+  it.startRasterRead( 1, mpRasterLayer->width(), mpRasterLayer->height(), mpRasterLayer->extent() );
+
+  QgsRasterIterator prefetchIt( provider );
+  QCOMPARE( prefetchIt.prefetchCount(), 0 );
+  prefetchIt.setPrefetchCount( 2 );
+  QCOMPARE( prefetchIt.prefetchCount(), 2 );
+  prefetchIt.setMaximumTileHeight( 2500 );
+  prefetchIt.setMaximumTileWidth( 3000 );
+  prefetchIt.startRasterRead( 1, mpRasterLayer->width(), mpRasterLayer->height(), mpRasterLayer->extent() );
+
+  int nCols;
+  int nRows;
+  int topLeftCol;
+  int topLeftRow;
+  QgsRectangle blockExtent;
+  std::unique_ptr< QgsRasterBlock > block;
+  int prefetchNCols;
+  int prefetchNRows;
+  int prefetchTopLeftCol;
+  int prefetchTopLeftRow;
+  QgsRectangle prefetchBlockExtent;
+  std::unique_ptr< QgsRasterBlock > prefetchBlock;
+
+  // prefetched parts are identical to the parts read on demand, including when some parts are skipped
+  int part = 0;
+  while ( it.readNextRasterPart( 1, nCols, nRows, block, topLeftCol, topLeftRow, &blockExtent ) )
+  {
+    if ( part == 4 )
+    {
+      QVERIFY( prefetchIt.next( 1, prefetchNCols, prefetchNRows, prefetchTopLeftCol, prefetchTopLeftRow, prefetchBlockExtent ) );
+    }
+    else
+    {
+      QVERIFY( prefetchIt.readNextRasterPart( 1, prefetchNCols, prefetchNRows, prefetchBlock, prefetchTopLeftCol, prefetchTopLeftRow, &prefetchBlockExtent ) );
+      QVERIFY( prefetchBlock.get() );
+      QCOMPARE( prefetchBlock->width(), block->width() );
+      QCOMPARE( prefetchBlock->height(), block->height() );
+      QCOMPARE( prefetchBlock->data(), block->data() );
+    }
+    QCOMPARE( prefetchNCols, nCols );
+    QCOMPARE( prefetchNRows, nRows );
+    QCOMPARE( prefetchTopLeftCol, topLeftCol );
+    QCOMPARE( prefetchTopLeftRow, topLeftRow );
+    QCOMPARE( prefetchBlockExtent, blockExtent );
+    part++;
+  }
+  QCOMPARE( part, 9 );
+  QVERIFY( !prefetchIt.readNextRasterPart( 1, prefetchNCols, prefetchNRows, prefetchBlock, prefetchTopLeftCol, prefetchTopLeftRow, &prefetchBlockExtent ) );
+
+  // restarting the iteration discards the prefetched parts
+  prefetchIt.startRasterRead( 1, mpRasterLayer->width(), mpRasterLayer->height(), mpRasterLayer->extent() );
+  QVERIFY( prefetchIt.readNextRasterPart( 1, prefetchNCols, prefetchNRows, prefetchBlock, prefetchTopLeftCol, prefetchTopLeftRow, &prefetchBlockExtent ) );
+  QVERIFY( prefetchIt.readNextRasterPart( 1, prefetchNCols, prefetchNRows, prefetchBlock, prefetchTopLeftCol, prefetchTopLeftRow, &prefetchBlockExtent ) );
+  prefetchIt.startRasterRead( 1, mpRasterLayer->width(), mpRasterLayer->height(), mpRasterLayer->extent() );
+  QVERIFY( prefetchIt.readNextRasterPart( 1, prefetchNCols, prefetchNRows, prefetchBlock, prefetchTopLeftCol, prefetchTopLeftRow, &prefetchBlockExtent ) );
+  QCOMPARE( prefetchTopLeftCol, 0 );
+  QCOMPARE( prefetchTopLeftRow, 0 );
+}
+
+void TestQgsRasterIterator::testPrefetchInputs()
+{
+  QgsRasterPipe pipe( *mpRasterLayer->pipe() );
+  QgsRasterIterator it( pipe.last() );
+  it.setMaximumTileHeight( 200 );
+  it.setMaximumTileWidth( 3000 );
+  it.startRasterRead( 1, mpRasterLayer->width() / 4, mpRasterLayer->height() / 4, mpRasterLayer->extent() );
+
+  // parts are read concurrently through copies of the pipe
+  std::vector< std::unique_ptr< QgsRasterPipe > > pipes;
+  QList< QgsRasterInterface * > inputs;
+  for ( int i = 0; i < 3; ++i )
+  {
+    pipes.emplace_back( std::make_unique< QgsRasterPipe >( pipe ) );
+    pipes.back()->moveToThread( nullptr );
+    inputs << pipes.back()->last();
+  }
+  QgsRasterIterator prefetchIt( pipe.last() );
+  prefetchIt.setPrefetchInputs( inputs );
+  prefetchIt.setPrefetchCount( inputs.size() );
+  prefetchIt.setMaximumTileHeight( 200 );
+  prefetchIt.setMaximumTileWidth( 3000 );
+  prefetchIt.startRasterRead( 1, mpRasterLayer->width() / 4, mpRasterLayer->height() / 4, mpRasterLayer->extent() );
+
+  int nCols;
+  int nRows;
+  int topLeftCol;
+  int topLeftRow;
+  std::unique_ptr< QgsRasterBlock > block;
+  int prefetchNCols;
+  int prefetchNRows;
+  int prefetchTopLeftCol;
+  int prefetchTopLeftRow;
+  std::unique_ptr< QgsRasterBlock > prefetchBlock;
+
+  int part = 0;
+  while ( it.readNextRasterPart( 1, nCols, nRows, block, topLeftCol, topLeftRow ) )
+  {
+    QVERIFY( prefetchIt.readNextRasterPart( 1, prefetchNCols, prefetchNRows, prefetchBlock, prefetchTopLeftCol, prefetchTopLeftRow ) );
+    QVERIFY( prefetchBlock.get() );
+    QCOMPARE( prefetchTopLeftCol, topLeftCol );
+    QCOMPARE( prefetchTopLeftRow, topLeftRow );
+    QCOMPARE( prefetchBlock->dataType(), block->dataType() );
+    QCOMPARE( prefetchBlock->data(), block->data() );
+    part++;
+  }
+  QVERIFY( part > 3 );
+  QVERIFY( !prefetchIt.readNextRasterPart( 1, prefetchNCols, prefetchNRows, prefetchBlock, prefetchTopLeftCol, prefetchTopLeftRow ) );
+}
+
+void TestQgsRasterIterator::testAlignToInputBlocks()
+{
+  QgsRasterDataProvider *provider = mpRasterLayer->dataProvider();
+  const int xBlockSize = provider->xBlockSize();
+  const int yBlockSize = provider->yBlockSize();
+  QVERIFY( xBlockSize > 0 );
+  QVERIFY( yBlockSize > 0 );
+
+  QgsRasterIterator it( provider );
+  QVERIFY( !it.alignToInputBlocks() );
+  it.setAlignToInputBlocks( true );
+  QVERIFY( it.alignToInputBlocks() );
+  it.setMaximumTileHeight( 2500 );
+  it.setMaximumTileWidth( 3000 );
+  it.startRasterRead( 1, mpRasterLayer->width(), mpRasterLayer->height(), mpRasterLayer->extent() );
+
+  int nCols;
+  int nRows;
+  int topLeftCol;
+  int topLeftRow;
+  QgsRectangle blockExtent;
+  qgssize cells = 0;
+  while ( it.next( 1, nCols, nRows, topLeftCol, topLeftRow, blockExtent ) )
+  {
+    QVERIFY( nCols <= 3000 );
+    QVERIFY( nRows <= 2500 );
+    if ( xBlockSize < 3000 )
+      QCOMPARE( topLeftCol % xBlockSize, 0 );
+    if ( yBlockSize < 2500 )
+      QCOMPARE( topLeftRow % yBlockSize, 0 );
+    cells += static_cast< qgssize >( nCols ) * nRows;
+  }
+  QCOMPARE( cells, static_cast< qgssize >( mpRasterLayer->width() ) * mpRasterLayer->height() );
+}
+
+void TestQgsRasterIterator::testProcessRasterParts()
+{
+  QgsRasterDataProvider *provider = mpRasterLayer->dataProvider();
+  QgsRasterIterator it( provider );
+  it.setPrefetchCount( 1 );
+  it.setMaximumTileHeight( 2500 );
+  it.setMaximumTileWidth( 3000 );
+  it.startRasterRead( 1, mpRasterLayer->width(), mpRasterLayer->height(), mpRasterLayer->extent() );
+
+  QMutex mutex;
+  int parts = 0;
+  qgssize cells = 0;
+  QVERIFY( it.processRasterParts( 1, [&]( const QgsRasterBlock * block, int, int, const QgsRectangle & )
+  {
+    QMutexLocker locker( &mutex );
+    parts++;
+    cells += static_cast< qgssize >( block->width() ) * block->height();
+    return true;
+  }, 4 ) );
+  QCOMPARE( parts, 9 );
+  QCOMPARE( cells, static_cast< qgssize >( mpRasterLayer->width() ) * mpRasterLayer->height() );
+
+  // the function can stop the iteration
+  it.startRasterRead( 1, mpRasterLayer->width(), mpRasterLayer->height(), mpRasterLayer->extent() );
+  QVERIFY( !it.processRasterParts( 1, []( const QgsRasterBlock *, int topLeftCol, int topLeftRow, const QgsRectangle & )
+  {
+    return !( topLeftCol == 0 && topLeftRow == 0 );
+  } ) );
+}
 
 QGSTEST_MAIN( TestQgsRasterIterator )
 
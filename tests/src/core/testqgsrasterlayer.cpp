@@ -96,11 +96,13 @@ class TestQgsRasterLayer : public QgsTest
     void singleBandGrayRendererNoDataColor();
     void singleBandPseudoRendererNoData();
     void singleBandPseudoRendererNoDataColor();
+    void singleBandPseudoRendererIntegerBlocks();
     void setRenderer();
     void setLayerOpacity();
     void regression992(); //test for issue #992 - GeoJP2 images improperly displayed as all black
     void testRefreshRendererIfNeeded();
     void sample();
+    void samplePoints();
     void testTemporalProperties();
     void rotatedRaster();
     void forceRasterRender();
@@ -942,6 +944,58 @@ void TestQgsRasterLayer::singleBandPseudoRendererNoDataColor()
   QVERIFY( render( QStringLiteral( "raster_singlebandpseudo_nodata_color" ) ) );
 }
 
+void TestQgsRasterLayer::singleBandPseudoRendererIntegerBlocks()
+{
+  // integer blocks are colored through a lookup table, which must give the colors of the shader
+  QgsRasterShader *rasterShader = new QgsRasterShader();
+  QgsColorRampShader *colorRampShader = new QgsColorRampShader();
+  colorRampShader->setColorRampType( QgsColorRampShader::Interpolated );
+  QList<QgsColorRampShader::ColorRampItem> colorRampItems;
+  colorRampItems << QgsColorRampShader::ColorRampItem( 50, QColor( 0, 0, 255 ) )
+                 << QgsColorRampShader::ColorRampItem( 120, QColor( 0, 255, 255, 100 ) )
+                 << QgsColorRampShader::ColorRampItem( 200, QColor( 255, 0, 0 ) );
+  colorRampShader->setColorRampItemList( colorRampItems );
+  colorRampShader->setClip( true );
+  rasterShader->setRasterShaderFunction( colorRampShader );
+
+  QgsSingleBandPseudoColorRenderer renderer( mpLandsatRasterLayer->dataProvider(), 1, rasterShader );
+  renderer.setOpacity( 0.8 );
+  renderer.setNodataColor( QColor( 255, 0, 255 ) );
+  QgsRasterTransparency *transparency = new QgsRasterTransparency();
+  QgsRasterTransparency::TransparentSingleValuePixel pixel;
+  pixel.min = 100;
+  pixel.max = 110;
+  pixel.percentTransparent = 50;
+  transparency->setTransparentSingleValuePixelList( QList< QgsRasterTransparency::TransparentSingleValuePixel >() << pixel );
+  renderer.setRasterTransparency( transparency );
+
+  const QgsRectangle extent = mpLandsatRasterLayer->extent();
+  const int width = mpLandsatRasterLayer->width();
+  const int height = mpLandsatRasterLayer->height();
+  std::unique_ptr< QgsRasterBlock > input( mpLandsatRasterLayer->dataProvider()->block( 1, extent, width, height ) );
+  QCOMPARE( input->dataType(), Qgis::DataType::Byte );
+  std::unique_ptr< QgsRasterBlock > output( renderer.block( 1, extent, width, height ) );
+  QCOMPARE( output->dataType(), Qgis::DataType::ARGB32_Premultiplied );
+
+  for ( int row = 0; row < height; ++row )
+  {
+    for ( int column = 0; column < width; ++column )
+    {
+      const double value = input->value( row, column );
+      int red, green, blue, alpha;
+      QRgb expected = qRgba( 255, 0, 255, 255 );
+      if ( colorRampShader->shade( value, &red, &green, &blue, &alpha ) )
+      {
+        const double opacity = transparency->alphaValue( value, 0.8 * 255 ) / 255.0;
+        const double premultiply = alpha < 255 ? alpha / 255.0 : 1.0;
+        expected = qRgba( opacity * static_cast< int >( red * premultiply ), opacity * static_cast< int >( green * premultiply ),
+                          opacity * static_cast< int >( blue * premultiply ), opacity * alpha );
+      }
+      QCOMPARE( output->color( row, column ), expected );
+    }
+  }
+}
+
 void TestQgsRasterLayer::setRenderer()
 {
   const QSignalSpy spy( mpRasterLayer, &QgsRasterLayer::rendererChanged );
@@ -1063,6 +1117,56 @@ void TestQgsRasterLayer::sample()
   QVERIFY( !ok );
 }
 
+void TestQgsRasterLayer::samplePoints()
+{
+  const QString fileName = mTestDataDir + "landsat-f32-b1.tif";
+
+  const QFileInfo rasterFileInfo( fileName );
+  std::unique_ptr< QgsRasterLayer > rl = std::make_unique< QgsRasterLayer> ( rasterFileInfo.filePath(),
+                                         rasterFileInfo.completeBaseName() );
+  QVERIFY( rl->isValid() );
+
+  // points spread over the whole raster, plus points outside of it
+  const QgsRectangle extent = rl->extent();
+  QVector< QgsPointXY > points;
+  for ( int i = 0; i < 500; ++i )
+  {
+    points << QgsPointXY( extent.xMinimum() + extent.width() * ( ( i * 37 ) % 500 + 0.3 ) / 500.0,
+                          extent.yMinimum() + extent.height() * ( ( i * 91 ) % 500 + 0.3 ) / 500.0 );
+  }
+  points << QgsPointXY( 0, 0 ) << QgsPointXY( 788461, 3344957 );
+
+  const QVector< double > values = rl->dataProvider()->samplePoints( points, 1 );
+  QCOMPARE( values.size(), points.size() );
+  for ( int i = 0; i < points.size(); ++i )
+  {
+    bool ok = false;
+    const double expected = rl->dataProvider()->sample( points.at( i ), 1, &ok );
+    if ( ok )
+      QCOMPARE( values.at( i ), expected );
+    else
+      QVERIFY( std::isnan( values.at( i ) ) );
+  }
+  QVERIFY( std::isnan( values.at( 500 ) ) );
+  QCOMPARE( values.at( 501 ), 125.0 );
+
+  // bad bands
+  QVERIFY( std::isnan( rl->dataProvider()->samplePoints( points, 0 ).at( 501 ) ) );
+  QVERIFY( std::isnan( rl->dataProvider()->samplePoints( points, 10 ).at( 501 ) ) );
+
+  // bilinear interpolation: the value at a pixel center is the pixel value, and between
+  // two pixel centers the average of the pixels
+  const double pixelSizeX = rl->rasterUnitsPerPixelX();
+  const double pixelSizeY = rl->rasterUnitsPerPixelY();
+  const QgsPointXY center( extent.xMinimum() + 10.5 * pixelSizeX, extent.yMaximum() - 20.5 * pixelSizeY );
+  const QgsPointXY nextCenter( center.x() + pixelSizeX, center.y() );
+  const QgsPointXY between( center.x() + 0.5 * pixelSizeX, center.y() );
+  const QVector< double > interpolated = rl->dataProvider()->samplePoints( QVector< QgsPointXY >() << center << nextCenter << between, 1, true );
+  QCOMPARE( interpolated.at( 0 ), rl->dataProvider()->sample( center, 1 ) );
+  QCOMPARE( interpolated.at( 1 ), rl->dataProvider()->sample( nextCenter, 1 ) );
+  QGSCOMPARENEAR( interpolated.at( 2 ), ( interpolated.at( 0 ) + interpolated.at( 1 ) ) / 2, 1e-6 );
+}
+
 void TestQgsRasterLayer::testTemporalProperties()
 {
   QgsRasterLayerTemporalProperties *temporalProperties = qobject_cast< QgsRasterLayerTemporalProperties * >( mTemporalRasterLayer->temporalProperties() );
@@ -15,6 +15,8 @@
 #include "qgstest.h"
 #include <QDomDocument>
 #include <QFile>
+#include <QImage>
+#include <QPainter>
 #include <QTemporaryFile>
 //header for class being tested
 #include <qgsrulebasedrenderer.h>
@@ -33,6 +35,9 @@
 #include "qgsmarkersymbollayer.h"
 #include "qgsgeometry.h"
 #include "qgsembeddedsymbolrenderer.h"
+#include "qgsexpressioncontextutils.h"
+#include "qgsmaprenderersequentialjob.h"
+#include "qgsmapsettings.h"
 
 typedef QgsRuleBasedRenderer::Rule RRule;
 
@@ -1094,6 +1099,108 @@ class TestQgsRuleBasedRenderer: public QgsTest
       QCOMPARE( counter->featureCount( "2" ), 1LL );
     }
 
+    void testParallelRendering()
+    {
+      // more features than a batch of the parallel rendering
+      std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "Point?crs=epsg:4326&field=number:int" ), QStringLiteral( "test" ), QStringLiteral( "memory" ) );
+      QVERIFY( layer->isValid() );
+      QgsFeatureList features;
+      for ( int i = 0; i < 25000; ++i )
+      {
+        QgsFeature f( layer->fields() );
+        f.setAttribute( 0, i );
+        f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i % 150, i / 150 ) ) );
+        features << f;
+      }
+      QVERIFY( layer->dataProvider()->addFeatures( features ) );
+
+      // the rules queue the features and draw them in stopRender()
+      QgsMarkerSymbol *evenSymbol = QgsMarkerSymbol::createSimple( { { QStringLiteral( "color" ), QStringLiteral( "#ff0000" ) }, { QStringLiteral( "size" ), QStringLiteral( "2" ) } } );
+      QgsMarkerSymbol *oddSymbol = QgsMarkerSymbol::createSimple( { { QStringLiteral( "color" ), QStringLiteral( "#0000ff" ) }, { QStringLiteral( "size" ), QStringLiteral( "3" ) } } );
+      RRule *rootRule = new RRule( nullptr );
+      rootRule->appendChild( new RRule( evenSymbol, 0, 0, QStringLiteral( "\"number\" % 2 = 0" ) ) );
+      rootRule->appendChild( new RRule( oddSymbol, 0, 0, QStringLiteral( "ELSE" ) ) );
+      layer->setRenderer( new QgsRuleBasedRenderer( rootRule ) );
+
+      QgsMapSettings mapSettings;
+      mapSettings.setLayers( QList< QgsMapLayer * >() << layer.get() );
+      mapSettings.setDestinationCrs( layer->crs() );
+      mapSettings.setOutputSize( QSize( 400, 300 ) );
+      mapSettings.setExtent( QgsRectangle( -1, -1, 151, 168 ) );
+      mapSettings.setFlag( Qgis::MapSettingsFlag::Antialiasing, false );
+
+      auto render = [&mapSettings]
+      {
+        QgsMapRendererSequentialJob job( mapSettings );
+        job.start();
+        job.waitForFinished();
+        return job.renderedImage();
+      };
+
+      const QImage sequentialImage = render();
+      mapSettings.setFlag( Qgis::MapSettingsFlag::ParallelFeatureRendering, true );
+      const QImage parallelImage = render();
+      QVERIFY( !sequentialImage.isNull() );
+      QCOMPARE( parallelImage, sequentialImage );
+      QVERIFY( sequentialImage.pixelColor( 200, 150 ) != QColor( 255, 255, 255 ) );
+    }
+
+    void testEqualityFilterLookup()
+    {
+      std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "Point?crs=epsg:4326&field=name:string&field=number:integer" ), QStringLiteral( "test" ), QStringLiteral( "memory" ) );
+      QVERIFY( layer->isValid() );
+
+      QgsRuleBasedRenderer::Rule *rootRule = new QgsRuleBasedRenderer::Rule( nullptr );
+      rootRule->appendChild( new QgsRuleBasedRenderer::Rule( new QgsMarkerSymbol(), 0, 0, QStringLiteral( "\"name\" = 'a'" ) ) );
+      rootRule->appendChild( new QgsRuleBasedRenderer::Rule( new QgsMarkerSymbol(), 0, 0, QStringLiteral( "'b' = \"name\"" ) ) );
+      rootRule->appendChild( new QgsRuleBasedRenderer::Rule( new QgsMarkerSymbol(), 0, 0, QStringLiteral( "\"name\" = 'a'" ) ) );
+      QgsRuleBasedRenderer renderer( rootRule );
+
+      QImage image( 10, 10, QImage::Format_ARGB32 );
+      QPainter painter( &image );
+      QgsRenderContext context = QgsRenderContext::fromQPainter( &painter );
+      context.expressionContext().appendScope( QgsExpressionContextUtils::layerScope( layer.get() ) );
+
+      auto renderFeature = [&]( const QVariant & name, const QVariant & number )
+      {
+        QgsFeature f( layer->fields() );
+        f.setAttributes( QgsAttributes() << name << number );
+        f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 1, 1 ) ) );
+        context.expressionContext().setFeature( f );
+        return renderer.renderFeature( f, context );
+      };
+
+      // the children are looked up by the value of the name field
+      renderer.startRender( context, layer->fields() );
+      QVERIFY( renderFeature( QStringLiteral( "a" ), 1 ) );
+      QVERIFY( renderFeature( QStringLiteral( "b" ), 1 ) );
+      QVERIFY( !renderFeature( QStringLiteral( "c" ), 1 ) );
+      QVERIFY( !renderFeature( QStringLiteral( "A" ), 1 ) );
+      QVERIFY( !renderFeature( QVariant( QVariant::String ), 1 ) );
+      renderer.stopRender( context );
+
+      // inactive rules still prevent else rules from matching
+      rootRule->children().at( 1 )->setActive( false );
+      rootRule->appendChild( new QgsRuleBasedRenderer::Rule( new QgsMarkerSymbol(), 0, 0, QStringLiteral( "ELSE" ) ) );
+      renderer.startRender( context, layer->fields() );
+      QVERIFY( renderFeature( QStringLiteral( "a" ), 1 ) );
+      QVERIFY( !renderFeature( QStringLiteral( "b" ), 1 ) );
+      QVERIFY( renderFeature( QStringLiteral( "c" ), 1 ) );
+      QVERIFY( renderFeature( QVariant( QVariant::String ), 1 ) );
+      renderer.stopRender( context );
+
+      // filters on another field are evaluated for each feature
+      rootRule->children().at( 1 )->setActive( true );
+      rootRule->appendChild( new QgsRuleBasedRenderer::Rule( new QgsMarkerSymbol(), 0, 0, QStringLiteral( "\"number\" = '5'" ) ) );
+      rootRule->removeChildAt( 3 );
+      renderer.startRender( context, layer->fields() );
+      QVERIFY( renderFeature( QStringLiteral( "a" ), 1 ) );
+      QVERIFY( renderFeature( QStringLiteral( "c" ), 5 ) );
+      QVERIFY( !renderFeature( QStringLiteral( "c" ), 1 ) );
+      renderer.stopRender( context );
+      painter.end();
+    }
+
     void testLegendKeyToExpression()
     {
       QgsRuleBasedRenderer::Rule *rootRule = new QgsRuleBasedRenderer::Rule( nullptr );
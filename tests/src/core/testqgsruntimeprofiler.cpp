@@ -26,6 +26,7 @@ class TestQgsRuntimeProfiler: public QObject
     void initTestCase();
     void cleanupTestCase();
     void testGroups();
+    void testRecord();
     void threading();
 
 };
@@ -90,6 +91,29 @@ void TestQgsRuntimeProfiler::testGroups()
 }
 
 
+void TestQgsRuntimeProfiler::testRecord()
+{
+  QgsRuntimeProfiler profiler;
+
+  const QSignalSpy spy( &profiler, &QgsRuntimeProfiler::groupAdded );
+
+  // top level event
+  profiler.record( QStringLiteral( "task 1" ), 2.5, QStringLiteral( "group 1" ) );
+  QCOMPARE( spy.count(), 1 );
+  QVERIFY( !profiler.groupIsActive( QStringLiteral( "group 1" ) ) );
+  QCOMPARE( profiler.profileTime( QStringLiteral( "task 1" ), QStringLiteral( "group 1" ) ), 2.5 );
+
+  // recorded as child of the active event
+  profiler.start( QStringLiteral( "task 2" ), QStringLiteral( "group 1" ) );
+  profiler.record( QStringLiteral( "task 2a" ), 1.5, QStringLiteral( "group 1" ) );
+  QVERIFY( profiler.groupIsActive( QStringLiteral( "group 1" ) ) );
+  profiler.end( QStringLiteral( "group 1" ) );
+
+  QCOMPARE( spy.count(), 1 );
+  QCOMPARE( profiler.childGroups( QString(), QStringLiteral( "group 1" ) ), QStringList() << QStringLiteral( "task 1" ) << QStringLiteral( "task 2" ) );
+  QCOMPARE( profiler.childGroups( QStringLiteral( "task 2" ), QStringLiteral( "group 1" ) ), QStringList() << QStringLiteral( "task 2a" ) );
+  QCOMPARE( profiler.profileTime( QStringLiteral( "task 2/task 2a" ), QStringLiteral( "group 1" ) ), 1.5 );
+}
 
 class ProfileInThread : public QThread
 {
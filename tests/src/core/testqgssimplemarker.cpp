@@ -32,6 +32,8 @@
 #include "qgsmarkersymbollayer.h"
 #include "qgsproperty.h"
 #include "qgsmarkersymbol.h"
+#include "qgsrendercontext.h"
+#include "qgsexpressioncontext.h"
 
 
 /**
@@ -80,6 +82,7 @@ class TestQgsSimpleMarkerSymbol : public QgsTest
     void colors();
     void opacityWithDataDefinedColor();
     void dataDefinedOpacity();
+    void dataDefinedSprites();
 
   private:
     bool mTestHasError =  false ;
@@ -547,6 +550,61 @@ void TestQgsSimpleMarkerSymbol::dataDefinedOpacity()
   QVERIFY( result );
 }
 
+void TestQgsSimpleMarkerSymbol::dataDefinedSprites()
+{
+  // markers with a data defined size, angle and color are drawn from rendered images of the markers,
+  // which must match the markers rendered as vectors
+  QgsSimpleMarkerSymbolLayer *layer = new QgsSimpleMarkerSymbolLayer( Qgis::MarkerShape::Arrow, 6 );
+  layer->setStrokeWidth( 0.4 );
+  layer->setDataDefinedProperty( QgsSymbolLayer::PropertyAngle, QgsProperty::fromExpression( QStringLiteral( "(\"id\" % 3) * 37" ) ) );
+  layer->setDataDefinedProperty( QgsSymbolLayer::PropertySize, QgsProperty::fromExpression( QStringLiteral( "4 + \"id\" % 3" ) ) );
+  layer->setDataDefinedProperty( QgsSymbolLayer::PropertyFillColor, QgsProperty::fromExpression( QStringLiteral( "color_rgb((\"id\" % 3) * 100, 50, 0)" ) ) );
+  QgsMarkerSymbol symbol( QgsSymbolLayerList() << layer );
+
+  QgsFields fields;
+  fields.append( QgsField( QStringLiteral( "id" ), QVariant::Int ) );
+
+  auto render = [&symbol, &fields]( bool forceVectorOutput ) -> QImage
+  {
+    QImage image( 300, 100, QImage::Format_ARGB32_Premultiplied );
+    image.fill( 0 );
+    QPainter painter( &image );
+    QgsRenderContext context = QgsRenderContext::fromQPainter( &painter );
+    context.setFlag( Qgis::RenderContextFlag::Antialiasing, true );
+    context.setFlag( Qgis::RenderContextFlag::ForceVectorOutput, forceVectorOutput );
+    context.expressionContext().appendScope( new QgsExpressionContextScope() );
+
+    symbol.startRender( context, fields );
+    for ( int i = 0; i < 9; ++i )
+    {
+      QgsFeature feature( fields );
+      feature.setAttributes( QgsAttributes() << i );
+      context.expressionContext().setFeature( feature );
+      symbol.renderPoint( QPointF( 20 + 30 * i, 50 ), &feature, context );
+    }
+    symbol.stopRender( context );
+    painter.end();
+    return image;
+  };
+
+  const QImage sprites = render( false );
+  const QImage vectors = render( true );
+
+  int mismatches = 0;
+  for ( int y = 0; y < sprites.height(); ++y )
+  {
+    for ( int x = 0; x < sprites.width(); ++x )
+    {
+      const QRgb sprite = sprites.pixel( x, y );
+      const QRgb vector = vectors.pixel( x, y );
+      if ( std::abs( qAlpha( sprite ) - qAlpha( vector ) ) > 64 || std::abs( qRed( sprite ) - qRed( vector ) ) > 64 )
+        mismatches++;
+    }
+  }
+  QVERIFY( qAlpha( sprites.pixel( 80, 50 ) ) > 0 );
+  QVERIFY( mismatches < 30 );
+}
+
 
 QGSTEST_MAIN( TestQgsSimpleMarkerSymbol )
 #include "testqgssimplemarker.moc"
@@ -0,0 +1,178 @@
+/***************************************************************************
+    testqgsspatialfilterevaluator.cpp
+     --------------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgsfeatureiterator.h"
+#include "qgsfeaturerequest.h"
+#include "qgsspatialfilterevaluator.h"
+#include "qgsvectorlayer.h"
+
+class TestQgsSpatialFilterEvaluator : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void fromRequest();
+    void testList();
+    void nextFeature();
+    void memoryLayer();
+
+  private:
+    QgsFeatureList pointFeatures( int count ) const;
+};
+
+void TestQgsSpatialFilterEvaluator::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsSpatialFilterEvaluator::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+QgsFeatureList TestQgsSpatialFilterEvaluator::pointFeatures( int count ) const
+{
+  QgsFeatureList features;
+  for ( int i = 0; i < count; ++i )
+  {
+    QgsFeature f( i );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+    features << f;
+  }
+  return features;
+}
+
+void TestQgsSpatialFilterEvaluator::fromRequest()
+{
+  const QgsRectangle rect( 0, 0, 10, 10 );
+
+  QVERIFY( !QgsSpatialFilterEvaluator::fromRequest( QgsFeatureRequest(), QgsRectangle() ) );
+  // bounding box filters are only tested by the evaluator for exact intersections
+  QVERIFY( !QgsSpatialFilterEvaluator::fromRequest( QgsFeatureRequest().setFilterRect( rect ), rect ) );
+
+  std::unique_ptr< QgsSpatialFilterEvaluator > evaluator = QgsSpatialFilterEvaluator::fromRequest( QgsFeatureRequest().setFilterRect( rect ).setFlags( QgsFeatureRequest::ExactIntersect ), rect );
+  QVERIFY( evaluator );
+  QCOMPARE( evaluator->predicate(), QgsSpatialFilterEvaluator::Predicate::Intersects );
+
+  evaluator = QgsSpatialFilterEvaluator::fromRequest( QgsFeatureRequest().setDistanceWithin( QgsGeometry::fromWkt( QStringLiteral( "Point (1 1)" ) ), 2 ), rect );
+  QVERIFY( evaluator );
+  QCOMPARE( evaluator->predicate(), QgsSpatialFilterEvaluator::Predicate::DistanceWithin );
+}
+
+void TestQgsSpatialFilterEvaluator::testList()
+{
+  const QgsSpatialFilterEvaluator intersects( QgsSpatialFilterEvaluator::Predicate::Intersects, QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 1000 0, 0 1000, 0 0))" ) ) );
+  QVERIFY( intersects.test( QgsGeometry::fromWkt( QStringLiteral( "Point (1 1)" ) ).constGet() ) );
+  QVERIFY( !intersects.test( QgsGeometry::fromWkt( QStringLiteral( "Point (600 600)" ) ).constGet() ) );
+  QVERIFY( !intersects.test( nullptr ) );
+
+  // large enough to be tested by several threads, the results keep the order of the features
+  const QgsFeatureList features = pointFeatures( 1000 );
+  QVector< bool > results = intersects.test( features );
+  QCOMPARE( results.size(), 1000 );
+  for ( int i = 0; i < 1000; ++i )
+    QCOMPARE( results.at( i ), i <= 500 );
+
+  const QgsSpatialFilterEvaluator distanceWithin( QgsSpatialFilterEvaluator::Predicate::DistanceWithin, QgsGeometry::fromWkt( QStringLiteral( "Point (100 100)" ) ), 15 );
+  results = distanceWithin.test( features );
+  for ( int i = 0; i < 1000; ++i )
+    QCOMPARE( results.at( i ), std::abs( i - 100 ) * M_SQRT2 <= 15 );
+
+  QVERIFY( intersects.test( QgsFeatureList() ).isEmpty() );
+}
+
+void TestQgsSpatialFilterEvaluator::nextFeature()
+{
+  QgsSpatialFilterEvaluator evaluator( QgsSpatialFilterEvaluator::Predicate::DistanceWithin, QgsGeometry::fromWkt( QStringLiteral( "LineString (0 0, 300 0)" ) ), 250 );
+  evaluator.setReadAheadSize( 100 );
+  QCOMPARE( evaluator.readAheadSize(), 100 );
+
+  const QgsFeatureList features = pointFeatures( 1000 );
+  int candidateIndex = 0;
+  const auto fetchCandidate = [&features, &candidateIndex]( QgsFeature & f )
+  {
+    if ( candidateIndex >= features.size() )
+      return false;
+    f = features.at( candidateIndex++ );
+    return true;
+  };
+
+  QList< QgsFeatureId > ids;
+  QgsFeature f;
+  while ( evaluator.nextFeature( f, fetchCandidate ) )
+    ids << f.id();
+
+  QList< QgsFeatureId > expected;
+  for ( int i = 0; i <= 250; ++i )
+    expected << i;
+  QCOMPARE( ids, expected );
+  QCOMPARE( candidateIndex, 1000 );
+
+  // the candidates read ahead are discarded on reset
+  candidateIndex = 0;
+  QVERIFY( evaluator.nextFeature( f, fetchCandidate ) );
+  QCOMPARE( f.id(), 0LL );
+  QCOMPARE( candidateIndex, 100 );
+  evaluator.reset();
+  candidateIndex = 200;
+  QVERIFY( evaluator.nextFeature( f, fetchCandidate ) );
+  QCOMPARE( f.id(), 200LL );
+}
+
+void TestQgsSpatialFilterEvaluator::memoryLayer()
+{
+  QgsVectorLayer layer( QStringLiteral( "Point?crs=EPSG:3857" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer.isValid() );
+  QVERIFY( layer.dataProvider()->addFeatures( QgsFeatureList() << pointFeatures( 1000 ) ) );
+
+  QgsFeatureRequest request;
+  request.setFilterRect( QgsRectangle( 10, 10, 900, 900 ) );
+  request.setFlags( QgsFeatureRequest::ExactIntersect );
+
+  QgsFeatureIterator it = layer.getFeatures( request );
+  QgsFeature f;
+  int count = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QVERIFY( f.isValid() );
+    QVERIFY( f.geometry().boundingBox().intersects( QgsRectangle( 10, 10, 900, 900 ) ) );
+    count++;
+  }
+  QCOMPARE( count, 891 );
+
+  // rewinding discards the features read ahead
+  QVERIFY( it.rewind() );
+  QVERIFY( it.nextFeature( f ) );
+  QCOMPARE( f.geometry().asWkt(), QStringLiteral( "Point (10 10)" ) );
+
+  request = QgsFeatureRequest().setDistanceWithin( QgsGeometry::fromWkt( QStringLiteral( "Point (500 500)" ) ), 15 );
+  it = layer.getFeatures( request );
+  count = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QVERIFY( f.geometry().asPoint().distance( QgsPointXY( 500, 500 ) ) <= 15 );
+    count++;
+  }
+  QCOMPARE( count, 21 );
+}
+
+QGSTEST_MAIN( TestQgsSpatialFilterEvaluator )
+#include "testqgsspatialfilterevaluator.moc"
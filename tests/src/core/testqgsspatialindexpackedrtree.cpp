@@ -0,0 +1,216 @@
+/***************************************************************************
+     testqgsspatialindexpackedrtree.cpp
+     ----------------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+#include <QString>
+#include <QTemporaryDir>
+
+#include <qgsapplication.h>
+#include "qgsfeatureiterator.h"
+#include "qgsgeometry.h"
+#include "qgsspatialindex.h"
+#include "qgsspatialindexpackedrtree.h"
+#include "qgsvectordataprovider.h"
+#include "qgsvectorlayer.h"
+
+static QgsFeature _rectFeature( QgsFeatureId id, const QgsRectangle &rect )
+{
+  QgsFeature f( id );
+  f.setGeometry( QgsGeometry::fromRect( rect ) );
+  return f;
+}
+
+static QList< QgsFeatureId > _sorted( QList< QgsFeatureId > ids )
+{
+  std::sort( ids.begin(), ids.end() );
+  return ids;
+}
+
+class TestQgsSpatialIndexPackedRTree : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+
+    void initTestCase()
+    {
+      QgsApplication::init();
+      QgsApplication::initQgis();
+    }
+    void cleanupTestCase()
+    {
+      QgsApplication::exitQgis();
+    }
+
+    void testEmpty()
+    {
+      const QgsSpatialIndexPackedRTree index;
+      QCOMPARE( index.size(), static_cast< qgssize >( 0 ) );
+      QVERIFY( index.intersects( QgsRectangle( -10, -10, 10, 10 ) ).isEmpty() );
+      QVERIFY( index.nearestNeighbor( QgsPointXY( 0, 0 ), 3 ).isEmpty() );
+    }
+
+    void testIntersects_data()
+    {
+      QTest::addColumn<int>( "nodeSize" );
+      QTest::addColumn<int>( "count" );
+
+      QTest::newRow( "single" ) << 16 << 1;
+      QTest::newRow( "one level" ) << 16 << 16;
+      QTest::newRow( "several levels" ) << 16 << 5000;
+      QTest::newRow( "small nodes" ) << 2 << 1000;
+    }
+
+    void testIntersects()
+    {
+      QFETCH( int, nodeSize );
+      QFETCH( int, count );
+
+      // overlapping rectangles on a grid, compared to a brute force search
+      QVector< QgsFeatureId > ids;
+      QVector< QgsRectangle > bounds;
+      for ( int i = 0; i < count; ++i )
+      {
+        const double x = ( i % 100 ) * 10;
+        const double y = ( i / 100 ) * 10;
+        ids << i * 2;
+        bounds << QgsRectangle( x, y, x + 15 + i % 7, y + 12 );
+      }
+
+      const QgsSpatialIndexPackedRTree index( ids, bounds, nodeSize );
+      QCOMPARE( index.size(), static_cast< qgssize >( count ) );
+      QCOMPARE( index.nodeSize(), nodeSize );
+
+      const QList< QgsRectangle > searches { QgsRectangle( 0, 0, 5, 5 ), QgsRectangle( 105, 33, 333, 182 ), QgsRectangle( -100, -100, 2000, 2000 ), QgsRectangle( 5000, 5000, 6000, 6000 ) };
+      for ( const QgsRectangle &search : searches )
+      {
+        QList< QgsFeatureId > expected;
+        for ( int i = 0; i < count; ++i )
+        {
+          if ( bounds.at( i ).intersects( search ) )
+            expected << ids.at( i );
+        }
+        QCOMPARE( _sorted( index.intersects( search ) ), expected );
+      }
+    }
+
+    void testNearestNeighbor()
+    {
+      QVector< QgsFeatureId > ids;
+      QVector< QgsRectangle > bounds;
+      for ( int i = 0; i < 1000; ++i )
+      {
+        ids << i;
+        bounds << QgsRectangle( i * 10, 0, i * 10 + 1, 1 );
+      }
+      const QgsSpatialIndexPackedRTree index( ids, bounds );
+
+      QCOMPARE( index.nearestNeighbor( QgsPointXY( 503, 0 ) ), QList< QgsFeatureId >() << 50 );
+      QCOMPARE( index.nearestNeighbor( QgsPointXY( 503, 0 ), 3 ), QList< QgsFeatureId >() << 50 << 51 << 49 );
+      QCOMPARE( index.nearestNeighbor( QgsPointXY( -5, 0.5 ), 2 ), QList< QgsFeatureId >() << 0 << 1 );
+
+      // max distance is measured to the bounding boxes
+      QCOMPARE( _sorted( index.nearestNeighbor( QgsPointXY( 503, 0 ), 10, 12 ) ), QList< QgsFeatureId >() << 49 << 50 << 51 );
+      QVERIFY( index.nearestNeighbor( QgsPointXY( 503, 100 ), 10, 12 ).isEmpty() );
+    }
+
+    void testSource()
+    {
+      QgsVectorLayer layer( QStringLiteral( "Polygon" ), QStringLiteral( "rects" ), QStringLiteral( "memory" ) );
+      QgsFeatureList features;
+      features << _rectFeature( 1, QgsRectangle( 0, 0, 1, 1 ) )
+               << _rectFeature( 2, QgsRectangle( 2, 2, 3, 3 ) )
+               << _rectFeature( 3, QgsRectangle( 0.5, 0.5, 2.5, 2.5 ) );
+      // features without geometry are not indexed
+      features << QgsFeature( 4 );
+      QVERIFY( layer.dataProvider()->addFeatures( features ) );
+
+      const QgsSpatialIndexPackedRTree index( *layer.dataProvider() );
+      QCOMPARE( index.size(), static_cast< qgssize >( 3 ) );
+      QCOMPARE( index.extent(), QgsRectangle( 0, 0, 3, 3 ) );
+
+      // same results as QgsSpatialIndex
+      const QgsSpatialIndex reference( *layer.dataProvider() );
+      const QList< QgsRectangle > searches { QgsRectangle( 0, 0, 0.7, 0.7 ), QgsRectangle( 1.5, 1.5, 1.8, 1.8 ), QgsRectangle( 10, 10, 11, 11 ) };
+      for ( const QgsRectangle &search : searches )
+        QCOMPARE( _sorted( index.intersects( search ) ), _sorted( reference.intersects( search ) ) );
+
+      // the callback can stop the load
+      int calls = 0;
+      QgsFeatureIterator it = layer.getFeatures();
+      const QgsSpatialIndexPackedRTree partial( it, [&calls]( const QgsFeature & )->bool
+      {
+        return ++calls < 2;
+      } );
+      QCOMPARE( partial.size(), static_cast< qgssize >( 1 ) );
+    }
+
+    void testCopy()
+    {
+      std::unique_ptr< QgsSpatialIndexPackedRTree > index = std::make_unique< QgsSpatialIndexPackedRTree >( QVector< QgsFeatureId >() << 1 << 2, QVector< QgsRectangle >() << QgsRectangle( 0, 0, 1, 1 ) << QgsRectangle( 5, 5, 6, 6 ) );
+      const QgsSpatialIndexPackedRTree copy( *index );
+      QgsSpatialIndexPackedRTree assigned;
+      assigned = *index;
+      index.reset();
+
+      QCOMPARE( copy.intersects( QgsRectangle( 4, 4, 7, 7 ) ), QList< QgsFeatureId >() << 2 );
+      QCOMPARE( assigned.intersects( QgsRectangle( -1, -1, 0.5, 0.5 ) ), QList< QgsFeatureId >() << 1 );
+    }
+
+    void testFile()
+    {
+      QVector< QgsFeatureId > ids;
+      QVector< QgsRectangle > bounds;
+      for ( int i = 0; i < 3000; ++i )
+      {
+        ids << i + 100;
+        bounds << QgsRectangle( i % 50, i / 50, i % 50 + 2, i / 50 + 2 );
+      }
+      const QgsSpatialIndexPackedRTree index( ids, bounds, 8 );
+
+      const QTemporaryDir dir;
+      const QString path = dir.filePath( QStringLiteral( "index.qpr" ) );
+      QVERIFY( index.writeToFile( path ) );
+
+      bool ok = false;
+      const QgsSpatialIndexPackedRTree loaded = QgsSpatialIndexPackedRTree::fromFile( path, &ok );
+      QVERIFY( ok );
+      QCOMPARE( loaded.size(), index.size() );
+      QCOMPARE( loaded.nodeSize(), 8 );
+      QCOMPARE( loaded.extent(), index.extent() );
+      const QgsRectangle search( 10.5, 20.5, 14, 25 );
+      QCOMPARE( _sorted( loaded.intersects( search ) ), _sorted( index.intersects( search ) ) );
+      QCOMPARE( loaded.nearestNeighbor( QgsPointXY( -10, -10 ), 1 ), index.nearestNeighbor( QgsPointXY( -10, -10 ), 1 ) );
+
+      // empty index
+      const QString emptyPath = dir.filePath( QStringLiteral( "empty.qpr" ) );
+      QVERIFY( QgsSpatialIndexPackedRTree().writeToFile( emptyPath ) );
+      QCOMPARE( QgsSpatialIndexPackedRTree::fromFile( emptyPath, &ok ).size(), static_cast< qgssize >( 0 ) );
+      QVERIFY( ok );
+
+      // invalid files
+      QVERIFY( QgsSpatialIndexPackedRTree::fromFile( dir.filePath( QStringLiteral( "missing.qpr" ) ), &ok ).intersects( search ).isEmpty() );
+      QVERIFY( !ok );
+
+      QFile truncated( path );
+      QVERIFY( truncated.resize( truncated.size() - 8 ) );
+      QCOMPARE( QgsSpatialIndexPackedRTree::fromFile( path, &ok ).size(), static_cast< qgssize >( 0 ) );
+      QVERIFY( !ok );
+    }
+};
+
+QGSTEST_MAIN( TestQgsSpatialIndexPackedRTree )
+
+#include "testqgsspatialindexpackedrtree.moc"
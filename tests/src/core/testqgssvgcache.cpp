@@ -48,6 +48,7 @@ class TestQgsSvgCache : public QgsTest
     void init() {} // will be called before each testfunction is executed.
     void cleanup() {} // will be called after every testfunction.
     void fillCache();
+    void imageCost();
     void broken();
     void threadSafePicture();
     void threadSafeImage();
@@ -94,6 +95,23 @@ void TestQgsSvgCache::fillCache()
   }
 }
 
+void TestQgsSvgCache::imageCost()
+{
+  QgsSvgCache cache;
+  const QString svgPath = TEST_DATA_DIR + QStringLiteral( "/sample_svg.svg" );
+  bool fitInCache = false;
+
+  // images are accounted by their size in bytes, so an 800 pixels wide image fits in the cache
+  QImage image = cache.svgAsImage( svgPath, 800, QColor( 255, 0, 0 ), QColor( 0, 255, 0 ), 1, 1, fitInCache );
+  QVERIFY( fitInCache );
+  QCOMPARE( image.width(), 800 );
+
+  // but images larger than half of the cache size are not cached
+  image = cache.svgAsImage( svgPath, 3000, QColor( 255, 0, 0 ), QColor( 0, 255, 0 ), 1, 1, fitInCache );
+  QVERIFY( !fitInCache );
+  QCOMPARE( image.width(), 3000 );
+}
+
 void TestQgsSvgCache::broken()
 {
   QgsSvgCache cache;
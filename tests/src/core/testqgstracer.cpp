@@ -396,6 +396,17 @@ void TestQgsTracer::testExtent()
 
   const QgsPolylineXY points2 = tracer.findShortestPath( QgsPointXY( 0, 0 ), QgsPointXY( 20, 10 ) );
   QCOMPARE( points2.count(), 0 );
+
+  // the graph is kept for extents within the extent it was built for
+  tracer.setExtent( QgsRectangle( 1, 1, 4, 4 ) );
+  QVERIFY( tracer.isInitialized() );
+  tracer.setExtent( QgsRectangle( 0, 0, 20, 20 ) );
+  QVERIFY( !tracer.isInitialized() );
+  tracer.init();
+  const QgsPolylineXY points3 = tracer.findShortestPath( QgsPointXY( 0, 0 ), QgsPointXY( 20, 10 ) );
+  QVERIFY( points3.count() > 0 );
+  tracer.setExtent( QgsRectangle() );
+  QVERIFY( !tracer.isInitialized() );
 }
 
 void TestQgsTracer::testReprojection()
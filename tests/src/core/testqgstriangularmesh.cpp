@@ -24,6 +24,7 @@
 #include "qgsapplication.h"
 #include "qgsproject.h"
 #include "qgis.h"
+#include "qgscoordinatetransform.h"
 
 /**
  * \ingroup UnitTests
@@ -46,6 +47,8 @@ class TestQgsTriangularMesh : public QObject
 
     void test_centroids();
 
+    void test_updateLargeMesh();
+
   private:
     void populateMeshVertices( QgsTriangularMesh &mesh );
 
@@ -167,5 +170,50 @@ void TestQgsTriangularMesh::test_centroids()
 
 }
 
+void TestQgsTriangularMesh::test_updateLargeMesh()
+{
+  // a grid of quads large enough to be processed in several blocks
+  const int size = 400;
+  QgsMesh nativeMesh;
+  for ( int row = 0; row <= size; ++row )
+    for ( int col = 0; col <= size; ++col )
+      nativeMesh.vertices.append( QgsMeshVertex( 10 + col * 0.001, 45 + row * 0.001, row + col ) );
+  for ( int row = 0; row < size; ++row )
+  {
+    for ( int col = 0; col < size; ++col )
+    {
+      const int v = row * ( size + 1 ) + col;
+      nativeMesh.faces.append( QgsMeshFace( {v, v + 1, v + size + 2, v + size + 1} ) );
+    }
+  }
+
+  const QgsCoordinateTransform transform( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ), QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ), QgsProject::instance() );
+  QgsTriangularMesh mesh;
+  QVERIFY( mesh.update( &nativeMesh, transform ) );
+
+  QCOMPARE( mesh.vertices().count(), nativeMesh.vertices.count() );
+  QCOMPARE( mesh.triangles().count(), 2 * size * size );
+  QCOMPARE( mesh.faceCentroids().count(), size * size );
+  for ( int i = 0; i < nativeMesh.vertices.count(); i += 997 )
+  {
+    QgsMeshVertex expected = nativeMesh.vertices.at( i );
+    expected.transform( transform );
+    QGSCOMPARENEAR( mesh.vertices().at( i ).x(), expected.x(), 1e-6 );
+    QGSCOMPARENEAR( mesh.vertices().at( i ).y(), expected.y(), 1e-6 );
+    QCOMPARE( mesh.vertices().at( i ).z(), expected.z() );
+  }
+
+  // triangles keep the order of the native faces
+  const QVector<int> trianglesToNativeFaces = mesh.trianglesToNativeFaces();
+  for ( int i = 0; i < trianglesToNativeFaces.count(); ++i )
+    QCOMPARE( trianglesToNativeFaces.at( i ), i / 2 );
+
+  // the spatial index finds the triangles of a face in the middle of the grid
+  const int face = ( size / 2 ) * size + size / 2;
+  const QgsPointXY centroid( mesh.faceCentroids().at( face ) );
+  const int triangle = mesh.faceIndexForPoint_v2( centroid );
+  QCOMPARE( trianglesToNativeFaces.at( triangle ), face );
+}
+
 QGSTEST_MAIN( TestQgsTriangularMesh )
 #include "testqgstriangularmesh.moc"
@@ -38,6 +38,7 @@ class TestQgsValueRelationFieldFormatter: public QObject
     void cleanup(); // will be called after every testfunction.
     void testDependencies();
     void testSortValueNull();
+    void testRepresentValue();
 
   private:
     std::unique_ptr<QgsVectorLayer> mLayer1;
@@ -164,5 +165,32 @@ void TestQgsValueRelationFieldFormatter::testSortValueNull()
   QCOMPARE( value, QVariant( QString( "iron" ) ) );
 }
 
+void TestQgsValueRelationFieldFormatter::testRepresentValue()
+{
+  const QgsValueRelationFieldFormatter formatter;
+  QVariantMap config;
+  config.insert( QStringLiteral( "Layer" ), mLayer2->id() );
+  config.insert( QStringLiteral( "Key" ), QStringLiteral( "pk" ) );
+  config.insert( QStringLiteral( "Value" ), QStringLiteral( "raccord" ) );
+
+  const QVariant cache = formatter.createCache( mLayer1.get(), 1, config );
+  QCOMPARE( formatter.representValue( mLayer1.get(), 1, config, cache, 10 ), QStringLiteral( "brides" ) );
+  QCOMPARE( formatter.representValue( mLayer1.get(), 1, config, cache, 11 ), QStringLiteral( "sleeve" ) );
+  QCOMPARE( formatter.representValue( mLayer1.get(), 1, config, cache, 12 ), QStringLiteral( "collar" ) );
+  // keys of another type than the cached keys
+  QCOMPARE( formatter.representValue( mLayer1.get(), 1, config, cache, QVariant( 11LL ) ), QStringLiteral( "sleeve" ) );
+  QCOMPARE( formatter.representValue( mLayer1.get(), 1, config, cache, 13 ), QStringLiteral( "(13)" ) );
+
+  // ordered by value
+  config.insert( QStringLiteral( "OrderByValue" ), true );
+  const QVariant valueOrderedCache = formatter.createCache( mLayer1.get(), 1, config );
+  QCOMPARE( formatter.representValue( mLayer1.get(), 1, config, valueOrderedCache, 10 ), QStringLiteral( "brides" ) );
+  QCOMPARE( formatter.representValue( mLayer1.get(), 1, config, valueOrderedCache, 12 ), QStringLiteral( "collar" ) );
+
+  // multiple values
+  config.insert( QStringLiteral( "AllowMulti" ), true );
+  QCOMPARE( formatter.representValue( mLayer1.get(), 1, config, valueOrderedCache, QStringLiteral( "{10,12}" ) ), QStringLiteral( "{brides, collar}" ) );
+}
+
 QGSTEST_MAIN( TestQgsValueRelationFieldFormatter )
 #include "testqgsvaluerelationfieldformatter.moc"
@@ -20,12 +20,14 @@
 #include <QTemporaryFile>
 
 #include "qgsvectorlayer.h" //defines QgsFieldMap
+#include "qgsvectordataprovider.h"
 #include "qgsvectorfilewriter.h" //logic for writing shpfiles
 #include "qgsfeature.h" //we will need to pass a bunch of these for each rec
 #include "qgsgeometry.h" //each feature needs a geometry
 #include "qgspointxy.h" //we will use point geometry
 #include "qgscoordinatereferencesystem.h" //needed for creating a srs
 #include "qgscoordinatetransformcontext.h"
+#include "qgscoordinatetransform.h"
 #include "qgsapplication.h" //search path for srs.db
 #include "qgslogger.h"
 #include "qgsfield.h"
@@ -112,6 +114,10 @@ class TestQgsVectorFileWriter: public QObject
     void testExportCustomFieldNames();
     //! Test export to shape with NaN values for Z
     void testExportToShapeNanValuesForZ();
+    //! Test export of several batches of features, which are prepared on worker threads
+    void testExportManyFeatures();
+    //! Test deferred creation of GeoPackage spatial indexes
+    void testDeferredSpatialIndex();
   private:
     // a little util fn used by all tests
     bool cleanupFile( QString fileBase );
@@ -751,5 +757,112 @@ void TestQgsVectorFileWriter::testExportToShapeNanValuesForZ()
   QVERIFY( mError == QgsVectorFileWriter::NoError );
 }
 
+void TestQgsVectorFileWriter::testExportManyFeatures()
+{
+  QTemporaryFile tmpFile( QDir::tempPath() +  "/test_qgsvectorfilewriter4_XXXXXX.gpkg" );
+  tmpFile.open();
+  const QString fileName( tmpFile.fileName( ) );
+  QgsVectorLayer vl( "Point?crs=EPSG:4326&field=id:integer&field=name:string&field=value:double", "test", "memory" );
+  QgsFeatureList features;
+  for ( int i = 0; i < 2500; ++i )
+  {
+    QgsFeature f { vl.fields() };
+    f.setAttributes( QgsAttributes() << i << QStringLiteral( "feature %1" ).arg( i ) << i / 4.0 );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i % 50, i / 50 ) ) );
+    features << f;
+  }
+  QVERIFY( vl.dataProvider()->addFeatures( features ) );
+
+  QgsVectorFileWriter::SaveVectorOptions options;
+  options.driverName = "GPKG";
+  options.layerName = "test";
+  options.ct = QgsCoordinateTransform( vl.crs(), QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ), vl.transformContext() );
+  // features of the first 40 rows
+  options.filterExtent = options.ct.transformBoundingBox( QgsRectangle( -1, -1, 51, 39.5 ) );
+  QString errorMessage;
+  const QgsVectorFileWriter::WriterError error( QgsVectorFileWriter::writeAsVectorFormatV3(
+        &vl,
+        fileName,
+        vl.transformContext(),
+        options, &errorMessage ) );
+  QCOMPARE( error, QgsVectorFileWriter::WriterError::NoError );
+  QVERIFY( errorMessage.isEmpty() );
+
+  QgsVectorLayer vl2( QStringLiteral( "%1|layername=test" ).arg( fileName ), "src_test", "ogr" );
+  QVERIFY( vl2.isValid() );
+  QCOMPARE( vl2.featureCount(), 2000L );
+  QCOMPARE( vl2.crs().authid(), QStringLiteral( "EPSG:3857" ) );
+
+  // features are written in their input order
+  QgsFeatureIterator it = vl2.getFeatures();
+  QgsFeature f;
+  int expected = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.attribute( QStringLiteral( "id" ) ).toInt(), expected );
+    QCOMPARE( f.attribute( QStringLiteral( "name" ) ).toString(), QStringLiteral( "feature %1" ).arg( expected ) );
+    QCOMPARE( f.attribute( QStringLiteral( "value" ) ).toDouble(), expected / 4.0 );
+    expected++;
+  }
+  QCOMPARE( expected, 2000 );
+
+  QgsFeatureRequest request;
+  request.setFilterExpression( QStringLiteral( "id = 1234" ) );
+  QVERIFY( vl2.getFeatures( request ).nextFeature( f ) );
+  const QgsPointXY point = options.ct.transform( QgsPointXY( 34, 24 ) );
+  QGSCOMPARENEAR( f.geometry().asPoint().x(), point.x(), 0.001 );
+  QGSCOMPARENEAR( f.geometry().asPoint().y(), point.y(), 0.001 );
+}
+
+void TestQgsVectorFileWriter::testDeferredSpatialIndex()
+{
+  QTemporaryFile tmpFile( QDir::tempPath() +  "/test_qgsvectorfilewriter5_XXXXXX.gpkg" );
+  tmpFile.open();
+  const QString fileName( tmpFile.fileName( ) );
+  QgsFields fields;
+  fields.append( QgsField( QStringLiteral( "id" ), QVariant::Int ) );
+
+  QgsVectorFileWriter::SaveVectorOptions options;
+  options.driverName = "GPKG";
+  options.layerName = "deferred";
+  options.layerOptions = QgsVectorFileWriter::defaultLayerOptions( QStringLiteral( "GPKG" ) );
+  options.spatialIndexCreation = QgsVectorFileWriter::SpatialIndexDeferred;
+  std::unique_ptr< QgsVectorFileWriter > writer( QgsVectorFileWriter::create( fileName, fields, QgsWkbTypes::Point, QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ), QgsCoordinateTransformContext(), options ) );
+  QCOMPARE( writer->hasError(), QgsVectorFileWriter::NoError );
+  for ( int i = 0; i < 100; ++i )
+  {
+    QgsFeature f( fields );
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+    QVERIFY( writer->addFeature( f ) );
+  }
+  writer.reset();
+
+  QgsVectorLayer vl( QStringLiteral( "%1|layername=deferred" ).arg( fileName ), "test", "ogr" );
+  QVERIFY( vl.isValid() );
+  QCOMPARE( vl.featureCount(), 100L );
+  QCOMPARE( vl.dataProvider()->hasSpatialIndex(), QgsFeatureSource::SpatialIndexPresent );
+  QgsFeatureRequest request;
+  request.setFilterRect( QgsRectangle( 9.5, 9.5, 20.5, 20.5 ) );
+  QgsFeatureIterator it = vl.getFeatures( request );
+  QgsFeature f;
+  int count = 0;
+  while ( it.nextFeature( f ) )
+    count++;
+  QCOMPARE( count, 11 );
+
+  // layer options disabling the spatial index are respected
+  options.layerName = "no_index";
+  options.actionOnExistingFile = QgsVectorFileWriter::CreateOrOverwriteLayer;
+  options.layerOptions = QStringList() << QStringLiteral( "SPATIAL_INDEX=NO" );
+  writer.reset( QgsVectorFileWriter::create( fileName, fields, QgsWkbTypes::Point, QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ), QgsCoordinateTransformContext(), options ) );
+  QCOMPARE( writer->hasError(), QgsVectorFileWriter::NoError );
+  writer.reset();
+
+  QgsVectorLayer vl2( QStringLiteral( "%1|layername=no_index" ).arg( fileName ), "test", "ogr" );
+  QVERIFY( vl2.isValid() );
+  QCOMPARE( vl2.dataProvider()->hasSpatialIndex(), QgsFeatureSource::SpatialIndexNotPresent );
+}
+
 QGSTEST_MAIN( TestQgsVectorFileWriter )
 #include "testqgsvectorfilewriter.moc"
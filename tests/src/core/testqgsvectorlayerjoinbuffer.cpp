@@ -70,6 +70,7 @@ class TestVectorLayerJoinBuffer : public QObject
     void testChangeAttributeValues();
     void testCollidingNameColumn();
     void testCollidingNameColumnCached();
+    void testDirectLookupRepeatedValues();
 
   private:
     QgsProject mProject;
@@ -1022,5 +1023,52 @@ void TestVectorLayerJoinBuffer::testCollidingNameColumnCached()
   QCOMPARE( fA1.attribute( "value_c" ).toString(), QStringLiteral( "value_c" ) );
 }
 
+void TestVectorLayerJoinBuffer::testDirectLookupRepeatedValues()
+{
+  mProject.clear();
+  QgsVectorLayer *vlA = new QgsVectorLayer( QStringLiteral( "Point?field=id_a:integer" ), QStringLiteral( "lookupA" ), QStringLiteral( "memory" ) );
+  QVERIFY( vlA->isValid() );
+  QgsVectorLayer *vlB = new QgsVectorLayer( QStringLiteral( "Point?field=id_b:integer&field=value_b" ), QStringLiteral( "lookupB" ), QStringLiteral( "memory" ) );
+  QVERIFY( vlB->isValid() );
+  mProject.addMapLayer( vlA );
+  mProject.addMapLayer( vlB );
+
+  // several features share the same join values, and one value has no joined feature
+  QgsFeatureList featuresA;
+  const QList< int > joinValues { 1, 2, 1, 3, 2, 1 };
+  for ( int value : joinValues )
+  {
+    QgsFeature f( vlA->dataProvider()->fields() );
+    f.setAttribute( QStringLiteral( "id_a" ), value );
+    featuresA << f;
+  }
+  vlA->dataProvider()->addFeatures( featuresA );
+
+  QgsFeatureList featuresB;
+  for ( int value : { 1, 2 } )
+  {
+    QgsFeature f( vlB->dataProvider()->fields() );
+    f.setAttribute( QStringLiteral( "id_b" ), value );
+    f.setAttribute( QStringLiteral( "value_b" ), QStringLiteral( "value_%1" ).arg( value ) );
+    featuresB << f;
+  }
+  vlB->dataProvider()->addFeatures( featuresB );
+
+  QgsVectorLayerJoinInfo joinInfo;
+  joinInfo.setTargetFieldName( QStringLiteral( "id_a" ) );
+  joinInfo.setJoinLayer( vlB );
+  joinInfo.setJoinFieldName( QStringLiteral( "id_b" ) );
+  joinInfo.setUsingMemoryCache( false );
+  joinInfo.setPrefix( QString() );
+  vlA->addJoin( joinInfo );
+
+  QStringList values;
+  QgsFeatureIterator fi = vlA->getFeatures();
+  QgsFeature f;
+  while ( fi.nextFeature( f ) )
+    values << ( f.attribute( QStringLiteral( "value_b" ) ).isNull() ? QStringLiteral( "null" ) : f.attribute( QStringLiteral( "value_b" ) ).toString() );
+  QCOMPARE( values, QStringList( { "value_1", "value_2", "value_1", "null", "value_2", "value_1" } ) );
+}
+
 QGSTEST_MAIN( TestVectorLayerJoinBuffer )
 #include "testqgsvectorlayerjoinbuffer.moc"
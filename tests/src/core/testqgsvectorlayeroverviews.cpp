@@ -0,0 +1,124 @@
+/***************************************************************************
+     testqgsvectorlayeroverviews.cpp
+     -------------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+#include <QString>
+#include <QTemporaryDir>
+
+#include <qgsapplication.h>
+#include "qgsfeatureiterator.h"
+#include "qgsgeometry.h"
+#include "qgslinestring.h"
+#include "qgsvectordataprovider.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerfeatureiterator.h"
+#include "qgsvectorlayeroverviews.h"
+
+class TestQgsVectorLayerOverviews : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+
+    void initTestCase()
+    {
+      QgsApplication::init();
+      QgsApplication::initQgis();
+    }
+    void cleanupTestCase()
+    {
+      QgsApplication::exitQgis();
+    }
+
+    void testOverviews()
+    {
+      QgsVectorLayer layer( QStringLiteral( "LineString?crs=epsg:3857&field=name:string(20)&field=value:integer" ), QStringLiteral( "lines" ), QStringLiteral( "memory" ) );
+      QVERIFY( layer.isValid() );
+
+      // lines of 1000 vertices spread over 1 km
+      QgsFeatureList features;
+      for ( int i = 0; i < 5; ++i )
+      {
+        QVector< double > x;
+        QVector< double > y;
+        for ( int j = 0; j < 1000; ++j )
+        {
+          x << j;
+          y << i * 100 + ( j % 2 ) * 0.1;
+        }
+        QgsFeature f( layer.fields() );
+        f.setAttributes( QgsAttributes() << QStringLiteral( "line%1" ).arg( i ) << i );
+        f.setGeometry( QgsGeometry( new QgsLineString( x, y ) ) );
+        features << f;
+      }
+      QVERIFY( layer.dataProvider()->addFeatures( features ) );
+      QVERIFY( layer.dataProvider()->deleteFeatures( QgsFeatureIds() << features.at( 1 ).id() ) );
+
+      QVERIFY( QgsVectorLayerOverviews::path( &layer ).isEmpty() );
+      QVERIFY( !QgsVectorLayerOverviews::createFeatureSource( &layer, 1000000 ) );
+
+      const QTemporaryDir dir;
+      const QString path = dir.filePath( QStringLiteral( "overviews.gpkg" ) );
+      QString error;
+      QVERIFY( QgsVectorLayerOverviews::build( &layer, path, QList< double >() << 100000 << 10000, nullptr, &error ) );
+      QVERIFY( error.isEmpty() );
+      QCOMPARE( QgsVectorLayerOverviews::path( &layer ), path );
+      QCOMPARE( QgsVectorLayerOverviews::scales( &layer ), QList< double >() << 10000 << 100000 );
+
+      // no overview at larger scales than the overview scales
+      QVERIFY( !QgsVectorLayerOverviews::createFeatureSource( &layer, 5000 ) );
+
+      std::unique_ptr< QgsAbstractFeatureSource > source( QgsVectorLayerOverviews::createFeatureSource( &layer, 20000 ) );
+      QVERIFY( source );
+
+      // features keep their ids and attributes in the layer fields, with simplified geometries
+      QgsFeatureIterator it = source->getFeatures();
+      QgsFeature f;
+      QgsFeatureIds ids;
+      while ( it.nextFeature( f ) )
+      {
+        ids << f.id();
+        const QgsFeature original = layer.getFeature( f.id() );
+        QCOMPARE( f.fields(), layer.dataProvider()->fields() );
+        QCOMPARE( f.attributes(), original.attributes() );
+        QVERIFY( f.geometry().constGet()->nCoordinates() < 10 );
+        QVERIFY( f.geometry().boundingBox().width() > 998 );
+      }
+      QCOMPARE( ids, layer.allFeatureIds() );
+
+      // subsets of attributes are mapped to the overview fields
+      it = source->getFeatures( QgsFeatureRequest().setFilterFid( features.at( 2 ).id() ).setSubsetOfAttributes( QgsAttributeList() << 1 ) );
+      QVERIFY( it.nextFeature( f ) );
+      QCOMPARE( f.attribute( 1 ), QVariant( 2 ) );
+      QVERIFY( !it.nextFeature( f ) );
+
+      // the overview replaces the provider features in a layer source
+      QgsVectorLayerFeatureSource layerSource( &layer );
+      layerSource.setProviderFeatureSource( QgsVectorLayerOverviews::createFeatureSource( &layer, 1000000 ) );
+      it = layerSource.getFeatures( QgsFeatureRequest().setFilterExpression( QStringLiteral( "\"name\" = 'line4'" ) ) );
+      QVERIFY( it.nextFeature( f ) );
+      QCOMPARE( f.id(), features.at( 4 ).id() );
+      QVERIFY( f.geometry().constGet()->nCoordinates() < 10 );
+      QVERIFY( !it.nextFeature( f ) );
+
+      QgsVectorLayerOverviews::remove( &layer );
+      QVERIFY( QgsVectorLayerOverviews::path( &layer ).isEmpty() );
+      QVERIFY( !QgsVectorLayerOverviews::createFeatureSource( &layer, 1000000 ) );
+    }
+};
+
+QGSTEST_MAIN( TestQgsVectorLayerOverviews )
+
+#include "testqgsvectorlayeroverviews.moc"
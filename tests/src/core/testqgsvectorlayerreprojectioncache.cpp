@@ -0,0 +1,207 @@
+/***************************************************************************
+    testqgsvectorlayerreprojectioncache.cpp
+     --------------------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgscoordinatetransform.h"
+#include "qgsfillsymbol.h"
+#include "qgsmaprendererjob.h"
+#include "qgsmapsettings.h"
+#include "qgsproject.h"
+#include "qgssinglesymbolrenderer.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerreprojectioncache.h"
+
+class TestQgsVectorLayerReprojectionCache : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void cache();
+    void maximumSize();
+    void layerInvalidation();
+    void render();
+
+  private:
+    QImage renderLayer( QgsVectorLayer *layer );
+};
+
+void TestQgsVectorLayerReprojectionCache::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsVectorLayerReprojectionCache::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsVectorLayerReprojectionCache::cache()
+{
+  QgsVectorLayerReprojectionCache cache( 1000000 );
+  const QgsCoordinateTransform toMercator( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ), QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ), QgsProject::instance() );
+  const QgsCoordinateTransform toLambert( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:4326" ) ), QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:2154" ) ), QgsProject::instance() );
+  const QString mercatorKey = QgsVectorLayerReprojectionCache::transformKey( toMercator );
+  const QString lambertKey = QgsVectorLayerReprojectionCache::transformKey( toLambert );
+  QVERIFY( mercatorKey != lambertKey );
+
+  QgsGeometry geometry;
+  QVERIFY( !cache.geometry( mercatorKey, 1, geometry ) );
+
+  cache.insert( mercatorKey, 1, QgsGeometry::fromWkt( QStringLiteral( "Point (1 2)" ) ), cache.generation() );
+  cache.insert( mercatorKey, 2, QgsGeometry::fromWkt( QStringLiteral( "Point (3 4)" ) ), cache.generation() );
+  QCOMPARE( cache.count(), 2 );
+  QVERIFY( cache.geometry( mercatorKey, 1, geometry ) );
+  QCOMPARE( geometry.asWkt(), QStringLiteral( "Point (1 2)" ) );
+  QVERIFY( !cache.geometry( lambertKey, 1, geometry ) );
+
+  // geometries fetched before an invalidation are ignored
+  const quint64 generation = cache.generation();
+  cache.invalidate( 1 );
+  QVERIFY( !cache.geometry( mercatorKey, 1, geometry ) );
+  QVERIFY( cache.geometry( mercatorKey, 2, geometry ) );
+  cache.insert( mercatorKey, 1, QgsGeometry::fromWkt( QStringLiteral( "Point (1 2)" ) ), generation );
+  QVERIFY( !cache.geometry( mercatorKey, 1, geometry ) );
+
+  // another transform replaces the cached geometries
+  cache.insert( lambertKey, 1, QgsGeometry::fromWkt( QStringLiteral( "Point (5 6)" ) ), cache.generation() );
+  QCOMPARE( cache.count(), 1 );
+  QVERIFY( !cache.geometry( mercatorKey, 2, geometry ) );
+  QVERIFY( cache.geometry( lambertKey, 1, geometry ) );
+  QCOMPARE( geometry.asWkt(), QStringLiteral( "Point (5 6)" ) );
+
+  cache.clear();
+  QCOMPARE( cache.count(), 0 );
+}
+
+void TestQgsVectorLayerReprojectionCache::maximumSize()
+{
+  const QgsGeometry point = QgsGeometry::fromWkt( QStringLiteral( "Point (1 2)" ) );
+  const int pointSize = point.constGet()->wkbSize();
+
+  QgsVectorLayerReprojectionCache cache( 3 * pointSize );
+  QCOMPARE( cache.maximumSize(), 3 * pointSize );
+  for ( int i = 0; i < 5; ++i )
+    cache.insert( QStringLiteral( "key" ), i, point, cache.generation() );
+  QCOMPARE( cache.count(), 3 );
+
+  // the least recently used geometries are discarded first
+  QgsGeometry geometry;
+  QVERIFY( !cache.geometry( QStringLiteral( "key" ), 0, geometry ) );
+  QVERIFY( cache.geometry( QStringLiteral( "key" ), 4, geometry ) );
+
+  cache.setMaximumSize( pointSize );
+  QCOMPARE( cache.count(), 1 );
+  QVERIFY( cache.geometry( QStringLiteral( "key" ), 4, geometry ) );
+
+  // larger geometries than the cache are never stored
+  cache.insert( QStringLiteral( "key" ), 5, QgsGeometry::fromWkt( QStringLiteral( "LineString (1 2, 3 4)" ) ), cache.generation() );
+  QVERIFY( !cache.geometry( QStringLiteral( "key" ), 5, geometry ) );
+}
+
+void TestQgsVectorLayerReprojectionCache::layerInvalidation()
+{
+  QgsVectorLayer layer( QStringLiteral( "Point?crs=EPSG:4326" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer.isValid() );
+  QVERIFY( !layer.reprojectionCache() );
+  QCOMPARE( layer.reprojectionCacheMaximumSize(), 0 );
+
+  QgsFeature f1;
+  f1.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Point (1 2)" ) ) );
+  QgsFeature f2;
+  f2.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Point (3 4)" ) ) );
+  QVERIFY( layer.dataProvider()->addFeatures( QgsFeatureList() << f1 << f2 ) );
+  const QgsFeatureIds ids = layer.allFeatureIds();
+  const QgsFeatureId fid1 = *std::min_element( ids.begin(), ids.end() );
+  const QgsFeatureId fid2 = *std::max_element( ids.begin(), ids.end() );
+
+  layer.setReprojectionCacheMaximumSize( 1000000 );
+  QCOMPARE( layer.reprojectionCacheMaximumSize(), 1000000 );
+  const std::shared_ptr< QgsVectorLayerReprojectionCache > cache = layer.reprojectionCache();
+  QVERIFY( cache );
+
+  const QgsGeometry point = QgsGeometry::fromWkt( QStringLiteral( "Point (10 20)" ) );
+  cache->insert( QStringLiteral( "key" ), fid1, point, cache->generation() );
+  cache->insert( QStringLiteral( "key" ), fid2, point, cache->generation() );
+
+  // edited geometries are invalidated
+  QgsGeometry geometry;
+  QVERIFY( layer.startEditing() );
+  QVERIFY( layer.changeGeometry( fid1, QgsGeometry::fromWkt( QStringLiteral( "Point (5 6)" ) ) ) );
+  QVERIFY( !cache->geometry( QStringLiteral( "key" ), fid1, geometry ) );
+  QVERIFY( cache->geometry( QStringLiteral( "key" ), fid2, geometry ) );
+
+  QVERIFY( layer.deleteFeature( fid2 ) );
+  QVERIFY( !cache->geometry( QStringLiteral( "key" ), fid2, geometry ) );
+
+  cache->insert( QStringLiteral( "key" ), fid2, point, cache->generation() );
+  QVERIFY( layer.rollBack() );
+  QCOMPARE( cache->count(), 0 );
+
+  layer.setReprojectionCacheMaximumSize( 0 );
+  QVERIFY( !layer.reprojectionCache() );
+  QCOMPARE( layer.reprojectionCacheMaximumSize(), 0 );
+}
+
+QImage TestQgsVectorLayerReprojectionCache::renderLayer( QgsVectorLayer *layer )
+{
+  QgsMapSettings settings;
+  settings.setLayers( QList< QgsMapLayer * >() << layer );
+  settings.setDestinationCrs( QgsCoordinateReferenceSystem( QStringLiteral( "EPSG:3857" ) ) );
+  settings.setOutputSize( QSize( 200, 200 ) );
+  settings.setExtent( QgsRectangle( -1000000, -1000000, 3000000, 3000000 ) );
+  settings.setBackgroundColor( Qt::white );
+
+  QgsMapRendererSequentialJob job( settings );
+  job.start();
+  job.waitForFinished();
+  return job.renderedImage();
+}
+
+void TestQgsVectorLayerReprojectionCache::render()
+{
+  QgsVectorLayer layer( QStringLiteral( "Polygon?crs=EPSG:4326" ), QStringLiteral( "polygons" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer.isValid() );
+  QgsFeature f1;
+  f1.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((1 1, 10 1, 10 10, 1 1))" ) ) );
+  QgsFeature f2;
+  f2.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((12 12, 20 12, 20 20, 12 20, 12 12))" ) ) );
+  QVERIFY( layer.dataProvider()->addFeatures( QgsFeatureList() << f1 << f2 ) );
+
+  QgsVectorSimplifyMethod simplifyMethod;
+  simplifyMethod.setSimplifyHints( QgsVectorSimplifyMethod::NoSimplification );
+  layer.setSimplifyMethod( simplifyMethod );
+
+  QgsFillSymbol *symbol = QgsFillSymbol::createSimple( QVariantMap( { { QStringLiteral( "color" ), QStringLiteral( "255,0,0" ) } } ) );
+  layer.setRenderer( new QgsSingleSymbolRenderer( symbol ) );
+
+  const QImage expected = renderLayer( &layer );
+
+  layer.setReprojectionCacheMaximumSize( 1000000 );
+  const QImage first = renderLayer( &layer );
+  QCOMPARE( layer.reprojectionCache()->count(), 2 );
+  QCOMPARE( first, expected );
+
+  // drawn from the cached geometries
+  const QImage second = renderLayer( &layer );
+  QCOMPARE( second, expected );
+}
+
+QGSTEST_MAIN( TestQgsVectorLayerReprojectionCache )
+#include "testqgsvectorlayerreprojectioncache.moc"
@@ -56,6 +56,7 @@ class TestQgsVectorTileWriter : public QObject
     void test_filtering();
     void test_z0TileMatrix3857();
     void test_z0TileMatrix2154();
+    void test_tileBlocks();
 };
 
 
@@ -481,5 +482,65 @@ void TestQgsVectorTileWriter::test_z0TileMatrix2154()
 }
 
 
+void TestQgsVectorTileWriter::test_tileBlocks()
+{
+  QTemporaryDir dir;
+  const QString fileName = dir.path() + "/blocks.mbtiles";
+
+  QgsDataSourceUri ds;
+  ds.setParam( "type", "mbtiles" );
+  ds.setParam( "url", fileName );
+
+  QgsVectorLayer *vlPoints = new QgsVectorLayer( mDataDir + "/points.shp", "points", "ogr" );
+
+  QList<QgsVectorTileWriter::Layer> layers;
+  layers << QgsVectorTileWriter::Layer( vlPoints );
+
+  // tiles at zoom level 8 are spread over several blocks of tiles encoded in parallel
+  QgsVectorTileWriter writer;
+  writer.setDestinationUri( ds.encodedUri() );
+  writer.setMinZoom( 8 );
+  writer.setMaxZoom( 8 );
+  writer.setLayers( layers );
+
+  QVERIFY( writer.writeTiles() );
+  QVERIFY( writer.errorMessage().isEmpty() );
+
+  const QgsTileMatrix tileMatrix = QgsTileMatrix::fromWebMercator( 8 );
+  const QgsTileRange range = tileMatrix.tileRangeFromExtent( writer.fullExtent() );
+  QVERIFY( range.endColumn() - range.startColumn() >= 16 );
+
+  delete vlPoints;
+
+  // every point is written in the tile containing it, and possibly in the buffers of its neighbors
+  QgsVectorTileLayer *vtLayer = new QgsVectorTileLayer( ds.encodedUri(), "output" );
+  QMap<QString, QgsFields> perLayerFields;
+  perLayerFields["points"] = QgsFields();
+  int count = 0;
+  for ( int row = range.startRow(); row <= range.endRow(); ++row )
+  {
+    for ( int col = range.startColumn(); col <= range.endColumn(); ++col )
+    {
+      const QgsTileXYZ id( col, row, 8 );
+      const QByteArray tileData = vtLayer->getRawTile( id );
+      if ( tileData.isEmpty() )
+        continue;
+
+      QgsVectorTileMVTDecoder decoder( QgsVectorTileMatrixSet::fromWebMercator() );
+      QVERIFY( decoder.decode( id, tileData ) );
+      const QgsVectorTileFeatures features = decoder.layerFeatures( perLayerFields, QgsCoordinateTransform() );
+      const QgsRectangle tileExtent = tileMatrix.tileExtent( id );
+      for ( const QgsFeature &f : features["points"] )
+      {
+        if ( tileExtent.contains( f.geometry().boundingBox() ) )
+          ++count;
+      }
+    }
+  }
+  QCOMPARE( count, 17 );
+
+  delete vtLayer;
+}
+
 QGSTEST_MAIN( TestQgsVectorTileWriter )
 #include "testqgsvectortilewriter.moc"
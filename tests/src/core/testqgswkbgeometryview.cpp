@@ -0,0 +1,134 @@
+/***************************************************************************
+    testqgswkbgeometryview.cpp
+     --------------------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+
+#include "qgsapplication.h"
+#include "qgsgeometry.h"
+#include "qgsabstractgeometry.h"
+#include "qgswkbgeometryview.h"
+
+class TestQgsWkbGeometryView : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void geometries_data();
+    void geometries();
+    void bigEndian();
+    void malformed();
+};
+
+void TestQgsWkbGeometryView::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsWkbGeometryView::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsWkbGeometryView::geometries_data()
+{
+  QTest::addColumn<QString>( "wkt" );
+  QTest::addColumn<bool>( "directlyReadable" );
+
+  QTest::newRow( "point" ) << QStringLiteral( "Point (1 2)" ) << true;
+  QTest::newRow( "pointzm" ) << QStringLiteral( "PointZM (1 2 3 4)" ) << true;
+  QTest::newRow( "linestring" ) << QStringLiteral( "LineString (1 2, 3 -4, -5 6)" ) << true;
+  QTest::newRow( "linestringz" ) << QStringLiteral( "LineStringZ (1 2 10, 3 -4 20, -5 6 30)" ) << true;
+  QTest::newRow( "polygon with hole" ) << QStringLiteral( "Polygon ((0 0, 10 0, 10 10, 0 10, 0 0),(2 2, 3 2, 3 3, 2 2))" ) << true;
+  QTest::newRow( "multipoint" ) << QStringLiteral( "MultiPoint ((1 2),(3 4))" ) << true;
+  QTest::newRow( "multilinestringm" ) << QStringLiteral( "MultiLineStringM ((1 2 3, 4 5 6),(7 8 9, 10 11 12))" ) << true;
+  QTest::newRow( "multipolygon" ) << QStringLiteral( "MultiPolygon (((0 0, 1 0, 1 1, 0 0)),((5 5, 6 5, 6 6, 5 5)))" ) << true;
+  QTest::newRow( "collection" ) << QStringLiteral( "GeometryCollection (Point (1 2),LineString (3 4, 5 6),Polygon ((0 0, 1 0, 1 1, 0 0)))" ) << true;
+  QTest::newRow( "empty collection" ) << QStringLiteral( "GeometryCollection EMPTY" ) << true;
+  QTest::newRow( "circularstring" ) << QStringLiteral( "CircularString (0 0, 1 1, 2 0)" ) << false;
+  QTest::newRow( "collection with curve" ) << QStringLiteral( "GeometryCollection (Point (1 2),CircularString (0 0, 1 1, 2 0))" ) << false;
+}
+
+void TestQgsWkbGeometryView::geometries()
+{
+  QFETCH( QString, wkt );
+  QFETCH( bool, directlyReadable );
+
+  const QgsGeometry g = QgsGeometry::fromWkt( wkt );
+  const QgsWkbGeometryView view( g.asWkb() );
+  QCOMPARE( view.wkbType(), g.wkbType() );
+  QCOMPARE( view.isDirectlyReadable(), directlyReadable );
+  QCOMPARE( view.boundingBox(), g.boundingBox() );
+  QCOMPARE( view.vertexCount(), g.constGet()->nCoordinates() );
+  QCOMPARE( view.geometry().asWkt(), g.asWkt() );
+
+  QVector< QgsPointXY > vertices;
+  view.visitVertices( [&vertices]( double x, double y )
+  {
+    vertices << QgsPointXY( x, y );
+  } );
+  QVector< QgsPointXY > expected;
+  for ( auto it = g.constGet()->vertices_begin(); it != g.constGet()->vertices_end(); ++it )
+    expected << QgsPointXY( ( *it ).x(), ( *it ).y() );
+  QCOMPARE( vertices, expected );
+}
+
+void TestQgsWkbGeometryView::bigEndian()
+{
+  // LineString (1 2, 3 4) in big endian byte order
+  const QByteArray wkb = QByteArray::fromHex( "0000000002000000023FF000000000000040000000000000004008000000000000401000000000000" );
+  const QgsWkbGeometryView view( wkb );
+  QCOMPARE( view.wkbType(), QgsWkbTypes::LineString );
+  QVERIFY( view.isDirectlyReadable() );
+  QCOMPARE( view.vertexCount(), 2 );
+  QCOMPARE( view.boundingBox(), QgsRectangle( 1, 2, 3, 4 ) );
+  QCOMPARE( view.geometry().asWkt(), QStringLiteral( "LineString (1 2, 3 4)" ) );
+}
+
+void TestQgsWkbGeometryView::malformed()
+{
+  const QgsWkbGeometryView empty( ( QByteArray() ) );
+  QCOMPARE( empty.wkbType(), QgsWkbTypes::Unknown );
+  QVERIFY( !empty.isDirectlyReadable() );
+  QVERIFY( empty.boundingBox().isNull() );
+  QCOMPARE( empty.vertexCount(), 0 );
+  QVERIFY( empty.geometry().isNull() );
+
+  // truncated linestring
+  QByteArray wkb = QgsGeometry::fromWkt( QStringLiteral( "LineString (1 2, 3 4)" ) ).asWkb();
+  wkb.chop( 8 );
+  const QgsWkbGeometryView truncated( wkb );
+  QVERIFY( !truncated.isDirectlyReadable() );
+  QCOMPARE( truncated.vertexCount(), 0 );
+
+  // truncated points, alone and in a multipoint
+  wkb = QgsGeometry::fromWkt( QStringLiteral( "PointZ (1 2 3)" ) ).asWkb();
+  wkb.chop( 4 );
+  const QgsWkbGeometryView truncatedPoint( wkb );
+  QVERIFY( !truncatedPoint.isDirectlyReadable() );
+  QCOMPARE( truncatedPoint.vertexCount(), 0 );
+  QVERIFY( truncatedPoint.boundingBox().isNull() );
+
+  wkb = QgsGeometry::fromWkt( QStringLiteral( "MultiPoint ((1 2), (3 4))" ) ).asWkb();
+  wkb.chop( 8 );
+  const QgsWkbGeometryView truncatedMultiPoint( wkb );
+  QVERIFY( !truncatedMultiPoint.isDirectlyReadable() );
+  QCOMPARE( truncatedMultiPoint.vertexCount(), 0 );
+}
+
+QGSTEST_MAIN( TestQgsWkbGeometryView )
+#include "testqgswkbgeometryview.moc"
@@ -87,7 +87,9 @@ class TestQgsCopcProvider : public QgsTest
     void testPointCloudIndex();
     void testStatsCalculator();
     void testSaveLoadStats();
+    void testStatisticsCache();
     void testPointCloudRequest();
+    void testNodeDataCache();
 
     void testQgsRangeRequestCache();
 
@@ -917,6 +919,39 @@ void TestQgsCopcProvider::testSaveLoadStats()
   QVERIFY( calculatedStats.toStatisticsJson() == readStats.toStatisticsJson() );
 }
 
+void TestQgsCopcProvider::testStatisticsCache()
+{
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/copc/sunshine-coast.copc.laz" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
+  QVERIFY( layer->isValid() );
+
+  QgsPointCloudIndex *index = layer->dataProvider()->index();
+  QVERIFY( index->isValid() );
+
+  QMap<QString, QgsPointCloudAttributeStatistics> statsMap;
+  QgsPointCloudAttributeStatistics intensityStats;
+  intensityStats.minimum = 2;
+  intensityStats.maximum = 30;
+  intensityStats.count = 100;
+  statsMap.insert( QStringLiteral( "Intensity" ), intensityStats );
+  const QgsPointCloudStatistics stats( 100, statsMap );
+
+  QVERIFY( index->storeStatisticsToCache( stats ) );
+  QCOMPARE( index->cachedStatistics().toStatisticsJson(), stats.toStatisticsJson() );
+
+  // clones of the index and other layers of the same dataset find the same statistics
+  std::unique_ptr< QgsPointCloudIndex > clonedIndex = index->clone();
+  QCOMPARE( clonedIndex->cachedStatistics().toStatisticsJson(), stats.toStatisticsJson() );
+
+  // statistics are not shared with filtered indexes
+  QVERIFY( index->setSubsetString( QStringLiteral( "Intensity > 10" ) ) );
+  QCOMPARE( index->cachedStatistics().sampledPointsCount(), 0 );
+
+  // nor with other datasets
+  std::unique_ptr< QgsPointCloudLayer > otherLayer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/copc/lone-star.copc.laz" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
+  QVERIFY( otherLayer->isValid() );
+  QVERIFY( otherLayer->dataProvider()->index()->cachedStatistics().toStatisticsJson() != stats.toStatisticsJson() );
+}
+
 void TestQgsCopcProvider::testPointCloudRequest()
 {
   std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/copc/lone-star.copc.laz" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
@@ -984,5 +1019,40 @@ void TestQgsCopcProvider::testPointCloudRequest()
   }
   QCOMPARE( count, layer->pointCount() );
 }
+void TestQgsCopcProvider::testNodeDataCache()
+{
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/copc/lone-star.copc.laz" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
+  QVERIFY( layer->isValid() );
+
+  QgsPointCloudIndex *index = layer->dataProvider()->index();
+  QVERIFY( index->isValid() );
+
+  QgsPointCloudRequest request;
+  request.setAttributes( layer->attributes() );
+
+  // the second request of a node is served from the decoded blocks cache, with the same points
+  std::unique_ptr< QgsPointCloudBlock > block( index->nodeData( index->root(), request ) );
+  std::unique_ptr< QgsPointCloudBlock > cachedBlock( index->nodeData( index->root(), request ) );
+  QVERIFY( block );
+  QVERIFY( cachedBlock );
+  QVERIFY( block.get() != cachedBlock.get() );
+  QCOMPARE( cachedBlock->pointCount(), block->pointCount() );
+  const int recordSize = block->attributes().pointRecordSize();
+  QCOMPARE( QByteArray( cachedBlock->data(), cachedBlock->pointCount() * recordSize ), QByteArray( block->data(), block->pointCount() * recordSize ) );
+
+  // a different filter rect is not served with the cached block
+  request.setFilterRect( QgsRectangle( 0, 0, 1, 1 ) );
+  std::unique_ptr< QgsPointCloudBlock > filteredBlock( index->nodeData( index->root(), request ) );
+  QVERIFY( filteredBlock );
+  QCOMPARE( filteredBlock->pointCount(), 0 );
+
+  // a cloned index shares the cache
+  std::unique_ptr< QgsPointCloudIndex > clonedIndex = index->clone();
+  request.setFilterRect( QgsRectangle() );
+  std::unique_ptr< QgsPointCloudBlock > clonedBlock( clonedIndex->nodeData( index->root(), request ) );
+  QCOMPARE( clonedBlock->pointCount(), block->pointCount() );
+  QCOMPARE( QByteArray( clonedBlock->data(), clonedBlock->pointCount() * recordSize ), QByteArray( block->data(), block->pointCount() * recordSize ) );
+}
+
 QGSTEST_MAIN( TestQgsCopcProvider )
 #include "testqgscopcprovider.moc"
@@ -0,0 +1,251 @@
+/***************************************************************************
+     testqgsdelimitedtextprovider.cpp
+     --------------------------------------
+    Date                 : October 2022
+    Copyright            : (C) 2022 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include <QObject>
+#include <QString>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QUrl>
+
+//qgis includes...
+#include <qgis.h>
+#include <qgsapplication.h>
+#include <qgsfeatureiterator.h>
+#include <qgsvectorlayer.h>
+
+/**
+ * \ingroup UnitTests
+ * This is a unit test for the delimited text provider
+ */
+class TestQgsDelimitedTextProvider : public QgsTest
+{
+    Q_OBJECT
+
+  public:
+
+    TestQgsDelimitedTextProvider() : QgsTest( QStringLiteral( "Delimited Text Provider Tests" ) ) {}
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void init() {}// will be called before each testfunction is executed.
+    void cleanup() {}// will be called after every testfunction.
+
+    void indexFileReused();
+    void indexFileInvalidated();
+    void seekToRecords();
+
+  private:
+
+    //! Writes a CSV file with a BOM, CRLF line endings and multibyte characters, with \a count records at the \a y coordinate
+    static bool writeFile( const QString &fileName, int count, int y );
+
+    //! Returns the uri of the delimited text file \a fileName with an index file
+    static QString uri( const QString &fileName, const QString &parameters = QString() );
+
+    //! Returns the features of \a layer by id
+    static QMap< QgsFeatureId, QgsFeature > features( QgsVectorLayer &layer );
+};
+
+//runs before all tests
+void TestQgsDelimitedTextProvider::initTestCase()
+{
+  // init QGIS's paths - true means that all path will be inited from prefix
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+//runs after all tests
+void TestQgsDelimitedTextProvider::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+bool TestQgsDelimitedTextProvider::writeFile( const QString &fileName, int count, int y )
+{
+  QFile file( fileName );
+  if ( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+    return false;
+
+  QByteArray data( "\xEF\xBB\xBF" );
+  data += "id,name,x,y\r\n";
+  for ( int i = 1; i <= count; ++i )
+    data += QStringLiteral( "%1,\"nämé 日本, %1\",%1,%2\r\n" ).arg( i ).arg( y ).toUtf8();
+  return file.write( data ) == data.size();
+}
+
+QString TestQgsDelimitedTextProvider::uri( const QString &fileName, const QString &parameters )
+{
+  QString uri = QUrl::fromLocalFile( fileName ).toString() + QStringLiteral( "?type=csv&encoding=UTF-8&xField=x&yField=y&spatialIndex=yes&indexFile=yes" );
+  if ( !parameters.isEmpty() )
+    uri += '&' + parameters;
+  return uri;
+}
+
+QMap< QgsFeatureId, QgsFeature > TestQgsDelimitedTextProvider::features( QgsVectorLayer &layer )
+{
+  QMap< QgsFeatureId, QgsFeature > features;
+  QgsFeatureIterator it = layer.getFeatures();
+  QgsFeature feature;
+  while ( it.nextFeature( feature ) )
+    features.insert( feature.id(), feature );
+  return features;
+}
+
+void TestQgsDelimitedTextProvider::indexFileReused()
+{
+  const QTemporaryDir dir;
+  QVERIFY( dir.isValid() );
+  const QString fileName = dir.filePath( QStringLiteral( "points.csv" ) );
+  QVERIFY( writeFile( fileName, 200, 1 ) );
+
+  QgsVectorLayer layer( uri( fileName ), QStringLiteral( "points" ), QStringLiteral( "delimitedtext" ) );
+  QVERIFY( layer.isValid() );
+  QCOMPARE( layer.featureCount(), 200LL );
+  QCOMPARE( layer.extent(), QgsRectangle( 1, 1, 200, 1 ) );
+
+  const QFileInfo indexFile( fileName + QStringLiteral( ".qdtidx" ) );
+  QVERIFY( indexFile.exists() );
+  QVERIFY( QFileInfo::exists( fileName + QStringLiteral( ".qdtidx.rtree" ) ) );
+  const QDateTime indexModified = indexFile.lastModified();
+
+  // the index file is read, not written again, when the layer is reopened
+  QThread::msleep( 50 );
+  QgsVectorLayer reopened( uri( fileName ), QStringLiteral( "points" ), QStringLiteral( "delimitedtext" ) );
+  QVERIFY( reopened.isValid() );
+  QCOMPARE( QFileInfo( indexFile.filePath() ).lastModified(), indexModified );
+  QCOMPARE( reopened.featureCount(), 200LL );
+  QCOMPARE( reopened.extent(), layer.extent() );
+  QCOMPARE( reopened.fields(), layer.fields() );
+  QCOMPARE( reopened.wkbType(), QgsWkbTypes::Point );
+
+  // and so is the spatial index
+  QgsFeatureIterator it = reopened.getFeatures( QgsFeatureRequest().setFilterRect( QgsRectangle( 9.5, 0, 12.5, 2 ) ) );
+  QgsFeature feature;
+  QList< int > ids;
+  while ( it.nextFeature( feature ) )
+    ids << feature.attribute( QStringLiteral( "id" ) ).toInt();
+  std::sort( ids.begin(), ids.end() );
+  QCOMPARE( ids, QList< int >() << 10 << 11 << 12 );
+
+  const QMap< QgsFeatureId, QgsFeature > expected = features( layer );
+  const QMap< QgsFeatureId, QgsFeature > actual = features( reopened );
+  QCOMPARE( actual.keys(), expected.keys() );
+  for ( auto expectedIt = expected.constBegin(); expectedIt != expected.constEnd(); ++expectedIt )
+    QCOMPARE( actual.value( expectedIt.key() ).attributes(), expectedIt.value().attributes() );
+}
+
+void TestQgsDelimitedTextProvider::indexFileInvalidated()
+{
+  const QTemporaryDir dir;
+  QVERIFY( dir.isValid() );
+  const QString fileName = dir.filePath( QStringLiteral( "points.csv" ) );
+  QVERIFY( writeFile( fileName, 200, 1 ) );
+  {
+    QgsVectorLayer layer( uri( fileName ), QStringLiteral( "points" ), QStringLiteral( "delimitedtext" ) );
+    QVERIFY( layer.isValid() );
+    QCOMPARE( layer.extent(), QgsRectangle( 1, 1, 200, 1 ) );
+  }
+
+  // same size, other modification time
+  QVERIFY( writeFile( fileName, 200, 5 ) );
+  {
+    QFile file( fileName );
+    QVERIFY( file.open( QIODevice::ReadWrite ) );
+    QVERIFY( file.setFileTime( QDateTime::currentDateTime().addSecs( 60 ), QFileDevice::FileModificationTime ) );
+  }
+  {
+    QgsVectorLayer layer( uri( fileName ), QStringLiteral( "points" ), QStringLiteral( "delimitedtext" ) );
+    QVERIFY( layer.isValid() );
+    QCOMPARE( layer.featureCount(), 200LL );
+    QCOMPARE( layer.extent(), QgsRectangle( 1, 5, 200, 5 ) );
+  }
+
+  // other size
+  QVERIFY( writeFile( fileName, 300, 5 ) );
+  {
+    QgsVectorLayer layer( uri( fileName ), QStringLiteral( "points" ), QStringLiteral( "delimitedtext" ) );
+    QVERIFY( layer.isValid() );
+    QCOMPARE( layer.featureCount(), 300LL );
+    QCOMPARE( layer.extent(), QgsRectangle( 1, 5, 300, 5 ) );
+    QCOMPARE( layer.fields().field( QStringLiteral( "id" ) ).type(), QVariant::Int );
+  }
+
+  // other definition
+  {
+    QgsVectorLayer layer( uri( fileName, QStringLiteral( "detectTypes=no" ) ), QStringLiteral( "points" ), QStringLiteral( "delimitedtext" ) );
+    QVERIFY( layer.isValid() );
+    QCOMPARE( layer.featureCount(), 300LL );
+    QCOMPARE( layer.fields().field( QStringLiteral( "id" ) ).type(), QVariant::String );
+  }
+
+  // parameters which don't change the scan keep the index file
+  const QDateTime indexModified = QFileInfo( fileName + QStringLiteral( ".qdtidx" ) ).lastModified();
+  QThread::msleep( 50 );
+  {
+    QgsVectorLayer layer( uri( fileName, QStringLiteral( "detectTypes=no&subset=%22id%22%20%3D%20'5'" ) ), QStringLiteral( "points" ), QStringLiteral( "delimitedtext" ) );
+    QVERIFY( layer.isValid() );
+    QCOMPARE( layer.featureCount(), 1LL );
+  }
+  QCOMPARE( QFileInfo( fileName + QStringLiteral( ".qdtidx" ) ).lastModified(), indexModified );
+}
+
+void TestQgsDelimitedTextProvider::seekToRecords()
+{
+  const QTemporaryDir dir;
+  QVERIFY( dir.isValid() );
+  const QString fileName = dir.filePath( QStringLiteral( "points.csv" ) );
+  QVERIFY( writeFile( fileName, 500, 1 ) );
+
+  // the features read from the start of the file
+  QgsVectorLayer plain( QUrl::fromLocalFile( fileName ).toString() + QStringLiteral( "?type=csv&encoding=UTF-8&xField=x&yField=y" ), QStringLiteral( "points" ), QStringLiteral( "delimitedtext" ) );
+  QVERIFY( plain.isValid() );
+  const QMap< QgsFeatureId, QgsFeature > expected = features( plain );
+  QCOMPARE( expected.size(), 500 );
+  QCOMPARE( expected.first().attribute( QStringLiteral( "name" ) ).toString(), QStringLiteral( "nämé 日本, 1" ) );
+
+  // the features read by seeking to the offsets of the records, when scanning the file and from the index file
+  for ( int pass = 0; pass < 2; ++pass )
+  {
+    QgsVectorLayer layer( uri( fileName ), QStringLiteral( "points" ), QStringLiteral( "delimitedtext" ) );
+    QVERIFY( layer.isValid() );
+
+    QList< QgsFeatureId > ids = expected.keys();
+    // backwards, so that each record must be sought
+    std::reverse( ids.begin(), ids.end() );
+    for ( const QgsFeatureId id : std::as_const( ids ) )
+    {
+      const QgsFeature feature = layer.getFeature( id );
+      QVERIFY( feature.isValid() );
+      QCOMPARE( feature.attributes(), expected.value( id ).attributes() );
+      QCOMPARE( feature.geometry().asWkt(), expected.value( id ).geometry().asWkt() );
+    }
+
+    QgsFeatureIterator it = layer.getFeatures( QgsFeatureRequest().setFilterFids( QgsFeatureIds() << ids.at( 10 ) << ids.at( 200 ) << ids.at( 499 ) ) );
+    QgsFeature feature;
+    int count = 0;
+    while ( it.nextFeature( feature ) )
+    {
+      QCOMPARE( feature.attributes(), expected.value( feature.id() ).attributes() );
+      count++;
+    }
+    QCOMPARE( count, 3 );
+  }
+}
+
+QGSTEST_MAIN( TestQgsDelimitedTextProvider )
+#include "testqgsdelimitedtextprovider.moc"
@@ -263,6 +263,48 @@ class TestQgsPostgresConn: public QObject
       QCOMPARE( result.PQgetvalue( 0, 1 ), session_user );
       conn->unref();
     }
+
+    void cachedPreparedStatements()
+    {
+      const char *connstring = getenv( "QGIS_PGTEST_DB" );
+      if ( !connstring ) connstring = "service=qgis_test";
+      QgsPostgresConn *conn = QgsPostgresConn::connectDb( connstring, false, false );
+      QVERIFY( conn );
+
+      conn->PQexecNR( QStringLiteral( "DROP TABLE IF EXISTS qgis_test.cached_prepared" ) );
+      QVERIFY( conn->PQexecNR( QStringLiteral( "CREATE TABLE qgis_test.cached_prepared (id integer PRIMARY KEY, name text)" ) ) );
+      QVERIFY( conn->PQexecNR( QStringLiteral( "INSERT INTO qgis_test.cached_prepared VALUES (1, 'one'), (2, 'two')" ) ) );
+
+      const QString query = QStringLiteral( "SELECT * FROM qgis_test.cached_prepared WHERE id = $1" );
+      QgsPostgresResult result( conn->PQexecCachedPrepared( query, QStringList() << QStringLiteral( "1" ) ) );
+      QCOMPARE( result.PQresultStatus(), PGRES_TUPLES_OK );
+      QCOMPARE( result.PQntuples(), 1 );
+      QCOMPARE( result.PQnfields(), 2 );
+
+      // the cached plan changes its result type, the statement is prepared again
+      QVERIFY( conn->PQexecNR( QStringLiteral( "ALTER TABLE qgis_test.cached_prepared ADD COLUMN value double precision" ) ) );
+      result = conn->PQexecCachedPrepared( query, QStringList() << QStringLiteral( "2" ) );
+      QCOMPARE( result.PQresultStatus(), PGRES_TUPLES_OK );
+      QCOMPARE( result.PQntuples(), 1 );
+      QCOMPARE( result.PQnfields(), 3 );
+
+      // not within a transaction block, which the error aborted
+      QVERIFY( conn->PQexecNR( QStringLiteral( "BEGIN" ) ) );
+      QVERIFY( conn->PQexecNR( QStringLiteral( "ALTER TABLE qgis_test.cached_prepared DROP COLUMN value" ) ) );
+      result = conn->PQexecCachedPrepared( query, QStringList() << QStringLiteral( "2" ) );
+      QCOMPARE( result.PQresultStatus(), PGRES_FATAL_ERROR );
+      QCOMPARE( conn->PQtransactionStatus(), static_cast< int >( PQTRANS_INERROR ) );
+      conn->PQexecNR( QStringLiteral( "ROLLBACK" ) );
+
+      // the statement is prepared again after the transaction
+      QVERIFY( conn->PQexecNR( QStringLiteral( "ALTER TABLE qgis_test.cached_prepared DROP COLUMN value" ) ) );
+      result = conn->PQexecCachedPrepared( query, QStringList() << QStringLiteral( "1" ) );
+      QCOMPARE( result.PQresultStatus(), PGRES_TUPLES_OK );
+      QCOMPARE( result.PQnfields(), 2 );
+
+      conn->PQexecNR( QStringLiteral( "DROP TABLE qgis_test.cached_prepared" ) );
+      conn->unref();
+    }
 #endif
 };
 
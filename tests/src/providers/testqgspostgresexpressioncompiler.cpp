@@ -29,6 +29,11 @@ class QgsTestPostgresExpressionCompiler: public QgsPostgresExpressionCompiler
       mDetectedSrid = srid;
       mGeometryColumn = geometryColumn;
     }
+
+    void setFields( const QgsFields &fields )
+    {
+      mFields = fields;
+    }
 };
 
 class TestQgsPostgresExpressionCompiler: public QObject
@@ -41,6 +46,7 @@ class TestQgsPostgresExpressionCompiler: public QObject
 
   private slots:
     void testGeometryFromWkt();
+    void testToDateTime();
 };
 
 void TestQgsPostgresExpressionCompiler::testGeometryFromWkt()
@@ -57,6 +63,37 @@ void TestQgsPostgresExpressionCompiler::testGeometryFromWkt()
   QCOMPARE( sql, QStringLiteral( "ST_Intersects(\"geom\",ST_GeomFromText('Polygon ((0 0, 1 0, 1 1, 0 1, 0 0))',4326))" ) );
 }
 
+void TestQgsPostgresExpressionCompiler::testToDateTime()
+{
+  const QgsPostgresProvider p( QLatin1String( "" ), QgsDataProvider::ProviderOptions() );
+  QgsPostgresFeatureSource featureSource( &p );
+  QgsTestPostgresExpressionCompiler compiler( &featureSource, QStringLiteral( "4326" ), QStringLiteral( "geom" ) );
+  QgsFields fields;
+  fields.append( QgsField( QStringLiteral( "date" ), QVariant::Date ) );
+  fields.append( QgsField( QStringLiteral( "datetime" ), QVariant::DateTime ) );
+  fields.append( QgsField( QStringLiteral( "text" ), QVariant::String ) );
+  compiler.setFields( fields );
+  const QgsExpressionContext expContext;
+
+  QgsExpression exp( QStringLiteral( "to_datetime( \"date\" ) >= make_datetime(2020,1,2,3,4,5)" ) );
+  exp.prepare( &expContext );
+  QCOMPARE( compiler.compile( &exp ), QgsSqlExpressionCompiler::Complete );
+  QVERIFY( compiler.result().startsWith( QStringLiteral( "((\"date\")::timestamp >= " ) ) );
+
+  exp = QgsExpression( QStringLiteral( "to_datetime( \"datetime\" ) IS NULL" ) );
+  exp.prepare( &expContext );
+  QCOMPARE( compiler.compile( &exp ), QgsSqlExpressionCompiler::Complete );
+  QCOMPARE( compiler.result(), QStringLiteral( "(\"datetime\" IS NULL)" ) );
+
+  // strings and formats are parsed by QGIS
+  exp = QgsExpression( QStringLiteral( "to_datetime( \"text\" ) IS NULL" ) );
+  exp.prepare( &expContext );
+  QCOMPARE( compiler.compile( &exp ), QgsSqlExpressionCompiler::Fail );
+  exp = QgsExpression( QStringLiteral( "to_datetime( \"date\", 'yyyy' ) IS NULL" ) );
+  exp.prepare( &expContext );
+  QCOMPARE( compiler.compile( &exp ), QgsSqlExpressionCompiler::Fail );
+}
+
 QGSTEST_MAIN( TestQgsPostgresExpressionCompiler )
 
 #include "testqgspostgresexpressioncompiler.moc"
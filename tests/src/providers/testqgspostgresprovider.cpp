@@ -20,12 +20,21 @@
 #include <qgspostgresprovider.h>
 #include <qgspostgresconn.h>
 #include <qgsfields.h>
+#include <qgsgeometry.h>
+#include <qgsapplication.h>
+#include <qgsvariantutils.h>
 
 
 class TestQgsPostgresProvider: public QObject
 {
     Q_OBJECT
   private slots:
+#ifdef ENABLE_PGTEST
+    void initTestCase();
+    void cleanupTestCase();
+    void testFastInsertCopy();
+    void testPipelinedFetches();
+#endif
 
     void decodeHstore();
     void decodeHstoreNoQuote();
@@ -428,5 +437,143 @@ void TestQgsPostgresProvider::testWhereClauseFids()
                    << "\"fld_int\"=43 AND \"fld\"::text='PostGIS too!'" );
 }
 
+#ifdef ENABLE_PGTEST
+void TestQgsPostgresProvider::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsPostgresProvider::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsPostgresProvider::testFastInsertCopy()
+{
+  const char *connstring = getenv( "QGIS_PGTEST_DB" );
+  if ( !connstring )
+    connstring = "service=qgis_test";
+
+  QgsPostgresConn *conn = QgsPostgresConn::connectDb( connstring, false, false );
+  QVERIFY( conn );
+  conn->PQexecNR( QStringLiteral( "DROP TABLE IF EXISTS qgis_test.fast_insert_copy" ) );
+  QVERIFY( conn->PQexecNR( QStringLiteral( "CREATE TABLE qgis_test.fast_insert_copy (pk serial PRIMARY KEY, txt text, bin bytea, js jsonb, cst text DEFAULT 'default value', "
+                           "geom geometry(Point, 4326))" ) ) );
+  conn->unref();
+
+  QgsDataSourceUri uri( connstring );
+  uri.setDataSource( QStringLiteral( "qgis_test" ), QStringLiteral( "fast_insert_copy" ), QStringLiteral( "geom" ), QString(), QStringLiteral( "pk" ) );
+  QgsPostgresProvider provider( uri.uri( false ), QgsDataProvider::ProviderOptions() );
+  QVERIFY( provider.isValid() );
+
+  const QgsFields fields = provider.fields();
+  const int txtIdx = fields.indexOf( QStringLiteral( "txt" ) );
+  const int binIdx = fields.indexOf( QStringLiteral( "bin" ) );
+  const int jsIdx = fields.indexOf( QStringLiteral( "js" ) );
+  const int cstIdx = fields.indexOf( QStringLiteral( "cst" ) );
+
+  // the constant column is set to its default value clause, so it is left out of the COPY
+  const QString text = QStringLiteral( "tab\there\nnew line\r\\backslash \\N" );
+  const QByteArray bytes( "\x00\x01\\\t\n\xff", 6 );
+  QVariantMap json;
+  json.insert( QStringLiteral( "key" ), QStringLiteral( "tab\t\\" ) );
+  json.insert( QStringLiteral( "number" ), 5 );
+
+  QgsFeature f1( fields );
+  f1.setAttribute( txtIdx, text );
+  f1.setAttribute( binIdx, bytes );
+  f1.setAttribute( jsIdx, json );
+  f1.setAttribute( cstIdx, provider.defaultValueClause( cstIdx ) );
+  f1.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Point (1 2)" ) ) );
+  QgsFeature f2( fields );
+  f2.setAttribute( txtIdx, QVariant( QVariant::String ) );
+  f2.setAttribute( binIdx, QVariant( QVariant::ByteArray ) );
+  f2.setAttribute( jsIdx, QVariantList() << 1 << QStringLiteral( "two" ) );
+  f2.setAttribute( cstIdx, provider.defaultValueClause( cstIdx ) );
+  QgsFeatureList features { f1, f2 };
+  QVERIFY( provider.addFeatures( features, QgsFeatureSink::FastInsert ) );
+
+  QgsFeatureRequest request;
+  request.addOrderBy( QStringLiteral( "pk" ) );
+  QgsFeatureIterator it = provider.getFeatures( request );
+  QgsFeature feature;
+  QVERIFY( it.nextFeature( feature ) );
+  QCOMPARE( feature.attribute( txtIdx ).toString(), text );
+  QCOMPARE( feature.attribute( binIdx ).toByteArray(), bytes );
+  QCOMPARE( feature.attribute( jsIdx ).toMap(), json );
+  QCOMPARE( feature.attribute( cstIdx ).toString(), QStringLiteral( "default value" ) );
+  QCOMPARE( feature.geometry().asWkt(), QStringLiteral( "Point (1 2)" ) );
+  QVERIFY( it.nextFeature( feature ) );
+  QVERIFY( QgsVariantUtils::isNull( feature.attribute( txtIdx ) ) );
+  QVERIFY( QgsVariantUtils::isNull( feature.attribute( binIdx ) ) );
+  QCOMPARE( feature.attribute( jsIdx ).toList(), QVariantList() << 1 << QStringLiteral( "two" ) );
+  QCOMPARE( feature.attribute( cstIdx ).toString(), QStringLiteral( "default value" ) );
+  QVERIFY( !feature.hasGeometry() );
+  QVERIFY( !it.nextFeature( feature ) );
+
+  conn = QgsPostgresConn::connectDb( connstring, false, false );
+  QVERIFY( conn );
+  conn->PQexecNR( QStringLiteral( "DROP TABLE qgis_test.fast_insert_copy" ) );
+  conn->unref();
+}
+
+void TestQgsPostgresProvider::testPipelinedFetches()
+{
+  const char *connstring = getenv( "QGIS_PGTEST_DB" );
+  if ( !connstring )
+    connstring = "service=qgis_test";
+
+  QgsPostgresConn *conn = QgsPostgresConn::connectDb( connstring, false, false );
+  QVERIFY( conn );
+  conn->PQexecNR( QStringLiteral( "DROP TABLE IF EXISTS qgis_test.pipelined_fetches" ) );
+  QVERIFY( conn->PQexecNR( QStringLiteral( "CREATE TABLE qgis_test.pipelined_fetches AS SELECT pk, 'row ' || pk AS txt FROM generate_series(1, 100000) AS pk" ) ) );
+  QVERIFY( conn->PQexecNR( QStringLiteral( "ALTER TABLE qgis_test.pipelined_fetches ADD PRIMARY KEY (pk)" ) ) );
+  conn->unref();
+
+  QgsDataSourceUri uri( connstring );
+  uri.setDataSource( QStringLiteral( "qgis_test" ), QStringLiteral( "pipelined_fetches" ), QString(), QString(), QStringLiteral( "pk" ) );
+  QgsPostgresProvider provider( uri.uri( false ), QgsDataProvider::ProviderOptions() );
+  QVERIFY( provider.isValid() );
+
+  // limited requests
+  QgsFeature feature;
+  int count = 0;
+  QgsFeatureIterator it = provider.getFeatures( QgsFeatureRequest().setLimit( 10 ) );
+  while ( it.nextFeature( feature ) )
+    count++;
+  QCOMPARE( count, 10 );
+
+  count = 0;
+  it = provider.getFeatures( QgsFeatureRequest().setLimit( 4500 ) );
+  while ( it.nextFeature( feature ) )
+    count++;
+  QCOMPARE( count, 4500 );
+
+  // iterators closed with a pending FETCH, the pooled connection must still be usable afterwards
+  for ( int i = 0; i < 3; ++i )
+  {
+    it = provider.getFeatures( QgsFeatureRequest().addOrderBy( QStringLiteral( "pk" ) ) );
+    for ( int j = 0; j < 2500; ++j )
+    {
+      QVERIFY( it.nextFeature( feature ) );
+      QCOMPARE( feature.attribute( 0 ).toInt(), j + 1 );
+    }
+    it.close();
+  }
+
+  count = 0;
+  it = provider.getFeatures();
+  while ( it.nextFeature( feature ) )
+    count++;
+  QCOMPARE( count, 100000 );
+
+  conn = QgsPostgresConn::connectDb( connstring, false, false );
+  QVERIFY( conn );
+  conn->PQexecNR( QStringLiteral( "DROP TABLE qgis_test.pipelined_fetches" ) );
+  conn->unref();
+}
+#endif
+
 QGSTEST_MAIN( TestQgsPostgresProvider )
 #include "testqgspostgresprovider.moc"